@@ -0,0 +1,231 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <executor.h>
+#include <fusion.h>
+#include <instrumentation.h>
+#include <ir_all_nodes.h>
+#include <ir_builder.h>
+#include <kernel_cache.h>
+#include <kernel_db/kernel_db.h>
+#include <ops/all_ops.h>
+
+#include <benchmark/benchmark.h>
+
+#include <cuda_runtime.h>
+
+#include <benchmark/utils.h>
+
+// Benchmarks of the time to the first result of a new fusion, i.e., of
+// segmentation, scheduling, lowering, code generation and compilation. The
+// time of every compilation stage is reported as a counter, averaged over
+// the iterations, see Note [ Compile time instrumentation ].
+//
+// Compiled kernels are cached in the process by their code, see
+// Note [ Shared kernel modules ]. The ColdStart benchmarks scale the result
+// of their fusion by a constant numbered by the iteration, so that every
+// iteration pays for NVRTC. The constants are the same in every process, so
+// running the ColdStart benchmarks twice with
+// PYTORCH_NVFUSER_ENABLE=kernel_db measures a cold start reading the kernels
+// from a populated KernelDb. The WarmKernelCache benchmarks compile the same
+// fusion every iteration and measure everything but NVRTC.
+
+namespace {
+
+// Defines the fusion and returns its inputs, `scale` multiplies its outputs
+using SetupFusion =
+    std::function<std::vector<c10::IValue>(Fusion*, double scale)>;
+
+// Bias, dropout, residual add and layer norm of the BERT encoder
+std::vector<c10::IValue> setupBiasDropoutAddLayerNorm(
+    Fusion* fusion,
+    double scale) {
+  auto x = makeContigTensor(3, DataType::Half);
+  auto bias = makeContigTensor(1, DataType::Half);
+  auto residual = makeContigTensor(3, DataType::Half);
+  auto weight = makeContigTensor(1, DataType::Half);
+  auto beta = makeContigTensor(1, DataType::Half);
+  fusion->addInput(x);
+  fusion->addInput(bias);
+  fusion->addInput(residual);
+  fusion->addInput(weight);
+  fusion->addInput(beta);
+
+  auto tv = add(castOp(DataType::Float, x), castOp(DataType::Float, bias));
+  tv = dropout(tv, IrBuilder::create<Double>(0.1)).output;
+  tv = add(tv, castOp(DataType::Float, residual));
+  auto result = layer_norm(
+      tv,
+      1,
+      castOp(DataType::Float, weight),
+      castOp(DataType::Float, beta),
+      IrBuilder::create<Double>(1e-5));
+  fusion->addOutput(castOp(
+      DataType::Half, mul(result.output, IrBuilder::create<Double>(scale))));
+  fusion->addOutput(result.mean);
+  fusion->addOutput(result.invstd);
+
+  auto options = at::TensorOptions().dtype(at::kHalf).device(at::kCUDA, 0);
+  return {
+      at::randn({8, 512, 1024}, options),
+      at::randn({1024}, options),
+      at::randn({8, 512, 1024}, options),
+      at::randn({1024}, options),
+      at::randn({1024}, options)};
+}
+
+// Backward of layer norm, with the gradients of the weight and of the bias
+std::vector<c10::IValue> setupLayerNormBackward(Fusion* fusion, double scale) {
+  auto dy = makeContigTensor(2);
+  auto x = makeContigTensor(2);
+  auto mean = makeConcreteTensor({-1, 1});
+  auto rstd = makeConcreteTensor({-1, 1});
+  auto weight = makeContigTensor(1);
+  auto bias = makeContigTensor(1);
+  fusion->addInput(dy);
+  fusion->addInput(x);
+  fusion->addInput(mean);
+  fusion->addInput(rstd);
+  fusion->addInput(weight);
+  fusion->addInput(bias);
+
+  auto grads = layer_norm_backward(
+      dy, x, {1024}, mean, rstd, weight, bias, {true, true, true});
+  auto scale_val = IrBuilder::create<Double>(scale);
+  fusion->addOutput(mul(grads.grad_input, scale_val));
+  fusion->addOutput(mul(grads.grad_weight, scale_val));
+  fusion->addOutput(mul(grads.grad_bias, scale_val));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  return {
+      at::randn({4096, 1024}, options),
+      at::randn({4096, 1024}, options),
+      at::randn({4096, 1}, options),
+      at::randn({4096, 1}, options),
+      at::randn({1024}, options),
+      at::randn({1024}, options)};
+}
+
+// Chain of normalizations alternating between the inner and the outer
+// dimension, which is segmented into one kernel per normalization
+std::vector<c10::IValue> setupManySegments(Fusion* fusion, double scale) {
+  auto tv = makeContigTensor(2);
+  fusion->addInput(tv);
+  for (auto i : c10::irange(8)) {
+    const bool inner = i % 2 == 0;
+    auto sum_tv = sum(tv, {inner ? 1 : 0});
+    tv = sub(tv, broadcast(sum_tv, {!inner, inner}));
+  }
+  fusion->addOutput(mul(tv, IrBuilder::create<Double>(scale)));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  return {at::randn({1024, 1024}, options)};
+}
+
+void runCompileIterations(
+    benchmark::State& benchmark_state,
+    const SetupFusion& setup_fusion,
+    bool unique_kernels) {
+  inst::CompileStats::instance()->reset();
+
+  int64_t iteration = 0;
+  std::unique_ptr<FusionExecutorCache> fec;
+  for (auto _ : benchmark_state) {
+    benchmark_state.PauseTiming();
+    fec.reset();
+    auto fusion_ptr = std::make_unique<Fusion>();
+    std::vector<c10::IValue> aten_inputs;
+    {
+      FusionGuard fg(fusion_ptr.get());
+      // Exactly representable, and printed in full by the code generator
+      const double scale =
+          unique_kernels ? 1.0 + (double)(iteration + 1) / (1 << 20) : 1.0;
+      aten_inputs = setup_fusion(fusion_ptr.get(), scale);
+    }
+    iteration++;
+    C10_CUDA_CHECK(cudaDeviceSynchronize());
+    benchmark_state.ResumeTiming();
+
+    fec = std::make_unique<FusionExecutorCache>(std::move(fusion_ptr));
+    fec->runFusionWithInputs(aten_inputs);
+    C10_CUDA_CHECK(cudaDeviceSynchronize());
+  }
+
+  for (const auto& [stage, stats] : inst::CompileStats::instance()->stats()) {
+    benchmark_state.counters[stage + "_ms"] =
+        stats.total_ms / (double)benchmark_state.iterations();
+  }
+  benchmark_state.counters["kernel_db"] = KernelDb::get().enabled() ? 1 : 0;
+  if (fec != nullptr) {
+    auto runtime = fec->getMostRecentKernelRuntime();
+    benchmark_state.counters["segments"] = runtime->isSegmented()
+        ? (double)runtime->fusionSegments()->groups().size()
+        : 1.0;
+  }
+}
+
+} // namespace
+
+//------------------------------------------------------------------------------
+
+static void CompileTime_BiasDropoutAddLayerNorm_ColdStart(
+    benchmark::State& benchmark_state) {
+  runCompileIterations(benchmark_state, setupBiasDropoutAddLayerNorm, true);
+}
+
+static void CompileTime_BiasDropoutAddLayerNorm_WarmKernelCache(
+    benchmark::State& benchmark_state) {
+  runCompileIterations(benchmark_state, setupBiasDropoutAddLayerNorm, false);
+}
+
+static void CompileTime_LayerNormBackward_ColdStart(
+    benchmark::State& benchmark_state) {
+  runCompileIterations(benchmark_state, setupLayerNormBackward, true);
+}
+
+static void CompileTime_LayerNormBackward_WarmKernelCache(
+    benchmark::State& benchmark_state) {
+  runCompileIterations(benchmark_state, setupLayerNormBackward, false);
+}
+
+static void CompileTime_ManySegments_ColdStart(
+    benchmark::State& benchmark_state) {
+  runCompileIterations(benchmark_state, setupManySegments, true);
+}
+
+static void CompileTime_ManySegments_WarmKernelCache(
+    benchmark::State& benchmark_state) {
+  runCompileIterations(benchmark_state, setupManySegments, false);
+}
+
+//------------------------------------------------------------------------------
+
+// The iterations are fixed so that the kernels of the ColdStart benchmarks
+// are the same in every process
+BENCHMARK(CompileTime_BiasDropoutAddLayerNorm_ColdStart)
+    ->Iterations(5)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK(CompileTime_BiasDropoutAddLayerNorm_WarmKernelCache)
+    ->Iterations(5)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK(CompileTime_LayerNormBackward_ColdStart)
+    ->Iterations(5)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK(CompileTime_LayerNormBackward_WarmKernelCache)
+    ->Iterations(5)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK(CompileTime_ManySegments_ColdStart)
+    ->Iterations(5)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK(CompileTime_ManySegments_WarmKernelCache)
+    ->Iterations(5)
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,217 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <executor.h>
+#include <fusion.h>
+#include <instrumentation.h>
+#include <ir_all_nodes.h>
+#include <ir_builder.h>
+#include <kernel_cache.h>
+#include <ops/all_ops.h>
+
+#include <benchmark/benchmark.h>
+
+#include <c10/cuda/CUDACachingAllocator.h>
+#include <cuda_runtime.h>
+
+#include <benchmark/utils.h>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+// Benchmarks of a single FusionExecutorCache serving a stream of inputs
+// whose sequence length changes from one iteration to the next, as with
+// variable length batches. Every iteration synchronizes, so its time is the
+// latency of the run including the compilation stalls of the new shapes.
+// The sequence lengths are drawn from a seeded generator, so every process
+// runs the same stream. Besides the mean, the benchmarks report:
+// - p50_us, p99_us and max_us, the percentiles of the iteration latencies,
+// - kernel_runtimes and compilations, the kernel runtimes created and the
+//   kernels compiled by the stream, and runtime_hit_rate, the fraction of
+//   runs whose input id already had a kernel runtime, see
+//   Note [ Runtime metrics ],
+// - host_kernel_MB, the host memory held by the compiled kernels, and
+//   device_reserved_MB, the growth of the memory reserved by the caching
+//   allocator over the stream.
+
+namespace {
+
+// Builds the fusion and returns the inputs for a sequence length
+using MakeInputs = std::function<std::vector<c10::IValue>(int64_t seqlen)>;
+
+// Layer norm of [batch, seqlen, hidden] inputs over the hidden dimension
+MakeInputs setupLayerNorm(Fusion* fusion) {
+  auto x = makeSymbolicTensor(3, DataType::Half);
+  auto weight = makeSymbolicTensor(1, DataType::Half);
+  auto bias = makeSymbolicTensor(1, DataType::Half);
+  fusion->addInput(x);
+  fusion->addInput(weight);
+  fusion->addInput(bias);
+
+  auto result = layer_norm(
+      castOp(DataType::Float, x),
+      1,
+      castOp(DataType::Float, weight),
+      castOp(DataType::Float, bias),
+      IrBuilder::create<Double>(1e-5));
+  fusion->addOutput(castOp(DataType::Half, result.output));
+
+  return [](int64_t seqlen) -> std::vector<c10::IValue> {
+    auto options = at::TensorOptions().dtype(at::kHalf).device(at::kCUDA, 0);
+    return {
+        at::randn({8, seqlen, 1024}, options),
+        at::randn({1024}, options),
+        at::randn({1024}, options)};
+  };
+}
+
+// Softmax of [batch * heads, seqlen, seqlen] attention scores over the last
+// dimension
+MakeInputs setupAttentionSoftmax(Fusion* fusion) {
+  auto scores = makeSymbolicTensor(3, DataType::Half);
+  fusion->addInput(scores);
+
+  auto probs = softmax(castOp(DataType::Float, scores), 2);
+  fusion->addOutput(castOp(DataType::Half, probs));
+
+  return [](int64_t seqlen) -> std::vector<c10::IValue> {
+    auto options = at::TensorOptions().dtype(at::kHalf).device(at::kCUDA, 0);
+    return {at::randn({8 * 16, seqlen, seqlen}, options)};
+  };
+}
+
+int64_t reservedDeviceBytes() {
+  // Aggregate over the small and the large pools
+  return c10::cuda::CUDACachingAllocator::getDeviceStats(0)
+      .reserved_bytes[0]
+      .current;
+}
+
+double percentile(std::vector<double> values, double fraction) {
+  TORCH_INTERNAL_ASSERT(!values.empty());
+  const auto index = std::min(
+      values.size() - 1, (size_t)(fraction * (double)values.size()));
+  std::nth_element(values.begin(), values.begin() + index, values.end());
+  return values[index];
+}
+
+// Runs sequence lengths of multiples of 8 up to range(0) through one cache
+void runDynamicShapeIterations(
+    benchmark::State& benchmark_state,
+    const std::function<MakeInputs(Fusion*)>& setup_fusion,
+    bool bucketed) {
+  c10::cuda::CUDACachingAllocator::emptyCache();
+  const auto max_seqlen = benchmark_state.range(0);
+
+  auto fusion_ptr = std::make_unique<Fusion>();
+  MakeInputs make_inputs;
+  {
+    FusionGuard fg(fusion_ptr.get());
+    make_inputs = setup_fusion(fusion_ptr.get());
+  }
+  FusionExecutorCache fec(std::move(fusion_ptr));
+  if (bucketed) {
+    // Powers of two of the second dimension of the first input, i.e. of the
+    // (outer) sequence length, see Note [ Shape bucketing ]
+    ShapeBuckets shape_buckets;
+    shape_buckets.dims = {{0, 1}};
+    fec.setShapeBuckets(shape_buckets);
+  }
+
+  std::mt19937 generator(0);
+  std::uniform_int_distribution<int64_t> distribution(1, max_seqlen / 8);
+  std::vector<double> latencies_us;
+  const auto reserved_bytes = reservedDeviceBytes();
+  auto metrics = inst::RuntimeMetrics::instance();
+  metrics->reset();
+
+  for (auto _ : benchmark_state) {
+    auto aten_inputs = make_inputs(8 * distribution(generator));
+    C10_CUDA_CHECK(cudaDeviceSynchronize());
+
+    const auto start = std::chrono::steady_clock::now();
+    fec.runFusionWithInputs(aten_inputs);
+    C10_CUDA_CHECK(cudaDeviceSynchronize());
+    const std::chrono::duration<double> latency =
+        std::chrono::steady_clock::now() - start;
+
+    benchmark_state.SetIterationTime(latency.count());
+    latencies_us.push_back(latency.count() * 1e6);
+  }
+
+  const auto snapshot = metrics->snapshot();
+  const auto hits = snapshot.get(inst::RuntimeCounter::RuntimeCacheHits);
+  const auto misses = snapshot.get(inst::RuntimeCounter::RuntimeCacheMisses);
+  benchmark_state.counters["p50_us"] = percentile(latencies_us, 0.5);
+  benchmark_state.counters["p99_us"] = percentile(latencies_us, 0.99);
+  benchmark_state.counters["max_us"] =
+      *std::max_element(latencies_us.begin(), latencies_us.end());
+  benchmark_state.counters["kernel_runtimes"] =
+      (double)snapshot.get(inst::RuntimeCounter::KernelRuntimesCreated);
+  benchmark_state.counters["compilations"] =
+      (double)snapshot.get(inst::RuntimeCounter::KernelCompilations);
+  benchmark_state.counters["runtime_hit_rate"] =
+      hits + misses > 0 ? (double)hits / (double)(hits + misses) : 0.0;
+  benchmark_state.counters["host_kernel_MB"] =
+      (double)fec.compiledKernelStats().host_bytes / 1.0e6;
+  benchmark_state.counters["device_reserved_MB"] =
+      (double)(reservedDeviceBytes() - reserved_bytes) / 1.0e6;
+}
+
+} // namespace
+
+//------------------------------------------------------------------------------
+
+static void DynamicShapes_LayerNorm(benchmark::State& benchmark_state) {
+  runDynamicShapeIterations(benchmark_state, setupLayerNorm, false);
+}
+
+static void DynamicShapes_LayerNorm_Bucketed(
+    benchmark::State& benchmark_state) {
+  runDynamicShapeIterations(benchmark_state, setupLayerNorm, true);
+}
+
+static void DynamicShapes_AttentionSoftmax(benchmark::State& benchmark_state) {
+  runDynamicShapeIterations(benchmark_state, setupAttentionSoftmax, false);
+}
+
+static void DynamicShapes_AttentionSoftmax_Bucketed(
+    benchmark::State& benchmark_state) {
+  runDynamicShapeIterations(benchmark_state, setupAttentionSoftmax, true);
+}
+
+//------------------------------------------------------------------------------
+
+// The iterations are fixed so that every process runs the same stream
+BENCHMARK(DynamicShapes_LayerNorm)
+    ->Arg(512)
+    ->Arg(4096)
+    ->Iterations(200)
+    ->Unit(benchmark::kMicrosecond)
+    ->UseManualTime();
+
+BENCHMARK(DynamicShapes_LayerNorm_Bucketed)
+    ->Arg(512)
+    ->Arg(4096)
+    ->Iterations(200)
+    ->Unit(benchmark::kMicrosecond)
+    ->UseManualTime();
+
+BENCHMARK(DynamicShapes_AttentionSoftmax)
+    ->Arg(512)
+    ->Arg(2048)
+    ->Iterations(200)
+    ->Unit(benchmark::kMicrosecond)
+    ->UseManualTime();
+
+BENCHMARK(DynamicShapes_AttentionSoftmax_Bucketed)
+    ->Arg(512)
+    ->Arg(2048)
+    ->Iterations(200)
+    ->Unit(benchmark::kMicrosecond)
+    ->UseManualTime();
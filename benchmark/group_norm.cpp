@@ -0,0 +1,208 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <executor.h>
+#include <fusion.h>
+#include <ir_builder.h>
+#include <lower2device.h>
+#include <ops/all_ops.h>
+#include <scheduler/all_schedulers.h>
+
+#include <benchmark/benchmark.h>
+
+#include <cuda_runtime.h>
+
+#include <benchmark/utils.h>
+
+// Groups of the group norms of diffusion UNets
+constexpr int64_t kGroups = 32;
+
+// Shape of the input of group_norm, [N, G, C / G, H, W] or
+// [N, H, W, G, C / G] if channels_last
+static std::vector<int64_t> groupedShape(
+    benchmark::State& benchmark_state,
+    bool channels_last) {
+  const int64_t n = benchmark_state.range(0);
+  const int64_t hw = benchmark_state.range(1);
+  const int64_t c = benchmark_state.range(2);
+  if (channels_last) {
+    return {n, hw, hw, kGroups, c / kGroups};
+  }
+  return {n, kGroups, c / kGroups, hw, hw};
+}
+
+static void setupGroupNorm(
+    Fusion* fusion,
+    DataType dtype,
+    bool channels_last = false) {
+  TORCH_INTERNAL_ASSERT(dtype == DataType::Float || dtype == DataType::Half);
+
+  FusionGuard fg(fusion);
+
+  auto input = makeContigTensor(5, dtype);
+  auto weight = makeContigTensor(2, dtype);
+  auto bias = makeContigTensor(2, dtype);
+
+  fusion->addInput(input);
+  fusion->addInput(weight);
+  fusion->addInput(bias);
+
+  if (dtype == DataType::Half) {
+    input = castOp(DataType::Float, input);
+    weight = castOp(DataType::Float, weight);
+    bias = castOp(DataType::Float, bias);
+  }
+
+  const float kEps = 1e-5;
+  auto eps_ptr = IrBuilder::create<Double>(kEps);
+
+  auto norm = group_norm(input, weight, bias, eps_ptr, channels_last);
+
+  auto output = norm.output;
+  if (dtype == DataType::Half) {
+    output = castOp(DataType::Half, output);
+  }
+
+  fusion->addOutput(output);
+}
+
+//------------------------------------------------------------------------------
+
+static void NvFuserScheduler_GroupNorm(
+    benchmark::State& benchmark_state,
+    FusionExecutorCache* fusion_executor_cache,
+    DataType dtype,
+    bool channels_last = false) {
+  TORCH_INTERNAL_ASSERT(dtype == DataType::Float || dtype == DataType::Half);
+
+  const int64_t kChannels = benchmark_state.range(2);
+
+  // inputs
+  at::manual_seed(0);
+  auto options =
+      at::TensorOptions().dtype(data_type_to_aten(dtype)).device(at::kCUDA, 0);
+  at::Tensor at_x =
+      at::randn(groupedShape(benchmark_state, channels_last), options);
+  at::Tensor at_weight = at::ones({kGroups, kChannels / kGroups}, options);
+  at::Tensor at_bias = at::zeros({kGroups, kChannels / kGroups}, options);
+
+  std::vector<c10::IValue> aten_inputs = {at_x, at_weight, at_bias};
+
+  runBenchmarkIterations(benchmark_state, fusion_executor_cache, aten_inputs);
+
+  // Read: x, weight, bias
+  // Write: y
+  benchmark_state.SetBytesProcessed(
+      benchmark_state.iterations() *
+      (kChannels * 2 + at_x.numel() * 2) * dataTypeSize(dtype));
+}
+
+static void Baseline_GroupNorm(
+    benchmark::State& benchmark_state,
+    DataType dtype,
+    bool channels_last = false) {
+  TORCH_INTERNAL_ASSERT(dtype == DataType::Float || dtype == DataType::Half);
+
+  const int64_t kChannels = benchmark_state.range(2);
+  std::vector<int64_t> input_shape{
+      benchmark_state.range(0),
+      kChannels,
+      benchmark_state.range(1),
+      benchmark_state.range(1)};
+
+  const float kEps = 1e-5;
+
+  at::manual_seed(0);
+  auto options =
+      at::TensorOptions().dtype(data_type_to_aten(dtype)).device(at::kCUDA, 0);
+  if (channels_last) {
+    options = options.memory_format(c10::MemoryFormat::ChannelsLast);
+  }
+  at::Tensor at_x = at::randn(input_shape, options);
+  at::Tensor at_weight = at::ones({kChannels}, options);
+  at::Tensor at_bias = at::zeros({kChannels}, options);
+
+  clearL2Cache();
+  C10_CUDA_CHECK(cudaDeviceSynchronize());
+  for (auto _ : benchmark_state) {
+    CudaKernelTimer timer;
+
+    auto output = at::group_norm(at_x, kGroups, at_weight, at_bias, kEps);
+
+    benchmark_state.SetIterationTime(timer.elapsed() / 1000.0);
+    C10_CUDA_CHECK(cudaDeviceSynchronize());
+    clearL2Cache();
+    C10_CUDA_CHECK(cudaDeviceSynchronize());
+  }
+
+  // Read: x, weight, bias
+  // Write: y
+  benchmark_state.SetBytesProcessed(
+      benchmark_state.iterations() *
+      (kChannels * 2 + at_x.numel() * 2) * dataTypeSize(dtype));
+}
+
+//------------------------------------------------------------------------------
+
+static void Baseline_GroupNorm_fp16(benchmark::State& benchmark_state) {
+  Baseline_GroupNorm(benchmark_state, DataType::Half);
+}
+
+static void Baseline_GroupNorm_fp16_channels_last(
+    benchmark::State& benchmark_state) {
+  Baseline_GroupNorm(benchmark_state, DataType::Half, true);
+}
+
+//------------------------------------------------------------------------------
+
+NVFUSER_BENCHMARK_DEFINE(
+    NvFuserScheduler_GroupNorm_fp16,
+    setupGroupNorm,
+    NvFuserScheduler_GroupNorm,
+    DataType::Half);
+
+// Resolutions and channels of the blocks of a diffusion UNet
+NVFUSER_BENCHMARK_RUN(NvFuserScheduler_GroupNorm_fp16)
+    ->Args({2, 64, 320})
+    ->Args({2, 32, 640})
+    ->Args({2, 16, 1280})
+    ->Args({2, 8, 1280})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseManualTime();
+
+NVFUSER_BENCHMARK_DEFINE(
+    NvFuserScheduler_GroupNorm_fp16_channels_last,
+    setupGroupNorm,
+    NvFuserScheduler_GroupNorm,
+    DataType::Half,
+    true);
+
+NVFUSER_BENCHMARK_RUN(NvFuserScheduler_GroupNorm_fp16_channels_last)
+    ->Args({2, 64, 320})
+    ->Args({2, 32, 640})
+    ->Args({2, 16, 1280})
+    ->Args({2, 8, 1280})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseManualTime();
+
+//------------------------------------------------------------------------------
+
+BENCHMARK(Baseline_GroupNorm_fp16)
+    ->Args({2, 64, 320})
+    ->Args({2, 32, 640})
+    ->Args({2, 16, 1280})
+    ->Args({2, 8, 1280})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseManualTime();
+
+BENCHMARK(Baseline_GroupNorm_fp16_channels_last)
+    ->Args({2, 64, 320})
+    ->Args({2, 32, 640})
+    ->Args({2, 16, 1280})
+    ->Args({2, 8, 1280})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseManualTime();
@@ -0,0 +1,230 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <evaluator_common.h>
+#include <executor.h>
+#include <fusion.h>
+#include <ir_all_nodes.h>
+#include <kernel_cache.h>
+#include <ops/all_ops.h>
+
+#include <benchmark/benchmark.h>
+
+#include <cuda_runtime.h>
+
+#include <benchmark/utils.h>
+
+// Benchmarks of the host latency of a cache hit of
+// FusionExecutorCache::runFusionWithInputs, and of its steps. The tensors
+// are small so that the launches don't wait for the GPU, and no benchmark
+// synchronizes in its loop: the times are CPU times.
+
+namespace {
+
+// Pointwise sum of range(0) 2D inputs, scheduled as a single kernel
+std::unique_ptr<FusionExecutorCache> makeManyInputsFusion(
+    int64_t num_inputs,
+    std::vector<c10::IValue>& aten_inputs) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  FusionGuard fg(fusion_ptr.get());
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  TensorView* result = nullptr;
+  for (auto i : c10::irange(num_inputs)) {
+    (void)i;
+    auto tv = makeContigTensor(2);
+    fusion_ptr->addInput(tv);
+    result = result == nullptr ? tv : add(result, tv);
+    aten_inputs.emplace_back(at::randn({128, 128}, options));
+  }
+  fusion_ptr->addOutput(result);
+
+  return std::make_unique<FusionExecutorCache>(std::move(fusion_ptr));
+}
+
+// Chain of range(0) normalizations alternating between the inner and the
+// outer dimension, which are scheduled as one segment each
+std::unique_ptr<FusionExecutorCache> makeManySegmentsFusion(
+    int64_t num_normalizations,
+    std::vector<c10::IValue>& aten_inputs) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  FusionGuard fg(fusion_ptr.get());
+
+  auto tv = makeContigTensor(2);
+  fusion_ptr->addInput(tv);
+  for (auto i : c10::irange(num_normalizations)) {
+    const bool inner = i % 2 == 0;
+    auto sum_tv = sum(tv, {inner ? 1 : 0});
+    tv = sub(tv, broadcast(sum_tv, {!inner, inner}));
+  }
+  fusion_ptr->addOutput(tv);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  aten_inputs = {at::randn({128, 128}, options)};
+
+  return std::make_unique<FusionExecutorCache>(std::move(fusion_ptr));
+}
+
+// Compiles the fusion and records its number of segments
+void warmUp(
+    benchmark::State& benchmark_state,
+    FusionExecutorCache* fec,
+    const std::vector<c10::IValue>& aten_inputs) {
+  fec->runFusionWithInputs(aten_inputs);
+  C10_CUDA_CHECK(cudaDeviceSynchronize());
+  auto runtime = fec->getMostRecentKernelRuntime();
+  benchmark_state.counters["segments"] = runtime->isSegmented()
+      ? (double)runtime->fusionSegments()->groups().size()
+      : 1.0;
+}
+
+} // namespace
+
+//------------------------------------------------------------------------------
+
+// End-to-end cache hit, launching the kernels
+static void HostOverhead_ManyInputs(benchmark::State& benchmark_state) {
+  std::vector<c10::IValue> aten_inputs;
+  auto fec = makeManyInputsFusion(benchmark_state.range(0), aten_inputs);
+  warmUp(benchmark_state, fec.get(), aten_inputs);
+
+  for (auto _ : benchmark_state) {
+    fec->runFusionWithInputs(aten_inputs);
+  }
+  C10_CUDA_CHECK(cudaDeviceSynchronize());
+}
+
+// End-to-end cache hit, stopping right before cuLaunchKernel
+static void HostOverhead_ManyInputs_NoLaunch(
+    benchmark::State& benchmark_state) {
+  std::vector<c10::IValue> aten_inputs;
+  auto fec = makeManyInputsFusion(benchmark_state.range(0), aten_inputs);
+  warmUp(benchmark_state, fec.get(), aten_inputs);
+  fec->disableKernelLaunch();
+
+  for (auto _ : benchmark_state) {
+    fec->runFusionWithInputs(aten_inputs);
+  }
+}
+
+static void HostOverhead_ManySegments(benchmark::State& benchmark_state) {
+  std::vector<c10::IValue> aten_inputs;
+  auto fec = makeManySegmentsFusion(benchmark_state.range(0), aten_inputs);
+  warmUp(benchmark_state, fec.get(), aten_inputs);
+
+  for (auto _ : benchmark_state) {
+    fec->runFusionWithInputs(aten_inputs);
+  }
+  C10_CUDA_CHECK(cudaDeviceSynchronize());
+}
+
+static void HostOverhead_ManySegments_NoLaunch(
+    benchmark::State& benchmark_state) {
+  std::vector<c10::IValue> aten_inputs;
+  auto fec = makeManySegmentsFusion(benchmark_state.range(0), aten_inputs);
+  warmUp(benchmark_state, fec.get(), aten_inputs);
+  fec->disableKernelLaunch();
+
+  for (auto _ : benchmark_state) {
+    fec->runFusionWithInputs(aten_inputs);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Steps of a cache hit, in the order runFusionWithInputs goes through them
+
+// Encoding the inputs into the id of their shapes and strides
+static void HostOverhead_InputsIdLookup(benchmark::State& benchmark_state) {
+  std::vector<c10::IValue> aten_inputs;
+  auto fec = makeManyInputsFusion(benchmark_state.range(0), aten_inputs);
+
+  InputsIdLookup inputs_id_lookup;
+  inputs_id_lookup.lookupId(aten_inputs);
+
+  for (auto _ : benchmark_state) {
+    inputs_id_lookup.lookupId(aten_inputs);
+  }
+}
+
+// Packing the inputs into kernel arguments
+static void HostOverhead_ArgumentPacking(benchmark::State& benchmark_state) {
+  std::vector<c10::IValue> aten_inputs;
+  auto fec = makeManyInputsFusion(benchmark_state.range(0), aten_inputs);
+
+  for (auto _ : benchmark_state) {
+    KernelArgumentHolder::createKernelArgumentHolder(aten_inputs);
+  }
+}
+
+// Checking that the heuristics of the cached runtime still apply
+static void HostOverhead_RuntimeSelection(benchmark::State& benchmark_state) {
+  std::vector<c10::IValue> aten_inputs;
+  auto fec = makeManySegmentsFusion(benchmark_state.range(0), aten_inputs);
+  warmUp(benchmark_state, fec.get(), aten_inputs);
+  auto runtime = fec->getMostRecentKernelRuntime();
+  auto args = KernelArgumentHolder::createKernelArgumentHolder(aten_inputs);
+  TORCH_INTERNAL_ASSERT(runtime->getMaybeHeuristicsFor(args).has_value());
+
+  for (auto _ : benchmark_state) {
+    runtime->getMaybeHeuristicsFor(args);
+  }
+}
+
+// Evaluating the launch parameters and allocation sizes of a kernel
+static void HostOverhead_PrecomputedValues(benchmark::State& benchmark_state) {
+  std::vector<c10::IValue> aten_inputs;
+  auto fec = makeManyInputsFusion(benchmark_state.range(0), aten_inputs);
+  warmUp(benchmark_state, fec.get(), aten_inputs);
+  auto runtime = fec->getMostRecentKernelRuntime();
+  TORCH_INTERNAL_ASSERT(!runtime->isSegmented());
+  auto args = KernelArgumentHolder::createKernelArgumentHolder(aten_inputs);
+
+  PrecomputedValues precomputed_values(runtime->executors().at(0).kernel());
+  for (auto _ : benchmark_state) {
+    precomputed_values.bindInputs(args);
+    precomputed_values.evaluate();
+  }
+}
+
+//------------------------------------------------------------------------------
+
+BENCHMARK(HostOverhead_ManyInputs)
+    ->RangeMultiplier(4)
+    ->Range(1, 64)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(HostOverhead_ManyInputs_NoLaunch)
+    ->RangeMultiplier(4)
+    ->Range(1, 64)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(HostOverhead_ManySegments)
+    ->DenseRange(2, 8, 2)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(HostOverhead_ManySegments_NoLaunch)
+    ->DenseRange(2, 8, 2)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(HostOverhead_InputsIdLookup)
+    ->RangeMultiplier(4)
+    ->Range(1, 64)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(HostOverhead_ArgumentPacking)
+    ->RangeMultiplier(4)
+    ->Range(1, 64)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(HostOverhead_RuntimeSelection)
+    ->DenseRange(2, 8, 2)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(HostOverhead_PrecomputedValues)
+    ->RangeMultiplier(4)
+    ->Range(1, 64)
+    ->Unit(benchmark::kMicrosecond);
@@ -282,3 +282,106 @@ BENCHMARK(Baseline_LayerNorm_fp16)
     ->Ranges({{128, 1024 * 16}, {128, 1024 * 16}})
     ->Unit(benchmark::kMicrosecond)
     ->UseManualTime();
+
+//------------------------------------------------------------------------------
+
+// layer_norm(x + residual) updating the residual in place, see
+// Note [ Residual norms ]
+static void setupResidualLayerNorm(Fusion* fusion, DataType dtype) {
+  TORCH_INTERNAL_ASSERT(dtype == DataType::Float || dtype == DataType::Half);
+
+  FusionGuard fg(fusion);
+
+  const float kEps = 1e-5;
+
+  Double* eps_ptr = IrBuilder::create<Double>(kEps);
+
+  // setup fusion
+  auto input = makeContigTensor(2, dtype);
+  auto residual = makeContigTensor(2, dtype);
+  auto weight = makeContigTensor(1, dtype);
+  auto bias = makeContigTensor(1, dtype);
+
+  fusion->addInput(input);
+  fusion->addInput(residual);
+  fusion->addInput(weight);
+  fusion->addInput(bias);
+
+  if (dtype == DataType::Half) {
+    input = castOp(DataType::Float, input);
+    residual = castOp(DataType::Float, residual);
+    weight = castOp(DataType::Float, weight);
+    bias = castOp(DataType::Float, bias);
+  }
+
+  auto results =
+      residual_layer_norm(input, residual, 1, weight, bias, eps_ptr, true);
+
+  auto output = results.output;
+
+  if (dtype != DataType::Float) {
+    output = castOp(dtype, output);
+  }
+
+  fusion->addOutput(output);
+  fusion->addOutput(results.mean);
+  fusion->addOutput(results.invstd);
+}
+
+static void NvFuserScheduler_ResidualLayerNorm(
+    benchmark::State& benchmark_state,
+    FusionExecutorCache* fusion_executor_cache,
+    DataType dtype) {
+  TORCH_INTERNAL_ASSERT(dtype == DataType::Float || dtype == DataType::Half);
+
+  std::vector<int64_t> input_shape{
+      benchmark_state.range(0), benchmark_state.range(1)};
+
+  // inputs
+  at::manual_seed(0);
+  auto options =
+      at::TensorOptions().dtype(data_type_to_aten(dtype)).device(at::kCUDA, 0);
+  at::Tensor input = at::randn(input_shape, options);
+  at::Tensor residual = at::randn(input_shape, options);
+  at::Tensor weight = at::randn({input_shape[1]}, options);
+  at::Tensor bias = at::randn({input_shape[1]}, options);
+
+  std::vector<c10::IValue> aten_inputs({input, residual, weight, bias});
+
+  runBenchmarkIterations(benchmark_state, fusion_executor_cache, aten_inputs);
+
+  // Reads input and residual, writes output and residual
+  benchmark_state.SetBytesProcessed(
+      int64_t(benchmark_state.iterations()) *
+      (4 * input.numel() + weight.numel() + bias.numel()) *
+      int64_t(dataTypeSize(dtype)));
+}
+
+NVFUSER_BENCHMARK_DEFINE(
+    NvFuserScheduler_ResidualLayerNorm_fp32,
+    setupResidualLayerNorm,
+    NvFuserScheduler_ResidualLayerNorm,
+    DataType::Float);
+
+// GPT-2
+NVFUSER_BENCHMARK_RUN(NvFuserScheduler_ResidualLayerNorm_fp32)
+    ->Args({8 * 1024, 768})
+    ->Args({8 * 1024, 1024})
+    ->Args({8 * 1024, 1280})
+    ->Args({8 * 1024, 1600})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseManualTime();
+
+NVFUSER_BENCHMARK_DEFINE(
+    NvFuserScheduler_ResidualLayerNorm_fp16,
+    setupResidualLayerNorm,
+    NvFuserScheduler_ResidualLayerNorm,
+    DataType::Half);
+
+NVFUSER_BENCHMARK_RUN(NvFuserScheduler_ResidualLayerNorm_fp16)
+    ->Args({8 * 1024, 768})
+    ->Args({8 * 1024, 1024})
+    ->Args({8 * 1024, 1280})
+    ->Args({8 * 1024, 1600})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseManualTime();
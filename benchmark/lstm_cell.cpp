@@ -259,3 +259,122 @@ BENCHMARK_CAPTURE(LstmCell_RunFusion_CpuOnly, Small, 512, 64)
 
 BENCHMARK_CAPTURE(LstmCell_RunFusion_CpuOnly, Medium, 1024, 128)
     ->Unit(benchmark::kMicrosecond);
+
+//------------------------------------------------------------------------------
+
+// A whole timestep, recurrent projection included, see Note [ Fused LSTM
+// cells ]. Function Signature: cy, hy = lstm_cell(hx, cx, x_gates, w_hh)
+static void setupLstmCellRecurrent(Fusion* fusion, DataType dtype) {
+  FusionGuard fg(fusion);
+
+  TensorView* tvs[10];
+  for (size_t i = 0; i < 10; i++) {
+    tvs[i] = makeContigTensor(2, dtype);
+    fusion->addInput(tvs[i]);
+  }
+
+  auto lstm_result = lstm_cell(
+      tvs[0],
+      tvs[1],
+      tvs[2],
+      tvs[3],
+      tvs[4],
+      tvs[5],
+      tvs[6],
+      tvs[7],
+      tvs[8],
+      tvs[9]);
+
+  fusion->addOutput(lstm_result.cell);
+  fusion->addOutput(lstm_result.hidden);
+}
+
+static void NvFuserScheduler_LstmCellRecurrent(
+    benchmark::State& benchmark_state,
+    FusionExecutorCache* fusion_executor_cache,
+    DataType dtype) {
+  const int64_t batch_size = benchmark_state.range(0);
+  const int64_t hidden_features = benchmark_state.range(1);
+
+  at::manual_seed(0);
+  auto options =
+      at::TensorOptions().dtype(data_type_to_aten(dtype)).device(at::kCUDA, 0);
+  const auto at_hx = at::randn({batch_size, hidden_features}, options);
+  const auto at_cx = at::randn({batch_size, hidden_features}, options);
+  const auto at_gates_x =
+      at::randn({batch_size, hidden_features * 4}, options);
+  const auto at_w_hh =
+      at::randn({hidden_features * 4, hidden_features}, options);
+
+  std::vector<c10::IValue> inputs = {at_hx, at_cx};
+  const auto gates_x_chunks = at_gates_x.chunk(4, 1);
+  const auto w_hh_chunks = at_w_hh.chunk(4, 0);
+  inputs.insert(inputs.end(), gates_x_chunks.begin(), gates_x_chunks.end());
+  inputs.insert(inputs.end(), w_hh_chunks.begin(), w_hh_chunks.end());
+
+  runBenchmarkIterations(benchmark_state, fusion_executor_cache, inputs);
+
+  // Read: hx, cx, x_gates, w_hh
+  // Write: cy (Float), hy (Float)
+  benchmark_state.SetBytesProcessed(
+      benchmark_state.iterations() *
+      ((at_hx.numel() + at_cx.numel() + at_gates_x.numel() +
+        at_w_hh.numel()) *
+           dataTypeSize(dtype) +
+       2 * at_cx.numel() * dataTypeSize(DataType::Float)));
+}
+
+// A GEMM for the recurrent projection and the pointwise cell math, as run by
+// torch.nn.LSTMCell
+static void Baseline_LstmCellRecurrent(
+    benchmark::State& benchmark_state,
+    DataType dtype) {
+  const int64_t batch_size = benchmark_state.range(0);
+  const int64_t hidden_features = benchmark_state.range(1);
+
+  at::manual_seed(0);
+  auto options =
+      at::TensorOptions().dtype(data_type_to_aten(dtype)).device(at::kCUDA, 0);
+  const auto at_hx = at::randn({batch_size, hidden_features}, options);
+  const auto at_cx = at::randn({batch_size, hidden_features}, options);
+  const auto at_gates_x =
+      at::randn({batch_size, hidden_features * 4}, options);
+  const auto at_w_hh =
+      at::randn({hidden_features * 4, hidden_features}, options);
+
+  clearL2Cache();
+  C10_CUDA_CHECK(cudaDeviceSynchronize());
+  for (auto _ : benchmark_state) {
+    CudaKernelTimer timer;
+
+    auto gates = at::addmm(at_gates_x, at_hx, at_w_hh.t()).chunk(4, 1);
+    auto cy = gates[1].sigmoid() * at_cx + gates[0].sigmoid() * gates[2].tanh();
+    auto hy = gates[3].sigmoid() * cy.tanh();
+
+    benchmark_state.SetIterationTime(timer.elapsed() / 1000.0);
+    C10_CUDA_CHECK(cudaDeviceSynchronize());
+    clearL2Cache();
+    C10_CUDA_CHECK(cudaDeviceSynchronize());
+  }
+}
+
+static void Baseline_LstmCellRecurrent_fp32(benchmark::State& benchmark_state) {
+  Baseline_LstmCellRecurrent(benchmark_state, DataType::Float);
+}
+
+NVFUSER_BENCHMARK_DEFINE(
+    NvFuserScheduler_LstmCellRecurrent_fp32,
+    setupLstmCellRecurrent,
+    NvFuserScheduler_LstmCellRecurrent,
+    DataType::Float);
+
+// Batch sizes and hidden features of streaming speech models
+NVFUSER_BENCHMARK_RUN(NvFuserScheduler_LstmCellRecurrent_fp32)
+    ->ArgsProduct({{1, 4, 16}, {512, 1024}})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseManualTime();
+
+BENCHMARK(Baseline_LstmCellRecurrent_fp32)
+    ->ArgsProduct({{1, 4, 16}, {512, 1024}})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseManualTime();
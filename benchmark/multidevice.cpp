@@ -0,0 +1,240 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#ifdef USE_DISTRIBUTED
+#include <fusion.h>
+#include <ir_all_nodes.h>
+#include <multidevice/multicluster_fusion.h>
+#include <multidevice/multidevice_runtime.h>
+#include <ops/all_ops.h>
+
+#include <benchmark/benchmark.h>
+
+#include <ATen/cuda/CUDAContext.h>
+#include <multidevice/ProcessGroupBuilder.hpp>
+#include <torch/csrc/distributed/c10d/TCPStore.hpp>
+
+#include <benchmark/utils.h>
+
+using namespace nvfuser;
+
+// Benchmarks of the communication path of MultiDeviceRuntime. They are run
+// by every rank of a single node launched with mpirun, e.g.
+//   mpirun -np 2 nvfuser_bench --benchmark_filter=MultiDevice
+// Every rank must run the same benchmarks with the same arguments, and the
+// iterations are fixed so that the communications of the ranks match.
+
+namespace {
+
+struct Communicator {
+  int rank = 0;
+  int size = 0;
+  c10::intrusive_ptr<c10d::Backend> backend;
+};
+
+// Returns the process group of the ranks, or nullptr when the benchmarks are
+// not run by a distributed launcher
+Communicator* getCommunicator() {
+  static std::unique_ptr<Communicator> communicator =
+      []() -> std::unique_ptr<Communicator> {
+    auto communicator = std::make_unique<Communicator>();
+    if (parseEnv(communicator->rank, communicator->size) ||
+        at::cuda::getNumGPUs() < communicator->size) {
+      return nullptr;
+    }
+    c10d::TCPStoreOptions store_opts;
+    store_opts.isServer = communicator->rank == 0;
+    auto store = c10::make_intrusive<c10d::TCPStore>("localhost", store_opts);
+    communicator->backend = ProcessGroupBuilder().getProcessGroup(
+        "nccl", store, communicator->rank, communicator->size);
+    return communicator;
+  }();
+  return communicator.get();
+}
+
+at::TensorOptions deviceOptions(const Communicator* communicator) {
+  return at::TensorOptions().dtype(at::kFloat).device(
+      at::kCUDA, communicator->rank);
+}
+
+// Times `run` on every rank after a warm-up run compiling the kernels, each
+// iteration starting at a barrier
+void runMultiDeviceIterations(
+    benchmark::State& benchmark_state,
+    const Communicator* communicator,
+    const std::function<void()>& run) {
+  run();
+  C10_CUDA_CHECK(cudaDeviceSynchronize());
+  for (auto _ : benchmark_state) {
+    communicator->backend->barrier()->wait();
+    CudaKernelTimer timer;
+    run();
+    benchmark_state.SetIterationTime(timer.elapsed() / 1000.0);
+  }
+  C10_CUDA_CHECK(cudaDeviceSynchronize());
+}
+
+} // namespace
+
+//------------------------------------------------------------------------------
+
+// Rank 0 sends a tensor of range(0) floats to rank 1
+static void MultiDevice_SendRecv(benchmark::State& benchmark_state) {
+  auto communicator = getCommunicator();
+  if (communicator == nullptr || communicator->size < 2) {
+    benchmark_state.SkipWithError("needs at least 2 ranks");
+    return;
+  }
+  const auto size = benchmark_state.range(0);
+
+  MultiClusterFusion fusion;
+  FusionGuard fg(&fusion);
+  TensorView* tv = makeContigTensor(1);
+  fusion.addInput(tv);
+
+  fusion.newCluster({.process_rank = 0});
+  auto tv0 = set(tv);
+  fusion.addClusterOutput(tv0);
+
+  fusion.newCluster({.process_rank = 1});
+  auto tv1 = set(tv0);
+  fusion.addClusterOutput(tv1);
+  fusion.addOutput(tv1);
+
+  MultiDeviceRuntime runtime(fusion.aggregateDag(), communicator->backend);
+  at::Tensor input = at::randn({size}, deviceOptions(communicator));
+
+  runMultiDeviceIterations(
+      benchmark_state, communicator, [&]() { runtime.runWithInput({input}); });
+
+  benchmark_state.SetBytesProcessed(
+      int64_t(benchmark_state.iterations()) * size * int64_t(sizeof(float)));
+}
+
+// A pipeline of one stage per rank, run on range(1) micro-batches of an
+// input of range(0) rows of 1024 floats
+static void MultiDevice_Pipeline(benchmark::State& benchmark_state) {
+  auto communicator = getCommunicator();
+  if (communicator == nullptr) {
+    benchmark_state.SkipWithError("distributed config is not provided");
+    return;
+  }
+  const auto rows = benchmark_state.range(0);
+  const auto num_micro_batches = benchmark_state.range(1);
+
+  MultiClusterFusion fusion;
+  FusionGuard fg(&fusion);
+  TensorView* tv = makeContigTensor(2);
+  fusion.addInput(tv);
+
+  for (auto rank : c10::irange(communicator->size)) {
+    fusion.newCluster({.process_rank = rank});
+    tv = add(mul(tv, IrBuilder::create<Double>(2.0)),
+             IrBuilder::create<Double>(1.0));
+    fusion.addClusterOutput(tv);
+  }
+  fusion.addOutput(tv);
+
+  MultiDeviceRuntime runtime(fusion.aggregateDag(), communicator->backend);
+  at::Tensor input = at::randn({rows, 1024}, deviceOptions(communicator));
+
+  runMultiDeviceIterations(benchmark_state, communicator, [&]() {
+    runtime.runWithMicroBatches({input}, num_micro_batches);
+  });
+
+  benchmark_state.SetItemsProcessed(
+      int64_t(benchmark_state.iterations()) * rows);
+}
+
+// Megatron-style tensor-parallel MLP: every rank multiplies the replicated
+// input of range(0) rows of range(1) features by its column shard of the
+// first weight and the matching row shard of the second weight, whose
+// partial results are all-reduced. The matmuls are expressed as broadcasts
+// and sums.
+static void MultiDevice_TensorParallelMLP(benchmark::State& benchmark_state) {
+  auto communicator = getCommunicator();
+  if (communicator == nullptr) {
+    benchmark_state.SkipWithError("distributed config is not provided");
+    return;
+  }
+  const auto batch = benchmark_state.range(0);
+  const auto hidden = benchmark_state.range(1);
+  const auto shard = 4 * hidden / communicator->size;
+
+  MultiClusterFusion fusion;
+  FusionGuard fg(&fusion);
+  TensorView* x = makeContigTensor(2);
+  fusion.addInput(x);
+
+  std::vector<TensorView*> partials;
+  for (auto rank : c10::irange(communicator->size)) {
+    TensorView* w1 = makeContigTensor(2);
+    TensorView* w2 = makeContigTensor(2);
+    fusion.addInput(w1);
+    fusion.addInput(w2);
+
+    fusion.newCluster({.process_rank = rank});
+    auto h = sum(
+        mul(broadcast(x, {false, false, true}),
+            broadcast(w1, {true, false, false})),
+        {1});
+    h = relu(h);
+    auto y = sum(
+        mul(broadcast(h, {false, false, true}),
+            broadcast(w2, {true, false, false})),
+        {1});
+    fusion.addClusterOutput(y);
+    partials.push_back(y);
+  }
+  auto y = fusion.addCollective(CollectiveType::AllReduce, partials);
+
+  for (auto rank : c10::irange(communicator->size)) {
+    fusion.newCluster({.process_rank = rank});
+    auto output = set(y);
+    fusion.addClusterOutput(output);
+    fusion.addOutput(output);
+  }
+
+  MultiDeviceRuntime runtime(fusion.aggregateDag(), communicator->backend);
+  auto options = deviceOptions(communicator);
+  // The weights of the other ranks are only placeholders
+  std::vector<c10::IValue> inputs = {at::randn({batch, hidden}, options)};
+  for (auto rank : c10::irange(communicator->size)) {
+    (void)rank;
+    inputs.emplace_back(at::randn({hidden, shard}, options));
+    inputs.emplace_back(at::randn({shard, hidden}, options));
+  }
+
+  runMultiDeviceIterations(
+      benchmark_state, communicator, [&]() { runtime.runWithInput(inputs); });
+
+  benchmark_state.SetItemsProcessed(
+      int64_t(benchmark_state.iterations()) * batch);
+}
+
+//------------------------------------------------------------------------------
+
+BENCHMARK(MultiDevice_SendRecv)
+    ->RangeMultiplier(16)
+    ->Range(1 << 10, 1 << 26)
+    ->Iterations(20)
+    ->Unit(benchmark::kMicrosecond)
+    ->UseManualTime();
+
+BENCHMARK(MultiDevice_Pipeline)
+    ->ArgsProduct({{1024, 16 * 1024}, {1, 4, 16}})
+    ->Iterations(20)
+    ->Unit(benchmark::kMicrosecond)
+    ->UseManualTime();
+
+BENCHMARK(MultiDevice_TensorParallelMLP)
+    ->ArgsProduct({{16, 128}, {256, 1024}})
+    ->Iterations(10)
+    ->Unit(benchmark::kMicrosecond)
+    ->UseManualTime();
+
+#endif
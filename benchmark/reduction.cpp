@@ -74,16 +74,21 @@ static void NvFuserScheduler_Reduction(
   executor_instance->setMeasureKernelTimeFlag(true);
   // Sync everything up before we start
   C10_CUDA_CHECK(cudaDeviceSynchronize());
+  double kernel_seconds = 0;
   for (auto _ : benchmark_state) {
     clearL2Cache();
     auto cg_outputs = fusion_executor_cache->runFusionWithInputs({aten_input});
     benchmark_state.SetIterationTime(
         executor_instance->kernelTimeMs() / 1000.0);
+    kernel_seconds += executor_instance->kernelTimeMs() / 1000.0;
   }
   // Sync everything up before we're finished, don't want to run ahead on the
   // cpu while benchmarking.
   C10_CUDA_CHECK(cudaDeviceSynchronize());
 
+  setBandwidthCounters(
+      benchmark_state, executor_instance->bytesProcessed(), kernel_seconds);
+
   benchmark_state.SetBytesProcessed(
       int64_t(benchmark_state.iterations()) *
       (iter_size * reduction_size + iter_size) * int64_t(dataTypeSize(dtype)));
@@ -173,3 +173,96 @@ NVFUSER_BENCHMARK_RUN(NvFuserScheduler_RMSNorm_fp16)
 //     ->Ranges({{24, 48}})
 //     ->Unit(benchmark::kMicrosecond)
 //     ->UseManualTime();
+
+//------------------------------------------------------------------------------
+
+// rms_norm(x + residual) updating the residual in place, see
+// Note [ Residual norms ]
+static void setupResidualRMSNorm(Fusion* fusion, DataType dtype) {
+  TORCH_INTERNAL_ASSERT(
+      dtype == DataType::Float || dtype == DataType::Half ||
+      dtype == DataType::BFloat16);
+
+  FusionGuard fg(fusion);
+
+  const float kEps = 1e-6;
+
+  Double* eps_ptr = IrBuilder::create<Double>(kEps);
+
+  // setup fusion
+  auto input = makeContigTensor(3, dtype);
+  auto residual = makeContigTensor(3, dtype);
+  auto weight = makeContigTensor(1, dtype);
+
+  fusion->addInput(input);
+  fusion->addInput(residual);
+  fusion->addInput(weight);
+
+  if (dtype == DataType::Half) {
+    input = castOp(DataType::Float, input);
+    residual = castOp(DataType::Float, residual);
+    weight = castOp(DataType::Float, weight);
+  }
+
+  auto results = residual_rms_norm(input, residual, 1, weight, eps_ptr, true);
+
+  auto output = results.output;
+
+  if (dtype != DataType::Float) {
+    output = castOp(dtype, output);
+  }
+
+  fusion->addOutput(output);
+}
+
+static void NvFuserScheduler_ResidualRMSNorm(
+    benchmark::State& benchmark_state,
+    FusionExecutorCache* fusion_executor_cache,
+    DataType dtype) {
+  TORCH_INTERNAL_ASSERT(
+      dtype == DataType::Float || dtype == DataType::Half ||
+      dtype == DataType::BFloat16);
+
+  std::vector<int64_t> input_shape{8, benchmark_state.range(0), 1024};
+
+  // inputs
+  at::manual_seed(0);
+  auto options =
+      at::TensorOptions().dtype(data_type_to_aten(dtype)).device(at::kCUDA, 0);
+  at::Tensor input = at::randn(input_shape, options);
+  at::Tensor residual = at::randn(input_shape, options);
+  at::Tensor weight = at::randn({input_shape[2]}, options);
+
+  std::vector<c10::IValue> aten_inputs({input, residual, weight});
+
+  runBenchmarkIterations(benchmark_state, fusion_executor_cache, aten_inputs);
+
+  // Reads input and residual, writes output and residual
+  benchmark_state.SetBytesProcessed(
+      int64_t(benchmark_state.iterations()) *
+      (4 * input.numel() + weight.numel()) * int64_t(dataTypeSize(dtype)));
+}
+
+NVFUSER_BENCHMARK_DEFINE(
+    NvFuserScheduler_ResidualRMSNorm_fp32,
+    setupResidualRMSNorm,
+    NvFuserScheduler_ResidualRMSNorm,
+    DataType::Float);
+
+NVFUSER_BENCHMARK_RUN(NvFuserScheduler_ResidualRMSNorm_fp32)
+    ->RangeMultiplier(2)
+    ->Ranges({{16, 64}})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseManualTime();
+
+NVFUSER_BENCHMARK_DEFINE(
+    NvFuserScheduler_ResidualRMSNorm_fp16,
+    setupResidualRMSNorm,
+    NvFuserScheduler_ResidualRMSNorm,
+    DataType::Half);
+
+NVFUSER_BENCHMARK_RUN(NvFuserScheduler_ResidualRMSNorm_fp16)
+    ->RangeMultiplier(2)
+    ->Ranges({{16, 64}})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseManualTime();
@@ -165,6 +165,29 @@ TensorView* makeContigConcreteTensor(
   return TensorViewBuilder().shape(shape).dtype(dtype).contiguity(true).build();
 }
 
+double peakDramBandwidth() {
+  auto prop = at::cuda::getCurrentDeviceProperties();
+  // memoryClockRate is in kHz and memoryBusWidth in bits, and DRAM transfers
+  // twice per clock
+  return 2.0 * (double)prop->memoryClockRate * 1.0e3 *
+      (double)prop->memoryBusWidth / 8.0;
+}
+
+void setBandwidthCounters(
+    benchmark::State& benchmark_state,
+    int64_t bytes_per_iteration,
+    double seconds) {
+  if (seconds <= 0) {
+    return;
+  }
+  const double bytes_per_second =
+      (double)bytes_per_iteration * (double)benchmark_state.iterations() /
+      seconds;
+  benchmark_state.counters["bandwidth_GBps"] = bytes_per_second / 1.0e9;
+  benchmark_state.counters["peak_bandwidth_pct"] =
+      100.0 * bytes_per_second / peakDramBandwidth();
+}
+
 void runBenchmarkIterations(
     benchmark::State& benchmark_state,
     FusionExecutorCache* fusion_executor_cache,
@@ -192,15 +215,20 @@ void runBenchmarkIterations(
 
     // Sync everything up before we start
     C10_CUDA_CHECK(cudaDeviceSynchronize());
+    double kernel_seconds = 0;
     for (auto _ : benchmark_state) {
       clearL2Cache();
       auto cg_outputs = fusion_executor_cache->runFusionWithInputs(aten_inputs);
       benchmark_state.SetIterationTime(
           executor_instance->kernelTimeMs() / 1000.0);
+      kernel_seconds += executor_instance->kernelTimeMs() / 1000.0;
     }
     // Sync everything up before we're finished, don't want to run ahead on the
     // cpu while benchmarking.
     C10_CUDA_CHECK(cudaDeviceSynchronize());
+
+    setBandwidthCounters(
+        benchmark_state, executor_instance->bytesProcessed(), kernel_seconds);
   } else {
     // Segmented
     // Sync everything up before we start
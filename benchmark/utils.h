@@ -50,9 +50,22 @@ std::string toString(const TransposeParams& params);
 std::string toString(const std::shared_ptr<HeuristicParams>& params);
 std::string toString(LaunchParams lparams);
 
+// Theoretical DRAM bandwidth of the current device, in bytes per second
+double peakDramBandwidth();
+
+// Reports the bandwidth achieved by the iterations of the benchmark, moving
+// `bytes_per_iteration` bytes each in `seconds` overall, in GB/s and in
+// percent of peakDramBandwidth(). The counters are part of the JSON output
+// of --benchmark_format=json.
+void setBandwidthCounters(
+    benchmark::State& benchmark_state,
+    int64_t bytes_per_iteration,
+    double seconds);
+
 // Run benchmark iterations with provided inputs. If not segmented, report
-// kernel time from the runtime, as well as heuristic parameters. If segmented
-// use timers. Make sure to clear L2 between iterations.
+// kernel time from the runtime, as well as heuristic parameters, and the
+// bandwidth achieved by the kernel. If segmented use timers. Make sure to
+// clear L2 between iterations.
 void runBenchmarkIterations(
     benchmark::State& benchmark_state,
     FusionExecutorCache* fusion_executor_cache,
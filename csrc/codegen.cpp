@@ -8,6 +8,7 @@
 #include <codegen.h>
 #include <instrumentation.h>
 #include <ir_utils.h>
+#include <kernel_db/utils.h>
 #include <kernel_ir.h>
 #include <kernel_ir_dispatch.h>
 #include <lower_utils.h>
@@ -15,6 +16,7 @@
 #include <type.h>
 #include <utils.h>
 
+#include <algorithm>
 #include <array>
 #include <cmath>
 #include <sstream>
@@ -120,21 +122,81 @@ std::string genCall(
   return ss.str();
 }
 
+// Note [ Streaming kernel emission ]
+//
+// The kernel is emitted through a single std::ostream whose buffer appends
+// straight to the string that is eventually returned, rather than through a
+// std::stringstream that is copied out at the end. Subexpressions rendered by
+// gen() are written to a plain string by temporarily redirecting that buffer,
+// instead of constructing and imbuing a new std::stringstream for every
+// statement.
+//
+// While bytes are appended to the kernel itself, their fnv1a_hash is
+// accumulated as well, so the key of the kernel db (see kernel_db.h) is known
+// as soon as the code is generated, without another pass over a possibly
+// megabyte-sized string.
+class KernelCodeBuffer : public std::streambuf {
+ public:
+  explicit KernelCodeBuffer(std::string* code) : code_(code), out_(code) {}
+
+  //! Appends to out until the next redirect, returns the previous target
+  std::string* redirect(std::string* out) {
+    std::swap(out, out_);
+    return out;
+  }
+
+  //! fnv1a_hash of what has been appended to the code so far
+  uint64_t hash() const {
+    return hash_;
+  }
+
+ protected:
+  int_type overflow(int_type ch) final {
+    if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+      const char c = traits_type::to_char_type(ch);
+      append(&c, 1);
+    }
+    return traits_type::not_eof(ch);
+  }
+
+  std::streamsize xsputn(const char* s, std::streamsize n) final {
+    append(s, (size_t)n);
+    return n;
+  }
+
+ private:
+  void append(const char* s, size_t n) {
+    out_->append(s, n);
+    if (out_ == code_) {
+      hash_ = fnv1a_hash(s, n, hash_);
+    }
+  }
+
+  std::string* code_ = nullptr;
+  std::string* out_ = nullptr;
+  uint64_t hash_ = kFnv1aOffsetBasis;
+};
+
 class CudaKernelGenerator : private OptOutConstDispatch {
   static constexpr const char* kTab = "  ";
 
  public:
   static std::string generateKernelDefinition(
       const kir::Kernel* kernel,
-      const std::string& kernel_name) {
+      const std::string& kernel_name,
+      const LaunchBounds& launch_bounds,
+      uint64_t* code_hash) {
     CudaKernelGenerator codegen(kernel);
-    codegen.genDeclaration(kernel_name);
+    codegen.genDeclaration(kernel_name, launch_bounds);
     codegen.startBlock();
     codegen.genPrologue();
     codegen.genBody();
     codegen.endBlock();
     TORCH_CHECK(codegen.block_nest_level_ == 0);
-    return codegen.code_.str();
+    if (code_hash != nullptr) {
+      *code_hash = codegen.code_buffer_.hash();
+    }
+    return std::move(codegen.kernel_code_);
   }
 
  private:
@@ -142,14 +204,14 @@ class CudaKernelGenerator : private OptOutConstDispatch {
     initStringStreamFormat(code_);
   }
 
-  void initStringStreamFormat(std::stringstream& ss) {
+  void initStringStreamFormat(std::ostream& ss) {
     ss.imbue(std::locale("C"));
     ss << std::scientific;
     // Set the default precision as Double
     setPrecision(ss, DataType::Double);
   }
 
-  void setPrecision(std::stringstream& ss, DataType dtype) {
+  void setPrecision(std::ostream& ss, DataType dtype) {
     TORCH_INTERNAL_ASSERT(isFloatingPointType(dtype));
     ss << std::setprecision(max_digits10(dtype));
   }
@@ -167,10 +229,20 @@ class CudaKernelGenerator : private OptOutConstDispatch {
   }
 
   // Generates the kernel function declaration
-  void genDeclaration(const std::string& kernel_name) {
+  void genDeclaration(
+      const std::string& kernel_name,
+      const LaunchBounds& launch_bounds) {
     const auto& kernel_summary = kernel_->summary();
 
-    code_ << "__global__ void " << kernel_name << "(";
+    code_ << "__global__ void ";
+    if (!launch_bounds.empty()) {
+      code_ << "__launch_bounds__(" << launch_bounds.max_threads_per_block;
+      if (launch_bounds.min_blocks_per_sm > 0) {
+        code_ << ", " << launch_bounds.min_blocks_per_sm;
+      }
+      code_ << ") ";
+    }
+    code_ << kernel_name << "(";
 
     std::unordered_set<Val*> unique_args;
 
@@ -257,6 +329,8 @@ class CudaKernelGenerator : private OptOutConstDispatch {
           << "  static_cast<uint64_t>(*(philox_args.offset_.ptr) + philox_args.offset_intragraph_) :\n";
       indent() << "  philox_args.offset_.val;\n";
       indent() << "uint4 rng_result;\n";
+      indent() << "float4 rng_normalf;\n";
+      indent() << "double2 rng_normal;\n";
       indent() << "nvfuser_index_t rng_subseq = -1;\n";
       indent() << "nvfuser_index_t rng_offset = -1;\n";
     }
@@ -303,6 +377,15 @@ class CudaKernelGenerator : private OptOutConstDispatch {
                 << ")";
             smem_buf_size = smem_buf_size_with_outer_opt.str();
           }
+          if (kernel_summary.has_outer_grouped_grid_reduction) {
+            std::stringstream smem_buf_size_with_outer_opt;
+            smem_buf_size_with_outer_opt
+                << "max(" << smem_buf_size << ", "
+                << kernel_summary
+                       .outer_grouped_grid_reduction_largest_smem_size
+                << ")";
+            smem_buf_size = smem_buf_size_with_outer_opt.str();
+          }
           indent() << "smem_offset += " << smem_buf_size << ";\n";
         }
 
@@ -320,6 +403,15 @@ class CudaKernelGenerator : private OptOutConstDispatch {
                    << " *shared_mem_n = shared_mem_avg + block_size;\n";
         }
       }
+
+      // Buffers with offsets assigned at lowering, see
+      // Note [ Shared memory offset packing ]
+      if (kernel_summary.packed_smem.size > 0) {
+        indent() << "const unsigned smem_packed_offset = "
+                 << "alignBufferSize(smem_offset, 16);\n";
+        indent() << "smem_offset = smem_packed_offset + "
+                 << kernel_summary.packed_smem.size << ";\n";
+      }
     }
 
     // Call the initialization function if using a custom block sync
@@ -328,10 +420,69 @@ class CudaKernelGenerator : private OptOutConstDispatch {
     }
   }
 
+  // Returns if an expr accesses global memory, other than the allocation of
+  // a buffer
+  static bool accessesGlobalMemory(const Expr* expr) {
+    const std::vector<Expr*> loop_nest{const_cast<Expr*>(expr)};
+    for (auto flat_expr : ir_utils::flattenScopedExprs(loop_nest)) {
+      if (flat_expr->isA<kir::Allocate>()) {
+        continue;
+      }
+      if (flat_expr->isOneOf<
+              kir::GridReduction,
+              kir::GroupedGridReduction,
+              kir::GridBroadcast,
+              kir::GridWelford,
+              kir::GroupedGridWelford,
+              kir::GridSync>()) {
+        return true;
+      }
+      for (const auto& vals : {flat_expr->inputs(), flat_expr->outputs()}) {
+        for (auto val : vals) {
+          auto ti = dynamic_cast<kir::TensorIndex*>(val);
+          if (ti != nullptr &&
+              ti->view()->getMemoryType() == MemoryType::Global) {
+            return true;
+          }
+        }
+      }
+    }
+    return false;
+  }
+
   void genBody() {
-    for (auto expr : kernel_->topLevelExprs()) {
+    const auto& exprs = kernel_->topLevelExprs();
+    // See Note [ Programmatic dependent launch ]
+    auto first_global_access = exprs.end();
+    if (isOptionEnabled(EnableOption::ProgrammaticLaunch)) {
+      first_global_access =
+          std::find_if(exprs.begin(), exprs.end(), accessesGlobalMemory);
+    }
+    for (auto it = exprs.begin(); it != exprs.end(); ++it) {
+      if (it == first_global_access) {
+        code_ << "#if __CUDA_ARCH__ >= 900\n";
+        indent() << "asm volatile(\"griddepcontrol.wait;\" ::: \"memory\");\n";
+        indent() << "asm volatile(\"griddepcontrol.launch_dependents;\");\n";
+        code_ << "#endif\n";
+      }
+      genExpr(*it);
+    }
+  }
+
+  // Generates an expression of the kernel body, surrounded by the timeline
+  // records of its block if it is profiled. See
+  // Note [ Kernel profile timeline ]
+  void genExpr(const Expr* expr) {
+    const auto timeline = kernel_->profile().getTimelineBuffer();
+    if (timeline == nullptr || !kernel_->profile().isProfiled(expr)) {
       OptOutConstDispatch::handle(expr);
+      return;
     }
+    const auto timeline_args = ir_utils::varName(timeline) + ".data, " +
+        std::to_string(kernel_->profile().getIndexInTimelineBuffer(expr));
+    indent() << "profileTimelineBegin(" << timeline_args << ");\n";
+    OptOutConstDispatch::handle(expr);
+    indent() << "profileTimelineEnd(" << timeline_args << ");\n";
   }
 
   void startBlock(bool continuation = false) {
@@ -357,13 +508,17 @@ class CudaKernelGenerator : private OptOutConstDispatch {
     return code_;
   }
 
+  // See Note [ Streaming kernel emission ]
   std::string gen(const Statement* stmt) {
-    std::stringstream tmp_code;
-    initStringStreamFormat(tmp_code);
-    std::swap(tmp_code, code_);
+    std::string tmp_code;
+    auto saved_out = code_buffer_.redirect(&tmp_code);
+    // Like a fresh stream, always start from the default precision
+    const auto saved_precision = code_.precision();
+    setPrecision(code_, DataType::Double);
     OptOutConstDispatch::handle(stmt);
-    std::swap(tmp_code, code_);
-    return tmp_code.str();
+    code_.precision(saved_precision);
+    code_buffer_.redirect(saved_out);
+    return tmp_code;
   }
 
   std::string genInline(const Statement* stmt) {
@@ -375,6 +530,17 @@ class CudaKernelGenerator : private OptOutConstDispatch {
     return result;
   }
 
+  //! Returns the cache hint template argument of the vectorized global
+  //! memory accesses of tv, see Note [ Cache hints ]
+  std::string genCacheHint(const TensorView* tv) {
+    if (tv->cacheHint() == CacheHint::Default) {
+      return "";
+    }
+    std::stringstream ss;
+    ss << ", CacheHint::" << tv->cacheHint();
+    return ss.str();
+  }
+
   void handle(const kir::Predicate* pred) final {
     TORCH_INTERNAL_ASSERT(pred->hasValue());
     code_ << gen(pred->value());
@@ -673,14 +839,15 @@ class CudaKernelGenerator : private OptOutConstDispatch {
           if (localToGlobal) {
             indent() << "loadLocalToGlobal<" << uop->out()->dtype() << ", "
                      << vector_word_size << ", "
-                     << (is_volatile_to ? "true" : "false") << ">(";
+                     << (is_volatile_to ? "true" : "false")
+                     << genCacheHint(out_tv) << ">(";
             code_ << " &" << gen(uop->out()) << ", &" << gen(uop->in())
                   << ");\n";
           } else if (globalToLocal) {
             indent() << "loadGlobalToLocal<" << uop->out()->dtype() << ", "
                      << vector_word_size << ", "
-                     << (is_volatile_from ? "true" : "false") << ">(&"
-                     << gen(uop->out()) << ", ";
+                     << (is_volatile_from ? "true" : "false")
+                     << genCacheHint(in_tv) << ">(&" << gen(uop->out()) << ", ";
             code_ << " &" << gen(uop->in()) << ");\n";
           } else if (globalToGlobal) {
             indent() << "loadGlobalToGlobal<" << uop->out()->dtype() << ", "
@@ -760,20 +927,42 @@ class CudaKernelGenerator : private OptOutConstDispatch {
              << rop->getRNGOffset() << ";\n";
     indent() << "if (rng_subseq != rng_subseq" << rop->name()
              << " || rng_offset != rng_offset" << rop->name() << ") {\n";
-    indent() << "  auto seed = philox_args.captured_ ?\n"
-             << "      static_cast<uint64_t>(*(philox_args.seed_.ptr)) : \n"
-             << "      philox_args.seed_.val;\n";
-    indent() << "  rng_result = philox(seed, rng_subseq" << rop->name()
-             << ", philox_offset / 4 + rng_offset" << rop->name() << ");\n";
+    if (rop->hasExplicitPhilox()) {
+      // See Note [ Explicit Philox seed and offset ]
+      indent() << "  rng_result = philox("
+               << "static_cast<uint64_t>(" << genInline(rop->getPhiloxSeed())
+               << "), rng_subseq" << rop->name() << ", static_cast<uint64_t>("
+               << genInline(rop->getPhiloxOffset()) << ") / 4);\n";
+    } else {
+      indent() << "  auto seed = philox_args.captured_ ?\n"
+               << "      static_cast<uint64_t>(*(philox_args.seed_.ptr)) : \n"
+               << "      philox_args.seed_.val;\n";
+      indent() << "  rng_result = philox(seed, rng_subseq" << rop->name()
+               << ", philox_offset / 4 + rng_offset" << rop->name() << ");\n";
+    }
+    // Normals are generated in pairs by the Box-Muller transform, so
+    // transform all the components of a Philox result at once and let the
+    // following elements that share it just pick their normal
+    auto op_type = rop->getRNGOpType();
+    const bool is_normal = op_type == RNGOpType::NormalStandard ||
+        op_type == RNGOpType::NormalGeneral;
+    const bool is_float = rop->dtype() == DataType::Float;
+    std::string rng_state = "rng_result";
+    if (is_normal && is_float) {
+      rng_state = "rng_normalf";
+      indent() << "  rng_normalf = rng_normal_standard4f(rng_result);\n";
+    } else if (is_normal) {
+      rng_state = "rng_normal";
+      indent() << "  rng_normal = rng_normal_standard2(rng_result);\n";
+    }
     indent() << "  rng_subseq = rng_subseq" << rop->name() << ";\n";
     indent() << "  rng_offset = rng_offset" << rop->name() << ";\n";
     indent() << "}\n";
-    auto op_type = rop->getRNGOpType();
     indent() << gen(rop->output(0)) << " = " << op_type;
-    if (needFloatSuffix(op_type) && rop->dtype() == DataType::Float) {
+    if (needFloatSuffix(op_type) && is_float) {
       code_ << "f";
     }
-    code_ << "(rng_result, rng_component" << rop->name();
+    code_ << "(" << rng_state << ", rng_component" << rop->name();
     switch (op_type) {
       case RNGOpType::UniformRange: {
         auto parameters = rop->getParameters();
@@ -1024,6 +1213,33 @@ class CudaKernelGenerator : private OptOutConstDispatch {
   }
 
   void handle(const IndexSelectOp* sop) final {
+    // A row of the lookup tensor loaded into registers with a vector load,
+    // see isVectorizedIndexSelect in lower_validation.cpp
+    if (vectorize_scope_ && sop->output(0)->isA<kir::TensorIndex>()) {
+      auto out_tv = sop->output(0)->as<kir::TensorIndex>()->view();
+      auto vectorized_id = std::find_if(
+          out_tv->domain()->domain().begin(),
+          out_tv->domain()->domain().end(),
+          [](IterDomain* id) {
+            return id->getParallelType() == ParallelType::Vectorize;
+          });
+      if (vectorized_id != out_tv->domain()->domain().end()) {
+        TORCH_INTERNAL_ASSERT(
+            (*vectorized_id)->extent()->isConstInt(),
+            "Could not evaluate constant value bound to vectorized dim.");
+        auto lookup_tv = sop->input(0)->as<kir::TensorIndex>()->view();
+        TORCH_INTERNAL_ASSERT(
+            out_tv->getMemoryType() == MemoryType::Local &&
+                lookup_tv->getMemoryType() == MemoryType::Global,
+            "Vectorized index_select must load from global to local memory.");
+        indent() << "loadGlobalToLocal<" << sop->output(0)->dtype() << ", "
+                 << (*vectorized_id)->extent()->evaluateInt() << ", false"
+                 << genCacheHint(lookup_tv) << ">(&" << gen(sop->output(0))
+                 << ", &" << gen(sop->input(0)) << ");\n";
+        return;
+      }
+    }
+
     // generate code
     if (!print_inline_) {
       indent() << gen(sop->output(0));
@@ -1043,11 +1259,31 @@ class CudaKernelGenerator : private OptOutConstDispatch {
       // When value of index_tv are not unique, the behavior of Set is
       // non-deterministic
       indent() << gen(sop->output(0)) << " = " << gen(sop->input(2)) << ";\n";
+    } else if (sop->getScatterOpType() == ScatterOpType::Add) {
+      // Duplicated indices are summed atomically, see runtime/scatter.cu
+      indent() << "scatter::add(" << gen(sop->output(0)) << ", "
+               << gen(sop->input(2)) << ");\n";
     } else {
       TORCH_INTERNAL_ASSERT(false, "unkown scatterOp");
     }
   }
 
+  void handle(const ScanOp* sop) final {
+    // The output carries the prefix of the row, see Note [ Scan ops ]
+    const auto output = sop->out()->as<kir::TensorIndex>();
+    const auto gen_out = gen(output);
+    std::stringstream prefix;
+    prefix << "(" << genInline(sop->isFirst()) << " ? " << output->dtype()
+           << "(" << genInline(sop->init()) << ") : " << gen_out << ")";
+    indent() << gen_out << " = "
+             << genBinaryOp(
+                    sop->getScanOpType(),
+                    output->dtype(),
+                    prefix.str(),
+                    gen(sop->in()))
+             << ";\n";
+  }
+
   std::string genArchString(MmaOptions::MacroType macro) {
     std::stringstream ss;
     if (isVolta(macro)) {
@@ -1232,9 +1468,28 @@ class CudaKernelGenerator : private OptOutConstDispatch {
 
     const auto data_type = output->dtype();
 
-    indent() << "blockReduce<" << (tidx ? "true" : "false") << ", "
-             << (tidy ? "true" : "false") << ", " << (tidz ? "true" : "false")
-             << ">(\n";
+    // Note [ Shuffle-only block reductions ]
+    //
+    // A block reduction whose segments are groups of adjacent threads, e.g.,
+    // of a softmax over short rows with several rows per block along TIDy,
+    // doesn't need shared memory or block synchronization when the segments
+    // map to power-of-2 groups of lanes of full warps. When the segments are
+    // made of whole warps, the warps are reduced with shuffles and only their
+    // partial results go through shared memory. Whether either applies
+    // depends on the launch configuration, so warp::blockReduceShuffle
+    // checks blockDim and otherwise falls back to blockReduce. Only types
+    // with __shfl_xor_sync overloads take this path.
+    bool shuffle_reduction = false;
+#ifndef USE_ROCM
+    shuffle_reduction =
+        (data_type == DataType::Float || data_type == DataType::Double ||
+         data_type == DataType::Int || data_type == DataType::Int32) &&
+        !isOptionDisabled(DisableOption::ShuffleReduction);
+#endif
+    indent() << (shuffle_reduction ? "warp::blockReduceShuffle<"
+                                   : "blockReduce<")
+             << (tidx ? "true" : "false") << ", " << (tidy ? "true" : "false")
+             << ", " << (tidz ? "true" : "false") << ">(\n";
     indent() << kTab << gen(output) << ",\n";
     indent() << kTab << gen(input) << ",\n";
     indent() << kTab << genReductionOp(reduction_op_type, output->dtype())
@@ -1594,7 +1849,13 @@ class CudaKernelGenerator : private OptOutConstDispatch {
 
     addProfileArguments(func_args, grop);
 
-    indent() << "reduction::gridReduce<" << template_args << ">(\n";
+    // See Note [ Atomic grid reductions ]
+    const bool is_atomic = lower_utils::isAtomicGridReduction(
+        op_type, grop->init(), data_type, grop->isAllreduce());
+
+    indent() << (is_atomic ? "reduction::gridReduceAtomicAdd<"
+                           : "reduction::gridReduce<")
+             << template_args << ">(\n";
     indent() << kTab << func_args << ");\n";
   }
 
@@ -1679,7 +1940,11 @@ class CudaKernelGenerator : private OptOutConstDispatch {
         grouped_grop->sync_buffer()->buffer()->as<TensorView>();
 
     if (grouped_grop->isAllreduce()) {
-      generateGroupedGridAllreduce(grouped_grop);
+      if (grouped_grop->useOuterOpt()) {
+        generateGroupedGridAllreduceOuter(grouped_grop);
+      } else {
+        generateGroupedGridAllreduce(grouped_grop);
+      }
       return;
     }
 
@@ -1970,6 +2235,75 @@ class CudaKernelGenerator : private OptOutConstDispatch {
     indent() << kTab << func_args << ");\n";
   }
 
+  // Outer-optimized version of generateGroupedGridAllreduce. Mostly
+  // the same as generateGroupedGridAllreduceWelfordOuter
+  void generateGroupedGridAllreduceOuter(
+      const kir::GroupedGridReduction* grouped_grop) {
+    TORCH_INTERNAL_ASSERT(grouped_grop->isAllreduce());
+
+    const auto num_grouped_iterations =
+        getGroupedLoopIndexConcreteIntSets().size();
+
+    TORCH_INTERNAL_ASSERT(
+        grouped_grop->numHorizontallyGroupedExprs() == 1,
+        "Horizontal grouped outer reduciton is not yet supported: ",
+        grouped_grop->toString());
+
+    const auto output = grouped_grop->output(0);
+    const auto input = grouped_grop->input(0);
+    const auto data_type = output->dtype();
+
+    ArgumentBuilder func_args;
+
+    // output and input arrays
+    func_args.arg(ir_utils::varName(output));
+    func_args.arg(ir_utils::varName(input));
+
+    // init value
+    auto iv = grouped_grop->initVal(0);
+    if (iv->dtype() != data_type) {
+      func_args.arg(genCall(data_type, gen(iv)));
+    } else {
+      func_args.arg(genInline(iv));
+    }
+
+    // global buf
+    const auto work_buffer =
+        grouped_grop->reduction_buffers().at(0)->buffer()->as<TensorView>();
+    func_args.arg("&").append(ir_utils::varName(work_buffer)).append("[0]");
+
+    // shared buf
+    func_args.arg(
+        genCall("reinterpret_cast", ptrType(data_type), "shared_mem"));
+
+    // sync buf
+    const auto sync_buffer =
+        grouped_grop->sync_buffer()->buffer()->as<TensorView>();
+    func_args.arg("&").append(ir_utils::varName(sync_buffer)).append("[0]");
+
+    addProfileArguments(func_args, grouped_grop);
+
+    func_args.arg(
+        genReductionOp(grouped_grop->getReductionOpType(0), data_type));
+
+    ArgumentBuilder func_template_args;
+    func_template_args.arg(num_grouped_iterations);
+    func_template_args.arg(data_type);
+
+    const auto& par_dim_map = kernel_->summary().parallel_dimension_map_;
+    TORCH_INTERNAL_ASSERT(par_dim_map.get(ParallelType::TIDx)->isConstInt());
+    TORCH_INTERNAL_ASSERT(par_dim_map.get(ParallelType::TIDy)->isConstInt());
+    func_template_args.arg(genInline(par_dim_map.get(ParallelType::TIDx)));
+    func_template_args.arg(genInline(par_dim_map.get(ParallelType::TIDy)));
+
+    indent() << genCall(
+                    genFusedReductionName(ir_utils::getTvOutput(grouped_grop)) +
+                        ".reduceGroupOuter",
+                    func_template_args,
+                    func_args)
+             << ";\n";
+  }
+
   // Mostly the same as the grouped grid redution version
   void generateGroupedGridAllreduceWelford(
       const kir::GroupedGridWelford* grouped_gwop) {
@@ -2498,7 +2832,7 @@ class CudaKernelGenerator : private OptOutConstDispatch {
 
   void handleScope(const kir::Scope& scope) {
     for (auto expr : scope.exprs()) {
-      OptOutConstDispatch::handle(expr);
+      genExpr(expr);
     }
   }
 
@@ -2669,7 +3003,16 @@ class CudaKernelGenerator : private OptOutConstDispatch {
           indent() << "// Allocate global tensor " << ir_utils::varName(tv)
                    << "\n";
           break;
-        case MemoryType::Shared:
+        case MemoryType::Shared: {
+          const auto& packed_offsets = kernel_->summary().packed_smem.offsets;
+          auto packed_it = packed_offsets.find(alloc);
+          if (packed_it != packed_offsets.end()) {
+            indent() << buffer_dtype << "* " << ir_utils::varName(tv)
+                     << " = reinterpret_cast<" << buffer_dtype << "*>"
+                     << "(array + smem_packed_offset + " << packed_it->second
+                     << ");\n";
+            break;
+          }
           // Align Offset Position
           indent() << "smem_offset = alignBufferSize(smem_offset, "
                    // Always align to 128b / 16B
@@ -2681,7 +3024,7 @@ class CudaKernelGenerator : private OptOutConstDispatch {
           // Increment Offset Position
           indent() << "smem_offset += (" << genInline(size) << " * sizeof("
                    << buffer_dtype << "));\n";
-          break;
+        } break;
         case MemoryType::Local: {
           auto va = kernel_->summary().vectorized_accesses;
           if (va.find(tv) != va.end()) {
@@ -2802,7 +3145,10 @@ class CudaKernelGenerator : private OptOutConstDispatch {
   }
 
  private:
-  std::stringstream code_;
+  //! The generated code, see Note [ Streaming kernel emission ]
+  std::string kernel_code_;
+  KernelCodeBuffer code_buffer_{&kernel_code_};
+  std::ostream code_{&code_buffer_};
   const kir::Kernel* kernel_;
   int block_nest_level_ = 0;
   int block_reduce_name_ = 0;
@@ -2823,9 +3169,12 @@ class CudaKernelGenerator : private OptOutConstDispatch {
 
 std::string generateCudaKernel(
     const kir::Kernel* kernel,
-    const std::string& kernel_name) {
-  FUSER_PERF_SCOPE("generateCudaKernel");
-  return CudaKernelGenerator::generateKernelDefinition(kernel, kernel_name);
+    const std::string& kernel_name,
+    const LaunchBounds& launch_bounds,
+    uint64_t* code_hash) {
+  FUSER_COMPILE_STAGE_SCOPE("CodeGen");
+  return CudaKernelGenerator::generateKernelDefinition(
+      kernel, kernel_name, launch_bounds, code_hash);
 }
 
 } // namespace codegen
@@ -15,10 +15,34 @@
 namespace nvfuser {
 namespace codegen {
 
-//! Generates a CUDA kernel definition for the given kernel
+//! Launch bounds a kernel is declared with, none if max_threads_per_block
+//! isn't positive. See Note [ Launch bounds ]
+struct LaunchBounds {
+  int64_t max_threads_per_block = 0;
+  int64_t min_blocks_per_sm = 0;
+
+  bool empty() const {
+    return max_threads_per_block <= 0;
+  }
+
+  bool operator==(const LaunchBounds& other) const {
+    return max_threads_per_block == other.max_threads_per_block &&
+        min_blocks_per_sm == other.min_blocks_per_sm;
+  }
+
+  bool operator!=(const LaunchBounds& other) const {
+    return !(*this == other);
+  }
+};
+
+//! Generates a CUDA kernel definition for the given kernel. If code_hash is
+//! given, it is set to the fnv1a_hash of the returned code, which is computed
+//! while the code is emitted
 TORCH_CUDA_CU_API std::string generateCudaKernel(
     const kir::Kernel* kernel,
-    const std::string& kernel_name = "CUDAGeneratedKernel");
+    const std::string& kernel_name = "CUDAGeneratedKernel",
+    const LaunchBounds& launch_bounds = {},
+    uint64_t* code_hash = nullptr);
 
 } // namespace codegen
 } // namespace nvfuser
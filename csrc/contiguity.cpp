@@ -16,8 +16,11 @@ namespace nvfuser {
 OrderedIdInformation::OrderedIdInformation(
     const std::vector<IterDomain*>& ids,
     const std::vector<IterDomain*>& root_domain,
-    std::shared_ptr<const ConcretizedBroadcastDomains> concrete_info)
-    : active_ids_(root_domain), concrete_info_(std::move(concrete_info)) {
+    std::shared_ptr<const ConcretizedBroadcastDomains> concrete_info,
+    std::unordered_set<IterDomain*> trivially_indexed_broadcasts)
+    : active_ids_(root_domain),
+      concrete_info_(std::move(concrete_info)),
+      trivially_indexed_broadcasts_(std::move(trivially_indexed_broadcasts)) {
   if (ids.empty() || root_domain.empty()) {
     return;
   }
@@ -48,6 +51,11 @@ OrderedIdInformation::OrderedIdInformation(
   }
 }
 
+bool OrderedIdInformation::isConcretizedBroadcast(IterDomain* id) const {
+  return id->isBroadcast() && concrete_info_->isConcretized(id) &&
+      trivially_indexed_broadcasts_.count(id) == 0;
+}
+
 bool OrderedIdInformation::checkExclusivelyConsumesRoots(IterDomain* id) {
   TORCH_INTERNAL_ASSERT(
       std::find(active_ids_.begin(), active_ids_.end(), id) !=
@@ -130,11 +138,9 @@ void OrderedIdInformation::handle(Merge* merge) {
   //  axes to the right of the broadcast root domain in the contigous merge is
   //  bigger than the vectorization dimension. And that the tensor buffer
   //  supports the vector word size (always done).
-  bool outer_is_concretized_bcast = merge->outer()->isBroadcast() &&
-      concrete_info_->isConcretized(merge->outer());
+  bool outer_is_concretized_bcast = isConcretizedBroadcast(merge->outer());
 
-  bool inner_is_concretized_bcast = merge->inner()->isBroadcast() &&
-      concrete_info_->isConcretized(merge->inner());
+  bool inner_is_concretized_bcast = isConcretizedBroadcast(merge->inner());
 
   // Update maps
   // Find the position inner would have to have to be considered ordered
@@ -146,7 +152,7 @@ void OrderedIdInformation::handle(Merge* merge) {
     }
     if (active_ids_[pos_after_outer]->isReduction() ||
         ((active_ids_[pos_after_outer]->isBroadcast() &&
-          !concrete_info_->isConcretized(active_ids_[pos_after_outer])))) {
+          !isConcretizedBroadcast(active_ids_[pos_after_outer])))) {
       // Skip reduction or broadcast axes that aren't concretized in the fusion
       continue;
     }
@@ -460,7 +466,7 @@ ContigIDs::ContigIDs(
         std::make_shared<ConcretizedBroadcastDomains>(ids[0]->fusion());
 
     consistent_transform_info_ = std::make_unique<const OrderedIdInformation>(
-        ids, root_domain, concrete_info_);
+        ids, root_domain, concrete_info_, getTriviallyIndexedBroadcasts(ids));
   }
   build(ids);
 }
@@ -492,7 +498,8 @@ ContigIDs::ContigIDs(
       consistent_transform_info_(std::make_unique<const OrderedIdInformation>(
           ids,
           root_domain,
-          concrete_info_)),
+          concrete_info_,
+          getTriviallyIndexedBroadcasts(ids))),
       non_divisible_id_info_(ids, root_domain, divisible_splits_) {
   build(ids);
 }
@@ -675,6 +682,66 @@ IterDomain* ContigIDs::getMappedId(IterDomain* id) const {
   }
 }
 
+// Note [ Contiguity of concretized broadcasts ]
+//
+// A merge with a broadcast input, e.g. of T1[i0, b1, i2] in
+//
+//   T1[i0, b1, i2] = broadcast(T0[i0, i2])
+//   T2[i0, i1, i2] = T1 + T3[i0, i1, i2]
+//   T4[i0, b1, i2] = T1 * 2
+//
+// is contiguous as long as b1 is indexed as a size-one domain, so that the
+// index of i0*b1*i2 is the index of i0*i2. That isn't the case if T1 is
+// inlined into T2, as the loops of the merge then iterate over i0*i1*i2 and
+// the index has to be unmerged with the extent of i1. Such merges used to be
+// rejected whenever the broadcast is concretized anywhere in the fusion,
+// which also rejected T4 and expanded tensors computed in loops of their
+// own. Instead, a concretized broadcast is only rejected if a leaf
+// depending on it is indexed by a loop that isn't exactly mapped with it.
+// Predicates keep the fusion-wide check.
+
+std::unordered_set<IterDomain*> ContigIDs::getTriviallyIndexedBroadcasts(
+    const std::vector<IterDomain*>& ids) const {
+  std::unordered_set<IterDomain*> trivially_indexed;
+  if (ids.empty() || ignore_consistent_ordering_) {
+    return trivially_indexed;
+  }
+  std::unordered_set<IterDomain*> concretely_indexed;
+  for (auto id : ids) {
+    auto all_vals = DependencyCheck::getAllValsBetween(
+        {root_domain_.begin(), root_domain_.end()}, {id});
+    std::vector<IterDomain*> broadcast_ids;
+    for (auto dep_id : ir_utils::filterByType<IterDomain>(all_vals)) {
+      if (dep_id->isBroadcast()) {
+        broadcast_ids.push_back(dep_id);
+      }
+    }
+    if (broadcast_ids.empty()) {
+      continue;
+    }
+    // When indexing a producer, its broadcasts may also be concretized by
+    // the consumer it's indexed as
+    auto loop_id = getMappedId(id);
+    const bool is_exactly_indexed = ca_map_->idExistsInMap(loop_id) &&
+        ca_map_->areMapped(
+            loop_id,
+            ca_map_->getConcreteMappedID(loop_id, IdMappingMode::LOOP),
+            IdMappingMode::EXACT) &&
+        std::all_of(
+            broadcast_ids.begin(),
+            broadcast_ids.end(),
+            [&](IterDomain* bcast_id) {
+              return getMappedId(bcast_id)->isBroadcast();
+            });
+    auto& indexed = is_exactly_indexed ? trivially_indexed : concretely_indexed;
+    indexed.insert(broadcast_ids.begin(), broadcast_ids.end());
+  }
+  for (auto id : concretely_indexed) {
+    trivially_indexed.erase(id);
+  }
+  return trivially_indexed;
+}
+
 bool ContigIDs::isIndexable(IterDomain* id) const {
   // If ID is mapped to consumer through persmissive map but not exact map it
   // will not be mapped through to the exact map through the p2c map. Therefore
@@ -32,10 +32,14 @@ class OrderedIdInformation : public OptInDispatch {
  public:
   OrderedIdInformation() = delete;
 
+  //! trivially_indexed_broadcasts are broadcast domains that are never
+  //! indexed with their concretized extents, so they are ordered like
+  //! broadcasts that aren't concretized in the fusion
   OrderedIdInformation(
       const std::vector<IterDomain*>& ids,
       const std::vector<IterDomain*>& root_domain,
-      std::shared_ptr<const ConcretizedBroadcastDomains> concrete_info);
+      std::shared_ptr<const ConcretizedBroadcastDomains> concrete_info,
+      std::unordered_set<IterDomain*> trivially_indexed_broadcasts = {});
 
   const std::unordered_map<IterDomain*, VectorOfUniqueEntries<IterDomain*>>&
   idToRootIds() const {
@@ -64,6 +68,10 @@ class OrderedIdInformation : public OptInDispatch {
 
   void handle(Resize* resize) override;
 
+  // Returns if id is a broadcast that may be indexed with its concretized
+  // extent
+  bool isConcretizedBroadcast(IterDomain* id) const;
+
   // Track which root ids were used to generate each iter domain
   std::unordered_map<IterDomain*, VectorOfUniqueEntries<IterDomain*>>
       id_to_root_ids_;
@@ -103,11 +111,11 @@ class OrderedIdInformation : public OptInDispatch {
   std::unordered_set<IterDomain*> exclusively_consumes_roots_;
 
   // Broadcast domains that are concretized cannot be considered contiguously
-  // indexable.
-  // TODO: This constraint is more conservative than necessary as it's only if
-  // the domain is concretized within the local indexing, not in the entire
-  // fusion.
+  // indexable, unless they're in trivially_indexed_broadcasts_. See
+  // Note [ Contiguity of concretized broadcasts ] in contiguity.cpp
   std::shared_ptr<const ConcretizedBroadcastDomains> concrete_info_;
+
+  std::unordered_set<IterDomain*> trivially_indexed_broadcasts_;
 };
 
 // Based on provided divisible split set, goes through expressions and marks all
@@ -269,6 +277,12 @@ class ContigIDs : public OptInDispatch {
   //! Return an ID mapped with id_map_ or itself
   IterDomain* getMappedId(IterDomain* id) const;
 
+  //! Broadcast domains between the root domain and ids that are only
+  //! indexed by loops iterating over exactly their extents. See
+  //! Note [ Contiguity of concretized broadcasts ]
+  std::unordered_set<IterDomain*> getTriviallyIndexedBroadcasts(
+      const std::vector<IterDomain*>& ids) const;
+
  private:
   void build(const std::vector<IterDomain*>& ids);
 
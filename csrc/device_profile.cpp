@@ -0,0 +1,236 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <device_profile.h>
+
+#include <utils.h>
+
+#include <ATen/cuda/CUDAContext.h>
+#include <c10/util/Exception.h>
+
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+
+namespace nvfuser {
+
+// Note [ Device profiles ]
+//
+// The heuristics of the schedulers and the kernel cost model are written
+// against a DeviceProfile instead of querying the CUDA device properties
+// directly, so all of them see the same, possibly corrected, picture of the
+// GPU. A profile is populated the first time a device is used and then
+// cached for the lifetime of the process.
+//
+// The CUDA device properties don't describe everything heuristics tuned on
+// one GPU get wrong on another, e.g. the memory bandwidth an inference GPU
+// like an L4 or an A10 actually reaches, or the launch latency that decides
+// whether splitting work across kernels pays off. Any field of a profile
+// can be overridden from the file PYTORCH_NVFUSER_DEVICE_PROFILES points
+// to:
+//
+//   # Everything after a '#' is a comment
+//   [*]
+//   launch_latency_us = 4
+//
+//   [NVIDIA L4]
+//   memory_bandwidth_gbs = 240
+//   l2_size = 50331648
+//
+// A section applies to the devices whose name, as reported by
+// cudaGetDeviceProperties, matches its header exactly, and [*] to every
+// device. Sections apply in the order of the file, so later ones win. A
+// key outside of any section applies to every device.
+
+namespace {
+
+// Host overhead of launching a kernel on recent drivers, used until a
+// profile overrides it with a measurement of its own
+constexpr double kDefaultLaunchLatencyUs = 5.0;
+
+template <typename T>
+struct ProfileField {
+  const char* name;
+  T DeviceProfile::*member;
+};
+
+const std::vector<ProfileField<int64_t>>& integerFields() {
+  static const std::vector<ProfileField<int64_t>> fields = {
+      {"major", &DeviceProfile::major},
+      {"minor", &DeviceProfile::minor},
+      {"sm_count", &DeviceProfile::sm_count},
+      {"warp_size", &DeviceProfile::warp_size},
+      {"max_threads_per_block", &DeviceProfile::max_threads_per_block},
+      {"max_threads_per_sm", &DeviceProfile::max_threads_per_sm},
+      {"max_blocks_per_sm", &DeviceProfile::max_blocks_per_sm},
+      {"max_grid_dim_y", &DeviceProfile::max_grid_dim_y},
+      {"regs_per_block", &DeviceProfile::regs_per_block},
+      {"regs_per_sm", &DeviceProfile::regs_per_sm},
+      {"smem_per_block", &DeviceProfile::smem_per_block},
+      {"smem_per_block_optin", &DeviceProfile::smem_per_block_optin},
+      {"smem_per_sm", &DeviceProfile::smem_per_sm},
+      {"l2_size", &DeviceProfile::l2_size}};
+  return fields;
+}
+
+const std::vector<ProfileField<double>>& floatingFields() {
+  static const std::vector<ProfileField<double>> fields = {
+      {"clock_rate_khz", &DeviceProfile::clock_rate_khz},
+      {"memory_bandwidth_gbs", &DeviceProfile::memory_bandwidth_gbs},
+      {"launch_latency_us", &DeviceProfile::launch_latency_us}};
+  return fields;
+}
+
+std::string trim(const std::string& str) {
+  const auto begin = str.find_first_not_of(" \t\r");
+  if (begin == std::string::npos) {
+    return "";
+  }
+  const auto end = str.find_last_not_of(" \t\r");
+  return str.substr(begin, end - begin + 1);
+}
+
+void setField(
+    DeviceProfile& profile,
+    const std::string& key,
+    const std::string& value) {
+  for (const auto& field : integerFields()) {
+    if (key == field.name) {
+      profile.*field.member = std::stoll(value);
+      return;
+    }
+  }
+  for (const auto& field : floatingFields()) {
+    if (key == field.name) {
+      profile.*field.member = std::stod(value);
+      return;
+    }
+  }
+  TORCH_CHECK(false, "Unknown field of device profiles: ", key);
+}
+
+DeviceProfile queryDeviceProfile(int device_index) {
+  const auto prop = at::cuda::getDeviceProperties(device_index);
+  DeviceProfile profile;
+  profile.name = prop->name;
+  profile.major = prop->major;
+  profile.minor = prop->minor;
+  profile.sm_count = prop->multiProcessorCount;
+  profile.warp_size = prop->warpSize;
+  profile.max_threads_per_block = prop->maxThreadsPerBlock;
+  profile.max_threads_per_sm = prop->maxThreadsPerMultiProcessor;
+  profile.max_blocks_per_sm = prop->maxBlocksPerMultiProcessor;
+  profile.max_grid_dim_y = prop->maxGridSize[1];
+  profile.regs_per_block = prop->regsPerBlock;
+  profile.regs_per_sm = prop->regsPerMultiprocessor;
+  profile.smem_per_block = (int64_t)prop->sharedMemPerBlock;
+  profile.smem_per_block_optin = (int64_t)prop->sharedMemPerBlockOptin;
+  profile.smem_per_sm = (int64_t)prop->sharedMemPerMultiprocessor;
+  profile.l2_size = prop->l2CacheSize;
+  profile.clock_rate_khz = prop->clockRate;
+  // Double data rate, memoryClockRate is in kHz and memoryBusWidth in bits
+  profile.memory_bandwidth_gbs =
+      2.0 * prop->memoryClockRate * (prop->memoryBusWidth / 8.0) / 1.0e6;
+  profile.launch_latency_us = kDefaultLaunchLatencyUs;
+
+  if (const char* path = getenv("PYTORCH_NVFUSER_DEVICE_PROFILES")) {
+    std::ifstream overrides(path);
+    TORCH_CHECK(
+        overrides.good(), "Can't open the device profiles file ", path);
+    applyDeviceProfileOverrides(profile, overrides);
+  }
+  if (isDebugDumpEnabled(DebugDumpOption::SchedulerDebug)) {
+    std::cout << "Device profile of device " << device_index << ":\n"
+              << profile.toString() << std::endl;
+  }
+  return profile;
+}
+
+} // namespace
+
+void applyDeviceProfileOverrides(
+    DeviceProfile& profile,
+    std::istream& overrides) {
+  bool in_matching_section = true;
+  std::string line;
+  int64_t line_number = 0;
+  while (std::getline(overrides, line)) {
+    ++line_number;
+    line = trim(line.substr(0, line.find('#')));
+    if (line.empty()) {
+      continue;
+    }
+    if (line.front() == '[') {
+      TORCH_CHECK(
+          line.back() == ']',
+          "Unterminated section of device profiles at line ",
+          line_number);
+      const auto section = trim(line.substr(1, line.size() - 2));
+      in_matching_section = section == "*" || section == profile.name;
+      continue;
+    }
+    const auto eq = line.find('=');
+    TORCH_CHECK(
+        eq != std::string::npos,
+        "Expected key = value in device profiles at line ",
+        line_number,
+        ": ",
+        line);
+    if (!in_matching_section) {
+      continue;
+    }
+    const auto key = trim(line.substr(0, eq));
+    const auto value = trim(line.substr(eq + 1));
+    try {
+      setField(profile, key, value);
+    } catch (const std::logic_error& e) {
+      // std::stoll and std::stod throw std::invalid_argument and
+      // std::out_of_range, both std::logic_error
+      TORCH_CHECK(
+          false,
+          "Invalid value of ",
+          key,
+          " in device profiles at line ",
+          line_number,
+          ": ",
+          value);
+    }
+  }
+}
+
+std::string DeviceProfile::toString() const {
+  std::stringstream ss;
+  ss << "  name: " << name << "\n";
+  for (const auto& field : integerFields()) {
+    ss << "  " << field.name << ": " << this->*field.member << "\n";
+  }
+  for (const auto& field : floatingFields()) {
+    ss << "  " << field.name << ": " << this->*field.member << "\n";
+  }
+  return ss.str();
+}
+
+const DeviceProfile& getDeviceProfile(int device_index) {
+  static std::mutex mutex;
+  static std::unordered_map<int, std::unique_ptr<DeviceProfile>> profiles;
+  std::lock_guard<std::mutex> guard(mutex);
+  auto& profile = profiles[device_index];
+  if (profile == nullptr) {
+    profile = std::make_unique<DeviceProfile>(queryDeviceProfile(device_index));
+  }
+  return *profile;
+}
+
+const DeviceProfile& getCurrentDeviceProfile() {
+  return getDeviceProfile(at::cuda::current_device());
+}
+
+} // namespace nvfuser
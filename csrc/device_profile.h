@@ -0,0 +1,59 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <c10/macros/Export.h>
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+namespace nvfuser {
+
+//! Properties of a GPU the scheduler heuristics and the kernel cost model
+//! are tuned for, see Note [ Device profiles ]. Populated once per device
+//! from its CUDA device properties and the overrides of
+//! PYTORCH_NVFUSER_DEVICE_PROFILES.
+struct TORCH_CUDA_CU_API DeviceProfile {
+  std::string name;
+  int64_t major = 0;
+  int64_t minor = 0;
+  int64_t sm_count = 0;
+  int64_t warp_size = 32;
+  int64_t max_threads_per_block = 0;
+  int64_t max_threads_per_sm = 0;
+  int64_t max_blocks_per_sm = 0;
+  int64_t max_grid_dim_y = 0;
+  int64_t regs_per_block = 0;
+  int64_t regs_per_sm = 0;
+  //! Shared memory of a block without and with opting in to the maximum
+  int64_t smem_per_block = 0;
+  int64_t smem_per_block_optin = 0;
+  int64_t smem_per_sm = 0;
+  int64_t l2_size = 0;
+  double clock_rate_khz = 0;
+  double memory_bandwidth_gbs = 0;
+  //! Host to device latency of a kernel launch
+  double launch_latency_us = 0;
+
+  std::string toString() const;
+};
+
+//! Profile of a device, populated on first use
+TORCH_CUDA_CU_API const DeviceProfile& getDeviceProfile(int device_index);
+
+//! Profile of the current CUDA device
+TORCH_CUDA_CU_API const DeviceProfile& getCurrentDeviceProfile();
+
+//! Applies the overrides of a device profile file to a profile, see Note
+//! [ Device profiles ]
+TORCH_CUDA_CU_API void applyDeviceProfileOverrides(
+    DeviceProfile& profile,
+    std::istream& overrides);
+
+} // namespace nvfuser
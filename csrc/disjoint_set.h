@@ -121,6 +121,20 @@ class VectorOfUniqueEntries {
     }
   }
 
+  // Insert the entries of other that are not in this container at the front,
+  // keeping their order. Returns if any node was added
+  bool pushFront(const VectorOfUniqueEntries<T, Hash>& other) {
+    std::vector<T> new_entries;
+    new_entries.reserve(other.size());
+    for (auto entry : other) {
+      if (set_.emplace(entry).second) {
+        new_entries.push_back(entry);
+      }
+    }
+    vector_.insert(vector_.begin(), new_entries.begin(), new_entries.end());
+    return !new_entries.empty();
+  }
+
   // Returns iterator pointing to the beginning of vector container
   typename std::vector<T>::const_iterator begin() const {
     return vector().begin();
@@ -259,15 +273,37 @@ class DisjointSets {
       return;
     }
 
-    // Place everything in set1 into set0 and remap all entries in set1 to set0
-    for (auto entry : set1_shared_ptr->vector()) {
-      set0_shared_ptr->pushBack(entry);
-      disjoint_set_maps_[entry] = set0_shared_ptr;
+    auto set0_pos = std::distance(
+        disjoint_sets_.begin(),
+        std::find(
+            disjoint_sets_.begin(), disjoint_sets_.end(), set0_shared_ptr));
+    auto set1_pos = std::distance(
+        disjoint_sets_.begin(),
+        std::find(
+            disjoint_sets_.begin(), disjoint_sets_.end(), set1_shared_ptr));
+
+    // Union by size: only the entries of the smaller set are rehashed and
+    // remapped, so each entry is moved O(log n) times while a graph of n
+    // entries is built. The merged set keeps the entries of set0 first and
+    // the position of set0 in disjoint_sets_ either way.
+    if (set1_shared_ptr->size() > set0_shared_ptr->size()) {
+      set1_shared_ptr->pushFront(*set0_shared_ptr);
+      for (auto entry : set0_shared_ptr->vector()) {
+        disjoint_set_maps_[entry] = set1_shared_ptr;
+      }
+      disjoint_sets_[set0_pos] = set1_shared_ptr;
+    } else {
+      // Place everything in set1 into set0 and remap all entries in set1 to
+      // set0
+      for (auto entry : set1_shared_ptr->vector()) {
+        set0_shared_ptr->pushBack(entry);
+        disjoint_set_maps_[entry] = set0_shared_ptr;
+      }
     }
 
-    // set1 no longer needed as its entries are copied into set0
-    disjoint_sets_.erase(std::find(
-        disjoint_sets_.begin(), disjoint_sets_.end(), set1_shared_ptr));
+    // The other set is no longer needed as its entries are copied into the
+    // merged set
+    disjoint_sets_.erase(disjoint_sets_.begin() + set1_pos);
   }
 
   // Will assert if provided entry0 is not in any disjoint set, otherwise
@@ -64,6 +64,8 @@ void Val::dispatch(T handler, Val* val) {
           return;
         case DataType::Int:
         case DataType::Int32:
+        case DataType::Int8:
+        case DataType::UInt8:
         case DataType::Index:
         case DataType::SMemAddress:
           // Dispatch to Int even with Int32 as we don't have Int32 IR
@@ -157,6 +159,10 @@ void Expr::dispatch(T handler, Expr* expr) {
     ptr(handler)->handle(expr->as<ScatterOp>());
     return;
   }
+  if (expr->isStrictlyA<ScanOp>()) {
+    ptr(handler)->handle(expr->as<ScanOp>());
+    return;
+  }
   if (expr->isStrictlyA<RNGOp>()) {
     ptr(handler)->handle(expr->as<RNGOp>());
     return;
@@ -321,6 +327,10 @@ void Expr::dispatch(T handler, Expr* expr) {
     ptr(handler)->handle(expr->as<SendRecv>());
     return;
   }
+  if (expr->isStrictlyA<Collective>()) {
+    ptr(handler)->handle(expr->as<Collective>());
+    return;
+  }
   TORCH_INTERNAL_ASSERT(false, "Unknown exprtype in dispatch!");
 }
 
@@ -355,6 +365,8 @@ void Val::constDispatch(T handler, const Val* val) {
         case DataType::Int:
         case DataType::Index:
         case DataType::Int32:
+        case DataType::Int8:
+        case DataType::UInt8:
         case DataType::SMemAddress:
           // Dispatch to Int even with Int32 as we don't have Int32 IR
           // node.
@@ -447,6 +459,10 @@ void Expr::constDispatch(T handler, const Expr* expr) {
     ptr(handler)->handle(expr->as<ScatterOp>());
     return;
   }
+  if (expr->isStrictlyA<ScanOp>()) {
+    ptr(handler)->handle(expr->as<ScanOp>());
+    return;
+  }
   if (expr->isStrictlyA<RNGOp>()) {
     ptr(handler)->handle(expr->as<RNGOp>());
     return;
@@ -611,6 +627,10 @@ void Expr::constDispatch(T handler, const Expr* expr) {
     ptr(handler)->handle(expr->as<SendRecv>());
     return;
   }
+  if (expr->isStrictlyA<Collective>()) {
+    ptr(handler)->handle(expr->as<Collective>());
+    return;
+  }
   TORCH_INTERNAL_ASSERT(false, "Unknown exprtype in dispatch!");
 }
 
@@ -655,6 +675,8 @@ void Val::mutatorDispatch(T mutator, Val* val) {
           return;
         case DataType::Int:
         case DataType::Int32:
+        case DataType::Int8:
+        case DataType::UInt8:
         case DataType::Index:
         case DataType::SMemAddress:
           ptr(mutator)->mutate(val->as<Int>());
@@ -872,6 +894,9 @@ void OptOutConstDispatch::handle(const TorchGatherOp* stmt) {
 void OptOutConstDispatch::handle(const ScatterOp* stmt) {
   unhandled(stmt);
 }
+void OptOutConstDispatch::handle(const ScanOp* stmt) {
+  unhandled(stmt);
+}
 void OptOutConstDispatch::handle(const RNGOp* stmt) {
   unhandled(stmt);
 }
@@ -998,6 +1023,9 @@ void OptOutConstDispatch::handle(const AggregateExpr* stmt) {
 void OptOutConstDispatch::handle(const SendRecv* stmt) {
   unhandled(stmt);
 }
+void OptOutConstDispatch::handle(const Collective* stmt) {
+  unhandled(stmt);
+}
 
 void OptOutDispatch::unhandled(Statement*) {}
 
@@ -1069,6 +1097,9 @@ void OptOutDispatch::handle(TorchGatherOp* stmt) {
 void OptOutDispatch::handle(ScatterOp* stmt) {
   unhandled(stmt);
 }
+void OptOutDispatch::handle(ScanOp* stmt) {
+  unhandled(stmt);
+}
 void OptOutDispatch::handle(RNGOp* stmt) {
   unhandled(stmt);
 }
@@ -1194,5 +1225,8 @@ void OptOutDispatch::handle(AggregateExpr* stmt) {
 void OptOutDispatch::handle(SendRecv* stmt) {
   unhandled(stmt);
 }
+void OptOutDispatch::handle(Collective* stmt) {
+  unhandled(stmt);
+}
 
 } // namespace nvfuser
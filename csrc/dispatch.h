@@ -87,6 +87,7 @@ class SelectOp;
 class IndexSelectOp;
 class TorchGatherOp;
 class ScatterOp;
+class ScanOp;
 class RNGOp;
 class ReductionOp;
 class GroupedReductionOp;
@@ -108,6 +109,7 @@ class SliceOp;
 
 class AggregateExpr;
 class SendRecv;
+class Collective;
 
 // Exprs
 class Split;
@@ -177,6 +179,7 @@ class TORCH_CUDA_CU_API OptOutConstDispatch : public PolymorphicBase {
   virtual void handle(const IndexSelectOp* stmt);
   virtual void handle(const TorchGatherOp* stmt);
   virtual void handle(const ScatterOp* stmt);
+  virtual void handle(const ScanOp* stmt);
   virtual void handle(const RNGOp* stmt);
   virtual void handle(const ReductionOp* stmt);
   virtual void handle(const GroupedReductionOp* stmt);
@@ -221,6 +224,7 @@ class TORCH_CUDA_CU_API OptOutConstDispatch : public PolymorphicBase {
 
   virtual void handle(const AggregateExpr*);
   virtual void handle(const SendRecv*);
+  virtual void handle(const Collective*);
 };
 
 class TORCH_CUDA_CU_API OptOutDispatch : public PolymorphicBase {
@@ -259,6 +263,7 @@ class TORCH_CUDA_CU_API OptOutDispatch : public PolymorphicBase {
   virtual void handle(IndexSelectOp* stmt);
   virtual void handle(TorchGatherOp* stmt);
   virtual void handle(ScatterOp* stmt);
+  virtual void handle(ScanOp* stmt);
   virtual void handle(RNGOp* stmt);
   virtual void handle(ReductionOp* stmt);
   virtual void handle(GroupedReductionOp* stmt);
@@ -303,6 +308,7 @@ class TORCH_CUDA_CU_API OptOutDispatch : public PolymorphicBase {
 
   virtual void handle(AggregateExpr* stmt);
   virtual void handle(SendRecv* stmt);
+  virtual void handle(Collective* stmt);
 };
 
 class TORCH_CUDA_CU_API OptInConstDispatch : public OptOutConstDispatch {
@@ -227,6 +227,27 @@ c10::optional<EvaluatorValue> PrecomputedValues::getMaybeValueFor(
   return values_[index];
 }
 
+std::vector<std::vector<c10::optional<EvaluatorValue>>> PrecomputedValues::
+    evaluateBatch(
+        const std::vector<KernelArgumentHolder>& args_batch,
+        const std::vector<const Val*>& vals) {
+  FUSER_PERF_SCOPE("PrecomputedValues::EvaluateBatch");
+  std::vector<std::vector<c10::optional<EvaluatorValue>>> results(
+      vals.size(), std::vector<c10::optional<EvaluatorValue>>());
+  for (auto& result : results) {
+    result.reserve(args_batch.size());
+  }
+  for (const auto& args : args_batch) {
+    invalidate();
+    bindInputs(args);
+    evaluate();
+    for (const auto i : c10::irange(vals.size())) {
+      results[i].push_back(getMaybeValueFor(vals[i]));
+    }
+  }
+  return results;
+}
+
 void PrecomputedValues::print() const {
   std::cout << "Precomputed Values:\n";
   for (auto i : c10::irange(symbols_.size())) {
@@ -327,16 +348,24 @@ void PrecomputedValues::bindTensorMetaData(
 
 NaiveValueMachine::NaiveValueMachine(PrecomputedValues& precomputed_values)
     : precomputed_values_(precomputed_values), num_of_instructions_{0} {
+  std::unordered_set<Expr*> lowered_exprs;
   for (auto val : precomputed_values_.symbols_) {
     auto def = val->definition();
-    if (def) {
-      if (auto uop = dynamic_cast<UnaryOp*>(def)) {
-        makeUnaryOp(uop);
-      } else if (auto bop = dynamic_cast<BinaryOp*>(def)) {
-        makeBinaryOp(bop);
-      } else {
-        TORCH_INTERNAL_ASSERT(false, "Unsupported expr");
-      }
+    // Constants are folded by initializeValueList and never need to be
+    //  computed
+    if (def == nullptr ||
+        precomputed_values_.is_constant_[val->evaluatorIndex()] ||
+        !lowered_exprs.insert(def).second) {
+      continue;
+    }
+    if (auto uop = dynamic_cast<UnaryOp*>(def)) {
+      makeUnaryOp(uop);
+    } else if (auto bop = dynamic_cast<BinaryOp*>(def)) {
+      makeBinaryOp(bop);
+    } else if (auto top = dynamic_cast<TernaryOp*>(def)) {
+      makeTernaryOp(top);
+    } else {
+      makeExpr(def);
     }
   }
 }
@@ -386,14 +415,51 @@ void NaiveValueMachine::makeBinaryOp(BinaryOp* bop) {
   dest_[index] = out;
 }
 
+void NaiveValueMachine::makeTernaryOp(TernaryOp* top) {
+  int in0 = top->inputs()[0]->evaluatorIndex();
+  int in1 = top->inputs()[1]->evaluatorIndex();
+  int in2 = top->inputs()[2]->evaluatorIndex();
+  int out = top->outputs()[0]->evaluatorIndex();
+
+  TORCH_INTERNAL_ASSERT(in0 >= 0, "Integer Machine: unknown in1: ", top);
+  TORCH_INTERNAL_ASSERT(in1 >= 0, "Integer Machine: unknown in2: ", top);
+  TORCH_INTERNAL_ASSERT(in2 >= 0, "Integer Machine: unknown in3: ", top);
+  TORCH_INTERNAL_ASSERT(out >= 0, "Integer Machine: unknown out: ", top);
+
+  int index = makeInstructionEntry();
+  inst_type_[index] = InstructionType::TERNARY_OP;
+  top_type_[index] = top->getTernaryOpType();
+  src0_[index] = in0;
+  src1_[index] = in1;
+  src2_[index] = in2;
+  dest_[index] = out;
+}
+
+void NaiveValueMachine::makeExpr(Expr* expr) {
+  for (auto inp : expr->inputs()) {
+    TORCH_INTERNAL_ASSERT(
+        inp->evaluatorIndex() >= 0, "Integer Machine: unknown input: ", expr);
+  }
+  int out = expr->output(0)->evaluatorIndex();
+  TORCH_INTERNAL_ASSERT(out >= 0, "Integer Machine: unknown out: ", expr);
+
+  int index = makeInstructionEntry();
+  inst_type_[index] = InstructionType::EXPR;
+  expr_[index] = expr;
+  dest_[index] = out;
+}
+
 int NaiveValueMachine::makeInstructionEntry() {
   int index = num_of_instructions_++;
   inst_type_.emplace_back(InstructionType::UNARY_OP);
   uop_type_.emplace_back(UnaryOpType::Abs);
   bop_type_.emplace_back(BinaryOpType::Add);
+  top_type_.emplace_back(TernaryOpType::Where);
+  expr_.emplace_back(nullptr);
   data_type_.emplace_back(DataType::Null);
   src0_.emplace_back(-1);
   src1_.emplace_back(-1);
+  src2_.emplace_back(-1);
   dest_.emplace_back(-1);
   return index;
 }
@@ -406,15 +472,24 @@ void NaiveValueMachine::runInstruction(int index) {
     case InstructionType::BINARY_OP:
       runBinaryOp(index);
       break;
+    case InstructionType::TERNARY_OP:
+      runTernaryOp(index);
+      break;
+    case InstructionType::EXPR:
+      runExpr(index);
+      break;
   }
 }
 
+bool NaiveValueMachine::hasOperand(int src_index) const {
+  return precomputed_values_.defined_[src_index] ||
+      precomputed_values_.is_constant_[src_index];
+}
+
 void NaiveValueMachine::runUnaryOp(int index) {
   using namespace EvaluatorValue_functions;
   int src_index = src0_[index];
-  bool src_defined = precomputed_values_.defined_[src_index];
-  bool src_is_const = precomputed_values_.is_constant_[src_index];
-  if (!src_defined && !src_is_const) {
+  if (!hasOperand(src_index)) {
     return;
   }
 
@@ -431,9 +506,9 @@ void NaiveValueMachine::runUnaryOp(int index) {
       dest = src;
       break;
     case UnaryOpType::Cast:
-      if (data_type_[index] == DataType::Double) {
+      if (isFloatingPointType(data_type_[index])) {
         dest = EvaluatorValue(src.template cast<double>());
-      } else if (data_type_[index] == DataType::Int) {
+      } else if (isIntegralType(data_type_[index])) {
         dest = EvaluatorValue(src.template cast<int64_t>());
       } else if (data_type_[index] == DataType::Bool) {
         dest = EvaluatorValue(src.template cast<bool>());
@@ -444,6 +519,9 @@ void NaiveValueMachine::runUnaryOp(int index) {
     case UnaryOpType::Abs:
       dest = abs(src);
       break;
+    case UnaryOpType::Not:
+      dest = notExpr(src);
+      break;
     default:
       TORCH_CHECK(!"Unexpected operator type ", uop_type_[index]);
   }
@@ -455,14 +533,7 @@ void NaiveValueMachine::runBinaryOp(int index) {
   using namespace EvaluatorValue_functions;
   int src0_index = src0_[index];
   int src1_index = src1_[index];
-  bool src0_is_const = precomputed_values_.is_constant_[src0_index];
-  bool src1_is_const = precomputed_values_.is_constant_[src1_index];
-
-  bool src_defined =
-      (precomputed_values_.defined_[src0_index] || src0_is_const) &&
-      (precomputed_values_.defined_[src1_index] || src1_is_const);
-
-  if (!src_defined) {
+  if (!hasOperand(src0_index) || !hasOperand(src1_index)) {
     return;
   }
   int dest_index = dest_[index];
@@ -496,6 +567,30 @@ void NaiveValueMachine::runBinaryOp(int index) {
     case BinaryOpType::And:
       dest = lhs && rhs;
       break;
+    case BinaryOpType::Or:
+      dest = lhs || rhs;
+      break;
+    case BinaryOpType::Xor:
+      dest = lhs ^ rhs;
+      break;
+    case BinaryOpType::Eq:
+      dest = lhs == rhs;
+      break;
+    case BinaryOpType::NE:
+      dest = lhs != rhs;
+      break;
+    case BinaryOpType::GT:
+      dest = lhs > rhs;
+      break;
+    case BinaryOpType::GE:
+      dest = lhs >= rhs;
+      break;
+    case BinaryOpType::LT:
+      dest = lhs < rhs;
+      break;
+    case BinaryOpType::LE:
+      dest = lhs <= rhs;
+      break;
     case BinaryOpType::Max:
       dest = lhs > rhs ? lhs : rhs;
       break;
@@ -509,4 +604,51 @@ void NaiveValueMachine::runBinaryOp(int index) {
   precomputed_values_.defined_[dest_index] = true;
 }
 
+void NaiveValueMachine::runTernaryOp(int index) {
+  int src0_index = src0_[index];
+  int src1_index = src1_[index];
+  int src2_index = src2_[index];
+  if (!hasOperand(src0_index) || !hasOperand(src1_index) ||
+      !hasOperand(src2_index)) {
+    return;
+  }
+  int dest_index = dest_[index];
+
+  auto& in1 = precomputed_values_.values_[src0_index];
+  auto& in2 = precomputed_values_.values_[src1_index];
+  auto& in3 = precomputed_values_.values_[src2_index];
+  auto& dest = precomputed_values_.values_[dest_index];
+
+  switch (top_type_[index]) {
+    case TernaryOpType::Where:
+      dest = in1.as<bool>() ? in2 : in3;
+      break;
+    default:
+      TORCH_CHECK(!"Unexpected operator type");
+  }
+
+  precomputed_values_.defined_[dest_index] = true;
+}
+
+void NaiveValueMachine::runExpr(int index) {
+  auto expr = expr_[index];
+  std::vector<EvaluatorValue> inputs;
+  inputs.reserve(expr->inputs().size());
+  for (auto inp : expr->inputs()) {
+    if (!hasOperand(inp->evaluatorIndex())) {
+      return;
+    }
+    inputs.emplace_back(precomputed_values_.values_[inp->evaluatorIndex()]);
+  }
+
+  auto outputs = expr->evaluate(inputs);
+  for (auto i : c10::irange(expr->outputs().size())) {
+    auto dest_index = expr->output(i)->evaluatorIndex();
+    if (dest_index >= 0 && !precomputed_values_.is_constant_[dest_index]) {
+      precomputed_values_.values_[dest_index] = outputs.at(i);
+      precomputed_values_.defined_[dest_index] = true;
+    }
+  }
+}
+
 } // namespace nvfuser
@@ -27,10 +27,14 @@ class PrecomputedValues;
 //!   and it currently must be associated with an instance of
 //!   PrecomputedValues that will provide the workspace
 //!   containing the concrete values for the values.
+//!  Unary, binary and ternary scalar ops are decoded into
+//!   instructions, any other expr is evaluated through
+//!   Expr::evaluate. Values that are compile-time constants
+//!   are folded by PrecomputedValues and get no instruction.
 class NaiveValueMachine {
   //! The generic types of instructions supported for this
-  //!  machine, currently only binary and unary.
-  enum class InstructionType { UNARY_OP, BINARY_OP };
+  //!  machine.
+  enum class InstructionType { UNARY_OP, BINARY_OP, TERNARY_OP, EXPR };
 
  public:
   //! Constructor lowers all the expr IR nodes stored in precomputed_values
@@ -48,6 +52,13 @@ class NaiveValueMachine {
   //! Convert an binary IR expr to an instruction
   void makeBinaryOp(BinaryOp* bop);
 
+  //! Convert a ternary IR expr to an instruction
+  void makeTernaryOp(TernaryOp* top);
+
+  //! Convert any other IR expr to an instruction evaluating it
+  //!  through Expr::evaluate
+  void makeExpr(Expr* expr);
+
   //! Create an empty instruction with all default values
   //!  and place it at the end of the instruction buffer.
   int makeInstructionEntry();
@@ -63,6 +74,16 @@ class NaiveValueMachine {
   //! Runs a binary operation at given index of instruction buffer
   void runBinaryOp(int index);
 
+  //! Runs a ternary operation at given index of instruction buffer
+  void runTernaryOp(int index);
+
+  //! Runs a generic expr at given index of instruction buffer
+  void runExpr(int index);
+
+  //! Returns true if the operand at the given workspace index
+  //!  has a computed or constant value.
+  bool hasOperand(int src_index) const;
+
  private:
   friend PrecomputedValues;
 
@@ -79,7 +100,7 @@ class NaiveValueMachine {
   int num_of_instructions_ = 0;
 
   //! Machine instruction type for each instruction i.e.
-  //!  unary or binary
+  //!  unary, binary, ternary or generic
   std::vector<InstructionType> inst_type_;
 
   //! Unary operator type if applicable, contains a default
@@ -90,10 +111,18 @@ class NaiveValueMachine {
   //!  value at each index corresponding other ops.
   std::vector<DataType> data_type_;
 
-  //! Unary operator type if applicable, contains a default
-  //!  value at each index corresponding to a unary op.
+  //! Binary operator type if applicable, contains a default
+  //!  value at each index corresponding to other ops.
   std::vector<BinaryOpType> bop_type_;
 
+  //! Ternary operator type if applicable, contains a default
+  //!  value at each index corresponding to other ops.
+  std::vector<TernaryOpType> top_type_;
+
+  //! IR expr of each generic instruction, nullptr at each
+  //!  index corresponding to other ops.
+  std::vector<Expr*> expr_;
+
   //! Indexes of operands and destination of each instruction.
   //!  The indexes corresponds to positions in the workspace
   //!  where concrete values are hosted.
@@ -105,6 +134,10 @@ class NaiveValueMachine {
   //!  each index corresponding to a unary op.
   std::vector<int> src1_;
 
+  //! Operand 2 of each instruction, a default value at
+  //!  each index corresponding to a unary or binary op.
+  std::vector<int> src2_;
+
   //! Destination of each instruction.
   std::vector<int> dest_;
 };
@@ -152,6 +185,17 @@ class PrecomputedValues {
   //!  in the workspace and has been evaluated.
   c10::optional<EvaluatorValue> getMaybeValueFor(const Val* val);
 
+  //! Evaluates the given IR nodes for each of the input
+  //!  signatures in args_batch, running the same instructions
+  //!  over every binding. The results are laid out as a
+  //!  struct of arrays: result[i][j] is the value of vals[i]
+  //!  for args_batch[j], nullopt if it is not in the workspace
+  //!  or can't be inferred from the inputs. The workspace holds
+  //!  the values of the last signature afterwards.
+  std::vector<std::vector<c10::optional<EvaluatorValue>>> evaluateBatch(
+      const std::vector<KernelArgumentHolder>& args_batch,
+      const std::vector<const Val*>& vals);
+
   //! Debugging helper, prints all the currently known values
   void print() const;
 
@@ -24,16 +24,25 @@
 #include <ATen/cuda/llvm_jit_strings.h>
 #include <ATen/native/cuda/jit_utils.h>
 #include <c10/core/DeviceGuard.h>
+#include <c10/core/thread_pool.h>
 #include <c10/cuda/CUDAFunctions.h>
+#include <c10/cuda/CUDAGraphsC10Utils.h>
+#include <c10/cuda/CUDAGuard.h>
 #include <c10/cuda/CUDAStream.h>
+#include <c10/util/accumulate.h>
 #include <c10/util/irange.h>
 
+#include <algorithm>
+#include <array>
+#include <cctype>
 #include <cmath>
 #include <fstream>
+#include <iterator>
+#include <mutex>
 
 namespace nvfuser {
 
-int FusionExecutor::fusion_id_counter_ = 0; // NOLINT
+std::atomic<int> FusionExecutor::fusion_id_counter_{0}; // NOLINT
 
 bool fill_allocation_with_nan_ = false;
 
@@ -45,6 +54,23 @@ void setFillAllocationWithNan(bool value) {
   fill_allocation_with_nan_ = value;
 }
 
+namespace {
+
+//! Counts the device memory of newly allocated tensors, see
+//! Note [ Runtime metrics ]
+void recordAllocations(const std::vector<at::Tensor>& tensors) {
+  int64_t nbytes = 0;
+  for (const auto& tensor : tensors) {
+    if (tensor.defined()) {
+      nbytes += (int64_t)tensor.nbytes();
+    }
+  }
+  inst::RuntimeMetrics::instance()->add(
+      inst::RuntimeCounter::BytesAllocated, nbytes);
+}
+
+} // namespace
+
 bool assert_out_of_bound_ = false;
 
 bool shouldAssertOutOfBound() {
@@ -103,7 +129,7 @@ std::string FusionExecutor::getStructuredCode(
   code += includeStdComplex();
   code += std::string("namespace ") + FusionExecutor::kernelNamespace() +
       " {\n" + defineIntegerTypes() + defineIndexType(index_type) +
-      executor_utils::kernelPreamble() + kernel_str + "}\n";
+      executor_utils::kernelPreamble(kernel_str) + kernel_str + "}\n";
 
   if (isDebugDumpEnabled(DebugDumpOption::CudaKernel)) {
     std::cout << "\n======= Codegen output for kernel: " << kernelName()
@@ -150,12 +176,15 @@ void FusionExecutor::debugCompileFusionFromStr(
               << std::endl;
   }
 
-  lowered_ = std::make_unique<GpuLower>(fusion);
+  lowered_ = std::make_shared<GpuLower>(fusion);
   const auto kernel = lowered_->kernel();
   fusion_ = lowered_->kernel();
 
   fusion_id_ = id;
   setUsedTVs();
+  setScatterSelfIndices();
+  setConcatOutputSlices();
+  setBroadcastInputIndices();
 
   if (isDebugDumpEnabled(DebugDumpOption::KernelIr)) {
     kernel->print();
@@ -179,12 +208,296 @@ void FusionExecutor::debugCompileFusionFromStr(
       fusion_id_ > 0, "assign a fusion_id_ <= 0 is not accepted.");
 }
 
+// Note [ Fast compilation ]
+//
+// Most of the time to compile a kernel is spent in ptxas, and it grows
+// quickly with the size of the kernel at the default optimization level.
+// With `PYTORCH_NVFUSER_ENABLE=fast_compile`, a new kernel is first compiled
+// at a low ptxas optimization level, 0 by default or the level given as
+// option argument, e.g. `fast_compile(1)`, so that the first launch isn't
+// held up by the full optimization. The same kernel is then recompiled at
+// full optimization on a background thread, and the executor swaps it in at
+// its first launch after the recompilation is done. Compilations of
+// different kernels still run concurrently on the compilation thread pool of
+// the kernel runtime.
+//
+// The low optimization level is part of the compile args, so the KernelDb
+// keeps both versions apart. Kernels using cooperative grid reductions are
+// always compiled at full optimization, as their grid size is validated
+// against the occupancy of the compiled kernel. Modules of replaced kernels
+// are not unloaded, as launches of them might still be in flight, and CUDA
+// graphs captured in the meantime keep launching the fast kernel.
+
+namespace {
+
+//! Returns the ptxas optimization level of the fast first compilation, see
+//! Note [ Fast compilation ]
+c10::optional<int> fastCompileOptLevel() {
+  if (!isOptionEnabled(EnableOption::FastCompile)) {
+    return c10::nullopt;
+  }
+  int opt_level = 0;
+  const auto& option_args = getEnableOptionArguments(EnableOption::FastCompile);
+  if (!option_args.empty()) {
+    try {
+      opt_level = std::stoi(option_args[0]);
+    } catch (const std::exception& e) {
+      std::cout << "skip invalid argument for FastCompile, arg = "
+                << option_args[0] << std::endl;
+    }
+  }
+  // The full optimization level leaves nothing to recompile
+  if (opt_level < 0 || opt_level >= 4) {
+    return c10::nullopt;
+  }
+  return opt_level;
+}
+
+//! A single thread recompiles kernels in the background, so that it doesn't
+//! compete with the compilations that first launches are waiting for
+c10::ThreadPool* getRecompileThreadPool() {
+  static c10::ThreadPool pool(1);
+  return &pool;
+}
+
+} // namespace
+
+void FusionExecutor::compileKernel(
+    const std::string& structured_code,
+    c10::optional<int> block_size,
+    bool return_compiled_binary) {
+  const std::string func_name = kernelNamespace() + "::" + kernelName();
+  smem_carveout_ = -1;
+  // Registers are limited by the launch bounds instead of the block size,
+  // see Note [ Launch bounds ]
+  if (!launch_bounds_.empty()) {
+    block_size = c10::nullopt;
+  }
+  const auto fast_opt_level =
+      kernel()->summary().has_cooperative_grid_reduction
+      ? c10::nullopt
+      : fastCompileOptLevel();
+
+  // A recompilation of the previous kernel must not be swapped in
+  optimized_kernel_.reset();
+  std::tie(compiled_kernel_, last_compiler_log_, last_compiled_binary_) =
+      executor_utils::nvrtcCompile(
+          kernel_code_,
+          structured_code,
+          func_name,
+          fusion_id_,
+          block_size,
+          maxrregcount_high_water_mark,
+          return_compiled_binary,
+          fast_opt_level,
+          fast_math_,
+          kernel_code_hash_);
+  if (!fast_opt_level.has_value()) {
+    return;
+  }
+
+  auto optimized_kernel = std::make_shared<OptimizedKernel>();
+  optimized_kernel_ = optimized_kernel;
+  getRecompileThreadPool()->run([optimized_kernel,
+                                 kernel_code = kernel_code_,
+                                 kernel_code_hash = kernel_code_hash_,
+                                 structured_code,
+                                 func_name,
+                                 fusion_id = fusion_id_,
+                                 block_size,
+                                 max_register = maxrregcount_high_water_mark,
+                                 fast_math = fast_math_,
+                                 device = options_.device]() {
+    FUSER_PERF_SCOPE("FusionExecutor::recompileKernel");
+    try {
+      c10::cuda::CUDAGuard dg(device);
+      optimized_kernel->function = std::get<0>(executor_utils::nvrtcCompile(
+          kernel_code,
+          structured_code,
+          func_name,
+          fusion_id,
+          block_size,
+          max_register,
+          false,
+          c10::nullopt,
+          fast_math,
+          kernel_code_hash));
+      optimized_kernel->ready.store(true, std::memory_order_release);
+    } catch (const std::exception& e) {
+      // The fast kernel stays in use
+      TORCH_WARN(
+          "nvFuser failed to recompile ",
+          func_name,
+          " at full optimization: ",
+          e.what());
+    }
+  });
+}
+
+void FusionExecutor::maybeSwapOptimizedKernel(
+    executor_utils::KernelModuleGuard& module_guard) {
+  if (optimized_kernel_ == nullptr ||
+      !optimized_kernel_->ready.load(std::memory_order_acquire)) {
+    return;
+  }
+  compiled_kernel_ = optimized_kernel_->function;
+  optimized_kernel_.reset();
+  module_guard.pin(compiled_kernel_);
+  smem_carveout_ = -1;
+
+  int max_dynamic_smem = 0;
+  CUDA_SAFE_CALL(cuFuncGetAttribute(
+      &max_dynamic_smem,
+      CU_FUNC_ATTRIBUTE_MAX_DYNAMIC_SHARED_SIZE_BYTES,
+      compiled_kernel_.function));
+  maybe_available_dynamic_smem_ = max_dynamic_smem;
+}
+
+// Note [ Lowering cache ]
+//
+// Lowering and code generation run from scratch for every compilation,
+// even when the scheduled fusion is identical to one that is already
+// lowered, e.g. the same layer repeated in a model with its own executor
+// cache, or a new kernel runtime of a symbolic fusion whose heuristics end
+// up the same as before. The lowered kernel depends only on the scheduled
+// fusion, the compile params and the device, so executors of identical
+// scheduled fusions share their GpuLower and generated code:
+//   - identical means the printed math and transforms of the fusion, every
+//     tensor's memory type, inlining and buffering, the aliases and the
+//     compile params all match, together with the compute capability and
+//     the enabled options, which EnableOptionGuard can change at runtime;
+//   - fusions with managed data, like loop rotation parameters, are never
+//     shared since it isn't part of the printout;
+//   - the cached code is renamed to the name of the new kernel, and
+//     generated again if it was declared with other launch bounds.
+// The cache doesn't keep lowered kernels alive on its own, so entries live
+// as long as one of the executors sharing them. The lowered kernel is never
+// modified after lowering, apart from the evaluator indices a
+// PrecomputedValues assigns to its values, which are the same for every
+// executor. Sharing can be turned off with
+// PYTORCH_NVFUSER_DISABLE=lowering_cache.
+
+namespace {
+
+// Note [ Launch bounds ]
+//
+// Kernels are declared with __launch_bounds__(block size, min blocks per
+// SM), so that ptxas allocates the registers of each kernel for the block
+// size it is compiled for and the occupancy its heuristics target, where it
+// would otherwise be limited by a --maxrregcount computed from the block
+// size alone. The block size is the high water mark of the executor, and a
+// launch with a larger block recompiles the kernel. Schedulers set the
+// target occupancy in CompileParams::min_blocks_per_sm, and an explicit
+// register limit of the heuristics, CompileParams::maxrregcount, or of
+// PYTORCH_NVFUSER_MAX_REG_COUNT is still passed to ptxas. Kernels compiled
+// without arguments, whose block size is unknown, and
+// PYTORCH_NVFUSER_DISABLE=launch_bounds fall back to the block size based
+// --maxrregcount.
+codegen::LaunchBounds launchBoundsFor(
+    const CompileParams& compile_params,
+    c10::optional<int64_t> block_size) {
+  if (!block_size.has_value() ||
+      isOptionDisabled(DisableOption::LaunchBounds)) {
+    return {};
+  }
+  return {block_size.value(), compile_params.min_blocks_per_sm};
+}
+
+struct LoweringCacheEntry {
+  std::weak_ptr<GpuLower> lower;
+  std::string kernel_code;
+  std::string kernel_name;
+  codegen::LaunchBounds launch_bounds;
+};
+
+std::mutex lowering_cache_mutex;
+std::unordered_map<std::string, LoweringCacheEntry> lowering_cache;
+
+//! Describes everything lowering depends on, see Note [ Lowering cache ]
+std::string loweringCacheKey(
+    Fusion* fusion,
+    const CompileParams& compile_params) {
+  FUSER_PERF_SCOPE("loweringCacheKey");
+  std::stringstream key;
+  const auto properties = at::cuda::getCurrentDeviceProperties();
+  key << "sm_" << properties->major << properties->minor << " "
+      << DataType(compile_params.index_type.value()) << " "
+      << compile_params.maxrregcount
+      << " " << compile_params.enable_magic_zero << " "
+      << compile_params.fast_math << "\n";
+  // Enable options can change at runtime through EnableOptionGuard
+  key << "enabled:";
+  for (const auto i : c10::irange((int)EnableOption::EndOfOption)) {
+    const auto option = static_cast<EnableOption>(i);
+    if (!isOptionEnabled(option)) {
+      continue;
+    }
+    key << " " << i;
+    for (const auto& arg : getEnableOptionArguments(option)) {
+      key << "," << arg;
+    }
+  }
+  key << "\ninputs:";
+  for (auto input : fusion->inputs()) {
+    key << " " << input->toString();
+  }
+  key << "\noutputs:";
+  for (auto output : fusion->outputs()) {
+    key << " " << output->toString();
+  }
+  key << "\naliases:";
+  for (const auto& alias : fusion->getInputAliasIndices()) {
+    key << " " << alias.first << "->" << alias.second;
+  }
+  key << "\n";
+  IrMathPrinter(key).handle(fusion);
+  IrTransformPrinter(key).handle(fusion);
+  for (auto tv : ir_utils::allTvs(fusion)) {
+    key << tv->toString() << " " << tv->isDoubleBuffered() << " "
+        << tv->isCircularBuffered() << " " << tv->circularBufferDepth()
+        << " " << tv->cacheHint() << "\n";
+  }
+  return key.str();
+}
+
+bool isIdentifierChar(char c) {
+  return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+//! Replaces the kernel name wherever it appears as a whole identifier
+std::string renameKernel(
+    const std::string& code,
+    const std::string& name,
+    const std::string& new_name) {
+  std::string renamed;
+  renamed.reserve(code.size());
+  size_t copied = 0;
+  for (size_t pos = code.find(name); pos != std::string::npos;
+       pos = code.find(name, pos + name.size())) {
+    const size_t end = pos + name.size();
+    if ((pos > 0 && isIdentifierChar(code[pos - 1])) ||
+        (end < code.size() && isIdentifierChar(code[end]))) {
+      continue;
+    }
+    renamed.append(code, copied, pos - copied);
+    renamed.append(new_name);
+    copied = end;
+  }
+  renamed.append(code, copied, std::string::npos);
+  return renamed;
+}
+
+} // namespace
+
 void FusionExecutor::compileFusion(
     Fusion* fusion,
     const KernelArgumentHolder& args,
     const LaunchParams& launch_constraints,
     CompileParams compile_params) {
   FUSER_PERF_SCOPE("compileFusion");
+  inst::CompileTimingsGuard compile_timings_guard(&compile_timings_);
+  inst::RuntimeMetrics::instance()->add(
+      inst::RuntimeCounter::KernelCompilations);
 
   TORCH_INTERNAL_ASSERT(
       !fusion->outputs().empty(), "No output found for this kernel, aborting.");
@@ -260,13 +573,38 @@ void FusionExecutor::compileFusion(
   device_smem_limit_ = properties->sharedMemPerBlockOptin;
   warp_size_ = properties->warpSize;
 
-  lowered_ = std::make_unique<GpuLower>(fusion, compile_params);
+  // See Note [ Lowering cache ]
+  const bool use_lowering_cache =
+      !isOptionDisabled(DisableOption::LoweringCache) &&
+      !fusion->hasAnyManaged();
+  std::string lowering_key;
+  LoweringCacheEntry cached_lowering;
+  lowered_.reset();
+  if (use_lowering_cache) {
+    lowering_key = loweringCacheKey(fusion, compile_params);
+    std::lock_guard<std::mutex> guard(lowering_cache_mutex);
+    auto it = lowering_cache.find(lowering_key);
+    if (it != lowering_cache.end()) {
+      lowered_ = it->second.lower.lock();
+      if (lowered_ != nullptr) {
+        cached_lowering = it->second;
+      } else {
+        lowering_cache.erase(it);
+      }
+    }
+  }
+  if (lowered_ == nullptr) {
+    lowered_ = std::make_shared<GpuLower>(fusion, compile_params);
+  }
 
   const auto kernel = lowered_->kernel();
   fusion_ = lowered_->kernel()->as<Fusion>();
 
   fusion_id_ = ++fusion_id_counter_;
   setUsedTVs();
+  setScatterSelfIndices();
+  setConcatOutputSlices();
+  setBroadcastInputIndices();
 
   if (isDebugDumpEnabled(DebugDumpOption::KernelIr)) {
     kernel->print();
@@ -293,7 +631,57 @@ void FusionExecutor::compileFusion(
     }
   }
 
-  kernel_code_ = codegen::generateCudaKernel(kernel, kernelName());
+  // TODO: pass block_size here;
+  c10::optional<int> block_size = c10::nullopt;
+  estimated_cost_.reset();
+  if (!args.empty()) {
+    auto expr_eval = executor_utils::bindInputs(args, kernel);
+    auto launch_params =
+        computeLaunchParams(launch_constraints, expr_eval, warp_size_);
+    block_size = launch_params.nThreads();
+    TORCH_INTERNAL_ASSERT(
+        block_size > 0, "launch param inferred block size < 0");
+
+    // See Note [ Kernel cost estimate ]
+    estimated_cost_ = estimateKernelCost(kernel, launch_params, expr_eval);
+    if (isDebugDumpEnabled(DebugDumpOption::KernelResources)) {
+      std::cout << kernelName() << " estimated cost: "
+                << estimated_cost_->toString() << std::endl;
+    }
+    if (cost_filter_ && !cost_filter_(estimated_cost_.value())) {
+      // Not worth compiling, leave the executor not compiled()
+      fusion_id_ = -1;
+      return;
+    }
+  }
+
+  // See Note [ Launch bounds ]
+  launch_bounds_ = launchBoundsFor(
+      compile_params,
+      block_size.has_value()
+          ? c10::optional<int64_t>(std::max<int64_t>(
+                block_size.value(), block_size_high_water_mark))
+          : c10::nullopt);
+
+  uint64_t kernel_code_hash = 0;
+  if (cached_lowering.lower.expired()) {
+    kernel_code_ = codegen::generateCudaKernel(
+        kernel, kernelName(), launch_bounds_, &kernel_code_hash);
+    kernel_code_hash_ = kernel_code_hash;
+    if (use_lowering_cache) {
+      std::lock_guard<std::mutex> guard(lowering_cache_mutex);
+      lowering_cache[lowering_key] = {
+          lowered_, kernel_code_, kernelName(), launch_bounds_};
+    }
+  } else if (cached_lowering.launch_bounds != launch_bounds_) {
+    kernel_code_ = codegen::generateCudaKernel(
+        kernel, kernelName(), launch_bounds_, &kernel_code_hash);
+    kernel_code_hash_ = kernel_code_hash;
+  } else {
+    kernel_code_ = renameKernel(
+        cached_lowering.kernel_code, cached_lowering.kernel_name, kernelName());
+    kernel_code_hash_ = c10::nullopt;
+  }
 
   auto load_external_code = [](const char* external_code_path) {
     std::cout << "--------> Compiling external cuda code: "
@@ -333,17 +721,6 @@ void FusionExecutor::compileFusion(
     TORCH_INTERNAL_ASSERT(false, ss.str());
   }
 
-  // TODO: pass block_size here;
-  c10::optional<int> block_size = c10::nullopt;
-  if (!args.empty()) {
-    auto expr_eval = executor_utils::bindInputs(args, kernel);
-    auto launch_params =
-        computeLaunchParams(launch_constraints, expr_eval, warp_size_);
-    block_size = launch_params.nThreads();
-    TORCH_INTERNAL_ASSERT(
-        block_size > 0, "launch param inferred block size < 0");
-  }
-
   // TODO: high water mark should be computed via occupancy API after
   // compilation.
 
@@ -354,18 +731,17 @@ void FusionExecutor::compileFusion(
       (block_size.has_value() ? block_size.value() : 1),
       block_size_high_water_mark);
   maxrregcount_high_water_mark = compile_params.maxrregcount;
-  std::tie(compiled_kernel_, last_compiler_log_, last_compiled_binary_) =
-      executor_utils::nvrtcCompile(
-          kernel_code_,
-          structured_code,
-          (kernelNamespace() + "::" + kernelName()).c_str(),
-          fusion_id_,
-          block_size,
-          maxrregcount_high_water_mark,
-          save_compiled_binary_ || isDebugDumpEnabled(DebugDumpOption::Sass));
+  fast_math_ = compile_params.fast_math;
+  compileKernel(
+      structured_code,
+      block_size,
+      save_compiled_binary_ || isDebugDumpEnabled(DebugDumpOption::Sass));
   TORCH_INTERNAL_ASSERT(
       fusion_id_ > 0, "failed to assign a fusion_id_ after compilation.");
 
+  executor_utils::KernelModuleGuard module_guard;
+  module_guard.pin(compiled_kernel_);
+
   // The driver API call requires an int argument.
   int max_dynamic_smem = 0;
   CUDA_SAFE_CALL(cuFuncGetAttribute(
@@ -374,13 +750,68 @@ void FusionExecutor::compileFusion(
       compiled_kernel_.function));
   maybe_available_dynamic_smem_ = max_dynamic_smem;
 
+  // See Note [ Programmatic dependent launch ]
+  programmatic_launch_ = isOptionEnabled(EnableOption::ProgrammaticLaunch) &&
+      CUDA_VERSION >= 12000 && properties->major >= 9 &&
+      !kernel_summary.has_cooperative_grid_reduction;
+
   if (isDebugDumpEnabled(DebugDumpOption::Sass)) {
     std::cout << disassembledKernelSASS() << std::endl;
   }
 }
 
+// Note [ Programmatic dependent launch ]
+//
+// Kernels launched back to back on a stream, like the segments of a
+// segmented fusion, each pay the launch latency and the drain of the
+// previous kernel's last wave before their first blocks start. With
+// PYTORCH_NVFUSER_ENABLE=programmatic_launch on Hopper, kernels are launched
+// with cuLaunchKernelEx and programmatic stream serialization, which lets a
+// kernel start as soon as all blocks of the previous kernel on the stream
+// signaled griddepcontrol.launch_dependents or exited. Codegen places
+//   griddepcontrol.wait;
+//   griddepcontrol.launch_dependents;
+// before the first top-level expression accessing global memory: the wait
+// blocks until the previous kernel completed and its memory is visible, and
+// the prologue before it, the setup of indices, shared memory and block
+// synchronization, overlaps the tail of the previous kernel. Writes are
+// kept after the wait as well, since the caching allocator may give the
+// outputs of a kernel the memory of intermediates the previous kernel is
+// still reading, see Note [ Intermediate buffer liveness ]. The kernel then
+// lets its own dependents launch. Cooperative kernels are launched without
+// it.
+
 namespace {
 
+//! Launches a kernel that may start before the previous kernel on `stream`
+//! is done, see Note [ Programmatic dependent launch ]
+void launchProgrammaticDependent(
+    CUfunction function,
+    const LaunchParams& launch_params,
+    CUstream stream,
+    void** kernel_args) {
+#if CUDA_VERSION >= 12000
+  CUlaunchAttribute attribute = {};
+  attribute.id = CU_LAUNCH_ATTRIBUTE_PROGRAMMATIC_STREAM_SERIALIZATION;
+  attribute.value.programmaticStreamSerializationAllowed = 1;
+  CUlaunchConfig config = {};
+  config.gridDimX = launch_params.gdimx();
+  config.gridDimY = launch_params.gdimy();
+  config.gridDimZ = launch_params.gdimz();
+  config.blockDimX = launch_params.bdimx();
+  config.blockDimY = launch_params.bdimy();
+  config.blockDimZ = launch_params.bdimz();
+  config.sharedMemBytes = launch_params.smem();
+  config.hStream = stream;
+  config.attrs = &attribute;
+  config.numAttrs = 1;
+  CUDA_SAFE_CALL(cuLaunchKernelEx(&config, function, kernel_args, nullptr));
+#else
+  TORCH_INTERNAL_ASSERT(
+      false, "Programmatic dependent launch requires CUDA 12 or newer");
+#endif
+}
+
 void fillTensorWithNan(at::Tensor& t) {
   switch (t.scalar_type()) {
     case at::ScalarType::Byte:
@@ -501,6 +932,11 @@ at::Tensor inferAndAllocOutput(
     ExpressionEvaluator& expr_eval,
     const CompileOptions& options,
     bool zero_init = false) {
+  // Scatter outputs are iterated over like src but have the shape of self,
+  // see Note [ Scatter outputs ]
+  if (auto sop = dynamic_cast<ScatterOp*>(tv->definition())) {
+    tv = sop->selfTv();
+  }
   const auto domain = tv->domain();
   const auto maybe_rfactor_domain = domain->hasRFactor()
       ? domain->getRFactorDomain()
@@ -521,8 +957,70 @@ at::Tensor inferAndAllocOutput(
   return inferAndAlloc(tv, sizes, expr_eval, expand_map, options, zero_init);
 }
 
+//! Evaluates the sizes of the outputs of `fusion` and returns them as
+//! non-allocated tensors on the device of `meta_options`
+KernelArgumentHolder evaluateFusionOutputSizes(
+    Fusion* fusion,
+    const KernelArgumentHolder& args,
+    ExpressionEvaluator& expr_eval,
+    const std::unordered_set<int>& alias_indices,
+    const CompileOptions& meta_options) {
+  KernelArgumentHolder ret(args.getIndexMode());
+  ret.setDeviceIndex(args.getDeviceIndex());
+
+  for (const auto out_i : c10::irange(fusion->outputs().size())) {
+    // If the output is just trivially the input, just "copy" it over, see note
+    // [trivial forwarding]
+    if (fusion->outputs()[out_i]->isFusionInput()) {
+      for (auto inp_i : c10::irange(fusion->inputs().size())) {
+        if (fusion->inputs()[inp_i] == fusion->outputs()[out_i]) {
+          TORCH_INTERNAL_ASSERT(
+              inp_i < args.size(),
+              "Issue with an input showing up as output, couldn't find input.");
+
+          auto tensor_arg_abstract =
+              dynamic_cast<const TensorArgAbstract*>(args[inp_i]);
+          TORCH_INTERNAL_ASSERT(
+              tensor_arg_abstract,
+              "Cannot register a scalar as an output in a fusion.");
+          ret.push(tensor_arg_abstract);
+          break;
+        }
+      }
+    } else {
+      TORCH_INTERNAL_ASSERT(
+          fusion->outputs()[out_i]->isA<TensorView>(),
+          "Cannot allocate outputs that are not tensors.");
+      auto output = fusion->outputs()[out_i]->as<TensorView>();
+      if (alias_indices.count((int)out_i) != 0) {
+        // aliasing to inputs, no need to allocate real output
+        // but we still need to push an entry here.
+        ret.push(int64_t(0));
+      } else {
+        // TODO: we are using meta here, which is bad since it doesn't account
+        // for devices. Switch to fake tensor instead
+        ret.push(inferAndAllocOutput(output, expr_eval, meta_options, false));
+      }
+    }
+  }
+  return ret;
+}
+
 } // namespace
 
+KernelArgumentHolder inferOutputSizes(
+    Fusion* fusion,
+    const KernelArgumentHolder& args) {
+  FUSER_PERF_SCOPE("inferOutputSizes");
+  FusionGuard fg(fusion);
+  auto expr_eval = executor_utils::bindInputs(args, fusion);
+
+  CompileOptions meta_options;
+  meta_options.device = c10::Device(c10::DeviceType::Meta, 0);
+  return evaluateFusionOutputSizes(
+      fusion, args, expr_eval, fusion->getOutputAliasIndices(), meta_options);
+}
+
 uint64_t FusionExecutor::computeSharedMemory(
     ExpressionEvaluator& expr_eval,
     const std::vector<const kir::Allocate*>& buffers,
@@ -736,14 +1234,39 @@ LaunchParams FusionExecutor::computeLaunchParams(
           (uint64_t)
               kernel_summary.outer_grouped_grid_welford_largest_smem_size);
     }
+    if (kernel_summary.has_outer_grouped_grid_reduction) {
+      reduction_broadcast_workspace = std::max(
+          reduction_broadcast_workspace,
+          (uint64_t)
+              kernel_summary.outer_grouped_grid_reduction_largest_smem_size);
+    }
+  }
+
+  // Buffers packed at lowering are laid out as a single region right after
+  // the workspace, see Note [ Shared memory offset packing ]
+  const auto& packed_smem = kernel_summary.packed_smem;
+  uint64_t smem_before_unpacked = reduction_broadcast_workspace;
+  std::vector<const kir::Allocate*> unpacked_smem_allocations;
+  if (packed_smem.size > 0) {
+    smem_before_unpacked =
+        ceilDiv((int64_t)reduction_broadcast_workspace, 16) * 16 +
+        packed_smem.size;
+    std::copy_if(
+        kernel_summary.dynamic_smem_allocations.begin(),
+        kernel_summary.dynamic_smem_allocations.end(),
+        std::back_inserter(unpacked_smem_allocations),
+        [&](const kir::Allocate* alloc) {
+          return packed_smem.offsets.count(alloc) == 0;
+        });
   }
 
   // NOLINTNEXTLINE(cppcoreguidelines-init-variables)
   const uint64_t dynamic_smem_size = computeSharedMemory(
       expr_eval,
-      kernel_summary.dynamic_smem_allocations,
+      packed_smem.size > 0 ? unpacked_smem_allocations
+                           : kernel_summary.dynamic_smem_allocations,
       true,
-      reduction_broadcast_workspace);
+      smem_before_unpacked);
 
   // Check that requested smem size can be dynamically allocated.
   //  This check is only done once a kernel has been compiled, since
@@ -807,11 +1330,184 @@ FusionExecutor::GlobalBuffers FusionExecutor::allocGlobalVals(
         tv == kernel->profile().getBuffer()) {
       global_buffers.profile_buffer = global_buffers.buffers.back();
     }
+    if (isOptionEnabled(EnableOption::KernelProfile) &&
+        tv == kernel->profile().getTimelineBuffer()) {
+      global_buffers.timeline_buffer = global_buffers.buffers.back();
+    }
   }
 
   return global_buffers;
 }
 
+namespace {
+
+// Alignment in bytes of each buffer carved out of a workspace
+constexpr int64_t kWorkspaceAlignment = 128;
+
+// Workspaces grow in power of two buckets, so that slowly growing sizes don't
+// reallocate on every launch
+int64_t workspaceBucketSize(int64_t nbytes) {
+  int64_t bucket_size = kWorkspaceAlignment;
+  while (bucket_size < nbytes) {
+    bucket_size *= 2;
+  }
+  return bucket_size;
+}
+
+} // namespace
+
+// Note [ Persistent workspace ]
+//
+// On cached launches, the work buffers and semaphores of grid reductions,
+// broadcasts and syncs are carved out of a workspace owned by the executor
+// instead of being allocated through the caching allocator on every launch.
+// A workspace is only used by launches on the stream it was created for, so
+// stream ordering guarantees that a launch never overlaps with the previous
+// user of the same buffers.
+//
+// Semaphores don't need to be zero-filled before every launch. The increments
+// of all blocks participating in a grid sync add up to exactly
+// FIRST_UINT64_BIT (see grid_sync::sync), which flips the top bit and leaves
+// the other bits zero. As waiting only tests for a flip of the top bit, a
+// semaphore that completed its syncs is a valid initial state for the next
+// launch, so semaphores are only zero-filled when the workspace grows. This
+// saves the memset launch of at::zeros on every launch.
+//
+// The other zero-initialized buffers are the accumulation slots of atomic
+// grid reductions, see Note [ Atomic grid reductions ]. The kernel resets
+// each slot to zero after reading it, so they don't need to be zero-filled
+// before every launch either. They are kept in their own storage instead of
+// sharing it with semaphores, as the bits a completed semaphore leaves
+// behind are not zero, and the layout of the buffers changes with the
+// launch sizes.
+//
+// Workspaces are not used under stream capture, where the zero-fill at
+// allocation would only be executed on replay, and where the graph would
+// keep reading and writing the workspace of the stream after its launches
+// outside the graph moved on. Captured launches allocate their buffers from
+// the private pool of the graph instead, see Note [ CUDA graph replay ].
+// Workspaces are not used with kernel profiling either, whose buffer
+// accumulates and has to be zeroed for each launch.
+FusionExecutor::GlobalBuffers FusionExecutor::getWorkspaceBuffers(
+    const ExecutorEntry& executor_entry,
+    const c10::cuda::CUDAStream& stream) {
+  FUSER_PERF_SCOPE("FusionExecutor::getWorkspaceBuffers");
+  TORCH_INTERNAL_ASSERT(
+      c10::cuda::currentStreamCaptureStatusMayInitCtx() ==
+          c10::cuda::CaptureStatus::None,
+      "Captured launches can't use the persistent workspace of a stream");
+  const auto num_buffers = executor_entry.buffer_sizes.size();
+
+  auto& workspace = workspaces_[stream.id()];
+  std::array<at::Tensor*, 3> storages = {
+      &workspace.buffers, &workspace.semaphores, &workspace.accumulators};
+
+  // Semaphores are the only zero-initialized integer buffers, the other
+  // zero-initialized buffers are accumulation slots
+  auto storage_index = [&executor_entry](size_t i) -> size_t {
+    if (!executor_entry.buffer_zero_init[i]) {
+      return 0;
+    }
+    return executor_entry.buffer_types[i] == at::kLong ? 1 : 2;
+  };
+
+  // Lay out non-zero-initialized buffers, semaphores and accumulation slots
+  // in their own storage
+  std::vector<int64_t> offsets(num_buffers, 0);
+  std::vector<int64_t> nbytes(num_buffers, 0);
+  std::array<int64_t, 3> storage_sizes = {0, 0, 0};
+  for (const auto i : c10::irange(num_buffers)) {
+    nbytes[i] = (int64_t)at::elementSize(executor_entry.buffer_types[i]) *
+        c10::multiply_integers(executor_entry.buffer_sizes[i]);
+    auto& total_size = storage_sizes.at(storage_index(i));
+    offsets[i] = total_size;
+    total_size = ceilDiv(total_size + nbytes[i], kWorkspaceAlignment) *
+        kWorkspaceAlignment;
+  }
+
+  auto ensure_size = [this](at::Tensor& storage, int64_t size, bool zero_init) {
+    if (storage.defined() && storage.numel() >= size) {
+      return;
+    }
+    const auto storage_options =
+        at::TensorOptions().dtype(at::kByte).device(options_.device);
+    const auto bucket_size = workspaceBucketSize(size);
+    storage = zero_init ? at::zeros({bucket_size}, storage_options)
+                        : at::empty({bucket_size}, storage_options);
+    recordAllocations({storage});
+  };
+  for (const auto i : c10::irange(storages.size())) {
+    ensure_size(*storages.at(i), storage_sizes.at(i), i != 0);
+  }
+
+  GlobalBuffers global_buffers;
+  for (const auto i : c10::irange(num_buffers)) {
+    const bool zero_init = executor_entry.buffer_zero_init[i];
+    auto& storage = *storages.at(storage_index(i));
+    auto buffer = storage.narrow(0, offsets[i], nbytes[i])
+                      .view(executor_entry.buffer_types[i])
+                      .view(executor_entry.buffer_sizes[i]);
+    if (!zero_init && shouldFillAllocationWithNan()) {
+      fillTensorWithNan(buffer);
+    }
+    global_buffers.buffers.push_back(buffer);
+    global_buffers.zero_init.push_back(zero_init);
+  }
+  return global_buffers;
+}
+
+// Note [ Output recycling ]
+//
+// In steady-state loops the same fusion is launched with the same input
+// shapes over and over, and the outputs of one iteration are dropped before
+// the next one. With output recycling enabled (see setOutputRecycling), an
+// executor entry keeps a reference to up to output_ring_size_ of the output
+// sets it allocated. A set is handed out again once the executor holds the
+// only reference to each of its tensors and their storages, i.e. the user
+// released the outputs and all views of them. This has the same semantics as
+// freeing the outputs to the caching allocator and getting the same blocks
+// back on the next allocation: reuse is ordered on the stream of the launch,
+// and consumers on other streams need to synchronize as they would have to
+// with record_stream. Aliased outputs are owned by the inputs they alias and
+// are never recycled. Outputs are not recycled under stream capture, where
+// they belong to the private memory pool of the graph.
+std::vector<at::Tensor> FusionExecutor::takeRecycledOutputs(
+    const ExecutorEntry& executor_entry) {
+  if (output_ring_size_ == 0 ||
+      c10::cuda::currentStreamCaptureStatusMayInitCtx() !=
+          c10::cuda::CaptureStatus::None) {
+    return {};
+  }
+  auto is_free = [](const at::Tensor& tensor) {
+    return !tensor.defined() ||
+        (tensor.use_count() == 1 && tensor.storage().use_count() == 1);
+  };
+  for (const auto& recycled : executor_entry.recycled_outputs) {
+    if (std::all_of(recycled.begin(), recycled.end(), is_free)) {
+      return recycled;
+    }
+  }
+  return {};
+}
+
+void FusionExecutor::recycleOutputs(
+    ExecutorEntry& executor_entry,
+    const std::vector<at::Tensor>& outputs) {
+  // The slices of a concatenated output share their storage, so they would
+  // never look free, see Note [ Cat into output slices ]
+  if (executor_entry.recycled_outputs.size() >= output_ring_size_ ||
+      !concat_output_slices_.empty() ||
+      c10::cuda::currentStreamCaptureStatusMayInitCtx() !=
+          c10::cuda::CaptureStatus::None) {
+    return;
+  }
+  auto recycled = outputs;
+  for (const auto& entry : executor_entry.io_alias_indices) {
+    recycled[entry.first] = at::Tensor();
+  }
+  executor_entry.recycled_outputs.push_back(std::move(recycled));
+}
+
 std::vector<at::Tensor> FusionExecutor::allocOutputSpace(
     const at::ArrayRef<c10::IValue>& inputs) {
   auto kernel_inputs = KernelArgumentHolder::createKernelArgumentHolder(inputs);
@@ -849,12 +1545,31 @@ std::vector<at::Tensor> FusionExecutor::allocOutputs(
         // aliasing to inputs, no need to allocate real output, just push empty
         // tensor here.
         outputs.emplace_back();
+      } else if (isConcatOutputSlice((int)out_i)) {
+        // allocated below as a view of its concatenated output
+        outputs.emplace_back();
       } else {
         outputs.push_back(
             inferAndAllocOutput(output, expr_eval, options_, false));
       }
     }
   }
+  if (!concat_output_slices_.empty()) {
+    allocConcatOutputSlices(outputs, [&](int out_i) {
+      std::vector<int64_t> sizes;
+      const auto output = kernel->outputs().at(out_i)->as<TensorView>();
+      for (auto id :
+           TensorDomain::noReductions(output->getMaybeRFactorDomain())) {
+        const auto extent = expr_eval.evaluate(id->extent());
+        TORCH_INTERNAL_ASSERT(
+            extent.has_value(),
+            "Cannot evaluate the extent of a concatenated output slice: ",
+            id->extent()->toInlineString());
+        sizes.push_back(extent->as<int64_t>());
+      }
+      return sizes;
+    });
+  }
   return outputs;
 }
 
@@ -865,61 +1580,181 @@ void FusionExecutor::setUsedTVs() {
   used_tvs_.insert(used_tvs_.begin(), used_tvs.begin(), used_tvs.end());
 }
 
+void FusionExecutor::setScatterSelfIndices() {
+  scatter_self_indices_.clear();
+  const auto& inputs = fusion_->inputs();
+  for (const auto out_i : c10::irange(fusion_->outputs().size())) {
+    auto sop =
+        dynamic_cast<ScatterOp*>(fusion_->outputs()[out_i]->definition());
+    if (sop == nullptr) {
+      continue;
+    }
+    auto inp_it = std::find(inputs.begin(), inputs.end(), sop->selfTv());
+    TORCH_INTERNAL_ASSERT(
+        inp_it != inputs.end(),
+        "The self tensor of scatter must be a fusion input: ",
+        sop->selfTv()->toString());
+    scatter_self_indices_.emplace_back(
+        (int)out_i, (int)std::distance(inputs.begin(), inp_it));
+  }
+}
+
+// Note [ L2 persistence of broadcast inputs ]
+//
+// Inputs that a kernel reads through a broadcast, like the weight and bias
+// of a normalization re-read for every row or a bias added to every row of
+// a pointwise kernel, are read by many blocks, which may run far apart in
+// time. With PYTORCH_NVFUSER_ENABLE=l2_persistence, a kernel is launched
+// with an access policy window over the largest of the inputs it reads
+// through a broadcast, as a segmented fusion is over the inputs read by
+// several segments, see Note [ L2 persistence of re-read inputs ]. A stream
+// only has a single window, so the window of the segmented fusion is kept
+// if there is one, and the window of the kernel is removed from the stream
+// right after its launch.
+void FusionExecutor::setBroadcastInputIndices() {
+  broadcast_input_indices_.clear();
+  const auto bcast_ops =
+      ir_utils::filterByType<BroadcastOp>(fusion_->exprs()).vector();
+  const auto& inputs = fusion_->inputs();
+  for (const auto inp_i : c10::irange(inputs.size())) {
+    auto input = inputs[inp_i];
+    if (!input->isA<TensorView>()) {
+      continue;
+    }
+    // Broadcasts of reductions of the input don't re-read it
+    const bool is_broadcast =
+        std::any_of(bcast_ops.begin(), bcast_ops.end(), [&](auto bop) {
+          if (bop->in() != input &&
+              !DependencyCheck::isDependencyOf(input, bop->in())) {
+            return false;
+          }
+          const auto exprs =
+              DependencyCheck::getAllExprsBetween({input}, {bop->in()});
+          return std::none_of(exprs.begin(), exprs.end(), [](auto expr) {
+            return expr->template isOneOf<
+                ReductionOp,
+                GroupedReductionOp,
+                WelfordOp,
+                GroupedWelfordOp>();
+          });
+        });
+    if (is_broadcast) {
+      broadcast_input_indices_.push_back((int)inp_i);
+    }
+  }
+}
+
+// Note [ Shared memory carveout ]
+//
+// The L1 cache and shared memory of an SM share the same storage, split at
+// a carveout the driver picks for the kernels resident on the SM. Before a
+// launch, a kernel sets its preferred carveout to what its blocks need: no
+// shared memory for kernels without dynamic shared memory, which leaves the
+// storage to L1 for the inputs they re-read, and otherwise the shared memory
+// of as many blocks as the threads of an SM allow, so that shared memory
+// doesn't limit the occupancy. The preference is only set again when it
+// changes. This can be turned off with
+// PYTORCH_NVFUSER_DISABLE=smem_carveout.
+void FusionExecutor::maybeSetSmemCarveout(const LaunchParams& launch_params) {
+  if (isOptionDisabled(DisableOption::SmemCarveout)) {
+    return;
+  }
+  int carveout = 0;
+  if (launch_params.smem() > 0) {
+    const auto prop = at::cuda::getDeviceProperties(options_.device.index());
+    const int64_t blocks_per_sm = std::min<int64_t>(
+        prop->maxBlocksPerMultiProcessor,
+        std::max<int64_t>(
+            1, prop->maxThreadsPerMultiProcessor / launch_params.nThreads()));
+    const int64_t smem_per_sm = blocks_per_sm *
+        (launch_params.smem() + (int64_t)prop->reservedSharedMemPerBlock);
+    carveout = (int)std::min<int64_t>(
+        100,
+        ceilDiv(100 * smem_per_sm, (int64_t)prop->sharedMemPerMultiprocessor));
+  }
+  if (carveout != smem_carveout_) {
+    CUDA_SAFE_CALL(cuFuncSetAttribute(
+        compiled_kernel_.function,
+        CU_FUNC_ATTRIBUTE_PREFERRED_SHARED_MEMORY_CARVEOUT,
+        carveout));
+    smem_carveout_ = carveout;
+  }
+}
+
+void FusionExecutor::initializeScatterOutputs(
+    const KernelArgumentHolder& args,
+    const std::vector<at::Tensor>& outputs) {
+  FUSER_PERF_SCOPE("ExecutorRunFusion::InitializeScatterOutputs");
+  for (const auto& entry : scatter_self_indices_) {
+    auto self_arg = dynamic_cast<const TensorArgAbstract*>(args[entry.second]);
+    TORCH_INTERNAL_ASSERT(
+        self_arg != nullptr, "The self tensor of scatter must be a tensor");
+    // The output is a copy of self with the scattered elements updated
+    auto output = outputs.at(entry.first);
+    output.copy_(self_arg->getTensor());
+  }
+}
+
+void FusionExecutor::setConcatOutputSlices() {
+  concat_output_slices_ = fusion_->getConcatOutputSlices();
+}
+
+bool FusionExecutor::isConcatOutputSlice(int out_i) const {
+  return std::any_of(
+      concat_output_slices_.begin(),
+      concat_output_slices_.end(),
+      [out_i](const auto& group) {
+        return std::find(group.first.begin(), group.first.end(), out_i) !=
+            group.first.end();
+      });
+}
+
+void FusionExecutor::allocConcatOutputSlices(
+    std::vector<at::Tensor>& outputs,
+    const std::function<std::vector<int64_t>(int)>& slice_sizes) {
+  for (const auto& group : concat_output_slices_) {
+    const auto& indices = group.first;
+    const auto dim = group.second;
+    std::vector<int64_t> extents;
+    auto buffer_sizes = slice_sizes(indices.front());
+    buffer_sizes.at(dim) = 0;
+    for (auto out_i : indices) {
+      extents.push_back(slice_sizes(out_i).at(dim));
+      buffer_sizes.at(dim) += extents.back();
+    }
+    const auto at_type = data_type_to_aten(
+        fusion_->outputs().at(indices.front())->as<TensorView>()->dtype());
+    auto buffer = at::native::empty_cuda(
+        buffer_sizes, at_type, c10::nullopt, options_.device, c10::nullopt);
+    if (shouldFillAllocationWithNan()) {
+      fillTensorWithNan(buffer);
+    }
+    // Each slice is the view of the buffer right after the one before it
+    int64_t offset = 0;
+    for (const auto slice_i : c10::irange(indices.size())) {
+      outputs.at(indices[slice_i]) =
+          buffer.narrow(dim, offset, extents[slice_i]);
+      offset += extents[slice_i];
+    }
+  }
+}
+
 KernelArgumentHolder FusionExecutor::evaluateOutputSizes(
     const KernelArgumentHolder& args,
     ExpressionEvaluator& expr_eval,
     const std::unordered_set<int>& alias_indices) {
   FUSER_PERF_SCOPE("FusionExecutor::AllocOutputs");
-  const auto kernel = lowered_->kernel();
-
-  KernelArgumentHolder ret(args.getIndexMode());
-  ret.setDeviceIndex(args.getDeviceIndex());
-
   CompileOptions meta_options = options_;
   meta_options.device = c10::Device(c10::DeviceType::Meta, 0);
-
-  for (const auto out_i : c10::irange(kernel->outputs().size())) {
-    // If the output is just trivially the input, just "copy" it over, see note
-    // [trivial forwarding]
-    if (kernel->outputs()[out_i]->isFusionInput()) {
-      for (auto inp_i : c10::irange(kernel->inputs().size())) {
-        if (kernel->inputs()[inp_i] == kernel->outputs()[out_i]) {
-          TORCH_INTERNAL_ASSERT(
-              inp_i < args.size(),
-              "Issue with an input showing up as output, couldn't find input.");
-
-          auto tensor_arg_abstract =
-              dynamic_cast<const TensorArgAbstract*>(args[inp_i]);
-          TORCH_INTERNAL_ASSERT(
-              tensor_arg_abstract,
-              "Cannot register a scalar as an output in a fusion.");
-          ret.push(tensor_arg_abstract);
-          break;
-        }
-      }
-    } else {
-      TORCH_INTERNAL_ASSERT(
-          kernel->outputs()[out_i]->isA<TensorView>(),
-          "Cannot allocate outputs that are not tensors.");
-      auto output = kernel->outputs()[out_i]->as<TensorView>();
-      if (alias_indices.count((int)out_i) != 0) {
-        // aliasing to inputs, no need to allocate real output
-        // but we still need to push an entry here.
-        ret.push(int64_t(0));
-      } else {
-        // TODO: we are using meta here, which is bad since it doesn't account
-        // for devices. Switch to fake tensor instead
-        ret.push(inferAndAllocOutput(output, expr_eval, meta_options, false));
-      }
-    }
-  }
-  return ret;
+  return evaluateFusionOutputSizes(
+      lowered_->kernel(), args, expr_eval, alias_indices, meta_options);
 }
 
 KernelArgumentHolder FusionExecutor::inferOutputSizes(
     const KernelArgumentHolder& args,
     const LaunchParams& launch_constraints) {
   FUSER_PERF_SCOPE("FusionExecutor::RunFusion");
+  std::lock_guard<std::mutex> guard(launch_mutex_);
 
   ExecutorEntry* executor_entry = nullptr;
   c10::optional<size_t> opt_code = args.getCacheId();
@@ -949,9 +1784,8 @@ KernelArgumentHolder FusionExecutor::inferOutputSizes(
   expr_eval.precomputedValues() = evaluator_precomputed_values_.get();
 
   // I think this binds something to expr_eval, so even though we are not using
-  // launch_params_, we still need this in order to infer output shapes.
-  launch_params_ =
-      computeLaunchParams(launch_constraints, expr_eval, warp_size_);
+  // the launch params, we still need this in order to infer output shapes.
+  computeLaunchParams(launch_constraints, expr_eval, warp_size_);
 
   executor_utils::validateVectorizedTensors(
       lowered_.get()->kernel(), args, {}, compileTimeDataCache(), expr_eval);
@@ -1022,6 +1856,23 @@ void validateIndexType(
 
 } // namespace
 
+// Note [ Concurrent launches ]
+//
+// An executor may be launched from multiple threads at once, e.g. by
+// inference streams sharing one FusionExecutorCache. The state of a launch,
+// i.e. its launch params, the kernel arguments and the kernel time, lives on
+// the stack of runFusion. The state shared by launches, i.e. the executor
+// entries and their packed arguments and recycled outputs, the per-stream
+// workspaces, the precomputed values, the compiled kernel and its function
+// attributes, is guarded by `launch_mutex_`. The lock is held until the kernel
+// is enqueued, which covers patching the packed arguments of the entry in
+// place, as cuLaunchKernel copies them, and keeps the dynamic shared memory
+// and carveout attributes of the function consistent with the launch. It is
+// released before waiting on the kernel time, so only host-side preparation
+// is serialized, while kernels of different streams run concurrently. The
+// launch params, kernel time and bytes of the last launch are then
+// published for profiling.
+
 std::vector<at::Tensor> FusionExecutor::runFusion(
     KernelArgumentHolder& args,
     const LaunchParams& launch_constraints,
@@ -1031,9 +1882,10 @@ std::vector<at::Tensor> FusionExecutor::runFusion(
   TORCH_INTERNAL_ASSERT(compiled());
   TORCH_INTERNAL_ASSERT(
       fusion_id_ > 0, "Cannot run fusion, it was not compiled.");
-  TORCH_INTERNAL_ASSERT(
-      !args.getCacheId().has_value() || outputs.empty(),
-      "short cut input cache is not compatible with pre-allocated output");
+
+  // See Note [ Kernel telemetry ]
+  const bool record_telemetry = inst::KernelTelemetry::enabled();
+  const auto host_start = inst::Trace::Clock::now();
 
   validateIndexType(kernel(), args, compile_params);
 
@@ -1054,6 +1906,9 @@ std::vector<at::Tensor> FusionExecutor::runFusion(
     std::cout << "maxrregcount= " << compile_params.maxrregcount << std::endl;
   }
 
+  // Held until the kernel is enqueued, see Note [ Concurrent launches ]
+  std::unique_lock<std::mutex> launch_lock(launch_mutex_);
+
   ExecutorEntry* executor_entry = nullptr;
   if (args.getCacheId().has_value()) {
     executor_entry = &executor_entry_lookup_[*args.getCacheId()];
@@ -1063,31 +1918,64 @@ std::vector<at::Tensor> FusionExecutor::runFusion(
   auto stream = at::cuda::getCurrentCUDAStream();
   at::cuda::jit::initializeCudaContext();
   TORCH_INTERNAL_ASSERT(lowered_);
-  launch_params_ = LaunchParams();
+
+  // Keep the module of the kernel loaded until it is launched, see
+  // Note [ Loaded kernel budget ]
+  executor_utils::KernelModuleGuard module_guard;
+  maybeSwapOptimizedKernel(module_guard);
+  module_guard.pin(compiled_kernel_);
+  LaunchParams launch_params;
   // NOLINTNEXTLINE(cppcoreguidelines-init-variables)
   std::vector<at::Tensor> allocated_outputs;
   GlobalBuffers global_buffers;
   uint64_t rand_offset = 0;
 
+  // On a hit of an initialized entry, the kernel parameters are patched into
+  // the packed arguments of the entry instead of being pushed to `args`
+  const bool use_packed_args = executor_entry && executor_entry->init &&
+      !disable_parameter_cache_ && !executor_entry->packed_args.empty();
+
   if (executor_entry && executor_entry->init && !disable_parameter_cache_) {
     {
       // context manager to disable auto grad for `empty_cuda` calls later
       at::AutoDispatchBelowADInplaceOrView non_variable_type_mode;
       // take the short-cut for launch if we see a recorded input set again
-      launch_params_ = executor_entry->launch_params;
+      launch_params = executor_entry->launch_params;
       // only allocate outputs when not given
       if (outputs.empty()) {
         FUSER_PERF_SCOPE("ExecutorRunFusion::OutputAlloc");
-        for (const auto i : c10::irange(executor_entry->output_sizes.size())) {
-          allocated_outputs.push_back(at::native::empty_strided_cuda(
-              executor_entry->output_sizes[i],
-              executor_entry->output_strides[i],
-              executor_entry->output_types[i],
-              c10::nullopt,
-              options_.device,
-              c10::nullopt));
-          if (shouldFillAllocationWithNan()) {
-            fillTensorWithNan(allocated_outputs.back());
+        allocated_outputs = takeRecycledOutputs(*executor_entry);
+        if (allocated_outputs.empty()) {
+          for (const auto i :
+               c10::irange(executor_entry->output_sizes.size())) {
+            if (isConcatOutputSlice((int)i)) {
+              allocated_outputs.emplace_back();
+              continue;
+            }
+            allocated_outputs.push_back(at::native::empty_strided_cuda(
+                executor_entry->output_sizes[i],
+                executor_entry->output_strides[i],
+                executor_entry->output_types[i],
+                c10::nullopt,
+                options_.device,
+                c10::nullopt));
+            if (shouldFillAllocationWithNan()) {
+              fillTensorWithNan(allocated_outputs.back());
+            }
+          }
+          if (!concat_output_slices_.empty()) {
+            allocConcatOutputSlices(allocated_outputs, [&](int out_i) {
+              return executor_entry->output_sizes.at(out_i);
+            });
+          }
+          recordAllocations(allocated_outputs);
+          recycleOutputs(*executor_entry, allocated_outputs);
+        } else if (shouldFillAllocationWithNan()) {
+          for (auto& output : allocated_outputs) {
+            // aliased slots are not recycled and left undefined
+            if (output.defined()) {
+              fillTensorWithNan(output);
+            }
           }
         }
         // Note: aliased output is not returned as output. But we still need it
@@ -1102,17 +1990,45 @@ std::vector<at::Tensor> FusionExecutor::runFusion(
           allocated_outputs[aliased_output_index] =
               tensor_arg_abstract->getTensor();
         }
-        args.push(allocated_outputs);
+        if (!use_packed_args) {
+          args.push(allocated_outputs);
+        }
       } else {
         TORCH_INTERNAL_ASSERT(
             outputs.size() == fusion_->outputs().size(),
             __func__,
             " provided number of outputs does match fusion output");
+        // The recorded launch was computed for the outputs allocated on the
+        // first run, so given outputs need to match them exactly
+        for (const auto i : c10::irange(outputs.size())) {
+          TORCH_CHECK(
+              outputs[i].is_cuda() && outputs[i].device() == options_.device &&
+                  outputs[i].scalar_type() == executor_entry->output_types[i] &&
+                  outputs[i].sizes() == executor_entry->output_sizes[i] &&
+                  outputs[i].strides() == executor_entry->output_strides[i],
+              "Provided output ",
+              i,
+              " does not match the cached output allocation, expected sizes ",
+              c10::IntArrayRef(executor_entry->output_sizes[i]),
+              " and strides ",
+              c10::IntArrayRef(executor_entry->output_strides[i]),
+              " but got ",
+              outputs[i].sizes(),
+              " and ",
+              outputs[i].strides());
+        }
         allocated_outputs = outputs;
-        args.push(outputs);
+        if (!use_packed_args) {
+          args.push(outputs);
+        }
       }
 
-      {
+      if (!isOptionDisabled(DisableOption::WorkspacePool) &&
+          !isOptionEnabled(EnableOption::KernelProfile) &&
+          c10::cuda::currentStreamCaptureStatusMayInitCtx() ==
+              c10::cuda::CaptureStatus::None) {
+        global_buffers = getWorkspaceBuffers(*executor_entry, stream);
+      } else {
         FUSER_PERF_SCOPE("ExecutorRunFusion::IntermediateBufferAlloc");
         for (const auto i : c10::irange(executor_entry->buffer_sizes.size())) {
           if (executor_entry->buffer_zero_init[i]) {
@@ -1135,6 +2051,7 @@ std::vector<at::Tensor> FusionExecutor::runFusion(
             global_buffers.zero_init.push_back(false);
           }
         }
+        recordAllocations(global_buffers.buffers);
       }
     }
     rand_offset = executor_entry->rand_offset;
@@ -1154,29 +2071,32 @@ std::vector<at::Tensor> FusionExecutor::runFusion(
     evaluator_precomputed_values_->bindInputs(args);
     expr_eval.precomputedValues() = evaluator_precomputed_values_.get();
 
-    launch_params_ =
+    launch_params =
         computeLaunchParams(launch_constraints, expr_eval, warp_size_);
 
     // Recompile the kernel if the number of threads in the block has increased
     // or maxrregcount has changed
-    if (launch_params_.nThreads() > block_size_high_water_mark ||
+    if (launch_params.nThreads() > block_size_high_water_mark ||
         compile_params.maxrregcount != maxrregcount_high_water_mark) {
+      inst::CompileTimingsGuard compile_timings_guard(&compile_timings_);
       const auto kernel = lowered_->kernel();
-      kernel_code_ = codegen::generateCudaKernel(kernel, kernelName());
+      block_size_high_water_mark = launch_params.nThreads();
+      launch_bounds_ =
+          launchBoundsFor(compile_params, block_size_high_water_mark);
+      uint64_t kernel_code_hash = 0;
+      kernel_code_ = codegen::generateCudaKernel(
+          kernel, kernelName(), launch_bounds_, &kernel_code_hash);
+      kernel_code_hash_ = kernel_code_hash;
       const auto structured_code =
           getStructuredCode(kernel_code_, kernel->indexType());
-      block_size_high_water_mark = launch_params_.nThreads();
       maxrregcount_high_water_mark = compile_params.maxrregcount;
 
-      std::tie(compiled_kernel_, last_compiler_log_, last_compiled_binary_) =
-          executor_utils::nvrtcCompile(
-              kernel_code_,
-              structured_code,
-              (kernelNamespace() + "::" + kernelName()).c_str(),
-              fusion_id_,
-              block_size_high_water_mark,
-              maxrregcount_high_water_mark,
-              save_compiled_binary_);
+      compileKernel(
+          structured_code, block_size_high_water_mark, save_compiled_binary_);
+      module_guard.pin(compiled_kernel_);
+      if (record_telemetry) {
+        inst::KernelTelemetry::instance()->recordRecompile(kernelName());
+      }
     }
 
     if (kernel()->summary().has_cooperative_grid_reduction) {
@@ -1184,25 +2104,25 @@ std::vector<at::Tensor> FusionExecutor::runFusion(
       CUDA_SAFE_CALL(cuOccupancyMaxActiveBlocksPerMultiprocessor(
           &num_blocks_per_SM,
           compiled_kernel_.function,
-          (int)(launch_params_.bdimx() * launch_params_.bdimy() * launch_params_.bdimz()),
-          (size_t)launch_params_.smem()));
+          (int)(launch_params.bdimx() * launch_params.bdimy() * launch_params.bdimz()),
+          (size_t)launch_params.smem()));
 
       TORCH_INTERNAL_ASSERT(
           (int64_t)(
               num_blocks_per_SM *
               at::cuda::getDeviceProperties(options_.device.index())
-                  ->multiProcessorCount) >= launch_params_.gdimx() *
-                  launch_params_.gdimy() * launch_params_.gdimz(),
+                  ->multiProcessorCount) >= launch_params.gdimx() *
+                  launch_params.gdimy() * launch_params.gdimz(),
           "Wanted to launch a cooperative kernel, however the number of blocks is greater than ",
           "what can be resident on the GPU at once. Need: ",
-          launch_params_.gdimx() * launch_params_.gdimy() *
-              launch_params_.gdimz(),
+          launch_params.gdimx() * launch_params.gdimy() *
+              launch_params.gdimz(),
           " (",
-          launch_params_.gdimx(),
+          launch_params.gdimx(),
           " * ",
-          launch_params_.gdimy(),
+          launch_params.gdimy(),
           " * ",
-          launch_params_.gdimz(),
+          launch_params.gdimz(),
           ") but limited to ",
           num_blocks_per_SM,
           " * ",
@@ -1240,6 +2160,7 @@ std::vector<at::Tensor> FusionExecutor::runFusion(
       auto& output_alias_indices = output_alias_indices_entry.get();
 
       allocated_outputs = allocOutputs(args, expr_eval, output_alias_indices);
+      recordAllocations(allocated_outputs);
 
       for (const auto& entry : alias_indices) {
         auto aliased_output_index = entry.first;
@@ -1260,6 +2181,7 @@ std::vector<at::Tensor> FusionExecutor::runFusion(
     }
 
     global_buffers = allocGlobalVals(expr_eval);
+    recordAllocations(global_buffers.buffers);
 
     if (kernel()->summary().max_rng_offsets >= 0) {
       // NOTE: this is how we map offset to PW kernels in order to have
@@ -1276,7 +2198,7 @@ std::vector<at::Tensor> FusionExecutor::runFusion(
     if (executor_entry) {
       FUSER_PERF_SCOPE("ExecutorRunFusion::FillCacheEntry");
       // record the the short-cut executor entry for the given input set;
-      executor_entry->launch_params = launch_params_;
+      executor_entry->launch_params = launch_params;
       executor_entry->io_alias_indices = alias_indices;
       for (const auto& output : allocated_outputs) {
         executor_entry->output_sizes.push_back(output.sizes().vec());
@@ -1296,16 +2218,52 @@ std::vector<at::Tensor> FusionExecutor::runFusion(
     }
   }
 
-  // push back global buffers
-  args.push(global_buffers.buffers);
+  if (execute_kernel_) {
+    initializeScatterOutputs(args, allocated_outputs);
+  }
 
-  // push back RNG state if needed
-  if (lowered_->kernel()->summary().max_rng_offsets >= 0) {
-    args.appendPhiloxRNGSeed(rand_offset);
+  void** kernel_args = nullptr;
+  if (use_packed_args) {
+    FUSER_PERF_SCOPE("ExecutorRunFusion::PatchPackedArgs");
+    auto& packed_args = executor_entry->packed_args;
+    size_t arg_i = 0;
+    // Input tensors of the same input id only differ in data pointers, but
+    // scalar inputs can have any value
+    for (; arg_i < num_inputs; ++arg_i) {
+      packed_args.setValue(arg_i, args[arg_i]);
+    }
+    for (const auto& output : allocated_outputs) {
+      packed_args.setPointer(arg_i++, output.data_ptr());
+    }
+    for (const auto& buffer : global_buffers.buffers) {
+      packed_args.setPointer(arg_i++, buffer.data_ptr());
+    }
+    if (lowered_->kernel()->summary().max_rng_offsets >= 0) {
+      const auto philox_state = getPhiloxRNGSeed(rand_offset);
+      packed_args.setValue(arg_i++, &philox_state, sizeof(philox_state));
+    }
+    TORCH_INTERNAL_ASSERT(
+        arg_i == packed_args.size(),
+        "Packed kernel arguments don't match the cached launch");
+    kernel_args = packed_args.getBuffer();
+  } else {
+    // push back global buffers
+    args.push(global_buffers.buffers);
+
+    // push back RNG state if needed
+    if (lowered_->kernel()->summary().max_rng_offsets >= 0) {
+      args.appendPhiloxRNGSeed(rand_offset);
+    }
+
+    // Record the layout of the arguments for the next hit of this entry
+    if (executor_entry && executor_entry->init && !disable_parameter_cache_) {
+      executor_entry->packed_args.pack(args);
+    }
+    kernel_args = args.getBuffer();
   }
 
   if (isDebugDumpEnabled(DebugDumpOption::LaunchParam)) {
-    launch_params_.print();
+    launch_params.print();
   }
 
   if (isDebugDumpEnabled(DebugDumpOption::KernelArgs)) {
@@ -1336,94 +2294,206 @@ std::vector<at::Tensor> FusionExecutor::runFusion(
   cudaEvent_t start_event = {};
   cudaEvent_t finish_event = {};
 
-  if (measure_kernel_time_ ||
+  const bool measure_kernel_time = measure_kernel_time_ || record_telemetry ||
       isDebugDumpEnabled(DebugDumpOption::EffectiveBandwidth) ||
-      isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose)) {
+      isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose);
+  if (measure_kernel_time) {
     CUDA_RT_SAFE_CALL(cudaEventCreate(&start_event));
     CUDA_RT_SAFE_CALL(cudaEventCreate(&finish_event));
     CUDA_RT_SAFE_CALL(cudaEventRecord(start_event, stream));
   }
 
+  // Keep the largest input read through a broadcast in L2, see
+  // Note [ L2 persistence of broadcast inputs ]
+  c10::optional<executor_utils::L2PersistenceWindow> l2_window;
+  if (execute_kernel_ && isOptionEnabled(EnableOption::L2Persistence) &&
+      !broadcast_input_indices_.empty() &&
+      !executor_utils::L2PersistenceWindow::isSetOn(stream)) {
+    c10::optional<at::Tensor> broadcast_input;
+    for (auto inp_i : broadcast_input_indices_) {
+      auto tensor_arg = dynamic_cast<const TensorArgAbstract*>(args[inp_i]);
+      if (tensor_arg == nullptr) {
+        continue;
+      }
+      const auto tensor = tensor_arg->getTensor();
+      if (tensor.is_cuda() &&
+          (!broadcast_input.has_value() ||
+           tensor.numel() * tensor.element_size() >
+               broadcast_input->numel() * broadcast_input->element_size())) {
+        broadcast_input = tensor;
+      }
+    }
+    if (broadcast_input.has_value()) {
+      l2_window.emplace(
+          broadcast_input.value(), std::vector<c10::cuda::CUDAStream>{stream});
+    }
+  }
+
   if (execute_kernel_) {
     if (maybe_available_dynamic_smem_.has_value() &&
-        size_t(launch_params_.smem()) > maybe_available_dynamic_smem_.value()) {
+        size_t(launch_params.smem()) > maybe_available_dynamic_smem_.value()) {
       // Increase limit of dynamic shared memory if needed.
       CUDA_SAFE_CALL(cuFuncSetAttribute(
           compiled_kernel_.function,
           CU_FUNC_ATTRIBUTE_MAX_DYNAMIC_SHARED_SIZE_BYTES,
-          launch_params_.smem()));
+          launch_params.smem()));
     }
-    if (!kernel()->summary().has_cooperative_grid_reduction) {
+    maybeSetSmemCarveout(launch_params);
+    if (programmatic_launch_) {
+      FUSER_PERF_SCOPE("ExecutorRunFusion::cuLaunchKernelEx");
+      launchProgrammaticDependent(
+          compiled_kernel_.function, launch_params, stream, kernel_args);
+    } else if (!kernel()->summary().has_cooperative_grid_reduction) {
       FUSER_PERF_SCOPE("ExecutorRunFusion::cuLaunchKernel");
       CUDA_SAFE_CALL(cuLaunchKernel(
           compiled_kernel_.function,
-          launch_params_.gdimx(),
-          launch_params_.gdimy(),
-          launch_params_.gdimz(),
-          launch_params_.bdimx(),
-          launch_params_.bdimy(),
-          launch_params_.bdimz(),
-          launch_params_.smem(),
+          launch_params.gdimx(),
+          launch_params.gdimy(),
+          launch_params.gdimz(),
+          launch_params.bdimx(),
+          launch_params.bdimy(),
+          launch_params.bdimz(),
+          launch_params.smem(),
           stream,
-          args.getBuffer(),
+          kernel_args,
           nullptr));
     } else {
       FUSER_PERF_SCOPE("ExecutorRunFusion::cuLaunchCooperativeKernel");
       CUDA_SAFE_CALL(cuLaunchCooperativeKernel(
           compiled_kernel_.function,
-          launch_params_.gdimx(),
-          launch_params_.gdimy(),
-          launch_params_.gdimz(),
-          launch_params_.bdimx(),
-          launch_params_.bdimy(),
-          launch_params_.bdimz(),
-          launch_params_.smem(),
+          launch_params.gdimx(),
+          launch_params.gdimy(),
+          launch_params.gdimz(),
+          launch_params.bdimx(),
+          launch_params.bdimy(),
+          launch_params.bdimz(),
+          launch_params.smem(),
           stream,
-          args.getBuffer()));
+          kernel_args));
     }
   }
 
-  if (measure_kernel_time_ ||
-      isDebugDumpEnabled(DebugDumpOption::EffectiveBandwidth) ||
-      isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose)) {
+  if (measure_kernel_time) {
     CUDA_RT_SAFE_CALL(cudaEventRecord(finish_event, stream));
+  }
+  launch_lock.unlock();
+  const std::chrono::duration<double, std::milli> host_overhead =
+      inst::Trace::Clock::now() - host_start;
+
+  float kernel_time_ms = 0;
+  int64_t bytes_processed = 0;
+  if (measure_kernel_time) {
     CUDA_RT_SAFE_CALL(cudaEventSynchronize(start_event));
     CUDA_RT_SAFE_CALL(cudaEventSynchronize(finish_event));
     CUDA_RT_SAFE_CALL(
-        cudaEventElapsedTime(&kernel_time_ms_, start_event, finish_event));
+        cudaEventElapsedTime(&kernel_time_ms, start_event, finish_event));
     CUDA_RT_SAFE_CALL(cudaEventDestroy(start_event));
     CUDA_RT_SAFE_CALL(cudaEventDestroy(finish_event));
 
-    bytes_processed_ = 0;
     // Figure how many bytes are inputs, outputs, and temporary buffers
     for (auto i : c10::irange(num_inputs)) {
       if (auto tensor_arg_abstract =
               dynamic_cast<const TensorArgAbstract*>(args[i])) {
-        bytes_processed_ += tensor_arg_abstract->numel() *
+        bytes_processed += tensor_arg_abstract->numel() *
             (int64_t)dataTypeSize(tensor_arg_abstract->getDataType());
       }
     }
     for (const auto& output : allocated_outputs) {
-      bytes_processed_ += output.numel() *
+      bytes_processed += output.numel() *
           (int64_t)dataTypeSize(aten_to_data_type(output.scalar_type()));
     }
 
     if (isDebugDumpEnabled(DebugDumpOption::EffectiveBandwidth)) {
       double gb_per_s =
-          ((double)bytes_processed_ / ((double)kernel_time_ms_ / 1000)) /
+          ((double)bytes_processed / ((double)kernel_time_ms / 1000)) /
           (double)1.0e9;
-      std::cout << "kernel" << fusion_id_ << " run in " << kernel_time_ms_
+      std::cout << "kernel" << fusion_id_ << " run in " << kernel_time_ms
                 << " ms, achieved: " << gb_per_s << " GB/s" << std::endl;
     }
   }
 
+  {
+    std::lock_guard<std::mutex> guard(launch_mutex_);
+    launch_params_ = launch_params;
+    if (measure_kernel_time) {
+      kernel_time_ms_ = kernel_time_ms;
+      bytes_processed_ = bytes_processed;
+    }
+  }
+
+  if (record_telemetry && execute_kernel_) {
+    inst::KernelTelemetry::instance()->recordLaunch(
+        kernelName(), host_overhead.count(), kernel_time_ms);
+  }
+
+  if (isDebugDumpEnabled(DebugDumpOption::KernelResources)) {
+    const auto usage = kernelResourceUsage();
+    std::cout << "kernel" << fusion_id_ << " resources: "
+              << usage.registers_per_thread << " registers, "
+              << usage.local_bytes_per_thread << " bytes of local memory, "
+              << usage.static_smem_bytes << " + " << usage.dynamic_smem_bytes
+              << " bytes of static + dynamic shared memory, "
+              << usage.max_active_blocks_per_sm << " blocks of "
+              << launch_params.nThreads() << " threads per SM, occupancy "
+              << usage.occupancy << std::endl;
+  }
+
   if (isOptionEnabled(EnableOption::KernelProfile)) {
     std::cout << kernel()->profile().toString(global_buffers.profile_buffer);
+    kernel()->profile().recordTimeline(
+        global_buffers.timeline_buffer, kernelName(), options_.device.index());
   }
 
   return allocated_outputs;
 }
 
+KernelResourceUsage FusionExecutor::kernelResourceUsage() {
+  TORCH_INTERNAL_ASSERT(
+      compiled(), "Resource usage requires a compiled kernel");
+  std::lock_guard<std::mutex> guard(launch_mutex_);
+  c10::DeviceGuard dg(options_.device);
+  executor_utils::KernelModuleGuard module_guard;
+  module_guard.pin(compiled_kernel_);
+
+  KernelResourceUsage usage;
+  CUDA_SAFE_CALL(cuFuncGetAttribute(
+      &usage.registers_per_thread,
+      CU_FUNC_ATTRIBUTE_NUM_REGS,
+      compiled_kernel_.function));
+  CUDA_SAFE_CALL(cuFuncGetAttribute(
+      &usage.local_bytes_per_thread,
+      CU_FUNC_ATTRIBUTE_LOCAL_SIZE_BYTES,
+      compiled_kernel_.function));
+  CUDA_SAFE_CALL(cuFuncGetAttribute(
+      &usage.static_smem_bytes,
+      CU_FUNC_ATTRIBUTE_SHARED_SIZE_BYTES,
+      compiled_kernel_.function));
+  CUDA_SAFE_CALL(cuFuncGetAttribute(
+      &usage.max_threads_per_block,
+      CU_FUNC_ATTRIBUTE_MAX_THREADS_PER_BLOCK,
+      compiled_kernel_.function));
+  usage.dynamic_smem_bytes = launch_params_.smem();
+
+  const auto block_size = launch_params_.nThreads();
+  if (block_size <= 0) {
+    return usage;
+  }
+  CUDA_SAFE_CALL(cuOccupancyMaxActiveBlocksPerMultiprocessor(
+      &usage.max_active_blocks_per_sm,
+      compiled_kernel_.function,
+      (int)block_size,
+      (size_t)launch_params_.smem()));
+  const auto properties =
+      at::cuda::getDeviceProperties(options_.device.index());
+  const auto threads_per_block =
+      ceilDiv(block_size, (int64_t)properties->warpSize) *
+      properties->warpSize;
+  usage.occupancy =
+      (double)(usage.max_active_blocks_per_sm * threads_per_block) /
+      (double)properties->maxThreadsPerMultiProcessor;
+  return usage;
+}
+
 void FusionExecutor::compileRtc(
     const std::string& code,
     const std::string& name,
@@ -1455,6 +2525,9 @@ float FusionExecutor::runRtc(
   c10::DeviceGuard dg(options_.device);
   auto stream = at::cuda::getCurrentCUDAStream();
 
+  executor_utils::KernelModuleGuard module_guard;
+  module_guard.pin(compiled_kernel_);
+
   cudaEvent_t start_event = {};
   cudaEvent_t finish_event = {};
 
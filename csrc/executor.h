@@ -6,17 +6,26 @@
  */
 // clang-format on
 #pragma once
+#include <codegen.h>
 #include <executor_params.h>
 #include <executor_utils.h>
 #include <expr_evaluator.h>
 #include <fusion.h>
+#include <instrumentation.h>
 #include <ir_all_nodes.h>
 #include <ir_cloner.h>
 #include <ir_printer.h>
 #include <lower2device.h>
+#include <lower_kernel_cost.h>
 #include <utils.h>
 
 #include <c10/core/DeviceType.h>
+#include <c10/cuda/CUDAStream.h>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
 
 namespace nvfuser {
 
@@ -49,6 +58,30 @@ struct TORCH_CUDA_CU_API CompileOptions {
   c10::Device device = c10::Device(c10::DeviceType::CUDA, 0);
 };
 
+//! infers output sizes of an unscheduled and uncompiled `fusion` by evaluating
+//! the extents of its outputs on `args`. Returns non-allocated
+//! KernelArgumentHolder like FusionExecutor::inferOutputSizes, which makes it
+//! possible to set up the inputs of all segments before any of them is
+//! compiled.
+TORCH_CUDA_CU_API KernelArgumentHolder
+inferOutputSizes(Fusion* fusion, const KernelArgumentHolder& args);
+
+//! Resources the compiled kernel uses at the launch parameters of its last
+//! launch, see FusionExecutor::kernelResourceUsage
+struct TORCH_CUDA_CU_API KernelResourceUsage {
+  int registers_per_thread = 0;
+  //! Local memory of a thread, i.e. its stack and spilled registers
+  int local_bytes_per_thread = 0;
+  int static_smem_bytes = 0;
+  int64_t dynamic_smem_bytes = 0;
+  //! Largest block the kernel can be launched with given its registers
+  int max_threads_per_block = 0;
+  //! Blocks resident on a multiprocessor at once
+  int max_active_blocks_per_sm = 0;
+  //! Resident threads relative to the maximum of a multiprocessor
+  double occupancy = 0;
+};
+
 class TORCH_CUDA_CU_API FusionExecutor : public NonCopyable {
  public:
   // Unsafe compilation that's useful for debugging kernels, iterating over
@@ -120,10 +153,23 @@ class TORCH_CUDA_CU_API FusionExecutor : public NonCopyable {
     return fusion_id_ != -1 && lowered_;
   };
 
+  //! Whether the kernel is a fast compilation that hasn't been replaced by
+  //! its recompilation at full optimization yet, see
+  //! Note [ Fast compilation ]
+  bool isRecompiling() const {
+    return optimized_kernel_ != nullptr;
+  }
+
   void evictCache(size_t cache_id) {
+    std::lock_guard<std::mutex> guard(launch_mutex_);
     executor_entry_lookup_.erase(cache_id);
   }
 
+  //! Host memory held by the code and the binary of the compiled kernel
+  size_t kernelHostBytes() const {
+    return kernel_code_.size() + last_compiled_binary_.size();
+  }
+
   // struct used to hold necessary information to launch compiled kernel on a
   // given input set.
   //
@@ -142,6 +188,11 @@ class TORCH_CUDA_CU_API FusionExecutor : public NonCopyable {
     std::vector<at::ScalarType> buffer_types;
     std::vector<bool> buffer_zero_init;
     uint64_t rand_offset;
+    //! kernel parameters of the last launch, patched on later hits
+    PackedKernelArguments packed_args;
+    //! output sets allocated for this entry that are recycled once they are
+    //! no longer referenced, see setOutputRecycling
+    std::vector<std::vector<at::Tensor>> recycled_outputs;
   };
 
   using ExecutorCompileTimeInfoCache =
@@ -159,6 +210,7 @@ class TORCH_CUDA_CU_API FusionExecutor : public NonCopyable {
 
   //! Internal knob used for debugging/profiling only
   void setMeasureKernelTimeFlag(bool measure_kernel_time) {
+    std::lock_guard<std::mutex> guard(launch_mutex_);
     measure_kernel_time_ = measure_kernel_time;
   }
 
@@ -173,24 +225,60 @@ class TORCH_CUDA_CU_API FusionExecutor : public NonCopyable {
   //!    setMeasureKernelTimeFlag(true)
   //!
   float kernelTimeMs() const {
+    std::lock_guard<std::mutex> guard(launch_mutex_);
     return measure_kernel_time_ ? kernel_time_ms_ : 0;
   }
 
   //! Returns the number of bytes processed last kernel execution
   int64_t bytesProcessed() const {
+    std::lock_guard<std::mutex> guard(launch_mutex_);
     return bytes_processed_;
   }
 
   //! Returns the launch parameters from the last kernel execution
   LaunchParams lastLaunchParams() const {
+    std::lock_guard<std::mutex> guard(launch_mutex_);
     return launch_params_;
   }
 
+  //! Registers, shared memory and occupancy of the compiled kernel at the
+  //! launch parameters of its last launch, e.g. for profiling
+  KernelResourceUsage kernelResourceUsage();
+
+  //! Static estimate of the work of the lowered kernel at the launch
+  //! parameters of its compilation, see Note [ Kernel cost estimate ].
+  //! Empty if the kernel was compiled without arguments.
+  const c10::optional<KernelCostEstimate>& estimatedCost() const {
+    return estimated_cost_;
+  }
+
+  //! Decides from the cost estimate whether a kernel is worth compiling
+  using CostFilter = std::function<bool(const KernelCostEstimate&)>;
+
+  //! Makes compileFusion stop right after lowering, before the code
+  //! generation and NVRTC, when filter rejects the cost estimate of the
+  //! kernel. The executor is then left not compiled().
+  void setCostFilter(CostFilter filter) {
+    cost_filter_ = std::move(filter);
+  }
+
   //! Returns the string of the compiled kernel
   std::string kernelString() const {
     return kernel_code_;
   }
 
+  //! Durations of the compilation stages of this kernel, including the
+  //! recompilations for a larger block size
+  const inst::CompileTimings& compileTimings() const {
+    return compile_timings_;
+  }
+
+  //! The compile timings stages are recorded into by an executor's owner,
+  //! e.g. the scheduling of the fusion before compileFusion
+  inst::CompileTimings& compileTimings() {
+    return compile_timings_;
+  }
+
   //! Returns the latest compile log
   std::string compilerLog() const {
     return last_compiler_log_;
@@ -242,6 +330,21 @@ class TORCH_CUDA_CU_API FusionExecutor : public NonCopyable {
     disable_parameter_cache_ = true;
   }
 
+  //! Keep up to `ring_size` output sets per cached input id and reuse a set
+  //! on a later launch once all of its tensors are no longer referenced
+  //! outside of the executor. Releasing an output is then equivalent to
+  //! freeing it through the caching allocator, but avoids the allocator on
+  //! the hot path. 0 disables recycling.
+  void setOutputRecycling(size_t ring_size) {
+    std::lock_guard<std::mutex> guard(launch_mutex_);
+    output_ring_size_ = ring_size;
+    if (ring_size == 0) {
+      for (auto& entry : executor_entry_lookup_) {
+        entry.second.recycled_outputs.clear();
+      }
+    }
+  }
+
   //! Used in distributed setting where we only want to
   //!  allocate output space and receive output data from
   //!  a different rank instead of computing them.
@@ -254,6 +357,20 @@ class TORCH_CUDA_CU_API FusionExecutor : public NonCopyable {
     std::vector<at::Tensor> buffers;
     std::vector<bool> zero_init;
     at::Tensor profile_buffer;
+    at::Tensor timeline_buffer;
+  };
+
+  //! Global buffers reused by all launches on one stream, see
+  //! Note [ Persistent workspace ]
+  struct Workspace {
+    //! storage of non-zero-initialized buffers, e.g. grid reduction work
+    //! buffers
+    at::Tensor buffers;
+    //! storage of grid sync semaphores, only zero-filled when allocated
+    at::Tensor semaphores;
+    //! storage of the accumulation slots of atomic grid reductions, only
+    //! zero-filled when allocated as the kernel resets them after use
+    at::Tensor accumulators;
   };
 
   static std::string kernelNamespace() {
@@ -280,6 +397,23 @@ class TORCH_CUDA_CU_API FusionExecutor : public NonCopyable {
   // not initialized, while the second vector contains zero-initiliazed tensors
   GlobalBuffers allocGlobalVals(ExpressionEvaluator& expr_eval);
 
+  //! Returns an output set of the entry that is no longer referenced outside
+  //! of the executor, or an empty vector if there is none
+  std::vector<at::Tensor> takeRecycledOutputs(
+      const ExecutorEntry& executor_entry);
+
+  //! Keeps freshly allocated outputs of the entry for recycling if its ring
+  //! is not full yet
+  void recycleOutputs(
+      ExecutorEntry& executor_entry,
+      const std::vector<at::Tensor>& outputs);
+
+  //! carves the global buffers recorded in `executor_entry` out of the
+  //! workspace of `stream`, growing the workspace if needed
+  GlobalBuffers getWorkspaceBuffers(
+      const ExecutorEntry& executor_entry,
+      const c10::cuda::CUDAStream& stream);
+
   // alias_index: index of outputs that are aliases to inputs, hence we should
   // skip allocating real storage for those, but still maintain its spot to
   // maintain the indexing from output aliases to inputs
@@ -288,12 +422,56 @@ class TORCH_CUDA_CU_API FusionExecutor : public NonCopyable {
       ExpressionEvaluator& expr_eval,
       const std::unordered_set<int>& alias_indices = {});
 
+  //! compiles `structured_code` into `compiled_kernel_`. With
+  //! `PYTORCH_NVFUSER_ENABLE=fast_compile`, the kernel is compiled at a low
+  //! optimization level and recompiled at full optimization in the
+  //! background, see Note [ Fast compilation ]
+  void compileKernel(
+      const std::string& structured_code,
+      c10::optional<int> block_size,
+      bool return_compiled_binary);
+
+  //! swaps in the kernel recompiled at full optimization once it is ready,
+  //! pinning its module with `module_guard`
+  void maybeSwapOptimizedKernel(
+      executor_utils::KernelModuleGuard& module_guard);
+
   void setUsedTVs();
 
   const std::vector<TensorView*>& getUsedTVs() const {
     return used_tvs_;
   };
 
+  //! records the fusion outputs that scatter into a copy of a fusion input,
+  //! see Note [ Scatter outputs ]
+  void setScatterSelfIndices();
+
+  //! copies the self tensors of scatter ops into their outputs
+  void initializeScatterOutputs(
+      const KernelArgumentHolder& args,
+      const std::vector<at::Tensor>& outputs);
+
+  //! records the groups of outputs that are slices of one concatenated
+  //! output, see Note [ Cat into output slices ]
+  void setConcatOutputSlices();
+
+  //! records the inputs read through a broadcast, see
+  //! Note [ L2 persistence of broadcast inputs ]
+  void setBroadcastInputIndices();
+
+  //! sets the shared memory carveout preference of the kernel for
+  //! `launch_params`, see Note [ Shared memory carveout ]
+  void maybeSetSmemCarveout(const LaunchParams& launch_params);
+
+  //! returns true if output `out_i` is allocated by allocConcatOutputSlices
+  bool isConcatOutputSlice(int out_i) const;
+
+  //! allocates each group of concatenated output slices as adjacent views of
+  //! a single buffer, given the sizes of the slices
+  void allocConcatOutputSlices(
+      std::vector<at::Tensor>& outputs,
+      const std::function<std::vector<int64_t>(int)>& slice_sizes);
+
   ExecutorCompileTimeInfoCache* compileTimeDataCache() {
     return &compile_time_info_cache_;
   }
@@ -329,14 +507,47 @@ class TORCH_CUDA_CU_API FusionExecutor : public NonCopyable {
   int warp_size_ = 0;
   executor_utils::NvrtcFunction compiled_kernel_;
 
+  //! Result of the background recompilation at full optimization
+  struct OptimizedKernel {
+    executor_utils::NvrtcFunction function;
+    std::atomic<bool> ready{false};
+  };
+  //! Recompilation of `compiled_kernel_` in flight, if any, see
+  //! Note [ Fast compilation ]
+  std::shared_ptr<OptimizedKernel> optimized_kernel_;
+
   // TensorViews actually used in the kernel.
   std::vector<TensorView*> used_tvs_;
 
+  //! Pairs of <output, input> indices of the outputs of scatter ops and their
+  //! self tensors
+  std::vector<std::pair<int, int>> scatter_self_indices_;
+
+  //! Output indices of the slices of each concatenated output with their
+  //! concatenated dimension
+  std::vector<std::pair<std::vector<int>, int64_t>> concat_output_slices_;
+
+  //! Indices of the tensor inputs read through a broadcast
+  std::vector<int> broadcast_input_indices_;
+
+  //! Carveout preference last set on the compiled kernel, -1 if none
+  int smem_carveout_ = -1;
+
+  //! Whether the kernel is launched with programmatic stream serialization,
+  //! see Note [ Programmatic dependent launch ]
+  bool programmatic_launch_ = false;
+
   // Counter to be used for kernel name.
   int fusion_id_ = -1;
-  static int fusion_id_counter_;
+  // Shared by all executors, which may be compiled concurrently
+  static std::atomic<int> fusion_id_counter_;
+
+  //! Shared among executors of identical fusions, see
+  //! Note [ Lowering cache ]
+  std::shared_ptr<GpuLower> lowered_;
 
-  std::unique_ptr<GpuLower> lowered_;
+  // Workspaces for global buffers, indexed by the stream they are used on
+  std::unordered_map<c10::StreamId, Workspace> workspaces_;
   // Copy of lowered_->kernel()
   Fusion* fusion_ = nullptr;
 
@@ -344,6 +555,11 @@ class TORCH_CUDA_CU_API FusionExecutor : public NonCopyable {
   // increases, recompile to adjust maxregister count.
   int64_t block_size_high_water_mark = 1;
   int maxrregcount_high_water_mark = 255;
+  // Launch bounds the kernel is declared with, see Note [ Launch bounds ]
+  codegen::LaunchBounds launch_bounds_;
+
+  // Whether the kernel is compiled with fast math, see CompileParams
+  bool fast_math_ = false;
 
   // lookup table to take short cut to retrieve recorded information in order to
   // launch kernels without re-inference parameters.
@@ -372,21 +588,42 @@ class TORCH_CUDA_CU_API FusionExecutor : public NonCopyable {
   // Profiling support: the last kernel Bytes processed
   int64_t bytes_processed_ = 0;
 
-  // Profiling support: the last launch param used
+  // Profiling support: the last launch param used. Launches compute their
+  // own and only publish them here, see Note [ Concurrent launches ]
   LaunchParams launch_params_;
 
+  // Guards the state shared by launches from multiple threads, i.e. the
+  // executor entries, workspaces, the compiled kernel and the profiling
+  // results above, see Note [ Concurrent launches ]
+  mutable std::mutex launch_mutex_;
+
   // Profiling support: disable caching of launch params and output allocation
   // output allocation is also disable when output sizes are dependent on
   // runtime scalar inputs, such as for the case of tensor factory. see
   // https://github.com/csarofeen/pytorch/issues/2002
   bool disable_parameter_cache_ = false;
 
+  // Number of output sets recycled per cached input id, see
+  // setOutputRecycling
+  size_t output_ring_size_ = 0;
+
   // Profiling support: kept copy of the cuda kernel
   std::string kernel_code_;
 
+  // fnv1a_hash of kernel_code_ if it was computed during code generation, see
+  // Note [ Streaming kernel emission ] in codegen.cpp
+  c10::optional<uint64_t> kernel_code_hash_;
+
   // Profiling support: nvrtc log for debugging
   std::string last_compiler_log_;
 
+  // See Note [ Compile time instrumentation ]
+  inst::CompileTimings compile_timings_;
+
+  // See estimatedCost and setCostFilter
+  c10::optional<KernelCostEstimate> estimated_cost_;
+  CostFilter cost_filter_;
+
   // save compiled binary
   bool save_compiled_binary_ = false;
 
@@ -107,6 +107,10 @@ std::unique_ptr<TensorArgAbstract> getTensorArg(
       return getTensorArg<int64_t, INDEX_MODE>(nDims);
     case c10::ScalarType::Int:
       return getTensorArg<int32_t, INDEX_MODE>(nDims);
+    case c10::ScalarType::Char:
+      return getTensorArg<int8_t, INDEX_MODE>(nDims);
+    case c10::ScalarType::Byte:
+      return getTensorArg<uint8_t, INDEX_MODE>(nDims);
     case c10::ScalarType::ComplexFloat:
       return getTensorArg<c10::complex<float>, INDEX_MODE>(nDims);
     case c10::ScalarType::ComplexDouble:
@@ -231,6 +235,18 @@ void KernelArgumentHolder::push(const at::Tensor& tensor) {
                 CpuScalarTensorArg<CpuScalarTensorCodegen<int32_t>>>(
                 tensor.data_ptr<int32_t>()[0]));
         break;
+      case c10::ScalarType::Char:
+        arguments_.push_back(
+            std::make_unique<
+                CpuScalarTensorArg<CpuScalarTensorCodegen<int8_t>>>(
+                tensor.data_ptr<int8_t>()[0]));
+        break;
+      case c10::ScalarType::Byte:
+        arguments_.push_back(
+            std::make_unique<
+                CpuScalarTensorArg<CpuScalarTensorCodegen<uint8_t>>>(
+                tensor.data_ptr<uint8_t>()[0]));
+        break;
       default:
         TORCH_CHECK(
             false,
@@ -289,10 +305,12 @@ void KernelArgumentHolder::push(const c10::IValue& val) {
 }
 
 void KernelArgumentHolder::push(int64_t val) {
+  changed_ = true;
   arguments_.push_back(std::make_unique<LongArg>(val));
 }
 
 void KernelArgumentHolder::push(const at::PhiloxCudaState& val) {
+  changed_ = true;
   arguments_.push_back(std::make_unique<PhiloxCudaStateArg>(val));
 }
 
@@ -339,7 +357,14 @@ void KernelArgumentHolder::swap(int i, const ArgAbstract* arg) {
   arguments_[i].swap(holder);
 }
 
-void KernelArgumentHolder::appendPhiloxRNGSeed(uint64_t rand_offset) {
+void KernelArgumentHolder::releaseTensor(size_t ind) {
+  if (auto tensor_arg =
+          dynamic_cast<TensorArgAbstract*>(arguments_.at(ind).get())) {
+    tensor_arg->setTensor(at::Tensor());
+  }
+}
+
+at::PhiloxCudaState getPhiloxRNGSeed(uint64_t rand_offset) {
   at::PhiloxCudaState philox_engine_inputs;
   auto gen = at::cuda::detail::getDefaultCUDAGenerator();
   {
@@ -349,7 +374,33 @@ void KernelArgumentHolder::appendPhiloxRNGSeed(uint64_t rand_offset) {
         at::check_generator<at::CUDAGeneratorImpl>(gen)->philox_cuda_state(
             rand_offset);
   }
-  push(philox_engine_inputs);
+  return philox_engine_inputs;
+}
+
+void KernelArgumentHolder::appendPhiloxRNGSeed(uint64_t rand_offset) {
+  push(getPhiloxRNGSeed(rand_offset));
+}
+
+void PackedKernelArguments::pack(const KernelArgumentHolder& args) {
+  arg_sizes_.clear();
+  arg_types_.clear();
+
+  // Lay out the arguments with each one starting at a chunk boundary
+  std::vector<size_t> chunk_offsets;
+  size_t num_chunks = 0;
+  for (const auto i : c10::irange(args.size())) {
+    chunk_offsets.push_back(num_chunks);
+    arg_sizes_.push_back(args[i]->argSize());
+    arg_types_.push_back(args[i]->type());
+    num_chunks += ceilDiv((int64_t)arg_sizes_.back(), sizeof(Chunk));
+  }
+
+  buffer_ = std::vector<Chunk>(num_chunks);
+  arg_ptrs_ = std::vector<void*>(args.size(), nullptr);
+  for (const auto i : c10::irange(args.size())) {
+    arg_ptrs_[i] = buffer_[chunk_offsets[i]].data;
+    std::memcpy(arg_ptrs_[i], args[i]->arg(), arg_sizes_[i]);
+  }
 }
 
 } // namespace nvfuser
@@ -13,6 +13,7 @@
 #include <torch/csrc/jit/ir/ir.h>
 #include <type.h>
 #include <array>
+#include <cstring>
 #include <optional>
 
 namespace nvfuser {
@@ -126,6 +127,8 @@ struct ArgAbstract {
   virtual bool isType(ArgType type) const = 0;
   virtual ArgType type() const = 0;
   virtual std::unique_ptr<ArgAbstract> copy_unique_ptr() const = 0;
+  //! size in bytes of the kernel parameter pointed to by arg()
+  virtual size_t argSize() const = 0;
   virtual std::string toString() const {
     return "input type: " + argTypeToString(type());
   };
@@ -146,6 +149,9 @@ struct ArgAbstract {
   }                                                               \
   std::unique_ptr<ArgAbstract> copy_unique_ptr() const override { \
     return std::make_unique<TARGET_TYPE##Arg>(*this);             \
+  }                                                               \
+  size_t argSize() const override {                               \
+    return sizeof(ARG_NAME);                                      \
   }
 
 #define DEF_TOSTRING_FUNC                 \
@@ -310,7 +316,8 @@ class TORCH_CUDA_CU_API KernelArgumentHolder {
   KernelArgumentHolder(const KernelArgumentHolder& self)
       : device_index_(self.getDeviceIndex()),
         cache_id_(self.getCacheId()),
-        index_mode_(self.getIndexMode()) {
+        index_mode_(self.getIndexMode()),
+        canonical_sizes_(self.hasCanonicalSizes()) {
     for (const auto& arg : self.arguments_) {
       push(arg.get());
     }
@@ -319,6 +326,7 @@ class TORCH_CUDA_CU_API KernelArgumentHolder {
   KernelArgumentHolder& operator=(const KernelArgumentHolder& self) {
     device_index_ = self.getDeviceIndex();
     index_mode_ = self.getIndexMode();
+    canonical_sizes_ = self.hasCanonicalSizes();
     for (const auto& arg : self.arguments_) {
       push(arg.get());
     }
@@ -345,6 +353,10 @@ class TORCH_CUDA_CU_API KernelArgumentHolder {
 
   void swap(int i, const ArgAbstract* arg);
 
+  //! Drops the reference to the tensor at `ind`, if any. Its meta data is
+  //! kept, but the pointer must not be launched with anymore
+  void releaseTensor(size_t ind);
+
   // push int64
   void push(int64_t val);
 
@@ -382,6 +394,16 @@ class TORCH_CUDA_CU_API KernelArgumentHolder {
     return cache_id_;
   }
 
+  //! Marks the sizes as the canonical sizes of shape buckets, which stand for
+  //! any size of their bucket, see Note [ Shape bucketing ]
+  void setCanonicalSizes(bool canonical_sizes) {
+    canonical_sizes_ = canonical_sizes;
+  }
+
+  bool hasCanonicalSizes() const {
+    return canonical_sizes_;
+  }
+
   std::string toString() const;
 
  private:
@@ -392,6 +414,72 @@ class TORCH_CUDA_CU_API KernelArgumentHolder {
   int device_index_ = 0;
   c10::optional<size_t> cache_id_ = c10::nullopt;
   KernelIndexMode index_mode_ = KernelIndexMode::INT64;
+  bool canonical_sizes_ = false;
+};
+
+//! Returns the philox RNG state of the default CUDA generator for a kernel
+//! consuming `rand_offset` random numbers per thread
+TORCH_CUDA_CU_API at::PhiloxCudaState getPhiloxRNGSeed(uint64_t rand_offset);
+
+//! A flat copy of the kernel parameters of a launch. All arguments, including
+//! the TensorArgCodegen structs of tensors, are laid out once in a single
+//! pre-sized buffer. Subsequent launches with the same argument layout, e.g.
+//! on a hit of the same input id, only patch the values that can change, i.e.
+//! data pointers of tensors and values of scalars. This avoids the heap
+//! allocated, polymorphic ArgAbstract of KernelArgumentHolder on the hot path.
+class TORCH_CUDA_CU_API PackedKernelArguments {
+ public:
+  //! lays out all arguments of `args` and copies their current values
+  void pack(const KernelArgumentHolder& args);
+
+  bool empty() const {
+    return arg_ptrs_.empty();
+  }
+
+  size_t size() const {
+    return arg_ptrs_.size();
+  }
+
+  //! overwrites the data pointer of the tensor argument at `index`
+  void setPointer(size_t index, void* ptr) {
+    TORCH_INTERNAL_ASSERT(arg_types_.at(index) == ArgType::Tensor);
+    std::memcpy(arg_ptrs_[index], &ptr, sizeof(void*));
+  }
+
+  //! overwrites the argument at `index` with `size` bytes from `value`
+  void setValue(size_t index, const void* value, size_t size) {
+    TORCH_INTERNAL_ASSERT(
+        arg_sizes_.at(index) == size,
+        "Packed kernel argument ",
+        index,
+        " has size ",
+        arg_sizes_.at(index),
+        " but got a value of size ",
+        size);
+    std::memcpy(arg_ptrs_[index], value, size);
+  }
+
+  //! overwrites the argument at `index` with the value of `arg`, which must
+  //! have the layout the argument was packed with
+  void setValue(size_t index, const ArgAbstract* arg) {
+    setValue(index, arg->arg(), arg->argSize());
+  }
+
+  //! pointers to each argument, as expected by cuLaunchKernel
+  void** getBuffer() {
+    return arg_ptrs_.data();
+  }
+
+ private:
+  //! 16 byte aligned chunks, the largest alignment of any argument
+  struct alignas(16) Chunk {
+    char data[16];
+  };
+
+  std::vector<Chunk> buffer_;
+  std::vector<void*> arg_ptrs_;
+  std::vector<size_t> arg_sizes_;
+  std::vector<ArgType> arg_types_;
 };
 
 } // namespace nvfuser
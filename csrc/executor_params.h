@@ -15,7 +15,14 @@ namespace nvfuser {
 struct TORCH_CUDA_CU_API CompileParams {
   std::optional<PrimDataType> index_type = std::nullopt;
   int maxrregcount = 255;
+  //! Blocks of the kernel that should be resident on an SM at once, the
+  //! target occupancy the kernel is declared with in its launch bounds, see
+  //! Note [ Launch bounds ]
+  int64_t min_blocks_per_sm = 1;
   bool enable_magic_zero = true;
+  //! Compile with hardware approximations of transcendental functions, see
+  //! Note [ Fast math ]
+  bool fast_math = false;
 
   bool operator==(const CompileParams& other) const {
     // Disallow comparison if the index type is nullopt
@@ -27,7 +34,9 @@ struct TORCH_CUDA_CU_API CompileParams {
         "cannot compare as the other index type is not defined");
     return index_type == other.index_type &&
         maxrregcount == other.maxrregcount &&
-        enable_magic_zero == other.enable_magic_zero;
+        min_blocks_per_sm == other.min_blocks_per_sm &&
+        enable_magic_zero == other.enable_magic_zero &&
+        fast_math == other.fast_math;
   }
 
   bool operator!=(const CompileParams& other) const {
@@ -8,9 +8,13 @@
 #include <ATen/cuda/CUDAContext.h>
 #include <ATen/cuda/CUDAGeneratorImpl.h>
 #include <ATen/native/cuda/jit_utils.h>
+#include <c10/cuda/CUDAGraphsC10Utils.h>
+#include <c10/cuda/CUDAGuard.h>
 
 #include <c10/util/irange.h>
 
+#include <algorithm>
+
 #include <contiguity.h>
 #include <executor_utils.h>
 #include <instrumentation.h>
@@ -26,6 +30,7 @@
 #include <nvfuser_resources/basic_type_traits.h>
 #include <nvfuser_resources/bf16_support.h>
 #include <nvfuser_resources/block_reduction.h>
+#include <nvfuser_resources/block_reduction_outer.h>
 #include <nvfuser_resources/block_sync_atomic.h>
 #include <nvfuser_resources/block_sync_default.h>
 #include <nvfuser_resources/block_welford_outer.h>
@@ -33,6 +38,7 @@
 #include <nvfuser_resources/complex_number.h>
 #include <nvfuser_resources/fp16_support.h>
 #include <nvfuser_resources/fused_reduction.h>
+#include <nvfuser_resources/fused_reduction_impl_outer.h>
 #include <nvfuser_resources/fused_welford_helper.h>
 #include <nvfuser_resources/fused_welford_impl.h>
 #include <nvfuser_resources/fused_welford_impl_outer.h>
@@ -43,6 +49,7 @@
 #include <nvfuser_resources/index_utils.h>
 #include <nvfuser_resources/memory.h>
 #include <nvfuser_resources/random_numbers.h>
+#include <nvfuser_resources/scatter.h>
 #include <nvfuser_resources/tensor.h>
 #include <nvfuser_resources/tensorcore.h>
 #include <nvfuser_resources/tuple.h>
@@ -51,13 +58,48 @@
 #include <nvfuser_resources/welford.h>
 #include <cstdlib>
 #include <fstream>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
 
 #include <nvrtc.h>
 
 namespace nvfuser {
 namespace executor_utils {
 
-std::string kernelPreamble() {
+// Note [ Pruned kernel preamble ]
+//
+// The runtime library is prepended to every generated kernel, and NVRTC
+// spends a noticeable part of each compilation parsing it, most of all the
+// Welford and tensor core helpers that only a small fraction of the kernels
+// use. Those parts of the library are left out when the generated code
+// can't reference them:
+//
+// - The fused Welford implementations only provide out-of-class
+//   definitions of ParallelReduce::welfordGroup* and the block/grid welford
+//   helpers, and every call codegen emits into them has "elford" in its
+//   name. welford.cu and fused_welford_helper.cu are always kept since
+//   fused_reduction.cu declares its members in terms of them.
+// - tensorcore.cu and memory.cu only define the Volta, Turing, Ampere and
+//   Hopper namespaces, which codegen always spells out in full.
+// - The outer-optimized grouped grid reduction only provides
+//   ParallelReduce::reduceGroupOuter, which codegen calls by name.
+//
+// The decision is a plain function of the kernel code, so the code handed
+// to NVRTC, and with it the KernelDb key, is still deterministic. Pruning
+// can be turned off with PYTORCH_NVFUSER_DISABLE=preamble_pruning.
+std::string kernelPreamble(const std::string& kernel_str) {
+  const bool prune = !isOptionDisabled(DisableOption::PreamblePruning);
+  const bool uses_welford =
+      !prune || kernel_str.find("elford") != std::string::npos;
+  const bool uses_outer_reduction =
+      !prune || kernel_str.find("reduceGroupOuter") != std::string::npos;
+  const bool uses_mma = !prune ||
+      kernel_str.find("Volta::") != std::string::npos ||
+      kernel_str.find("Turing::") != std::string::npos ||
+      kernel_str.find("Ampere::") != std::string::npos ||
+      kernel_str.find("Hopper::") != std::string::npos;
+
   std::stringstream ss;
   ss << nvfuser_resources::basic_type_traits_cu;
   ss << nvfuser_resources::complex_number_cu;
@@ -119,16 +161,25 @@ std::string kernelPreamble() {
   ss << nvfuser_resources::welford_cu;
 #ifndef USE_ROCM
   ss << nvfuser_resources::warp_cu;
-  ss << nvfuser_resources::tensorcore_cu;
-  ss << nvfuser_resources::memory_cu;
+  ss << nvfuser_resources::scatter_cu;
+  if (uses_mma) {
+    ss << nvfuser_resources::tensorcore_cu;
+    ss << nvfuser_resources::memory_cu;
+  }
 #else
   ss << nvfuser_resources::warp_rocm_cu;
 #endif
   ss << nvfuser_resources::fused_welford_helper_cu;
   ss << nvfuser_resources::fused_reduction_cu;
-  ss << nvfuser_resources::fused_welford_impl_cu;
-  ss << nvfuser_resources::block_welford_outer_cu;
-  ss << nvfuser_resources::fused_welford_impl_outer_cu;
+  if (uses_welford) {
+    ss << nvfuser_resources::fused_welford_impl_cu;
+    ss << nvfuser_resources::block_welford_outer_cu;
+    ss << nvfuser_resources::fused_welford_impl_outer_cu;
+  }
+  if (uses_outer_reduction) {
+    ss << nvfuser_resources::block_reduction_outer_cu;
+    ss << nvfuser_resources::fused_reduction_impl_outer_cu;
+  }
 
   // Random utilities
   ss << nvfuser_resources::PhiloxCudaStateRaw_cu;
@@ -255,6 +306,12 @@ bool validateKernelArgTensor(
     case at::ScalarType::Int:
       match = param_data_type == DataType::Int32;
       break;
+    case at::ScalarType::Char:
+      match = param_data_type == DataType::Int8;
+      break;
+    case at::ScalarType::Byte:
+      match = param_data_type == DataType::UInt8;
+      break;
     case at::ScalarType::Bool:
       match = param_data_type == DataType::Bool;
       break;
@@ -656,6 +713,14 @@ void validateAlignedVectorizedFusionInputOutput(
   // domain must have stride 1.
   int64_t cur_contig_stride = 1;
   bool still_rightmost = true;
+  // Extent of the innermost contiguous domains. Strided tensors, e.g.,
+  // slices and padded buffers, are vectorized as long as a vector
+  // doesn't cross the padding between their rows, which requires this
+  // extent to be divisible by the word size. The divisibility of the
+  // vectorized split alone isn't enough once the vectorized domain is
+  // merged across the padded stride.
+  int64_t inner_contig_extent = 1;
+  bool still_inner_contig = true;
   for (auto i = aten_tensor.ndimension() - 1; i >= 0; --i) {
     const auto stride = aten_tensor.strides().at(i);
     const auto size = aten_tensor.sizes().at(i);
@@ -687,6 +752,12 @@ void validateAlignedVectorizedFusionInputOutput(
         tv->axis(i)->toString(),
         ", stride: ",
         stride)
+    if (size != 1 && !is_expanded_broadcasting) {
+      still_inner_contig = still_inner_contig && stride == cur_contig_stride;
+      if (still_inner_contig) {
+        inner_contig_extent *= size;
+      }
+    }
     // If the domain is size-1, the next domain is still considered
     // rightmost.
     still_rightmost =
@@ -697,6 +768,16 @@ void validateAlignedVectorizedFusionInputOutput(
       cur_contig_stride = stride * size;
     }
   }
+
+  TORCH_INTERNAL_ASSERT(
+      still_inner_contig || inner_contig_extent % word_size == 0,
+      "Vectorization of ",
+      tv->toString(),
+      " with word size ",
+      word_size,
+      " not possible as the extent of its innermost contiguous domains, ",
+      inner_contig_extent,
+      ", is not divisible by the word size.");
 }
 
 void validateAlignedVectorizedTensors(
@@ -797,7 +878,8 @@ void validateMisalignedVectorizedTensors(
 }
 
 // Check if there's any split that is non-divisible and vectorized. If
-// found, Vectorize is illegal.
+// found, Vectorize is illegal. Also checks the splits a scheduler assumed to
+// be divisible, see Note [ Assumed divisible splits ]
 void validateVectorizedSplits(
     kir::Kernel* kernel,
     ExpressionEvaluator& expr_eval) {
@@ -816,7 +898,7 @@ void validateVectorizedSplits(
         ", is not possible to evaluate.");
     TORCH_INTERNAL_ASSERT(
         input_extent.value() % split_factor.value() == 0,
-        "Non-divisible split with vectorization is detected. ",
+        "Non-divisible split with vectorization, or assumed to be divisible, is detected. ",
         "Extent: ",
         input_extent.value(),
         ". Factor: ",
@@ -1055,6 +1137,298 @@ c10::optional<int> getMaxRegCount(
   }
 }
 
+// Note [ Shared kernel modules ]
+//
+// Identical fusions, e.g. the same layer repeated many times in a model, are
+// compiled by different FusionExecutors that differ only in the name of their
+// kernel, which is numbered by the executor. A process-wide cache of loaded
+// modules keyed by the kernel code with its name taken out, the compile args,
+// the JIT options that change the loaded module and the device makes sure
+// that such kernels are compiled and loaded once. All executors then launch
+// the function of the first one, so profiles show its name for all of them.
+//
+// Modules are loaded per device, but the image a module is loaded from, i.e.
+// its cubin or ptx, only depends on the architecture, which is part of the
+// compile args. In processes that see more than one device, the images are
+// also cached under the key without the device, so the kernels of a fusion
+// that runs on several devices of the same architecture are compiled once and
+// only loaded on each device. Scheduling and lowering still run per device.
+//
+// Note [ Loaded kernel budget ]
+//
+// Long running processes with dynamic shapes accumulate thousands of kernels,
+// whose modules stay loaded on the device. With a max number of loaded
+// kernels set by setMaxLoadedKernels or PYTORCH_NVFUSER_MAX_LOADED_KERNELS,
+// the cache keeps the image a module was loaded from, i.e. its cubin or ptx,
+// in host memory and unloads the least recently used modules beyond the
+// budget. Executors pin the module of their kernel with a KernelModuleGuard
+// while they use it, which reloads the module from its image if it was
+// unloaded. Pinned modules are never unloaded. A captured CUDA graph replays
+// the functions of the modules that were loaded at capture, so the modules
+// pinned during a capture are kept pinned by the KernelModulePins of the
+// graph for as long as it lives. The device is synchronized before a module
+// is unloaded, as launches of it might still be in flight. This happens after
+// the modules to unload are taken out of the cache and the module lock is
+// released, so other threads are not stalled on the lock while the device
+// drains. Nothing is unloaded while the current stream is being captured.
+//
+// The lowered kernel of an executor is still needed to allocate outputs and
+// compute launch parameters, so it is not dropped.
+
+} // namespace
+
+//! Cached module and the ptxas log of its compilation
+struct SharedKernelModule {
+  NvrtcFunction function;
+  std::string ptxas_log;
+
+  // Below are only set for modules that are subject to the budget, see
+  // Note [ Loaded kernel budget ]
+
+  //! cubin or ptx the module is reloaded from
+  std::vector<char> image;
+  //! JIT options to reload a ptx module with
+  std::vector<CUjit_option> options;
+  std::vector<void*> option_vals;
+  std::string lowered_name;
+  c10::DeviceIndex device = 0;
+  bool loaded = false;
+  size_t num_pins = 0;
+  uint64_t last_use = 0;
+};
+
+namespace {
+
+std::mutex shared_kernel_modules_mutex;
+
+//! Pins of the innermost KernelModulePinsGuard of the calling thread
+thread_local KernelModulePins* active_module_pins = nullptr;
+
+std::unordered_map<std::string, std::shared_ptr<SharedKernelModule>>&
+sharedKernelModules() {
+  static std::unordered_map<std::string, std::shared_ptr<SharedKernelModule>>
+      modules;
+  return modules;
+}
+
+//! Image of a compiled kernel that can be loaded on any device of the
+//! architecture it was compiled for, see Note [ Shared kernel modules ]
+struct SharedKernelImage {
+  //! cubin or ptx
+  std::vector<char> image;
+  //! whether the image is ptx that is JIT compiled with the JIT options
+  bool jit = false;
+  std::string lowered_name;
+  std::string ptxas_log;
+};
+
+std::unordered_map<std::string, std::shared_ptr<const SharedKernelImage>>&
+sharedKernelImages() {
+  static std::
+      unordered_map<std::string, std::shared_ptr<const SharedKernelImage>>
+          images;
+  return images;
+}
+
+// Below are guarded by shared_kernel_modules_mutex
+
+size_t& maxLoadedKernels() {
+  static size_t max_loaded_kernels = []() -> size_t {
+    if (auto env_max = getenv("PYTORCH_NVFUSER_MAX_LOADED_KERNELS")) {
+      auto max_loaded = std::atoi(env_max);
+      TORCH_CHECK(
+          max_loaded >= 0,
+          "Invalid max number of loaded kernels specified by PYTORCH_NVFUSER_MAX_LOADED_KERNELS: ",
+          env_max);
+      return max_loaded;
+    }
+    return 0;
+  }();
+  return max_loaded_kernels;
+}
+
+size_t num_loaded_kernels = 0;
+uint64_t kernel_use_counter = 0;
+
+void loadSharedModule(SharedKernelModule& shared_module) {
+  FUSER_COMPILE_STAGE_SCOPE("ModuleLoad");
+  c10::cuda::CUDAGuard dg(shared_module.device);
+  CUDA_SAFE_CALL(cuModuleLoadDataEx(
+      &(shared_module.function.module),
+      shared_module.image.data(),
+      shared_module.options.size(),
+      shared_module.options.data(),
+      shared_module.option_vals.data()));
+  CUDA_SAFE_CALL(cuModuleGetFunction(
+      &(shared_module.function.function),
+      shared_module.function.module,
+      shared_module.lowered_name.c_str()));
+  shared_module.loaded = true;
+  num_loaded_kernels++;
+}
+
+//! Module of an unloaded SharedKernelModule, to be unloaded from its device
+//! by unloadModules once shared_kernel_modules_mutex is released
+struct ColdModule {
+  c10::DeviceIndex device = 0;
+  CUmodule module = CUmodule();
+};
+
+//! Marks the least recently used modules beyond the budget, except for
+//! `keep`, as unloaded and returns them. Requires shared_kernel_modules_mutex
+std::vector<ColdModule> takeColdModules(const SharedKernelModule* keep) {
+  std::vector<ColdModule> cold_modules;
+  const auto max_loaded_kernels = maxLoadedKernels();
+  if (max_loaded_kernels == 0 ||
+      c10::cuda::currentStreamCaptureStatusMayInitCtx() !=
+          c10::cuda::CaptureStatus::None) {
+    return cold_modules;
+  }
+  while (num_loaded_kernels > max_loaded_kernels) {
+    SharedKernelModule* coldest = nullptr;
+    for (auto& entry : sharedKernelModules()) {
+      auto& shared_module = *entry.second;
+      if (shared_module.image.empty() || !shared_module.loaded ||
+          shared_module.num_pins > 0 || &shared_module == keep) {
+        continue;
+      }
+      if (coldest == nullptr || shared_module.last_use < coldest->last_use) {
+        coldest = &shared_module;
+      }
+    }
+    if (coldest == nullptr) {
+      break;
+    }
+    cold_modules.push_back({coldest->device, coldest->function.module});
+    coldest->function = NvrtcFunction();
+    coldest->loaded = false;
+    num_loaded_kernels--;
+  }
+  return cold_modules;
+}
+
+//! Unloads the modules of takeColdModules. Launches of them might still be in
+//! flight, so their devices are synchronized first, which must not stall the
+//! threads waiting for shared_kernel_modules_mutex
+void unloadModules(const std::vector<ColdModule>& cold_modules) {
+  if (cold_modules.empty()) {
+    return;
+  }
+  FUSER_PERF_SCOPE("executor_utils::UnloadSharedModule");
+  for (const auto& cold_module : cold_modules) {
+    c10::cuda::CUDAGuard dg(cold_module.device);
+    CUDA_SAFE_CALL(cuCtxSynchronize());
+    CUDA_SAFE_CALL(cuModuleUnload(cold_module.module));
+  }
+}
+
+//! Returns the function of a cached module, reloading it if needed. Modules
+//! the reload pushes beyond the budget are added to `cold_modules`
+NvrtcFunction useSharedModule(
+    const std::shared_ptr<SharedKernelModule>& shared_module,
+    std::vector<ColdModule>& cold_modules) {
+  NvrtcFunction function = shared_module->function;
+  if (!shared_module->image.empty()) {
+    if (!shared_module->loaded) {
+      loadSharedModule(*shared_module);
+      auto taken = takeColdModules(shared_module.get());
+      cold_modules.insert(cold_modules.end(), taken.begin(), taken.end());
+    }
+    shared_module->last_use = ++kernel_use_counter;
+    function = shared_module->function;
+    function.shared_module = shared_module;
+  }
+  return function;
+}
+
+bool isIdentifierChar(char c) {
+  return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+//! Key of `code` in sharedKernelImages(), the key in sharedKernelModules()
+//! additionally has the device. See Note [ Shared kernel modules ]
+std::string sharedKernelImageKey(
+    const std::string& code,
+    const std::string& func_name,
+    const std::string& compile_args,
+    const std::vector<CUjit_option>& options,
+    const std::vector<void*>& option_vals) {
+  // func_name is the qualified kernel name
+  const auto name_pos = func_name.rfind("::");
+  const std::string kernel_name = name_pos == std::string::npos
+      ? func_name
+      : func_name.substr(name_pos + 2);
+
+  std::stringstream key;
+  key << compile_args;
+  for (const auto i : c10::irange(options.size())) {
+    if (options[i] == CU_JIT_OPTIMIZATION_LEVEL ||
+        options[i] == CU_JIT_MAX_REGISTERS) {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+      key << " " << options[i] << "="
+          << reinterpret_cast<intptr_t>(option_vals[i]);
+    }
+  }
+  key << "\n";
+
+  // Replace the kernel name wherever it appears as a whole identifier
+  size_t copied = 0;
+  for (size_t pos = code.find(kernel_name); pos != std::string::npos;
+       pos = code.find(kernel_name, pos + kernel_name.size())) {
+    const size_t end = pos + kernel_name.size();
+    if ((pos > 0 && isIdentifierChar(code[pos - 1])) ||
+        (end < code.size() && isIdentifierChar(code[end]))) {
+      continue;
+    }
+    key << code.substr(copied, pos - copied) << "__kernel__";
+    copied = end;
+  }
+  key << code.substr(copied);
+  return key.str();
+}
+
+// Note [ Cached SASS of PTX kernels ]
+//
+// When kernels are compiled to PTX, e.g. because the driver is older than
+// NVRTC or with `PYTORCH_NVFUSER_DISABLE=compile_to_sass`, the driver JIT
+// compiles the PTX to SASS every time a module is loaded, i.e. in every new
+// process. With `PYTORCH_NVFUSER_ENABLE=kernel_db,kernel_db_sass`, the PTX is
+// linked to a cubin with the link API of the driver instead, and the cubin is
+// stored in the KernelDb next to the PTX. Its compile args extend those of
+// the PTX with the architecture of the device and the JIT options, so a db
+// shared by devices of different architectures holds one cubin per
+// architecture next to a single PTX per kernel. Once the cubin of the
+// current device is in the db, loading the kernel neither runs NVRTC nor the
+// driver JIT.
+
+//! Links `ptx` to a cubin for the current device
+std::vector<char> linkPtxToCubin(
+    const std::vector<char>& ptx,
+    std::vector<CUjit_option>& options,
+    std::vector<void*>& option_vals) {
+  FUSER_COMPILE_STAGE_SCOPE("PtxLink");
+  CUlinkState link_state = nullptr;
+  CUDA_SAFE_CALL(cuLinkCreate(
+      options.size(), options.data(), option_vals.data(), &link_state));
+  torch::jit::ResourceGuard destroy_link_state(
+      [&] { CUDA_SAFE_CALL(cuLinkDestroy(link_state)); });
+  CUDA_SAFE_CALL(cuLinkAddData(
+      link_state,
+      CU_JIT_INPUT_PTX,
+      const_cast<char*>(ptx.data()),
+      ptx.size(),
+      "kernel.ptx",
+      0,
+      nullptr,
+      nullptr));
+  void* cubin = nullptr;
+  size_t cubin_size = 0;
+  // The cubin is owned by the link state
+  CUDA_SAFE_CALL(cuLinkComplete(link_state, &cubin, &cubin_size));
+  const auto cubin_data = static_cast<const char*>(cubin);
+  return std::vector<char>(cubin_data, cubin_data + cubin_size);
+}
+
 } // namespace
 
 std::tuple<NvrtcFunction, std::string, std::vector<char>> nvrtcCompile(
@@ -1064,7 +1438,10 @@ std::tuple<NvrtcFunction, std::string, std::vector<char>> nvrtcCompile(
     int id,
     c10::optional<int> opt_block_size,
     const int max_register_heuristic,
-    bool return_compiled_binary) {
+    bool return_compiled_binary,
+    c10::optional<int> opt_level,
+    bool fast_math,
+    c10::optional<uint64_t> kernel_code_hash) {
   FUSER_PERF_SCOPE("executor_utils::NVRTC");
   if (isOptionDisabled(DisableOption::ArchCheck)) {
     TORCH_WARN(
@@ -1111,6 +1488,20 @@ std::tuple<NvrtcFunction, std::string, std::vector<char>> nvrtcCompile(
   } else {
     args.push_back("--fmad=true");
   }
+  // Note [ Fast math ]
+  //
+  // Kernels compiled with CompileParams::fast_math use --use_fast_math, which
+  // maps expf, logf, sinf, cosf, powf and friends to their hardware
+  // approximations (__expf, ...), approximates division and square roots,
+  // and flushes denormals to zero. The runtime library additionally replaces
+  // tanhf with tanh.approx on sm_75 and later when
+  // PYTORCH_NVFUSER_FAST_MATH is defined, which covers tanh-based gelu.
+  // sigmoid and silu pick up __expf through --use_fast_math. erff is left as
+  // is, as it is already a short polynomial.
+  if (fast_math) {
+    args.push_back("--use_fast_math");
+    args.push_back("-DPYTORCH_NVFUSER_FAST_MATH");
+  }
   // Add line info to generated kernels
   if (isDebugDumpEnabled(DebugDumpOption::DebugInfo)) {
     args.push_back("-lineinfo");
@@ -1154,7 +1545,25 @@ std::tuple<NvrtcFunction, std::string, std::vector<char>> nvrtcCompile(
     }
   }
 
-  if (ptxas_opt_level) {
+  auto set_opt_level = [&](int val) {
+    if (compile_to_sass) {
+      jit_opt_level += std::to_string(val);
+      args.push_back("--ptxas-options");
+      args.push_back(jit_opt_level.c_str());
+    } else {
+      options.push_back(CU_JIT_OPTIMIZATION_LEVEL);
+      // NOLINTNEXTLINE(performance-no-int-to-ptr)
+      option_vals.push_back((void*)(intptr_t)val);
+    }
+  };
+
+  if (opt_level.has_value()) {
+    TORCH_INTERNAL_ASSERT(
+        opt_level.value() >= 0 && opt_level.value() <= 4,
+        "Invalid ptxas optimization level: ",
+        opt_level.value());
+    set_opt_level(opt_level.value());
+  } else if (ptxas_opt_level) {
     int val = atoi(ptxas_opt_level);
     if (val <= 4 && val >= 0) {
       if (val < 4) {
@@ -1163,15 +1572,7 @@ std::tuple<NvrtcFunction, std::string, std::vector<char>> nvrtcCompile(
             val,
             ", which could negatively affect performance. Try removing env variable PYTORCH_NVFUSER_JIT_OPT_LEVEL for optimal performance.");
       }
-      if (compile_to_sass) {
-        jit_opt_level += std::to_string(val);
-        args.push_back("--ptxas-options");
-        args.push_back(jit_opt_level.c_str());
-      } else {
-        options.push_back(CU_JIT_OPTIMIZATION_LEVEL);
-        // NOLINTNEXTLINE(performance-no-int-to-ptr)
-        option_vals.push_back((void*)(intptr_t)val);
-      }
+      set_opt_level(val);
     } else {
       TORCH_WARN_ONCE(
           "acceptable range for PYTORCH_NVFUSER_JIT_OPT_LEVEL is between 0 and 4, but received ",
@@ -1224,13 +1625,95 @@ std::tuple<NvrtcFunction, std::string, std::vector<char>> nvrtcCompile(
     }
   }
 
+  // Reuse the module of an identical kernel compiled by another executor,
+  // see Note [ Shared kernel modules ]
+  const std::string image_key = sharedKernelImageKey(
+      code, func_name, compile_args, options, option_vals);
+  const std::string module_key =
+      image_key + "device=" + std::to_string(at::cuda::current_device());
+  // Images are only shared by the devices of a process
+  const bool share_image =
+      !return_compiled_binary && at::cuda::device_count() > 1;
+  std::shared_ptr<const SharedKernelImage> shared_image;
+  if (!return_compiled_binary) {
+    std::vector<ColdModule> cold_modules;
+    std::shared_ptr<SharedKernelModule> shared_module;
+    NvrtcFunction function;
+    {
+      std::lock_guard<std::mutex> guard(shared_kernel_modules_mutex);
+      auto it = sharedKernelModules().find(module_key);
+      if (it != sharedKernelModules().end()) {
+        shared_module = it->second;
+        function = useSharedModule(shared_module, cold_modules);
+      } else if (share_image) {
+        auto image_it = sharedKernelImages().find(image_key);
+        if (image_it != sharedKernelImages().end()) {
+          shared_image = image_it->second;
+        }
+      }
+    }
+    if (shared_module != nullptr) {
+      unloadModules(cold_modules);
+      return {function, shared_module->ptxas_log, {}};
+    }
+  }
+
   std::vector<char> binary;
 
   auto& kernel_db = KernelDb::get();
+  // Hash the kernel code at most once for all the lookups and writes below
+  if (kernel_db.enabled() && kernel_code.has_value() &&
+      !kernel_code_hash.has_value()) {
+    kernel_code_hash = fnv1a_hash(kernel_code.value().get());
+  }
+
+  // The kernel was compiled for another device of the same architecture
+  if (shared_image != nullptr) {
+    ptx = shared_image->image;
+    lowered_kernel_name_str = shared_image->lowered_name;
+    ptxas_log << shared_image->ptxas_log;
+    if (!shared_image->jit) {
+      options.clear();
+      option_vals.clear();
+    }
+  }
+
+  // Look for the cubin JIT compiled from the PTX of the kernel, see
+  // Note [ Cached SASS of PTX kernels ]
+  const bool cache_jit_sass = shared_image == nullptr && !compile_to_sass &&
+      kernel_db.enabled() && kernel_code.has_value() &&
+      isOptionEnabled(EnableOption::KernelDbSass);
+  std::string jit_sass_compile_args;
+  bool queried_jit_sass = false;
+  if (cache_jit_sass) {
+    std::stringstream ss;
+    ss << compile_args << " --jit-sass=sm_" << prop->major << prop->minor;
+    for (const auto i : c10::irange(options.size())) {
+      if (options[i] == CU_JIT_OPTIMIZATION_LEVEL ||
+          options[i] == CU_JIT_MAX_REGISTERS) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        ss << " --jit-option" << options[i] << "="
+           << reinterpret_cast<intptr_t>(option_vals[i]);
+      }
+    }
+    jit_sass_compile_args = ss.str();
+    queried_jit_sass = kernel_db.query(
+        kernel_code.value(),
+        kernel_code_hash.value(),
+        jit_sass_compile_args,
+        lowered_kernel_name_str,
+        ptx);
+  }
+
   // If the Kernel Query failes, the Kernel is recompiled
-  if (!(kernel_db.enabled() && kernel_code.has_value() &&
+  if (shared_image == nullptr && !queried_jit_sass &&
+      !(kernel_db.enabled() && kernel_code.has_value() &&
         kernel_db.query(
-            kernel_code.value(), compile_args, lowered_kernel_name_str, ptx))) {
+            kernel_code.value(),
+            kernel_code_hash.value(),
+            compile_args,
+            lowered_kernel_name_str,
+            ptx))) {
     nvrtcProgram program; // NOLINT(cppcoreguidelines-init-variables)
     torch::jit::ResourceGuard holdProgram([&] {
       FUSER_PERF_SCOPE("executor_utils::NvrtcDestroyProgram");
@@ -1252,8 +1735,11 @@ std::tuple<NvrtcFunction, std::string, std::vector<char>> nvrtcCompile(
 
       // NOTE: not using NVRTC_SAFE_CALL on the return here, since we want to
       // display log if the compilation fails here.
-      const auto result =
-          nvrtcCompileProgram(program, (int)args.size(), args.data());
+      nvrtcResult result = NVRTC_SUCCESS;
+      {
+        FUSER_COMPILE_STAGE_SCOPE("NVRTC");
+        result = nvrtcCompileProgram(program, (int)args.size(), args.data());
+      }
       size_t logsize = 0;
       NVRTC_SAFE_CALL(nvrtcGetProgramLogSize(program, &logsize));
       std::vector<char> log(logsize);
@@ -1335,7 +1821,11 @@ std::tuple<NvrtcFunction, std::string, std::vector<char>> nvrtcCompile(
 
     if (kernel_db.enabled() && kernel_code.has_value()) {
       auto result = kernel_db.write(
-          kernel_code.value(), compile_args, lowered_kernel_name_str, ptx);
+          kernel_code.value(),
+          kernel_code_hash.value(),
+          compile_args,
+          lowered_kernel_name_str,
+          ptx);
       if (!result) {
         TORCH_WARN(
             "kernel_db was unable to write kernel: ", lowered_kernel_name_str);
@@ -1356,10 +1846,29 @@ std::tuple<NvrtcFunction, std::string, std::vector<char>> nvrtcCompile(
 #endif
   }
 
+  if (cache_jit_sass && !queried_jit_sass) {
+    ptx = linkPtxToCubin(ptx, options, option_vals);
+    if (!kernel_db.write(
+            kernel_code.value(),
+            kernel_code_hash.value(),
+            jit_sass_compile_args,
+            lowered_kernel_name_str,
+            ptx)) {
+      TORCH_WARN(
+          "kernel_db was unable to write the cubin of kernel: ",
+          lowered_kernel_name_str);
+    }
+  }
+  if (cache_jit_sass) {
+    // The cubin is loaded as is
+    options.clear();
+    option_vals.clear();
+  }
+
   NvrtcFunction compiled_kernel_;
 
   {
-    FUSER_PERF_SCOPE("executor_utils::Nvrtc::LoadPTX");
+    FUSER_COMPILE_STAGE_SCOPE("ModuleLoad");
 
     // load ptx or cubin directly
     CUDA_SAFE_CALL(cuModuleLoadDataEx(
@@ -1369,7 +1878,8 @@ std::tuple<NvrtcFunction, std::string, std::vector<char>> nvrtcCompile(
         options.data(),
         option_vals.data()));
 
-    if (!compile_to_sass &&
+    // The JIT log of a linked cubin was written when linking it
+    if (!compile_to_sass && !queried_jit_sass && shared_image == nullptr &&
         isDebugDumpEnabled(DebugDumpOption::PrintPtxasLog)) {
       std::cout << info_log.data() << std::endl;
     }
@@ -1384,9 +1894,126 @@ std::tuple<NvrtcFunction, std::string, std::vector<char>> nvrtcCompile(
       !isOptionDisabled(DisableOption::ArchCheck),
       "NVFuser Compile: arch check disabled, should not return any compiled kernel");
 
+  std::vector<ColdModule> cold_modules;
+  {
+    // A module loaded concurrently for the same key stays in use by its
+    // executor, the first one inserted is shared
+    std::lock_guard<std::mutex> guard(shared_kernel_modules_mutex);
+    if (share_image && shared_image == nullptr) {
+      auto image = std::make_shared<SharedKernelImage>();
+      image->image = ptx;
+      image->jit = !compile_to_sass && !cache_jit_sass;
+      image->lowered_name = lowered_kernel_name_str;
+      image->ptxas_log = ptxas_log.str();
+      sharedKernelImages().emplace(image_key, std::move(image));
+    }
+    auto shared_module = std::make_shared<SharedKernelModule>();
+    shared_module->function = compiled_kernel_;
+    shared_module->ptxas_log = ptxas_log.str();
+    if (maxLoadedKernels() > 0) {
+      // Keep what is needed to reload the module, see
+      // Note [ Loaded kernel budget ]
+      shared_module->image = ptx;
+      for (const auto i : c10::irange(options.size())) {
+        if (options[i] == CU_JIT_OPTIMIZATION_LEVEL ||
+            options[i] == CU_JIT_MAX_REGISTERS) {
+          shared_module->options.push_back(options[i]);
+          shared_module->option_vals.push_back(option_vals[i]);
+        }
+      }
+      shared_module->lowered_name = lowered_kernel_name_str;
+      shared_module->device = at::cuda::current_device();
+      shared_module->loaded = true;
+    }
+    if (sharedKernelModules().emplace(module_key, shared_module).second &&
+        shared_module->loaded) {
+      num_loaded_kernels++;
+      compiled_kernel_ = useSharedModule(shared_module, cold_modules);
+      auto taken = takeColdModules(shared_module.get());
+      cold_modules.insert(cold_modules.end(), taken.begin(), taken.end());
+    }
+  }
+  unloadModules(cold_modules);
+
   return {compiled_kernel_, ptxas_log.str(), binary};
 }
 
+KernelModuleGuard::~KernelModuleGuard() {
+  release();
+}
+
+void KernelModuleGuard::pin(NvrtcFunction& kernel) {
+  if (kernel.shared_module == pinned_) {
+    // A pinned module stays loaded
+    return;
+  }
+  release();
+  if (kernel.shared_module == nullptr) {
+    return;
+  }
+  std::vector<ColdModule> cold_modules;
+  {
+    std::lock_guard<std::mutex> guard(shared_kernel_modules_mutex);
+    kernel = useSharedModule(kernel.shared_module, cold_modules);
+    pinned_ = kernel.shared_module;
+    pinned_->num_pins++;
+    if (active_module_pins != nullptr) {
+      active_module_pins->add(pinned_);
+    }
+  }
+  unloadModules(cold_modules);
+}
+
+void KernelModuleGuard::release() {
+  if (pinned_ == nullptr) {
+    return;
+  }
+  std::lock_guard<std::mutex> guard(shared_kernel_modules_mutex);
+  pinned_->num_pins--;
+  pinned_ = nullptr;
+}
+
+KernelModulePins::~KernelModulePins() {
+  std::lock_guard<std::mutex> guard(shared_kernel_modules_mutex);
+  for (auto& shared_module : pinned_) {
+    shared_module->num_pins--;
+  }
+}
+
+void KernelModulePins::add(
+    const std::shared_ptr<SharedKernelModule>& shared_module) {
+  if (std::find(pinned_.begin(), pinned_.end(), shared_module) !=
+      pinned_.end()) {
+    return;
+  }
+  shared_module->num_pins++;
+  pinned_.push_back(shared_module);
+}
+
+KernelModulePinsGuard::KernelModulePinsGuard(KernelModulePins* pins)
+    : prev_pins_(active_module_pins) {
+  active_module_pins = pins;
+}
+
+KernelModulePinsGuard::~KernelModulePinsGuard() {
+  active_module_pins = prev_pins_;
+}
+
+void setMaxLoadedKernels(size_t max_loaded_kernels) {
+  std::vector<ColdModule> cold_modules;
+  {
+    std::lock_guard<std::mutex> guard(shared_kernel_modules_mutex);
+    maxLoadedKernels() = max_loaded_kernels;
+    cold_modules = takeColdModules(nullptr);
+  }
+  unloadModules(cold_modules);
+}
+
+size_t numLoadedKernels() {
+  std::lock_guard<std::mutex> guard(shared_kernel_modules_mutex);
+  return num_loaded_kernels;
+}
+
 namespace caching {
 
 //! CompileTimeInfo is the actual subclass of CompileTimeInfoBase that will
@@ -1555,5 +2182,67 @@ std::unique_ptr<caching::WarpPaddedExtentsInfo> getWarpPaddedExtentsInfo(
   return warp_padded_extent_info_ptr;
 }
 
+L2PersistenceWindow::L2PersistenceWindow(
+    const at::Tensor& tensor,
+    std::vector<c10::cuda::CUDAStream> streams)
+    : streams_(std::move(streams)) {
+  const auto device_index = tensor.device().index();
+  const auto prop = at::cuda::getDeviceProperties(device_index);
+  if (prop->persistingL2CacheMaxSize <= 0 ||
+      prop->accessPolicyMaxWindowSize <= 0) {
+    return;
+  }
+  claimSetAside(device_index, (size_t)prop->persistingL2CacheMaxSize);
+
+  const size_t num_bytes = std::min(
+      tensor.numel() * tensor.element_size(),
+      (size_t)prop->accessPolicyMaxWindowSize);
+  cudaStreamAttrValue attr = {};
+  attr.accessPolicyWindow.base_ptr = tensor.data_ptr();
+  attr.accessPolicyWindow.num_bytes = num_bytes;
+  attr.accessPolicyWindow.hitRatio = std::min(
+      1.0f, (float)prop->persistingL2CacheMaxSize / (float)num_bytes);
+  attr.accessPolicyWindow.hitProp = cudaAccessPropertyPersisting;
+  attr.accessPolicyWindow.missProp = cudaAccessPropertyStreaming;
+  setWindow(attr);
+  active_ = true;
+}
+
+L2PersistenceWindow::~L2PersistenceWindow() {
+  if (active_) {
+    cudaStreamAttrValue attr = {};
+    attr.accessPolicyWindow.num_bytes = 0;
+    attr.accessPolicyWindow.hitProp = cudaAccessPropertyNormal;
+    attr.accessPolicyWindow.missProp = cudaAccessPropertyNormal;
+    setWindow(attr);
+  }
+}
+
+bool L2PersistenceWindow::isSetOn(const c10::cuda::CUDAStream& stream) {
+  cudaStreamAttrValue attr = {};
+  CUDA_RT_SAFE_CALL(cudaStreamGetAttribute(
+      stream.stream(), cudaStreamAttributeAccessPolicyWindow, &attr));
+  return attr.accessPolicyWindow.num_bytes > 0;
+}
+
+void L2PersistenceWindow::setWindow(const cudaStreamAttrValue& attr) {
+  for (const auto& stream : streams_) {
+    CUDA_RT_SAFE_CALL(cudaStreamSetAttribute(
+        stream.stream(), cudaStreamAttributeAccessPolicyWindow, &attr));
+  }
+}
+
+void L2PersistenceWindow::claimSetAside(
+    c10::DeviceIndex device_index,
+    size_t size) {
+  static std::mutex mutex;
+  static std::unordered_set<c10::DeviceIndex> claimed_devices;
+  std::lock_guard<std::mutex> guard(mutex);
+  if (claimed_devices.insert(device_index).second) {
+    c10::cuda::CUDAGuard device_guard(device_index);
+    CUDA_RT_SAFE_CALL(cudaDeviceSetLimit(cudaLimitPersistingL2CacheSize, size));
+  }
+}
+
 } // namespace executor_utils
 } // namespace nvfuser
@@ -10,6 +10,7 @@
 #include <ATen/core/ivalue.h>
 
 #include <c10/core/DeviceType.h>
+#include <c10/cuda/CUDAStream.h>
 #include <c10/util/Exception.h>
 
 #include <cuda.h>
@@ -23,6 +24,7 @@
 #include <kernel.h>
 #include <lower2device.h>
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -65,8 +67,10 @@ namespace nvfuser {
 
 namespace executor_utils {
 
-// Include all the functions we might need in generated code
-std::string kernelPreamble();
+//! Include all the functions we might need in generated code. Parts of the
+//! runtime library that kernel_str can't reference are left out, see
+//! Note [ Pruned kernel preamble ]
+TORCH_CUDA_CU_API std::string kernelPreamble(const std::string& kernel_str);
 
 void validateKernelInputs(
     Fusion* fusion,
@@ -88,12 +92,85 @@ std::string disassembleBinary(
     const std::vector<char>& cubin,
     const std::string& nvdisasm_args);
 
+struct SharedKernelModule;
+
 struct NvrtcFunction {
   CUmodule module = CUmodule();
   CUfunction function = CUfunction();
+  //! Set if the module is unloaded when it gets cold, see
+  //! Note [ Loaded kernel budget ]
+  std::shared_ptr<SharedKernelModule> shared_module;
+};
+
+//! Keeps the module of a kernel loaded while it is used, e.g. during a
+//! launch, reloading it if it was unloaded. Pinning a new kernel releases the
+//! previous one. See Note [ Loaded kernel budget ]
+class TORCH_CUDA_CU_API KernelModuleGuard {
+ public:
+  KernelModuleGuard() = default;
+  ~KernelModuleGuard();
+
+  KernelModuleGuard(const KernelModuleGuard&) = delete;
+  KernelModuleGuard& operator=(const KernelModuleGuard&) = delete;
+
+  //! pins the module of `kernel` and updates its module and function
+  void pin(NvrtcFunction& kernel);
+
+ private:
+  void release();
+
+  std::shared_ptr<SharedKernelModule> pinned_;
+};
+
+//! Keeps modules loaded for the lifetime of the pins, e.g. the modules whose
+//! functions a captured CUDA graph replays. Modules are added by the
+//! KernelModuleGuard pins made under a KernelModulePinsGuard. See
+//! Note [ Loaded kernel budget ]
+class TORCH_CUDA_CU_API KernelModulePins {
+ public:
+  KernelModulePins() = default;
+  ~KernelModulePins();
+
+  KernelModulePins(const KernelModulePins&) = delete;
+  KernelModulePins& operator=(const KernelModulePins&) = delete;
+
+ private:
+  friend class KernelModuleGuard;
+
+  //! pins `shared_module` unless it already is, requires the module lock
+  void add(const std::shared_ptr<SharedKernelModule>& shared_module);
+
+  std::vector<std::shared_ptr<SharedKernelModule>> pinned_;
+};
+
+//! Adds the modules the calling thread pins with a KernelModuleGuard to
+//! `pins` for the lifetime of the guard
+class TORCH_CUDA_CU_API KernelModulePinsGuard {
+ public:
+  explicit KernelModulePinsGuard(KernelModulePins* pins);
+  ~KernelModulePinsGuard();
+
+  KernelModulePinsGuard(const KernelModulePinsGuard&) = delete;
+  KernelModulePinsGuard& operator=(const KernelModulePinsGuard&) = delete;
+
+ private:
+  KernelModulePins* prev_pins_ = nullptr;
 };
 
-// Returns executable function and the ptxas log from compilation
+//! Sets the max number of loaded kernel modules, cold ones beyond it are
+//! unloaded. 0 keeps all modules loaded, which is the default unless set by
+//! PYTORCH_NVFUSER_MAX_LOADED_KERNELS. Only applies to kernels compiled
+//! after it is set.
+TORCH_CUDA_CU_API void setMaxLoadedKernels(size_t max_loaded_kernels);
+
+//! Number of loaded kernel modules that are subject to the budget
+TORCH_CUDA_CU_API size_t numLoadedKernels();
+
+// Returns executable function and the ptxas log from compilation. A given
+// `opt_level` overrides the ptxas optimization level set by
+// PYTORCH_NVFUSER_JIT_OPT_LEVEL. `kernel_code_hash` is the fnv1a_hash of
+// `kernel_code` if already known, see Note [ Streaming kernel emission ] in
+// codegen.cpp
 std::tuple<NvrtcFunction, std::string, std::vector<char>> nvrtcCompile(
     c10::optional<std::reference_wrapper<const std::string>> kernel_code,
     const std::string& code,
@@ -101,7 +178,10 @@ std::tuple<NvrtcFunction, std::string, std::vector<char>> nvrtcCompile(
     int id,
     c10::optional<int> opt_block_size = c10::nullopt,
     const int max_register_heuristic = 255,
-    bool return_compiled_binary = false);
+    bool return_compiled_binary = false,
+    c10::optional<int> opt_level = c10::nullopt,
+    bool fast_math = false,
+    c10::optional<uint64_t> kernel_code_hash = c10::nullopt);
 
 namespace caching {
 // TODO: Could consider putting some of
@@ -349,5 +429,33 @@ void validateVectorizedTensors(
     caching::ExecutorCompileTimeInfoCache* data_cache,
     ExpressionEvaluator& expr_eval);
 
+//! Sets an access policy window over a tensor on streams for its lifetime,
+//! see Note [ L2 persistence of re-read inputs ] and
+//! Note [ L2 persistence of broadcast inputs ]
+class L2PersistenceWindow {
+ public:
+  L2PersistenceWindow(
+      const at::Tensor& tensor,
+      std::vector<c10::cuda::CUDAStream> streams);
+
+  ~L2PersistenceWindow();
+
+  L2PersistenceWindow(const L2PersistenceWindow&) = delete;
+  L2PersistenceWindow& operator=(const L2PersistenceWindow&) = delete;
+
+  //! Returns if an access policy window is set on `stream`
+  static bool isSetOn(const c10::cuda::CUDAStream& stream);
+
+ private:
+  void setWindow(const cudaStreamAttrValue& attr);
+
+  //! Sets the L2 set-aside for persisting accesses of a device once
+  static void claimSetAside(c10::DeviceIndex device_index, size_t size);
+
+ private:
+  std::vector<c10::cuda::CUDAStream> streams_;
+  bool active_ = false;
+};
+
 } // namespace executor_utils
 } // namespace nvfuser
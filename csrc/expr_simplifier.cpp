@@ -23,6 +23,8 @@
 #include <regex>
 #include <sstream>
 #include <string>
+#include <tuple>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -55,6 +57,7 @@ class NoOpLogger {
   NoOpLogger(Val*) {}
   virtual ~NoOpLogger() = default;
   virtual void record(const char*, Val*) {}
+  virtual void recordStats(const std::string&, int64_t, int64_t) {}
 };
 
 class Logger : public NoOpLogger {
@@ -109,10 +112,21 @@ class Logger : public NoOpLogger {
     for (auto r : record_) {
       std::cout << r.name << ":\n" << str(r.result) << std::endl;
     }
+    for (const auto& [name, num_applied, num_reused] : stats_) {
+      std::cout << name << ": simplified " << num_applied
+                << " subexpressions, reused " << num_reused << std::endl;
+    }
     std::cout << std::string(std::min<size_t>(header.size(), 80), '=')
               << std::endl;
   }
 
+  void recordStats(
+      const std::string& name,
+      int64_t num_applied,
+      int64_t num_reused) override {
+    stats_.emplace_back(name, num_applied, num_reused);
+  }
+
   void record(const char* name, Val* value) override {
     if (value->sameAs(current_val_)) {
       return;
@@ -124,6 +138,8 @@ class Logger : public NoOpLogger {
 
  private:
   std::vector<Record> record_;
+  // Subexpressions simplified and results reused by each pass
+  std::vector<std::tuple<std::string, int64_t, int64_t>> stats_;
   Val* init_val_;
   Val* current_val_;
 };
@@ -314,40 +330,70 @@ std::unordered_set<Val*> getSubexprDependency(
   return result;
 }
 
+// Results of applying a rule to the subexpressions it already visited. A
+// subexpression shared by several parts of an expression, or left unchanged
+// by the previous rounds of simplifyExpr, is only simplified once by each
+// rule, and stays shared in the result.
+struct RuleMemo {
+  std::unordered_map<Val*, Val*> results;
+  // Statistics for the ExprSimplification dump
+  int64_t num_applied = 0;
+  int64_t num_reused = 0;
+};
+
 // Apply `rule` to `value`, if `rule` returns a new `Val*` to replace `value`,
 // then return that new `Val*`, otherwise recursively goes down to its inputs.
-Val* recurseDown(Val* value, std::function<Val*(Val*)> rule) {
+Val* recurseDown(
+    Val* value,
+    const std::function<Val*(Val*)>& rule,
+    RuleMemo& memo) {
   if (value->isOneOf<TensorView, kir::TensorIndex>()) {
     return value;
   }
-  auto transformed = rule(value);
-  if (transformed != value) {
-    return transformed;
-  }
-  auto def = value->definition();
-  if (def == nullptr) {
-    return value;
+  auto it = memo.results.find(value);
+  if (it != memo.results.end()) {
+    memo.num_reused++;
+    return it->second;
   }
+  memo.num_applied++;
 
-  bool changed = false;
-  std::vector<Val*> new_inputs;
-  new_inputs.reserve(def->inputs().size());
-  for (auto v : def->inputs()) {
-    new_inputs.emplace_back(recurseDown(v, rule));
-    if (new_inputs.back() != v) {
-      changed = true;
+  auto result = [&]() -> Val* {
+    auto transformed = rule(value);
+    if (transformed != value) {
+      return transformed;
+    }
+    auto def = value->definition();
+    if (def == nullptr) {
+      return value;
     }
-  }
 
-  if (!changed) {
-    return value;
-  }
+    bool changed = false;
+    std::vector<Val*> new_inputs;
+    new_inputs.reserve(def->inputs().size());
+    for (auto v : def->inputs()) {
+      new_inputs.emplace_back(recurseDown(v, rule, memo));
+      if (new_inputs.back() != v) {
+        changed = true;
+      }
+    }
 
-  Val* output = IrBuilder::newScalar(*value->getDataType());
-  auto create_fn = def->newObjectFunc();
-  create_fn(
-      def->container(), std::move(new_inputs), {output}, def->attributes());
-  return output;
+    if (!changed) {
+      return value;
+    }
+
+    Val* output = IrBuilder::newScalar(*value->getDataType());
+    auto create_fn = def->newObjectFunc();
+    create_fn(
+        def->container(), std::move(new_inputs), {output}, def->attributes());
+    return output;
+  }();
+  memo.results.emplace(value, result);
+  return result;
+}
+
+Val* recurseDown(Val* value, const std::function<Val*(Val*)>& rule) {
+  RuleMemo memo;
+  return recurseDown(value, rule, memo);
 }
 
 inline RegisterType promoteRegisterType(RegisterType t1, RegisterType t2) {
@@ -872,6 +918,80 @@ Val* unflatten(Val* value, const Context& context) {
       value, [&context](Val* val) { return unflattenRule(val, context); });
 }
 
+// Collect the operands of the chain of binary ops of `type` computing
+// `value`, e.g., [a, b, c, d] for (a + b) + (c + d)
+void collectOperands(
+    Val* value,
+    BinaryOpType type,
+    std::vector<Val*>& result) {
+  auto bop = dynamic_cast<BinaryOp*>(value->definition());
+  if (bop != nullptr && bop->getBinaryOpType() == type &&
+      bop->lhs()->dtype() == value->dtype() &&
+      bop->rhs()->dtype() == value->dtype()) {
+    collectOperands(bop->lhs(), type, result);
+    collectOperands(bop->rhs(), type, result);
+  } else {
+    result.emplace_back(value);
+  }
+}
+
+bool sameAsModuloReordering(Val* a, Val* b) {
+  if (a == b) {
+    return true;
+  }
+  auto def_a = a->definition();
+  auto def_b = b->definition();
+  if (def_a == nullptr || def_b == nullptr || a->vtype() != b->vtype() ||
+      a->dtype() != b->dtype() || typeid(*def_a) != typeid(*def_b) ||
+      def_a->outputs().size() != 1 || def_b->outputs().size() != 1) {
+    return a->sameAs(b);
+  }
+
+  auto bop_a = dynamic_cast<BinaryOp*>(def_a);
+  auto bop_b = dynamic_cast<BinaryOp*>(def_b);
+  // Floating point arithmetic is not associative
+  if (bop_a != nullptr &&
+      bop_a->getBinaryOpType() == bop_b->getBinaryOpType() &&
+      isAssociativeAndCommutative(bop_a->getBinaryOpType()) &&
+      (isIntegralType(a->dtype()) || isBooleanType(a->dtype()))) {
+    std::vector<Val*> operands_a;
+    std::vector<Val*> operands_b;
+    collectOperands(a, bop_a->getBinaryOpType(), operands_a);
+    collectOperands(b, bop_b->getBinaryOpType(), operands_b);
+    if (operands_a.size() != operands_b.size()) {
+      return false;
+    }
+    // Find a 1:1 mapping between the operands
+    std::list<Val*> unmatched(operands_b.begin(), operands_b.end());
+    for (auto operand : operands_a) {
+      auto it = std::find_if(unmatched.begin(), unmatched.end(), [&](Val* v) {
+        return sameAsModuloReordering(operand, v);
+      });
+      if (it == unmatched.end()) {
+        return false;
+      }
+      unmatched.erase(it);
+    }
+    return true;
+  }
+
+  if (def_a->inputs().size() != def_b->inputs().size() ||
+      def_a->attributes().size() != def_b->attributes().size()) {
+    return false;
+  }
+  for (const auto i : c10::irange(def_a->attributes().size())) {
+    if (!def_a->attribute(i)->sameAs(def_b->attribute(i))) {
+      return false;
+    }
+  }
+  for (const auto i : c10::irange(def_a->inputs().size())) {
+    if (!sameAsModuloReordering(def_a->input(i), def_b->input(i))) {
+      return false;
+    }
+  }
+  return true;
+}
+
 } // namespace assoc_comm
 
 namespace {
@@ -1235,7 +1355,9 @@ bool isNonNegative(Val* value, const Context& context) {
 bool isNonNegativeHelper(Val* value, const Context& context) {
   if (auto ns = dynamic_cast<NamedScalar*>(value)) {
     // TODO: make tensor size and tensor stride an expr
-    if (ns->isTensorSize() || ns->isTensorStride()) {
+    if (ns->isTensorSize() || ns->isTensorStride() ||
+        ns->getParallelIndex().has_value() ||
+        ns->getParallelDim().has_value()) {
       return true;
     }
   }
@@ -2262,14 +2384,17 @@ Val* fundamentalDivisionWithRemainderProperty(
 
 } // namespace rules
 
-#define RUN_PASS(pass_name)                                     \
-  if (disabled_passes == nullptr ||                             \
-      (!disabled_passes->empty() &&                             \
-       disabled_passes->count(#pass_name) == 0)) {              \
-    simplified = recurseDown(simplified, [&context](Val* val) { \
-      return rules::pass_name(val, context);                    \
-    });                                                         \
-    logger->record(#pass_name, simplified);                     \
+#define RUN_PASS(pass_name)                                  \
+  if (disabled_passes == nullptr ||                          \
+      (!disabled_passes->empty() &&                          \
+       disabled_passes->count(#pass_name) == 0)) {           \
+    simplified = recurseDown(                                \
+        simplified,                                          \
+        [&context](Val* val) {                               \
+          return rules::pass_name(val, context);             \
+        },                                                   \
+        memos[#pass_name]);                                  \
+    logger->record(#pass_name, simplified);                  \
   }
 
 // Requires that all the passes before the barrier to be converged before
@@ -2297,6 +2422,10 @@ Val* simplifyExpr(
         std::make_unique<std::unordered_set<std::string>>(v.begin(), v.end());
   }
 
+  // The rules only depend on the subexpression they are applied to and the
+  // context, so their results are kept across the rounds
+  std::unordered_map<std::string, RuleMemo> memos;
+
   Val* simplified = value;
   Val* old_simplified = nullptr;
   while (old_simplified != simplified) {
@@ -2331,9 +2460,75 @@ Val* simplifyExpr(
 
   auto unflattened = assoc_comm::unflatten(simplified, context);
   logger->record(debug_print::kUnflattenName, unflattened);
+  for (const auto& [name, memo] : memos) {
+    logger->recordStats(name, memo.num_applied, memo.num_reused);
+  }
   return unflattened;
 }
 
 #undef RUN_PASS
 
+// Note [ Fast integer division ]
+//
+// Integer division and modulo are slow on GPUs, but they are all over the
+// indices of merged domains, e.g., i / T0.size[2] and i % T0.size[2]. A
+// division by a constant is already turned into a multiplication and a shift
+// by nvrtc, which can't do so when the divisor is a tensor size. So when the
+// kernel uses 32-bit indices, strengthReduceDivMod rewrites the divisions of
+// a provably nonnegative numerator by a provably nonnegative divisor that is
+// loop invariant, i.e., doesn't depend on any of the variables, as
+//   n / d = fastDiv(n, d, fastDivMultiplier(d))
+//   n % d = n - fastDiv(n, d, fastDivMultiplier(d)) * d
+// The multiplier only depends on the divisor, so index hoisting computes it
+// once at the top of the kernel, and fastDiv is only a multiply-high, an add
+// and a shift. See runtime/helpers.cu for the algorithm, which requires both
+// the numerator and the divisor to be less than 2^31.
+Val* strengthReduceDivMod(
+    Val* value,
+    const std::list<VarInfo>& variables,
+    std::vector<Bool*> assumptions) {
+  FusionGuard fg(value->fusion());
+  const Context context(variables, assumptions, /*preserve_error=*/false);
+
+  std::function<Val*(Val*)> rule = [&](Val* x) -> Val* {
+    auto bop = dynamic_cast<BinaryOp*>(x->definition());
+    if (bop == nullptr || !isIntegralType(*x->getDataType()) ||
+        (bop->getBinaryOpType() != BinaryOpType::Div &&
+         bop->getBinaryOpType() != BinaryOpType::Mod)) {
+      return x;
+    }
+    auto denominator = bop->rhs();
+    if (denominator->isConstScalar() ||
+        !getSubexprDependency(denominator, context.variableSet()).empty() ||
+        !isValidDenominator(denominator, context) ||
+        !prove::isNonNegative(denominator, context) ||
+        !prove::isNonNegative(bop->lhs(), context)) {
+      return x;
+    }
+    auto numerator = recurseDown(bop->lhs(), rule);
+    auto multiplier = IrBuilder::newScalar(*denominator->getDataType());
+    IrBuilder::create<UnaryOp>(
+        UnaryOpType::FastDivMultiplier, multiplier, denominator);
+    auto quotient = IrBuilder::newScalar(*x->getDataType());
+    IrBuilder::create<TernaryOp>(
+        TernaryOpType::FastDiv, quotient, numerator, denominator, multiplier);
+    if (bop->getBinaryOpType() == BinaryOpType::Div) {
+      return quotient;
+    }
+    return IrBuilder::subExpr(
+        numerator, IrBuilder::mulExpr(quotient, denominator));
+  };
+
+  auto flattened = assoc_comm::flatten(value);
+  auto reduced = recurseDown(flattened, rule);
+  if (reduced == flattened) {
+    return value;
+  }
+  return assoc_comm::unflatten(reduced, context);
+}
+
+bool sameAsModuloReordering(Val* a, Val* b) {
+  return assoc_comm::sameAsModuloReordering(a, b);
+}
+
 } // namespace nvfuser
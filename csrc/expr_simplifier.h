@@ -582,4 +582,20 @@ TORCH_CUDA_CU_API Val* simplifyExpr(
     std::vector<Bool*> assumptions = {},
     bool preserve_error = false);
 
+// Rewrite the loop invariant integer divisions and modulos of `value` with
+// fastDiv, see Note [ Fast integer division ] in expr_simplifier.cpp. Only
+// valid if all the integers `value` is computed from are less than 2^31.
+TORCH_CUDA_CU_API Val* strengthReduceDivMod(
+    Val* value,
+    const std::list<VarInfo>& variables,
+    std::vector<Bool*> assumptions = {});
+
+// Check if `a` and `b` are the same expression up to the order and the
+// parenthesization of the operands of associative and commutative integer and
+// boolean operators, e.g., (a + b) * c and c * (b + a). Expressions simplified
+// with different `variables` may only differ in this way. The expressions are
+// not simplified.
+// See Note: [Reordering associative and commutative operators]
+TORCH_CUDA_CU_API bool sameAsModuloReordering(Val* a, Val* b);
+
 } // namespace nvfuser
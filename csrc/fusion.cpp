@@ -53,8 +53,12 @@ void swap(Fusion& a, Fusion& b) noexcept {
   swap(a.outputs_, b.outputs_);
 
   swap(a.io_alias_, b.io_alias_);
+  swap(a.concat_output_slices_, b.concat_output_slices_);
   swap(a.permuted_input_map_, b.permuted_input_map_);
   swap(a.permuted_output_map_, b.permuted_output_map_);
+
+  swap(a.cached_exprs_, b.cached_exprs_);
+  swap(a.cached_used_math_vals_, b.cached_used_math_vals_);
 }
 
 std::unique_ptr<SegmentedFusion> Fusion::segment(
@@ -88,6 +92,11 @@ IrCloner Fusion::copy(const Fusion* from, Fusion* to) {
     to->io_alias_[copied_output] = copied_input;
   }
 
+  for (const auto& entry : from->concat_output_slices_) {
+    to->concat_output_slices_.emplace_back(
+        ir_cloner.clone(entry.first), entry.second);
+  }
+
   to->permuted_input_map_ = from->permuted_input_map_;
   to->permuted_output_map_ = from->permuted_output_map_;
 
@@ -107,6 +116,108 @@ IrCloner Fusion::copy(const Fusion* from, Fusion* to) {
   return ir_cloner;
 }
 
+// Note [ Segment copies ]
+//
+// SegmentedFusion::makeFusion creates the fusion of every segment to compile
+// or schedule it. Copying the complete fusion and only replacing its inputs
+// and outputs would copy the IR of all the other segments along, making the
+// segmentation of large fusions quadratic in their size.
+//
+// Only the exprs between the inputs and the outputs of the segment are
+// copied instead, together with the nodes they reference: TensorDomains,
+// IterDomains, and the scalars and IterDomain exprs those depend on. The
+// definitions of the TensorViews outside of the segment are not copied, so
+// the inputs of the copy have no definition and the uses of its Vals are
+// restricted to the copied exprs.
+IrCloner Fusion::copy(
+    const Fusion* from,
+    Fusion* to,
+    const std::vector<Val*>& inputs,
+    const std::vector<Val*>& outputs) {
+  FUSER_PERF_SCOPE("Fusion segment copy");
+  to->clear();
+  IrCloner ir_cloner(to);
+
+  const std::unordered_set<Val*> input_set(inputs.begin(), inputs.end());
+  for (auto expr : StmtSort::getExprsBetween(
+           const_cast<Fusion*>(from), inputs, outputs)) {
+    ir_cloner.clone(expr);
+  }
+  ir_cloner.clone(inputs);
+  ir_cloner.clone(outputs);
+
+  for (const auto& entry : from->io_alias_) {
+    if (ir_cloner.isCloned(entry.first) && ir_cloner.isCloned(entry.second)) {
+      to->io_alias_[ir_cloner.clone(entry.first)] =
+          ir_cloner.clone(entry.second);
+    }
+  }
+
+  for (const auto& entry : from->concat_output_slices_) {
+    if (std::all_of(
+            entry.first.begin(), entry.first.end(), [&](Val* slice) {
+              return ir_cloner.isCloned(slice);
+            })) {
+      to->concat_output_slices_.emplace_back(
+          ir_cloner.clone(entry.first), entry.second);
+    }
+  }
+
+  for (const auto& i : from->managed_data_) {
+    to->managed_data_.emplace_back(i.second(ir_cloner, i.first), i.second);
+  }
+  for (auto [k, v] : from->managed_named_data_) {
+    to->managed_named_data_.insert(std::make_pair(
+        k, std::make_pair(v.second(ir_cloner, v.first), v.second)));
+  }
+
+  // Clone the definitions of the other Vals the copied nodes depend on,
+  // until no new node gets cloned
+  size_t num_cloned = 0;
+  while (num_cloned != to->vals_.size() + to->exprs_.size()) {
+    num_cloned = to->vals_.size() + to->exprs_.size();
+    for (auto val : from->vals_) {
+      if (val->definition_ != nullptr && !val->isA<TensorView>() &&
+          input_set.count(val) == 0 && ir_cloner.isCloned(val)) {
+        ir_cloner.clone(val->definition_);
+      }
+    }
+  }
+
+  for (auto val : from->vals_) {
+    if (!ir_cloner.isCloned(val)) {
+      continue;
+    }
+    auto val_clone = ir_cloner.clone(val);
+    val_clone->setDefinition(
+        input_set.count(val) == 0 && ir_cloner.isCloned(val->definition_)
+            ? ir_cloner.clone(val->definition_)
+            : nullptr);
+    std::vector<Expr*> uses;
+    for (auto use : val->uses_) {
+      if (ir_cloner.isCloned(use)) {
+        uses.push_back(ir_cloner.clone(use));
+      }
+    }
+    val_clone->setUses(uses);
+  }
+
+  to->val_type_name_map_ = from->val_type_name_map_;
+  to->expr_name_counter_ = from->expr_name_counter_;
+
+  for (auto inp : inputs) {
+    to->addInput(ir_cloner.clone(inp));
+  }
+  for (auto out : outputs) {
+    to->addOutput(ir_cloner.clone(out));
+  }
+
+  to->permuted_input_map_ = from->permuted_input_map_;
+  to->permuted_output_map_ = from->permuted_output_map_;
+
+  return ir_cloner;
+}
+
 // Clang tidy complains when using default constructor for IrContainer instead
 // of copy constructor. Fusion::copy has a call to IrContainer::copy, so it's
 // redundant to use the IrContainer copy constructor, but it is harmless since
@@ -152,6 +263,7 @@ void Fusion::clear() noexcept {
   outputs_.clear();
 
   io_alias_.clear();
+  concat_output_slices_.clear();
 
   permuted_input_map_.clear();
   permuted_output_map_.clear();
@@ -160,6 +272,8 @@ void Fusion::clear() noexcept {
 
   all_tv_uses_valid_ = false;
   is_during_update_uses_ = false;
+
+  invalidateTvGraph();
 }
 
 void Fusion::removeExpr(Expr* expr) {
@@ -168,6 +282,11 @@ void Fusion::removeExpr(Expr* expr) {
   // that removing something that doesn't exist simply does nothing. For now,
   // we're going with the strictest model which errors.
 
+  if (ir_utils::isTvOp(expr)) {
+    invalidateTvGraph();
+  }
+  invalidateExprOrder();
+
   for (auto out : expr->outputs()) {
     out->setDefinition(nullptr);
   }
@@ -237,6 +356,7 @@ void Fusion::addInput(Val* input) {
   input->setIsFusionInput(true);
 
   all_tv_uses_valid_ = false;
+  invalidateTvGraph();
 }
 
 void Fusion::addOutput(Val* output) {
@@ -261,6 +381,7 @@ void Fusion::addOutput(Val* output) {
   output->setIsFusionOutput(true);
 
   all_tv_uses_valid_ = false;
+  invalidateTvGraph();
 }
 
 void Fusion::removeInput(Val* input) {
@@ -270,6 +391,7 @@ void Fusion::removeInput(Val* input) {
   }
   input->setIsFusionInput(false);
   all_tv_uses_valid_ = false;
+  invalidateTvGraph();
 }
 
 void Fusion::removeOutput(Val* output) {
@@ -279,6 +401,7 @@ void Fusion::removeOutput(Val* output) {
   }
   output->setIsFusionOutput(false);
   all_tv_uses_valid_ = false;
+  invalidateTvGraph();
 }
 
 void Fusion::replaceOutput(Val* output, Val* replacement) {
@@ -300,6 +423,7 @@ void Fusion::replaceOutput(Val* output, Val* replacement) {
       output->setIsFusionOutput(false);
       output->as<TensorView>()->setMemoryType(MemoryType::Local);
     }
+    invalidateTvGraph();
     resetTvUses();
   }
 
@@ -310,10 +434,21 @@ void Fusion::replaceOutput(Val* output, Val* replacement) {
     io_alias_.erase(output);
     io_alias_[replacement] = input;
   }
+
+  for (auto& entry : concat_output_slices_) {
+    std::replace(entry.first.begin(), entry.first.end(), output, replacement);
+  }
 }
 
 std::vector<Expr*> Fusion::exprs() {
-  return StmtSort::getExprs(this);
+  // See Note [ Cached expression order ]
+  if (isA<kir::Kernel>()) {
+    return StmtSort::getExprs(this);
+  }
+  if (!cached_exprs_.has_value()) {
+    cached_exprs_ = StmtSort::getExprs(this);
+  }
+  return *cached_exprs_;
 }
 
 bool Fusion::isNoOp() {
@@ -559,8 +694,10 @@ void Fusion::registerExpr(Expr* expr) {
   // view definitions.
   bool is_ssa = !this->isA<kir::Kernel>();
 
+  bool defines_used_val = false;
   for (Val* output : expr->outputs()) {
     has_tv = has_tv || output->isA<TensorView>();
+    defines_used_val = defines_used_val || !output->uses_.empty();
     assertInContainer(output, "Output to expr is invalid, ");
     if (output->definition() != nullptr && is_ssa) {
       removeExpr(output->definition());
@@ -571,10 +708,24 @@ void Fusion::registerExpr(Expr* expr) {
   }
 
   if (has_tv) {
+    invalidateTvGraph();
     resetTvUses();
+  } else if (defines_used_val) {
+    invalidateExprOrder();
   }
 }
 
+void Fusion::invalidateTvGraph() {
+  ++tv_graph_version_;
+  cached_analyses_.clear();
+  invalidateExprOrder();
+}
+
+void Fusion::invalidateExprOrder() {
+  cached_exprs_.reset();
+  cached_used_math_vals_.reset();
+}
+
 void Fusion::resetTvUses() {
   FUSER_PERF_SCOPE("Fusion::resetTvUses");
   is_during_update_uses_ = true;
@@ -606,6 +757,11 @@ void Fusion::resetTvUses() {
 }
 
 std::vector<Val*> Fusion::usedMathVals() {
+  // See Note [ Cached expression order ]
+  if (!isA<kir::Kernel>() && cached_used_math_vals_.has_value()) {
+    return *cached_used_math_vals_;
+  }
+
   // Note that using fusion->inputs() as the argument for the first
   // parameter of getAllValsBetween does not grab all used vals as
   // there can be vals that are created inside a fusion without using
@@ -619,7 +775,8 @@ std::vector<Val*> Fusion::usedMathVals() {
   // used. However, we want them to be included as they must show up
   // in the fusion.
   std::vector<Val*> vals_to_add;
-  std::unordered_set<Val*> added_vals;
+  std::unordered_set<Val*> added_vals(
+      used_math_vals.begin(), used_math_vals.end());
 
   for (auto val : used_math_vals) {
     auto def = val->definition();
@@ -627,12 +784,8 @@ std::vector<Val*> Fusion::usedMathVals() {
       continue;
     }
     for (auto out : def->outputs()) {
-      if (std::find(used_math_vals.begin(), used_math_vals.end(), out) ==
-          used_math_vals.end()) {
-        if (!added_vals.count(out)) {
-          vals_to_add.push_back(out);
-          added_vals.insert(out);
-        }
+      if (added_vals.insert(out).second) {
+        vals_to_add.push_back(out);
       }
     }
   }
@@ -640,6 +793,9 @@ std::vector<Val*> Fusion::usedMathVals() {
   used_math_vals.insert(
       used_math_vals.end(), vals_to_add.begin(), vals_to_add.end());
 
+  if (!isA<kir::Kernel>()) {
+    cached_used_math_vals_ = used_math_vals;
+  }
   return used_math_vals;
 }
 
@@ -775,6 +931,39 @@ void Fusion::aliasOutputToInput(Val* output, Val* input) {
   addOutput(output);
 }
 
+void Fusion::addConcatOutputSlices(
+    const std::vector<Val*>& slices,
+    int64_t dim) {
+  TORCH_INTERNAL_ASSERT(
+      slices.size() > 1, "Expected at least two slices to concatenate");
+  for (auto slice : slices) {
+    TORCH_INTERNAL_ASSERT(
+        slice->isFusionOutput(),
+        "Concatenated slices must be fusion outputs: ",
+        slice->toString());
+  }
+  concat_output_slices_.emplace_back(slices, dim);
+}
+
+std::vector<std::pair<std::vector<int>, int64_t>> Fusion::
+    getConcatOutputSlices() const {
+  std::vector<std::pair<std::vector<int>, int64_t>> groups;
+  for (const auto& entry : concat_output_slices_) {
+    std::vector<int> indices;
+    for (auto slice : entry.first) {
+      auto it = std::find(outputs_.begin(), outputs_.end(), slice);
+      if (it == outputs_.end()) {
+        break;
+      }
+      indices.push_back((int)std::distance(outputs_.begin(), it));
+    }
+    if (indices.size() == entry.first.size()) {
+      groups.emplace_back(std::move(indices), entry.second);
+    }
+  }
+  return groups;
+}
+
 Val* Fusion::getOutputAlias(Val* output) {
   auto search = io_alias_.find(output);
   if (search != io_alias_.end()) {
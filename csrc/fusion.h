@@ -17,6 +17,7 @@
 #include <iter_visitor.h>
 
 #include <any>
+#include <optional>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -155,7 +156,8 @@ class TORCH_CUDA_CU_API Fusion : public IrContainer {
   bankConflictInfo(const CompileParams& compile_params = CompileParams());
 
   //! Return a list of topologically sorted expressions. This only includes
-  //! exprs required to genereate registered outputs.
+  //! exprs required to genereate registered outputs. See
+  //! Note [ Cached expression order ]
   std::vector<Expr*> exprs();
 
   //! Return a vector of fusion inputs that feed this Val
@@ -167,6 +169,8 @@ class TORCH_CUDA_CU_API Fusion : public IrContainer {
   //! outputs, however, when a multi-output expression exists, and only
   //! some of the outputs are used, the remaining unused outputs are
   //! also included as they must show up in the final code.
+  //!
+  //! See Note [ Cached expression order ]
   std::vector<Val*> usedMathVals();
 
   //! Returns all vals that are produced by used math expressions and
@@ -201,18 +205,29 @@ class TORCH_CUDA_CU_API Fusion : public IrContainer {
 
   std::vector<Val*> getTerminatingOutputs() const;
 
-  // Aliasing output to input value, this is a WAR to allow inplace update on
-  // input tensor.
-  // Note: this is not always safe and should be used with extra caution.
-  // Currently the only place it's used is in the running stats update for batch
-  // normalization.
-  // TODO: alias should be made aware to segmentation, so we'll always include
-  // the input tensor to the section where output is produced.
+  // Aliasing output to input value, this allows inplace update on input
+  // tensor, e.g., for the running stats of batch normalization or parameters
+  // updated by an optimizer step. The aliased output is written to the input
+  // tensor and not returned from the fusion.
+  // Note: this is only safe if the output only depends on the input element
+  // at its own position, which is checked when the fusion is run, see
+  // Note [ In-place outputs ]
   void aliasOutputToInput(Val* output, Val* input);
   Val* getOutputAlias(Val* output);
   std::unordered_set<int> getOutputAliasIndices() const;
   std::vector<std::pair<int, int>> getInputAliasIndices() const;
 
+  //! Marks outputs as the consecutive slices along dim of a single
+  //! concatenated tensor, which executors allocate as views of one buffer,
+  //! see Note [ Cat into output slices ]
+  void addConcatOutputSlices(const std::vector<Val*>& slices, int64_t dim);
+
+  //! Returns the output indices of each group of concatenated slices with
+  //! their concatenated dimension. Groups with a slice that isn't an output
+  //! of this fusion are skipped.
+  std::vector<std::pair<std::vector<int>, int64_t>> getConcatOutputSlices()
+      const;
+
   // mark input at index to be permuted by permutation
   void setPermutationOnInput(int index, std::vector<int64_t> permutation) {
     permuted_input_map_.insert({index, permutation});
@@ -271,8 +286,9 @@ class TORCH_CUDA_CU_API Fusion : public IrContainer {
   //   T& data = fusion.getManaged<T>(name); // lvalue
   // To check existence:
   //   bool has_data = fusion.hasManaged(name);
-  // Note that special names, such as "loop_rotation", are reserved as lowering
-  // options.
+  // Note that special names, such as "loop_rotation",
+  // "optional_loop_rotation" and "assumed_divisible_splits", are reserved as
+  // lowering options.
   //
   // The managed data can be any type. To retrieve managed data, you always need
   // to specify the actual type of the data. For the data whose type already
@@ -346,6 +362,64 @@ class TORCH_CUDA_CU_API Fusion : public IrContainer {
     return managed_named_data_.find(key) != managed_named_data_.end();
   }
 
+  //! Does the fusion carry any managed data, named or unnamed?
+  inline bool hasAnyManaged() const {
+    return !managed_data_.empty() || !managed_named_data_.empty();
+  }
+
+  // Note [ Cached tensor graph analyses ]
+  //
+  // Some analyses, e.g., the root domain mapping used by inlining, only
+  // depend on the tensor graph, i.e., the expressions between tensors and
+  // their root and rfactor domains, but not on the loop transformations of
+  // the tensors. Schedulers repeatedly run them between transformations, so
+  // their results can be cached here. The cache is dropped whenever the
+  // tensor graph changes, i.e., when an expression of tensors is added or
+  // removed, an input or output changes, or the rfactor domain of a tensor
+  // is replaced. Splits, merges and reorders of the leaf domains keep it.
+  // The cache is not copied with the fusion.
+
+  //! Version of the tensor graph, incremented at each change
+  int64_t tvGraphVersion() const {
+    return tv_graph_version_;
+  }
+
+  //! Notify a change of the tensor graph and drop the cached analyses
+  void invalidateTvGraph();
+
+  // Note [ Cached expression order ]
+  //
+  // exprs() and usedMathVals() traverse the whole fusion, and schedulers
+  // and lowering call them, directly or through ir_utils::allTvs, many
+  // times on the same graph. Their results are cached until an
+  // expression that could change them is added or removed: an expression
+  // of tensors, an expression redefining an already used scalar, any
+  // removal, or a change of the inputs and outputs. Expressions creating
+  // new scalars or IterDomains, i.e., the loop transformations, keep the
+  // cache. Kernels are not SSA and lowering edits their definitions, so
+  // their traversals are not cached.
+
+  //! Drop the cached traversals, see Note [ Cached expression order ]
+  void invalidateExprOrder();
+
+  //! Get a cached analysis if it's been computed on the current tensor graph
+  template <typename T>
+  T* getCachedAnalysis(const std::string& key) {
+    auto it = cached_analyses_.find(key);
+    if (it == cached_analyses_.end()) {
+      return nullptr;
+    }
+    return std::any_cast<T>(&it->second);
+  }
+
+  //! Cache an analysis of the current tensor graph
+  template <typename T>
+  T& cacheAnalysis(const std::string& key, T data) {
+    auto& entry = cached_analyses_[key];
+    entry = std::move(data);
+    return *std::any_cast<T>(&entry);
+  }
+
  protected:
   friend SegmentCandidateFinder;
   friend SegmentedFusion;
@@ -354,6 +428,15 @@ class TORCH_CUDA_CU_API Fusion : public IrContainer {
 
   static IrCloner copy(const Fusion* from, Fusion* to);
 
+  //! Copy into `to` only the part of `from` computing `outputs` from
+  //! `inputs`, which become the inputs and outputs of `to`. See
+  //! Note [ Segment copies ]
+  static IrCloner copy(
+      const Fusion* from,
+      Fusion* to,
+      const std::vector<Val*>& inputs,
+      const std::vector<Val*>& outputs);
+
   using IrContainer::registerExpr;
   using IrContainer::registerVal;
 
@@ -386,6 +469,9 @@ class TORCH_CUDA_CU_API Fusion : public IrContainer {
   // io alias pointing from output to input
   std::unordered_map<Val*, Val*> io_alias_;
 
+  // groups of outputs sliced from one concatenated tensor along a dimension
+  std::vector<std::pair<std::vector<Val*>, int64_t>> concat_output_slices_;
+
   // See Note [ Permutation support in nvfuser ]
   // map from indices of input tensor to permutation
   PermutationMap permuted_input_map_;
@@ -400,6 +486,14 @@ class TORCH_CUDA_CU_API Fusion : public IrContainer {
   std::vector<std::pair<std::any, CloneFn>> managed_data_;
   std::unordered_map<std::string, std::pair<std::any, CloneFn>>
       managed_named_data_;
+
+  // See Note [ Cached tensor graph analyses ]
+  int64_t tv_graph_version_ = 0;
+  std::unordered_map<std::string, std::any> cached_analyses_;
+
+  // See Note [ Cached expression order ]
+  std::optional<std::vector<Expr*>> cached_exprs_;
+  std::optional<std::vector<Val*>> cached_used_math_vals_;
 };
 
 } // namespace nvfuser
@@ -0,0 +1,429 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <fusion_interpreter.h>
+
+#include <executor_kernel_arg.h>
+#include <executor_utils.h>
+#include <expr_evaluator.h>
+#include <instrumentation.h>
+#include <ir_all_nodes.h>
+#include <ir_utils.h>
+
+#include <c10/util/irange.h>
+
+#include <unordered_map>
+
+namespace nvfuser {
+
+namespace {
+
+bool canInterpret(UnaryOpType op_type) {
+  switch (op_type) {
+    case UnaryOpType::Abs:
+    case UnaryOpType::Acos:
+    case UnaryOpType::Acosh:
+    case UnaryOpType::Asin:
+    case UnaryOpType::Asinh:
+    case UnaryOpType::Atan:
+    case UnaryOpType::Atanh:
+    case UnaryOpType::Cast:
+    case UnaryOpType::Ceil:
+    case UnaryOpType::Cos:
+    case UnaryOpType::Cosh:
+    case UnaryOpType::Exp:
+    case UnaryOpType::Exp2:
+    case UnaryOpType::Expm1:
+    case UnaryOpType::Erf:
+    case UnaryOpType::Erfc:
+    case UnaryOpType::Erfinv:
+    case UnaryOpType::Floor:
+    case UnaryOpType::Frac:
+    case UnaryOpType::Gelu:
+    case UnaryOpType::Silu:
+    case UnaryOpType::Lgamma:
+    case UnaryOpType::Log:
+    case UnaryOpType::Log10:
+    case UnaryOpType::Log1p:
+    case UnaryOpType::Log2:
+    case UnaryOpType::Neg:
+    case UnaryOpType::Reciprocal:
+    case UnaryOpType::Relu:
+    case UnaryOpType::Rsqrt:
+    case UnaryOpType::Round:
+    case UnaryOpType::Set:
+    case UnaryOpType::Sigmoid:
+    case UnaryOpType::Sin:
+    case UnaryOpType::Sinh:
+    case UnaryOpType::Sqrt:
+    case UnaryOpType::Tan:
+    case UnaryOpType::Tanh:
+    case UnaryOpType::Trunc:
+    case UnaryOpType::Not:
+    case UnaryOpType::IsFinite:
+    case UnaryOpType::IsInf:
+    case UnaryOpType::IsNan:
+    case UnaryOpType::IsNegInf:
+    case UnaryOpType::IsPosInf:
+    case UnaryOpType::IsReal:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool canInterpret(BinaryOpType op_type) {
+  switch (op_type) {
+    case BinaryOpType::CeilDiv:
+      return false;
+    default:
+      return true;
+  }
+}
+
+bool canInterpret(TernaryOpType op_type) {
+  switch (op_type) {
+    case TernaryOpType::Clamp:
+    case TernaryOpType::Lerp:
+    case TernaryOpType::Threshold:
+    case TernaryOpType::Where:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool canInterpret(Expr* expr) {
+  if (auto uop = dynamic_cast<UnaryOp*>(expr)) {
+    return canInterpret(uop->getUnaryOpType());
+  } else if (auto bop = dynamic_cast<BinaryOp*>(expr)) {
+    return canInterpret(bop->getBinaryOpType());
+  } else if (auto top = dynamic_cast<TernaryOp*>(expr)) {
+    return canInterpret(top->getTernaryOpType());
+  } else if (auto rop = dynamic_cast<ReductionOp*>(expr)) {
+    const auto op_type = rop->getReductionOpType();
+    return op_type == BinaryOpType::Add || op_type == BinaryOpType::Max ||
+        op_type == BinaryOpType::Min;
+  }
+  return expr->isOneOf<BroadcastOp, SqueezeOp>();
+}
+
+at::Tensor interpret(UnaryOpType op_type, const at::Tensor& in) {
+  switch (op_type) {
+    case UnaryOpType::Abs:
+      return at::abs(in);
+    case UnaryOpType::Acos:
+      return at::acos(in);
+    case UnaryOpType::Acosh:
+      return at::acosh(in);
+    case UnaryOpType::Asin:
+      return at::asin(in);
+    case UnaryOpType::Asinh:
+      return at::asinh(in);
+    case UnaryOpType::Atan:
+      return at::atan(in);
+    case UnaryOpType::Atanh:
+      return at::atanh(in);
+    case UnaryOpType::Ceil:
+      return at::ceil(in);
+    case UnaryOpType::Cos:
+      return at::cos(in);
+    case UnaryOpType::Cosh:
+      return at::cosh(in);
+    case UnaryOpType::Exp:
+      return at::exp(in);
+    case UnaryOpType::Exp2:
+      return at::exp2(in);
+    case UnaryOpType::Expm1:
+      return at::expm1(in);
+    case UnaryOpType::Erf:
+      return at::erf(in);
+    case UnaryOpType::Erfc:
+      return at::erfc(in);
+    case UnaryOpType::Erfinv:
+      return at::erfinv(in);
+    case UnaryOpType::Floor:
+      return at::floor(in);
+    case UnaryOpType::Frac:
+      return at::frac(in);
+    case UnaryOpType::Gelu:
+      return at::gelu(in);
+    case UnaryOpType::Silu:
+      return at::silu(in);
+    case UnaryOpType::Lgamma:
+      return at::lgamma(in);
+    case UnaryOpType::Log:
+      return at::log(in);
+    case UnaryOpType::Log10:
+      return at::log10(in);
+    case UnaryOpType::Log1p:
+      return at::log1p(in);
+    case UnaryOpType::Log2:
+      return at::log2(in);
+    case UnaryOpType::Neg:
+      return at::neg(in);
+    case UnaryOpType::Reciprocal:
+      return at::reciprocal(in);
+    case UnaryOpType::Relu:
+      return at::relu(in);
+    case UnaryOpType::Rsqrt:
+      return at::rsqrt(in);
+    case UnaryOpType::Round:
+      return at::round(in);
+    case UnaryOpType::Sigmoid:
+      return at::sigmoid(in);
+    case UnaryOpType::Sin:
+      return at::sin(in);
+    case UnaryOpType::Sinh:
+      return at::sinh(in);
+    case UnaryOpType::Sqrt:
+      return at::sqrt(in);
+    case UnaryOpType::Tan:
+      return at::tan(in);
+    case UnaryOpType::Tanh:
+      return at::tanh(in);
+    case UnaryOpType::Trunc:
+      return at::trunc(in);
+    case UnaryOpType::Not:
+      return in.scalar_type() == at::kBool ? at::logical_not(in)
+                                           : at::bitwise_not(in);
+    case UnaryOpType::IsFinite:
+      return at::isfinite(in);
+    case UnaryOpType::IsInf:
+      return at::isinf(in);
+    case UnaryOpType::IsNan:
+      return at::isnan(in);
+    case UnaryOpType::IsNegInf:
+      return at::isneginf(in);
+    case UnaryOpType::IsPosInf:
+      return at::isposinf(in);
+    case UnaryOpType::IsReal:
+      return at::isreal(in);
+    default:
+      // Cast and Set only change the dtype, which the caller takes care of
+      return in;
+  }
+}
+
+at::Tensor interpret(
+    BinaryOpType op_type,
+    const at::Tensor& lhs,
+    const at::Tensor& rhs) {
+  // Integer division and modulo truncate as in CUDA C
+  const bool is_integral = !c10::isFloatingType(lhs.scalar_type()) &&
+      !c10::isFloatingType(rhs.scalar_type());
+  const bool is_bool =
+      lhs.scalar_type() == at::kBool && rhs.scalar_type() == at::kBool;
+  switch (op_type) {
+    case BinaryOpType::Add:
+      return at::add(lhs, rhs);
+    case BinaryOpType::Atan2:
+      return at::atan2(lhs, rhs);
+    case BinaryOpType::Div:
+      return is_integral ? at::div(lhs, rhs, "trunc") : at::div(lhs, rhs);
+    case BinaryOpType::Fmod:
+    case BinaryOpType::Mod:
+      return at::fmod(lhs, rhs);
+    case BinaryOpType::Max:
+      return at::maximum(lhs, rhs);
+    case BinaryOpType::Min:
+      return at::minimum(lhs, rhs);
+    case BinaryOpType::Mul:
+      return at::mul(lhs, rhs);
+    case BinaryOpType::Pow:
+      return at::pow(lhs, rhs);
+    case BinaryOpType::Remainder:
+      return at::remainder(lhs, rhs);
+    case BinaryOpType::Sub:
+      return at::sub(lhs, rhs);
+    case BinaryOpType::Lshift:
+      return at::bitwise_left_shift(lhs, rhs);
+    case BinaryOpType::Rshift:
+      return at::bitwise_right_shift(lhs, rhs);
+    case BinaryOpType::Eq:
+      return at::eq(lhs, rhs);
+    case BinaryOpType::GE:
+      return at::ge(lhs, rhs);
+    case BinaryOpType::GT:
+      return at::gt(lhs, rhs);
+    case BinaryOpType::LE:
+      return at::le(lhs, rhs);
+    case BinaryOpType::LT:
+      return at::lt(lhs, rhs);
+    case BinaryOpType::NE:
+      return at::ne(lhs, rhs);
+    case BinaryOpType::And:
+      return is_bool ? at::logical_and(lhs, rhs) : at::bitwise_and(lhs, rhs);
+    case BinaryOpType::Or:
+      return is_bool ? at::logical_or(lhs, rhs) : at::bitwise_or(lhs, rhs);
+    case BinaryOpType::Xor:
+      return is_bool ? at::logical_xor(lhs, rhs) : at::bitwise_xor(lhs, rhs);
+    default:
+      TORCH_INTERNAL_ASSERT(false, "Unexpected binary op type: ", op_type);
+  }
+}
+
+at::Tensor interpret(
+    TernaryOpType op_type,
+    const at::Tensor& in1,
+    const at::Tensor& in2,
+    const at::Tensor& in3) {
+  switch (op_type) {
+    case TernaryOpType::Clamp:
+      return at::clamp(in1, in2, in3);
+    case TernaryOpType::Lerp:
+      return at::lerp(in1, in2, in3);
+    case TernaryOpType::Threshold:
+      return at::where(at::le(in1, in2), in3, in1);
+    case TernaryOpType::Where:
+      return at::where(in1, in2, in3);
+    default:
+      TORCH_INTERNAL_ASSERT(false, "Unexpected ternary op type: ", op_type);
+  }
+}
+
+at::Tensor interpret(const ReductionOp* rop, const at::Tensor& in) {
+  std::vector<int64_t> axes;
+  const auto& root_domain = rop->out()->as<TensorView>()->getRootDomain();
+  for (const auto i : c10::irange(root_domain.size())) {
+    if (root_domain.at(i)->isReduction()) {
+      axes.push_back((int64_t)i);
+    }
+  }
+  if (axes.empty()) {
+    return in;
+  }
+  switch (rop->getReductionOpType()) {
+    case BinaryOpType::Add:
+      return at::sum(in, axes);
+    case BinaryOpType::Max:
+      return at::amax(in, axes);
+    case BinaryOpType::Min:
+      return at::amin(in, axes);
+    default:
+      TORCH_INTERNAL_ASSERT(false, "Unexpected reduction: ", rop->toString());
+  }
+}
+
+} // namespace
+
+bool canInterpretFusion(Fusion* fusion) {
+  for (auto expr : fusion->exprs()) {
+    if (!ir_utils::isTvOp(expr)) {
+      // Scalars are computed by the expression evaluator
+      continue;
+    }
+    if (!canInterpret(expr)) {
+      return false;
+    }
+    // Complex scalars can't be evaluated
+    for (auto val : expr->inputs()) {
+      if (isComplexType(*val->getDataType())) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+std::vector<at::Tensor> interpretFusion(
+    Fusion* fusion,
+    const at::ArrayRef<c10::IValue>& inputs) {
+  FUSER_PERF_SCOPE("interpretFusion");
+  TORCH_INTERNAL_ASSERT(
+      inputs.size() == fusion->inputs().size(),
+      "Expected ",
+      fusion->inputs().size(),
+      " inputs but received ",
+      inputs.size());
+
+  auto args = KernelArgumentHolder::createKernelArgumentHolder(inputs);
+  auto expr_eval = executor_utils::bindInputs(args, fusion);
+
+  std::unordered_map<Val*, at::Tensor> tensor_map;
+  for (const auto i : c10::irange(inputs.size())) {
+    if (fusion->inputs().at(i)->isA<TensorView>()) {
+      tensor_map.emplace(fusion->inputs().at(i), inputs.at(i).toTensor());
+    }
+  }
+
+  // Scalars are passed as CPU scalar tensors, which ATen accepts along with
+  // tensors on any device
+  auto getTensor = [&](Val* val) -> at::Tensor {
+    if (val->isA<TensorView>()) {
+      return tensor_map.at(val);
+    }
+    auto value = expr_eval.evaluate(val);
+    TORCH_INTERNAL_ASSERT(
+        value.has_value(), "Could not evaluate ", val->toString());
+    const auto options = at::TensorOptions().dtype(
+        data_type_to_aten(val->getDataType().value()));
+    if (value->isDouble()) {
+      return at::scalar_tensor(value->as<double>(), options);
+    } else if (value->isInt()) {
+      return at::scalar_tensor(value->as<int64_t>(), options);
+    }
+    return at::scalar_tensor(value->as<bool>(), options);
+  };
+
+  for (auto expr : fusion->exprs()) {
+    if (!ir_utils::isTvOp(expr)) {
+      continue;
+    }
+    at::Tensor out;
+    if (auto uop = dynamic_cast<UnaryOp*>(expr)) {
+      out = interpret(uop->getUnaryOpType(), getTensor(uop->in()));
+    } else if (auto bop = dynamic_cast<BinaryOp*>(expr)) {
+      out = interpret(
+          bop->getBinaryOpType(), getTensor(bop->lhs()), getTensor(bop->rhs()));
+    } else if (auto top = dynamic_cast<TernaryOp*>(expr)) {
+      out = interpret(
+          top->getTernaryOpType(),
+          getTensor(top->in1()),
+          getTensor(top->in2()),
+          getTensor(top->in3()));
+    } else if (auto rop = dynamic_cast<ReductionOp*>(expr)) {
+      out = interpret(rop, getTensor(rop->in()));
+    } else if (auto bop = dynamic_cast<BroadcastOp*>(expr)) {
+      out = getTensor(bop->in());
+      const auto& flags = bop->getBroadcastDimFlags();
+      for (const auto i : c10::irange(flags.size())) {
+        if (flags.at(i)) {
+          out = out.unsqueeze((int64_t)i);
+        }
+      }
+    } else if (auto sop = dynamic_cast<SqueezeOp*>(expr)) {
+      out = getTensor(sop->in());
+      const auto& flags = sop->getSqueezeDimFlags();
+      for (int64_t i = (int64_t)flags.size() - 1; i >= 0; --i) {
+        if (flags.at(i)) {
+          out = out.squeeze(i);
+        }
+      }
+    } else {
+      TORCH_INTERNAL_ASSERT(false, "Can't interpret ", expr->toString());
+    }
+    auto out_tv = ir_utils::getTvOutput(expr);
+    tensor_map[out_tv] =
+        out.to(data_type_to_aten(out_tv->getDataType().value()));
+  }
+
+  // Outputs don't alias the inputs, as those of a kernel don't
+  std::vector<at::Tensor> outputs;
+  for (auto out : fusion->outputs()) {
+    auto tensor = tensor_map.at(out);
+    if (std::any_of(inputs.begin(), inputs.end(), [&](const auto& input) {
+          return input.isTensor() && tensor.is_alias_of(input.toTensor());
+        })) {
+      tensor = tensor.clone();
+    }
+    outputs.push_back(std::move(tensor));
+  }
+  return outputs;
+}
+
+} // namespace nvfuser
@@ -0,0 +1,31 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <ATen/core/ivalue.h>
+#include <c10/macros/Export.h>
+
+#include <fusion.h>
+
+#include <vector>
+
+namespace nvfuser {
+
+//! Returns true if interpretFusion supports all the expressions of fusion:
+//! pointwise unary, binary and ternary ops, sets, broadcasts, squeezes and
+//! sum, max and min reductions
+TORCH_CUDA_CU_API bool canInterpretFusion(Fusion* fusion);
+
+//! Computes the outputs of fusion for inputs with an ATen op per expression,
+//! without scheduling nor compiling anything. Meant as a fallback while the
+//! kernels of the fusion compile, see Note [ Eager fallback ]
+TORCH_CUDA_CU_API std::vector<at::Tensor> interpretFusion(
+    Fusion* fusion,
+    const at::ArrayRef<c10::IValue>& inputs);
+
+} // namespace nvfuser
@@ -1434,39 +1434,19 @@ std::string toString(SegmentedFusion* segmented_fusion) {
 std::unique_ptr<Fusion> SegmentedFusion::makeFusion(SegmentedGroup* sg) {
   std::unique_ptr<Fusion> fusion_segment = std::make_unique<Fusion>();
 
-  auto complete_to_segment_map =
-      Fusion::copy(completeFusion(), fusion_segment.get());
+  // Only copy the IR of the segment, see Note [ Segment copies ]
+  const auto inputs = getAllInputs(sg);
+  auto complete_to_segment_map = Fusion::copy(
+      completeFusion(), fusion_segment.get(), inputs, getAllOutputs(sg));
 
-  std::vector<Val*> input_list(
-      fusion_segment->inputs().begin(), fusion_segment->inputs().end());
-  for (auto inp : input_list) {
-    fusion_segment->removeInput(inp);
-  }
-
-  std::vector<Val*> output_list(
-      fusion_segment->outputs().begin(), fusion_segment->outputs().end());
-  for (auto out : output_list) {
-    fusion_segment->removeOutput(out);
-  }
-
-  std::vector<TensorView*> view_tvs;
-  for (auto inp : getAllInputs(sg)) {
-    auto clone_tv = complete_to_segment_map.clone(inp);
-    fusion_segment->addInput(clone_tv);
+  for (auto inp : inputs) {
     if (inp->isDefinitionType<ViewOp>()) {
+      auto clone_tv = complete_to_segment_map.clone(inp);
       TORCH_INTERNAL_ASSERT(clone_tv != nullptr && clone_tv->isA<TensorView>());
-      view_tvs.push_back(clone_tv->as<TensorView>());
+      clone_tv->as<TensorView>()->convertRfactorToRootDomain();
     }
   }
 
-  for (auto out : getAllOutputs(sg)) {
-    fusion_segment->addOutput(complete_to_segment_map.clone(out));
-  }
-
-  for (auto tv : view_tvs) {
-    tv->convertRfactorToRootDomain();
-  }
-
   return fusion_segment;
 }
 
@@ -1642,7 +1622,14 @@ SegmentedGroup* SegmentCandidateFinder::mergeNodes() {
           disconnected_edges.begin(), disconnected_edges.end());
     }
 
-    joined_group->setHeuristic(deriveHeuristic(joined_group));
+    // See Note [ Memoized merge probes ]
+    auto probed_it = merge_heuristics_.find(std::minmax(group1, group2));
+    if (probed_it != merge_heuristics_.end() &&
+        probed_it->second.has_value()) {
+      joined_group->setHeuristic(probed_it->second.value());
+    } else {
+      joined_group->setHeuristic(deriveHeuristic(joined_group));
+    }
     // Need to maintain the group dependency data if it has been intialized
     //  by previous merging
     if (group_dependency_) {
@@ -2975,18 +2962,38 @@ bool areDirectlyConnected(SegmentedGroup* group1, SegmentedGroup* group2) {
 
 } // namespace
 
+// Note [ Memoized merge probes ]
+//
+// Probing a merge narrows the complete fusion to the two groups and runs the
+// canSchedule checks of every scheduler on it, which builds ComputeAtMaps
+// and other analyses of the narrowed fusion. The Herrmann merge pass probes
+// the pairs that failed to merge again on every iteration, and the final
+// merge pass restarts from the first group after every merge, so the same
+// pairs get probed many times on large fusions. The result of a probe only
+// depends on the exprs, inputs and outputs of the two groups. The vals of a
+// group's edges don't change when its neighbors are merged, as merged groups
+// are replaced with new ones, so the results are memoized per pair until the
+// initial segments are rebuilt. The heuristic of a successful probe is also
+// reused for the joined group in mergeNodes.
 bool SegmentCandidateFinder::codeGenSupportedMerge(
     SegmentedGroup* group1,
     SegmentedGroup* group2) {
   TORCH_INTERNAL_ASSERT(
       areDirectlyConnected(group1, group2),
       "only support testing immediate producer-consumer groups");
-  auto h = tryMerge(segmented_fusion_.get(), runtime_info_, group1, group2);
-  return h.has_value();
+  auto key = std::minmax(group1, group2);
+  auto it = merge_heuristics_.find(key);
+  if (it == merge_heuristics_.end()) {
+    it = merge_heuristics_
+             .emplace(
+                 key,
+                 tryMerge(
+                     segmented_fusion_.get(), runtime_info_, group1, group2))
+             .first;
+  }
+  return it->second.has_value();
 }
 
-// TODO: consider caching the heuristics value so tryMerge doesn't have to be
-//       called twice
 ScheduleHeuristic SegmentCandidateFinder::deriveHeuristic(
     SegmentedGroup* group) {
   auto h = tryMerge(segmented_fusion_.get(), runtime_info_, group);
@@ -2995,6 +3002,149 @@ ScheduleHeuristic SegmentCandidateFinder::deriveHeuristic(
   return h.value();
 }
 
+// Note [ Segmentation cost model ]
+//
+// Whether two groups can be merged only depends on whether a scheduler
+// accepts the merged group, so the order the merge passes visit candidates
+// in decides which intermediates end up round-tripping through global
+// memory. As segmented kernels are generally bound by memory bandwidth, the
+// cost of a plan is estimated as the bytes each group reads and writes, with
+// broadcast dimensions not counting towards the size of a tensor. Merging
+// two groups avoids writing and then reading back the tensors between them,
+// or just the read for tensors that are fusion outputs anyway.
+//
+// With SegmentCandidateFinderOptions::cost_guided_merge, the Herrmann and
+// final merge passes try the candidates avoiding the most traffic first.
+// Since a greedy order can still paint itself into a corner, the fusion is
+// also segmented with the default order and the plan with less estimated
+// traffic, or fewer groups on a tie, is kept. Run with
+// PYTORCH_NVFUSER_DUMP=segmenter_logging to see the estimates of each phase
+// and plan.
+int64_t SegmentCandidateFinder::estimatedBytes(Val* val) {
+  auto tv = dynamic_cast<TensorView*>(val);
+  if (tv == nullptr) {
+    return 0;
+  }
+  int64_t num_elements = 1;
+  for (auto id : TensorDomain::noReductions(tv->getMaybeRFactorDomain())) {
+    if (id->isBroadcast()) {
+      continue;
+    }
+    auto extent = expressionEvaluator().evaluate(id->extent());
+    if (extent.has_value()) {
+      num_elements *= extent->as<int64_t>();
+    }
+  }
+  return num_elements *
+      (int64_t)dataTypeSize(
+             tv->getDataType().value(),
+             indexModeToDtype(runtime_info_.getIndexMode()));
+}
+
+int64_t SegmentCandidateFinder::estimatedBytesMoved(SegmentedGroup* group) {
+  int64_t bytes = 0;
+  for (auto val : getAllInputs(group)) {
+    bytes += estimatedBytes(val);
+  }
+  for (auto val : getAllOutputs(group)) {
+    bytes += estimatedBytes(val);
+  }
+  return bytes;
+}
+
+int64_t SegmentCandidateFinder::estimatedBytesMoved() {
+  int64_t bytes = 0;
+  for (auto group : groups()) {
+    if (!group->isFusionInputGroup()) {
+      bytes += estimatedBytesMoved(group);
+    }
+  }
+  return bytes;
+}
+
+int64_t SegmentCandidateFinder::estimatedMergeSavings(
+    SegmentedGroup* group1,
+    SegmentedGroup* group2) {
+  std::unordered_set<Val*> edge_vals;
+  for (auto edge : group1->producer_edges) {
+    if (edge->from == group2) {
+      edge_vals.insert(edge->val);
+    }
+  }
+  for (auto edge : group1->consumer_edges) {
+    if (edge->to == group2) {
+      edge_vals.insert(edge->val);
+    }
+  }
+  int64_t savings = 0;
+  for (auto val : edge_vals) {
+    // Fusion outputs are still written by the merged group
+    savings += estimatedBytes(val) * (val->isFusionOutput() ? 1 : 2);
+  }
+  return savings;
+}
+
+void SegmentCandidateFinder::logSegmentationCost(const char* phase) {
+  if (!isDebugDumpEnabled(DebugDumpOption::FusionSegmenterLog)) {
+    return;
+  }
+  auto num_groups = std::count_if(
+      groups().begin(), groups().end(), [](SegmentedGroup* group) {
+        return !group->isFusionInputGroup();
+      });
+  scheduler_debug_utils::canScheduleMessage(
+      "Segmentation after ",
+      phase,
+      ": ",
+      num_groups,
+      " groups, estimated ",
+      estimatedBytesMoved(),
+      " bytes of global memory traffic");
+}
+
+std::unique_ptr<SegmentCandidateFinder> SegmentCandidateFinder::
+    findSegmentation(
+        std::unique_ptr<Fusion> fusion,
+        const KernelArgumentHolder& inputs,
+        SegmentCandidateFinderOptions options) {
+  if (!options.cost_guided_merge ||
+      (!options.run_herrmann_merge && !options.run_final_merge)) {
+    return std::unique_ptr<SegmentCandidateFinder>(
+        new SegmentCandidateFinder(std::move(fusion), inputs, options));
+  }
+
+  // See Note [ Segmentation cost model ]
+  auto default_options = options;
+  default_options.cost_guided_merge = false;
+  std::unique_ptr<SegmentCandidateFinder> default_scf(
+      new SegmentCandidateFinder(
+          std::make_unique<Fusion>(*fusion), inputs, default_options));
+  std::unique_ptr<SegmentCandidateFinder> cost_guided_scf(
+      new SegmentCandidateFinder(std::move(fusion), inputs, options));
+
+  const auto default_bytes = default_scf->estimatedBytesMoved();
+  const auto cost_guided_bytes = cost_guided_scf->estimatedBytesMoved();
+  const auto default_groups = default_scf->groups().size();
+  const auto cost_guided_groups = cost_guided_scf->groups().size();
+  scheduler_debug_utils::canScheduleMessage(
+      "Segmentation plans: default merge order ",
+      default_groups,
+      " groups, ",
+      default_bytes,
+      " bytes; cost guided merge order ",
+      cost_guided_groups,
+      " groups, ",
+      cost_guided_bytes,
+      " bytes");
+
+  if (cost_guided_bytes < default_bytes ||
+      (cost_guided_bytes == default_bytes &&
+       cost_guided_groups <= default_groups)) {
+    return cost_guided_scf;
+  }
+  return default_scf;
+}
+
 SegmentCandidateFinder::SegmentCandidateFinder(
     std::unique_ptr<Fusion> fusion,
     const KernelArgumentHolder& inputs,
@@ -3009,6 +3159,7 @@ SegmentCandidateFinder::SegmentCandidateFinder(
 void SegmentCandidateFinder::buildInitialSegments() {
   groups().clear();
   edges().clear();
+  merge_heuristics_.clear();
 
   // TODO: Make traversal items local to this function.
   // Need this for initialization of the DAG that is process
@@ -3076,6 +3227,10 @@ void SegmentCandidateFinder::buildInitialSegments() {
 void SegmentCandidateFinder::findSegments() {
   FUSER_PERF_SCOPE("Finding valid fusion segment solutions");
 
+  if (options_.reuse_partial_reductions) {
+    reusePartialReductions();
+  }
+
   buildInitialSegments();
 
   segmented_fusion_->validateIfDebug();
@@ -3114,6 +3269,8 @@ void SegmentCandidateFinder::findSegments() {
 
   segmented_fusion_->validateIfDebug();
 
+  logSegmentationCost("initial grouping");
+
   if (options_.run_herrmann_merge) {
     bool merged_nodes = true;
     // Initial merge iteration
@@ -3132,6 +3289,21 @@ void SegmentCandidateFinder::findSegments() {
           continue;
         }
 
+        if (options_.cost_guided_merge) {
+          std::unordered_map<SegmentedGroup*, int64_t> savings;
+          for (auto& candidate : candidates) {
+            savings.emplace(
+                candidate.group,
+                estimatedMergeSavings(group, candidate.group));
+          }
+          std::stable_sort(
+              candidates.begin(),
+              candidates.end(),
+              [&savings](const auto& a, const auto& b) {
+                return savings.at(a.group) > savings.at(b.group);
+              });
+        }
+
         auto candidate_it = candidates.begin();
         while (candidate_it != candidates.end() &&
                !codeGenSupportedMerge(group, candidate_it->group)) {
@@ -3161,6 +3333,7 @@ void SegmentCandidateFinder::findSegments() {
 
       segmented_fusion_->validateIfDebug();
     }
+    logSegmentationCost("herrmann merging");
   }
 
   segmented_fusion_->validateIfDebug();
@@ -3169,6 +3342,7 @@ void SegmentCandidateFinder::findSegments() {
     // TODO: consider interleaving herrmman merge and bruteforce merge, as
     // bruteforce merge can introduce opportunities for more herrmann merge
     finalMerge();
+    logSegmentationCost("final merging");
   }
 
   segmented_fusion_->validateIfDebug();
@@ -3222,6 +3396,13 @@ void SegmentCandidateFinder::forwardInputs() {
     }
   }
 
+  if (options_.recompute_pointwise_inputs) {
+    for (auto tv : findRecomputedPointwiseInputs(forwarded_inputs)) {
+      excluded_inp_unary_exprs_.pushBack(tv->definition());
+      forwarded_inputs.pushBack(tv);
+    }
+  }
+
   auto excluded_fusion_inputs = IterVisitor::getInputsTo(
       {forwarded_inputs.begin(), forwarded_inputs.end()});
 
@@ -3252,6 +3433,129 @@ void SegmentCandidateFinder::forwardInputs() {
   }
 }
 
+// Note [ Recomputing pointwise segment inputs ]
+//
+// forwardInputs recomputes unary op chains of fusion inputs in every segment
+// using them. The same can be done for tensors produced by any cheap
+// pointwise ops and broadcasts, e.g. tv2 = tv0 * mask + bias, as long as it
+// reduces the global memory traffic. When a tensor with k uses is
+// materialized, one segment reads its inputs and writes it, and the segments
+// of the other uses read it back, so its size is moved k times on top of its
+// inputs. When it's recomputed instead, the inputs are read k times. The
+// tensor is recomputed when
+//
+//   (k - 1) * bytes(inputs) < k * bytes(tensor)
+//
+// This is always the case for unary chains, and otherwise holds when some of
+// the inputs are broadcast or narrower than the tensor, like masks and
+// biases. Only tensors with no pointwise uses themselves are considered, and
+// only if every use of the inputs and intermediates they're computed from is
+// also recomputed, since those uses lose their producer edges.
+std::vector<TensorView*> SegmentCandidateFinder::findRecomputedPointwiseInputs(
+    const VectorOfUniqueEntries<Val*>& forwarded_inputs) {
+  auto fusion = completeFusion();
+
+  // Leave the unary chains already being forwarded alone
+  const std::vector<Val*>& forwarded_vals = forwarded_inputs.vector();
+  auto forwarded_exprs = StmtSort::getExprs(fusion, forwarded_vals);
+  std::unordered_set<Expr*> forwarded_expr_set(
+      forwarded_exprs.begin(), forwarded_exprs.end());
+  auto forwarded_fusion_inputs = IterVisitor::getInputsTo(forwarded_vals);
+  std::unordered_set<Val*> aliased_inputs;
+  for (const auto& alias : fusion->ioAlias()) {
+    aliased_inputs.insert(alias.second);
+  }
+
+  // Tensors computed by pointwise ops from fusion inputs only
+  std::unordered_set<Val*> recomputable;
+  for (auto inp : ir_utils::filterByType<TensorView>(fusion->inputs())) {
+    if (std::find(
+            forwarded_fusion_inputs.begin(),
+            forwarded_fusion_inputs.end(),
+            inp) == forwarded_fusion_inputs.end() &&
+        aliased_inputs.count(inp) == 0) {
+      recomputable.insert(inp);
+    }
+  }
+  std::unordered_set<Expr*> recomputable_exprs;
+  std::vector<TensorView*> candidates;
+  for (auto expr : fusion->exprs()) {
+    if (!(expr->isA<UnaryOp>() || expr->isA<BinaryOp>() ||
+          expr->isA<TernaryOp>() || expr->isA<BroadcastOp>()) ||
+        forwarded_expr_set.count(expr) || !expr->output(0)->isA<TensorView>() ||
+        expr->output(0)->isFusionOutput()) {
+      continue;
+    }
+    auto tv_inputs = ir_utils::filterByType<TensorView>(expr->inputs());
+    if (!std::all_of(tv_inputs.begin(), tv_inputs.end(), [&](TensorView* tv) {
+          return recomputable.count(tv);
+        })) {
+      continue;
+    }
+    recomputable.insert(expr->output(0));
+    recomputable_exprs.insert(expr);
+    candidates.push_back(expr->output(0)->as<TensorView>());
+  }
+
+  // Keep the multi-use tensors at the frontier of the recomputable region
+  // that are cheaper to recompute
+  std::vector<TensorView*> recomputed;
+  for (auto tv : candidates) {
+    const auto& uses = tv->uses();
+    if (uses.size() < 2 ||
+        std::any_of(uses.begin(), uses.end(), [&](Expr* use) {
+          return recomputable_exprs.count(use);
+        })) {
+      continue;
+    }
+    int64_t input_bytes = 0;
+    for (auto inp : IterVisitor::getInputsTo({tv})) {
+      input_bytes += estimatedBytes(inp);
+    }
+    const auto num_uses = (int64_t)uses.size();
+    if ((num_uses - 1) * input_bytes < num_uses * estimatedBytes(tv)) {
+      recomputed.push_back(tv);
+    }
+  }
+
+  // Drop the tensors whose inputs or intermediates have uses that aren't
+  // recomputed until none are left
+  bool dropped = true;
+  while (dropped && !recomputed.empty()) {
+    dropped = false;
+    auto closure_exprs = StmtSort::getExprs(
+        fusion, std::vector<Val*>(recomputed.begin(), recomputed.end()));
+    std::unordered_set<Expr*> closure_expr_set(
+        closure_exprs.begin(), closure_exprs.end());
+    auto has_outside_use = [&](Val* val) {
+      return std::any_of(
+          val->uses().begin(), val->uses().end(), [&](Expr* use) {
+            return closure_expr_set.count(use) == 0;
+          });
+    };
+    auto is_not_closed = [&](TensorView* tv) {
+      for (auto expr : StmtSort::getExprs(fusion, std::vector<Val*>{tv})) {
+        auto tv_inputs = ir_utils::filterByType<TensorView>(expr->inputs());
+        if (std::any_of(tv_inputs.begin(), tv_inputs.end(), has_outside_use)) {
+          return true;
+        }
+      }
+      return false;
+    };
+    auto it = std::find_if(recomputed.begin(), recomputed.end(), is_not_closed);
+    if (it != recomputed.end()) {
+      recomputed.erase(it);
+      dropped = true;
+    }
+  }
+
+  for (auto tv : recomputed) {
+    scheduler_debug_utils::canScheduleMessage(
+        "Recomputing ", tv->toString(), " in each segment using it");
+  }
+  return recomputed;
+}
+
 void SegmentCandidateFinder::cleanupForwardedInputs() {
   std::unordered_set<SegmentedGroup*> input_groups;
   for (auto input : forwarded_fusion_inputs_) {
@@ -3293,6 +3597,20 @@ void SegmentCandidateFinder::finalMerge() {
           std::back_inserter(all_consumers_of_producer_group),
           [](auto& it) { return it.first; });
 
+      if (options_.cost_guided_merge) {
+        std::unordered_map<SegmentedGroup*, int64_t> savings;
+        for (auto consumer : all_consumers_of_producer_group) {
+          savings.emplace(
+              consumer, estimatedMergeSavings(producer_group, consumer));
+        }
+        std::stable_sort(
+            all_consumers_of_producer_group.begin(),
+            all_consumers_of_producer_group.end(),
+            [&savings](SegmentedGroup* a, SegmentedGroup* b) {
+              return savings.at(a) > savings.at(b);
+            });
+      }
+
       for (auto consumer : all_consumers_of_producer_group) {
         if (!producer_check->isConsumerOfAny(
                 consumer, all_consumers_of_producer_group) &&
@@ -3700,6 +4018,118 @@ void SegmentedFusion::annotateFP16IntermediateTensors() {
   }
 }
 
+// Note [ Reusing partial reductions ]
+//
+// Reductions of the same tensor over different axes, e.g., the sum of a
+// tensor over its inner dimension and the sum over all of its dimensions,
+// can't be scheduled or combined into one kernel, so each of them ends up
+// in its own segment reading the whole tensor. When the axes of a reduction
+// are a superset of the axes of a sibling reduction with the same reduction
+// op and init value, the wider reduction can instead reduce the output of
+// the narrower one over the remaining axes, which only reads the much
+// smaller partial result. The rewrite changes the order the values are
+// accumulated in, which is why it's opt-in with
+// PYTORCH_NVFUSER_ENABLE=reuse_partial_reductions. Welford ops aren't
+// rewritten, as combining partial Welford results needs the averages, the
+// variances and the counts.
+bool SegmentCandidateFinder::reusePartialReductions() {
+  auto fusion = completeFusion();
+  FusionGuard fg(fusion);
+
+  struct ReductionInfo {
+    ReductionOp* rop;
+    //! Reduced positions of the producer domain
+    std::vector<size_t> axes;
+    //! Tensor the reduction currently produces
+    TensorView* out;
+  };
+
+  std::unordered_map<Val*, std::vector<ReductionInfo>> reductions_of;
+  for (auto rop : ir_utils::filterByType<ReductionOp>(fusion->exprs())) {
+    auto out_tv = rop->out()->as<TensorView>();
+    if (!rop->in()->isA<TensorView>() || rop->isAllreduce()) {
+      continue;
+    }
+    std::vector<size_t> axes;
+    const auto& root = out_tv->getRootDomain();
+    for (const auto i : c10::irange(root.size())) {
+      if (root[i]->isReduction()) {
+        axes.push_back(i);
+      }
+    }
+    reductions_of[rop->in()].push_back({rop, axes, out_tv});
+  }
+
+  bool modified = false;
+  for (auto& entry : reductions_of) {
+    auto& reductions = entry.second;
+    if (reductions.size() < 2) {
+      continue;
+    }
+    // Narrower reductions are rewritten first, so that chains of them
+    // reduce each other's outputs
+    std::stable_sort(
+        reductions.begin(), reductions.end(), [](const auto& a, const auto& b) {
+          return a.axes.size() < b.axes.size();
+        });
+    for (const auto wide_i : c10::irange(reductions.size())) {
+      auto& wide = reductions[wide_i];
+      // Pick the widest sibling reducing a strict subset of the axes
+      c10::optional<size_t> narrow_i;
+      for (const auto i : c10::irange(wide_i)) {
+        const auto& narrow = reductions[i];
+        if (narrow.axes.size() < wide.axes.size() &&
+            narrow.rop->getReductionOpType() ==
+                wide.rop->getReductionOpType() &&
+            narrow.rop->init()->sameAs(wide.rop->init()) &&
+            narrow.out->getDataType() == wide.out->getDataType() &&
+            std::includes(
+                wide.axes.begin(),
+                wide.axes.end(),
+                narrow.axes.begin(),
+                narrow.axes.end())) {
+          narrow_i = i;
+        }
+      }
+      if (!narrow_i.has_value()) {
+        continue;
+      }
+      const auto& narrow = reductions[narrow_i.value()];
+
+      // Positions in the output of the narrow reduction of the axes left
+      // to reduce
+      std::vector<int> remaining_axes;
+      int narrow_out_pos = 0;
+      const auto num_dims = narrow.out->getRootDomain().size();
+      for (const auto i : c10::irange(num_dims)) {
+        if (std::binary_search(narrow.axes.begin(), narrow.axes.end(), i)) {
+          continue;
+        }
+        if (std::binary_search(wide.axes.begin(), wide.axes.end(), i)) {
+          remaining_axes.push_back(narrow_out_pos);
+        }
+        narrow_out_pos++;
+      }
+
+      auto new_out = reductionOp(
+          wide.rop->getReductionOpType(),
+          remaining_axes,
+          wide.rop->init(),
+          narrow.out);
+      auto old_out = wide.out;
+      for (auto use : std::vector<Expr*>(old_out->uses())) {
+        ir_utils::replaceValInExpr(use, old_out, new_out);
+      }
+      if (old_out->isFusionOutput()) {
+        fusion->replaceOutput(old_out, new_out);
+      }
+      wide.out = new_out;
+      modified = true;
+    }
+  }
+  return modified;
+}
+
 std::string toString(const SegmentCandidateFinderOptions& segment_options) {
   std::stringstream ss;
   ss << "segmentation phases {\n";
@@ -3712,6 +4142,12 @@ std::string toString(const SegmentCandidateFinderOptions& segment_options) {
   if (segment_options.run_final_merge) {
     ss << "final merging\n";
   }
+  if (segment_options.cost_guided_merge) {
+    ss << "cost guided merging\n";
+  }
+  if (segment_options.reuse_partial_reductions) {
+    ss << "reuse partial reductions\n";
+  }
   ss << "\n}\n";
   return ss.str();
 }
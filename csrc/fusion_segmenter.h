@@ -16,6 +16,7 @@
 
 #include <deque>
 #include <list>
+#include <map>
 #include <unordered_set>
 #include <vector>
 
@@ -483,6 +484,19 @@ struct TORCH_CUDA_CU_API SegmentCandidateFinderOptions {
   bool run_combine_reductions = true;
   bool run_herrmann_merge = true;
   bool run_final_merge = true;
+  //! Merge the groups saving the most estimated global memory traffic first
+  //!  and keep the cheaper of this plan and the default one, see
+  //!  Note [ Segmentation cost model ]
+  bool cost_guided_merge = isOptionEnabled(EnableOption::SegmenterCostModel);
+  //! Recompute cheap pointwise producers from fusion inputs in each consumer
+  //!  segment when that's estimated to move less data than materializing
+  //!  them, see Note [ Recomputing pointwise segment inputs ]
+  bool recompute_pointwise_inputs =
+      isOptionEnabled(EnableOption::RecomputeSegmentInputs);
+  //! Compute reductions of a tensor from sibling reductions of it over a
+  //!  subset of their axes, see Note [ Reusing partial reductions ]
+  bool reuse_partial_reductions =
+      isOptionEnabled(EnableOption::ReusePartialReductions);
 };
 
 //!  SegmentCandidateFinder
@@ -521,8 +535,8 @@ class TORCH_CUDA_CU_API SegmentCandidateFinder {
                 << std::endl;
       fusion_copy->printMath();
     }
-    SegmentCandidateFinder scf(std::move(fusion_copy), inputs, options);
-    return std::move(scf.segmented_fusion_);
+    auto scf = findSegmentation(std::move(fusion_copy), inputs, options);
+    return std::move(scf->segmented_fusion_);
   }
 
   // Perform segmentation on and take ownership of the given fusion
@@ -530,13 +544,13 @@ class TORCH_CUDA_CU_API SegmentCandidateFinder {
       std::unique_ptr<Fusion> fusion,
       const KernelArgumentHolder& inputs,
       SegmentCandidateFinderOptions options = SegmentCandidateFinderOptions()) {
-    SegmentCandidateFinder scf(std::move(fusion), inputs, options);
+    auto scf = findSegmentation(std::move(fusion), inputs, options);
     if (isDebugDumpEnabled(DebugDumpOption::FusionSegments)) {
       std::cout << "Segment the fusion (Original Fusion Un-modified): "
                 << std::endl;
-      scf.completeFusion()->printMath();
+      scf->completeFusion()->printMath();
     }
-    return std::move(scf.segmented_fusion_);
+    return std::move(scf->segmented_fusion_);
   }
 
   static bool translateWelfordInFusion(
@@ -550,6 +564,14 @@ class TORCH_CUDA_CU_API SegmentCandidateFinder {
       const KernelArgumentHolder& inputs,
       SegmentCandidateFinderOptions options);
 
+  //! Segment fusion with the given options. With cost guided merging, a copy
+  //!  of fusion is also segmented with the default merge order and the plan
+  //!  with less estimated global memory traffic is kept.
+  static std::unique_ptr<SegmentCandidateFinder> findSegmentation(
+      std::unique_ptr<Fusion> fusion,
+      const KernelArgumentHolder& inputs,
+      SegmentCandidateFinderOptions options);
+
   void resetTraversal();
 
   void resetLevels();
@@ -641,6 +663,23 @@ class TORCH_CUDA_CU_API SegmentCandidateFinder {
   //!  group built by merging the two groups connected by edge
   ScheduleHeuristic deriveHeuristic(SegmentedGroup* edge);
 
+  //! Estimated bytes of val read from or written to global memory, see
+  //!  Note [ Segmentation cost model ]
+  int64_t estimatedBytes(Val* val);
+
+  //! Estimated bytes of global memory read and written by group
+  int64_t estimatedBytesMoved(SegmentedGroup* group);
+
+  //! Estimated bytes of global memory read and written by all groups
+  int64_t estimatedBytesMoved();
+
+  //! Estimated bytes of global memory traffic that merging the directly
+  //!  connected group1 and group2 avoids
+  int64_t estimatedMergeSavings(SegmentedGroup* group1, SegmentedGroup* group2);
+
+  //! Log the number of groups and their estimated traffic after phase
+  void logSegmentationCost(const char* phase);
+
   GroupDependencyAnalysis* getGroupDependency();
 
   //! Find all expresions that are simply unary ops from
@@ -656,8 +695,19 @@ class TORCH_CUDA_CU_API SegmentCandidateFinder {
   //! forwarded inputs.
   void forwardInputs();
 
+  //! Find the tensors produced only by pointwise ops from fusion inputs that
+  //!  are cheaper to recompute in each consumer segment than to write and
+  //!  read back. Expressions producing forwarded_inputs are left alone.
+  std::vector<TensorView*> findRecomputedPointwiseInputs(
+      const VectorOfUniqueEntries<Val*>& forwarded_inputs);
+
   void cleanupForwardedInputs();
 
+  //! Rewrites reductions of a tensor to reduce the output of a sibling
+  //!  reduction over a subset of their axes instead. Returns true if the
+  //!  complete fusion was modified, see Note [ Reusing partial reductions ]
+  bool reusePartialReductions();
+
   //! Query if a val is a fusion input or a forwarded input
   bool isFusionInput(Val* val) const {
     return std::find(
@@ -699,6 +749,13 @@ class TORCH_CUDA_CU_API SegmentCandidateFinder {
 
   SchedulerRuntimeInfo runtime_info_;
 
+  //! Heuristics proposed for merging a pair of groups, nullopt if they can't
+  //!  be merged, see Note [ Memoized merge probes ]
+  std::map<
+      std::pair<SegmentedGroup*, SegmentedGroup*>,
+      c10::optional<ScheduleHeuristic>>
+      merge_heuristics_;
+
   //! Note:
   //!  Segmenter should eventually rely only on runtime_info_ for
   //!  safe caching. runtime_inputs_ is only used in translateWelford
@@ -32,6 +32,7 @@
 #include <torch/csrc/jit/ir/alias_analysis.h>
 #include <torch/csrc/jit/passes/tensorexpr_fuser.h>
 
+#include <iostream>
 #include <queue>
 #include <unordered_map>
 
@@ -1452,6 +1453,50 @@ void removeFusionWithMissingProfilingInformation(torch::jit::Block* block) {
   }
 }
 
+// Returns the number of ATen ops computed by the fusion group guarded by the
+// CudaFusionGuard `n`, i.e., the number of kernel launches it saves plus one
+int64_t numGuardedAtenOps(torch::jit::Node* n) {
+  torch::jit::Node* if_node = n->output()->uses().at(0).user;
+  if (if_node->kind() == at::prim::ListConstruct) {
+    if_node = if_node->output()->uses().at(0).user->output()->uses().at(0).user;
+  }
+  int64_t num_ops = 0;
+  for (auto fusion_node : if_node->blocks()[0]->nodes()) {
+    if (fusion_node->kind() != at::prim::CudaFusionGroup) {
+      continue;
+    }
+    for (auto node : fusion_node->g(at::attr::Subgraph)->nodes()) {
+      if (!node->kind().is_prim()) {
+        num_ops++;
+      }
+    }
+  }
+  return num_ops;
+}
+
+// A fusion group of a single op doesn't save any launch over eager mode, but
+// still pays for its guard and for the launch overhead of nvfuser, which is
+// larger than the one of ATen. So groups of less than `min_ops` ops are
+// reverted to their fallback graph.
+void removeSmallFusions(torch::jit::Block* block, int64_t min_ops) {
+  FUSER_PERF_SCOPE("removeSmallFusions");
+  std::vector<torch::jit::Node*> removeCudaFusionNodes;
+
+  for (auto node : block->nodes()) {
+    if (node->kind() == at::prim::CudaFusionGuard &&
+        numGuardedAtenOps(node) < min_ops) {
+      removeCudaFusionNodes.push_back(node);
+    }
+    for (auto sub_block : node->blocks()) {
+      removeSmallFusions(sub_block, min_ops);
+    }
+  }
+
+  for (auto node : removeCudaFusionNodes) {
+    removeCudaFusionPathForGuardNode(node);
+  }
+}
+
 void compileFusionRecursive(torch::jit::Block* block) {
   FUSER_PERF_SCOPE("compileFusionRecursive");
 
@@ -2561,6 +2606,22 @@ void CudaFuseGraph(std::shared_ptr<torch::jit::Graph>& graph) {
   removeFusionWithMissingProfilingInformation(graph->block());
   GRAPH_DEBUG("After remove missing profiling: ", *graph);
 
+  if (isOptionEnabled(EnableOption::PruneSmallFusions)) {
+    int64_t min_ops = 2;
+    const auto& option_args =
+        getEnableOptionArguments(EnableOption::PruneSmallFusions);
+    if (!option_args.empty()) {
+      try {
+        min_ops = std::stoi(option_args[0]);
+      } catch (const std::exception& e) {
+        std::cout << "skip invalid argument for PruneSmallFusions, arg = "
+                  << option_args[0] << std::endl;
+      }
+    }
+    removeSmallFusions(graph->block(), min_ops);
+    GRAPH_DEBUG("After remove small fusions: ", *graph);
+  }
+
   // optimization targeting AMP
   removeOutputUsedOnlyInDtype(graph->block());
   GRAPH_DEBUG("After removeOutputUsedOnlyInDtype: ", *graph);
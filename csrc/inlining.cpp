@@ -27,9 +27,20 @@ void MaxPosCalculator::buildUnmappableDims(bool compute_at_only) {
   if (compute_at_only) {
     return;
   }
+  // The unmappable dims only depend on the root and rfactor domains, so they
+  // are reused until the tensor graph changes. See Note [ Cached tensor graph
+  // analyses ]
+  auto fusion = FusionGuard::getCurFusion();
+  const std::string cache_key = "MaxPosCalculator::unmappable_dims";
+  if (auto cached = fusion->getCachedAnalysis<std::unordered_set<IterDomain*>>(
+          cache_key)) {
+    unmappable_dims_ = *cached;
+    return;
+  }
+
   ComputeAtRootDomainMap root_map;
   root_map.build();
-  auto all_tvs = ir_utils::allTvs(FusionGuard::getCurFusion());
+  auto all_tvs = ir_utils::allTvs(fusion);
   for (auto tv : all_tvs) {
     auto consumers = ir_utils::consumerTvsOf(tv);
     for (auto consumer : consumers) {
@@ -46,6 +57,7 @@ void MaxPosCalculator::buildUnmappableDims(bool compute_at_only) {
       }
     }
   }
+  fusion->cacheAnalysis(cache_key, unmappable_dims_);
 }
 
 bool MaxPosCalculator::isAllowedID(
@@ -8,6 +8,10 @@
 #include <instrumentation.h>
 
 #include <c10/macros/Export.h>
+#include <c10/util/irange.h>
+
+#include <algorithm>
+#include <sstream>
 
 #ifdef _WIN32
 #include <c10/util/win32-headers.h>
@@ -52,8 +56,12 @@ Trace::~Trace() {
   }
 }
 
-void Trace::logEvent(char ph, const char* name, char sep) {
-  const std::chrono::duration<double> d = Clock::now() - start_timestamp_;
+void Trace::logEvent(
+    char ph,
+    const char* name,
+    char sep,
+    Clock::time_point timestamp) {
+  const std::chrono::duration<double> d = timestamp - start_timestamp_;
   const double elapsed = d.count() * 1e6;
 
 #ifdef _WIN32
@@ -75,5 +83,455 @@ void Trace::logEvent(char ph, const char* name, char sep) {
       sep);
 }
 
+void Trace::deviceEvent(
+    const std::string& name,
+    int device,
+    int sm,
+    Clock::time_point begin,
+    Clock::time_point end) {
+  if (log_file_ == nullptr) {
+    return;
+  }
+
+  // Pseudo process ids of the devices, away from the ids of real processes
+  constexpr int kDevicePidBase = 1 << 24;
+  const int pid = kDevicePidBase + device;
+  {
+    std::lock_guard<std::mutex> guard(named_devices_mutex_);
+    if (named_devices_.insert(device).second) {
+      fprintf(
+          log_file_,
+          "{ \"name\": \"process_name\", \"ph\": \"M\", \"pid\": %d, \"args\": { \"name\": \"GPU %d\" } },\n",
+          pid,
+          device);
+    }
+  }
+
+  const std::chrono::duration<double> ts = begin - start_timestamp_;
+  const std::chrono::duration<double> dur = end - begin;
+  fprintf(
+      log_file_,
+      "{ \"name\": \"%s\", \"ph\": \"X\", \"pid\": %d, \"tid\": %d, \"ts\": %.3f, \"dur\": %.3f },\n",
+      name.c_str(),
+      pid,
+      sm,
+      ts.count() * 1e6,
+      dur.count() * 1e6);
+}
+
+// Note [ Compile time instrumentation ]
+//
+// The first run of a fusion pays for segmentation, heuristics, scheduling,
+// every lowering pass, code generation, NVRTC and module loading. Each of
+// these stages is timed and recorded twice:
+//
+// - into process wide histograms (CompileStats), available from python
+//   through nvfuser._C.compile_stats(), and
+// - into the CompileTimings of the compilation the stage belongs to, which
+//   FusionKernelRuntime and FusionExecutor expose and the ExecutorLog
+//   carries in profiling mode.
+//
+// The stages are also emitted to the PYTORCH_NVFUSER_TRACE trace. The
+// second destination is found through a thread local pointer set by
+// CompileTimingsGuard, so stages don't need to know which compilation they
+// are part of, and stages of compilations in another thread (parallel or
+// background compilation) are attributed to the right one.
+namespace {
+
+thread_local CompileTimings* active_compile_timings = nullptr;
+
+} // namespace
+
+double CompileTimings::totalMs() const {
+  double total_ms = 0;
+  for (const auto& stage : stages_ms) {
+    total_ms += stage.second;
+  }
+  return total_ms;
+}
+
+void CompileStats::record(const std::string& stage, double duration_ms) {
+  if (active_compile_timings != nullptr) {
+    active_compile_timings->stages_ms.emplace_back(stage, duration_ms);
+  }
+
+  size_t bucket = 0;
+  while (bucket + 1 < CompileStageStats::kNumBuckets &&
+         duration_ms >= CompileStageStats::bucketUpperBoundMs(bucket)) {
+    ++bucket;
+  }
+
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto& stats = stats_[stage];
+  if (stats.count == 0 || duration_ms < stats.min_ms) {
+    stats.min_ms = duration_ms;
+  }
+  if (duration_ms > stats.max_ms) {
+    stats.max_ms = duration_ms;
+  }
+  ++stats.count;
+  stats.total_ms += duration_ms;
+  ++stats.histogram[bucket];
+}
+
+std::map<std::string, CompileStageStats> CompileStats::stats() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return stats_;
+}
+
+void CompileStats::reset() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  stats_.clear();
+}
+
+CompileTimingsGuard::CompileTimingsGuard(CompileTimings* timings)
+    : prev_timings_(active_compile_timings) {
+  active_compile_timings = timings;
+}
+
+CompileTimingsGuard::~CompileTimingsGuard() {
+  active_compile_timings = prev_timings_;
+}
+
+void CompileStageLaps::lap(const std::string& name) {
+  const auto now = Trace::Clock::now();
+  const std::chrono::duration<double, std::milli> d = now - start_;
+  const std::string stage = prefix_ + name;
+  Trace::instance()->completedEvent(stage, start_, now);
+  CompileStats::instance()->record(stage, d.count());
+  start_ = now;
+}
+
+// Note [ Runtime metrics ]
+//
+// The trace and the compile stats are meant for analysis sessions, not for
+// every run in production. RuntimeMetrics counts what is needed to notice
+// recompilation storms and slow paths in a running process: runs, kernel
+// runtime cache hits and misses, new kernel runtimes and compilations,
+// launched segments, allocated bytes and a histogram of the host latency of
+// the runs. Durations of the compilations are aggregated by CompileStats,
+// see Note [ Compile time instrumentation ].
+//
+// Recording must not add contention between the threads launching fusions,
+// so every thread owns a shard of the counters and is the only writer of
+// it. Increments are relaxed loads and stores of its own cache lines, and
+// neither lock nor read-modify-write. A scraper sums the shards under the
+// registry lock, which a recording thread only takes when it records for
+// the first time and when it exits, folding its shard into the retired
+// totals. As shards can't be cleared from another thread, reset() records
+// the current totals as a baseline that is subtracted from the snapshots.
+// Snapshots are not atomic across counters, which is fine for periodic
+// scraping.
+struct alignas(64) RuntimeMetrics::Shard {
+  std::array<std::atomic<int64_t>, RuntimeMetricsSnapshot::kNumCounters>
+      counters{};
+  std::array<std::atomic<int64_t>, RuntimeMetricsSnapshot::kNumLatencyBuckets>
+      latency_histogram{};
+  std::atomic<int64_t> total_latency_ns{0};
+};
+
+namespace {
+
+// Only the owning thread writes a shard, so the increment doesn't need to be
+// a read-modify-write
+void bump(std::atomic<int64_t>& value, int64_t increment) {
+  value.store(
+      value.load(std::memory_order_relaxed) + increment,
+      std::memory_order_relaxed);
+}
+
+template <size_t N>
+void accumulate(
+    std::array<int64_t, N>& totals,
+    const std::array<std::atomic<int64_t>, N>& values) {
+  for (const auto i : c10::irange(N)) {
+    totals[i] += values[i].load(std::memory_order_relaxed);
+  }
+}
+
+template <size_t N>
+void subtract(
+    std::array<int64_t, N>& totals,
+    const std::array<int64_t, N>& values) {
+  for (const auto i : c10::irange(N)) {
+    totals[i] -= values[i];
+  }
+}
+
+} // namespace
+
+//! Registers the shard of a thread, and retires it when the thread exits
+class RuntimeMetrics::ThreadShard {
+ public:
+  explicit ThreadShard(RuntimeMetrics* metrics) : metrics_(metrics) {
+    std::lock_guard<std::mutex> guard(metrics_->mutex_);
+    metrics_->shards_.push_back(&shard_);
+  }
+
+  ~ThreadShard() {
+    std::lock_guard<std::mutex> guard(metrics_->mutex_);
+    auto& retired = metrics_->retired_;
+    accumulate(retired.counters, shard_.counters);
+    accumulate(retired.latency_histogram, shard_.latency_histogram);
+    retired.total_latency_ns +=
+        shard_.total_latency_ns.load(std::memory_order_relaxed);
+    auto& shards = metrics_->shards_;
+    shards.erase(std::find(shards.begin(), shards.end(), &shard_));
+  }
+
+  Shard* shard() {
+    return &shard_;
+  }
+
+ private:
+  RuntimeMetrics* metrics_ = nullptr;
+  Shard shard_;
+};
+
+const char* toString(RuntimeCounter counter) {
+  switch (counter) {
+    case RuntimeCounter::FusionRuns:
+      return "fusion_runs";
+    case RuntimeCounter::RuntimeCacheHits:
+      return "runtime_cache_hits";
+    case RuntimeCounter::RuntimeCacheMisses:
+      return "runtime_cache_misses";
+    case RuntimeCounter::KernelRuntimesCreated:
+      return "kernel_runtimes_created";
+    case RuntimeCounter::KernelCompilations:
+      return "kernel_compilations";
+    case RuntimeCounter::SegmentsRun:
+      return "segments_run";
+    case RuntimeCounter::BytesAllocated:
+      return "bytes_allocated";
+    default:
+      TORCH_INTERNAL_ASSERT(false, "Unknown runtime counter");
+  }
+}
+
+RuntimeMetrics* RuntimeMetrics::instance() {
+  // Never destroyed, so that threads exiting after the static destructors
+  // can still retire their shards
+  static auto metrics = new RuntimeMetrics();
+  return metrics;
+}
+
+RuntimeMetrics::Shard* RuntimeMetrics::localShard() {
+  thread_local ThreadShard thread_shard(this);
+  return thread_shard.shard();
+}
+
+void RuntimeMetrics::add(RuntimeCounter counter, int64_t value) {
+  bump(localShard()->counters[static_cast<size_t>(counter)], value);
+}
+
+void RuntimeMetrics::recordRun(std::chrono::nanoseconds host_latency) {
+  const double latency_us = static_cast<double>(host_latency.count()) / 1e3;
+  size_t bucket = 0;
+  while (
+      bucket + 1 < RuntimeMetricsSnapshot::kNumLatencyBuckets &&
+      latency_us >= RuntimeMetricsSnapshot::latencyBucketUpperBoundUs(bucket)) {
+    ++bucket;
+  }
+
+  auto shard = localShard();
+  bump(shard->counters[static_cast<size_t>(RuntimeCounter::FusionRuns)], 1);
+  bump(shard->latency_histogram[bucket], 1);
+  bump(shard->total_latency_ns, host_latency.count());
+}
+
+RuntimeMetricsSnapshot RuntimeMetrics::totals() const {
+  RuntimeMetricsSnapshot totals = retired_;
+  for (const auto shard : shards_) {
+    accumulate(totals.counters, shard->counters);
+    accumulate(totals.latency_histogram, shard->latency_histogram);
+    totals.total_latency_ns +=
+        shard->total_latency_ns.load(std::memory_order_relaxed);
+  }
+  return totals;
+}
+
+RuntimeMetricsSnapshot RuntimeMetrics::snapshot() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto snapshot = totals();
+  subtract(snapshot.counters, baseline_.counters);
+  subtract(snapshot.latency_histogram, baseline_.latency_histogram);
+  snapshot.total_latency_ns -= baseline_.total_latency_ns;
+  return snapshot;
+}
+
+void RuntimeMetrics::reset() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  baseline_ = totals();
+}
+
+// Note [ Kernel telemetry ]
+//
+// ExecutorLog and the kernel profiles describe the kernels of a single
+// kernel runtime. Finding the kernels worth tuning in a model needs the
+// totals of every kernel of the process instead, over all
+// FusionExecutorCaches, including those of the python FusionCache. With
+// PYTORCH_NVFUSER_ENABLE=kernel_telemetry, or once enabled with
+// KernelTelemetry::setEnabled, FusionExecutor::runFusion times each launch
+// with CUDA events and records its GPU time, its host overhead and the
+// recompilations of the kernel into KernelTelemetry, keyed by the kernel
+// name, which is unique within the process. Kernel runtimes add the
+// heuristic and its parameters the first time they launch a kernel, so the
+// report says how each hot kernel was scheduled.
+//
+// Timing waits for each kernel to complete, and recording takes a process
+// wide lock, so telemetry is meant for finding hot kernels rather than for
+// production runs, see Note [ Runtime metrics ] for what is cheap enough
+// to be always on. The report ranks the kernels by GPU time and is exported
+// as JSON, also from python through nvfuser._C.kernel_telemetry_json(), or
+// as a trace in the format of Trace, with a slice for each kernel as long
+// as its total GPU time.
+namespace {
+
+std::string escapeJson(const std::string& str) {
+  std::stringstream ss;
+  for (const char c : str) {
+    switch (c) {
+      case '"':
+        ss << "\\\"";
+        break;
+      case '\\':
+        ss << "\\\\";
+        break;
+      case '\n':
+        ss << "\\n";
+        break;
+      case '\t':
+        ss << "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          ss << ' ';
+        } else {
+          ss << c;
+        }
+    }
+  }
+  return ss.str();
+}
+
+} // namespace
+
+void KernelTelemetry::recordLaunch(
+    const std::string& kernel_name,
+    double host_overhead_ms,
+    double gpu_time_ms) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto& entry = entries_[kernel_name];
+  entry.kernel_name = kernel_name;
+  ++entry.calls;
+  entry.gpu_time_ms += gpu_time_ms;
+  entry.host_overhead_ms += host_overhead_ms;
+}
+
+void KernelTelemetry::recordRecompile(const std::string& kernel_name) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto& entry = entries_[kernel_name];
+  entry.kernel_name = kernel_name;
+  ++entry.recompiles;
+}
+
+bool KernelTelemetry::hasHeuristic(const std::string& kernel_name) const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto it = entries_.find(kernel_name);
+  return it != entries_.end() && !it->second.heuristic.empty();
+}
+
+void KernelTelemetry::setHeuristic(
+    const std::string& kernel_name,
+    std::string heuristic,
+    std::string params) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto& entry = entries_[kernel_name];
+  entry.kernel_name = kernel_name;
+  entry.heuristic = std::move(heuristic);
+  entry.params = std::move(params);
+}
+
+std::vector<KernelTelemetryEntry> KernelTelemetry::report(size_t top_k) const {
+  std::vector<KernelTelemetryEntry> entries;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    entries.reserve(entries_.size());
+    for (const auto& [kernel_name, entry] : entries_) {
+      entries.push_back(entry);
+    }
+  }
+  std::sort(
+      entries.begin(),
+      entries.end(),
+      [](const KernelTelemetryEntry& a, const KernelTelemetryEntry& b) {
+        if (a.gpu_time_ms != b.gpu_time_ms) {
+          return a.gpu_time_ms > b.gpu_time_ms;
+        }
+        if (a.host_overhead_ms != b.host_overhead_ms) {
+          return a.host_overhead_ms > b.host_overhead_ms;
+        }
+        return a.kernel_name < b.kernel_name;
+      });
+  if (top_k > 0 && entries.size() > top_k) {
+    entries.resize(top_k);
+  }
+  return entries;
+}
+
+std::string KernelTelemetry::toJson(size_t top_k) const {
+  std::stringstream ss;
+  ss << "{\n\"kernels\": [";
+  const auto entries = report(top_k);
+  for (const auto i : c10::irange(entries.size())) {
+    const auto& entry = entries[i];
+    ss << (i == 0 ? "\n" : ",\n") << "{ \"rank\": " << i + 1
+       << ", \"kernel\": \"" << escapeJson(entry.kernel_name)
+       << "\", \"heuristic\": \"" << escapeJson(entry.heuristic)
+       << "\", \"calls\": " << entry.calls
+       << ", \"gpu_time_ms\": " << entry.gpu_time_ms
+       << ", \"host_overhead_ms\": " << entry.host_overhead_ms
+       << ", \"recompiles\": " << entry.recompiles << ", \"params\": \""
+       << escapeJson(entry.params) << "\" }";
+  }
+  ss << "\n]\n}\n";
+  return ss.str();
+}
+
+void KernelTelemetry::writeTrace(const std::string& path, size_t top_k) const {
+  FILE* trace_file = fopen(path.c_str(), "w");
+  TORCH_CHECK(trace_file != nullptr, "Can't open trace file ", path);
+  fprintf(trace_file, "{\n\"traceEvents\": [\n");
+  // The slices of the kernels are back to back on a single track, in the
+  // order of their rank
+  double ts_us = 0;
+  const auto entries = report(top_k);
+  for (const auto i : c10::irange(entries.size())) {
+    const auto& entry = entries[i];
+    const double dur_us = entry.gpu_time_ms * 1e3;
+    fprintf(
+        trace_file,
+        "{ \"name\": \"%s\", \"ph\": \"X\", \"pid\": 0, \"tid\": 0, \"ts\": %.3f, \"dur\": %.3f, \"args\": { \"rank\": %zu, \"heuristic\": \"%s\", \"calls\": %lld, \"host_overhead_ms\": %.3f, \"recompiles\": %lld } }%c\n",
+        escapeJson(entry.kernel_name).c_str(),
+        ts_us,
+        dur_us,
+        i + 1,
+        escapeJson(entry.heuristic).c_str(),
+        (long long)entry.calls,
+        entry.host_overhead_ms,
+        (long long)entry.recompiles,
+        i + 1 == entries.size() ? ' ' : ',');
+    ts_us += dur_us;
+  }
+  fprintf(trace_file, "],\n\"displayTimeUnit\": \"ms\"\n}\n");
+  fclose(trace_file);
+}
+
+void KernelTelemetry::reset() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  entries_.clear();
+}
+
 } // namespace inst
 } // namespace nvfuser
@@ -13,8 +13,17 @@
 
 // NOLINTNEXTLINE(modernize-deprecated-headers)
 #include <stdio.h>
+#include <array>
+#include <atomic>
 #include <chrono>
 #include <cstdio>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 namespace nvfuser {
 namespace inst {
@@ -63,16 +72,50 @@ class TORCH_CUDA_CU_API Trace : public NonCopyable {
     }
   }
 
+  //! Records an event that has already completed, used for events without
+  //! a scope of their own such as the individual lowering passes
+  void completedEvent(
+      const std::string& name,
+      Clock::time_point begin,
+      Clock::time_point end) {
+    if (log_file_ != nullptr) {
+      logEvent('B', name.c_str(), ',', begin);
+      logEvent('E', name.c_str(), ',', end);
+    }
+  }
+
+  //! Records an event that ran on a GPU, on the track of the SM `sm` of a
+  //! pseudo process standing for the device. See
+  //! Note [ Kernel profile timeline ]
+  void deviceEvent(
+      const std::string& name,
+      int device,
+      int sm,
+      Clock::time_point begin,
+      Clock::time_point end);
+
  private:
   Trace();
   ~Trace();
 
-  void logEvent(char ph, const char* name, char sep = ',');
+  void logEvent(char ph, const char* name, char sep = ',') {
+    logEvent(ph, name, sep, Clock::now());
+  }
+
+  void logEvent(
+      char ph,
+      const char* name,
+      char sep,
+      Clock::time_point timestamp);
 
  private:
   FILE* log_file_ = nullptr;
   Clock::time_point start_timestamp_;
   bool record_nvtx_range_ = true;
+
+  //! Devices whose pseudo process has been named in the trace
+  std::mutex named_devices_mutex_;
+  std::unordered_set<int> named_devices_;
 };
 
 //! \internal Automatic scope for a perf marker
@@ -91,6 +134,274 @@ class TORCH_CUDA_CU_API TraceScope : public NonCopyable {
   const char* event_name_ = nullptr;
 };
 
+//! Durations of the stages of a single compilation, in the order they
+//! completed. See Note [ Compile time instrumentation ]
+struct TORCH_CUDA_CU_API CompileTimings {
+  //! (stage name, duration in milliseconds)
+  std::vector<std::pair<std::string, double>> stages_ms;
+
+  double totalMs() const;
+
+  void clear() {
+    stages_ms.clear();
+  }
+};
+
+//! Aggregate of one compilation stage over all compilations of the process
+struct TORCH_CUDA_CU_API CompileStageStats {
+  //! Bucket i counts the durations below bucketUpperBoundMs(i) that don't
+  //! fit an earlier bucket, the last bucket counts everything else
+  static constexpr size_t kNumBuckets = 20;
+
+  static double bucketUpperBoundMs(size_t bucket) {
+    return 0.01 * static_cast<double>(1 << bucket);
+  }
+
+  int64_t count = 0;
+  double total_ms = 0;
+  double min_ms = 0;
+  double max_ms = 0;
+  std::array<int64_t, kNumBuckets> histogram = {};
+};
+
+//! Process wide histograms of the compilation stage durations
+class TORCH_CUDA_CU_API CompileStats : public NonCopyable {
+ public:
+  static CompileStats* instance() {
+    static CompileStats stats;
+    return &stats;
+  }
+
+  //! Adds a stage duration to the histograms and to the CompileTimings of
+  //! the innermost CompileTimingsGuard of the calling thread
+  void record(const std::string& stage, double duration_ms);
+
+  std::map<std::string, CompileStageStats> stats() const;
+
+  void reset();
+
+ private:
+  CompileStats() = default;
+
+ private:
+  mutable std::mutex mutex_;
+  std::map<std::string, CompileStageStats> stats_;
+};
+
+//! Routes the stages the calling thread records into timings for the
+//! lifetime of the guard
+class TORCH_CUDA_CU_API CompileTimingsGuard : public NonCopyable {
+ public:
+  explicit CompileTimingsGuard(CompileTimings* timings);
+
+  ~CompileTimingsGuard();
+
+ private:
+  CompileTimings* prev_timings_ = nullptr;
+};
+
+//! \internal Automatic scope for a compilation stage
+//!   (normally used through the FUSER_COMPILE_STAGE_SCOPE macro)
+class TORCH_CUDA_CU_API CompileStageScope : public NonCopyable {
+ public:
+  explicit CompileStageScope(const char* stage_name)
+      : trace_scope_(stage_name),
+        stage_name_(stage_name),
+        start_(Trace::Clock::now()) {}
+
+  ~CompileStageScope() {
+    const std::chrono::duration<double, std::milli> d =
+        Trace::Clock::now() - start_;
+    CompileStats::instance()->record(stage_name_, d.count());
+  }
+
+ private:
+  TraceScope trace_scope_;
+  const char* stage_name_ = nullptr;
+  Trace::Clock::time_point start_;
+};
+
+//! Times back-to-back steps without a scope of their own, such as the
+//! lowering passes. Each lap records the time since the previous lap (or
+//! restart) as the stage "<prefix><name>"
+class TORCH_CUDA_CU_API CompileStageLaps : public NonCopyable {
+ public:
+  explicit CompileStageLaps(std::string prefix)
+      : prefix_(std::move(prefix)), start_(Trace::Clock::now()) {}
+
+  void lap(const std::string& name);
+
+  //! Excludes the time since the last lap from the next one
+  void restart() {
+    start_ = Trace::Clock::now();
+  }
+
+ private:
+  std::string prefix_;
+  Trace::Clock::time_point start_;
+};
+
+//! Counters of RuntimeMetrics, see Note [ Runtime metrics ]
+enum class RuntimeCounter {
+  FusionRuns, //! Runs of FusionExecutorCache
+  RuntimeCacheHits, //! Lookups of inputs whose id had a kernel runtime
+  RuntimeCacheMisses, //! Lookups that selected or created a kernel runtime
+  KernelRuntimesCreated, //! Kernel runtimes segmented and scheduled
+  KernelCompilations, //! Calls of FusionExecutor::compileFusion
+  SegmentsRun, //! Kernel runtime segments launched
+  BytesAllocated, //! Device memory allocated for outputs and buffers
+  EndOfCounter //! Placeholder for counting the number of elements
+};
+
+TORCH_CUDA_CU_API const char* toString(RuntimeCounter counter);
+
+//! Totals of the runtime metrics of all threads since the last reset
+struct TORCH_CUDA_CU_API RuntimeMetricsSnapshot {
+  static constexpr size_t kNumCounters =
+      static_cast<size_t>(RuntimeCounter::EndOfCounter);
+
+  //! Bucket i counts the host latencies below latencyBucketUpperBoundUs(i)
+  //! that don't fit an earlier bucket, the last bucket counts everything else
+  static constexpr size_t kNumLatencyBuckets = 20;
+
+  static double latencyBucketUpperBoundUs(size_t bucket) {
+    return static_cast<double>(1 << bucket);
+  }
+
+  int64_t get(RuntimeCounter counter) const {
+    return counters[static_cast<size_t>(counter)];
+  }
+
+  std::array<int64_t, kNumCounters> counters = {};
+  std::array<int64_t, kNumLatencyBuckets> latency_histogram = {};
+  int64_t total_latency_ns = 0;
+};
+
+//! Process wide counters and host latency histogram of the runs, cheap
+//! enough to be always on. See Note [ Runtime metrics ]
+class TORCH_CUDA_CU_API RuntimeMetrics : public NonCopyable {
+ public:
+  static RuntimeMetrics* instance();
+
+  void add(RuntimeCounter counter, int64_t value = 1);
+
+  //! Counts a run of FusionExecutorCache and its host latency
+  void recordRun(std::chrono::nanoseconds host_latency);
+
+  RuntimeMetricsSnapshot snapshot() const;
+
+  void reset();
+
+ private:
+  struct Shard;
+  class ThreadShard;
+
+  RuntimeMetrics() = default;
+
+  //! The shard of the calling thread, registered on first use
+  Shard* localShard();
+
+  //! Sum of all shards, requires `mutex_` to be held
+  RuntimeMetricsSnapshot totals() const;
+
+ private:
+  //! Guards the registry of the shards, never taken by the recording
+  //! threads once their shard exists
+  mutable std::mutex mutex_;
+  std::vector<Shard*> shards_;
+  //! Totals of the threads that exited
+  RuntimeMetricsSnapshot retired_;
+  //! Totals at the last reset, subtracted from the snapshots
+  RuntimeMetricsSnapshot baseline_;
+};
+
+//! Records the host latency of a run of FusionExecutorCache on destruction
+class TORCH_CUDA_CU_API RunLatencyScope : public NonCopyable {
+ public:
+  RunLatencyScope() : start_(Trace::Clock::now()) {}
+
+  ~RunLatencyScope() {
+    RuntimeMetrics::instance()->recordRun(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            Trace::Clock::now() - start_));
+  }
+
+ private:
+  Trace::Clock::time_point start_;
+};
+
+//! Totals of the launches of a kernel, see Note [ Kernel telemetry ]
+struct TORCH_CUDA_CU_API KernelTelemetryEntry {
+  std::string kernel_name;
+  //! Scheduler heuristic and parameters of the kernel, empty unless a
+  //! kernel runtime launched it
+  std::string heuristic;
+  std::string params;
+  int64_t calls = 0;
+  //! Kernel time measured with CUDA events around the launches
+  double gpu_time_ms = 0;
+  //! Host time of the launches, from entering FusionExecutor::runFusion to
+  //! enqueuing the kernel
+  double host_overhead_ms = 0;
+  //! Recompilations for a larger block size or register count
+  int64_t recompiles = 0;
+};
+
+//! Process wide totals of every kernel launched while enabled, by
+//! PYTORCH_NVFUSER_ENABLE=kernel_telemetry or setEnabled, ranked by GPU
+//! time. See Note [ Kernel telemetry ]
+class TORCH_CUDA_CU_API KernelTelemetry : public NonCopyable {
+ public:
+  static KernelTelemetry* instance() {
+    static KernelTelemetry telemetry;
+    return &telemetry;
+  }
+
+  static bool enabled() {
+    return instance()->enabled_.load(std::memory_order_relaxed);
+  }
+
+  //! Overrides PYTORCH_NVFUSER_ENABLE=kernel_telemetry
+  void setEnabled(bool enabled) {
+    enabled_.store(enabled, std::memory_order_relaxed);
+  }
+
+  void recordLaunch(
+      const std::string& kernel_name,
+      double host_overhead_ms,
+      double gpu_time_ms);
+
+  void recordRecompile(const std::string& kernel_name);
+
+  bool hasHeuristic(const std::string& kernel_name) const;
+
+  void setHeuristic(
+      const std::string& kernel_name,
+      std::string heuristic,
+      std::string params);
+
+  //! Kernels by decreasing GPU time, then host overhead, the top_k first
+  //! ones only if top_k is positive
+  std::vector<KernelTelemetryEntry> report(size_t top_k = 0) const;
+
+  //! report() as a JSON object {"kernels": [...]}
+  std::string toJson(size_t top_k = 0) const;
+
+  //! Writes report() to path as a trace in the format of Trace, a slice
+  //! for each kernel as long as its GPU time
+  void writeTrace(const std::string& path, size_t top_k = 0) const;
+
+  void reset();
+
+ private:
+  KernelTelemetry() = default;
+
+ private:
+  std::atomic<bool> enabled_{isOptionEnabled(EnableOption::KernelTelemetry)};
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, KernelTelemetryEntry> entries_;
+};
+
 #define FUSER_MACRO_CONCAT2(a, b) a##b
 #define FUSER_MACRO_CONCAT(a, b) FUSER_MACRO_CONCAT2(a, b)
 #define FUSER_ANONYMOUS(prefix) FUSER_MACRO_CONCAT(prefix, __COUNTER__)
@@ -102,5 +413,13 @@ class TORCH_CUDA_CU_API TraceScope : public NonCopyable {
 #define FUSER_PERF_SCOPE(name) \
   nvfuser::inst::TraceScope FUSER_ANONYMOUS(_perf_scope_)(name)
 
+//! Defines a compilation stage we want to measure, recorded in the perf
+//! trace as well as in the compile time statistics
+//!
+//! \param name The name of the stage, a string literal
+//!
+#define FUSER_COMPILE_STAGE_SCOPE(name) \
+  nvfuser::inst::CompileStageScope FUSER_ANONYMOUS(_compile_stage_)(name)
+
 } // namespace inst
 } // namespace nvfuser
@@ -29,6 +29,8 @@ Val* IrBuilder::newScalar(DataType dtype) {
       return IrBuilder::create<Double>(dtype);
     case DataType::Int:
     case DataType::Int32:
+    case DataType::Int8:
+    case DataType::UInt8:
     case DataType::Index:
       return IrBuilder::create<Int>(dtype);
     case DataType::ComplexFloat:
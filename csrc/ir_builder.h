@@ -10,6 +10,8 @@
 #include <ir_all_nodes.h>
 #include <ir_builder_passkey.h>
 
+#include <new>
+
 namespace nvfuser {
 
 namespace kir {
@@ -29,7 +31,9 @@ class TORCH_CUDA_CU_API IrBuilder {
     // return create<T>(container, std::forward<Args>(args)...);
     TORCH_INTERNAL_ASSERT(
         container != nullptr, "Need an active container to build IR.");
-    T* node = new T(IrBuilderPasskey(container), std::forward<Args>(args)...);
+    T* node = new (container->allocateStmt(
+        IrBuilderPasskey(container), sizeof(T), alignof(T)))
+        T(IrBuilderPasskey(container), std::forward<Args>(args)...);
 
     container->registerStmt(IrBuilderPasskey(container), node);
 
@@ -42,7 +46,9 @@ class TORCH_CUDA_CU_API IrBuilder {
   static T* create(IrContainer* container, Args&&... args) {
     TORCH_INTERNAL_ASSERT(
         container != nullptr, "Need an active container to build IR.");
-    T* node = new T(IrBuilderPasskey(container), std::forward<Args>(args)...);
+    T* node = new (container->allocateStmt(
+        IrBuilderPasskey(container), sizeof(T), alignof(T)))
+        T(IrBuilderPasskey(container), std::forward<Args>(args)...);
 
     container->registerStmt(IrBuilderPasskey(container), node);
 
@@ -103,6 +109,8 @@ Val* IrBuilder::newConstant(T value, DataType dtype) {
       return IrBuilder::create<Double>((double)value, dtype);
     case DataType::Int:
     case DataType::Int32:
+    case DataType::Int8:
+    case DataType::UInt8:
     case DataType::Index:
       return IrBuilder::create<Int>((int64_t)value, dtype);
     case DataType::ComplexFloat:
@@ -81,6 +81,11 @@ class TORCH_CUDA_CU_API IrCloner {
     return ir_container_;
   }
 
+  //! Whether the node was already cloned by this cloner
+  bool isCloned(const Statement* statement) const {
+    return clones_map_.count(statement) > 0;
+  }
+
  protected:
   void registerClone(const Statement* src, Statement* clone);
   virtual Statement* handle(const Statement* s);
@@ -125,11 +130,13 @@ T* IrBuilder::clone(const T* src, IrCloner* ir_cloner) {
       ir_cloner->container() != nullptr,
       "Cloner doesn't have a valid container to store cloned object.");
 
-  T* dest = new T(src, ir_cloner);
+  auto dest_container = ir_cloner->container();
+  T* dest = new (dest_container->allocateStmt(
+      IrBuilderPasskey(dest_container), sizeof(T), alignof(T)))
+      T(src, ir_cloner);
   const Statement* src_stmt = dynamic_cast<const Statement*>(src);
   Statement* dest_stmt = dynamic_cast<Statement*>(dest);
 
-  auto dest_container = ir_cloner->container();
   auto src_container = src_stmt->container();
 
   dest_container->registerStmt(IrBuilderPasskey(dest_container), dest_stmt);
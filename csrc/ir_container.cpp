@@ -12,11 +12,49 @@
 
 namespace nvfuser {
 
+void* StatementArena::allocate(size_t size, size_t alignment) {
+  auto align = [alignment](char* ptr) {
+    auto address = reinterpret_cast<uintptr_t>(ptr);
+    return reinterpret_cast<char*>(
+        (address + alignment - 1) & ~(uintptr_t)(alignment - 1));
+  };
+  char* ptr = cursor_ == nullptr ? nullptr : align(cursor_);
+  if (ptr == nullptr || ptr + size > end_) {
+    // Nodes larger than a block get a block of their own
+    const auto block_size = std::max(kBlockSize, size + alignment);
+    blocks_.emplace_back(new char[block_size]);
+    end_ = blocks_.back().get() + block_size;
+    ptr = align(blocks_.back().get());
+  }
+  cursor_ = ptr + size;
+  return ptr;
+}
+
+void StatementArena::clear() noexcept {
+  blocks_.clear();
+  cursor_ = nullptr;
+  end_ = nullptr;
+}
+
+void StatementArena::swap(StatementArena& other) noexcept {
+  std::swap(blocks_, other.blocks_);
+  std::swap(cursor_, other.cursor_);
+  std::swap(end_, other.end_);
+}
+
 void swap(IrContainer& a, IrContainer& b) noexcept {
   FUSER_PERF_SCOPE("Fusion swap");
 
   using std::swap;
 
+  // The nodes go with the memory they live in, including the shortcuts
+  a.arena_.swap(b.arena_);
+  swap(a.true_val_, b.true_val_);
+  swap(a.false_val_, b.false_val_);
+  swap(a.one_val_, b.one_val_);
+  swap(a.zero_val_, b.zero_val_);
+  swap(a.magic_zero_val_, b.magic_zero_val_);
+
   // Swap the content
   swap(a.vals_up_, b.vals_up_);
   swap(a.vals_, b.vals_);
@@ -39,10 +77,10 @@ void swap(IrContainer& a, IrContainer& b) noexcept {
 
   // Fixup the Statement::fusion_ links for b
   for (auto val : b.vals_) {
-    val->ir_container_ = &a;
+    val->ir_container_ = &b;
   }
   for (auto expr : b.exprs_) {
-    expr->ir_container_ = &a;
+    expr->ir_container_ = &b;
   }
 }
 
@@ -121,7 +159,7 @@ void IrContainer::removeExpr(Expr* expr) {
   auto expr_in_deque = std::find_if(
       exprs_up_.begin(),
       exprs_up_.end(),
-      [expr](std::unique_ptr<Expr>& expr_up) { return expr_up.get() == expr; });
+      [expr](StmtPtr<Expr>& expr_up) { return expr_up.get() == expr; });
 
   TORCH_INTERNAL_ASSERT(
       expr_in_deque != exprs_up_.end(),
@@ -146,7 +184,7 @@ void IrContainer::removeVal(Val* val) {
       vals_.find(val) != vals_.end(),
       "Wanted to remove a value but it doesn't exist in this container.");
   auto val_in_deque = std::find_if(
-      vals_up_.begin(), vals_up_.end(), [val](std::unique_ptr<Val>& val_up) {
+      vals_up_.begin(), vals_up_.end(), [val](StmtPtr<Val>& val_up) {
         return val_up.get() == val;
       });
 
@@ -165,7 +203,7 @@ void IrContainer::registerVal(Val* val) {
     return;
   }
 
-  vals_up_.emplace_back(std::unique_ptr<Val>(val));
+  vals_up_.emplace_back(StmtPtr<Val>(val));
   vals_.emplace(vals_up_.back().get());
   val->setName(IrContainerPasskey(), getValName(vals_up_.back()->vtype()));
   raw_ptrs_.emplace((void*)vals_up_.back().get());
@@ -176,7 +214,7 @@ void IrContainer::registerExpr(Expr* expr) {
   if (inContainer(expr)) {
     return;
   }
-  exprs_up_.emplace_back(std::unique_ptr<Expr>(expr));
+  exprs_up_.emplace_back(StmtPtr<Expr>(expr));
   exprs_.emplace(exprs_up_.back().get());
   expr->setName(IrContainerPasskey(), getExprName());
   raw_ptrs_.emplace((void*)exprs_up_.back().get());
@@ -190,6 +228,14 @@ void IrContainer::clear() noexcept {
   exprs_up_.clear();
   raw_ptrs_.clear();
 
+  // The shortcuts live in the arena too, they are created again on demand
+  true_val_.reset();
+  false_val_.reset();
+  one_val_.reset();
+  zero_val_.reset();
+  magic_zero_val_.reset();
+  arena_.clear();
+
   val_type_name_map_.clear();
   expr_name_counter_ = 0;
 }
@@ -225,7 +271,7 @@ Int* IrContainer::zeroVal() {
   if (!zero_val_) {
     auto zero_val = IrBuilder::create<Int>(this, 0);
     TORCH_INTERNAL_ASSERT(vals_up_.back().get() == zero_val);
-    zero_val_ = std::unique_ptr<Int>(vals_up_.back().release()->as<Int>());
+    zero_val_ = StmtPtr<Int>(vals_up_.back().release()->as<Int>());
     vals_up_.pop_back();
   }
   return zero_val_.get();
@@ -251,7 +297,7 @@ Int* IrContainer::oneVal() {
   if (!one_val_) {
     auto one_val = IrBuilder::create<Int>(this, 1);
     TORCH_INTERNAL_ASSERT(vals_up_.back().get() == one_val);
-    one_val_ = std::unique_ptr<Int>(vals_up_.back().release()->as<Int>());
+    one_val_ = StmtPtr<Int>(vals_up_.back().release()->as<Int>());
     vals_up_.pop_back();
   }
   return one_val_.get();
@@ -277,7 +323,7 @@ Bool* IrContainer::falseVal() {
   if (!false_val_) {
     auto false_val = IrBuilder::create<Bool>(this, false);
     TORCH_INTERNAL_ASSERT(vals_up_.back().get() == false_val);
-    false_val_ = std::unique_ptr<Bool>(vals_up_.back().release()->as<Bool>());
+    false_val_ = StmtPtr<Bool>(vals_up_.back().release()->as<Bool>());
     vals_up_.pop_back();
   }
   return false_val_.get();
@@ -287,7 +333,7 @@ Bool* IrContainer::trueVal() {
   if (!true_val_) {
     auto true_val = IrBuilder::create<Bool>(this, true);
     TORCH_INTERNAL_ASSERT(vals_up_.back().get() == true_val);
-    true_val_ = std::unique_ptr<Bool>(vals_up_.back().release()->as<Bool>());
+    true_val_ = StmtPtr<Bool>(vals_up_.back().release()->as<Bool>());
     vals_up_.pop_back();
   }
   return true_val_.get();
@@ -298,7 +344,7 @@ NamedScalar* IrContainer::magicZeroVal() {
     auto magic_zero =
         IrBuilder::create<NamedScalar>(kMagicZeroName, DataType::Int);
     TORCH_INTERNAL_ASSERT(vals_up_.back().get() == magic_zero);
-    magic_zero_val_ = std::unique_ptr<NamedScalar>(
+    magic_zero_val_ = StmtPtr<NamedScalar>(
         vals_up_.back().release()->as<NamedScalar>());
     vals_up_.pop_back();
   }
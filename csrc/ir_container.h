@@ -13,6 +13,7 @@
 #include <utils.h>
 
 #include <deque>
+#include <memory>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -36,6 +37,53 @@ class IrContainerPasskey {
   explicit IrContainerPasskey() {}
 };
 
+// Note [ Statement arena ]
+//
+// Building or cloning a Fusion creates many small IR nodes, which used to be
+// allocated one by one on the heap. A container allocates its nodes from a
+// StatementArena instead, a bump allocator carving them out of large blocks,
+// and owns them through StmtPtr, which only runs their destructor. The
+// memory is released all at once when the container is cleared or
+// destroyed, so the memory of removed nodes is only reclaimed then.
+//
+// Nodes must be created through IrBuilder, which allocates them from the
+// arena of the container they are registered with.
+
+//! Bump allocator for the IR nodes of a container, see
+//! Note [ Statement arena ]
+class TORCH_CUDA_CU_API StatementArena {
+ public:
+  StatementArena() = default;
+  StatementArena(const StatementArena&) = delete;
+  StatementArena& operator=(const StatementArena&) = delete;
+
+  void* allocate(size_t size, size_t alignment);
+
+  //! Releases all the memory, the nodes must have been destroyed
+  void clear() noexcept;
+
+  void swap(StatementArena& other) noexcept;
+
+ private:
+  static constexpr size_t kBlockSize = 64 * 1024;
+
+  std::vector<std::unique_ptr<char[]>> blocks_;
+  // Free space of the last block
+  char* cursor_ = nullptr;
+  char* end_ = nullptr;
+};
+
+//! Destroys an IR node without freeing its memory, which belongs to the
+//! StatementArena of its container
+struct StatementDestroyer {
+  void operator()(Statement* stmt) const noexcept {
+    stmt->~Statement();
+  }
+};
+
+template <typename T>
+using StmtPtr = std::unique_ptr<T, StatementDestroyer>;
+
 class TORCH_CUDA_CU_API IrContainer : public PolymorphicBase {
  public:
   IrContainer();
@@ -62,10 +110,15 @@ class TORCH_CUDA_CU_API IrContainer : public PolymorphicBase {
         vals_up_.begin(),
         vals_up_.end(),
         std::back_inserter(vals_deque),
-        [](const std::unique_ptr<Val>& val_up) { return val_up.get(); });
+        [](const StmtPtr<Val>& val_up) { return val_up.get(); });
     return vals_deque;
   }
 
+  //! Allocate the memory of a Statement registered with this container
+  void* allocateStmt(IrBuilderPasskey, size_t size, size_t alignment) {
+    return arena_.allocate(size, alignment);
+  }
+
   //! Register the Statement with this container
   virtual void registerStmt(IrBuilderPasskey, Statement* stmt);
 
@@ -129,15 +182,19 @@ class TORCH_CUDA_CU_API IrContainer : public PolymorphicBase {
 
   void clear() noexcept;
 
+  // Memory of the Statements, see Note [ Statement arena ]. Declared first
+  // so that it outlives them.
+  StatementArena arena_;
+
   // Deque of unique pointer is the memory owning data structure
-  std::deque<std::unique_ptr<Val>> vals_up_;
+  std::deque<StmtPtr<Val>> vals_up_;
 
   // A convenient set to return when we just need an unordered set to do
   // something like check if a Val is in this container
   std::unordered_set<Val*> vals_;
 
   // Deque of unique pointer is the memory owning data structure
-  std::deque<std::unique_ptr<Expr>> exprs_up_;
+  std::deque<StmtPtr<Expr>> exprs_up_;
 
   // A convenient set to return when we just need an unordered set to do
   // something like check if an Expr is in this container
@@ -164,11 +221,11 @@ class TORCH_CUDA_CU_API IrContainer : public PolymorphicBase {
   // to know when we're using a different container as in FusionCopy_test
   // demonstrates deleting then creating containers can result in the same
   // pointer for the container.
-  std::unique_ptr<Bool> true_val_;
-  std::unique_ptr<Bool> false_val_;
-  std::unique_ptr<Int> one_val_;
-  std::unique_ptr<Int> zero_val_;
-  std::unique_ptr<NamedScalar> magic_zero_val_;
+  StmtPtr<Bool> true_val_;
+  StmtPtr<Bool> false_val_;
+  StmtPtr<Int> one_val_;
+  StmtPtr<Int> zero_val_;
+  StmtPtr<NamedScalar> magic_zero_val_;
 };
 
 } // namespace nvfuser
@@ -457,6 +457,16 @@ class TORCH_CUDA_CU_API TensorView : public Val {
     return circular_buffer_stage_;
   }
 
+  //! Sets the eviction priority of vectorized accesses of this tensor in
+  //! global memory, see Note [ Cache hints ]
+  void setCacheHint(CacheHint cache_hint) {
+    cache_hint_ = cache_hint;
+  }
+
+  CacheHint cacheHint() const {
+    return cache_hint_;
+  }
+
   //! Transforms the innermost iterdomains according to the given mma swizzle,
   //!  this should be used on the tvs that are either inputs/outputs of an
   //!  MmaOp, or any tv's that are involved in prolog/epilog fusions and need to
@@ -547,9 +557,7 @@ class TORCH_CUDA_CU_API TensorView : public Val {
   void updateMaxProducerPosition();
 
  protected:
-  void setDomain(TensorDomain* td) {
-    domain_ = td;
-  }
+  void setDomain(TensorDomain* td);
 
  private:
   int normalizeAxisPos(int pos) const {
@@ -580,6 +588,9 @@ class TORCH_CUDA_CU_API TensorView : public Val {
   //! Indicates the circular buffering stage depth if applicable.
   unsigned int circular_buffer_stage_ = 0;
 
+  //! Eviction priority of vectorized global memory accesses
+  CacheHint cache_hint_ = CacheHint::Default;
+
   // special handling for CPU based zero-dim tensors (i.e. CPU Tensors that
   // only have one value). This is only used if on an input value, otherwise
   // ignored. This is important as special handling because these "scalars"
@@ -196,6 +196,63 @@ class TORCH_CUDA_CU_API ScatterOp : public Expr {
   }
 };
 
+//! Inclusive prefix scan of in along dim with a binary op, e.g., cumsum. The
+//! output has the same domains as the input. See Note [ Scan ops ]
+class TORCH_CUDA_CU_API ScanOp : public Expr {
+ public:
+  using Expr::Expr;
+
+  ScanOp(
+      IrBuilderPasskey,
+      BinaryOpType scan_op_type,
+      Val* init,
+      Val* out,
+      Val* in,
+      int dim);
+
+  //! Create a scan op with the predicate of the first element of a scanned
+  //! row for codegen. Only used for the Kernel container
+  ScanOp(
+      IrBuilderPasskey,
+      BinaryOpType scan_op_type,
+      Val* init,
+      Val* out,
+      Val* in,
+      int dim,
+      Bool* is_first);
+
+  NVFUSER_DECLARE_CLONE_AND_CREATE
+
+  virtual const char* getOpString() const override {
+    return "ScanOp";
+  }
+
+  std::string toString(int indent_size = 0) const override;
+  std::string toInlineString(int indent_size = 0) const override;
+
+  Val* out() const {
+    return output(0);
+  }
+  Val* in() const {
+    return input(0);
+  }
+  Val* init() const {
+    return attributeVal(0);
+  }
+
+  BinaryOpType getScanOpType() const {
+    return attribute(1)->as<Attribute<BinaryOpType>>()->value;
+  }
+
+  int dim() const {
+    return attribute(2)->as<Attribute<int>>()->value;
+  }
+
+  //! True at the first element of a scanned row, where the scan restarts
+  //! from init. Only valid with the Kernel container
+  Bool* isFirst() const;
+};
+
 class TORCH_CUDA_CU_API IotaOp : public Expr {
  public:
   using Expr::Expr;
@@ -410,12 +467,16 @@ class TORCH_CUDA_CU_API RNGOp : public Expr {
     RNGOpType rtype;
     DataType dtype;
     int rng_offset;
+    // True when the last two inputs are an explicit Philox seed and offset,
+    // see Note [ Explicit Philox seed and offset ]
+    bool explicit_philox = false;
 
     // TODO: Enable the following in C++20:
     // bool operator==(const Attributes &other) const = default;
     bool operator==(const Attributes& other) const {
       return rtype == other.rtype && dtype == other.dtype &&
-          rng_offset == other.rng_offset;
+          rng_offset == other.rng_offset &&
+          explicit_philox == other.explicit_philox;
     }
   };
 
@@ -428,7 +489,9 @@ class TORCH_CUDA_CU_API RNGOp : public Expr {
       DataType dtype,
       std::vector<Val*> parameters = {},
       int rng_offset = 0,
-      Val* philox_index = nullptr);
+      Val* philox_index = nullptr,
+      Val* philox_seed = nullptr,
+      Val* philox_offset = nullptr);
 
   NVFUSER_DECLARE_CLONE_AND_CREATE
 
@@ -456,7 +519,24 @@ class TORCH_CUDA_CU_API RNGOp : public Expr {
   }
 
   std::vector<Val*> getParameters() const {
-    return {inputs().begin() + getOutputDims(), inputs().end()};
+    return {
+        inputs().begin() + getOutputDims(),
+        inputs().end() - (hasExplicitPhilox() ? 2 : 0)};
+  }
+
+  bool hasExplicitPhilox() const {
+    return attribute(0)->as<Attribute<Attributes>>()->value.explicit_philox;
+  }
+
+  //! Seed used instead of the one of the global generator, or nullptr
+  Val* getPhiloxSeed() const {
+    return hasExplicitPhilox() ? input(inputs().size() - 2) : nullptr;
+  }
+
+  //! Philox offset used instead of the one reserved from the global
+  //! generator, or nullptr
+  Val* getPhiloxOffset() const {
+    return hasExplicitPhilox() ? input(inputs().size() - 1) : nullptr;
   }
 
   std::vector<Val*> getShape() const {
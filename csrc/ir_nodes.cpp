@@ -276,6 +276,77 @@ std::string ScatterOp::toInlineString(int indent_size) const {
 
 NVFUSER_DEFINE_CLONE_AND_CREATE(ScatterOp)
 
+ScanOp::ScanOp(
+    IrBuilderPasskey passkey,
+    BinaryOpType scan_op_type,
+    Val* init,
+    Val* out,
+    Val* in,
+    int dim)
+    : Expr(passkey) {
+  TORCH_INTERNAL_ASSERT(
+      (in->isA<TensorView>() && out->isA<TensorView>()) ||
+          (in->isA<kir::TensorIndex>() && out->isA<kir::TensorIndex>()),
+      "Scan operation was created without tensor inputs and outputs.");
+  if (out->isA<TensorView>()) {
+    TORCH_INTERNAL_ASSERT(
+        dim >= 0 &&
+            dim < static_cast<int>(
+                      out->as<TensorView>()->getRootDomain().size()),
+        "Invalid dimension to scan: ",
+        dim);
+  }
+  TORCH_INTERNAL_ASSERT(
+      init->isConstScalar(),
+      "Tried to create a scan operation with a non-constant initial value.");
+
+  addOutput(out);
+  addInput(in);
+  addAttribute(init);
+  addAttribute(IrBuilder::create<Attribute<BinaryOpType>>(
+      passkey.ir_container_, scan_op_type));
+  addAttribute(IrBuilder::create<Attribute<int>>(passkey.ir_container_, dim));
+}
+
+ScanOp::ScanOp(
+    IrBuilderPasskey passkey,
+    BinaryOpType scan_op_type,
+    Val* init,
+    Val* out,
+    Val* in,
+    int dim,
+    Bool* is_first)
+    : ScanOp(passkey, scan_op_type, init, out, in, dim) {
+  TORCH_INTERNAL_ASSERT(
+      passkey.ir_container_->isA<kir::Kernel>(),
+      "Should only be used for Kernel container.");
+  addAttribute(is_first);
+}
+
+std::string ScanOp::toString(int indent_size) const {
+  std::stringstream ss;
+  indent(ss, indent_size) << out() << "\n";
+  indent(ss, indent_size) << "   = scan( " << in()->toString()
+                          << ", op = " << getScanOpType()
+                          << ", initial value = " << init()->toString()
+                          << ", dim = " << dim() << " )\n";
+  return ss.str();
+}
+
+std::string ScanOp::toInlineString(int indent_size) const {
+  TORCH_CHECK(false, "Tensor op can not be printed inline");
+}
+
+Bool* ScanOp::isFirst() const {
+  TORCH_INTERNAL_ASSERT(
+      container()->isA<kir::Kernel>(),
+      "Should only be used for Kernel container.");
+  TORCH_INTERNAL_ASSERT(attributes().size() == 4, "No predicate found");
+  return attribute(3)->as<Bool>();
+}
+
+NVFUSER_DEFINE_CLONE_AND_CREATE(ScanOp)
+
 IotaOp::IotaOp(
     IrBuilderPasskey passkey,
     Val* out,
@@ -679,8 +750,13 @@ RNGOp::RNGOp(
     DataType dtype,
     std::vector<Val*> parameters,
     int rng_offset,
-    Val* philox_index)
+    Val* philox_index,
+    Val* philox_seed,
+    Val* philox_offset)
     : Expr(passkey) {
+  TORCH_CHECK(
+      (philox_seed == nullptr) == (philox_offset == nullptr),
+      "Philox seed and offset must be given together");
   if (auto tv_out = dynamic_cast<TensorView*>(out)) {
     for (auto id : tv_out->getRootDomain()) {
       TORCH_CHECK(!id->isReduction(), "Output of RNGOp can not have reduction");
@@ -690,8 +766,12 @@ RNGOp::RNGOp(
   for (auto v : parameters) {
     addInput(v);
   }
+  if (philox_seed != nullptr) {
+    addInput(philox_seed);
+    addInput(philox_offset);
+  }
   addOutput(out);
-  RNGOp::Attributes attr{type, dtype, rng_offset};
+  RNGOp::Attributes attr{type, dtype, rng_offset, philox_seed != nullptr};
   addAttribute(IrBuilder::create<Attribute<RNGOp::Attributes>>(
       passkey.ir_container_, attr));
   addAttribute(philox_index);
@@ -708,7 +788,12 @@ std::string RNGOp::toString(int indent_size) const {
   if (!getParameters().empty()) {
     ss << toDelimitedString(getParameters()) << ", ";
   }
-  ss << dtype() << ");\n";
+  ss << dtype();
+  if (hasExplicitPhilox()) {
+    ss << ", seed=" << getPhiloxSeed()->toInlineString()
+       << ", offset=" << getPhiloxOffset()->toInlineString();
+  }
+  ss << ");\n";
   return ss.str();
 }
 
@@ -426,6 +426,30 @@ std::vector<TorchGatherOp*> getTorchGatherOps(Fusion* fusion) {
   return torch_gather_ops;
 }
 
+std::vector<ScanOp*> getScanOps(Fusion* fusion) {
+  std::vector<ScanOp*> scan_ops;
+
+  for (auto expr : fusion->exprs()) {
+    if (expr->isA<ScanOp>()) {
+      scan_ops.push_back(expr->as<ScanOp>());
+    }
+  }
+
+  return scan_ops;
+}
+
+std::vector<ShiftOp*> getShiftOps(Fusion* fusion) {
+  std::vector<ShiftOp*> shift_ops;
+
+  for (auto expr : fusion->exprs()) {
+    if (expr->isA<ShiftOp>()) {
+      shift_ops.push_back(expr->as<ShiftOp>());
+    }
+  }
+
+  return shift_ops;
+}
+
 std::vector<SelectOp*> getSelectOps(Fusion* fusion) {
   std::vector<SelectOp*> select_ops;
 
@@ -769,6 +793,15 @@ bool isIndexSelectIndicesTv(const TensorView* tv) {
   return false;
 }
 
+bool isScanAxis(const TensorView* tv, IterDomain* id) {
+  auto sop = dynamic_cast<ScanOp*>(tv->definition());
+  if (sop == nullptr || sop->out() != tv) {
+    return false;
+  }
+  auto scan_id = tv->getRootDomain().at(sop->dim());
+  return id == scan_id || DependencyCheck::isDependencyOf(scan_id, id);
+}
+
 bool isTorchGatherLookupTv(const Val* tv) {
   for (auto expr : tv->uses()) {
     if (expr->isA<TorchGatherOp>()) {
@@ -793,6 +826,15 @@ bool isTorchGatherIndicesTv(const Val* tv) {
   return false;
 }
 
+bool isScatterSelfTv(const Val* tv) {
+  for (auto expr : tv->uses()) {
+    if (expr->isA<ScatterOp>() && expr->as<ScatterOp>()->selfTv() == tv) {
+      return true;
+    }
+  }
+  return false;
+}
+
 std::string varName(const Val* val) {
   if (val->isA<kir::TensorIndex>()) {
     return varName(val->as<kir::TensorIndex>()->view());
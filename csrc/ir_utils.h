@@ -325,6 +325,10 @@ TORCH_CUDA_CU_API std::vector<IndexSelectOp*> getIndexSelectOps(Fusion* fusion);
 
 TORCH_CUDA_CU_API std::vector<TorchGatherOp*> getTorchGatherOps(Fusion* fusion);
 
+TORCH_CUDA_CU_API std::vector<ScanOp*> getScanOps(Fusion* fusion);
+
+TORCH_CUDA_CU_API std::vector<ShiftOp*> getShiftOps(Fusion* fusion);
+
 TORCH_CUDA_CU_API std::vector<SelectOp*> getSelectOps(Fusion* fusion);
 
 // Returns the initialization value of tv or nullptr if not initialized.
@@ -372,11 +376,18 @@ TORCH_CUDA_CU_API bool isIndexSelectLookupTv(const TensorView* tv);
 // Check if the given tv is third argment of index_select(lookup, dim, indices)
 TORCH_CUDA_CU_API bool isIndexSelectIndicesTv(const TensorView* tv);
 
+// Check if tv is the output of a scan and id one of its IterDomains derived
+// from the scanned root domain, see Note [ Scan ops ]
+TORCH_CUDA_CU_API bool isScanAxis(const TensorView* tv, IterDomain* id);
+
 // Check if the given tv is first/third argment of torch_gather(lookup, dim,
 // indices)
 TORCH_CUDA_CU_API bool isTorchGatherIndicesTv(const Val* tv);
 TORCH_CUDA_CU_API bool isTorchGatherLookupTv(const Val* tv);
 
+// Check if the given tv is first argment of scatter(self, dim, index, src)
+TORCH_CUDA_CU_API bool isScatterSelfTv(const Val* tv);
+
 TORCH_CUDA_CU_API std::string varName(const Val* val);
 
 // Check if a tensor is resized as part of  its root to rfactor transformations
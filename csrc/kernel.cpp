@@ -14,7 +14,9 @@
 
 #include <ATen/cuda/CUDAContext.h>
 
+#include <chrono>
 #include <iostream>
+#include <limits>
 #include <unordered_set>
 
 namespace nvfuser {
@@ -136,6 +138,25 @@ class KernelIrScanner : private IrVisitor {
     if (grid_reduction->isAllreduce()) {
       summary_.has_cooperative_grid_reduction = true;
     }
+    if (grid_reduction->useOuterOpt()) {
+      summary_.has_outer_grouped_grid_reduction = true;
+      const auto& par_dim_map = GpuLower::current()->parallelDimensionMap();
+      auto tidx_val = par_dim_map.get(ParallelType::TIDx);
+      auto tidy_val = par_dim_map.get(ParallelType::TIDy);
+      TORCH_INTERNAL_ASSERT(
+          tidx_val->isConstInt(),
+          "TIDx is expected to be a const int: ",
+          tidx_val->toInlineString());
+      TORCH_INTERNAL_ASSERT(
+          tidy_val->isConstInt(),
+          "TIDy is expected to be a const int: ",
+          tidy_val->toInlineString());
+      auto tidx = static_cast<int>(tidx_val->evaluateInt());
+      auto tidy = static_cast<int>(tidy_val->evaluateInt());
+      summary_.outer_grouped_grid_reduction_largest_smem_size = std::max(
+          summary_.outer_grouped_grid_reduction_largest_smem_size,
+          grid_reduction->getSmemBufferSize(tidx, tidy, 1));
+    }
   }
 
   void handle(GroupedGridWelford* grid_welford) final {
@@ -303,6 +324,8 @@ void Kernel::finalize(std::vector<Expr*> top_level_exprs) {
   // Make sure this is after analyze as it sets summary_
   summary_.vectorized_accesses = GpuLower::current()->vectorizedAccesses();
   summary_.vectorized_set_info = GpuLower::current()->vectorizedSetInfo();
+  summary_.packed_smem = GpuLower::current()->packedSmemInfo();
+  summary_.register_pressure = GpuLower::current()->registerPressure();
   summary_.sync_map = GpuLower::current()->syncMap();
   summary_.parallel_dimension_map_ =
       GpuLower::current()->parallelDimensionMap();
@@ -416,6 +439,70 @@ std::array<int, 2> KernelPerformanceProfile::getIndicesInProfileBuffer(
   return {cycle_index, count_index};
 }
 
+int KernelPerformanceProfile::getIndexInTimelineBuffer(
+    const Expr* expr) const {
+  TORCH_INTERNAL_ASSERT(
+      isProfiled(expr), "Not a profiled expression: ", expr->toString());
+  return getIndex(expr).value();
+}
+
+void KernelPerformanceProfile::recordTimeline(
+    const at::Tensor& timeline,
+    const std::string& kernel_name,
+    int device) const {
+  if (!timeline.defined()) {
+    return;
+  }
+
+  const auto host_timeline = timeline.cpu();
+  const auto records = host_timeline.accessor<int64_t, 3>();
+  const int64_t num_blocks = host_timeline.size(1);
+
+  // Blocks that didn't run a region, e.g., because of a predicate, leave
+  // their record zero
+  auto is_recorded = [&](int64_t entry, int64_t block) {
+    return records[entry][block][0] != 0 &&
+        records[entry][block][1] >= records[entry][block][0];
+  };
+
+  // The global timer of the device has no relation to the clock of the
+  // host, so the timeline is placed to end when it is read back
+  int64_t first_begin = std::numeric_limits<int64_t>::max();
+  int64_t last_end = std::numeric_limits<int64_t>::min();
+  for (const auto& kv : expr_entry_map_) {
+    for (const auto block : c10::irange(num_blocks)) {
+      if (is_recorded(kv.second, block)) {
+        first_begin = std::min(first_begin, records[kv.second][block][0]);
+        last_end = std::max(last_end, records[kv.second][block][1]);
+      }
+    }
+  }
+  if (first_begin > last_end) {
+    return;
+  }
+  const auto kernel_begin = inst::Trace::Clock::now() -
+      std::chrono::nanoseconds(last_end - first_begin);
+
+  for (const auto& kv : expr_entry_map_) {
+    auto expr = kv.first;
+    auto index = kv.second;
+    const auto name = kernel_name + " " + expr->getOpString() + " T" +
+        std::to_string(ir_utils::getTvOutput(expr)->name());
+    for (const auto block : c10::irange(num_blocks)) {
+      if (!is_recorded(index, block)) {
+        continue;
+      }
+      const auto& record = records[index][block];
+      inst::Trace::instance()->deviceEvent(
+          name,
+          device,
+          (int)record[2],
+          kernel_begin + std::chrono::nanoseconds(record[0] - first_begin),
+          kernel_begin + std::chrono::nanoseconds(record[1] - first_begin));
+    }
+  }
+}
+
 std::string KernelPerformanceProfile::toString(const at::Tensor& buffer) const {
   std::stringstream ss;
   ss << "Kernel performance profile:\n";
@@ -26,6 +26,16 @@
 namespace nvfuser {
 namespace kir {
 
+//! Shared memory buffers placed at fixed offsets of one packed region, see
+//! Note [ Shared memory offset packing ]
+struct PackedSmemInfo {
+  //! Byte offset of each packed buffer from the start of the region
+  std::unordered_map<const kir::Allocate*, int64_t> offsets;
+
+  //! Size in bytes of the packed region
+  int64_t size = 0;
+};
+
 //! Summary of interesting facts about the kernel
 // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init)
 struct KernelSummary {
@@ -41,6 +51,13 @@ struct KernelSummary {
   //! List of static shared memory buffers
   std::vector<const kir::Allocate*> static_smem_allocations;
 
+  //! Dynamic shared memory buffers with offsets assigned at lowering
+  PackedSmemInfo packed_smem;
+
+  //! Estimated 32-bit registers per thread held by the local buffers live at
+  //! the same time, see Note [ Register pressure estimate ]
+  int64_t register_pressure = 0;
+
   //! Indicate the need to generate random numbers
   int max_rng_offsets = -1;
 
@@ -75,6 +92,12 @@ struct KernelSummary {
   //! Largest shared memory buffer size of outer grouped grid welford
   int outer_grouped_grid_welford_largest_smem_size = 0;
 
+  //! Do we have any outer grouped grid reduction op?
+  bool has_outer_grouped_grid_reduction = false;
+
+  //! Largest shared memory buffer size of outer grouped grid reduction
+  int outer_grouped_grid_reduction_largest_smem_size = 0;
+
   //! Largest shared memory buffer base type
   DataType largest_smem_data_type = DataType::Null;
 
@@ -134,8 +157,29 @@ class TORCH_CUDA_CU_API KernelPerformanceProfile {
   //! Get the indices of the profile of an expression in the backing buffer
   std::array<int, 2> getIndicesInProfileBuffer(const Expr* expr) const;
 
+  //! Set the backing buffer of the timeline of the blocks, see
+  //! Note [ Kernel profile timeline ]
+  void setTimelineBuffer(TensorView* buffer) {
+    timeline_buffer_ = buffer;
+  }
+
+  //! Get the backing buffer of the timeline, nullptr unless requested
+  TensorView* getTimelineBuffer() const {
+    return timeline_buffer_;
+  }
+
+  //! Get the index of the timeline of an expression in the timeline buffer
+  int getIndexInTimelineBuffer(const Expr* expr) const;
+
   std::string toString(const at::Tensor& buffer) const;
 
+  //! Emit the timeline of the blocks of a run of the kernel to the
+  //! PYTORCH_NVFUSER_TRACE trace
+  void recordTimeline(
+      const at::Tensor& timeline,
+      const std::string& kernel_name,
+      int device) const;
+
  private:
   //! Get the new profile index
   int getNewIndex();
@@ -151,6 +195,11 @@ class TORCH_CUDA_CU_API KernelPerformanceProfile {
   //! the cycles spent, and another the count.
   TensorView* buffer_ = nullptr;
 
+  //! Backing buffer of NxBx3 integer tensor, where N is the number of
+  //! profiled regions and B the number of blocks. Each block records when it
+  //! entered and left a region, and on which SM.
+  TensorView* timeline_buffer_ = nullptr;
+
   //! Map profiled expressions to profile entry offsets
   std::unordered_map<const Expr*, int> expr_entry_map_;
 
@@ -7,107 +7,277 @@
 // clang-format on
 #include <kernel_cache.h>
 
+#include <compute_at_map.h>
 #include <executor_params.h>
+#include <executor_utils.h>
+#include <fusion_interpreter.h>
 #include <instrumentation.h>
+#include <ir_builder.h>
 #include <ir_utils.h>
+#include <kernel_db/kernel_db.h>
+#include <kernel_db/utils.h>
+#include <lower_validation.h>
+#include <ops/arith.h>
 #include <parser.h>
 #include <scheduler/debug_utils.h>
 #include <scheduler/registry.h>
+#include <scheduler/utils.h>
 #include <torch/csrc/jit/jit_log.h>
 #include <torch/csrc/jit/runtime/graph_executor.h>
 
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/CUDAEvent.h>
 #include <c10/core/thread_pool.h>
 #include <c10/cuda/CUDAGuard.h>
 #include <c10/util/irange.h>
 #include <torch/csrc/jit/jit_log.h>
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <cstdlib>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <sstream>
+
 namespace nvfuser {
 
 namespace {
 
+// Default size of the compilation thread pool, can be overwritten by the
+// environment variable PYTORCH_NVFUSER_NUM_COMPILE_THREADS
 #define THREAD_POOL_SIZE 10
 
-// TODO: clean this up with some knobs
+int getThreadPoolSize() {
+  if (auto env_size = getenv("PYTORCH_NVFUSER_NUM_COMPILE_THREADS")) {
+    auto pool_size = std::atoi(env_size);
+    TORCH_CHECK(
+        pool_size > 0,
+        "Invalid number of threads specified by PYTORCH_NVFUSER_NUM_COMPILE_THREADS: ",
+        env_size);
+    return pool_size;
+  }
+  return THREAD_POOL_SIZE;
+}
+
 c10::ThreadPool* getThreadPool() {
-  static c10::ThreadPool pool(THREAD_POOL_SIZE);
+  static c10::ThreadPool pool(getThreadPoolSize());
   return &pool;
 }
 
-void encodeBuffer(size_t value, std::string& buffer) {
-  const char* v = reinterpret_cast<char*>(&value);
-  for (const auto i : c10::irange(sizeof(size_t))) {
+//! Runs `fn(i)` for each i in [0, n) concurrently on the thread pool and
+//! returns once all of them are done. The calling thread participates in the
+//! work, so this doesn't deadlock when called from a task that is itself
+//! running on the pool. The first exception thrown by `fn` is rethrown.
+void parallelFor(size_t n, std::function<void(size_t)> fn) {
+  struct State {
+    std::function<void(size_t)> fn;
+    size_t n = 0;
+    std::atomic<size_t> next{0};
+    std::mutex mutex;
+    std::condition_variable done_cv;
+    size_t num_done = 0;
+    std::exception_ptr error = nullptr;
+  };
+  auto state = std::make_shared<State>();
+  state->fn = std::move(fn);
+  state->n = n;
+
+  // Helpers that start after all work items are claimed return immediately,
+  // without touching anything but the shared state
+  auto work = [state]() {
+    for (size_t i = state->next++; i < state->n; i = state->next++) {
+      std::exception_ptr error = nullptr;
+      try {
+        state->fn(i);
+      } catch (...) {
+        error = std::current_exception();
+      }
+      std::lock_guard<std::mutex> guard(state->mutex);
+      if (error && !state->error) {
+        state->error = error;
+      }
+      if (++state->num_done == state->n) {
+        state->done_cv.notify_all();
+      }
+    }
+  };
+
+  const auto num_helpers =
+      std::min(n, getThreadPool()->size()) - (n > 0 ? 1 : 0);
+  for (const auto i : c10::irange(num_helpers)) {
     (void)i; // Suppress unused variable warning
-    buffer.push_back(*(v++));
+    getThreadPool()->run(work);
   }
-}
+  work();
 
-} // namespace
+  std::unique_lock<std::mutex> lock(state->mutex);
+  state->done_cv.wait(lock, [&state]() { return state->num_done == state->n; });
+  if (state->error) {
+    std::rethrow_exception(state->error);
+  }
+}
 
-InputsIdLookup::IdLookupReturn InputsIdLookup::lookupId(
-    const at::ArrayRef<c10::IValue>& inputs) {
-  IdLookupReturn ret;
+// Tags separating the different kinds of inputs in an encoded input set
+constexpr int64_t kTensorInputTag = -1;
+constexpr int64_t kScalarInputTag = -2;
 
-  // lock mutex_ because we are touching encoding_
-  std::lock_guard<std::mutex> guard(mutex_);
-  encoding_.clear();
+//! Walks the meta information of `inputs` that identifies an input set, and
+//! calls `fn` on each encoded word. This is the single source of truth for
+//! both the signature and the packed key of `InputsIdLookup`.
+template <typename Fn>
+void forEachEncodedWord(const at::ArrayRef<c10::IValue>& inputs, Fn&& fn) {
   for (const auto& input : inputs) {
     if (input.isTensor()) {
-      auto& input_tensor = input.toTensor();
-
+      const auto& input_tensor = input.toTensor();
+      fn(kTensorInputTag);
+      fn((int64_t)input_tensor.dim());
       for (auto size : input_tensor.sizes()) {
-        encodeBuffer(size, encoding_);
-        encoding_.push_back(' ');
+        fn(size);
       }
-      encoding_.push_back('X');
-      encoding_.push_back(' ');
       for (auto stride : input_tensor.strides()) {
-        encodeBuffer(stride, encoding_);
-        encoding_.push_back(' ');
-      }
-      encoding_.push_back('a');
-      encodeBuffer(
-          SchedulerRuntimeInfo::computeAlignmentSize(
-              (size_t)input_tensor.data_ptr()),
-          encoding_);
-      encoding_.push_back('d');
-      encodeBuffer(input_tensor.device().index(), encoding_);
+        fn(stride);
+      }
+      fn((int64_t)SchedulerRuntimeInfo::computeAlignmentSize(
+          (size_t)input_tensor.data_ptr()));
+      fn((int64_t)input_tensor.device().index());
     } else {
       // encode s for scalar;
-      encoding_.push_back('s');
+      fn(kScalarInputTag);
     }
-    encoding_.push_back(';');
   }
+}
 
-  auto& entry = encoding_lookup_[encoding_];
+//! 64-bit finalizer from splitmix64, used to diffuse each encoded word before
+//! it is folded into the signature
+inline uint64_t mixWord(uint64_t x) {
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebULL;
+  x ^= x >> 31;
+  return x;
+}
 
-  if (entry.id == 0) {
-    // no entry existed for given input set, set id for given entry
-    entry.id = current_id_++;
-    if (used_entry_.size() == max_cache_size_) {
-      // pop least recently used cache;
-      const auto& remove_iter = encoding_lookup_.find(used_entry_.back());
-      used_entry_.pop_back();
-      ret.evict_id = remove_iter->second.id;
-      ret.eviction = true;
-      encoding_lookup_.erase(remove_iter);
-    }
-  } else {
-    // short-cut to leave LRU entry as is
-    if (entry.lru_iter == used_entry_.begin()) {
+InputsIdLookup::Signature computeSignature(
+    const at::ArrayRef<c10::IValue>& inputs) {
+  // Two lanes seeded and combined differently, so that the lanes are
+  // independent enough to make the 128-bit signature collision resistant
+  InputsIdLookup::Signature sig{0x243f6a8885a308d3ULL, 0x13198a2e03707344ULL};
+  forEachEncodedWord(inputs, [&sig](int64_t word) {
+    const auto w = mixWord((uint64_t)word);
+    sig.lo = (sig.lo ^ w) * 0x100000001b3ULL;
+    sig.hi = ((sig.hi << 29) | (sig.hi >> 35)) + (w ^ 0x9e3779b97f4a7c15ULL);
+  });
+  sig.lo = mixWord(sig.lo);
+  sig.hi = mixWord(sig.hi ^ sig.lo);
+  return sig;
+}
+
+//! Compare the meta information of `inputs` against a packed key produced by
+//! `forEachEncodedWord`, without materializing the encoding of `inputs`
+bool matchesPackedKey(
+    const at::ArrayRef<c10::IValue>& inputs,
+    const std::vector<int64_t>& packed_key) {
+  size_t pos = 0;
+  bool match = true;
+  forEachEncodedWord(inputs, [&](int64_t word) {
+    match = match && pos < packed_key.size() && packed_key[pos] == word;
+    ++pos;
+  });
+  return match && pos == packed_key.size();
+}
+
+} // namespace
+
+InputsIdLookup::InputsIdLookup(size_t max_cache_size, size_t num_shards)
+    : max_cache_size_(max_cache_size) {
+  TORCH_INTERNAL_ASSERT(
+      num_shards > 0 && max_cache_size >= num_shards,
+      "InputsIdLookup needs at least one entry per shard, but got cache size ",
+      max_cache_size,
+      " with ",
+      num_shards,
+      " shards");
+  shards_.reserve(num_shards);
+  for (const auto i : c10::irange(num_shards)) {
+    (void)i; // Suppress unused variable warning
+    shards_.emplace_back(std::make_unique<Shard>());
+  }
+}
+
+size_t InputsIdLookup::size() const {
+  size_t total = 0;
+  for (const auto& shard : shards_) {
+    std::lock_guard<std::mutex> guard(shard->mutex);
+    total += shard->encoding_lookup.size();
+  }
+  return total;
+}
+
+InputsIdLookup::IdLookupReturn InputsIdLookup::lookupId(
+    const at::ArrayRef<c10::IValue>& inputs) {
+  IdLookupReturn ret;
+
+  const auto sig = computeSignature(inputs);
+  // pick the shard with the high lane, the low lane drives the bucket
+  // selection within the shard
+  auto& shard = *shards_[sig.hi % shards_.size()];
+
+  // lock mutex because we are touching the LRU of the shard
+  std::lock_guard<std::mutex> guard(shard.mutex);
+
+  auto entry_it = shard.encoding_lookup.find(sig);
+  if (entry_it != shard.encoding_lookup.end()) {
+    auto& entry = entry_it->second;
+    if (matchesPackedKey(inputs, entry.packed_key)) {
       ret.id = entry.id;
+      // short-cut to leave LRU entry as is; otherwise move the entry to the
+      // front, splice doesn't allocate
+      if (entry.lru_iter != shard.used_entry.begin()) {
+        shard.used_entry.splice(
+            shard.used_entry.begin(), shard.used_entry, entry.lru_iter);
+      }
       return ret;
     }
 
-    used_entry_.erase(entry.lru_iter);
+    // Signature collision with a different input set. Replace the stale
+    // entry, which is reported as an eviction so the nested caches drop it.
+    ret.evict_id = entry.id;
+    ret.eviction = true;
+    shard.used_entry.erase(entry.lru_iter);
+    shard.encoding_lookup.erase(entry_it);
+  } else if (
+      num_entries_.load() >= max_cache_size_ && !shard.used_entry.empty()) {
+    // pop least recently used cache of the shard;
+    const auto& remove_iter =
+        shard.encoding_lookup.find(shard.used_entry.back());
+    shard.used_entry.pop_back();
+    ret.evict_id = remove_iter->second.id;
+    ret.eviction = true;
+    shard.encoding_lookup.erase(remove_iter);
+  } else {
+    num_entries_++;
   }
 
+  // no entry existed for given input set, set id for given entry
+  auto& entry = shard.encoding_lookup[sig];
+  entry.id = current_id_++;
+  forEachEncodedWord(
+      inputs, [&entry](int64_t word) { entry.packed_key.push_back(word); });
+  entry.lru_iter = shard.used_entry.insert(shard.used_entry.begin(), sig);
+
   ret.id = entry.id;
-  entry.lru_iter = used_entry_.insert(used_entry_.begin(), encoding_);
   return ret;
 }
 
 FusionExecutorCache::FusionExecutorCache(std::unique_ptr<Fusion> fusion)
-    : fusion_(std::move(fusion)) {}
+    : fusion_(std::move(fusion)),
+      // NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers)
+      inputs_id_lookup_(/*max_cache_size=*/128, /*num_shards=*/8) {}
 
 KernelArgumentHolder FusionExecutorCache::prepareInputs(
     const at::ArrayRef<c10::IValue>& inputs) {
@@ -145,6 +315,220 @@ void FusionExecutorCache::compileFusionAsync(
   kernel_runtime->startAsyncCompile(args);
 }
 
+void FusionExecutorCache::compileFusionForInputs(
+    const std::vector<std::vector<c10::IValue>>& input_signatures) {
+  FUSER_PERF_SCOPE("FusionExecutorCache::compileFusionForInputs");
+
+  // Input ids and runtimes are looked up serially. Signatures that share a
+  // runtime are compiled once.
+  std::vector<std::vector<c10::IValue>> inputs_list;
+  std::vector<KernelArgumentHolder> args_list;
+  std::vector<FusionKernelRuntime*> kernel_runtimes;
+  inputs_list.reserve(input_signatures.size());
+  const c10::Device device(c10::DeviceType::CUDA, at::cuda::current_device());
+  for (const auto& signature : input_signatures) {
+    std::vector<c10::IValue> inputs;
+    inputs.reserve(signature.size());
+    for (const auto& input : signature) {
+      if (input.isTensor() && input.toTensor().is_meta()) {
+        const auto& meta_tensor = input.toTensor();
+        inputs.emplace_back(at::empty_strided(
+            meta_tensor.sizes(),
+            meta_tensor.strides(),
+            meta_tensor.options().device(device)));
+      } else {
+        inputs.push_back(input);
+      }
+    }
+    // The arguments refer to the data of materialized tensors
+    inputs_list.push_back(std::move(inputs));
+
+    KernelArgumentHolder args = prepareInputs(inputs_list.back());
+    auto kernel_runtime = getKernelRuntimeFor(args);
+    if (std::find(
+            kernel_runtimes.begin(), kernel_runtimes.end(), kernel_runtime) ==
+        kernel_runtimes.end()) {
+      kernel_runtimes.push_back(kernel_runtime);
+      args_list.push_back(std::move(args));
+    }
+  }
+
+  parallelFor(kernel_runtimes.size(), [&](size_t i) {
+    c10::cuda::CUDAGuard dg(args_list[i].getDeviceIndex());
+    kernel_runtimes[i]->compileFusion(args_list[i]);
+  });
+}
+
+// Note [ Meta execution ]
+//
+// Memory planners and graph compilers want to know the outputs of a fusion
+// before running it, possibly on hosts without a GPU. planFusionWithInputs
+// evaluates the extents of the outputs of the unsegmented fusion from the
+// sizes of the tensor inputs and the values of the scalar inputs on the CPU,
+// so tensor inputs may be on the meta device. The outputs are returned as
+// meta tensors with the strides the executors allocate them with, after the
+// same permutations and without the aliased outputs, like the outputs of
+// runFusionWithInputs. Nothing is allocated for them.
+//
+// Segmentation and heuristics depend on the properties of the device, so
+// they are only picked if a CUDA device is available. The kernel runtime is
+// then looked up as by runFusionWithInputs and cached, so later runs with
+// inputs of the same signature skip segmentation and heuristics. As in
+// compileFusionForInputs, meta inputs are materialized uninitialized on the
+// current device for the lookup, as the heuristics depend on the alignment
+// of the data. No kernel is compiled or launched.
+
+namespace {
+
+// Binds the extents of the tensor inputs and the scalar inputs of `fusion`
+void bindMetaInputs(
+    Fusion* fusion,
+    const at::ArrayRef<c10::IValue>& inputs,
+    ExpressionEvaluator& expr_eval) {
+  TORCH_CHECK(
+      fusion->inputs().size() == inputs.size(),
+      "Expected ",
+      fusion->inputs().size(),
+      " inputs but got ",
+      inputs.size());
+  for (const auto i : c10::irange(inputs.size())) {
+    auto fusion_input = fusion->inputs()[i];
+    const auto& input = inputs[i];
+    if (auto tv = dynamic_cast<TensorView*>(fusion_input)) {
+      TORCH_CHECK(input.isTensor(), "Expected a tensor for input ", i);
+      const auto& tensor = input.toTensor();
+      const auto root_domain =
+          TensorDomain::noReductions(tv->getMaybeRFactorDomain());
+      TORCH_CHECK(
+          tensor.dim() == (int64_t)root_domain.size(),
+          "Expected a tensor of rank ",
+          root_domain.size(),
+          " for input ",
+          i,
+          " but got ",
+          tensor.dim());
+      for (const auto dim : c10::irange(root_domain.size())) {
+        auto id = root_domain[dim];
+        const auto size = tensor.size((int64_t)dim);
+        auto bind = [&expr_eval](Val* extent, int64_t value) {
+          auto prev_value = expr_eval.evaluate(extent);
+          if (!prev_value.has_value()) {
+            expr_eval.bind(extent, value);
+            return;
+          }
+          TORCH_CHECK(
+              *prev_value == value,
+              "Attempting to bind ",
+              extent->toString(),
+              " to ",
+              value,
+              " but it's already set to ",
+              *prev_value);
+        };
+        if (id->hasExpandedExtent()) {
+          bind(id->expandedExtent(), size);
+          bind(id->extent(), 1);
+        } else {
+          bind(id->extent(), size);
+        }
+      }
+    } else if (fusion_input->isA<Int>()) {
+      expr_eval.bind(fusion_input, input.toInt());
+    } else if (fusion_input->isA<Bool>()) {
+      expr_eval.bind(fusion_input, input.toBool());
+    } else if (fusion_input->isA<Double>()) {
+      expr_eval.bind(fusion_input, input.toDouble());
+    }
+  }
+}
+
+} // namespace
+
+MetaExecution FusionExecutorCache::planFusionWithInputs(
+    const at::ArrayRef<c10::IValue>& inputs) {
+  FUSER_PERF_SCOPE("FusionExecutorCache::planFusionWithInputs");
+
+  std::vector<c10::IValue> inputs_vec;
+  at::ArrayRef<c10::IValue> perm_inputs = permuteInputs(inputs, inputs_vec);
+
+  ExpressionEvaluator expr_eval;
+  bindMetaInputs(fusion_.get(), perm_inputs, expr_eval);
+
+  MetaExecution meta_execution;
+  for (auto output : fusion_->outputs()) {
+    auto tv = dynamic_cast<TensorView*>(output);
+    TORCH_CHECK(
+        tv != nullptr,
+        "Meta execution only supports tensor outputs, but got ",
+        output->toString());
+    const auto root_domain =
+        TensorDomain::noReductions(tv->getMaybeRFactorDomain());
+    std::vector<int64_t> sizes(root_domain.size());
+    std::vector<int64_t> strides(root_domain.size());
+    int64_t stride = 1;
+    for (int64_t dim = (int64_t)root_domain.size() - 1; dim >= 0; --dim) {
+      auto id = root_domain[dim];
+      auto size = expr_eval.evaluate(id->getMaybeExpandedExtent());
+      TORCH_CHECK(
+          size.has_value(),
+          "Could not infer the extent ",
+          id->getMaybeExpandedExtent()->toString(),
+          " of output ",
+          tv->toString());
+      sizes[dim] = size->as<int64_t>();
+      // Expanded domains are broadcast in memory
+      strides[dim] = id->hasExpandedExtent() ? 0 : stride;
+      if (!id->hasExpandedExtent()) {
+        stride *= sizes[dim];
+      }
+    }
+    meta_execution.outputs.push_back(at::empty_strided(
+        sizes,
+        strides,
+        at::TensorOptions()
+            .dtype(data_type_to_aten(tv->getDataType().value()))
+            .device(c10::DeviceType::Meta)));
+  }
+
+  // Same as the outputs of runKernelRuntime
+  for (const auto& pair : fusion_->getPermutationOutputMap()) {
+    if (size_t(pair.first) < meta_execution.outputs.size()) {
+      meta_execution.outputs[pair.first] =
+          meta_execution.outputs[pair.first].permute(pair.second);
+    }
+  }
+  const auto& indices = fusion_->getOutputAliasIndices();
+  std::set<int> aliased_output_indices(indices.begin(), indices.end());
+  int offset = 0;
+  for (const auto& v : aliased_output_indices) {
+    meta_execution.outputs.erase(
+        meta_execution.outputs.begin() + v - offset);
+    offset++;
+  }
+
+  if (!at::cuda::is_available()) {
+    return meta_execution;
+  }
+
+  const c10::Device device(c10::DeviceType::CUDA, at::cuda::current_device());
+  std::vector<c10::IValue> device_inputs;
+  device_inputs.reserve(perm_inputs.size());
+  for (const auto& input : perm_inputs) {
+    if (input.isTensor() && input.toTensor().is_meta()) {
+      const auto& meta_tensor = input.toTensor();
+      device_inputs.emplace_back(at::empty_strided(
+          meta_tensor.sizes(),
+          meta_tensor.strides(),
+          meta_tensor.options().device(device)));
+    } else {
+      device_inputs.push_back(input);
+    }
+  }
+  KernelArgumentHolder args = prepareInputs(device_inputs);
+  meta_execution.kernel_runtime = getKernelRuntimeFor(args);
+  return meta_execution;
+}
+
 // Note [ Permutation support in nvfuser ]
 //
 // Background:
@@ -173,30 +557,582 @@ void FusionExecutorCache::compileFusionAsync(
 // For details  on Part_2, refer to implementation Note [ Permutation
 // Bookkeeping and Propagation in Parser ]
 std::vector<at::Tensor> FusionExecutorCache::runFusionWithInputs(
-    const at::ArrayRef<c10::IValue>& inputs) {
+    const at::ArrayRef<c10::IValue>& inputs,
+    const std::vector<at::Tensor>& outputs) {
   FUSER_PERF_SCOPE("FusionExecutorCache::runFusionWithInputs");
+  inst::RunLatencyScope run_latency_scope;
+
+  checkPreallocatedOutputs(outputs);
 
-  // permute input tensor for kernel execution. See Part_1 in Note [ Channels
-  // Last support in nvfuser ]
-  at::ArrayRef<c10::IValue> perm_inputs = inputs;
-  const auto& to_be_permuted_inputs = fusion_->getPermutationInputMap();
   std::vector<c10::IValue> inputs_vec;
-  if (!to_be_permuted_inputs.empty()) {
-    inputs_vec = inputs.vec();
-    for (const auto& pair : to_be_permuted_inputs) {
-      auto v = inputs_vec[pair.first];
+  at::ArrayRef<c10::IValue> perm_inputs = permuteInputs(inputs, inputs_vec);
+
+  KernelArgumentHolder args = prepareInputs(perm_inputs);
+
+  if (args.getIndexMode() == KernelIndexMode::INT64 && outputs.empty() &&
+      !isOptionDisabled(DisableOption::Int32Chunks)) {
+    auto chunked_outputs = runInChunks(perm_inputs, args);
+    if (chunked_outputs.has_value()) {
+      return std::move(chunked_outputs.value());
+    }
+  }
+
+  auto kernel_runtime = getKernelRuntimeFor(args);
+  if (eager_fallback_ && outputs.empty() && canRunEagerly() &&
+      !kernel_runtime->compileInBackground(args)) {
+    num_eager_runs_.fetch_add(1, std::memory_order_relaxed);
+    return interpretFusion(fusion_.get(), inputs);
+  }
+  return runKernelRuntime(kernel_runtime, inputs, perm_inputs, args, outputs);
+}
+
+// Note [ Eager fallback ]
+//
+// The first run of a new input set blocks until its kernels are scheduled,
+// lowered and compiled, which can take hundreds of milliseconds. With
+// setEagerFallback, the kernel runtime of an input set that isn't compiled
+// yet is instead compiled on the compilation thread pool, and the run
+// computes the outputs with an ATen op per expression of the unscheduled
+// fusion, see interpretFusion. Runs switch to the kernels once the
+// compilation is done. Segmentation and heuristics still run on the calling
+// thread, as they pick the kernel runtime to compile.
+//
+// Only fusions of the pointwise ops, broadcasts, squeezes and simple
+// reductions interpretFusion supports fall back, and only without permuted
+// or aliased inputs and outputs nor preallocated outputs: the interpreter
+// runs on the fusion as given. Other fusions, and input sets that need
+// 32-bit indexed chunks, wait for their kernels as usual. A failed
+// background compilation is not retried in the background; the next run
+// compiles synchronously and raises its error.
+
+bool FusionExecutorCache::canRunEagerly() {
+  std::call_once(eager_flag_, [this]() {
+    Fusion* fusion = fusion_.get();
+    eager_ = fusion->getPermutationInputMap().empty() &&
+        fusion->getPermutationOutputMap().empty() &&
+        fusion->getOutputAliasIndices().empty() &&
+        fusion->getConcatOutputSlices().empty() && canInterpretFusion(fusion);
+  });
+  return eager_;
+}
+
+// Note [ 32-bit indexed chunks ]
+//
+// A single tensor argument with more elements than collectIndexMode allows
+// for 32-bit indices makes every index of the kernel 64-bit, which slows down
+// the integer math of the whole kernel. Whenever the rows of the outermost
+// dimension of a fusion are computed independently of each other, the
+// fusion is instead run for chunks of rows, each as a regular run of its own
+// with the inputs narrowed to the rows of the chunk and the outputs written
+// to the rows of preallocated full outputs. The chunks are sized so that
+// they need 32-bit indices only, and are a multiple of 16 rows, so that all
+// but the last chunk have the same sizes and alignment and share a kernel
+// runtime.
+//
+// The rows are independent if the fusion only has pointwise ops, broadcasts
+// and reductions, none of which reduces the outermost dimension, which is
+// the outermost dimension of all outputs and, exactly mapped to it, the
+// outermost dimension of all inputs that have it at all. Inputs without it,
+// e.g. a broadcast bias, are passed whole to every chunk. Outputs of
+// segmented fusions can't be preallocated, so the chunks of such fusions are
+// copied to the full outputs instead.
+
+bool FusionExecutorCache::canRunInChunks() {
+  std::call_once(chunkable_flag_, [this]() {
+    Fusion* fusion = fusion_.get();
+    if (!fusion->getPermutationInputMap().empty() ||
+        !fusion->getPermutationOutputMap().empty() ||
+        !fusion->getOutputAliasIndices().empty() ||
+        !fusion->getConcatOutputSlices().empty()) {
+      return;
+    }
+    for (auto expr : fusion->exprs()) {
+      if (!expr->isOneOf<
+              UnaryOp,
+              BinaryOp,
+              TernaryOp,
+              BroadcastOp,
+              ReductionOp,
+              WelfordOp,
+              LoadStoreOp>()) {
+        return;
+      }
+    }
+
+    ComputeAtMap ca_map(fusion);
+    IterDomain* row_id = nullptr;
+    for (auto out : fusion->outputs()) {
+      auto out_tv = dynamic_cast<TensorView*>(out);
+      if (out_tv == nullptr || out_tv->dtype() == DataType::Index) {
+        return;
+      }
+      auto domain =
+          TensorDomain::noReductions(out_tv->getMaybeRFactorDomain());
+      if (domain.empty() || !domain.front()->isIteration() ||
+          std::any_of(domain.begin(), domain.end(), [](IterDomain* id) {
+            return id->hasExpandedExtent();
+          })) {
+        return;
+      }
+      if (row_id == nullptr) {
+        row_id = domain.front();
+      } else if (!ca_map.areMapped(
+                     row_id, domain.front(), IdMappingMode::EXACT)) {
+        return;
+      }
+    }
+    if (row_id == nullptr) {
+      return;
+    }
+
+    // Inputs have the rows as their outermost dimension or not at all
+    std::vector<bool> input_has_rows;
+    for (auto in : fusion->inputs()) {
+      auto in_tv = dynamic_cast<TensorView*>(in);
+      const auto& domain = in_tv == nullptr ? std::vector<IterDomain*>()
+                                            : in_tv->getMaybeRFactorDomain();
+      input_has_rows.push_back(
+          !domain.empty() &&
+          ca_map.areMapped(row_id, domain.front(), IdMappingMode::EXACT));
+      for (const auto i : c10::irange(1, domain.size())) {
+        if (ca_map.areMapped(row_id, domain.at(i), IdMappingMode::EXACT)) {
+          return;
+        }
+      }
+    }
+
+    // Nothing reduces the rows
+    for (auto tv : ir_utils::allTvs(fusion)) {
+      for (auto id : tv->getMaybeRFactorDomain()) {
+        if (id->isReduction() &&
+            ca_map.areMapped(row_id, id, IdMappingMode::EXACT)) {
+          return;
+        }
+      }
+    }
+
+    input_has_rows_ = std::move(input_has_rows);
+    chunkable_ = true;
+  });
+  return chunkable_;
+}
+
+namespace {
+
+// Number of leading rows of tensor whose elements collectIndexMode accepts
+// for 32-bit indexing, 0 if there are none
+int64_t rowsIndexableBy32Bits(const at::Tensor& tensor) {
+  constexpr int64_t most_positive_int32_index =
+      std::numeric_limits<int>::max() / 2;
+  int64_t row_most_positive_index = 0;
+  for (const auto dim : c10::irange(1, tensor.dim())) {
+    if (tensor.size(dim) <= 1) {
+      continue;
+    }
+    if (tensor.stride(dim) < 0) {
+      return 0;
+    }
+    row_most_positive_index += (tensor.size(dim) - 1) * tensor.stride(dim);
+  }
+  if (row_most_positive_index > most_positive_int32_index ||
+      tensor.stride(0) < 0) {
+    return 0;
+  }
+  if (tensor.stride(0) == 0) {
+    return tensor.size(0);
+  }
+  return (most_positive_int32_index - row_most_positive_index) /
+      tensor.stride(0) +
+      1;
+}
+
+} // namespace
+
+c10::optional<std::vector<at::Tensor>> FusionExecutorCache::runInChunks(
+    const at::ArrayRef<c10::IValue>& inputs,
+    const KernelArgumentHolder& args) {
+  if (!canRunInChunks()) {
+    return c10::nullopt;
+  }
+  FUSER_PERF_SCOPE("FusionExecutorCache::runInChunks");
+
+  const auto& has_rows = input_has_rows_;
+
+  // Full outputs, allocated contiguous like the ones of the kernels
+  auto expr_eval = executor_utils::bindInputs(args, fusion_.get());
+  const auto options =
+      at::TensorOptions().device(at::kCUDA, args.getDeviceIndex());
+  std::vector<at::Tensor> outputs;
+  for (auto out : fusion_->outputs()) {
+    auto out_tv = out->as<TensorView>();
+    std::vector<int64_t> sizes;
+    for (auto id :
+         TensorDomain::noReductions(out_tv->getMaybeRFactorDomain())) {
+      auto extent = expr_eval.evaluate(id->extent());
+      if (!extent.has_value()) {
+        return c10::nullopt;
+      }
+      sizes.push_back(extent->as<int64_t>());
+    }
+    const auto dtype = data_type_to_aten(out_tv->getDataType().value());
+    outputs.push_back(at::empty(sizes, options.dtype(dtype)));
+  }
+
+  const int64_t num_rows = outputs.front().size(0);
+  int64_t chunk_rows = num_rows;
+  for (const auto i : c10::irange(inputs.size())) {
+    if (has_rows.at(i)) {
+      const auto& tensor = inputs.at(i).toTensor();
+      if (tensor.size(0) != num_rows) {
+        return c10::nullopt;
+      }
+      chunk_rows = std::min(chunk_rows, rowsIndexableBy32Bits(tensor));
+    } else if (collectIndexMode({inputs.at(i)}) == KernelIndexMode::INT64) {
+      // Inputs passed whole need 32-bit indices by themselves
+      return c10::nullopt;
+    }
+  }
+  for (const auto& output : outputs) {
+    chunk_rows = std::min(chunk_rows, rowsIndexableBy32Bits(output));
+  }
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers)
+  constexpr int64_t row_alignment = 16;
+  if (chunk_rows > row_alignment) {
+    chunk_rows -= chunk_rows % row_alignment;
+  }
+  if (chunk_rows < 1 || chunk_rows >= num_rows) {
+    return c10::nullopt;
+  }
+
+  for (int64_t start = 0; start < num_rows; start += chunk_rows) {
+    const auto rows = std::min(chunk_rows, num_rows - start);
+    std::vector<c10::IValue> chunk_inputs;
+    for (const auto i : c10::irange(inputs.size())) {
+      chunk_inputs.emplace_back(
+          has_rows.at(i) ? c10::IValue(inputs.at(i).toTensor().narrow(
+                               0, start, rows))
+                         : inputs.at(i));
+    }
+    std::vector<at::Tensor> chunk_outputs;
+    for (const auto& output : outputs) {
+      chunk_outputs.push_back(output.narrow(0, start, rows));
+    }
+
+    KernelArgumentHolder chunk_args = prepareInputs(chunk_inputs);
+    TORCH_INTERNAL_ASSERT(
+        chunk_args.getIndexMode() == KernelIndexMode::INT32,
+        "Chunk of ",
+        rows,
+        " rows still needs 64-bit indexing");
+    auto kernel_runtime = getKernelRuntimeFor(chunk_args);
+    if (!kernel_runtime->isSegmented()) {
+      runKernelRuntime(
+          kernel_runtime,
+          chunk_inputs,
+          chunk_inputs,
+          chunk_args,
+          chunk_outputs);
+      continue;
+    }
+    auto results = runKernelRuntime(
+        kernel_runtime, chunk_inputs, chunk_inputs, chunk_args, {});
+    for (const auto i : c10::irange(outputs.size())) {
+      chunk_outputs.at(i).copy_(results.at(i));
+    }
+  }
+  return outputs;
+}
+
+// Note [ Streamed execution ]
+//
+// runFusionStreamed runs fusions over tensors larger than the device memory
+// like runInChunks, see Note [ 32-bit indexed chunks ], with the rows of the
+// inputs and outputs living on the host. The chunks of the inputs that have
+// rows are copied to one of two sets of device buffers on a copy stream,
+// each chunk as soon as the kernels of the chunk that last used its buffers
+// are done, so the copy of chunk k + 1 overlaps with the kernels of chunk k
+// on the current stream. The outputs of chunk k are copied back to the
+// pinned host outputs on the copy stream, after the copy of chunk k + 1 so
+// that it isn't held up by the kernels of chunk k. Inputs without rows are
+// copied to the device once.
+//
+// Copies from pageable host memory are staged by the driver and don't
+// overlap with anything, so inputs are best allocated in pinned memory. The
+// kernels of the last chunk, which is usually shorter, may be compiled
+// separately, and all chunks go through the regular kernel runtime lookup,
+// so the first run of a chunk size compiles as usual.
+
+std::vector<at::Tensor> FusionExecutorCache::runFusionStreamed(
+    const at::ArrayRef<c10::IValue>& inputs,
+    int64_t chunk_rows) {
+  FUSER_PERF_SCOPE("FusionExecutorCache::runFusionStreamed");
+  TORCH_CHECK(chunk_rows > 0, "Chunks need at least one row");
+  TORCH_CHECK(
+      canRunInChunks(),
+      "Streamed execution requires a fusion whose rows are independent, ",
+      "see Note [ Streamed execution ]");
+  TORCH_CHECK(inputs.size() == fusion_->inputs().size(), "Wrong input count");
+
+  const auto& has_rows = input_has_rows_;
+  const auto device = at::Device(at::kCUDA, at::cuda::current_device());
+  for (const auto& input : inputs) {
+    if (input.isTensor() && input.toTensor().is_cuda()) {
       TORCH_CHECK(
-          v.isTensor(), "input permutation can only be applied at tensor");
-      auto tensor = v.toTensor();
-      inputs_vec[pair.first] = tensor.permute(pair.second);
+          input.toTensor().device() == device,
+          "Streamed inputs must be on the host or the current device");
     }
-    perm_inputs = inputs_vec;
   }
 
-  KernelArgumentHolder args = prepareInputs(perm_inputs);
+  int64_t num_rows = -1;
+  std::vector<c10::IValue> device_inputs(inputs.begin(), inputs.end());
+  for (const auto i : c10::irange(inputs.size())) {
+    if (has_rows.at(i)) {
+      const auto rows = inputs.at(i).toTensor().size(0);
+      TORCH_CHECK(
+          num_rows == -1 || rows == num_rows,
+          "Streamed inputs must have the same number of rows");
+      num_rows = rows;
+    } else if (inputs.at(i).isTensor() && inputs.at(i).toTensor().dim() > 0) {
+      device_inputs.at(i) = inputs.at(i).toTensor().to(device);
+    }
+  }
+  TORCH_CHECK(num_rows > 0, "No rows to stream");
+  chunk_rows = std::min(chunk_rows, num_rows);
+
+  auto compute_stream = at::cuda::getCurrentCUDAStream();
+  auto copy_stream = at::cuda::getStreamFromPool(false, device.index());
+
+  // Double buffered device chunks of the inputs with rows
+  std::array<std::vector<at::Tensor>, 2> buffers;
+  for (auto& buffer : buffers) {
+    for (const auto i : c10::irange(inputs.size())) {
+      if (!has_rows.at(i)) {
+        buffer.emplace_back();
+        continue;
+      }
+      const auto& input = inputs.at(i).toTensor();
+      auto sizes = input.sizes().vec();
+      sizes.at(0) = chunk_rows;
+      buffer.push_back(at::empty(sizes, input.options().device(device)));
+    }
+  }
+  std::array<at::cuda::CUDAEvent, 2> copied;
+
+  auto copy_chunk_in = [&](int64_t start) {
+    const auto rows = std::min(chunk_rows, num_rows - start);
+    auto& buffer = buffers.at((start / chunk_rows) % 2);
+    c10::cuda::CUDAStreamGuard guard(copy_stream);
+    for (const auto i : c10::irange(inputs.size())) {
+      if (has_rows.at(i)) {
+        buffer.at(i).narrow(0, 0, rows).copy_(
+            inputs.at(i).toTensor().narrow(0, start, rows),
+            /*non_blocking=*/true);
+      }
+    }
+    copied.at((start / chunk_rows) % 2).record(copy_stream);
+  };
+
+  std::vector<at::Tensor> outputs;
+  copy_chunk_in(0);
+  for (int64_t start = 0; start < num_rows; start += chunk_rows) {
+    const auto rows = std::min(chunk_rows, num_rows - start);
+    const auto buffer_index = (start / chunk_rows) % 2;
+    if (start + chunk_rows < num_rows) {
+      copy_chunk_in(start + chunk_rows);
+    }
 
+    std::vector<c10::IValue> chunk_inputs;
+    for (const auto i : c10::irange(inputs.size())) {
+      chunk_inputs.emplace_back(
+          has_rows.at(i)
+              ? c10::IValue(buffers.at(buffer_index).at(i).narrow(0, 0, rows))
+              : device_inputs.at(i));
+    }
+    copied.at(buffer_index).block(compute_stream);
+    KernelArgumentHolder chunk_args = prepareInputs(chunk_inputs);
+    auto kernel_runtime = getKernelRuntimeFor(chunk_args);
+    auto results = runKernelRuntime(
+        kernel_runtime, chunk_inputs, chunk_inputs, chunk_args, {});
+
+    if (outputs.empty()) {
+      for (const auto& result : results) {
+        auto sizes = result.sizes().vec();
+        sizes.at(0) = num_rows;
+        outputs.push_back(at::empty(
+            sizes, result.options().device(at::kCPU).pinned_memory(true)));
+      }
+    }
+
+    at::cuda::CUDAEvent computed;
+    computed.record(compute_stream);
+    computed.block(copy_stream);
+    c10::cuda::CUDAStreamGuard guard(copy_stream);
+    for (const auto i : c10::irange(results.size())) {
+      // The results are freed once this iteration ends, while the copy
+      // stream still reads them
+      results.at(i).record_stream(copy_stream);
+      outputs.at(i).narrow(0, start, rows).copy_(
+          results.at(i), /*non_blocking=*/true);
+    }
+  }
+  for (auto& buffer : buffers) {
+    for (auto& tensor : buffer) {
+      if (tensor.defined()) {
+        tensor.record_stream(copy_stream);
+      }
+    }
+  }
+  copy_stream.synchronize();
+  return outputs;
+}
+
+// Note [ Bound executions ]
+//
+// Every call of runFusionWithInputs encodes the inputs to look up their id,
+// refreshes the LRU order of the id and then looks up the kernel runtime of
+// the id. Callers that run the same input signature over and over again, e.g.
+// the steps of a training loop, pay for this on every call although the
+// answer never changes.
+//
+// bind() does these lookups once and records the resolved kernel runtime and
+// input id along with the packed encoding of the inputs. BoundExecution::run
+// only compares the meta information of the inputs against the packed key,
+// which neither hashes nor locks, and goes straight to building the kernel
+// arguments and launching the kernel runtime.
+//
+// Kernel runtimes are never destroyed before their FusionExecutorCache, so
+// the bound pointer stays valid. The input id may get evicted from
+// `inputs_id_lookup_` by other input sets in the meantime, which only drops
+// the launch parameters cached for it in the executors; they are recomputed
+// on the next launch under the same id. Ids are never reused, so a bound id
+// can't alias another input set.
+BoundExecution FusionExecutorCache::bind(
+    const at::ArrayRef<c10::IValue>& inputs) {
+  FUSER_PERF_SCOPE("FusionExecutorCache::bind");
+
+  std::vector<c10::IValue> inputs_vec;
+  at::ArrayRef<c10::IValue> perm_inputs = permuteInputs(inputs, inputs_vec);
+
+  KernelArgumentHolder args = prepareInputs(perm_inputs);
   auto kernel_runtime = getKernelRuntimeFor(args);
+
+  std::vector<int64_t> packed_key;
+  forEachEncodedWord(
+      inputs, [&packed_key](int64_t word) { packed_key.push_back(word); });
+
+  return BoundExecution(
+      this, kernel_runtime, args.getCacheId().value(), std::move(packed_key));
+}
+
+BoundExecution::BoundExecution(
+    FusionExecutorCache* fec,
+    FusionKernelRuntime* kernel_runtime,
+    size_t cache_id,
+    std::vector<int64_t> packed_key)
+    : fec_(fec),
+      kernel_runtime_(kernel_runtime),
+      cache_id_(cache_id),
+      packed_key_(std::move(packed_key)) {}
+
+bool BoundExecution::matches(const at::ArrayRef<c10::IValue>& inputs) const {
+  return matchesPackedKey(inputs, packed_key_);
+}
+
+std::vector<at::Tensor> BoundExecution::run(
+    const at::ArrayRef<c10::IValue>& inputs,
+    const std::vector<at::Tensor>& outputs) const {
+  FUSER_PERF_SCOPE("BoundExecution::run");
+  TORCH_CHECK(
+      matches(inputs),
+      "Inputs don't match the signature the execution was bound to");
+  return fec_->runBound(*this, inputs, outputs);
+}
+
+std::vector<at::Tensor> FusionExecutorCache::runBound(
+    const BoundExecution& bound,
+    const at::ArrayRef<c10::IValue>& inputs,
+    const std::vector<at::Tensor>& outputs) {
+  inst::RunLatencyScope run_latency_scope;
+  checkPreallocatedOutputs(outputs);
+
+  std::vector<c10::IValue> inputs_vec;
+  at::ArrayRef<c10::IValue> perm_inputs = permuteInputs(inputs, inputs_vec);
+
+  KernelArgumentHolder args =
+      KernelArgumentHolder::createKernelArgumentHolder(perm_inputs);
+  args.setCacheId(bound.cache_id_);
+
+  return runKernelRuntime(
+      bound.kernel_runtime_, inputs, perm_inputs, args, outputs);
+}
+
+void FusionExecutorCache::checkPreallocatedOutputs(
+    const std::vector<at::Tensor>& outputs) const {
+  // Given outputs are handed to the kernel as they are, so they can't be
+  // mapped to permuted or dropped aliased outputs
+  TORCH_CHECK(
+      outputs.empty() ||
+          (fusion_->getPermutationOutputMap().empty() &&
+           fusion_->getOutputAliasIndices().empty()),
+      "Preallocated outputs are not supported for fusions with permuted or ",
+      "aliased outputs");
+}
+
+at::ArrayRef<c10::IValue> FusionExecutorCache::permuteInputs(
+    const at::ArrayRef<c10::IValue>& inputs,
+    std::vector<c10::IValue>& inputs_vec) const {
+  // permute input tensor for kernel execution. See Part_1 in Note [ Channels
+  // Last support in nvfuser ]
+  const auto& to_be_permuted_inputs = fusion_->getPermutationInputMap();
+  if (to_be_permuted_inputs.empty()) {
+    return inputs;
+  }
+  inputs_vec = inputs.vec();
+  for (const auto& pair : to_be_permuted_inputs) {
+    auto v = inputs_vec[pair.first];
+    TORCH_CHECK(
+        v.isTensor(), "input permutation can only be applied at tensor");
+    auto tensor = v.toTensor();
+    inputs_vec[pair.first] = tensor.permute(pair.second);
+  }
+  return inputs_vec;
+}
+
+// Note [ Execution policy ]
+//
+// Latency critical and throughput fusions of different tenants may share a
+// GPU, each with its own FusionExecutorCache. The ExecutionPolicy of a cache
+// controls how its kernels compete for the GPU:
+//
+// With high_priority_stream, each run is launched on a high priority stream
+// of the pool. The stream waits for the work already on the current stream
+// and the current stream waits for the run, so the run is ordered as if it
+// was launched on the current stream, and outputs are recorded on the current
+// stream for the caching allocator. The blocks of its kernels are scheduled
+// before the pending blocks of lower priority streams.
+//
+// With an sm_budget, the heuristics size grids for at most that many SMs,
+// i.e. the waves, split reductions and grid persistence the schedulers
+// derive from the SM count (see scheduler_utils::numSMs) assume the kernel
+// only gets the budget. This keeps a throughput fusion from claiming whole
+// waves of the device, but doesn't confine its blocks to a subset of the
+// SMs, which needs hardware partitioning such as MPS or green contexts that
+// ATen streams can't target. The budget is set for the lookup and creation
+// of kernel runtimes in getKernelRuntimeFor, and runtimes keep the budget
+// they were created with for segments compiled on other threads. The budget
+// is part of the heuristic arguments, see Note [ Heuristic lookup ].
+std::vector<at::Tensor> FusionExecutorCache::runKernelRuntime(
+    FusionKernelRuntime* kernel_runtime,
+    const at::ArrayRef<c10::IValue>& inputs,
+    const at::ArrayRef<c10::IValue>& perm_inputs,
+    KernelArgumentHolder& args,
+    const std::vector<at::Tensor>& outputs) {
   most_recent_runtime_ = kernel_runtime;
+  inst::RuntimeMetrics::instance()->add(
+      inst::RuntimeCounter::SegmentsRun,
+      kernel_runtime->isSegmented()
+          ? (int64_t)kernel_runtime->fusionSegments()->groups().size()
+          : 1);
   int seq_id = 0;
   // Record kernel input and output tensors so profiler can construct
   // the data flow graph
@@ -204,14 +1140,52 @@ std::vector<at::Tensor> FusionExecutorCache::runFusionWithInputs(
       "run_fused_kernel",
       std::vector<c10::IValue>(inputs.begin(), inputs.end()),
       seq_id);
-  auto outputs = kernel_runtime->runWithInput(args);
-  RECORD_OUTPUTS(outputs);
+  // Launch on a high priority stream forked from the current one, see
+  // Note [ Execution policy ]
+  c10::optional<c10::cuda::CUDAStream> caller_stream;
+  c10::optional<c10::cuda::CUDAStreamGuard> stream_guard;
+  if (execution_policy_.high_priority_stream) {
+    caller_stream = c10::cuda::getCurrentCUDAStream(args.getDeviceIndex());
+    auto priority_stream =
+        c10::cuda::getStreamFromPool(true, args.getDeviceIndex());
+    at::cuda::CUDAEvent fork_event;
+    fork_event.record(caller_stream.value());
+    fork_event.block(priority_stream);
+    stream_guard.emplace(priority_stream);
+  }
+
+  std::vector<at::Tensor> fusion_outputs;
+  c10::optional<std::vector<at::Tensor>> graph_outputs = c10::nullopt;
+  if (isOptionEnabled(EnableOption::CudaGraph) && !profiling_ &&
+      outputs.empty()) {
+    graph_outputs = runWithCudaGraph(kernel_runtime, perm_inputs, args);
+  }
+  if (graph_outputs.has_value()) {
+    fusion_outputs = std::move(graph_outputs.value());
+  } else {
+    fusion_outputs = kernel_runtime->runWithInput(args, outputs);
+  }
+  RECORD_OUTPUTS(fusion_outputs);
+
+  if (caller_stream.has_value()) {
+    at::cuda::CUDAEvent join_event;
+    join_event.record(stream_guard->current_stream());
+    join_event.block(caller_stream.value());
+    // outputs allocated on the priority stream are used on the caller's
+    for (auto& output : fusion_outputs) {
+      if (output.defined()) {
+        output.record_stream(caller_stream.value());
+      }
+    }
+    stream_guard.reset();
+  }
 
   // permute output tensor returned by kernel execution. See Part_3 in Note [
   // Permutation support in nvfuser ]
   for (const auto& pair : fusion_->getPermutationOutputMap()) {
-    if (size_t(pair.first) < outputs.size()) {
-      outputs[pair.first] = outputs[pair.first].permute(pair.second);
+    if (size_t(pair.first) < fusion_outputs.size()) {
+      fusion_outputs[pair.first] =
+          fusion_outputs[pair.first].permute(pair.second);
     }
   }
 
@@ -222,42 +1196,443 @@ std::vector<at::Tensor> FusionExecutorCache::runFusionWithInputs(
   const auto& indices = fusion_->getOutputAliasIndices();
   std::set<int> aliased_output_indices(indices.begin(), indices.end());
   for (const auto& v : aliased_output_indices) {
-    outputs.erase(outputs.begin() + v - offset);
+    fusion_outputs.erase(fusion_outputs.begin() + v - offset);
     offset++;
   }
 
-  return outputs;
+  return fusion_outputs;
+}
+
+CompiledKernelStats FusionExecutorCache::compiledKernelStats() {
+  std::lock_guard<std::mutex> guard(kernel_runtimes_mutex_);
+  CompiledKernelStats stats;
+  for (const auto& it : kernel_runtimes_) {
+    for (const auto& kernel_runtime : it.second) {
+      for (const auto& executor : kernel_runtime->executors()) {
+        if (!executor.compiled()) {
+          continue;
+        }
+        ++stats.num_kernels;
+        stats.compile_ms += executor.compileTimings().totalMs();
+        stats.host_bytes += executor.kernelHostBytes();
+      }
+    }
+  }
+  return stats;
 }
 
 void FusionExecutorCache::evictCache(size_t cache_id) {
-  auto it = id_to_kernel_runtime_.find(cache_id);
-  TORCH_INTERNAL_ASSERT(it != id_to_kernel_runtime_.end());
+  std::lock_guard<std::mutex> guard(kernel_runtimes_mutex_);
+  // The evicted id might not have been registered yet by the thread that
+  // looked it up, in which case there is nothing cached for it
+  const auto& id_to_kernel_runtime = *id_to_kernel_runtime_;
+  auto it = id_to_kernel_runtime.find(cache_id);
+  if (it == id_to_kernel_runtime.end()) {
+    return;
+  }
   it->second->evictCache(cache_id);
-  id_to_kernel_runtime_.erase(it);
+  updateKernelRuntimeId(cache_id, nullptr);
+  std::lock_guard<std::mutex> graphs_guard(cuda_graphs_mutex_);
+  cuda_graphs_.erase(cache_id);
+}
+
+void FusionExecutorCache::updateKernelRuntimeId(
+    size_t cache_id,
+    FusionKernelRuntime* kernel_runtime) {
+  auto id_to_kernel_runtime =
+      std::make_shared<KernelRuntimeIdMap>(*id_to_kernel_runtime_);
+  if (kernel_runtime == nullptr) {
+    id_to_kernel_runtime->erase(cache_id);
+  } else {
+    (*id_to_kernel_runtime)[cache_id] = kernel_runtime;
+  }
+  std::atomic_store(
+      &id_to_kernel_runtime_,
+      std::shared_ptr<const KernelRuntimeIdMap>(
+          std::move(id_to_kernel_runtime)));
+}
+
+namespace {
+
+//! Upper bound of the recorded runtime selections per FusionExecutorCache
+constexpr size_t kMaxHeuristicLookupSize = 1024;
+
+//! Encoding of everything heuristics can depend on in `args`, see
+//! Note [ Heuristic lookup ]
+std::vector<int64_t> encodeHeuristicArgs(const KernelArgumentHolder& args) {
+  std::vector<int64_t> key;
+  key.push_back((int64_t)args.getDeviceIndex());
+  for (const auto i : c10::irange(args.size())) {
+    const auto arg = args[i];
+    key.push_back((int64_t)arg->type());
+    if (arg->isType(ArgType::Tensor)) {
+      const auto tensor_arg = static_cast<const TensorArgAbstract*>(arg);
+      key.push_back(
+          (int64_t)std::get<PrimDataType>(tensor_arg->getDataType().type));
+      key.push_back(tensor_arg->getRank());
+      for (const auto dim : c10::irange(tensor_arg->getRank())) {
+        key.push_back(tensor_arg->getSize((int)dim));
+        key.push_back(tensor_arg->getStride((int)dim));
+      }
+      key.push_back((int64_t)SchedulerRuntimeInfo::computeAlignmentSize(
+          (size_t)tensor_arg->getPointer()));
+    } else if (
+        arg->isType(ArgType::Long) || arg->isType(ArgType::Double) ||
+        arg->isType(ArgType::ComplexDouble) || arg->isType(ArgType::Bool)) {
+      const auto bytes = static_cast<const char*>(arg->arg());
+      for (size_t offset = 0; offset < arg->argSize();
+           offset += sizeof(int64_t)) {
+        int64_t word = 0;
+        std::memcpy(
+            &word,
+            bytes + offset,
+            std::min(sizeof(int64_t), arg->argSize() - offset));
+        key.push_back(word);
+      }
+    }
+  }
+  return key;
+}
+
+std::vector<LaunchParams> launchParamsOf(FusionHeuristics* heuristics) {
+  std::vector<LaunchParams> launch_params;
+  for (const auto& scheduler_entry : heuristics->heuristicsList()) {
+    launch_params.push_back(scheduler_entry->params()->lparams);
+  }
+  return launch_params;
+}
+
+bool sameScalarInput(const c10::IValue& captured, const c10::IValue& input) {
+  if (captured.isTensor()) {
+    return input.isTensor() && at::equal(captured.toTensor(), input.toTensor());
+  }
+  return captured == input;
+}
+
+} // namespace
+
+// Note [ CUDA graph replay ]
+//
+// With PYTORCH_NVFUSER_ENABLE=cuda_graph, the first run of an input set on an
+// already compiled FusionKernelRuntime captures the launches of all its
+// segments, including the allocation of intermediate and output buffers, into
+// a CUDA graph with its own private memory pool. Subsequent runs with the same
+// input id replay the graph, which skips argument preparation, allocation and
+// the per-segment launch overhead on the host.
+//
+// Kernel parameters are baked into the graph at capture time, so the graph
+// reads its tensor inputs from static buffers owned by the cache entry. Inputs
+// are bound by a device-to-device copy into these buffers, which is skipped
+// when the caller passes the static buffers themselves. Scalar inputs are
+// baked into the graph as well and must match the captured values, otherwise
+// the fusion runs without the graph. The modules of the captured kernels are
+// pinned for the lifetime of the graph, so they are never unloaded under it,
+// see Note [ Loaded kernel budget ].
+//
+// Buffers allocated during the capture, i.e. outputs, intermediates and the
+// work buffers and semaphores of grid reductions and syncs, come from the
+// private memory pool of the graph. Executors don't use their persistent
+// workspace under capture, see Note [ Persistent workspace ], so a graph
+// never shares buffers with the launches outside of it.
+//
+// Replays of an input set are serialized, and the static buffers are only
+// reused once the previous replay and the copy of its outputs are done on
+// whichever stream they were issued. Outputs are returned as copies of the
+// static output buffers of the graph. With setCudaGraphStaticOutputs, the
+// static buffers are returned instead, as torch.cuda.graphs does, which saves
+// the copies but means that they are overwritten by the next replay of the
+// same input set.
+c10::optional<std::vector<at::Tensor>> FusionExecutorCache::runWithCudaGraph(
+    FusionKernelRuntime* kernel_runtime,
+    const at::ArrayRef<c10::IValue>& inputs,
+    KernelArgumentHolder& args) {
+  FUSER_PERF_SCOPE("FusionExecutorCache::runWithCudaGraph");
+  // Compilation, which synchronizes, can't happen under stream capture
+  if (!args.getCacheId().has_value() || !kernel_runtime->isCompiled()) {
+    return c10::nullopt;
+  }
+  const auto cache_id = args.getCacheId().value();
+  const auto device_index = (c10::DeviceIndex)args.getDeviceIndex();
+  auto current_stream = at::cuda::getCurrentCUDAStream(device_index);
+
+  std::lock_guard<std::mutex> guard(cuda_graphs_mutex_);
+  auto& entry = cuda_graphs_[cache_id];
+  if (entry == nullptr) {
+    FUSER_PERF_SCOPE("FusionExecutorCache::runWithCudaGraph::Capture");
+    entry = std::make_unique<CudaGraphEntry>();
+    std::vector<c10::IValue> static_ivalues;
+    for (const auto& input : inputs) {
+      if (input.isTensor() && !is_cpu_scalar(input.toTensor())) {
+        const auto& tensor = input.toTensor();
+        if (!tensor.is_non_overlapping_and_dense()) {
+          entry->replayable = false;
+          return c10::nullopt;
+        }
+        auto static_input = at::empty_strided(
+            tensor.sizes(), tensor.strides(), tensor.options());
+        static_input.copy_(tensor, /*non_blocking=*/true);
+        entry->static_inputs.push_back(static_input);
+        entry->scalar_inputs.emplace_back();
+        static_ivalues.emplace_back(static_input);
+      } else {
+        entry->static_inputs.emplace_back();
+        entry->scalar_inputs.push_back(
+            input.isTensor() ? c10::IValue(input.toTensor().clone()) : input);
+        static_ivalues.push_back(input);
+      }
+    }
+
+    KernelArgumentHolder static_args =
+        KernelArgumentHolder::createKernelArgumentHolder(
+            static_ivalues, args.getIndexMode());
+    static_args.setCacheId(cache_id);
+
+    // Graphs can't be captured on the default stream
+    auto capture_stream = at::cuda::getStreamFromPool(false, device_index);
+    at::cuda::CUDAEvent inputs_ready;
+    inputs_ready.record(current_stream);
+    inputs_ready.block(capture_stream);
+    try {
+      c10::cuda::CUDAStreamGuard stream_guard(capture_stream);
+      executor_utils::KernelModulePinsGuard pins_guard(&entry->module_pins);
+      entry->graph.capture_begin();
+      entry->static_outputs = kernel_runtime->runWithInput(static_args);
+      entry->graph.capture_end();
+    } catch (...) {
+      cuda_graphs_.erase(cache_id);
+      throw;
+    }
+    at::cuda::CUDAEvent capture_done;
+    capture_done.record(capture_stream);
+    capture_done.block(current_stream);
+  } else if (!entry->replayable) {
+    return c10::nullopt;
+  } else {
+    for (const auto i : c10::irange(inputs.size())) {
+      if (!entry->static_inputs[i].defined() &&
+          !sameScalarInput(entry->scalar_inputs[i], inputs[i])) {
+        return c10::nullopt;
+      }
+    }
+    // The previous replay might have been issued on another stream
+    entry->last_use.block(current_stream);
+    c10::cuda::CUDAStreamGuard stream_guard(current_stream);
+    for (const auto i : c10::irange(inputs.size())) {
+      const auto& static_input = entry->static_inputs[i];
+      if (static_input.defined() &&
+          static_input.data_ptr() != inputs[i].toTensor().data_ptr()) {
+        static_input.copy_(inputs[i].toTensor(), /*non_blocking=*/true);
+      }
+    }
+  }
+
+  std::vector<at::Tensor> outputs;
+  {
+    FUSER_PERF_SCOPE("FusionExecutorCache::runWithCudaGraph::Replay");
+    c10::cuda::CUDAStreamGuard stream_guard(current_stream);
+    entry->graph.replay();
+    if (cuda_graph_static_outputs_) {
+      outputs = entry->static_outputs;
+    } else {
+      outputs.reserve(entry->static_outputs.size());
+      for (const auto& static_output : entry->static_outputs) {
+        outputs.push_back(
+            static_output.defined() ? static_output.clone() : static_output);
+      }
+    }
+    entry->last_use.record(current_stream);
+  }
+  return outputs;
+}
+
+// Note [ Shape bucketing ]
+//
+// Inputs with different sizes may produce different heuristics, so e.g.
+// variable sequence lengths can create a new kernel runtime, and compile its
+// kernels, for many of the sizes seen. With a ShapeBuckets policy set, the
+// heuristics used to create and re-use runtimes are computed for a copy of
+// the arguments in which every bucketed dimension has the canonical size of
+// its bucket, so all sizes of a bucket get the same heuristics and share a
+// runtime. The kernels are still launched with the actual arguments.
+//
+// This is valid because generated kernels are symbolic in the extents and
+// predicate out-of-bound accesses, except for vectorization and alignment,
+// which depend on the largest power of two up to 16 that divides sizes and
+// strides. The canonical size is therefore the upper bound of the bucket
+// rounded up to a multiple of 16 plus that power of two of the actual size,
+// which makes it at least as large as any size of the bucket and leaves the
+// vectorizability of the inputs unchanged. Launch parameters derived from the
+// canonical sizes can only over-provision the launch, which is predicated.
+// Bucketed arguments are marked with setCanonicalSizes, so that schedulers
+// don't assume other properties of the canonical sizes, e.g. the
+// divisibility of Note [ Assumed divisible splits ], for the whole bucket.
+int64_t ShapeBuckets::canonicalSize(int64_t size) const {
+  // sizes of 0 and 1 are part of the fusion definition
+  if (size <= 1) {
+    return size;
+  }
+  int64_t upper_bound = 1;
+  auto bound_it = std::lower_bound(bounds.begin(), bounds.end(), size);
+  if (bound_it != bounds.end()) {
+    upper_bound = *bound_it;
+  } else {
+    while (upper_bound < size) {
+      upper_bound *= 2;
+    }
+  }
+  constexpr int64_t kMaxVectorWidth = 16;
+  const int64_t pow2_factor = std::min(size & -size, kMaxVectorWidth);
+  return ceilDiv(upper_bound, kMaxVectorWidth) * kMaxVectorWidth +
+      pow2_factor % kMaxVectorWidth;
+}
+
+KernelArgumentHolder FusionExecutorCache::bucketArgs(
+    const KernelArgumentHolder& args) const {
+  KernelArgumentHolder bucketed_args(args);
+  bucketed_args.setCanonicalSizes(true);
+  for (const auto& bucketed_dim : shape_buckets_.dims) {
+    const auto input_index = bucketed_dim.first;
+    const auto dim = (int)bucketed_dim.second;
+    if (input_index >= bucketed_args.size()) {
+      continue;
+    }
+    auto tensor_arg =
+        dynamic_cast<const TensorArgAbstract*>(bucketed_args[input_index]);
+    if (tensor_arg == nullptr || dim >= tensor_arg->getRank()) {
+      continue;
+    }
+    const auto size = tensor_arg->getSize(dim);
+    const auto canonical_size = shape_buckets_.canonicalSize(size);
+    if (canonical_size == size) {
+      continue;
+    }
+    auto arg = tensor_arg->copy_unique_ptr();
+    auto canonical_arg = static_cast<TensorArgAbstract*>(arg.get());
+    canonical_arg->setSize(dim, canonical_size);
+    // scale the strides of dimensions laid out outside of the bucketed one
+    const auto dim_extent = tensor_arg->getStride(dim) * size;
+    for (const auto i : c10::irange(tensor_arg->getRank())) {
+      const auto stride = tensor_arg->getStride((int)i);
+      if (i != dim && dim_extent > 0 && stride >= dim_extent &&
+          stride % dim_extent == 0) {
+        canonical_arg->setStride((int)i, stride / size * canonical_size);
+      }
+    }
+    bucketed_args.swap((int)input_index, canonical_arg);
+  }
+  return bucketed_args;
+}
+
+// Note [ Kernel runtime selection ]
+//
+// Selecting the runtime of an input id that was seen before is the hot path
+// of every launch, and may happen from multiple threads at once. The id to
+// runtime map is an immutable snapshot held by a shared_ptr: readers
+// atomically load the current snapshot and look the id up without taking any
+// lock, while writers, serialized by `kernel_runtimes_mutex_`, publish a
+// modified copy. A reader holding an old snapshot at worst misses an id that
+// was just added and takes the slow path, which looks the id up again under
+// the lock. Copying the map on updates is cheap as it is bounded by the size
+// of `inputs_id_lookup_`.
+//
+// On an id miss, runtimes of the device are checked for re-use, which
+// requires computing the heuristics of all segments for the new inputs. The
+// re-used runtime is moved to the front of the candidates, so that in the
+// common case of a few hot runtimes among many dynamic shapes only a single
+// candidate is checked.
+//
+// Note [ Heuristic lookup ]
+//
+// Heuristics are a function of the arguments they are computed for, i.e. the
+// sizes, strides and alignment of the tensors and the values of the scalars,
+// given the fusion and the device. The outcome of the re-use check, the
+// selected runtime and the launch parameters of its segments, is therefore
+// recorded by the encoding of the heuristic arguments. New input ids with the
+// same encoding skip the analysis and the canSchedule checks altogether. This
+// is exact, and it matters most with shape bucketing, where all sizes of a
+// bucket share their heuristic arguments, and for input ids evicted from
+// `inputs_id_lookup_` that come back later. Runtimes are never destroyed and
+// their heuristics only change in launch params, so entries stay valid.
+void FusionExecutorCache::recordRuntimeCacheHit(bool hit) {
+  (hit ? num_runtime_cache_hits_ : num_runtime_cache_misses_)
+      .fetch_add(1, std::memory_order_relaxed);
+  inst::RuntimeMetrics::instance()->add(
+      hit ? inst::RuntimeCounter::RuntimeCacheHits
+          : inst::RuntimeCounter::RuntimeCacheMisses);
 }
 
 FusionKernelRuntime* FusionExecutorCache::getKernelRuntimeFor(
     const KernelArgumentHolder& args) {
   // Check for id hit case
   auto unique_id = *args.getCacheId();
-  auto id_it = id_to_kernel_runtime_.find(unique_id);
-  if (id_it != id_to_kernel_runtime_.end()) {
+  {
+    auto id_to_kernel_runtime = std::atomic_load(&id_to_kernel_runtime_);
+    auto id_it = id_to_kernel_runtime->find(unique_id);
+    if (id_it != id_to_kernel_runtime->end()) {
+      recordRuntimeCacheHit(true);
+      return id_it->second;
+    }
+  }
+
+  std::lock_guard<std::mutex> guard(kernel_runtimes_mutex_);
+  // Heuristics are computed for the SM budget, see Note [ Execution policy ]
+  scheduler_utils::SmBudgetGuard sm_budget_guard(execution_policy_.sm_budget);
+
+  // Another thread might have registered the id while we were waiting
+  auto id_it = id_to_kernel_runtime_->find(unique_id);
+  if (id_it != id_to_kernel_runtime_->end()) {
+    recordRuntimeCacheHit(true);
     return id_it->second;
   }
+  recordRuntimeCacheHit(false);
 
   // Access kernels associated with the common device id
   auto& kernel_runtimes = kernel_runtimes_[args.getDeviceIndex()];
 
+  // Heuristics are computed for the canonical sizes of buckets, see
+  // Note [ Shape bucketing ]
+  c10::optional<KernelArgumentHolder> bucketed_args;
+  if (!shape_buckets_.empty()) {
+    bucketed_args.emplace(bucketArgs(args));
+  }
+  const auto& heuristic_args =
+      bucketed_args.has_value() ? bucketed_args.value() : args;
+
+  // Note [ Heuristic lookup ]
+  auto heuristic_key = encodeHeuristicArgs(heuristic_args);
+  auto lookup_it = heuristic_lookup_.find(heuristic_key);
+  if (lookup_it != heuristic_lookup_.end()) {
+    auto kernel_runtime = lookup_it->second.kernel_runtime;
+    kernel_runtime->updateHeuristicsLaunchParams(
+        lookup_it->second.launch_params);
+    if (bucketed_args.has_value() &&
+        encodeHeuristicArgs(args) != heuristic_key) {
+      num_compiles_avoided_++;
+    }
+    updateKernelRuntimeId(unique_id, kernel_runtime);
+    return kernel_runtime;
+  }
+
   // Check for re-use hit case
   //  a kernel runtime is re-usable if all the compiled
   //  kernels have the same heuristic parameters
   std::unique_ptr<FusionHeuristics> new_heuristics;
 
+  // Sizes that miss are specialized while the budget lasts, see
+  // Note [ Shape specialization ]
+  const bool specialize = shape_buckets_.empty() &&
+      num_specialized_shapes_ < max_specialized_shapes_;
+
   auto reuse_it = std::find_if(
       kernel_runtimes.begin(),
       kernel_runtimes.end(),
-      [&args, &new_heuristics](auto& kernel_runtime) {
-        auto maybe_heuristics = kernel_runtime->getMaybeHeuristicsFor(args);
+      [&heuristic_args, &new_heuristics, specialize](auto& kernel_runtime) {
+        if ((specialize && !kernel_runtime->isShapeSpecialized()) ||
+            !kernel_runtime->acceptsSizesOf(heuristic_args)) {
+          return false;
+        }
+        auto maybe_heuristics =
+            kernel_runtime->getMaybeHeuristicsFor(heuristic_args);
         if (!maybe_heuristics.has_value()) {
           return false;
         }
@@ -266,31 +1641,709 @@ FusionKernelRuntime* FusionExecutorCache::getKernelRuntimeFor(
       });
 
   FusionKernelRuntime* kernel_runtime = nullptr;
+  std::vector<LaunchParams> launch_params;
   if (reuse_it != kernel_runtimes.end()) {
     kernel_runtime = reuse_it->get();
-    kernel_runtime->updateHeuristicsLaunchParams(new_heuristics.get());
+    launch_params = launchParamsOf(new_heuristics.get());
+    kernel_runtime->updateHeuristicsLaunchParams(launch_params);
+    if (bucketed_args.has_value() &&
+        !kernel_runtime->getMaybeHeuristicsFor(args).has_value()) {
+      num_compiles_avoided_++;
+    }
+    // check the most recently re-used runtime first on the next miss
+    std::rotate(kernel_runtimes.begin(), reuse_it, std::next(reuse_it));
   } else {
     // graph miss, need to re-build an optimized graph for this case
-    kernel_runtimes.emplace_back(
-        std::make_unique<FusionKernelRuntime>(fusion_.get(), args));
+    kernel_runtimes.emplace_back(std::make_unique<FusionKernelRuntime>(
+        fusion_.get(), heuristic_args, specialize));
     kernel_runtime = kernel_runtimes.back().get();
+    if (specialize) {
+      num_specialized_shapes_++;
+    }
+    inst::RuntimeMetrics::instance()->add(
+        inst::RuntimeCounter::KernelRuntimesCreated);
     if (profiling_) {
       kernel_runtime->profile(true);
     }
+    if (output_ring_size_ > 0) {
+      kernel_runtime->setOutputRecycling(output_ring_size_);
+    }
+    kernel_runtime->setFastMath(fast_math_);
+    launch_params = launchParamsOf(kernel_runtime->schedulerHeuristics());
+  }
+
+  if (heuristic_lookup_.size() >= kMaxHeuristicLookupSize) {
+    heuristic_lookup_.clear();
   }
+  heuristic_lookup_.emplace(
+      std::move(heuristic_key),
+      HeuristicLookupEntry{kernel_runtime, std::move(launch_params)});
 
-  id_to_kernel_runtime_[unique_id] = kernel_runtime;
+  updateKernelRuntimeId(unique_id, kernel_runtime);
   return kernel_runtime;
 }
 
-FusionKernelRuntime::FusionKernelRuntime(
+// Note [ Persistent scheduling decisions ]
+//
+// Creating a FusionKernelRuntime first proposes a heuristic for the complete
+// fusion by trying the canSchedule check of every scheduler in turn, and
+// segments the fusion if none of them accepts it. On a warm start in a new
+// process, the cubins are served by the KernelDb, which leaves these checks
+// and the segmentation as the bulk of the time to the first launch. With the
+// KernelDb enabled, the decision is recorded in the db, keyed by
+//   - a fingerprint of the fusion: its inputs, outputs and expressions,
+//   - the signature of the arguments: dtypes, sizes and strides of tensors
+//     and the values of scalars, and
+//   - the architecture of the device,
+// so that later runtimes, in this or any other process sharing the db, only
+// confirm a recorded heuristic with its single canSchedule check, and go
+// straight to segmentation for a fusion recorded as segmented. A recorded
+// heuristic that no longer accepts the fusion falls back to proposing one.
+// Heuristic parameters and lowering are not persisted: the executor needs
+// the lowered kernel to allocate outputs and compute launch parameters.
+
+namespace {
+
+//! Decision recorded for a fusion that could not be scheduled as a whole
+constexpr int64_t kSegmentedDecision = -1;
+
+uint64_t schedulingDecisionKey(
+    Fusion* fusion,
+    const KernelArgumentHolder& args) {
+  std::stringstream ss;
+  for (auto inp : fusion->inputs()) {
+    ss << inp->toString() << ":" << inp->getDataType().value() << ",";
+  }
+  ss << "->";
+  for (auto out : fusion->outputs()) {
+    ss << out->toString() << ":" << out->getDataType().value() << ",";
+  }
+  ss << "\n";
+  for (auto expr : fusion->exprs()) {
+    ss << expr->toString();
+  }
+  for (const auto i : c10::irange(args.size())) {
+    const auto arg = args[i];
+    if (arg->isType(ArgType::Tensor)) {
+      // The data pointer is left out, only the layout is part of the key
+      const auto tensor_arg = static_cast<const TensorArgAbstract*>(arg);
+      ss << "tensor " << tensor_arg->getDataType() << " (";
+      for (const auto dim : c10::irange(tensor_arg->getRank())) {
+        ss << tensor_arg->getSize(dim) << ":" << tensor_arg->getStride(dim)
+           << ", ";
+      }
+      ss << ")\n";
+    } else if (
+        arg->isType(ArgType::Long) || arg->isType(ArgType::Double) ||
+        arg->isType(ArgType::ComplexDouble) || arg->isType(ArgType::Bool)) {
+      ss << argTypeToString(arg->type()) << " " << arg->toString() << "\n";
+    } else {
+      ss << argTypeToString(arg->type()) << "\n";
+    }
+  }
+  const auto prop = at::cuda::getDeviceProperties(args.getDeviceIndex());
+  ss << "sm_" << prop->major << prop->minor << " " << prop->multiProcessorCount;
+  if (auto sm_budget = scheduler_utils::smBudget()) {
+    ss << " budget " << sm_budget.value();
+  }
+  return fnv1a_hash(ss.str());
+}
+
+//! Proposes a heuristic for the complete fusion, nullopt if it has to be
+//! segmented. See Note [ Persistent scheduling decisions ]
+c10::optional<ScheduleHeuristic> proposeCompleteFusionHeuristic(
     Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
     const KernelArgumentHolder& args) {
+  auto& kernel_db = KernelDb::get();
+  if (!kernel_db.enabled()) {
+    return SchedulerEntry::proposeHeuristics(fusion, runtime_info);
+  }
+
+  const auto fusion_key = schedulingDecisionKey(fusion, args);
+  int64_t decision = kSegmentedDecision;
+  if (kernel_db.queryHeuristic(fusion_key, decision)) {
+    if (decision == kSegmentedDecision) {
+      scheduler_debug_utils::canScheduleMessage(
+          "***Recorded*** as segmented");
+      return c10::nullopt;
+    }
+    const auto sh = static_cast<ScheduleHeuristic>(decision);
+    if (decision > static_cast<int64_t>(ScheduleHeuristic::None) &&
+        decision <= static_cast<int64_t>(ScheduleHeuristic::Stencil) &&
+        SchedulerEntry::canSchedule(sh, fusion, runtime_info)) {
+      scheduler_debug_utils::canScheduleMessage("***Recorded*** as: ", sh);
+      return sh;
+    }
+  }
+
+  const auto heuristic =
+      SchedulerEntry::proposeHeuristics(fusion, runtime_info);
+  kernel_db.writeHeuristic(
+      fusion_key,
+      heuristic.has_value() ? static_cast<int64_t>(heuristic.value())
+                            : kSegmentedDecision);
+  return heuristic;
+}
+
+} // namespace
+
+// Note [ Background autotuning ]
+//
+// The heuristics pick the parameters of a kernel from a model of the GPU,
+// which leaves some performance on the table for the kernels a workload
+// spends most of its time in. With
+// PYTORCH_NVFUSER_ENABLE=autotune(<num_runs>, <min_kernel_time_us>),
+// default 100 and 20, the kernel of a pointwise or reduction group that is
+// launched for the num_runs-th time is timed, and if it took at least
+// min_kernel_time_us, a few variations of its parameters are tried on the
+// compilation thread pool:
+//   - the candidates halve an unroll or vectorization factor, or double an
+//     unroll factor that doesn't vectorize, up to 8;
+//   - a candidate whose cost estimate is more than 1.5 times the one of the
+//     original parameters is dropped after lowering, before its code
+//     generation and NVRTC, see Note [ Kernel cost estimate ];
+//   - each candidate and the original parameters are compiled into fresh
+//     executors and launched a few times, on a side stream, with the
+//     arguments of the timed launch. Dense tensor arguments are copied so
+//     that they don't change underneath the trials;
+//   - candidates that fail to schedule, compile or launch, or whose outputs
+//     don't match the outputs of the original parameters, are dropped, and
+//     reported with PYTORCH_NVFUSER_DUMP=perf_debug_verbose;
+//   - the fastest remaining candidate wins if it is at least 5% faster than
+//     the original parameters.
+// The winning executor is published through the `ready` flag of the
+// group's TunedKernel, and launched instead of the group's own executor
+// from then on, as long as the heuristics of the group have the launch
+// parameters it was tuned for. Each group is tuned at most once, and not
+// while a CUDA graph is being captured.
+//
+// With the KernelDb enabled, the winning factors are also recorded in the
+// db's log of scheduling decisions, keyed by the fingerprint of the group's
+// fusion, the signature of its arguments and the device, see
+// Note [ Persistent scheduling decisions ]. When a group with a recorded
+// winner is compiled, in this or any later process sharing the db, the
+// factors are applied on top of the parameters of its heuristic and the
+// tuned kernel is compiled alongside the group's own one, and ready from the
+// first launch. Tuning can thus be run offline over the production shapes
+// with autotune enabled, and the results are picked up by runs without it.
+// Groups with a recorded winner aren't tuned again.
+
+//! The kernel autotuning picked for a group
+struct TunedKernel {
+  //! Launch parameters of the heuristics of the group the kernel was tuned
+  //! for
+  LaunchParams tuned_for;
+  std::shared_ptr<HeuristicParams> params;
+  std::unique_ptr<FusionExecutor> executor;
+  //! Set once params and executor hold the winner
+  std::atomic<bool> ready{false};
+  //! Set once autotuning finished, whether it found a winner or not
+  std::atomic<bool> done{false};
+};
+
+namespace {
+
+//! Number of launches after which a group is autotuned and the minimum
+//! kernel time in microseconds worth autotuning. The arguments are parsed
+//! again when EnableOptionGuard changed them.
+std::pair<int64_t, double> autotuneThresholds() {
+  static std::mutex mutex;
+  static c10::optional<std::vector<std::string>> parsed_args;
+  static std::pair<int64_t, double> thresholds;
+  std::lock_guard<std::mutex> guard(mutex);
+  const auto& option_args = getEnableOptionArguments(EnableOption::Autotune);
+  if (parsed_args.has_value() && parsed_args.value() == option_args) {
+    return thresholds;
+  }
+  thresholds = {100, 20};
+  for (const auto i : c10::irange(std::min<size_t>(option_args.size(), 2))) {
+    try {
+      if (i == 0) {
+        thresholds.first = std::stol(option_args[i]);
+      } else {
+        thresholds.second = std::stod(option_args[i]);
+      }
+    } catch (const std::exception& e) {
+      std::cout << "skip invalid argument for Autotune, arg = "
+                << option_args[i] << std::endl;
+    }
+  }
+  parsed_args = option_args;
+  return thresholds;
+}
+
+//! Halves a factor that is larger than one, and doubles it up to 8 if it
+//! doesn't vectorize
+std::vector<int64_t> autotuneFactors(int64_t factor, bool vectorize) {
+  constexpr int64_t kMaxUnrollFactor = 8;
+  std::vector<int64_t> factors;
+  if (factor > 1) {
+    factors.push_back(factor / 2);
+  }
+  if (!vectorize && factor * 2 <= kMaxUnrollFactor) {
+    factors.push_back(factor * 2);
+  }
+  return factors;
+}
+
+//! Packs the factors autotuning varies into a scheduling decision for the
+//! KernelDb, see Note [ Background autotuning ]
+int64_t packAutotuneFactors(const std::shared_ptr<HeuristicParams>& params) {
+  int64_t first = 0, second = 0;
+  if (auto pparams = std::dynamic_pointer_cast<PointwiseParams>(params)) {
+    first = (int64_t)pparams->unroll_factor;
+  } else if (
+      auto rparams = std::dynamic_pointer_cast<ReductionParams>(params)) {
+    first = rparams->unroll_factor_inner_reduction;
+    second = rparams->unroll_factor_iter_dom;
+  }
+  return first | (second << 32);
+}
+
+//! Applies factors packed by packAutotuneFactors to a copy of params.
+//! Returns nullptr if there is nothing to apply.
+std::shared_ptr<HeuristicParams> unpackAutotuneFactors(
+    const std::shared_ptr<HeuristicParams>& params,
+    int64_t packed) {
+  const int64_t first = packed & 0xffffffff;
+  const int64_t second = packed >> 32;
+  if (first <= 0 || second < 0) {
+    return nullptr;
+  }
+  if (auto pparams = std::dynamic_pointer_cast<PointwiseParams>(params)) {
+    auto tuned = std::static_pointer_cast<PointwiseParams>(pparams->clone());
+    tuned->unroll_factor = (size_t)first;
+    return tuned;
+  } else if (
+      auto rparams = std::dynamic_pointer_cast<ReductionParams>(params)) {
+    if (second <= 0) {
+      return nullptr;
+    }
+    auto tuned = std::static_pointer_cast<ReductionParams>(rparams->clone());
+    tuned->unroll_factor_inner_reduction = first;
+    tuned->unroll_factor_iter_dom = second;
+    return tuned;
+  }
+  return nullptr;
+}
+
+//! KernelDb key of the winner of autotuning a group
+uint64_t autotuneKey(
+    Fusion* fusion,
+    const KernelArgumentHolder& args,
+    ScheduleHeuristic heuristic) {
+  std::stringstream ss;
+  ss << "autotune " << heuristic;
+  return fnv1a_hash(ss.str(), schedulingDecisionKey(fusion, args));
+}
+
+std::vector<std::shared_ptr<HeuristicParams>> autotuneCandidates(
+    const std::shared_ptr<HeuristicParams>& params) {
+  std::vector<std::shared_ptr<HeuristicParams>> candidates;
+  if (auto pparams = std::dynamic_pointer_cast<PointwiseParams>(params)) {
+    for (const auto factor : autotuneFactors(
+             (int64_t)pparams->unroll_factor, pparams->vectorize)) {
+      auto candidate =
+          std::static_pointer_cast<PointwiseParams>(pparams->clone());
+      candidate->unroll_factor = (size_t)factor;
+      candidates.push_back(candidate);
+    }
+  } else if (
+      auto rparams = std::dynamic_pointer_cast<ReductionParams>(params)) {
+    for (const auto factor : autotuneFactors(
+             rparams->unroll_factor_inner_reduction,
+             rparams->vectorize_inner_reduction)) {
+      auto candidate =
+          std::static_pointer_cast<ReductionParams>(rparams->clone());
+      candidate->unroll_factor_inner_reduction = factor;
+      candidates.push_back(candidate);
+    }
+    for (const auto factor : autotuneFactors(
+             rparams->unroll_factor_iter_dom, rparams->vectorize_iter_dom)) {
+      auto candidate =
+          std::static_pointer_cast<ReductionParams>(rparams->clone());
+      candidate->unroll_factor_iter_dom = factor;
+      candidates.push_back(candidate);
+    }
+  }
+  return candidates;
+}
+
+bool sameAutotuneOutputs(
+    const std::vector<at::Tensor>& outputs,
+    const std::vector<at::Tensor>& ref_outputs) {
+  if (outputs.size() != ref_outputs.size()) {
+    return false;
+  }
+  for (const auto i : c10::irange(outputs.size())) {
+    const auto& output = outputs[i];
+    const auto& ref_output = ref_outputs[i];
+    if (output.sizes() != ref_output.sizes() ||
+        output.scalar_type() != ref_output.scalar_type()) {
+      return false;
+    }
+    // Reordered floating point reductions don't match exactly
+    const bool same = output.is_floating_point() || output.is_complex()
+        ? at::allclose(output, ref_output, 1e-3, 1e-5, /*equal_nan=*/true)
+        : at::equal(output, ref_output);
+    if (!same) {
+      return false;
+    }
+  }
+  return true;
+}
+
+//! Runs the trials of Note [ Background autotuning ] and publishes the
+//! winner in tuned_kernel
+void autotuneKernel(
+    const std::shared_ptr<TunedKernel>& tuned_kernel,
+    const std::shared_ptr<Fusion>& fusion,
+    const std::shared_ptr<HeuristicParams>& params,
+    const KernelArgumentHolder& args,
+    const std::shared_ptr<at::cuda::CUDAEvent>& args_ready,
+    c10::optional<uint64_t> db_key) {
+  FUSER_PERF_SCOPE("autotuneKernel");
+  constexpr int kNumLaunches = 5;
+  constexpr float kMinSpeedup = 0.95f;
+  constexpr double kMaxEstimatedSlowdown = 1.5;
+
+  c10::cuda::CUDAGuard device_guard((c10::DeviceIndex)args.getDeviceIndex());
+  c10::cuda::CUDAStreamGuard stream_guard(c10::cuda::getStreamFromPool());
+  auto stream = c10::cuda::getCurrentCUDAStream();
+  args_ready->block(stream);
+
+  struct Trial {
+    std::shared_ptr<HeuristicParams> params;
+    std::unique_ptr<FusionExecutor> executor;
+    std::vector<at::Tensor> outputs;
+    float time_ms = std::numeric_limits<float>::max();
+  };
+  // Limit of the estimated time of the candidates, set once the original
+  // parameters are compiled
+  c10::optional<double> max_estimated_time_us;
+  auto run_trial = [&](const std::shared_ptr<HeuristicParams>& trial_params)
+      -> std::unique_ptr<Trial> {
+    try {
+      auto trial = std::make_unique<Trial>();
+      trial->params = trial_params;
+      trial->executor = std::make_unique<FusionExecutor>();
+      if (max_estimated_time_us.has_value()) {
+        trial->executor->setCostFilter([&](const KernelCostEstimate& cost) {
+          return cost.estimatedTimeUs(args.getDeviceIndex()) <=
+              max_estimated_time_us.value();
+        });
+      }
+      {
+        Fusion fusion_to_run(*fusion);
+        FusionGuard fg(&fusion_to_run);
+        if (auto pparams =
+                std::dynamic_pointer_cast<PointwiseParams>(trial_params)) {
+          schedulePointwise(&fusion_to_run, *pparams);
+        } else {
+          scheduleReduction(
+              &fusion_to_run,
+              *std::dynamic_pointer_cast<ReductionParams>(trial_params));
+        }
+        trial->executor->compileFusion(
+            &fusion_to_run, args, trial_params->lparams, trial_params->cparams);
+      }
+      if (!trial->executor->compiled()) {
+        if (isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose)) {
+          std::cout << "Autotuning dropped a candidate rejected by the cost "
+                    << "filter:" << trial_params->toString() << std::endl;
+        }
+        return nullptr;
+      }
+      trial->executor->setMeasureKernelTimeFlag(true);
+      for (const auto i : c10::irange(kNumLaunches)) {
+        (void)i; // Suppress unused variable warning
+        // Launches append their outputs to the arguments
+        KernelArgumentHolder launch_args(args);
+        trial->outputs = trial->executor->runFusion(
+            launch_args, trial_params->lparams, trial_params->cparams);
+        trial->time_ms =
+            std::min(trial->time_ms, trial->executor->kernelTimeMs());
+      }
+      trial->executor->setMeasureKernelTimeFlag(false);
+      return trial;
+    } catch (const std::exception& e) {
+      if (isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose)) {
+        std::cout << "Autotuning dropped a candidate that failed: " << e.what()
+                  << trial_params->toString() << std::endl;
+      }
+      return nullptr;
+    }
+  };
+
+  auto baseline = run_trial(params);
+  std::unique_ptr<Trial> best;
+  if (baseline != nullptr) {
+    const auto& baseline_cost = baseline->executor->estimatedCost();
+    if (baseline_cost.has_value()) {
+      max_estimated_time_us = kMaxEstimatedSlowdown *
+          baseline_cost->estimatedTimeUs(args.getDeviceIndex());
+    }
+    for (const auto& candidate_params : autotuneCandidates(params)) {
+      auto trial = run_trial(candidate_params);
+      if (trial == nullptr) {
+        continue;
+      }
+      if (!sameAutotuneOutputs(trial->outputs, baseline->outputs)) {
+        if (isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose)) {
+          std::cout << "Autotuning dropped a candidate whose outputs differ:"
+                    << candidate_params->toString() << std::endl;
+        }
+        continue;
+      }
+      if (best == nullptr || trial->time_ms < best->time_ms) {
+        best = std::move(trial);
+      }
+    }
+  }
+  // The arguments are released on this stream
+  stream.synchronize();
+
+  if (best == nullptr || best->time_ms >= kMinSpeedup * baseline->time_ms) {
+    return;
+  }
+  if (isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose)) {
+    std::cout << "Autotuned " << best->executor->kernelName() << ": "
+              << baseline->time_ms << " ms -> " << best->time_ms << " ms"
+              << best->params->toString() << std::endl;
+  }
+  if (db_key.has_value()) {
+    KernelDb::get().writeHeuristic(
+        db_key.value(), packAutotuneFactors(best->params));
+  }
+  tuned_kernel->params = best->params;
+  tuned_kernel->executor = std::move(best->executor);
+  tuned_kernel->ready.store(true, std::memory_order_release);
+}
+
+// Note [ Cat into output slices ]
+//
+// A concatenated fusion output, e.g. the keys of a KV cache extended with the
+// ones of new tokens,
+//
+//   T2[i0, i1 + i2, i3] = cat({T0[i0, i1, i3], T1[i0, i2, i3]}, 1)
+//
+// is computed by a CatOp over its inputs padded to the concatenated extent,
+// so every element of the output selects the input it comes from with a
+// predicate on its index along the concatenated dimension. With
+// EnableOption::CatSliceOutputs, FusionKernelRuntime replaces such an output,
+// when nothing in the fusion reads it and it is neither aliased nor permuted,
+// with one output per input,
+//
+//   T3[i0, i1, i3] = set(T0)
+//   T4[i0, i2, i3] = set(T1)
+//
+// and records them as a group with Fusion::addConcatOutputSlices. The first
+// slice takes the position of the concatenated output and the others are
+// appended to the outputs. A FusionExecutor producing all the slices of a
+// group allocates a single buffer of the concatenated shape and hands out
+// adjacent views of it along the concatenated dimension, so every producer
+// writes straight into its slice without any predicate. Slices are strided by
+// the concatenated extent outside of the concatenated dimension, so they are
+// not contiguous there. A slice starts after the ones before it, so a vector
+// width dividing the contiguous size of every slice, which vectorizing them
+// requires, keeps all of them aligned. runWithInput then returns the whole
+// buffer in place of the slices, or concatenates them with at::cat when
+// segmentation put them into different kernels and they were allocated
+// separately.
+
+//! Replaces the concatenated outputs of `fusion` with their slices, see
+//! Note [ Cat into output slices ]
+void sliceCatOutputs(Fusion* fusion) {
+  FusionGuard fg(fusion);
+  const auto alias_indices = fusion->getOutputAliasIndices();
+  const auto& permuted_outputs = fusion->getPermutationOutputMap();
+  const auto outputs = fusion->outputs();
+  for (const auto out_i : c10::irange(outputs.size())) {
+    auto cat_out = dynamic_cast<TensorView*>(outputs[out_i]);
+    if (cat_out == nullptr || !cat_out->definition() ||
+        !cat_out->definition()->isA<CatOp>() || !cat_out->uses().empty() ||
+        alias_indices.count((int)out_i) != 0 ||
+        permuted_outputs.count((int)out_i) != 0 ||
+        std::count(outputs.begin(), outputs.end(), cat_out) != 1) {
+      continue;
+    }
+    auto cat_op = cat_out->definition()->as<CatOp>();
+    const auto dim = cat_op->concatenatedDim();
+
+    auto is_sliceable = [](Val* inp) {
+      auto pad_op = dynamic_cast<PadOp*>(inp->definition());
+      if (pad_op == nullptr || inp->uses().size() != 1) {
+        return false;
+      }
+      const auto& dom = pad_op->in()->as<TensorView>()->getMaybeRFactorDomain();
+      return std::none_of(dom.begin(), dom.end(), [](IterDomain* id) {
+        return id->isBroadcast();
+      });
+    };
+    if (!std::all_of(
+            cat_op->inputs().begin(), cat_op->inputs().end(), is_sliceable)) {
+      continue;
+    }
+
+    std::vector<Val*> slices;
+    for (auto inp : cat_op->inputs()) {
+      auto slice = set(inp->definition()->as<PadOp>()->in()->as<TensorView>());
+      auto contiguity = TensorDomain::getContiguityFilledWith(
+          slice->getMaybeRFactorDomain(), true);
+      for (const auto i : c10::irange(dim)) {
+        contiguity[i] = false;
+      }
+      slice->setContiguity(contiguity);
+      slices.push_back(slice);
+    }
+
+    const std::vector<Val*> padded = cat_op->inputs();
+    fusion->replaceOutput(cat_out, slices.front());
+    for (auto it = slices.begin() + 1; it != slices.end(); ++it) {
+      fusion->addOutput(*it);
+    }
+    fusion->addConcatOutputSlices(slices, dim);
+
+    // Nothing reads the concatenated output and its padded inputs anymore
+    fusion->removeVal(cat_out);
+    for (auto val : padded) {
+      fusion->removeVal(val);
+    }
+  }
+}
+
+//! Puts each group of output slices back together at the position of its
+//! first slice and drops the other slices, see
+//! Note [ Cat into output slices ]
+void concatOutputSlices(
+    std::vector<at::Tensor>& outputs,
+    const std::vector<std::pair<std::vector<int>, int64_t>>& groups) {
+  FUSER_PERF_SCOPE("FusionKernelRuntime::concatOutputSlices");
+  std::vector<int> dropped;
+  for (const auto& group : groups) {
+    const auto& indices = group.first;
+    const auto dim = group.second;
+    std::vector<at::Tensor> slices;
+    slices.reserve(indices.size());
+    for (auto i : indices) {
+      slices.push_back(outputs.at(i));
+    }
+
+    // Slices allocated by the same kernel are adjacent views of one buffer
+    const auto& first = slices.front();
+    bool is_buffer = true;
+    int64_t extent = 0;
+    for (const auto& slice : slices) {
+      is_buffer = is_buffer && slice.is_alias_of(first) &&
+          slice.strides() == first.strides() &&
+          slice.storage_offset() ==
+              first.storage_offset() + extent * first.stride(dim);
+      extent += slice.size(dim);
+    }
+    if (is_buffer) {
+      auto sizes = first.sizes().vec();
+      sizes[dim] = extent;
+      outputs.at(indices.front()) =
+          first.as_strided(sizes, first.strides(), first.storage_offset());
+    } else {
+      outputs.at(indices.front()) = at::cat(slices, dim);
+    }
+    dropped.insert(dropped.end(), indices.begin() + 1, indices.end());
+  }
+  std::sort(dropped.begin(), dropped.end(), std::greater<int>());
+  for (auto i : dropped) {
+    outputs.erase(outputs.begin() + i);
+  }
+}
+
+// Note [ Shape specialization ]
+//
+// Extents of fusion inputs are symbolic, so a kernel reads them, and the
+// strides derived from them, from its tensor arguments and divides by them
+// at run time in its index math. For a few hot static shapes, e.g. the
+// layers of a model, a FusionExecutorCache can instead compile kernels that
+// are specialized for the sizes of a set of inputs: before the fusion copy
+// of the runtime is scheduled, the symbolic extents of its tensor inputs are
+// replaced with constants, as is done for lowering in replaceSymbolicSizes,
+// so that the splits, the predicates and the index math of the kernels are
+// constant folded by the simplifier and nvrtc. Such a runtime only accepts
+// the exact sizes it was specialized for, strides and alignment are still
+// checked by the re-use of its heuristics, and other sizes go to other
+// runtimes. The first `max_shapes` distinct sizes that miss the existing
+// runtimes are specialized, see FusionExecutorCache::setShapeSpecialization.
+// Strides of non-contiguous dimensions remain runtime values.
+
+//! Sizes of the tensor arguments, each prefixed by its rank
+std::vector<int64_t> tensorSizesOf(const KernelArgumentHolder& args) {
+  std::vector<int64_t> sizes;
+  for (const auto i : c10::irange(args.size())) {
+    if (!args[i]->isType(ArgType::Tensor)) {
+      continue;
+    }
+    const auto tensor_arg = static_cast<const TensorArgAbstract*>(args[i]);
+    sizes.push_back(tensor_arg->getRank());
+    for (const auto dim : c10::irange(tensor_arg->getRank())) {
+      sizes.push_back(tensor_arg->getSize((int)dim));
+    }
+  }
+  return sizes;
+}
+
+//! Replaces the symbolic extents of the tensor inputs of `fusion` with the
+//! sizes of `args`, see Note [ Shape specialization ]
+void specializeInputExtents(Fusion* fusion, const KernelArgumentHolder& args) {
+  FusionGuard fg(fusion);
+  std::unordered_map<Val*, Val*> replacement_map;
+  for (const auto i : c10::irange(fusion->inputs().size())) {
+    auto tv = dynamic_cast<TensorView*>(fusion->inputs()[i]);
+    if (tv == nullptr) {
+      continue;
+    }
+    TORCH_INTERNAL_ASSERT(args[i]->isType(ArgType::Tensor));
+    const auto tensor_arg = static_cast<const TensorArgAbstract*>(args[i]);
+    const auto root_domain =
+        TensorDomain::noReductions(tv->getMaybeRFactorDomain());
+    TORCH_INTERNAL_ASSERT(
+        (int64_t)root_domain.size() == tensor_arg->getRank(),
+        "Rank mismatch of input ",
+        i);
+    for (const auto dim : c10::irange(root_domain.size())) {
+      auto id = root_domain[dim];
+      auto extent = id->extent();
+      // Expanded extents are bound separately from their broadcast
+      if (id->isBroadcast() || id->hasExpandedExtent() ||
+          extent->isConstScalar() || extent->isFusionInput()) {
+        continue;
+      }
+      replacement_map.emplace(
+          extent, IrBuilder::create<Int>(tensor_arg->getSize((int)dim)));
+    }
+  }
+  ir_utils::replaceValue(fusion, replacement_map);
+}
+
+} // namespace
+
+FusionKernelRuntime::FusionKernelRuntime(
+    Fusion* fusion,
+    const KernelArgumentHolder& args,
+    bool specialize_shapes)
+    : is_shape_specialized_(specialize_shapes),
+      sm_budget_(scheduler_utils::smBudget()) {
   FUSER_PERF_SCOPE("FusionKernelRuntime::FusionKernelRuntime");
+  inst::CompileTimingsGuard compile_timings_guard(&compile_timings_);
 
   // Make a copy of fusion and do segmentation and translation
   //  on this copy
   auto fusion_copy = std::make_unique<Fusion>(*fusion);
+  if (isOptionEnabled(EnableOption::CatSliceOutputs)) {
+    sliceCatOutputs(fusion_copy.get());
+  }
+  if (is_shape_specialized_) {
+    specializeInputExtents(fusion_copy.get(), args);
+    specialized_sizes_ = tensorSizesOf(args);
+  }
 
   // Run segmentation on the copied fusion
   SchedulerRuntimeInfo runtime_info(fusion_copy.get(), args, true);
@@ -302,23 +2355,41 @@ FusionKernelRuntime::FusionKernelRuntime(
   scheduler_debug_utils::canScheduleMessage(
       "***Runtime***: Try to schedule fusion un-segmented:\n");
 
-  const auto maybe_complete_fusion_heuristic =
-      SchedulerEntry::proposeHeuristics(fusion_copy.get(), runtime_info);
+  c10::optional<ScheduleHeuristic> maybe_complete_fusion_heuristic;
+  {
+    FUSER_COMPILE_STAGE_SCOPE("Heuristics");
+    maybe_complete_fusion_heuristic =
+        proposeCompleteFusionHeuristic(fusion_copy.get(), runtime_info, args);
+  }
 
   //! Decide if this fusion is segmented or not
   const bool segmented = !maybe_complete_fusion_heuristic.has_value();
 
-  if (segmented) {
-    // Take ownership and segment transformed fusion
-    segmented_fusion_ =
-        SegmentCandidateFinder::segment(std::move(fusion_copy), args);
-  } else {
-    segmented_fusion_ = SegmentedFusion::fromCompleteFusion(
-        std::move(fusion_copy), maybe_complete_fusion_heuristic.value(), args);
+  {
+    FUSER_COMPILE_STAGE_SCOPE("Segmentation");
+    if (segmented) {
+      // Take ownership and segment transformed fusion
+      segmented_fusion_ =
+          SegmentCandidateFinder::segment(std::move(fusion_copy), args);
+    } else {
+      segmented_fusion_ = SegmentedFusion::fromCompleteFusion(
+          std::move(fusion_copy),
+          maybe_complete_fusion_heuristic.value(),
+          args);
+    }
   }
 
-  heuristics_ = segmented_fusion_->makeInitialHeuristics(args);
+  {
+    FUSER_COMPILE_STAGE_SCOPE("Heuristics");
+    heuristics_ = segmented_fusion_->makeInitialHeuristics(args);
+  }
   executors_ = std::vector<FusionExecutor>(segmented_fusion_->groups().size());
+  reprojected_kernels_ =
+      std::vector<ReprojectedKernel>(segmented_fusion_->groups().size());
+  if (isOptionEnabled(EnableOption::Autotune) || KernelDb::get().enabled()) {
+    autotune_states_ =
+        std::vector<AutotuneState>(segmented_fusion_->groups().size());
+  }
   if (isDebugDumpEnabled(DebugDumpOption::FusionSegments)) {
     segmented_fusion_->print();
   }
@@ -331,13 +2402,37 @@ FusionKernelRuntime::FusionKernelRuntime(
   // Pre-compute the executor order so that the run time path
   //  would go directly to kernel launch.
   prepareRuntimeOrder();
+  runtime_workspace_.concat_output_slices =
+      segmented_fusion_->completeFusion()->getConcatOutputSlices();
+}
+
+FusionKernelRuntime::~FusionKernelRuntime() {
+  // The compilation refers to this runtime
+  std::lock_guard<std::mutex> guard(background_compile_mutex_);
+  if (background_compile_.valid()) {
+    background_compile_.wait();
+  }
 }
 
+// Note [ Concurrent runs ]
+//
+// A runtime may be run from multiple threads at once, e.g. by inference
+// streams sharing one FusionExecutorCache. `mutex_` guards the compilation of
+// segments and the selection of the executor to run, i.e. reprojected and
+// autotuned kernels, and is released before the launch. Executors are never
+// replaced once compiled, and each one guards its own launches, see
+// Note [ Concurrent launches ], so segments are launched concurrently and
+// the kernels of different streams overlap. Launches that are measured, i.e.
+// with profiling, PerfDebugVerbose or to decide on autotuning, toggle the
+// measurement of the executor and keep the lock until they are done.
 std::vector<at::Tensor> FusionKernelRuntime::runKernelWithInput(
     KernelArgumentHolder& args,
-    SegmentedGroup* sg) {
+    SegmentedGroup* sg,
+    const std::vector<at::Tensor>& outputs) {
   FUSER_PERF_SCOPE("FusionKernelRuntime::runKernelWithInput");
-  std::lock_guard<std::mutex> guard(mutex_);
+  // Released before the launch unless the launch is measured, see
+  // Note [ Concurrent runs ]
+  std::unique_lock<std::mutex> lock(mutex_);
   // This function will be called once on un-segmented fusion,
   //  for segmented fusion, this function will be called on each segment
   //  In the case of segmented fusion, segmented group needs to be given so
@@ -347,8 +2442,6 @@ std::vector<at::Tensor> FusionKernelRuntime::runKernelWithInput(
   TORCH_INTERNAL_ASSERT(sg, "runKernelWithInput: need valid group to run");
   auto group_id = sg->groupId();
 
-  LaunchParams launch_params;
-  CompileParams compile_params;
   auto scheduler_entry = schedulers()[group_id].get();
 
   // Check that the heuristics are matched, in the case of segmented fusion
@@ -356,35 +2449,107 @@ std::vector<at::Tensor> FusionKernelRuntime::runKernelWithInput(
 
   if (!executors_[group_id].compiled()) {
     FUSER_PERF_SCOPE("FusionKernelRuntime::runKernelWithInput::Compile");
-    std::unique_ptr<Fusion> fusion_to_run;
-
     // Running a segment group as a single kernel,
     //  make a fusion to run from segmented fusion
-    fusion_to_run = segmented_fusion_->makeFusion(sg);
-    FusionGuard fg(fusion_to_run.get());
-    scheduler_entry->schedule(fusion_to_run.get());
-    launch_params = scheduler_entry->params()->lparams;
-    compile_params = scheduler_entry->params()->cparams;
-    TORCH_INTERNAL_ASSERT(
-        compile_params.index_type.has_value(), "Kernel index type not defined");
-    executors_[group_id].compileFusion(
-        fusion_to_run.get(), args, launch_params, compile_params);
-  } else {
-    launch_params = scheduler_entry->params()->lparams;
-    compile_params = scheduler_entry->params()->cparams;
+    compileSegment(segmented_fusion_->makeFusion(sg), args, sg);
+  }
+  LaunchParams launch_params = scheduler_entry->params()->lparams;
+  CompileParams compile_params = scheduler_entry->params()->cparams;
+
+  FusionExecutor* executor_to_run = &executors_[group_id];
+  std::shared_ptr<HeuristicParams> params_to_run = scheduler_entry->params();
+  const auto& reprojected_kernel = reprojected_kernels_[group_id];
+  if (reprojected_kernel.executor != nullptr) {
+    executor_to_run = reprojected_kernel.executor.get();
+    params_to_run = reprojected_kernel.params;
+  }
+  // Copy of the arguments to autotune the kernel with, taken before the
+  // launch appends its outputs, see Note [ Background autotuning ]
+  c10::optional<KernelArgumentHolder> autotune_args;
+  if (!autotune_states_.empty()) {
+    auto& autotune_state = autotune_states_[group_id];
+    const auto& tuned_kernel = autotune_state.tuned_kernel;
+    if (tuned_kernel != nullptr) {
+      if (tuned_kernel->ready.load(std::memory_order_acquire) &&
+          tuned_kernel->tuned_for == launch_params) {
+        executor_to_run = tuned_kernel->executor.get();
+        params_to_run = tuned_kernel->params;
+        launch_params = params_to_run->lparams;
+        compile_params = params_to_run->cparams;
+      }
+    } else if (
+        isOptionEnabled(EnableOption::Autotune) &&
+        ++autotune_state.num_runs == autotuneThresholds().first &&
+        (scheduler_entry->heuristic() == ScheduleHeuristic::PointWise ||
+         scheduler_entry->heuristic() == ScheduleHeuristic::Reduction) &&
+        c10::cuda::currentStreamCaptureStatusMayInitCtx() ==
+            c10::cuda::CaptureStatus::None) {
+      autotune_args = args;
+      executor_to_run->setMeasureKernelTimeFlag(true);
+    }
   }
 
   if (profiling_) {
-    most_recent_executor_log_.fusion_executor = &executors_[group_id];
-    most_recent_executor_log_.params = scheduler_entry->params()->clone();
+    most_recent_executor_log_.fusion_executor = executor_to_run;
+    most_recent_executor_log_.params = params_to_run->clone();
+    most_recent_executor_log_.compile_timings = compile_timings_;
+    const auto& kernel_stages = executor_to_run->compileTimings().stages_ms;
+    most_recent_executor_log_.compile_timings.stages_ms.insert(
+        most_recent_executor_log_.compile_timings.stages_ms.end(),
+        kernel_stages.begin(),
+        kernel_stages.end());
   }
 
-  auto& executor = executors_[group_id];
-  if (isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose)) {
+  auto& executor = *executor_to_run;
+  if (profiling_ || isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose)) {
     executor.setMeasureKernelTimeFlag(true);
+  } else if (!autotune_args.has_value()) {
+    lock.unlock();
+  }
+
+  auto kernel_outputs =
+      executor.runFusion(args, launch_params, compile_params, outputs);
+
+  if (inst::KernelTelemetry::enabled()) {
+    // See Note [ Kernel telemetry ]
+    auto telemetry = inst::KernelTelemetry::instance();
+    const auto kernel_name = executor.kernelName();
+    if (!telemetry->hasHeuristic(kernel_name)) {
+      telemetry->setHeuristic(
+          kernel_name,
+          toString(scheduler_entry->heuristic()),
+          params_to_run->toString());
+    }
   }
 
-  auto outputs = executor.runFusion(args, launch_params, compile_params);
+  if (profiling_) {
+    KernelProfile kernel_profile;
+    kernel_profile.group_id = group_id;
+    kernel_profile.kernel_name = executor.kernelName();
+    kernel_profile.heuristic = scheduler_entry->heuristic();
+    kernel_profile.launch_params = executor.lastLaunchParams();
+    kernel_profile.time_ms = executor.kernelTimeMs();
+    kernel_profile.bytes = executor.bytesProcessed();
+    if (kernel_profile.time_ms > 0) {
+      kernel_profile.bandwidth_gbs = (double)kernel_profile.bytes /
+          ((double)kernel_profile.time_ms * 1.0e6);
+    }
+    kernel_profile.resource_usage = executor.kernelResourceUsage();
+    kernel_profiles_.push_back(std::move(kernel_profile));
+    if (!autotune_args.has_value() &&
+        !isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose)) {
+      executor.setMeasureKernelTimeFlag(false);
+    }
+  }
+
+  if (autotune_args.has_value()) {
+    if (executor.kernelTimeMs() * 1000 >= autotuneThresholds().second) {
+      startAutotune(*autotune_args, sg);
+    }
+    if (!isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose)) {
+      executor.setMeasureKernelTimeFlag(false);
+    }
+  }
 
   // Print relevant information all at once for easy debuging of perf
   if (isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose)) {
@@ -399,7 +2564,7 @@ std::vector<at::Tensor> FusionKernelRuntime::runKernelWithInput(
       std::cout << "  " << args[i]->toString() << std::endl;
     }
     std::cout << "Compiler log: " << executor.compilerLog() << "\n";
-    std::cout << scheduler_entry->params()->toString() << "\n";
+    std::cout << params_to_run->toString() << "\n";
     std::cout << "With arguments: " << executor.lastLaunchParams().toString();
     std::cout << executor.kernelName() << " " << executor.bytesProcessed()
               << " bytes/ " << std::setprecision(3) << executor.kernelTimeMs()
@@ -411,7 +2576,130 @@ std::vector<at::Tensor> FusionKernelRuntime::runKernelWithInput(
     executor.setMeasureKernelTimeFlag(false);
   }
 
-  return outputs;
+  return kernel_outputs;
+}
+
+void FusionKernelRuntime::startAutotune(
+    const KernelArgumentHolder& args,
+    SegmentedGroup* sg) {
+  FUSER_PERF_SCOPE("FusionKernelRuntime::startAutotune");
+  auto group_id = sg->groupId();
+  auto scheduler_entry = schedulers()[group_id].get();
+
+  auto tuned_kernel = std::make_shared<TunedKernel>();
+  tuned_kernel->tuned_for = scheduler_entry->params()->lparams;
+  autotune_states_[group_id].tuned_kernel = tuned_kernel;
+
+  std::shared_ptr<Fusion> fusion = segmented_fusion_->makeFusion(sg);
+  auto params = scheduler_entry->params()->clone();
+  params->cparams.fast_math = fast_math_;
+  c10::optional<uint64_t> db_key;
+  if (KernelDb::get().enabled()) {
+    db_key = autotuneKey(fusion.get(), args, scheduler_entry->heuristic());
+  }
+
+  KernelArgumentHolder args_copy(args);
+  for (const auto i : c10::irange(args.size())) {
+    if (!args[i]->isType(ArgType::Tensor)) {
+      continue;
+    }
+    const auto tensor =
+        dynamic_cast<const TensorArgAbstract*>(args[i])->getTensor();
+    // A copy of an overlapping tensor wouldn't keep its strides
+    if (tensor.is_non_overlapping_and_dense()) {
+      KernelArgumentHolder tensor_copy(args.getIndexMode());
+      tensor_copy.push(tensor.clone());
+      args_copy.swap((int)i, tensor_copy.back());
+    }
+  }
+  auto args_ready = std::make_shared<at::cuda::CUDAEvent>();
+  args_ready->record(at::cuda::getCurrentCUDAStream());
+
+  getThreadPool()->run(
+      [tuned_kernel, fusion, params, args_copy, args_ready, db_key]() {
+        autotuneKernel(
+            tuned_kernel, fusion, params, args_copy, args_ready, db_key);
+        tuned_kernel->done.store(true, std::memory_order_release);
+      });
+}
+
+void FusionKernelRuntime::restoreTunedKernel(
+    std::unique_ptr<Fusion> fusion,
+    const KernelArgumentHolder& args,
+    SegmentedGroup* sg) {
+  FUSER_PERF_SCOPE("FusionKernelRuntime::restoreTunedKernel");
+  auto group_id = sg->groupId();
+  auto scheduler_entry = schedulers()[group_id].get();
+
+  int64_t packed = 0;
+  if (!KernelDb::get().queryHeuristic(
+          autotuneKey(fusion.get(), args, scheduler_entry->heuristic()),
+          packed)) {
+    return;
+  }
+  auto params = unpackAutotuneFactors(scheduler_entry->params(), packed);
+  if (params == nullptr) {
+    return;
+  }
+  params->cparams.fast_math = fast_math_;
+
+  auto tuned_kernel = std::make_shared<TunedKernel>();
+  tuned_kernel->tuned_for = scheduler_entry->params()->lparams;
+  tuned_kernel->params = params;
+  tuned_kernel->executor = std::make_unique<FusionExecutor>();
+  try {
+    FusionGuard fg(fusion.get());
+    {
+      inst::CompileTimingsGuard compile_timings_guard(
+          &tuned_kernel->executor->compileTimings());
+      FUSER_COMPILE_STAGE_SCOPE("Scheduling");
+      if (auto pparams = std::dynamic_pointer_cast<PointwiseParams>(params)) {
+        schedulePointwise(fusion.get(), *pparams);
+      } else {
+        scheduleReduction(
+            fusion.get(), *std::dynamic_pointer_cast<ReductionParams>(params));
+      }
+    }
+    tuned_kernel->executor->compileFusion(
+        fusion.get(), args, params->lparams, params->cparams);
+  } catch (const std::exception& e) {
+    // Keep the kernel of the heuristics if the recorded factors no longer
+    // work, e.g. after a change of the schedulers
+    return;
+  }
+  tuned_kernel->ready.store(true, std::memory_order_release);
+  tuned_kernel->done.store(true, std::memory_order_release);
+  autotune_states_[group_id].tuned_kernel = std::move(tuned_kernel);
+}
+
+void FusionKernelRuntime::recordTunedParams(
+    int group_id,
+    const std::shared_ptr<HeuristicParams>& params,
+    const KernelArgumentHolder& args) {
+  TORCH_CHECK(
+      KernelDb::get().enabled(),
+      "Tuned parameters can only be recorded in an enabled KernelDb");
+  auto group = segmented_fusion_->groups().at(group_id);
+  TORCH_INTERNAL_ASSERT(group->groupId() == group_id);
+  const auto heuristic = schedulers()[group_id]->heuristic();
+  TORCH_CHECK(
+      heuristic == ScheduleHeuristic::PointWise ||
+          heuristic == ScheduleHeuristic::Reduction,
+      "Only pointwise and reduction groups are autotuned, but got ",
+      heuristic);
+  auto fusion = segmented_fusion_->makeFusion(group);
+  KernelDb::get().writeHeuristic(
+      autotuneKey(fusion.get(), args, heuristic), packAutotuneFactors(params));
+}
+
+bool FusionKernelRuntime::isAutotuning() const {
+  return std::any_of(
+      autotune_states_.begin(),
+      autotune_states_.end(),
+      [](const AutotuneState& state) {
+        return state.tuned_kernel != nullptr &&
+            !state.tuned_kernel->done.load(std::memory_order_acquire);
+      });
 }
 
 void FusionKernelRuntime::prepareRuntimeOrder() {
@@ -433,12 +2721,36 @@ void FusionKernelRuntime::prepareRuntimeOrder() {
     }
   }
 
+  // Inputs overwritten in place by each group, which has to run after all
+  // other groups reading them, see Note [ In-place outputs ]
+  std::unordered_map<SegmentedGroup*, std::vector<Val*>> overwritten_inputs;
+  for (auto group : segmented_fusion_->groups()) {
+    for (auto output : group->outputs()) {
+      if (auto aliased_input = segmented_fusion_->findAlias(output)) {
+        overwritten_inputs[group].push_back(aliased_input);
+      }
+    }
+  }
+
   // Keep track of groups that has run
   std::vector<bool> group_ran(segmented_fusion_->groups().size(), false);
+  auto is_read_by_pending_group = [&](Val* input, SegmentedGroup* writer) {
+    for (const size_t group_i :
+         c10::irange(segmented_fusion_->groups().size())) {
+      auto group = segmented_fusion_->groups()[group_i];
+      if (!group_ran[group_i] && group != writer &&
+          std::find(group->inputs().begin(), group->inputs().end(), input) !=
+              group->inputs().end()) {
+        return true;
+      }
+    }
+    return false;
+  };
 
   while (!std::all_of(
       group_ran.begin(), group_ran.end(), [](bool b) { return b; })) {
     bool one_ran = false;
+    Val* blocked_input = nullptr;
 
     // Find the first segment with all inputs available to run
     for (const size_t group_i :
@@ -452,6 +2764,17 @@ void FusionKernelRuntime::prepareRuntimeOrder() {
           group_inputs.begin(),
           group_inputs.end(),
           [&available_input](Val* val) { return available_input.count(val); });
+      if (ready_to_run) {
+        auto overwritten_it = overwritten_inputs.find(group);
+        if (overwritten_it != overwritten_inputs.end()) {
+          for (auto input : overwritten_it->second) {
+            if (is_read_by_pending_group(input, group)) {
+              ready_to_run = false;
+              blocked_input = input;
+            }
+          }
+        }
+      }
 
       if (ready_to_run) {
         runtime_workspace_.group_run_order.push_back(group);
@@ -465,13 +2788,257 @@ void FusionKernelRuntime::prepareRuntimeOrder() {
         one_ran = true;
       }
     }
+    TORCH_CHECK(
+        one_ran || blocked_input == nullptr,
+        "Can not overwrite ",
+        blocked_input->toString(),
+        " in place, it is read by a segment depending on the segment ",
+        "overwriting it");
     TORCH_INTERNAL_ASSERT(
         one_ran,
         "Couldn't run all groups, something must have gone wrong in segmentation.");
   }
+
+  prepareArgumentSlots();
+  prepareStreamAssignment();
+}
+
+// Note [ Runtime argument slots ]
+//
+// runWithInput collects all values passed between groups in the runtime
+// arguments: the fusion inputs, followed by the extents of all tensor inputs
+// and the outputs of each group in run order, except for trivially forwarded
+// inputs. As this layout only depends on the segmentation, the position of
+// every group input and fusion output in the arguments is computed once here,
+// so that preparing the inputs of a group on the hot path is a plain index
+// into the arguments rather than a hash map lookup per value. Together with
+// the launch parameters cached per input id in the executors, this keeps the
+// host cost of a cached launch of a segment small and constant, and leaves
+// the kernel of one segment running while the next one is being prepared.
+void FusionKernelRuntime::prepareArgumentSlots() {
+  // Values map to the first slot they are pushed at
+  std::unordered_map<Val*, size_t> slots;
+  size_t num_slots = segmented_fusion_->inputs().size();
+  size_t extent_index = 0;
+  for (const auto i : c10::irange(segmented_fusion_->inputs().size())) {
+    auto input_val = segmented_fusion_->inputs()[i];
+    slots.emplace(input_val, i);
+    if (auto input_tv = dynamic_cast<TensorView*>(input_val)) {
+      const auto rank =
+          TensorDomain::noReductions(input_tv->getRootDomain()).size();
+      for (const auto dim : c10::irange(rank)) {
+        (void)dim;
+        slots.emplace(
+            runtime_workspace_.group_extent_binding_order[extent_index++],
+            num_slots++);
+      }
+    }
+  }
+
+  const size_t first_intermediate_slot = num_slots;
+  const auto& run_order = runtime_workspace_.group_run_order;
+  runtime_workspace_.group_input_slots.assign(run_order.size(), {});
+  for (const auto run_i : c10::irange(run_order.size())) {
+    auto group = run_order[run_i];
+    auto& input_slots = runtime_workspace_.group_input_slots[run_i];
+    for (auto input : group->inputs()) {
+      input_slots.push_back(slots.at(input));
+    }
+    for (auto output : group->outputs()) {
+      if (!output->isFusionInput()) {
+        slots.emplace(output, num_slots++);
+      }
+    }
+  }
+  runtime_workspace_.num_arg_slots = num_slots;
+
+  runtime_workspace_.fusion_output_slots.clear();
+  for (auto output : segmented_fusion_->outputs()) {
+    auto slot_it = slots.find(output);
+    runtime_workspace_.fusion_output_slots.push_back(
+        slot_it != slots.end() ? c10::optional<size_t>(slot_it->second)
+                               : c10::nullopt);
+  }
+
+  // Position in the run order of the last group producing or reading each
+  // intermediate, see Note [ Intermediate buffer liveness ]
+  std::vector<size_t> last_use(num_slots, 0);
+  for (const auto run_i : c10::irange(run_order.size())) {
+    for (auto slot : runtime_workspace_.group_input_slots[run_i]) {
+      last_use[slot] = run_i;
+    }
+    for (auto output : run_order[run_i]->outputs()) {
+      if (!output->isFusionInput()) {
+        last_use[slots.at(output)] = run_i;
+      }
+    }
+  }
+  std::unordered_set<size_t> output_slots;
+  for (const auto& slot : runtime_workspace_.fusion_output_slots) {
+    if (slot.has_value()) {
+      output_slots.insert(slot.value());
+    }
+  }
+  runtime_workspace_.group_released_slots.assign(run_order.size(), {});
+  for (const auto slot : c10::irange(first_intermediate_slot, num_slots)) {
+    if (!output_slots.count(slot)) {
+      runtime_workspace_.group_released_slots[last_use[slot]].push_back(slot);
+    }
+  }
+
+  runtime_workspace_.reread_input_slots.clear();
+  for (const auto i : c10::irange(segmented_fusion_->inputs().size())) {
+    auto input_val = segmented_fusion_->inputs()[i];
+    if (!input_val->isA<TensorView>()) {
+      continue;
+    }
+    const auto num_readers =
+        std::count_if(run_order.begin(), run_order.end(), [&](auto group) {
+          const auto& group_inputs = group->inputs();
+          return std::find(
+                     group_inputs.begin(), group_inputs.end(), input_val) !=
+              group_inputs.end();
+        });
+    if (num_readers > 1) {
+      runtime_workspace_.reread_input_slots.push_back(i);
+    }
+  }
+}
+
+// Note [ Intermediate buffer liveness ]
+//
+// The outputs of a group read by later groups are owned by the runtime
+// arguments, which would keep every intermediate of a segmented fusion
+// allocated until the last group ran, adding up all of them in the peak
+// memory of the fusion. As the run order is fixed, the last group reading
+// each intermediate is known upfront, and runWithInput drops the reference
+// to an intermediate as soon as that group has been launched. The caching
+// allocator then hands the block to the outputs of the following groups on
+// the same stream, so the peak only covers the intermediates live at any one
+// point of the run order. Intermediates that are also fusion outputs are
+// kept. With concurrent segments, a group reading an intermediate produced
+// on another stream records the intermediate on its own stream, so that the
+// block isn't reused before that group is done reading it.
+
+// Note [ L2 persistence of re-read inputs ]
+//
+// A normalization whose persistent buffers don't fit in registers and shared
+// memory is segmented into a kernel computing the statistics and a kernel
+// normalizing the input with them, and each of them reads the whole input
+// from DRAM. With PYTORCH_NVFUSER_ENABLE=l2_persistence, the launches of a
+// segmented fusion are made with an access policy window over the largest
+// fusion input read by more than one segment, so that the part of the input
+// fitting in the L2 set-aside for persisting accesses is still in L2 when the
+// later segments read it again. The hit ratio of the window is the fraction
+// of the input the set-aside can hold, and the rest of the input is read as
+// streaming so that it doesn't evict the persisting part. The set-aside is
+// claimed once per device at its maximum size, and the window is removed
+// from the streams again after the last launch, so kernels launched after
+// the fusion don't persist their accesses.
+
+// Note [ Concurrent segments ]
+//
+// Segments are launched in `group_run_order`, which serializes groups that
+// don't depend on each other, e.g. several small reductions of a multi-head
+// fusion that each fill only a fraction of the SMs. With
+// PYTORCH_NVFUSER_ENABLE=concurrent_segments(<num_streams>), default 4,
+// groups are spread over the current stream and up to num_streams - 1 side
+// streams following the segment DAG:
+//   - a group continues on the stream of a producer if it is the first
+//     consumer launched after that producer on the stream, so chains of
+//     segments don't need any synchronization;
+//   - other groups, including all but the first group without producers,
+//     are assigned to the streams round-robin.
+// Before a launch, the stream of a group waits on events recorded after each
+// of its producers that ran on another stream. Side streams wait on the
+// current stream before the first launch and the current stream waits on
+// all side streams after the last one, so the fusion as a whole is still
+// ordered on the current stream, which also makes it capturable in a CUDA
+// graph. Tensors produced on side streams are recorded on the current stream
+// for the caching allocator, since they are consumed and released in its
+// order.
+void FusionKernelRuntime::prepareStreamAssignment() {
+  const auto& run_order = runtime_workspace_.group_run_order;
+  const size_t num_groups = run_order.size();
+
+  size_t num_streams = 1;
+  if (isOptionEnabled(EnableOption::ConcurrentSegments) && num_groups > 1) {
+    num_streams = 4;
+    const auto& option_args =
+        getEnableOptionArguments(EnableOption::ConcurrentSegments);
+    if (!option_args.empty()) {
+      try {
+        num_streams = std::max(std::stoi(option_args[0]), 1);
+      } catch (const std::exception& e) {
+        std::cout << "skip invalid argument for ConcurrentSegments, arg = "
+                  << option_args[0] << std::endl;
+      }
+    }
+  }
+
+  std::unordered_map<SegmentedGroup*, size_t> run_position;
+  for (const auto i : c10::irange(num_groups)) {
+    run_position[run_order[i]] = i;
+  }
+
+  runtime_workspace_.num_streams = num_streams;
+  runtime_workspace_.group_streams.assign(num_groups, 0);
+  runtime_workspace_.group_producers.assign(num_groups, {});
+
+  // Last group launched on each stream
+  std::vector<c10::optional<size_t>> stream_tail(num_streams);
+  size_t next_stream = 0;
+  for (const auto i : c10::irange(num_groups)) {
+    auto& producers = runtime_workspace_.group_producers[i];
+    for (auto edge : run_order[i]->producer_edges) {
+      auto producer_i = run_position.at(edge->from);
+      if (std::find(producers.begin(), producers.end(), producer_i) ==
+          producers.end()) {
+        producers.push_back(producer_i);
+      }
+    }
+    // Groups overwriting an input wait for the earlier groups reading it,
+    // see Note [ In-place outputs ]
+    for (auto output : run_order[i]->outputs()) {
+      auto aliased_input = segmented_fusion_->findAlias(output);
+      if (aliased_input == nullptr) {
+        continue;
+      }
+      for (const auto reader_i : c10::irange(i)) {
+        const auto& reader_inputs = run_order[reader_i]->inputs();
+        if (std::find(
+                reader_inputs.begin(), reader_inputs.end(), aliased_input) !=
+                reader_inputs.end() &&
+            std::find(producers.begin(), producers.end(), reader_i) ==
+                producers.end()) {
+          producers.push_back(reader_i);
+        }
+      }
+    }
+
+    auto continued_it = std::find_if(
+        producers.begin(), producers.end(), [&](size_t producer_i) {
+          return stream_tail[runtime_workspace_.group_streams[producer_i]] ==
+              producer_i;
+        });
+    size_t stream = 0;
+    if (continued_it != producers.end()) {
+      stream = runtime_workspace_.group_streams[*continued_it];
+    } else {
+      stream = next_stream;
+      next_stream = (next_stream + 1) % num_streams;
+    }
+    runtime_workspace_.group_streams[i] = stream;
+    stream_tail[stream] = i;
+  }
 }
 
 // passing args by value, since we will be modify this
+bool FusionKernelRuntime::acceptsSizesOf(
+    const KernelArgumentHolder& args) const {
+  return !is_shape_specialized_ || tensorSizesOf(args) == specialized_sizes_;
+}
+
 void FusionKernelRuntime::startAsyncCompile(KernelArgumentHolder& args_old) {
   // only single compilation is supported at this moment.
   std::unique_lock<std::mutex> unique_lock(mutex_, std::try_to_lock);
@@ -504,13 +3071,15 @@ void FusionKernelRuntime::startAsyncCompile(KernelArgumentHolder& args_old) {
         " inputs but expecting ",
         segmented_fusion_->inputs().size());
 
+    if (isOptionEnabled(EnableOption::ParallelCompile)) {
+      compileFusionParallel(args);
+      return;
+    }
+
     c10::Device device(c10::DeviceType::CUDA, args.getDeviceIndex());
     std::unordered_map<Val*, const ArgAbstract*> tensor_map;
     mapFusionInputsToArgs(tensor_map, args);
 
-    // TODO: compilation can happen in parallel! We can have output sizes
-    // inferred on un-compiled kernel and setup all tensor_map prior to
-    // compilation.
     for (auto group_to_run : runtime_workspace_.group_run_order) {
       // TODO: index mode should be updated per segmented kernel
       // Prepare input vector
@@ -536,6 +3105,28 @@ void FusionKernelRuntime::startAsyncCompile(KernelArgumentHolder& args_old) {
   getThreadPool()->run(compile_fusion);
 }
 
+bool FusionKernelRuntime::compileInBackground(
+    const KernelArgumentHolder& args) {
+  std::lock_guard<std::mutex> guard(background_compile_mutex_);
+  if (!background_compile_.valid()) {
+    if (isCompiled()) {
+      return true;
+    }
+    // packaged_task is move-only while the thread pool takes copyable
+    // functions. Errors are kept in the future and raised again by the
+    // synchronous compilation of the next run.
+    auto task = std::make_shared<std::packaged_task<void()>>([this, args]() {
+      c10::cuda::CUDAGuard dg(args.getDeviceIndex());
+      compileFusion(args);
+    });
+    background_compile_ = task->get_future();
+    getThreadPool()->run([task]() { (*task)(); });
+    return false;
+  }
+  return background_compile_.wait_for(std::chrono::seconds(0)) ==
+      std::future_status::ready;
+}
+
 // TODO: replace the boilerplate in runKernelWithInput
 KernelArgumentHolder FusionKernelRuntime::compileKernel(
     const KernelArgumentHolder& args,
@@ -559,19 +3150,10 @@ KernelArgumentHolder FusionKernelRuntime::compileKernel(
 
   if (!executors_[group_id].compiled()) {
     FUSER_PERF_SCOPE("FusionKernelRuntime::compileKernel::Compile");
-    std::unique_ptr<Fusion> fusion_to_run;
-
     // Running a segment group as a single kernel,
     //  make a fusion to run from segmented fusion
-    fusion_to_run = segmented_fusion_->makeFusion(sg);
-    FusionGuard fg(fusion_to_run.get());
-    scheduler_entry->schedule(fusion_to_run.get());
+    compileSegment(segmented_fusion_->makeFusion(sg), args, sg);
     launch_params = scheduler_entry->params()->lparams;
-    auto compile_params = scheduler_entry->params()->cparams;
-    TORCH_INTERNAL_ASSERT(
-        compile_params.index_type.has_value(), "Kernel index type not defined");
-    executors_[group_id].compileFusion(
-        fusion_to_run.get(), args, launch_params, compile_params);
   } else {
     // TODO: this is a false negative assert, since we could be compiling
     // something for elevated high water mark on block size.
@@ -584,6 +3166,204 @@ KernelArgumentHolder FusionKernelRuntime::compileKernel(
   return outputs;
 }
 
+void FusionKernelRuntime::compileSegment(
+    std::unique_ptr<Fusion> fusion_to_run,
+    const KernelArgumentHolder& args,
+    SegmentedGroup* sg) {
+  FUSER_PERF_SCOPE("FusionKernelRuntime::compileSegment");
+  // Segments may be compiled on other threads, see Note [ Execution policy ]
+  scheduler_utils::SmBudgetGuard sm_budget_guard(sm_budget_);
+  // See Note [ In-place outputs ]
+  validateAliasedOutputs(fusion_to_run.get());
+
+  auto group_id = sg->groupId();
+  auto scheduler_entry = schedulers()[group_id].get();
+
+  // Keep the unscheduled fusion in case the persistent buffers need to be
+  // projected, see Note [ Register pressure feedback ]
+  std::unique_ptr<Fusion> unscheduled_fusion;
+  // Unscheduled copy to compile the recorded winner of a previous autotuning
+  // of the group with, see Note [ Background autotuning ]
+  std::unique_ptr<Fusion> fusion_to_tune;
+  if (!autotune_states_.empty() && KernelDb::get().enabled() &&
+      (scheduler_entry->heuristic() == ScheduleHeuristic::PointWise ||
+       scheduler_entry->heuristic() == ScheduleHeuristic::Reduction)) {
+    fusion_to_tune = std::make_unique<Fusion>(*fusion_to_run);
+  }
+  if (scheduler_entry->heuristic() == ScheduleHeuristic::Persistent &&
+      !scheduler_entry->reductionParams().project_persistent_buffers &&
+      !isOptionDisabled(DisableOption::PersistentReprojection) &&
+      ir_utils::getViewOps(fusion_to_run.get()).empty()) {
+    unscheduled_fusion = std::make_unique<Fusion>(*fusion_to_run);
+  }
+
+  FusionGuard fg(fusion_to_run.get());
+  {
+    inst::CompileTimingsGuard compile_timings_guard(
+        &executors_[group_id].compileTimings());
+    FUSER_COMPILE_STAGE_SCOPE("Scheduling");
+    scheduler_entry->schedule(fusion_to_run.get());
+  }
+  auto launch_params = scheduler_entry->params()->lparams;
+  auto compile_params = scheduler_entry->params()->cparams;
+  TORCH_INTERNAL_ASSERT(
+      compile_params.index_type.has_value(), "Kernel index type not defined");
+  compile_params.fast_math = fast_math_;
+  executors_[group_id].compileFusion(
+      fusion_to_run.get(), args, launch_params, compile_params);
+
+  if (unscheduled_fusion != nullptr) {
+    reprojectPersistentBuffers(std::move(unscheduled_fusion), args, sg);
+  }
+  if (fusion_to_tune != nullptr) {
+    restoreTunedKernel(std::move(fusion_to_tune), args, sg);
+  }
+}
+
+// Note [ Register pressure feedback ]
+//
+// The persistent scheduler projects the persistent buffers to the inputs of
+// the fusion only if that makes the buffers smaller, see
+// reduction_scheduler_utils::projectPersistentBuffers. Projecting instead
+// recomputes the pointwise producers of the buffers from the inputs after
+// the reduction, so it also shortens the live ranges of the intermediate
+// values the buffers are computed from. When lowering estimates that a
+// persistent kernel compiled without projection needs more registers than a
+// thread can have (see Note [ Register pressure estimate ]), the kernel is
+// compiled again with the buffers projected and the projected kernel is run
+// instead if its estimate is lower. The estimate misses spills ptxas can't
+// avoid, so a kernel that uses local memory according to its function
+// attributes (see FusionExecutor::kernelResourceUsage) is compiled again as
+// well, and the projected kernel is preferred if it uses less local memory.
+// The heuristic parameters of the segment are left as they are so that
+// heuristics matching isn't affected. This can be turned off with
+// PYTORCH_NVFUSER_DISABLE=persistent_reprojection.
+void FusionKernelRuntime::reprojectPersistentBuffers(
+    std::unique_ptr<Fusion> fusion,
+    const KernelArgumentHolder& args,
+    SegmentedGroup* sg) {
+  FUSER_PERF_SCOPE("FusionKernelRuntime::reprojectPersistentBuffers");
+  auto group_id = sg->groupId();
+  auto scheduler_entry = schedulers()[group_id].get();
+
+  const auto register_pressure =
+      executors_[group_id].kernel()->summary().register_pressure;
+  const auto local_bytes =
+      executors_[group_id].kernelResourceUsage().local_bytes_per_thread;
+  if (register_pressure <= scheduler_entry->params()->cparams.maxrregcount &&
+      local_bytes == 0) {
+    return;
+  }
+
+  auto rparams = std::static_pointer_cast<ReductionParams>(
+      scheduler_entry->params()->clone());
+  rparams->project_persistent_buffers = true;
+  rparams->cparams.fast_math = fast_math_;
+
+  FusionGuard fg(fusion.get());
+  auto executor = std::make_unique<FusionExecutor>();
+  {
+    inst::CompileTimingsGuard compile_timings_guard(
+        &executor->compileTimings());
+    FUSER_COMPILE_STAGE_SCOPE("Scheduling");
+    schedulePersistentKernel(fusion.get(), *rparams);
+  }
+  executor->compileFusion(
+      fusion.get(), args, rparams->lparams, rparams->cparams);
+  const auto projected_local_bytes =
+      executor->kernelResourceUsage().local_bytes_per_thread;
+  if (projected_local_bytes > local_bytes ||
+      (projected_local_bytes == local_bytes &&
+       executor->kernel()->summary().register_pressure >=
+           register_pressure)) {
+    return;
+  }
+  reprojected_kernels_[group_id] = {std::move(executor), rparams};
+}
+
+void FusionKernelRuntime::compileFusion(const KernelArgumentHolder& args) {
+  FUSER_PERF_SCOPE("FusionKernelRuntime::compileFusion");
+  std::lock_guard<std::mutex> guard(mutex_);
+  std::lock_guard<std::mutex> guard2(compiling_);
+  if (std::any_of(executors_.begin(), executors_.end(), [](const auto& fe) {
+        return !fe.compiled();
+      })) {
+    compileFusionParallel(args);
+  }
+}
+
+void FusionKernelRuntime::compileFusionParallel(KernelArgumentHolder args) {
+  FUSER_PERF_SCOPE("FusionKernelRuntime::compileFusionParallel");
+
+  TORCH_INTERNAL_ASSERT(
+      args.size() == segmented_fusion_->inputs().size(),
+      "Inputs were not set up correctly, received ",
+      args.size(),
+      " inputs but expecting ",
+      segmented_fusion_->inputs().size());
+
+  // Push the extents of tensor inputs, so that all group inputs are found at
+  // their precomputed slots, see Note [ Runtime argument slots ]
+  const auto num_inputs = args.size();
+  for (const auto i : c10::irange(num_inputs)) {
+    if (auto tensor_arg_abstract =
+            dynamic_cast<const TensorArgAbstract*>(args[i])) {
+      for (const auto dim : c10::irange(tensor_arg_abstract->getRank())) {
+        args.push(tensor_arg_abstract->getSize(dim));
+      }
+    }
+  }
+
+  // Make the fusion of each segment and infer its outputs on the unscheduled
+  // fusion, so that the inputs of all segments are known upfront. This
+  // touches the segmented fusion and is done serially.
+  std::vector<SegmentedGroup*> groups_to_compile;
+  std::vector<std::unique_ptr<Fusion>> fusions_to_compile;
+  std::vector<KernelArgumentHolder> group_args;
+  const auto& run_order = runtime_workspace_.group_run_order;
+  for (const auto run_i : c10::irange(run_order.size())) {
+    auto group_to_run = run_order[run_i];
+    // TODO: index mode should be updated per segmented kernel
+    // Prepare input vector
+    KernelArgumentHolder group_runtime_inputs(args.getIndexMode());
+    group_runtime_inputs.setDeviceIndex(args.getDeviceIndex());
+    for (auto slot : runtime_workspace_.group_input_slots[run_i]) {
+      group_runtime_inputs.push(args[slot]);
+    }
+
+    auto fusion_to_run = segmented_fusion_->makeFusion(group_to_run);
+    KernelArgumentHolder group_runtime_outputs =
+        inferOutputSizes(fusion_to_run.get(), group_runtime_inputs);
+
+    // Outputs forwarding fusion inputs have no slot of their own, as in
+    // runWithInput. See note [trivial forwarding]
+    const auto& group_outputs = group_to_run->outputs();
+    for (const size_t group_out_i : c10::irange(group_outputs.size())) {
+      if (!group_outputs[group_out_i]->isFusionInput()) {
+        args.push(group_runtime_outputs[group_out_i]);
+      }
+    }
+
+    if (!executors_[group_to_run->groupId()].compiled()) {
+      groups_to_compile.push_back(group_to_run);
+      fusions_to_compile.push_back(std::move(fusion_to_run));
+      group_args.push_back(group_runtime_inputs);
+    }
+  }
+
+  TORCH_INTERNAL_ASSERT(
+      args.size() == runtime_workspace_.num_arg_slots,
+      "Unexpected number of runtime arguments");
+
+  // Scheduling, lowering and NVRTC compilation of the segments are
+  // independent of each other
+  parallelFor(groups_to_compile.size(), [&](size_t i) {
+    c10::cuda::CUDAGuard dg(args.getDeviceIndex());
+    compileSegment(
+        std::move(fusions_to_compile[i]), group_args[i], groups_to_compile[i]);
+  });
+}
+
 void FusionKernelRuntime::mapFusionInputsToArgs(
     std::unordered_map<Val*, const ArgAbstract*>& tensor_map,
     KernelArgumentHolder& args) {
@@ -613,9 +3393,18 @@ void FusionKernelRuntime::mapFusionInputsToArgs(
 }
 
 std::vector<at::Tensor> FusionKernelRuntime::runWithInput(
-    KernelArgumentHolder& args) {
+    KernelArgumentHolder& args,
+    const std::vector<at::Tensor>& outputs) {
   FUSER_PERF_SCOPE("FusionKernelRuntime::runWithInput");
 
+  TORCH_CHECK(
+      outputs.empty() || !is_segmented_,
+      "Preallocated outputs are not supported for segmented fusions");
+  TORCH_CHECK(
+      outputs.empty() || runtime_workspace_.concat_output_slices.empty(),
+      "Preallocated outputs are not supported for concatenated outputs ",
+      "written as slices");
+
   TORCH_INTERNAL_ASSERT(
       args.size() == segmented_fusion_->inputs().size(),
       "Inputs were not set up correctly, received ",
@@ -625,21 +3414,111 @@ std::vector<at::Tensor> FusionKernelRuntime::runWithInput(
 
   c10::Device device(c10::DeviceType::CUDA, args.getDeviceIndex());
 
-  std::unordered_map<Val*, const ArgAbstract*> tensor_map;
-  mapFusionInputsToArgs(tensor_map, args);
+  if (profiling_) {
+    kernel_profiles_.clear();
+  }
+
+  // Compile all segments at once on the first run instead of one by one as
+  // they are launched
+  if (isOptionEnabled(EnableOption::ParallelCompile) && !isCompiled()) {
+    std::lock_guard<std::mutex> guard(compiling_);
+    // isCompiled also fails while another run holds `mutex_`, so check the
+    // executors themselves before compiling them
+    if (std::any_of(executors_.begin(), executors_.end(), [](const auto& fe) {
+          return !fe.compiled();
+        })) {
+      compileFusionParallel(args);
+    }
+  }
 
-  // TODO: we don't need this any more, since TensorArgAbstract already holds a
-  // reference to tensor
-  std::unordered_map<Val*, at::Tensor> output_holder;
+  // Push the extents of tensor inputs, so that all group inputs are found at
+  // their precomputed slots, see Note [ Runtime argument slots ]
+  const auto num_inputs = args.size();
+  for (const auto i : c10::irange(num_inputs)) {
+    if (auto tensor_arg_abstract =
+            dynamic_cast<const TensorArgAbstract*>(args[i])) {
+      for (const auto dim : c10::irange(tensor_arg_abstract->getRank())) {
+        args.push(tensor_arg_abstract->getSize(dim));
+      }
+    }
+  }
 
   if (isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose)) {
     std::cout << "=================RUNNING FUSION SEGMENTS================="
               << std::endl;
   }
 
+  // Streams and events to launch independent groups concurrently, see
+  // Note [ Concurrent segments ]
+  const auto& run_order = runtime_workspace_.group_run_order;
+  const bool concurrent = runtime_workspace_.num_streams > 1;
+  std::vector<c10::cuda::CUDAStream> streams;
+  std::vector<at::cuda::CUDAEvent> group_events;
+  if (concurrent) {
+    streams.push_back(c10::cuda::getCurrentCUDAStream(device.index()));
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      while (side_streams_.size() + 1 < runtime_workspace_.num_streams) {
+        side_streams_.push_back(
+            c10::cuda::getStreamFromPool(false, device.index()));
+      }
+    }
+    streams.insert(streams.end(), side_streams_.begin(), side_streams_.end());
+    group_events.resize(run_order.size());
+    at::cuda::CUDAEvent fork_event;
+    fork_event.record(streams[0]);
+    for (const auto stream_i : c10::irange(1, streams.size())) {
+      fork_event.block(streams[stream_i]);
+    }
+  }
+
+  // Keep the largest input read by several groups in L2, see
+  // Note [ L2 persistence of re-read inputs ]
+  c10::optional<executor_utils::L2PersistenceWindow> l2_window;
+  if (isOptionEnabled(EnableOption::L2Persistence) &&
+      !runtime_workspace_.reread_input_slots.empty()) {
+    c10::optional<at::Tensor> reread_input;
+    for (auto slot : runtime_workspace_.reread_input_slots) {
+      auto tensor_arg = dynamic_cast<const TensorArgAbstract*>(args[slot]);
+      if (tensor_arg == nullptr) {
+        continue;
+      }
+      const auto tensor = tensor_arg->getTensor();
+      if (tensor.is_cuda() &&
+          (!reread_input.has_value() ||
+           tensor.numel() * tensor.element_size() >
+               reread_input->numel() * reread_input->element_size())) {
+        reread_input = tensor;
+      }
+    }
+    if (reread_input.has_value()) {
+      l2_window.emplace(
+          reread_input.value(),
+          concurrent ? streams
+                     : std::vector<c10::cuda::CUDAStream>{
+                           c10::cuda::getCurrentCUDAStream(device.index())});
+    }
+  }
+
+  // Outputs of groups are pushed after the fusion inputs and their extents
+  const auto first_intermediate_slot = args.size();
+
   // group should share cache id.
   auto group_cache_id = args.getCacheId();
-  for (auto group_to_run : runtime_workspace_.group_run_order) {
+  for (const auto run_i : c10::irange(run_order.size())) {
+    auto group_to_run = run_order[run_i];
+    const auto stream_i =
+        concurrent ? runtime_workspace_.group_streams[run_i] : 0;
+    c10::optional<c10::cuda::CUDAStreamGuard> stream_guard;
+    if (concurrent) {
+      for (auto producer_i : runtime_workspace_.group_producers[run_i]) {
+        if (runtime_workspace_.group_streams[producer_i] != stream_i) {
+          group_events[producer_i].block(streams[stream_i]);
+        }
+      }
+      stream_guard.emplace(streams[stream_i]);
+    }
+
     // TODO: index mode should be updated per segmented kernel
     // Prepare input vector
     KernelArgumentHolder group_runtime_inputs(args.getIndexMode());
@@ -647,8 +3526,15 @@ std::vector<at::Tensor> FusionKernelRuntime::runWithInput(
     if (group_cache_id.has_value()) {
       group_runtime_inputs.setCacheId(group_cache_id.value());
     }
-    for (auto input : group_to_run->inputs()) {
-      group_runtime_inputs.push(tensor_map.at(input));
+    for (auto slot : runtime_workspace_.group_input_slots[run_i]) {
+      group_runtime_inputs.push(args[slot]);
+      // See Note [ Intermediate buffer liveness ]
+      if (concurrent && slot >= first_intermediate_slot) {
+        auto tensor_arg = dynamic_cast<const TensorArgAbstract*>(args[slot]);
+        if (tensor_arg != nullptr && tensor_arg->getTensor().defined()) {
+          tensor_arg->getTensor().record_stream(streams[stream_i]);
+        }
+      }
     }
 
     // TODO: currently we are still outputing PyTorch tensors, instead of
@@ -656,7 +3542,18 @@ std::vector<at::Tensor> FusionKernelRuntime::runWithInput(
 
     // Run graph segment
     std::vector<at::Tensor> group_runtime_outputs =
-        runKernelWithInput(group_runtime_inputs, group_to_run);
+        runKernelWithInput(group_runtime_inputs, group_to_run, outputs);
+
+    if (concurrent) {
+      group_events[run_i].record(streams[stream_i]);
+      if (stream_i != 0) {
+        for (auto& output : group_runtime_outputs) {
+          if (output.defined()) {
+            output.record_stream(streams[0]);
+          }
+        }
+      }
+    }
 
     const auto& group_outputs = group_to_run->outputs();
 
@@ -666,16 +3563,29 @@ std::vector<at::Tensor> FusionKernelRuntime::runWithInput(
         "output size does not match");
     for (const size_t group_out_i : c10::irange(group_outputs.size())) {
       // trivial forwarding outputs empty tensor to save bandwidth, skip
-      // tensor_map update on those, since we want all future use of inputs on
-      // the original tensor input. See note [trivial forwarding]
+      // pushing those, since we want all future use of inputs on the original
+      // tensor input. See note [trivial forwarding]
       if (!group_outputs[group_out_i]->isFusionInput()) {
-        output_holder[group_outputs[group_out_i]] =
-            group_runtime_outputs[group_out_i];
-
         args.push(group_runtime_outputs[group_out_i]);
-        tensor_map.emplace(group_outputs[group_out_i], args.back());
       }
     }
+
+    // Drop the intermediates no later group reads, see
+    // Note [ Intermediate buffer liveness ]
+    for (auto slot : runtime_workspace_.group_released_slots[run_i]) {
+      args.releaseTensor(slot);
+    }
+  }
+  TORCH_INTERNAL_ASSERT(
+      args.size() == runtime_workspace_.num_arg_slots,
+      "Unexpected number of runtime arguments");
+
+  if (concurrent) {
+    for (const auto stream_i : c10::irange(1, streams.size())) {
+      at::cuda::CUDAEvent join_event;
+      join_event.record(streams[stream_i]);
+      join_event.block(streams[0]);
+    }
   }
 
   if (isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose)) {
@@ -685,10 +3595,14 @@ std::vector<at::Tensor> FusionKernelRuntime::runWithInput(
 
   // Produce final global output
   std::vector<at::Tensor> fusion_outputs;
-  for (auto output : segmented_fusion_->outputs()) {
-    const auto iter = output_holder.find(output);
-    if (iter != output_holder.end()) {
-      fusion_outputs.push_back(iter->second);
+  const auto& fusion_output_slots = runtime_workspace_.fusion_output_slots;
+  for (const auto output_i : c10::irange(segmented_fusion_->outputs().size())) {
+    auto output = segmented_fusion_->outputs()[output_i];
+    const auto& slot = fusion_output_slots[output_i];
+    if (slot.has_value() && !output->isFusionInput()) {
+      auto arg = dynamic_cast<const TensorArgAbstract*>(args[slot.value()]);
+      TORCH_INTERNAL_ASSERT(arg, "Fusion output is not a tensor");
+      fusion_outputs.push_back(arg->getTensor());
     } else if (output->isFusionInput()) {
       // Note [ trivial forwarding ]
       //
@@ -709,10 +3623,9 @@ std::vector<at::Tensor> FusionKernelRuntime::runWithInput(
       // step 2. Integration handles the trivial forwarding of inputs. When we
       // put together `fusion_outputs` for a given fusion, when outputs are just
       // fusion inputs, we directly return the input tensor.
-      const auto iter = tensor_map.find(output);
       TORCH_INTERNAL_ASSERT(
-          iter != tensor_map.end(), "Can not find output as aliased intput");
-      auto arg = dynamic_cast<const TensorArgAbstract*>(iter->second);
+          slot.has_value(), "Can not find output as aliased intput");
+      auto arg = dynamic_cast<const TensorArgAbstract*>(args[slot.value()]);
       // See step 2 - note [ trivial forwarding ]
       fusion_outputs.push_back(arg->getTensor());
     } else {
@@ -747,6 +3660,10 @@ std::vector<at::Tensor> FusionKernelRuntime::runWithInput(
       fusion_outputs.emplace_back(at::empty({0}, tensor_options));
     }
   }
+  if (!runtime_workspace_.concat_output_slices.empty()) {
+    concatOutputSlices(
+        fusion_outputs, runtime_workspace_.concat_output_slices);
+  }
   return fusion_outputs;
 }
 
@@ -757,14 +3674,19 @@ const std::vector<FusionKernelRuntime::SchedulerEntryPtr>& FusionKernelRuntime::
 
 void FusionKernelRuntime::updateHeuristicsLaunchParams(
     FusionHeuristics* update_heuristics) {
+  updateHeuristicsLaunchParams(launchParamsOf(update_heuristics));
+}
+
+void FusionKernelRuntime::updateHeuristicsLaunchParams(
+    const std::vector<LaunchParams>& launch_params) {
   FUSER_PERF_SCOPE("FusionKernelRuntime::updateHeuristicsLaunchParams");
+  // launch params are read by runKernelWithInput under `mutex_`
+  std::lock_guard<std::mutex> guard(mutex_);
   auto scheduler_list_length = heuristics_->heuristicsList().size();
-  TORCH_INTERNAL_ASSERT(
-      update_heuristics->heuristicsList().size() == scheduler_list_length);
+  TORCH_INTERNAL_ASSERT(launch_params.size() == scheduler_list_length);
   for (const auto i : c10::irange(scheduler_list_length)) {
     auto& schedulerPtr = heuristics_->heuristicsList()[i];
-    schedulerPtr->updateLaunchConstraint(
-        update_heuristics->heuristicsList()[i]->params()->lparams);
+    schedulerPtr->updateLaunchConstraint(launch_params[i]);
   }
 }
 
@@ -825,6 +3747,7 @@ std::vector<at::Tensor> GraphCache::runGraphWithInputs(
   FUSER_PERF_SCOPE("GraphCache::runGraphWithInputs");
 
   GRAPH_DEBUG("running GraphCache: ", this);
+  std::lock_guard<std::mutex> guard(mutex_);
   auto outputs = fusion_executor_cache_->runFusionWithInputs(inputs);
   TORCH_INTERNAL_ASSERT(
       outputs.size() == num_of_outputs_,
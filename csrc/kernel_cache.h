@@ -14,9 +14,17 @@
 #include <scheduler/all_schedulers.h>
 #include <scheduler/registry.h>
 
+#include <ATen/cuda/CUDAEvent.h>
+#include <ATen/cuda/CUDAGraph.h>
+#include <c10/cuda/CUDAStream.h>
 #include <c10/macros/Export.h>
 #include <c10/util/ArrayRef.h>
+#include <c10/util/hash.h>
 
+#include <atomic>
+#include <future>
+#include <list>
+#include <memory>
 #include <mutex>
 #include <type_traits>
 #include <unordered_map>
@@ -26,11 +34,31 @@ namespace nvfuser {
 class SegmentedGroup;
 class FusionHeuristics;
 class SchedulerRuntimeInfo;
+struct TunedKernel;
 
 // Utilities for benchmarking and profiling
 struct ExecutorLog {
   std::shared_ptr<HeuristicParams> params = nullptr;
   FusionExecutor* fusion_executor = nullptr;
+  //! Compilation stages of the runtime (segmentation, heuristics) followed
+  //! by those of the kernel, see Note [ Compile time instrumentation ]
+  inst::CompileTimings compile_timings;
+};
+
+//! Record of a kernel launched by a profiled run, see
+//! FusionKernelRuntime::kernelProfiles
+struct KernelProfile {
+  //! Segment of the fusion the kernel was compiled for
+  int group_id = -1;
+  std::string kernel_name;
+  ScheduleHeuristic heuristic = ScheduleHeuristic::None;
+  LaunchParams launch_params;
+  //! Kernel time measured with CUDA events around the launch
+  float time_ms = 0;
+  //! Bytes of the inputs and outputs of the kernel
+  int64_t bytes = 0;
+  double bandwidth_gbs = 0;
+  KernelResourceUsage resource_usage;
 };
 
 //! FusionKernelRuntime is the unified interface from fusion graphs into
@@ -44,9 +72,15 @@ struct ExecutorLog {
 //!  single-kernel and multi-kernel caching/compiling/launching
 class TORCH_CUDA_CU_API FusionKernelRuntime {
  public:
+  //! With `specialize_shapes`, the kernels are compiled for the sizes of the
+  //! tensors in `inputs` only, see Note [ Shape specialization ]
   explicit FusionKernelRuntime(
       Fusion* fusion,
-      const KernelArgumentHolder& inputs);
+      const KernelArgumentHolder& inputs,
+      bool specialize_shapes = false);
+
+  //! Waits for the background compilation started by compileInBackground
+  ~FusionKernelRuntime();
 
   //! Type notations within FusionKernelRuntime Context
   using HashType = size_t;
@@ -55,6 +89,9 @@ class TORCH_CUDA_CU_API FusionKernelRuntime {
   //! Evicts internally cached parameters based on input sizes.
   //!  An interface used by runtime caches.
   void evictCache(size_t input_id) {
+    // executors are selected under `mutex_` from other threads, and guard
+    // their own entries, see Note [ Concurrent runs ]
+    std::lock_guard<std::mutex> guard(mutex_);
     for (auto& fe : executors_) {
       fe.evictCache(input_id);
     }
@@ -78,6 +115,23 @@ class TORCH_CUDA_CU_API FusionKernelRuntime {
   //! starts compilation async
   void startAsyncCompile(KernelArgumentHolder& inputs);
 
+  //! Starts compiling all segments on the compilation thread pool on the
+  //! first call. Returns true once the kernels are compiled, or the
+  //! compilation failed so that a run surfaces the error, and false while it
+  //! is in flight. See Note [ Eager fallback ]
+  bool compileInBackground(const KernelArgumentHolder& args);
+
+  //! compiles all segments that are not compiled yet on the calling thread.
+  //! Runs and other compilations of this runtime wait until it is done.
+  void compileFusion(const KernelArgumentHolder& args);
+
+  //! compiles all segments concurrently. Output sizes of all segments are
+  //! inferred on the unscheduled segments first, so that no segment has to
+  //! wait for the compilation of its producers. Enabled for both the async and
+  //! the first-run synchronous compilation with
+  //! `PYTORCH_NVFUSER_ENABLE=parallel_compile`.
+  void compileFusionParallel(KernelArgumentHolder args);
+
   //! maps entries in `args` to fusion inputs.
   //! Note that this function also pushes extra bits like dimension extent into
   //! `args` for expression evaluator binding. So consider your `args` polluted
@@ -86,14 +140,21 @@ class TORCH_CUDA_CU_API FusionKernelRuntime {
       std::unordered_map<Val*, const ArgAbstract*>& tensor_map,
       KernelArgumentHolder& args);
 
-  //! Unified interface to run the managed kernels with given input
-  std::vector<at::Tensor> runWithInput(KernelArgumentHolder& args);
+  //! Unified interface to run the managed kernels with given input. Outputs
+  //! can only be given for un-segmented fusions, in which case the kernel
+  //! writes to them instead of allocating its own.
+  std::vector<at::Tensor> runWithInput(
+      KernelArgumentHolder& args,
+      const std::vector<at::Tensor>& outputs = {});
 
   //! Turn On/Off profiling
   void profile(bool to_profile = true) {
     profiling_ = to_profile;
   }
 
+  //! Number, compile time and host memory of the kernels compiled so far
+  CompiledKernelStats compiledKernelStats();
+
   //! Internal knob for profiling shape inference
   void disableLaunchParamCache() {
     for (auto& executor : executors_) {
@@ -101,6 +162,20 @@ class TORCH_CUDA_CU_API FusionKernelRuntime {
     }
   }
 
+  //! Recycle up to `ring_size` output sets per input id in all segments, see
+  //! FusionExecutor::setOutputRecycling
+  void setOutputRecycling(size_t ring_size) {
+    for (auto& executor : executors_) {
+      executor.setOutputRecycling(ring_size);
+    }
+  }
+
+  //! Compile the kernels of all segments with fast math, see
+  //! CompileParams::fast_math. Only affects kernels compiled afterwards.
+  void setFastMath(bool fast_math) {
+    fast_math_ = fast_math;
+  }
+
   //! Internal knob for profiling shape inference
   void disableKernelLaunch() {
     for (auto& executor : executors_) {
@@ -113,6 +188,30 @@ class TORCH_CUDA_CU_API FusionKernelRuntime {
     return is_segmented_;
   }
 
+  //! Whether autotuning of one of the groups started on the thread pool and
+  //! hasn't finished yet, see Note [ Background autotuning ]
+  bool isAutotuning() const;
+
+  //! Records `params` in the KernelDb as the winner of autotuning the
+  //! pointwise or reduction group `group_id` for `args`, the arguments of the
+  //! group, like a finished autotuning does. Runtimes compiling the group for
+  //! the same arguments from then on use them, see
+  //! Note [ Background autotuning ]
+  void recordTunedParams(
+      int group_id,
+      const std::shared_ptr<HeuristicParams>& params,
+      const KernelArgumentHolder& args);
+
+  //! Returns if the kernels were compiled for the sizes of a single set of
+  //! inputs, see Note [ Shape specialization ]
+  bool isShapeSpecialized() const {
+    return is_shape_specialized_;
+  }
+
+  //! Returns if the tensors of `args` have the sizes this runtime can run,
+  //! which is any size unless it is shape specialized
+  bool acceptsSizesOf(const KernelArgumentHolder& args) const;
+
   //! Returns the fusion segments if applicable
   SegmentedFusion* fusionSegments() {
     return segmented_fusion_.get();
@@ -123,6 +222,12 @@ class TORCH_CUDA_CU_API FusionKernelRuntime {
     return heuristics_.get();
   }
 
+  //! Durations of the segmentation and heuristics stages of creating this
+  //! runtime. Stages of compiling the kernels are kept by the executors
+  const inst::CompileTimings& compileTimings() const {
+    return compile_timings_;
+  }
+
   //! Return the most recently used executor, corresponding to the
   //!  most recent kernel launch.
   //! TODO: have a interface for grabbing all recent logs. Need to put a buffer
@@ -133,6 +238,13 @@ class TORCH_CUDA_CU_API FusionKernelRuntime {
     return most_recent_executor_log_;
   }
 
+  //! One record per kernel launched by the most recent run, in launch order
+  const std::vector<KernelProfile>& kernelProfiles() const {
+    TORCH_INTERNAL_ASSERT(
+        profiling_, "Kernel profiles are only produced in profiling mode");
+    return kernel_profiles_;
+  }
+
   // Try to compute heuristics based on the SegmentedFusion managed
   //  in this kernel runtime, and will return a nullopt if either
   //  any segment cannot be scheduled or the parameters don't match
@@ -144,6 +256,11 @@ class TORCH_CUDA_CU_API FusionKernelRuntime {
   //!  for kernel launch for a new input dimension but same heuristics
   void updateHeuristicsLaunchParams(FusionHeuristics* update_heuristics);
 
+  //! Copy the launch params of all segments, in the order of the
+  //!  heuristics list
+  void updateHeuristicsLaunchParams(
+      const std::vector<LaunchParams>& launch_params);
+
   const std::vector<FusionExecutor>& executors() const {
     return executors_;
   }
@@ -154,7 +271,16 @@ class TORCH_CUDA_CU_API FusionKernelRuntime {
   //! the kernel outputs.
   std::vector<at::Tensor> runKernelWithInput(
       KernelArgumentHolder& args,
-      SegmentedGroup* sg);
+      SegmentedGroup* sg,
+      const std::vector<at::Tensor>& outputs = {});
+
+  //! Computes the positions of group inputs and fusion outputs in the runtime
+  //! arguments, see Note [ Runtime argument slots ]
+  void prepareArgumentSlots();
+
+  //! Assigns groups of `group_run_order` to streams so that independent
+  //! groups can run concurrently, see Note [ Concurrent segments ]
+  void prepareStreamAssignment();
 
   //! Interface to compile a single kernel, either one kernel for single-kernel
   //! fusions, or a kernel for a segmentedGrouup in a segmented fusion. Returns
@@ -163,11 +289,40 @@ class TORCH_CUDA_CU_API FusionKernelRuntime {
       const KernelArgumentHolder& args,
       SegmentedGroup* sg);
 
+  //! Schedules `fusion_to_run`, the fusion of segment `sg`, and compiles it
+  //! into the executor of the segment. Only touches the executor of `sg`, so
+  //! it can be called concurrently for different segments.
+  void compileSegment(
+      std::unique_ptr<Fusion> fusion_to_run,
+      const KernelArgumentHolder& args,
+      SegmentedGroup* sg);
+
+  //! Compiles the persistent kernel of `sg` again with its persistent
+  //! buffers projected to the inputs if the compiled kernel spills or is
+  //! estimated to spill registers. `fusion` is the unscheduled fusion of the
+  //! segment. See Note [ Register pressure feedback ]
+  void reprojectPersistentBuffers(
+      std::unique_ptr<Fusion> fusion,
+      const KernelArgumentHolder& args,
+      SegmentedGroup* sg);
+
   //! Access the list of schedulers maintained in this runtime instance
   const std::vector<SchedulerEntryPtr>& schedulers();
 
   void prepareRuntimeOrder();
 
+  //! Starts autotuning the kernel of a hot group in the background, see
+  //! Note [ Background autotuning ]
+  void startAutotune(const KernelArgumentHolder& args, SegmentedGroup* sg);
+
+  //! Compiles the kernel of `sg` with the parameters a previous autotuning
+  //! recorded in the KernelDb, if any. `fusion` is the unscheduled fusion of
+  //! the segment. See Note [ Background autotuning ]
+  void restoreTunedKernel(
+      std::unique_ptr<Fusion> fusion,
+      const KernelArgumentHolder& args,
+      SegmentedGroup* sg);
+
  private:
   //! Entries indexed by groupID:
   //! Executors holding compiled kernels
@@ -180,6 +335,15 @@ class TORCH_CUDA_CU_API FusionKernelRuntime {
   //  segmented fusion (true).
   bool is_segmented_ = true;
 
+  //! see isShapeSpecialized
+  bool is_shape_specialized_ = false;
+  //! sizes of the tensor inputs the kernels are specialized for
+  std::vector<int64_t> specialized_sizes_;
+
+  //! SM budget of the thread that created the runtime, which segments are
+  //! scheduled and compiled with, see Note [ Execution policy ]
+  c10::optional<int64_t> sm_budget_;
+
   //! Multi-Kernel fusion segment when applies
   std::unique_ptr<SegmentedFusion> segmented_fusion_ = nullptr;
 
@@ -190,22 +354,94 @@ class TORCH_CUDA_CU_API FusionKernelRuntime {
 
     //! Pre-determined order to bind tensor input meta data
     std::vector<Val*> group_extent_binding_order;
+
+    //! Positions in the runtime arguments of the inputs of each group of
+    //! `group_run_order`, see Note [ Runtime argument slots ]
+    std::vector<std::vector<size_t>> group_input_slots;
+
+    //! Positions in the runtime arguments of fusion outputs, nullopt for
+    //! outputs that are not produced by any group
+    std::vector<c10::optional<size_t>> fusion_output_slots;
+
+    //! Number of runtime arguments after all groups ran
+    size_t num_arg_slots = 0;
+
+    //! Slots of the intermediates whose last reader is each group of
+    //! `group_run_order`, see Note [ Intermediate buffer liveness ]
+    std::vector<std::vector<size_t>> group_released_slots;
+
+    //! Number of streams segments are launched on, see
+    //! Note [ Concurrent segments ]
+    size_t num_streams = 1;
+
+    //! Stream each group of `group_run_order` is launched on, with 0 being
+    //! the current stream
+    std::vector<size_t> group_streams;
+
+    //! Positions in `group_run_order` of the producers of each group
+    std::vector<std::vector<size_t>> group_producers;
+
+    //! Fusion inputs read by more than one group, see
+    //! Note [ L2 persistence of re-read inputs ]
+    std::vector<size_t> reread_input_slots;
+
+    //! Output indices of the slices of each concatenated output with their
+    //! concatenated dimension, see Note [ Cat into output slices ]
+    std::vector<std::pair<std::vector<int>, int64_t>> concat_output_slices;
   } runtime_workspace_;
 
+  //! Side streams independent segments are launched on, created on first use
+  std::vector<c10::cuda::CUDAStream> side_streams_;
+
   //! Utility to speed up value evaluation at runtime
   std::unique_ptr<PrecomputedValues> precomputed_values_;
 
   // States for profiling support
   bool profiling_ = false;
 
+  //! Compile with CompileParams::fast_math, see setFastMath
+  bool fast_math_ = false;
+
   std::mutex mutex_;
   // TODO: remove `compiling_` mutex and rely on `mutex_` only.
   // we don't need the second mutex, if only I could figure out how to pass
   // unique_lock into lambda
   std::mutex compiling_;
 
+  //! Compilation started by compileInBackground, guarded by
+  //! `background_compile_mutex_`
+  std::future<void> background_compile_;
+  std::mutex background_compile_mutex_;
+
   // The heuristics and executor for most recent kernel launch
   ExecutorLog most_recent_executor_log_;
+
+  // Kernels launched by the most recent run in profiling mode
+  std::vector<KernelProfile> kernel_profiles_;
+
+  // See Note [ Compile time instrumentation ]
+  inst::CompileTimings compile_timings_;
+
+  //! Background autotuning of a group, see Note [ Background autotuning ]
+  struct AutotuneState {
+    //! Launches of the group so far
+    int64_t num_runs = 0;
+    //! Set once autotuning started, holds the winning kernel once it is
+    //! ready
+    std::shared_ptr<TunedKernel> tuned_kernel;
+  };
+  //! Indexed by group ID, empty unless autotuning or the KernelDb is
+  //! enabled
+  std::vector<AutotuneState> autotune_states_;
+
+  //! Kernel of a persistent group recompiled with projected persistent
+  //! buffers, see Note [ Register pressure feedback ]
+  struct ReprojectedKernel {
+    std::unique_ptr<FusionExecutor> executor;
+    std::shared_ptr<HeuristicParams> params;
+  };
+  //! Indexed by group ID
+  std::vector<ReprojectedKernel> reprojected_kernels_;
 };
 
 //! Encoding an input set to unique id, which is used to short-cut cache entry
@@ -216,15 +452,31 @@ class TORCH_CUDA_CU_API FusionKernelRuntime {
 //! grow gigantic when we have input shapes that does not stabalize to a finite
 //! set.
 //!
+//! Each input set is summarized by a fixed-width 128-bit signature that is
+//! accumulated while walking the inputs, so a cache hit neither builds a
+//! string nor allocates. The signature is only used to locate a candidate
+//! entry; the candidate is verified against a compact packed key stored at
+//! insertion time, so a hash collision can never alias two input sets.
+//!
+//! The table is split into `num_shards` independently locked shards selected
+//! by the signature, so concurrent callers with different input sets don't
+//! serialize on a single mutex. The table holds up to `max_cache_size`
+//! entries in total, however they are distributed over the shards. The LRU
+//! order is maintained per shard, so once the table is full, a new entry
+//! evicts the least recently used entry of its own shard. New entries of an
+//! empty shard, or entries inserted concurrently into different shards, don't
+//! evict, so the table may hold up to `num_shards - 1` entries more than
+//! `max_cache_size`.
+//!
 //! \note the uniqueness of the ide generated for a given input set is only
 //!   local to the instance of `InputsIdLookup`.
 //!
 class TORCH_CUDA_CU_API InputsIdLookup : public NonCopyable {
  public:
-  //! constructor where maximum cache size is fixed during init
+  //! constructor where maximum cache size and number of shards are fixed
+  //! during init
   // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init,cppcoreguidelines-avoid-magic-numbers)
-  explicit InputsIdLookup(size_t max_cache_size = 100)
-      : max_cache_size_(max_cache_size){};
+  explicit InputsIdLookup(size_t max_cache_size = 100, size_t num_shards = 1);
 
   //! struct to hold return value for lookupId.
   struct IdLookupReturn {
@@ -241,41 +493,155 @@ class TORCH_CUDA_CU_API InputsIdLookup : public NonCopyable {
   IdLookupReturn lookupId(const at::ArrayRef<c10::IValue>& inputs);
 
   //! debugging API that returns the size of lookup table
-  size_t size() const {
-    return encoding_lookup_.size();
-  }
+  size_t size() const;
 
- private:
-  // string to store encoded input meta information. Reuse the buffer instead of
-  // stringtream gives few us perf gain.
-  std::string encoding_; // Note: shared state, guarded by mutex_
+  //! 128-bit signature of an input set
+  struct Signature {
+    uint64_t lo = 0;
+    uint64_t hi = 0;
 
-  // mutex_ used to guard reused encoding_
-  std::mutex mutex_;
+    bool operator==(const Signature& other) const {
+      return lo == other.lo && hi == other.hi;
+    }
+  };
 
-  //! entry stored in `encoding_lookup_` to implement LRU
+ private:
+  struct SignatureHash {
+    size_t operator()(const Signature& sig) const {
+      return static_cast<size_t>(sig.lo ^ (sig.hi * 0x9e3779b97f4a7c15ULL));
+    }
+  };
+
+  //! entry stored in `encoding_lookup` to implement LRU
   // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init)
   struct EncodingEntry {
     size_t id = 0;
-    std::list<std::string>::iterator lru_iter;
+    std::list<Signature>::iterator lru_iter;
+    //! packed meta information of the input set, used to reject signature
+    //! collisions
+    std::vector<int64_t> packed_key;
   };
 
-  //! maximum cache size for LRU
+  //! A independently locked slice of the lookup table
+  struct Shard {
+    // mutex guarding all members of the shard
+    mutable std::mutex mutex;
+
+    //! entry in the cache, This is used to implement LRU cache, where entries
+    //! in the list is ordered by their recent usage (freshly used entry is
+    //! placed at the beginning)
+    std::list<Signature> used_entry;
+
+    //! map from `Signature` to a unique id `size_t` (packaged in
+    //! `EncodingEntry`). We store an iterator to `used_entry` to implement LRU
+    std::unordered_map<Signature, EncodingEntry, SignatureHash>
+        encoding_lookup;
+  };
+
+  //! maximum number of entries held by all shards together
   const size_t max_cache_size_;
 
+  //! number of entries held by all shards together
+  std::atomic<size_t> num_entries_{0};
+
   //! next available unique id, we monotonically increase `current_id_` avoid
   //! conflicts
-  size_t current_id_ = 1;
+  std::atomic<size_t> current_id_{1};
 
-  //! entry in the cache, This is used to implement LRU cache, where entries in
-  //! the list is ordered by their recent usage (freshly used entry is placed at
-  //! the beginning)
-  std::list<std::string> used_entry_;
+  //! shards of the lookup table, indexed by signature
+  std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+//! Shape bucketing policy of a FusionExecutorCache. Heuristics for inputs
+//! that only differ in the sizes of bucketed dimensions within a bucket are
+//! computed for the same canonical sizes, so that a single kernel runtime
+//! serves the whole bucket. See Note [ Shape bucketing ]
+struct TORCH_CUDA_CU_API ShapeBuckets {
+  //! bucketed dimensions as (fusion input index, dimension) pairs
+  std::vector<std::pair<size_t, size_t>> dims;
+  //! ascending upper bounds of the buckets. Sizes larger than the last bound,
+  //! or all sizes if there are no bounds, are bucketed by powers of two
+  std::vector<int64_t> bounds;
+
+  bool empty() const {
+    return dims.empty();
+  }
+
+  //! canonical size the heuristics are computed for
+  int64_t canonicalSize(int64_t size) const;
+};
 
-  //! map from `std::string` to a unique id `size_t` (packaged in
-  //! `EncodingEntry`
-  //! ). We store an iterator to `used_entry_` to implement LRU
-  std::unordered_map<std::string, EncodingEntry> encoding_lookup_;
+//! How the kernels of a FusionExecutorCache share the GPU with other work,
+//! e.g. the fusions of other serving tenants. See Note [ Execution policy ]
+struct TORCH_CUDA_CU_API ExecutionPolicy {
+  //! launch on a high priority stream of the pool, ordered after the work
+  //! of the current stream, instead of on the current stream
+  bool high_priority_stream = false;
+  //! number of SMs the heuristics size grids for, nullopt for all SMs of the
+  //! device
+  c10::optional<int64_t> sm_budget = c10::nullopt;
+};
+
+class FusionExecutorCache;
+
+//! Kernels compiled by a FusionExecutorCache, see
+//! FusionExecutorCache::compiledKernelStats
+struct CompiledKernelStats {
+  size_t num_kernels = 0;
+  //! total duration of the compilations of the kernels
+  double compile_ms = 0;
+  //! host memory held by the code and the binaries of the kernels
+  size_t host_bytes = 0;
+};
+
+//! Result of FusionExecutorCache::planFusionWithInputs, see
+//! Note [ Meta execution ]
+struct MetaExecution {
+  //! Tensors on the meta device with the sizes, strides and dtypes of the
+  //! outputs runFusionWithInputs returns for the same inputs
+  std::vector<at::Tensor> outputs;
+  //! Kernel runtime holding the segmentation and the heuristics picked for
+  //! the inputs, nullptr if there is no CUDA device to pick them for. Owned
+  //! by the FusionExecutorCache
+  FusionKernelRuntime* kernel_runtime = nullptr;
+};
+
+//! Handle that re-runs a FusionExecutorCache for inputs of a fixed signature,
+//! i.e. of the sizes, strides, alignment and devices of the inputs it was
+//! bound to. The input id and the kernel runtime are resolved once by
+//! FusionExecutorCache::bind, so runs skip the input id lookup and the runtime
+//! selection, see Note [ Bound executions ]. Only valid as long as the
+//! FusionExecutorCache it was bound by.
+class TORCH_CUDA_CU_API BoundExecution {
+ public:
+  //! Whether `inputs` have the signature the execution is bound to
+  bool matches(const at::ArrayRef<c10::IValue>& inputs) const;
+
+  //! Same as FusionExecutorCache::runFusionWithInputs, `inputs` have to match
+  //! the bound signature
+  std::vector<at::Tensor> run(
+      const at::ArrayRef<c10::IValue>& inputs,
+      const std::vector<at::Tensor>& outputs = {}) const;
+
+  FusionKernelRuntime* kernelRuntime() const {
+    return kernel_runtime_;
+  }
+
+ private:
+  friend class FusionExecutorCache;
+
+  BoundExecution(
+      FusionExecutorCache* fec,
+      FusionKernelRuntime* kernel_runtime,
+      size_t cache_id,
+      std::vector<int64_t> packed_key);
+
+  FusionExecutorCache* fec_ = nullptr;
+  FusionKernelRuntime* kernel_runtime_ = nullptr;
+  //! input id the kernel runtime was selected for
+  size_t cache_id_ = 0;
+  //! encoding of the bound inputs, see InputsIdLookup
+  std::vector<int64_t> packed_key_;
 };
 
 //! [ Note -- 2 level cache implementation ]
@@ -339,8 +705,31 @@ class TORCH_CUDA_CU_API FusionExecutorCache {
   //! Execute fusion graph with given inputs, create `FusionExecutor` as needed
   //! Note this function also handles permutation & input update outside of
   //! codegen.
+  //!
+  //! `outputs` optionally provides preallocated output tensors that the
+  //! kernel writes to in place. They have to match the sizes, strides and
+  //! types the fusion produces for the given inputs, and are only supported
+  //! for fusions that are not segmented and have neither permuted nor
+  //! aliased outputs.
   std::vector<at::Tensor> runFusionWithInputs(
-      const at::ArrayRef<c10::IValue>& inputs);
+      const at::ArrayRef<c10::IValue>& inputs,
+      const std::vector<at::Tensor>& outputs = {});
+
+  //! Runs a fusion whose tensors don't fit on the device as chunks of
+  //! `chunk_rows` rows of their outermost dimension. Tensor inputs may be on
+  //! the host, ideally in pinned memory, and are copied to the device chunk
+  //! by chunk on a separate stream, while the previous chunk runs. Outputs
+  //! are returned in pinned host memory. Only fusions that compute their
+  //! rows independently of each other are supported, see
+  //! Note [ Streamed execution ]
+  std::vector<at::Tensor> runFusionStreamed(
+      const at::ArrayRef<c10::IValue>& inputs,
+      int64_t chunk_rows);
+
+  //! Resolves the input id and the kernel runtime of `inputs` once, so that
+  //! inputs of the same signature can be run without looking them up again.
+  //! Compiles the kernels on the first run like runFusionWithInputs.
+  BoundExecution bind(const at::ArrayRef<c10::IValue>& inputs);
 
   Fusion* fusion() {
     return fusion_.get();
@@ -355,15 +744,24 @@ class TORCH_CUDA_CU_API FusionExecutorCache {
   }
 
   FusionKernelRuntime* getMostRecentKernelRuntime() {
-    return most_recent_runtime_;
+    return most_recent_runtime_.load();
   }
 
   // TODO: in a follow up we need a global logging structure
   //  to capture runtime profiling info. We also need to define
   //  a suitable profiling window / buffer size.
   ExecutorLog getMostRecentExecutorInfo() {
-    TORCH_INTERNAL_ASSERT(most_recent_runtime_ != nullptr);
-    return most_recent_runtime_->getMostRecentExecutorLog();
+    auto most_recent_runtime = most_recent_runtime_.load();
+    TORCH_INTERNAL_ASSERT(most_recent_runtime != nullptr);
+    return most_recent_runtime->getMostRecentExecutorLog();
+  }
+
+  //! Kernels launched by the most recent run, see
+  //! FusionKernelRuntime::kernelProfiles
+  std::vector<KernelProfile> getMostRecentKernelProfiles() {
+    auto most_recent_runtime = most_recent_runtime_.load();
+    TORCH_INTERNAL_ASSERT(most_recent_runtime != nullptr);
+    return most_recent_runtime->kernelProfiles();
   }
 
   void profile(bool to_profile) {
@@ -375,6 +773,100 @@ class TORCH_CUDA_CU_API FusionExecutorCache {
     }
   }
 
+  //! Set the shape bucketing policy used to select and create kernel runtimes
+  //! for new input ids. Meant to be set before the first run, runtimes that
+  //! already exist keep the heuristics they were created with.
+  void setShapeBuckets(ShapeBuckets shape_buckets) {
+    std::lock_guard<std::mutex> guard(kernel_runtimes_mutex_);
+    shape_buckets_ = std::move(shape_buckets);
+  }
+
+  //! Compile kernels specialized for the sizes of the first `max_shapes`
+  //! distinct sets of input sizes that miss the existing runtimes, with the
+  //! extents of the inputs baked in as constants. Later sizes get generic
+  //! runtimes. Ignored with shape bucketing. See
+  //! Note [ Shape specialization ]
+  void setShapeSpecialization(size_t max_shapes) {
+    std::lock_guard<std::mutex> guard(kernel_runtimes_mutex_);
+    max_specialized_shapes_ = max_shapes;
+  }
+
+  //! Number of new input ids that re-used a kernel runtime thanks to shape
+  //! bucketing, i.e. whose actual sizes don't match its heuristics. Ids
+  //! served by the heuristic lookup count if their sizes aren't canonical
+  size_t numCompilesAvoided() const {
+    return num_compiles_avoided_.load();
+  }
+
+  //! Kernel runtime lookups of input ids that were mapped to a runtime
+  //! already, and of the others. See Note [ Runtime metrics ] for the totals
+  //! of the process
+  size_t numRuntimeCacheHits() const {
+    return num_runtime_cache_hits_.load(std::memory_order_relaxed);
+  }
+
+  size_t numRuntimeCacheMisses() const {
+    return num_runtime_cache_misses_.load(std::memory_order_relaxed);
+  }
+
+  //! Opt into recycling of output tensors for steady-state loops. Up to
+  //! `ring_size` output sets are kept per input id and are handed out again
+  //! once the caller dropped all references to them, which skips the
+  //! allocator for outputs. See Note [ Output recycling ]. 0 disables it.
+  void setOutputRecycling(size_t ring_size) {
+    output_ring_size_ = ring_size;
+    for (auto& it : kernel_runtimes_) {
+      for (auto& kernel_runtime : it.second) {
+        kernel_runtime->setOutputRecycling(ring_size);
+      }
+    }
+  }
+
+  //! Compile the kernels of this fusion with hardware approximations of
+  //! transcendental functions, see Note [ Fast math ] in executor_utils.cpp.
+  //! Meant to be set before the first run, runtimes that already compiled
+  //! their kernels keep them.
+  void setFastMath(bool fast_math) {
+    fast_math_ = fast_math;
+    for (auto& it : kernel_runtimes_) {
+      for (auto& kernel_runtime : it.second) {
+        kernel_runtime->setFastMath(fast_math);
+      }
+    }
+  }
+
+  //! Run input sets whose kernels aren't compiled yet with ATen ops while
+  //! the kernels compile in the background, instead of waiting for them.
+  //! Only fusions interpretFusion supports fall back, see
+  //! Note [ Eager fallback ]
+  void setEagerFallback(bool eager_fallback) {
+    eager_fallback_ = eager_fallback;
+  }
+
+  //! Return the static output buffers of CUDA graph replays instead of
+  //! copies of them. The outputs of a replay are then overwritten by the
+  //! next replay of the same input set, see Note [ CUDA graph replay ]
+  void setCudaGraphStaticOutputs(bool static_outputs) {
+    cuda_graph_static_outputs_ = static_outputs;
+  }
+
+  //! Set the stream priority and SM budget of the kernels. Meant to be set
+  //! before the first run, runtimes that already exist keep the heuristics
+  //! they were created with. See Note [ Execution policy ]
+  void setExecutionPolicy(ExecutionPolicy execution_policy) {
+    std::lock_guard<std::mutex> guard(kernel_runtimes_mutex_);
+    execution_policy_ = std::move(execution_policy);
+  }
+
+  const ExecutionPolicy& executionPolicy() const {
+    return execution_policy_;
+  }
+
+  //! Number of runs that fell back to ATen while their kernels compiled
+  size_t numEagerRuns() const {
+    return num_eager_runs_.load(std::memory_order_relaxed);
+  }
+
   //! Internal knob for profiling shape inference
   void disableLaunchParamCache() {
     for (auto& it : kernel_runtimes_) {
@@ -406,6 +898,22 @@ class TORCH_CUDA_CU_API FusionExecutorCache {
   //! experimental at this moment, please use with extra caution.
   void compileFusionAsync(const at::ArrayRef<c10::IValue>& inputs);
 
+  //! compiles kernels ahead of time for each set of inputs in
+  //! `input_signatures`, e.g. to warm up a replica before it serves traffic.
+  //! Only sizes, strides and dtypes of tensors matter, so tensors on the
+  //! meta device can stand in for real inputs; they are materialized
+  //! uninitialized on the current device. Runtimes are looked up serially
+  //! and compiled concurrently on the compilation thread pool. Compiled
+  //! kernels go into the KernelDb when it is enabled. Returns once all
+  //! kernels are compiled.
+  void compileFusionForInputs(
+      const std::vector<std::vector<c10::IValue>>& input_signatures);
+
+  //! Infers the outputs of a run with `inputs` without compiling or launching
+  //! anything, see Note [ Meta execution ]. Tensor inputs may be on the meta
+  //! device.
+  MetaExecution planFusionWithInputs(const at::ArrayRef<c10::IValue>& inputs);
+
  private:
   //! evict cached short cut entry in `code_to_fe_lookup_` as well as cached
   //! entry in `FusionExecutor`
@@ -413,7 +921,92 @@ class TORCH_CUDA_CU_API FusionExecutorCache {
 
   FusionKernelRuntime* getKernelRuntimeFor(const KernelArgumentHolder& inputs);
 
+  //! Counts a kernel runtime lookup in the cache and in RuntimeMetrics
+  void recordRuntimeCacheHit(bool hit);
+
+  //! Copy of `args` with the bucketed dimensions of tensors replaced by their
+  //! canonical sizes, see Note [ Shape bucketing ]
+  KernelArgumentHolder bucketArgs(const KernelArgumentHolder& args) const;
+
+  //! Publishes a copy of `id_to_kernel_runtime_` with `cache_id` mapped to
+  //! `kernel_runtime`, or erased if it is nullptr. Requires
+  //! `kernel_runtimes_mutex_` to be held.
+  void updateKernelRuntimeId(
+      size_t cache_id,
+      FusionKernelRuntime* kernel_runtime);
+
+  //! Throws if preallocated `outputs` are given for a fusion that permutes or
+  //! aliases its outputs
+  void checkPreallocatedOutputs(const std::vector<at::Tensor>& outputs) const;
+
+  //! Whether the fusion computes the rows of its outermost dimension
+  //! independently of each other, see Note [ 32-bit indexed chunks ]
+  bool canRunInChunks();
+
+  //! Whether the fusion can run with ATen ops while its kernels compile, see
+  //! Note [ Eager fallback ]
+  bool canRunEagerly();
+
+  //! Runs `inputs`, whose `args` need 64-bit indexing, as chunks of rows that
+  //! are indexed with 32 bits. Returns c10::nullopt if they can't be split,
+  //! see Note [ 32-bit indexed chunks ]
+  c10::optional<std::vector<at::Tensor>> runInChunks(
+      const at::ArrayRef<c10::IValue>& inputs,
+      const KernelArgumentHolder& args);
+
+  //! Permutes the inputs of the fusion that are stored in a permuted layout.
+  //! Returns `inputs` if there is nothing to permute, otherwise the permuted
+  //! copy stored in `inputs_vec`
+  at::ArrayRef<c10::IValue> permuteInputs(
+      const at::ArrayRef<c10::IValue>& inputs,
+      std::vector<c10::IValue>& inputs_vec) const;
+
+  //! Launches `kernel_runtime` for the prepared `args` and maps the results
+  //! back to the outputs of the fusion
+  std::vector<at::Tensor> runKernelRuntime(
+      FusionKernelRuntime* kernel_runtime,
+      const at::ArrayRef<c10::IValue>& inputs,
+      const at::ArrayRef<c10::IValue>& perm_inputs,
+      KernelArgumentHolder& args,
+      const std::vector<at::Tensor>& outputs);
+
+  //! Runs `inputs` with the kernel runtime and input id resolved by `bound`
+  friend class BoundExecution;
+  std::vector<at::Tensor> runBound(
+      const BoundExecution& bound,
+      const at::ArrayRef<c10::IValue>& inputs,
+      const std::vector<at::Tensor>& outputs);
+
+  //! Runs `kernel_runtime` through the CUDA graph cached for the input id of
+  //! `args`, capturing it on the first call. Returns c10::nullopt if the input
+  //! set can't be replayed. See Note [ CUDA graph replay ]
+  c10::optional<std::vector<at::Tensor>> runWithCudaGraph(
+      FusionKernelRuntime* kernel_runtime,
+      const at::ArrayRef<c10::IValue>& inputs,
+      KernelArgumentHolder& args);
+
  private:
+  //! CUDA graph replaying the launches of all segments for one input set
+  struct CudaGraphEntry {
+    //! modules whose functions the graph replays, declared before the graph
+    //! so they stay loaded until it is destroyed, see
+    //! Note [ Loaded kernel budget ]
+    executor_utils::KernelModulePins module_pins;
+    at::cuda::CUDAGraph graph;
+    //! false if the input set can't be captured, e.g. because of overlapping
+    //! tensor inputs that can't be bound by a copy
+    bool replayable = true;
+    //! buffers the graph reads the tensor inputs from, undefined for scalars
+    std::vector<at::Tensor> static_inputs;
+    //! scalar inputs, including CPU scalar tensors, baked into the graph
+    std::vector<c10::IValue> scalar_inputs;
+    //! outputs written by each replay
+    std::vector<at::Tensor> static_outputs;
+    //! recorded after the last replay and the copies of its outputs, so that
+    //! the static buffers aren't overwritten before they are read
+    at::cuda::CUDAEvent last_use;
+  };
+
   //! original un-scheduled `Fusion`;
   std::unique_ptr<Fusion> fusion_;
 
@@ -427,16 +1020,87 @@ class TORCH_CUDA_CU_API FusionExecutorCache {
   //! Logging state for most recent compilation
   bool profiling_ = false;
 
+  //! Number of output sets recycled per input id, see setOutputRecycling
+  size_t output_ring_size_ = 0;
+
+  //! Whether kernels are compiled with fast math, see setFastMath
+  bool fast_math_ = false;
+
+  //! see setEagerFallback
+  std::atomic<bool> eager_fallback_{false};
+
+  //! see setCudaGraphStaticOutputs
+  std::atomic<bool> cuda_graph_static_outputs_{false};
+
+  //! see setExecutionPolicy
+  ExecutionPolicy execution_policy_;
+
+  //! see canRunEagerly
+  std::once_flag eager_flag_;
+  bool eager_ = false;
+
+  //! see numEagerRuns
+  std::atomic<size_t> num_eager_runs_{0};
+
   //! Logging state for most recent compilation
   ExecutorLog most_recent_executor_log_;
 
-  //! short-cut for cache hit
-  std::unordered_map<size_t, FusionKernelRuntime*> id_to_kernel_runtime_;
+  using KernelRuntimeIdMap = std::unordered_map<size_t, FusionKernelRuntime*>;
+
+  //! short-cut for cache hit. Immutable snapshot that is replaced as a whole
+  //! on updates, so it can be read without locking, see
+  //! Note [ Kernel runtime selection ]
+  std::shared_ptr<const KernelRuntimeIdMap> id_to_kernel_runtime_ =
+      std::make_shared<const KernelRuntimeIdMap>();
+
+  //! serializes updates of `id_to_kernel_runtime_` and `kernel_runtimes_`
+  std::mutex kernel_runtimes_mutex_;
+
+  //! see setShapeBuckets
+  ShapeBuckets shape_buckets_;
+
+  //! see setShapeSpecialization
+  size_t max_specialized_shapes_ = 0;
+  size_t num_specialized_shapes_ = 0;
+
+  //! see canRunInChunks
+  std::once_flag chunkable_flag_;
+  bool chunkable_ = false;
+  //! whether each input has the rows of the chunks as outermost dimension
+  std::vector<bool> input_has_rows_;
+
+  //! see numCompilesAvoided
+  std::atomic<size_t> num_compiles_avoided_{0};
+
+  //! see numRuntimeCacheHits and numRuntimeCacheMisses
+  std::atomic<size_t> num_runtime_cache_hits_{0};
+  std::atomic<size_t> num_runtime_cache_misses_{0};
+
+  //! Kernel runtime re-used for a set of heuristic arguments
+  struct HeuristicLookupEntry {
+    FusionKernelRuntime* kernel_runtime = nullptr;
+    //! launch params of all segments computed for the arguments
+    std::vector<LaunchParams> launch_params;
+  };
+
+  //! Runtime selections keyed by the encoding of the heuristic arguments,
+  //! see Note [ Heuristic lookup ]. Guarded by `kernel_runtimes_mutex_`
+  std::unordered_map<
+      std::vector<int64_t>,
+      HeuristicLookupEntry,
+      c10::hash<std::vector<int64_t>>>
+      heuristic_lookup_;
+
+  //! CUDA graphs captured per input id, see Note [ CUDA graph replay ]
+  std::unordered_map<size_t, std::unique_ptr<CudaGraphEntry>> cuda_graphs_;
+
+  //! serializes captures and replays, and guards `cuda_graphs_`
+  std::mutex cuda_graphs_mutex_;
 
   //! Profiling info:
   //! TODO: this can be largely expanded to look at complete
   //!   caching profiles. Currently it just makes it easier to test
-  FusionKernelRuntime* most_recent_runtime_ = nullptr;
+  std::atomic<FusionKernelRuntime*> most_recent_runtime_{nullptr};
 };
 
 class GraphCache {
@@ -448,7 +1112,8 @@ class GraphCache {
   //! Fusion IR.
   explicit GraphCache(const std::shared_ptr<torch::jit::Graph>& graph);
 
-  //! execute graph with given inputs
+  //! execute graph with given inputs, the runs of a GraphCache are
+  //! serialized
   std::vector<at::Tensor> runGraphWithInputs(
       const at::ArrayRef<c10::IValue>& inputs);
 
@@ -462,6 +1127,9 @@ class GraphCache {
 
   //! num of outputs
   size_t num_of_outputs_ = 0;
+
+  //! FusionExecutorCache is not thread safe
+  std::mutex mutex_;
 };
 
 } // namespace nvfuser
@@ -5,8 +5,17 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 // clang-format on
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
 #include <mutex>
 #include <regex>
+#include <sstream>
 
 #include <instrumentation.h>
 #include <kernel_db/kernel_db.h>
@@ -17,6 +26,149 @@ namespace nvfuser {
 
 static std::mutex kernel_db_lock;
 
+// Note [ Kernel DB layout ]
+//
+// A db directory holds the cuda file and the cubin of every kernel, named by
+// the content hash of the kernel code and compile args, which include the
+// target architecture. The entries are recorded in two append-only logs:
+//   - a binary index of length-prefixed records keyed by the content hash.
+//     Opening a db only reads these records, so neither the kernel code
+//     files have to be read nor giant strings be hashed on startup;
+//   - a csv file with the same information, which is human readable and
+//     restores the db if there is no index yet, e.g. for db directories
+//     created before the index existed.
+// Cubins and cuda files are memory mapped when queried, sharing the page
+// cache between all processes using the db.
+//
+// Multiple processes, e.g. the ranks on one node, can share a db. All of them
+// take a lock file with flock: shared to read the index, exclusive to open
+// and to write. A writer first reads the records appended by other processes,
+// writes the kernel files under temporary names that are renamed into place,
+// and finally appends the record, so readers never see a record before its
+// files are complete. A query that misses reads the records appended since
+// the last read before giving up.
+//
+// A third append-only log of fixed size records holds the scheduling
+// decisions of fusions, see Note [ Persistent scheduling decisions ] in
+// kernel_cache.cpp. It doesn't refer to any kernel file, so it is kept when
+// the rest of a corrupted db is reset.
+
+namespace {
+
+const char kTxtFileHeader[] =
+    "kernel_signature,compile_args,kernel_code_file,cubin_file";
+const char kIndexMagic[] = "NVFKDB01";
+constexpr size_t kIndexMagicSize = sizeof(kIndexMagic) - 1;
+const char kHeuristicsMagic[] = "NVFKDBH1";
+constexpr size_t kHeuristicsMagicSize = sizeof(kHeuristicsMagic) - 1;
+
+//! flock based lock of a file shared between processes
+class DbFileLock {
+ public:
+  DbFileLock(const fs::path& path, bool exclusive) {
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT, 0666);
+    if (fd_ >= 0 && ::flock(fd_, exclusive ? LOCK_EX : LOCK_SH) != 0) {
+      ::close(fd_);
+      fd_ = -1;
+    }
+  }
+
+  ~DbFileLock() {
+    if (fd_ >= 0) {
+      ::flock(fd_, LOCK_UN);
+      ::close(fd_);
+    }
+  }
+
+  DbFileLock(const DbFileLock&) = delete;
+  DbFileLock& operator=(const DbFileLock&) = delete;
+
+  bool locked() const {
+    return fd_ >= 0;
+  }
+
+ private:
+  int fd_ = -1;
+};
+
+//! Stable FNV-1a hash of the kernel code and compile args, given the
+//! fnv1a_hash of the kernel code
+uint64_t hashKernel(uint64_t kernel_code_hash, const std::string& compile_args) {
+  // separator, so that moving characters between code and args changes the
+  // hash
+  const uint64_t hash = fnv1a_hash("\xff", kernel_code_hash);
+  return fnv1a_hash(compile_args, hash);
+}
+
+uint64_t hashKernel(
+    const std::string& kernel_code,
+    const std::string& compile_args) {
+  return hashKernel(fnv1a_hash(kernel_code), compile_args);
+}
+
+std::string hashToString(uint64_t hash) {
+  std::stringstream ss;
+  ss << std::hex << std::setw(16) << std::setfill('0') << hash;
+  return ss.str();
+}
+
+void appendField(std::string& record, const void* data, size_t size) {
+  record.append(static_cast<const char*>(data), size);
+}
+
+void appendString(std::string& record, const std::string& str) {
+  const auto size = static_cast<uint32_t>(str.size());
+  appendField(record, &size, sizeof(size));
+  record += str;
+}
+
+//! Reads a field at `pos` of `buffer`, returns false if it is truncated
+template <typename T>
+bool readField(const std::vector<char>& buffer, size_t& pos, T& value) {
+  if (pos + sizeof(T) > buffer.size()) {
+    return false;
+  }
+  std::memcpy(&value, buffer.data() + pos, sizeof(T));
+  pos += sizeof(T);
+  return true;
+}
+
+bool readString(
+    const std::vector<char>& buffer,
+    size_t& pos,
+    std::string& str) {
+  uint32_t size = 0;
+  if (!readField(buffer, pos, size) || pos + size > buffer.size()) {
+    return false;
+  }
+  str.assign(buffer.data() + pos, size);
+  pos += size;
+  return true;
+}
+
+//! Writes a file under a temporary name and renames it into place, so that
+//! other processes never see a partially written file
+template <typename T>
+bool writeFileAtomically(
+    const fs::path& file_path,
+    const T& src,
+    bool (*copy_to_file)(const std::string&, const T&)) {
+  fs::path tmp_path = file_path;
+  tmp_path += ".tmp" + std::to_string(::getpid());
+  if (!copy_to_file(tmp_path.string(), src)) {
+    return false;
+  }
+  std::error_code error;
+  fs::rename(tmp_path, file_path, error);
+  if (error) {
+    fs::remove(tmp_path, error);
+    return false;
+  }
+  return true;
+}
+
+} // namespace
+
 KernelDb::KernelDb(bool _disabled)
     : disabled_(_disabled),
       initialized_(false),
@@ -52,8 +204,14 @@ KernelDb& KernelDb::get(
     singleton.disabled_ = true;
     singleton.initialized_ = false;
     singleton.kernel_map_.clear();
+    singleton.heuristic_map_.clear();
     singleton.kernel_db_path_.clear();
     singleton.kernel_db_txt_file_.clear();
+    singleton.kernel_db_index_file_.clear();
+    singleton.kernel_db_heuristics_file_.clear();
+    singleton.kernel_db_lock_file_.clear();
+    singleton.index_offset_ = 0;
+    singleton.heuristics_offset_ = 0;
   }
 
   singleton.disabled_ = disabled;
@@ -83,8 +241,7 @@ bool KernelDb::open(
     const std::string& kernel_db_file,
     bool use_temp_dir) {
   FUSER_PERF_SCOPE("KernelDb::open");
-  const std::string header(
-      "kernel_signature,compile_args,kernel_code_file,cubin_file");
+  const std::string header(kTxtFileHeader);
 
   // The KernelDb directory is queried and created if it doesn't exist
   {
@@ -96,7 +253,8 @@ bool KernelDb::open(
     }
     if (!fs::is_directory(kernel_db_path_)) {
       try {
-        fs::create_directory(kernel_db_path_);
+        // Another process might create the directory concurrently
+        fs::create_directories(kernel_db_path_);
       } catch (const std::exception& e) {
         TORCH_WARN(
             "Unable to create nvFuser Kernel DB directory! ",
@@ -107,161 +265,380 @@ bool KernelDb::open(
     }
   }
 
-  // The CSV file that captures the db is read if it exists
+  kernel_db_txt_file_ = kernel_db_path_ / kernel_db_file;
+  const auto db_name = fs::path(kernel_db_file).stem().string();
+  kernel_db_index_file_ = kernel_db_path_ / (db_name + ".idx");
+  kernel_db_heuristics_file_ =
+      kernel_db_path_ / (db_name + "_heuristics.idx");
+  kernel_db_lock_file_ = kernel_db_path_ / (db_name + ".lock");
+
+  DbFileLock lock(kernel_db_lock_file_, /*exclusive=*/true);
+  if (!lock.locked()) {
+    TORCH_WARN(
+        "Kernel DB: Unable to lock ", kernel_db_lock_file_.string(), "!");
+    return false;
+  }
+
   {
-    FUSER_PERF_SCOPE("KernelDb::open::read_db_txt_file");
+    FUSER_PERF_SCOPE("KernelDb::open::read_db_heuristics_file");
+    if (!openHeuristics()) {
+      TORCH_WARN(
+          "Kernel DB: Unable to create heuristics file: ",
+          kernel_db_heuristics_file_.string());
+      return false;
+    }
+  }
 
-    kernel_db_txt_file_ = kernel_db_path_ / kernel_db_file;
-    if (fs::is_regular_file(kernel_db_txt_file_)) {
-      std::ifstream in_file(kernel_db_txt_file_.c_str(), std::ios::in);
-      if (in_file) {
-        bool matched_header = false;
-        bool read_db_file = true;
-        std::regex db_line_regex(
-            "^([\\w-]+),([\\w -\\=]+),([\\w-\\/]+\\.cu),([\\w-\\/]+\\.cubin)$");
-        for (std::string line; std::getline(in_file, line);) {
-          if (!matched_header) {
-            if (line.compare(header) == 0) {
-              matched_header = true;
-            } else {
-              // Header is corrupted or badly formed
-              TORCH_WARN(
-                  "Kernel DB: CSV file header is corrupted or badly formed - Resetting!: ",
-                  line);
-              read_db_file = false;
-              break;
-            }
-          } else {
-            std::smatch db_line_match;
-            if (std::regex_match(line, db_line_match, db_line_regex)) {
-              if (db_line_match.size() == 5) {
-                KernelDbEntry temp{
-                    db_line_match[1],
-                    db_line_match[2],
-                    db_line_match[3],
-                    db_line_match[4]};
-
-                fs::path code_path = kernel_db_path_ / temp.kernel_code_file;
-                std::string code;
-                if (copy_from_text_file(code_path.string(), code)) {
-                  kernel_map_[code] = temp;
-                } else {
-                  TORCH_WARN(
-                      "Kernel DB: Unable to copy cuda file: ",
-                      code_path.string());
-                }
-              }
-            } else {
-              TORCH_WARN("Kernel DB: CSV line Doesn't match: ", line);
-            }
-          }
-        }
-        if (read_db_file) {
-          return true;
-        }
+  // The binary index is read if it exists
+  if (fs::is_regular_file(kernel_db_index_file_)) {
+    FUSER_PERF_SCOPE("KernelDb::open::read_db_index_file");
+    if (readIndex()) {
+      return true;
+    }
+    TORCH_WARN(
+        "Kernel DB: Index file is corrupted - Resetting!: ",
+        kernel_db_index_file_.string());
+    kernel_map_.clear();
+    index_offset_ = 0;
+  } else if (fs::is_regular_file(kernel_db_txt_file_)) {
+    // The CSV file that captures the db is read if there is no index, and the
+    // index is created from it
+    FUSER_PERF_SCOPE("KernelDb::open::read_db_txt_file");
+    if (readTxtFile()) {
+      bool status = copy_to_text_file(
+          kernel_db_index_file_.string(),
+          std::string(kIndexMagic, kIndexMagicSize));
+      for (const auto& entry : kernel_map_) {
+        status = status && appendIndex(entry.first, entry.second);
       }
+      if (status && readIndex()) {
+        return true;
+      }
+      TORCH_WARN(
+          "Kernel DB: Unable to create index file: ",
+          kernel_db_index_file_.string());
+      std::error_code error;
+      fs::remove(kernel_db_index_file_, error);
+      return false;
     }
+    kernel_map_.clear();
   }
 
-  // If reading of the CSV file was successful, the rest of this method
+  // If reading the index or CSV file was successful, the rest of this method
   // is skipped
 
-  // Remove all files from directory if valid db txt file was not found
+  // Remove all files from directory if a valid db was not found
   for (const auto& dir_entry : fs::directory_iterator(kernel_db_path_)) {
     const fs::path& path = dir_entry.path();
-    if (fs::is_regular_file(path)) {
+    if (fs::is_regular_file(path) && path != kernel_db_heuristics_file_) {
       if (path.extension() == ".cubin" || path.extension() == ".cu" ||
-          path.extension() == ".csv") {
+          path.extension() == ".csv" || path.extension() == ".idx") {
         fs::remove(path);
       }
     }
   }
 
-  // Create an empty db csv file
+  // Create an empty db csv file and index
   {
     FUSER_PERF_SCOPE("KernelDb::open::create_db_txt_file");
 
-    if (copy_to_text_file(kernel_db_txt_file_, header + "\n")) {
-      return true;
+    if (copy_to_text_file(kernel_db_txt_file_, header + "\n") &&
+        copy_to_text_file(
+            kernel_db_index_file_.string(),
+            std::string(kIndexMagic, kIndexMagicSize))) {
+      return readIndex();
     }
   }
   return false;
 }
 
+bool KernelDb::readTxtFile() {
+  const std::string header(kTxtFileHeader);
+  std::ifstream in_file(kernel_db_txt_file_.c_str(), std::ios::in);
+  if (!in_file) {
+    return false;
+  }
+  bool matched_header = false;
+  std::regex db_line_regex(
+      "^([\\w-]+),([\\w -\\=]+),([\\w-\\/]+\\.cu),([\\w-\\/]+\\.cubin)$");
+  for (std::string line; std::getline(in_file, line);) {
+    if (!matched_header) {
+      if (line.compare(header) == 0) {
+        matched_header = true;
+      } else {
+        // Header is corrupted or badly formed
+        TORCH_WARN(
+            "Kernel DB: CSV file header is corrupted or badly formed - Resetting!: ",
+            line);
+        return false;
+      }
+    } else {
+      std::smatch db_line_match;
+      if (std::regex_match(line, db_line_match, db_line_regex)) {
+        if (db_line_match.size() == 5) {
+          KernelDbEntry temp{
+              db_line_match[1],
+              db_line_match[2],
+              db_line_match[3],
+              db_line_match[4]};
+
+          fs::path code_path = kernel_db_path_ / temp.kernel_code_file;
+          std::string code;
+          if (copy_from_text_file(code_path.string(), code)) {
+            kernel_map_[hashKernel(code, temp.compile_args)] = temp;
+          } else {
+            TORCH_WARN(
+                "Kernel DB: Unable to copy cuda file: ", code_path.string());
+          }
+        }
+      } else {
+        TORCH_WARN("Kernel DB: CSV line Doesn't match: ", line);
+      }
+    }
+  }
+  return true;
+}
+
+bool KernelDb::readIndex() {
+  std::vector<char> buffer;
+  if (!copy_from_binary_file(kernel_db_index_file_.string(), buffer)) {
+    return false;
+  }
+  if (buffer.size() < kIndexMagicSize ||
+      std::memcmp(buffer.data(), kIndexMagic, kIndexMagicSize) != 0) {
+    return false;
+  }
+  size_t pos = std::max(index_offset_, kIndexMagicSize);
+  while (pos < buffer.size()) {
+    uint64_t kernel_hash = 0;
+    KernelDbEntry entry;
+    size_t record_pos = pos;
+    // A truncated record is left for the next read
+    if (!readField(buffer, record_pos, kernel_hash) ||
+        !readString(buffer, record_pos, entry.kernel_signature) ||
+        !readString(buffer, record_pos, entry.compile_args) ||
+        !readString(buffer, record_pos, entry.kernel_code_file) ||
+        !readString(buffer, record_pos, entry.cubin_file)) {
+      break;
+    }
+    kernel_map_[kernel_hash] = std::move(entry);
+    pos = record_pos;
+  }
+  index_offset_ = pos;
+  return true;
+}
+
+bool KernelDb::appendIndex(uint64_t kernel_hash, const KernelDbEntry& entry) {
+  std::string record;
+  appendField(record, &kernel_hash, sizeof(kernel_hash));
+  appendString(record, entry.kernel_signature);
+  appendString(record, entry.compile_args);
+  appendString(record, entry.kernel_code_file);
+  appendString(record, entry.cubin_file);
+  return append_to_text_file(kernel_db_index_file_.string(), record);
+}
+
+bool KernelDb::openHeuristics() {
+  if (fs::is_regular_file(kernel_db_heuristics_file_) && readHeuristics()) {
+    return true;
+  }
+  // The log is missing or corrupted, start a new one
+  heuristic_map_.clear();
+  heuristics_offset_ = 0;
+  return writeFileAtomically(
+             kernel_db_heuristics_file_,
+             std::string(kHeuristicsMagic, kHeuristicsMagicSize),
+             copy_to_text_file) &&
+      readHeuristics();
+}
+
+bool KernelDb::readHeuristics() {
+  std::vector<char> buffer;
+  if (!copy_from_binary_file(kernel_db_heuristics_file_.string(), buffer)) {
+    return false;
+  }
+  if (buffer.size() < kHeuristicsMagicSize ||
+      std::memcmp(buffer.data(), kHeuristicsMagic, kHeuristicsMagicSize) !=
+          0) {
+    return false;
+  }
+  size_t pos = std::max(heuristics_offset_, kHeuristicsMagicSize);
+  while (pos < buffer.size()) {
+    uint64_t fusion_key = 0;
+    int64_t heuristic = 0;
+    size_t record_pos = pos;
+    // A truncated record is left for the next read
+    if (!readField(buffer, record_pos, fusion_key) ||
+        !readField(buffer, record_pos, heuristic)) {
+      break;
+    }
+    heuristic_map_[fusion_key] = heuristic;
+    pos = record_pos;
+  }
+  heuristics_offset_ = pos;
+  return true;
+}
+
+bool KernelDb::queryHeuristic(uint64_t fusion_key, int64_t& heuristic) {
+  FUSER_PERF_SCOPE("KernelDb::queryHeuristic");
+  std::lock_guard<std::mutex> guard(kernel_db_lock);
+  auto entry = heuristic_map_.find(fusion_key);
+
+  // Pick up the decisions other processes wrote since the last read
+  if (entry == heuristic_map_.end()) {
+    DbFileLock lock(kernel_db_lock_file_, /*exclusive=*/false);
+    if (lock.locked() && readHeuristics()) {
+      entry = heuristic_map_.find(fusion_key);
+    }
+  }
+
+  if (entry == heuristic_map_.end()) {
+    return false;
+  }
+  heuristic = entry->second;
+  return true;
+}
+
+bool KernelDb::writeHeuristic(uint64_t fusion_key, int64_t heuristic) {
+  FUSER_PERF_SCOPE("KernelDb::writeHeuristic");
+  std::lock_guard<std::mutex> guard(kernel_db_lock);
+
+  DbFileLock lock(kernel_db_lock_file_, /*exclusive=*/true);
+  // Another process might have recorded the same fusion in the meantime
+  if (!lock.locked() || !readHeuristics() ||
+      heuristic_map_.count(fusion_key) != 0) {
+    return false;
+  }
+
+  std::string record;
+  appendField(record, &fusion_key, sizeof(fusion_key));
+  appendField(record, &heuristic, sizeof(heuristic));
+  return append_to_text_file(kernel_db_heuristics_file_.string(), record) &&
+      readHeuristics() && heuristic_map_.count(fusion_key) != 0;
+}
+
 bool KernelDb::query(
     const std::string& kernel_code,
     const std::string& compile_args,
     std::string& kernel_signature,
-    std::vector<char>& cubin) const {
+    std::vector<char>& cubin) {
+  return query(
+      kernel_code,
+      fnv1a_hash(kernel_code),
+      compile_args,
+      kernel_signature,
+      cubin);
+}
+
+bool KernelDb::query(
+    const std::string& kernel_code,
+    uint64_t kernel_code_hash,
+    const std::string& compile_args,
+    std::string& kernel_signature,
+    std::vector<char>& cubin) {
   FUSER_PERF_SCOPE("KernelDb::query");
-  bool status = false;
-  auto db_entry = kernel_map_.find(kernel_code);
+  std::lock_guard<std::mutex> guard(kernel_db_lock);
+  const auto kernel_hash = hashKernel(kernel_code_hash, compile_args);
+  auto db_entry = kernel_map_.find(kernel_hash);
 
-  // Kernel Match is found
-  if (db_entry != kernel_map_.end()) {
-    // Make sure the compilation args also match
-    if (db_entry->second.compile_args == compile_args) {
-      // Copy the cubin to a data buffer and record the kernel name for module
-      // loading
-      fs::path cubin_file_path = kernel_db_path_ / db_entry->second.cubin_file;
-      if (copy_from_binary_file(cubin_file_path.string(), cubin)) {
-        kernel_signature = db_entry->second.kernel_signature;
-        status = true;
-      }
+  // Pick up the entries other processes wrote since the last read
+  if (db_entry == kernel_map_.end()) {
+    DbFileLock lock(kernel_db_lock_file_, /*exclusive=*/false);
+    if (lock.locked() && readIndex()) {
+      db_entry = kernel_map_.find(kernel_hash);
     }
   }
-  return status;
+
+  // Kernel Match is found
+  if (db_entry == kernel_map_.end() ||
+      db_entry->second.compile_args != compile_args) {
+    return false;
+  }
+
+  // Make sure the kernel code also matches, as only its hash was compared
+  MappedFile code_file(
+      (kernel_db_path_ / db_entry->second.kernel_code_file).string());
+  if (!code_file.valid() || code_file.size() != kernel_code.size() ||
+      std::memcmp(code_file.data(), kernel_code.data(), kernel_code.size()) !=
+          0) {
+    return false;
+  }
+
+  // Copy the cubin to a data buffer and record the kernel name for module
+  // loading
+  MappedFile cubin_file(
+      (kernel_db_path_ / db_entry->second.cubin_file).string());
+  if (!cubin_file.valid()) {
+    return false;
+  }
+  cubin.assign(cubin_file.data(), cubin_file.data() + cubin_file.size());
+  kernel_signature = db_entry->second.kernel_signature;
+  return true;
 }
 
 // This method will write a cubin and the kernel code to files as well as add
-// an entry to the db csv file.
+// an entry to the db index and csv file.
 bool KernelDb::write(
     const std::string& kernel_code,
     const std::string& compile_args,
     const std::string& kernel_signature,
     const std::vector<char>& cubin) {
+  return write(
+      kernel_code,
+      fnv1a_hash(kernel_code),
+      compile_args,
+      kernel_signature,
+      cubin);
+}
+
+bool KernelDb::write(
+    const std::string& kernel_code,
+    uint64_t kernel_code_hash,
+    const std::string& compile_args,
+    const std::string& kernel_signature,
+    const std::vector<char>& cubin) {
   FUSER_PERF_SCOPE("KernelDb::write");
   std::lock_guard<std::mutex> guard(kernel_db_lock);
-  bool status = false;
-
-  // If the kernel doesn't already exist in the hash map, add it.
-  if (kernel_map_.count(kernel_code) == 0) {
-    // The cubin and kernel code files are given a unique number based on the
-    // size of the hash map.
-    std::string kernel_num =
-        std::to_string(static_cast<unsigned long>(kernel_map_.size()));
+  const auto kernel_hash = hashKernel(kernel_code_hash, compile_args);
 
-    // Kernel Code File path
-    std::string code_file_name("kernel_" + kernel_num + ".cu");
-    fs::path code_file_path = kernel_db_path_ / code_file_name;
-
-    // Cubin File path
-    std::string cubin_file_name("kernel_" + kernel_num + ".cubin");
-    fs::path cubin_file_path = kernel_db_path_ / cubin_file_name;
+  DbFileLock lock(kernel_db_lock_file_, /*exclusive=*/true);
+  // Another process might have written the same kernel in the meantime
+  if (!lock.locked() || !readIndex() || kernel_map_.count(kernel_hash) != 0) {
+    return false;
+  }
 
-    // Copy kernel code to file
-    status = copy_to_text_file(code_file_path.string(), kernel_code);
+  // The cubin and kernel code files are named by the kernel hash, so that
+  // the names are unique across processes
+  const std::string kernel_name = "kernel_" + hashToString(kernel_hash);
+  const std::string code_file_name(kernel_name + ".cu");
+  const std::string cubin_file_name(kernel_name + ".cubin");
 
-    // If the kernel code copy was successful, copy the cubin to file
-    if (status) {
-      status = copy_to_binary_file(cubin_file_path.string(), cubin);
-    }
+  // Copy kernel code to file, then the cubin
+  bool status = writeFileAtomically(
+      kernel_db_path_ / code_file_name, kernel_code, copy_to_text_file);
+  if (status) {
+    status = writeFileAtomically(
+        kernel_db_path_ / cubin_file_name, cubin, copy_to_binary_file);
+  }
 
-    // If both files were created successfully, add an entry to the CSV file
-    if (status) {
-      std::string entry(kernel_signature);
-      entry += "," + compile_args + "," + code_file_name + "," +
-          cubin_file_name + "\n";
-      status = append_to_text_file(kernel_db_txt_file_.string(), entry);
-    }
+  // If both files were created successfully, add an entry to the CSV file and
+  // the index. The index is written last, as it publishes the entry.
+  KernelDbEntry tmp{
+      kernel_signature, compile_args, code_file_name, cubin_file_name};
+  if (status) {
+    std::string entry(kernel_signature);
+    entry += "," + compile_args + "," + code_file_name + "," +
+        cubin_file_name + "\n";
+    status = append_to_text_file(kernel_db_txt_file_.string(), entry);
+  }
+  if (status) {
+    status = appendIndex(kernel_hash, tmp);
+  }
 
-    // If writing both files and adding an entry the CSV file was successful,
-    // finally add an entry to the Kernel DB
-    if (status) {
-      KernelDbEntry tmp{
-          kernel_signature, compile_args, code_file_name, cubin_file_name};
-      kernel_map_[kernel_code] = tmp;
-    }
+  // If writing both files and adding the entry was successful, finally add
+  // an entry to the Kernel DB
+  if (status) {
+    status = readIndex() && kernel_map_.count(kernel_hash) != 0;
   }
   return status;
 }
@@ -17,6 +17,8 @@ namespace fs = std::experimental::filesystem;
 #error "C++14 or Higher is required for filesystem library!"
 #endif
 
+#include <cstdint>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -24,8 +26,8 @@ namespace fs = std::experimental::filesystem;
 
 namespace nvfuser {
 
-//! KernelDbEntry captures information to be printed per fusion in a csv file
-//! that is used to restore a hash map
+//! KernelDbEntry captures information recorded per kernel in the binary index
+//! and the csv file that are used to restore the hash map
 struct KernelDbEntry {
   //! Cuda kernel function signature that is required to load the Cubin
   std::string kernel_signature;
@@ -39,8 +41,9 @@ struct KernelDbEntry {
 };
 
 //! KernelDb class is a singleton structure that is used to open, query, and
-//! write to the the database that is held in a hash map.  The kernel code is
-//! used as string key to the hash map.
+//! write to the the database that is held in a hash map.  A content hash of
+//! the kernel code and compile args is used as key to the hash map.  See
+//! Note [ Kernel DB layout ] for the on-disk format shared by processes.
 class TORCH_CUDA_CU_API KernelDb {
   KernelDb(bool _disabled);
 
@@ -74,21 +77,47 @@ class TORCH_CUDA_CU_API KernelDb {
     return kernel_map_.size();
   }
 
-  //! Query uses the string of the kernel code to lookup whether a cubin already
-  //! exists for the given kernel.  Additionally, the compile args are also
-  //! matched.
+  //! Query uses the hash of the kernel code and compile args to lookup whether
+  //! a cubin already exists for the given kernel.  The kernel code is verified
+  //! against the recorded cuda file.  Entries written by other processes since
+  //! the last lookup are picked up on a miss.
   bool query(
       const std::string& kernel_code,
       const std::string& compile_args,
       std::string& kernel_signature,
-      std::vector<char>& cubin) const;
+      std::vector<char>& cubin);
+  //! Same as above with the fnv1a_hash of kernel_code already known, e.g.
+  //! from code generation. See Note [ Streaming kernel emission ] in
+  //! codegen.cpp
+  bool query(
+      const std::string& kernel_code,
+      uint64_t kernel_code_hash,
+      const std::string& compile_args,
+      std::string& kernel_signature,
+      std::vector<char>& cubin);
   //! Write is used to write a new entry to the db upon compilation of a
-  //! new fusion
+  //! new fusion.  Safe with concurrent writers in other processes.
   bool write(
       const std::string& kernel_code,
       const std::string& compile_args,
       const std::string& kernel_signature,
       const std::vector<char>& cubin);
+  //! Same as above with the fnv1a_hash of kernel_code already known
+  bool write(
+      const std::string& kernel_code,
+      uint64_t kernel_code_hash,
+      const std::string& compile_args,
+      const std::string& kernel_signature,
+      const std::vector<char>& cubin);
+
+  //! Query the scheduling decision recorded for a fusion and its inputs by
+  //! any process sharing the db, see
+  //! Note [ Persistent scheduling decisions ] in kernel_cache.cpp
+  bool queryHeuristic(uint64_t fusion_key, int64_t& heuristic);
+  //! Record the scheduling decision for a fusion and its inputs. Also holds
+  //! the winners of autotuning, see Note [ Background autotuning ] in
+  //! kernel_cache.cpp
+  bool writeHeuristic(uint64_t fusion_key, int64_t heuristic);
 
  private:
   //! Disablement is specified by the user and can also be set by a
@@ -96,13 +125,37 @@ class TORCH_CUDA_CU_API KernelDb {
   bool disabled_ = true;
   //! Db is only initialized after it is successfully open
   bool initialized_ = false;
-  //! Hash Map of kernel_string -> db_entry
-  std::unordered_map<std::string, KernelDbEntry> kernel_map_;
+  //! Hash Map of kernel hash -> db_entry
+  std::unordered_map<uint64_t, KernelDbEntry> kernel_map_;
+  //! Hash Map of fusion key -> scheduling decision
+  std::unordered_map<uint64_t, int64_t> heuristic_map_;
 
   //! Full path to the db directory
   fs::path kernel_db_path_;
   //! Full path to csv file used to record and restore the db
   fs::path kernel_db_txt_file_;
+  //! Full path to the binary index used to restore the db
+  fs::path kernel_db_index_file_;
+  //! Full path to the log of scheduling decisions
+  fs::path kernel_db_heuristics_file_;
+  //! Full path to the file locked by readers and writers of the db
+  fs::path kernel_db_lock_file_;
+  //! Number of bytes of the binary index read into `kernel_map_`
+  size_t index_offset_ = 0;
+  //! Number of bytes of the scheduling decision log read into
+  //! `heuristic_map_`
+  size_t heuristics_offset_ = 0;
+
+  //! Restores the db from a csv file of a db without binary index
+  bool readTxtFile();
+  //! Reads the records of the binary index appended since the last read
+  bool readIndex();
+  //! Appends the record of an entry to the binary index
+  bool appendIndex(uint64_t kernel_hash, const KernelDbEntry& entry);
+  //! Reads the scheduling decision log, creating it if it is not valid
+  bool openHeuristics();
+  //! Reads the scheduling decisions appended since the last read
+  bool readHeuristics();
 };
 
 } // namespace nvfuser
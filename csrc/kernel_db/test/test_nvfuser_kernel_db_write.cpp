@@ -68,6 +68,44 @@ TEST_F(NVFuserTest, KernelDb_Write_CUDA) {
     FAIL() << "Unexpected failure while writing existing db entry!" << e.what();
   }
 
+  // Reopen the db from its binary index and query the written entry
+  try {
+    ASSERT_TRUE(fs::is_regular_file(test_db_path / "db.idx"));
+    auto& reopened_db =
+        KernelDb::get(kernel_db_dir, kernel_db_file, true, false, true);
+    ASSERT_TRUE(reopened_db.enabled());
+    ASSERT_TRUE(reopened_db.size() == 1);
+    std::string queried_signature;
+    std::vector<char> queried_cubin;
+    ASSERT_TRUE(reopened_db.query(
+        code, compile_args, queried_signature, queried_cubin));
+    ASSERT_TRUE(queried_signature == kernel_signature);
+    ASSERT_TRUE(queried_cubin == cubin);
+    SUCCEED();
+  } catch (const std::exception& e) {
+    FAIL() << "Unexpected failure while reopening db from its index!"
+           << e.what();
+  }
+
+  // Record scheduling decisions and query them after reopening the db
+  try {
+    const uint64_t fusion_key = 0x1234;
+    int64_t heuristic = 0;
+    ASSERT_FALSE(kernel_db.queryHeuristic(fusion_key, heuristic));
+    ASSERT_TRUE(kernel_db.writeHeuristic(fusion_key, 3));
+    ASSERT_FALSE(kernel_db.writeHeuristic(fusion_key, 4));
+    ASSERT_TRUE(fs::is_regular_file(test_db_path / "db_heuristics.idx"));
+    auto& reopened_db =
+        KernelDb::get(kernel_db_dir, kernel_db_file, true, false, true);
+    ASSERT_TRUE(reopened_db.enabled());
+    ASSERT_TRUE(reopened_db.queryHeuristic(fusion_key, heuristic));
+    ASSERT_TRUE(heuristic == 3);
+    SUCCEED();
+  } catch (const std::exception& e) {
+    FAIL() << "Unexpected failure while recording scheduling decisions!"
+           << e.what();
+  }
+
   // Cleanup DB Directory
   if (fs::is_directory(test_db_path)) {
     fs::remove_all(test_db_path);
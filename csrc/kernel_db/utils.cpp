@@ -6,6 +6,12 @@
  */
 // clang-format on
 #include <kernel_db/utils.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <fstream>
 
 namespace nvfuser {
@@ -76,4 +82,44 @@ bool copy_to_text_file(const std::string& file_path, const std::string& src) {
   return status;
 }
 
+uint64_t fnv1a_hash(const std::string& str, uint64_t hash) {
+  return fnv1a_hash(str.data(), str.size(), hash);
+}
+
+uint64_t fnv1a_hash(const char* data, size_t size, uint64_t hash) {
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= static_cast<uint8_t>(data[i]);
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+MappedFile::MappedFile(const std::string& file_path) {
+  int fd = ::open(file_path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return;
+  }
+  struct stat file_stat {};
+  if (::fstat(fd, &file_stat) == 0) {
+    size_ = static_cast<size_t>(file_stat.st_size);
+    if (size_ == 0) {
+      valid_ = true;
+    } else {
+      void* data = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+      if (data != MAP_FAILED) {
+        data_ = static_cast<const char*>(data);
+        valid_ = true;
+      }
+    }
+  }
+  // The mapping stays valid after closing the file descriptor
+  ::close(fd);
+}
+
+MappedFile::~MappedFile() {
+  if (data_ != nullptr) {
+    ::munmap(const_cast<char*>(data_), size_);
+  }
+}
+
 } // namespace nvfuser
@@ -6,6 +6,7 @@
  */
 // clang-format on
 #pragma once
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -34,4 +35,46 @@ TORCH_CUDA_CU_API bool copy_to_text_file(
     const std::string& file_path,
     const std::string& src);
 
+//! Initial state of fnv1a_hash
+constexpr uint64_t kFnv1aOffsetBasis = 0xcbf29ce484222325ULL;
+
+//! Stable FNV-1a hash of `str`, continuing from `hash`. Unlike std::hash it
+//! is the same in every process, so it can be used as key of on-disk records.
+TORCH_CUDA_CU_API uint64_t
+fnv1a_hash(const std::string& str, uint64_t hash = kFnv1aOffsetBasis);
+
+//! fnv1a_hash of `size` bytes at `data`. Hashing a string piece by piece
+//! gives the same result as hashing it at once.
+TORCH_CUDA_CU_API uint64_t
+fnv1a_hash(const char* data, size_t size, uint64_t hash = kFnv1aOffsetBasis);
+
+//! Read-only memory mapping of a whole file. The mapping shares the page
+//! cache with other processes reading the same file.
+class TORCH_CUDA_CU_API MappedFile {
+ public:
+  explicit MappedFile(const std::string& file_path);
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  //! False if the file could not be opened or mapped
+  bool valid() const {
+    return valid_;
+  }
+
+  const char* data() const {
+    return data_;
+  }
+
+  size_t size() const {
+    return size_;
+  }
+
+ private:
+  bool valid_ = false;
+  const char* data_ = nullptr;
+  size_t size_ = 0;
+};
+
 } // namespace nvfuser
@@ -803,7 +803,8 @@ GroupedGridReduction::GroupedGridReduction(
     Val* entrance_index,
     Val* entrances,
     Val* buffer_stride,
-    bool is_allreduce)
+    bool is_allreduce,
+    bool use_outer_opt)
     : GroupedReductionOp(
           passkey,
           std::move(reduction_op_types),
@@ -827,6 +828,34 @@ GroupedGridReduction::GroupedGridReduction(
   for (auto buffer : reduction_buffers) {
     addAttribute(buffer);
   }
+  addAttribute(
+      IrBuilder::create<Attribute<bool>>(passkey.ir_container_, use_outer_opt));
+}
+
+int GroupedGridReduction::getSmemBufferSize(int bdimx, int bdimy, int bdimz)
+    const {
+  TORCH_INTERNAL_ASSERT(useOuterOpt());
+  TORCH_INTERNAL_ASSERT(bdimz == 1);
+  auto out_tv = ir_utils::getTvOutput(this);
+
+  // Same layout as the avg buffer of the outer-optimized grouped
+  // grid welford, i.e., blockDim.x * NumberOfWarps * GroupCount
+  int group_count = 1;
+  for (auto axis : out_tv->domain()->domain()) {
+    if (axis->getParallelType() == ParallelType::Group) {
+      auto extent_int = axis->extent()->getInt();
+      TORCH_INTERNAL_ASSERT(extent_int.has_value());
+      group_count *= (int)extent_int.value();
+    }
+  }
+
+  TORCH_INTERNAL_ASSERT(group_count > 1);
+
+  int num_warps = bdimx * bdimy / 32;
+  TORCH_INTERNAL_ASSERT((bdimx * bdimy) % 32 == 0);
+
+  return bdimx * num_warps * group_count *
+      dataTypeSize(out_tv->getDataType().value());
 }
 
 std::string GroupedGridReduction::toString(int indent_size) const {
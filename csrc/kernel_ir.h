@@ -738,7 +738,8 @@ class TORCH_CUDA_CU_API GroupedGridReduction final : public GroupedReductionOp {
       Val* entrance_index,
       Val* entrances,
       Val* buffer_stride,
-      bool is_allreduce = false);
+      bool is_allreduce = false,
+      bool use_outer_opt = false);
 
   NVFUSER_DECLARE_CLONE_AND_CREATE
 
@@ -809,6 +810,15 @@ class TORCH_CUDA_CU_API GroupedGridReduction final : public GroupedReductionOp {
     result->threadPredicate() = thread_predicate;
     return result;
   }
+
+  // True if the outer-optimized kernel should be used
+  bool useOuterOpt() const {
+    auto offset = numGroupedReductionOpAttr() + 5 + outputs().size();
+    return attribute(offset)->as<Attribute<bool>>()->value;
+  }
+
+  //! Return the required smem buffer size of the outer-optimized kernel
+  int getSmemBufferSize(int bdimx, int bdimy, int bdimz) const;
 };
 
 //! Grid broadcast operation
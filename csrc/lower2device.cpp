@@ -42,6 +42,8 @@
 namespace nvfuser {
 
 thread_local GpuLower* active_gpu_lower = nullptr; // NOLINT
+// Times each lowering pass, see Note [ Compile time instrumentation ]
+thread_local inst::CompileStageLaps* active_pass_laps = nullptr; // NOLINT
 namespace {
 
 class KIRCleaner : public OptOutDispatch {
@@ -248,26 +250,51 @@ void assignRNGOffset(Fusion* fusion) {
   }
 }
 
+bool isLowerVerboseEnabled(const std::string& pass_name) {
+  if (!isDebugDumpEnabled(DebugDumpOption::LowerVerbose)) {
+    return false;
+  }
+  const auto& args = getDebugDumpArguments(DebugDumpOption::LowerVerbose);
+  return (
+      args.empty() ||
+      std::find(args.begin(), args.end(), pass_name) != args.end());
+}
+
 // Dump expr string if enable lower_verbose
 void dumpExprsIfEnabled(
     const std::vector<Expr*>& exprs,
     std::string pass_name,
     bool force_enable = false) {
-  auto enabled_by_env = [&pass_name]() {
-    if (!isDebugDumpEnabled(DebugDumpOption::LowerVerbose)) {
-      return false;
-    }
-    const auto& args = getDebugDumpArguments(DebugDumpOption::LowerVerbose);
-    return (
-        args.empty() ||
-        std::find(args.begin(), args.end(), pass_name) != args.end());
-  };
-  if (force_enable || enabled_by_env()) {
+  if (active_pass_laps != nullptr) {
+    active_pass_laps->lap(pass_name);
+  }
+  if (force_enable || isLowerVerboseEnabled(pass_name)) {
     std::cout << "After " << pass_name << ":" << std::endl;
     for (auto exp : exprs) {
       std::cout << exp->toString() << std::endl;
     }
   }
+  if (active_pass_laps != nullptr) {
+    active_pass_laps->restart();
+  }
+}
+
+// Dump the exprs of the fusion if enable lower_verbose. The exprs are only
+// sorted when they are dumped, as sorting the whole kernel after each of the
+// analysis passes costs more than most of them.
+void dumpExprsIfEnabled(Fusion* fusion, std::string pass_name) {
+  if (active_pass_laps != nullptr) {
+    active_pass_laps->lap(pass_name);
+  }
+  if (isLowerVerboseEnabled(pass_name)) {
+    std::cout << "After " << pass_name << ":" << std::endl;
+    for (auto exp : fusion->exprs()) {
+      std::cout << exp->toString() << std::endl;
+    }
+  }
+  if (active_pass_laps != nullptr) {
+    active_pass_laps->restart();
+  }
 }
 
 void GpuLower::lower(Fusion* fusion) {
@@ -276,14 +303,17 @@ void GpuLower::lower(Fusion* fusion) {
   TORCH_INTERNAL_ASSERT(
       active_gpu_lower == nullptr, "Nested lowering passes are not supported");
 
+  inst::CompileStageLaps pass_laps("GpuLower::");
   struct LowerGuard {
-    LowerGuard(GpuLower* gpu_lower) {
+    LowerGuard(GpuLower* gpu_lower, inst::CompileStageLaps* pass_laps) {
       active_gpu_lower = gpu_lower;
+      active_pass_laps = pass_laps;
     }
     ~LowerGuard() {
       active_gpu_lower = nullptr;
+      active_pass_laps = nullptr;
     }
-  } lower_guard(this);
+  } lower_guard(this, &pass_laps);
 
   // Use int64 by default as the kernel index type
   auto kernel_index_type = cparams_.index_type.has_value()
@@ -304,20 +334,20 @@ void GpuLower::lower(Fusion* fusion) {
   assignRNGOffset(fusion_);
 
   FusionGuard fg(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "initialize lowering");
+  dumpExprsIfEnabled(fusion_, "initialize lowering");
 
   // prepare for lowering
   validateIr(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "validateIr");
+  dumpExprsIfEnabled(fusion_, "validateIr");
 
   // Checks if any TIDx dim is marked as padded to a warp. Also checks if we can
   // determine the padding is explicitly a single warp.
   collectPaddedParallelDims();
-  dumpExprsIfEnabled(fusion_->exprs(), "collectPaddedParallelDims");
+  dumpExprsIfEnabled(fusion_, "collectPaddedParallelDims");
 
   // Replaces integers that are tensor sizes by named scalars as "T0.size[0]"
   replaceSymbolicSizes(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "replaceSymbolicSizes");
+  dumpExprsIfEnabled(fusion_, "replaceSymbolicSizes");
 
   // Build what's refered to as the compute at map. This map contains the
   // mappings of all iteration domains across the fusion. There are three types
@@ -326,74 +356,77 @@ void GpuLower::lower(Fusion* fusion) {
   compute_at_map_ = std::make_shared<ComputeAtMap>(fusion_);
 
   resolveComputeWith(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "resolveComputeWith");
+  dumpExprsIfEnabled(fusion_, "resolveComputeWith");
 
   if (isDebugDumpEnabled(DebugDumpOption::ComputeAtMap)) {
     std::cout << compute_at_map_->toString() << std::endl;
   }
   compute_at_map_->validateAndPropagatePType();
-  dumpExprsIfEnabled(fusion_->exprs(), "validateAndPropagatePType");
+  dumpExprsIfEnabled(fusion_, "validateAndPropagatePType");
 
   // Uses compute_at_map, find all splits that are enforced to be divisible
   divisible_splits_ = getAllDivisibleSplits(fusion_, compute_at_map_.get());
-  dumpExprsIfEnabled(fusion_->exprs(), "getAllDivisibleSplits");
+  dumpExprsIfEnabled(fusion_, "getAllDivisibleSplits");
 
   // Used in parallel dimension map
   concretized_broadcast_domains_ =
       std::make_shared<const ConcretizedBroadcastDomains>(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "build ConcretizedBroadcastDomains");
+  dumpExprsIfEnabled(fusion_, "build ConcretizedBroadcastDomains");
 
   parallelDimensionMap().build(fusion_);
   if (isDebugDumpEnabled(DebugDumpOption::ParallelDimensions)) {
     std::cout << "Parallel dimension map:" << std::endl;
     std::cout << parallel_dimension_map_.toString() << std::endl;
   }
-  dumpExprsIfEnabled(fusion_->exprs(), "build parallelDimensionMap");
+  dumpExprsIfEnabled(fusion_, "build parallelDimensionMap");
 
   // Validate mma data format and compatibility if any on the fusion.
   validateMma(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "validateMma");
+  dumpExprsIfEnabled(fusion_, "validateMma");
 
   // Validate swizzle usage on the fusion schedule.
   validateSwizzle(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "validateSwizzle");
+  dumpExprsIfEnabled(fusion_, "validateSwizzle");
 
   validateResize(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "validateResize");
+  dumpExprsIfEnabled(fusion_, "validateResize");
+
+  validateScanOps(fusion_);
+  dumpExprsIfEnabled(fusion_, "validateScanOps");
 
   // Compute thread predicates. Depends on parallel_dimension_map_
   thread_pred_map_.build(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "build thread_pred_map_");
+  dumpExprsIfEnabled(fusion_, "build thread_pred_map_");
 
   // Fuse cetain patterns of reductions, such as a grid reduction
   // followed by a grid broadcast. Only depends on parallelization and
   // thread predicate map.
   fuseReductionsAndBroadcasts(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "fuseReductionsAndBroadcasts");
+  dumpExprsIfEnabled(fusion_, "fuseReductionsAndBroadcasts");
 
   // Scan the whole fusion and build mappings about halo extensions of
   // all IterDomains
   halo_info_ = std::make_shared<HaloInfo>(fusion_, compute_at_map_);
-  dumpExprsIfEnabled(fusion_->exprs(), "build HaloInfo");
+  dumpExprsIfEnabled(fusion_, "build HaloInfo");
 
   // Want to run this after parallel map and halo info map are
   // created. vectorized_accesses_ and vectorized_set_info_ are filled.
   validateAndCollectVectorizeInfo(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "validateAndCollectVectorizeInfo");
+  dumpExprsIfEnabled(fusion_, "validateAndCollectVectorizeInfo");
 
   // Depends on ComputeAtMap and HaloInfo.
   validateAndConvertIterDomainGrouping(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "validateAndConvertIterDomainGrouping");
+  dumpExprsIfEnabled(fusion_, "validateAndConvertIterDomainGrouping");
 
   // Assumes all grouped reductions are convered to
   // GroupedReductionOp, which is done by
   // validateAndConvertIterDomainGrouping
   validateGroupedReductions(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "validateGroupedReductions");
+  dumpExprsIfEnabled(fusion_, "validateGroupedReductions");
 
   // all of the lookup TVs are fusion inputs
   validateLookupTV(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "validateLookupTV");
+  dumpExprsIfEnabled(fusion_, "validateLookupTV");
 
   // Depends on thread_pred_map_, validates parallelization collects which
   // tensor views need WAR or RAW syncs
@@ -401,27 +434,27 @@ void GpuLower::lower(Fusion* fusion) {
   if (isDebugDumpEnabled(DebugDumpOption::SyncMap)) {
     std::cout << sync_map_->toString() << std::endl;
   }
-  dumpExprsIfEnabled(fusion_->exprs(), "SyncMap");
+  dumpExprsIfEnabled(fusion_, "SyncMap");
 
   partialSplitMap().build(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "build partialSplitMap");
+  dumpExprsIfEnabled(fusion_, "build partialSplitMap");
 
   validatePartialSplit(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "validatePartialSplit");
+  dumpExprsIfEnabled(fusion_, "validatePartialSplit");
 
   nonDivisibleSplitInfo().build(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "build nonDivisibleSplitInfo");
+  dumpExprsIfEnabled(fusion_, "build nonDivisibleSplitInfo");
 
   // Detects all exprssions that don't need predicates. Depends on
   // nonDivisibleSplitInfo.
   pred_elimination_ = std::make_unique<PredicateElimination>(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "build predicateElimination");
+  dumpExprsIfEnabled(fusion_, "build predicateElimination");
 
   doubleBufferInfo().build(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "build doubleBufferInfo");
+  dumpExprsIfEnabled(fusion_, "build doubleBufferInfo");
 
   compute_at_map_->allocateIndexVariables();
-  dumpExprsIfEnabled(fusion_->exprs(), "allocateIndexVariables");
+  dumpExprsIfEnabled(fusion_, "allocateIndexVariables");
   // Run our passes keeping the lowered expressions and forwarding
   // them
 
@@ -440,8 +473,11 @@ void GpuLower::lower(Fusion* fusion) {
   const auto exprs_unary_replaced = unarySetOpInserter(exprs_lowered);
   dumpExprsIfEnabled(exprs_unary_replaced, "unarySetOpInserter");
 
+  const auto exprs_half_ops = nativeHalfOpInserter(exprs_unary_replaced);
+  dumpExprsIfEnabled(exprs_half_ops, "nativeHalfOpInserter");
+
   // Insert allocations
-  const auto exprs_alloced = insertAllocations(exprs_unary_replaced);
+  const auto exprs_alloced = insertAllocations(exprs_half_ops);
   dumpExprsIfEnabled(exprs_alloced, "insertAllocations");
 
   // Insert read after write smem syncs
@@ -456,14 +492,29 @@ void GpuLower::lower(Fusion* fusion) {
   const auto exprs_war_sync = insertWarThreadSynchronization(exprs_reuse_mem);
   dumpExprsIfEnabled(exprs_war_sync, "insertWarThreadSynchronization");
 
-  const auto exprs_double_buffered = DoubleBufferPass::run(exprs_war_sync);
+  // Assign offsets to shared memory buffers that can share memory
+  const auto exprs_smem_packed = packSharedMemoryAllocations(exprs_war_sync);
+  dumpExprsIfEnabled(exprs_smem_packed, "packSharedMemoryAllocations");
+
+  // Remove block syncs made redundant by other block syncs
+  const auto exprs_sync_merged =
+      removeRedundantThreadSynchronization(exprs_smem_packed);
+  dumpExprsIfEnabled(exprs_sync_merged, "removeRedundantThreadSynchronization");
+
+  const auto exprs_double_buffered = DoubleBufferPass::run(exprs_sync_merged);
   dumpExprsIfEnabled(exprs_double_buffered, "DoubleBufferPass");
 
-  const auto exprs_loop_rotated = fusion_->hasManaged("loop_rotation")
+  auto exprs_loop_rotated = fusion_->hasManaged("loop_rotation")
       ? rotateLoops(
             exprs_double_buffered,
             fusion_->getManaged<LoopRotationParam>("loop_rotation"))
       : exprs_double_buffered;
+  if (fusion_->hasManaged("optional_loop_rotation")) {
+    exprs_loop_rotated = rotateLoops(
+        exprs_loop_rotated,
+        fusion_->getManaged<LoopRotationParam>("optional_loop_rotation"),
+        true);
+  }
   dumpExprsIfEnabled(exprs_loop_rotated, "rotateLoops");
 
   // This pass inserts predicates as well as branches in the code. Up until now
@@ -531,6 +582,7 @@ void GpuLower::lower(Fusion* fusion) {
   // will also copy over some relevant information for code generation from
   // GpuLower.
   kernel_->finalize(exprs_sync_aligned);
+  pass_laps.lap("finalize");
 }
 
 kir::Kernel* GpuLower::kernel() const {
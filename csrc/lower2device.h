@@ -154,6 +154,22 @@ class TORCH_CUDA_CU_API GpuLower : public NonCopyable {
     return vectorized_accesses_;
   }
 
+  const kir::PackedSmemInfo& packedSmemInfo() const {
+    return packed_smem_info_;
+  }
+
+  kir::PackedSmemInfo& packedSmemInfo() {
+    return packed_smem_info_;
+  }
+
+  int64_t registerPressure() const {
+    return register_pressure_;
+  }
+
+  int64_t& registerPressure() {
+    return register_pressure_;
+  }
+
   const auto& vectorizedSetInfo() const {
     return vectorized_set_info_;
   }
@@ -174,6 +190,16 @@ class TORCH_CUDA_CU_API GpuLower : public NonCopyable {
     return profile_;
   }
 
+  //! Loops of the unpredicated versions of unswitched loop nests lowered
+  //! without magic zero, see Note [ Magic zero in unswitched loops ]
+  std::unordered_set<const kir::ForLoop*>& magicZeroFreeLoops() {
+    return magic_zero_free_loops_;
+  }
+
+  const std::unordered_set<const kir::ForLoop*>& magicZeroFreeLoops() const {
+    return magic_zero_free_loops_;
+  }
+
   bool isNvFuserZeroEnabled() {
     if (isOptionDisabled(DisableOption::MagicZero)) {
       return false;
@@ -230,6 +256,7 @@ class TORCH_CUDA_CU_API GpuLower : public NonCopyable {
   std::shared_ptr<const SyncMap> sync_map_;
   kir::KernelPerformanceProfile profile_;
   std::unordered_set<Split*> divisible_splits_;
+  std::unordered_set<const kir::ForLoop*> magic_zero_free_loops_;
   CompileParams cparams_;
 
   // Track which tensor views are inputs or outputs of a vectorized operation
@@ -238,6 +265,11 @@ class TORCH_CUDA_CU_API GpuLower : public NonCopyable {
   std::unordered_map<TensorView*, int> vectorized_accesses_;
   // Info on each vectorized set op
   std::vector<VectorizedSetInfo> vectorized_set_info_;
+  // Offsets of shared memory buffers packed by packSharedMemoryAllocations
+  kir::PackedSmemInfo packed_smem_info_;
+  // Register pressure estimated by reuseMemoryAllocations, see
+  // Note [ Register pressure estimate ]
+  int64_t register_pressure_ = 0;
 
   Fusion* fusion_ = nullptr;
 };
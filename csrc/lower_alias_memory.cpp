@@ -16,6 +16,7 @@
 #include <lower2device.h>
 #include <lower_utils.h>
 
+#include <algorithm>
 #include <sstream>
 #include <unordered_map>
 #include <unordered_set>
@@ -542,6 +543,8 @@ struct AllocationInfo {
   MemoryType mem_type = MemoryType::Local;
   DataType data_type = DataType::Float;
   std::string size_expr;
+  //! Number of elements of register buffers, which are constant sized
+  int64_t local_size = -1;
   ScopeInfo* loop_info = nullptr;
   bool can_use_inner_alias = true;
   int alloc_pos = -1;
@@ -753,6 +756,9 @@ class AllocationInfoMap : private kir::IrVisitor {
     alloc_info->mem_type = mem_type;
     alloc_info->data_type = data_type;
     alloc_info->size_expr = size_print;
+    if (mem_type == MemoryType::Local) {
+      alloc_info->local_size = alloc->size()->evaluateInt();
+    }
     alloc_info->loop_info = current_stack_.back();
     alloc_info->should_try_alias = should_try_alias;
 
@@ -1083,26 +1089,9 @@ class ReusableAllocationFinder : private kir::IrVisitor {
           if (!alloc_to_reuse->alloc_expr->buffer()->isA<TensorView>()) {
             continue;
           }
-          auto this_tv = alloc_info->alloc_expr->buffer()->as<TensorView>();
-          auto reuse_tv =
-              alloc_to_reuse->alloc_expr->buffer()->as<TensorView>();
-          // Check that either both tv's are vectorized acceses, or neither are.
-          // Vectorized allocations require correct alignment so they can only
-          // alias with other allocations with the right alignment
-          const auto& va = GpuLower::current()->vectorizedAccesses();
-          if ((va.find(this_tv) == va.end()) !=
-              (va.find(reuse_tv) == va.end())) {
+          if (!hasMatchingAlignment(alloc_info, alloc_to_reuse)) {
             return false;
           }
-
-          // Shared memory is all aligned to 128 bits, local memory might not be
-          if (this_tv->getMemoryType() == MemoryType::Local &&
-              va.find(this_tv) != va.end()) {
-            // Make sure alignment matches
-            if (va.at(this_tv) != va.at(reuse_tv)) {
-              return false;
-            }
-          }
         }
 
         // TODO:
@@ -1121,7 +1110,95 @@ class ReusableAllocationFinder : private kir::IrVisitor {
         return true;
       }
     }
-    return false;
+    return tryReuseLargerRegisterBuffer(alloc_info);
+  }
+
+  // Note [ Reusing larger register buffers ]
+  //
+  // Register buffers of loop nests that run one after the other, e.g., the
+  // buffers of the prologue and of the epilogue of a kernel, are live over
+  // disjoint intervals but rarely have the same size. A buffer that found no
+  // buffer of its own size to reuse may instead reuse a larger register
+  // buffer of the same data type, live outside of its outer live interval.
+  // The alias is declared as a reference to the larger array, so the
+  // indexing of the smaller buffer stays within bounds and the registers of
+  // the larger one are simply left unused while it's live. The smallest of
+  // the larger buffers is picked so the largest ones remain available to
+  // buffers of their own size.
+  //
+  // Buffers of different data types would have to reinterpret the array of
+  // the buffer they reuse, which codegen doesn't do, and inner sharing
+  // requires index equivalence between the two buffers, so both stay
+  // limited to buffers of the same size.
+  bool tryReuseLargerRegisterBuffer(AllocationInfo* alloc_info) {
+    if (inner_aliasing_pass_ || alloc_info->mem_type != MemoryType::Local ||
+        !alloc_info->alloc_expr->buffer()->isA<TensorView>()) {
+      return false;
+    }
+
+    AllocationInfo* best_to_reuse = nullptr;
+    for (const auto& reuse_stack : current_visible_buffer_stack_) {
+      for (auto alloc_to_reuse : *reuse_stack) {
+        if (alloc_to_reuse->alias_to != nullptr ||
+            alloc_to_reuse->mem_type != MemoryType::Local ||
+            alloc_to_reuse->data_type != alloc_info->data_type ||
+            alloc_to_reuse->local_size < alloc_info->local_size ||
+            !alloc_to_reuse->alloc_expr->buffer()->isA<TensorView>()) {
+          continue;
+        }
+
+        auto alloc_live_interval = alloc_info->outer_live_interval.get();
+        const auto& subscribed_intervals =
+            *alloc_to_reuse->outer_subscribed_intevals;
+        if (std::any_of(
+                subscribed_intervals.begin(),
+                subscribed_intervals.end(),
+                [alloc_live_interval](auto subscribed_interval) {
+                  return alloc_live_interval->intersect(subscribed_interval);
+                })) {
+          continue;
+        }
+
+        if (!hasMatchingAlignment(alloc_info, alloc_to_reuse)) {
+          continue;
+        }
+
+        if (best_to_reuse == nullptr ||
+            alloc_to_reuse->local_size < best_to_reuse->local_size) {
+          best_to_reuse = alloc_to_reuse;
+        }
+      }
+    }
+
+    if (best_to_reuse == nullptr) {
+      return false;
+    }
+    reuseAllocation(alloc_info, best_to_reuse);
+    return true;
+  }
+
+  //! Vectorized allocations require correct alignment so they can only
+  //!  alias with other allocations with the right alignment
+  bool hasMatchingAlignment(
+      AllocationInfo* alloc_info,
+      AllocationInfo* alloc_to_reuse) {
+    auto this_tv = alloc_info->alloc_expr->buffer()->as<TensorView>();
+    auto reuse_tv = alloc_to_reuse->alloc_expr->buffer()->as<TensorView>();
+    // Check that either both tv's are vectorized acceses, or neither are.
+    const auto& va = GpuLower::current()->vectorizedAccesses();
+    if ((va.find(this_tv) == va.end()) != (va.find(reuse_tv) == va.end())) {
+      return false;
+    }
+
+    // Shared memory is all aligned to 128 bits, local memory might not be
+    if (this_tv->getMemoryType() == MemoryType::Local &&
+        va.find(this_tv) != va.end()) {
+      // Make sure alignment matches
+      if (va.at(this_tv) != va.at(reuse_tv)) {
+        return false;
+      }
+    }
+    return true;
   }
 
   void handle(kir::ForLoop* for_loop) final {
@@ -1378,6 +1455,80 @@ class AllocationReuseModifier : private kir::ExprMutator {
   std::unordered_map<kir::Allocate*, kir::Allocate*> old2new_;
 };
 
+// Note [ Register pressure estimate ]
+//
+// The number of registers a kernel takes is only known after nvrtc
+// compiled it, but most of the registers of the kernels that spill are held
+// by the constant-sized local buffers, e.g., the persistent buffers of
+// normalization kernels. The estimate is the peak, over the positions of the
+// loop nest, of the 32-bit words of the local buffers live at the position.
+// A buffer is live over its outer live interval, i.e., a buffer used in a
+// loop is live over the whole loop, and a buffer aliasing another one is
+// folded into the buffer it aliases. Scalars, indices and predicates aren't
+// counted, nor are the extra stages double buffering adds later on, so the
+// estimate is a lower bound of what the kernel needs.
+int64_t estimateRegisterPressure(const AllocationInfoMap& allocation_info_map) {
+  const auto index_type = GpuLower::current()->kernel()->indexType();
+  const auto& alias_map = allocation_info_map.getAliasMap();
+
+  // 32-bit words and live intervals of each buffer that isn't an alias
+  std::unordered_map<AllocationInfo*, int64_t> buffer_words;
+  std::unordered_map<AllocationInfo*, std::vector<BufferLiveInterval*>>
+      buffer_intervals;
+  for (const auto& entry : allocation_info_map.getAllocationInfoMap()) {
+    auto alloc_info = entry.second;
+    if (alloc_info->mem_type != MemoryType::Local ||
+        alloc_info->outer_live_interval->firstWrite() < 0) {
+      continue;
+    }
+    auto root = alloc_info;
+    for (auto alias_it = alias_map.find(root); alias_it != alias_map.end();
+         alias_it = alias_map.find(root)) {
+      root = alias_it->second;
+    }
+    buffer_intervals[root].push_back(alloc_info->outer_live_interval.get());
+    if (root == alloc_info) {
+      buffer_words[root] = alloc_info->alloc_expr->size()->evaluateInt() *
+          ceilDiv((int64_t)dataTypeSize(alloc_info->data_type, index_type), 4);
+    }
+  }
+
+  // Sweep over the start and end positions of the live ranges, merging the
+  // overlapping intervals of a buffer and its aliases first
+  std::vector<std::pair<int, int64_t>> events;
+  for (auto& entry : buffer_intervals) {
+    const auto words = buffer_words.at(entry.first);
+    std::vector<std::pair<int, int>> ranges;
+    for (auto interval : entry.second) {
+      ranges.emplace_back(
+          interval->firstWrite(),
+          std::max(interval->firstWrite(), interval->lastRead()));
+    }
+    std::sort(ranges.begin(), ranges.end());
+    auto range = ranges.front();
+    for (const auto& next : ranges) {
+      if (next.first > range.second) {
+        events.emplace_back(range.first, words);
+        events.emplace_back(range.second + 1, -words);
+        range = next;
+      } else {
+        range.second = std::max(range.second, next.second);
+      }
+    }
+    events.emplace_back(range.first, words);
+    events.emplace_back(range.second + 1, -words);
+  }
+  // Buffers dying at a position are released before the ones starting there
+  std::sort(events.begin(), events.end());
+  int64_t live_words = 0;
+  int64_t peak_words = 0;
+  for (const auto& event : events) {
+    live_words += event.second;
+    peak_words = std::max(peak_words, live_words);
+  }
+  return peak_words;
+}
+
 } // namespace
 
 std::vector<Expr*> reuseMemoryAllocations(const std::vector<Expr*>& exprs) {
@@ -1389,7 +1540,232 @@ std::vector<Expr*> reuseMemoryAllocations(const std::vector<Expr*>& exprs) {
 
   ReusableAllocationFinder::find(exprs, allocation_info_map);
 
+  GpuLower::current()->registerPressure() =
+      estimateRegisterPressure(allocation_info_map);
+  if (debug_print) {
+    std::cout << "Register pressure estimate: "
+              << GpuLower::current()->registerPressure() << " words\n";
+  }
+
   return AllocationReuseModifier::modify(exprs, allocation_info_map);
 }
 
+// Note [ Shared memory offset packing ]
+//
+// reuseMemoryAllocations only lets a shared memory buffer alias a dead
+// buffer of the same size, and codegen lays out all the other dynamic shared
+// memory buffers one after another, so the footprint is the sum of their
+// sizes. packSharedMemoryAllocations instead assigns an explicit offset to
+// each buffer allocated at the top level of the kernel with a compile-time
+// constant size. The live interval of such a buffer is the range of
+// top-level expressions that touch it or any buffer aliasing it. Buffers
+// are placed in order of decreasing size, each at the smallest 16B-aligned
+// gap that fits between the already placed buffers whose live intervals
+// overlap its own (best fit), so buffers that are never live at the same
+// time share memory.
+//
+// Other threads may still read a dead buffer when a thread starts to write
+// a buffer placed over it, so a WAR sync is inserted before the allocation
+// of the new buffer unless there's already a top-level block sync after the
+// last use of the dead one.
+//
+// Codegen places the packed region right after the reduction workspace and
+// the remaining dynamic buffers after the region as before. The offsets are
+// only used if they reduce the footprint, and the packing can be turned off
+// with PYTORCH_NVFUSER_DISABLE=smem_packing.
+
+namespace {
+
+struct PackedSmemBuffer {
+  kir::Allocate* alloc = nullptr;
+  int64_t size = 0;
+  // Range of top-level expressions the buffer is live in, from its
+  // allocation to its last use
+  int64_t first_use = -1;
+  int64_t last_use = -1;
+  int64_t offset = -1;
+
+  bool liveAtSameTime(const PackedSmemBuffer& other) const {
+    return first_use <= other.last_use && other.first_use <= last_use;
+  }
+
+  bool sharesMemory(const PackedSmemBuffer& other) const {
+    return offset < other.offset + other.size &&
+        other.offset < offset + size;
+  }
+};
+
+int64_t alignSmemOffset(int64_t offset) {
+  // Same alignment as codegen gives each shared memory buffer
+  constexpr int64_t smem_alignment = 16;
+  return ceilDiv(offset, smem_alignment) * smem_alignment;
+}
+
+} // namespace
+
+std::vector<Expr*> packSharedMemoryAllocations(
+    const std::vector<Expr*>& exprs) {
+  FUSER_PERF_SCOPE("packSharedMemoryAllocations");
+
+  if (isOptionDisabled(DisableOption::SmemPacking)) {
+    return exprs;
+  }
+
+  std::vector<PackedSmemBuffer> buffers;
+  std::unordered_map<TensorView*, size_t> buffer_index;
+  for (auto i : c10::irange(exprs.size())) {
+    auto alloc = dynamic_cast<kir::Allocate*>(exprs[i]);
+    if (alloc == nullptr || alloc->memoryType() != MemoryType::Shared ||
+        alloc->alias() != nullptr || !alloc->buffer()->isA<TensorView>() ||
+        !alloc->size()->isConstInt()) {
+      continue;
+    }
+    PackedSmemBuffer buffer;
+    buffer.alloc = alloc;
+    buffer.size = alloc->size()->evaluateInt() *
+        (int64_t)dataTypeSize(alloc->buffer()->dtype());
+    buffer.first_use = (int64_t)i;
+    buffer.last_use = (int64_t)i;
+    buffer_index.emplace(alloc->buffer()->as<TensorView>(), buffers.size());
+    buffers.push_back(buffer);
+  }
+
+  if (buffers.size() < 2) {
+    return exprs;
+  }
+
+  // Map the aliases of the buffers to the allocations they alias
+  std::unordered_map<TensorView*, const kir::Allocate*> smem_allocs;
+  for (auto expr : lower_utils::flattenScopedExprs(exprs)) {
+    auto alloc = dynamic_cast<kir::Allocate*>(expr);
+    if (alloc != nullptr && alloc->memoryType() == MemoryType::Shared &&
+        alloc->buffer()->isA<TensorView>()) {
+      smem_allocs[alloc->buffer()->as<TensorView>()] = alloc;
+    }
+  }
+
+  auto get_buffer = [&](TensorView* tv) -> PackedSmemBuffer* {
+    auto alloc_it = smem_allocs.find(tv);
+    if (alloc_it == smem_allocs.end()) {
+      return nullptr;
+    }
+    const kir::Allocate* alloc = alloc_it->second;
+    while (alloc->alias() != nullptr) {
+      alloc = alloc->alias();
+    }
+    auto buffer_it = buffer_index.find(alloc->buffer()->as<TensorView>());
+    return buffer_it == buffer_index.end() ? nullptr
+                                           : &buffers.at(buffer_it->second);
+  };
+
+  // Extend the live intervals over all the uses of the buffers
+  for (auto i : c10::irange(exprs.size())) {
+    for (auto expr : lower_utils::flattenScopedExprs({exprs[i]})) {
+      if (!ir_utils::isTvOp(expr)) {
+        continue;
+      }
+      std::vector<Val*> vals = expr->inputs();
+      vals.insert(vals.end(), expr->outputs().begin(), expr->outputs().end());
+      for (auto tv : ir_utils::filterByType<TensorView>(vals)) {
+        if (tv->getMemoryType() != MemoryType::Shared) {
+          continue;
+        }
+        if (auto buffer = get_buffer(tv)) {
+          buffer->last_use = std::max(buffer->last_use, (int64_t)i);
+        }
+      }
+    }
+  }
+
+  // Best-fit placement in order of decreasing size
+  std::vector<PackedSmemBuffer*> placement_order;
+  for (auto& buffer : buffers) {
+    placement_order.push_back(&buffer);
+  }
+  std::stable_sort(
+      placement_order.begin(),
+      placement_order.end(),
+      [](PackedSmemBuffer* a, PackedSmemBuffer* b) {
+        return a->size > b->size;
+      });
+
+  int64_t packed_size = 0;
+  std::vector<PackedSmemBuffer*> placed;
+  for (auto buffer : placement_order) {
+    std::vector<std::pair<int64_t, int64_t>> occupied;
+    for (auto other : placed) {
+      if (buffer->liveAtSameTime(*other)) {
+        occupied.emplace_back(other->offset, other->offset + other->size);
+      }
+    }
+    std::sort(occupied.begin(), occupied.end());
+
+    int64_t best_offset = -1;
+    int64_t best_gap = 0;
+    int64_t gap_begin = 0;
+    for (const auto& range : occupied) {
+      const auto gap = range.first - gap_begin;
+      if (gap >= buffer->size && (best_offset < 0 || gap < best_gap)) {
+        best_offset = gap_begin;
+        best_gap = gap;
+      }
+      gap_begin = std::max(gap_begin, alignSmemOffset(range.second));
+    }
+    buffer->offset = best_offset < 0 ? gap_begin : best_offset;
+    packed_size = std::max(packed_size, buffer->offset + buffer->size);
+    placed.push_back(buffer);
+  }
+
+  // Footprint of the buffers laid out one after another by codegen
+  int64_t sequential_size = 0;
+  for (const auto& buffer : buffers) {
+    sequential_size = alignSmemOffset(sequential_size) + buffer.size;
+  }
+  if (packed_size >= sequential_size) {
+    return exprs;
+  }
+
+  // Insert WAR syncs where a buffer reuses memory of a dead buffer
+  std::vector<bool> sync_before(exprs.size(), false);
+  auto has_sync_between = [&](int64_t last_use, int64_t alloc_pos) {
+    for (auto i = last_use + 1; i <= alloc_pos; ++i) {
+      if (sync_before.at(i) || exprs.at(i)->isA<kir::BlockSync>()) {
+        return true;
+      }
+    }
+    return false;
+  };
+  std::vector<PackedSmemBuffer*> reuse_order = placed;
+  std::stable_sort(
+      reuse_order.begin(),
+      reuse_order.end(),
+      [](PackedSmemBuffer* a, PackedSmemBuffer* b) {
+        return a->first_use < b->first_use;
+      });
+  for (auto buffer : reuse_order) {
+    for (auto other : reuse_order) {
+      if (other->last_use < buffer->first_use &&
+          buffer->sharesMemory(*other) &&
+          !has_sync_between(other->last_use, buffer->first_use)) {
+        sync_before.at(buffer->first_use) = true;
+      }
+    }
+  }
+
+  auto& packed_smem_info = GpuLower::current()->packedSmemInfo();
+  for (const auto& buffer : buffers) {
+    packed_smem_info.offsets[buffer.alloc] = buffer.offset;
+  }
+  packed_smem_info.size = packed_size;
+
+  std::vector<Expr*> packed_exprs;
+  for (auto i : c10::irange(exprs.size())) {
+    if (sync_before.at(i)) {
+      packed_exprs.push_back(IrBuilder::create<kir::BlockSync>(true));
+    }
+    packed_exprs.push_back(exprs.at(i));
+  }
+  return packed_exprs;
+}
+
 } // namespace nvfuser
@@ -32,6 +32,16 @@ namespace nvfuser {
 //!          is not used after this op:
 //! then alias output Allocate to input Allocate.
 //!
+//! Also estimates the register pressure of the local buffers once they are
+//! aliased and records it in GpuLower::registerPressure(). See
+//! Note [ Register pressure estimate ]
 std::vector<Expr*> reuseMemoryAllocations(const std::vector<Expr*>& exprs);
 
+//! Assign offsets of the constant-sized shared memory buffers allocated at
+//! the top level of the kernel so that buffers that are not live at the same
+//! time share memory. Inserts block syncs where memory of a dead buffer gets
+//! reused and records the offsets in GpuLower::packedSmemInfo(). See
+//! Note [ Shared memory offset packing ]
+std::vector<Expr*> packSharedMemoryAllocations(const std::vector<Expr*>& exprs);
+
 } // namespace nvfuser
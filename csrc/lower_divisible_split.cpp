@@ -15,6 +15,24 @@
 
 namespace nvfuser {
 
+std::vector<Split*> getAssumedDivisibleSplits(Fusion* fusion) {
+  const std::string name = "assumed_divisible_splits";
+  if (!fusion->hasManaged(name)) {
+    return {};
+  }
+  std::vector<Split*> splits;
+  for (auto id : fusion->getManaged<std::vector<IterDomain*>>(name)) {
+    auto split = dynamic_cast<Split*>(id->definition());
+    TORCH_INTERNAL_ASSERT(
+        split != nullptr,
+        "Assumed divisible split not found, ",
+        id->toString(),
+        " is not an output of a split");
+    splits.push_back(split);
+  }
+  return splits;
+}
+
 std::unordered_set<Split*> getAllDivisibleSplits(Fusion* fusion) {
   ComputeAtMap ca_map(fusion);
   return getAllDivisibleSplits(fusion, &ca_map);
@@ -71,6 +89,12 @@ std::unordered_set<Split*> getAllDivisibleSplits(
     }
   }
 
+  // Splits schedulers assumed to be divisible, see
+  // Note [ Assumed divisible splits ]
+  for (auto split : getAssumedDivisibleSplits(fusion)) {
+    all_divisible_splits.emplace(split);
+  }
+
   // If there's no view like splits, there's nothing to find
   if (all_divisible_splits.empty()) {
     return all_divisible_splits;
@@ -27,4 +27,24 @@ TORCH_CUDA_CU_API std::unordered_set<Split*> getAllDivisibleSplits(
     Fusion* fusion,
     const ComputeAtMap* ca_map);
 
+// Note [ Assumed divisible splits ]
+//
+// Whether a split is divisible usually can't be proven at compile time, so
+// the split is conservatively predicated and indexed. A scheduler that knows
+// a split evenly divides the problem it is scheduling can register the split
+// with scheduler_utils::assumeDivisibleSplit. The split is then handled like
+// a vectorized split: lowering adds it, along with the splits exactly mapped
+// to it, to the divisible split set, and its divisibility is checked once at
+// launch with the ExpressionEvaluator (see validateVectorizedSplits).
+//
+// A scheduler must only make the assumption when the inputs it schedules
+// for satisfy it, and must record it in its heuristic parameters. Inputs
+// violating the assumption then get different parameters, and with them a
+// generic kernel, instead of failing the launch check of the cached one.
+//
+// The splits are kept as the fusion-managed data "assumed_divisible_splits",
+// see Note [Fusion managed data]. Returns the splits registered in fusion.
+TORCH_CUDA_CU_API std::vector<Split*> getAssumedDivisibleSplits(
+    Fusion* fusion);
+
 } // namespace nvfuser
@@ -168,6 +168,11 @@ class ExprGroup {
     removeEdge(producer_edges_, edge);
   }
 
+  void removeProducerEdges(
+      const std::unordered_set<ExprGroupConnections*>& edges) {
+    removeEdges(producer_edges_, edges);
+  }
+
   void clearProducerEdges() {
     producer_edges_.clear();
   }
@@ -184,6 +189,11 @@ class ExprGroup {
     removeEdge(consumer_edges_, edge);
   }
 
+  void removeConsumerEdges(
+      const std::unordered_set<ExprGroupConnections*>& edges) {
+    removeEdges(consumer_edges_, edges);
+  }
+
   void clearConsumerEdges() {
     consumer_edges_.clear();
   }
@@ -217,6 +227,21 @@ class ExprGroup {
     edges.erase(it);
   }
 
+  // Removes all edges found in edges_to_remove in a single pass, keeping the
+  // order of the remaining edges
+  static void removeEdges(
+      std::vector<ExprGroupConnections*>& edges,
+      const std::unordered_set<ExprGroupConnections*>& edges_to_remove) {
+    edges.erase(
+        std::remove_if(
+            edges.begin(),
+            edges.end(),
+            [&edges_to_remove](ExprGroupConnections* edge) {
+              return edges_to_remove.count(edge) > 0;
+            }),
+        edges.end());
+  }
+
  private:
   // "Ancestor nodes", towards inputs of segmentedDAG
   std::vector<ExprGroupConnections*> producer_edges_;
@@ -312,9 +337,14 @@ class ExprSegmentationSorter {
   // resolved in sorting.
   bool loopReady(IterDomain* concrete_id) const;
 
-  // Disconnect the edges connecting group to the rest of the graph, and return
-  // all the edges that were disconnected
-  std::unordered_set<ExprGroupConnections*> disconnectGroup(ExprGroup* group);
+  // Disconnect the edges connecting groups to the rest of the graph, and
+  // return all the edges that were disconnected
+  std::unordered_set<ExprGroupConnections*> disconnectGroups(
+      const std::unordered_set<ExprGroup*>& groups);
+
+  // Add or remove the compute at domains of group from ca_domain_counts_
+  void registerCaDomains(const ExprGroup* group);
+  void unregisterCaDomains(const ExprGroup* group);
 
   // Add (g1, g2) to the pending "to merge" list.
   void setToMerge(ExprGroup* g1, ExprGroup* g2);
@@ -355,8 +385,34 @@ class ExprSegmentationSorter {
   // others, however, we need a "global" view to track these dependencies.
   std::unordered_map<IterDomain*, std::unordered_set<IterDomain*>>
       concrete_id_dependencies_;
+
+  // Number of occurrences of each concrete ID in the compute at domains of all
+  // live groups. Maintained as groups are created and merged so that loopReady
+  // doesn't have to scan every group, see Note [ Incremental expr sorting ]
+  std::unordered_map<IterDomain*, int64_t> ca_domain_counts_;
 };
 
+// Note [ Incremental expr sorting ]
+//
+// Every merge round of the sorter used to rescan the whole graph several
+// times: loopReady walked the compute at domains of all groups for each
+// candidate pair, resetLevels re-queued groups whose producers weren't visited
+// yet, and disconnecting merged groups erased edges from their neighbors one
+// by one. With many tensors these scans dominate lowering time. Instead, the
+// state those scans recompute is maintained incrementally:
+//
+//  - ca_domain_counts_ tracks how many live groups hold each concrete ID in
+//    their compute at domains, so loopReady only looks at the dependencies of
+//    the loop it is asked about.
+//  - resetLevels is a Kahn traversal driven by remaining producer counts, so
+//    each group and edge is visited once per round.
+//  - Edges of merged groups are removed from their neighbors with a single
+//    pass over each neighbor's edge list.
+//
+// None of this changes which groups are merged or in which order, so the
+// sorted expressions, and the ExprSort debug dump, are identical to a full
+// rescan.
+
 // // Debug printing, disabled due to clang-tidy see above for declarations.
 std::string ExprGroup::toString() const {
   std::stringstream os;
@@ -521,47 +577,41 @@ void ExprSegmentationSorter::resetTraversal() {
 // Level is maximum distance from inputs. It's the metric used to select what
 // nodes can be merged while maintaining a DAG
 void ExprSegmentationSorter::resetLevels() {
-  std::vector<ExprGroup*> next_to_visit;
+  // Number of producer groups of each group that haven't been visited yet.
+  // A group is visited once this count drops to zero, see
+  // Note [ Incremental expr sorting ]
+  std::unordered_map<ExprGroup*, size_t> pending_producers;
+  size_t n_visited = 0;
 
   while (!to_visit_.empty()) {
     auto visit = to_visit_.front();
     to_visit_.pop_front();
 
-    // All inputs processed?
-    bool ready = true;
-    if (!visit->producerEdges().empty()) {
-      ready = std::all_of(
-          visit->producerEdges().begin(),
-          visit->producerEdges().end(),
-          [&](ExprGroupConnections* dep) {
-            return dep->from->payload()->visited;
-          });
-    }
-
-    if (!ready) {
-      // In case traversal doesn't complete because there's an error in the
-      // DAG topology.
-      next_to_visit.push_back(visit);
-      continue;
-    }
-
     visit->payload()->visited = true;
-
-    to_visit_.insert(
-        to_visit_.end(), next_to_visit.begin(), next_to_visit.end());
-    next_to_visit.clear();
-
-    for (auto out : visit->consumerEdges()) {
-      to_visit_.push_back(out->to);
-    }
+    n_visited++;
 
     visit->payload()->level = 0;
     for (auto inp : visit->producerEdges()) {
       visit->payload()->level =
           std::max(visit->payload()->level, inp->from->payload()->level + 1);
     }
+
+    for (auto out : visit->consumerEdges()) {
+      auto consumer = out->to;
+      auto pending_it = pending_producers.find(consumer);
+      if (pending_it == pending_producers.end()) {
+        pending_it =
+            pending_producers
+                .emplace(consumer, consumer->producerEdges().size())
+                .first;
+      }
+      if (--pending_it->second == 0) {
+        to_visit_.push_back(consumer);
+      }
+    }
   }
-  TORCH_INTERNAL_ASSERT(next_to_visit.empty(), "Error in graph, is not a DAG.");
+  TORCH_INTERNAL_ASSERT(
+      n_visited == groups_.size(), "Error in graph, is not a DAG.");
 }
 
 ExprGroup* ExprSegmentationSorter::makeEmptyGroup(bool is_scalar_only) {
@@ -595,9 +645,29 @@ ExprGroup* ExprSegmentationSorter::makeEmptyGroup(
       group->payload()->pa_domains.push_back(concrete_id);
     }
   }
+  registerCaDomains(group);
   return group;
 }
 
+void ExprSegmentationSorter::registerCaDomains(const ExprGroup* group) {
+  for (auto ca_domain : group->payload()->ca_domains) {
+    ca_domain_counts_[ca_domain]++;
+  }
+}
+
+void ExprSegmentationSorter::unregisterCaDomains(const ExprGroup* group) {
+  for (auto ca_domain : group->payload()->ca_domains) {
+    auto count_it = ca_domain_counts_.find(ca_domain);
+    TORCH_INTERNAL_ASSERT(
+        count_it != ca_domain_counts_.end() && count_it->second > 0,
+        "Compute at domain of a group was not registered: ",
+        ca_domain->toString());
+    if (--count_it->second == 0) {
+      ca_domain_counts_.erase(count_it);
+    }
+  }
+}
+
 // Debug function that prints the current state of the sorter.
 //
 // Uncomment if needed.
@@ -755,22 +825,39 @@ std::vector<IterDomain*> getLocalDomainOrdering(
 
 } // namespace
 
-// Disconect group from neighbors, and return edges that were disconnected
+// Disconect groups from neighbors, and return edges that were disconnected
 std::unordered_set<ExprGroupConnections*> ExprSegmentationSorter::
-    disconnectGroup(ExprGroup* group) {
-  std::unordered_set<ExprGroupConnections*> removed_edges(
-      group->producerEdges().begin(), group->producerEdges().end());
-
-  for (auto edge : group->producerEdges()) {
-    edge->from->removeConsumerEdge(edge);
+    disconnectGroups(const std::unordered_set<ExprGroup*>& groups) {
+  std::unordered_set<ExprGroupConnections*> removed_edges;
+  // Neighbors are collected in a vector so that each one's edge lists are
+  // only filtered once, regardless of how many edges it had to the groups.
+  std::unordered_set<ExprGroup*> neighbors;
+  std::vector<ExprGroup*> ordered_neighbors;
+
+  for (auto group : groups) {
+    for (auto edge : group->producerEdges()) {
+      removed_edges.emplace(edge);
+      if (!groups.count(edge->from) && neighbors.emplace(edge->from).second) {
+        ordered_neighbors.push_back(edge->from);
+      }
+    }
+    for (auto edge : group->consumerEdges()) {
+      removed_edges.emplace(edge);
+      if (!groups.count(edge->to) && neighbors.emplace(edge->to).second) {
+        ordered_neighbors.push_back(edge->to);
+      }
+    }
   }
 
-  for (auto edge : group->consumerEdges()) {
-    edge->to->removeProducerEdge(edge);
+  for (auto neighbor : ordered_neighbors) {
+    neighbor->removeProducerEdges(removed_edges);
+    neighbor->removeConsumerEdges(removed_edges);
   }
 
-  group->clearProducerEdges();
-  group->clearConsumerEdges();
+  for (auto group : groups) {
+    group->clearProducerEdges();
+    group->clearConsumerEdges();
+  }
 
   return removed_edges;
 }
@@ -877,6 +964,8 @@ ExprGroup* ExprSegmentationSorter::makeMergedNode(
     }
   }
 
+  registerCaDomains(joined_groups);
+
   if (isDebugDumpEnabled(DebugDumpOption::ExprSort)) {
     std::cout << "==========================================\n" << std::endl;
     std::cout << "Producer:\n" << producer->toString() << std::endl;
@@ -995,7 +1084,6 @@ bool ExprSegmentationSorter::interIterUpdate() {
 
 void ExprSegmentationSorter::mergeNodes() {
   std::unordered_set<ExprGroup*> clean_up_groups;
-  std::unordered_set<ExprGroupConnections*> clean_up_edges;
 
   while (!to_merge_.empty()) {
     ExprGroup *group1 = nullptr, *group2 = nullptr;
@@ -1010,10 +1098,11 @@ void ExprSegmentationSorter::mergeNodes() {
   }
 
   for (auto group : clean_up_groups) {
-    auto disconnected_edges = disconnectGroup(group);
-    clean_up_edges.insert(disconnected_edges.begin(), disconnected_edges.end());
+    unregisterCaDomains(group);
   }
 
+  auto clean_up_edges = disconnectGroups(clean_up_groups);
+
   edges_.remove_if([&](std::unique_ptr<ExprGroupConnections>& edge) {
     return clean_up_edges.find(edge.get()) != clean_up_edges.end();
   });
@@ -1138,9 +1227,8 @@ void ExprSegmentationSorter::initializeForLoopDependencies() {
 }
 
 // Checks if the for loop associated with the concrete ID is ready to be
-// resolved in sorting. This could be done more efficiently with some
-// additional tracking, however we recreate ca_domain_ when we merge groups,
-// so it's hard to track what is no longer needed.
+// resolved in sorting. The compute at domains of all groups are tracked in
+// ca_domain_counts_, see Note [ Incremental expr sorting ]
 bool ExprSegmentationSorter::loopReady(IterDomain* concrete_id) const {
   TORCH_INTERNAL_ASSERT(
       concrete_id ==
@@ -1159,18 +1247,14 @@ bool ExprSegmentationSorter::loopReady(IterDomain* concrete_id) const {
       "Dependency information not found for ",
       concrete_id->toString());
 
+  // Only need to check compute at domain here, because if there's an entry in
+  // produce at, that has no matching entry in compute at, then that ID can be
+  // removed as in canReducePA
   const auto& dependencies = concrete_id_dependencies_.at(concrete_id);
-  for (auto& group : groups_) {
-    // Only need to check compute at domain here, because if there's an entry in
-    // produce at, that has no matching entry in compute at, then that ID can be
-    // removed as in canReducePA
-    for (auto ca_domain : group->payload()->ca_domains) {
-      if (dependencies.count(ca_domain)) {
-        return false;
-      }
-    }
-  }
-  return true;
+  return std::none_of(
+      dependencies.begin(), dependencies.end(), [this](IterDomain* id) {
+        return ca_domain_counts_.count(id) > 0;
+      });
 }
 
 // Two expression groups can be merged together if there's a value produced by
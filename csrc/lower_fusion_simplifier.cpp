@@ -85,6 +85,99 @@ class UnaryOpInserter : private kir::ExprMutator {
   }
 };
 
+// Note [ Native half precision ops ]
+//
+// Type promotion computes pointwise ops of Half and BFloat16 tensors in
+// float, so a half precision add is lowered as
+//
+//   T3 = (float)T1; T4 = (float)T2; T5 = T3 + T4; T6 = (half)T5;
+//
+// which costs three conversions per element. For add, sub and mul, float
+// has more than twice the precision of half and bfloat16, so rounding the
+// float result to half gives the correctly rounded half result, which is
+// also what the native half instructions compute. Max and min are exact
+// anyway. With PYTORCH_NVFUSER_ENABLE=half_precision_ops, the cast back to
+// half is replaced with the op computed natively on T1 and T2, i.e.,
+// T6 = T1 + T2, using the operators of fp16_support.cu and bf16_support.cu.
+// The results are the same bit for bit. The float ops are left in place and
+// removed by the compiler when T5 has no other use.
+//
+// This is only done when T1 and T2 are in registers and the float
+// intermediates are inlined, so T6 reads T1 and T2 in the same loops, at
+// the same indices and under the same predicates as T3 and T4 did.
+class NativeHalfOpInserter : private kir::ExprMutator {
+ public:
+  static std::vector<Expr*> insert(const std::vector<Expr*>& exprs) {
+    NativeHalfOpInserter inserter(exprs);
+    return inserter.exprs_;
+  }
+
+ private:
+  using kir::ExprMutator::handle;
+
+  NativeHalfOpInserter(const std::vector<Expr*>& exprs) {
+    kir::ExprMutator::traverseAndInsert(exprs);
+  }
+
+  static bool isInlined(TensorView* tv) {
+    return tv->getMemoryType() == MemoryType::Local &&
+        tv->getComputeAtPosition() == tv->nDims();
+  }
+
+  // Returns the half precision tensor the float tensor tv is a cast of
+  static TensorView* getHalfProducer(Val* val, DataType dtype) {
+    auto tv = dynamic_cast<TensorView*>(val);
+    if (tv == nullptr || !isInlined(tv)) {
+      return nullptr;
+    }
+    auto cast = dynamic_cast<UnaryOp*>(tv->definition());
+    if (cast == nullptr || cast->getUnaryOpType() != UnaryOpType::Cast) {
+      return nullptr;
+    }
+    auto in_tv = dynamic_cast<TensorView*>(cast->in());
+    if (in_tv == nullptr || in_tv->getDataType() != dtype ||
+        in_tv->getMemoryType() != MemoryType::Local) {
+      return nullptr;
+    }
+    return in_tv;
+  }
+
+  void handle(UnaryOp* uop) final {
+    if (uop->getUnaryOpType() != UnaryOpType::Cast ||
+        !uop->out()->isA<TensorView>()) {
+      return;
+    }
+    const auto dtype = uop->out()->getDataType().value();
+    if (dtype != DataType::Half && dtype != DataType::BFloat16) {
+      return;
+    }
+    auto float_tv = dynamic_cast<TensorView*>(uop->in());
+    if (float_tv == nullptr || float_tv->getDataType() != DataType::Float ||
+        !isInlined(float_tv)) {
+      return;
+    }
+    auto bop = dynamic_cast<BinaryOp*>(float_tv->definition());
+    if (bop == nullptr) {
+      return;
+    }
+    const auto op_type = bop->getBinaryOpType();
+    if (op_type != BinaryOpType::Add && op_type != BinaryOpType::Sub &&
+        op_type != BinaryOpType::Mul && op_type != BinaryOpType::Max &&
+        op_type != BinaryOpType::Min) {
+      return;
+    }
+    auto lhs = getHalfProducer(bop->lhs(), dtype);
+    auto rhs = getHalfProducer(bop->rhs(), dtype);
+    if (lhs == nullptr || rhs == nullptr) {
+      return;
+    }
+    auto new_op = IrBuilder::create<BinaryOp>(
+        uop->container(), op_type, uop->out(), lhs, rhs);
+    registerReplace(uop, new_op);
+    GpuLower::current()->propagateExprInfo(uop, new_op);
+  }
+};
+
 } // namespace
 
 // Transpose, Shift, Gather, and View Ops with Unary Set Ops
@@ -92,4 +185,15 @@ std::vector<Expr*> unarySetOpInserter(const std::vector<Expr*>& exprs) {
   return UnaryOpInserter::insert(exprs);
 }
 
+std::vector<Expr*> nativeHalfOpInserter(const std::vector<Expr*>& exprs) {
+#ifdef USE_ROCM
+  return exprs;
+#else
+  if (!isOptionEnabled(EnableOption::HalfPrecisionOps)) {
+    return exprs;
+  }
+  return NativeHalfOpInserter::insert(exprs);
+#endif
+}
+
 } // namespace nvfuser
@@ -20,4 +20,8 @@ namespace nvfuser {
 // Transpose, Shift, Gather, and View Ops with Unary Set Ops
 std::vector<Expr*> unarySetOpInserter(const std::vector<Expr*>& exprs);
 
+// Compute casts of exact Half and BFloat16 pointwise ops computed in float
+// natively, see Note [ Native half precision ops ]
+std::vector<Expr*> nativeHalfOpInserter(const std::vector<Expr*>& exprs);
+
 } // namespace nvfuser
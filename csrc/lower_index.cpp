@@ -9,6 +9,7 @@
 #include <ir_iostream.h>
 #include <ir_utils.h>
 #include <lower2device.h>
+#include <lower_magic_zero.h>
 #include <lower_utils.h>
 #include <ops/arith.h>
 #include <predicate_compute.h>
@@ -101,10 +102,20 @@ void IndexLowering::handle(const kir::IfThenElse* ite) {
 
   active_scope_ = &new_ite->thenBody();
 
+  // The then clause of an unswitch is the unpredicated version of the
+  // unswitched loop nest
+  const bool prev_magic_zero_free = magic_zero_free_;
+  if (ite->predicate()->predicate_type() == PredicateType::Unswitch &&
+      canDropMagicZero(ite->thenBody().exprs())) {
+    magic_zero_free_ = true;
+  }
+
   for (auto expr : ite->thenBody().exprs()) {
     OptOutConstDispatch::handle(expr);
   }
 
+  magic_zero_free_ = prev_magic_zero_free;
+
   active_scope_ = &new_ite->elseBody();
 
   for (auto expr : ite->elseBody().exprs()) {
@@ -123,6 +134,9 @@ void IndexLowering::handle(const kir::ForLoop* for_loop) {
 
   auto new_for_loop = IrBuilder::create<kir::ForLoop>(for_loop);
   pushBack(new_for_loop);
+  if (magic_zero_free_) {
+    GpuLower::current()->magicZeroFreeLoops().insert(new_for_loop);
+  }
 
   active_scope_ = &new_for_loop->body();
   for_loops_.push_back(new_for_loop);
@@ -156,7 +170,9 @@ void IndexLowering::handle(const RNGOp* rop) {
       rop->dtype(),
       rop->getParameters(),
       rop->getRNGOffset(),
-      philox_index);
+      philox_index,
+      rop->getPhiloxSeed(),
+      rop->getPhiloxOffset());
 
   pushBack(lowered);
   GpuLower::current()->propagateExprInfo(rop, back());
@@ -300,6 +316,23 @@ void IndexLowering::handle(const ScatterOp* sop) {
   GpuLower::current()->propagateExprInfo(sop, back());
 }
 
+void IndexLowering::handle(const ScanOp* sop) {
+  const auto in = lowerSrcIndex(sop->in(), sop->out());
+  const auto out = lowerDstIndex(sop->out());
+
+  // The output is a register carrying the prefix along the scanned loops
+  // that restarts from init at the first element of a row, see
+  // Note [ Scan ops ]
+  auto out_indices = Index::getConsumerPerDimLogicalIndex(
+      sop->out()->as<TensorView>(), for_loops_, getRotatedLoop());
+  auto is_first = IrBuilder::eqExpr(
+      out_indices.at(sop->dim()), GpuLower::current()->kernel()->zeroVal());
+
+  pushBack(IrBuilder::create<ScanOp>(
+      sop->getScanOpType(), sop->init(), out, in, sop->dim(), is_first));
+  GpuLower::current()->propagateExprInfo(sop, back());
+}
+
 void IndexLowering::handle(const SelectOp* sop) {
   auto lowered_index = lowerSrcIndex(sop->input(1), sop->output(0));
   auto lowered_index_cast = lowered_index;
@@ -353,6 +386,27 @@ struct GridCommWorkBufferSizeInfo {
   Val* buffer_stride = nullptr;
 };
 
+// Get the number of threads of a block that are not used for reduction
+// domains, i.e., the number of values each block contributes to a grid
+// communication. See also getGridCommWorkBufferSize.
+Val* getGridCommThreadBufferSize(const TensorDomain* td) {
+  Val* buffer_size = GpuLower::current()->kernel()->oneVal();
+  for (auto pt : kParallelTypeTIDs) {
+    auto pt_dim = GpuLower::current()->parallelDimensionMap().get(pt);
+    if (pt_dim == nullptr || pt_dim->isOneInt()) {
+      continue;
+    }
+    if (std::any_of(td->domain().begin(), td->domain().end(), [&](auto out_id) {
+          return out_id->getParallelType() == pt &&
+              (out_id->isReduction() || out_id->isBroadcast());
+        })) {
+      continue;
+    }
+    buffer_size = SimplifyingIrBuilder::mulExpr(buffer_size, pt_dim);
+  }
+  return buffer_size;
+}
+
 // Get the size of the temporary work buffer for grid communication, this can be
 // grid reduction, broadcast, or grid welford.
 // The buffer is expanded for privatization when not persistent or grouped.
@@ -593,15 +647,24 @@ void IndexLowering::handleGridReduction(
   const auto buffer_size_info =
       getGridCommWorkBufferSize(out_domain, for_loops_, is_persistent);
 
+  auto sync_buffer_size =
+      getGridSyncBufferSize(out_domain, for_loops_, is_persistent);
+
+  // Atomic grid reductions only need one zero-initialized slot per
+  // reduction segment, see Note [ Atomic grid reductions ]
+  const bool is_atomic = lower_utils::isAtomicGridReduction(
+      rop->getReductionOpType(), rop->init(), out_tv->dtype(), is_persistent);
+
   auto work_buffer = allocateUniqueBuffer(
-      buffer_size_info.size_of_privatized_buffer,
+      is_atomic ? SimplifyingIrBuilder::mulExpr(
+                      sync_buffer_size,
+                      getGridCommThreadBufferSize(out_domain))
+                : buffer_size_info.size_of_privatized_buffer,
       out_tv->dtype(),
-      false,
+      is_atomic,
       out_tv,
       work_buffer_map_);
 
-  auto sync_buffer_size =
-      getGridSyncBufferSize(out_domain, for_loops_, is_persistent);
   auto sync_buffer = allocateUniqueBuffer(
       sync_buffer_size, DataType::Int, true, out_tv, sync_buffer_map_);
 
@@ -707,6 +770,136 @@ void IndexLowering::handleBlockReduction(
   GpuLower::current()->propagateExprInfo(grouped_rop, back());
 }
 
+namespace {
+
+// Returns true if a GroupedWelfordOp or GroupedReductionOp op is
+// eligible for using the outer-optimized grouped runtime functions
+bool canUseOuterOptRuntimeKernel(const Expr* grouped_op) {
+  const auto out_tv = ir_utils::getTvOutput(grouped_op);
+  const auto out_domain = out_tv->domain();
+
+  if (!out_domain->hasGridReduction()) {
+    return false;
+  }
+
+  // TIDx and BIDx must be used for non-reduction domains. TIDy and
+  // BIDy must be used for reduction domains.
+  ParallelTypeBitmap used_pts;
+  for (auto leaf_id : out_domain->domain()) {
+    auto pt = leaf_id->getParallelType();
+    if (isParallelTypeThread(pt)) {
+      used_pts.set(pt);
+      if ((leaf_id->isReduction() &&
+           (pt == ParallelType::BIDy || pt == ParallelType::TIDy)) ||
+          (leaf_id->getIterType() == IterType::Iteration &&
+           (pt == ParallelType::BIDx || pt == ParallelType::TIDx))) {
+        // valid pattern
+        continue;
+      } else {
+        return false;
+      }
+    }
+  }
+
+  ParallelTypeBitmap valid_pt_map;
+  valid_pt_map.set(ParallelType::BIDx);
+  valid_pt_map.set(ParallelType::BIDy);
+  valid_pt_map.set(ParallelType::TIDx);
+  valid_pt_map.set(ParallelType::TIDy);
+  if (used_pts != valid_pt_map) {
+    return false;
+  }
+
+  // TIDx and TIDy must be static constant
+  const auto& par_dim_map = GpuLower::current()->parallelDimensionMap();
+  auto tidx_val = par_dim_map.get(ParallelType::TIDx);
+  auto tidy_val = par_dim_map.get(ParallelType::TIDy);
+  if (!tidx_val->isConstInt() || !tidy_val->isConstInt()) {
+    return false;
+  }
+  auto tidx = static_cast<int>(tidx_val->evaluateInt());
+  auto tidy = static_cast<int>(tidy_val->evaluateInt());
+
+  // TIDz and BIDz must be unused or just 1. This contraint can be
+  // lifted if necessary.
+  auto tidz_val = par_dim_map.get(ParallelType::TIDz);
+  if (tidz_val != nullptr && !tidz_val->isOneInt()) {
+    return false;
+  }
+  auto bidz_val = par_dim_map.get(ParallelType::BIDz);
+  if (bidz_val != nullptr && !bidz_val->isOneInt()) {
+    return false;
+  }
+
+  // Warp reduction along threadIdx.y is a key factor for the
+  // outer-optimized kernel. The larger (32 / blockDim.x) is, the more
+  // effective. It shouldn't give any perf benefit when blockDim.x >=
+  // 32 as there's no warp reduction. blockDim.x == 16 is not
+  // preferable, but still would be better than the default
+  // implementation. blockDim.x == 8 is preferred.
+  if (tidx > 16) {
+    return false;
+  }
+
+  int num_grouped_iterations = 1;
+  for (auto axis : out_domain->domain()) {
+    if (axis->getParallelType() == ParallelType::Group) {
+      TORCH_INTERNAL_ASSERT(
+          axis->extent()->isConstInt(),
+          "Grouped IterDomain must have a static integer extent: ",
+          axis->extent()->toInlineString());
+      num_grouped_iterations *= axis->extent()->evaluateInt();
+    }
+  }
+
+  // Assumptions about TIDx/TIDy and group size
+  if (tidy % num_grouped_iterations != 0 || tidx > 32 || 32 % tidx != 0 ||
+      num_grouped_iterations < 32 / tidx) {
+    return false;
+  }
+
+  // Only considers the case where all outputs are local. This
+  // eliminates thread predicates
+  if (std::any_of(
+          grouped_op->outputs().begin(),
+          grouped_op->outputs().end(),
+          [](const Val* output) {
+            return !output->isA<TensorView>() ||
+                output->as<TensorView>()->getMemoryType() != MemoryType::Local;
+          })) {
+    return false;
+  }
+
+  // Must not be predicated. If the per-thread serial reduction is
+  // rfactored, the remaining block+grid reduction is not predicated.
+  if (!((grouped_op->predicate()->hasValue() &&
+         grouped_op->predicate()->value()) ||
+        GpuLower::current()->predicateElimination().canOmitPredicate(
+            grouped_op))) {
+    return false;
+  }
+
+  return true;
+}
+
+// The outer-optimized grouped grid reduction additionally requires a
+// single float or double reduction as the values are exchanged with
+// warp shuffles
+bool canUseOuterOptRuntimeKernel(const GroupedReductionOp* grouped_rop) {
+  if (grouped_rop->numHorizontallyGroupedExprs() != 1) {
+    return false;
+  }
+
+  const auto dtype = grouped_rop->output(0)->dtype();
+  if (dtype != DataType::Float && dtype != DataType::Double) {
+    return false;
+  }
+
+  return canUseOuterOptRuntimeKernel(static_cast<const Expr*>(grouped_rop));
+}
+
+} // namespace
+
 void IndexLowering::handleGridReduction(
     const GroupedReductionOp* grouped_rop,
     const std::vector<Val*>& outputs,
@@ -767,6 +960,11 @@ void IndexLowering::handleGridReduction(
   const auto& thread_pred =
       GpuLower::current()->threadPredMap().getPredicatedParallelTypes(out_tv);
 
+  // Only the allreduce version is implemented, like the welford one
+  bool use_outer_opt = grouped_rop->isAllreduce() &&
+      !isOptionDisabled(DisableOption::GroupedGridReductionOuterOpt) &&
+      canUseOuterOptRuntimeKernel(grouped_rop);
+
   auto grid_reduction = IrBuilder::create<kir::GroupedGridReduction>(
       grouped_rop->getReductionOpTypes(),
       grouped_rop->initVals(),
@@ -777,7 +975,8 @@ void IndexLowering::handleGridReduction(
       entrance_ind,
       n_entrances,
       work_buf_size_info.buffer_stride,
-      grouped_rop->isAllreduce());
+      grouped_rop->isAllreduce(),
+      use_outer_opt);
 
   grid_reduction = grid_reduction->withThreadPredicate(thread_pred);
 
@@ -1029,119 +1228,6 @@ std::vector<kir::Allocate*> IndexLowering::allocateWelfordWorkBuffer(
   return work_buffers;
 }
 
-namespace {
-
-// Returns true if a GroupedWelfordOp op is eligible for using the
-// outer-optimized grouped welford runtime function
-bool canUseOuterOptRuntimeKernel(const GroupedWelfordOp* grouped_wop) {
-  const auto out_tv = ir_utils::getTvOutput(grouped_wop);
-  const auto out_domain = out_tv->domain();
-
-  if (!out_domain->hasGridReduction()) {
-    return false;
-  }
-
-  // TIDx and BIDx must be used for non-reduction domains. TIDy and
-  // BIDy must be used for reduction domains.
-  ParallelTypeBitmap used_pts;
-  for (auto leaf_id : out_domain->domain()) {
-    auto pt = leaf_id->getParallelType();
-    if (isParallelTypeThread(pt)) {
-      used_pts.set(pt);
-      if ((leaf_id->isReduction() &&
-           (pt == ParallelType::BIDy || pt == ParallelType::TIDy)) ||
-          (leaf_id->getIterType() == IterType::Iteration &&
-           (pt == ParallelType::BIDx || pt == ParallelType::TIDx))) {
-        // valid pattern
-        continue;
-      } else {
-        return false;
-      }
-    }
-  }
-
-  ParallelTypeBitmap valid_pt_map;
-  valid_pt_map.set(ParallelType::BIDx);
-  valid_pt_map.set(ParallelType::BIDy);
-  valid_pt_map.set(ParallelType::TIDx);
-  valid_pt_map.set(ParallelType::TIDy);
-  if (used_pts != valid_pt_map) {
-    return false;
-  }
-
-  // TIDx and TIDy must be static constant
-  const auto& par_dim_map = GpuLower::current()->parallelDimensionMap();
-  auto tidx_val = par_dim_map.get(ParallelType::TIDx);
-  auto tidy_val = par_dim_map.get(ParallelType::TIDy);
-  if (!tidx_val->isConstInt() || !tidy_val->isConstInt()) {
-    return false;
-  }
-  auto tidx = static_cast<int>(tidx_val->evaluateInt());
-  auto tidy = static_cast<int>(tidy_val->evaluateInt());
-
-  // TIDz and BIDz must be unused or just 1. This contraint can be
-  // lifted if necessary.
-  auto tidz_val = par_dim_map.get(ParallelType::TIDz);
-  if (tidz_val != nullptr && !tidz_val->isOneInt()) {
-    return false;
-  }
-  auto bidz_val = par_dim_map.get(ParallelType::BIDz);
-  if (bidz_val != nullptr && !bidz_val->isOneInt()) {
-    return false;
-  }
-
-  // Warp reduction along threadIdx.y is a key factor for the
-  // outer-optimized kernel. The larger (32 / blockDim.x) is, the more
-  // effective. It shouldn't give any perf benefit when blockDim.x >=
-  // 32 as there's no warp reduction. blockDim.x == 16 is not
-  // preferable, but still would be better than the default
-  // implementation. blockDim.x == 8 is preferred.
-  if (tidx > 16) {
-    return false;
-  }
-
-  int num_grouped_iterations = 1;
-  for (auto axis : out_domain->domain()) {
-    if (axis->getParallelType() == ParallelType::Group) {
-      TORCH_INTERNAL_ASSERT(
-          axis->extent()->isConstInt(),
-          "Grouped IterDomain must have a static integer extent: ",
-          axis->extent()->toInlineString());
-      num_grouped_iterations *= axis->extent()->evaluateInt();
-    }
-  }
-
-  // Assumptions about TIDx/TIDy and group size
-  if (tidy % num_grouped_iterations != 0 || tidx > 32 || 32 % tidx != 0 ||
-      num_grouped_iterations < 32 / tidx) {
-    return false;
-  }
-
-  // Only considers the case where all outputs are local. This
-  // eliminates thread predicates
-  if (std::any_of(
-          grouped_wop->outputs().begin(),
-          grouped_wop->outputs().end(),
-          [](const Val* output) {
-            return !output->isA<TensorView>() ||
-                output->as<TensorView>()->getMemoryType() != MemoryType::Local;
-          })) {
-    return false;
-  }
-
-  // Must not be predicated. If the per-thread serial reduction is
-  // rfactored, the remaining block+grid reduction is not predicated.
-  if (!((grouped_wop->predicate()->hasValue() &&
-         grouped_wop->predicate()->value()) ||
-        GpuLower::current()->predicateElimination().canOmitPredicate(
-            grouped_wop))) {
-    return false;
-  }
-
-  return true;
-}
-
-} // namespace
 
 void IndexLowering::handleGroupedGridWelford(
     const GroupedWelfordOp* op,
@@ -1289,11 +1375,13 @@ void IndexLowering::handle(const BroadcastOp* bop) {
     return;
   }
 
-  // Grid broadcast
+  // Grid broadcast. The work buffer is double buffered, see
+  // Note [ Double buffered grid broadcast ] in runtime/grid_broadcast.cu
   const auto out_domain = out_tv->domain();
-  const auto work_buffer_size =
+  const auto work_buffer_size = SimplifyingIrBuilder::mulExpr(
       getGridCommWorkBufferSize(out_domain, for_loops_, true)
-          .size_of_privatized_buffer;
+          .size_of_privatized_buffer,
+      IrBuilder::create<Int>(2));
 
   auto work_buffer = allocateUniqueBuffer(
       work_buffer_size, out->dtype(), false, out_tv, work_buffer_map_);
@@ -55,6 +55,7 @@ class TORCH_CUDA_CU_API IndexLowering : private OptOutConstDispatch {
   void handle(const IndexSelectOp*) final;
   void handle(const TorchGatherOp*) final;
   void handle(const ScatterOp*) final;
+  void handle(const ScanOp*) final;
   void handle(const RNGOp*) final;
   void handle(const ReductionOp*) final;
   void handle(const GroupedReductionOp*) final;
@@ -168,6 +169,10 @@ class TORCH_CUDA_CU_API IndexLowering : private OptOutConstDispatch {
   // Keep track of the loop in which the currently visiting expr is a rotated.
   std::unordered_set<kir::ForLoop*> rotated_loop_;
 
+  // True while visiting the unpredicated version of an unswitched loop nest
+  // lowered without magic zero, see Note [ Magic zero in unswitched loops ]
+  bool magic_zero_free_ = false;
+
   // Maps to keep track of allocated buffers and objects that must be
   // allocated only once
   std::unordered_map<TensorView*, kir::Allocate*> sync_buffer_map_;
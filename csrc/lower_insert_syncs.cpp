@@ -778,6 +778,109 @@ class ReadAfterWriteSyncs : public kir::ExprMutator {
   }
 };
 
+// Note [ Redundant block syncs ]
+//
+// RAW syncs are placed per read of shared memory and WAR syncs per loop
+// after the RAW insertion, memory reuse and shared memory packing, each
+// independently of the others, so two block syncs can end up in the same
+// scope with nothing between them but expressions on registers, e.g., a
+// WAR sync at the end of a loop body right after the RAW sync of a
+// register-only epilogue. When two syncs in the same scope are only
+// separated by expressions that neither access shared or global memory
+// nor synchronize threads themselves, every hazard protected by one of
+// them is also protected by the other, so one of them is removed. WAR syncs
+// are kept over RAW syncs, which doesn't matter for correctness but keeps
+// KernelSummary::war_hazard_syncs_count meaningful.
+class RedundantSyncRemover : private kir::ExprMutator {
+ public:
+  static std::vector<Expr*> run(const std::vector<Expr*>& exprs) {
+    RedundantSyncRemover remover(exprs);
+    return remover.exprs_;
+  }
+
+ private:
+  using kir::ExprMutator::handle;
+
+  RedundantSyncRemover(const std::vector<Expr*>& exprs) {
+    kir::ExprMutator::traverseAndInsert(exprs);
+  }
+
+  //! True if an expression does not make a block sync redundant or
+  //! necessary, i.e., it only accesses registers and doesn't synchronize
+  //! threads
+  static bool isRegisterOnly(Expr* expr) {
+    auto is_register_only_scope = [](const kir::Scope& scope) {
+      return std::all_of(
+          scope.exprs().begin(), scope.exprs().end(), isRegisterOnly);
+    };
+    if (expr->isA<kir::Allocate>()) {
+      return true;
+    }
+    if (auto fl = dynamic_cast<kir::ForLoop*>(expr)) {
+      return is_register_only_scope(fl->body());
+    }
+    if (auto ite = dynamic_cast<kir::IfThenElse*>(expr)) {
+      return is_register_only_scope(ite->thenBody()) &&
+          is_register_only_scope(ite->elseBody());
+    }
+    if (!ir_utils::isTvOp(expr) ||
+        lower_utils::hasBlockSync(
+            expr, GpuLower::current()->threadPredMap())) {
+      return false;
+    }
+    auto is_local = [](Val* val) {
+      auto tv = dynamic_cast<TensorView*>(val);
+      return tv == nullptr || tv->getMemoryType() == MemoryType::Local;
+    };
+    return std::all_of(
+               expr->inputs().begin(), expr->inputs().end(), is_local) &&
+        std::all_of(expr->outputs().begin(), expr->outputs().end(), is_local);
+  }
+
+  void handle(Expr* expr) final {
+    if (expr->isA<kir::BlockSync>() || isRegisterOnly(expr)) {
+      kir::ExprMutator::handle(expr);
+      return;
+    }
+    // Process the nested scopes separately
+    last_sync_ = nullptr;
+    kir::ExprMutator::handle(expr);
+    last_sync_ = nullptr;
+  }
+
+  void handle(kir::ForLoop* fl) final {
+    auto prev_sync = last_sync_;
+    last_sync_ = nullptr;
+    kir::ExprMutator::handle(fl);
+    last_sync_ = prev_sync;
+  }
+
+  void handle(kir::IfThenElse* ite) final {
+    auto prev_sync = last_sync_;
+    last_sync_ = nullptr;
+    kir::ExprMutator::handle(ite);
+    last_sync_ = prev_sync;
+  }
+
+  void handle(kir::BlockSync* sync) final {
+    if (last_sync_ == nullptr) {
+      last_sync_ = sync;
+      return;
+    }
+    if (sync->isWarHazardSync() && !last_sync_->isWarHazardSync()) {
+      kir::ExprMutator::registerRemove(last_sync_);
+      last_sync_ = sync;
+    } else {
+      kir::ExprMutator::registerRemove(sync);
+    }
+  }
+
+ private:
+  //! Last block sync in the current scope that isn't followed by any
+  //! expression making another sync necessary
+  kir::BlockSync* last_sync_ = nullptr;
+};
+
 } // namespace
 
 std::vector<Expr*> insertRawThreadSynchronization(
@@ -791,4 +894,11 @@ std::vector<Expr*> insertWarThreadSynchronization(
   FUSER_PERF_SCOPE("GpuLower::Lower::insertWarThreadSynchronization");
   return WarSyncInserter::insert(exprs);
 }
+
+std::vector<Expr*> removeRedundantThreadSynchronization(
+    const std::vector<Expr*>& exprs) {
+  FUSER_PERF_SCOPE("GpuLower::Lower::removeRedundantThreadSynchronization");
+  return RedundantSyncRemover::run(exprs);
+}
+
 } // namespace nvfuser
@@ -29,4 +29,9 @@ std::vector<Expr*> insertWarThreadSynchronization(
 std::vector<Expr*> insertRawThreadSynchronization(
     const std::vector<Expr*>& exprs);
 
+//! Remove block syncs made redundant by another block sync in the same scope
+//! with only register accesses in between. See Note [ Redundant block syncs ]
+std::vector<Expr*> removeRedundantThreadSynchronization(
+    const std::vector<Expr*>& exprs);
+
 } // namespace nvfuser
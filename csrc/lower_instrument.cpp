@@ -12,10 +12,30 @@
 
 #include <lower_instrument.h>
 
+#include <algorithm>
+
 namespace nvfuser {
 
+// Note [ Kernel profile timeline ]
+//
+// The kernel profile accumulates the cycles the last block of the grid
+// spends in each profiled expression, which hides how the blocks differ.
+// With PYTORCH_NVFUSER_ENABLE=kernel_profile(timeline), every block also
+// records the global timer when it enters and leaves each profiled
+// expression, and the SM it runs on, into a second buffer. After the
+// kernel ran, the records are emitted to the PYTORCH_NVFUSER_TRACE trace
+// as one track per SM of the device, next to the host events, so that
+// the phases of the blocks and the imbalance across the SMs can be seen
+// in chrome://tracing. The timer of the device is not synchronized with
+// the host, so the kernel is placed to end when its timeline is read.
+
 namespace {
 
+bool isTimelineEnabled() {
+  const auto& args = getEnableOptionArguments(EnableOption::KernelProfile);
+  return std::find(args.begin(), args.end(), "timeline") != args.end();
+}
+
 class Instrumentor : private kir::IrVisitor {
  public:
   Instrumentor(const std::vector<Expr*>& exprs) {
@@ -33,6 +53,10 @@ class Instrumentor : private kir::IrVisitor {
     // Insert the allocation expression at the beginning of the
     // top-level expressions
     exprs_.push_back(buffer_alloc_);
+
+    if (isTimelineEnabled()) {
+      exprs_.push_back(allocateTimelineBuffer());
+    }
     exprs_.insert(exprs_.end(), exprs.begin(), exprs.end());
   }
 
@@ -90,6 +114,37 @@ class Instrumentor : private kir::IrVisitor {
         buffer_, buffer_->getMemoryType(), nullptr, true);
   }
 
+  //! Allocates three integers per block for each entry, see
+  //! Note [ Kernel profile timeline ]
+  kir::Allocate* allocateTimelineBuffer() {
+    Val* num_blocks = GpuLower::current()->kernel()->oneVal();
+    for (auto pt : kParallelTypeBIDs) {
+      if (auto dim = GpuLower::current()->parallelDimensionMap().get(pt)) {
+        num_blocks = IrBuilder::mulExpr(num_blocks, dim);
+      }
+    }
+
+    const std::vector<IterDomain*> new_buffer_ids = {
+        IterDomainBuilder(
+            GpuLower::current()->kernel()->zeroVal(),
+            IrBuilder::create<Int>(profile_.getNumberOfProfileEntries()))
+            .build(),
+        IterDomainBuilder(GpuLower::current()->kernel()->zeroVal(), num_blocks)
+            .build(),
+        IterDomainBuilder(
+            GpuLower::current()->kernel()->zeroVal(), IrBuilder::create<Int>(3))
+            .build()};
+
+    auto timeline_buffer = IrBuilder::create<TensorView>(
+        IrBuilder::create<TensorDomain>(new_buffer_ids),
+        DataType::Int,
+        MemoryType::Global);
+    profile_.setTimelineBuffer(timeline_buffer);
+
+    return IrBuilder::create<kir::Allocate>(
+        timeline_buffer, timeline_buffer->getMemoryType(), nullptr, true);
+  }
+
  private:
   std::vector<Expr*> exprs_;
   kir::KernelPerformanceProfile profile_;
@@ -0,0 +1,237 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <lower_kernel_cost.h>
+
+#include <device_profile.h>
+#include <instrumentation.h>
+#include <kernel_ir.h>
+#include <kernel_ir_dispatch.h>
+#include <lower_utils.h>
+#include <type.h>
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+namespace nvfuser {
+
+// Note [ Kernel cost estimate ]
+//
+// estimateKernelCost walks the lowered kernel once and counts what a thread
+// does, multiplying the expressions of a loop by its trip count:
+//   - the bytes an expression reads from and writes to tensors in global and
+//     shared memory, by the data types of its TensorIndex inputs and outputs;
+//   - every expression but a copy or an allocation as one arithmetic op;
+//   - block and grid syncs, including the ones inside block and grid
+//     reductions, broadcasts and welfords, which also move their values
+//     through shared memory or the global work buffers.
+// Thread and block parallel loops run once per thread, and both branches of
+// a predicate are counted, so the estimate is an upper bound of the work of
+// the thread with the most. A loop whose trip count can't be evaluated is
+// counted once and clears `exact`.
+//
+// It only needs the kernel IR and the launch parameters, so a kernel can be
+// estimated right after lowering, before code generation and NVRTC, which is
+// what FusionExecutor::setCostFilter uses to drop candidates of the
+// autotuning that aren't worth compiling, see
+// Note [ Background autotuning ]. estimatedTimeUs turns the estimate into a
+// roofline time of the device: the slowest of global traffic at the DRAM
+// bandwidth, shared memory traffic at one 4-byte word per bank per cycle and
+// arithmetic at 64 ops per cycle per multiprocessor, plus the syncs and the
+// launch latency, all taken from the device profile, see
+// Note [ Device profiles ]. It ignores caches, coalescing, bank conflicts
+// and occupancy, so it ranks variants of a kernel rather than predicting
+// its time.
+
+namespace {
+
+class KernelCostAnalysis : private kir::IrVisitor {
+ public:
+  static KernelCostEstimate get(
+      kir::Kernel* kernel,
+      const LaunchParams& launch_params,
+      ExpressionEvaluator& expr_eval) {
+    KernelCostAnalysis analysis(kernel, expr_eval);
+    analysis.estimate_.threads_per_block =
+        std::max<int64_t>(launch_params.nThreads(), 1);
+    analysis.estimate_.blocks = std::max<int64_t>(launch_params.nBlocks(), 1);
+    analysis.handle(kernel->topLevelExprs());
+    return analysis.estimate_;
+  }
+
+ private:
+  KernelCostAnalysis(kir::Kernel* kernel, ExpressionEvaluator& expr_eval)
+      : summary_(&kernel->summary()), expr_eval_(expr_eval) {}
+
+  using kir::IrVisitor::handle;
+
+  int64_t tripCount(kir::ForLoop* fl) {
+    if (fl->isTrivial()) {
+      return 1;
+    }
+    auto start = expr_eval_.evaluate(fl->start());
+    auto stop = expr_eval_.evaluate(fl->stop());
+    auto step = expr_eval_.evaluate(fl->step());
+    if (!start.has_value() || !stop.has_value() || !step.has_value() ||
+        step->as<int64_t>() <= 0) {
+      estimate_.exact = false;
+      return 1;
+    }
+    const auto trip_count = ceilDiv(
+        stop->as<int64_t>() - start->as<int64_t>(), step->as<int64_t>());
+    return std::max<int64_t>(trip_count, 0);
+  }
+
+  void handle(kir::ForLoop* fl) final {
+    const auto saved_multiplier = multiplier_;
+    multiplier_ *= tripCount(fl);
+    if (multiplier_ > 0) {
+      kir::IrVisitor::handle(fl);
+    }
+    multiplier_ = saved_multiplier;
+  }
+
+  // Adds the traffic of a TensorIndex, returns its size in bytes
+  int64_t countAccess(Val* val, bool is_write) {
+    auto ti = dynamic_cast<kir::TensorIndex*>(val);
+    if (ti == nullptr) {
+      return 0;
+    }
+    const auto bytes = (int64_t)dataTypeSize(ti->dtype());
+    switch (ti->view()->getMemoryType()) {
+      case MemoryType::Global:
+        if (is_write) {
+          estimate_.global_store_bytes += bytes * multiplier_;
+          estimate_.global_store_elements += multiplier_;
+        } else {
+          estimate_.global_load_bytes += bytes * multiplier_;
+        }
+        break;
+      case MemoryType::Shared:
+        (is_write ? estimate_.smem_write_bytes : estimate_.smem_read_bytes) +=
+            bytes * multiplier_;
+        break;
+      default:
+        break;
+    }
+    return bytes;
+  }
+
+  // Adds the traffic and the arithmetic of an expression
+  void countExpr(Expr* expr) {
+    for (auto inp : expr->inputs()) {
+      countAccess(inp, false);
+    }
+    int64_t out_bytes = 0;
+    for (auto out : expr->outputs()) {
+      out_bytes += countAccess(out, true);
+    }
+
+    const bool is_copy = expr->isA<LoadStoreOp>() ||
+        (expr->isA<UnaryOp>() &&
+         expr->as<UnaryOp>()->getUnaryOpType() == UnaryOpType::Set);
+    if (!is_copy && !expr->isA<BroadcastOp>()) {
+      estimate_.arithmetic_ops += multiplier_;
+    }
+
+    // Values exchanged between the threads of a block or of the grid
+    bool block = false;
+    bool grid = false;
+    if (auto bop = dynamic_cast<BroadcastOp*>(expr)) {
+      auto it = summary_->broadcast_parallel_types.find(bop);
+      if (it != summary_->broadcast_parallel_types.end()) {
+        block = it->second.hasTID();
+        grid = it->second.hasBID();
+      }
+    } else if (auto out = ir_utils::getTvOutput(expr)) {
+      block = out->domain()->hasBlockReduction();
+      grid = out->domain()->hasGridReduction();
+    }
+    if (block) {
+      // Through shared memory, with a sync before and after
+      estimate_.smem_write_bytes += out_bytes * multiplier_;
+      estimate_.smem_read_bytes += out_bytes * multiplier_;
+      estimate_.block_syncs += 2 * multiplier_;
+    }
+    if (grid) {
+      // Through the work buffer, with the semaphore of the sync buffer
+      estimate_.global_store_bytes += out_bytes * multiplier_;
+      estimate_.global_load_bytes += out_bytes * multiplier_;
+      estimate_.grid_syncs += multiplier_;
+    }
+  }
+
+  void handle(Expr* expr) final {
+    if (expr->isA<kir::ForLoop>() || expr->isA<kir::IfThenElse>()) {
+      kir::IrVisitor::handle(expr);
+    } else if (expr->isA<kir::BlockSync>()) {
+      estimate_.block_syncs += multiplier_;
+    } else if (expr->isA<kir::GridSync>()) {
+      estimate_.grid_syncs += multiplier_;
+    } else if (
+        auto grid_broadcast = dynamic_cast<kir::GridBroadcast*>(expr)) {
+      countExpr(grid_broadcast->broadcast_op());
+    } else if (auto grid_welford = dynamic_cast<kir::GridWelford*>(expr)) {
+      countExpr(grid_welford->welford_op());
+    } else if (ir_utils::isTvOp(expr)) {
+      countExpr(expr);
+    }
+  }
+
+ private:
+  const kir::KernelSummary* summary_;
+  ExpressionEvaluator& expr_eval_;
+  int64_t multiplier_ = 1;
+  KernelCostEstimate estimate_;
+};
+
+} // namespace
+
+double KernelCostEstimate::estimatedTimeUs(int device_index) const {
+  const auto& device = getDeviceProfile(device_index);
+  const double sms = (double)device.sm_count;
+  const double cycles_per_us = device.clock_rate_khz / 1000.0;
+  const double dram_bytes_per_us = device.memory_bandwidth_gbs * 1000.0;
+  const double threads = (double)threads_per_block * (double)blocks;
+  const double smem_bytes_per_us = sms * 32 * 4 * cycles_per_us;
+  const double ops_per_us = sms * 64 * cycles_per_us;
+
+  const double throughput_us = std::max(
+      {(double)totalGlobalBytes() / dram_bytes_per_us,
+       (double)totalSmemBytes() / smem_bytes_per_us,
+       (double)arithmetic_ops * threads / ops_per_us});
+  // A block sync stalls a block for a few tens of cycles and every wave of
+  // blocks pays for it, a grid sync waits for the whole grid
+  constexpr double kBlockSyncCycles = 20;
+  constexpr double kGridSyncUs = 2;
+  const double waves = std::ceil((double)blocks / sms);
+  return device.launch_latency_us + throughput_us +
+      (double)block_syncs * kBlockSyncCycles * waves / cycles_per_us +
+      (double)grid_syncs * kGridSyncUs;
+}
+
+std::string KernelCostEstimate::toString() const {
+  std::stringstream ss;
+  ss << "global " << global_load_bytes << " B read, " << global_store_bytes
+     << " B written, smem " << smem_read_bytes << " B read, "
+     << smem_write_bytes << " B written, " << arithmetic_ops << " ops ("
+     << arithmeticPerElement() << " per element), " << block_syncs
+     << " block syncs, " << grid_syncs << " grid syncs per thread of "
+     << threads_per_block << " x " << blocks << (exact ? "" : " (inexact)");
+  return ss.str();
+}
+
+KernelCostEstimate estimateKernelCost(
+    kir::Kernel* kernel,
+    const LaunchParams& launch_params,
+    ExpressionEvaluator& expr_eval) {
+  FUSER_PERF_SCOPE("estimateKernelCost");
+  return KernelCostAnalysis::get(kernel, launch_params, expr_eval);
+}
+
+} // namespace nvfuser
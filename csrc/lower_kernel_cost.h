@@ -0,0 +1,69 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <executor_params.h>
+#include <expr_evaluator.h>
+#include <kernel.h>
+
+namespace nvfuser {
+
+//! Static estimate of the work of a lowered kernel at given launch
+//! parameters, see Note [ Kernel cost estimate ]. Traffic and arithmetic are
+//! counted per thread, syncs per block.
+struct TORCH_CUDA_CU_API KernelCostEstimate {
+  int64_t global_load_bytes = 0;
+  int64_t global_store_bytes = 0;
+  int64_t smem_read_bytes = 0;
+  int64_t smem_write_bytes = 0;
+  //! Elements of global tensors a thread writes
+  int64_t global_store_elements = 0;
+  //! Arithmetic expressions, i.e. everything but data movement
+  int64_t arithmetic_ops = 0;
+  int64_t block_syncs = 0;
+  int64_t grid_syncs = 0;
+
+  int64_t threads_per_block = 1;
+  int64_t blocks = 1;
+
+  //! False if some loop had a trip count that couldn't be evaluated and was
+  //! counted as a single iteration
+  bool exact = true;
+
+  int64_t totalGlobalBytes() const {
+    return (global_load_bytes + global_store_bytes) * threads_per_block *
+        blocks;
+  }
+
+  int64_t totalSmemBytes() const {
+    return (smem_read_bytes + smem_write_bytes) * threads_per_block * blocks;
+  }
+
+  //! Arithmetic expressions per element written to global memory
+  double arithmeticPerElement() const {
+    return global_store_elements > 0
+        ? (double)arithmetic_ops / (double)global_store_elements
+        : (double)arithmetic_ops;
+  }
+
+  //! Roofline time of the estimate on a device, in microseconds. Only meant
+  //! to rank kernels of the same fusion against each other.
+  double estimatedTimeUs(int device_index) const;
+
+  std::string toString() const;
+};
+
+//! Estimates the cost of kernel. The extents of the kernel must be evaluable
+//! by expr_eval, e.g. with the inputs and the launch parameters bound by
+//! FusionExecutor::computeLaunchParams.
+TORCH_CUDA_CU_API KernelCostEstimate estimateKernelCost(
+    kir::Kernel* kernel,
+    const LaunchParams& launch_params,
+    ExpressionEvaluator& expr_eval);
+
+} // namespace nvfuser
@@ -99,12 +99,15 @@ class RotateLoop : kir::ExprMutator {
  public:
   static std::vector<Expr*> run(
       std::vector<Expr*> exprs,
-      const LoopRotationParam& params) {
+      const LoopRotationParam& params,
+      bool skip_invalid) {
     // Rotate one loop at a time so that nested loops can be rotated without
     // interacting with each other.
     for (auto item : params) {
       exprs = RotateLoop(
-                  std::get<0>(item)->axis(std::get<1>(item)), std::get<2>(item))
+                  std::get<0>(item)->axis(std::get<1>(item)),
+                  std::get<2>(item),
+                  skip_invalid)
                   .traverseAndInsert(exprs);
     }
     return exprs;
@@ -115,12 +118,19 @@ class RotateLoop : kir::ExprMutator {
   IterDomain* loop_concrete_id_;
   // The selected tvs/exprs to be rotated
   std::unordered_set<Statement*> selection_;
+  // Leave the loop as is instead of erroring out when the selection can't
+  // be rotated
+  bool skip_invalid_ = false;
 
-  RotateLoop(IterDomain* loop_id, std::unordered_set<Statement*> selection)
+  RotateLoop(
+      IterDomain* loop_id,
+      std::unordered_set<Statement*> selection,
+      bool skip_invalid)
       : loop_concrete_id_(GpuLower::current()->caMap()->getConcreteMappedID(
             loop_id,
             IdMappingMode::LOOP)),
-        selection_(selection) {}
+        selection_(selection),
+        skip_invalid_(skip_invalid) {}
 
   // We use the following strategy on expr selection:
   // - If a Val is selected, then its allocation is automatically selected.
@@ -369,8 +379,15 @@ class RotateLoop : kir::ExprMutator {
     expandSelection(fl);
     auto id = fl->iter_domain();
     if (id == loop_concrete_id_) {
-      TORCH_CHECK(
-          validateSelection(fl), "Unable to rotate loop ", fl->toString());
+      const bool valid = validateSelection(fl);
+      if (!valid && skip_invalid_) {
+        if (isDebugDumpEnabled(DebugDumpOption::LoopRotation)) {
+          std::cout << "[Loop rotation] Skipping loop:" << std::endl
+                    << fl->toString() << std::endl;
+        }
+        return;
+      }
+      TORCH_CHECK(valid, "Unable to rotate loop ", fl->toString());
       rotate(fl);
     }
   }
@@ -385,8 +402,9 @@ class RotateLoop : kir::ExprMutator {
 
 std::vector<Expr*> rotateLoops(
     const std::vector<Expr*>& exprs,
-    const LoopRotationParam& params) {
-  return RotateLoop::run(exprs, params);
+    const LoopRotationParam& params,
+    bool skip_invalid) {
+  return RotateLoop::run(exprs, params, skip_invalid);
 }
 
 } // namespace nvfuser
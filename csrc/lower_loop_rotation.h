@@ -145,8 +145,14 @@ namespace nvfuser {
 using LoopRotationParam = std::vector<
     std::tuple<TensorView*, int64_t, std::unordered_set<Statement*>>>;
 
+// Schedulers apply loop rotation heuristically, in which case the loop
+// structure isn't known ahead of lowering. Those rotations are passed as
+// "optional_loop_rotation" rather than "loop_rotation" and are skipped with
+// skip_invalid when the selection turns out not to be at the top of the
+// loop, instead of failing the compilation.
 std::vector<Expr*> rotateLoops(
     const std::vector<Expr*>& exprs,
-    const LoopRotationParam& params);
+    const LoopRotationParam& params,
+    bool skip_invalid = false);
 
 } // namespace nvfuser
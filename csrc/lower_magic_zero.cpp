@@ -40,6 +40,11 @@ class MagicZeroInserter : public kir::ExprMutator {
 
   void handle(kir::ForLoop* fl) final {
     if (fl->isUnrolled()) {
+      // Nothing in these loops is protected, see
+      // Note [ Magic zero in unswitched loops ]
+      if (GpuLower::current()->magicZeroFreeLoops().count(fl)) {
+        return;
+      }
       if (scope_.empty()) {
         kir::ExprMutator::registerInsertAfter(
             fl, IrBuilder::create<kir::UpdateMagicZero>());
@@ -57,6 +62,31 @@ class MagicZeroInserter : public kir::ExprMutator {
   std::vector<InsertionInfo> insertion_list_;
 };
 
+// Maximum number of iterations of an unpredicated unswitched loop nest
+// lowered without magic zero, see Note [ Magic zero in unswitched loops ]
+constexpr int64_t kMaxUnrolledIterationsWithoutMagicZero = 16;
+
+// Returns the largest number of iterations unrolled across the loop nests
+// of exprs
+int64_t getUnrolledIterations(const std::vector<Expr*>& exprs) {
+  int64_t max_iterations = 1;
+  for (auto expr : exprs) {
+    int64_t iterations = 1;
+    if (auto fl = dynamic_cast<kir::ForLoop*>(expr)) {
+      iterations = getUnrolledIterations(fl->body().exprs());
+      if (fl->isUnrolled()) {
+        iterations *= fl->stop()->evaluateInt() - fl->start()->evaluateInt();
+      }
+    } else if (auto ite = dynamic_cast<kir::IfThenElse*>(expr)) {
+      iterations = std::max(
+          getUnrolledIterations(ite->thenBody().exprs()),
+          getUnrolledIterations(ite->elseBody().exprs()));
+    }
+    max_iterations = std::max(max_iterations, iterations);
+  }
+  return max_iterations;
+}
+
 } // namespace
 
 std::vector<Expr*> insertMagicZero(const std::vector<Expr*>& exprs) {
@@ -102,6 +132,15 @@ Val* maybeUnwrapMagicZero(Val* val) {
   }
 }
 
+bool canDropMagicZero(const std::vector<Expr*>& unswitched_exprs) {
+  if (isOptionDisabled(DisableOption::MagicZeroElision) ||
+      !GpuLower::current()->isNvFuserZeroEnabled()) {
+    return false;
+  }
+  return getUnrolledIterations(unswitched_exprs) <=
+      kMaxUnrolledIterationsWithoutMagicZero;
+}
+
 bool needsMagicZero(
     kir::ForLoop* loop,
     IterDomain* reference_domain,
@@ -114,6 +153,10 @@ bool needsMagicZero(
     return false;
   }
 
+  if (GpuLower::current()->magicZeroFreeLoops().count(loop)) {
+    return false;
+  }
+
   bool ref_dom_simple =
       reference_domain == nullptr || reference_domain->definition() != nullptr;
   bool ind_simple =
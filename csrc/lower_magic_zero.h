@@ -35,6 +35,25 @@ bool isProtectedWithMagicZero(const Val* val);
 //! maybeUnwrapMagicZero(i2 + magic_zero) -> i2
 Val* maybeUnwrapMagicZero(Val* val);
 
+// Note [ Magic zero in unswitched loops ]
+//
+// Magic zero keeps nvrtc from precomputing the indices and predicates of
+// all the iterations of an unrolled loop, which would blow up register
+// usage, at the cost of an add per protected index and an update after
+// each unrolled loop nest. An unswitched loop nest is versioned by a single
+// runtime check that the whole nest is in bounds, see UnrollPass, and the
+// unpredicated version that check guards has no predicate left to protect,
+// only the indices of its tensors. When that version unrolls no more than
+// kMaxUnrolledIterationsWithoutMagicZero iterations, the indices nvrtc may
+// keep around fit in registers anyway, so its loops are lowered without
+// magic zero and without its updates. The predicated version, which only
+// runs for the tiles crossing a boundary, keeps the protection. This can be
+// turned off with PYTORCH_NVFUSER_DISABLE=magic_zero_elision.
+
+//! Check if the unpredicated version of an unswitched loop nest, given by
+//! the then clause of its unswitch, can be lowered without magic zero
+bool canDropMagicZero(const std::vector<Expr*>& unswitched_exprs);
+
 // Determine if we may run into over reuse of predicates or registers in the
 // compiler. If the loop can be unrolled and the index and domain are not
 // "simple" we likely want the loop protected.
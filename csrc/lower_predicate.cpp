@@ -54,12 +54,15 @@ class ConditionalFromPredicateModifier : public kir::ExprMutator {
           // now.
           auto ite = expr->as<kir::IfThenElse>();
 
+          // A vectorized index_select may be preceded by the cast of its
+          // index to the index type, see IndexLowering::handle(IndexSelectOp)
+          auto vec_expr = ite->thenBody().exprs().back();
           TORCH_INTERNAL_ASSERT(
-              ite->thenBody().size() == 1,
+              ite->thenBody().size() == 1 || vec_expr->isA<IndexSelectOp>(),
               "Expecting predicated body to only have one vectorized expression.");
-          auto vec_expr = ite->thenBody()[0];
           TORCH_INTERNAL_ASSERT(
-              vec_expr->isA<UnaryOp>() || vec_expr->isA<LoadStoreOp>(),
+              vec_expr->isA<UnaryOp>() || vec_expr->isA<LoadStoreOp>() ||
+                  vec_expr->isA<IndexSelectOp>(),
               "Vectorize predicate exprs only supported on set operations.");
           TORCH_INTERNAL_ASSERT(
               ir_utils::isTvOp(vec_expr),
@@ -196,11 +196,16 @@ class PredicateChcker : public IterVisitor {
   using IterVisitor::handle;
 
   void handle(Expr* expr) final {
-    needs_predicate_ = predicateIntDiv(expr) ||
-        predicateMisalignedVectorize(expr) || predicateShift(expr) ||
-        predicateSharedMemAccess(expr) || predicateProducerConsumerPair(expr) ||
+    // Checks are ordered by cost, as the first one that holds decides.
+    //  Most expressions of a kernel read or write global memory, so they
+    //  are settled before any of the checks replaying producers as
+    //  consumers, which are left to the end.
+    needs_predicate_ = predicateGlobalAccess(expr) || predicateIntDiv(expr) ||
+        predicateMisalignedVectorize(expr) ||
+        predicateNonDivisibleSplit(expr) || predicateShift(expr) ||
+        predicateSharedMemAccess(expr) || predicateExpandReduce(expr) ||
         predicateNonDivisibleRootDomains(expr) ||
-        predicateNonDivisibleSplit(expr) || predicateExpandReduce(expr);
+        predicateProducerConsumerPair(expr);
 
     // A cp.async op would need a predicate for either the global
     //  input or its shared mem output, or both.
@@ -227,6 +232,21 @@ class PredicateChcker : public IterVisitor {
   // All "predicateXYZ" functions return true if an expr needs to be
   // predicated.
 
+  // Global tensors are allocated based on their root domains, so any
+  // producer-consumer pair involving one must be predicated. This is the
+  // cheap part of predicateProducerConsumerPair.
+  bool predicateGlobalAccess(Expr* expr) const {
+    for (auto output : ir_utils::filterByType<TensorView>(expr->outputs())) {
+      for (auto input : ir_utils::filterByType<TensorView>(expr->inputs())) {
+        if (input->getMemoryType() == MemoryType::Global ||
+            output->getMemoryType() == MemoryType::Global) {
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
   // Always predicate integer division and related ops as we don't
   // know what values are in the out-of-bound region and they may
   // cause exceptions
@@ -842,6 +862,12 @@ PredicateElimination::PredicateElimination(Fusion* fusion) {
   traverseTo(fusion, fusion->outputs());
 }
 
+bool PredicateElimination::needsProducerConsumerPredicate(
+    TensorView* producer,
+    TensorView* consumer) {
+  return PredicateAnalyzer::needsPredicate(producer, consumer);
+}
+
 bool PredicateElimination::needsPredicate(Expr* expr) const {
   return PredicateChcker::needsPredicate(expr, *this);
 }
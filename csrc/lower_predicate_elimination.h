@@ -24,6 +24,15 @@ class TORCH_CUDA_CU_API PredicateElimination : public IterVisitor {
   //! \param expr Tensor expression
   bool canOmitPredicate(const Expr* expr) const;
 
+  //! True if consumer may read producer out of bounds without a predicate,
+  //!  which is always the case when either is on global memory. Only needs
+  //!  the scheduled fusion, not a lowering, so schedulers can check if a
+  //!  parallelization they consider keeps the predicates of local and
+  //!  shared memory accesses, e.g., because of non-divisible splits.
+  static bool needsProducerConsumerPredicate(
+      TensorView* producer,
+      TensorView* consumer);
+
   //! Value to initialize out-of-bound regions
   Val* getInitValue(TensorView* tv) const;
 
@@ -97,14 +97,17 @@ kir::ForLoop* getLoopAtPos(
 }
 
 // Check if in the definition of from, there is a subexpression equivalent to
-// reference. If found, then return this subexpression.
+// reference. If found, then return this subexpression. Unless exact, the
+// subexpression may differ from reference in the order of the operands of
+// associative and commutative operators, as the simplified indices and
+// predicates of different tensors may order the same terms differently.
 Val* findRefAsSubexprOf(Val* from, Val* reference, bool exact) {
   if (exact) {
     if (from == reference) {
       return from;
     }
   } else {
-    if (from->sameAs(reference)) {
+    if (sameAsModuloReordering(from, reference)) {
       return from;
     }
   }
@@ -163,7 +166,7 @@ std::pair<Val*, bool> CommonScalarMap::hoistScalarImpl(
     return {existing_subexpr, false};
   }
   for (auto existing_subexpr : seen_subexprs) {
-    if (value->sameAs(existing_subexpr)) {
+    if (sameAsModuloReordering(value, existing_subexpr)) {
       common_scalar_map_[my_loop].emplace_back(existing_subexpr);
       hoisted_or_reused_.emplace(existing_subexpr);
       return {existing_subexpr, false};
@@ -201,9 +204,15 @@ std::pair<Val*, bool> CommonScalarMap::hoistScalarImpl(
   // `common_scalar_map_` so that future `value` could consider reusing it. If
   // `value` is a subexpression of the given value, then we insert it into
   // `common_scalar_map_` only if it can be hoisted to outer loops.
-  if (!has_tensor_index_dependency && (is_given || my_pos < parent_pos)) {
+  // The multiplier of fastDiv is expensive to compute, so it's always
+  // allocated even if it's not used more than once or can't be hoisted
+  const auto uop = dynamic_cast<UnaryOp*>(value->definition());
+  const bool is_fast_div_multiplier = uop != nullptr &&
+      uop->getUnaryOpType() == UnaryOpType::FastDivMultiplier;
+  if (!has_tensor_index_dependency &&
+      (is_given || my_pos < parent_pos || is_fast_div_multiplier)) {
     common_scalar_map_[my_loop].emplace_back(value);
-    if (my_pos < parent_pos) {
+    if (my_pos < parent_pos || is_fast_div_multiplier) {
       hoisted_or_reused_.emplace(value);
     }
   }
@@ -278,11 +287,18 @@ std::vector<Bool*> getAssumptions(const std::vector<kir::ForLoop*>& loops) {
 Val* CommonScalarMap::hoistScalar(
     Val* value,
     const std::vector<kir::ForLoop*>& loops) {
-  value =
-      simplifyExpr(value, getVariableInfo(value, loops), getAssumptions(loops));
+  const auto variables = getVariableInfo(value, loops);
+  const auto assumptions = getAssumptions(loops);
+  value = simplifyExpr(value, variables, assumptions);
   if (isOptionDisabled(DisableOption::IndexHoist)) {
     return value;
   }
+  // The multipliers of fastDiv are always hoisted, so only rewrite divisions
+  // when hoisting is enabled, see Note [ Fast integer division ]
+  if (GpuLower::current()->kernel()->indexType() == PrimDataType::Int32 &&
+      !isOptionDisabled(DisableOption::FastDivMod)) {
+    value = strengthReduceDivMod(value, variables, assumptions);
+  }
   std::vector<Val*> seen_subexprs;
   return hoistScalarImpl(
              value,
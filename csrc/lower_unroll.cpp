@@ -56,6 +56,31 @@ bool isReductionInitExpr(const Expr* expr) {
   return true;
 }
 
+// If the number of visits of the loop body per thread is one, the
+// unswitch predicate is sufficient.
+// When the loop stop is the same as the extent of its IterDomain,
+// the per-thread visit count is guaranteed to be one at most (see
+// CudaKernelGenerator::handle(kir::ForLoop*) as well. Also, when a
+// loop is vectorized (not misaligned), the count must be one at
+// most. Even if not parallelized nor vectoirzed, it is also
+// sufficient if the loop stop is in fact one.
+bool isVisitedOnce(kir::ForLoop* loop) {
+  auto id = loop->iter_domain();
+  if ((id->isThread() && (loop->stop() == id->extent())) ||
+      id->getParallelType() == ParallelType::Vectorize) {
+    return true;
+  }
+  return loop->stop()->isConstInt() && loop->stop()->evaluateInt() == 1;
+}
+
+bool hasBlockSyncInLoopNest(kir::ForLoop* loop) {
+  const auto& pred_map = GpuLower::current()->threadPredMap();
+  const auto exprs = ir_utils::flattenScopedExprs(loop->body().exprs());
+  return std::any_of(exprs.begin(), exprs.end(), [&](Expr* expr) {
+    return lower_utils::hasBlockSync(expr, pred_map);
+  });
+}
+
 } // namespace
 
 void UnrollPass::registerReplace(Expr* reference, Expr* new_expr) {
@@ -192,7 +217,14 @@ void UnrollPass::handle(kir::ForLoop* fl) {
 
   // If we're not looking for an unroll loop, or didn't find one, process as
   // normal.
-  if (!is_unroll || !look_for_unroll_) {
+  if (!is_unroll || !(look_for_unroll_ || canPeelFullTiles(fl))) {
+    // Loops of the else clause iterated more than once may hold full tiles,
+    // see Note [ Peeling full tiles ]
+    const bool is_else_clause_serial_loop =
+        else_clause_ && !unswitched_loop_ && !isVisitedOnce(fl);
+    if (is_else_clause_serial_loop) {
+      ++else_clause_serial_loops_;
+    }
     for_loops_.push_back(fl);
     scope_.push_back(&fl->body());
     scope_exprs_.push_back(fl);
@@ -210,9 +242,19 @@ void UnrollPass::handle(kir::ForLoop* fl) {
     for_loops_.pop_back();
     scope_.pop_back();
     scope_exprs_.pop_back();
+    if (is_else_clause_serial_loop) {
+      --else_clause_serial_loops_;
+    }
     return;
   }
 
+  // Unswitching may be nested in the else clause of another unswitch, so
+  // save the state to restore at the end
+  const bool saved_look_for_unroll = look_for_unroll_;
+  const bool saved_else_clause = else_clause_;
+  const auto saved_else_clause_serial_loops = else_clause_serial_loops_;
+  const bool saved_non_trivial_pred_found = non_trivial_pred_found_;
+
   auto unroll_pred = IrBuilder::create<kir::Predicate>(fl);
 
   kir::IfThenElse* unroll_ite = IrBuilder::create<kir::IfThenElse>(unroll_pred);
@@ -227,9 +269,9 @@ void UnrollPass::handle(kir::ForLoop* fl) {
   scope_exprs_.push_back(unroll_ite);
   unswitched_loop_ = true;
   look_for_unroll_ = false;
+  else_clause_ = false;
   handle(unrolled_loop_nest);
   unswitched_loop_ = false;
-  look_for_unroll_ = true;
   scope_.pop_back();
   scope_exprs_.pop_back();
 
@@ -239,13 +281,21 @@ void UnrollPass::handle(kir::ForLoop* fl) {
   // Add inline predicates for inlined loop nest
   scope_.push_back(&unroll_ite->elseBody());
   scope_exprs_.push_back(unroll_ite);
-  look_for_unroll_ = false;
   non_trivial_pred_found_ = false;
+  else_clause_ = true;
+  else_clause_serial_loops_ = 0;
   handle(inlined_loop);
-  look_for_unroll_ = true;
   scope_.pop_back();
   scope_exprs_.pop_back();
-  if (!non_trivial_pred_found_) {
+  const bool non_trivial_pred_found = non_trivial_pred_found_;
+
+  look_for_unroll_ = saved_look_for_unroll;
+  else_clause_ = saved_else_clause;
+  else_clause_serial_loops_ = saved_else_clause_serial_loops;
+  non_trivial_pred_found_ =
+      saved_non_trivial_pred_found || non_trivial_pred_found;
+
+  if (!non_trivial_pred_found) {
     kir::ExprMutator::registerReplace(fl, inlined_loop);
   } else {
     if (!canOmitElseClause(fl)) {
@@ -255,6 +305,26 @@ void UnrollPass::handle(kir::ForLoop* fl) {
   }
 }
 
+// Note [ Peeling full tiles ]
+//
+// The else clause of an unswitched loop nest predicates every element. When
+// the nest has a serial loop, e.g., a loop over the unrolled tiles of a
+// non-divisible domain, the predicate of the unswitch fails for the whole
+// nest because of the last, partial tile, so all the full tiles run the
+// predicated path as well. To avoid that, the unrolled loops nested in a
+// serial loop of the else clause are unswitched again, which peels the full
+// tiles off into an unpredicated path and leaves the predicates to the
+// partial tiles. Like any unswitch the choice is made at runtime by the
+// predicate of the full tile. Loop nests with block syncs are not peeled so
+// that threads don't diverge at barriers. This can be turned off with
+// PYTORCH_NVFUSER_DISABLE=tile_peeling.
+bool UnrollPass::canPeelFullTiles(kir::ForLoop* fl) const {
+  return else_clause_ && !unswitched_loop_ && else_clause_serial_loops_ > 0 &&
+      fl->iter_domain()->getParallelType() == ParallelType::Unroll &&
+      !isOptionDisabled(DisableOption::TilePeeling) &&
+      !hasBlockSyncInLoopNest(fl);
+}
+
 bool UnrollPass::canOmitElseClause(kir::ForLoop* fl) {
   std::vector<kir::ForLoop*> loops({fl});
 
@@ -284,29 +354,9 @@ bool UnrollPass::canOmitElseClause(kir::ForLoop* fl) {
         resize_exprs.insert(expr);
       }
     }
-    // If the number of visits of the loop body per thread is one, the
-    // unswitch predicate is sufficient.
-    // When the loop stop is the same as the extent of its IterDomain,
-    // the per-thread visit count is guaranteed to be one at most (see
-    // CudaKernelGenerator::handle(kir::ForLoop*) as well. Also, when a
-    // loop is vectorized (not misaligned), the count must be one at
-    // most. Even if not parallelized nor vectoirzed, it is also
-    // sufficient if the loop stop is in fact one.
-    bool visit_once = false;
-    auto id = loop->iter_domain();
-    if ((id->isThread() && (loop->stop() == id->extent())) ||
-        id->getParallelType() == ParallelType::Vectorize) {
-      visit_once = true;
-    }
-    if (!visit_once) {
-      if (loop->stop()->isConstInt() && loop->stop()->evaluateInt() == 1) {
-        visit_once = true;
-      }
-    }
-
     // The visit count is not guaranteed to be one, so the else part
     // must be created.
-    if (!visit_once) {
+    if (!isVisitedOnce(loop)) {
       return false;
     }
 
@@ -79,6 +79,10 @@ class TORCH_CUDA_CU_API UnrollPass : kir::ExprMutator {
 
   void handle(kir::ForLoop* fl) final;
 
+  //! Check if the full tiles of an unrolled loop in the else clause of an
+  //! unswitch should be peeled off. See Note [ Peeling full tiles ]
+  bool canPeelFullTiles(kir::ForLoop* fl) const;
+
   void handle(Expr* expr) final;
 
  private:
@@ -95,6 +99,14 @@ class TORCH_CUDA_CU_API UnrollPass : kir::ExprMutator {
   // As we generate inline predicates check if we actually generated a
   // non-trivial one.
   bool non_trivial_pred_found_ = false;
+
+  // Indicates if the currently visited expression is inside the else clause
+  // of an unswitch
+  bool else_clause_ = false;
+
+  // Number of loops in the else clause visited more than once per thread
+  // enclosing the currently visited expression
+  int64_t else_clause_serial_loops_ = 0;
 };
 
 } // namespace nvfuser
@@ -130,6 +130,7 @@ bool isTvOp(const Expr* expr) {
           IndexSelectOp,
           TorchGatherOp,
           ScatterOp,
+          ScanOp,
           RNGOp,
           FullOp,
           IotaOp,
@@ -659,6 +660,41 @@ kir::Allocate* allocGlobalBufferForGridComm(
       buffer_tv, buffer_tv->getMemoryType(), nullptr, zero_init);
 }
 
+// Note [ Atomic grid reductions ]
+//
+// A non-persistent grid reduction has every block store its partial result
+// to its own slot of the work buffer, and the last block of each reduction
+// segment waits for all the others and then reduces all of the slots. That
+// serializes the whole cross-block reduction in the tail of one block, and
+// the work buffer is as large as the grid.
+//
+// With EnableOption::AtomicGridReduction, a floating-point sum instead has
+// every block atomically add its partial result to a single slot per
+// reduction segment and thread, so the last block only reads one value per
+// output after the grid sync. The last block also resets the slot to zero,
+// so the buffer only needs to be zero-filled when it is allocated, and can be
+// kept in the persistent workspace. The slots are kept apart from
+// semaphores there, see Note [ Persistent workspace ].
+//
+// The order of the atomic additions is undefined, so results are not
+// bitwise reproducible across launches, which is why this is opt-in.
+bool isAtomicGridReduction(
+    BinaryOpType op_type,
+    const Val* init,
+    DataType dtype,
+    bool is_allreduce) {
+#ifdef USE_ROCM
+  return false;
+#else
+  // Profiled grid reductions take extra arguments that only gridReduce
+  // supports
+  return isOptionEnabled(EnableOption::AtomicGridReduction) &&
+      !isOptionEnabled(EnableOption::KernelProfile) && !is_allreduce &&
+      op_type == BinaryOpType::Add && init->isZero() &&
+      (dtype == DataType::Float || dtype == DataType::Double);
+#endif
+}
+
 BasicAllocInfo getAllocInformation(
     const TensorView* tv,
     const std::vector<kir::ForLoop*>& for_loops,
@@ -710,6 +746,12 @@ BasicAllocInfo getAllocInformation(
       outer_alloc_found = true;
     }
 
+    // The output of a scan carries the prefix of a row across its scanned
+    // loops, so it's allocated outside of them. See Note [ Scan ops ]
+    if (ir_utils::isScanAxis(tv, tv->axis(info.alloc_pos))) {
+      outer_alloc_found = true;
+    }
+
     auto local_id = tv->axis(info.alloc_pos);
 
     if (use_id_map) {
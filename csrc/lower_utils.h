@@ -238,6 +238,15 @@ kir::Allocate* allocGlobalBufferForGridComm(
     DataType dtype,
     bool zero_init);
 
+//! Returns true if the partial results of a grid reduction are accumulated
+//! with atomics instead of being reduced by the last block, see
+//! Note [ Atomic grid reductions ]
+bool isAtomicGridReduction(
+    BinaryOpType op_type,
+    const Val* init,
+    DataType dtype,
+    bool is_allreduce);
+
 struct BasicAllocInfo {
   // The for loop that the initialization of this allocation must be
   // placed in, nullptr if not within a loop
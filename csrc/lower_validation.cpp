@@ -489,6 +489,15 @@ class VectorizeValidator : public OptInDispatch {
   }
 };
 
+//! An index_select loading rows of its lookup tensor from global memory
+//! into registers can be vectorized along the row like a Set, as the index
+//! only moves where the row starts. See Note [ Index select scheduling ]
+bool isVectorizedIndexSelect(TensorView* tv) {
+  auto sop = dynamic_cast<IndexSelectOp*>(tv->definition());
+  return sop != nullptr && tv->getMemoryType() == MemoryType::Local &&
+      sop->input(0)->as<TensorView>()->getMemoryType() == MemoryType::Global;
+}
+
 } // namespace
 
 // Uses ContigIDs to find root contig domains that a vectorized domain
@@ -553,7 +562,8 @@ void validateAndCollectVectorizeInfo(Fusion* fusion) {
               (tv->definition()->isA<UnaryOp>() &&
                tv->definition()->as<UnaryOp>()->getUnaryOpType() ==
                    UnaryOpType::Set) ||
-              tv->definition()->isA<LoadStoreOp>(),
+              tv->definition()->isA<LoadStoreOp>() ||
+              isVectorizedIndexSelect(tv),
           "Vectorized accesses cannot be inline with computation, they are only supported with a Set operation.",
           "TensorView: ",
           tv);
@@ -561,7 +571,7 @@ void validateAndCollectVectorizeInfo(Fusion* fusion) {
     // Validate the vectorized domain maps to the innermost domain of
     // tv. Note that we don't need to validate its producer tv as
     // both Vectorize and MisalignedVectorize can only be used with
-    // UnaryOp::Set.
+    // UnaryOp::Set, or with an index_select whose lookup is the producer.
     if (has_vectorize_dim || has_misaligned_vectorize_dim) {
       VectorizeValidator::validate(tv);
     }
@@ -1358,4 +1368,177 @@ void validateResize(Fusion* fusion) {
   }
 }
 
+void validateScanOps(Fusion* fusion) {
+  for (auto sop : ir_utils::getScanOps(fusion)) {
+    auto tv = sop->out()->as<TensorView>();
+    TORCH_CHECK(
+        tv->getMemoryType() == MemoryType::Local,
+        "The output of a scan must be in local memory: ",
+        tv->toString());
+
+    auto scan_id = tv->getRootDomain().at(sop->dim());
+    int last_scan_pos = -1;
+    for (const auto i : c10::irange(tv->nDims())) {
+      auto id = tv->axis((int)i);
+      if (!ir_utils::isScanAxis(tv, id)) {
+        TORCH_CHECK(
+            last_scan_pos < 0 || (int)i >= (int)tv->getComputeAtPosition() ||
+                id->isThread() || id->isBroadcast(),
+            "The loop of ",
+            id->toString(),
+            " of ",
+            tv->toString(),
+            " is inside of its scanned loops, the scan would restart in it");
+        TORCH_CHECK(
+            last_scan_pos >= 0 || id->getParallelType() != ParallelType::Unroll,
+            "The loop of ",
+            id->toString(),
+            " of ",
+            tv->toString(),
+            " is outside of its scanned loops and can't be unrolled");
+        continue;
+      }
+      TORCH_CHECK(
+          id->getParallelType() == ParallelType::Serial,
+          "Scanned domains are computed serially by a thread, but ",
+          id->toString(),
+          " of ",
+          tv->toString(),
+          " is parallelized");
+      const auto root_vals = IterVisitor::getInputsTo(
+          {id}, {tv->getRootDomain().begin(), tv->getRootDomain().end()});
+      for (auto root_id : ir_utils::filterByType<IterDomain>(root_vals)) {
+        TORCH_CHECK(
+            root_id == scan_id || root_id->isBroadcast(),
+            "Scanned domain ",
+            id->toString(),
+            " of ",
+            tv->toString(),
+            " can not be merged with ",
+            root_id->toString());
+      }
+      last_scan_pos = (int)i;
+    }
+    // The output is only a single register along the scanned loops if it's
+    // inlined in them, see Note [ Scan ops ]
+    TORCH_CHECK(
+        last_scan_pos < (int)tv->getComputeAtPosition(),
+        "The output of a scan must be inlined in its scanned loops: ",
+        tv->toString());
+  }
+}
+
+// Note [ In-place outputs ]
+//
+// An output aliased to an input with Fusion::aliasOutputToInput is written to
+// the buffer of the input, e.g., the running stats of batch norm, parameters
+// updated by an optimizer step or the residual of an add. This is only safe
+// if no element of the input is read after it got overwritten. Threads of a
+// kernel are only ordered per element, so every element computed from the
+// input may only depend on the element of the input at the same position:
+// the input may only be read through pointwise, broadcast and permute ops,
+// the domains of the input must end up at their own positions in the output,
+// and the output must not depend on reductions of a domain of the input.
+// Other outputs may reduce what is computed from the input, e.g., the
+// normalized output of a residual norm updating its residual in place: each
+// element of the input is then read by the thread writing it, and the
+// persistent buffers computed from it are not projected back to the input,
+// which would read it again after the reduction. Segments are ordered by
+// FusionKernelRuntime::prepareRuntimeOrder so that the segment overwriting an
+// input runs after all other segments reading it, so only the exprs of a
+// segment are checked. As rfactor domains of scheduled reductions make the
+// domains hard to follow, this runs on the fusion of each segment before it
+// is scheduled.
+void validateAliasedOutputs(Fusion* fusion) {
+  for (const auto& alias : fusion->ioAlias()) {
+    auto out_tv = dynamic_cast<TensorView*>(alias.first);
+    auto in_tv = dynamic_cast<TensorView*>(alias.second);
+    if (out_tv == nullptr || in_tv == nullptr || !out_tv->isFusionOutput() ||
+        !in_tv->isFusionInput()) {
+      continue;
+    }
+
+    // Position in the input of the domains its elements are indexed by
+    std::unordered_map<IterDomain*, size_t> input_positions;
+    const auto in_domain =
+        TensorDomain::noReductions(in_tv->getMaybeRFactorDomain());
+    for (const auto i : c10::irange(in_domain.size())) {
+      if (!in_domain[i]->isBroadcast()) {
+        input_positions.emplace(in_domain[i], i);
+      }
+    }
+
+    auto dependents = DependencyCheck::getAllDependentVals({in_tv});
+    dependents.insert(in_tv);
+    const auto output_dependencies = DependencyCheck::getAllValsBetween(
+        {in_tv}, {out_tv});
+    const std::unordered_set<Val*> output_dependency_set(
+        output_dependencies.begin(), output_dependencies.end());
+    for (auto expr : fusion->exprs()) {
+      for (auto producer :
+           ir_utils::filterByType<TensorView>(expr->inputs())) {
+        if (!dependents.count(producer)) {
+          continue;
+        }
+        TORCH_CHECK(
+            expr->isOneOf<
+                UnaryOp,
+                BinaryOp,
+                TernaryOp,
+                LoadStoreOp,
+                BroadcastOp,
+                TransposeOp,
+                ReductionOp,
+                WelfordOp>(),
+            "Input ",
+            in_tv->toString(),
+            " can not be overwritten in place by ",
+            out_tv->toString(),
+            ", it is read by ",
+            expr->toString());
+        for (auto consumer :
+             ir_utils::filterByType<TensorView>(expr->outputs())) {
+          const auto p2c = PairwiseRootDomainMap(producer, consumer)
+                               .mapProducerToConsumer(
+                                   producer->domain(), consumer->domain());
+          for (const auto& kv : p2c) {
+            auto position_it = input_positions.find(kv.first);
+            if (position_it == input_positions.end()) {
+              continue;
+            }
+            const auto position = position_it->second;
+            auto consumer_it = input_positions.find(kv.second);
+            TORCH_CHECK(
+                (!kv.second->isReduction() ||
+                 !output_dependency_set.count(consumer)) &&
+                    (consumer_it == input_positions.end() ||
+                     consumer_it->second == position),
+                "Input ",
+                in_tv->toString(),
+                " can not be overwritten in place by ",
+                out_tv->toString(),
+                ", ",
+                consumer->toString(),
+                " combines elements of it at different positions");
+            input_positions.emplace(kv.second, position);
+          }
+        }
+      }
+    }
+
+    const auto out_domain =
+        TensorDomain::noReductions(out_tv->getMaybeRFactorDomain());
+    for (const auto i : c10::irange(out_domain.size())) {
+      auto position_it = input_positions.find(out_domain[i]);
+      TORCH_CHECK(
+          position_it == input_positions.end() || position_it->second == i,
+          "Input ",
+          in_tv->toString(),
+          " can not be overwritten in place by ",
+          out_tv->toString(),
+          ", as the output is permuted");
+    }
+  }
+}
+
 } // namespace nvfuser
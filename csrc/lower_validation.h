@@ -80,4 +80,12 @@ void validateLookupTV(Fusion* fusion);
 //! Validate resize usage
 void validateResize(Fusion* fusion);
 
+//! Validate that the outputs of scans are registers carried along serial
+//! scanned loops, see Note [ Scan ops ]
+void validateScanOps(Fusion* fusion);
+
+//! Validate that the inputs outputs are aliased to can be overwritten in
+//! place. Runs on unscheduled fusions, see Note [ In-place outputs ]
+void validateAliasedOutputs(Fusion* fusion);
+
 } // namespace nvfuser
@@ -50,6 +50,8 @@ class WelfordVectorizer : public kir::ExprMutator {
 
     if (isVectorizableWelford(wop)) {
       vectorize(wop);
+    } else if (isMergeableWelford(wop)) {
+      mergeVectorizedReduction(wop);
     }
   }
 
@@ -163,16 +165,7 @@ class WelfordVectorizer : public kir::ExprMutator {
         "Predicate IfThenElse not found for ",
         wop->toString());
 
-    TORCH_INTERNAL_ASSERT(!for_loops_.empty());
-    innermost_loop_ = for_loops_.back();
-
-    scope_of_innermost_loop_ = nullptr;
-    for (int i = (int)scope_.size() - 1; i >= 0; --i) {
-      if (&(innermost_loop_->body()) == scope_.at(i)) {
-        scope_of_innermost_loop_ = scope_.at(i - 1);
-      }
-    }
-    TORCH_INTERNAL_ASSERT(scope_of_innermost_loop_ != nullptr);
+    setInnermostLoop();
 
     // If the expr is predicated, hoist the predicate as the innermost
     // loop should not have any dependency with the predicate (which
@@ -386,6 +379,278 @@ class WelfordVectorizer : public kir::ExprMutator {
     return vectorized_wop;
   }
 
+  // Check if a serial WelfordOp over a vectorized reduction domain can be
+  // merged as a whole. See Note [ Merging vectorized welford reductions ].
+  //
+  // Look for a pattern as:
+  //
+  // for (int i = 0; i < V; ++i) {
+  //   if (pred) {
+  //     WelfordCombine(out, in[i], 0, 1);
+  //   }
+  // }
+  //
+  // where V is a constant, the loop is exactly mapped with a vectorized
+  // IterDomain and pred doesn't depend on i.
+  bool isMergeableWelford(WelfordOp* wop) const {
+    const auto out_tv = ir_utils::getTvOutput(wop);
+    const auto out_domain = out_tv->domain();
+
+    auto innermost_leaf_id = out_tv->axis(-1);
+    if (!innermost_leaf_id->isReduction() ||
+        innermost_leaf_id->getParallelType() != ParallelType::Serial) {
+      return false;
+    }
+
+    TORCH_INTERNAL_ASSERT(!for_loops_.empty());
+    auto innermost_loop = for_loops_.back();
+
+    if (innermost_loop->isTrivial() || !innermost_loop->start()->isZeroInt() ||
+        !innermost_loop->step()->isOneInt() ||
+        !innermost_loop->iter_domain()->extent()->isConstInt()) {
+      return false;
+    }
+
+    if (out_tv->getMemoryType() != MemoryType::Local || wop->isAllreduce() ||
+        out_domain->hasBlockReduction() || out_domain->hasGridReduction() ||
+        !wop->inVar()->isZeroInt() || !wop->inN()->isOneInt()) {
+      return false;
+    }
+
+    if (!GpuLower::current()->caMap()->areMapped(
+            innermost_loop->iter_domain(),
+            innermost_leaf_id,
+            IdMappingMode::EXACT)) {
+      return false;
+    }
+
+    const auto& exact_set = GpuLower::current()
+                                ->caMap()
+                                ->getIdSets(IdMappingMode::EXACT)
+                                .getDisjointSetOf(innermost_leaf_id);
+    if (std::none_of(exact_set.begin(), exact_set.end(), [&](IterDomain* id) {
+          return id->getParallelType() == ParallelType::Vectorize;
+        })) {
+      return false;
+    }
+
+    TORCH_INTERNAL_ASSERT(!scope_exprs_.empty());
+    kir::IfThenElse* wop_ite =
+        dynamic_cast<kir::IfThenElse*>(scope_exprs_.back());
+    if (wop_ite == nullptr ||
+        !(wop_ite->thenBody().size() == 1 &&
+          wop_ite->thenBody().at(0) == wop && wop_ite->elseBody().empty())) {
+      return false;
+    }
+
+    auto pred = wop_ite->predicate();
+    if (pred->predicate_type() != PredicateType::Manual &&
+        pred->predicate_type() != PredicateType::Inline) {
+      return false;
+    }
+
+    TORCH_INTERNAL_ASSERT(
+        pred->hasValue(),
+        "All predicates should have been lowered at this point: ",
+        wop_ite->toString());
+
+    // The merged result is combined after the loop, so the predicate must be
+    // the same for all iterations
+    if (pred->isConst()) {
+      return pred->value()->value().value_or(false);
+    }
+    return !DependencyCheck::isDependencyOf(
+        innermost_loop->index(), pred->value());
+  }
+
+  // Note [ Merging vectorized welford reductions ]
+  //
+  // A serial welford over a vectorized reduction domain, e.g., of the inner
+  // welford of a layer norm whose input loads are vectorized, updates the
+  // running average and M2 with each element, which needs a division per
+  // element. Instead, the loop only accumulates the sum and the sum of
+  // squares of the elements shifted by the first element, which keeps the
+  // variance computation numerically stable, and the partial result is
+  // combined with the running one once after the loop:
+  //
+  // Before:
+  // for (i = 0; i < V; ++i) {
+  //   if (pred) {
+  //     welfordCombine(avg, M2, N, in[i], 0, 1);
+  //   }
+  // }
+  //
+  // After:
+  // float shift = 0, sum = 0, sum_sq = 0;
+  // for (i = 0; i < V; ++i) {
+  //   if (pred) {
+  //     shift = where(i == 0, in[i], shift);
+  //     float d = in[i] - shift;
+  //     sum = sum + d;
+  //     sum_sq = sum_sq + d * d;
+  //   }
+  // }
+  // if (pred) {
+  //   float mean = sum / (float)V;
+  //   // Same as welfordCombine(avg, M2, N, shift + mean, sum_sq - sum * mean,
+  //   // V), spelled out as the WelfordOp input must be a tensor
+  //   ...
+  // }
+  void mergeVectorizedReduction(WelfordOp* wop) {
+    kir::IfThenElse* wop_ite = scope_exprs_.back()->as<kir::IfThenElse>();
+    auto pred = wop_ite->predicate();
+
+    setInnermostLoop();
+
+    DataType data_type = wop->outAvg()->getDataType().value();
+    auto zero = GpuLower::current()->kernel()->zeroVal();
+
+    auto shift = defineScalar(data_type);
+    auto sum = defineScalar(data_type);
+    auto sum_sq = defineScalar(data_type);
+    auto diff = defineScalar(data_type);
+    auto diff_sq = defineScalar(data_type);
+    for (auto val : {shift, sum, sum_sq}) {
+      registerInsertBeforeInnerMostLoop(
+          IrBuilder::create<UnaryOp>(UnaryOpType::Set, val, zero));
+    }
+
+    // Accumulate the shifted elements in place of the WelfordOp
+    auto in = wop->inAvg();
+    auto& loop_body = wop_ite->thenBody();
+    for (auto expr : std::vector<Expr*>{
+             IrBuilder::create<TernaryOp>(
+                 TernaryOpType::Where,
+                 shift,
+                 IrBuilder::eqExpr(innermost_loop_->index(), zero),
+                 in,
+                 shift),
+             IrBuilder::create<BinaryOp>(BinaryOpType::Sub, diff, in, shift),
+             IrBuilder::create<BinaryOp>(BinaryOpType::Add, sum, sum, diff),
+             IrBuilder::create<BinaryOp>(
+                 BinaryOpType::Mul, diff_sq, diff, diff),
+             IrBuilder::create<BinaryOp>(
+                 BinaryOpType::Add, sum_sq, sum_sq, diff_sq)}) {
+      registerInsertBefore(wop, expr, &loop_body);
+    }
+    registerRemove(wop, &loop_body);
+
+    // The accumulators are updated in place. Don't leave them defined by
+    // their own updates, which would make their definitions cyclic.
+    for (auto val : {shift, sum, sum_sq}) {
+      val->setDefinition(nullptr);
+    }
+
+    // Combine the partial result after the loop as welfordCombine does.
+    // The outputs are local and indexed independently of the loop.
+    auto copy_index = [](Val* val) -> Val* {
+      auto ti = val->as<kir::TensorIndex>();
+      return IrBuilder::create<kir::TensorIndex>(ti->view(), ti->index());
+    };
+    auto out_avg = wop->outAvg();
+    auto out_var = wop->outVar();
+    auto out_N = wop->outN();
+    DataType index_type = out_N->getDataType().value();
+
+    auto count = IrBuilder::create<Int>(
+        innermost_loop_->iter_domain()->extent()->evaluateInt());
+    std::vector<Expr*> merge_exprs;
+    auto new_scalar = [&](DataType dt) {
+      auto val = IrBuilder::newScalar(dt);
+      merge_exprs.push_back(IrBuilder::create<kir::Allocate>(
+          val, MemoryType::Local, GpuLower::current()->kernel()->oneVal()));
+      return val;
+    };
+    auto count_float = new_scalar(data_type);
+    auto mean = new_scalar(data_type);
+    auto in_avg = new_scalar(data_type);
+    auto sum_mean = new_scalar(data_type);
+    auto in_M2 = new_scalar(data_type);
+    auto old_count_float = new_scalar(data_type);
+    auto new_count = new_scalar(index_type);
+    auto new_count_float = new_scalar(data_type);
+    auto ratio = new_scalar(data_type);
+    auto delta = new_scalar(data_type);
+    auto delta_ratio = new_scalar(data_type);
+    auto delta_sq_ratio = new_scalar(data_type);
+    auto M2_update = new_scalar(data_type);
+    auto M2_increment = new_scalar(data_type);
+
+    // Mean and M2 of the loop
+    merge_exprs.push_back(
+        IrBuilder::create<UnaryOp>(UnaryOpType::Cast, count_float, count));
+    merge_exprs.push_back(
+        IrBuilder::create<BinaryOp>(BinaryOpType::Div, mean, sum, count_float));
+    merge_exprs.push_back(
+        IrBuilder::create<BinaryOp>(BinaryOpType::Add, in_avg, shift, mean));
+    merge_exprs.push_back(
+        IrBuilder::create<BinaryOp>(BinaryOpType::Mul, sum_mean, sum, mean));
+    merge_exprs.push_back(IrBuilder::create<BinaryOp>(
+        BinaryOpType::Sub, in_M2, sum_sq, sum_mean));
+
+    // Combine with the running result
+    merge_exprs.push_back(IrBuilder::create<UnaryOp>(
+        UnaryOpType::Cast, old_count_float, copy_index(out_N)));
+    merge_exprs.push_back(IrBuilder::create<BinaryOp>(
+        BinaryOpType::Add, new_count, copy_index(out_N), count));
+    merge_exprs.push_back(IrBuilder::create<UnaryOp>(
+        UnaryOpType::Cast, new_count_float, new_count));
+    merge_exprs.push_back(IrBuilder::create<BinaryOp>(
+        BinaryOpType::Div, ratio, count_float, new_count_float));
+    merge_exprs.push_back(IrBuilder::create<BinaryOp>(
+        BinaryOpType::Sub, delta, in_avg, copy_index(out_avg)));
+    merge_exprs.push_back(IrBuilder::create<BinaryOp>(
+        BinaryOpType::Mul, delta_ratio, delta, ratio));
+    merge_exprs.push_back(IrBuilder::create<BinaryOp>(
+        BinaryOpType::Add,
+        copy_index(out_avg),
+        copy_index(out_avg),
+        delta_ratio));
+    merge_exprs.push_back(IrBuilder::create<BinaryOp>(
+        BinaryOpType::Mul, delta_sq_ratio, delta, delta_ratio));
+    merge_exprs.push_back(IrBuilder::create<BinaryOp>(
+        BinaryOpType::Mul, M2_update, delta_sq_ratio, old_count_float));
+    merge_exprs.push_back(IrBuilder::create<BinaryOp>(
+        BinaryOpType::Add, M2_increment, in_M2, M2_update));
+    merge_exprs.push_back(IrBuilder::create<BinaryOp>(
+        BinaryOpType::Add,
+        copy_index(out_var),
+        copy_index(out_var),
+        M2_increment));
+    merge_exprs.push_back(IrBuilder::create<UnaryOp>(
+        UnaryOpType::Set, copy_index(out_N), new_count));
+
+    Expr* insertion_point = innermost_loop_;
+    kir::Scope* merge_scope = scope_of_innermost_loop_;
+    if (!pred->isConst()) {
+      auto merge_ite = IrBuilder::create<kir::IfThenElse>(
+          IrBuilder::create<kir::Predicate>(pred->value()));
+      registerInsertAfter(insertion_point, merge_ite, merge_scope);
+      for (auto expr : merge_exprs) {
+        merge_ite->thenBody().push_back(expr);
+      }
+      return;
+    }
+    for (auto expr : merge_exprs) {
+      registerInsertAfter(insertion_point, expr, merge_scope);
+      insertion_point = expr;
+    }
+  }
+
+  // Find the innermost loop and the scope it is in
+  void setInnermostLoop() {
+    TORCH_INTERNAL_ASSERT(!for_loops_.empty());
+    innermost_loop_ = for_loops_.back();
+
+    scope_of_innermost_loop_ = nullptr;
+    for (int i = (int)scope_.size() - 1; i >= 0; --i) {
+      if (&(innermost_loop_->body()) == scope_.at(i)) {
+        scope_of_innermost_loop_ = scope_.at(i - 1);
+      }
+    }
+    TORCH_INTERNAL_ASSERT(scope_of_innermost_loop_ != nullptr);
+  }
+
   // Declare a scalar variable of type dt and insert its allocation
   Val* defineScalar(DataType dt) {
     Val* val = IrBuilder::newScalar(dt);
@@ -39,6 +39,11 @@ class Expr;
 // non-reduction domain and is vectorized, so the prediacte should not
 // have any dependency with the loop index, which enables the code
 // moition as the above.
+//
+// When the innermost loop is instead a reduction loop mapped with a
+// vectorized domain, the loop only accumulates sums and the result is
+// combined with the running welford result once after the loop. See
+// Note [ Merging vectorized welford reductions ].
 std::vector<Expr*> vectorizeWelford(const std::vector<Expr*>& exprs);
 
 } // namespace nvfuser
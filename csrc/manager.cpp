@@ -153,13 +153,15 @@ class CudaFusionManager {
     }
   }
 
-  std::vector<at::Tensor> runFusionNode(
-      int32_t kernel_id,
-      const at::ArrayRef<c10::IValue> inputs) {
+  // Returns the GraphCache of the given kernel. The GraphCache is owned by
+  // the manager and stays valid until unregisterCacheId, so it can be run
+  // without holding `mutex_`, which would serialize all the fusion groups.
+  GraphCache* getGraphCache(int32_t kernel_id) {
     std::lock_guard<std::mutex> guard(mutex_);
+    auto it = graph_cache_.find(kernel_id);
     TORCH_INTERNAL_ASSERT(
-        graph_cache_.count(kernel_id) > 0, "graph cache miss at run time");
-    return graph_cache_[kernel_id]->runGraphWithInputs(inputs);
+        it != graph_cache_.end(), "graph cache miss at run time");
+    return it->second.get();
   }
 
   bool hasFallbackCode(int32_t kernel_id) {
@@ -321,8 +323,9 @@ void runCudaFusionGroup(
 
     at::ArrayRef<c10::IValue> inputs = torch::jit::last(stack, nInputs);
 
-    auto outputs =
-        CudaFusionManager::getManager().runFusionNode(kernel_id, inputs);
+    auto outputs = CudaFusionManager::getManager()
+                       .getGraphCache(kernel_id)
+                       ->runGraphWithInputs(inputs);
 
     torch::jit::drop(stack, inputs.size());
     stack.insert(
@@ -8,6 +8,8 @@
 #include <maxinfo_propagator.h>
 #include <root_domain_map.h>
 
+#include <set>
+
 namespace nvfuser {
 
 bool MaxInfoSpanningTree::Information::operator>(const Information& r) const {
@@ -33,17 +35,27 @@ void MaxInfoSpanningTree::compute_spanning_tree() {
   // taking (because the answer is always not worth)
   std::unordered_set<TensorView*> replayed;
 
-  // A sorted list of possible next steps. The list is sorted in the order of
+  // A sorted set of possible next steps. The set is sorted in the order of
   // ascending amount of preserved information about the reference tensor. The
-  // back of the list preserves the most amount of information about the
+  // back of the set preserves the most amount of information about the
   // reference tensor, and should always be the next step to take. We use
-  // std::list instead of std::priority_queue because C++'s
+  // std::multiset instead of std::priority_queue because C++'s
   // std::priority_queue does not support increase-key, and might not be
-  // deterministic either.
-  std::list<NextHopWithInfo> candidates(1);
-  candidates.back().next_hop.from = nullptr;
-  candidates.back().next_hop.to = reference_;
-  candidates.back().info_to = reference_info_;
+  // deterministic either. std::multiset inserts an element after all the
+  // elements equivalent to it, so ties are broken by insertion order.
+  using CandidateSet = std::multiset<NextHopWithInfo>;
+  CandidateSet candidates;
+
+  // The candidate of each destination tensor in `candidates`. There is at most
+  // one candidate per destination, and looking it up here avoids scanning all
+  // the candidates, which is quadratic for wide fusions.
+  std::unordered_map<TensorView*, CandidateSet::iterator> candidate_of;
+
+  NextHopWithInfo start;
+  start.next_hop.from = nullptr;
+  start.next_hop.to = reference_;
+  start.info_to = reference_info_;
+  candidate_of[reference_] = candidates.insert(start);
 
   // Insert the given next hop the correct position in `candidates`. If there
   // is an existing next hop that preserves more information, then we will just
@@ -55,18 +67,14 @@ void MaxInfoSpanningTree::compute_spanning_tree() {
       return;
     }
     // Find if there is already a path to the dest tensor
-    auto existing = std::find_if(
-        candidates.begin(), candidates.end(), [&](const NextHopWithInfo& i) {
-          return i.next_hop.to == info.next_hop.to;
-        });
+    auto existing = candidate_of.find(info.next_hop.to);
     // Only insert if there is no existing path to the dest tensor, or the new
     // path preserves more information about the starting tensor.
-    if (existing == candidates.end() || *existing < info) {
-      if (existing != candidates.end()) {
-        candidates.erase(existing);
-      }
-      auto pos = std::upper_bound(candidates.begin(), candidates.end(), info);
-      candidates.insert(pos, info);
+    if (existing == candidate_of.end()) {
+      candidate_of.emplace(info.next_hop.to, candidates.insert(info));
+    } else if (*existing->second < info) {
+      candidates.erase(existing->second);
+      existing->second = candidates.insert(info);
     }
   };
 
@@ -92,9 +100,11 @@ void MaxInfoSpanningTree::compute_spanning_tree() {
   };
 
   while (!candidates.empty()) {
-    const auto next_hop_info = candidates.back();
+    auto last = std::prev(candidates.end());
+    const auto next_hop_info = *last;
     const auto& next_hop = next_hop_info.next_hop;
-    candidates.pop_back();
+    candidates.erase(last);
+    candidate_of.erase(next_hop.to);
 
     if (next_hop.from != nullptr) {
       // nullptr used to start from reference
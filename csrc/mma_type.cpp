@@ -137,6 +137,7 @@ int getOutputRegisterSize(MmaOptions::MacroType macro) {
       break;
     case MmaOptions::MacroType::Turing_16_8_16:
     case MmaOptions::MacroType::Ampere_16_8_16:
+    case MmaOptions::MacroType::Ampere_16_8_8:
       return 4;
       break;
     default:
@@ -149,6 +150,7 @@ int getOutputRegisterSize(MmaOptions::MacroType macro) {
 int getInputARegisterSize(MmaOptions::MacroType macro) {
   switch (macro) {
     case MmaOptions::MacroType::Volta_16_16_4:
+    case MmaOptions::MacroType::Ampere_16_8_8:
       return 4;
       break;
     case MmaOptions::MacroType::Turing_16_8_16:
@@ -172,6 +174,8 @@ int getInputBRegisterSize(MmaOptions::MacroType macro) {
     case MmaOptions::MacroType::Turing_16_8_16:
     case MmaOptions::MacroType::Ampere_16_8_16:
       return 4;
+    case MmaOptions::MacroType::Ampere_16_8_8:
+      return 2;
     case MmaOptions::MacroType::Turing_16_16_16:
     case MmaOptions::MacroType::Ampere_16_16_16:
       return 8;
@@ -231,6 +235,9 @@ std::string toString(MmaOptions::MacroType mt) {
     case MmaOptions::MacroType::Ampere_16_16_16:
       ss << "M16N16K16";
       break;
+    case MmaOptions::MacroType::Ampere_16_8_8:
+      ss << "M16N8K8";
+      break;
     default:
       TORCH_INTERNAL_ASSERT(false, "undefined mma type");
       break;
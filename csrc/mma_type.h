@@ -16,7 +16,7 @@ struct GemmTile {
   int m, n, k;
   GemmTile(int m_, int n_, int k_) : m(m_), n(n_), k(k_) {}
 
-  bool operator==(const GemmTile& other) {
+  bool operator==(const GemmTile& other) const {
     return m == other.m && n == other.n && k == other.k;
   }
 
@@ -44,7 +44,7 @@ struct TORCH_CUDA_CU_API MatMulTileOptions {
         warp_tile(warp_tile_),
         instruction_tile(instruction_tile_) {}
 
-  bool operator==(const MatMulTileOptions& other) {
+  bool operator==(const MatMulTileOptions& other) const {
     return cta_tile == other.cta_tile && warp_tile == other.warp_tile &&
         instruction_tile == other.instruction_tile;
   }
@@ -69,7 +69,7 @@ struct MmaOptions {
     Ampere_16_16_16,
     Turing_16_8_16,
     Turing_16_16_16,
-    Ampere_16_8_8 // place holder for tf32
+    Ampere_16_8_8 // tf32, no operand swizzles yet, so not schedulable
   };
 
   //! [Operand Layout Convention]
@@ -102,7 +102,18 @@ void AggregateDag::buildSendRecv() {
       std::inserter(internal_Vals, internal_Vals.end()),
       [](Val* val) { return val->as<AggregateVal>()->getOriginalVal(); });
 
+  // Vals that are communicated by a collective instead
+  std::unordered_set<Val*> collective_Vals;
+  for (const auto& collective : MCFusion_->collectives()) {
+    collective_Vals.insert(
+        collective.inputs.begin(), collective.inputs.end());
+    collective_Vals.insert(collective.output);
+  }
+
   for (auto val : internal_Vals) {
+    if (collective_Vals.count(val)) {
+      continue;
+    }
     auto srcs = FilterAggregateVals(
         internal_aVals,
         [](auto val) { return val->isOriginalValOutputOfCluster(); },
@@ -125,11 +136,48 @@ void AggregateDag::buildSendRecv() {
   }
 }
 
+void AggregateDag::buildCollectives() {
+  for (const auto& collective : MCFusion_->collectives()) {
+    std::vector<AggregateVal*> ins;
+    for (auto input : collective.inputs) {
+      auto srcs = FilterAggregateVals(
+          vals_,
+          [](auto val) { return val->isOriginalValOutputOfCluster(); },
+          input,
+          MCFusion_->clusterOfOutput(input));
+      TORCH_INTERNAL_ASSERT(std::size(srcs) == 1);
+      ins.push_back((*srcs.begin())->as<AggregateVal>());
+    }
+
+    // Ordered by cluster so that all the processes build the same Collective
+    std::vector<AggregateVal*> outs;
+    for (auto cluster : MCFusion_->clusters()) {
+      auto dsts = FilterAggregateVals(
+          vals_,
+          [](auto val) { return val->isOriginalValInputOfCluster(); },
+          collective.output,
+          cluster);
+      for (auto dst : dsts) {
+        outs.push_back(dst->as<AggregateVal>());
+      }
+    }
+    TORCH_CHECK(
+        !outs.empty(),
+        "The result of a ",
+        collective.type,
+        " must be consumed by a cluster");
+
+    IrBuilder::create<Collective>(
+        this->as<IrContainer>(), collective.type, outs, ins);
+  }
+}
+
 AggregateDag::AggregateDag(const MultiClusterFusion* MCFusion)
     : Fusion(), MCFusion_(MCFusion) {
   buildAVals();
   buildAExpr();
   buildSendRecv();
+  buildCollectives();
 }
 
 // Printer for AggregateDag
@@ -182,21 +230,28 @@ AggregateExpr::AggregateExpr(IrBuilderPasskey passkey, ClusterPtr cluster)
       passkey.ir_container_->isA<AggregateDag>(),
       "IR type only valid for AggregateDag container.");
 
-  auto output_set = FilterAggregateVals(
-      passkey.ir_container_->vals(),
-      [](auto val) { return val->isOriginalValOutputOfCluster(); },
-      nullptr,
-      cluster);
-  auto input_set = FilterAggregateVals(
-      passkey.ir_container_->vals(),
-      [](auto val) { return val->isOriginalValInputOfCluster(); },
-      nullptr,
-      cluster);
-  for (auto v : output_set) {
-    addOutput(v);
+  // Add the AggregateVals in the order of the cluster's outputs and inputs,
+  // so that all the processes traverse the AggregateDag in the same order,
+  // which the collectives rely on
+  for (auto output_val : cluster->outputs().vector()) {
+    auto output_set = FilterAggregateVals(
+        passkey.ir_container_->vals(),
+        [](auto val) { return val->isOriginalValOutputOfCluster(); },
+        output_val,
+        cluster);
+    for (auto v : output_set) {
+      addOutput(v);
+    }
   }
-  for (auto v : input_set) {
-    addInput(v);
+  for (auto input_val : cluster->inputs().vector()) {
+    auto input_set = FilterAggregateVals(
+        passkey.ir_container_->vals(),
+        [](auto val) { return val->isOriginalValInputOfCluster(); },
+        input_val,
+        cluster);
+    for (auto v : input_set) {
+      addInput(v);
+    }
   }
 }
 
@@ -258,6 +313,47 @@ std::string SendRecv::toInlineString(int indent_size) const {
   return toString(indent_size);
 }
 
+Collective::Collective(
+    IrBuilderPasskey passkey,
+    CollectiveType type,
+    std::vector<AggregateVal*> outs,
+    std::vector<AggregateVal*> ins)
+    : Expr(passkey), type_(type) {
+  TORCH_INTERNAL_ASSERT(
+      passkey.ir_container_->isA<AggregateDag>(),
+      "IR type only valid for AggregateDag container.");
+  TORCH_INTERNAL_ASSERT(!outs.empty() && !ins.empty());
+  for (auto out : outs) {
+    addOutput(out);
+  }
+  for (auto in : ins) {
+    addInput(in);
+  }
+}
+
+NVFUSER_DEFINE_CLONE_AND_CREATE(Collective)
+
+std::string Collective::toString(int indent_size) const {
+  std::stringstream ss;
+  ss << type() << " of Vals {";
+  for (auto input : inputs()) {
+    ss << input->as<AggregateVal>()->getOriginalVal()->toString(indent_size)
+       << " from cluster " << input->as<AggregateVal>()->getCluster()->unique_id
+       << ", ";
+  }
+  ss << "} into Val {" << getOriginalOutputVal()->toString(indent_size)
+     << "} to clusters {";
+  for (auto output : outputs()) {
+    ss << output->as<AggregateVal>()->getCluster()->unique_id << ", ";
+  }
+  ss << "}";
+  return ss.str();
+}
+
+std::string Collective::toInlineString(int indent_size) const {
+  return toString(indent_size);
+}
+
 AggregateVal::AggregateVal(
     IrBuilderPasskey passkey,
     Val* val,
@@ -9,6 +9,7 @@
 #include <fusion.h>
 #include <ir_base_nodes.h>
 #include <ir_container.h>
+#include <multidevice/multicluster_fusion.h>
 
 namespace nvfuser {
 
@@ -22,8 +23,9 @@ using ClusterPtr = std::shared_ptr<Cluster>;
 // Its traversal is what defines the runtime execution.
 // The nodes of the dag are the Vals AggregateVal
 // The edges are Expr of either type 1) AggregateExpr which represent the
-// operations contained in a Cluster, or 2)SendRecv which represents the
-// collective operation between two processes that needs to be done at runtime.
+// operations contained in a Cluster, 2)SendRecv which represents the
+// collective operation between two processes that needs to be done at runtime,
+// or 3) Collective which represents a collective between all the processes.
 
 // AggregateDag is an IrContainer, built from a multicluster fusion.
 // Its traversal is what orders the runtime execution.
@@ -54,8 +56,12 @@ class TORCH_CUDA_CU_API AggregateDag : public Fusion {
 
   // Build the SendRecv IR of the AggregateDag
   // A SendRecv is created for each pair of AggregateVals which Vals match
-  // and which are not inputs/outputs of the AggregateDag
+  // and which are not inputs/outputs of the AggregateDag nor of a collective
   void buildSendRecv();
+
+  // Build the Collective IR of the AggregateDag
+  // A Collective is created for each collective of the MultiClusterFusion
+  void buildCollectives();
 };
 
 // An AggregateVal is basically a Val and a Cluster. At runtime, since a Cluster
@@ -150,4 +156,39 @@ class TORCH_CUDA_CU_API SendRecv : public Expr {
   AggregateVal* const in_ = nullptr;
 };
 
+// Collective is an Expr that represents at runtime a collective
+// communication between all the processes. Its inputs are the contributions
+// of the clusters, and its outputs all represent the result, one for each
+// cluster consuming it.
+class TORCH_CUDA_CU_API Collective : public Expr {
+ public:
+  using Expr::Expr;
+  Collective(
+      IrBuilderPasskey,
+      CollectiveType type,
+      std::vector<AggregateVal*> outs,
+      std::vector<AggregateVal*> ins);
+
+  NVFUSER_DECLARE_CLONE_AND_CREATE
+
+  virtual std::string toString(int indent_size = 0) const override;
+  virtual std::string toInlineString(int indent_size = 0) const override;
+
+  const char* getOpString() const override {
+    return "Collective";
+  }
+
+  CollectiveType type() const {
+    return type_;
+  }
+
+  // returns the Val holding the result of the collective
+  Val* getOriginalOutputVal() const {
+    return output(0)->as<AggregateVal>()->getOriginalVal();
+  }
+
+ private:
+  CollectiveType type_ = CollectiveType::AllReduce;
+};
+
 } // namespace nvfuser
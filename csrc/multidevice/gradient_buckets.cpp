@@ -0,0 +1,161 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#ifdef USE_DISTRIBUTED
+#include <executor.h>
+#include <multidevice/gradient_buckets.h>
+#include <utils.h>
+
+#include <ATen/ATen.h>
+
+namespace nvfuser {
+
+at::Tensor GradientBuckets::slotView(
+    size_t index,
+    const at::Tensor& meta_tensor,
+    c10::Device device) {
+  const auto sizes = meta_tensor.sizes().vec();
+  const auto dtype = meta_tensor.scalar_type();
+  const auto numel = meta_tensor.numel();
+
+  if (index < slots_.size() &&
+      (slots_[index].sizes != sizes || slots_[index].dtype != dtype)) {
+    // The gradients changed, assign this one and the following ones again
+    slots_.resize(index);
+    buckets_.resize(slots_.empty() ? 0 : slots_.back().bucket + 1);
+    if (!buckets_.empty()) {
+      auto& bucket = buckets_.back();
+      const auto& last_slot = slots_.back();
+      bucket.size = last_slot.offset + last_slot.numel;
+      bucket.num_slots = std::count_if(
+          slots_.begin(), slots_.end(), [&](const Slot& slot) {
+            return slot.bucket == last_slot.bucket;
+          });
+    }
+  }
+
+  if (index == slots_.size()) {
+    // A bucket whose all-reduce is in flight can't take more gradients
+    bool fits = !buckets_.empty() && buckets_.back().work == nullptr &&
+        buckets_.back().tensor.scalar_type() == dtype &&
+        buckets_.back().size + numel <= buckets_.back().tensor.numel();
+    if (!fits) {
+      Bucket bucket;
+      const auto capacity = std::max<int64_t>(
+          bucket_bytes_ / (int64_t)c10::elementSize(dtype), numel);
+      bucket.tensor =
+          at::empty({capacity}, meta_tensor.options().device(device));
+      buckets_.push_back(std::move(bucket));
+    }
+    auto& bucket = buckets_.back();
+    slots_.push_back({sizes, dtype, buckets_.size() - 1, bucket.size, numel});
+    bucket.size += numel;
+    bucket.num_slots++;
+  }
+
+  const auto& slot = slots_.at(index);
+  return buckets_.at(slot.bucket)
+      .tensor.narrow(0, slot.offset, slot.numel)
+      .view(slot.sizes);
+}
+
+void GradientBuckets::launch(Bucket& bucket) {
+  std::vector<at::Tensor> tensors = {bucket.tensor.narrow(0, 0, bucket.size)};
+  bucket.work = process_group_->allreduce(tensors);
+}
+
+std::vector<at::Tensor> GradientBuckets::run(
+    FusionExecutorCache* fec,
+    const at::ArrayRef<c10::IValue>& inputs,
+    const std::vector<size_t>& gradient_indices) {
+  TORCH_INTERNAL_ASSERT(fec != nullptr);
+  const int device_index = getCommonDeviceCUDA(inputs);
+  TORCH_CHECK(device_index >= 0, "All inputs must be on the same device");
+  const auto device = c10::Device(c10::DeviceType::CUDA, device_index);
+  auto args = KernelArgumentHolder::createKernelArgumentHolder(inputs);
+  args.setDeviceIndex(device_index);
+  auto output_sizes = inferOutputSizes(fec->fusion(), args);
+
+  std::vector<bool> is_gradient(output_sizes.size(), false);
+  for (auto index : gradient_indices) {
+    TORCH_CHECK(
+        index < output_sizes.size(),
+        "Gradient index ",
+        index,
+        " is out of range, the fusion has ",
+        output_sizes.size(),
+        " outputs");
+    is_gradient.at(index) = true;
+  }
+
+  // The gradients are written into their buckets, the other outputs into
+  // tensors allocated like the kernel would
+  std::vector<at::Tensor> outputs;
+  std::vector<size_t> produced;
+  for (auto output_idx : c10::irange(output_sizes.size())) {
+    auto tensor_arg_abstract =
+        dynamic_cast<const TensorArgAbstract*>(output_sizes[output_idx]);
+    TORCH_INTERNAL_ASSERT(
+        tensor_arg_abstract != nullptr, "Fusion outputs must be tensors");
+    auto meta_tensor = tensor_arg_abstract->getTensor();
+    if (!is_gradient[output_idx]) {
+      outputs.push_back(at::empty_strided(
+          meta_tensor.sizes(),
+          meta_tensor.strides(),
+          meta_tensor.options().device(device)));
+      continue;
+    }
+    TORCH_CHECK(
+        meta_tensor.is_contiguous(),
+        "Gradient ",
+        output_idx,
+        " is not contiguous and can't be written into a bucket");
+    produced.push_back(num_produced_);
+    outputs.push_back(slotView(num_produced_++, meta_tensor, device));
+  }
+
+  auto results = fec->runFusionWithInputs(inputs, outputs);
+
+  // The backend orders the all-reduces after the kernel on the current
+  // stream, so a bucket is launched as soon as its last gradient is
+  // produced. Only buckets followed by another one are known to be
+  // complete.
+  for (auto index : produced) {
+    buckets_.at(slots_.at(index).bucket).num_produced++;
+  }
+  for (auto bucket_idx : c10::irange(buckets_.size())) {
+    auto& bucket = buckets_[bucket_idx];
+    if (bucket.work == nullptr && bucket.num_produced == bucket.num_slots &&
+        bucket_idx + 1 < buckets_.size()) {
+      launch(bucket);
+    }
+  }
+  return results;
+}
+
+void GradientBuckets::synchronize() {
+  for (auto& bucket : buckets_) {
+    if (bucket.work == nullptr && bucket.num_produced > 0) {
+      launch(bucket);
+    }
+  }
+  for (auto& bucket : buckets_) {
+    if (bucket.work != nullptr) {
+      bucket.work->wait();
+      bucket.work.reset();
+      if (average_) {
+        bucket.tensor.narrow(0, 0, bucket.size).div_(process_group_->getSize());
+      }
+    }
+    bucket.num_produced = 0;
+  }
+  num_produced_ = 0;
+}
+
+} // namespace nvfuser
+
+#endif
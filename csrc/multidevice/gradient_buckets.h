@@ -0,0 +1,116 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#ifdef USE_DISTRIBUTED
+#pragma once
+
+#include <kernel_cache.h>
+
+#include <torch/csrc/distributed/c10d/Backend.hpp>
+
+namespace nvfuser {
+
+// Note [ Gradient buckets ]
+//
+// Data-parallel training all-reduces the gradients of every step over the
+// ranks. All-reducing each gradient on its own pays the latency of a
+// collective per tensor, so the gradients are usually copied into larger
+// buckets first, and the bucket is all-reduced once the backward pass has
+// produced all of its gradients.
+//
+// GradientBuckets saves the copies by passing views of the buckets as the
+// preallocated outputs of the kernels producing the gradients, and hides the
+// communication by launching the all-reduce of a bucket as soon as the
+// fusion filling its last gradient has run, while the following fusions of
+// the backward pass compute the next buckets.
+//
+// Gradients are assigned to buckets in the order the fusions produce them.
+// A bucket holds gradients of a single dtype, and is closed when the next
+// gradient doesn't fit in it or has another dtype. The assignment is kept
+// across steps as long as the gradients keep their shapes, so the buckets
+// are allocated once. The gradients of a step are views of the buckets and
+// are overwritten by the next step.
+//
+// Only fusions run by FusionExecutorCache without segmentation can write
+// into the buckets, see FusionExecutorCache::runFusionWithInputs.
+class TORCH_CUDA_CU_API GradientBuckets {
+ public:
+  // `bucket_bytes` is the size a bucket is closed at, unless it holds a
+  // single larger gradient. `average` divides the sums by the number of
+  // ranks, like DistributedDataParallel does.
+  GradientBuckets(
+      c10::intrusive_ptr<c10d::Backend> process_group,
+      int64_t bucket_bytes = 25 * 1024 * 1024,
+      bool average = true)
+      : process_group_(std::move(process_group)),
+        bucket_bytes_(bucket_bytes),
+        average_(average) {}
+
+  // Runs the fusion of `fec`, writing its outputs at `gradient_indices`
+  // into the buckets, and launches the all-reduce of the buckets it
+  // completes. Returns the outputs; the gradients only hold the reduced
+  // values after synchronize().
+  std::vector<at::Tensor> run(
+      FusionExecutorCache* fec,
+      const at::ArrayRef<c10::IValue>& inputs,
+      const std::vector<size_t>& gradient_indices);
+
+  // Ends the step: launches the all-reduce of the last bucket and makes the
+  // current stream wait for all of them
+  void synchronize();
+
+  int64_t numBuckets() const {
+    return (int64_t)buckets_.size();
+  }
+
+ private:
+  struct Bucket {
+    // Flat storage of the gradients
+    at::Tensor tensor;
+    // Elements used by the gradients assigned to the bucket
+    int64_t size = 0;
+    // Gradients assigned to the bucket and produced in the current step
+    int64_t num_slots = 0;
+    int64_t num_produced = 0;
+    // All-reduce in flight, if launched in the current step
+    c10::intrusive_ptr<c10d::Work> work;
+  };
+
+  // Place of a gradient in the buckets
+  struct Slot {
+    std::vector<int64_t> sizes;
+    at::ScalarType dtype;
+    size_t bucket = 0;
+    int64_t offset = 0;
+    int64_t numel = 0;
+  };
+
+  // Returns the view of the bucket the gradient `index` of the step is
+  // written into, assigning it a slot first if it doesn't match the slot of
+  // the previous steps
+  at::Tensor slotView(
+      size_t index,
+      const at::Tensor& meta_tensor,
+      c10::Device device);
+
+  // Launches the all-reduce of the given bucket
+  void launch(Bucket& bucket);
+
+  c10::intrusive_ptr<c10d::Backend> process_group_;
+  const int64_t bucket_bytes_;
+  const bool average_;
+
+  std::vector<Slot> slots_;
+  std::vector<Bucket> buckets_;
+
+  // Gradients produced in the current step
+  size_t num_produced_ = 0;
+};
+
+} // namespace nvfuser
+
+#endif
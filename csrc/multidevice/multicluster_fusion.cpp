@@ -99,6 +99,93 @@ void MultiClusterFusion::addClusterOutput(TensorView* tv) {
   cluster->addOutput(tv);
 }
 
+std::ostream& operator<<(std::ostream& os, CollectiveType type) {
+  switch (type) {
+    case CollectiveType::AllReduce:
+      return os << "AllReduce";
+    case CollectiveType::ReduceScatter:
+      return os << "ReduceScatter";
+    case CollectiveType::AllGather:
+      return os << "AllGather";
+    case CollectiveType::Broadcast:
+      return os << "Broadcast";
+  }
+  TORCH_INTERNAL_ASSERT(false, "Unknown collective type");
+}
+
+ClusterPtr MultiClusterFusion::clusterOfOutput(Val* val) const {
+  for (const auto& cluster : clusters_) {
+    if (cluster->outputs().has(val)) {
+      return cluster;
+    }
+  }
+  return nullptr;
+}
+
+void MultiClusterFusion::remapRanks(
+    const std::vector<ProcessRankType>& placement) {
+  // The results of these collectives are laid out in the order of the ranks
+  for (const auto& collective : collectives_) {
+    TORCH_CHECK(
+        collective.type != CollectiveType::ReduceScatter &&
+            collective.type != CollectiveType::AllGather,
+        "Can't remap the ranks of a fusion with a ",
+        collective.type);
+  }
+  for (const auto& cluster : clusters_) {
+    auto& rank = cluster->params_.process_rank;
+    TORCH_CHECK(
+        rank < (ProcessRankType)placement.size(),
+        "No placement for rank ",
+        rank);
+    rank = placement.at(rank);
+  }
+}
+
+TensorView* MultiClusterFusion::addCollective(
+    CollectiveType type,
+    const std::vector<TensorView*>& inputs) {
+  TORCH_CHECK(!inputs.empty(), "A collective needs at least one input");
+  TORCH_CHECK(
+      type != CollectiveType::Broadcast || inputs.size() == 1,
+      "A broadcast has a single input, the output of its root cluster");
+  TORCH_INTERNAL_ASSERT(
+      FusionGuard::getCurFusion() == this,
+      "addCollective must be called within the FusionGuard of the fusion");
+
+  const auto ndims =
+      TensorDomain::noReductions(inputs.front()->getMaybeRFactorDomain())
+          .size();
+  const auto dtype = inputs.front()->getDataType().value();
+  std::unordered_set<ProcessRankType> ranks;
+  for (auto input : inputs) {
+    auto cluster = clusterOfOutput(input);
+    TORCH_CHECK(
+        cluster != nullptr,
+        input->toString(),
+        " is not a cluster output and can't be the input of a collective");
+    TORCH_CHECK(
+        ranks.insert(cluster->params().process_rank).second,
+        "Collective has several inputs on rank ",
+        cluster->params().process_rank);
+    TORCH_CHECK(
+        TensorDomain::noReductions(input->getMaybeRFactorDomain()).size() ==
+                ndims &&
+            input->getDataType().value() == dtype,
+        "The inputs of a collective must have the same rank and dtype");
+  }
+
+  // The result gets its own symbolic extents, which the clusters consuming
+  // it bind from the tensor the collective produces
+  auto output = TensorViewBuilder()
+                    .ndims(ndims)
+                    .dtype(dtype)
+                    .contiguity(true)
+                    .build();
+  collectives_.push_back({type, inputs, output});
+  return output;
+}
+
 std::unique_ptr<AggregateDag> MultiClusterFusion::aggregateDag() const {
   return std::make_unique<AggregateDag>(this);
 }
@@ -146,6 +233,13 @@ std::string MultiClusterFusion::toString(int indent_size) const {
     ss << cluster_ptr->toString(indent_size + 2);
     ss << "\n";
   }
+  for (const auto& collective : collectives_) {
+    ss << std::string(indent_size + 2, ' ') << collective.type << " {";
+    for (auto input : collective.inputs) {
+      ss << input->toString() << ", ";
+    }
+    ss << "} -> " << collective.output->toString() << "\n";
+  }
   ss << "} //MultiClusterFusion";
 
   return ss.str();
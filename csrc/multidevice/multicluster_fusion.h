@@ -18,6 +18,35 @@ using ExprSet = VectorOfUniqueEntries<Expr*>;
 class MultiClusterFusion;
 class AggregateDag;
 
+// Collective communications between the clusters of the ranks, see
+// MultiClusterFusion::addCollective
+enum class CollectiveType {
+  // every rank receives the sum of the inputs of all the ranks
+  AllReduce,
+  // every rank receives its slice along the outermost dimension of the sum
+  // of the inputs of all the ranks
+  ReduceScatter,
+  // every rank receives the inputs of all the ranks, concatenated along the
+  // outermost dimension in the order of the ranks
+  AllGather,
+  // every rank receives the input of the root rank
+  Broadcast
+};
+
+TORCH_CUDA_CU_API std::ostream& operator<<(
+    std::ostream& os,
+    CollectiveType type);
+
+// A collective registered in a MultiClusterFusion
+struct ClusterCollective {
+  CollectiveType type;
+  // Cluster outputs contributed to the collective, one per rank, or the
+  // output of the root cluster of a Broadcast
+  std::vector<TensorView*> inputs;
+  // Result of the collective, available to the clusters of every rank
+  TensorView* output = nullptr;
+};
+
 struct ClusterParams {
   // if the cluster should be auto-scheduled.
   bool auto_schedule{true};
@@ -106,6 +135,28 @@ class TORCH_CUDA_CU_API MultiClusterFusion : public Fusion {
   // Make the given tensor a cluster output
   void addClusterOutput(TensorView* tv);
 
+  // Adds a collective over all the ranks of the process group, which is
+  // lowered to a single call of the c10d backend instead of a SendRecv per
+  // pair of ranks. `inputs` are cluster outputs, one per rank, or the output
+  // of the root cluster for a Broadcast. Returns the result of the
+  // collective, which clusters created afterwards consume like any other
+  // tensor on the rank they run on.
+  TensorView* addCollective(
+      CollectiveType type,
+      const std::vector<TensorView*>& inputs);
+
+  // Returns the collectives registered with addCollective
+  const std::vector<ClusterCollective>& collectives() const {
+    return collectives_;
+  }
+
+  // Returns the cluster the given value is an output of, if any
+  ClusterPtr clusterOfOutput(Val* val) const;
+
+  // Moves the clusters pinned to each rank r to rank placement[r], e.g. as
+  // returned by placeClusters
+  void remapRanks(const std::vector<ProcessRankType>& placement);
+
   // overrides IrContainer
   // Called insided IrBuilder each time a new ir is created
   void registerStmt(IrBuilderPasskey, Statement* stmt) override;
@@ -141,6 +192,9 @@ class TORCH_CUDA_CU_API MultiClusterFusion : public Fusion {
   // Stores clusters of the fusion
   std::vector<ClusterPtr> clusters_;
 
+  // Stores the collectives between the clusters
+  std::vector<ClusterCollective> collectives_;
+
   // Keep track of the current cluster, which either has been manually set
   // through setCurrentCluster method or is the latest cluster created
   ClusterPtr current_cluster_;
@@ -12,52 +12,18 @@
 #include <multidevice/multicluster_fusion.h>
 #include <multidevice/multidevice_runtime.h>
 
-namespace nvfuser {
+#include <c10/cuda/CUDAGuard.h>
 
-// Update launch parameters if scheduler needs to set the launch params.
-void updateLaunchParamsFromScheduler(
-    SchedulerEntry* scheduler,
-    LaunchParams& lparams) {
-  // Set launch parameters form scheduler.
-  if (scheduler->params()->isA<ReductionParams>()) {
-    lparams = scheduler->reductionParams().lparams;
-  } else {
-    TORCH_INTERNAL_ASSERT(scheduler->params()->isA<PointwiseParams>());
-    lparams = scheduler->pointwiseParams().lparams;
-  }
-}
+#include <cstring>
+
+namespace nvfuser {
 
 MultiDeviceRuntime::CompiledKernelPtr MultiDeviceRuntime::compileCluster(
     ClusterPtr cluster,
     std::vector<c10::IValue> cluster_inputs) {
   // Make a copy of the fusion graph we want to generate
-  //  CUDA kernel and compile.
+  //  CUDA kernel and compile. The cluster is scheduled manually.
   auto fusion_from_cluster = cluster->toFusion();
-  // Placeholder for auto schedule parameters if any.
-  c10::optional<SchedulerEntry*> maybe_scheduler_entry = c10::nullopt;
-
-  // Auto schedule if requested
-  if (cluster->params().auto_schedule) {
-    // Get runtime info from fusion graph and concrete tensor inputs.
-    SchedulerRuntimeInfo runtime_info(
-        fusion_from_cluster.get(), cluster_inputs, true);
-
-    // Get heuristic tag that applies to the given fusion and input info.
-    auto heuristic = SchedulerEntry::proposeHeuristics(
-        fusion_from_cluster.get(), runtime_info);
-    TORCH_INTERNAL_ASSERT(heuristic.has_value(), "cannot auto schedule fusion");
-
-    // Generate scheduler parameters from tag.
-    auto scheduler = SchedulerEntry::makeEntry(
-        heuristic.value(), fusion_from_cluster.get(), runtime_info);
-
-    // Apply schedule to fusion graph.
-    scheduler->schedule(fusion_from_cluster.get());
-
-    maybe_scheduler_entry = scheduler.get();
-    // Cache scheduler in registry to retrieve launch parameters.
-    auto_scheduler_registry_[cluster] = std::move(scheduler);
-  }
 
   auto executor_ptr = std::make_unique<FusionExecutor>();
 
@@ -66,31 +32,111 @@ MultiDeviceRuntime::CompiledKernelPtr MultiDeviceRuntime::compileCluster(
   const int device_index = getCommonDeviceCUDA(cluster_inputs);
   TORCH_CHECK(device_index >= 0, "All inputs must be on the same device");
 
-  // Set launch parameters
-  LaunchParams launch_params;
-
   // Set compile options
   CompileOptions options;
   options.device = c10::Device(c10::DeviceType::CUDA, device_index);
 
   auto args = KernelArgumentHolder::createKernelArgumentHolder(cluster_inputs);
-  // Set parameters inferred by auto scheduler.
-  if (maybe_scheduler_entry.has_value()) {
-    auto scheduler_entry = maybe_scheduler_entry.value();
-    // TODO: I don't remember what happened with index mode. Need to follow up.
-    // args.setIndexMode(scheduler_entry->indexMode());
-    // Set launch parameters with auto scheduler.
-    updateLaunchParamsFromScheduler(scheduler_entry, launch_params);
-  }
-
   args.setDeviceIndex(device_index);
   // Lower the fusion and compile the generated kernel.
   executor_ptr->compileFusion(
-      fusion_from_cluster.get(), args, launch_params, {});
+      fusion_from_cluster.get(), args, LaunchParams(), {});
 
   return executor_ptr;
 }
 
+FusionExecutorCache* MultiDeviceRuntime::executorCacheOf(ClusterPtr cluster) {
+  auto& executor_cache = executor_caches_[cluster];
+  if (executor_cache == nullptr) {
+    executor_cache = std::make_unique<FusionExecutorCache>(cluster->toFusion());
+  }
+  return executor_cache.get();
+}
+
+std::vector<at::Tensor> MultiDeviceRuntime::runCluster(
+    ClusterPtr cluster,
+    const std::vector<c10::IValue>& cluster_input,
+    const std::vector<at::Tensor>& outputs) {
+  if (cluster->params().auto_schedule) {
+    return executorCacheOf(cluster)->runFusionWithInputs(
+        cluster_input, outputs);
+  }
+  auto& executor = compiled_kernels_[cluster];
+  if (executor == nullptr) {
+    executor = compileCluster(cluster, cluster_input);
+  }
+  return executor->runFusion(cluster_input, outputs);
+}
+
+std::vector<at::Tensor> MultiDeviceRuntime::allocClusterOutputs(
+    ClusterPtr cluster,
+    const std::vector<c10::IValue>& cluster_input) {
+  const int device_index = getCommonDeviceCUDA(cluster_input);
+  TORCH_CHECK(device_index >= 0, "All inputs must be on the same device");
+  auto args = KernelArgumentHolder::createKernelArgumentHolder(cluster_input);
+  args.setDeviceIndex(device_index);
+
+  // Auto-scheduled clusters are not compiled by the processes that don't
+  // run them, the sizes of the outputs are inferred from the fusion instead
+  auto output_sizes = [&]() {
+    if (cluster->params().auto_schedule) {
+      return inferOutputSizes(executorCacheOf(cluster)->fusion(), args);
+    }
+    auto& executor = compiled_kernels_[cluster];
+    if (executor == nullptr) {
+      executor = compileCluster(cluster, cluster_input);
+    }
+    return executor->inferOutputSizes(args, LaunchParams());
+  }();
+
+  // See Note [ Receive buffers ]
+  auto& buffers = recv_buffers_[cluster];
+  buffers.resize(output_sizes.size());
+  std::vector<at::Tensor> outputs;
+  for (auto output_idx : c10::irange(output_sizes.size())) {
+    auto tensor_arg_abstract =
+        dynamic_cast<const TensorArgAbstract*>(output_sizes[output_idx]);
+    TORCH_INTERNAL_ASSERT(
+        tensor_arg_abstract != nullptr, "Cluster outputs must be tensors");
+    auto meta_tensor = tensor_arg_abstract->getTensor();
+    auto& buffer = buffers[output_idx];
+    if (!buffer.defined() || buffer.sizes() != meta_tensor.sizes() ||
+        buffer.strides() != meta_tensor.strides() ||
+        buffer.scalar_type() != meta_tensor.scalar_type()) {
+      buffer = at::empty_strided(
+          meta_tensor.sizes(),
+          meta_tensor.strides(),
+          meta_tensor.options().device(
+              c10::Device(c10::DeviceType::CUDA, device_index)));
+    }
+    // Outputs of the fusion are returned to the user, the next run must not
+    // overwrite them
+    if (cluster->outputs().vector().at(output_idx)->isFusionOutput()) {
+      outputs.push_back(at::empty_like(buffer));
+      buffer = at::Tensor();
+    } else {
+      outputs.push_back(buffer);
+    }
+  }
+  return outputs;
+}
+
+// Note [ Receive buffers ]
+//
+// A process receives the values of SendRecvs into the placeholders of the
+// outputs of the clusters it doesn't run. The placeholders are kept across
+// runs and only allocated again when the shape of the output changes, so
+// that steady-state iterations neither allocate nor hand new addresses to
+// the backend, which NCCL would otherwise have to register again.
+//
+// Reusing a buffer is safe since the backend orders a receive after the
+// work already issued on the current stream, including the consumers of the
+// previous run. Values that are outputs of the fusion escape to the user and
+// get a fresh tensor instead.
+//
+// The c10d backend doesn't expose the registration of user buffers with
+// NCCL, so keeping the addresses stable is all the runtime does.
+
 void MultiDeviceRuntime::handle(SendRecv* sr) {
   auto sender_cluster = sr->in()->getCluster();
   auto receiver_cluster = sr->out()->getCluster();
@@ -103,12 +149,56 @@ void MultiDeviceRuntime::handle(SendRecv* sr) {
   int sender_rank = sender_cluster->params().process_rank;
   int receiver_rank = receiver_cluster->params().process_rank;
 
+  // Clusters of the same rank share the tensor, which stays on the device
+  if (sender_rank == receiver_rank) {
+    return;
+  }
+
   // Val corresponding to the sent tensor
   auto val = sr->in()->getOriginalVal();
 
+  // The sending kernel wrote the value into the buffer of the receiver, and
+  // only signals that it is complete
+  auto peer_it = peer_buffers_.find(sr);
+  if (peer_it != peer_buffers_.end() && peer_it->second.tensor.defined()) {
+    auto options = at::TensorOptions().dtype(at::kByte).device(
+        val_to_IValue.at(val).toTensor().device());
+    std::vector<at::Tensor> token = {at::empty({1}, options)};
+    if (is_sender) {
+      auto work = process_cluster_->send(token, receiver_rank, 0);
+      if (async_communication_) {
+        pending_sends_.push_back(work);
+      }
+    }
+    if (is_receiver) {
+      auto work = process_cluster_->recv(token, sender_rank, 0);
+      if (async_communication_) {
+        pending_recvs_[val].push_back(work);
+      } else {
+        work->wait();
+      }
+    }
+    peer_it->second.written = true;
+    return;
+  }
+
   // container for the sent/received tensor
   std::vector<at::Tensor> tensor = {val_to_IValue.at(val).toTensor()};
 
+  if (async_communication_) {
+    if (is_sender) {
+      pending_sends_.push_back(
+          process_cluster_->send(tensor, receiver_rank, 0));
+    }
+    if (is_receiver) {
+      // the tensor is received into the placeholder of the value, which is
+      // only read after waiting for the receive
+      pending_recvs_[val].push_back(
+          process_cluster_->recv(tensor, sender_rank, 0));
+    }
+    return;
+  }
+
   if (is_sender) {
     // sending the tensor
     process_cluster_->send(tensor, receiver_rank, 0);
@@ -124,9 +214,109 @@ void MultiDeviceRuntime::handle(SendRecv* sr) {
   }
 }
 
+void MultiDeviceRuntime::handle(Collective* collective) {
+  const auto rank = process_cluster_->getRank();
+  const auto world_size = process_cluster_->getSize();
+  const auto num_inputs = (int)collective->inputs().size();
+  TORCH_CHECK(
+      collective->type() == CollectiveType::Broadcast ||
+          num_inputs == world_size,
+      collective->type(),
+      " needs an input on each of the ",
+      world_size,
+      " ranks but has ",
+      num_inputs);
+
+  // The contribution of this process, and the root of a broadcast
+  Val* input_val = nullptr;
+  int root_rank = -1;
+  for (auto input : collective->inputs()) {
+    auto a_val = input->as<AggregateVal>();
+    if (shouldRun(a_val->getCluster())) {
+      input_val = a_val->getOriginalVal();
+    }
+    root_rank = a_val->getCluster()->params().process_rank;
+  }
+  // Every process allocates the outputs of the clusters it doesn't run, so
+  // the contributions of the other processes also give the shape
+  if (input_val == nullptr) {
+    input_val = collective->input(0)->as<AggregateVal>()->getOriginalVal();
+  }
+  auto input = val_to_IValue.at(input_val).toTensor();
+
+  std::vector<at::Tensor> tensors;
+  c10::intrusive_ptr<c10d::Work> work;
+  switch (collective->type()) {
+    case CollectiveType::AllReduce: {
+      tensors = {input.clone(at::MemoryFormat::Contiguous)};
+      work = process_cluster_->allreduce(tensors);
+      break;
+    }
+    case CollectiveType::ReduceScatter: {
+      TORCH_CHECK(
+          input.dim() > 0 && input.size(0) % world_size == 0,
+          "ReduceScatter needs an outermost dimension divisible by the ",
+          world_size,
+          " ranks");
+      auto sizes = input.sizes().vec();
+      sizes[0] /= world_size;
+      tensors = {at::empty(sizes, input.options())};
+      auto contiguous_input = input.contiguous();
+      work = process_cluster_->_reduce_scatter_base(
+          tensors[0], contiguous_input);
+      break;
+    }
+    case CollectiveType::AllGather: {
+      TORCH_CHECK(input.dim() > 0, "AllGather needs a tensor input");
+      auto sizes = input.sizes().vec();
+      sizes[0] *= world_size;
+      tensors = {at::empty(sizes, input.options())};
+      auto contiguous_input = input.contiguous();
+      work =
+          process_cluster_->_allgather_base(tensors[0], contiguous_input);
+      break;
+    }
+    case CollectiveType::Broadcast: {
+      // The root sends its input as is, the others receive into a new tensor
+      tensors = {rank == root_rank ? input : at::empty_like(input)};
+      c10d::BroadcastOptions options;
+      options.rootRank = root_rank;
+      work = process_cluster_->broadcast(tensors, options);
+      break;
+    }
+  }
+
+  auto output_val = collective->getOriginalOutputVal();
+  if (async_communication_) {
+    pending_recvs_[output_val].push_back(work);
+  } else {
+    work->wait();
+  }
+  val_to_IValue[output_val] = (c10::IValue)(tensors[0]);
+}
+
+void MultiDeviceRuntime::waitForRecvs(Val* val) {
+  auto pending_it = pending_recvs_.find(val);
+  if (pending_it == pending_recvs_.end()) {
+    return;
+  }
+  for (auto& work : pending_it->second) {
+    work->wait();
+  }
+  pending_recvs_.erase(pending_it);
+}
+
 void MultiDeviceRuntime::handle(AggregateExpr* aExpr) {
   auto cluster = aExpr->getCluster();
 
+  // Only wait for the received inputs of the clusters run by this process,
+  // the others only need their shapes to allocate outputs
+  if (shouldRun(cluster)) {
+    for (auto input_val : cluster->inputs()) {
+      waitForRecvs(input_val);
+    }
+  }
+
   // get the c10::IValues corresponding to the cluster's input
   std::vector<c10::IValue> cluster_input;
   std::transform(
@@ -135,29 +325,21 @@ void MultiDeviceRuntime::handle(AggregateExpr* aExpr) {
       std::back_inserter(cluster_input),
       [this](auto input_val) { return val_to_IValue[input_val]; });
 
-  // Run the lowering and compilation step if we haven't compiled yet.
-  if (!compiled_kernels_.count(cluster)) {
-    compiled_kernels_[cluster] = compileCluster(cluster, cluster_input);
+  std::vector<at::Tensor> peer_outputs;
+  if (peer_outputs_) {
+    peer_outputs = preparePeerOutputs(aExpr, cluster_input);
   }
-  auto& executor = compiled_kernels_[cluster];
 
   // Launch kernel and record the kernel output into current context
   std::vector<at::Tensor> outputs;
   if (shouldRun(cluster)) {
-    // Use default launch parameters.
-    LaunchParams launch_params;
-    // If the kernel was auto-scheduled, we need to
-    //  pull the launch parameters from the scheduler.
-    auto scheduler_it = auto_scheduler_registry_.find(cluster);
-    if (scheduler_it != auto_scheduler_registry_.end()) {
-      updateLaunchParamsFromScheduler(
-          scheduler_it->second.get(), launch_params);
-    }
-    outputs = executor->runFusion(cluster_input, launch_params, {});
+    outputs = runCluster(cluster, cluster_input, peer_outputs);
+  } else if (!peer_outputs.empty()) {
+    outputs = peer_outputs;
   } else {
-    // Allocate space for kernel outputs.
-    // TODO: allocate only if necessary
-    outputs = executor->allocOutputSpace(cluster_input);
+    // Placeholders of the outputs, which receive the values sent to this
+    // process
+    outputs = allocClusterOutputs(cluster, cluster_input);
   }
 
   // Store the outputs or place holders in the context
@@ -169,6 +351,272 @@ void MultiDeviceRuntime::handle(AggregateExpr* aExpr) {
   }
 }
 
+// Note [ Asynchronous communication ]
+//
+// By default, a SendRecv blocks the receiving process until the tensor has
+// arrived, so that nothing overlaps with the communication. In asynchronous
+// mode, the sends and receives are only issued, and the c10d::Work of a
+// receive is waited on by the first AggregateExpr run by this process that
+// consumes the received value. The exprs are also reordered so that each
+// SendRecv is issued right after the AggregateExpr producing its input,
+// which lets the clusters that don't depend on it run in the meantime. Every
+// process computes the same order, so that the sends and receives between
+// two processes are still matched in order.
+//
+// Collectives are issued in place in the same order, and the result of a
+// Collective is waited on like a received value.
+//
+// The communication runs on the streams of the backend: with NCCL, the
+// collectives are launched on an internal stream per device and waiting on
+// a work makes the current stream wait for it, without blocking the host.
+// Sends that are still in flight are waited on at the end of runWithInput,
+// before the intermediate tensors are released.
+
+// Note [ Peer outputs ]
+//
+// A SendRecv between two processes reads the value the sending kernel wrote
+// to global memory and writes it again into the memory of the receiving
+// process. On a single node, CUDA IPC lets the sending kernel write the
+// value into the memory of the receiving process instead, which saves the
+// copy and leaves the SendRecv only to signal that the value is complete.
+//
+// In this mode, the receiving process allocates a buffer for each value it
+// receives with the only SendRecv of the value across processes. The
+// buffer is exported with cudaIpcGetMemHandle and sent to the sending
+// process together with the device and the host of the receiver. The
+// sending process maps it with cudaIpcOpenMemHandle if it is on the same
+// host and its device can access the device of the receiver, and answers
+// whether it did. Both processes handle the producing AggregateExpr in the
+// same order and with the same output shapes, so they set up, and set up
+// again when the shape changes, their end of the buffer at the same
+// point. From then on,
+//   - the sending process passes the mapped buffer as the preallocated
+//     output of the kernel, and the receiving process uses the buffer in
+//     place of the placeholder of the value,
+//   - the SendRecv sends a one byte token after the kernel, which the
+//     receiving process waits for before consuming the value, and
+//   - before the next run overwrites the buffer, the receiving process
+//     sends a token back after the last consumer of the previous run,
+//     which the sending process waits for before launching the kernel.
+// Tokens are sent through the process cluster, so they are ordered with
+// respect to the kernels of both processes. Values that are outputs of the
+// fusion are copied out of the buffers at the end of each run.
+//
+// There is no NVSHMEM support: writes to peers only happen through
+// preallocated outputs of the whole kernel, not through the epilogue.
+
+namespace {
+
+// Message the receiving process sends to set up a peer buffer
+struct PeerBufferHandle {
+  cudaIpcMemHandle_t mem_handle;
+  int device_index;
+  size_t host_id;
+};
+
+} // namespace
+
+SendRecv* MultiDeviceRuntime::peerSendOf(AggregateVal* a_val) {
+  if (!peer_sends_.has_value()) {
+    // Only values with a single SendRecv across processes are eligible,
+    // since the sending kernel writes into a single buffer
+    std::unordered_map<AggregateVal*, int> num_send_recvs;
+    std::unordered_map<AggregateVal*, SendRecv*> peer_sends;
+    for (auto expr : StmtSort::getExprs(a_dag_.get())) {
+      if (!expr->isA<SendRecv>()) {
+        continue;
+      }
+      auto sr = expr->as<SendRecv>();
+      num_send_recvs[sr->in()]++;
+      const auto sender_rank = sr->in()->getCluster()->params().process_rank;
+      const auto receiver_rank =
+          sr->out()->getCluster()->params().process_rank;
+      // Without a topology, let the handshake tell which peers are reachable
+      const bool use_peer_memory = topology_.has_value()
+          ? selectTransport(
+                topology_->link(sender_rank, receiver_rank), peer_outputs_) ==
+              Transport::PeerMemory
+          : sender_rank != receiver_rank;
+      if (use_peer_memory) {
+        peer_sends[sr->in()] = sr;
+      }
+    }
+    for (const auto& [in, count] : num_send_recvs) {
+      if (count > 1) {
+        peer_sends.erase(in);
+      }
+    }
+    peer_sends_ = std::move(peer_sends);
+  }
+  auto it = peer_sends_->find(a_val);
+  return it == peer_sends_->end() ? nullptr : it->second;
+}
+
+void MultiDeviceRuntime::setupPeerBuffer(
+    SendRecv* sr,
+    PeerBuffer& peer_buffer,
+    const at::Tensor& placeholder) {
+  const bool is_sender = shouldRun(sr->in()->getCluster());
+  const int sender_rank = sr->in()->getCluster()->params().process_rank;
+  const int receiver_rank = sr->out()->getCluster()->params().process_rank;
+  const auto device = placeholder.device();
+  c10::cuda::CUDAGuard device_guard(device);
+
+  // Release the buffer of the previous shape, once nothing uses it anymore
+  peer_buffer.tensor = at::Tensor();
+  peer_buffer.sizes = placeholder.sizes().vec();
+  peer_buffer.strides = placeholder.strides().vec();
+
+  auto byte_options = at::TensorOptions().dtype(at::kByte).device(device);
+  std::vector<at::Tensor> handle_tensor = {
+      at::empty({(int64_t)sizeof(PeerBufferHandle)}, byte_options)};
+  std::vector<at::Tensor> accepted_tensor = {at::empty({1}, byte_options)};
+  const auto nbytes = std::max<size_t>(placeholder.storage().nbytes(), 1);
+
+  if (is_sender) {
+    process_cluster_->recv(handle_tensor, receiver_rank, 0)->wait();
+    PeerBufferHandle handle;
+    auto handle_cpu = handle_tensor[0].cpu();
+    std::memcpy(&handle, handle_cpu.data_ptr(), sizeof(handle));
+
+    int can_access_peer = handle.device_index == device.index();
+    if (!can_access_peer) {
+      CUDA_RT_SAFE_CALL(cudaDeviceCanAccessPeer(
+          &can_access_peer, device.index(), handle.device_index));
+    }
+    void* ptr = nullptr;
+    bool accepted = handle.host_id == localHostId() && can_access_peer &&
+        cudaIpcOpenMemHandle(
+            &ptr, handle.mem_handle, cudaIpcMemLazyEnablePeerAccess) ==
+            cudaSuccess;
+    if (!accepted) {
+      // clear the error of a failed cudaIpcOpenMemHandle
+      (void)cudaGetLastError();
+    } else {
+      peer_buffer.tensor = at::from_blob(
+          ptr,
+          peer_buffer.sizes,
+          peer_buffer.strides,
+          [device](void* ptr) {
+            c10::cuda::CUDAGuard device_guard(device);
+            (void)cudaIpcCloseMemHandle(ptr);
+          },
+          placeholder.options());
+    }
+    accepted_tensor[0].fill_((int)accepted);
+    process_cluster_->send(accepted_tensor, receiver_rank, 0)->wait();
+    return;
+  }
+
+  void* ptr = nullptr;
+  CUDA_RT_SAFE_CALL(cudaMalloc(&ptr, nbytes));
+  PeerBufferHandle handle;
+  CUDA_RT_SAFE_CALL(cudaIpcGetMemHandle(&handle.mem_handle, ptr));
+  handle.device_index = device.index();
+  handle.host_id = localHostId();
+  auto handle_cpu = at::empty(
+      {(int64_t)sizeof(PeerBufferHandle)},
+      at::TensorOptions().dtype(at::kByte));
+  std::memcpy(handle_cpu.data_ptr(), &handle, sizeof(handle));
+  handle_tensor[0].copy_(handle_cpu);
+  process_cluster_->send(handle_tensor, sender_rank, 0)->wait();
+  process_cluster_->recv(accepted_tensor, sender_rank, 0)->wait();
+
+  if (accepted_tensor[0].item<uint8_t>() == 0) {
+    CUDA_RT_SAFE_CALL(cudaFree(ptr));
+    return;
+  }
+  peer_buffer.tensor = at::from_blob(
+      ptr,
+      peer_buffer.sizes,
+      peer_buffer.strides,
+      [device](void* ptr) {
+        c10::cuda::CUDAGuard device_guard(device);
+        (void)cudaFree(ptr);
+      },
+      placeholder.options());
+}
+
+std::vector<at::Tensor> MultiDeviceRuntime::preparePeerOutputs(
+    AggregateExpr* aExpr,
+    const std::vector<c10::IValue>& cluster_input) {
+  auto cluster = aExpr->getCluster();
+  std::vector<std::pair<size_t, SendRecv*>> peer_sends;
+  for (auto output_idx : c10::irange(aExpr->outputs().size())) {
+    auto sr = peerSendOf(aExpr->output(output_idx)->as<AggregateVal>());
+    // Only the sending and the receiving process take part
+    if (sr != nullptr &&
+        (shouldRun(cluster) || shouldRun(sr->out()->getCluster()))) {
+      peer_sends.emplace_back(output_idx, sr);
+    }
+  }
+  if (peer_sends.empty()) {
+    return {};
+  }
+
+  // Shapes of the outputs, in the order of the cluster outputs
+  auto outputs = allocClusterOutputs(cluster, cluster_input);
+  for (const auto& [output_idx, sr] : peer_sends) {
+    auto& peer_buffer = peer_buffers_[sr];
+    const int sender_rank = sr->in()->getCluster()->params().process_rank;
+    const int receiver_rank = sr->out()->getCluster()->params().process_rank;
+    const auto& placeholder = outputs.at(output_idx);
+
+    // Wait for the receiver to be done with the value of the previous run
+    if (peer_buffer.written) {
+      auto options = at::TensorOptions().dtype(at::kByte).device(
+          placeholder.device());
+      std::vector<at::Tensor> token = {at::empty({1}, options)};
+      if (shouldRun(cluster)) {
+        process_cluster_->recv(token, receiver_rank, 0)->wait();
+      } else {
+        process_cluster_->send(token, sender_rank, 0);
+      }
+      peer_buffer.written = false;
+    }
+
+    if (peer_buffer.sizes != placeholder.sizes().vec() ||
+        peer_buffer.strides != placeholder.strides().vec()) {
+      setupPeerBuffer(sr, peer_buffer, placeholder);
+    }
+    if (peer_buffer.tensor.defined()) {
+      outputs.at(output_idx) = peer_buffer.tensor;
+    }
+  }
+  return outputs;
+}
+
+std::vector<Expr*> MultiDeviceRuntime::asyncSchedule() {
+  std::vector<Expr*> exprs = StmtSort::getExprs(a_dag_.get());
+
+  // SendRecvs are moved after the AggregateExpr producing their input
+  std::unordered_map<Expr*, std::vector<Expr*>> send_recvs_after;
+  for (auto expr : exprs) {
+    if (expr->isA<SendRecv>()) {
+      auto producer = expr->as<SendRecv>()->in()->definition();
+      TORCH_INTERNAL_ASSERT(producer != nullptr);
+      send_recvs_after[producer].push_back(expr);
+    }
+  }
+
+  std::vector<Expr*> schedule;
+  schedule.reserve(exprs.size());
+  for (auto expr : exprs) {
+    if (expr->isA<SendRecv>()) {
+      continue;
+    }
+    schedule.push_back(expr);
+    auto send_recvs_it = send_recvs_after.find(expr);
+    if (send_recvs_it != send_recvs_after.end()) {
+      schedule.insert(
+          schedule.end(),
+          send_recvs_it->second.begin(),
+          send_recvs_it->second.end());
+    }
+  }
+  return schedule;
+}
+
 std::vector<at::Tensor> MultiDeviceRuntime::runWithInput(
     std::vector<c10::IValue> inputs) {
   // Make sure inputs align at global boundary.
@@ -183,7 +631,16 @@ std::vector<at::Tensor> MultiDeviceRuntime::runWithInput(
   }
 
   // Run through the clusters to launch kernel
-  traverseTo(a_dag_.get(), a_dag_->outputs());
+  if (async_communication_) {
+    for (auto expr : asyncSchedule()) {
+      handle(expr);
+    }
+    for (auto output_val : a_dag_->MCFusionOutputs()) {
+      waitForRecvs(output_val);
+    }
+  } else {
+    traverseTo(a_dag_.get(), a_dag_->outputs());
+  }
 
   // Collect global outputs from context
   std::vector<at::Tensor> outputs;
@@ -193,12 +650,106 @@ std::vector<at::Tensor> MultiDeviceRuntime::runWithInput(
       std::back_inserter(outputs),
       [this](auto output_val) { return val_to_IValue[output_val].toTensor(); });
 
+  // Outputs written into peer buffers are overwritten by the next run
+  if (!peer_buffers_.empty()) {
+    for (auto& output : outputs) {
+      for (const auto& [sr, peer_buffer] : peer_buffers_) {
+        if (peer_buffer.tensor.defined() &&
+            output.data_ptr() == peer_buffer.tensor.data_ptr()) {
+          output = output.clone();
+          break;
+        }
+      }
+    }
+  }
+
   // Clear life time of intermediate tensors.
+  for (auto& work : pending_sends_) {
+    work->wait();
+  }
+  pending_sends_.clear();
+  pending_recvs_.clear();
   val_to_IValue.clear();
 
   return outputs;
 }
 
+// Note [ Micro-batch pipelining ]
+//
+// runWithMicroBatches runs the slices of the inputs through the AggregateDag
+// one after the other, in asynchronous communication mode, see
+// Note [ Asynchronous communication ]. Waiting for a receive only makes the
+// stream of the consuming process wait, so the host of every process issues
+// the kernels and the communication of all the micro-batches without
+// blocking, and a process runs its clusters on a micro-batch as soon as the
+// previous process has sent it, while that one moves on to the next
+// micro-batch. This is the forward-only (GPipe) schedule: the ranks of a
+// pipeline of n stages are all busy once the first n - 1 micro-batches are
+// in flight. Every output of the fusion must keep the dimension the inputs
+// are sliced along.
+
+std::vector<at::Tensor> MultiDeviceRuntime::runWithMicroBatches(
+    const std::vector<c10::IValue>& inputs,
+    int64_t num_micro_batches,
+    int64_t dim) {
+  TORCH_CHECK(
+      num_micro_batches > 0,
+      "Expected a positive number of micro-batches, got ",
+      num_micro_batches);
+
+  // slices of each tensor input, contiguous like the inputs the clusters are
+  // compiled for
+  std::vector<std::vector<at::Tensor>> input_slices(inputs.size());
+  for (auto input_idx : c10::irange(inputs.size())) {
+    if (!inputs[input_idx].isTensor()) {
+      continue;
+    }
+    const auto& input = inputs[input_idx].toTensor();
+    TORCH_CHECK(
+        dim >= 0 && dim < input.dim() &&
+            input.size(dim) >= num_micro_batches,
+        "Input ",
+        input_idx,
+        " can't be sliced into ",
+        num_micro_batches,
+        " micro-batches along dimension ",
+        dim);
+    for (const auto& slice : input.tensor_split(num_micro_batches, dim)) {
+      input_slices[input_idx].push_back(slice.contiguous());
+    }
+  }
+
+  const bool async_communication = async_communication_;
+  async_communication_ = true;
+  std::vector<std::vector<at::Tensor>> micro_batch_outputs;
+  try {
+    for (auto micro_batch : c10::irange(num_micro_batches)) {
+      std::vector<c10::IValue> micro_batch_inputs;
+      for (auto input_idx : c10::irange(inputs.size())) {
+        micro_batch_inputs.push_back(
+            inputs[input_idx].isTensor()
+                ? c10::IValue(input_slices[input_idx][micro_batch])
+                : inputs[input_idx]);
+      }
+      micro_batch_outputs.push_back(runWithInput(micro_batch_inputs));
+    }
+  } catch (...) {
+    async_communication_ = async_communication;
+    throw;
+  }
+  async_communication_ = async_communication;
+
+  std::vector<at::Tensor> outputs;
+  for (auto output_idx : c10::irange(micro_batch_outputs.front().size())) {
+    std::vector<at::Tensor> output_slices;
+    for (const auto& micro_batch_output : micro_batch_outputs) {
+      output_slices.push_back(micro_batch_output.at(output_idx));
+    }
+    outputs.push_back(at::cat(output_slices, dim));
+  }
+  return outputs;
+}
+
 } // namespace nvfuser
 
 #endif
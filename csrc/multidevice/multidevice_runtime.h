@@ -13,8 +13,10 @@
 #include <executor.h>
 #include <fusion.h>
 #include <fusion_segmenter.h>
+#include <kernel_cache.h>
 #include <multidevice/aggregate_dag.h>
 #include <multidevice/multicluster_fusion.h>
+#include <multidevice/topology.h>
 #include <scheduler/all_schedulers.h>
 #include <scheduler/registry.h>
 
@@ -42,33 +44,151 @@ class TORCH_CUDA_CU_API MultiDeviceRuntime : public IterVisitor {
   // Run the multidevice fusion with the given global inputs
   std::vector<at::Tensor> runWithInput(std::vector<c10::IValue> inputs);
 
+  // Run the multidevice fusion on `num_micro_batches` slices of the tensor
+  // inputs along `dim`, pipelined through the clusters, and concatenate the
+  // outputs of the slices along `dim`, see Note [ Micro-batch pipelining ]
+  std::vector<at::Tensor> runWithMicroBatches(
+      const std::vector<c10::IValue>& inputs,
+      int64_t num_micro_batches,
+      int64_t dim = 0);
+
+  // Issue the sends and receives of the SendRecvs without waiting for them,
+  // see Note [ Asynchronous communication ]
+  void setAsyncCommunication(bool async_communication) {
+    async_communication_ = async_communication;
+  }
+
+  // Let the kernels of the sending clusters write the values of SendRecvs
+  // directly into the memory of the receiving process, see
+  // Note [ Peer outputs ]
+  void setPeerOutputs(bool peer_outputs) {
+    peer_outputs_ = peer_outputs;
+  }
+
+  // Select the transport of each SendRecv from the link between its ranks,
+  // see selectTransport. Without a topology, peer outputs are used wherever
+  // the processes can access each other's memory.
+  void setTopology(Topology topology) {
+    topology_ = std::move(topology);
+    peer_sends_.reset();
+  }
+
  private:
   // Implement the execution of exprs of the AggregateDag
   // Each AggregateExpr will be compiled and executed on a GPU
   // Each SendRecv will invoke the ProgressCluster to perform the comm
+  // Each Collective will invoke the matching collective of the
+  // ProcessCluster
   using IterVisitor::handle;
   void handle(AggregateExpr* aExpr) override;
   void handle(SendRecv* sr) override;
+  void handle(Collective* collective) override;
+
+  // Order of the exprs of the AggregateDag in asynchronous mode, which
+  // issues each SendRecv right after the AggregateExpr producing its input
+  std::vector<Expr*> asyncSchedule();
+
+  // Wait for the receives and collectives in flight of the given value, if
+  // any
+  void waitForRecvs(Val* val);
+
+  // Buffer of the receiving process a SendRecv is written into by the
+  // kernel of the sending cluster, see Note [ Peer outputs ]
+  struct PeerBuffer {
+    // Sizes and strides of the value the buffer was set up for
+    std::vector<int64_t> sizes;
+    std::vector<int64_t> strides;
+    // The buffer of the receiving process, or its mapping in the sending
+    // process. Undefined if the processes can't access each other's memory
+    at::Tensor tensor;
+    // Set by a run that wrote into the buffer, for the next run to wait for
+    // the receiving process to release it
+    bool written = false;
+  };
+
+  // The outputs of the cluster with the buffers of the receiving processes
+  // in place of the values sent with a peer SendRecv, or empty if the
+  // cluster has none
+  std::vector<at::Tensor> preparePeerOutputs(
+      AggregateExpr* aExpr,
+      const std::vector<c10::IValue>& cluster_input);
+
+  // Exchanges the buffer of a SendRecv between the sending and the
+  // receiving process, for a value shaped like `placeholder`
+  void setupPeerBuffer(
+      SendRecv* sr,
+      PeerBuffer& peer_buffer,
+      const at::Tensor& placeholder);
+
+  // Returns the SendRecv its input can be written into the buffer of the
+  // receiving process by, if any
+  SendRecv* peerSendOf(AggregateVal* a_val);
 
   // Check if the current process should run a Cluster
   bool shouldRun(ClusterPtr cluster) {
     return cluster->params().process_rank == process_cluster_->getRank();
   }
-  // Generate and compile cuda kernel corresponding to the given Cluster
+  // Generate and compile cuda kernel corresponding to the given manually
+  // scheduled Cluster
   CompiledKernelPtr compileCluster(
       ClusterPtr cluster,
       std::vector<c10::IValue> cluster_input);
 
+  // Returns the FusionExecutorCache of the given auto-scheduled Cluster,
+  // created on first use
+  FusionExecutorCache* executorCacheOf(ClusterPtr cluster);
+
+  // Run the given Cluster, writing into `outputs` if given
+  std::vector<at::Tensor> runCluster(
+      ClusterPtr cluster,
+      const std::vector<c10::IValue>& cluster_input,
+      const std::vector<at::Tensor>& outputs = {});
+
+  // Placeholders of the outputs of a Cluster run by another process, reused
+  // across runs when their shapes don't change, see Note [ Receive buffers ]
+  std::vector<at::Tensor> allocClusterOutputs(
+      ClusterPtr cluster,
+      const std::vector<c10::IValue>& cluster_input);
+
   // Stores concrete computed values,
   std::unordered_map<Val*, c10::IValue> val_to_IValue;
 
-  // Compiled kernels from multi_cluster_fusion_
+  // Compiled kernels of the manually scheduled clusters
   std::unordered_map<ClusterPtr, CompiledKernelPtr> compiled_kernels_;
 
-  // Keeps track of heuristics that are used to schedule
-  //  the auto-scheduled kernels.
-  std::unordered_map<ClusterPtr, std::unique_ptr<SchedulerEntry>>
-      auto_scheduler_registry_;
+  // Executor caches of the auto-scheduled clusters, so that they are
+  // segmented, scheduled and compiled per input shape like single device
+  // fusions
+  std::unordered_map<ClusterPtr, std::unique_ptr<FusionExecutorCache>>
+      executor_caches_;
+
+  // Placeholders of the outputs of the clusters run by other processes,
+  // kept across runs
+  std::unordered_map<ClusterPtr, std::vector<at::Tensor>> recv_buffers_;
+
+  // Issue SendRecvs without waiting for them, see setAsyncCommunication
+  bool async_communication_ = false;
+
+  // Receives and collectives in flight in asynchronous mode, waited on by
+  // the first AggregateExpr consuming the received value
+  std::unordered_map<Val*, std::vector<c10::intrusive_ptr<c10d::Work>>>
+      pending_recvs_;
+
+  // Write the values of SendRecvs across processes directly into the
+  // memory of the receiving process, see setPeerOutputs
+  bool peer_outputs_ = false;
+
+  // Links between the devices of the ranks, see setTopology
+  c10::optional<Topology> topology_;
+
+  // SendRecvs eligible to peer outputs, by the AggregateVal they send
+  c10::optional<std::unordered_map<AggregateVal*, SendRecv*>> peer_sends_;
+
+  // Buffers of the SendRecvs written into by the sending cluster
+  std::unordered_map<SendRecv*, PeerBuffer> peer_buffers_;
+
+  // Sends in flight in asynchronous mode, waited on at the end of the run
+  std::vector<c10::intrusive_ptr<c10d::Work>> pending_sends_;
 
   // Process cluster. Interface for inter-process collectives
   c10::intrusive_ptr<c10d::Backend> process_cluster_;
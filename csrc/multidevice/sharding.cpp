@@ -0,0 +1,344 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <ir_cloner.h>
+#include <ir_utils.h>
+#include <multidevice/sharding.h>
+#include <ops/arith.h>
+
+#include <ATen/ATen.h>
+
+namespace nvfuser {
+
+namespace {
+
+// Clones the exprs of one stage of the original fusion for one rank, see
+// Note [ Sharding propagation ]
+class StageCloner : private IrCloner {
+ public:
+  explicit StageCloner(IrContainer* container) : IrCloner(container) {}
+
+  using IrCloner::clone;
+
+  bool isMapped(const Val* src) const {
+    return clones_map_.count(src) != 0;
+  }
+
+  // Maps an input of the stage and the extents of its logical domain to the
+  // tensor of the rank, so that the cloned exprs only refer to extents bound
+  // by the inputs of the cluster
+  void map(TensorView* src, TensorView* tv) {
+    registerClone(src, tv);
+    auto src_domain = TensorDomain::noReductions(src->getMaybeRFactorDomain());
+    auto domain = TensorDomain::noReductions(tv->getMaybeRFactorDomain());
+    TORCH_INTERNAL_ASSERT(src_domain.size() == domain.size());
+    for (auto i : c10::irange(domain.size())) {
+      // inputs sharing an extent bind it to the same value, either one does
+      if (!isMapped(src_domain[i]->extent())) {
+        registerClone(src_domain[i]->extent(), domain[i]->extent());
+      }
+    }
+  }
+};
+
+// Returns the axis the outputs of `expr` are sharded along, or -1 if they
+// are replicated. `partial` is set if the outputs are partial sums over the
+// sharded axis.
+int64_t propagateSharding(
+    Expr* expr,
+    const std::unordered_map<Val*, int64_t>& axes,
+    bool& partial) {
+  partial = false;
+  int64_t axis = -1;
+  for (auto input : ir_utils::filterByType<TensorView>(expr->inputs())) {
+    auto it = axes.find(input);
+    if (it == axes.end()) {
+      continue;
+    }
+    TORCH_CHECK(
+        axis == -1 || axis == it->second,
+        "The operands of ",
+        expr->toString(),
+        " are sharded along different axes");
+    axis = it->second;
+  }
+  if (axis == -1) {
+    return -1;
+  }
+
+  if (auto rop = dynamic_cast<ReductionOp*>(expr)) {
+    // The root domain of the output has the reduced axes at the position
+    // they have in the input
+    const auto& root = rop->out()->as<TensorView>()->getRootDomain();
+    if (root.at(axis)->isReduction()) {
+      TORCH_CHECK(
+          rop->getReductionOpType() == BinaryOpType::Add,
+          "Only sums can reduce a sharded axis, found ",
+          expr->toString());
+      partial = true;
+      return -1;
+    }
+    return axis -
+        std::count_if(root.begin(), root.begin() + axis, [](IterDomain* id) {
+             return id->isReduction();
+           });
+  }
+
+  if (auto bop = dynamic_cast<BroadcastOp*>(expr)) {
+    const auto& flags = bop->getBroadcastDimFlags();
+    int64_t input_axis = 0;
+    for (auto i : c10::irange(flags.size())) {
+      if (!flags[i] && input_axis++ == axis) {
+        return (int64_t)i;
+      }
+    }
+    TORCH_INTERNAL_ASSERT(false, "Sharded axis not found in ", bop->toString());
+  }
+
+  bool is_pointwise = expr->isA<UnaryOp>() || expr->isA<BinaryOp>() ||
+      expr->isA<TernaryOp>() || expr->isA<LoadStoreOp>();
+  for (auto output : ir_utils::filterByType<TensorView>(expr->outputs())) {
+    is_pointwise = is_pointwise && !output->hasRFactor();
+  }
+  TORCH_CHECK(
+      is_pointwise,
+      expr->getOpString(),
+      " is not supported on sharded tensors, found ",
+      expr->toString());
+
+  for (auto input : ir_utils::filterByType<TensorView>(expr->inputs())) {
+    TORCH_CHECK(
+        axes.count(input) ||
+            TensorDomain::noReductions(input->getMaybeRFactorDomain())
+                .at(axis)
+                ->isBroadcast(),
+        "The replicated operand ",
+        input->toString(),
+        " of ",
+        expr->toString(),
+        " must be broadcast along the sharded axis ",
+        axis);
+  }
+  return axis;
+}
+
+} // namespace
+
+ShardedFusion::ShardedFusion(Fusion* fusion, FusionSharding sharding)
+    : multi_cluster_fusion_(std::make_unique<MultiClusterFusion>()),
+      mesh_(std::move(sharding.mesh)) {
+  TORCH_CHECK(!mesh_.empty(), "The device mesh is empty");
+  auto mcf = multi_cluster_fusion_.get();
+  FusionGuard fg(mcf);
+
+  // Sharded axis of the values of the original fusion
+  std::unordered_map<Val*, int64_t> axes;
+  // Tensor standing for each value of the original fusion on each rank of
+  // the mesh, once it is produced
+  std::vector<std::unordered_map<Val*, TensorView*>> rank_tvs(mesh_.size());
+  // Cluster producing each tensor of the MultiClusterFusion
+  std::unordered_map<TensorView*, ClusterPtr> producers;
+
+  // Sharded inputs get a tensor per rank, a single tensor shared by the
+  // ranks stands for each replicated input
+  for (auto input : fusion->inputs()) {
+    TORCH_CHECK(
+        input->isA<TensorView>(),
+        "Only tensor inputs are supported, found ",
+        input->toString());
+    auto tv = input->as<TensorView>();
+    int64_t axis = -1;
+    auto it = sharding.input_axes.find(tv);
+    if (it != sharding.input_axes.end()) {
+      axis = it->second;
+      auto domain = TensorDomain::noReductions(tv->getMaybeRFactorDomain());
+      TORCH_CHECK(
+          axis >= 0 && axis < (int64_t)domain.size() &&
+              !domain.at(axis)->isBroadcast(),
+          "Can't shard ",
+          tv->toString(),
+          " along axis ",
+          axis);
+      axes[tv] = axis;
+    }
+    input_axes_.push_back(axis);
+
+    TensorView* local = nullptr;
+    for (auto i : c10::irange(mesh_.size())) {
+      if (axis != -1 || local == nullptr) {
+        IrCloner cloner(mcf);
+        local = cloner.clone(tv);
+        mcf->addInput(local);
+      }
+      rank_tvs[i][tv] = local;
+    }
+  }
+
+  // Group the exprs into stages separated by the all-reduces
+  std::vector<std::vector<Expr*>> stages;
+  std::vector<std::vector<TensorView*>> all_reduced;
+  std::unordered_map<Val*, size_t> stage_of;
+  for (auto expr : fusion->exprs()) {
+    TORCH_CHECK(
+        expr->outputs().size() ==
+            ir_utils::filterByType<TensorView>(expr->outputs()).size(),
+        "Only exprs producing tensors are supported, found ",
+        expr->toString());
+    size_t stage = 0;
+    for (auto input : expr->inputs()) {
+      auto it = stage_of.find(input);
+      if (it != stage_of.end()) {
+        stage = std::max(stage, it->second);
+      }
+    }
+    bool partial = false;
+    auto axis = propagateSharding(expr, axes, partial);
+    if (stages.size() <= stage) {
+      stages.resize(stage + 1);
+      all_reduced.resize(stage + 1);
+    }
+    stages[stage].push_back(expr);
+    for (auto output : expr->outputs()) {
+      stage_of[output] = partial ? stage + 1 : stage;
+      if (axis != -1) {
+        axes[output] = axis;
+      }
+    }
+    if (partial) {
+      all_reduced[stage].push_back(expr->output(0)->as<TensorView>());
+    }
+  }
+
+  // Tensors consumed by a later stage of the same rank
+  std::vector<TensorView*> crossing;
+  for (auto stage : c10::irange(stages.size())) {
+    for (auto i : c10::irange(mesh_.size())) {
+      mcf->newCluster({.process_rank = mesh_[i]});
+      auto cluster = mcf->getCurrentCluster();
+      StageCloner cloner(mcf);
+      for (auto expr : stages[stage]) {
+        for (auto input : ir_utils::filterByType<TensorView>(expr->inputs())) {
+          if (cloner.isMapped(input)) {
+            continue;
+          }
+          auto local = rank_tvs[i].at(input);
+          cloner.map(input, local);
+          if (producers.count(local)) {
+            crossing.push_back(local);
+          }
+        }
+        cloner.clone(expr);
+        for (auto output :
+             ir_utils::filterByType<TensorView>(expr->outputs())) {
+          auto local = cloner.clone(output);
+          rank_tvs[i][output] = local;
+          producers[local] = cluster;
+        }
+      }
+    }
+
+    for (auto tv : all_reduced[stage]) {
+      std::vector<TensorView*> partials;
+      for (auto i : c10::irange(mesh_.size())) {
+        auto local = rank_tvs[i].at(tv);
+        mcf->setCurrentCluster(producers.at(local));
+        mcf->addClusterOutput(local);
+        partials.push_back(local);
+      }
+      auto reduced = mcf->addCollective(CollectiveType::AllReduce, partials);
+      for (auto i : c10::irange(mesh_.size())) {
+        rank_tvs[i][tv] = reduced;
+      }
+    }
+  }
+
+  for (auto tv : crossing) {
+    mcf->setCurrentCluster(producers.at(tv));
+    mcf->addClusterOutput(tv);
+  }
+
+  // The outputs of the MultiDeviceRuntime are the outputs of every rank for
+  // the first output of the original fusion, then for the second, etc.
+  // Results of all-reduces are not produced by a cluster, each rank copies
+  // them in a last cluster.
+  std::vector<ClusterPtr> last_clusters(mesh_.size());
+  for (auto output : fusion->outputs()) {
+    TORCH_CHECK(
+        output->isA<TensorView>() && !output->isFusionInput(),
+        "Only tensor outputs computed by the fusion are supported, found ",
+        output->toString());
+    auto it = axes.find(output);
+    output_axes_.push_back(it == axes.end() ? -1 : it->second);
+    for (auto i : c10::irange(mesh_.size())) {
+      auto local = rank_tvs[i].at(output);
+      if (!producers.count(local)) {
+        if (last_clusters[i] == nullptr) {
+          mcf->newCluster({.process_rank = mesh_[i]});
+          last_clusters[i] = mcf->getCurrentCluster();
+        }
+        mcf->setCurrentCluster(last_clusters[i]);
+        local = set(local);
+        producers[local] = last_clusters[i];
+      }
+      mcf->setCurrentCluster(producers.at(local));
+      mcf->addClusterOutput(local);
+      mcf->addOutput(local);
+    }
+  }
+}
+
+size_t ShardedFusion::meshIndex(ProcessRankType rank) const {
+  auto it = std::find(mesh_.begin(), mesh_.end(), rank);
+  TORCH_CHECK(it != mesh_.end(), "Rank ", rank, " is not in the device mesh");
+  return std::distance(mesh_.begin(), it);
+}
+
+std::vector<c10::IValue> ShardedFusion::shardInputs(
+    const std::vector<c10::IValue>& inputs,
+    ProcessRankType rank) const {
+  TORCH_CHECK(
+      inputs.size() == input_axes_.size(),
+      "Expected ",
+      input_axes_.size(),
+      " inputs, got ",
+      inputs.size());
+  const auto index = meshIndex(rank);
+  std::vector<c10::IValue> sharded_inputs;
+  for (auto i : c10::irange(inputs.size())) {
+    if (input_axes_[i] == -1) {
+      sharded_inputs.push_back(inputs[i]);
+      continue;
+    }
+    auto shards = at::tensor_split(
+        inputs[i].toTensor(), (int64_t)mesh_.size(), input_axes_[i]);
+    for (auto j : c10::irange(shards.size())) {
+      sharded_inputs.push_back(
+          j == index ? shards[j].contiguous()
+                     : at::empty(shards[j].sizes(), shards[j].options()));
+    }
+  }
+  return sharded_inputs;
+}
+
+std::vector<at::Tensor> ShardedFusion::localOutputs(
+    const std::vector<at::Tensor>& outputs,
+    ProcessRankType rank) const {
+  TORCH_CHECK(
+      outputs.size() == output_axes_.size() * mesh_.size(),
+      "Expected ",
+      output_axes_.size() * mesh_.size(),
+      " outputs, got ",
+      outputs.size());
+  const auto index = meshIndex(rank);
+  std::vector<at::Tensor> local_outputs;
+  for (auto i : c10::irange(output_axes_.size())) {
+    local_outputs.push_back(outputs[i * mesh_.size() + index]);
+  }
+  return local_outputs;
+}
+
+} // namespace nvfuser
@@ -0,0 +1,95 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <ATen/core/ivalue.h>
+#include <multidevice/aggregate_dag.h>
+#include <multidevice/multicluster_fusion.h>
+
+namespace nvfuser {
+
+// Describes how the inputs of a Fusion are distributed over a device mesh,
+// see ShardedFusion
+struct FusionSharding {
+  // Ranks of the device mesh. The all-reduces inserted by ShardedFusion span
+  // the whole process group, so the mesh must list all of its ranks.
+  std::vector<ProcessRankType> mesh;
+  // Axis each sharded input is split along across the ranks of the mesh, the
+  // inputs that do not appear are replicated on every rank
+  std::unordered_map<TensorView*, int64_t> input_axes;
+};
+
+// Note [ Sharding propagation ]
+//
+// ShardedFusion derives from a plain Fusion and a FusionSharding the
+// MultiClusterFusion that runs the fusion on the shards of its inputs, which
+// saves writing one cluster per rank and the communication between them by
+// hand.
+//
+// Sharding flows through the exprs in topological order:
+// - pointwise ops keep the axis of their sharded operands, which must all be
+//   sharded along the same axis. Replicated operands must be broadcast along
+//   it, as every rank would otherwise read the whole of them.
+// - broadcasts move the axis to its position in their output.
+// - reductions over other axes drop the reduced axes before it.
+// - a sum over the sharded axis leaves every rank with a partial sum. The
+//   partial sums are combined by an AllReduce, whose result is replicated.
+// Other ops on sharded tensors are not supported yet.
+//
+// Each AllReduce ends a stage: the exprs of a stage are cloned once per rank
+// of the mesh into a cluster running on that rank, and the exprs after the
+// reduction go into the clusters of the next stage. Values crossing stages
+// on the same rank stay on the device, see MultiDeviceRuntime::handle.
+//
+// Each stage is cloned from a fresh set of extents, bound from the inputs of
+// its clusters, since the extents of the original fusion are shared by
+// values that end up in different clusters.
+class TORCH_CUDA_CU_API ShardedFusion {
+ public:
+  ShardedFusion(Fusion* fusion, FusionSharding sharding);
+
+  MultiClusterFusion* multiClusterFusion() const {
+    return multi_cluster_fusion_.get();
+  }
+
+  std::unique_ptr<AggregateDag> aggregateDag() const {
+    return multi_cluster_fusion_->aggregateDag();
+  }
+
+  // Axis the given output of the original fusion is sharded along, or -1 if
+  // every rank holds all of it
+  int64_t outputAxis(size_t index) const {
+    return output_axes_.at(index);
+  }
+
+  // Splits the inputs of the original fusion into the inputs of the
+  // MultiClusterFusion. Only the shards of `rank` are materialized, the
+  // shards of the other ranks are placeholders of the right shape.
+  std::vector<c10::IValue> shardInputs(
+      const std::vector<c10::IValue>& inputs,
+      ProcessRankType rank) const;
+
+  // Picks the outputs of `rank` among the outputs of the MultiDeviceRuntime,
+  // in the order of the outputs of the original fusion. Sharded outputs are
+  // the shard of `rank`.
+  std::vector<at::Tensor> localOutputs(
+      const std::vector<at::Tensor>& outputs,
+      ProcessRankType rank) const;
+
+ private:
+  // Position of the rank in the mesh
+  size_t meshIndex(ProcessRankType rank) const;
+
+  std::unique_ptr<MultiClusterFusion> multi_cluster_fusion_;
+  std::vector<ProcessRankType> mesh_;
+  // Axis of each input and output of the original fusion, -1 if replicated
+  std::vector<int64_t> input_axes_;
+  std::vector<int64_t> output_axes_;
+};
+
+} // namespace nvfuser
@@ -0,0 +1,250 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#ifdef USE_DISTRIBUTED
+#include <executor_utils.h>
+#include <iter_visitor.h>
+#include <multidevice/aggregate_dag.h>
+#include <multidevice/topology.h>
+
+#include <ATen/ATen.h>
+#include <c10/cuda/CUDAGuard.h>
+
+#include <unistd.h>
+#include <cstdio>
+#include <numeric>
+
+namespace nvfuser {
+
+std::ostream& operator<<(std::ostream& os, LinkType link) {
+  switch (link) {
+    case LinkType::SameDevice:
+      return os << "SameDevice";
+    case LinkType::NVLink:
+      return os << "NVLink";
+    case LinkType::PCIe:
+      return os << "PCIe";
+    case LinkType::Network:
+      return os << "Network";
+  }
+  TORCH_INTERNAL_ASSERT(false, "unknown link type");
+}
+
+std::ostream& operator<<(std::ostream& os, Transport transport) {
+  switch (transport) {
+    case Transport::None:
+      return os << "None";
+    case Transport::PeerMemory:
+      return os << "PeerMemory";
+    case Transport::Backend:
+      return os << "Backend";
+  }
+  TORCH_INTERNAL_ASSERT(false, "unknown transport");
+}
+
+double linkCost(LinkType link) {
+  // NVLink moves a few hundred GB/s, PCIe and InfiniBand a few tens, the
+  // network also paying for the staging through the NICs
+  switch (link) {
+    case LinkType::SameDevice:
+      return 0.0;
+    case LinkType::NVLink:
+      return 1.0;
+    case LinkType::PCIe:
+      return 8.0;
+    case LinkType::Network:
+      return 12.0;
+  }
+  TORCH_INTERNAL_ASSERT(false, "unknown link type");
+}
+
+Transport selectTransport(LinkType link, bool peer_outputs_enabled) {
+  if (link == LinkType::SameDevice) {
+    return Transport::None;
+  }
+  if (link == LinkType::NVLink && peer_outputs_enabled) {
+    return Transport::PeerMemory;
+  }
+  return Transport::Backend;
+}
+
+size_t localHostId() {
+  char hostname[256] = {};
+  gethostname(hostname, sizeof(hostname) - 1);
+  return std::hash<std::string>()(hostname);
+}
+
+Topology::Topology(std::vector<std::vector<LinkType>> links)
+    : links_(std::move(links)) {
+  for (const auto& row : links_) {
+    TORCH_CHECK(
+        row.size() == links_.size(), "The links must form a square matrix");
+  }
+}
+
+namespace {
+
+// Returns the index of the device of the given PCI location in this
+// process, or -1 if it is not visible
+int deviceIndexOf(int64_t domain, int64_t bus, int64_t device) {
+  char bus_id[32];
+  std::snprintf(
+      bus_id,
+      sizeof(bus_id),
+      "%04x:%02x:%02x.0",
+      (unsigned)domain,
+      (unsigned)bus,
+      (unsigned)device);
+  int index = -1;
+  if (cudaDeviceGetByPCIBusId(&index, bus_id) != cudaSuccess) {
+    // clear the error of a device that is not visible
+    (void)cudaGetLastError();
+    return -1;
+  }
+  return index;
+}
+
+} // namespace
+
+Topology Topology::discover(
+    const c10::intrusive_ptr<c10d::Backend>& process_group,
+    at::Device device) {
+  c10::cuda::CUDAGuard device_guard(device);
+  cudaDeviceProp prop;
+  CUDA_RT_SAFE_CALL(cudaGetDeviceProperties(&prop, device.index()));
+
+  // Every rank shares the node and the PCI location of its device
+  constexpr int64_t descriptor_size = 4;
+  auto local = at::tensor(
+                   {(int64_t)localHostId(),
+                    (int64_t)prop.pciDomainID,
+                    (int64_t)prop.pciBusID,
+                    (int64_t)prop.pciDeviceID},
+                   at::TensorOptions().dtype(at::kLong))
+                   .to(device);
+  const auto size = process_group->getSize();
+  auto all = at::empty({size, descriptor_size}, local.options());
+  process_group->_allgather_base(all, local)->wait();
+  auto descriptors = all.cpu();
+  auto descriptor = descriptors.accessor<int64_t, 2>();
+
+  std::vector<std::vector<LinkType>> links(
+      size, std::vector<LinkType>(size, LinkType::Network));
+  for (auto a : c10::irange(size)) {
+    for (auto b : c10::irange(size)) {
+      if (descriptor[a][0] != descriptor[b][0]) {
+        continue;
+      }
+      if (descriptor[a][1] == descriptor[b][1] &&
+          descriptor[a][2] == descriptor[b][2] &&
+          descriptor[a][3] == descriptor[b][3]) {
+        links[a][b] = LinkType::SameDevice;
+        continue;
+      }
+      // Devices this process doesn't see are conservatively connected by
+      // PCIe
+      links[a][b] = LinkType::PCIe;
+      auto index_a =
+          deviceIndexOf(descriptor[a][1], descriptor[a][2], descriptor[a][3]);
+      auto index_b =
+          deviceIndexOf(descriptor[b][1], descriptor[b][2], descriptor[b][3]);
+      if (index_a == -1 || index_b == -1) {
+        continue;
+      }
+      int access = 0;
+      int native_atomics = 0;
+      CUDA_RT_SAFE_CALL(cudaDeviceGetP2PAttribute(
+          &access, cudaDevP2PAttrAccessSupported, index_a, index_b));
+      CUDA_RT_SAFE_CALL(cudaDeviceGetP2PAttribute(
+          &native_atomics,
+          cudaDevP2PAttrNativeAtomicSupported,
+          index_a,
+          index_b));
+      if (access && native_atomics) {
+        links[a][b] = LinkType::NVLink;
+      }
+    }
+  }
+  return Topology(std::move(links));
+}
+
+std::string Topology::toString() const {
+  std::stringstream ss;
+  ss << "Topology {\n";
+  for (auto a : c10::irange(links_.size())) {
+    ss << "  rank " << a << ":";
+    for (auto link : links_[a]) {
+      ss << " " << link;
+    }
+    ss << "\n";
+  }
+  ss << "}";
+  return ss.str();
+}
+
+std::vector<ProcessRankType> placeClusters(
+    const MultiClusterFusion& fusion,
+    const Topology& topology,
+    const std::unordered_map<Val*, double>& bytes) {
+  const auto size = topology.size();
+
+  // Bytes sent from the clusters of each rank to the clusters of each other
+  // rank
+  std::vector<std::vector<double>> traffic(size, std::vector<double>(size));
+  auto a_dag = fusion.aggregateDag();
+  for (auto expr : StmtSort::getExprs(a_dag.get())) {
+    if (!expr->isA<SendRecv>()) {
+      continue;
+    }
+    auto sr = expr->as<SendRecv>();
+    auto sender = sr->in()->getCluster()->params().process_rank;
+    auto receiver = sr->out()->getCluster()->params().process_rank;
+    TORCH_CHECK(
+        sender < size && receiver < size,
+        "The clusters use more ranks than the topology has");
+    auto it = bytes.find(sr->in()->getOriginalVal());
+    traffic[sender][receiver] += it == bytes.end() ? 1.0 : it->second;
+  }
+
+  std::vector<ProcessRankType> placement(size);
+  std::iota(placement.begin(), placement.end(), 0);
+  auto cost = [&]() {
+    double total = 0.0;
+    for (auto a : c10::irange(size)) {
+      for (auto b : c10::irange(size)) {
+        if (traffic[a][b] > 0.0) {
+          total += traffic[a][b] *
+              linkCost(topology.link(placement[a], placement[b]));
+        }
+      }
+    }
+    return total;
+  };
+
+  auto best_cost = cost();
+  bool improved = true;
+  while (improved) {
+    improved = false;
+    for (auto a : c10::irange(size)) {
+      for (auto b : c10::irange(a + 1, size)) {
+        std::swap(placement[a], placement[b]);
+        auto new_cost = cost();
+        if (new_cost < best_cost) {
+          best_cost = new_cost;
+          improved = true;
+        } else {
+          std::swap(placement[a], placement[b]);
+        }
+      }
+    }
+  }
+  return placement;
+}
+
+} // namespace nvfuser
+
+#endif
@@ -0,0 +1,104 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#ifdef USE_DISTRIBUTED
+#pragma once
+
+#include <multidevice/multicluster_fusion.h>
+
+#include <c10/core/Device.h>
+#include <torch/csrc/distributed/c10d/Backend.hpp>
+
+namespace nvfuser {
+
+// Link between the devices of two ranks
+enum class LinkType {
+  // both ranks use the same device
+  SameDevice,
+  // devices of the same node with native peer atomics, which only NVLink
+  // provides
+  NVLink,
+  // other devices of the same node
+  PCIe,
+  // devices of different nodes
+  Network
+};
+
+TORCH_CUDA_CU_API std::ostream& operator<<(std::ostream& os, LinkType link);
+
+// Relative cost of moving a byte over a link, roughly the inverse of its
+// bandwidth
+TORCH_CUDA_CU_API double linkCost(LinkType link);
+
+// How a SendRecv moves its value between the devices of two ranks
+enum class Transport {
+  // the value stays on the device
+  None,
+  // the kernel of the sending cluster writes into the memory of the
+  // receiving process, see Note [ Peer outputs ]
+  PeerMemory,
+  // send and receive of the communication backend
+  Backend
+};
+
+TORCH_CUDA_CU_API std::ostream& operator<<(
+    std::ostream& os,
+    Transport transport);
+
+// Picks the transport of a SendRecv over `link`. Peer memory only pays off
+// over NVLink, kernels writing across PCIe are slower than the copies of the
+// backend.
+TORCH_CUDA_CU_API Transport
+selectTransport(LinkType link, bool peer_outputs_enabled);
+
+// Identifier of the node the process runs on
+TORCH_CUDA_CU_API size_t localHostId();
+
+// Links between the devices of the ranks of a process group
+class TORCH_CUDA_CU_API Topology {
+ public:
+  // links[a][b] is the link between ranks a and b
+  explicit Topology(std::vector<std::vector<LinkType>> links);
+
+  // Discovers the links between the devices of the ranks of the process
+  // group, each rank using `device`. Every rank of the group must call it.
+  static Topology discover(
+      const c10::intrusive_ptr<c10d::Backend>& process_group,
+      at::Device device);
+
+  int64_t size() const {
+    return (int64_t)links_.size();
+  }
+
+  LinkType link(ProcessRankType a, ProcessRankType b) const {
+    return links_.at(a).at(b);
+  }
+
+  std::string toString() const;
+
+ private:
+  std::vector<std::vector<LinkType>> links_;
+};
+
+// Returns the rank each rank of the clusters of `fusion` is best placed on,
+// i.e. placement[r] is the rank the clusters pinned to rank r should run on
+// to minimize the cost of the SendRecvs of the AggregateDag over the links
+// of `topology`. `bytes` estimates the size of the values sent, values
+// missing from it count as one byte. Apply the placement with
+// MultiClusterFusion::remapRanks.
+//
+// The placement is found by a local search swapping pairs of ranks, starting
+// from the placement of the user. Collectives span all the ranks, so their
+// cost doesn't depend on the placement.
+TORCH_CUDA_CU_API std::vector<ProcessRankType> placeClusters(
+    const MultiClusterFusion& fusion,
+    const Topology& topology,
+    const std::unordered_map<Val*, double>& bytes = {});
+
+} // namespace nvfuser
+
+#endif
@@ -8,6 +8,7 @@
 #include <ir_iostream.h>
 #include <ir_utils.h>
 #include <lower2device.h>
+#include <lower_divisible_split.h>
 #include <lower_utils.h>
 #include <non_divisible_split.h>
 
@@ -30,6 +31,14 @@ void NonDivisibleSplitInfo::build(Fusion* fusion) {
     current_tv_ = nullptr;
   }
 
+  // Assumed divisible splits are validated at run time, see
+  // Note [ Assumed divisible splits ]
+  for (auto split : getAssumedDivisibleSplits(fusion)) {
+    if (getMaybeNonDivisibleExtent(split) != nullptr) {
+      splits_to_validate_.insert(split);
+    }
+  }
+
   if (GpuLower::current() != nullptr) {
     removeRedundancy();
   }
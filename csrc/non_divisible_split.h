@@ -28,7 +28,9 @@ namespace nvfuser {
 //! predicating the input domain of the non-divisible split results in
 //! a vectoried operation is predicated out entirely since we do not
 //! generate a fall-back non-vectorized else path. Runtime check is
-//! done for those domains.
+//! done for those domains, as well as for the splits schedulers
+//! assume to be divisible, see Note [ Assumed divisible splits ] in
+//! lower_divisible_split.h
 class TORCH_CUDA_CU_API NonDivisibleSplitInfo : public IterVisitor {
  public:
   void build(Fusion* fusion);
@@ -236,6 +236,30 @@ TensorView* torch_gather(TensorView* inp, int dim, TensorView* index) {
   return out_tensor->as<TensorView>();
 }
 
+// Note [ Scatter outputs ]
+//
+// out = scatter(self, dim, index, src) is self with the elements of src
+// written to, or added to with scatter_add, the positions that index gives
+// along dim. Index and src have the same shape, which differs from the one of
+// self at most along dim, e.g. for the backward of an embedding,
+//
+//   T3[i0, i1] = index_add(T0[i2, i1], 0, T1[i0], T2[i0, i1])
+//
+// The output is iterated over like src, so its root domain is the one of src,
+// but it is allocated with the shape of self by inferAndAllocOutput and
+// FusionExecutor copies self into it before every launch, after which the
+// kernel only writes the scattered elements. Self itself is never read by the
+// kernel and must be an input of it that nothing else uses. Since only the
+// outputs of a kernel are initialized this way, the output of a scatter must
+// also be an output of its kernel that the kernel doesn't read, so fusions
+// consuming it are segmented after the scatter, see
+// rejectScheduleForSelectLikeOps. Like the lookup of torch_gather, the IDs of
+// self are not mapped to the ones of the output.
+//
+// ScatterOpType::Set leaves the element of a duplicated index to whichever
+// write comes last, ScatterOpType::Add sums all of them with the atomics of
+// runtime/scatter.cu.
+
 // torch.scatter torch.scatter_add
 TensorView* scatterOp(
     ScatterOpType type,
@@ -262,21 +286,30 @@ TensorView* scatterOp(
       self_dom.size(),
       " non-reduction dims.");
 
-  // The shape of output tensor is same as self tensor.
+  // The output is iterated over like src, but is allocated with the shape
+  // of self, see Note [ Scatter outputs ]
   std::vector<IterDomain*> out_domain;
-  for (const auto i : c10::irange(self_dom.size())) {
+  for (const auto i : c10::irange(src_dom.size())) {
     out_domain.push_back(
-        IterDomainBuilder(self_dom[i])
+        IterDomainBuilder(src_dom[i])
             .iter_type(
-                self_dom[i]->getIterType() == IterType::Iteration
+                src_dom[i]->getIterType() == IterType::Iteration
                     ? IterType::GatherScatter
-                    : self_dom[i]->getIterType())
+                    : src_dom[i]->getIterType())
             .build());
   }
 
+  // The extent of the scattered dimension is the one of src, so it and the
+  // dimensions outside of it are strided by the actual strides of the output
+  auto out_contiguity = TensorDomain::getContiguityFilledWith(out_domain, true);
+  for (const auto i : c10::irange(dim + 1)) {
+    if (out_contiguity[i].has_value()) {
+      out_contiguity[i] = false;
+    }
+  }
+
   TensorView* out_tensor = IrBuilder::create<TensorView>(
-      IrBuilder::create<TensorDomain>(
-          out_domain, TensorDomain::getContiguityFilledWith(out_domain, true)),
+      IrBuilder::create<TensorDomain>(out_domain, out_contiguity),
       self->getDataType().value());
 
   IrBuilder::create<ScatterOp>(
@@ -292,8 +325,56 @@ TensorView* scatter(
   return scatterOp(ScatterOpType::Set, self, dim, index, src);
 }
 
+TensorView* scatter_add(
+    TensorView* self,
+    int dim,
+    TensorView* index,
+    TensorView* src) {
+  return scatterOp(ScatterOpType::Add, self, dim, index, src);
+}
+
+TensorView* index_add(
+    TensorView* self,
+    int dim,
+    TensorView* index,
+    TensorView* src) {
+  auto src_dom = TensorDomain::noReductions(src->getMaybeRFactorDomain());
+  TORCH_CHECK(
+      TensorDomain::noReductions(index->getMaybeRFactorDomain()).size() == 1,
+      "index_add requires a 1-D index tensor.");
+  if (dim < 0) {
+    dim += src_dom.size();
+  }
+  TORCH_CHECK(
+      dim >= 0 && dim < (int)src_dom.size(),
+      "index_add on invalid axis, received: ",
+      dim,
+      " however tensor view only has ",
+      src_dom.size(),
+      " non-reduction dims.");
+
+  // Every element of a slice of src is added to the slice selected by its
+  // index, which is the same index along all the other dimensions
+  std::vector<bool> is_broadcast_dim(src_dom.size(), true);
+  is_broadcast_dim[dim] = false;
+  auto expanded_index = expand_as(broadcast(index, is_broadcast_dim), src);
+  return scatterOp(ScatterOpType::Add, self, dim, expanded_index, src);
+}
+
 // TENSOR FACTORIES
-TensorView* rand(const std::vector<Val*>& shape, DataType dtype) {
+TensorView* rand(
+    const std::vector<Val*>& shape,
+    DataType dtype,
+    Val* philox_seed,
+    Val* philox_offset) {
+  TORCH_CHECK(
+      (philox_seed == nullptr) == (philox_offset == nullptr),
+      "Philox seed and offset must be given together");
+  TORCH_CHECK(
+      philox_seed == nullptr ||
+          (isIntegralType(philox_seed->dtype()) &&
+           isIntegralType(philox_offset->dtype())),
+      "Philox seed and offset must be integers");
   auto n = shape.size();
   auto out = TensorViewBuilder()
                  .ndims(n)
@@ -301,7 +382,15 @@ TensorView* rand(const std::vector<Val*>& shape, DataType dtype) {
                  .contiguity(true)
                  .shape(shape)
                  .build();
-  IrBuilder::create<RNGOp>(RNGOpType::Uniform, out, dtype);
+  IrBuilder::create<RNGOp>(
+      RNGOpType::Uniform,
+      out,
+      dtype,
+      std::vector<Val*>{},
+      0,
+      nullptr,
+      philox_seed,
+      philox_offset);
   return out;
 }
 
@@ -388,6 +477,20 @@ Val* rand_like(Val* v) {
   return rand_like(v->as<TensorView>());
 }
 
+TensorView* rand_like(TensorView* tv, Val* philox_seed, Val* philox_offset) {
+  TORCH_CHECK(
+      isFloatingPointType(tv->dtype()),
+      "input must have floating point type, but got ",
+      tv->dtype());
+  std::vector<Val*> shape;
+  auto dom = TensorDomain::noReductions(tv->getMaybeRFactorDomain());
+  shape.reserve(dom.size());
+  for (auto id : dom) {
+    shape.emplace_back(id->getMaybeExpandedExtent());
+  }
+  return rand(shape, tv->dtype(), philox_seed, philox_offset);
+}
+
 TensorView* full(
     const std::vector<Val*>& shape,
     Val* fill_value,
@@ -1355,6 +1458,51 @@ TensorView* sum(
   return reductionOp(BinaryOpType::Add, axes, init, v1, keep_dim, dtype);
 }
 
+// Note [ Accumulation policies ]
+//
+// sum accumulates in the dtype it's given, or in its input's, and
+// composites usually cast half and bfloat16 inputs to float first so that
+// rounding errors don't pile up along the reduction. An AccumulationPolicy
+// picks the accumulator and casts the result back to the input's dtype:
+//
+// - Native accumulates half and bfloat16 in their own precision with the
+//   native instructions of fp16_support.cu and bf16_support.cu, halving
+//   the registers and shared memory taken by the partial results. Only
+//   meant for short reductions or inputs whose partial sums are exact.
+// - Float is the usual accumulation of reduced precision inputs in float.
+// - Double accumulates floating point inputs in double, which is how large
+//   float sums, e.g., of loss scaling, are compensated. Up to 2^29 elements
+//   it's about as accurate as Kahan summation of floats, without the block
+//   and grid reductions having to carry a compensation term along.
+//
+// The schedulers see the accumulator through the dtype of the reduction
+// output, e.g., when sizing persistent buffers and shared memory.
+TensorView* sum(
+    TensorView* v1,
+    const std::vector<int>& axes,
+    AccumulationPolicy policy,
+    bool keep_dim) {
+  const auto dtype = v1->getDataType().value();
+  if (!isFloatingPointType(dtype)) {
+    return sum(v1, axes, keep_dim);
+  }
+  auto acc_dtype = dtype;
+  switch (policy) {
+    case AccumulationPolicy::Native:
+      break;
+    case AccumulationPolicy::Float:
+      if (dtype == DataType::Half || dtype == DataType::BFloat16) {
+        acc_dtype = DataType::Float;
+      }
+      break;
+    case AccumulationPolicy::Double:
+      acc_dtype = DataType::Double;
+      break;
+  }
+  auto out = sum(v1, axes, keep_dim, acc_dtype);
+  return acc_dtype == dtype ? out : castOp(dtype, out);
+}
+
 TensorView* prod(
     TensorView* v1,
     const std::vector<int>& axes,
@@ -1402,6 +1550,126 @@ TensorView* min(
   return reductionOp(BinaryOpType::Min, axes, init, v1, keep_dim);
 }
 
+// Note [ Scan ops ]
+//
+// out = scanOp(op, dim, init, in) is the inclusive prefix scan of in along
+// dim, e.g. for cumsum,
+//
+//   T1[i0, i1] = scan(T0[i0, i1], op = add, initial value = 0, dim = 1)
+//   T1[i, j] = T0[i, 0] + ... + T0[i, j]
+//
+// The output has the same domains as the input and they are mapped to each
+// other like the ones of a pointwise op, so scans are scheduled and inlined
+// together with their pointwise producers and consumers.
+//
+// A scan is computed serially by a thread along the scanned row, in the
+// order of the loops of the axes derived from dim, which
+// validateScanOps requires to be serial and to be inlined in the
+// consumers of the output. The output is then a single register per thread
+// that carries the prefix of the row from one iteration to the next:
+// getAllocInformation places its allocation outside of the scanned loops,
+// while its index stays zero within them, and the kernel computes
+//
+//   T1[0] = (is_first ? 0 : T1[0]) + T0[0];
+//
+// where is_first is true at the first element of the row, see
+// IndexLowering::handle(const ScanOp*). The scan scheduler, see
+// Note [ Scan scheduling ], puts the scanned rows on threads.
+//
+// Half and bfloat16 rows are summed and multiplied in float, so that the
+// rounding errors don't accumulate along the row, and integral and boolean
+// rows in int64 like sum and prod.
+
+TensorView* scanOp(
+    BinaryOpType scan_op_type,
+    int dim,
+    Val* init,
+    TensorView* v1) {
+  TORCH_CHECK(
+      init->isConstScalar(),
+      "Cannot create a scan operation with a non-constant initial value.");
+
+  const auto ndims =
+      (int)TensorDomain::noReductions(v1->getMaybeRFactorDomain()).size();
+  // The scan of a 0-dim tensor is the tensor itself
+  if (ndims == 0) {
+    return set(v1);
+  }
+  if (dim < 0) {
+    dim += ndims;
+  }
+  TORCH_CHECK(
+      dim >= 0 && dim < ndims,
+      "Scan on invalid axis, received: ",
+      dim,
+      " however tensor view only has ",
+      ndims,
+      " non-reduction dims.");
+
+  auto out = ops::newValLike(v1, v1->getDataType().value())->as<TensorView>();
+  IrBuilder::create<ScanOp>(scan_op_type, init, out, v1, dim);
+  return out;
+}
+
+namespace {
+
+// Scans half and bfloat16 rows in float, see Note [ Scan ops ]
+TensorView* promotedScanOp(
+    BinaryOpType scan_op_type,
+    int dim,
+    TensorView* v1,
+    DataType dtype) {
+  if (dtype == DataType::Null) {
+    auto initial_v1_dtype = v1->getDataType().value();
+    if (isBooleanType(initial_v1_dtype) || isIntegralType(initial_v1_dtype)) {
+      dtype = DataType::Int;
+    }
+  }
+  if (dtype != DataType::Null) {
+    v1 = optionalCastStrict(dtype, v1)->as<TensorView>();
+  }
+
+  const auto out_dtype = v1->getDataType().value();
+  const bool is_reduced_precision =
+      out_dtype == DataType::Half || out_dtype == DataType::BFloat16;
+  if (is_reduced_precision) {
+    v1 = castOp(DataType::Float, v1);
+  }
+  auto init = scan_op_type == BinaryOpType::Add
+      ? FusionGuard::getCurFusion()->zeroVal(v1->getDataType().value())
+      : FusionGuard::getCurFusion()->oneVal(v1->getDataType().value());
+  auto out = scanOp(scan_op_type, dim, init, v1);
+  return is_reduced_precision ? castOp(out_dtype, out) : out;
+}
+
+} // namespace
+
+TensorView* cumsum(
+    TensorView* v1,
+    int dim,
+    DataType dtype /* DataType::Null */) {
+  return promotedScanOp(BinaryOpType::Add, dim, v1, dtype);
+}
+
+TensorView* cumprod(
+    TensorView* v1,
+    int dim,
+    DataType dtype /* DataType::Null */) {
+  return promotedScanOp(BinaryOpType::Mul, dim, v1, dtype);
+}
+
+TensorView* cummax(TensorView* v1, int dim) {
+  Val* init = ops::getMinimumValue(v1->getDataType().value());
+  TORCH_CHECK(init != nullptr, "Missing initial value");
+  return scanOp(BinaryOpType::Max, dim, init, v1);
+}
+
+TensorView* cummin(TensorView* v1, int dim) {
+  Val* init = ops::getMaximumValue(v1->getDataType().value());
+  TORCH_CHECK(init != nullptr, "Missing initial value");
+  return scanOp(BinaryOpType::Min, dim, init, v1);
+}
+
 TensorView* broadcast(
     TensorView* inp,
     const std::vector<bool>& is_broadcast_dim) {
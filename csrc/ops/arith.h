@@ -150,11 +150,31 @@ TORCH_CUDA_CU_API WelfordResult WelfordRaw(
 TORCH_CUDA_CU_API TensorView* select(TensorView* tv, int dim, Val* index);
 
 // RNG OPERATIONS
+
+// Note [ Explicit Philox seed and offset ]
+//
+// By default every RNGOp of a fusion draws from the global CUDA generator:
+// the executor reserves a fresh Philox offset per launch and each op gets its
+// own slice of it (see assignRNGOffset). That makes the values unreachable
+// from any other fusion. Passing a seed and an offset instead pins the
+// stream: element i of the output is always produced by
+// philox(seed, i / 4, offset / 4), independent of the schedule, the launch
+// and the kernel the op lands in. A backward fusion can then recompute
+// exactly the random numbers the forward fusion used from two scalars rather
+// than keeping a tensor of them alive, which is what the dropout overloads in
+// composite.h do. Callers own the offset bookkeeping: two ops given the same
+// seed and offset produce the same values.
 TORCH_CUDA_CU_API TensorView* rand(
     const std::vector<Val*>& shape,
-    DataType dtype);
+    DataType dtype,
+    Val* philox_seed = nullptr,
+    Val* philox_offset = nullptr);
 TORCH_CUDA_CU_API Val* rand_like(Val*);
 TORCH_CUDA_CU_API TensorView* rand_like(TensorView*);
+TORCH_CUDA_CU_API TensorView* rand_like(
+    TensorView*,
+    Val* philox_seed,
+    Val* philox_offset);
 TORCH_CUDA_CU_API TensorView* randn(
     const std::vector<Val*>& shape,
     DataType dtype);
@@ -521,6 +541,23 @@ TORCH_CUDA_CU_API TensorView* sum(
     bool keep_dim = false,
     DataType dtype = DataType::Null);
 
+//! Precision a sum accumulates in, see Note [ Accumulation policies ]
+enum class AccumulationPolicy {
+  //! In the precision of the input, e.g., half for half inputs
+  Native,
+  //! In float for half and bfloat16 inputs, natively otherwise
+  Float,
+  //! In double for floating point inputs
+  Double
+};
+
+//! Sum accumulating as the policy says, the result has the dtype of v1
+TORCH_CUDA_CU_API TensorView* sum(
+    TensorView* v1,
+    const std::vector<int>& reduction_axes,
+    AccumulationPolicy policy,
+    bool keep_dim = false);
+
 TORCH_CUDA_CU_API TensorView* prod(
     TensorView* v1,
     const std::vector<int>& reduction_axes,
@@ -539,6 +576,29 @@ TORCH_CUDA_CU_API TensorView* min(
     bool keep_dim = false,
     DataType dtype = DataType::Null);
 
+// SCAN OPERATIONS
+// Inclusive prefix scan of v1 along dim with the binary op scan_op_type,
+// starting every row from init. See Note [ Scan ops ]
+TORCH_CUDA_CU_API TensorView* scanOp(
+    BinaryOpType scan_op_type,
+    int dim,
+    Val* init,
+    TensorView* v1);
+
+TORCH_CUDA_CU_API TensorView* cumsum(
+    TensorView* v1,
+    int dim,
+    DataType dtype = DataType::Null);
+
+TORCH_CUDA_CU_API TensorView* cumprod(
+    TensorView* v1,
+    int dim,
+    DataType dtype = DataType::Null);
+
+TORCH_CUDA_CU_API TensorView* cummax(TensorView* v1, int dim);
+
+TORCH_CUDA_CU_API TensorView* cummin(TensorView* v1, int dim);
+
 // COMPOUND OPERATIONS
 // add_alpha
 TORCH_CUDA_CU_API Val* add_alpha(Val* v1, Val* v2, Val* s);
@@ -593,6 +653,18 @@ TORCH_CUDA_CU_API TensorView* scatter(
     int dim,
     TensorView* index,
     TensorView* src);
+// torch.scatter_add
+TORCH_CUDA_CU_API TensorView* scatter_add(
+    TensorView* self,
+    int dim,
+    TensorView* index,
+    TensorView* src);
+// torch.index_add, with a 1-D index of the slices of src along dim
+TORCH_CUDA_CU_API TensorView* index_add(
+    TensorView* self,
+    int dim,
+    TensorView* index,
+    TensorView* src);
 
 // addcmul
 TORCH_CUDA_CU_API Val* addcmul(Val* v1, Val* v2, Val* v3, Val* s);
@@ -6,10 +6,16 @@
  */
 // clang-format on
 #include <ir_builder.h>
+#include <ops/alias.h>
 #include <ops/arith.h>
 #include <ops/composite.h>
+#include <ops/utils.h>
 #include <transform_view.h>
 
+#include <c10/util/irange.h>
+
+#include <limits>
+
 namespace nvfuser {
 
 ForwardDropoutResult dropout(TensorView* x, Val* prob) {
@@ -53,6 +59,86 @@ TensorView* dropout_backward(TensorView* dy, TensorView* mask, Val* scale) {
   return dx;
 }
 
+ForwardDropoutResult dropout(
+    TensorView* x,
+    Val* prob,
+    Val* scale,
+    Val* philox_seed,
+    Val* philox_offset) {
+  TORCH_INTERNAL_ASSERT(x != nullptr, "Input is invalid.");
+  TORCH_INTERNAL_ASSERT(
+      prob != nullptr && prob->getDataType().has_value() &&
+          prob->getDataType().value() == DataType::Double,
+      "Probability is not a valid Double.");
+  TORCH_INTERNAL_ASSERT(
+      scale != nullptr && scale->getDataType().has_value() &&
+          scale->getDataType().value() == DataType::Double,
+      "Scale is not a valid Double.");
+
+  auto rand_vals = rand_like(x, philox_seed, philox_offset);
+  auto mask = lt(rand_vals, prob);
+  auto apply_mask = mul(x, mask);
+  auto y = mul(apply_mask, scale);
+
+  return {y, mask};
+}
+
+TensorView* dropout_backward(
+    TensorView* dy,
+    Val* prob,
+    Val* scale,
+    Val* philox_seed,
+    Val* philox_offset) {
+  TORCH_INTERNAL_ASSERT(dy != nullptr, "Grad Output is invalid.");
+  TORCH_INTERNAL_ASSERT(
+      prob != nullptr && prob->getDataType().has_value() &&
+          prob->getDataType().value() == DataType::Double,
+      "Probability is not a valid Double.");
+  TORCH_INTERNAL_ASSERT(
+      scale != nullptr && scale->getDataType().has_value() &&
+          scale->getDataType().value() == DataType::Double,
+      "Scale is not a valid Double.");
+
+  // Same shape and dtype as the forward input, hence the same random numbers
+  auto rand_vals = rand_like(dy, philox_seed, philox_offset);
+  auto mask = lt(rand_vals, prob);
+  return dropout_backward(dy, mask, scale);
+}
+
+TensorView* stochastic_round_cast(
+    TensorView* x,
+    DataType dtype,
+    Val* philox_seed,
+    Val* philox_offset) {
+  TORCH_INTERNAL_ASSERT(x != nullptr, "Input is invalid.");
+  TORCH_CHECK(
+      dtype == DataType::BFloat16,
+      "Stochastic rounding is only supported for casting to BFloat16, but got ",
+      dtype);
+  TORCH_CHECK(
+      isFloatingPointType(x->dtype()) && !isComplexType(x->dtype()),
+      "Stochastic rounding requires a real floating point input, but got ",
+      x->dtype());
+
+  // BFloat16 is the upper half of Float, so adding 16 uniformly random bits
+  // to the lower half and truncating it rounds up with probability
+  // proportional to the truncated fraction. The final cast is exact.
+  auto x_float = x->dtype() == DataType::Float ? x : castOp(DataType::Float, x);
+  auto rand_vals = philox_seed == nullptr
+      ? rand_like(x_float)
+      : rand_like(x_float, philox_seed, philox_offset);
+  auto noise = castOp(
+      DataType::Int32,
+      mul(rand_vals, IrBuilder::create<Double>(x->container(), 65536.)));
+  auto bits = bitCastOp(DataType::Int32, x_float);
+  auto rounded_bits = bitwise_and(
+      add(bits, noise), IrBuilder::create<Int>(x->container(), -65536));
+  auto rounded = bitCastOp(DataType::Float, rounded_bits);
+  // Infinities and NaNs must not be perturbed into other values
+  auto y = where(isfinite(x_float), rounded, x_float);
+  return castOp(dtype, y);
+}
+
 LstmResult lstm(
     TensorView* prev_cell,
     TensorView* in_x,
@@ -77,6 +163,86 @@ LstmResult lstm(
   return {cell, hidden};
 }
 
+// Note [ Fused LSTM cells ]
+//
+// The recurrent projection of an LSTM timestep, prev_hidden times the
+// transposed weight_hh, is usually run as a separate GEMM followed by a
+// pointwise kernel for the cell math, i.e., two launches per timestep and a
+// round trip of the [B, 4H] gates through global memory. With the small
+// batches of streaming inference, the projection is a handful of
+// matrix-vector products bound by reading the weights, which tensor cores
+// don't speed up. lstm_cell defines it instead as a sum over H_in of
+// broadcast products, one per gate:
+//
+//   gate[B, H] = gate_x[B, H] + sum(prev_hidden[B, 1, H_in] * w[1, H, H_in])
+//
+// The four sums have the same shape and the cell math only uses their
+// outputs, so the whole timestep is scheduled by the reduction scheduler as
+// a single kernel, with the cell math fused as its epilogue.
+//
+// The timesteps of a sequence still run as one kernel each: a persistent
+// kernel over the whole sequence needs a grid-wide dependency between
+// consecutive timesteps, which fusions can't express.
+
+namespace {
+
+TensorView* toFloat(TensorView* x) {
+  const auto dtype = x->getDataType().value();
+  TORCH_CHECK(
+      dtype == DataType::Float || dtype == DataType::Half ||
+          dtype == DataType::BFloat16,
+      "lstm_cell only supports Float, Half and BFloat16 inputs, got ",
+      dtype);
+  return dtype == DataType::Float ? x : castOp(DataType::Float, x);
+}
+
+// hidden [B, H_in] times weight [H, H_in] transposed
+TensorView* recurrentProjection(TensorView* hidden, TensorView* weight) {
+  TORCH_INTERNAL_ASSERT(weight != nullptr, "Recurrent weight is invalid");
+  TORCH_CHECK(
+      TensorDomain::noReductions(weight->getMaybeRFactorDomain()).size() == 2,
+      "Recurrent weights must be 2D, [H, H_in]");
+  auto product = mul(
+      broadcast(hidden, {false, true, false}),
+      broadcast(toFloat(weight), {true, false, false}));
+  return sum(product, {2});
+}
+
+} // namespace
+
+LstmResult lstm_cell(
+    TensorView* prev_hidden,
+    TensorView* prev_cell,
+    TensorView* in_x,
+    TensorView* forget_x,
+    TensorView* cell_x,
+    TensorView* out_x,
+    TensorView* in_w,
+    TensorView* forget_w,
+    TensorView* cell_w,
+    TensorView* out_w) {
+  TORCH_INTERNAL_ASSERT(
+      prev_hidden != nullptr, "Previous hidden state is invalid.");
+  TORCH_INTERNAL_ASSERT(
+      prev_cell != nullptr, "Previous cell state is invalid.");
+  const auto hidden_ndims =
+      TensorDomain::noReductions(prev_hidden->getMaybeRFactorDomain()).size();
+  TORCH_CHECK(hidden_ndims == 2, "Hidden state must be 2D, [B, H_in]");
+
+  auto hidden = toFloat(prev_hidden);
+  auto gate = [&](TensorView* x, TensorView* w) {
+    TORCH_INTERNAL_ASSERT(x != nullptr, "Gate input is invalid");
+    return add(toFloat(x), recurrentProjection(hidden, w));
+  };
+
+  return lstm(
+      toFloat(prev_cell),
+      gate(in_x, in_w),
+      gate(forget_x, forget_w),
+      gate(cell_x, cell_w),
+      gate(out_x, out_w));
+}
+
 namespace {
 template <typename T>
 T* sign(T* x) {
@@ -227,4 +393,646 @@ TensorView* view_as_real(TensorView* x) {
   return viewAsScalar(tv_vector);
 }
 
+
+// Note [ Packed index reductions ]
+//
+// argmax, argmin and topk reduce a value together with its position along
+// the reduced dimension. Instead of a reduction of (value, index) tuples,
+// every element is packed into a single Int,
+//
+//   packed = key * 2^32 + (2^32 - 1 - index)
+//
+// where key is a 32-bit integer ordered like the value: Int32 values are
+// their own keys, and floats, including Half and BFloat16 ones upcast
+// exactly to Float, are bit cast to Int32 with the magnitude bits of
+// negative values flipped. The key is complemented to find the smallest
+// value, and NaNs get the largest key, as they win both in eager mode. A
+// plain max reduction of the packed values then finds the largest key, and
+// the lowest position among equal keys, so it is scheduled, fused and
+// lowered like any other reduction, including block, grid and persistent
+// ones. The position is in the low 32 bits of the result and the value is
+// decoded from the high ones.
+//
+// topk takes k such maxima in a row, each after replacing the previous one
+// by the smallest Int. Packed values are distinct, so exactly one element
+// is replaced each time. The normalization scheduler keeps the k reductions
+// of a row in registers like the ones of a softmax.
+//
+// The reduced dimension must be shorter than 2^32 elements.
+
+namespace {
+
+constexpr int64_t kIndexMask = 0xffffffff;
+constexpr int64_t kMagnitudeMask = 0x7fffffff;
+
+Val* intVal(int64_t value) {
+  return IrBuilder::create<Int>(value);
+}
+
+TensorView* packWithIndex(TensorView* x, int dim, bool largest) {
+  const auto dtype = x->getDataType().value();
+  TensorView* key = nullptr;
+  if (dtype == DataType::Int32) {
+    key = castOp(DataType::Int, x);
+  } else {
+    TORCH_CHECK(
+        dtype == DataType::Float || dtype == DataType::Half ||
+            dtype == DataType::BFloat16,
+        "Index reductions only support Float, Half, BFloat16 and Int32 ",
+        "inputs, got ",
+        dtype);
+    auto x_float = dtype == DataType::Float ? x : castOp(DataType::Float, x);
+    auto bits = castOp(DataType::Int, bitCastOp(DataType::Int32, x_float));
+    key = where(
+        ge(bits, intVal(0)), bits, bitwise_xor(bits, intVal(kMagnitudeMask)));
+  }
+  if (!largest) {
+    key = bitwise_not(key);
+  }
+  if (dtype != DataType::Int32) {
+    key = where(isnan(x), intVal(std::numeric_limits<int32_t>::max()), key);
+  }
+
+  auto domain = TensorDomain::noReductions(x->getMaybeRFactorDomain());
+  std::vector<bool> is_broadcast_dim(domain.size(), true);
+  is_broadcast_dim.at(dim) = false;
+  auto index = broadcast(
+      iota(domain.at(dim)->extent(), nullptr, nullptr, DataType::Int),
+      is_broadcast_dim);
+  return add(mul(key, intVal(kIndexMask + 1)), sub(intVal(kIndexMask), index));
+}
+
+TensorView* unpackIndex(TensorView* packed) {
+  return sub(intVal(kIndexMask), bitwise_and(packed, intVal(kIndexMask)));
+}
+
+TensorView* unpackValue(TensorView* packed, DataType dtype, bool largest) {
+  auto key = bitwise_right_shift(packed, intVal(32));
+  if (!largest) {
+    key = bitwise_not(key);
+  }
+  if (dtype == DataType::Int32) {
+    return castOp(DataType::Int32, key);
+  }
+  auto bits = where(
+      ge(key, intVal(0)), key, bitwise_xor(key, intVal(kMagnitudeMask)));
+  auto value = bitCastOp(DataType::Float, castOp(DataType::Int32, bits));
+  return dtype == DataType::Float ? value : castOp(dtype, value);
+}
+
+int normalizeDim(TensorView* x, int dim) {
+  const auto ndims =
+      (int)TensorDomain::noReductions(x->getMaybeRFactorDomain()).size();
+  if (dim < 0) {
+    dim += ndims;
+  }
+  TORCH_CHECK(dim >= 0 && dim < ndims, "Invalid dimension to reduce: ", dim);
+  return dim;
+}
+
+TensorView* indexReduction(
+    TensorView* x,
+    int dim,
+    bool keep_dim,
+    bool largest) {
+  TORCH_INTERNAL_ASSERT(x != nullptr, "Input is invalid.");
+  dim = normalizeDim(x, dim);
+  auto packed = packWithIndex(x, dim, largest);
+  return unpackIndex(max(packed, {dim}, keep_dim));
+}
+
+} // namespace
+
+TensorView* argmax(TensorView* x, int dim, bool keep_dim) {
+  return indexReduction(x, dim, keep_dim, true);
+}
+
+TensorView* argmin(TensorView* x, int dim, bool keep_dim) {
+  return indexReduction(x, dim, keep_dim, false);
+}
+
+TopKResult topk(TensorView* x, int64_t k, int dim, bool largest) {
+  TORCH_INTERNAL_ASSERT(x != nullptr, "Input is invalid.");
+  TORCH_CHECK(k > 0, "topk needs a positive k, got ", k);
+  dim = normalizeDim(x, dim);
+  const auto dtype = x->getDataType().value();
+  auto packed = packWithIndex(x, dim, largest);
+
+  // Positions of the k results along dim
+  auto ndims = TensorDomain::noReductions(x->getMaybeRFactorDomain()).size();
+  std::vector<bool> is_broadcast_dim(ndims, true);
+  is_broadcast_dim.at(dim) = false;
+  auto position = broadcast(
+      iota(intVal(k), nullptr, nullptr, DataType::Int), is_broadcast_dim);
+
+  TensorView* topk_packed = nullptr;
+  for (const auto i : c10::irange(k)) {
+    auto best = max(packed, {dim}, true);
+    if (i + 1 < k) {
+      packed = where(
+          eq(packed, best), ops::getMinimumValue(DataType::Int), packed);
+    }
+    topk_packed = topk_packed == nullptr
+        ? where(eq(position, intVal(i)), best, intVal(0))
+        : where(eq(position, intVal(i)), best, topk_packed);
+  }
+  return {unpackValue(topk_packed, dtype, largest), unpackIndex(topk_packed)};
+}
+
+// Note [ Fused cross-entropy ]
+//
+// log_softmax followed by torch_gather of the labels writes the
+// log-probabilities of every class to global memory only to read one per
+// row back. cross_entropy instead computes, along the classes of a row,
+//
+//   m = max(x)
+//   loss = log(sum(exp(x - m))) - sum(where(class == label, x - m, 0))
+//
+// so the logit of the label is picked up by a reduction alongside the sum
+// of the exponentials rather than by a gather. All three reductions are
+// along the same dimension, which the normalization scheduler computes in a
+// single kernel reading each row once while it fits on chip, and otherwise
+// the segmenter splits off the max, so that the logits are streamed twice
+// and nothing of the size of the logits is written. The log-sum-exp of the
+// rows is returned for cross_entropy_backward, which is then a single
+// pointwise pass,
+//
+//   dx = (exp(x - lse) - (class == label)) * dloss
+//
+// Half and BFloat16 logits are computed in Float.
+
+namespace {
+
+// Whether each class of logits is the label of its row
+TensorView* isLabel(TensorView* logits, TensorView* labels) {
+  auto domain = TensorDomain::noReductions(logits->getMaybeRFactorDomain());
+  const auto ndims = domain.size();
+  TORCH_CHECK(ndims > 0, "Cross-entropy of a 0-dim tensor");
+  TORCH_CHECK(
+      TensorDomain::noReductions(labels->getMaybeRFactorDomain()).size() + 1 ==
+          ndims,
+      "Expected a label for each row of the logits");
+  TORCH_CHECK(
+      isIntegralType(labels->getDataType().value()),
+      "Labels must be integers, got ",
+      labels->getDataType().value());
+
+  std::vector<bool> is_row_dim(ndims, true);
+  is_row_dim.back() = false;
+  std::vector<bool> is_class_dim(ndims, false);
+  is_class_dim.back() = true;
+  auto classes = broadcast(
+      iota(domain.back()->extent(), nullptr, nullptr, DataType::Int),
+      is_row_dim);
+  return eq(classes, broadcast(labels, is_class_dim));
+}
+
+TensorView* toFloat(TensorView* x) {
+  const auto dtype = x->getDataType().value();
+  TORCH_CHECK(
+      dtype == DataType::Float || dtype == DataType::Half ||
+          dtype == DataType::BFloat16,
+      "Cross-entropy only supports Float, Half and BFloat16 logits, got ",
+      dtype);
+  return dtype == DataType::Float ? x : castOp(DataType::Float, x);
+}
+
+} // namespace
+
+CrossEntropyResult cross_entropy(
+    TensorView* logits,
+    TensorView* labels,
+    int64_t ignore_index) {
+  TORCH_INTERNAL_ASSERT(
+      logits != nullptr && labels != nullptr, "Input is invalid.");
+  auto is_label = isLabel(logits, labels);
+  auto x = toFloat(logits);
+  const auto ndims =
+      TensorDomain::noReductions(x->getMaybeRFactorDomain()).size();
+  const int dim = (int)ndims - 1;
+  std::vector<bool> is_class_dim(ndims, false);
+  is_class_dim.back() = true;
+
+  auto max_val = max(x, {dim});
+  auto x_max_sub = sub(x, broadcast(max_val, is_class_dim));
+  auto log_sum_exp = log(sum(exp(x_max_sub), {dim}));
+  auto label_val = sum(
+      where(is_label, x_max_sub, IrBuilder::create<Double>(0)), {dim});
+  auto loss = where(
+      eq(labels, IrBuilder::create<Int>(ignore_index)),
+      IrBuilder::create<Double>(0),
+      sub(log_sum_exp, label_val));
+  return {loss, add(log_sum_exp, max_val)};
+}
+
+TensorView* cross_entropy_backward(
+    TensorView* dloss,
+    TensorView* logits,
+    TensorView* labels,
+    TensorView* log_sum_exp,
+    int64_t ignore_index) {
+  TORCH_INTERNAL_ASSERT(
+      dloss != nullptr && logits != nullptr && labels != nullptr &&
+          log_sum_exp != nullptr,
+      "Input is invalid.");
+  auto is_label = isLabel(logits, labels);
+  auto x = toFloat(logits);
+  std::vector<bool> is_class_dim(
+      TensorDomain::noReductions(x->getMaybeRFactorDomain()).size(), false);
+  is_class_dim.back() = true;
+
+  auto prob = exp(sub(x, broadcast(log_sum_exp, is_class_dim)));
+  auto grad = where(is_label, sub(prob, IrBuilder::create<Double>(1)), prob);
+  auto row_grad = where(
+      eq(labels, IrBuilder::create<Int>(ignore_index)),
+      IrBuilder::create<Double>(0),
+      dloss);
+  auto dx = mul(grad, broadcast(row_grad, is_class_dim));
+  return castOp(logits->getDataType().value(), dx);
+}
+
+// Note [ Quantization ]
+//
+// Quantized tensors are Int8 or UInt8 tensors of integers of up to 8 bits,
+// with the affine mapping
+//
+//   q = clamp(round(x / scale) + zero_point, qmin, qmax)
+//   x = (q - zero_point) * scale
+//
+// computed in Float. The scales and zero points are scalars for a
+// per-tensor quantization, or tensors broadcast along the other dimensions
+// of x per channel, or per group once the grouped dimension of x is viewed
+// as [groups, group_size]. Either way they are plain pointwise ops, so a
+// dequantization is fused with its consumers, and with the loads of the
+// quantized tensor vectorized, by any scheduler.
+//
+// There is no 4-bit data type. 4-bit integers are stored two per UInt8
+// byte, the first of a pair in the low nibble, and unpacked with shifts and
+// masks of the bytes broadcast along a new dimension of the pairs,
+//
+//   q[..., i, j] = (packed[..., i] >> 4 * j) & 0xf
+//
+// sign extended with (q ^ 8) - 8. Loads of the packed bytes are vectorized
+// like those of any UInt8 input, and the N pairs of a row are flattened
+// back into its 2 * N integers with flatten. Packing is a sum of the two
+// shifted nibbles of a pair.
+
+namespace {
+
+// Smallest and largest num_bits integers stored as dtype
+std::pair<int64_t, int64_t> quantizedRange(DataType dtype, int64_t num_bits) {
+  TORCH_CHECK(
+      dtype == DataType::Int8 || dtype == DataType::UInt8,
+      "Quantized tensors are Int8 or UInt8 tensors, got ",
+      dtype);
+  TORCH_CHECK(
+      num_bits > 0 && num_bits <= 8,
+      "Quantized integers have 1 to 8 bits, got ",
+      num_bits);
+  const int64_t num_values = (int64_t)1 << num_bits;
+  if (dtype == DataType::Int8) {
+    return {-num_values / 2, num_values / 2 - 1};
+  }
+  return {0, num_values - 1};
+}
+
+TensorView* maybeCastToFloat(TensorView* x) {
+  return x->getDataType().value() == DataType::Float
+      ? x
+      : castOp(DataType::Float, x);
+}
+
+// Broadcasts the per-channel parameters along the other dimensions of x
+TensorView* broadcastChannels(TensorView* x, TensorView* params, int axis) {
+  const auto ndims =
+      (int)TensorDomain::noReductions(x->getMaybeRFactorDomain()).size();
+  axis = normalizeDim(x, axis);
+  TORCH_CHECK(
+      TensorDomain::noReductions(params->getMaybeRFactorDomain()).size() == 1,
+      "Expected a 1D tensor of per-channel parameters");
+  std::vector<bool> is_broadcast_dim(ndims, true);
+  is_broadcast_dim.at(axis) = false;
+  return broadcast(params, is_broadcast_dim);
+}
+
+// Broadcasts the per-group parameters along the groups of x
+TensorView* broadcastGroups(TensorView* x, TensorView* params) {
+  const auto ndims =
+      TensorDomain::noReductions(x->getMaybeRFactorDomain()).size();
+  TORCH_CHECK(
+      TensorDomain::noReductions(params->getMaybeRFactorDomain()).size() + 1 ==
+          ndims,
+      "Expected per-group parameters for all but the last dimension of the ",
+      "grouped tensor");
+  std::vector<bool> is_group_dim(ndims, false);
+  is_group_dim.back() = true;
+  return broadcast(params, is_group_dim);
+}
+
+} // namespace
+
+TensorView* quantize(
+    TensorView* x,
+    Val* scale,
+    Val* zero_point,
+    DataType dtype,
+    int64_t num_bits) {
+  TORCH_INTERNAL_ASSERT(
+      x != nullptr && scale != nullptr && zero_point != nullptr,
+      "Input is invalid.");
+  const auto [qmin, qmax] = quantizedRange(dtype, num_bits);
+  auto q = add(round(div(maybeCastToFloat(x), scale)), zero_point);
+  return castOp(
+      dtype,
+      clamp(
+          q,
+          IrBuilder::create<Double>((double)qmin),
+          IrBuilder::create<Double>((double)qmax)));
+}
+
+TensorView* dequantize(
+    TensorView* q,
+    Val* scale,
+    Val* zero_point,
+    DataType dtype) {
+  TORCH_INTERNAL_ASSERT(
+      q != nullptr && scale != nullptr && zero_point != nullptr,
+      "Input is invalid.");
+  TORCH_CHECK(
+      isIntegralType(q->getDataType().value()),
+      "Dequantizing a non-integer tensor of ",
+      q->getDataType().value());
+  auto x = mul(sub(castOp(DataType::Float, q), zero_point), scale);
+  return dtype == DataType::Float ? x : castOp(dtype, x);
+}
+
+TensorView* quantize_per_channel(
+    TensorView* x,
+    TensorView* scales,
+    TensorView* zero_points,
+    int axis,
+    DataType dtype,
+    int64_t num_bits) {
+  TORCH_INTERNAL_ASSERT(
+      x != nullptr && scales != nullptr && zero_points != nullptr,
+      "Input is invalid.");
+  return quantize(
+      x,
+      broadcastChannels(x, scales, axis),
+      broadcastChannels(x, zero_points, axis),
+      dtype,
+      num_bits);
+}
+
+TensorView* dequantize_per_channel(
+    TensorView* q,
+    TensorView* scales,
+    TensorView* zero_points,
+    int axis,
+    DataType dtype) {
+  TORCH_INTERNAL_ASSERT(
+      q != nullptr && scales != nullptr && zero_points != nullptr,
+      "Input is invalid.");
+  return dequantize(
+      q,
+      broadcastChannels(q, scales, axis),
+      broadcastChannels(q, zero_points, axis),
+      dtype);
+}
+
+TensorView* quantize_per_group(
+    TensorView* x,
+    TensorView* scales,
+    TensorView* zero_points,
+    DataType dtype,
+    int64_t num_bits) {
+  TORCH_INTERNAL_ASSERT(
+      x != nullptr && scales != nullptr && zero_points != nullptr,
+      "Input is invalid.");
+  return quantize(
+      x,
+      broadcastGroups(x, scales),
+      broadcastGroups(x, zero_points),
+      dtype,
+      num_bits);
+}
+
+TensorView* dequantize_per_group(
+    TensorView* q,
+    TensorView* scales,
+    TensorView* zero_points,
+    DataType dtype) {
+  TORCH_INTERNAL_ASSERT(
+      q != nullptr && scales != nullptr && zero_points != nullptr,
+      "Input is invalid.");
+  return dequantize(
+      q, broadcastGroups(q, scales), broadcastGroups(q, zero_points), dtype);
+}
+
+TensorView* pack_int4(TensorView* q) {
+  TORCH_INTERNAL_ASSERT(q != nullptr, "Input is invalid.");
+  TORCH_CHECK(
+      q->getDataType().value() == DataType::Int8 ||
+          q->getDataType().value() == DataType::UInt8,
+      "Packing 4-bit integers of a non-quantized tensor of ",
+      q->getDataType().value());
+  auto domain = TensorDomain::noReductions(q->getMaybeRFactorDomain());
+  TORCH_CHECK(
+      domain.size() > 1, "Expected pairs of 4-bit integers to pack, got ", q);
+  std::vector<bool> is_outer_dim(domain.size(), true);
+  is_outer_dim.back() = false;
+  auto shift = broadcast(
+      mul(iota(domain.back()->extent(), nullptr, nullptr, DataType::Int),
+          intVal(4)),
+      is_outer_dim);
+  auto nibble = bitwise_and(castOp(DataType::Int, q), intVal(0xf));
+  return castOp(
+      DataType::UInt8,
+      sum(bitwise_left_shift(nibble, shift), {(int)domain.size() - 1}));
+}
+
+TensorView* unpack_int4(TensorView* packed, bool is_signed) {
+  TORCH_INTERNAL_ASSERT(packed != nullptr, "Input is invalid.");
+  TORCH_CHECK(
+      packed->getDataType().value() == DataType::UInt8,
+      "Packed 4-bit integers are stored as UInt8, got ",
+      packed->getDataType().value());
+  const auto ndims =
+      TensorDomain::noReductions(packed->getMaybeRFactorDomain()).size();
+  std::vector<bool> is_pair_dim(ndims + 1, false);
+  is_pair_dim.back() = true;
+  std::vector<bool> is_byte_dim(ndims + 1, true);
+  is_byte_dim.back() = false;
+  auto shift = broadcast(
+      mul(iota(intVal(2), nullptr, nullptr, DataType::Int), intVal(4)),
+      is_byte_dim);
+  auto nibble = bitwise_and(
+      bitwise_right_shift(broadcast(packed, is_pair_dim), shift), intVal(0xf));
+  if (!is_signed) {
+    return castOp(DataType::UInt8, nibble);
+  }
+  return castOp(
+      DataType::Int8, sub(bitwise_xor(nibble, intVal(8)), intVal(8)));
+}
+
+// Note [ Implicit GEMM convolution ]
+//
+// A convolution is the GEMM of the [N * H' * W', R * S * C] im2col matrix of
+// its input with the [R * S * C, K] filters. conv2d_nhwc never writes the
+// im2col matrix: it's the concatenation along the channels of the R * S
+// slices of the padded input shifted by each tap,
+//
+//   col[n, h, w, (r * S + s) * C + c] = pad(x)[n, h + r, w + s, c]
+//
+// which are resize ops, so the contraction
+//
+//   y[n, h, w, k] = sum(col[n, h, w, b, rsc] * weight[b, b, b, k, rsc])
+//
+// is a reduction of pointwise ops of the input. The reduction scheduler
+// then fuses a prologue applied to the input, e.g. the scale and shift of
+// an inference batch norm and a relu, and an epilogue applied to the
+// output, e.g. a bias and a relu, with the convolution in a single kernel.
+// As with any input of a resize op, the padding is applied after the
+// prologue, as for an eager convolution of its output.
+//
+// The contraction runs on CUDA cores in Float: the matmul scheduler only
+// takes fusion inputs as operands and a single 2D mma, so it cannot load
+// the shifted slices into its tiles.
+
+TensorView* conv2d_nhwc(
+    TensorView* input,
+    TensorView* weight,
+    const std::vector<int64_t>& kernel_size,
+    const std::vector<int64_t>& padding) {
+  TORCH_INTERNAL_ASSERT(
+      input != nullptr && weight != nullptr, "Input is invalid.");
+  TORCH_CHECK(
+      TensorDomain::noReductions(input->getMaybeRFactorDomain()).size() == 4,
+      "Expected an NHWC input, got ",
+      input);
+  TORCH_CHECK(
+      TensorDomain::noReductions(weight->getMaybeRFactorDomain()).size() == 2,
+      "Expected [K, R * S * C] filters, got ",
+      weight);
+  TORCH_CHECK(
+      kernel_size.size() == 2 && padding.size() == 2,
+      "Expected the kernel size and padding of the height and width");
+  const auto kernel_h = kernel_size.at(0);
+  const auto kernel_w = kernel_size.at(1);
+  TORCH_CHECK(
+      kernel_h > 0 && kernel_w > 0, "Invalid kernel size of the convolution");
+
+  auto x = pad(
+      input,
+      {intVal(0),
+       intVal(0),
+       intVal(padding.at(1)),
+       intVal(padding.at(1)),
+       intVal(padding.at(0)),
+       intVal(padding.at(0))});
+  auto x_domain = TensorDomain::noReductions(x->getMaybeRFactorDomain());
+  Val* padded_h = x_domain.at(1)->extent();
+  Val* padded_w = x_domain.at(2)->extent();
+
+  std::vector<TensorView*> taps;
+  for (const auto r : c10::irange(kernel_h)) {
+    for (const auto s : c10::irange(kernel_w)) {
+      taps.push_back(slice(
+          x,
+          {Slice(),
+           {intVal(r), sub(padded_h, intVal(kernel_h - 1 - r))},
+           {intVal(s), sub(padded_w, intVal(kernel_w - 1 - s))},
+           Slice()}));
+    }
+  }
+  auto col = taps.size() == 1 ? taps.front() : cat(taps, 3);
+
+  // [N, H', W', b, R * S * C] * [b, b, b, K, R * S * C]
+  auto col_bcast =
+      broadcast(maybeCastToFloat(col), {false, false, false, true, false});
+  auto weight_bcast =
+      broadcast(maybeCastToFloat(weight), {true, true, true, false, false});
+  return sum(mul(col_bcast, weight_bcast), {4});
+}
+
+// Note [ Jagged tensors ]
+//
+// A batch of sequences of different lengths is a jagged tensor, which is
+// made of the rows of all sequences packed along its first dimension, e.g.
+// [tokens, hidden], with the offsets of the B sequences, B + 1 integers
+// from 0 to the number of rows. Packing rather than padding the sequences
+// to the longest one means that
+//
+//  - pointwise ops and reductions within a row, e.g. a layer norm of each
+//    token, are plain ops of the packed tensor,
+//  - a value of each sequence used by all its rows, e.g. [B, hidden], is
+//    gathered with index_select of the segment ids of the rows returned by
+//    jagged_segment_ids,
+//  - a reduction of the rows of each sequence is the atomic index_add of
+//    jagged_sum.
+//
+// There is no jagged IterDomain, so the offsets are never part of the
+// indexing of a tensor and all schedulers see dense packed tensors. The
+// segment of row t is the number of offsets, other than the first one, no
+// larger than t, which is a reduction along the offsets, B + 1 of them.
+
+TensorView* jagged_segment_ids(TensorView* offsets, Val* num_rows) {
+  TORCH_INTERNAL_ASSERT(
+      offsets != nullptr && num_rows != nullptr, "Input is invalid.");
+  const auto offsets_ndims =
+      TensorDomain::noReductions(offsets->getMaybeRFactorDomain()).size();
+  TORCH_CHECK(
+      offsets_ndims == 1 && isIntegralType(offsets->getDataType().value()),
+      "Expected a 1D integer tensor of offsets, got ",
+      offsets);
+  auto rows = broadcast(
+      iota(num_rows, nullptr, nullptr, DataType::Int), {false, true});
+  auto starts = broadcast(offsets, {true, false});
+  auto num_starts = sum(castOp(DataType::Int, le(starts, rows)), {1});
+  return sub(num_starts, intVal(1));
+}
+
+TensorView* jagged_sum(
+    TensorView* x,
+    TensorView* segment_ids,
+    TensorView* init) {
+  TORCH_INTERNAL_ASSERT(
+      x != nullptr && segment_ids != nullptr && init != nullptr,
+      "Input is invalid.");
+  TORCH_CHECK(
+      isIntegralType(segment_ids->getDataType().value()),
+      "Segment ids must be integers, got ",
+      segment_ids->getDataType().value());
+  return index_add(init, 0, segment_ids, x);
+}
+
+TensorView* block_sparse_mask(TensorView* x, TensorView* mask) {
+  TORCH_INTERNAL_ASSERT(x != nullptr && mask != nullptr, "Input is invalid.");
+  const auto x_ndims =
+      TensorDomain::noReductions(x->getMaybeRFactorDomain()).size();
+  const auto mask_ndims =
+      TensorDomain::noReductions(mask->getMaybeRFactorDomain()).size();
+  TORCH_CHECK(
+      mask->getDataType().value() == DataType::Bool,
+      "Expected a Bool mask of blocks, got ",
+      mask->getDataType().value());
+  TORCH_CHECK(
+      x_ndims == 2 * mask_ndims,
+      "Expected a tensor viewed as its blocks, with two dimensions for each ",
+      "dimension of the mask, got ",
+      x_ndims,
+      " and ",
+      mask_ndims);
+  // Each dimension of the mask indexes the blocks of a pair of dimensions
+  // of x, whose second dimension is within a block
+  std::vector<bool> is_block_dim(x_ndims, false);
+  for (const auto i : c10::irange(mask_ndims)) {
+    is_block_dim[2 * i + 1] = true;
+  }
+  auto x_mask = broadcast(mask, is_block_dim);
+  // A zero of the dtype of x, so that x isn't cast ahead of the where
+  auto zero = x->container()->zeroVal(x->getDataType().value());
+  return where(x_mask, x, zero);
+}
+
 } // namespace nvfuser
@@ -35,6 +35,37 @@ TORCH_CUDA_CU_API TensorView* dropout_backward(
     TensorView* mask,
     Val* scale);
 
+//! Dropout drawing its random numbers from an explicit Philox seed and
+//! offset, see Note [ Explicit Philox seed and offset ]. The mask is still
+//! returned but does not need to be kept for the backward pass.
+TORCH_CUDA_CU_API ForwardDropoutResult dropout(
+    TensorView* x,
+    Val* prob,
+    Val* scale,
+    Val* philox_seed,
+    Val* philox_offset);
+
+//! Backward of the dropout above: regenerates the mask from the same seed
+//! and offset instead of reading a saved one.
+TORCH_CUDA_CU_API TensorView* dropout_backward(
+    TensorView* dy,
+    Val* prob,
+    Val* scale,
+    Val* philox_seed,
+    Val* philox_offset);
+
+//! Cast to BFloat16 with stochastic rounding: x is rounded up with
+//! probability equal to its distance from the next smaller BFloat16 value
+//! divided by the spacing of the two, so the rounding is unbiased in
+//! expectation. This lets optimizer updates accumulate into BFloat16 weights
+//! without keeping Float master copies. The random bits come from the same
+//! Philox stream as rand_like, optionally with an explicit seed and offset.
+TORCH_CUDA_CU_API TensorView* stochastic_round_cast(
+    TensorView* x,
+    DataType dtype,
+    Val* philox_seed = nullptr,
+    Val* philox_offset = nullptr);
+
 struct LstmResult {
   TensorView* cell = nullptr;
   TensorView* hidden = nullptr;
@@ -47,6 +78,24 @@ TORCH_CUDA_CU_API LstmResult lstm(
     TensorView* cell_x,
     TensorView* out_x);
 
+//! One LSTM timestep with its recurrent projection: each gate adds
+//! prev_hidden [B, H_in] times the transpose of its recurrent weight
+//! [H, H_in], laid out as the chunks of torch.nn.LSTM's weight_hh, to its
+//! input projection [B, H] before applying lstm. Reduced precision operands
+//! are computed in Float and the outputs are Float. See Note [ Fused LSTM
+//! cells ]
+TORCH_CUDA_CU_API LstmResult lstm_cell(
+    TensorView* prev_hidden,
+    TensorView* prev_cell,
+    TensorView* in_x,
+    TensorView* forget_x,
+    TensorView* cell_x,
+    TensorView* out_x,
+    TensorView* in_w,
+    TensorView* forget_w,
+    TensorView* cell_w,
+    TensorView* out_w);
+
 TORCH_CUDA_CU_API TensorView* sign(TensorView* x);
 TORCH_CUDA_CU_API Val* sign(Val* x);
 TORCH_CUDA_CU_API TensorView* softplus(
@@ -62,4 +111,141 @@ TORCH_CUDA_CU_API TensorView* leaky_relu(TensorView* x, Val* negative_slope);
 
 TORCH_CUDA_CU_API TensorView* view_as_real(TensorView* x);
 
+//! Position of the largest value along dim, the first one if several are
+//! equal, see Note [ Packed index reductions ]
+TORCH_CUDA_CU_API TensorView* argmax(
+    TensorView* x,
+    int dim,
+    bool keep_dim = false);
+
+//! Position of the smallest value along dim, the first one if several are
+//! equal
+TORCH_CUDA_CU_API TensorView* argmin(
+    TensorView* x,
+    int dim,
+    bool keep_dim = false);
+
+struct TopKResult {
+  TensorView* values = nullptr;
+  TensorView* indices = nullptr;
+};
+
+//! The k largest, or smallest, values along dim in sorted order and their
+//! positions, meant for a small k as it takes k reductions
+TORCH_CUDA_CU_API TopKResult
+topk(TensorView* x, int64_t k, int dim, bool largest = true);
+
+struct CrossEntropyResult {
+  TensorView* loss = nullptr;
+  TensorView* log_sum_exp = nullptr;
+};
+
+//! Cross-entropy loss of each row of logits, whose classes are its last
+//! dimension, for the labels of the rows, without reduction. Rows labeled
+//! ignore_index have a zero loss. See Note [ Fused cross-entropy ]
+TORCH_CUDA_CU_API CrossEntropyResult cross_entropy(
+    TensorView* logits,
+    TensorView* labels,
+    int64_t ignore_index = -100);
+
+//! Gradient of the logits of cross_entropy from the gradient of its loss
+//! and the log_sum_exp it returned
+TORCH_CUDA_CU_API TensorView* cross_entropy_backward(
+    TensorView* dloss,
+    TensorView* logits,
+    TensorView* labels,
+    TensorView* log_sum_exp,
+    int64_t ignore_index = -100);
+
+//! Affine quantization of x to the num_bits integers of dtype, Int8 or
+//! UInt8, q = clamp(round(x / scale) + zero_point). scale and zero_point are
+//! scalars or tensors broadcast like x. See Note [ Quantization ]
+TORCH_CUDA_CU_API TensorView* quantize(
+    TensorView* x,
+    Val* scale,
+    Val* zero_point,
+    DataType dtype,
+    int64_t num_bits = 8);
+
+//! x = (q - zero_point) * scale computed in Float and cast to dtype
+TORCH_CUDA_CU_API TensorView* dequantize(
+    TensorView* q,
+    Val* scale,
+    Val* zero_point,
+    DataType dtype = DataType::Float);
+
+//! quantize with a scale and a zero point for each position of x along axis
+TORCH_CUDA_CU_API TensorView* quantize_per_channel(
+    TensorView* x,
+    TensorView* scales,
+    TensorView* zero_points,
+    int axis,
+    DataType dtype,
+    int64_t num_bits = 8);
+
+TORCH_CUDA_CU_API TensorView* dequantize_per_channel(
+    TensorView* q,
+    TensorView* scales,
+    TensorView* zero_points,
+    int axis,
+    DataType dtype = DataType::Float);
+
+//! quantize with a scale and a zero point for each group of x, the groups
+//! being its last dimension, i.e. x is [..., groups, group_size] and scales
+//! and zero_points are [..., groups]
+TORCH_CUDA_CU_API TensorView* quantize_per_group(
+    TensorView* x,
+    TensorView* scales,
+    TensorView* zero_points,
+    DataType dtype,
+    int64_t num_bits = 8);
+
+TORCH_CUDA_CU_API TensorView* dequantize_per_group(
+    TensorView* q,
+    TensorView* scales,
+    TensorView* zero_points,
+    DataType dtype = DataType::Float);
+
+//! Packs the pairs of 4-bit integers of q, [..., N, 2], into the UInt8
+//! bytes [..., N], the first of a pair in the low nibble
+TORCH_CUDA_CU_API TensorView* pack_int4(TensorView* q);
+
+//! Unpacks the UInt8 bytes [..., N] of pack_int4 into the pairs of 4-bit
+//! integers [..., N, 2], sign extended to Int8 if is_signed and UInt8
+//! otherwise
+TORCH_CUDA_CU_API TensorView* unpack_int4(TensorView* packed, bool is_signed);
+
+//! Convolution of an NHWC input with a stride of one, with weight given as
+//! [K, R * S * C], i.e. the [K, R, S, C] filters with their taps and input
+//! channels flattened. The output is the Float [N, H', W', K] of the padded
+//! input. See Note [ Implicit GEMM convolution ]
+TORCH_CUDA_CU_API TensorView* conv2d_nhwc(
+    TensorView* input,
+    TensorView* weight,
+    const std::vector<int64_t>& kernel_size,
+    const std::vector<int64_t>& padding);
+
+//! Segment of each of the num_rows rows of a jagged tensor packed along its
+//! first dimension, segment b being the rows [offsets[b], offsets[b + 1]).
+//! See Note [ Jagged tensors ]
+TORCH_CUDA_CU_API TensorView* jagged_segment_ids(
+    TensorView* offsets,
+    Val* num_rows);
+
+//! Sum of the rows of each segment of the packed jagged tensor x, added to
+//! init, a fusion input shaped like a row of x for each segment
+TORCH_CUDA_CU_API TensorView* jagged_sum(
+    TensorView* x,
+    TensorView* segment_ids,
+    TensorView* init);
+
+//! x with the blocks mask marks empty replaced by zeros, without loading
+//! them, see Note [ Block sparse inputs ]. x is a dense tensor viewed as
+//! its blocks, [num_blocks_0, block_size_0, num_blocks_1, block_size_1,
+//! ...], e.g., x.view({R / bR, bR, C / bC, bC}), and mask is the Bool
+//! [num_blocks_0, num_blocks_1, ...] bitmap of its nonzero blocks
+TORCH_CUDA_CU_API TensorView* block_sparse_mask(
+    TensorView* x,
+    TensorView* mask);
+
 } // namespace nvfuser
@@ -9,6 +9,8 @@
 #include <ops/arith.h>
 #include <ops/normalization.h>
 
+#include <limits>
+
 namespace nvfuser {
 
 int nonNegativeAxis(int axis, int ndims) {
@@ -222,6 +224,87 @@ TensorView* log_softmax_backward(TensorView* dy, TensorView* y, int dim) {
   return dx;
 }
 
+TensorView* causal_mask(TensorView* x, Val* window) {
+  TORCH_INTERNAL_ASSERT(x != nullptr, "Input is invalid.");
+  const auto domain = TensorDomain::noReductions(x->getMaybeRFactorDomain());
+  const size_t kNumberOfDims = domain.size();
+  TORCH_CHECK(kNumberOfDims >= 2, "Causal masks need queries and keys");
+  TORCH_CHECK(
+      window == nullptr || isIntegralType(*window->getDataType()),
+      "The window of a causal mask must be an integer");
+
+  auto num_queries = domain[kNumberOfDims - 2]->extent();
+  auto num_keys = domain[kNumberOfDims - 1]->extent();
+
+  std::vector<bool> query_bcast(kNumberOfDims, true);
+  query_bcast[kNumberOfDims - 2] = false;
+  std::vector<bool> key_bcast(kNumberOfDims, true);
+  key_bcast[kNumberOfDims - 1] = false;
+
+  // Position of each query among the keys
+  auto queries = broadcast(
+      add(iota(num_queries), sub(num_keys, num_queries)), query_bcast);
+  auto keys = broadcast(iota(num_keys), key_bcast);
+
+  auto mask = le(keys, queries);
+  if (window != nullptr) {
+    mask = bitwise_and(mask, gt(keys, sub(queries, window)));
+  }
+  return mask;
+}
+
+TensorView* length_mask(TensorView* x, TensorView* lengths) {
+  TORCH_INTERNAL_ASSERT(x != nullptr, "Input is invalid.");
+  TORCH_INTERNAL_ASSERT(lengths != nullptr, "Lengths are invalid.");
+  const auto domain = TensorDomain::noReductions(x->getMaybeRFactorDomain());
+  const size_t kNumberOfDims = domain.size();
+  TORCH_CHECK(kNumberOfDims >= 2, "Length masks need a batch and keys");
+  TORCH_CHECK(
+      TensorDomain::noReductions(lengths->getMaybeRFactorDomain()).size() ==
+              1 &&
+          isIntegralType(*lengths->getDataType()),
+      "Lengths of a mask must be a 1D integer tensor");
+
+  std::vector<bool> batch_bcast(kNumberOfDims, true);
+  batch_bcast[0] = false;
+  std::vector<bool> key_bcast(kNumberOfDims, true);
+  key_bcast[kNumberOfDims - 1] = false;
+
+  auto keys = broadcast(iota(domain[kNumberOfDims - 1]->extent()), key_bcast);
+  return lt(keys, broadcast(lengths, batch_bcast));
+}
+
+TensorView* masked_softmax(TensorView* x, TensorView* mask, int dim) {
+  TORCH_INTERNAL_ASSERT(x != nullptr, "Input is invalid.");
+  TORCH_INTERNAL_ASSERT(mask != nullptr, "Mask is invalid.");
+  TORCH_CHECK(
+      mask->getDataType() == DataType::Bool, "Softmax masks must be boolean");
+
+  const int kNumberOfDims =
+      TensorDomain::noReductions(x->getMaybeRFactorDomain()).size();
+  const int kReductionAxis = (dim < 0) ? dim + kNumberOfDims : dim;
+  TORCH_INTERNAL_ASSERT(kReductionAxis >= 0 && kReductionAxis < kNumberOfDims);
+
+  std::vector<bool> broadcast_mask(kNumberOfDims, false);
+  broadcast_mask[kReductionAxis] = true;
+
+  auto neg_inf = IrBuilder::create<Double>(
+      x->container(), -std::numeric_limits<double>::infinity());
+  auto max_val = max(where(mask, x, neg_inf), {kReductionAxis});
+  auto bcast_max = broadcast(max_val, broadcast_mask);
+  // The maximum of fully masked rows is -inf, masking after the subtraction
+  // keeps their exponentials zero instead of NaN
+  auto exp_val = exp(where(mask, sub(x, bcast_max), neg_inf));
+  auto sum_exp = sum(exp_val, {kReductionAxis});
+  auto bcast_sum = broadcast(sum_exp, broadcast_mask);
+  auto y = where(
+      mask,
+      mul(exp_val, reciprocal(bcast_sum)),
+      IrBuilder::create<Double>(x->container(), 0));
+
+  return y;
+}
+
 ForwardNormResult layer_norm(
     TensorView* x,
     const std::vector<int64_t>& norm_shape,
@@ -460,6 +543,92 @@ BackwardRMSNormResult rms_norm_backward(
   return {dx, dw};
 }
 
+namespace {
+
+// Adds x and residual, writing the sum over the residual if requested, see
+// Note [ Residual norms ]
+TensorView* addResidual(
+    TensorView* x,
+    TensorView* residual,
+    bool inplace_residual) {
+  TORCH_INTERNAL_ASSERT(x != nullptr, "Input is invalid.");
+  TORCH_INTERNAL_ASSERT(residual != nullptr, "Residual is invalid.");
+  auto x_plus_residual = add(x, residual);
+  if (inplace_residual) {
+    x->fusion()->aliasOutputToInput(x_plus_residual, residual);
+  }
+  return x_plus_residual;
+}
+
+} // namespace
+
+ForwardResidualNormResult residual_layer_norm(
+    TensorView* x,
+    TensorView* residual,
+    const size_t kNormShapeNumDims,
+    TensorView* weight,
+    TensorView* bias,
+    Val* eps,
+    bool inplace_residual) {
+  auto x_plus_residual = addResidual(x, residual, inplace_residual);
+  auto result =
+      layer_norm(x_plus_residual, kNormShapeNumDims, weight, bias, eps);
+  return {result.output, x_plus_residual, result.mean, result.invstd};
+}
+
+ForwardResidualRMSNormResult residual_rms_norm(
+    TensorView* x,
+    TensorView* residual,
+    const size_t kNormShapeNumDims,
+    TensorView* weight,
+    Val* eps,
+    bool inplace_residual) {
+  auto x_plus_residual = addResidual(x, residual, inplace_residual);
+  auto result = rms_norm(x_plus_residual, kNormShapeNumDims, weight, eps);
+  return {result.output, x_plus_residual, result.invstd};
+}
+
+BackwardNormResult residual_layer_norm_backward(
+    TensorView* dy,
+    TensorView* grad_residual,
+    TensorView* x_plus_residual,
+    const std::vector<int64_t>& norm_shape,
+    TensorView* mean,
+    TensorView* invstd,
+    TensorView* weight,
+    TensorView* bias,
+    const std::vector<bool>& output_mask) {
+  auto grads = layer_norm_backward(
+      dy,
+      x_plus_residual,
+      norm_shape,
+      mean,
+      invstd,
+      weight,
+      bias,
+      output_mask);
+  if (grads.grad_input != nullptr && grad_residual != nullptr) {
+    grads.grad_input = add(grads.grad_input, grad_residual);
+  }
+  return grads;
+}
+
+BackwardRMSNormResult residual_rms_norm_backward(
+    TensorView* dy,
+    TensorView* grad_residual,
+    TensorView* x_plus_residual,
+    const std::vector<int64_t>& norm_shape,
+    TensorView* invstd,
+    TensorView* weight,
+    const std::vector<bool>& output_mask) {
+  auto grads = rms_norm_backward(
+      dy, x_plus_residual, norm_shape, invstd, weight, output_mask);
+  if (grads.grad_input != nullptr && grad_residual != nullptr) {
+    grads.grad_input = add(grads.grad_input, grad_residual);
+  }
+  return grads;
+}
+
 ForwardNormResult batch_norm(
     TensorView* x,
     TensorView* weight,
@@ -867,6 +1036,80 @@ ForwardNormResult instance_norm(
   return {y, mean, invstd};
 }
 
+ForwardNormResult group_norm(
+    TensorView* x,
+    TensorView* weight,
+    TensorView* bias,
+    Val* eps,
+    bool channels_last) {
+  TORCH_INTERNAL_ASSERT(x != nullptr, "Input is invalid.");
+
+  TORCH_INTERNAL_ASSERT(
+      eps != nullptr && eps->getDataType().has_value() &&
+          eps->getDataType().value() == DataType::Double,
+      "Epsilon (eps) is not a valid Double.");
+
+  // (N, G, C / G, H, W) or (N, H, W, G, C / G) tensor
+  // M = outer = N * G
+  // R = reduction = C / G * H * W
+  // weight = bias = (G, C / G) tensor
+  const size_t kBatchDim = 0;
+  const size_t kNumberOfDims =
+      TensorDomain::noReductions(x->getMaybeRFactorDomain()).size();
+  TORCH_CHECK(
+      kNumberOfDims >= 3,
+      "Expected the input of group_norm to have at least 3 dimensions, N, G and C / G, but found ",
+      kNumberOfDims);
+  const size_t kGroupsDim = channels_last ? kNumberOfDims - 2 : 1;
+  const size_t kChannelsDim = kGroupsDim + 1;
+
+  std::vector<int> x_reduction_axes;
+  std::vector<bool> x_broadcast_mask(kNumberOfDims, false);
+  std::vector<bool> channels_only_broadcast_mask(kNumberOfDims, true);
+  Val* N = IrBuilder::create<Double>(x->container(), 1);
+  for (const auto axis : c10::irange(kNumberOfDims)) {
+    if (axis != kBatchDim && axis != kGroupsDim) {
+      x_reduction_axes.push_back(axis);
+      x_broadcast_mask[axis] = true;
+      N = mul(N, x->domain()->domain()[axis]->extent());
+    }
+    if (axis == kGroupsDim || axis == kChannelsDim) {
+      channels_only_broadcast_mask[axis] = false;
+    }
+  }
+
+  // The channels and spatial dimensions of a group are contiguous, or two
+  // groups of axes strided by the groups with channels_last, which the
+  // persistent scheduler merges into a 3D schedule, see
+  // ReductionParams::schedule_3D. Either way the groups are normalized in a
+  // single kernel holding them in registers or shared memory.
+  auto welford_out = Welford(x, x_reduction_axes);
+
+  auto mean = welford_out.avg;
+  auto mean_bcast = broadcast(mean, x_broadcast_mask);
+  auto x_sub_mean = sub(x, mean_bcast);
+
+  auto var = mul(welford_out.var_sum, reciprocal(N));
+  auto var_eps = add(var, eps);
+  auto invstd = rsqrt(var_eps);
+  auto invstd_bcast = broadcast(invstd, x_broadcast_mask);
+
+  auto y = mul(x_sub_mean, invstd_bcast);
+
+  // Optional: norm * weight
+  if (weight) {
+    auto weight_bcast = broadcast(weight, channels_only_broadcast_mask);
+    y = mul(y, weight_bcast);
+  }
+
+  // Optional: norm * weight + bias
+  if (bias) {
+    auto bias_bcast = broadcast(bias, channels_only_broadcast_mask);
+    y = add(y, bias_bcast);
+  }
+  return {y, mean, invstd};
+}
+
 BackwardNormResult instance_norm_backward(
     TensorView* input,
     TensorView* grad_output,
@@ -50,6 +50,19 @@ struct VarMeanResult {
   TensorView* mean = nullptr;
 };
 
+struct ForwardResidualNormResult {
+  TensorView* output = nullptr;
+  TensorView* residual = nullptr;
+  TensorView* mean = nullptr;
+  TensorView* invstd = nullptr;
+};
+
+struct ForwardResidualRMSNormResult {
+  TensorView* output = nullptr;
+  TensorView* residual = nullptr;
+  TensorView* invstd = nullptr;
+};
+
 } // namespace nvfuser
 
 namespace std {
@@ -58,6 +71,8 @@ namespace std {
 using nvfuser::BackwardNormResult;
 using nvfuser::BackwardRMSNormResult;
 using nvfuser::ForwardNormResult;
+using nvfuser::ForwardResidualNormResult;
+using nvfuser::ForwardResidualRMSNormResult;
 using nvfuser::ForwardRMSNormResult;
 using nvfuser::TensorView;
 using nvfuser::VarMeanResult;
@@ -112,6 +127,37 @@ constexpr TensorView* get(const BackwardRMSNormResult& results) {
   return nullptr;
 }
 
+template <int i>
+constexpr TensorView* get(const ForwardResidualNormResult& results) {
+  if (i == 0) {
+    return results.output;
+  }
+  if (i == 1) {
+    return results.residual;
+  }
+  if (i == 2) {
+    return results.mean;
+  }
+  if (i == 3) {
+    return results.invstd;
+  }
+  return nullptr;
+}
+
+template <int i>
+constexpr TensorView* get(const ForwardResidualRMSNormResult& results) {
+  if (i == 0) {
+    return results.output;
+  }
+  if (i == 1) {
+    return results.residual;
+  }
+  if (i == 2) {
+    return results.invstd;
+  }
+  return nullptr;
+}
+
 template <int i>
 constexpr TensorView* get(const VarMeanResult& results) {
   if (i == 0) {
@@ -170,6 +216,39 @@ TORCH_CUDA_CU_API TensorView* log_softmax_backward(
     TensorView* y,
     const int dim);
 
+// Note [ Generated attention masks ]
+//
+// Masked softmax of attention scores usually reads a boolean [B, H, S, S]
+// mask from global memory. The masks below are instead computed in the
+// kernel from iota comparisons, so they cost a few integer ops per element
+// and no memory traffic. They are boolean tensors of the rank of the scores
+// `x`, whose last two dimensions are the queries and the keys, and are
+// broadcast along all other dimensions but the ones they depend on. The
+// iota tensors have no producers, so the schedulers inline them into the
+// masked softmax like any other pointwise op.
+//
+// masked_softmax zeroes the masked positions, so softmax_backward of its
+// output needs no mask: y is zero at the masked positions and so is
+// y * (dy - sum(y * dy)).
+
+//! Keeps the keys up to the position of the query, the queries being the
+//! last keys if there are fewer queries than keys, and only the last `window`
+//! of these keys if `window` is given
+TORCH_CUDA_CU_API TensorView* causal_mask(
+    TensorView* x,
+    Val* window = nullptr);
+
+//! Keeps the first lengths[b] keys of the batch b, the first dimension of
+//! `x`. `lengths` is a 1D integer tensor.
+TORCH_CUDA_CU_API TensorView* length_mask(TensorView* x, TensorView* lengths);
+
+//! softmax of `x` along `dim` over the positions where `mask` is true. The
+//! other positions, and fully masked rows, are zero.
+TORCH_CUDA_CU_API TensorView* masked_softmax(
+    TensorView* x,
+    TensorView* mask,
+    int dim);
+
 TORCH_CUDA_CU_API ForwardNormResult layer_norm(
     TensorView* x,
     const std::vector<int64_t>& norm_shape,
@@ -214,6 +293,66 @@ TORCH_CUDA_CU_API BackwardRMSNormResult rms_norm_backward(
     TensorView* weight,
     const std::vector<bool>& output_mask);
 
+// Note [ Residual norms ]
+//
+// Pre-norm transformer blocks add the output of a sublayer to the residual
+// stream and normalize the sum, which becomes the new residual stream. The
+// residual norms below compute both in the persistent kernel of the norm, so
+// the sum is written once and never read back. With inplace_residual, the
+// new residual is aliased to the residual input, cast to its dtype if
+// needed, and written over it instead of being a new output. The residual
+// input, or the input it is cast from, must then be a fusion input, and the
+// returned residual must not be added as an output again. The persistent
+// scheduler doesn't project persistent buffers back to inputs overwritten in
+// place, see Note [ In-place outputs ].
+//
+// The gradient of the sum flows to both x and the residual, so the backward
+// returns a single grad_input, which is the gradient of the norm plus the
+// gradient flowing back along the residual stream, if any.
+
+//! layer_norm(x + residual), also returning x + residual
+TORCH_CUDA_CU_API ForwardResidualNormResult residual_layer_norm(
+    TensorView* x,
+    TensorView* residual,
+    const size_t kNormShapeNumDims,
+    TensorView* weight,
+    TensorView* bias,
+    Val* eps,
+    bool inplace_residual = false);
+
+//! rms_norm(x + residual), also returning x + residual
+TORCH_CUDA_CU_API ForwardResidualRMSNormResult residual_rms_norm(
+    TensorView* x,
+    TensorView* residual,
+    const size_t kNormShapeNumDims,
+    TensorView* weight,
+    Val* eps,
+    bool inplace_residual = false);
+
+//! Backward of residual_layer_norm. x_plus_residual is the residual returned
+//! by the forward, and grad_residual the gradient of the following layers
+//! with respect to it, which may be nullptr.
+TORCH_CUDA_CU_API BackwardNormResult residual_layer_norm_backward(
+    TensorView* dy,
+    TensorView* grad_residual,
+    TensorView* x_plus_residual,
+    const std::vector<int64_t>& norm_shape,
+    TensorView* mean,
+    TensorView* rstd,
+    TensorView* weight,
+    TensorView* bias,
+    const std::vector<bool>& output_mask);
+
+//! Backward of residual_rms_norm, see residual_layer_norm_backward
+TORCH_CUDA_CU_API BackwardRMSNormResult residual_rms_norm_backward(
+    TensorView* dy,
+    TensorView* grad_residual,
+    TensorView* x_plus_residual,
+    const std::vector<int64_t>& norm_shape,
+    TensorView* rstd,
+    TensorView* weight,
+    const std::vector<bool>& output_mask);
+
 TORCH_CUDA_CU_API ForwardNormResult batch_norm(
     TensorView* x,
     TensorView* weight,
@@ -249,6 +388,18 @@ TORCH_CUDA_CU_API ForwardNormResult instance_norm(
     Val* eps,
     bool channels_last = false);
 
+//! Group normalization of x viewed with its channels split into groups,
+//! i.e. as [N, G, C / G, *spatial], or as [N, *spatial, G, C / G] if
+//! channels_last. Each group is normalized over its channels and spatial
+//! dimensions, so the mean and invstd are of shape [N, G]. The optional
+//! weight and bias are per channel and of shape [G, C / G].
+TORCH_CUDA_CU_API ForwardNormResult group_norm(
+    TensorView* x,
+    TensorView* weight,
+    TensorView* bias,
+    Val* eps,
+    bool channels_last = false);
+
 TORCH_CUDA_CU_API BackwardNormResult instance_norm_backward(
     TensorView* x,
     TensorView* dy,
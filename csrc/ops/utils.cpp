@@ -122,6 +122,10 @@ Val* newScalar(ValType vtype, DataType dtype) {
           return IrBuilder::create<Double>(DataType::Double);
         case DataType::Int32:
           return IrBuilder::create<Int>(DataType::Int32);
+        case DataType::Int8:
+          return IrBuilder::create<Int>(DataType::Int8);
+        case DataType::UInt8:
+          return IrBuilder::create<Int>(DataType::UInt8);
         case DataType::Index:
           return IrBuilder::create<Int>(DataType::Index);
         case DataType::Int:
@@ -349,6 +353,12 @@ Val* getMinimumValue(DataType v) {
     case (DataType::Int32):
       return IrBuilder::create<Int>(std::numeric_limits<int32_t>::lowest());
       break;
+    case (DataType::Int8):
+      return IrBuilder::create<Int>(std::numeric_limits<int8_t>::lowest());
+      break;
+    case (DataType::UInt8):
+      return IrBuilder::create<Int>(std::numeric_limits<uint8_t>::lowest());
+      break;
     case (DataType::Bool):
       return IrBuilder::create<Bool>(false);
       break;
@@ -385,6 +395,12 @@ Val* getMaximumValue(DataType v) {
     case (DataType::Int32):
       return IrBuilder::create<Int>(std::numeric_limits<int32_t>::max());
       break;
+    case (DataType::Int8):
+      return IrBuilder::create<Int>(std::numeric_limits<int8_t>::max());
+      break;
+    case (DataType::UInt8):
+      return IrBuilder::create<Int>(std::numeric_limits<uint8_t>::max());
+      break;
     case (DataType::Bool):
       return IrBuilder::create<Bool>(true);
       break;
@@ -20,6 +20,7 @@ void ParallelDimensionMap::build(Fusion* fusion) {
   // Scan all TVs to build ParallelType maps
   auto all_vals = fusion->usedMathVals();
   for (auto tv : ir_utils::filterByType<TensorView>(all_vals)) {
+    registerExtents(tv);
     for (auto id : tv->domain()->domain()) {
       registerConstantExtent(id);
       if (!isParallelTypeThread(id->getParallelType())) {
@@ -73,6 +74,30 @@ void ParallelDimensionMap::registerConstantExtent(IterDomain* id) {
   }
 }
 
+void ParallelDimensionMap::registerExtents(TensorView* tv) {
+  auto register_extent = [this](IterDomain* id) {
+    if (id->isBroadcast()) {
+      return;
+    }
+    auto concrete_id = getCAMappedConcreteDomain(id);
+    auto inserted = extent_concrete_map_.emplace(id->extent(), concrete_id);
+    if (!inserted.second && inserted.first->second != concrete_id) {
+      inserted.first->second = nullptr;
+    }
+  };
+  for (auto id : tv->getRootDomain()) {
+    register_extent(id);
+  }
+  if (tv->hasRFactor()) {
+    for (auto id : tv->getRFactorDomain()) {
+      register_extent(id);
+    }
+  }
+  for (auto id : tv->domain()->domain()) {
+    register_extent(id);
+  }
+}
+
 // Adds the conrecte domain of id to the mappsed set for its
 // parallel type
 void ParallelDimensionMap::handleParallelDomain(IterDomain* id) {
@@ -259,13 +284,25 @@ IterDomain* ParallelDimensionMap::getCAMappedConcreteDomain(IterDomain* id) {
 
 // Symbolically compares equality of two KIR vals. Comparison is done
 // conservatively, so returning false does not guarantee non-equality.
-bool ParallelDimensionMap::equalDim(Val* dim1, Val* dim2) {
+bool ParallelDimensionMap::equalDim(Val* dim1, Val* dim2) const {
   TORCH_INTERNAL_ASSERT(dim1 != nullptr && dim2 != nullptr);
 
   if (dim1 == dim2) {
     return true;
   }
 
+  // Different vals are still equal if they are the extents of exactly mapped
+  // domains, e.g., the sizes of two inputs of a binary op, or the ceilDiv
+  // extents of splits of such domains, which are compared recursively below.
+  auto dim1_concrete_it = extent_concrete_map_.find(dim1);
+  auto dim2_concrete_it = extent_concrete_map_.find(dim2);
+  if (dim1_concrete_it != extent_concrete_map_.end() &&
+      dim2_concrete_it != extent_concrete_map_.end() &&
+      dim1_concrete_it->second != nullptr &&
+      dim1_concrete_it->second == dim2_concrete_it->second) {
+    return true;
+  }
+
   // When Both are Int, they are same if both have the same constant
   auto dim1_int = dynamic_cast<Int*>(dim1);
   auto dim2_int = dynamic_cast<Int*>(dim2);
@@ -308,12 +345,26 @@ bool ParallelDimensionMap::equalDim(Val* dim1, Val* dim2) {
       (dim1_def->isA<UnaryOp>() && dim2_def->isA<UnaryOp>() &&
        (dim1_def->as<UnaryOp>()->getUnaryOpType() ==
         dim2_def->as<UnaryOp>()->getUnaryOpType()))) {
+    bool inputs_equal = true;
     for (const auto i : c10::irange(dim1_def->inputs().size())) {
       if (!equalDim(dim1_def->inputs().at(i), dim2_def->inputs().at(i))) {
-        return false;
+        inputs_equal = false;
+        break;
       }
     }
-    return true;
+    if (inputs_equal) {
+      return true;
+    }
+    // Merging the same domains in a different order results in
+    // commuted products, e.g., i0 * i1 and i1 * i0
+    if (dim1_def->isA<BinaryOp>()) {
+      auto bop_type = dim1_def->as<BinaryOp>()->getBinaryOpType();
+      if (bop_type == BinaryOpType::Mul || bop_type == BinaryOpType::Add) {
+        return equalDim(dim1_def->input(0), dim2_def->input(1)) &&
+            equalDim(dim1_def->input(1), dim2_def->input(0));
+      }
+    }
+    return false;
   }
 
   return false;
@@ -32,13 +32,18 @@ class TORCH_CUDA_CU_API ParallelDimensionMap {
 
   std::string toString() const;
 
-  //! Symbolically analyze if two extent vals are equal
-  static bool equalDim(Val* dim1, Val* dim2);
+  //! Symbolically analyze if two extent vals are equal. Extents of exactly
+  //! mapped domains are considered equal
+  bool equalDim(Val* dim1, Val* dim2) const;
 
  private:
   //! Register the extent of an IterDomain if its constant
   void registerConstantExtent(IterDomain* id);
 
+  //! Register the extents of the root, rfactor and leaf domains of tv with
+  //! their exact concrete domains
+  void registerExtents(TensorView* tv);
+
   void handleParallelDomain(IterDomain* id);
 
   void populateDimensionMapWithSingleCASet(
@@ -74,6 +79,9 @@ class TORCH_CUDA_CU_API ParallelDimensionMap {
   //! represented by the concrete domain.
   std::unordered_map<IterDomain*, std::unordered_set<int64_t>>
       constant_extent_map_;
+  //! Exact concrete domain of the domains each extent belongs to, nullptr if
+  //! the extent is shared by domains that aren't exactly mapped
+  std::unordered_map<Val*, IterDomain*> extent_concrete_map_;
 };
 
 } // namespace nvfuser
@@ -5,11 +5,269 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 // clang-format on
+#include <c10/util/irange.h>
 #include <instrumentation.h>
+#include <kernel_db/utils.h>
 #include <python_frontend/fusion_cache.h>
 
+#include <cstdio>
+
 namespace nvfuser::python_frontend {
 
+// Note [ Serialized FusionCache ]
+//
+// FusionCache::serialize writes the trie of records to a binary file so that
+// other processes, e.g. the replicas of a model, can restore it with
+// FusionCache::deserialize instead of defining every fusion again. The file
+// starts with a magic string and the number of fusions, followed by the trie
+// nodes in pre-order. Each node is written as its record, i.e. the data
+// common to all records (type, name, args, and outputs) followed by the
+// child class specific data written by RecordFunctor::serializeData, and
+// then either the fusion id of a terminal node or the number of children.
+//
+// Records capturing an arith function write the signature of the function,
+// which together with the record name identifies the function in the
+// registry filled by the python bindings. The encoding is specific to a
+// build of nvFuser as it relies on typeid names and the in-memory layout of
+// the record data.
+//
+// Deserializing builds the unscheduled Fusion IR of every fusion, so fusions
+// can be executed by id right away. The compiled kernels and the scheduling
+// decisions of the fusions are not part of the file, they are restored from
+// the kernel db instead, see Note [ Kernel DB layout ] in kernel_db.cpp.
+// User defined schedules are not serialized.
+
+namespace {
+
+const char kSerializedCacheMagic[] = "NVFPFC01";
+
+std::mutex& recordDeserializersLock() {
+  static std::mutex lock;
+  return lock;
+}
+
+std::unordered_map<std::string, RecordDeserializer>& recordDeserializers() {
+  static std::unordered_map<std::string, RecordDeserializer> deserializers;
+  return deserializers;
+}
+
+template <typename RecordClass>
+bool isSerializedAs(const std::string& type_name) {
+  return type_name == typeid(RecordClass).name();
+}
+
+//! Creates a record from the data written by RecordFunctor::serialize
+RecordFunctor* deserializeRecord(RecordReader& reader) {
+  const auto record_type = reader.read<RecordType>();
+  auto name = reader.read<std::string>();
+  auto args = reader.read<std::vector<State>>();
+  auto outputs = reader.read<std::vector<State>>();
+
+  switch (record_type) {
+    case RecordType::Op:
+    case RecordType::CastOp:
+    case RecordType::ReductionOp: {
+      const auto key = name + reader.read<std::string>();
+      const RecordDeserializer* deserializer = getRecordDeserializer(key);
+      TORCH_CHECK(
+          deserializer != nullptr,
+          "No arith function is registered for the serialized record ",
+          name,
+          ". Are the python bindings loaded?");
+      return (*deserializer)(std::move(args), std::move(outputs), reader);
+    }
+    case RecordType::BatchNormOp: {
+      const auto training = reader.read<bool>();
+      const auto channels_last = reader.read<bool>();
+      return new BatchNormOpRecord(
+          std::move(args), std::move(outputs), training, channels_last);
+    }
+    case RecordType::BroadcastOp: {
+      auto is_broadcast_dim = reader.read<std::vector<bool>>();
+      return new BroadcastOpRecord(
+          std::move(args), std::move(outputs), name, is_broadcast_dim);
+    }
+    case RecordType::BroadcastInDimOp: {
+      const auto type_name = reader.read<std::string>();
+      if (isSerializedAs<BroadcastInDimOpRecord<int64_t>>(type_name)) {
+        auto output_shape = reader.read<std::vector<int64_t>>();
+        auto broadcast_dims = reader.read<std::vector<int64_t>>();
+        return new BroadcastInDimOpRecord<int64_t>(
+            std::move(args),
+            std::move(outputs),
+            name,
+            output_shape,
+            broadcast_dims);
+      }
+      TORCH_CHECK(
+          isSerializedAs<BroadcastInDimOpRecord<State>>(type_name),
+          "Unexpected serialized broadcast_in_dim record: ",
+          type_name);
+      auto output_shape = reader.read<std::vector<State>>();
+      auto broadcast_dims = reader.read<std::vector<int64_t>>();
+      return new BroadcastInDimOpRecord<State>(
+          std::move(args),
+          std::move(outputs),
+          name,
+          output_shape,
+          broadcast_dims);
+    }
+    case RecordType::CatOp:
+      return new CatOpRecord(
+          std::move(args), std::move(outputs), reader.read<int64_t>());
+    case RecordType::Constant: {
+      const auto type_name = reader.read<std::string>();
+      if (isSerializedAs<ConstantRecord<Bool, bool>>(type_name)) {
+        const auto value = reader.read<bool>();
+        return new ConstantRecord<Bool, bool>(
+            std::move(outputs), value, reader.read<PrimDataType>());
+      } else if (isSerializedAs<ConstantRecord<Double, double>>(type_name)) {
+        const auto value = reader.read<double>();
+        return new ConstantRecord<Double, double>(
+            std::move(outputs), value, reader.read<PrimDataType>());
+      } else if (isSerializedAs<ConstantRecord<Int, int64_t>>(type_name)) {
+        const auto value = reader.read<int64_t>();
+        return new ConstantRecord<Int, int64_t>(
+            std::move(outputs), value, reader.read<PrimDataType>());
+      }
+      using ComplexConstantRecord =
+          ConstantRecord<ComplexDouble, std::complex<double>>;
+      TORCH_CHECK(
+          isSerializedAs<ComplexConstantRecord>(type_name),
+          "Unexpected serialized constant record: ",
+          type_name);
+      const auto value = reader.read<std::complex<double>>();
+      return new ComplexConstantRecord(
+          std::move(outputs), value, reader.read<PrimDataType>());
+    }
+    case RecordType::End:
+      return new EndRecord();
+    case RecordType::FullOp: {
+      auto shape = reader.read<std::vector<int64_t>>();
+      return new FullOpRecord(
+          std::move(args),
+          std::move(outputs),
+          shape,
+          reader.read<PrimDataType>());
+    }
+    case RecordType::IotaOp:
+      return new IotaOpRecord(
+          std::move(args), std::move(outputs), reader.read<PrimDataType>());
+    case RecordType::IndexSelectOp:
+      return new IndexSelectOpRecord(
+          std::move(args), std::move(outputs), reader.read<int64_t>());
+    case RecordType::TorchGatherOp:
+      return new TorchGatherOpRecord(
+          std::move(args), std::move(outputs), reader.read<int64_t>());
+    case RecordType::Output: {
+      const auto type_name = reader.read<std::string>();
+      auto stride_order = reader.read<std::vector<int64_t>>();
+      if (isSerializedAs<OutputRecord<TensorView>>(type_name)) {
+        return new OutputRecord<TensorView>(
+            std::move(args), std::move(stride_order));
+      }
+      TORCH_CHECK(
+          isSerializedAs<OutputRecord<Val>>(type_name),
+          "Unexpected serialized output record: ",
+          type_name);
+      return new OutputRecord<Val>(std::move(args), std::move(stride_order));
+    }
+    case RecordType::PadOp: {
+      auto pad_widths = reader.read<std::vector<int64_t>>();
+      return new PadOpRecord(std::move(args), std::move(outputs), pad_widths);
+    }
+    case RecordType::PermuteOp: {
+      auto dims = reader.read<std::vector<int64_t>>();
+      return new PermuteOpRecord(std::move(args), std::move(outputs), dims);
+    }
+    case RecordType::Scalar:
+      return new ScalarRecord(std::move(outputs), reader.read<PrimDataType>());
+    case RecordType::SliceOp: {
+      auto start_indices = reader.read<std::vector<int64_t>>();
+      auto end_indices = reader.read<std::vector<int64_t>>();
+      auto strides = reader.read<std::vector<int64_t>>();
+      return new SliceOpRecord(
+          std::move(args),
+          std::move(outputs),
+          std::move(start_indices),
+          std::move(end_indices),
+          std::move(strides));
+    }
+    case RecordType::SqueezeOp: {
+      auto original_shape = reader.read<std::vector<int64_t>>();
+      auto dims = reader.read<std::vector<int64_t>>();
+      return new SqueezeOpRecord(
+          std::move(args), std::move(outputs), original_shape, dims);
+    }
+    case RecordType::Start:
+      return new StartRecord();
+    case RecordType::Tensor: {
+      auto symbolic_sizes = reader.read<std::vector<int64_t>>();
+      auto contiguous_info =
+          reader.read<std::vector<c10::optional<bool>>>();
+      const auto dtype = reader.read<PrimDataType>();
+      const auto is_cpu = reader.read<bool>();
+      return new TensorRecord(
+          std::move(outputs),
+          std::move(symbolic_sizes),
+          std::move(contiguous_info),
+          dtype,
+          is_cpu);
+    }
+    case RecordType::TensorSizes:
+      return new TensorSizesRecord(std::move(args), std::move(outputs));
+    case RecordType::VarianceOp:
+    case RecordType::VarianceMeanOp: {
+      auto axes = reader.read<std::vector<int>>();
+      const auto correction = reader.read<int64_t>();
+      const auto keep_dim = reader.read<bool>();
+      if (record_type == RecordType::VarianceOp) {
+        return new VarianceOpRecord(
+            std::move(args), std::move(outputs), axes, correction, keep_dim);
+      }
+      return new VarianceMeanOpRecord(
+          std::move(args), std::move(outputs), axes, correction, keep_dim);
+    }
+    case RecordType::ReshapeOp: {
+      auto original_shape = reader.read<std::vector<int64_t>>();
+      auto new_shape = reader.read<std::vector<int64_t>>();
+      return new ReshapeOpRecord(
+          std::move(args), std::move(outputs), original_shape, new_shape);
+    }
+    case RecordType::RandomOp: {
+      auto output_shape = reader.read<std::vector<State>>();
+      return new RandomOpRecord(
+          std::move(args),
+          std::move(outputs),
+          output_shape,
+          name,
+          reader.read<PrimDataType>());
+    }
+    default:
+      break;
+  }
+  TORCH_CHECK(
+      false,
+      "Unexpected record type in serialized FusionCache: ",
+      static_cast<int>(record_type));
+  return nullptr;
+}
+
+} // namespace
+
+void registerRecordDeserializer(
+    const std::string& key,
+    RecordDeserializer deserializer) {
+  std::lock_guard<std::mutex> guard(recordDeserializersLock());
+  recordDeserializers()[key] = std::move(deserializer);
+}
+
+const RecordDeserializer* getRecordDeserializer(const std::string& key) {
+  std::lock_guard<std::mutex> guard(recordDeserializersLock());
+  auto it = recordDeserializers().find(key);
+  return it == recordDeserializers().end() ? nullptr : &it->second;
+}
+
 // FusionCache static data member definitions for singleton usage
 std::mutex FusionCache::singleton_lock_;
 FusionCache* FusionCache::singleton_ = nullptr;
@@ -19,6 +277,44 @@ UserSchedule::UserSchedule() : schedule(nullptr), executor(nullptr) {
   executor = std::make_unique<FusionExecutor>();
 }
 
+// Note [ Symbolic user schedules ]
+//
+// A user schedule is compiled for the inputs it was defined with and keyed by
+// their exact encoding, so a tuned schedule only applies to a single shape.
+// Schedules that don't depend on the concrete sizes, e.g. that only split
+// by constants the sizes are known to be divisible by, can instead be
+// registered with constraints on the sizes of the inputs. Executions whose
+// inputs satisfy the constraints of a symbolic schedule run its kernel,
+// which is compiled once and only evaluates the launch parameters for the
+// new sizes. It is up to the user to pick constraints the schedule is valid
+// for; the executor still validates e.g. the alignment of vectorized inputs.
+
+bool SymbolicUserSchedule::matches(
+    const at::ArrayRef<c10::IValue>& inputs) const {
+  if (inputs.size() != constraints.size()) {
+    return false;
+  }
+  for (const auto i : c10::irange(inputs.size())) {
+    const auto& dims = constraints[i];
+    if (dims.empty()) {
+      continue;
+    }
+    if (!inputs[i].isTensor()) {
+      return false;
+    }
+    const auto sizes = inputs[i].toTensor().sizes();
+    if (sizes.size() != dims.size()) {
+      return false;
+    }
+    for (const auto d : c10::irange(dims.size())) {
+      if (!dims[d].matches(sizes[d])) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
 FusionSchedules::FusionSchedules()
     : auto_gen_schedules(nullptr), user_def_schedules(), scheds_lock() {
   auto_gen_schedules =
@@ -31,18 +327,111 @@ Fusion* FusionSchedules::preschedFusion() {
   return fusion;
 }
 
+// Note [ Lock-free trie lookups ]
+//
+// Every record of every FusionDefinition looks up a child of a trie node, so
+// the lookups must not serialize threads defining fusions on the hot nodes
+// near the root. The children of a node are published in an open addressing
+// hash table whose slots are only set once with a release store. A lookup
+// loads the table and probes its slots with acquire loads, so a child found
+// is always completely constructed. It doesn't lock; the only shared writes
+// are the relaxed increments of the visit counters.
+//
+// Children are only added under the lock of the node, which also serializes
+// the adds with the lookup that createChild repeats in case another thread
+// added the same child since the lock-free lookup missed. Before a table
+// gets half full, the children are copied to a table of twice the capacity,
+// which is then published. Lookups still probing the replaced table see a
+// consistent, if possibly stale, set of children, and a stale miss only
+// leads to the locked lookup in createChild. Replaced tables are kept alive
+// with their node as there is no way to tell when the lookups probing them
+// are done. Children are never removed.
+
+TrieNode::ChildTable::ChildTable(size_t _capacity)
+    : capacity(_capacity), slots(new std::atomic<TrieNode*>[_capacity]) {
+  TORCH_INTERNAL_ASSERT(
+      (capacity & (capacity - 1)) == 0,
+      "Capacity of the child table must be a power of 2.");
+  for (size_t i = 0; i < capacity; ++i) {
+    slots[i].store(nullptr, std::memory_order_relaxed);
+  }
+}
+
+void TrieNode::ChildTable::insert(TrieNode* child) {
+  const size_t mask = capacity - 1;
+  for (size_t i = child->record_hash & mask;; i = (i + 1) & mask) {
+    if (slots[i].load(std::memory_order_relaxed) == nullptr) {
+      slots[i].store(child, std::memory_order_release);
+      ++size;
+      return;
+    }
+  }
+}
+
 TrieNode::TrieNode(RecordFunctor* rec, TrieNode* _parent, size_t _fusion_id)
     : record(rec),
-      children(),
+      record_hash(rec->hash()),
       fusion_id(_fusion_id),
       visits(0),
       parent(_parent),
-      trie_node_lock() {}
+      trie_node_lock(),
+      child_table_(nullptr),
+      child_tables_(),
+      owned_children_() {}
 
 bool TrieNode::isTerminal() const {
   return (record.get()->recordType() == RecordType::End);
 }
 
+TrieNode* TrieNode::findChild(const RecordFunctor* rec) const {
+  const ChildTable* table = child_table_.load(std::memory_order_acquire);
+  if (table == nullptr) {
+    return nullptr;
+  }
+  const size_t hash = rec->hash();
+  const size_t mask = table->capacity - 1;
+  // Tables are at most half full, so the probing reaches an empty slot
+  for (size_t i = hash & mask;; i = (i + 1) & mask) {
+    TrieNode* child = table->slots[i].load(std::memory_order_acquire);
+    if (child == nullptr) {
+      return nullptr;
+    }
+    if (child->record_hash == hash && *child->record == *rec) {
+      return child;
+    }
+  }
+}
+
+void TrieNode::addChild(std::unique_ptr<TrieNode> child) {
+  ChildTable* table = child_table_.load(std::memory_order_relaxed);
+  if (table == nullptr || 2 * (table->size + 1) > table->capacity) {
+    auto new_table = std::make_unique<ChildTable>(
+        table == nullptr ? 4 : 2 * table->capacity);
+    for (auto& owned_child : owned_children_) {
+      new_table->insert(owned_child.get());
+    }
+    new_table->insert(child.get());
+    child_table_.store(new_table.get(), std::memory_order_release);
+    child_tables_.push_back(std::move(new_table));
+  } else {
+    table->insert(child.get());
+  }
+  owned_children_.push_back(std::move(child));
+}
+
+std::vector<TrieNode*> TrieNode::children() const {
+  std::vector<TrieNode*> result;
+  const ChildTable* table = child_table_.load(std::memory_order_acquire);
+  if (table != nullptr) {
+    for (size_t i = 0; i < table->capacity; ++i) {
+      if (TrieNode* child = table->slots[i].load(std::memory_order_acquire)) {
+        result.push_back(child);
+      }
+    }
+  }
+  return result;
+}
+
 FusionCache* FusionCache::get(size_t max_fusions) {
   FUSER_PERF_SCOPE("FusionCache::get");
   std::lock_guard<std::mutex> guard(singleton_lock_);
@@ -57,6 +446,7 @@ FusionCache* FusionCache::get(size_t max_fusions) {
 }
 
 size_t FusionCache::numFusions() const {
+  std::lock_guard<std::mutex> guard(fusions_lock_);
   return fusions_.size();
 }
 
@@ -89,8 +479,8 @@ void FusionCache::print(std::ostream& os) const {
             os << std::endl;
           });
     } else {
-      for (auto& iter : node->children) {
-        stack.push_back(iter.second.get());
+      for (TrieNode* child : node->children()) {
+        stack.push_back(child);
       }
     }
   }
@@ -105,14 +495,14 @@ void FusionCache::stats(std::ostream& os) const {
     auto total_cache_hits = 0;
     for (size_t i = 0; i < terminal_nodes_.size(); ++i) {
       // The first visit is a miss!
-      auto visits = terminal_nodes_[i]->visits - 1;
+      auto visits = terminal_nodes_[i]->visits.load() - 1;
       total_cache_hits += visits;
       os << "\t" << i << " -> " << visits << " hits\n";
     }
 
     auto hit_rate = static_cast<float>(total_cache_hits) /
-        static_cast<float>(root_->visits) * 100.0;
-    os << "Cache Lookups: " << root_->visits;
+        static_cast<float>(root_->visits.load()) * 100.0;
+    os << "Cache Lookups: " << root_->visits.load();
     os << " Cache Hits: " << total_cache_hits;
     os << " Hit Rate: " << hit_rate << "%\n";
   }
@@ -122,11 +512,141 @@ void FusionCache::reset() {
   std::lock_guard<std::mutex> guard(singleton_lock_);
   if (singleton_ != nullptr) {
     auto max_fusions = singleton_->max_fusions_;
+    auto max_resident_fusions = singleton_->max_resident_fusions_;
+    auto max_resident_bytes = singleton_->max_resident_bytes_;
+    auto eviction_policy = singleton_->eviction_policy_;
     delete singleton_;
     singleton_ = new FusionCache(max_fusions);
+    singleton_->max_resident_fusions_ = max_resident_fusions;
+    singleton_->max_resident_bytes_ = max_resident_bytes;
+    singleton_->eviction_policy_ = eviction_policy;
   }
 }
 
+void FusionCache::serialize(const std::string& filename) const {
+  FUSER_PERF_SCOPE("FusionCache::serialize");
+  std::vector<char> buffer;
+  RecordWriter writer(buffer);
+  writer.write(std::string(kSerializedCacheMagic));
+  writer.write(static_cast<uint64_t>(fusions_.size()));
+
+  // Pre-order traversal, each node is followed by its subtrees
+  std::vector<TrieNode*> stack;
+  stack.push_back(root_.get());
+  while (!stack.empty()) {
+    TrieNode* node = stack.back();
+    stack.pop_back();
+    node->record->serialize(writer);
+    if (node->isTerminal()) {
+      writer.write(static_cast<uint64_t>(node->fusion_id));
+    } else {
+      const auto children = node->children();
+      writer.write(static_cast<uint64_t>(children.size()));
+      stack.insert(stack.end(), children.begin(), children.end());
+    }
+  }
+
+  // Rename the complete file into place so that processes restoring the
+  // cache never read a partially written one
+  const std::string tmp_filename = filename + ".tmp";
+  TORCH_CHECK(
+      copy_to_binary_file(tmp_filename, buffer) &&
+          std::rename(tmp_filename.c_str(), filename.c_str()) == 0,
+      "Failed to write serialized FusionCache to ",
+      filename);
+}
+
+void FusionCache::deserialize(const std::string& filename) {
+  FUSER_PERF_SCOPE("FusionCache::deserialize");
+  TORCH_CHECK(
+      fusions_.empty(), "Only an empty FusionCache can be deserialized!");
+  MappedFile file(filename);
+  TORCH_CHECK(
+      file.valid(), "Failed to open serialized FusionCache: ", filename);
+  RecordReader reader(file.data(), file.size());
+  TORCH_CHECK(
+      reader.read<std::string>() == kSerializedCacheMagic,
+      "Not a serialized FusionCache of this build of nvFuser: ",
+      filename);
+  const auto num_fusions = reader.read<uint64_t>();
+  TORCH_CHECK(
+      num_fusions <= max_fusions_,
+      "The serialized FusionCache holds more than ",
+      max_fusions_,
+      " fusions.");
+
+  // The trie is restored on the side so that the cache is left unchanged
+  // if the file turns out to be invalid
+  std::unique_ptr<RecordFunctor> start(deserializeRecord(reader));
+  TORCH_CHECK(
+      start->recordType() == RecordType::Start,
+      "The serialized FusionCache should start with a StartRecord!");
+  auto root = std::make_unique<TrieNode>(start.release());
+  std::vector<std::unique_ptr<FusionSchedules>> fusions(num_fusions);
+  std::vector<TrieNode*> terminal_nodes(num_fusions, nullptr);
+
+  // Nodes whose children are being read with the number of children left
+  std::vector<std::pair<TrieNode*, uint64_t>> stack;
+  stack.emplace_back(root.get(), reader.read<uint64_t>());
+  while (!stack.empty()) {
+    TrieNode* node = stack.back().first;
+    if (stack.back().second == 0) {
+      stack.pop_back();
+      continue;
+    }
+    --stack.back().second;
+
+    RecordFunctor* rec = deserializeRecord(reader);
+    auto child = std::make_unique<TrieNode>(rec, node);
+    TrieNode* child_ptr = child.get();
+    TORCH_CHECK(
+        node->findChild(rec) == nullptr,
+        "Duplicate record in serialized FusionCache!");
+    // The restored trie is not shared with other threads yet
+    node->addChild(std::move(child));
+    if (!child_ptr->isTerminal()) {
+      stack.emplace_back(child_ptr, reader.read<uint64_t>());
+      continue;
+    }
+
+    const auto fusion_id = reader.read<uint64_t>();
+    TORCH_CHECK(
+        fusion_id < num_fusions && terminal_nodes.at(fusion_id) == nullptr,
+        "Invalid fusion id in serialized FusionCache: ",
+        fusion_id);
+    child_ptr->fusion_id = fusion_id;
+    // The restoring counts as the first visit, which is a miss
+    child_ptr->visits = 1;
+    terminal_nodes.at(fusion_id) = child_ptr;
+
+    // Build the unscheduled Fusion IR from the records on the path to the
+    // terminal node just like FusionDefinition::finalizeDefinition does
+    std::vector<TrieNode*> path;
+    for (TrieNode* n = node; n->parent != nullptr; n = n->parent) {
+      path.push_back(n);
+    }
+    FusionState state;
+    std::for_each(path.rbegin(), path.rend(), [&state](TrieNode* n) {
+      state.addRecord(n->record->clone());
+    });
+    fusions.at(fusion_id) = std::make_unique<FusionSchedules>();
+    state.buildFusionIr(fusions.at(fusion_id)->preschedFusion());
+  }
+  TORCH_CHECK(
+      reader.done() &&
+          std::none_of(
+              terminal_nodes.begin(),
+              terminal_nodes.end(),
+              [](TrieNode* n) { return n == nullptr; }),
+      "Invalid serialized FusionCache: ",
+      filename);
+
+  std::lock_guard<std::mutex> guard(fusions_lock_);
+  root_ = std::move(root);
+  fusions_ = std::move(fusions);
+  terminal_nodes_ = std::move(terminal_nodes);
+}
+
 FusionCache::FusionCache(size_t max_fusions)
     : max_fusions_(max_fusions),
       root_(nullptr),
@@ -137,33 +657,222 @@ FusionCache::FusionCache(size_t max_fusions)
   root_ = std::make_unique<TrieNode>(start);
 }
 
-// In order to keep queries fast, this method does not lock.
-// In the worst case, the query should fail and if you try to create a child,
-// it should give you back an already created child if two threads are walking
-// the trie at the same time with the same definition.
+// In order to keep queries fast, this method does not lock, see
+// Note [ Lock-free trie lookups ]. In the worst case, the query should fail
+// and if you try to create a child, it should give you back an already
+// created child if two threads are walking the trie at the same time with the
+// same definition.
 c10::optional<TrieNode*> FusionCache::queryChildren(
     TrieNode* node,
     RecordFunctor* rec) const {
   TORCH_CHECK(
       !node->isTerminal(), "There should be no children from a Terminal Node!");
   TORCH_CHECK(rec, "Record is null!");
-  auto trie_node = node->children.find(rec);
-  if (trie_node == std::end(node->children)) {
+  TrieNode* child = node->findChild(rec);
+  if (child == nullptr) {
     return c10::nullopt;
-  } else {
-    ++(trie_node->second.get()->visits);
-    return c10::optional<TrieNode*>(trie_node->second.get());
   }
+  child->visits.fetch_add(1, std::memory_order_relaxed);
+  return c10::optional<TrieNode*>(child);
 }
 FusionSchedules* FusionCache::queryFusionSchedules(size_t fusion_id) const {
+  std::lock_guard<std::mutex> guard(fusions_lock_);
   TORCH_CHECK(
       fusion_id < fusions_.size(),
       "Invalid scheduler query for id:",
       fusion_id);
   FusionSchedules* ptr = fusions_.at(fusion_id).get();
-  TORCH_CHECK(ptr != nullptr, "Unexpected null FusionSchedules object.");
+  TORCH_CHECK(
+      ptr != nullptr,
+      "The schedules of fusion ",
+      fusion_id,
+      " were evicted from the FusionCache, the fusion has to be defined ",
+      "again.");
+  ptr->last_use.store(
+      use_clock_.fetch_add(1, std::memory_order_relaxed) + 1,
+      std::memory_order_relaxed);
+  ptr->num_uses.fetch_add(1, std::memory_order_relaxed);
   return ptr;
 }
+
+namespace {
+
+//! Whether the path from the root to the terminal `node` holds `records`
+bool isDefinitionOf(
+    const TrieNode* node,
+    const std::vector<std::unique_ptr<RecordFunctor>>& records) {
+  const TrieNode* parent = node->parent;
+  for (auto it = records.rbegin(); it != records.rend(); ++it) {
+    if (parent == nullptr ||
+        parent->record->recordType() == RecordType::Start ||
+        !(*parent->record == **it)) {
+      return false;
+    }
+    parent = parent->parent;
+  }
+  return parent != nullptr &&
+      parent->record->recordType() == RecordType::Start;
+}
+
+} // namespace
+
+TrieNode* FusionCache::queryDefinition(
+    size_t fingerprint,
+    const std::vector<std::unique_ptr<RecordFunctor>>& records) const {
+  FUSER_PERF_SCOPE("FusionCache::queryDefinition");
+  std::lock_guard<std::mutex> guard(fusions_lock_);
+  auto it = definitions_.find(fingerprint);
+  if (it == definitions_.end()) {
+    return nullptr;
+  }
+  for (TrieNode* node : it->second) {
+    if (isDefinitionOf(node, records)) {
+      node->visits.fetch_add(1, std::memory_order_relaxed);
+      return node;
+    }
+  }
+  return nullptr;
+}
+
+void FusionCache::registerDefinition(size_t fingerprint, TrieNode* node) {
+  TORCH_INTERNAL_ASSERT(node->isTerminal(), "Expected a terminal node!");
+  std::lock_guard<std::mutex> guard(fusions_lock_);
+  auto& nodes = definitions_[fingerprint];
+  if (std::find(nodes.begin(), nodes.end(), node) == nodes.end()) {
+    nodes.push_back(node);
+  }
+}
+
+bool FusionCache::reviveFusion(TrieNode* node) {
+  TORCH_INTERNAL_ASSERT(node->isTerminal(), "Expected a terminal node!");
+  std::lock_guard<std::mutex> guard(fusions_lock_);
+  auto& scheds = fusions_.at(node->fusion_id);
+  if (scheds != nullptr) {
+    hits_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  if (isDebugDumpEnabled(DebugDumpOption::PythonFrontendDebug)) {
+    std::cout << "\nFusionCache: Reviving evicted fusion " << node->fusion_id
+              << "\n";
+  }
+  misses_.fetch_add(1, std::memory_order_relaxed);
+  scheds = std::make_unique<FusionSchedules>();
+  evictFusions(node->fusion_id);
+  return true;
+}
+
+// Note [ FusionCache eviction ]
+//
+// With dynamic shapes or generated definitions, the number of fusions grows
+// without bound, and each of them holds a FusionExecutorCache with its
+// kernels. setEvictionPolicy bounds the resident fusions by their number
+// and/or by the host memory of their kernels. Whenever the schedules of a
+// fusion are created, the schedules of other fusions are evicted until the
+// budget holds again, picking the least recently or the least frequently
+// used ones. A use is any query of the schedules, e.g. an execution.
+//
+// Only the schedules are evicted, which drops the Fusion IR, the kernels and
+// the user schedules of a fusion. Its path in the trie stays, as lookups
+// don't lock, and it's small compared to the kernels. Defining an evicted
+// fusion again finds its terminal node and rebuilds the schedules under the
+// same fusion id. A FusionDefinition that still refers to an evicted fusion
+// has to be defined again before it can be executed.
+//
+// Evicting destroys the schedules, so like the other Thread-Unsafe methods it
+// relies on the Python GIL; executions from other threads must not overlap
+// the creation of fusions when a budget is set. By default it's unbounded.
+
+void FusionCache::setEvictionPolicy(
+    size_t max_resident_fusions,
+    size_t max_resident_bytes,
+    FusionEvictionPolicy policy) {
+  std::lock_guard<std::mutex> guard(fusions_lock_);
+  max_resident_fusions_ = max_resident_fusions;
+  max_resident_bytes_ = max_resident_bytes;
+  eviction_policy_ = policy;
+  evictFusions(fusions_.size());
+}
+
+void FusionCache::evictFusions(size_t keep_id) {
+  if (max_resident_fusions_ == 0 && max_resident_bytes_ == 0) {
+    return;
+  }
+
+  size_t resident_fusions = 0;
+  size_t resident_bytes = 0;
+  std::vector<size_t> host_bytes(fusions_.size(), 0);
+  for (const auto i : c10::irange(fusions_.size())) {
+    if (fusions_[i] == nullptr) {
+      continue;
+    }
+    ++resident_fusions;
+    if (max_resident_bytes_ > 0) {
+      host_bytes[i] =
+          fusions_[i]->auto_gen_schedules->compiledKernelStats().host_bytes;
+      resident_bytes += host_bytes[i];
+    }
+  }
+
+  auto colder = [this](const FusionSchedules& a, const FusionSchedules& b) {
+    const auto a_last_use = a.last_use.load(std::memory_order_relaxed);
+    const auto b_last_use = b.last_use.load(std::memory_order_relaxed);
+    if (eviction_policy_ == FusionEvictionPolicy::LFU) {
+      const auto a_uses = a.num_uses.load(std::memory_order_relaxed);
+      const auto b_uses = b.num_uses.load(std::memory_order_relaxed);
+      if (a_uses != b_uses) {
+        return a_uses < b_uses;
+      }
+    }
+    return a_last_use < b_last_use;
+  };
+
+  while ((max_resident_fusions_ > 0 &&
+          resident_fusions > max_resident_fusions_) ||
+         (max_resident_bytes_ > 0 && resident_bytes > max_resident_bytes_)) {
+    c10::optional<size_t> victim = c10::nullopt;
+    for (const auto i : c10::irange(fusions_.size())) {
+      if (i == keep_id || fusions_[i] == nullptr) {
+        continue;
+      }
+      if (!victim.has_value() || colder(*fusions_[i], *fusions_[*victim])) {
+        victim = i;
+      }
+    }
+    if (!victim.has_value()) {
+      break;
+    }
+    if (isDebugDumpEnabled(DebugDumpOption::PythonFrontendDebug)) {
+      std::cout << "\nFusionCache: Evicting fusion " << victim.value()
+                << "\n";
+    }
+    fusions_[*victim].reset();
+    --resident_fusions;
+    resident_bytes -= host_bytes[*victim];
+    evictions_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+FusionCacheStats FusionCache::statistics() const {
+  FusionCacheStats stats;
+  stats.hits = hits_.load(std::memory_order_relaxed);
+  stats.misses = misses_.load(std::memory_order_relaxed);
+  stats.lookups = stats.hits + stats.misses;
+  stats.evictions = evictions_.load(std::memory_order_relaxed);
+
+  std::lock_guard<std::mutex> guard(fusions_lock_);
+  stats.num_fusions = fusions_.size();
+  for (const auto& scheds : fusions_) {
+    if (scheds == nullptr) {
+      continue;
+    }
+    ++stats.resident_fusions;
+    const auto kernel_stats = scheds->auto_gen_schedules->compiledKernelStats();
+    stats.compiled_kernels += kernel_stats.num_kernels;
+    stats.compile_ms += kernel_stats.compile_ms;
+    stats.resident_bytes += kernel_stats.host_bytes;
+  }
+  return stats;
+}
 c10::optional<size_t> FusionCache::queryUserScheduleId(
     const FusionSchedules* scheds,
     const at::ArrayRef<c10::IValue>& inputs,
@@ -194,6 +903,23 @@ const UserSchedule& FusionCache::queryUserSchedule(
   return user_sched->second.at(device);
 }
 
+const UserSchedule* FusionCache::querySymbolicUserSchedule(
+    const FusionSchedules* scheds,
+    const at::ArrayRef<c10::IValue>& inputs,
+    int device) const {
+  for (const auto& symbolic_sched : scheds->symbolic_user_schedules) {
+    if (static_cast<size_t>(device) >= symbolic_sched.schedules.size() ||
+        !symbolic_sched.matches(inputs)) {
+      continue;
+    }
+    const auto& user_sched = symbolic_sched.schedules.at(device);
+    if (user_sched.executor->compiled()) {
+      return &user_sched;
+    }
+  }
+  return nullptr;
+}
+
 TrieNode* FusionCache::createChild(TrieNode* node, RecordFunctor* rec) {
   FUSER_PERF_SCOPE("FusionCache::createChild");
   TrieNode* child = nullptr;
@@ -210,7 +936,9 @@ TrieNode* FusionCache::createChild(TrieNode* node, RecordFunctor* rec) {
     child = child_node.value();
   } else {
     size_t fusion_id = 0;
+    std::unique_lock<std::mutex> fusions_guard(fusions_lock_, std::defer_lock);
     if (rec->recordType() == RecordType::End) {
+      fusions_guard.lock();
       TORCH_CHECK(
           (fusions_.size() + 1) <= max_fusions_,
           "The number of fusions in nvfuser has exceeded ",
@@ -219,6 +947,8 @@ TrieNode* FusionCache::createChild(TrieNode* node, RecordFunctor* rec) {
           "increased if the max number is not being exceeded due to an error.");
       fusions_.emplace_back(std::make_unique<FusionSchedules>());
       fusion_id = fusions_.size() - 1;
+      misses_.fetch_add(1, std::memory_order_relaxed);
+      evictFusions(fusion_id);
     }
 
     // Copying the record owned by the FusionDefinition that calls this function
@@ -226,15 +956,14 @@ TrieNode* FusionCache::createChild(TrieNode* node, RecordFunctor* rec) {
     // than managing a shared pointer that would only share with
     // FusionDefinition that creates a trie node but not cache lookups
     RecordFunctor* new_rec = rec->clone();
-    node->children[new_rec] =
-        std::make_unique<TrieNode>(new_rec, node, fusion_id);
-    child = node->children[new_rec].get();
+    auto new_child = std::make_unique<TrieNode>(new_rec, node, fusion_id);
+    child = new_child.get();
     ++(child->visits);
-    TORCH_CHECK(
-        child != nullptr, "Created child of TrieNode should not be null!");
     if (rec->recordType() == RecordType::End) {
-      terminal_nodes_.push_back(node->children[new_rec].get());
+      terminal_nodes_.push_back(child);
     }
+    // Publishes the child to lock-free lookups, so it must be complete
+    node->addChild(std::move(new_child));
     if (isDebugDumpEnabled(DebugDumpOption::PythonFrontendDebug)) {
       std::stringstream ss;
       new_rec->print(ss);
@@ -264,9 +993,43 @@ UserSchedule* FusionCache::createUserSchedule(
   return &user_scheds[input_id.id].at(device);
 }
 
+UserSchedule* FusionCache::createSymbolicUserSchedule(
+    FusionSchedules* scheds,
+    const InputShapeConstraints& constraints,
+    int device) {
+  FUSER_PERF_SCOPE("FusionCache::createSymbolicUserSchedule");
+  std::lock_guard<std::mutex> guard(scheds->scheds_lock);
+  auto& symbolic_scheds = scheds->symbolic_user_schedules;
+  auto it = std::find_if(
+      symbolic_scheds.begin(),
+      symbolic_scheds.end(),
+      [&constraints](const SymbolicUserSchedule& symbolic_sched) {
+        return symbolic_sched.constraints == constraints;
+      });
+  if (it == symbolic_scheds.end()) {
+    symbolic_scheds.emplace_back();
+    it = symbolic_scheds.end() - 1;
+    it->constraints = constraints;
+  }
+  if (static_cast<size_t>(device) >= it->schedules.size()) {
+    it->schedules.resize(device + 1);
+  }
+  return &it->schedules.at(device);
+}
+
 TrieNode* FusionCache::rootTriePtr() {
-  ++(root_.get()->visits);
+  root_->visits.fetch_add(1, std::memory_order_relaxed);
   return root_.get();
 }
 
+StitchedFusion* FusionCache::queryStitchedFusion(
+    const std::vector<size_t>& key) {
+  std::lock_guard<std::mutex> guard(stitched_fusions_lock_);
+  auto& stitched = stitched_fusions_[key];
+  if (stitched == nullptr) {
+    stitched = std::make_unique<StitchedFusion>();
+  }
+  return stitched.get();
+}
+
 } // namespace nvfuser::python_frontend
@@ -11,6 +11,9 @@
 #include <kernel_cache.h>
 #include <python_frontend/fusion_record.h>
 
+#include <atomic>
+#include <deque>
+#include <map>
 #include <memory>
 #include <mutex>
 
@@ -28,6 +31,18 @@ struct UserSchedule {
   std::unique_ptr<FusionExecutor> executor;
 };
 
+//! \struct SymbolicUserSchedule
+//! \brief A user schedule that applies to all inputs satisfying its shape
+//! constraints, see Note [ Symbolic user schedules ].
+struct SymbolicUserSchedule {
+  //! Whether the sizes of `inputs` satisfy the constraints
+  bool matches(const at::ArrayRef<c10::IValue>& inputs) const;
+
+  InputShapeConstraints constraints;
+  //! A vector based on device_id of User Defined Fusion Schedules.
+  std::vector<UserSchedule> schedules;
+};
+
 //! \struct FusionSchedules
 //! \brief A container for auto generated and user defined schedules
 //! that correspond to compiled kernels for each complete Fusion Definition.
@@ -44,14 +59,71 @@ struct FusionSchedules {
   //!        InputsIdLookup struct found inside of the FusionCache.
   //! Value: A vector based on device_id of User Defined Fusion Schedules.
   std::unordered_map<size_t, std::vector<UserSchedule>> user_def_schedules;
+  //! Schedules defined by the user for all input sizes satisfying some
+  //! constraints, looked up in order if there is no exact user schedule.
+  //! A deque keeps the schedules in place while new ones are appended.
+  std::deque<SymbolicUserSchedule> symbolic_user_schedules;
   //! For thread-Safe locking of Fusion Schedules
   std::mutex scheds_lock;
+  //! Tick of the FusionCache use clock at the last use of the schedules, see
+  //! Note [ FusionCache eviction ]
+  std::atomic<uint64_t> last_use{0};
+  //! Number of uses of the schedules
+  std::atomic<uint64_t> num_uses{0};
+};
+
+//! \struct StitchedFusion
+//! \brief Two fusions that batches run in a row, with outputs of the first
+//! feeding the second, stitched into one, see Note [ Fusion stitching ].
+struct StitchedFusion {
+  //! Runs of the two fusions in a row with the same links
+  size_t num_runs = 0;
+  //! Whether stitching was tried and failed, in which case the fusions keep
+  //! running separately
+  bool unstitchable = false;
+  //! Number of outputs of the first fusion
+  size_t num_producer_outputs = 0;
+  //! Schedules of the stitched fusion, null until it is stitched
+  std::unique_ptr<FusionExecutorCache> executor;
+};
+
+//! Picks the fusion whose schedules are evicted when the FusionCache exceeds
+//! its budget, see Note [ FusionCache eviction ]
+enum class FusionEvictionPolicy {
+  //! the least recently used fusion
+  LRU,
+  //! the least frequently used fusion, ties go to the least recently used
+  LFU,
+};
+
+//! Machine readable counters of the FusionCache, see FusionCache::statistics
+struct TORCH_CUDA_CU_API FusionCacheStats {
+  //! Lookups of complete fusion definitions
+  size_t lookups = 0;
+  //! Lookups that found the schedules of the fusion resident
+  size_t hits = 0;
+  //! Lookups that had to build the fusion, either new or evicted
+  size_t misses = 0;
+  //! Fusions whose schedules were evicted
+  size_t evictions = 0;
+  //! Fusions defined, including the evicted ones
+  size_t num_fusions = 0;
+  //! Fusions whose schedules are resident
+  size_t resident_fusions = 0;
+  //! Kernels compiled for the resident fusions
+  size_t compiled_kernels = 0;
+  //! Total compile time of the kernels of the resident fusions
+  double compile_ms = 0;
+  //! Host memory held by the kernels of the resident fusions
+  size_t resident_bytes = 0;
 };
 
 //! \struct TrieNode
 //! \brief Is the container for a Node in a prefix tree or trie
 //! where each node represents a statement in a fusion definition and
 //! the leaf Nodes represent a complete Fusion that is cached.
+//!
+//! Looking up a child does not lock, see Note [ Lock-free trie lookups ].
 
 struct TORCH_CUDA_CU_API TrieNode {
   TrieNode(
@@ -63,21 +135,49 @@ struct TORCH_CUDA_CU_API TrieNode {
   // a the end of Fusion entry in the cache.
   bool isTerminal() const;
 
+  //! Lock-Free: Returns the child holding a record equal to `rec` or nullptr
+  TrieNode* findChild(const RecordFunctor* rec) const;
+  //! Thread-Unsafe: Adds a child that findChild doesn't find. The caller
+  //! holds trie_node_lock unless no other thread can access the node.
+  void addChild(std::unique_ptr<TrieNode> child);
+  //! Lock-Free: Snapshot of the children in no particular order
+  std::vector<TrieNode*> children() const;
+
   //! An entry's primary data is the record it holds
   std::unique_ptr<RecordFunctor> record;
-  //! A hash map of the children for the current node.
-  //! The hash map hashs a pointer to a RecordFunctor because
-  //! the hash function is virtual.
-  std::unordered_map<RecordFunctor*, std::unique_ptr<TrieNode>> children;
+  //! Hash of the record compared before the records themselves on lookups
+  const size_t record_hash;
   //! An index into FusionCache's vector of nvFuser object that holds an
   //! unscheduled Fusion.  The id is only valid if the entry is terminal.
   size_t fusion_id;
   //! Count of times the Entry is traversed
-  size_t visits;
+  std::atomic<size_t> visits;
   //! Parent node for printing
   TrieNode* parent;
-  //! For thread-Safe locking of a node
+  //! For thread-Safe locking of a node, only taken to add children
   std::mutex trie_node_lock;
+
+ private:
+  //! An open addressing hash table of children whose slots are only ever
+  //! set once. It is replaced by a table of twice the capacity before it
+  //! gets half full.
+  struct ChildTable {
+    explicit ChildTable(size_t _capacity);
+    void insert(TrieNode* child);
+
+    const size_t capacity;
+    std::unique_ptr<std::atomic<TrieNode*>[]> slots;
+    //! Number of children in the table, only accessed by writers
+    size_t size = 0;
+  };
+
+  //! The child table published to lookups
+  std::atomic<ChildTable*> child_table_;
+  //! Owns every child table ever published as lookups may still probe a
+  //! replaced table. Their total size is at most twice the current one.
+  std::vector<std::unique_ptr<ChildTable>> child_tables_;
+  //! Owns the children
+  std::vector<std::unique_ptr<TrieNode>> owned_children_;
 };
 
 //! \class FusionCache
@@ -88,16 +188,15 @@ struct TORCH_CUDA_CU_API TrieNode {
 //! cache fusions.  A leaf of the tree with a terminal node contains a
 //! container for caching the kernels generated for specific fusions.
 //!
-//! \todo
-//! Add the ability to evict a fusion.  There is currently a max number
-//! of fusions that is checked to prevent a runaway case.
+//! The schedules of cold fusions are evicted beyond an optional budget set
+//! by setEvictionPolicy, see Note [ FusionCache eviction ].  There is also a
+//! max number of fusions that is checked to prevent a runaway case.
 //!
 //! \note
-//! Thread-Safety is assured by the Python GIL.  If a no-GIL python is used
-//! then further scrutiny needs to be applied to the mutexes used to limit
-//! acccess to the singleton pointer, node creation, and user schedule
-//! creation.  Otherwise, the Python GIL provides a natural thread based mutex
-//! that does not allow for multiple threads to interact.
+//! Trie lookups are lock-free and nodes are only locked to add children, so
+//! threads defining fusions concurrently don't contend on hot nodes.  The
+//! fusions are guarded by their own mutex.  The remaining methods marked
+//! Thread-Unsafe rely on the Python GIL.
 
 class TORCH_CUDA_CU_API FusionCache {
   //! The constructor is private given the FusionCache is only constructed
@@ -109,7 +208,7 @@ class TORCH_CUDA_CU_API FusionCache {
   FusionCache& operator=(const FusionCache&) = delete;
 
  public:
-  //! The next 4 pubic methods are the python interface methods
+  //! The next 7 pubic methods are the python interface methods
 
   //! Gets a pointer to the singleton and creates a new one if necessary
   static FusionCache* get(size_t max_fusions = 8192);
@@ -121,15 +220,42 @@ class TORCH_CUDA_CU_API FusionCache {
   void stats(std::ostream& os) const;
   //! Reset Cache to an empty state
   static void reset();
+  //! Thread-Unsafe: Writes the trie of records to a file to be restored by
+  //! other processes, see Note [ Serialized FusionCache ]
+  void serialize(const std::string& filename) const;
+  //! Restores a trie written by serialize into an empty cache and builds the
+  //! Fusion IR of the restored fusions
+  void deserialize(const std::string& filename);
+  //! Thread-Unsafe: Sets the budget of resident fusion schedules and the
+  //! policy picking the fusion evicted beyond it. 0 doesn't bound the number
+  //! of fusions or bytes respectively. See Note [ FusionCache eviction ]
+  void setEvictionPolicy(
+      size_t max_resident_fusions,
+      size_t max_resident_bytes,
+      FusionEvictionPolicy policy);
+  //! Counters of lookups, evictions and the resident kernels
+  FusionCacheStats statistics() const;
 
   //! The rest of the public methods are only used in C++
 
-  //! Thread-Unsafe: Queries the current trie node to see if a record matches
+  //! Lock-Free: Queries the current trie node to see if a record matches
   //! one of its children
   c10::optional<TrieNode*> queryChildren(TrieNode* node, RecordFunctor* rec)
       const;
   //! Query a Fusion's Schedules based on fusion id or cache id
   FusionSchedules* queryFusionSchedules(size_t fusion_id) const;
+  //! Returns the terminal node of the definition of `records` if one was
+  //! registered for `fingerprint`, or nullptr. See
+  //! Note [ Definition fingerprints ]
+  TrieNode* queryDefinition(
+      size_t fingerprint,
+      const std::vector<std::unique_ptr<RecordFunctor>>& records) const;
+  //! Registers the terminal `node` of a definition for `fingerprint`
+  void registerDefinition(size_t fingerprint, TrieNode* node);
+  //! Thread-Unsafe: Records a lookup of the terminal `node` and recreates its
+  //! schedules if they were evicted. Returns true if they were recreated, in
+  //! which case the caller has to build their Fusion IR again.
+  bool reviveFusion(TrieNode* node);
   //! Lookup the User Schedule Id and return null if one does not exist.
   //! NOTE: this method cannot be const because the InputsIdLookup can
   //! cause a modification to that data member for cache eviction.
@@ -142,6 +268,12 @@ class TORCH_CUDA_CU_API FusionCache {
       const FusionSchedules* scheds,
       size_t id,
       int device) const;
+  //! Lookup the first compiled symbolic User Schedule whose constraints
+  //! `inputs` satisfy and return null if there is none.
+  const UserSchedule* querySymbolicUserSchedule(
+      const FusionSchedules* scheds,
+      const at::ArrayRef<c10::IValue>& inputs,
+      int device) const;
   //! Thread-Safe: Creates a child node for the current cache entry and an
   //! optional fusion_id is returned if the new entry is terminal
   TrieNode* createChild(TrieNode* node, RecordFunctor* rec);
@@ -150,8 +282,16 @@ class TORCH_CUDA_CU_API FusionCache {
       FusionSchedules* scheds,
       const at::ArrayRef<c10::IValue>& inputs,
       int device);
+  //! Create or lookup the symbolic User Schedule for `constraints`
+  UserSchedule* createSymbolicUserSchedule(
+      FusionSchedules* scheds,
+      const InputShapeConstraints& constraints,
+      int device);
   //! Get the root Trie ptr
   TrieNode* rootTriePtr();
+  //! Creates or lookup the stitched fusion of the links `key` describes, see
+  //! Note [ Fusion stitching ]
+  StitchedFusion* queryStitchedFusion(const std::vector<size_t>& key);
 
  private:
   //! The static pointer to the FusionCache
@@ -164,10 +304,36 @@ class TORCH_CUDA_CU_API FusionCache {
   //! The root (start) of the prefix tree to start a cache look up of a given
   //! fusion definition.
   std::unique_ptr<TrieNode> root_;
-  //! A vector of nvFuser Fusion IR fusions.
+  //! A vector of nvFuser Fusion IR fusions, null if evicted.
   std::vector<std::unique_ptr<FusionSchedules>> fusions_;
   //! A vector of Terminal trie nodes for Stats collection
   std::vector<TrieNode*> terminal_nodes_;
+  //! Terminal nodes by the fingerprint of their definition, see
+  //! Note [ Definition fingerprints ]
+  std::unordered_map<size_t, std::vector<TrieNode*>> definitions_;
+  //! Guards fusions_, terminal_nodes_ and definitions_
+  mutable std::mutex fusions_lock_;
+
+  //! Evicts schedules until the resident fusions fit the budget, sparing
+  //! `keep_id`. Requires `fusions_lock_` to be held.
+  void evictFusions(size_t keep_id);
+
+  //! see setEvictionPolicy
+  size_t max_resident_fusions_ = 0;
+  size_t max_resident_bytes_ = 0;
+  FusionEvictionPolicy eviction_policy_ = FusionEvictionPolicy::LRU;
+  //! Ticks on every use of fusion schedules
+  mutable std::atomic<uint64_t> use_clock_{0};
+  //! see statistics
+  std::atomic<size_t> hits_{0};
+  std::atomic<size_t> misses_{0};
+  std::atomic<size_t> evictions_{0};
+
+  //! Fusions stitched by batches, see Note [ Fusion stitching ]
+  std::map<std::vector<size_t>, std::unique_ptr<StitchedFusion>>
+      stitched_fusions_;
+  //! Guards stitched_fusions_
+  std::mutex stitched_fusions_lock_;
 
   //! Items specifically to aid user defined schedules these data members
   //! are for the mechanics of user schedule usage and don't make sense as
@@ -5,7 +5,11 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 // clang-format on
+#include <c10/util/hash.h>
+#include <c10/util/irange.h>
 #include <instrumentation.h>
+#include <ir_cloner.h>
+#include <iter_visitor.h>
 #include <python_frontend/fusion_cache.h>
 #include <python_frontend/fusion_definition.h>
 #include <utils.h>
@@ -31,6 +35,10 @@ const char* dtypeToPyString(PrimDataType t) {
       return "DataType.Int";
     case DataType::Int32:
       return "DataType.Int32";
+    case DataType::Int8:
+      return "DataType.Int8";
+    case DataType::UInt8:
+      return "DataType.UInt8";
     case DataType::ComplexFloat:
       return "DataType.ComplexFloat";
     case DataType::ComplexDouble:
@@ -73,6 +81,7 @@ FusionDefinition::FusionDefinition(c10::optional<size_t> id, size_t max_length)
       fusion_id_(id),
       fusion_cache_(FusionCache::get()),
       trie_node_(nullptr),
+      fingerprint_(0),
       recording_state_(),
       prev_fusion_(nullptr),
       user_sched_(nullptr),
@@ -89,11 +98,44 @@ FusionDefinition* FusionDefinition::setupDefinition() {
   TORCH_CHECK(max_length_ > 0, "Can't make a FusionDefinition with 0 records!");
   TORCH_CHECK(!id().has_value(), "Fusion Schedule is already found!");
   trie_node_ = fusionCache()->rootTriePtr();
+  fingerprint_ = 0;
   return this;
 }
 
+// Note [ Definition fingerprints ]
+//
+// Training loops define the same fusions on every step. Instead of walking
+// the trie for every record, records are only hashed into a fingerprint of
+// the definition while they are defined. A complete definition first looks
+// up the terminal nodes registered for its fingerprint and compares their
+// paths with its records, which resolves a known definition with a single
+// hash lookup. Only unknown definitions walk the trie record by record, and
+// register their terminal node for the fingerprint afterwards. Visits of the
+// inner trie nodes are therefore only counted by the walks.
+
 void FusionDefinition::finalizeDefinition() {
   FUSER_PERF_SCOPE("FusionDefinition::finalizeDefinition");
+  TrieNode* terminal = fusionCache()->queryDefinition(fingerprint_, recording_);
+  if (terminal != nullptr) {
+    if (isDebugDumpEnabled(DebugDumpOption::PythonFrontendDebug)) {
+      std::cout << "\nFusionDefinition: Definition (fingerprint: 0x"
+                << std::hex << fingerprint_ << std::dec
+                << ") hit in Fusion Cache.\n";
+    }
+    trie_node_ = terminal;
+    fusion_id_ = c10::optional<size_t>(trie_node_->fusion_id);
+    // The schedules of the fusion were evicted, see
+    // Note [ FusionCache eviction ]
+    if (fusionCache()->reviveFusion(trie_node_)) {
+      buildFusionIr(preschedFusion());
+    }
+    return;
+  }
+
+  for (const auto& record : recording_) {
+    walkTrie(record.get());
+  }
+
   auto child_node = fusionCache()->queryChildren(trie_node_, end_record_.get());
   if (!child_node.has_value()) {
     if (isDebugDumpEnabled(DebugDumpOption::PythonFrontendDebug)) {
@@ -118,10 +160,18 @@ void FusionDefinition::finalizeDefinition() {
     }
     trie_node_ = child_node.value();
     fusion_id_ = c10::optional<size_t>(trie_node_->fusion_id);
+    // The schedules of the fusion were evicted, see
+    // Note [ FusionCache eviction ]
+    if (fusionCache()->reviveFusion(trie_node_)) {
+      buildFusionIr(preschedFusion());
+    }
   }
+  fusionCache()->registerDefinition(fingerprint_, trie_node_);
 }
 
-void FusionDefinition::setupSchedule(const at::ArrayRef<c10::IValue>& inputs) {
+void FusionDefinition::setupSchedule(
+    const at::ArrayRef<c10::IValue>& inputs,
+    const c10::optional<InputShapeConstraints>& constraints) {
   FUSER_PERF_SCOPE("FusionDefinition::setupSchedule");
   TORCH_CHECK(id().has_value(), "FusionDefinition definition does not exist!");
   auto scheds = fusionCache()->queryFusionSchedules(id().value());
@@ -130,7 +180,18 @@ void FusionDefinition::setupSchedule(const at::ArrayRef<c10::IValue>& inputs) {
       inputs.size() == 0 || device > -1,
       "Inputs are not all on the same device!");
   TORCH_CHECK(user_sched_ == nullptr, "Expected User Scheduler to be null!");
-  user_sched_ = fusionCache()->createUserSchedule(scheds, inputs, device);
+  if (constraints.has_value()) {
+    TORCH_CHECK(
+        constraints->size() == inputs.size(),
+        "Expected shape constraints for each of the ",
+        inputs.size(),
+        " inputs but got ",
+        constraints->size());
+    user_sched_ = fusionCache()->createSymbolicUserSchedule(
+        scheds, constraints.value(), device);
+  } else {
+    user_sched_ = fusionCache()->createUserSchedule(scheds, inputs, device);
+  }
 
   // Building a new Fusion container for scheduling with definition such that
   // the definition's tensor data members refer to the corresponding IR objects
@@ -170,9 +231,42 @@ void FusionDefinition::print(std::ostream& os) const {
   os << std::endl;
 }
 
+namespace {
+
+//! Runs a user schedule and records its single kernel launch when profiling
+std::vector<at::Tensor> runUserSchedule(
+    FusionExecutor& executor,
+    const at::ArrayRef<c10::IValue>& inputs,
+    std::vector<KernelProfile>* kernel_profiles) {
+  if (kernel_profiles == nullptr) {
+    return executor.runFusion(inputs);
+  }
+  executor.setMeasureKernelTimeFlag(true);
+  auto outputs = executor.runFusion(inputs);
+  executor.setMeasureKernelTimeFlag(false);
+
+  KernelProfile kernel_profile;
+  kernel_profile.group_id = 0;
+  kernel_profile.kernel_name = executor.kernelName();
+  kernel_profile.heuristic = ScheduleHeuristic::None;
+  kernel_profile.launch_params = executor.lastLaunchParams();
+  kernel_profile.time_ms = executor.kernelTimeMs();
+  kernel_profile.bytes = executor.bytesProcessed();
+  if (kernel_profile.time_ms > 0) {
+    kernel_profile.bandwidth_gbs = (double)kernel_profile.bytes /
+        ((double)kernel_profile.time_ms * 1.0e6);
+  }
+  kernel_profile.resource_usage = executor.kernelResourceUsage();
+  *kernel_profiles = {std::move(kernel_profile)};
+  return outputs;
+}
+
+} // namespace
+
 std::vector<at::Tensor> FusionDefinition::execute(
     const at::ArrayRef<c10::IValue>& inputs,
-    bool override_user_schedule) const {
+    bool override_user_schedule,
+    std::vector<KernelProfile>* kernel_profiles) const {
   TORCH_CHECK(id().has_value(), "Valid fusion schedule is not available!");
 
   auto scheds = fusionCache()->queryFusionSchedules(id().value());
@@ -187,11 +281,381 @@ std::vector<at::Tensor> FusionDefinition::execute(
     if (user_sched_id.has_value()) {
       auto& user_sched = fusionCache()->queryUserSchedule(
           scheds, user_sched_id.value(), device);
-      return user_sched.executor->runFusion(inputs);
+      return runUserSchedule(*user_sched.executor, inputs, kernel_profiles);
+    }
+    auto symbolic_sched =
+        fusionCache()->querySymbolicUserSchedule(scheds, inputs, device);
+    if (symbolic_sched != nullptr) {
+      return runUserSchedule(
+          *symbolic_sched->executor, inputs, kernel_profiles);
+    }
+  }
+
+  auto fec = scheds->auto_gen_schedules.get();
+  if (kernel_profiles == nullptr) {
+    return fec->runFusionWithInputs(inputs);
+  }
+  fec->profile(true);
+  std::vector<at::Tensor> outputs;
+  try {
+    outputs = fec->runFusionWithInputs(inputs);
+    *kernel_profiles = fec->getMostRecentKernelProfiles();
+  } catch (...) {
+    fec->profile(false);
+    throw;
+  }
+  fec->profile(false);
+  return outputs;
+}
+
+namespace {
+
+// Note [ Fusion stitching ]
+//
+// Batches often run a fusion right after the fusion producing its inputs,
+// e.g. the epilogue of a normalization defined in a separate fusion. Run
+// separately, the linked tensors are written to global memory by the first
+// kernel and read back by the second. Once two fusions ran in a row with the
+// same links kMinRunsToStitch times, executeFusions stitches them into one
+// Fusion: a copy of the producer fusion whose outputs feed a clone of the
+// math of the consumer fusion. The linked tensors are then intermediates of
+// the stitched fusion, which never reach global memory when the segmenter
+// schedules it as one kernel. The stitched fusion gets its own
+// FusionExecutorCache held by the FusionCache.
+//
+// Linked outputs are still outputs of the stitched fusion, unless the batch
+// doesn't return intermediates, in which case the stitched fusion drops them.
+// Pairs are only stitched if no other fusion of the batch reads the outputs of
+// the producer, if both fusions run with the auto-generated schedules and if
+// the linked tensors match in type and broadcast pattern. Fusions aliasing or
+// permuting their inputs and outputs aren't stitched. Pairs that can't be
+// stitched keep running separately.
+
+//! Runs of two fusions in a row before they are stitched
+constexpr size_t kMinRunsToStitch = 3;
+
+//! Clones the math of a consumer fusion into a copy of its producer fusion,
+//! see Note [ Fusion stitching ]
+class FusionStitcher : private IrCloner {
+ public:
+  //! Stitches `consumer` after `producer`, input links[i].first of the
+  //! consumer reads output links[i].second of the producer. Returns null if
+  //! the fusions can't be stitched.
+  static std::unique_ptr<Fusion> stitch(
+      Fusion* producer,
+      Fusion* consumer,
+      const std::vector<std::pair<size_t, size_t>>& links,
+      bool return_linked_outputs);
+
+ private:
+  explicit FusionStitcher(Fusion* stitched) : IrCloner(stitched) {}
+
+  //! Makes clones of the consumer input `in` refer to `out` of the stitched
+  //! fusion, including the extents of its root domain
+  bool link(Val* in, Val* out);
+};
+
+bool FusionStitcher::link(Val* in, Val* out) {
+  if (!in->isA<TensorView>() || !out->isA<TensorView>() ||
+      in->getDataType() != out->getDataType() || isCloned(in)) {
+    return false;
+  }
+  const auto& in_root = in->as<TensorView>()->getRootDomain();
+  const auto out_root = TensorDomain::noReductions(
+      out->as<TensorView>()->getMaybeRFactorDomain());
+  if (in_root.size() != out_root.size()) {
+    return false;
+  }
+  for (auto i : c10::irange(in_root.size())) {
+    auto in_id = in_root[i];
+    auto out_id = out_root[i];
+    if (in_id->isBroadcast() != out_id->isBroadcast() ||
+        in_id->hasExpandedExtent() != out_id->hasExpandedExtent() ||
+        (in_id->extent()->isConstScalar() &&
+         !in_id->extent()->sameAs(out_id->extent()))) {
+      return false;
+    }
+  }
+  clones_map_[in] = out;
+  for (auto i : c10::irange(in_root.size())) {
+    auto in_id = in_root[i];
+    auto out_id = out_root[i];
+    if (!in_id->extent()->isConstScalar()) {
+      clones_map_.emplace(in_id->extent(), out_id->extent());
+    }
+    if (in_id->hasExpandedExtent() &&
+        !in_id->expandedExtent()->isConstScalar()) {
+      clones_map_.emplace(in_id->expandedExtent(), out_id->expandedExtent());
     }
   }
+  return true;
+}
+
+std::unique_ptr<Fusion> FusionStitcher::stitch(
+    Fusion* producer,
+    Fusion* consumer,
+    const std::vector<std::pair<size_t, size_t>>& links,
+    bool return_linked_outputs) {
+  FUSER_PERF_SCOPE("FusionStitcher::stitch");
+  if (!producer->ioAlias().empty() || !consumer->ioAlias().empty() ||
+      !producer->getPermutationOutputMap().empty() ||
+      !consumer->getPermutationInputMap().empty() ||
+      std::any_of(
+          consumer->outputs().begin(),
+          consumer->outputs().end(),
+          [](Val* out) { return out->isFusionInput(); })) {
+    return nullptr;
+  }
 
-  return scheds->auto_gen_schedules->runFusionWithInputs(inputs);
+  auto stitched = std::make_unique<Fusion>(*producer);
+  FusionGuard fg(stitched.get());
+  FusionStitcher stitcher(stitched.get());
+
+  const auto producer_outputs = stitched->outputs();
+  std::vector<bool> is_linked(consumer->inputs().size(), false);
+  for (auto [input_index, output_index] : links) {
+    if (input_index >= consumer->inputs().size() ||
+        output_index >= producer_outputs.size()) {
+      return nullptr;
+    }
+    auto out = producer_outputs[output_index];
+    if (std::count(producer_outputs.begin(), producer_outputs.end(), out) !=
+            1 ||
+        !stitcher.link(consumer->inputs()[input_index], out)) {
+      return nullptr;
+    }
+    is_linked[input_index] = true;
+  }
+
+  for (auto expr : StmtSort::getExprs(consumer)) {
+    stitcher.clone(expr);
+  }
+  // Clone the definitions of the other Vals the cloned nodes depend on, until
+  // no new node gets cloned
+  size_t num_cloned = 0;
+  while (num_cloned !=
+         stitched->vals().size() + stitched->unordered_exprs().size()) {
+    num_cloned = stitched->vals().size() + stitched->unordered_exprs().size();
+    for (auto val : consumer->vals()) {
+      if (val->definition() != nullptr && !val->isA<TensorView>() &&
+          stitcher.isCloned(val)) {
+        stitcher.clone(val->definition());
+      }
+    }
+  }
+
+  for (auto i : c10::irange(consumer->inputs().size())) {
+    if (!is_linked[i]) {
+      stitched->addInput(stitcher.clone(consumer->inputs()[i]));
+    }
+  }
+  if (!return_linked_outputs) {
+    for (auto link : links) {
+      stitched->removeOutput(producer_outputs[link.second]);
+    }
+  }
+  for (auto out : consumer->outputs()) {
+    stitched->addOutput(stitcher.clone(out));
+  }
+  return stitched;
+}
+
+//! Whether user schedules may take precedence over the auto-generated ones
+bool hasUserSchedules(FusionSchedules* scheds) {
+  std::lock_guard<std::mutex> guard(scheds->scheds_lock);
+  return !scheds->user_def_schedules.empty() ||
+      !scheds->symbolic_user_schedules.empty();
+}
+
+//! Replaces the placeholders of `entry` referring to outputs of fusions that
+//! already ran
+void substituteOutputRefs(
+    FusionBatchEntry& entry,
+    const std::vector<std::vector<at::Tensor>>& outputs) {
+  for (const auto& [position, ref] : entry.output_refs) {
+    if (ref.fusion_index >= outputs.size()) {
+      continue;
+    }
+    const auto& producer_outputs = outputs[ref.fusion_index];
+    TORCH_CHECK(
+        ref.output_index < producer_outputs.size(),
+        "Fusion ",
+        ref.fusion_index,
+        " of the batch has no output ",
+        ref.output_index);
+    entry.inputs[position] = producer_outputs[ref.output_index];
+  }
+}
+
+//! Runs fusion `index` of `batch` and the next one as their stitched fusion
+//! if they are stitched, see Note [ Fusion stitching ]. Returns false if they
+//! have to run separately. `num_refs` counts the inputs of the batch
+//! referring to outputs of fusion `index`.
+bool runStitched(
+    std::vector<FusionBatchEntry>& batch,
+    size_t index,
+    size_t num_refs,
+    bool return_intermediates,
+    std::vector<std::vector<at::Tensor>>& outputs) {
+  const auto& producer = batch[index];
+  const auto& consumer = batch[index + 1];
+  if (num_refs == 0 || !producer.fusion->id().has_value() ||
+      !consumer.fusion->id().has_value() ||
+      isOptionDisabled(DisableOption::FusionStitching)) {
+    return false;
+  }
+
+  std::vector<std::pair<size_t, size_t>> links;
+  std::vector<bool> is_linked(consumer.inputs.size(), false);
+  for (const auto& [position, ref] : consumer.output_refs) {
+    if (ref.fusion_index == index) {
+      links.emplace_back(position, ref.output_index);
+      is_linked[position] = true;
+    }
+  }
+  // Another fusion reads outputs of the producer
+  if (links.size() != num_refs) {
+    return false;
+  }
+
+  auto producer_scheds =
+      fusionCache()->queryFusionSchedules(producer.fusion->id().value());
+  auto consumer_scheds =
+      fusionCache()->queryFusionSchedules(consumer.fusion->id().value());
+  if (hasUserSchedules(producer_scheds) || hasUserSchedules(consumer_scheds)) {
+    return false;
+  }
+
+  std::vector<size_t> key = {
+      producer.fusion->id().value(),
+      consumer.fusion->id().value(),
+      (size_t)return_intermediates};
+  for (auto link : links) {
+    key.push_back(link.first);
+    key.push_back(link.second);
+  }
+  auto stitched = fusionCache()->queryStitchedFusion(key);
+  if (stitched->unstitchable) {
+    return false;
+  }
+  if (stitched->executor == nullptr) {
+    if (++stitched->num_runs < kMinRunsToStitch) {
+      return false;
+    }
+    auto fusion = FusionStitcher::stitch(
+        producer_scheds->preschedFusion(),
+        consumer_scheds->preschedFusion(),
+        links,
+        return_intermediates);
+    if (fusion == nullptr) {
+      stitched->unstitchable = true;
+      return false;
+    }
+    stitched->num_producer_outputs =
+        producer_scheds->preschedFusion()->outputs().size();
+    stitched->executor = std::make_unique<FusionExecutorCache>(std::move(fusion));
+  }
+
+  std::vector<c10::IValue> inputs = producer.inputs;
+  for (auto i : c10::irange(consumer.inputs.size())) {
+    if (!is_linked[i]) {
+      inputs.push_back(consumer.inputs[i]);
+    }
+  }
+  auto stitched_outputs = stitched->executor->runFusionWithInputs(inputs);
+
+  std::vector<bool> is_linked_output(stitched->num_producer_outputs, false);
+  for (auto link : links) {
+    is_linked_output.at(link.second) = true;
+  }
+  auto next_output = stitched_outputs.begin();
+  std::vector<at::Tensor> producer_outputs;
+  for (auto i : c10::irange(stitched->num_producer_outputs)) {
+    if (is_linked_output[i] && !return_intermediates) {
+      producer_outputs.emplace_back();
+    } else {
+      producer_outputs.push_back(*next_output++);
+    }
+  }
+  outputs.push_back(std::move(producer_outputs));
+  outputs.emplace_back(next_output, stitched_outputs.end());
+  return true;
+}
+
+} // namespace
+
+std::vector<std::vector<at::Tensor>> executeFusions(
+    std::vector<FusionBatchEntry>& batch,
+    bool return_intermediates) {
+  FUSER_PERF_SCOPE("executeFusions");
+  // Inputs of the batch referring to the outputs of each fusion
+  std::vector<size_t> num_refs(batch.size(), 0);
+  for (auto i : c10::irange(batch.size())) {
+    TORCH_CHECK(batch[i].fusion != nullptr, "Missing fusion in batch");
+    for (const auto& [position, ref] : batch[i].output_refs) {
+      TORCH_CHECK(
+          ref.fusion_index < i,
+          "Fusion ",
+          i,
+          " of the batch refers to the outputs of fusion ",
+          ref.fusion_index,
+          ", which doesn't run before it");
+      TORCH_INTERNAL_ASSERT(position < batch[i].inputs.size());
+      num_refs[ref.fusion_index]++;
+    }
+  }
+
+  std::vector<std::vector<at::Tensor>> outputs;
+  outputs.reserve(batch.size());
+  while (outputs.size() < batch.size()) {
+    auto index = outputs.size();
+    auto& entry = batch[index];
+    substituteOutputRefs(entry, outputs);
+    if (index + 1 < batch.size()) {
+      substituteOutputRefs(batch[index + 1], outputs);
+      if (runStitched(
+              batch, index, num_refs[index], return_intermediates, outputs)) {
+        continue;
+      }
+    }
+    outputs.push_back(
+        entry.fusion->execute(entry.inputs, /*override_user_schedule=*/false));
+  }
+
+  if (!return_intermediates) {
+    for (const auto& entry : batch) {
+      for (const auto& ref : entry.output_refs) {
+        outputs[ref.second.fusion_index][ref.second.output_index] =
+            at::Tensor();
+      }
+    }
+  }
+  return outputs;
+}
+
+void FusionDefinition::precompile(
+    const std::vector<std::vector<c10::IValue>>& input_signatures) const {
+  FUSER_PERF_SCOPE("FusionDefinition::precompile");
+  TORCH_CHECK(id().has_value(), "Valid fusion schedule is not available!");
+
+  auto scheds = fusionCache()->queryFusionSchedules(id().value());
+  scheds->auto_gen_schedules->compileFusionForInputs(input_signatures);
+}
+
+BoundExecution FusionDefinition::bind(
+    const at::ArrayRef<c10::IValue>& inputs) const {
+  FUSER_PERF_SCOPE("FusionDefinition::bind");
+  TORCH_CHECK(id().has_value(), "Valid fusion schedule is not available!");
+
+  auto scheds = fusionCache()->queryFusionSchedules(id().value());
+  return scheds->auto_gen_schedules->bind(inputs);
+}
+
+void FusionDefinition::setFastMath(bool fast_math) const {
+  TORCH_CHECK(id().has_value(), "Valid fusion schedule is not available!");
+
+  auto scheds = fusionCache()->queryFusionSchedules(id().value());
+  scheds->auto_gen_schedules->setFastMath(fast_math);
 }
 
 c10::optional<size_t> FusionDefinition::id() const {
@@ -221,25 +685,27 @@ void FusionDefinition::defineRecord(RecordFunctor* record) {
       "operations.  The max_length for FusionDefintion's might need to be ",
       "increased if the definition is created as expected.");
   addRecord(record);
-  auto child_node =
-      fusionCache()->queryChildren(trie_node_, recording_.back().get());
+  fingerprint_ = c10::hash_combine(fingerprint_, record->hash());
+}
+
+void FusionDefinition::walkTrie(RecordFunctor* record) {
+  auto child_node = fusionCache()->queryChildren(trie_node_, record);
   // If the Record is found in the cache, the FusionDefinition and the Cache
   // will not share Record given the Record had to be created in order to
   // match it but it also already existed in the cache.
   if (child_node.has_value()) {
     if (isDebugDumpEnabled(DebugDumpOption::PythonFrontendDebug)) {
       std::cout << "\nFusionDefinition: Record (hash: 0x" << std::hex
-                << record->hash() << ") hit in Fusion Cache.\n";
+                << record->hash() << std::dec << ") hit in Fusion Cache.\n";
     }
     trie_node_ = child_node.value();
     // The FusionDefinition and the Cache will share the Record
   } else {
     if (isDebugDumpEnabled(DebugDumpOption::PythonFrontendDebug)) {
       std::cout << "\nFusionDefinition: Record (hash: 0x" << std::hex
-                << record->hash() << ") missed in Fusion Cache.\n";
+                << record->hash() << std::dec << ") missed in Fusion Cache.\n";
     }
-    trie_node_ =
-        fusionCache()->createChild(trie_node_, recording_.back().get());
+    trie_node_ = fusionCache()->createChild(trie_node_, record);
   }
 }
 
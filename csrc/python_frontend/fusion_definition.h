@@ -27,6 +27,30 @@ struct TrieNode;
 
 TORCH_CUDA_CU_API const char* dtypeToPyString(PrimDataType t);
 
+//! \struct DimConstraint
+//! \brief Sizes of an input dimension a symbolic user schedule applies to.
+struct TORCH_CUDA_CU_API DimConstraint {
+  //! Exact size of the dimension, any size if not set
+  c10::optional<int64_t> size = c10::nullopt;
+  //! The size of the dimension has to be a multiple of the divisor
+  int64_t divisor = 1;
+
+  bool operator==(const DimConstraint& other) const {
+    return size == other.size && divisor == other.divisor;
+  }
+
+  bool matches(int64_t extent) const {
+    if (size.has_value() && extent != size.value()) {
+      return false;
+    }
+    return divisor <= 1 || extent % divisor == 0;
+  }
+};
+
+//! Constraints of the dimensions of each input, an empty entry doesn't
+//! constrain the input, e.g. a scalar
+using InputShapeConstraints = std::vector<std::vector<DimConstraint>>;
+
 //! The State and the StateType enum are used to define state objects to
 //! encapsulate the recording of state in the FusionDefinition.
 
@@ -121,16 +145,34 @@ class TORCH_CUDA_CU_API FusionDefinition : public FusionState {
   void finalizeDefinition();
   //! Setup user scheduling of a fusion
   //! Copies fusion object and sets up FusionGuard
-  void setupSchedule(const at::ArrayRef<c10::IValue>& inputs);
+  //! A schedule with shape `constraints` applies to all inputs satisfying
+  //! them, see Note [ Symbolic user schedules ]
+  void setupSchedule(
+      const at::ArrayRef<c10::IValue>& inputs,
+      const c10::optional<InputShapeConstraints>& constraints = c10::nullopt);
   //! Finalized use scheduling of a fusion
   //! resets FusionGuard, lowers IR to a kernel, compiles kernel
   void finalizeSchedule(const at::ArrayRef<c10::IValue>& inputs);
   //! Prints a python function representing the definition
   void print(std::ostream& os) const;
-  //! Executes a fusion if a valid definition or cache lookup occurred prior
+  //! Executes a fusion if a valid definition or cache lookup occurred prior.
+  //! With `kernel_profiles`, every kernel is timed and a record of each
+  //! launch is written to it, see FusionKernelRuntime::kernelProfiles
   std::vector<at::Tensor> execute(
       const at::ArrayRef<c10::IValue>& inputs,
-      bool override_user_schedule) const;
+      bool override_user_schedule,
+      std::vector<KernelProfile>* kernel_profiles = nullptr) const;
+  //! Compiles the auto-generated schedules for each set of inputs ahead of
+  //! time, see FusionExecutorCache::compileFusionForInputs
+  void precompile(
+      const std::vector<std::vector<c10::IValue>>& input_signatures) const;
+  //! Binds the auto-generated schedules to the signature of `inputs`, so that
+  //! inputs of the same signature re-run without cache lookups. User
+  //! schedules are not considered, see FusionExecutorCache::bind
+  BoundExecution bind(const at::ArrayRef<c10::IValue>& inputs) const;
+  //! Compiles the auto-generated schedules with hardware approximations of
+  //! transcendental functions, see FusionExecutorCache::setFastMath
+  void setFastMath(bool fast_math) const;
   //! Return fusion id of defined FusionDefinition
   c10::optional<size_t> id() const;
   //! Prints the Prescheduled Fusion IR representation
@@ -157,6 +199,8 @@ class TORCH_CUDA_CU_API FusionDefinition : public FusionState {
   FusionCache* fusionCache() const;
   //! Return a prescheduled Fusion object
   Fusion* preschedFusion();
+  //! Moves `trie_node_` to its child for `record`, creating it if needed
+  void walkTrie(RecordFunctor* record);
 
   //! Holds the defined maximum length of a FusionDefinition in order to
   //! prevent a run away error. The user should feel free to increase this
@@ -168,6 +212,9 @@ class TORCH_CUDA_CU_API FusionDefinition : public FusionState {
   FusionCache* fusion_cache_;
   //! Current pointer to node in FusionCache.
   TrieNode* trie_node_;
+  //! Hash of the records defined so far, see
+  //! Note [ Definition fingerprints ]
+  size_t fingerprint_;
 
   //! A vector of state recorded in the FusionDefinition
   std::vector<State> recording_state_;
@@ -212,4 +259,36 @@ class TORCH_CUDA_CU_API FusionDefinition : public FusionState {
   SchedOperators sched;
 };
 
+//! Input of a fusion in a batch that is an output of an earlier fusion of the
+//! same batch, see executeFusions
+struct TORCH_CUDA_CU_API FusionOutputRef {
+  //! index of the producing fusion in the batch
+  size_t fusion_index = 0;
+  //! index of the output of the producing fusion
+  size_t output_index = 0;
+};
+
+//! One fusion of a batch and its inputs. Inputs listed in `output_refs` are
+//! placeholders in `inputs` that are replaced by outputs of earlier fusions
+//! once they are produced.
+struct TORCH_CUDA_CU_API FusionBatchEntry {
+  const FusionDefinition* fusion = nullptr;
+  std::vector<c10::IValue> inputs;
+  //! input position and the output it refers to
+  std::vector<std::pair<size_t, FusionOutputRef>> output_refs;
+};
+
+//! Executes the fusions of `batch` in order with the auto-generated or user
+//! schedules execute() would pick, and returns the outputs of each of them.
+//! Running a whole step of small fusions in one call saves the per-call
+//! overhead of the python bindings. Outputs of a fusion can feed later
+//! fusions of the batch, which makes the batch a DAG in topological order.
+//! Fusions that repeatedly run in a row are stitched into one, see
+//! Note [ Fusion stitching ]. If `return_intermediates` is false, outputs
+//! feeding later fusions of the batch are returned as undefined tensors,
+//! which lets stitched fusions keep them out of global memory.
+TORCH_CUDA_CU_API std::vector<std::vector<at::Tensor>> executeFusions(
+    std::vector<FusionBatchEntry>& batch,
+    bool return_intermediates = true);
+
 } // namespace nvfuser::python_frontend
@@ -7,16 +7,22 @@
 // clang-format on
 #pragma once
 #include <c10/util/complex.h>
+#include <c10/util/hash.h>
 #include <ir_interface_nodes.h>
 #include <ops/alias.h>
 #include <ops/arith.h>
 #include <ops/normalization.h>
 #include <python_frontend/fusion_definition.h>
 #include <python_frontend/fusion_state.h>
+#include <transform_view.h>
 #include <utils.h>
 
 #include <algorithm>
 #include <complex>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+#include <typeinfo>
 #include <variant>
 
 namespace nvfuser::python_frontend {
@@ -55,6 +61,114 @@ enum class RecordType {
   RandomOp
 };
 
+//! Type trait of std::vector used by RecordWriter and RecordReader
+template <typename T>
+struct IsVector : std::false_type {};
+template <typename T, typename Allocator>
+struct IsVector<std::vector<T, Allocator>> : std::true_type {};
+
+//! Appends the binary encoding of record data to a buffer. See
+//! Note [ Serialized FusionCache ] in fusion_cache.cpp
+class RecordWriter {
+ public:
+  explicit RecordWriter(std::vector<char>& buffer) : buffer_(buffer) {}
+
+  //! Writes a trivially copyable value, a string, an optional bool, or a
+  //! vector of those
+  template <typename T>
+  void write(const T& value) {
+    if constexpr (std::is_same_v<T, std::string>) {
+      write(static_cast<uint64_t>(value.size()));
+      buffer_.insert(buffer_.end(), value.begin(), value.end());
+    } else if constexpr (std::is_same_v<T, c10::optional<bool>>) {
+      write(static_cast<int8_t>(value.has_value() ? value.value() : -1));
+    } else if constexpr (IsVector<T>::value) {
+      write(static_cast<uint64_t>(value.size()));
+      for (const auto& element : value) {
+        write(static_cast<typename T::value_type>(element));
+      }
+    } else {
+      static_assert(
+          std::is_trivially_copyable_v<T>,
+          "Record data must be trivially copyable to be serialized");
+      const char* ptr = reinterpret_cast<const char*>(&value);
+      buffer_.insert(buffer_.end(), ptr, ptr + sizeof(T));
+    }
+  }
+
+ private:
+  std::vector<char>& buffer_;
+};
+
+//! Reads the record data encoded by RecordWriter
+class RecordReader {
+ public:
+  RecordReader(const char* data, size_t size) : data_(data), size_(size) {}
+
+  template <typename T>
+  T read() {
+    if constexpr (std::is_same_v<T, std::string>) {
+      const auto size = read<uint64_t>();
+      const char* ptr = advance(size);
+      return std::string(ptr, size);
+    } else if constexpr (std::is_same_v<T, c10::optional<bool>>) {
+      const auto value = read<int8_t>();
+      return value < 0 ? c10::optional<bool>()
+                       : c10::optional<bool>(value != 0);
+    } else if constexpr (IsVector<T>::value) {
+      const auto size = read<uint64_t>();
+      T result;
+      for (uint64_t i = 0; i < size; ++i) {
+        result.push_back(read<typename T::value_type>());
+      }
+      return result;
+    } else {
+      static_assert(
+          std::is_trivially_copyable_v<T>,
+          "Record data must be trivially copyable to be deserialized");
+      // Not every record data type is default constructible, e.g. State
+      std::aligned_storage_t<sizeof(T), alignof(T)> storage;
+      std::memcpy(&storage, advance(sizeof(T)), sizeof(T));
+      return *reinterpret_cast<T*>(&storage);
+    }
+  }
+
+  //! Whether all the data has been read
+  bool done() const {
+    return pos_ == size_;
+  }
+
+ private:
+  const char* advance(size_t size) {
+    TORCH_CHECK(
+        size <= size_ - pos_, "Unexpected end of serialized FusionCache!");
+    const char* ptr = data_ + pos_;
+    pos_ += size;
+    return ptr;
+  }
+
+  const char* data_ = nullptr;
+  size_t size_ = 0;
+  size_t pos_ = 0;
+};
+
+//! Creates a record that holds an arith function from its serialized data
+//! following the data common to all records.
+using RecordDeserializer = std::function<RecordFunctor*(
+    std::vector<State> args,
+    std::vector<State> outputs,
+    RecordReader& reader)>;
+
+//! Records capturing an arith function can only be deserialized once a
+//! deserializer has been registered for their name and function signature,
+//! which the python bindings do for every operation they define.
+TORCH_CUDA_CU_API void registerRecordDeserializer(
+    const std::string& key,
+    RecordDeserializer deserializer);
+//! Returns nullptr if there is no deserializer registered for `key`
+TORCH_CUDA_CU_API const RecordDeserializer* getRecordDeserializer(
+    const std::string& key);
+
 //! RecordFunctor is the base class record for operations recorded by
 //! the FusionDefinition.  It is, in essence, a node in the graph with
 //! input edges, args, and outputs edges outputs where the stored
@@ -174,6 +288,20 @@ struct RecordFunctor {
     return record_type_;
   }
 
+  //! Writes the data common to all records followed by the child class
+  //! specific data, see Note [ Serialized FusionCache ] in fusion_cache.cpp
+  void serialize(RecordWriter& writer) const {
+    writer.write(record_type_);
+    writer.write(name_);
+    writer.write(args_);
+    writer.write(outputs_);
+    serializeData(writer);
+  }
+
+  //! Writes the child class specific data in the order it is read back by
+  //! deserializeRecord in fusion_cache.cpp
+  virtual void serializeData(RecordWriter& writer) const {}
+
  protected:
   //! Inputs that are indices into the FusionDefinition's Recorded State.
   std::vector<State> args_;
@@ -215,6 +343,11 @@ struct OpRecord : RecordFunctor {
     return new OpRecord(*this);
   }
 
+  virtual void serializeData(RecordWriter& writer) const final {
+    // Identifies the arith function together with the name
+    writer.write(std::string(typeid(fusion_op_).name()));
+  }
+
   //! Child specific hash function in lower 32 bits.= at::Symbol
   //! | 31 -------------------------------------  0 |
   //! | Arith Function Sigs hash code               |
@@ -303,17 +436,41 @@ struct ReshapeOpRecord : RecordFunctor {
             "ops.reshape",
             RecordType::ReshapeOp),
         original_shape_(std::move(original_shape)),
-        new_shape_(std::move(new_shape)) {}
+        new_shape_(std::move(new_shape)) {
+    // Size-1 dimensions are squeezed or merged depending on the input tensor,
+    // which the constraint doesn't know about
+    if (std::all_of(
+            original_shape_.begin(), original_shape_.end(), [](int64_t size) {
+              return size > 1;
+            })) {
+      view_key_ = analyzeViewConstraint(original_shape_, new_shape_)
+                      .conglomerateString();
+    }
+  }
   virtual ~ReshapeOpRecord() = default;
   virtual RecordFunctor* clone() final {
     return new ReshapeOpRecord(*this);
   }
 
+  virtual void serializeData(RecordWriter& writer) const final {
+    writer.write(original_shape_);
+    writer.write(new_shape_);
+  }
+
   //! Child specific hash function in lower 32 bits.
   //! | 31 -------------- 16 | 15 --------------  0 |
   //! | original_shape hash  | new_shape hash       |
+  //! Reshapes with a constraint key hash the key instead.
   virtual size_t hash() const final {
     auto result = RecordFunctor::hash();
+    if (!view_key_.empty()) {
+      size_t view_key_hash = 0;
+      for (auto value : view_key_) {
+        view_key_hash =
+            c10::hash_combine(view_key_hash, static_cast<size_t>(value));
+      }
+      return result | (view_key_hash & 0xffffffff);
+    }
     size_t new_shape_hash = 0;
     for (auto shape : new_shape_) {
       new_shape_hash ^= static_cast<size_t>(shape);
@@ -330,6 +487,11 @@ struct ReshapeOpRecord : RecordFunctor {
     auto result = false;
     if (auto child_ptr = dynamic_cast<const ReshapeOpRecord*>(&other)) {
       result = RecordFunctor::operator==(other);
+      // Reshapes with the same constraint build the same Fusion IR, see
+      // Note [ Symbolic reshapes ]
+      if (!view_key_.empty() || !child_ptr->view_key_.empty()) {
+        return result && view_key_ == child_ptr->view_key_;
+      }
       result &= std::equal(
           original_shape_.begin(),
           original_shape_.end(),
@@ -380,6 +542,9 @@ struct ReshapeOpRecord : RecordFunctor {
   std::vector<int64_t> original_shape_;
   //! Represents the tensor dimensions of the output tensor.
   std::vector<int64_t> new_shape_;
+  //! The AnalyzeViewConstraint of the reshape, which records are compared
+  //! by, or empty if they are compared by the shapes.
+  std::vector<int64_t> view_key_;
 };
 
 struct PadOpRecord : RecordFunctor {
@@ -398,6 +563,10 @@ struct PadOpRecord : RecordFunctor {
     return new PadOpRecord(*this);
   }
 
+  virtual void serializeData(RecordWriter& writer) const final {
+    writer.write(pad_widths_);
+  }
+
   //! Child specific hash function in lower 32 bits.
   //! | 31 ------------------------------ 0 |
   //! |          pad_widths                 |
@@ -502,6 +671,10 @@ struct PermuteOpRecord : RecordFunctor {
     return new PermuteOpRecord(*this);
   }
 
+  virtual void serializeData(RecordWriter& writer) const final {
+    writer.write(dims_);
+  }
+
   virtual size_t hash() const final {
     auto result = RecordFunctor::hash();
     size_t dims_hash = 0;
@@ -577,6 +750,11 @@ struct SqueezeOpRecord : RecordFunctor {
     return new SqueezeOpRecord(*this);
   }
 
+  virtual void serializeData(RecordWriter& writer) const final {
+    writer.write(original_shape_);
+    writer.write(dims_);
+  }
+
   //! Child specific hash function in lower 32 bits.
   //! | 31 -------------- 16 | 15 --------------  0 |
   //! | Squeeze Dim hash     | original_shape hash  |
@@ -683,6 +861,12 @@ struct BroadcastInDimOpRecord : RecordFunctor {
     return new BroadcastInDimOpRecord(*this);
   }
 
+  virtual void serializeData(RecordWriter& writer) const final {
+    writer.write(std::string(typeid(BroadcastInDimOpRecord).name()));
+    writer.write(output_shape_);
+    writer.write(broadcast_dims_);
+  }
+
   inline size_t outputShapeHash(
       const std::vector<OutputShapeType>& shape) const;
 
@@ -904,6 +1088,10 @@ struct BroadcastOpRecord : RecordFunctor {
     return new BroadcastOpRecord(*this);
   }
 
+  virtual void serializeData(RecordWriter& writer) const final {
+    writer.write(is_broadcast_dim_);
+  }
+
   virtual size_t hash() const final {
     auto result = RecordFunctor::hash();
     size_t is_broadcast_dim_hash = 0;
@@ -975,6 +1163,11 @@ struct CastOpRecord : RecordFunctor {
     return new CastOpRecord(*this);
   }
 
+  virtual void serializeData(RecordWriter& writer) const final {
+    writer.write(std::string(typeid(fusion_op_).name()));
+    writer.write(dtype_);
+  }
+
   //! Child specific hash function in lower 32 bits.
   //! | 31 --- 24 | 23 --------------------------  0 |
   //! | Dtype     | Arith Function Sig hash code     |
@@ -1055,6 +1248,10 @@ struct CatOpRecord : RecordFunctor {
     return new CatOpRecord(*this);
   }
 
+  virtual void serializeData(RecordWriter& writer) const final {
+    writer.write(dim_);
+  }
+
   virtual size_t hash() const final {
     auto result = RecordFunctor::hash();
     return result | (static_cast<size_t>(dim_) & 0xffff);
@@ -1137,6 +1334,12 @@ struct ConstantRecord : RecordFunctor {
     return new ConstantRecord(*this);
   }
 
+  virtual void serializeData(RecordWriter& writer) const final {
+    writer.write(std::string(typeid(ConstantRecord).name()));
+    writer.write(value_);
+    writer.write(dtype_);
+  }
+
   //! Going to start out hashing nothing extra since hashing a complex number
   //! seems complicated.  Initially, the thought was to simply static cast the
   //! value_
@@ -1254,6 +1457,13 @@ struct TensorRecord : RecordFunctor {
     return new TensorRecord(*this);
   }
 
+  virtual void serializeData(RecordWriter& writer) const final {
+    writer.write(symbolic_sizes_);
+    writer.write(contiguous_info_);
+    writer.write(dtype_);
+    writer.write(is_cpu_);
+  }
+
   //! Child specific hash function in lower 32 bits.
   //! |  31  | 30 --- 24 | 23 --------- 12 | 11 ---------  0 |
   //! | CPU? | Dtype     | Symbolic Sizes  | Contiguous Info |
@@ -1413,6 +1623,11 @@ struct OutputRecord : RecordFunctor {
     return new OutputRecord(*this);
   }
 
+  virtual void serializeData(RecordWriter& writer) const final {
+    writer.write(std::string(typeid(OutputRecord).name()));
+    writer.write(stride_order_);
+  }
+
   //! Nothing extra necessary in hash
   //! Child specific hash function in lower 32 bits.
   //! | 31 ----------------------------------------  0 |
@@ -1545,6 +1760,13 @@ struct ReductionOpRecord : RecordFunctor {
     return new ReductionOpRecord(*this);
   }
 
+  virtual void serializeData(RecordWriter& writer) const final {
+    writer.write(std::string(typeid(fusion_op_).name()));
+    writer.write(axes_);
+    writer.write(keep_dim_);
+    writer.write(dtype_);
+  }
+
   //! Child specific hash function in lower 32 bits.
   //! | 31 -- 28 | 27 --- 20 | 19 -----------------  0 |
   //! | keep_dim | Dtype     | Axes Hash               |
@@ -1668,6 +1890,10 @@ struct IndexSelectOpRecord : RecordFunctor {
     return new IndexSelectOpRecord(*this);
   }
 
+  virtual void serializeData(RecordWriter& writer) const final {
+    writer.write(dim_);
+  }
+
   virtual bool operator==(const RecordFunctor& other) const final {
     auto result = false;
     if (auto child_ptr = dynamic_cast<const IndexSelectOpRecord*>(&other)) {
@@ -1713,6 +1939,10 @@ struct TorchGatherOpRecord : RecordFunctor {
     return new TorchGatherOpRecord(*this);
   }
 
+  virtual void serializeData(RecordWriter& writer) const final {
+    writer.write(dim_);
+  }
+
   void operator()(FusionState& fd) final {
     auto arg1 = fd.getFusionState(args_.at(0).index)->template as<TensorView>();
     auto arg3 = fd.getFusionState(args_.at(1).index)->template as<TensorView>();
@@ -1757,6 +1987,10 @@ struct ScalarRecord : RecordFunctor {
     return new ScalarRecord(*this);
   }
 
+  virtual void serializeData(RecordWriter& writer) const final {
+    writer.write(dtype_);
+  }
+
   //! Child specific hash function in lower 32 bits.
   //! | 31 ---------------------------------------  0 |
   //! | Dtype                                         |
@@ -1827,6 +2061,12 @@ struct SliceOpRecord : RecordFunctor {
     return new SliceOpRecord(*this);
   }
 
+  virtual void serializeData(RecordWriter& writer) const final {
+    writer.write(start_indices_);
+    writer.write(end_indices_);
+    writer.write(strides_);
+  }
+
   //! Child specific hash function in lower 32 bits.
   //! | 31 -------- 20 | 19 --------  8 |  7 ------  0 |
   //! | start_indices  | end_indices    | strides      |
@@ -1975,6 +2215,12 @@ struct NormOpRecord : RecordFunctor {
   virtual ~NormOpRecord() = default;
   RecordFunctor* clone() override = 0;
 
+  virtual void serializeData(RecordWriter& writer) const final {
+    writer.write(axes_);
+    writer.write(correction_);
+    writer.write(keep_dim_);
+  }
+
   // I am skipping the bassel's correction value in the hash because
   // I suspect we might change it to a bool from a 64-bit value
   //! Child specific hash function in lower 32 bits.
@@ -2120,6 +2366,11 @@ struct BatchNormOpRecord : RecordFunctor {
     return new BatchNormOpRecord(*this);
   }
 
+  virtual void serializeData(RecordWriter& writer) const final {
+    writer.write(training_);
+    writer.write(channels_last_);
+  }
+
   virtual bool operator==(const RecordFunctor& other) const final {
     auto result = false;
     if (auto child_ptr = dynamic_cast<const BatchNormOpRecord*>(&other)) {
@@ -2233,6 +2484,11 @@ struct FullOpRecord : RecordFunctor {
     return new FullOpRecord(*this);
   }
 
+  virtual void serializeData(RecordWriter& writer) const final {
+    writer.write(shape_);
+    writer.write(dtype_);
+  }
+
   //! Child specific hash function in lower 32 bits.
   //! | 31 --- 24 | 23 --------------------------  0 |
   //! | Dtype     | Shape hash code                  |
@@ -2310,6 +2566,10 @@ struct IotaOpRecord : RecordFunctor {
     return new IotaOpRecord(*this);
   }
 
+  virtual void serializeData(RecordWriter& writer) const final {
+    writer.write(dtype_);
+  }
+
   //! Child specific hash function in lower 32 bits.
   //! | 31 --------------------------------------  0 |
   //! | Dtype                                        |
@@ -2372,6 +2632,11 @@ struct RandomOpRecord : RecordFunctor {
     return new RandomOpRecord(*this);
   }
 
+  virtual void serializeData(RecordWriter& writer) const final {
+    writer.write(output_shape_);
+    writer.write(dtype_);
+  }
+
   //! Child specific hash function in lower 32 bits.
   //! | 31 -------------- 16 | 15 --------------  0 |
   //! |   distribution hash  | output_shape hash    |
@@ -2450,6 +2715,75 @@ struct RandomOpRecord : RecordFunctor {
   PrimDataType dtype_;
 };
 
+//! The register functions below make the records of an arith function
+//! restorable by FusionCache::deserialize, see Note [ Serialized FusionCache ]
+//! in fusion_cache.cpp. The python bindings register every arith function
+//! they record.
+
+template <class OutType, class... ArgTypes>
+void registerOpRecord(std::string name, OutType (*fusion_op)(ArgTypes...)) {
+  const std::string key =
+      name + typeid(std::function<OutType(ArgTypes...)>).name();
+  registerRecordDeserializer(
+      key,
+      [name, fusion_op](
+          std::vector<State> args,
+          std::vector<State> outputs,
+          RecordReader& reader) -> RecordFunctor* {
+        return new OpRecord<OutType, ArgTypes...>(
+            std::move(args), std::move(outputs), name, fusion_op);
+      });
+}
+
+template <class OutType, class ArgType>
+void registerCastOpRecord(
+    std::string name,
+    OutType (*fusion_op)(DataType, ArgType)) {
+  const std::string key =
+      name + typeid(std::function<OutType(DataType, ArgType)>).name();
+  registerRecordDeserializer(
+      key,
+      [name, fusion_op](
+          std::vector<State> args,
+          std::vector<State> outputs,
+          RecordReader& reader) -> RecordFunctor* {
+        const auto dtype = reader.read<PrimDataType>();
+        return new CastOpRecord<OutType, ArgType>(
+            std::move(args), std::move(outputs), name, fusion_op, dtype);
+      });
+}
+
+inline void registerReductionOpRecord(
+    std::string name,
+    TensorView* (*fusion_op)(
+        TensorView*,
+        const std::vector<int>&,
+        bool,
+        DataType)) {
+  const std::string key = name +
+      typeid(std::function<TensorView*(
+                 TensorView*, const std::vector<int>&, bool, DataType)>)
+          .name();
+  registerRecordDeserializer(
+      key,
+      [name, fusion_op](
+          std::vector<State> args,
+          std::vector<State> outputs,
+          RecordReader& reader) -> RecordFunctor* {
+        auto axes = reader.read<std::vector<int>>();
+        const auto keep_dim = reader.read<bool>();
+        const auto dtype = reader.read<PrimDataType>();
+        return new ReductionOpRecord(
+            std::move(args),
+            std::move(outputs),
+            name,
+            fusion_op,
+            std::move(axes),
+            keep_dim,
+            dtype);
+      });
+}
+
 } // namespace nvfuser::python_frontend
 
 //! Creating the template specialized hash and equal_to functions for a
@@ -7,6 +7,8 @@
 // clang-format on
 #include <python_frontend/python_bindings.h>
 
+#include <ATen/DLConvertor.h>
+#include <c10/cuda/CUDAException.h>
 #include <c10/util/ArrayRef.h>
 #include <c10/util/Optional.h>
 #include <c10/util/irange.h>
@@ -22,6 +24,7 @@
 #include <torch/csrc/jit/python/pybind_utils.h>
 #include <complex>
 #include <iostream>
+#include <limits>
 #include <tuple>
 
 namespace nvfuser::python_frontend {
@@ -60,6 +63,166 @@ std::vector<c10::optional<bool>> computeContiguity(
   return contiguity;
 }
 
+namespace {
+
+//! Scalar type of a `__cuda_array_interface__` type string, e.g. "<f4"
+at::ScalarType scalarTypeOfTypestr(const std::string& typestr) {
+  TORCH_CHECK(
+      typestr.size() >= 3 && typestr[0] != '>',
+      "Unsupported __cuda_array_interface__ typestr: ",
+      typestr);
+  const char kind = typestr[1];
+  const int bytes = std::stoi(typestr.substr(2));
+  switch (kind) {
+    case 'b':
+      return at::kBool;
+    case 'f':
+      if (bytes == 2) {
+        return at::kHalf;
+      } else if (bytes == 4) {
+        return at::kFloat;
+      } else if (bytes == 8) {
+        return at::kDouble;
+      }
+      break;
+    case 'i':
+      if (bytes == 1) {
+        return at::kChar;
+      } else if (bytes == 4) {
+        return at::kInt;
+      } else if (bytes == 8) {
+        return at::kLong;
+      }
+      break;
+    case 'u':
+      if (bytes == 1) {
+        return at::kByte;
+      }
+      break;
+    case 'c':
+      if (bytes == 8) {
+        return at::kComplexFloat;
+      } else if (bytes == 16) {
+        return at::kComplexDouble;
+      }
+      break;
+    default:
+      break;
+  }
+  TORCH_CHECK(
+      false, "Unsupported __cuda_array_interface__ typestr: ", typestr);
+}
+
+//! Wraps the memory described by a `__cuda_array_interface__` in a tensor
+//! without copying it. The tensor doesn't own the memory, so `obj` has to
+//! outlive it, which holds for the inputs of a single execution.
+at::Tensor fromCudaArrayInterface(const py::handle& obj) {
+  auto cai = obj.attr("__cuda_array_interface__").cast<py::dict>();
+  auto dtype = scalarTypeOfTypestr(cai["typestr"].cast<std::string>());
+  auto sizes = cai["shape"].cast<std::vector<int64_t>>();
+  auto data = (void*)cai["data"].cast<py::tuple>()[0].cast<uintptr_t>();
+
+  const auto item_size = (int64_t)c10::elementSize(dtype);
+  std::vector<int64_t> strides(sizes.size(), 1);
+  if (cai.contains("strides") && !cai["strides"].is_none()) {
+    strides = cai["strides"].cast<std::vector<int64_t>>();
+    for (auto& stride : strides) {
+      TORCH_CHECK(
+          stride % item_size == 0,
+          "__cuda_array_interface__ strides must be multiples of the item "
+          "size");
+      stride /= item_size;
+    }
+  } else {
+    for (int64_t i = (int64_t)sizes.size() - 2; i >= 0; --i) {
+      strides[i] = strides[i + 1] * sizes[i + 1];
+    }
+  }
+
+  int device = 0;
+  if (data != nullptr) {
+    cudaPointerAttributes attributes;
+    C10_CUDA_CHECK(cudaPointerGetAttributes(&attributes, data));
+    device = attributes.device;
+  }
+  return at::from_blob(
+      data,
+      sizes,
+      strides,
+      at::TensorOptions().dtype(dtype).device(at::kCUDA, device));
+}
+
+//! Converts a python input of a fusion to an IValue. Tensors and python
+//! scalars are converted directly, which skips the type inference of
+//! torch::jit::toIValue. Arrays of other frameworks, e.g. CuPy or JAX, are
+//! wrapped without a copy through DLPack or `__cuda_array_interface__`.
+c10::IValue toFusionInput(const py::handle& obj) {
+  if (THPVariable_Check(obj.ptr())) {
+    return THPVariable_Unpack(obj.ptr());
+  }
+  if (py::isinstance<py::bool_>(obj)) {
+    return obj.cast<bool>();
+  }
+  if (py::isinstance<py::int_>(obj)) {
+    return obj.cast<int64_t>();
+  }
+  if (py::isinstance<py::float_>(obj)) {
+    return obj.cast<double>();
+  }
+  if (py::hasattr(obj, "__dlpack__")) {
+    auto capsule = obj.attr("__dlpack__")().cast<py::capsule>();
+    TORCH_CHECK(
+        std::string(capsule.name()) == "dltensor",
+        "DLPack capsule was already consumed");
+    auto tensor = at::fromDLPack(capsule.get_pointer<DLManagedTensor>());
+    // The tensor took over the ownership of the DLManagedTensor
+    PyCapsule_SetName(capsule.ptr(), "used_dltensor");
+    return tensor;
+  }
+  if (py::hasattr(obj, "__cuda_array_interface__")) {
+    return fromCudaArrayInterface(obj);
+  }
+  return torch::jit::toIValue(obj, c10::AnyType::get());
+}
+
+//! Converts the shape constraints of a symbolic user schedule, a list with
+//! an entry for each input that is either None for any input or a list of
+//! the dimensions of a tensor. A dimension is None for any size, an int for
+//! an exact size or a DimConstraint.
+c10::optional<InputShapeConstraints> toInputShapeConstraints(
+    const py::object& obj) {
+  if (obj.is_none()) {
+    return c10::nullopt;
+  }
+  InputShapeConstraints constraints;
+  for (py::handle input : obj.cast<py::iterable>()) {
+    std::vector<DimConstraint> dims;
+    if (!input.is_none()) {
+      for (py::handle dim : input.cast<py::iterable>()) {
+        if (dim.is_none()) {
+          dims.emplace_back();
+        } else if (py::isinstance<DimConstraint>(dim)) {
+          dims.push_back(dim.cast<DimConstraint>());
+        } else {
+          dims.push_back(DimConstraint{dim.cast<int64_t>(), 1});
+        }
+      }
+    }
+    constraints.push_back(std::move(dims));
+  }
+  return constraints;
+}
+
+std::vector<c10::IValue> toFusionInputs(const py::iterable& iter) {
+  std::vector<c10::IValue> inputs;
+  for (py::handle obj : iter) {
+    inputs.push_back(toFusionInput(obj));
+  }
+  return inputs;
+}
+
+} // namespace
+
 void initNvFuserPythonBindings(PyObject* module) {
   auto nvfuser = py::handle(module).cast<py::module>();
 
@@ -70,6 +233,8 @@ void initNvFuserPythonBindings(PyObject* module) {
       .value("Half", DataType::Half)
       .value("Int", DataType::Int)
       .value("Int32", DataType::Int32)
+      .value("Int8", DataType::Int8)
+      .value("UInt8", DataType::UInt8)
       .value("Bool", DataType::Bool)
       .value("BFloat16", DataType::BFloat16)
       .value("ComplexFloat", DataType::ComplexFloat)
@@ -78,9 +243,168 @@ void initNvFuserPythonBindings(PyObject* module) {
 
   nvfuser.def("compute_contiguity", computeContiguity);
 
+  //! Durations of the compilation stages over all compilations of the
+  //! process, see Note [ Compile time instrumentation ]
+  nvfuser.def("compile_stats", []() {
+    py::dict stats;
+    for (const auto& [stage, stage_stats] :
+         inst::CompileStats::instance()->stats()) {
+      py::dict entry;
+      entry["count"] = stage_stats.count;
+      entry["total_ms"] = stage_stats.total_ms;
+      entry["min_ms"] = stage_stats.min_ms;
+      entry["max_ms"] = stage_stats.max_ms;
+      py::list histogram;
+      for (const auto bucket :
+           c10::irange(inst::CompileStageStats::kNumBuckets)) {
+        const auto upper_bound_ms =
+            bucket + 1 == inst::CompileStageStats::kNumBuckets
+            ? std::numeric_limits<double>::infinity()
+            : inst::CompileStageStats::bucketUpperBoundMs(bucket);
+        histogram.append(
+            py::make_tuple(upper_bound_ms, stage_stats.histogram[bucket]));
+      }
+      entry["histogram"] = histogram;
+      stats[py::str(stage)] = entry;
+    }
+    return stats;
+  });
+  nvfuser.def(
+      "reset_compile_stats", []() { inst::CompileStats::instance()->reset(); });
+
+  //! Counters and host latency histogram of the runs since the last reset,
+  //! see Note [ Runtime metrics ]
+  nvfuser.def("runtime_metrics", []() {
+    const auto snapshot = inst::RuntimeMetrics::instance()->snapshot();
+    py::dict metrics;
+    for (const auto counter :
+         c10::irange(inst::RuntimeMetricsSnapshot::kNumCounters)) {
+      metrics[inst::toString(static_cast<inst::RuntimeCounter>(counter))] =
+          snapshot.counters[counter];
+    }
+    py::list histogram;
+    for (const auto bucket :
+         c10::irange(inst::RuntimeMetricsSnapshot::kNumLatencyBuckets)) {
+      const auto upper_bound_us =
+          bucket + 1 == inst::RuntimeMetricsSnapshot::kNumLatencyBuckets
+          ? std::numeric_limits<double>::infinity()
+          : inst::RuntimeMetricsSnapshot::latencyBucketUpperBoundUs(bucket);
+      histogram.append(
+          py::make_tuple(upper_bound_us, snapshot.latency_histogram[bucket]));
+    }
+    metrics["host_latency_histogram"] = histogram;
+    metrics["total_host_latency_us"] =
+        static_cast<double>(snapshot.total_latency_ns) / 1e3;
+    return metrics;
+  });
+  nvfuser.def("reset_runtime_metrics", []() {
+    inst::RuntimeMetrics::instance()->reset();
+  });
+
+  //! Totals of the kernels launched while kernel telemetry is enabled,
+  //! ranked by GPU time, see Note [ Kernel telemetry ]
+  nvfuser.def("enable_kernel_telemetry", [](bool enabled) {
+    inst::KernelTelemetry::instance()->setEnabled(enabled);
+  });
+  nvfuser.def(
+      "kernel_telemetry",
+      [](size_t top_k) {
+        py::list report;
+        for (const auto& entry :
+             inst::KernelTelemetry::instance()->report(top_k)) {
+          py::dict kernel;
+          kernel["kernel"] = entry.kernel_name;
+          kernel["heuristic"] = entry.heuristic;
+          kernel["params"] = entry.params;
+          kernel["calls"] = entry.calls;
+          kernel["gpu_time_ms"] = entry.gpu_time_ms;
+          kernel["host_overhead_ms"] = entry.host_overhead_ms;
+          kernel["recompiles"] = entry.recompiles;
+          report.append(kernel);
+        }
+        return report;
+      },
+      py::arg("top_k") = 0);
+  nvfuser.def(
+      "kernel_telemetry_json",
+      [](size_t top_k) {
+        return inst::KernelTelemetry::instance()->toJson(top_k);
+      },
+      py::arg("top_k") = 0);
+  nvfuser.def(
+      "write_kernel_telemetry_trace",
+      [](const std::string& path, size_t top_k) {
+        inst::KernelTelemetry::instance()->writeTrace(path, top_k);
+      },
+      py::arg("path"),
+      py::arg("top_k") = 0);
+  nvfuser.def("reset_kernel_telemetry", []() {
+    inst::KernelTelemetry::instance()->reset();
+  });
+
+  //! Constraint on a dimension of an input of a symbolic user schedule, see
+  //! Note [ Symbolic user schedules ]
+  py::class_<DimConstraint> dim_constraint(nvfuser, "DimConstraint");
+  dim_constraint
+      .def(
+          py::init([](c10::optional<int64_t> size, int64_t divisor) {
+            TORCH_CHECK(divisor > 0, "The divisor has to be positive");
+            return DimConstraint{size, divisor};
+          }),
+          py::arg("size") = py::none(),
+          py::arg("divisor") = 1)
+      .def_readonly("size", &DimConstraint::size)
+      .def_readonly("divisor", &DimConstraint::divisor);
+
+  //! Refers to an output of an earlier fusion of a batch, see executeFusions
+  py::class_<FusionOutputRef> output_ref(nvfuser, "FusionOutputRef");
+  output_ref
+      .def(
+          py::init([](size_t fusion_index, size_t output_index) {
+            return FusionOutputRef{fusion_index, output_index};
+          }),
+          py::arg("fusion_index"),
+          py::arg("output_index"))
+      .def_readonly("fusion_index", &FusionOutputRef::fusion_index)
+      .def_readonly("output_index", &FusionOutputRef::output_index);
+
+  //! Executes a list of (FusionDefinition, inputs) pairs in one call, inputs
+  //! may be FusionOutputRefs to outputs of earlier fusions of the list.
+  //! Outputs feeding later fusions are None if return_intermediates is False.
+  nvfuser.def(
+      "execute_fusions",
+      [](const py::iterable& fusions, bool return_intermediates) {
+        std::vector<FusionBatchEntry> batch;
+        for (py::handle item : fusions) {
+          auto pair = py::reinterpret_borrow<py::sequence>(item);
+          TORCH_CHECK(
+              pair.size() == 2,
+              "Expected (FusionDefinition, inputs) pairs in the batch");
+          FusionBatchEntry entry;
+          entry.fusion = pair[0].cast<FusionDefinition*>();
+          for (py::handle obj : pair[1].cast<py::iterable>()) {
+            if (py::isinstance<FusionOutputRef>(obj)) {
+              entry.output_refs.emplace_back(
+                  entry.inputs.size(), obj.cast<FusionOutputRef>());
+              entry.inputs.emplace_back();
+            } else {
+              entry.inputs.push_back(toFusionInput(obj));
+            }
+          }
+          batch.push_back(std::move(entry));
+        }
+        return executeFusions(batch, return_intermediates);
+      },
+      py::arg("fusions"),
+      py::arg("return_intermediates") = true);
+
   //! Binding the FusionCache that holds a cache of Fusions
   //! This is only bound to provide an interface to get the number of fusions
-  //! that are cached.
+  //! that are cached and to save and restore the cache.
+  py::enum_<FusionEvictionPolicy>(nvfuser, "FusionEvictionPolicy")
+      .value("LRU", FusionEvictionPolicy::LRU)
+      .value("LFU", FusionEvictionPolicy::LFU);
+
   py::class_<FusionCache> fusion_cache(nvfuser, "FusionCache");
   fusion_cache
       .def_static(
@@ -89,6 +413,30 @@ void initNvFuserPythonBindings(PyObject* module) {
           py::arg("max_fusions") = int(8192),
           py::return_value_policy::reference)
       .def("num_fusions", &FusionCache::numFusions)
+      .def("serialize", &FusionCache::serialize, py::arg("filename"))
+      .def("deserialize", &FusionCache::deserialize, py::arg("filename"))
+      .def(
+          "set_eviction_policy",
+          &FusionCache::setEvictionPolicy,
+          py::arg("max_resident_fusions") = 0,
+          py::arg("max_resident_bytes") = 0,
+          py::arg("policy") = FusionEvictionPolicy::LRU)
+      .def(
+          "statistics",
+          [](FusionCache& self) {
+            const auto stats = self.statistics();
+            py::dict entry;
+            entry["lookups"] = stats.lookups;
+            entry["hits"] = stats.hits;
+            entry["misses"] = stats.misses;
+            entry["evictions"] = stats.evictions;
+            entry["num_fusions"] = stats.num_fusions;
+            entry["resident_fusions"] = stats.resident_fusions;
+            entry["compiled_kernels"] = stats.compiled_kernels;
+            entry["compile_ms"] = stats.compile_ms;
+            entry["resident_bytes"] = stats.resident_bytes;
+            return entry;
+          })
       .def(
           "__repr__",
           [](FusionCache& self) {
@@ -138,6 +486,25 @@ void initNvFuserPythonBindings(PyObject* module) {
     return ss.str();
   });
 
+  //! Re-runs a fusion for inputs of the signature it was bound to, see
+  //! FusionDefinition::bind
+  py::class_<BoundExecution> bound_execution(nvfuser, "BoundExecution");
+  bound_execution
+      .def(
+          "execute",
+          [](BoundExecution& self, const py::iterable& iter) {
+            auto inputs = toFusionInputs(iter);
+            return self.run(inputs);
+          },
+          py::arg("inputs"))
+      .def(
+          "matches",
+          [](BoundExecution& self, const py::iterable& iter) {
+            auto inputs = toFusionInputs(iter);
+            return self.matches(inputs);
+          },
+          py::arg("inputs"));
+
   //! The FusionDefinition is a context manager in Python where the user will
   //! define the set the operations and connections between operations for
   //! nvFuser to create.
@@ -165,22 +532,20 @@ void initNvFuserPythonBindings(PyObject* module) {
           })
       .def(
           "_setup_schedule",
-          [](FusionDefinition& self, const py::iterable& iter) {
+          [](FusionDefinition& self,
+             const py::iterable& iter,
+             const py::object& constraints) {
             // Instrumentation to mark the beginning of a schedule
             inst::Trace::instance()->beginEvent("FusionDefinition Schedule");
-            std::vector<c10::IValue> inputs;
-            for (py::handle obj : iter) {
-              inputs.push_back(torch::jit::toIValue(obj, c10::AnyType::get()));
-            }
-            self.setupSchedule(inputs);
-          })
+            auto inputs = toFusionInputs(iter);
+            self.setupSchedule(inputs, toInputShapeConstraints(constraints));
+          },
+          py::arg("inputs"),
+          py::arg("constraints") = py::none())
       .def(
           "_finalize_schedule",
           [](FusionDefinition& self, const py::iterable& iter) {
-            std::vector<c10::IValue> inputs;
-            for (py::handle obj : iter) {
-              inputs.push_back(torch::jit::toIValue(obj, c10::AnyType::get()));
-            }
+            auto inputs = toFusionInputs(iter);
             self.finalizeSchedule(inputs);
             // Mark the end of a schedule
             inst::Trace::instance()->endEvent(nullptr);
@@ -200,15 +565,73 @@ void initNvFuserPythonBindings(PyObject* module) {
           [](FusionDefinition& self,
              const py::iterable& iter,
              bool override_user_schedule) {
-            std::vector<c10::IValue> inputs;
-            for (py::handle obj : iter) {
-              inputs.push_back(torch::jit::toIValue(obj, c10::AnyType::get()));
-            }
+            auto inputs = toFusionInputs(iter);
             return self.execute(inputs, override_user_schedule);
           },
           py::arg("inputs"),
           py::arg("override_user_schedule") = false,
           py::return_value_policy::reference)
+      .def(
+          "_profile",
+          [](FusionDefinition& self,
+             const py::iterable& iter,
+             bool override_user_schedule) {
+            auto inputs = toFusionInputs(iter);
+            std::vector<KernelProfile> kernel_profiles;
+            auto outputs =
+                self.execute(inputs, override_user_schedule, &kernel_profiles);
+            py::list records;
+            for (const auto& kernel_profile : kernel_profiles) {
+              const auto& lparams = kernel_profile.launch_params;
+              const auto& usage = kernel_profile.resource_usage;
+              py::dict record;
+              record["segment"] = kernel_profile.group_id;
+              record["kernel_name"] = kernel_profile.kernel_name;
+              record["heuristic"] = toString(kernel_profile.heuristic);
+              record["grid"] = py::make_tuple(
+                  lparams.gdimx(), lparams.gdimy(), lparams.gdimz());
+              record["block"] = py::make_tuple(
+                  lparams.bdimx(), lparams.bdimy(), lparams.bdimz());
+              record["time_ms"] = kernel_profile.time_ms;
+              record["bytes"] = kernel_profile.bytes;
+              record["bandwidth_gbs"] = kernel_profile.bandwidth_gbs;
+              record["registers_per_thread"] = usage.registers_per_thread;
+              record["local_bytes_per_thread"] = usage.local_bytes_per_thread;
+              record["static_smem_bytes"] = usage.static_smem_bytes;
+              record["dynamic_smem_bytes"] = usage.dynamic_smem_bytes;
+              record["max_active_blocks_per_sm"] =
+                  usage.max_active_blocks_per_sm;
+              record["occupancy"] = usage.occupancy;
+              records.append(record);
+            }
+            return py::make_tuple(outputs, records);
+          },
+          py::arg("inputs"),
+          py::arg("override_user_schedule") = false)
+      .def(
+          "_precompile",
+          [](FusionDefinition& self, const py::iterable& signatures) {
+            std::vector<std::vector<c10::IValue>> input_signatures;
+            for (py::handle signature : signatures) {
+              input_signatures.push_back(
+                  toFusionInputs(signature.cast<py::iterable>()));
+            }
+            self.precompile(input_signatures);
+          },
+          py::arg("input_signatures"))
+      .def(
+          "_bind",
+          [](FusionDefinition& self, const py::iterable& iter) {
+            auto inputs = toFusionInputs(iter);
+            return self.bind(inputs);
+          },
+          py::arg("inputs"))
+      .def(
+          "_set_fast_math",
+          [](FusionDefinition& self, bool fast_math) {
+            self.setFastMath(fast_math);
+          },
+          py::arg("fast_math"))
       .def(
           "id",
           [](FusionDefinition& self) -> c10::optional<size_t> {
@@ -460,6 +883,9 @@ void initNvFuserPythonBindings(PyObject* module) {
   // ******************** INSERT OP BINDINGS BELOW HERE ********************
 #define OP_PREFIX "Operators."
 #define NVFUSER_PYTHON_BINDING_UNARY_OP(op_str, op_name)                       \
+  registerOpRecord(                                                            \
+      "ops." op_str, static_cast<TensorView* (*)(TensorView*)>(op_name));      \
+  registerOpRecord("ops." op_str, static_cast<Val* (*)(Val*)>(op_name));       \
   nvf_ops.def(                                                                 \
       op_str,                                                                  \
       [](FusionDefinition::Operators& self, Tensor input) -> Tensor {          \
@@ -578,6 +1004,9 @@ void initNvFuserPythonBindings(PyObject* module) {
 #undef NVFUSER_PYTHON_BINDING_UNARY_OP
 
 #define NVFUSER_PYTHON_BINDING_UNARY_OP_SPECIAL(op_str, op_name)               \
+  registerOpRecord(                                                            \
+      "ops." op_str, static_cast<TensorView* (*)(TensorView*)>(op_name));      \
+  registerOpRecord("ops." op_str, static_cast<Val* (*)(Val*)>(op_name));       \
   tensor_class.def(                                                            \
       "__" op_str "__",                                                        \
       [](Tensor input) -> Tensor {                                             \
@@ -615,6 +1044,16 @@ void initNvFuserPythonBindings(PyObject* module) {
 #undef NVFUSER_PYTHON_BINDING_UNARY_OP_SPECIAL
 
 #define NVFUSER_PYTHON_BINDING_BINARY_OP(op_str, op_name)                      \
+  registerOpRecord(                                                            \
+      "ops." op_str,                                                           \
+      static_cast<TensorView* (*)(TensorView*, TensorView*)>(op_name));        \
+  registerOpRecord(                                                            \
+      "ops." op_str,                                                           \
+      static_cast<TensorView* (*)(TensorView*, Val*)>(op_name));               \
+  registerOpRecord(                                                            \
+      "ops." op_str,                                                           \
+      static_cast<TensorView* (*)(Val*, TensorView*)>(op_name));               \
+  registerOpRecord("ops." op_str, static_cast<Val* (*)(Val*, Val*)>(op_name)); \
   nvf_ops.def(                                                                 \
       op_str,                                                                  \
       [](FusionDefinition::Operators& self,                                    \
@@ -775,6 +1214,16 @@ void initNvFuserPythonBindings(PyObject* module) {
 #undef NVFUSER_PYTHON_BINDING_BINARY_OP
 
 #define NVFUSER_PYTHON_BINDING_BINARY_OP_SPECIAL(py_op, op_str, op_name)       \
+  registerOpRecord(                                                            \
+      "ops." op_str,                                                           \
+      static_cast<TensorView* (*)(TensorView*, TensorView*)>(op_name));        \
+  registerOpRecord(                                                            \
+      "ops." op_str,                                                           \
+      static_cast<TensorView* (*)(TensorView*, Val*)>(op_name));               \
+  registerOpRecord(                                                            \
+      "ops." op_str,                                                           \
+      static_cast<TensorView* (*)(Val*, TensorView*)>(op_name));               \
+  registerOpRecord("ops." op_str, static_cast<Val* (*)(Val*, Val*)>(op_name)); \
   tensor_class.def(                                                            \
       py_op,                                                                   \
       [](Tensor arg1, Tensor arg2) -> Tensor {                                 \
@@ -864,6 +1313,17 @@ void initNvFuserPythonBindings(PyObject* module) {
 #undef NVFUSER_PYTHON_BINDING_BINARY_OP_SPECIAL
 
 #define NVFUSER_PYTHON_BINDING_BINARY_WITH_ALPHA_OP(op_str, op_name)           \
+  registerOpRecord(                                                            \
+      "ops." op_str,                                                           \
+      static_cast<TensorView* (*)(TensorView*, TensorView*, Val*)>(op_name));  \
+  registerOpRecord(                                                            \
+      "ops." op_str,                                                           \
+      static_cast<TensorView* (*)(TensorView*, Val*, Val*)>(op_name));         \
+  registerOpRecord(                                                            \
+      "ops." op_str,                                                           \
+      static_cast<TensorView* (*)(Val*, TensorView*, Val*)>(op_name));         \
+  registerOpRecord(                                                            \
+      "ops." op_str, static_cast<Val* (*)(Val*, Val*, Val*)>(op_name));        \
   nvf_ops.def(                                                                 \
       op_str,                                                                  \
       [](FusionDefinition::Operators& self,                                    \
@@ -1034,6 +1494,30 @@ void initNvFuserPythonBindings(PyObject* module) {
 #undef NVFUSER_PYTHON_BINDING_BINARY_WITH_ALPHA_OP
 
 #define NVFUSER_PYTHON_BINDING_TERNARY_OP(op_str, op_name)                     \
+  registerOpRecord(                                                            \
+      "ops." op_str, static_cast<Val* (*)(Val*, Val*, Val*)>(op_name));        \
+  registerOpRecord(                                                            \
+      "ops." op_str,                                                           \
+      static_cast<                                                             \
+          TensorView* (*)(TensorView*, TensorView*, TensorView*)>(op_name));   \
+  registerOpRecord(                                                            \
+      "ops." op_str,                                                           \
+      static_cast<TensorView* (*)(TensorView*, TensorView*, Val*)>(op_name));  \
+  registerOpRecord(                                                            \
+      "ops." op_str,                                                           \
+      static_cast<TensorView* (*)(TensorView*, Val*, TensorView*)>(op_name));  \
+  registerOpRecord(                                                            \
+      "ops." op_str,                                                           \
+      static_cast<TensorView* (*)(Val*, TensorView*, TensorView*)>(op_name));  \
+  registerOpRecord(                                                            \
+      "ops." op_str,                                                           \
+      static_cast<TensorView* (*)(Val*, Val*, TensorView*)>(op_name));         \
+  registerOpRecord(                                                            \
+      "ops." op_str,                                                           \
+      static_cast<TensorView* (*)(TensorView*, Val*, Val*)>(op_name));         \
+  registerOpRecord(                                                            \
+      "ops." op_str,                                                           \
+      static_cast<TensorView* (*)(Val*, TensorView*, Val*)>(op_name));         \
   nvf_ops.def(                                                                 \
       op_str,                                                                  \
       [](FusionDefinition::Operators& self,                                    \
@@ -1385,6 +1869,11 @@ void initNvFuserPythonBindings(PyObject* module) {
 #undef NVFUSER_PYTHON_BINDING_TERNARY_OP
 
 #define NVFUSER_PYTHON_BINDING_THRESHOLD_LIKE_OP(op_str, op_name)              \
+  registerOpRecord(                                                            \
+      "ops." op_str, static_cast<Val* (*)(Val*, Val*, Val*)>(op_name));        \
+  registerOpRecord(                                                            \
+      "ops." op_str,                                                           \
+      static_cast<TensorView* (*)(TensorView*, Val*, Val*)>(op_name));         \
   nvf_ops.def(                                                                 \
       op_str,                                                                  \
       [](FusionDefinition::Operators& self,                                    \
@@ -1477,6 +1966,33 @@ void initNvFuserPythonBindings(PyObject* module) {
 #undef NVFUSER_PYTHON_BINDING_THRESHOLD_LIKE_OP
 
 #define NVFUSER_PYTHON_BINDING_TERNARY_WITH_ALPHA_OP(op_str, op_name)          \
+  registerOpRecord(                                                            \
+      "ops." op_str, static_cast<Val* (*)(Val*, Val*, Val*, Val*)>(op_name));  \
+  registerOpRecord(                                                            \
+      "ops." op_str,                                                           \
+      static_cast<TensorView* (*)(                                             \
+          TensorView*, TensorView*, TensorView*, Val*)>(op_name));             \
+  registerOpRecord(                                                            \
+      "ops." op_str,                                                           \
+      static_cast<                                                             \
+          TensorView* (*)(TensorView*, TensorView*, Val*, Val*)>(op_name));    \
+  registerOpRecord(                                                            \
+      "ops." op_str,                                                           \
+      static_cast<                                                             \
+          TensorView* (*)(TensorView*, Val*, TensorView*, Val*)>(op_name));    \
+  registerOpRecord(                                                            \
+      "ops." op_str,                                                           \
+      static_cast<                                                             \
+          TensorView* (*)(Val*, TensorView*, TensorView*, Val*)>(op_name));    \
+  registerOpRecord(                                                            \
+      "ops." op_str,                                                           \
+      static_cast<TensorView* (*)(Val*, Val*, TensorView*, Val*)>(op_name));   \
+  registerOpRecord(                                                            \
+      "ops." op_str,                                                           \
+      static_cast<TensorView* (*)(TensorView*, Val*, Val*, Val*)>(op_name));   \
+  registerOpRecord(                                                            \
+      "ops." op_str,                                                           \
+      static_cast<TensorView* (*)(Val*, TensorView*, Val*, Val*)>(op_name));   \
   nvf_ops.def(                                                                 \
       op_str,                                                                  \
       [](FusionDefinition::Operators& self,                                    \
@@ -1886,6 +2402,10 @@ void initNvFuserPythonBindings(PyObject* module) {
 #undef NVFUSER_PYTHON_BINDING_TERNARY_WITH_ALPHA_OP
 
 #define NVFUSER_PYTHON_BINDING_REDUCTION_OP(op_str, op_name)                            \
+  registerReductionOpRecord(                                                   \
+      "ops." op_str,                                                           \
+      static_cast<TensorView* (*)(                                             \
+          TensorView*, const std::vector<int>&, bool, DataType)>(op_name));    \
   nvf_ops.def(                                                                          \
       op_str,                                                                           \
       [](FusionDefinition::Operators& self,                                             \
@@ -2009,6 +2529,11 @@ void initNvFuserPythonBindings(PyObject* module) {
 #undef NVFUSER_PYTHON_BINDING_REDUCTION_OP
 
 #define NVFUSER_PYTHON_BINDING_CAST_OP(op_str, op_name)                        \
+  registerCastOpRecord(                                                        \
+      "ops." op_str,                                                           \
+      static_cast<TensorView* (*)(DataType, TensorView*)>(op_name));           \
+  registerCastOpRecord(                                                        \
+      "ops." op_str, static_cast<Val* (*)(DataType, Val*)>(op_name));          \
   nvf_ops.def(                                                                 \
       op_str,                                                                  \
       [](FusionDefinition::Operators& self,                                    \
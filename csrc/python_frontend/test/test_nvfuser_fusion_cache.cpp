@@ -14,6 +14,9 @@
 #include <test/test_gpu_validator.h>
 #include <test/test_utils.h>
 
+#include <filesystem>
+#include <thread>
+
 namespace nvfuser {
 using namespace nvfuser::python_frontend;
 
@@ -181,4 +184,168 @@ TEST_F(NVFuserTest, PyFusionCache_CUDA) {
   }
 }
 
+
+// RUN CMD: bin/test_jit --gtest_filter="NVFuserTest*PyFusionCacheSerde*"
+TEST_F(NVFuserTest, PyFusionCacheSerde_CUDA) {
+  FusionCache::reset();
+  FusionCache* fc = FusionCache::get();
+  registerOpRecord(
+      "ops.abs", static_cast<TensorView* (*)(TensorView*)>(nvfuser::abs));
+
+  auto make_records = []() {
+    std::vector<std::unique_ptr<RecordFunctor>> records;
+    records.emplace_back(new TensorRecord(
+        {State(0, StateType::Tensor)},
+        {-1, 1},
+        {true, c10::nullopt},
+        DataType::Float));
+    records.emplace_back(new OpRecord<TensorView*, TensorView*>(
+        {State(0, StateType::Tensor)},
+        {State(1, StateType::Tensor)},
+        "ops.abs",
+        static_cast<TensorView* (*)(TensorView*)>(nvfuser::abs)));
+    records.emplace_back(
+        new OutputRecord<TensorView>({State(1, StateType::Tensor)}));
+    records.emplace_back(new EndRecord());
+    return records;
+  };
+
+  auto records = make_records();
+  TrieNode* node = fc->rootTriePtr();
+  for (auto& record : records) {
+    node = fc->createChild(node, record.get());
+  }
+  ASSERT_TRUE(fc->numFusions() == 1);
+
+  const std::string filename =
+      (std::filesystem::temp_directory_path() / "nvfuser_fusion_cache.bin")
+          .string();
+  fc->serialize(filename);
+
+  // Only an empty cache can be restored
+  EXPECT_THAT(
+      [&]() { fc->deserialize(filename); },
+      ::testing::ThrowsMessage<c10::Error>(
+          ::testing::HasSubstr("Only an empty FusionCache")));
+
+  FusionCache::reset();
+  fc = FusionCache::get();
+  fc->deserialize(filename);
+  ASSERT_TRUE(fc->numFusions() == 1);
+
+  // The restored trie matches the records of the original definition
+  auto lookup_records = make_records();
+  node = fc->rootTriePtr();
+  for (auto& record : lookup_records) {
+    auto child = fc->queryChildren(node, record.get());
+    ASSERT_TRUE(child.has_value());
+    node = child.value();
+  }
+  ASSERT_TRUE(node->isTerminal());
+  ASSERT_TRUE(node->fusion_id == 0);
+
+  // The Fusion IR is built on restoring
+  Fusion* fusion = fc->queryFusionSchedules(0)->preschedFusion();
+  ASSERT_TRUE(fusion->inputs().size() == 1);
+  ASSERT_TRUE(fusion->outputs().size() == 1);
+  ASSERT_TRUE(fusion->outputs().at(0)->definition()->isA<UnaryOp>());
+
+  std::filesystem::remove(filename);
+  FusionCache::reset();
+}
+
+
+// RUN CMD: bin/test_jit --gtest_filter="NVFuserTest*PyFusionCacheThreads*"
+TEST_F(NVFuserTest, PyFusionCacheThreads_CUDA) {
+  FusionCache::reset();
+  FusionCache* fc = FusionCache::get();
+
+  // Threads walking the trie with the same records, which grows the child
+  // table of the root while other threads look it up, must all end up with
+  // the same nodes
+  constexpr size_t num_threads = 8;
+  constexpr size_t num_records = 256;
+  std::vector<std::vector<TrieNode*>> nodes(
+      num_threads, std::vector<TrieNode*>(num_records, nullptr));
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&, t]() {
+      for (size_t i = 0; i < num_records; ++i) {
+        ScalarRecord record({State(i, StateType::Scalar)}, DataType::Float);
+        TrieNode* root = fc->rootTriePtr();
+        auto child = fc->queryChildren(root, &record);
+        nodes[t][i] =
+            child.has_value() ? child.value() : fc->createChild(root, &record);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  TrieNode* root = fc->rootTriePtr();
+  ASSERT_TRUE(root->children().size() == num_records);
+  for (size_t i = 0; i < num_records; ++i) {
+    ScalarRecord record({State(i, StateType::Scalar)}, DataType::Float);
+    TrieNode* node = root->findChild(&record);
+    ASSERT_TRUE(node != nullptr);
+    ASSERT_TRUE(node->visits.load() == num_threads);
+    for (size_t t = 0; t < num_threads; ++t) {
+      ASSERT_TRUE(nodes[t][i] == node);
+    }
+  }
+  FusionCache::reset();
+}
+
+// RUN CMD: bin/test_jit --gtest_filter="NVFuserTest*PyFusionCacheEviction*"
+TEST_F(NVFuserTest, PyFusionCacheEviction_CUDA) {
+  FusionCache::reset();
+  FusionCache* fc = FusionCache::get();
+  fc->setEvictionPolicy(
+      /*max_resident_fusions=*/2,
+      /*max_resident_bytes=*/0,
+      FusionEvictionPolicy::LRU);
+
+  // Defines three fusions that only differ by their scalar input
+  EndRecord end_record;
+  std::vector<TrieNode*> terminal_nodes;
+  for (size_t i = 0; i < 3; ++i) {
+    ScalarRecord record({State(i, StateType::Scalar)}, DataType::Float);
+    TrieNode* node = fc->createChild(fc->rootTriePtr(), &record);
+    terminal_nodes.push_back(fc->createChild(node, &end_record));
+    // Uses the fusion like an execution would
+    fc->queryFusionSchedules(terminal_nodes.back()->fusion_id);
+  }
+
+  // The least recently used fusion was evicted when the third was created
+  auto stats = fc->statistics();
+  ASSERT_EQ(stats.num_fusions, 3);
+  ASSERT_EQ(stats.resident_fusions, 2);
+  ASSERT_EQ(stats.misses, 3);
+  ASSERT_EQ(stats.evictions, 1);
+  EXPECT_THAT(
+      [&]() { fc->queryFusionSchedules(terminal_nodes[0]->fusion_id); },
+      ::testing::ThrowsMessage<c10::Error>(
+          ::testing::HasSubstr("were evicted")));
+
+  // Looking up a resident fusion is a hit, an evicted one is revived under
+  // its fusion id, which evicts the least recently used of the others
+  ASSERT_FALSE(fc->reviveFusion(terminal_nodes[2]));
+  ASSERT_TRUE(fc->reviveFusion(terminal_nodes[0]));
+  ASSERT_NE(fc->queryFusionSchedules(terminal_nodes[0]->fusion_id), nullptr);
+  EXPECT_THAT(
+      [&]() { fc->queryFusionSchedules(terminal_nodes[1]->fusion_id); },
+      ::testing::ThrowsMessage<c10::Error>(
+          ::testing::HasSubstr("were evicted")));
+
+  stats = fc->statistics();
+  ASSERT_EQ(stats.lookups, 5);
+  ASSERT_EQ(stats.hits, 1);
+  ASSERT_EQ(stats.evictions, 2);
+  ASSERT_EQ(stats.resident_fusions, 2);
+
+  fc->setEvictionPolicy(0, 0, FusionEvictionPolicy::LRU);
+  FusionCache::reset();
+}
+
 } // namespace nvfuser
@@ -271,10 +271,16 @@ torch::jit::RegisterOperators reg_guard({
         // if we would ever return refined tensor, which would change aliasing
         // analysis, we should update aliasdb pass.
         [](const torch::jit::Node* node) -> torch::jit::Operation {
-          return [node](torch::jit::Stack& stack) {
-            // TODO: check latency here!!!!
-            std::vector<torch::jit::TypePtr> types = node->tys(at::attr::types);
-            const auto num_inputs = types.size();
+          // The guard types of a node are fixed once it is built, so they
+          // are cast once instead of being copied out of the node by every
+          // run of the guard
+          std::vector<c10::TensorTypePtr> guard_tensor_types;
+          for (const auto& type : node->tys(at::attr::types)) {
+            guard_tensor_types.push_back(type->cast<at::TensorType>());
+          }
+          return [guard_tensor_types = std::move(guard_tensor_types)](
+                     torch::jit::Stack& stack) {
+            const auto num_inputs = guard_tensor_types.size();
             at::ArrayRef<c10::IValue> inputs =
                 torch::jit::last(stack, num_inputs);
             torch::jit::drop(stack, num_inputs);
@@ -285,14 +291,11 @@ torch::jit::RegisterOperators reg_guard({
             }
 
             for (const auto i : c10::irange(num_inputs)) {
-              const c10::TensorTypePtr& guard_tensor_type =
-                  types[i]->cast<at::TensorType>();
-
               // TODO: maybe we should just push false and fallback
               TORCH_INTERNAL_ASSERT(inputs[i].isTensor());
               const at::Tensor& tensor = inputs[i].toTensor();
 
-              if (!nvfuser::complyWith(tensor, guard_tensor_type)) {
+              if (!nvfuser::complyWith(tensor, guard_tensor_types[i])) {
                 torch::jit::push(stack, c10::IValue(false));
                 return;
               }
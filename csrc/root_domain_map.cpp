@@ -91,6 +91,12 @@ std::unordered_map<IterDomain*, IterDomain*> PairwiseRootDomainMap::map(
       require_same_extent_) {
     // Nothing to map when having same extent is required
     return {};
+  } else if (
+      consumer_tv_->definition()->isA<ScatterOp>() &&
+      consumer_tv_->definition()->as<ScatterOp>()->selfTv() == producerTv() &&
+      require_same_extent_) {
+    // Same for the self tensor of scatter, see Note [ Scatter outputs ]
+    return {};
   }
 
   std::vector<bool> broadcast_flags;
@@ -1150,6 +1156,30 @@ void ComputeAtRootDomainMapBuilder::handle(TorchGatherOp* op) {
   }
 }
 
+void ComputeAtRootDomainMapBuilder::handle(ScatterOp* op) {
+  const TensorDomain* out_td = op->output(0)->as<TensorView>()->domain();
+  const auto& out_root = out_td->getRootDomain();
+
+  // Only maps the index and src root axes. Do not map the self axes due to
+  // non-equal size problem.
+  for (auto inp : {op->indexTv(), op->srcTv()}) {
+    const TensorDomain* in_td = inp->domain();
+    const auto in_root =
+        TensorDomain::noReductions(in_td->getMaybeRFactorDomain());
+    TORCH_INTERNAL_ASSERT(
+        in_root.size() == out_root.size(),
+        "\nExpression: ",
+        op,
+        "\nInput root domain: ",
+        in_root,
+        "\nOutput root domain: ",
+        out_root);
+    for (const auto it : c10::irange(in_root.size())) {
+      setMaybeMapped(in_td, in_root[it], out_td, out_root[it]);
+    }
+  }
+}
+
 void ComputeAtRootDomainMapBuilder::mapAllPendingMappings(
     const DomainKey& key) {
   auto it = pending_map_.find(key);
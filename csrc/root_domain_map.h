@@ -429,6 +429,12 @@ class TORCH_CUDA_CU_API ComputeAtRootDomainMapBuilder
 
   void handle(TorchGatherOp* top) override;
 
+  void handle(ScatterOp* op) override;
+
+  void handle(ScanOp* op) override {
+    mapPointwiseOrReductionOp(op);
+  }
+
   void handle(ReductionOp* op) override {
     mapPointwiseOrReductionOp(op);
   }
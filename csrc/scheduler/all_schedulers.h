@@ -6,9 +6,14 @@
  */
 // clang-format on
 #pragma once
+#include <scheduler/attention.h>
+#include <scheduler/index_select.h>
+#include <scheduler/matmul.h>
 #include <scheduler/normalization.h>
 #include <scheduler/pointwise.h>
 #include <scheduler/reduction.h>
+#include <scheduler/scan.h>
+#include <scheduler/stencil.h>
 #include <scheduler/transpose.h>
 
 namespace nvfuser {
@@ -19,7 +24,12 @@ enum class TORCH_CUDA_CU_API ScheduleHeuristic {
   PointWise,
   Reduction,
   Persistent,
-  Transpose
+  Transpose,
+  Matmul,
+  IndexSelect,
+  Scan,
+  Attention,
+  Stencil
 };
 
 } // namespace nvfuser
@@ -0,0 +1,611 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <scheduler/attention.h>
+
+#include <compute_at_map.h>
+#include <device_profile.h>
+#include <inlining.h>
+#include <instrumentation.h>
+#include <ir_utils.h>
+#include <ops/arith.h>
+#include <scheduler/registry.h>
+#include <scheduler/utils.h>
+#include <transform_replay.h>
+#include <utils.h>
+
+#include <algorithm>
+
+namespace nvfuser {
+
+namespace {
+
+// Keys of a row spread across the threads of a block before a thread holds
+// more than one of their scores
+constexpr int64_t kMaxKeyThreads = 256;
+
+// Scores of a row a thread holds in registers
+constexpr int64_t kMaxPersistentBatch = 16;
+
+constexpr int64_t kMaxThreadsPerBlock = 512;
+constexpr int64_t kMaxRowsPerBlock = 4;
+
+// The two contractions of an attention fusion and the dimensions they
+// contract, see Note [ Attention scheduling ]
+struct AttentionPattern {
+  // Contraction of the queries with the keys
+  TensorView* scores = nullptr;
+  // Contraction of the probabilities with the values
+  TensorView* context = nullptr;
+  // Root domains of the scores along the query rows, e.g. batch, heads and
+  // queries
+  std::vector<IterDomain*> row_ids;
+  IterDomain* key_id = nullptr;
+  IterDomain* head_id = nullptr;
+  IterDomain* value_id = nullptr;
+};
+
+enum class AttentionDim { Row, Key, Head, Value, Other };
+
+AttentionDim classify(
+    const ComputeAtMap& ca_map,
+    const AttentionPattern& pattern,
+    IterDomain* id) {
+  auto is_mapped = [&](IterDomain* other) {
+    return other != nullptr &&
+        ca_map.areMapped(id, other, IdMappingMode::EXACT);
+  };
+  if (std::any_of(
+          pattern.row_ids.begin(), pattern.row_ids.end(), is_mapped)) {
+    return AttentionDim::Row;
+  }
+  if (is_mapped(pattern.key_id)) {
+    return AttentionDim::Key;
+  }
+  if (is_mapped(pattern.head_id)) {
+    return AttentionDim::Head;
+  }
+  if (is_mapped(pattern.value_id)) {
+    return AttentionDim::Value;
+  }
+  return AttentionDim::Other;
+}
+
+bool hasDim(
+    const ComputeAtMap& ca_map,
+    const AttentionPattern& pattern,
+    TensorView* tv,
+    AttentionDim dim) {
+  const auto& root = tv->getRootDomain();
+  return std::any_of(root.begin(), root.end(), [&](IterDomain* id) {
+    return !id->isBroadcast() && classify(ca_map, pattern, id) == dim;
+  });
+}
+
+// A contraction is a sum of products: an mma op, or a sum of a
+// multiplication nothing else uses
+bool isContraction(TensorView* tv) {
+  auto def = tv->definition();
+  if (def == nullptr) {
+    return false;
+  }
+  if (def->isA<MmaOp>()) {
+    return true;
+  }
+  auto rop = dynamic_cast<ReductionOp*>(def);
+  if (rop == nullptr || rop->getReductionOpType() != BinaryOpType::Add) {
+    return false;
+  }
+  auto bop = dynamic_cast<BinaryOp*>(rop->in()->definition());
+  return bop != nullptr && bop->getBinaryOpType() == BinaryOpType::Mul &&
+      rop->in()->uses().size() == 1;
+}
+
+// The tensor holding the products of a contraction, the contraction itself
+// for an mma op
+TensorView* productOf(TensorView* contraction) {
+  auto def = contraction->definition();
+  if (def->isA<MmaOp>()) {
+    return contraction;
+  }
+  return def->input(0)->as<TensorView>();
+}
+
+IterDomain* onlyReductionId(TensorView* tv) {
+  IterDomain* reduction_id = nullptr;
+  for (auto id : tv->getRootDomain()) {
+    if (!id->isReduction()) {
+      continue;
+    }
+    if (reduction_id != nullptr) {
+      return nullptr;
+    }
+    reduction_id = id;
+  }
+  return reduction_id;
+}
+
+// Fills pattern with the contractions of fusion and returns an empty
+// string, or returns why fusion isn't an attention fusion
+std::string findAttentionPattern(
+    Fusion* fusion,
+    const ComputeAtMap& ca_map,
+    AttentionPattern& pattern) {
+  std::vector<TensorView*> contractions;
+  for (auto tv : ir_utils::allTvs(fusion)) {
+    if (isContraction(tv)) {
+      contractions.push_back(tv);
+    }
+  }
+  if (contractions.size() != 2) {
+    return "expected two contractions";
+  }
+  if (DependencyCheck::isDependencyOf(contractions[1], contractions[0])) {
+    std::swap(contractions[0], contractions[1]);
+  }
+  pattern.scores = contractions[0];
+  pattern.context = contractions[1];
+  if (!DependencyCheck::isDependencyOf(pattern.scores, pattern.context)) {
+    return "the contractions are not chained";
+  }
+
+  pattern.head_id = onlyReductionId(pattern.scores);
+  auto context_key_id = onlyReductionId(pattern.context);
+  if (pattern.head_id == nullptr || context_key_id == nullptr) {
+    return "the contractions don't reduce a single dimension";
+  }
+
+  for (auto id : pattern.scores->getRootDomain()) {
+    if (id->isReduction()) {
+      continue;
+    }
+    if (id->isBroadcast()) {
+      return "broadcast dimension in the scores";
+    }
+    if (ca_map.areMapped(id, context_key_id, IdMappingMode::EXACT)) {
+      pattern.key_id = id;
+    } else {
+      pattern.row_ids.push_back(id);
+    }
+  }
+  if (pattern.key_id == nullptr) {
+    return "the second contraction doesn't reduce the keys of the scores";
+  }
+  if (pattern.row_ids.empty()) {
+    return "no query rows";
+  }
+
+  size_t n_context_rows = 0;
+  for (auto id : pattern.context->getRootDomain()) {
+    if (id->isReduction()) {
+      continue;
+    }
+    if (id->isBroadcast()) {
+      return "broadcast dimension in the context";
+    }
+    if (classify(ca_map, pattern, id) == AttentionDim::Row) {
+      n_context_rows++;
+    } else if (pattern.value_id == nullptr) {
+      pattern.value_id = id;
+    } else {
+      return "the context has more than one dimension besides the rows";
+    }
+  }
+  if (n_context_rows != pattern.row_ids.size()) {
+    return "the context doesn't have the rows of the scores";
+  }
+  if (pattern.value_id == nullptr) {
+    return "the context has no dimension besides the rows";
+  }
+  if (classify(ca_map, pattern, pattern.head_id) != AttentionDim::Head ||
+      classify(ca_map, pattern, pattern.value_id) != AttentionDim::Value) {
+    return "the head dimensions are mapped to other dimensions";
+  }
+
+  if (!ir_utils::getViewOps(fusion).empty()) {
+    return "no support for view ops";
+  }
+
+  for (auto expr : fusion->exprs()) {
+    if (expr->isOneOf<SelectOp, IndexSelectOp, TorchGatherOp, ScatterOp>()) {
+      return "no support for gather-like ops";
+    }
+    if (expr->isOneOf<PadOp, SliceOp, CatOp>()) {
+      return "no support for resize ops";
+    }
+    if (expr->isOneOf<WelfordOp, GroupedReductionOp, GroupedWelfordOp>()) {
+      return "no support for welford and grouped reduction ops";
+    }
+    if (auto mma = dynamic_cast<MmaOp*>(expr)) {
+      if (!mma->init()->isZero()) {
+        return "mma op with a non-zero initial value";
+      }
+      continue;
+    }
+    auto rop = dynamic_cast<ReductionOp*>(expr);
+    if (rop == nullptr || rop->out() == pattern.scores ||
+        rop->out() == pattern.context) {
+      continue;
+    }
+    auto out = rop->out()->as<TensorView>();
+    for (auto id : out->getRootDomain()) {
+      if (id->isReduction() &&
+          classify(ca_map, pattern, id) != AttentionDim::Key) {
+        return "reduction of the scores along other dimensions than the keys";
+      }
+    }
+    if (DependencyCheck::isDependencyOf(pattern.context, out)) {
+      return "reduction of the context";
+    }
+  }
+
+  for (auto tv : ir_utils::allTvs(fusion)) {
+    for (auto ids : {tv->getRootDomain(), tv->getMaybeRFactorDomain()}) {
+      for (auto id : ids) {
+        if (!id->isBroadcast() &&
+            classify(ca_map, pattern, id) == AttentionDim::Other) {
+          return "dimension that isn't a row, a key or a head dimension";
+        }
+      }
+    }
+  }
+
+  return "";
+}
+
+// Tensors computed in the loops of the context, see Note [ Attention
+// scheduling ]. Everything else but the fusion inputs is computed in the
+// loops of the scores.
+std::unordered_set<TensorView*> getContextTvs(
+    Fusion* fusion,
+    const ComputeAtMap& ca_map,
+    const AttentionPattern& pattern) {
+  std::unordered_set<Val*> seeds{productOf(pattern.context)};
+  for (auto tv : ir_utils::allTvs(fusion)) {
+    if (!tv->isFusionInput() &&
+        hasDim(ca_map, pattern, tv, AttentionDim::Value)) {
+      seeds.insert(tv);
+    }
+  }
+  auto dependents = DependencyCheck::getAllDependentVals(seeds);
+  dependents.insert(seeds.begin(), seeds.end());
+  auto context_tvs = ir_utils::filterByType<TensorView>(dependents);
+  return {context_tvs.begin(), context_tvs.end()};
+}
+
+// Tensors of the scores loops read by the context loops, which are stored
+// in shared memory
+std::vector<TensorView*> getSharedTvs(
+    Fusion* fusion,
+    const std::unordered_set<TensorView*>& context_tvs) {
+  std::vector<TensorView*> shared_tvs;
+  for (auto tv : ir_utils::allTvs(fusion)) {
+    if (tv->isFusionInput() || context_tvs.count(tv)) {
+      continue;
+    }
+    auto consumers = ir_utils::consumerTvsOf(tv);
+    if (std::any_of(consumers.begin(), consumers.end(), [&](auto consumer) {
+          return context_tvs.count(consumer) > 0;
+        })) {
+      shared_tvs.push_back(tv);
+    }
+  }
+  return shared_tvs;
+}
+
+// Sizes of an attention fusion for the given inputs
+struct AttentionSizes {
+  int64_t n_rows = 1;
+  int64_t n_keys = 1;
+  int64_t n_values = 1;
+  int64_t persistent_batch = 1;
+  int64_t key_threads = 1;
+  // Shared memory holding the tensors read by the context loops of a row
+  int64_t row_smem = 0;
+};
+
+AttentionSizes getAttentionSizes(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info) {
+  ComputeAtMap ca_map(fusion);
+  AttentionPattern pattern;
+  auto reason = findAttentionPattern(fusion, ca_map, pattern);
+  TORCH_INTERNAL_ASSERT(reason.empty(), "Not an attention fusion: ", reason);
+
+  auto& expr_eval = runtime_info.expressionEvaluator();
+  auto extent_of = [&](IterDomain* id) {
+    auto extent = expr_eval.evaluate(id->extent());
+    TORCH_INTERNAL_ASSERT(
+        extent.has_value(),
+        "Error inferring size for attention scheduler: ",
+        id->extent()->toInlineString());
+    return extent->as<int64_t>();
+  };
+
+  AttentionSizes sizes;
+  for (auto id : pattern.row_ids) {
+    sizes.n_rows *= extent_of(id);
+  }
+  sizes.n_keys = extent_of(pattern.key_id);
+  sizes.n_values = extent_of(pattern.value_id);
+  sizes.persistent_batch =
+      std::max(ceilDiv(sizes.n_keys, kMaxKeyThreads), (int64_t)1);
+  sizes.key_threads = ceilDiv(sizes.n_keys, sizes.persistent_batch);
+
+  // Mma ops are translated to float products, see Note [ Attention
+  // scheduling ]
+  auto context_tvs = getContextTvs(fusion, ca_map, pattern);
+  for (auto tv : getSharedTvs(fusion, context_tvs)) {
+    if (!hasDim(ca_map, pattern, tv, AttentionDim::Key)) {
+      continue;
+    }
+    const auto elem_size = std::max(
+        (int64_t)dataTypeSize(tv->getDataType().value()),
+        (int64_t)sizeof(float));
+    sizes.row_smem +=
+        sizes.persistent_batch * sizes.key_threads * elem_size;
+  }
+  return sizes;
+}
+
+// Shared memory left by the block reductions and broadcasts
+int64_t attentionSmemSize() {
+  const auto& dev_prop = getCurrentDeviceProfile();
+  const int64_t reduction_workspace_size =
+      dev_prop.max_threads_per_block * (int64_t)sizeof(double);
+  return dev_prop.smem_per_block_optin - reduction_workspace_size;
+}
+
+// Translates the mma ops of the contractions to float products summed along
+// the reduced dimension, see Note [ Attention scheduling ]
+void translateMmaOps(Fusion* fusion) {
+  auto exprs = fusion->exprs();
+  for (auto mma : ir_utils::filterByType<MmaOp>(exprs)) {
+    auto old_out = mma->out()->as<TensorView>();
+    std::vector<int> axes;
+    const auto& root = old_out->getRootDomain();
+    for (const auto i : c10::irange(root.size())) {
+      if (root[i]->isReduction()) {
+        axes.push_back((int)i);
+      }
+    }
+    auto product = mul(
+        castOp(DataType::Float, mma->inA()->as<TensorView>()),
+        castOp(DataType::Float, mma->inB()->as<TensorView>()));
+    auto new_out = sum(product, axes);
+    for (auto use : std::vector<Expr*>(old_out->uses())) {
+      ir_utils::replaceValInExpr(use, old_out, new_out);
+    }
+    if (old_out->isFusionOutput()) {
+      fusion->replaceOutput(old_out, new_out);
+    }
+  }
+}
+
+// Reorders tv as [rows..., inner_ids...] and merges the rows
+void mergeRows(
+    TensorView* tv,
+    const ComputeAtMap& ca_map,
+    const AttentionPattern& pattern,
+    const std::vector<IterDomain*>& inner_ids) {
+  std::vector<IterDomain*> ordered_ids = pattern.row_ids;
+  ordered_ids.insert(ordered_ids.end(), inner_ids.begin(), inner_ids.end());
+  TORCH_INTERNAL_ASSERT(ordered_ids.size() == tv->nDims());
+
+  std::unordered_map<int, int> old2new;
+  for (const auto new_pos : c10::irange(ordered_ids.size())) {
+    for (const auto old_pos : c10::irange(tv->nDims())) {
+      if (ca_map.areMapped(
+              tv->axis((int)old_pos),
+              ordered_ids[new_pos],
+              IdMappingMode::EXACT)) {
+        old2new[(int)old_pos] = (int)new_pos;
+        break;
+      }
+    }
+  }
+  TORCH_INTERNAL_ASSERT(
+      old2new.size() == ordered_ids.size(),
+      "Unexpected dimensions of ",
+      tv->toString());
+  tv->reorder(old2new);
+
+  for (size_t i = 1; i < pattern.row_ids.size(); i++) {
+    tv->merge(0);
+  }
+}
+
+void propagateWithin(
+    TensorView* reference_tv,
+    const std::vector<TensorView*>& tvs) {
+  SetSelector selector({tvs.begin(), tvs.end()});
+  MaxRootDomainInfoSpanningTree spanning_tree(reference_tv, &selector);
+  TransformPropagator propagator(reference_tv);
+  spanning_tree.traverse(&propagator);
+  scheduler_utils::parallelizeAllLike(reference_tv, tvs);
+}
+
+} // namespace
+
+std::string getAttentionCompileTimeRejectReason(Fusion* fusion) {
+  FusionGuard fg(fusion);
+
+  ComputeAtMap ca_map(fusion);
+  AttentionPattern pattern;
+  auto reason = findAttentionPattern(fusion, ca_map, pattern);
+  if (!reason.empty()) {
+    return reason;
+  }
+
+  for (auto tv : getContextTvs(fusion, ca_map, pattern)) {
+    if (hasDim(ca_map, pattern, tv, AttentionDim::Head)) {
+      return "the head dimension of the queries is used by the context";
+    }
+  }
+
+  return "";
+}
+
+std::string getAttentionRuntimeRejectReason(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info) {
+  FusionGuard fg(fusion);
+
+  auto sizes = getAttentionSizes(fusion, runtime_info);
+  if (sizes.persistent_batch > kMaxPersistentBatch) {
+    return "too many keys to hold the scores of a row in registers";
+  }
+  const auto& dev_prop = getCurrentDeviceProfile();
+  if (sizes.n_values > dev_prop.max_threads_per_block) {
+    return "the head dimension of the values is larger than a block";
+  }
+  if (sizes.row_smem > attentionSmemSize()) {
+    return "the probabilities of a row don't fit in shared memory";
+  }
+  return "";
+}
+
+std::shared_ptr<AttentionParams> getAttentionHeuristics(
+    Fusion* fusion,
+    const at::ArrayRef<c10::IValue>& runtime_inputs,
+    HeuristicSummary* data_cache) {
+  SchedulerRuntimeInfo runtime_info(fusion, runtime_inputs, true);
+  return getAttentionHeuristics(fusion, runtime_info, data_cache);
+}
+
+std::shared_ptr<AttentionParams> getAttentionHeuristics(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    HeuristicSummary* data_cache) {
+  FUSER_PERF_SCOPE("getAttentionHeuristics");
+
+  FusionGuard fg(fusion);
+
+  auto params = std::make_shared<AttentionParams>(
+      "Attention heuristics", runtime_info.getIndexMode());
+
+  auto sizes = getAttentionSizes(fusion, runtime_info);
+  params->persistent_batch = sizes.persistent_batch;
+
+  // Rows of a block share the loads of the keys and the values
+  const int64_t bdimx = std::max(sizes.key_threads, sizes.n_values);
+  const int64_t smem_size = attentionSmemSize();
+  while (params->rows_per_block * 2 <= kMaxRowsPerBlock &&
+         params->rows_per_block * 2 <= sizes.n_rows &&
+         bdimx * params->rows_per_block * 2 <= kMaxThreadsPerBlock &&
+         sizes.row_smem * params->rows_per_block * 2 <= smem_size) {
+    params->rows_per_block *= 2;
+  }
+
+  if (isDebugDumpEnabled(DebugDumpOption::SchedulerDebug)) {
+    std::cerr << "\n===== Attention Stats ========\n"
+              << "rows: " << sizes.n_rows << " keys: " << sizes.n_keys
+              << " values: " << sizes.n_values << "\n"
+              << "shared memory per row: " << sizes.row_smem << std::endl;
+    std::cerr << params->toString() << std::endl;
+  }
+
+  return params;
+}
+
+// TODO: remove or return launch parameters
+LaunchParams scheduleAttention(
+    Fusion* fusion,
+    const at::ArrayRef<c10::IValue>& runtime_inputs) {
+  FUSER_PERF_SCOPE("scheduleFusion");
+  auto params = getAttentionHeuristics(fusion, runtime_inputs);
+  TORCH_INTERNAL_ASSERT(
+      params != nullptr, "Could not schedule attention fusion.");
+  scheduleAttention(fusion, *params);
+  return params->lparams;
+}
+
+void scheduleAttention(Fusion* fusion, const AttentionParams& params) {
+  FusionGuard fg(fusion);
+
+  translateMmaOps(fusion);
+
+  // Make sure we don't have global memory set on intermediate tensors from
+  // fusion segmentation
+  scheduler_utils::clearMemorySpace(fusion);
+
+  scheduler_utils::cacheInputs(fusion, true);
+  scheduler_utils::cacheAndForkOutputs(fusion, true);
+
+  ComputeAtMap ca_map(fusion);
+  AttentionPattern pattern;
+  auto reason = findAttentionPattern(fusion, ca_map, pattern);
+  TORCH_INTERNAL_ASSERT(reason.empty(), "Not an attention fusion: ", reason);
+
+  const auto context_tv_set = getContextTvs(fusion, ca_map, pattern);
+  std::vector<TensorView*> scores_tvs;
+  std::vector<TensorView*> context_tvs;
+  for (auto tv : ir_utils::allTvs(fusion)) {
+    if (tv->isFusionInput()) {
+      continue;
+    }
+    if (context_tv_set.count(tv)) {
+      context_tvs.push_back(tv);
+    } else {
+      scores_tvs.push_back(tv);
+    }
+  }
+  const auto shared_tvs = getSharedTvs(fusion, context_tv_set);
+
+  // [rows, keys, head] -> [BIDx, TIDy, persistent_batch, TIDx, head]
+  auto scores_ref = productOf(pattern.scores);
+  mergeRows(scores_ref, ca_map, pattern, {pattern.key_id, pattern.head_id});
+  scores_ref->split(0, params.rows_per_block);
+  scores_ref->split(2, params.persistent_batch, false);
+  scores_ref->axis(0)->parallelize(ParallelType::BIDx);
+  scores_ref->axis(1)->parallelize(ParallelType::TIDy);
+  scores_ref->axis(3)->parallelize(ParallelType::TIDx);
+  propagateWithin(scores_ref, scores_tvs);
+
+  // The softmax reductions first reduce the persistent batch of a thread
+  for (auto tv : scores_tvs) {
+    if (tv == pattern.scores || !tv->hasReduction()) {
+      continue;
+    }
+    std::vector<int> serial_axes;
+    bool has_thread_axis = false;
+    for (const auto i : c10::irange(tv->nDims())) {
+      auto id = tv->axis((int)i);
+      if (!id->isReduction()) {
+        continue;
+      }
+      if (id->isThread()) {
+        has_thread_axis = true;
+      } else {
+        serial_axes.push_back((int)i);
+      }
+    }
+    if (has_thread_axis && !serial_axes.empty()) {
+      tv->rFactor(serial_axes);
+    }
+  }
+
+  // [rows, values, keys] -> [BIDx, TIDy, TIDx, keys]
+  auto context_ref = productOf(pattern.context);
+  mergeRows(
+      context_ref, ca_map, pattern, {pattern.value_id, pattern.key_id});
+  context_ref->split(0, params.rows_per_block);
+  context_ref->axis(0)->parallelize(ParallelType::BIDx);
+  context_ref->axis(1)->parallelize(ParallelType::TIDy);
+  context_ref->axis(2)->parallelize(ParallelType::TIDx);
+  propagateWithin(context_ref, context_tvs);
+
+  for (auto tv : shared_tvs) {
+    tv->setMemoryType(MemoryType::Shared);
+  }
+
+  // The scores of a row are reduced along the keys and broadcast back, so
+  // they are held by each thread for its persistent batch
+  inlineMost();
+}
+
+} // namespace nvfuser
@@ -0,0 +1,84 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <ATen/core/ivalue.h>
+
+#include <fusion.h>
+#include <scheduler/attention_heuristic.h>
+
+namespace nvfuser {
+
+// Note [ Attention scheduling ]
+//
+// An attention fusion contracts the queries with the keys, normalizes the
+// scores along the keys and contracts the probabilities with the values,
+// e.g. with the values given transposed
+//
+//   T3[i0, i1] = fusedMultiplySum(T0[i0, b, i2], T1[b, i1, i2], {-1})
+//   T4[i0, i1] = softmax(T3 * scale, 1)
+//   T5[i0, i3] = fusedMultiplySum(half(T4)[i0, b, i1], T2[b, i3, i1], {-1})
+//
+// where i0 are the query rows, merged with any batch dimensions, i1 the keys,
+// i2 the head dimension and i3 the head dimension of the values. Segmenting
+// it at the mma ops writes the [i0, i1] scores to global memory. Instead,
+// the attention scheduler computes a block of query rows in a single kernel
+// holding their scores on chip:
+//
+//  1. The scores of a row are computed with the keys split across the
+//     threads of the block, [BIDx, TIDy, persistent_batch, TIDx, i2], each
+//     thread walking the head dimension serially and keeping its
+//     persistent_batch scores in registers. The softmax reductions along the
+//     keys are block allreduces, as in the persistent normalization kernels.
+//  2. The probabilities, and anything else of step 1 used by step 2, are
+//     stored in shared memory.
+//  3. The context is computed with the head dimension of the values on the
+//     threads, [BIDx, TIDy, TIDx, i1], each thread walking the keys serially
+//     and reading the probabilities from shared memory.
+//
+// The two steps are scheduled from their own reference, the product of each
+// contraction, as the two groups of the transpose scheduler are. Mma ops are
+// translated to a cast, a multiplication and a sum before scheduling, so the
+// contractions run on CUDA cores in float and the keys of a row are not
+// tiled with an online softmax: the scores of a row must fit in registers and
+// shared memory, which bounds the number of keys, and longer sequences are
+// left to the segmenter.
+
+class SchedulerRuntimeInfo;
+class HeuristicSummary;
+
+TORCH_CUDA_CU_API std::shared_ptr<AttentionParams> getAttentionHeuristics(
+    Fusion* fusion,
+    const at::ArrayRef<c10::IValue>& runtime_inputs,
+    HeuristicSummary* data_cache = nullptr);
+
+TORCH_CUDA_CU_API std::shared_ptr<AttentionParams> getAttentionHeuristics(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    HeuristicSummary* data_cache = nullptr);
+
+TORCH_CUDA_CU_API void scheduleAttention(
+    Fusion* fusion,
+    const AttentionParams& params);
+
+TORCH_CUDA_CU_API LaunchParams scheduleAttention(
+    Fusion* fusion,
+    const at::ArrayRef<c10::IValue>& runtime_inputs);
+
+//! Returns an empty string if the fusion has the structure the attention
+//! scheduler handles, otherwise the reason why it doesn't
+TORCH_CUDA_CU_API std::string getAttentionCompileTimeRejectReason(
+    Fusion* fusion);
+
+//! Returns an empty string if the scores of a row of the given inputs fit on
+//! chip, otherwise the reason why they don't
+TORCH_CUDA_CU_API std::string getAttentionRuntimeRejectReason(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info);
+
+} // namespace nvfuser
@@ -0,0 +1,64 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <scheduler/heuristic.h>
+
+#include <sstream>
+
+namespace nvfuser {
+
+// Parameters of the attention heuristic, see Note [ Attention scheduling ].
+// The block shape is inferred from the scheduled kernel.
+// Warning: equal operator is intended for use in caching the kernel associated
+// with these parameters. It does not check if the launch parameters are
+// equivelent!
+class AttentionParams : public HeuristicParams {
+ public:
+  // Scores of a row held in registers by each thread
+  int64_t persistent_batch = 1;
+
+  // Query rows computed by a block, one per TIDy
+  int64_t rows_per_block = 1;
+
+  using HeuristicParams::HeuristicParams;
+
+  // Warning: Does not check launch parameters!
+  bool sameAs(
+      const std::shared_ptr<HeuristicParams>& other_base) const override {
+    auto other_casted = std::dynamic_pointer_cast<AttentionParams>(other_base);
+    if (other_casted == nullptr) {
+      return false;
+    }
+    return other_casted->cparams == cparams &&
+        other_casted->persistent_batch == persistent_batch &&
+        other_casted->rows_per_block == rows_per_block;
+  }
+
+  std::string toString() const override {
+    std::stringstream ss;
+    ss << "\n===== Attention Parameters ========\n"
+       << (tag == "" ? "" : "Tag: ") << tag << "\n"
+       << " Persistent batch: " << persistent_batch << "\n"
+       << " Rows per block: " << rows_per_block << "\n"
+       << "====================================\n";
+    return ss.str();
+  }
+
+  // Warning: Hash is not based on launch parameters!
+  size_t hash() const override {
+    return (static_cast<size_t>(persistent_batch) << 8) ^
+        static_cast<size_t>(rows_per_block);
+  }
+
+  std::shared_ptr<HeuristicParams> clone() const override {
+    return std::make_shared<AttentionParams>(*this);
+  }
+};
+
+} // namespace nvfuser
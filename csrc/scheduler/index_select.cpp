@@ -0,0 +1,283 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <scheduler/index_select.h>
+
+#include <compute_at_map.h>
+#include <inlining.h>
+#include <instrumentation.h>
+#include <ir_utils.h>
+#include <scheduler/pointwise.h>
+#include <scheduler/registry.h>
+#include <scheduler/transpose.h>
+#include <scheduler/utils.h>
+#include <transform_replay.h>
+#include <utils.h>
+
+#include <algorithm>
+
+namespace nvfuser {
+
+namespace {
+
+constexpr int64_t kThreadsPerBlock = 128;
+
+// A row is covered by at most 65535 blocks of BIDy
+constexpr int64_t kMaxGridY = 65535;
+
+// Smallest power of two no less than n
+int64_t ceilPow2(int64_t n) {
+  auto pow2 = scheduler_utils::lastPow2(n);
+  return pow2 < n ? pow2 * 2 : pow2;
+}
+
+// The inputs and outputs accessed along the gathered rows, and the
+// index_select outputs the rows of the lookups are loaded into
+std::vector<TensorView*> getVectorizableTvs(
+    Fusion* fusion,
+    TensorView* reference_tv) {
+  auto vectorizable_tvs =
+      scheduler_utils::getInputsOutputsWithInnerDim(reference_tv, true, true);
+  for (auto sop : ir_utils::getIndexSelectOps(fusion)) {
+    vectorizable_tvs.push_back(sop->input(0)->as<TensorView>());
+  }
+  return vectorizable_tvs;
+}
+
+} // namespace
+
+std::string getIndexSelectCompileTimeRejectReason(Fusion* fusion) {
+  FusionGuard fg(fusion);
+
+  auto index_select_ops = ir_utils::getIndexSelectOps(fusion);
+  if (index_select_ops.empty()) {
+    return "no index_select op to schedule";
+  }
+
+  for (auto expr : fusion->exprs()) {
+    if (expr->isOneOf<SelectOp, TorchGatherOp, ScatterOp>()) {
+      return "no support for gather-like ops other than index_select";
+    }
+  }
+
+  if (!ir_utils::getViewOps(fusion).empty()) {
+    return "no support for view ops";
+  }
+
+  if (hasAtLeastTwoValidGroups(fusion)) {
+    return "inputs or outputs are transposed";
+  }
+
+  auto reference_tv = getReferenceTensorView(fusion);
+  if (reference_tv == nullptr) {
+    return "cannot find reference tensor";
+  }
+  auto ref_root =
+      TensorDomain::noReductions(reference_tv->getMaybeRFactorDomain());
+  if (ref_root.size() < 2 || ref_root.back()->isBroadcast()) {
+    return "reference has no concrete inner dimension to gather along";
+  }
+
+  ComputeAtMap ca_map(fusion);
+  for (auto sop : index_select_ops) {
+    auto lookup_root = TensorDomain::noReductions(
+        sop->input(0)->as<TensorView>()->getMaybeRFactorDomain());
+    if (sop->getSelectAxis() == lookup_root.back()) {
+      return "index_select on the inner dimension gathers no rows";
+    }
+    if (!ca_map.areMapped(
+            lookup_root.back(), ref_root.back(), IdMappingMode::EXACT)) {
+      return "gathered rows are not on the inner dimension of the reference";
+    }
+  }
+
+  return "";
+}
+
+std::string getIndexSelectRuntimeRejectReason(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info) {
+  // The rows of all the lookups map to the same dimension
+  auto lookup_tv =
+      ir_utils::getIndexSelectOps(fusion).at(0)->input(0)->as<TensorView>();
+  auto row_size = runtime_info.expressionEvaluator().evaluate(
+      TensorDomain::noReductions(lookup_tv->getMaybeRFactorDomain())
+          .back()
+          ->extent());
+  TORCH_INTERNAL_ASSERT(
+      row_size.has_value(), "Error inferring the row size of ", lookup_tv);
+  if (ceilDiv(row_size->as<int64_t>(), kThreadsPerBlock) > kMaxGridY) {
+    return "gathered rows are too long for the grid";
+  }
+  return "";
+}
+
+std::shared_ptr<IndexSelectParams> getIndexSelectHeuristics(
+    Fusion* fusion,
+    const at::ArrayRef<c10::IValue>& runtime_inputs,
+    HeuristicSummary* data_cache) {
+  SchedulerRuntimeInfo runtime_info(fusion, runtime_inputs, true);
+  return getIndexSelectHeuristics(fusion, runtime_info, data_cache);
+}
+
+std::shared_ptr<IndexSelectParams> getIndexSelectHeuristics(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    HeuristicSummary* data_cache) {
+  FUSER_PERF_SCOPE("getIndexSelectHeuristics");
+
+  FusionGuard fg(fusion);
+
+  auto params = std::make_shared<IndexSelectParams>(
+      "Index select heuristics", runtime_info.getIndexMode());
+
+  auto reference_tv = getReferenceTensorView(fusion);
+  TORCH_INTERNAL_ASSERT(reference_tv != nullptr);
+
+  // [rows, row_size] of the reference
+  auto ref_root =
+      TensorDomain::noReductions(reference_tv->getMaybeRFactorDomain());
+  auto& expr_eval = runtime_info.expressionEvaluator();
+  int64_t n_rows = 1;
+  int64_t row_size = 1;
+  for (auto i : c10::irange(ref_root.size())) {
+    auto extent = expr_eval.evaluate(ref_root[i]->extent());
+    TORCH_INTERNAL_ASSERT(
+        extent.has_value(),
+        "Error inferring size for index_select scheduler: ",
+        ref_root[i]->extent()->toInlineString());
+    if (i + 1 < ref_root.size()) {
+      n_rows *= extent->as<int64_t>();
+    } else {
+      row_size = extent->as<int64_t>();
+    }
+  }
+
+  // The widest vector that divides the rows and that every vectorized
+  // tensor, including the lookups, is aligned to
+  int64_t vectorize_factor =
+      (int64_t)SchedulerRuntimeInfo::max_alignment_size_in_byte;
+  for (auto tv : getVectorizableTvs(fusion, reference_tv)) {
+    vectorize_factor = std::min(
+        vectorize_factor,
+        (int64_t)runtime_info.getInnerDimVectorizableWidth(tv));
+  }
+  params->vectorize_factor = std::max(vectorize_factor, (int64_t)1);
+
+  // Threads of a block cover a row, or several short rows
+  const auto vectors_per_row =
+      std::max(ceilDiv(row_size, params->vectorize_factor), (int64_t)1);
+  const int64_t bdimx = std::min(ceilPow2(vectors_per_row), kThreadsPerBlock);
+  const int64_t bdimy = std::min(
+      kThreadsPerBlock / bdimx, ceilPow2(std::max(n_rows, (int64_t)1)));
+  params->lparams.bind(bdimx, ParallelType::TIDx);
+  params->lparams.bind(bdimy, ParallelType::TIDy);
+
+  if (isDebugDumpEnabled(DebugDumpOption::SchedulerDebug)) {
+    std::cerr << "\n===== Index Select Stats ========\n"
+              << "rows: " << n_rows << " row_size: " << row_size << "\n"
+              << "vectorize_factor: " << params->vectorize_factor << std::endl;
+    std::cerr << params->toString() << std::endl;
+  }
+
+  return params;
+}
+
+// TODO: remove or return launch parameters
+LaunchParams scheduleIndexSelect(
+    Fusion* fusion,
+    const at::ArrayRef<c10::IValue>& runtime_inputs) {
+  FUSER_PERF_SCOPE("scheduleFusion");
+  auto params = getIndexSelectHeuristics(fusion, runtime_inputs);
+  TORCH_INTERNAL_ASSERT(
+      params != nullptr, "Could not schedule index_select operation.");
+  scheduleIndexSelect(fusion, *params);
+  return params->lparams;
+}
+
+void scheduleIndexSelect(Fusion* fusion, const IndexSelectParams& params) {
+  FusionGuard fg(fusion);
+
+  // Make sure we don't have global memory set on intermediate tensors from
+  // fusion segmentation
+  scheduler_utils::clearMemorySpace(fusion);
+
+  // The lookups are not cached, their rows are loaded by the index_select
+  // ops themselves
+  scheduler_utils::cacheInputs(fusion, true);
+  scheduler_utils::cacheAndForkOutputs(fusion, true);
+
+  // Keep the rows of the lookups in L2 for duplicated indices, see
+  // Note [ Index select scheduling ]
+  for (auto inp : ir_utils::filterByType<TensorView>(fusion->inputs())) {
+    if (ir_utils::isIndexSelectLookupTv(inp)) {
+      inp->setCacheHint(CacheHint::EvictLast);
+    } else if (!ir_utils::isIndexSelectIndicesTv(inp)) {
+      inp->setCacheHint(CacheHint::EvictFirst);
+    }
+  }
+  for (auto out : ir_utils::filterByType<TensorView>(fusion->outputs())) {
+    out->setCacheHint(CacheHint::EvictFirst);
+  }
+
+  TensorView* reference_tv = getReferenceTensorView(fusion);
+  TORCH_INTERNAL_ASSERT(
+      reference_tv != nullptr,
+      "Could not find a fully broadcasted output to reference schedule on.");
+
+  // Merge the rows: [rows, row_size]
+  while (reference_tv->nDims() > 2) {
+    reference_tv->merge(0);
+  }
+  TORCH_INTERNAL_ASSERT(reference_tv->nDims() == 2);
+
+  // [rows, row_size] -> [BIDx, TIDy | BIDy, TIDx, V]
+  reference_tv->split(1, params.vectorize_factor);
+  reference_tv->split(1, NamedScalar::getParallelDim(ParallelType::TIDx));
+  reference_tv->split(0, NamedScalar::getParallelDim(ParallelType::TIDy));
+  reference_tv->axis(0)->parallelize(ParallelType::BIDx);
+  reference_tv->axis(1)->parallelize(ParallelType::TIDy);
+  reference_tv->axis(2)->parallelize(ParallelType::BIDy);
+  reference_tv->axis(3)->parallelize(ParallelType::TIDx);
+
+  TransformPropagator propagator(reference_tv);
+  MaxRootDomainInfoSpanningTree spanning_tree(reference_tv);
+  spanning_tree.traverse(&propagator);
+  scheduler_utils::parallelizeAllLike(reference_tv);
+
+  if (params.vectorize_factor > 1) {
+    // Vectorize the copies of the inputs and outputs along the rows and the
+    // index_select ops, which load from the lookups
+    std::vector<TensorView*> vectorized_tvs;
+    bool should_vectorize_reference_tv = false;
+    for (auto tv : getVectorizableTvs(fusion, reference_tv)) {
+      if (tv == reference_tv) {
+        should_vectorize_reference_tv = true;
+      }
+      if (!tv->isFusionInput()) {
+        vectorized_tvs.emplace_back(tv);
+        continue;
+      }
+      auto consumer_tvs = ir_utils::consumerTvsOf(tv);
+      vectorized_tvs.insert(
+          vectorized_tvs.end(), consumer_tvs.begin(), consumer_tvs.end());
+    }
+    auto vectorize_id = reference_tv->axis(4);
+    vectorize_id->parallelize(ParallelType::Vectorize);
+    scheduler_utils::parallelizeAllLike(
+        reference_tv, vectorized_tvs, {ParallelType::Vectorize});
+    if (!should_vectorize_reference_tv) {
+      vectorize_id->parallelize(ParallelType::Serial);
+    }
+  }
+
+  // Vectorized dimensions are never inlined, so the vectorized accesses keep
+  // loops of their own and the cached indices are computed once per row
+  inlineMost();
+}
+
+} // namespace nvfuser
@@ -0,0 +1,87 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <ATen/core/ivalue.h>
+
+#include <fusion.h>
+#include <scheduler/index_select_heuristic.h>
+
+namespace nvfuser {
+
+// Note [ Index select scheduling ]
+//
+// A fusion like an embedding lookup,
+//
+//   T2[i2, i1] = index_select(T0[i0, i1], 0, T1[i2])
+//   T4[i2, i1] = T2 * T3[i2, i1]
+//
+// gathers whole rows of the lookup tensor T0. The pointwise scheduler merges
+// [i2, i1] into a single dimension and has to keep T0 out of its vectorized
+// tensors, so every thread loads a single element of a row, reloads the
+// index of its row and divides its linear index by the row size to find it.
+//
+// The index_select scheduler keeps the rows apart. The reference is split as
+//
+//   [i2, i1] -> [BIDx, TIDy | BIDy, TIDx, V]
+//
+// with the merged outer dimensions, i.e. the gathered rows, on blocks and
+// TIDy and the row itself on TIDx and a vector of V elements, so that:
+//   - a warp reads consecutive vectors of a row, which is a coalesced access
+//     wherever the row is in the lookup tensor. The vectorized index_select
+//     loads a row of the lookup from global memory straight into registers,
+//     since its index only moves where the row starts;
+//   - the cached index tensor is computed outside the row, so a thread loads
+//     the index of its row once into a register. The threads of a warp
+//     in the same row load the same index, which is a single broadcast read;
+//   - duplicated indices gather the same rows several times, so the lookup
+//     is loaded with CacheHint::EvictLast and the other inputs and the
+//     outputs, which are only accessed once, with CacheHint::EvictFirst to
+//     keep the lookup in L2. See Note [ Cache hints ].
+//
+// It is proposed before the pointwise scheduler for fusions dominated by
+// their index_select ops: every lookup is gathered along a dimension other
+// than its innermost one and its rows map to the innermost dimension of the
+// reference, no input or output is transposed against the reference, and
+// there is no other gather-like op. torch_gather and scatter index every
+// element by its own index, so they gain nothing from vectorized rows and
+// stay with the pointwise scheduler.
+
+class SchedulerRuntimeInfo;
+class HeuristicSummary;
+
+TORCH_CUDA_CU_API std::shared_ptr<IndexSelectParams> getIndexSelectHeuristics(
+    Fusion* fusion,
+    const at::ArrayRef<c10::IValue>& runtime_inputs,
+    HeuristicSummary* data_cache = nullptr);
+
+TORCH_CUDA_CU_API std::shared_ptr<IndexSelectParams> getIndexSelectHeuristics(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    HeuristicSummary* data_cache = nullptr);
+
+TORCH_CUDA_CU_API void scheduleIndexSelect(
+    Fusion* fusion,
+    const IndexSelectParams& params);
+
+TORCH_CUDA_CU_API LaunchParams scheduleIndexSelect(
+    Fusion* fusion,
+    const at::ArrayRef<c10::IValue>& runtime_inputs);
+
+//! Returns an empty string if the fusion has the structure the index_select
+//! scheduler handles, otherwise the reason why it doesn't
+TORCH_CUDA_CU_API std::string getIndexSelectCompileTimeRejectReason(
+    Fusion* fusion);
+
+//! Returns an empty string if the index_select scheduler can schedule the
+//! fusion with the given inputs, otherwise the reason why it can't
+TORCH_CUDA_CU_API std::string getIndexSelectRuntimeRejectReason(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info);
+
+} // namespace nvfuser
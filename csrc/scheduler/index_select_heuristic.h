@@ -0,0 +1,64 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <scheduler/heuristic.h>
+
+#include <sstream>
+
+namespace nvfuser {
+
+// Parameters of the index_select heuristic, see Note [ Index select
+// scheduling ]. The block shape is held by the launch parameters.
+// Warning: equal operator is intended for use in caching the kernel associated
+// with these parameters. It does not check if the launch parameters are
+// equivelent!
+class IndexSelectParams : public HeuristicParams {
+ public:
+  // Elements of a gathered row loaded and stored by a vector access, 1 if
+  // not vectorized
+  int64_t vectorize_factor = 1;
+
+  using HeuristicParams::HeuristicParams;
+
+  // Warning: Does not check launch parameters!
+  bool sameAs(
+      const std::shared_ptr<HeuristicParams>& other_base) const override {
+    auto other_casted =
+        std::dynamic_pointer_cast<IndexSelectParams>(other_base);
+    if (other_casted == nullptr) {
+      return false;
+    }
+    return other_casted->cparams == cparams &&
+        other_casted->vectorize_factor == vectorize_factor;
+  }
+
+  std::string toString() const override {
+    std::stringstream ss;
+    ss << "\n===== Index Select Parameters ========\n"
+       << (tag == "" ? "" : "Tag: ") << tag << "\n"
+       << " BlckY: " << lparams.bdimy() << " BlckX: " << lparams.bdimx()
+       << "\n";
+    if (vectorize_factor > 1) {
+      ss << "Vectorize, Factor: " << vectorize_factor << "\n";
+    }
+    ss << "====================================\n";
+    return ss.str();
+  }
+
+  // Warning: Hash is not based on launch parameters!
+  size_t hash() const override {
+    return static_cast<size_t>(vectorize_factor);
+  }
+
+  std::shared_ptr<HeuristicParams> clone() const override {
+    return std::make_shared<IndexSelectParams>(*this);
+  }
+};
+
+} // namespace nvfuser
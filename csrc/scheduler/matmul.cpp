@@ -6,7 +6,12 @@
  */
 // clang-format on
 #include <scheduler/matmul.h>
+
+#include <device_profile.h>
+#include <expr_evaluator.h>
+#include <instrumentation.h>
 #include <scheduler/mma_utils.h>
+#include <scheduler/registry.h>
 #include <scheduler/utils.h>
 
 namespace nvfuser {
@@ -44,6 +49,119 @@ void moveInnerBroadcastLeft(TensorView* tv, int number_of_inner_pos = 3) {
   tv->reorder(order_map);
 }
 
+//! The operands and the output of a pure matmul fusion
+struct MatmulTensors {
+  TensorView* a = nullptr;
+  TensorView* b = nullptr;
+  TensorView* c = nullptr;
+  MmaOptions::MmaInputLayout layout = MmaOptions::MmaInputLayout::TT;
+  // Positions of the M, N and K axes in the root domain of c
+  int m_pos = 0;
+  int n_pos = 0;
+  int k_pos = 0;
+};
+
+//! Find the operands of a fusion supported by the matmul scheduler. Returns
+//! the reason if the fusion isn't supported, otherwise an empty string.
+std::string findMatmulTensors(Fusion* fusion, MatmulTensors& tensors) {
+  const auto exprs = fusion->exprs();
+  std::vector<MmaOp*> mma_ops;
+  for (auto expr : exprs) {
+    if (auto mma = dynamic_cast<MmaOp*>(expr)) {
+      mma_ops.push_back(mma);
+    }
+  }
+  if (mma_ops.size() != 1) {
+    return "needs exactly one mma op";
+  }
+  auto mma = mma_ops.front();
+  if (exprs.size() != 3) {
+    return "no support for prologue or epilogue ops";
+  }
+
+  tensors.c = dynamic_cast<TensorView*>(mma->out());
+  if (tensors.c == nullptr || fusion->outputs().size() != 1 ||
+      fusion->outputs().front() != tensors.c) {
+    return "mma output must be the only fusion output";
+  }
+
+  // Each operand is a 2D fusion input broadcast along the non-matching axis
+  // of the other operand
+  std::array<int, 2> broadcast_pos = {-1, -1};
+  std::array<TensorView*, 2> operands = {nullptr, nullptr};
+  for (auto i : c10::irange(2)) {
+    auto bcast =
+        dynamic_cast<BroadcastOp*>((i == 0 ? mma->inA() : mma->inB())
+                                       ->definition());
+    if (bcast == nullptr) {
+      return "operands must be broadcast fusion inputs";
+    }
+    auto operand = dynamic_cast<TensorView*>(bcast->in());
+    if (operand == nullptr || !operand->isFusionInput() ||
+        operand->getMaybeRFactorDomain().size() != 2) {
+      return "operands must be 2D fusion inputs";
+    }
+    if (operand->getDataType() != DataType::Half) {
+      return "only fp16 operands are supported";
+    }
+    const auto& flags = bcast->getBroadcastDimFlags();
+    if (flags.size() != 3 ||
+        std::count(flags.begin(), flags.end(), true) != 1) {
+      return "operands must be broadcast along a single axis";
+    }
+    broadcast_pos.at(i) = (int)std::distance(
+        flags.begin(), std::find(flags.begin(), flags.end(), true));
+    operands.at(i) = operand;
+  }
+  if (operands[0] == operands[1]) {
+    return "operands must be different tensors";
+  }
+  tensors.a = operands[0];
+  tensors.b = operands[1];
+
+  const auto& c_root = tensors.c->getMaybeRFactorDomain();
+  if (c_root.size() != 3 ||
+      std::count_if(c_root.begin(), c_root.end(), [](IterDomain* id) {
+        return id->isReduction();
+      }) != 1) {
+    return "mma output must have a single reduction axis";
+  }
+  tensors.k_pos = (int)std::distance(
+      c_root.begin(),
+      std::find_if(c_root.begin(), c_root.end(), [](IterDomain* id) {
+        return id->isReduction();
+      }));
+  // The axis A is broadcast along is N and the one B is broadcast along is M
+  tensors.m_pos = broadcast_pos[1];
+  tensors.n_pos = broadcast_pos[0];
+
+  // See [Operand Layout Convention]
+  const std::array<int, 3> mkn = {tensors.m_pos, tensors.k_pos, tensors.n_pos};
+  if (mkn == std::array<int, 3>{0, 1, 2}) {
+    tensors.layout = MmaOptions::MmaInputLayout::TT;
+  } else if (mkn == std::array<int, 3>{0, 2, 1}) {
+    tensors.layout = MmaOptions::MmaInputLayout::TN;
+  } else if (mkn == std::array<int, 3>{1, 0, 2}) {
+    tensors.layout = MmaOptions::MmaInputLayout::NT;
+  } else {
+    return "unsupported operand layout";
+  }
+
+  return "";
+}
+
+//! The mma macro of the architecture of a device
+MmaOptions::MacroType getMmaMacro(const DeviceProfile& device_prop) {
+  if (device_prop.major == 7) {
+    return device_prop.minor < 5 ? MmaOptions::MacroType::Volta_16_16_4
+                                 : MmaOptions::MacroType::Turing_16_8_16;
+  }
+  if (device_prop.major >= 8) {
+    return MmaOptions::MacroType::Ampere_16_8_16;
+  }
+  return MmaOptions::MacroType::NoMMA;
+}
+
 } // namespace
 
 void scheduleMatmul(
@@ -182,6 +300,16 @@ void scheduleMatmul(
   scheduler_utils::matmul_utils::makeTile(cc, gemm_tile.cta_tile.toVector());
 
   // [Mo, No, Ko, Mi, Ni, Ki]
+  // Split K across CTAs, see Note [ Split-K ]
+  TORCH_CHECK(params.splitk_factor >= 1, "Invalid split-K factor");
+  const bool use_splitk = params.splitk_factor > 1;
+  if (use_splitk) {
+    cc->split(2, params.splitk_factor, false);
+  }
+  // Position of the main loop, i.e., Ko, on the mma output
+  const int ko_pos = use_splitk ? 3 : 2;
+
+  // [Mo, No, (Kso,) Ko, Mi, Ni, Ki]
   // Propagate tiling globally
   scheduler_utils::transformPropagateToAllFrom(cc, -1);
 
@@ -192,6 +320,17 @@ void scheduleMatmul(
   scheduler_utils::BoundedDirectionalTransformPropagator::bothWays(
       cc, -1, {acw_smem, bcw_smem}, {c});
 
+  // The output of the mma op. Same as cc unless K is split across CTAs, in
+  //  which case the mma op computes the partial sums of each CTA and cc
+  //  becomes the grid reduction of them.
+  TensorView* mma_result = cc;
+  if (use_splitk) {
+    //  0   1  2   3   4   5   6   7  8  9  10 11
+    // [Mo No Kso Ko Kwo Mwo Nwo Mw Nw Mi Ni Ki]
+    mma_result = cc->rFactor({3, 4, -1});
+    mma_builder.accumulatorTv(mma_result);
+  }
+
   // Schedule prolog:
   //   TODO: this section goes to a separate matmul util,
   //   and needs more configurability.
@@ -236,12 +375,12 @@ void scheduleMatmul(
   b->computeAt(c, 2);
 
   // Prolog:
-  a->computeAt(cc, 3);
-  b->computeAt(cc, 3);
+  a->computeAt(mma_result, ko_pos + 1);
+  b->computeAt(mma_result, ko_pos + 1);
 
   // Main Loop:
-  acr->computeAt(cc, -6);
-  bcr->computeAt(cc, -6);
+  acr->computeAt(mma_result, -6);
+  bcr->computeAt(mma_result, -6);
 
   // Add mma swizzle:
   //   TODO: this section goes to a separate matmul util,
@@ -270,8 +409,12 @@ void scheduleMatmul(
       scheduler_utils::BoundedDirectionalTransformPropagator::Options()
           .propagateParallelType());
 
-  cc->applyMmaSwizzle(
+  mma_result->applyMmaSwizzle(
       mma_builder.operand(MmaOptions::Operand::Accumulator).build());
+  if (use_splitk) {
+    cc->applyMmaSwizzle(
+        mma_builder.operand(MmaOptions::Operand::Accumulator).build());
+  }
 
   // Set memory type:
   acw_smem->setMemoryType(MemoryType::Shared);
@@ -291,22 +434,43 @@ void scheduleMatmul(
 
   //  0   1  2  3   4   5   6  7  8  9  10
   // [Mo No Ko Kwo Mwo Nwo Mw Nw (Mi Ni Ki)]
-  if (params.rasterization_order ==
-      MatmulParam::TileRasterizationOrder::RowMajor) {
-    cc->axis(0)->parallelize(ParallelType::BIDx);
-    cc->axis(1)->parallelize(ParallelType::BIDy);
-  } else if (
-      params.rasterization_order ==
-      MatmulParam::TileRasterizationOrder::ColumnMajor) {
-    cc->axis(0)->parallelize(ParallelType::BIDy);
-    cc->axis(1)->parallelize(ParallelType::BIDx);
-  } else {
-    TORCH_CHECK(
-        false, "Invalid TileRasterizationOrder passed to Matmul scheduler");
+  // or, with split-K:
+  //  0   1  2   3   4   5   6   7  8  9  10 11
+  // [Mo No Kso Ko Kwo Mwo Nwo Mw Nw (Mi Ni Ki)]
+  std::vector<TensorView*> parallelized_tvs = {mma_result};
+  if (use_splitk) {
+    parallelized_tvs.push_back(cc);
+  }
+  for (auto tv : parallelized_tvs) {
+    if (params.rasterization_order ==
+        MatmulParam::TileRasterizationOrder::RowMajor) {
+      tv->axis(0)->parallelize(ParallelType::BIDx);
+      tv->axis(1)->parallelize(ParallelType::BIDy);
+    } else if (
+        params.rasterization_order ==
+        MatmulParam::TileRasterizationOrder::ColumnMajor) {
+      tv->axis(0)->parallelize(ParallelType::BIDy);
+      tv->axis(1)->parallelize(ParallelType::BIDx);
+    } else {
+      TORCH_CHECK(
+          false, "Invalid TileRasterizationOrder passed to Matmul scheduler");
+    }
   }
 
-  cc->axis(4)->parallelize(ParallelType::TIDz);
-  cc->axis(5)->parallelize(ParallelType::TIDy);
+  if (use_splitk) {
+    mma_result->axis(2)->parallelize(ParallelType::BIDz);
+    mma_result->axis(5)->parallelize(ParallelType::TIDz);
+    mma_result->axis(6)->parallelize(ParallelType::TIDy);
+
+    //  0   1  2    3   4   5  6  7  8
+    // [Mo No Kso Mwo Nwo Mw Nw (Mi Ni)]
+    cc->axis(2)->parallelize(ParallelType::BIDz);
+    cc->axis(3)->parallelize(ParallelType::TIDz);
+    cc->axis(4)->parallelize(ParallelType::TIDy);
+  } else {
+    cc->axis(4)->parallelize(ParallelType::TIDz);
+    cc->axis(5)->parallelize(ParallelType::TIDy);
+  }
 
   // Propagate mma output swizzle and parallelization down the DAG
   if (params.double_buffer_options.double_buffer_smem_write) {
@@ -340,8 +504,139 @@ void scheduleMatmul(
 
   if (params.double_buffer_options.double_buffer_smem_read &&
       params.double_buffer_options.double_buffer_smem_write) {
-    scheduler_utils::rotateLoop(cc, 2, {acr, bcr});
+    scheduler_utils::rotateLoop(mma_result, ko_pos, {acr, bcr});
+  }
+}
+
+std::string getMatmulCompileTimeRejectReason(Fusion* fusion) {
+  MatmulTensors tensors;
+  return findMatmulTensors(fusion, tensors);
+}
+
+std::string getMatmulRunTimeRejectReason(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info) {
+  MatmulTensors tensors;
+  auto reason = findMatmulTensors(fusion, tensors);
+  if (!reason.empty()) {
+    return reason;
+  }
+
+  if (getMmaMacro(getCurrentDeviceProfile()) == MmaOptions::MacroType::NoMMA) {
+    return "no mma support on the device";
   }
+
+  // The operand loads are vectorized by 8
+  for (auto operand : {tensors.a, tensors.b}) {
+    if (runtime_info.getInnerDimVectorizableWidth(operand) < 8) {
+      return "operands must be vectorizable by 8";
+    }
+  }
+
+  return "";
+}
+
+std::shared_ptr<MatmulParams> getMatmulHeuristics(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    HeuristicSummary* data_cache) {
+  FUSER_PERF_SCOPE("getMatmulHeuristics");
+
+  FusionGuard fg(fusion);
+
+  MatmulTensors tensors;
+  auto reason = findMatmulTensors(fusion, tensors);
+  TORCH_INTERNAL_ASSERT(reason.empty(), "Unsupported matmul: ", reason);
+
+  auto params = std::make_shared<MatmulParams>(
+      "Matmul heuristics", indexModeToDtype(runtime_info.getIndexMode()));
+  // Magic zero isn't needed as the fragment loops are fully unrolled
+  params->cparams.enable_magic_zero = false;
+
+  const auto& device_prop = getCurrentDeviceProfile();
+  params->mma_macro = getMmaMacro(device_prop);
+  params->layout = tensors.layout;
+
+  auto& tiles = params->tile_sizes;
+  tiles.cta_tile = GemmTile(128, 128, 32);
+  tiles.warp_tile = GemmTile(64, 64, 32);
+  tiles.instruction_tile = isVolta(params->mma_macro) ? GemmTile(16, 16, 4)
+                                                      : GemmTile(16, 8, 16);
+
+  if (isAmpere(params->mma_macro)) {
+    // Pipeline the operand loads with as many stages as fit in shared
+    // memory, up to 3
+    params->async_gmem_load_operands = true;
+    const int64_t stage_size = (int64_t)(tiles.cta_tile.m + tiles.cta_tile.n) *
+        tiles.cta_tile.k * (int64_t)dataTypeSize(DataType::Half);
+    const int64_t num_stages = std::min(
+        (int64_t)3, device_prop.smem_per_block_optin / stage_size);
+    if (num_stages >= 2) {
+      params->double_buffer_smem_write = true;
+      params->double_buffer_smem_read = true;
+      params->smem_double_buffer_stage = (int)num_stages;
+    }
+  }
+
+  auto get_extent = [&](int pos) {
+    auto extent = runtime_info.expressionEvaluator().evaluate(
+        tensors.c->getMaybeRFactorDomain().at(pos)->extent());
+    TORCH_INTERNAL_ASSERT(extent.has_value(), "Unknown matmul extent");
+    return extent->as<int64_t>();
+  };
+  const int64_t m_tiles = ceilDiv(get_extent(tensors.m_pos), tiles.cta_tile.m);
+  const int64_t n_tiles = ceilDiv(get_extent(tensors.n_pos), tiles.cta_tile.n);
+  const int64_t k_tiles = ceilDiv(get_extent(tensors.k_pos), tiles.cta_tile.k);
+
+  // The tiles of N are bound to blockIdx.y, whose extent is limited, unless
+  // the rasterization is swapped
+  params->column_major_rasterization = n_tiles > device_prop.max_grid_dim_y;
+
+  // Split K across CTAs when the tiles fill less than half of the SMs,
+  //  keeping each split long enough to fill the operand pipeline. See
+  //  Note [ Split-K ].
+  const int64_t num_sms = scheduler_utils::numSMs();
+  const int64_t num_tiles = m_tiles * n_tiles;
+  if (2 * num_tiles <= num_sms) {
+    const int64_t min_k_tiles_per_split =
+        2 * (int64_t)params->smem_double_buffer_stage;
+    params->splitk_factor = (int)std::max(
+        (int64_t)1,
+        std::min(num_sms / num_tiles, k_tiles / min_k_tiles_per_split));
+  }
+
+  if (isDebugDumpEnabled(DebugDumpOption::SchedulerDebug)) {
+    std::cerr << params->toString() << std::endl;
+  }
+
+  return params;
+}
+
+void scheduleMatmul(Fusion* fusion, const MatmulParams& params) {
+  FUSER_PERF_SCOPE("scheduleMatmul");
+  FusionGuard fg(fusion);
+
+  MatmulTensors tensors;
+  auto reason = findMatmulTensors(fusion, tensors);
+  TORCH_INTERNAL_ASSERT(reason.empty(), "Unsupported matmul: ", reason);
+
+  auto mma_builder =
+      MmaBuilder(params.mma_macro, params.tile_sizes).layout(params.layout);
+  MatmulParam matmul_param(mma_builder);
+  matmul_param.tile_sizes = params.tile_sizes;
+  matmul_param.async_gmem_load_operands = params.async_gmem_load_operands;
+  matmul_param.double_buffer_options.double_buffer_smem_write =
+      params.double_buffer_smem_write;
+  matmul_param.double_buffer_options.double_buffer_smem_read =
+      params.double_buffer_smem_read;
+  matmul_param.double_buffer_options.smem_double_buffer_stage =
+      params.smem_double_buffer_stage;
+  matmul_param.rasterization_order = params.column_major_rasterization
+      ? MatmulParam::TileRasterizationOrder::ColumnMajor
+      : MatmulParam::TileRasterizationOrder::RowMajor;
+  matmul_param.splitk_factor = params.splitk_factor;
+
+  scheduleMatmul(tensors.c, tensors.a, tensors.b, matmul_param);
 }
 
 } // namespace nvfuser
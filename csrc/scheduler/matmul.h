@@ -11,6 +11,7 @@
 
 #include <fusion.h>
 #include <mma_type.h>
+#include <scheduler/matmul_heuristic.h>
 
 namespace nvfuser {
 
@@ -48,8 +49,30 @@ class MatmulParam {
     RowMajor = 0,
     ColumnMajor = 1
   } rasterization_order = TileRasterizationOrder::RowMajor;
+
+  //! Number of CTAs the K dimension is split across, see Note [ Split-K ]
+  int splitk_factor = 1;
 };
 
+// Note [ Split-K ]
+//
+// When M and N are small compared to K, the CTA tiles alone don't fill the
+// device. With split-K, the serial K loop of each tile is split into
+// splitk_factor contiguous chunks that are computed by different CTAs along
+// blockIdx.z:
+//
+//   cc[Mo, No, Ko, Mi, Ni, Ki] -> cc[Mo, No, Kso, Ko, Mi, Ni, Ki]
+//
+// The mma output is rfactored on all of the reduction axes but Kso, so the
+// mma op computes the partial sums of each CTA in registers and the remaining
+// reduction over Kso is lowered to a grid reduction:
+//
+//   mma_result[Mo, No, Kso, rKo, ..., rKi] = mma(a, b)
+//   cc[Mo, No, rKso, ...] = sum(mma_result)
+//
+// The grid reduction syncs the CTAs of a tile once per accumulator element,
+// so it only pays off when the tile count is well below the SM count.
+
 //! Prototype auto scheduling function.
 //!  Currently only support a pure matmul with no
 //!   fused prolog or epilog.
@@ -64,4 +87,43 @@ TORCH_CUDA_CU_API void scheduleMatmul(
     TensorView* b_tv,
     MatmulParam& params);
 
+class SchedulerRuntimeInfo;
+class HeuristicSummary;
+
+// Note [ Matmul scheduler ]
+//
+// The matmul scheduler takes fusions with a single mma op, defined with
+// fusedMultiplySum of two broadcast 2D fp16 fusion inputs, whose output is
+// the only fusion output, i.e. the pure matmuls scheduleMatmul supports. The
+// operand layout is inferred from the positions of the broadcast and
+// reduction axes, see [Operand Layout Convention]. Fusions with prologue or
+// epilogue ops are segmented, so that the mma is scheduled by itself and the
+// pointwise ops around it by the other schedulers.
+//
+// The heuristic picks the mma macro of the device architecture, uses cp.async
+// and circular buffering of the operands on Ampere and later with as many
+// stages as the shared memory allows, and swaps the block rasterization when
+// the tiles of N don't fit in gridDim.y. K is split across CTAs when there
+// aren't enough tiles to fill the device, see Note [ Split-K ].
+
+//! Returns an empty string if the fusion can be scheduled as a matmul,
+//! otherwise the reason it can't
+TORCH_CUDA_CU_API std::string getMatmulCompileTimeRejectReason(Fusion* fusion);
+
+//! Returns an empty string if the matmul can be run with the given inputs on
+//! the current device, otherwise the reason it can't
+TORCH_CUDA_CU_API std::string getMatmulRunTimeRejectReason(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info);
+
+TORCH_CUDA_CU_API std::shared_ptr<MatmulParams> getMatmulHeuristics(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    HeuristicSummary* data_cache = nullptr);
+
+//! Schedule a fusion accepted by getMatmulCompileTimeRejectReason
+TORCH_CUDA_CU_API void scheduleMatmul(
+    Fusion* fusion,
+    const MatmulParams& params);
+
 } // namespace nvfuser
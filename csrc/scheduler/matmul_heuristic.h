@@ -0,0 +1,129 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <c10/util/hash.h>
+#include <mma_type.h>
+#include <scheduler/heuristic.h>
+#include <utils.h>
+
+#include <sstream>
+
+namespace nvfuser {
+
+// Parameters of the matmul heuristic to describe the optimial schedule.
+// Warning: equal operator is intended for use in caching the kernel associated
+// with these matmul parameters. It does not check if the launch parameters
+// are equivelent!
+class MatmulParams : public HeuristicParams {
+ public:
+  //! Type of the mma instruction
+  MmaOptions::MacroType mma_macro = MmaOptions::MacroType::NoMMA;
+
+  //! Layout of the operands, see [Operand Layout Convention]
+  MmaOptions::MmaInputLayout layout = MmaOptions::MmaInputLayout::TT;
+
+  //! Specifies the tiling hierarchy on block, warp, and instruction levels
+  MatMulTileOptions tile_sizes;
+
+  //! (Ampere+) Use cp.async to load operands
+  bool async_gmem_load_operands = false;
+
+  //! Circular buffer the shared memory operands
+  bool double_buffer_smem_write = false;
+
+  //! Double buffer the registers loaded from the shared memory operands
+  bool double_buffer_smem_read = false;
+
+  //! Number of stages of the circular buffered shared memory operands
+  int smem_double_buffer_stage = 2;
+
+  //! Swap blockIdx.x and blockIdx.y, i.e., bind the tiles of N to
+  //! blockIdx.x
+  bool column_major_rasterization = false;
+
+  //! Number of CTAs the K dimension is split across, see Note [ Split-K ]
+  int splitk_factor = 1;
+
+  using HeuristicParams::HeuristicParams;
+
+  // Warning: Does not check launch parameters!
+  bool sameAs(
+      const std::shared_ptr<HeuristicParams>& other_base) const override {
+    auto other_casted = std::dynamic_pointer_cast<MatmulParams>(other_base);
+    if (other_casted == nullptr) {
+      return false;
+    }
+    const MatmulParams& other = *other_casted;
+    return other.cparams == cparams && other.mma_macro == mma_macro &&
+        other.layout == layout && other.tile_sizes == tile_sizes &&
+        other.async_gmem_load_operands == async_gmem_load_operands &&
+        other.double_buffer_smem_write == double_buffer_smem_write &&
+        other.double_buffer_smem_read == double_buffer_smem_read &&
+        other.smem_double_buffer_stage == smem_double_buffer_stage &&
+        other.column_major_rasterization == column_major_rasterization &&
+        other.splitk_factor == splitk_factor;
+  }
+
+  std::string toString() const override {
+    auto tile_to_string = [](const GemmTile& tile) {
+      std::stringstream ss;
+      ss << tile.m << "x" << tile.n << "x" << tile.k;
+      return ss.str();
+    };
+    std::stringstream ss;
+    ss << "\n===== Matmul Parameters ========\n"
+       << (tag == "" ? "" : "Tag: ") << tag << "\n"
+       << " mma macro: " << (int)mma_macro << "\n"
+       << " layout: " << (int)layout << "\n"
+       << " CTA tile: " << tile_to_string(tile_sizes.cta_tile) << "\n"
+       << " warp tile: " << tile_to_string(tile_sizes.warp_tile) << "\n"
+       << " instruction tile: "
+       << tile_to_string(tile_sizes.instruction_tile) << "\n";
+    if (async_gmem_load_operands) {
+      ss << " cp.async operand loads\n";
+    }
+    if (double_buffer_smem_write) {
+      ss << " smem stages: " << smem_double_buffer_stage << "\n";
+    }
+    if (double_buffer_smem_read) {
+      ss << " double buffered smem reads\n";
+    }
+    ss << " rasterization: "
+       << (column_major_rasterization ? "column major" : "row major") << "\n";
+    if (splitk_factor > 1) {
+      ss << " split-K factor: " << splitk_factor << "\n";
+    }
+    ss << "====================================\n";
+    return ss.str();
+  }
+
+  size_t hash() const override {
+    auto tile_hash = [](const GemmTile& tile) {
+      return c10::get_hash(tile.m, tile.n, tile.k);
+    };
+    return c10::get_hash(
+        (int)mma_macro,
+        (int)layout,
+        tile_hash(tile_sizes.cta_tile),
+        tile_hash(tile_sizes.warp_tile),
+        tile_hash(tile_sizes.instruction_tile),
+        async_gmem_load_operands,
+        double_buffer_smem_write,
+        double_buffer_smem_read,
+        smem_double_buffer_stage,
+        column_major_rasterization,
+        splitk_factor);
+  }
+
+  std::shared_ptr<HeuristicParams> clone() const override {
+    return std::make_shared<MatmulParams>(*this);
+  }
+};
+
+} // namespace nvfuser
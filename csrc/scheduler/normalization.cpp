@@ -7,6 +7,7 @@
 // clang-format on
 #include <scheduler/reduction.h>
 
+#include <device_profile.h>
 #include <executor_utils.h>
 #include <grouped_reduction.h>
 #include <instrumentation.h>
@@ -20,8 +21,6 @@
 #include <scheduler/vectorize_helper.h>
 #include <transform_replay.h>
 
-#include <ATen/cuda/CUDAContext.h>
-
 #include <cmath>
 
 namespace nvfuser {
@@ -55,14 +54,13 @@ std::shared_ptr<ReductionParams> innerPersistentHeuristic(
   const int64_t outer_reduction_numel =
       total_reduction_numel / inner_most_dimension_numel;
 
-  const auto dev_prop = at::cuda::getCurrentDeviceProperties();
+  const auto& dev_prop = getCurrentDeviceProfile();
   // WARNING: At some point we may want to generate heuristics for another
   // device that is not the current device.
   const int64_t device_max_threads_per_multiprocessor =
-      (int64_t)dev_prop->maxThreadsPerMultiProcessor;
+      dev_prop.max_threads_per_sm;
 
-  const int64_t device_multiprocessor_count =
-      (int64_t)dev_prop->multiProcessorCount;
+  const int64_t device_multiprocessor_count = scheduler_utils::numSMs();
 
   auto const max_unroll = ceilDiv(
       // Available unrolling based on size of data type
@@ -81,7 +79,7 @@ std::shared_ptr<ReductionParams> innerPersistentHeuristic(
   // we can use a smaller warp size. While thread local data fits in l1, and
   // reduction dim is really small, we can use <32 threads per warp.
   const bool fits_in_l2 =
-      n_elems * max_input_dtype_size * n_tensor_inputs < dev_prop->l2CacheSize;
+      n_elems * max_input_dtype_size * n_tensor_inputs < dev_prop.l2_size;
 
   // If it fits in l2, we just want to make sure each warp uses 32Bytes. Set
   // minimum warp as 16 threads instead of 32 as if we have a small reduction
@@ -168,7 +166,7 @@ std::shared_ptr<ReductionParams> innerPersistentHeuristic(
       // reductions
       max_threads_in_block = std::min(
           ceilDiv(n_elems, target_blocks * target_unroll),
-          (int64_t)dev_prop->maxThreadsPerBlock);
+          dev_prop.max_threads_per_block);
     } else {
       // targetting 4 waves, so try to use a quarter of available threads
       max_threads_in_block = std::min(
@@ -285,7 +283,7 @@ std::shared_ptr<ReductionParams> innerPersistentHeuristic(
   constexpr int scheduler_per_sm = 4;
   if (outer_reduction_numel == 1 && vectorize) {
     bdimx = std::min(
-        scheduler_per_sm * dev_prop->warpSize, threads_after_vectorize);
+        scheduler_per_sm * dev_prop.warp_size, threads_after_vectorize);
   }
   // Set size of persistent per thread buffer on inner reduction buffer
   // if too large, will be reduced later to reduce register usage
@@ -417,19 +415,37 @@ std::shared_ptr<ReductionParams> innerPersistentHeuristic(
     batches_per_block_outer_reduction /= 2;
   }
 
-  auto device_warp_size = at::cuda::warp_size();
+  auto device_warp_size = getCurrentDeviceProfile().warp_size;
+
+  // Rows of a power-of-2 number of threads along TIDx are reduced with warp
+  // shuffles only if the block is made of full warps, so round the rows per
+  // block up to fill them, see Note [ Shuffle-only block reductions ]
+  if (bdimx < device_warp_size && bdimz == 1 &&
+      scheduler_utils::lastPow2(bdimx) == bdimx &&
+      (bdimx * bdimy) % device_warp_size != 0 &&
+      !isOptionDisabled(DisableOption::ShuffleReduction)) {
+    const int64_t rows_per_warp = device_warp_size / bdimx;
+    const int64_t rounded_bdimy =
+        ceilDiv(bdimy, rows_per_warp) * rows_per_warp;
+    if (bdimx * rounded_bdimy <= max_threads_in_block) {
+      bdimy = rounded_bdimy;
+      godim = ceilDiv(total_iteration_numel, bdimy);
+    }
+  }
+
   auto padded_bdimx = bdimx % device_warp_size == 0
       ? bdimx
       : bdimx + (device_warp_size - bdimx % device_warp_size);
 
   bool pad_bdimx = bdimx > 16 &&
-      padded_bdimx * bdimy * bdimz < (int64_t)dev_prop->maxThreadsPerBlock;
+      padded_bdimx * bdimy * bdimz < dev_prop.max_threads_per_block;
 
   // estimate register usage and occupancy raito.
   // If occupancy raito is less than a preset occupancy_ratio, reduce register
   // usage register per thread is estimated as overhead + buffer_size /
   // bytes_per_register
   int64_t nvrtc_register_per_thread = 255;
+  int64_t min_blocks_per_sm = 1;
   const int blocksPerKernel = godim;
   // register estimation is only valid for vectorized gmem access
   // we've seen unexpectedly high register counts with vectorization factor less
@@ -462,22 +478,20 @@ std::shared_ptr<ReductionParams> innerPersistentHeuristic(
         reg_allocation_granularity;
     const int threadsPerBlock =
         (pad_bdimx ? padded_bdimx : bdimx) * bdimy * bdimz;
-    const int warps_per_block = ceilDiv(threadsPerBlock, dev_prop->warpSize);
-    const int estimated_warps_per_sm = dev_prop->regsPerMultiprocessor /
+    const int warps_per_block = ceilDiv(threadsPerBlock, dev_prop.warp_size);
+    const int estimated_warps_per_sm = dev_prop.regs_per_sm /
         (register_per_warp * warps_per_block) * warps_per_block;
     const int occupancy_warps_per_sm = static_cast<int>(
-        dev_prop->maxThreadsPerMultiProcessor / device_warp_size *
-        occupancy_ratio);
+        dev_prop.max_threads_per_sm / device_warp_size * occupancy_ratio);
 
     if (estimated_warps_per_sm < occupancy_warps_per_sm) {
-      const int blocks_per_sm_1 = dev_prop->maxBlocksPerMultiProcessor;
+      const int blocks_per_sm_1 = dev_prop.max_blocks_per_sm;
       const int blocks_per_sm_2 =
           ceilDiv(occupancy_warps_per_sm, warps_per_block);
       const int blocks_per_sm = std::min(blocks_per_sm_1, blocks_per_sm_2);
       const int warps_per_sm = blocks_per_sm * warps_per_block;
-      const int register_per_warp = dev_prop->regsPerMultiprocessor /
-          warps_per_sm / reg_allocation_granularity *
-          reg_allocation_granularity;
+      const int register_per_warp = dev_prop.regs_per_sm / warps_per_sm /
+          reg_allocation_granularity * reg_allocation_granularity;
       const int occupancy_register_count = register_per_warp / device_warp_size;
       // use occupancy_register_count directly may cause register spills
       // only allow 20% drop from estimated_register_count to balance register
@@ -487,6 +501,20 @@ std::shared_ptr<ReductionParams> innerPersistentHeuristic(
           static_cast<int>(estimated_register_count * max_adjust_fraction),
           occupancy_register_count);
     }
+
+    // Target the occupancy of the register count in the launch bounds, see
+    // Note [ Launch bounds ]
+    const int target_register_per_warp =
+        ceilDiv(
+            (int)nvrtc_register_per_thread * device_warp_size,
+            reg_allocation_granularity) *
+        reg_allocation_granularity;
+    min_blocks_per_sm = std::min(
+        dev_prop.max_blocks_per_sm,
+        std::max(
+            (int64_t)1,
+            dev_prop.regs_per_sm /
+                (target_register_per_warp * warps_per_block)));
   }
 
   // Will be used once supporting inter-block persistence
@@ -497,8 +525,13 @@ std::shared_ptr<ReductionParams> innerPersistentHeuristic(
   auto rparams = std::make_shared<ReductionParams>();
 
   rparams->cparams.maxrregcount = nvrtc_register_per_thread;
+  rparams->cparams.min_blocks_per_sm = min_blocks_per_sm;
   rparams->persistent_kernel = true;
   rparams->fastest_dim = true;
+  // Computing the cached inputs with their first consumers lets the loaded
+  // values be consumed right after the loads, so only the persistent
+  // buffers themselves need to stay live across the normalization.
+  rparams->compute_persistent_buffer_with_first_consumer = true;
 
   // Inner reduction domain
   rparams->cross_block_inner_reduction = true;
@@ -657,22 +690,20 @@ std::shared_ptr<ReductionParams> outerPersistentHeuristic(
 
   // WARNING: Current device for codegen may not be the target device
   const int64_t device_max_threads_per_multiprocessor =
-      (int64_t)at::cuda::getCurrentDeviceProperties()
-          ->maxThreadsPerMultiProcessor;
+      getCurrentDeviceProfile().max_threads_per_sm;
 
-  const int64_t device_multiprocessor_count =
-      (int64_t)at::cuda::getCurrentDeviceProperties()->multiProcessorCount;
+  const int64_t device_multiprocessor_count = scheduler_utils::numSMs();
 
   // If it fits in l2, we just want to make sure each warp uses 32Bytes. Set
   // minimum warp as 16 threads instead of 32 as if we have a small reduction
   // dim going a bit smaller than 32 usually helps.
   const int64_t warp_size = n_elems * max_input_dtype_size * n_tensor_inputs <
-          at::cuda::getCurrentDeviceProperties()->l2CacheSize
+          getCurrentDeviceProfile().l2_size
       ? (int64_t)32 / max_input_dtype_size
       : 16;
 
   const auto register_file_size =
-      at::cuda::getCurrentDeviceProperties()->regsPerBlock * sizeof(int);
+      getCurrentDeviceProfile().regs_per_block * sizeof(int);
 
   // Each block runs N reductions, where N is defined as:
   // vectorize_factor * blockDim.x. The minimum number of SMs to run
@@ -972,6 +1003,24 @@ std::shared_ptr<ReductionParams> persistentHeuristic(
   return rparams;
 }
 
+// Note [ Shared memory persistent buffers ]
+//
+// An inner persistent kernel keeps a whole reduction row of each persistent
+// buffer on chip, which in registers is limited to about half the register
+// file of an SM, see scheduler_utils::register_file_size. Rows whose
+// persistent buffers don't fit there, e.g. layer norms with hidden sizes in
+// the tens of thousands, are instead staged in shared memory: the buffers
+// are scheduled exactly as they would be in registers and only their memory
+// type is changed, so each thread still reads back the elements it wrote and
+// the block syncs inserted for the shared memory accesses are the only
+// additional cost. The shared memory budget of a block is what the device
+// allows with the dynamic shared memory opt-in, less room for the block
+// reduction workspace, see scheduler_utils::smemPersistentBufferSize. The
+// kernel's dynamic shared memory is sized by the executor as for any other
+// shared memory buffer. Buffers are placed either all in registers or all in
+// shared memory. This can be turned off with
+// PYTORCH_NVFUSER_DISABLE=smem_persistent_buffers.
+
 std::shared_ptr<ReductionParams> getPersistentHeuristics(
     Fusion* fusion,
     SchedulerRuntimeInfo& runtime_info,
@@ -1106,6 +1155,10 @@ std::shared_ptr<ReductionParams> getPersistentHeuristics(
       max_persistent_size,
       vectorize_factor,
       project_persistent_buffers);
+  // Stage the buffers in shared memory if they don't fit in registers, see
+  // Note [ Shared memory persistent buffers ]
+  heuristic->smem_persistent_buffers = properties.fastest_dim_reduction &&
+      max_persistent_size > scheduler_utils::register_file_size;
   heuristic->cparams.index_type = indexModeToDtype(runtime_info.getIndexMode());
   return heuristic;
 }
@@ -1156,6 +1209,13 @@ void schedulePersistentKernel(Fusion* fusion, const ReductionParams& rparams) {
 
   scheduler_utils::prepareForMemoryTypePromotion(fusion);
 
+  // See Note [ Shared memory persistent buffers ]
+  std::vector<TensorView*> smem_persistent_buffers;
+  if (rparams.smem_persistent_buffers) {
+    smem_persistent_buffers =
+        scheduler_utils::persistentBuffers(fusion).persistent_buffers;
+  }
+
   auto reduction_tvs = scheduler_utils::getReductionTvs(fusion);
 
   TORCH_INTERNAL_ASSERT(reduction_tvs.size());
@@ -1174,6 +1234,17 @@ void schedulePersistentKernel(Fusion* fusion, const ReductionParams& rparams) {
         scheduler_utils::domainReorderAsRfactorMap(reduction_tv));
   }
 
+  // Note [ Grid persistent normal reductions ]
+  //
+  // Grid persistent outer normalizations are launched as a single
+  // cooperative kernel, and every grid allreduce in it is a grid
+  // synchronization. Welford-based ones (batch_norm forward) need a
+  // single Welford. Normal reductions, e.g., the two sums of
+  // batch_norm_backward, are grouped here into a GroupedReductionOp so
+  // that the whole kernel still has a single grid synchronization. As
+  // the grouped grid reduction kernel is not well tuned yet, the
+  // canScheduleRunTime check only accepts them with
+  // PYTORCH_NVFUSER_ENABLE=grid_persistent_reductions.
   if (rparams.persistent_kernel && rparams.cross_grid_inner_reduction &&
       !rparams.fastest_dim && reduction_tvs.size() > 1) {
     groupReductions(reduction_tvs, false);
@@ -1226,6 +1297,13 @@ void schedulePersistentKernel(Fusion* fusion, const ReductionParams& rparams) {
     }
   }
 
+  for (auto persistent_buffer : smem_persistent_buffers) {
+    if (!persistent_buffer->isFusionInput() &&
+        !persistent_buffer->isFusionOutput()) {
+      persistent_buffer->setMemoryType(MemoryType::Shared);
+    }
+  }
+
   scheduler_utils::promoteProducerMemoryTypesOfResizedTensors(
       fusion, cached_inputs);
 }
@@ -5,12 +5,12 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 // clang-format on
+#include <device_profile.h>
 #include <scheduler/debug_utils.h>
 #include <scheduler/normalization_utils.h>
+#include <scheduler/utils.h>
 #include <utils.h>
 
-#include <ATen/cuda/CUDAContext.h>
-
 namespace nvfuser {
 namespace normalization_scheduler_utils {
 
@@ -57,8 +57,7 @@ bool PreferredLaunchConfig::setBdimx(int bdimx, bool dry_run) {
 // 36), (2, 54)].
 void PreferredLaunchConfig::initValidGdims() {
   std::vector<std::pair<int, int>> grid_dims;
-  const int num_sms =
-      at::cuda::getCurrentDeviceProperties()->multiProcessorCount;
+  const int num_sms = (int)scheduler_utils::numSMs();
   const int max_first_half =
       static_cast<int>(std::sqrt(static_cast<float>(num_sms)));
   for (int gdimy = 2; gdimy <= max_first_half; ++gdimy) {
@@ -451,8 +450,8 @@ std::optional<GridOuterNormalizationParams> getGridOuterNormalizationParams(
     int64_t adjusted_gdimy = -1;
     int64_t adjusted_buffer_size = -1;
     bool last_block_work_reduced = false;
-    const auto major_ver = at::cuda::getCurrentDeviceProperties()->major;
-    const auto minor_ver = at::cuda::getCurrentDeviceProperties()->minor;
+    const auto major_ver = getCurrentDeviceProfile().major;
+    const auto minor_ver = getCurrentDeviceProfile().minor;
     if (major_ver == 7 && minor_ver == 5) {
       adjusted_gdimy = launch_cfg.gdimy();
       adjusted_buffer_size = getMinPersistentBufferSize(
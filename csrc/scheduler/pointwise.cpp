@@ -7,6 +7,8 @@
 // clang-format on
 #include <scheduler/pointwise.h>
 
+#include <device_profile.h>
+#include <disjoint_set.h>
 #include <executor_utils.h>
 #include <inlining.h>
 #include <instrumentation.h>
@@ -20,8 +22,6 @@
 #include <transform_replay.h>
 #include <utils.h>
 
-#include <ATen/cuda/CUDAContext.h>
-
 #include <algorithm>
 #include <unordered_map>
 
@@ -32,6 +32,93 @@ namespace {
 // Unused at the moment, commenting for clang tidy
 constexpr int64_t kThreadX = 128;
 
+// Minimum number of full waves of blocks for a 1D schedule to loop over its
+// blocks with a grid-stride loop, see Note [ Grid-stride pointwise kernels ]
+constexpr int64_t kGridStrideMinWaves = 64;
+
+// Note [ Misaligned pointwise vectorization ]
+//
+// Vectorize requires the vectorized tensors to start at an address aligned
+// to the vector and to have a multiple of its width as inner extent, so an
+// input with a storage offset, or an odd number of elements, is accessed by
+// unrolled scalar loads instead. MisalignedVectorize is lowered to a scalar
+// prologue up to the first aligned address of the first vectorized tensor,
+// a vectorized body shifted by as many elements and a scalar epilogue for
+// the remainder, see lower_misaligned_vectorization.cpp. When enabled, a 1D
+// schedule of contiguous tensors of the same shape uses it whenever it is
+// wider than the aligned vectorization:
+//
+//   [i0, i1] -> [BIDx, TIDx, MisalignedVectorize]
+//
+// with everything computed at the -2 position, as lowering requires, so
+// there's no unswitch. The shift applies to all global tensors, which must
+// therefore be equally misaligned. If all inputs are aligned, all inputs
+// and outputs are vectorized and only the remainder is peeled. Otherwise
+// only the first misaligned input is vectorized and the other tensors are
+// accessed by scalars in the same shifted loops. The alignment of the
+// inputs is part of the kernel cache key, so a kernel is never reused for
+// inputs aligned differently, while the misalignment of the only
+// vectorized input may change.
+
+// Returns true if all tensors of the fusion can be indexed along with the
+// reference in a misaligned vectorized loop, see Note [ Misaligned pointwise
+// vectorization ]
+bool canMisalignedVectorize(Fusion* fusion, size_t n_ref_dims) {
+  for (auto expr : fusion->exprs()) {
+    if (!expr->isOneOf<UnaryOp, BinaryOp, TernaryOp, LoadStoreOp>()) {
+      return false;
+    }
+  }
+  std::vector<TensorView*> global_tvs;
+  for (auto val : fusion->inputs()) {
+    if (auto tv = dynamic_cast<TensorView*>(val)) {
+      global_tvs.push_back(tv);
+    }
+  }
+  for (auto tv : ir_utils::filterByType<TensorView>(fusion->outputs())) {
+    if (tv->isFusionInput()) {
+      return false;
+    }
+    global_tvs.push_back(tv);
+  }
+  for (auto tv : global_tvs) {
+    auto root = TensorDomain::noReductions(
+        TensorDomain::noBroadcasts(tv->getMaybeRFactorDomain()));
+    if (root.size() != n_ref_dims) {
+      return false;
+    }
+    const auto& contiguity = tv->domain()->contiguity();
+    if (std::any_of(contiguity.begin(), contiguity.end(), [](auto contig) {
+          return !contig.has_value() || !*contig;
+        })) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Maps the values of each connected component of the fusion graph to a
+// disjoint set, the same way isConnectedFusionGraph in registry.cpp does.
+DisjointSets<Val*> connectedComponentsOf(Fusion* fusion) {
+  DisjointSets<Val*> component_sets;
+  for (auto tv : ir_utils::allTvs(fusion)) {
+    component_sets.initializeSet(tv);
+  }
+  for (auto expr : fusion->exprs()) {
+    auto output0 = expr->output(0);
+    for (auto input : ir_utils::filterByType<TensorView>(expr->inputs())) {
+      component_sets.mapEntries(output0, input);
+    }
+    for (auto output : expr->outputs()) {
+      component_sets.mapEntries(output0, output);
+    }
+  }
+  for (auto alias_it : fusion->ioAlias()) {
+    component_sets.mapEntries(alias_it.first, alias_it.second);
+  }
+  return component_sets;
+}
+
 class DomainMap : public pointwise_utils::DomainMap {
  public:
   using pointwise_utils::DomainMap::DomainMap;
@@ -56,7 +143,72 @@ class DomainMap : public pointwise_utils::DomainMap {
     return result;
   }
 
+  // Find a reference tensor for each connected component of a fusion that
+  // isn't connected, see Note [ Horizontal pointwise fusion ]. Returns an
+  // empty vector if the fusion is connected or if any component has no valid
+  // reference.
+  std::vector<TensorView*> findHorizontalReferenceTensorViews() const {
+    // View transforms are propagated across the whole fusion at once
+    if (!ir_utils::getViewOps(fusion_).empty()) {
+      return {};
+    }
+
+    auto component_sets = connectedComponentsOf(fusion_);
+
+    std::vector<TensorView*> references;
+    for (const auto& component : component_sets.disjointSets()) {
+      bool has_output = false;
+      TensorView* reference = nullptr;
+      int max_dims = -1;
+      for (auto val : component->vector()) {
+        auto output_tv = dynamic_cast<TensorView*>(val);
+        if (output_tv == nullptr || !output_tv->isFusionOutput() ||
+            output_tv->isFusionInput()) {
+          continue;
+        }
+        has_output = true;
+        if (!isValidReferenceOf(output_tv, *component)) {
+          continue;
+        }
+        int n_dims = pointwise_utils::nRootDims(output_tv);
+        if (n_dims > max_dims) {
+          reference = output_tv;
+          max_dims = n_dims;
+        }
+      }
+      if (!has_output) {
+        // Nothing to compute, e.g. an input forwarded as an output
+        continue;
+      }
+      if (reference == nullptr) {
+        return {};
+      }
+      references.push_back(reference);
+    }
+
+    if (references.size() < 2) {
+      return {};
+    }
+    return references;
+  }
+
  private:
+  // Same as isValidReference, but only considers the inputs of component
+  bool isValidReferenceOf(
+      TensorView* tv,
+      const VectorOfUniqueEntries<Val*>& component) const {
+    for (auto input_tv :
+         ir_utils::filterByType<TensorView>(fusion_->inputs())) {
+      if (input_tv->uses().empty() || !component.has(input_tv)) {
+        continue;
+      }
+      if (!areAllInputIdsMappedTo(input_tv, tv)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
   bool hasMinimumSize(TensorView* tv, int num_axes) const {
     TORCH_INTERNAL_ASSERT(tv != nullptr);
     return (
@@ -65,6 +217,180 @@ class DomainMap : public pointwise_utils::DomainMap {
   }
 };
 
+// Note [ Horizontal pointwise fusion ]
+//
+// Fusions of many small independent pointwise subgraphs, e.g. the
+// per-parameter updates of an optimizer, are bound by launch overhead when
+// each subgraph is its own kernel. With EnableOption::HorizontalPointwise
+// the pointwise scheduler accepts fusions that aren't connected as long as
+// every connected component has its own reference tensor. Each component is
+// given the unrolled 1D schedule, [BIDx, Unswitch, Unroll, TIDx], from its
+// reference. All components share the same blockDim.x, while gridDim.x is the
+// largest of their block counts, so the blocks past the end of a smaller
+// component are predicated off of its loop nest and move on to the next
+// component. Vectorization and grid-stride loops would have to agree across
+// all components and aren't used.
+std::shared_ptr<PointwiseParams> getHorizontalPointwiseHeuristics(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    HeuristicSummary* data_cache,
+    const std::vector<TensorView*>& reference_tvs,
+    PrimDataType index_type) {
+  // Create the remaining entries HeuristicSummary::validate() expects of the
+  // pointwise scheduler. They're only used by the 1D/2D analysis of a single
+  // reference.
+  auto vectorizable_inputs_outputs_entry = HeuristicSummaryEntry<
+      HeuristicCompileTime::VectorizableInputsAndOutputs>(data_cache, []() {
+    return std::make_unique<std::vector<TensorView*>>();
+  });
+  vectorizable_inputs_outputs_entry.get();
+
+  auto broadcast_info = HeuristicSummaryEntry<
+      HeuristicCompileTime::BroadcastMultiples>(data_cache, []() {
+    return std::make_unique<scheduler_utils::BroadcastMultipleInformation>();
+  });
+  broadcast_info.get();
+
+  auto vectorize_maps_entry =
+      HeuristicSummaryEntry<HeuristicCompileTime::VectorizeMaps>(
+          data_cache, []() {
+            return std::make_unique<std::vector<
+                vectorize_helper::ContiguousInnerDimensionsMapper>>();
+          });
+  vectorize_maps_entry.get();
+
+  const int64_t device_multiprocessor_count = scheduler_utils::numSMs();
+
+  int64_t max_input_dtype_size = 2;
+  for (auto inp : ir_utils::filterByType<TensorView>(fusion->inputs())) {
+    max_input_dtype_size = std::max(
+        max_input_dtype_size,
+        (int64_t)dataTypeSize(inp->getDataType().value(), index_type));
+  }
+
+  // The largest component determines the grid
+  int64_t max_n_elems = 0;
+  for (auto reference_tv : reference_tvs) {
+    int64_t n_elems = 1;
+    for (auto id :
+         TensorDomain::noReductions(reference_tv->getMaybeRFactorDomain())) {
+      auto inferred_val =
+          runtime_info.expressionEvaluator().evaluate(id->extent());
+      TORCH_INTERNAL_ASSERT(
+          inferred_val.has_value(),
+          "Error inferring size for pointwise scheduler: ",
+          id->extent()->toInlineString());
+      n_elems *= inferred_val->as<int64_t>();
+    }
+    max_n_elems = std::max(max_n_elems, n_elems);
+  }
+
+  constexpr int64_t kSixteen = 16; // clang tidy
+  int64_t unroll_factor = kSixteen / max_input_dtype_size;
+  // Don't unroll at the cost of getting a full wave on the GPU
+  if (max_n_elems < device_multiprocessor_count * kThreadX) {
+    unroll_factor = std::min(
+        unroll_factor,
+        ceilDiv(max_n_elems, device_multiprocessor_count * kThreadX));
+  }
+
+  auto params = std::make_shared<PointwiseParams>(
+      "Horizontal pointwise heuristics", index_type);
+  params->unroll_factor = std::max(unroll_factor, (int64_t)1);
+  params->lparams.bind(kThreadX, ParallelType::TIDx);
+
+  if (isDebugDumpEnabled(DebugDumpOption::SchedulerDebug)) {
+    std::cerr << "\n===== Horizontal Pointwise Stats ========\n"
+              << "num_components: " << reference_tvs.size() << "\n"
+              << "max_num_elems: " << max_n_elems << std::endl;
+    std::cerr << params->toString() << std::endl;
+  }
+
+  return params;
+}
+
+// Inline at the inner most position. The CA position of all tensors except
+// inputs, cached inputs and outputs will be updated.
+void inlineInnerMost(
+    Fusion* fusion,
+    const std::vector<TensorView*>& cached_inputs,
+    const std::vector<std::pair<TensorView*, TensorView*>>& cached_outputs) {
+  auto all_tvs = ir_utils::allTvs(fusion);
+  std::unordered_set<TensorView*> inner_most_tensors(
+      all_tvs.begin(), all_tvs.end());
+  for (auto cached_input : cached_inputs) {
+    inner_most_tensors.erase(cached_input);
+  }
+  for (auto entry : cached_outputs) {
+    auto output = entry.second;
+    inner_most_tensors.erase(output);
+  }
+  inlineMost(inner_most_tensors);
+}
+
+// Schedules each connected component of a fusion that isn't connected like
+// its reference tensor, see Note [ Horizontal pointwise fusion ]
+void scheduleHorizontalPointwise(
+    Fusion* fusion,
+    const PointwiseParams& params,
+    const std::vector<TensorView*>& reference_tvs) {
+  TORCH_INTERNAL_ASSERT(
+      params.break_point == 0 && !params.vectorize && !params.grid_stride_loop,
+      "Horizontal pointwise fusions only support the unrolled 1D schedule.");
+
+  constexpr int64_t unswitch_pos = 2;
+  for (auto reference_tv : reference_tvs) {
+    if (pointwise_utils::nRootDims(reference_tv) == 0) {
+      continue;
+    }
+
+    while (reference_tv->nDims() > 1) {
+      reference_tv->merge(0);
+    }
+    // Threads
+    reference_tv->split(0, kThreadX);
+    // Unroll
+    reference_tv->split(0, params.unroll_factor);
+    // Unswitch
+    reference_tv->split(0, 1);
+
+    // [BIDx, Unswitch, Unroll, TIDx]
+    reference_tv->axis(0)->parallelize(ParallelType::BIDx);
+    reference_tv->axis(1)->parallelize(ParallelType::Unswitch);
+    reference_tv->axis(3)->parallelize(ParallelType::TIDx);
+
+    // Neither the propagation nor the inlining leave the component of
+    // reference_tv
+    TransformPropagator propagator(reference_tv);
+    MaxRootDomainInfoSpanningTree spanning_tree(reference_tv);
+    spanning_tree.traverse(&propagator);
+    inlineAllAt(reference_tv, unswitch_pos, true);
+  }
+
+  // Same as scheduler_utils::parallelizeAllLike for every reference, but
+  // with a single ComputeAtMap as there can be thousands of components
+  ComputeAtMap ca_map(fusion);
+  std::unordered_map<IterDomain*, IterDomain*> concrete_to_reference_map;
+  for (auto reference_tv : reference_tvs) {
+    for (auto id : reference_tv->domain()->domain()) {
+      concrete_to_reference_map[ca_map.getConcreteMappedID(
+          id, IdMappingMode::PERMISSIVE_RESIZE)] = id;
+    }
+  }
+  for (auto tv : ir_utils::allTvs(fusion)) {
+    if (tv->isFusionInput()) {
+      continue;
+    }
+    for (auto id : tv->domain()->domain()) {
+      auto it = concrete_to_reference_map.find(
+          ca_map.getConcreteMappedID(id, IdMappingMode::PERMISSIVE_RESIZE));
+      if (it != concrete_to_reference_map.end()) {
+        id->parallelize(it->second->getParallelType());
+      }
+    }
+  }
+}
+
 } // namespace
 
 std::shared_ptr<PointwiseParams> getPointwiseHeuristics(
@@ -94,18 +420,34 @@ std::shared_ptr<PointwiseParams> getPointwiseHeuristics(
           [fusion]() { return std::make_unique<DomainMap>(fusion); });
   const auto& domain_map = dynamic_cast<DomainMap&>(domain_map_entry.get());
 
+  // Holds one reference per connected component when the fusion is
+  // scheduled horizontally, see Note [ Horizontal pointwise fusion ]
   auto largest_out_entry =
       HeuristicSummaryEntry<HeuristicCompileTime::ReferenceTensors>(
           data_cache, [&domain_map]() {
             std::vector<TensorView*> data{domain_map.findReferenceTensorView()};
+            if (data.front() == nullptr) {
+              auto horizontal_references =
+                  domain_map.findHorizontalReferenceTensorViews();
+              if (!horizontal_references.empty()) {
+                data = std::move(horizontal_references);
+              }
+            }
             return std::make_unique<std::vector<TensorView*>>(std::move(data));
           });
+  if (largest_out_entry.get().size() > 1) {
+    return getHorizontalPointwiseHeuristics(
+        fusion,
+        runtime_info,
+        data_cache,
+        largest_out_entry.get(),
+        index_type);
+  }
   TensorView* largest_out = largest_out_entry.get()[0];
 
   TORCH_INTERNAL_ASSERT(largest_out != nullptr);
 
-  const int64_t device_multiprocessor_count =
-      (int64_t)at::cuda::getCurrentDeviceProperties()->multiProcessorCount;
+  const int64_t device_multiprocessor_count = scheduler_utils::numSMs();
 
   // TODO: Set to 1?
   int64_t max_input_dtype_size = 2;
@@ -313,15 +655,14 @@ std::shared_ptr<PointwiseParams> getPointwiseHeuristics(
         // Need to be able to parallelize, don't use break if there's not
         // at least an unrolled warp.
         if (ceilDiv(cur_right_elem_count, max_unroll_factor) <=
-            at::cuda::getCurrentDeviceProperties()->warpSize) {
+            getCurrentDeviceProfile().warp_size) {
           continue;
         }
 
         // If outer broadcast, or balanced broadcast:
         if (lhs_byte_multiple <= rhs_byte_multiple &&
             // If right transfer size is bigger than half of L2
-            at::cuda::getCurrentDeviceProperties()->l2CacheSize <
-                right_transfer_size * 2) {
+            getCurrentDeviceProfile().l2_size < right_transfer_size * 2) {
           // flip BIDx and BIDy bindings
           flip_grid_binding = true;
         } else {
@@ -367,6 +708,46 @@ std::shared_ptr<PointwiseParams> getPointwiseHeuristics(
     params->unroll_factor = vectorize_factor;
   }
 
+  // See Note [ Misaligned pointwise vectorization ]
+  if (break_point == 0 &&
+      isOptionEnabled(EnableOption::MisalignedVectorize) &&
+      canMisalignedVectorize(fusion, ref_root.size())) {
+    int64_t max_dtype_size = 1;
+    for (auto val : fusion->inputs()) {
+      if (auto tv = dynamic_cast<TensorView*>(val)) {
+        max_dtype_size = std::max(
+            max_dtype_size,
+            (int64_t)dataTypeSize(tv->getDataType().value(), index_type));
+      }
+    }
+    for (auto tv : ir_utils::filterByType<TensorView>(fusion->outputs())) {
+      max_dtype_size = std::max(
+          max_dtype_size,
+          (int64_t)dataTypeSize(tv->getDataType().value(), index_type));
+    }
+    const auto misaligned_factor = scheduler_utils::lastPow2(
+        std::min(max_unroll_factor, kSixteen / max_dtype_size));
+    if (misaligned_factor > (int64_t)vectorize_factor) {
+      // The first input not aligned to a full vector, if any
+      int64_t misaligned_input = -1;
+      for (auto i : c10::irange(fusion->inputs().size())) {
+        auto tv = dynamic_cast<TensorView*>(fusion->inputs()[i]);
+        if (tv != nullptr &&
+            (int64_t)runtime_info.getAlignmentSize(tv) <
+                misaligned_factor *
+                    (int64_t)dataTypeSize(
+                        tv->getDataType().value(), index_type)) {
+          misaligned_input = (int64_t)i;
+          break;
+        }
+      }
+      params->vectorize = true;
+      params->unroll_factor = misaligned_factor;
+      params->misaligned_vectorize = true;
+      params->misaligned_vectorize_input = misaligned_input;
+    }
+  }
+
   TORCH_INTERNAL_ASSERT(right_elem_count > 0 || break_point == 0);
   TORCH_INTERNAL_ASSERT(!(bdimy > 1 && gdim_right > 1));
 
@@ -383,6 +764,36 @@ std::shared_ptr<PointwiseParams> getPointwiseHeuristics(
     params->split_grid_y_dim = true;
   }
 
+  // Note [ Grid-stride pointwise kernels ]
+  //
+  // The 1D schedule launches a block for every kThreadX * unroll_factor
+  // elements, so very large fusions launch a great many short-lived blocks
+  // and pay for block scheduling and the tail of the last wave. Once there
+  // are at least kGridStrideMinWaves waves of blocks, the grid is instead
+  // sized to the blocks that can be resident on the device at once, and
+  // each block loops over every gridDim.x-th block of elements. Residency is
+  // estimated from the thread count alone as register usage isn't known
+  // yet; a grid that ends up larger than one wave is still correct.
+  if (break_point == 0 && !params->misaligned_vectorize &&
+      !isOptionDisabled(DisableOption::GridStridePointwise)) {
+    const auto& device_prop = getCurrentDeviceProfile();
+    const int64_t resident_blocks = device_multiprocessor_count *
+        std::max(device_prop.max_threads_per_sm / kThreadX, (int64_t)1);
+    const int64_t n_blocks =
+        ceilDiv(n_elems, kThreadX * (int64_t)params->unroll_factor);
+    if (n_blocks >= kGridStrideMinWaves * resident_blocks) {
+      params->grid_stride_loop = true;
+      params->lparams.bind(resident_blocks, ParallelType::BIDx);
+    }
+  }
+
+  // See Note [ Assumed divisible splits ]. Canonical sizes of shape buckets
+  // don't tell whether the actual sizes of the bucket are divisible
+  params->assume_divisible_split = break_point == 0 &&
+      !params->misaligned_vectorize && !runtime_info.hasCanonicalSizes() &&
+      !isOptionDisabled(DisableOption::AssumedDivisibleSplits) &&
+      n_elems % (kThreadX * (int64_t)params->unroll_factor) == 0;
+
   if (isDebugDumpEnabled(DebugDumpOption::SchedulerDebug)) {
     std::cerr << "\n===== Pointwise Stats ========\n"
               << "num_elems: " << n_elems << "\n"
@@ -427,6 +838,12 @@ bool hasReferenceTensorView(Fusion* fusion) {
   return getReferenceTensorView(fusion) != nullptr;
 }
 
+std::vector<TensorView*> getHorizontalReferenceTensorViews(Fusion* fusion) {
+  FusionGuard fg(fusion);
+  DomainMap domain_map(fusion);
+  return domain_map.findHorizontalReferenceTensorViews();
+}
+
 // TODO: Inline intermediate operations (avoid inlining unrolled/vectorized
 // input/output caches)
 void schedulePointwise(Fusion* fusion, const PointwiseParams& params) {
@@ -443,7 +860,7 @@ void schedulePointwise(Fusion* fusion, const PointwiseParams& params) {
       "This scheduler only handles pointwise ops.");
 
   // Cache inputs
-  auto cached_inputs = scheduler_utils::cacheInputs(fusion, true);
+  auto cached_inputs = scheduler_utils::cacheInputs(fusion, true, true);
 
   // Cache and fork outputs
   auto cached_outputs = scheduler_utils::cacheAndForkOutputs(fusion, true);
@@ -477,8 +894,37 @@ void schedulePointwise(Fusion* fusion, const PointwiseParams& params) {
     return;
   }
 
+  // Broadcast inputs are read again by many blocks, so keep them in L2 over
+  // the inputs and outputs that are only accessed once. See Note [ Cache
+  // hints ]
+  const bool has_reused_input =
+      std::any_of(input_tvs.begin(), input_tvs.end(), [&](TensorView* inp) {
+        return pointwise_utils::nRootDims(inp) < max_dims;
+      });
+  if (has_reused_input) {
+    for (auto inp : input_tvs) {
+      inp->setCacheHint(
+          pointwise_utils::nRootDims(inp) < max_dims ? CacheHint::EvictLast
+                                                     : CacheHint::EvictFirst);
+    }
+    for (auto out : output_tvs) {
+      out->setCacheHint(CacheHint::EvictFirst);
+    }
+  }
+
   TensorView* reference_tv = getReferenceTensorView(fusion);
 
+  if (reference_tv == nullptr) {
+    auto horizontal_reference_tvs = getHorizontalReferenceTensorViews(fusion);
+    if (!horizontal_reference_tvs.empty()) {
+      scheduleHorizontalPointwise(fusion, params, horizontal_reference_tvs);
+      inlineInnerMost(fusion, cached_inputs, cached_outputs);
+      scheduler_utils::promoteProducerMemoryTypesOfResizedTensors(
+          fusion, cached_inputs);
+      return;
+    }
+  }
+
   TORCH_INTERNAL_ASSERT(
       reference_tv != nullptr,
       "Could not find a fully broadcasted output to reference schedule on.");
@@ -706,13 +1152,26 @@ void schedulePointwise(Fusion* fusion, const PointwiseParams& params) {
     // unmerged...]
     reference_tv->reorder({{-1, 0}});
 
-    if (params.vectorize) {
+    if (params.misaligned_vectorize) {
+      // See Note [ Misaligned pointwise vectorization ]
+      reference_tv->split(0, params.unroll_factor);
+      reference_tv->split(0, kThreadX);
+
+      reference_tv->axis(0)->parallelize(ParallelType::BIDx);
+      reference_tv->axis(1)->parallelize(ParallelType::TIDx);
+      // Vectorization are propagated separately
+      vectorize_id = reference_tv->axis(2);
+      //[BIDx, TIDx, MisalignedVectorization]
+    } else if (params.vectorize) {
       // Vectorize
       reference_tv->split(0, params.unroll_factor);
       // Unswitch
       reference_tv->split(0, 1);
       // Threads
       reference_tv->split(0, kThreadX);
+      if (params.assume_divisible_split) {
+        scheduler_utils::assumeDivisibleSplit(reference_tv, 1);
+      }
 
       reference_tv->axis(0)->parallelize(ParallelType::BIDx);
       reference_tv->axis(1)->parallelize(ParallelType::TIDx);
@@ -729,6 +1188,10 @@ void schedulePointwise(Fusion* fusion, const PointwiseParams& params) {
       reference_tv->split(0, kThreadX);
       // Unroll
       reference_tv->split(0, params.unroll_factor);
+      if (params.assume_divisible_split) {
+        scheduler_utils::assumeDivisibleSplit(reference_tv, 2);
+        scheduler_utils::assumeDivisibleSplit(reference_tv, 1);
+      }
       // Unswitch
       reference_tv->split(0, 1);
 
@@ -743,6 +1206,14 @@ void schedulePointwise(Fusion* fusion, const PointwiseParams& params) {
       reference_tv->axis(3)->parallelize(ParallelType::TIDx);
     }
     unswitch_pos = 2;
+
+    if (params.grid_stride_loop) {
+      // [BIDx, ...] -> [grid-stride, BIDx, ...]
+      reference_tv->split(0, NamedScalar::getParallelDim(ParallelType::BIDx));
+      reference_tv->axis(0)->parallelize(ParallelType::Serial);
+      reference_tv->axis(1)->parallelize(ParallelType::BIDx);
+      unswitch_pos = 3;
+    }
   }
 
   TransformPropagator propagator(reference_tv);
@@ -754,6 +1225,13 @@ void schedulePointwise(Fusion* fusion, const PointwiseParams& params) {
     // Grab all tensor views that should be vectorized
     auto inputs_outputs =
         scheduler_utils::getInputsOutputsWithInnerDim(reference_tv, true, true);
+    if (params.misaligned_vectorize_input >= 0) {
+      // Only the consumer of the misaligned input, see Note [ Misaligned
+      // pointwise vectorization ]
+      inputs_outputs = {fusion->inputs()
+                            .at(params.misaligned_vectorize_input)
+                            ->as<TensorView>()};
+    }
     std::vector<TensorView*> vectorized_tvs;
     bool should_vectorize_reference_tv = false;
     for (auto tv : inputs_outputs) {
@@ -764,6 +1242,10 @@ void schedulePointwise(Fusion* fusion, const PointwiseParams& params) {
         vectorized_tvs.emplace_back(tv);
         continue;
       }
+      // Uncached inputs are read by where, see Note [ Block sparse inputs ]
+      if (scheduler_utils::isOnlySelectedByWhere(tv)) {
+        continue;
+      }
       // move inputs to consumers of inputs
       auto consumer_tvs = ir_utils::consumerTvsOf(tv);
       vectorized_tvs.insert(
@@ -772,9 +1254,12 @@ void schedulePointwise(Fusion* fusion, const PointwiseParams& params) {
     if (!vectorized_tvs.empty()) {
       // Aggressively mark with vectorized and cleanup later. That way we
       // don't have to manually specify parallelization outside the reference.
-      vectorize_id->parallelize(ParallelType::Vectorize);
+      const auto vectorize_ptype = params.misaligned_vectorize
+          ? ParallelType::MisalignedVectorize
+          : ParallelType::Vectorize;
+      vectorize_id->parallelize(vectorize_ptype);
       scheduler_utils::parallelizeAllLike(
-          reference_tv, vectorized_tvs, {ParallelType::Vectorize});
+          reference_tv, vectorized_tvs, {vectorize_ptype});
       if (!should_vectorize_reference_tv) {
         vectorize_id->parallelize(ParallelType::Serial);
       }
@@ -788,20 +1273,11 @@ void schedulePointwise(Fusion* fusion, const PointwiseParams& params) {
   // unrolling manually.
   inlineAllAt(reference_tv, unswitch_pos, true);
 
-  auto all_tvs = ir_utils::allTvs(fusion);
-
-  // Inline at the inner most position. The CA position of all tensors except
-  // inputs, cached inputs and outputs will be updated.
-  std::unordered_set<TensorView*> inner_most_tensors(
-      all_tvs.begin(), all_tvs.end());
-  for (auto cached_input : cached_inputs) {
-    inner_most_tensors.erase(cached_input);
+  // A loop of a misaligned vectorized tensor can't hold any other
+  // expression, so everything is left at the -2 position
+  if (!params.misaligned_vectorize) {
+    inlineInnerMost(fusion, cached_inputs, cached_outputs);
   }
-  for (auto entry : cached_outputs) {
-    auto output = entry.second;
-    inner_most_tensors.erase(output);
-  }
-  inlineMost(inner_most_tensors);
 
   scheduler_utils::promoteProducerMemoryTypesOfResizedTensors(
       fusion, cached_inputs);
@@ -178,4 +178,9 @@ bool hasReferenceTensorView(Fusion* fusion);
 // Return reference tensor view.
 TensorView* getReferenceTensorView(Fusion* fusion);
 
+//! Return a reference tensor view for each connected component of a fusion
+//!  that isn't connected, see Note [ Horizontal pointwise fusion ]. Empty if
+//!  the fusion is connected or any of its components has no reference.
+std::vector<TensorView*> getHorizontalReferenceTensorViews(Fusion* fusion);
+
 } // namespace nvfuser
@@ -43,6 +43,25 @@ class PointwiseParams : public HeuristicParams {
   // Unroll or vectorization factor
   size_t unroll_factor = 1;
 
+  // Launch a grid of the size bound to BIDx in lparams and loop over the
+  // remaining blocks of elements. 1D schedule only, see Note [ Grid-stride
+  // pointwise kernels ]
+  bool grid_stride_loop = false;
+
+  // Vectorize with ParallelType::MisalignedVectorize instead, with
+  // unroll_factor as the vector width. 1D schedule only, see Note [
+  // Misaligned pointwise vectorization ]
+  bool misaligned_vectorize = false;
+
+  // Position in the fusion inputs of the only input vectorized with
+  // misaligned vectorization, -1 if all inputs and outputs are
+  int64_t misaligned_vectorize_input = -1;
+
+  // The 1D domain divides evenly into blocks of kThreadX * unroll_factor
+  // elements, so the thread and unroll splits are registered as divisible.
+  // See Note [ Assumed divisible splits ] in lower_divisible_split.h
+  bool assume_divisible_split = false;
+
   using HeuristicParams::HeuristicParams;
 
   // Warning: Does not check launch parameters!
@@ -58,7 +77,11 @@ class PointwiseParams : public HeuristicParams {
         other.split_block == split_block &&
         other.split_grid_y_dim == split_grid_y_dim &&
         other.unroll_factor == unroll_factor &&
-        other.flip_grid_binding == flip_grid_binding;
+        other.flip_grid_binding == flip_grid_binding &&
+        other.grid_stride_loop == grid_stride_loop &&
+        other.misaligned_vectorize == misaligned_vectorize &&
+        other.misaligned_vectorize_input == misaligned_vectorize_input &&
+        other.assume_divisible_split == assume_divisible_split;
     return attr_equal;
   }
 
@@ -79,7 +102,12 @@ class PointwiseParams : public HeuristicParams {
       }
     }
     if (unroll_factor > 1) {
-      if (vectorize) {
+      if (misaligned_vectorize) {
+        ss << "Misaligned vectorize, Factor: " << unroll_factor << "\n";
+        if (misaligned_vectorize_input >= 0) {
+          ss << "  Only input: " << misaligned_vectorize_input << "\n";
+        }
+      } else if (vectorize) {
         ss << "Vectorize, Factor: " << unroll_factor << "\n";
       } else {
         ss << "Unroll, Factor: " << unroll_factor << "\n";
@@ -88,6 +116,12 @@ class PointwiseParams : public HeuristicParams {
     if (flip_grid_binding) {
       ss << "Flip BIDx/BIDy bindings\n";
     }
+    if (grid_stride_loop) {
+      ss << "Grid-stride loop\n";
+    }
+    if (assume_divisible_split) {
+      ss << "Assumed divisible split\n";
+    }
     ss << "====================================\n";
     return ss.str();
   }
@@ -99,7 +133,11 @@ class PointwiseParams : public HeuristicParams {
         static_cast<size_t>(split_block) << 5 ^
         static_cast<size_t>(split_grid_y_dim) << 6 ^
         static_cast<size_t>(unroll_factor) << 9 ^
-        static_cast<size_t>(flip_grid_binding) << 10;
+        static_cast<size_t>(flip_grid_binding) << 10 ^
+        static_cast<size_t>(grid_stride_loop) << 11 ^
+        static_cast<size_t>(misaligned_vectorize) << 12 ^
+        static_cast<size_t>(misaligned_vectorize_input + 1) << 13 ^
+        static_cast<size_t>(assume_divisible_split) << 1;
     return attr_hash;
   }
 
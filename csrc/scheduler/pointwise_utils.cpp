@@ -27,6 +27,16 @@ DomainMap::DomainMap(Fusion* fusion) : fusion_(fusion), ca_map_(fusion) {
       select_ids_.emplace(id);
     }
   }
+  // The self tensor of scatter is not mapped to its output either, see
+  // Note [ Scatter outputs ]
+  for (auto expr : fusion->exprs()) {
+    if (auto sop = dynamic_cast<ScatterOp*>(expr)) {
+      for (auto id :
+           TensorDomain::noReductions(sop->selfTv()->getMaybeRFactorDomain())) {
+        select_ids_.emplace(id);
+      }
+    }
+  }
 }
 
 // Determine if all IterDomains in input are mapped to the given tensor
@@ -7,6 +7,7 @@
 // clang-format on
 #include <scheduler/reduction.h>
 
+#include <device_profile.h>
 #include <executor_utils.h>
 #include <instrumentation.h>
 #include <ir_all_nodes.h>
@@ -19,8 +20,6 @@
 
 #include <ir_iostream.h>
 
-#include <ATen/cuda/CUDAContext.h>
-
 namespace nvfuser {
 
 namespace {
@@ -66,6 +65,174 @@ void reduceProductTo(int64_t& z, int64_t& y, int64_t& x, const int64_t max) {
   }
 }
 
+// Note [ Circular buffering of reduction inputs ]
+//
+// A non-persistent reduction iterates serially over the part of the
+// reduction domain not covered by the block and the grid, and each
+// iteration starts with a vectorized load of each input. When the loop is
+// long, these loads are latency bound, as the next iteration can't start
+// loading before the current one is done. With
+// `PYTORCH_NVFUSER_ENABLE=circular_buffer` on sm_80 and newer devices, the
+// cached inputs are instead loaded with cp.async into shared memory,
+// circular buffered over the serial loop, so that the loads of up to
+// `circular_buffer_stages - 1` iterations ahead are in flight while the
+// current one is reduced. The number of stages is 3 by default and can be
+// given as option argument, e.g. `circular_buffer(4)`. It's only applied
+// when the serial loop has at least as many iterations as stages and the
+// buffers fit in half of the shared memory of a block, so occupancy isn't
+// bound by them. Each thread only reads back what it loaded itself, so no
+// block syncs are needed.
+//
+// This applies to both inner and outer reductions. For outer reductions, the
+// inputs are vectorized over the iteration domain and each iteration of the
+// serial loop loads a [bdimy * unroll, bdimx * vectorize] tile. Rather than
+// dedicating producer warps to the loads, every thread issues its own
+// cp.async copies ahead of its use, which keeps the loads in flight without
+// the named barriers a warp specialized kernel would need.
+//
+// Pointwise and persistent kernels are not circular buffered, as they have
+// no serial loop over the loads of their inputs.
+
+//! Returns the number of stages to circular buffer the input loads of a
+//! non-persistent reduction with, or 0 to not circular buffer them.
+//! See Note [ Circular buffering of reduction inputs ]
+int64_t reductionCircularBufferStages(
+    const int64_t serial_iterations,
+    const int64_t smem_bytes_per_stage) {
+  if (!isOptionEnabled(EnableOption::CircularBuffer) ||
+      getCurrentDeviceProfile().major < 8) {
+    return 0;
+  }
+  int64_t stages = 3;
+  const auto& option_args =
+      getEnableOptionArguments(EnableOption::CircularBuffer);
+  if (!option_args.empty()) {
+    try {
+      stages = std::stoi(option_args[0]);
+    } catch (const std::exception& e) {
+      std::cout << "skip invalid argument for CircularBuffer, arg = "
+                << option_args[0] << std::endl;
+    }
+  }
+  const auto max_smem_bytes = getCurrentDeviceProfile().smem_per_block / 2;
+  if (stages < 2 || serial_iterations < stages ||
+      stages * smem_bytes_per_stage > max_smem_bytes) {
+    return 0;
+  }
+  return stages;
+}
+
+// Note [ Rotated serial reduction loop ]
+//
+// When the inputs aren't circular buffered, the loads of each iteration of
+// the serial reduction loop are only issued once the previous iteration is
+// reduced, so their latency is exposed once per iteration. Instead, the
+// cached inputs are loaded a whole iteration at a time and the serial loop
+// is rotated over those loads (see Note [Loop Rotation]):
+//
+//   load(0);
+//   for i in serial:
+//     reduce(i);
+//     load(i + 1);
+//
+// so that the loads of the next iteration are issued right after the
+// reduction of the current one and can overlap with it instead of waiting
+// at the top of the next iteration. This needs no extra buffer beyond the
+// per-iteration register cache the unrolled loop already has. Whether the
+// loads end up at the top of the loop is only known at lowering, so the
+// rotation is optional there and is silently dropped otherwise. It can be
+// turned off with PYTORCH_NVFUSER_DISABLE=scheduler_loop_rotation.
+
+//! Returns if the inputs of the serial loop of a non-persistent reduction
+//! should be rotated. See Note [ Rotated serial reduction loop ]
+bool rotateSerialReductionLoop(const ReductionParams& rparams) {
+  return !isOptionDisabled(DisableOption::SchedulerLoopRotation) &&
+      !rparams.persistent_kernel && rparams.isUnrolled() &&
+      rparams.circular_buffer_stages <= 1 &&
+      !rparams.multiple_serial_accumulators &&
+      !rparams.stage_transposed_outputs;
+}
+
+//! Returns if the serial loop of an inner reduction is long enough to
+//! accumulate its unrolled elements into separate registers.
+//! See Note [ Multiple serial accumulators ] in reduction_utils.cpp
+bool useMultipleSerialAccumulators(
+    const ReductionParams& rparams,
+    const int64_t inner_most_dimension_numel) {
+  // Shorter loops don't issue enough dependent additions for the extra
+  // registers and the final combination to pay off
+  constexpr int64_t kMinSerialIterations = 8;
+  if (!rparams.fastest_dim || rparams.persistent_kernel ||
+      rparams.schedule_3D || !rparams.cross_block_inner_reduction ||
+      rparams.cross_grid_inner_reduction ||
+      rparams.unroll_factor_inner_reduction < 2 ||
+      rparams.circular_buffer_stages > 0) {
+    return false;
+  }
+  const int64_t serial_iterations = ceilDiv(
+      inner_most_dimension_numel,
+      rparams.lparams.bdimx() * rparams.unroll_factor_inner_reduction);
+  return serial_iterations >= kMinSerialIterations;
+}
+
+// Note [ Staging transposed outputs of reductions ]
+//
+// A fusion reducing the outer dimension of a tensor can also output a
+// transposed copy of it (or of a pointwise function of it), e.g., a weight
+// gradient that's also written in another layout. The whole fusion is taken
+// by the reduction scheduler, which reads the input once, but the copy
+// follows the schedule of the reduction: threadIdx.x runs over the iteration
+// domain, which is the outer dimension of the copy, so each thread of a warp
+// writes to a different row and none of the stores are coalesced.
+//
+// Instead, the serial reduction loop is hoisted right inside the grid
+// parallelized loops of the reference, so that each iteration of it covers
+// a [bdimy * unroll, bdimx * unroll] tile of the input for the whole block.
+// The transposed output is computed into a shared memory copy of that tile,
+// and written out from it with the tile reordered to have the innermost
+// dimension of the output last and re-parallelized over the same threads:
+//
+//   for serial:
+//     tile_smem[r, i] = f(in[r, i]);  // threads over [r, i], as the reduction
+//     __syncthreads();
+//     out[i, r] = tile_smem[r, i];    // threads over [i, r], r innermost
+//
+// This is the tiling the transpose scheduler uses, fused into the reduction
+// kernel. It's only used for outer reductions parallelized over the
+// iteration domain with threadIdx.x, and when the tiles fit in half of the
+// shared memory of a block. The input loads aren't circular buffered or
+// rotated with it, as their loop is now shared with the block syncs of the
+// tile.
+
+//! Returns if the transposed outputs of a non-persistent outer reduction
+//! should be written through shared memory.
+//! See Note [ Staging transposed outputs of reductions ]
+bool stageTransposedOutputs(
+    const ReductionParams& rparams,
+    TensorView* reduction_tv,
+    const DataType index_type) {
+  if (rparams.fastest_dim || rparams.schedule_3D ||
+      rparams.persistent_kernel ||
+      rparams.block_dim_iter_dom != ParallelType::TIDx ||
+      rparams.circular_buffer_stages > 1) {
+    return false;
+  }
+  const auto transposed_outputs =
+      reduction_scheduler_utils::getTransposedOutputs(reduction_tv);
+  if (transposed_outputs.empty()) {
+    return false;
+  }
+  const int64_t tile_numel = rparams.lparams.bdimx() *
+      rparams.lparams.bdimy() * rparams.unroll_factor_iter_dom *
+      rparams.unroll_factor_inner_reduction;
+  int64_t smem_bytes = 0;
+  for (auto tv : transposed_outputs) {
+    smem_bytes += tile_numel *
+        (int64_t)dataTypeSize(tv->getDataType().value(), index_type);
+  }
+  return smem_bytes <= getCurrentDeviceProfile().smem_per_block / 2;
+}
+
 std::shared_ptr<ReductionParams> innerReductionHeuristic(
     const int64_t total_reduction_numel,
     const int64_t total_iteration_numel,
@@ -80,11 +247,9 @@ std::shared_ptr<ReductionParams> innerReductionHeuristic(
   // WARNING: At some point we may want to generate heuristics for another
   // device that is not the current device.
   const int64_t device_max_threads_per_multiprocessor =
-      (int64_t)at::cuda::getCurrentDeviceProperties()
-          ->maxThreadsPerMultiProcessor;
+      getCurrentDeviceProfile().max_threads_per_sm;
 
-  const int64_t device_multiprocessor_count =
-      (int64_t)at::cuda::getCurrentDeviceProperties()->multiProcessorCount;
+  const int64_t device_multiprocessor_count = scheduler_utils::numSMs();
 
   auto const max_unroll = ceilDiv(
       // Available unrolling based on size of data type
@@ -103,7 +268,7 @@ std::shared_ptr<ReductionParams> innerReductionHeuristic(
   // we can use a smaller warp size. While thread local data fits in l1, and
   // reduction dim is really small, we can use <32 threads per warp.
   const bool fits_in_l2 = n_elems * max_input_dtype_size * n_tensor_inputs <
-      at::cuda::getCurrentDeviceProperties()->l2CacheSize;
+      getCurrentDeviceProfile().l2_size;
 
   // If it fits in l2, we just want to make sure each warp uses 32Bytes. Set
   // minimum warp as 16 threads instead of 32 as if we have a small reduction
@@ -388,8 +553,7 @@ std::shared_ptr<ReductionParams> innerReductionHeuristic(
   rparams->cross_grid_inner_reduction = gridim > 1;
   rparams->multiple_reds_per_blk = bdimy > 1;
   bool pad_bdimx = bdimx > 16 &&
-      bdimx * bdimy <
-          (int64_t)at::cuda::getCurrentDeviceProperties()->maxThreadsPerBlock;
+      bdimx * bdimy < getCurrentDeviceProfile().max_threads_per_block;
   // If barely just covering reduction dim, don't pad to the next warp
   pad_bdimx = pad_bdimx &&
       bdimx * inner_reduction_unroll_factor != inner_most_dimension_numel;
@@ -397,8 +561,7 @@ std::shared_ptr<ReductionParams> innerReductionHeuristic(
 
   if (rparams->pad_inner_reduction_to_warp) {
     // Adjust bdimx based on padding
-    auto min_warp_size =
-        (int64_t)at::cuda::getCurrentDeviceProperties()->warpSize;
+    auto min_warp_size = getCurrentDeviceProfile().warp_size;
     bdimx = bdimx % min_warp_size == 0
         ? bdimx
         : bdimx + min_warp_size - bdimx % min_warp_size;
@@ -471,6 +634,15 @@ std::shared_ptr<ReductionParams> innerReductionHeuristic(
       bdimy > 1 ? bdimy : LaunchParams::UNINITIALIZED_VAL,
       bdimz > 1 ? bdimz : LaunchParams::UNINITIALIZED_VAL);
 
+  if (vectorize && !rparams->schedule_3D) {
+    rparams->circular_buffer_stages = reductionCircularBufferStages(
+        ceilDiv(
+            inner_most_dimension_numel,
+            bdimx * inner_reduction_unroll_factor * gridim),
+        n_tensor_inputs * max_input_dtype_size *
+            inner_reduction_unroll_factor * bdimx * bdimy);
+  }
+
   if (isDebugDumpEnabled(DebugDumpOption::SchedulerDebug)) {
     std::cerr << "\n===== Reduction Stats ========\n"
               << "total_reduction_numel: "
@@ -518,11 +690,9 @@ std::shared_ptr<ReductionParams> outerReductionHeuristic(
     const size_t vectorize_factor) {
   // WARNING: Current device for codegen may not be the target device
   const int64_t device_max_threads_per_multiprocessor =
-      (int64_t)at::cuda::getCurrentDeviceProperties()
-          ->maxThreadsPerMultiProcessor;
+      getCurrentDeviceProfile().max_threads_per_sm;
 
-  const int64_t device_multiprocessor_count =
-      (int64_t)at::cuda::getCurrentDeviceProperties()->multiProcessorCount;
+  const int64_t device_multiprocessor_count = scheduler_utils::numSMs();
 
   auto const max_unroll = ceilDiv(
       // Available unrolling based on size of data type
@@ -540,7 +710,7 @@ std::shared_ptr<ReductionParams> outerReductionHeuristic(
   // TODO: Could get a much more accurate estimation of it the problem fits in
   // L2
   const bool fits_in_l2 = n_elems * max_input_dtype_size * n_tensor_inputs <
-      at::cuda::getCurrentDeviceProperties()->l2CacheSize;
+      getCurrentDeviceProfile().l2_size;
 
   const int64_t min_warp_size = fits_in_l2 ? 16 : 32;
 
@@ -835,6 +1005,13 @@ std::shared_ptr<ReductionParams> outerReductionHeuristic(
       rparams->multiple_reds_per_blk ? bdimy : LaunchParams::UNINITIALIZED_VAL,
       LaunchParams::UNINITIALIZED_VAL);
 
+  if (rparams->vectorize_iter_dom) {
+    rparams->circular_buffer_stages = reductionCircularBufferStages(
+        rDimAvail(),
+        n_tensor_inputs * max_input_dtype_size * iter_unroll_factor *
+            inner_reduction_unroll_factor * bdimx * bdimy);
+  }
+
   if (isDebugDumpEnabled(DebugDumpOption::SchedulerDebug)) {
     std::cerr << "\n===== Reduction Stats ========\n"
               << "total_reduction_numel: " << total_reduction_numel << "\n"
@@ -975,6 +1152,19 @@ std::shared_ptr<ReductionParams> getReductionHeuristics(
       max_dtype_size,
       vectorize_factor);
   heuristic->cparams.index_type = indexModeToDtype(runtime_info.getIndexMode());
+
+  if (!isOptionDisabled(DisableOption::SerialAccumulators) &&
+      reduction_tvs.size() == 1 && red_expr->isA<ReductionOp>() &&
+      isFloatingPointType(reduction_tv->getDataType().value())) {
+    heuristic->multiple_serial_accumulators = useMultipleSerialAccumulators(
+        *heuristic, properties.inner_most_dimension_numel);
+  }
+  heuristic->stage_transposed_outputs = stageTransposedOutputs(
+      *heuristic,
+      reduction_tv,
+      indexModeToDtype(runtime_info.getIndexMode()));
+  heuristic->rotate_serial_reduction_loop =
+      rotateSerialReductionLoop(*heuristic);
   return heuristic;
 }
 
@@ -986,10 +1176,12 @@ void scheduleReduction(Fusion* fusion, const ReductionParams& rparams) {
   bool unroll = rparams.isUnrolled();
 
   // Cache inputs if unrolled
-  auto cached_inputs = scheduler_utils::cacheInputs(fusion, unroll);
+  auto cached_inputs = scheduler_utils::cacheInputs(fusion, unroll, true);
 
-  // Cache and fork outputs
-  auto cached_outputs = scheduler_utils::cacheAndForkOutputs(fusion, unroll);
+  // Cache and fork outputs. Transposed outputs are staged through their
+  // cache, see Note [ Staging transposed outputs of reductions ]
+  auto cached_outputs = scheduler_utils::cacheAndForkOutputs(
+      fusion, unroll || rparams.stage_transposed_outputs);
 
   // Make sure we don't have global memory set on intermediate tensors from
   // fusion segmentation
@@ -1035,6 +1227,10 @@ void scheduleReduction(Fusion* fusion, const ReductionParams& rparams) {
   TensorView* reference_tv = reduction_scheduler_utils::scheduleReductionTV(
       rparams, reduction_tv, has_iter_axis);
 
+  if (rparams.stage_transposed_outputs) {
+    reduction_scheduler_utils::hoistSerialReductionLoop(reference_tv);
+  }
+
   // Reduction tensor views and rfactor tensor views are setup. Let's finish off
   // the scheduling, particularly inlining and unrolling.
   TORCH_INTERNAL_ASSERT(
@@ -28,6 +28,10 @@ class ReductionParams : public HeuristicParams {
   // Project persistent buffers back to inputs to reduce persistent buffer size
   bool project_persistent_buffers = false;
 
+  // Stage persistent buffers in shared memory instead of registers, see
+  // Note [ Shared memory persistent buffers ] in normalization.cpp
+  bool smem_persistent_buffers = false;
+
   // Are we treating the scheduling as 3 dimensional, can be useful for patterns
   // like [reduction, iteration, reduction].
   bool schedule_3D = false;
@@ -109,6 +113,26 @@ class ReductionParams : public HeuristicParams {
   // Use computeWith to persistent buffers
   bool compute_persistent_buffer_with_first_consumer = false;
 
+  // Number of stages to circular buffer the vectorized input loads of the
+  // serial reduction loop with cp.async, 0 to load directly into
+  // registers
+  int64_t circular_buffer_stages = 0;
+
+  // Accumulate the serial loop of the inner reduction into one register per
+  // unrolled or vectorized element, combined after the loop, instead of a
+  // single register. See Note [ Multiple serial accumulators ]
+  bool multiple_serial_accumulators = false;
+
+  // Rotate the input loads of the serial reduction loop so that the next
+  // iteration is loaded while the current one is reduced. See
+  // Note [ Rotated serial reduction loop ]
+  bool rotate_serial_reduction_loop = false;
+
+  // Write outputs transposed relative to the reduction input through a
+  // shared memory tile per iteration of the serial reduction loop. See
+  // Note [ Staging transposed outputs of reductions ] in reduction.cpp
+  bool stage_transposed_outputs = false;
+
   bool static_bdimx = false;
   bool static_bdimy = false;
 
@@ -132,6 +156,7 @@ class ReductionParams : public HeuristicParams {
         other.fastest_dim == fastest_dim &&
         other.persistent_kernel == persistent_kernel &&
         other.project_persistent_buffers == project_persistent_buffers &&
+        other.smem_persistent_buffers == smem_persistent_buffers &&
         other.schedule_3D == schedule_3D && other.flip_grid == flip_grid &&
         other.cross_block_inner_reduction == cross_block_inner_reduction &&
         other.cross_grid_inner_reduction == cross_grid_inner_reduction &&
@@ -155,7 +180,11 @@ class ReductionParams : public HeuristicParams {
         other.batches_per_block_outer_reduction ==
             batches_per_block_outer_reduction &&
         other.compute_persistent_buffer_with_first_consumer ==
-            compute_persistent_buffer_with_first_consumer;
+            compute_persistent_buffer_with_first_consumer &&
+        other.circular_buffer_stages == circular_buffer_stages &&
+        other.multiple_serial_accumulators == multiple_serial_accumulators &&
+        other.rotate_serial_reduction_loop == rotate_serial_reduction_loop &&
+        other.stage_transposed_outputs == stage_transposed_outputs;
 
     if (other.static_bdimy || static_bdimy) {
       attr_equal = attr_equal && other.lparams.bdimy() == lparams.bdimy();
@@ -172,7 +201,9 @@ class ReductionParams : public HeuristicParams {
        << (tag == "" ? "" : "Tag: ") << tag << "\n"
        << (fastest_dim ? "Red On Fastest Dim\n" : "Red On Slow Dim\n")
        << (persistent_kernel ? "Persistent Kernel\n" : "")
-       << (project_persistent_buffers ? "Project Persistent Buffers\n" : "");
+       << (project_persistent_buffers ? "Project Persistent Buffers\n" : "")
+       << (smem_persistent_buffers ? "Shared Memory Persistent Buffers\n"
+                                   : "");
     if (batches_per_block_inner_reduction > 1 || persistent_kernel) {
       ss << "Batches per block: " << batches_per_block_inner_reduction << "\n";
     }
@@ -247,6 +278,22 @@ class ReductionParams : public HeuristicParams {
       ss << "\ncomputeWith persistent buffers";
     }
 
+    if (circular_buffer_stages > 1) {
+      ss << "\nCircular buffer stages: " << circular_buffer_stages;
+    }
+
+    if (multiple_serial_accumulators) {
+      ss << "\nMultiple serial accumulators";
+    }
+
+    if (rotate_serial_reduction_loop) {
+      ss << "\nRotated serial reduction loop";
+    }
+
+    if (stage_transposed_outputs) {
+      ss << "\nStaged transposed outputs";
+    }
+
     ss << "\n" << lparams.toString() << "\n";
     ss << "====================================\n";
     return ss.str();
@@ -278,7 +325,12 @@ class ReductionParams : public HeuristicParams {
         static_cast<size_t>(batches_per_block_outer_reduction) << (bits - 21) ^
         static_cast<size_t>(unroll_factor_outer_reduction) << (bits - 22) ^
         static_cast<size_t>(compute_persistent_buffer_with_first_consumer)
-            << (bits - 23);
+            << (bits - 23) ^
+        static_cast<size_t>(circular_buffer_stages) << (bits - 24) ^
+        static_cast<size_t>(smem_persistent_buffers) << (bits - 25) ^
+        static_cast<size_t>(multiple_serial_accumulators) << (bits - 26) ^
+        static_cast<size_t>(rotate_serial_reduction_loop) << (bits - 27) ^
+        static_cast<size_t>(stage_transposed_outputs) << (bits - 28);
     return attr_hash;
   }
 
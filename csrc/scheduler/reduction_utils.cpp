@@ -11,6 +11,7 @@
 #include <inlining.h>
 #include <ir_cloner.h>
 #include <ir_utils.h>
+#include <iter_visitor.h>
 #include <maxinfo_propagator.h>
 #include <ops/arith.h>
 #include <scheduler/registry.h>
@@ -258,7 +259,9 @@ TensorView* scheduleReductionTV(
     }
   }
 
-  auto reduction_rf_tv = sortAndRFactor(reduction_tv);
+  auto reduction_rf_tv = rparams.multiple_serial_accumulators
+      ? sortAndRFactorSerialAccumulators(reduction_tv)
+      : sortAndRFactor(reduction_tv);
 
   // In the case of outer grid persistence, make sure the vectorized
   // domain placed at the innermost position.
@@ -347,6 +350,225 @@ bool isGridAllreduce(TensorView* reduction_tv) {
 
 } // namespace
 
+namespace {
+
+// Position of the serial reduction loop of the reference outside of any
+// unrolled or unswitched loop, or -1 if there's none
+int serialReductionLoopPosition(TensorView* reference_tv) {
+  for (const auto i : c10::irange(reference_tv->nDims())) {
+    auto ptype = reference_tv->axis((int)i)->getParallelType();
+    if (ptype == ParallelType::Unroll || ptype == ParallelType::Unswitch) {
+      break;
+    }
+    if (reference_tv->axis((int)i)->isReduction() &&
+        ptype == ParallelType::Serial) {
+      return (int)i;
+    }
+  }
+  return -1;
+}
+
+// Inline the schedule, circular buffering the vectorized loads of the cached
+// inputs over the serial reduction loop of the reference. See
+// Note [ Circular buffering of reduction inputs ] in reduction.cpp
+void inlineWithCircularBufferedInputs(
+    Fusion* fusion,
+    const ReductionParams& rparams,
+    TensorView* reference_tv,
+    const std::vector<TensorView*>& cached_inputs) {
+  const int serial_pos = serialReductionLoopPosition(reference_tv);
+
+  // cp.async copies 4, 8 or 16 bytes at a time
+  std::unordered_set<TensorView*> circular_buffered_tvs;
+  for (auto cached_input : cached_inputs) {
+    auto def = cached_input->definition();
+    if (serial_pos < 0 || !def->isA<UnaryOp>() ||
+        def->as<UnaryOp>()->getUnaryOpType() != UnaryOpType::Set) {
+      continue;
+    }
+    auto vec_it = std::find_if(
+        cached_input->domain()->domain().begin(),
+        cached_input->domain()->domain().end(),
+        [](IterDomain* id) {
+          return id->getParallelType() == ParallelType::Vectorize;
+        });
+    if (vec_it == cached_input->domain()->domain().end() ||
+        !(*vec_it)->extent()->isConstInt()) {
+      continue;
+    }
+    const auto byte_size = (*vec_it)->extent()->evaluateInt() *
+        (int64_t)dataTypeSize(cached_input->getDataType().value());
+    if (byte_size == 4 || byte_size == 8 || byte_size == 16) {
+      circular_buffered_tvs.insert(cached_input);
+    }
+  }
+
+  std::vector<TensorView*> other_tvs;
+  for (auto tv : ir_utils::allTvs(fusion)) {
+    if (circular_buffered_tvs.count(tv) == 0) {
+      other_tvs.push_back(tv);
+    }
+  }
+  inlineMost(other_tvs);
+  if (circular_buffered_tvs.empty()) {
+    return;
+  }
+
+  // Load a whole iteration of the serial loop at a time
+  inlineSelectedAt(circular_buffered_tvs, reference_tv, serial_pos + 1, true);
+  for (auto tv : circular_buffered_tvs) {
+    if (tv->nDims() != reference_tv->nDims() ||
+        (int)tv->getComputeAtPosition() != serial_pos + 1) {
+      inlineMost(std::vector<TensorView*>{tv});
+      continue;
+    }
+    auto producer = tv->definition()->input(0)->as<TensorView>();
+    fusion->removeExpr(tv->definition());
+    IrBuilder::create<LoadStoreOp>(LoadStoreOpType::CpAsyncCa, tv, producer);
+    tv->setMemoryType(MemoryType::Shared);
+    tv->circularBuffer((unsigned int)rparams.circular_buffer_stages);
+  }
+}
+
+// Inline the schedule, loading the cached inputs a whole iteration of the
+// serial reduction loop at a time and rotating the loop over those loads.
+// See Note [ Rotated serial reduction loop ] in reduction.cpp
+void inlineWithRotatedInputs(
+    Fusion* fusion,
+    TensorView* reference_tv,
+    const std::vector<TensorView*>& cached_inputs) {
+  const int serial_pos = serialReductionLoopPosition(reference_tv);
+
+  std::unordered_set<TensorView*> rotated_tvs;
+  for (auto cached_input : cached_inputs) {
+    auto def = cached_input->definition();
+    if (serial_pos < 0 || cached_input->nDims() != reference_tv->nDims() ||
+        cached_input->getMemoryType() != MemoryType::Local ||
+        !def->isA<UnaryOp>() ||
+        def->as<UnaryOp>()->getUnaryOpType() != UnaryOpType::Set) {
+      continue;
+    }
+    rotated_tvs.insert(cached_input);
+  }
+
+  std::vector<TensorView*> other_tvs;
+  for (auto tv : ir_utils::allTvs(fusion)) {
+    if (rotated_tvs.count(tv) == 0) {
+      other_tvs.push_back(tv);
+    }
+  }
+  inlineMost(other_tvs);
+  if (rotated_tvs.empty()) {
+    return;
+  }
+
+  inlineSelectedAt(rotated_tvs, reference_tv, serial_pos + 1, true);
+  std::unordered_set<Statement*> selection;
+  for (auto tv : rotated_tvs) {
+    if ((int)tv->getComputeAtPosition() != serial_pos + 1) {
+      inlineMost(std::vector<TensorView*>{tv});
+      continue;
+    }
+    selection.insert(tv);
+  }
+
+  if (!selection.empty()) {
+    scheduler_utils::rotateLoop(
+        reference_tv, serial_pos, std::move(selection), true);
+  }
+}
+
+// Schedule the transposed outputs to be written from a shared memory tile
+// per iteration of the serial reduction loop, with their innermost dimension
+// across the threads of the block. See
+// Note [ Staging transposed outputs of reductions ] in reduction.cpp
+void stageTransposedOutputs(
+    TensorView* reference_tv,
+    const std::vector<std::pair<TensorView*, TensorView*>>& cached_outputs) {
+  const int serial_pos = serialReductionLoopPosition(reference_tv);
+  if (serial_pos < 0) {
+    return;
+  }
+
+  // Thread dimensions of the tile, innermost first
+  std::vector<ParallelType> tile_ptypes;
+  for (auto ptype :
+       {ParallelType::TIDx, ParallelType::TIDy, ParallelType::TIDz}) {
+    if (std::any_of(
+            reference_tv->domain()->domain().begin() + serial_pos + 1,
+            reference_tv->domain()->domain().end(),
+            [ptype](IterDomain* id) { return id->getParallelType() == ptype; })) {
+      tile_ptypes.push_back(ptype);
+    }
+  }
+  if (tile_ptypes.empty()) {
+    return;
+  }
+
+  const auto transposed_outputs = getTransposedOutputs(reference_tv);
+
+  for (const auto& cached_output : cached_outputs) {
+    auto cached_tv = cached_output.first;
+    auto output = cached_output.second;
+    if (output->nDims() != reference_tv->nDims() ||
+        std::find(
+            transposed_outputs.begin(), transposed_outputs.end(), output) ==
+            transposed_outputs.end()) {
+      continue;
+    }
+
+    // Order the tile with the axes covering the innermost dimension of the
+    // output last. Axes mixing it with other dimensions can't be written
+    // contiguously, so such outputs are left as they are.
+    auto inner_most_id = scheduler_utils::innerMostRootDim(output);
+    const auto& rfactor_dom = output->getMaybeRFactorDomain();
+    std::vector<int> outer_tile_axes;
+    std::vector<int> inner_tile_axes;
+    bool can_stage = true;
+    for (const auto i : c10::irange(serial_pos + 1, (int)output->nDims())) {
+      auto inputs = IterVisitor::getInputsTo(
+          {output->axis(i)}, {rfactor_dom.begin(), rfactor_dom.end()});
+      if (std::find(inputs.begin(), inputs.end(), inner_most_id) ==
+          inputs.end()) {
+        outer_tile_axes.push_back(i);
+      } else if (inputs.size() == 1) {
+        inner_tile_axes.push_back(i);
+      } else {
+        can_stage = false;
+      }
+    }
+    if (!can_stage || inner_tile_axes.empty()) {
+      continue;
+    }
+
+    std::unordered_map<int, int> old2new;
+    int new_pos = serial_pos + 1;
+    for (auto axis : outer_tile_axes) {
+      old2new[axis] = new_pos++;
+    }
+    for (auto axis : inner_tile_axes) {
+      old2new[axis] = new_pos++;
+    }
+    for (const auto i : c10::irange(serial_pos + 1, (int)output->nDims())) {
+      output->axis(i)->parallelize(ParallelType::Serial);
+    }
+    output->reorder(old2new);
+
+    // [..., serial, tile] -> [..., serial, tile / threads, TIDz, TIDy, TIDx]
+    while ((int)output->nDims() > serial_pos + 2) {
+      output->merge(serial_pos + 1);
+    }
+    for (auto ptype : tile_ptypes) {
+      output->split(serial_pos + 1, NamedScalar::getParallelDim(ptype));
+      output->axis(serial_pos + 2)->parallelize(ptype);
+    }
+
+    cached_tv->setMemoryType(MemoryType::Shared);
+  }
+}
+
+} // namespace
+
 void multiReductionInliner(
     Fusion* fusion,
     const ReductionParams& rparams,
@@ -468,6 +690,13 @@ void multiReductionInliner(
 
     std::vector<TensorView*> rfactor_and_reduction_tvs = {
         reference_tv, reduction_tv};
+    // The accumulators are combined by a second rfactor between the
+    // reference and reduction_tv, see Note [ Multiple serial accumulators ]
+    if (rparams.multiple_serial_accumulators &&
+        reduction_tv->definition()->input(0) != reference_tv) {
+      rfactor_and_reduction_tvs.push_back(
+          reduction_tv->definition()->input(0)->as<TensorView>());
+    }
     // If reference shouldn't be unrolled, clear that parallel type.
     // In the case of outer grid persistence, replace Vector with Group
     for (auto tv : rfactor_and_reduction_tvs) {
@@ -509,13 +738,24 @@ void multiReductionInliner(
     }
   }
 
+  if (rparams.stage_transposed_outputs) {
+    stageTransposedOutputs(reference_tv, cached_outputs);
+  }
+
   // Remove dummy outputs as they can inadvertently affect CA positions
   for (auto output : dummy_outputs) {
     fusion->removeOutput(output);
   }
 
   // Inline the schedule
-  inlineMost();
+  if (rparams.circular_buffer_stages > 1) {
+    inlineWithCircularBufferedInputs(
+        fusion, rparams, reference_tv, cached_inputs);
+  } else if (rparams.rotate_serial_reduction_loop) {
+    inlineWithRotatedInputs(fusion, reference_tv, cached_inputs);
+  } else {
+    inlineMost();
+  }
 }
 
 namespace {
@@ -612,9 +852,15 @@ struct id_lt {
     return idPos(id0) < idPos(id1);
   }
 };
-} // namespace
 
-TensorView* sortAndRFactor(TensorView* reference_tv) {
+bool isUnrolledOrVectorized(const IterDomain* id) {
+  return id->getParallelType() == ParallelType::Unroll ||
+      id->getParallelType() == ParallelType::Vectorize ||
+      id->getParallelType() == ParallelType::MisalignedVectorize;
+}
+
+// Reorder the axes of reference_tv in the order of id_lt
+void sortAxes(TensorView* reference_tv) {
   auto domain = reference_tv->domain()->domain();
   std::sort(domain.begin(), domain.end(), id_lt());
   std::unordered_map<int, int> reorder_map;
@@ -631,6 +877,12 @@ TensorView* sortAndRFactor(TensorView* reference_tv) {
     reorder_map[old_i] = new_i;
   }
   reference_tv->reorder(reorder_map);
+}
+
+} // namespace
+
+TensorView* sortAndRFactor(TensorView* reference_tv) {
+  sortAxes(reference_tv);
 
   std::vector<int> rfactor_axes;
   std::vector<int> rfactor_axes_no_unswitch;
@@ -663,6 +915,97 @@ TensorView* sortAndRFactor(TensorView* reference_tv) {
   return ir_utils::rfactorHelper(reference_tv, rfactor_axes);
 }
 
+// Note [ Multiple serial accumulators ]
+//
+// A non-persistent inner reduction is sorted to
+//
+//   [..., rS, rTIDx, rUS, rU]
+//
+// with rS the serial loop, rUS the unswitch and rU the unrolled or vectorized
+// elements of each iteration. sortAndRFactor rfactors {rS, rUS, rU}, so all
+// the elements a thread reduces are accumulated into a single register and
+// each addition waits for the previous one. When the serial loop is long,
+// this dependency chain bounds the throughput of the kernel rather than its
+// loads. Instead, rS and rUS are rfactored first:
+//
+//   T_acc[..., rS, TIDx, rUS, U] -> T_comb[..., TIDx, rU] -> T[..., rTIDx]
+//
+// T_acc keeps one accumulator per unrolled element, each updated
+// independently in the serial loop, and T_comb adds them up once the loop is
+// done, before the block reduction. T_acc is returned as the reference, whose
+// U axis is constant sized and thus still unrolled once the inliner makes
+// it serial.
+TensorView* sortAndRFactorSerialAccumulators(TensorView* reference_tv) {
+  sortAxes(reference_tv);
+
+  std::vector<int> serial_axes;
+  for (int axis_i = 0; axis_i < (int)reference_tv->nDims(); axis_i++) {
+    auto id = reference_tv->axis(axis_i);
+    if (id->isReduction() && !id->isThread() && !isUnrolledOrVectorized(id)) {
+      serial_axes.emplace_back(axis_i);
+    }
+  }
+  TORCH_INTERNAL_ASSERT(
+      !serial_axes.empty(),
+      "Multiple serial accumulators require a serial reduction loop in ",
+      reference_tv->toString());
+  auto accumulators_tv = ir_utils::rfactorHelper(reference_tv, serial_axes);
+
+  // Combine the accumulators before any parallel reduction of reference_tv
+  std::vector<int> accumulator_axes;
+  bool has_thread_reduction = false;
+  for (int axis_i = 0; axis_i < (int)reference_tv->nDims(); axis_i++) {
+    auto id = reference_tv->axis(axis_i);
+    if (!id->isReduction()) {
+      continue;
+    }
+    if (isUnrolledOrVectorized(id)) {
+      accumulator_axes.emplace_back(axis_i);
+    } else if (id->isThread()) {
+      has_thread_reduction = true;
+    }
+  }
+  if (has_thread_reduction && !accumulator_axes.empty()) {
+    ir_utils::rfactorHelper(reference_tv, accumulator_axes);
+  }
+
+  return accumulators_tv;
+}
+
+std::vector<TensorView*> getTransposedOutputs(TensorView* reduction_tv) {
+  const auto inner_dim_tvs =
+      scheduler_utils::getInputsOutputsWithInnerDim(reduction_tv, true, false);
+  std::vector<TensorView*> transposed_outputs;
+  for (auto output :
+       ir_utils::filterByType<TensorView>(reduction_tv->fusion()->outputs())) {
+    if (output->hasReduction() ||
+        scheduler_utils::innerMostRootDim(output) == nullptr ||
+        std::find(inner_dim_tvs.begin(), inner_dim_tvs.end(), output) !=
+            inner_dim_tvs.end()) {
+      continue;
+    }
+    transposed_outputs.push_back(output);
+  }
+  return transposed_outputs;
+}
+
+void hoistSerialReductionLoop(TensorView* reference_tv) {
+  int hoisted_pos = 0;
+  while (hoisted_pos < (int)reference_tv->nDims() &&
+         reference_tv->axis(hoisted_pos)->isBlockDim()) {
+    hoisted_pos++;
+  }
+  for (const auto i : c10::irange(hoisted_pos, (int)reference_tv->nDims())) {
+    auto id = reference_tv->axis(i);
+    if (id->isReduction() && id->getParallelType() == ParallelType::Serial) {
+      if (i > hoisted_pos) {
+        reference_tv->reorder({{i, hoisted_pos}});
+      }
+      return;
+    }
+  }
+}
+
 std::vector<TensorView*> projectPersistentBuffers(Fusion* fusion) {
   auto persistent_info = scheduler_utils::persistentBuffers(fusion);
   std::vector<TensorView*> dummy_outputs;
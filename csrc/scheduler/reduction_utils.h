@@ -48,6 +48,25 @@ TORCH_CUDA_CU_API void multiReductionInliner(
 // Reduction inliner expects an rfactored domain.
 TORCH_CUDA_CU_API TensorView* sortAndRFactor(TensorView* reference_tv);
 
+// Sort as sortAndRFactor, but rfactor the serial and the unrolled reduction
+// axes separately so that each unrolled element is accumulated into its own
+// register. Returns the rfactor tensor of the serial axes.
+// See Note [ Multiple serial accumulators ] in reduction_utils.cpp
+TORCH_CUDA_CU_API TensorView* sortAndRFactorSerialAccumulators(
+    TensorView* reference_tv);
+
+// Outputs that aren't reductions and whose innermost dimension isn't mapped
+// to the innermost dimension of reduction_tv, e.g., a transposed copy of the
+// input of an outer reduction.
+TORCH_CUDA_CU_API std::vector<TensorView*> getTransposedOutputs(
+    TensorView* reduction_tv);
+
+// Move the serial reduction loop of the rfactored reference right inside its
+// grid parallelized loops, so that an iteration of it covers a tile of the
+// whole block. See Note [ Staging transposed outputs of reductions ] in
+// reduction.cpp
+TORCH_CUDA_CU_API void hoistSerialReductionLoop(TensorView* reference_tv);
+
 // Take all projectable persistent buffers, and move them to the inputs. This
 // function create dummy outputs which should be used in later stages of the
 // scheduling.
@@ -6,6 +6,7 @@
  */
 // clang-format on
 #include <c10/util/irange.h>
+#include <device_profile.h>
 #include <disjoint_set.h>
 #include <executor_utils.h>
 #include <expr_evaluator.h>
@@ -21,8 +22,7 @@
 #include <scheduler/utils.h>
 
 #include <limits>
-
-#include <ATen/cuda/CUDAContext.h>
+#include <type_traits>
 
 namespace nvfuser {
 
@@ -66,10 +66,60 @@ bool rejectScheduleForSelectLikeOps(
     Fusion* fusion,
     ScheduleHeuristic schedule_strategy) {
   for (auto expr : fusion->exprs()) {
-    if (expr->isOneOf<SelectOp, IndexSelectOp, TorchGatherOp>() &&
+    if (expr->isOneOf<SelectOp, IndexSelectOp, TorchGatherOp, ScatterOp>() &&
         rejectScheduleFusionInputRequirement(expr, schedule_strategy)) {
       return true;
     }
+    // Only the outputs of a kernel get self copied in before the launch, so
+    // the segmenter must cut after a scatter, see Note [ Scatter outputs ]
+    if (expr->isA<ScatterOp>()) {
+      auto out = expr->output(0);
+      if (!out->isFusionOutput() || !out->uses().empty()) {
+        scheduler_debug_utils::canScheduleRejectReason(
+            schedule_strategy,
+            "Output of ",
+            expr->getOpString(),
+            " must be a fusion output without uses.");
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+//! Mma ops can only be scheduled by the matmul and attention schedulers
+bool rejectScheduleForMmaOps(
+    Fusion* fusion,
+    ScheduleHeuristic schedule_strategy) {
+  for (auto expr : fusion->exprs()) {
+    if (expr->isA<MmaOp>()) {
+      scheduler_debug_utils::canScheduleRejectReason(
+          schedule_strategy,
+          "mma ops are only supported by matmul and attention schedulers");
+      return true;
+    }
+  }
+  return false;
+}
+
+bool rejectScheduleForScanOps(
+    Fusion* fusion,
+    ScheduleHeuristic schedule_strategy) {
+  if (!ir_utils::getScanOps(fusion).empty()) {
+    scheduler_debug_utils::canScheduleRejectReason(
+        schedule_strategy, "scan ops are only supported by scan scheduler");
+    return true;
+  }
+  return false;
+}
+
+bool rejectScheduleForShiftOps(
+    Fusion* fusion,
+    ScheduleHeuristic schedule_strategy) {
+  if (!ir_utils::getShiftOps(fusion).empty()) {
+    scheduler_debug_utils::canScheduleRejectReason(
+        schedule_strategy, "shift ops are only supported by stencil scheduler");
+    return true;
   }
   return false;
 }
@@ -790,6 +840,7 @@ void SchedulerRuntimeInfo::initialize(
     initializeExpressionEvaluator(args);
   }
   index_mode_ = args.getIndexMode();
+  canonical_sizes_ = args.hasCanonicalSizes();
 }
 
 SchedulerRuntimeInfo::SchedulerRuntimeInfo(
@@ -1275,6 +1326,18 @@ class ReductionScheduler : public SchedulerEntry {
       return false;
     }
 
+    if (rejectScheduleForMmaOps(fusion, ScheduleHeuristic::Reduction)) {
+      return false;
+    }
+
+    if (rejectScheduleForScanOps(fusion, ScheduleHeuristic::Reduction)) {
+      return false;
+    }
+
+    if (rejectScheduleForShiftOps(fusion, ScheduleHeuristic::Reduction)) {
+      return false;
+    }
+
     auto reduction_tvs = scheduler_utils::getReductionTvs(fusion);
 
     if (reduction_tvs.size() == 0) {
@@ -1431,6 +1494,18 @@ class TransposeScheduler : public SchedulerEntry {
       return false;
     }
 
+    if (rejectScheduleForMmaOps(fusion, ScheduleHeuristic::Transpose)) {
+      return false;
+    }
+
+    if (rejectScheduleForScanOps(fusion, ScheduleHeuristic::Transpose)) {
+      return false;
+    }
+
+    if (rejectScheduleForShiftOps(fusion, ScheduleHeuristic::Transpose)) {
+      return false;
+    }
+
     for (auto select : ir_utils::getSelectOps(fusion)) {
       auto root = TensorDomain::noReductions(
           select->input(0)->as<TensorView>()->getMaybeRFactorDomain());
@@ -1521,6 +1596,341 @@ class TransposeScheduler : public SchedulerEntry {
   }
 };
 
+class IndexSelectScheduler : public SchedulerEntry {
+ public:
+  explicit IndexSelectScheduler(
+      Fusion* fusion,
+      SchedulerRuntimeInfo& runtime_info,
+      HeuristicSummary* data_cache = nullptr)
+      : SchedulerEntry(ScheduleHeuristic::IndexSelect) {
+    computeHeuristics(fusion, runtime_info, data_cache);
+  }
+
+  static bool canScheduleCompileTime(Fusion* fusion) {
+    if (isOptionDisabled(DisableOption::IndexSelectScheduler)) {
+      scheduler_debug_utils::canScheduleRejectReason(
+          ScheduleHeuristic::IndexSelect, "disabled");
+      return false;
+    }
+
+    // Check that inputs of all select/gather-like ops are fusion inputs
+    if (rejectScheduleForSelectLikeOps(
+            fusion, ScheduleHeuristic::IndexSelect)) {
+      return false;
+    }
+
+    if (rejectScheduleForMmaOps(fusion, ScheduleHeuristic::IndexSelect)) {
+      return false;
+    }
+
+    if (rejectScheduleForScanOps(fusion, ScheduleHeuristic::IndexSelect)) {
+      return false;
+    }
+
+    if (rejectScheduleForShiftOps(fusion, ScheduleHeuristic::IndexSelect)) {
+      return false;
+    }
+
+    if (!ir_utils::getReductionOps(fusion).empty()) {
+      scheduler_debug_utils::canScheduleRejectReason(
+          ScheduleHeuristic::IndexSelect, "no support for reduction ops");
+      return false;
+    }
+
+    if (hasNonUniqueBcast(fusion)) {
+      scheduler_debug_utils::canScheduleRejectReason(
+          ScheduleHeuristic::IndexSelect,
+          "Broadcasting dimension might be broadcasting to multiple sizes.");
+      return false;
+    }
+
+    auto reason = getIndexSelectCompileTimeRejectReason(fusion);
+    if (!reason.empty()) {
+      scheduler_debug_utils::canScheduleRejectReason(
+          ScheduleHeuristic::IndexSelect, reason);
+      return false;
+    }
+    return true;
+  }
+
+  static bool canScheduleRunTime(
+      Fusion* fusion,
+      SchedulerRuntimeInfo& runtime_info,
+      HeuristicSummary* data_cache = nullptr) {
+    FUSER_PERF_SCOPE("IndexSelectScheduler::canScheduleRunTime");
+
+    auto reason = getIndexSelectRuntimeRejectReason(fusion, runtime_info);
+    if (!reason.empty()) {
+      scheduler_debug_utils::canScheduleRejectReason(
+          ScheduleHeuristic::IndexSelect, reason);
+      return false;
+    }
+    return true;
+  }
+
+  void schedule(Fusion* fusion) override {
+    FUSER_PERF_SCOPE("Schedule IndexSelect Fusion");
+    scheduleIndexSelect(fusion, indexSelectParams());
+  }
+
+ private:
+  void computeHeuristics(
+      Fusion* fusion,
+      SchedulerRuntimeInfo& runtime_info,
+      HeuristicSummary* data_cache = nullptr) {
+    params_ = getIndexSelectHeuristics(fusion, runtime_info, data_cache);
+    TORCH_INTERNAL_ASSERT(params_ != nullptr);
+  }
+};
+
+class ScanScheduler : public SchedulerEntry {
+ public:
+  explicit ScanScheduler(
+      Fusion* fusion,
+      SchedulerRuntimeInfo& runtime_info,
+      HeuristicSummary* data_cache = nullptr)
+      : SchedulerEntry(ScheduleHeuristic::Scan) {
+    computeHeuristics(fusion, runtime_info, data_cache);
+  }
+
+  static bool canScheduleCompileTime(Fusion* fusion) {
+    if (isOptionDisabled(DisableOption::ScanScheduler)) {
+      scheduler_debug_utils::canScheduleRejectReason(
+          ScheduleHeuristic::Scan, "disabled");
+      return false;
+    }
+
+    if (rejectScheduleForMmaOps(fusion, ScheduleHeuristic::Scan)) {
+      return false;
+    }
+
+    if (rejectScheduleForShiftOps(fusion, ScheduleHeuristic::Scan)) {
+      return false;
+    }
+
+    if (!ir_utils::getReductionOps(fusion).empty()) {
+      scheduler_debug_utils::canScheduleRejectReason(
+          ScheduleHeuristic::Scan, "no support for reduction ops");
+      return false;
+    }
+
+    if (hasNonUniqueBcast(fusion)) {
+      scheduler_debug_utils::canScheduleRejectReason(
+          ScheduleHeuristic::Scan,
+          "Broadcasting dimension might be broadcasting to multiple sizes.");
+      return false;
+    }
+
+    auto reason = getScanCompileTimeRejectReason(fusion);
+    if (!reason.empty()) {
+      scheduler_debug_utils::canScheduleRejectReason(
+          ScheduleHeuristic::Scan, reason);
+      return false;
+    }
+    return true;
+  }
+
+  static bool canScheduleRunTime(
+      Fusion* fusion,
+      SchedulerRuntimeInfo& runtime_info,
+      HeuristicSummary* data_cache = nullptr) {
+    return true;
+  }
+
+  void schedule(Fusion* fusion) override {
+    FUSER_PERF_SCOPE("Schedule Scan Fusion");
+    scheduleScan(fusion, scanParams());
+  }
+
+ private:
+  void computeHeuristics(
+      Fusion* fusion,
+      SchedulerRuntimeInfo& runtime_info,
+      HeuristicSummary* data_cache = nullptr) {
+    params_ = getScanHeuristics(fusion, runtime_info, data_cache);
+    TORCH_INTERNAL_ASSERT(params_ != nullptr);
+  }
+};
+
+class AttentionScheduler : public SchedulerEntry {
+ public:
+  explicit AttentionScheduler(
+      Fusion* fusion,
+      SchedulerRuntimeInfo& runtime_info,
+      HeuristicSummary* data_cache = nullptr)
+      : SchedulerEntry(ScheduleHeuristic::Attention) {
+    computeHeuristics(fusion, runtime_info, data_cache);
+  }
+
+  static bool canScheduleCompileTime(Fusion* fusion) {
+    if (isOptionDisabled(DisableOption::AttentionScheduler)) {
+      scheduler_debug_utils::canScheduleRejectReason(
+          ScheduleHeuristic::Attention, "disabled");
+      return false;
+    }
+
+    // Mma ops of the attention pattern are translated when scheduling, see
+    // Note [ Attention scheduling ]
+    if (rejectScheduleForScanOps(fusion, ScheduleHeuristic::Attention)) {
+      return false;
+    }
+
+    if (rejectScheduleForShiftOps(fusion, ScheduleHeuristic::Attention)) {
+      return false;
+    }
+
+    if (hasNonUniqueBcast(fusion)) {
+      scheduler_debug_utils::canScheduleRejectReason(
+          ScheduleHeuristic::Attention,
+          "Broadcasting dimension might be broadcasting to multiple sizes.");
+      return false;
+    }
+
+    auto reason = getAttentionCompileTimeRejectReason(fusion);
+    if (!reason.empty()) {
+      scheduler_debug_utils::canScheduleRejectReason(
+          ScheduleHeuristic::Attention, reason);
+      return false;
+    }
+    return true;
+  }
+
+  static bool canScheduleRunTime(
+      Fusion* fusion,
+      SchedulerRuntimeInfo& runtime_info,
+      HeuristicSummary* data_cache = nullptr) {
+    FUSER_PERF_SCOPE("AttentionScheduler::canScheduleRunTime");
+
+    auto reason = getAttentionRuntimeRejectReason(fusion, runtime_info);
+    if (!reason.empty()) {
+      scheduler_debug_utils::canScheduleRejectReason(
+          ScheduleHeuristic::Attention, reason);
+      return false;
+    }
+    return true;
+  }
+
+  void schedule(Fusion* fusion) override {
+    FUSER_PERF_SCOPE("Schedule Attention Fusion");
+    scheduleAttention(fusion, attentionParams());
+  }
+
+ private:
+  void computeHeuristics(
+      Fusion* fusion,
+      SchedulerRuntimeInfo& runtime_info,
+      HeuristicSummary* data_cache = nullptr) {
+    params_ = getAttentionHeuristics(fusion, runtime_info, data_cache);
+    TORCH_INTERNAL_ASSERT(params_ != nullptr);
+  }
+};
+
+class StencilScheduler : public SchedulerEntry {
+ public:
+  explicit StencilScheduler(
+      Fusion* fusion,
+      SchedulerRuntimeInfo& runtime_info,
+      HeuristicSummary* data_cache = nullptr)
+      : SchedulerEntry(ScheduleHeuristic::Stencil) {
+    computeHeuristics(fusion, runtime_info, data_cache);
+  }
+
+  static bool canScheduleCompileTime(Fusion* fusion) {
+    if (isOptionDisabled(DisableOption::StencilScheduler)) {
+      scheduler_debug_utils::canScheduleRejectReason(
+          ScheduleHeuristic::Stencil, "disabled");
+      return false;
+    }
+
+    auto reason = getStencilCompileTimeRejectReason(fusion);
+    if (!reason.empty()) {
+      scheduler_debug_utils::canScheduleRejectReason(
+          ScheduleHeuristic::Stencil, reason);
+      return false;
+    }
+    return true;
+  }
+
+  static bool canScheduleRunTime(
+      Fusion* fusion,
+      SchedulerRuntimeInfo& runtime_info,
+      HeuristicSummary* data_cache = nullptr) {
+    return true;
+  }
+
+  void schedule(Fusion* fusion) override {
+    FUSER_PERF_SCOPE("Schedule Stencil Fusion");
+    scheduleStencil(fusion, stencilParams());
+  }
+
+ private:
+  void computeHeuristics(
+      Fusion* fusion,
+      SchedulerRuntimeInfo& runtime_info,
+      HeuristicSummary* data_cache = nullptr) {
+    params_ = getStencilHeuristics(fusion, runtime_info, data_cache);
+    TORCH_INTERNAL_ASSERT(params_ != nullptr);
+  }
+};
+
+class MatmulScheduler : public SchedulerEntry {
+ public:
+  explicit MatmulScheduler(
+      Fusion* fusion,
+      SchedulerRuntimeInfo& runtime_info,
+      HeuristicSummary* data_cache = nullptr)
+      : SchedulerEntry(ScheduleHeuristic::Matmul) {
+    computeHeuristics(fusion, runtime_info, data_cache);
+  }
+
+  static bool canScheduleCompileTime(Fusion* fusion) {
+    if (rejectScheduleForScanOps(fusion, ScheduleHeuristic::Matmul)) {
+      return false;
+    }
+
+    if (rejectScheduleForShiftOps(fusion, ScheduleHeuristic::Matmul)) {
+      return false;
+    }
+
+    auto reason = getMatmulCompileTimeRejectReason(fusion);
+    if (!reason.empty()) {
+      scheduler_debug_utils::canScheduleRejectReason(
+          ScheduleHeuristic::Matmul, reason);
+      return false;
+    }
+    return true;
+  }
+
+  static bool canScheduleRunTime(
+      Fusion* fusion,
+      SchedulerRuntimeInfo& runtime_info,
+      HeuristicSummary* data_cache = nullptr) {
+    FUSER_PERF_SCOPE("MatmulScheduler::canScheduleRunTime");
+
+    auto reason = getMatmulRunTimeRejectReason(fusion, runtime_info);
+    if (!reason.empty()) {
+      scheduler_debug_utils::canScheduleRejectReason(
+          ScheduleHeuristic::Matmul, reason);
+      return false;
+    }
+    return true;
+  }
+
+  void schedule(Fusion* fusion) override {
+    FUSER_PERF_SCOPE("Schedule Matmul Fusion");
+    scheduleMatmul(fusion, matmulParams());
+  }
+
+ private:
+  void computeHeuristics(
+      Fusion* fusion,
+      SchedulerRuntimeInfo& runtime_info,
+      HeuristicSummary* data_cache = nullptr) {
+    params_ = getMatmulHeuristics(fusion, runtime_info, data_cache);
+    TORCH_INTERNAL_ASSERT(params_ != nullptr);
+  }
+};
+
 class PointWiseScheduler : public SchedulerEntry {
  public:
   explicit PointWiseScheduler(
@@ -1535,7 +1945,9 @@ class PointWiseScheduler : public SchedulerEntry {
     //   Currently using the same path as the scheduler
     // to eliminate mismatch between canSchedule and
     // schedule pointwise.
-    if (!hasReferenceTensorView(fusion)) {
+    if (!hasReferenceTensorView(fusion) &&
+        (!isOptionEnabled(EnableOption::HorizontalPointwise) ||
+         getHorizontalReferenceTensorViews(fusion).empty())) {
       scheduler_debug_utils::canScheduleRejectReason(
           ScheduleHeuristic::PointWise, "cannot find reference tensor");
       return false;
@@ -1546,6 +1958,18 @@ class PointWiseScheduler : public SchedulerEntry {
       return false;
     }
 
+    if (rejectScheduleForMmaOps(fusion, ScheduleHeuristic::PointWise)) {
+      return false;
+    }
+
+    if (rejectScheduleForScanOps(fusion, ScheduleHeuristic::PointWise)) {
+      return false;
+    }
+
+    if (rejectScheduleForShiftOps(fusion, ScheduleHeuristic::PointWise)) {
+      return false;
+    }
+
     if (ir_utils::getViewOps(fusion).size() > 0) {
       ComputeAtMap ca_map(fusion);
       if (requiresForwardViewReplay(fusion, ca_map)) {
@@ -1581,7 +2005,9 @@ class PointWiseScheduler : public SchedulerEntry {
     auto can_schedule_transpose_entry =
         HeuristicSummaryEntry<HeuristicCompileTime::CanScheduleTranspose>(
             data_cache, [fusion]() {
+              // See Note [ Horizontal pointwise fusion ]
               return std::make_unique<bool>(
+                  isConnectedFusionGraph(fusion) &&
                   TransposeScheduler::canScheduleCompileTime(fusion));
             });
     if (can_schedule_transpose_entry.get()) {
@@ -1636,6 +2062,18 @@ class PersistentKernelScheduler : public SchedulerEntry {
       return false;
     }
 
+    if (rejectScheduleForMmaOps(fusion, ScheduleHeuristic::Persistent)) {
+      return false;
+    }
+
+    if (rejectScheduleForScanOps(fusion, ScheduleHeuristic::Persistent)) {
+      return false;
+    }
+
+    if (rejectScheduleForShiftOps(fusion, ScheduleHeuristic::Persistent)) {
+      return false;
+    }
+
     if (hasNonUniqueBcast(fusion)) {
       scheduler_debug_utils::canScheduleRejectReason(
           ScheduleHeuristic::Persistent,
@@ -1779,12 +2217,14 @@ class PersistentKernelScheduler : public SchedulerEntry {
               persistent_buffer_size_info.persistent_buffer_size,
               persistent_buffer_size_info.projected_persistent_buffer_size);
 
-    const int64_t device_multiprocessor_count =
-        (int64_t)at::cuda::getCurrentDeviceProperties()->multiProcessorCount;
+    const int64_t device_multiprocessor_count = scheduler_utils::numSMs();
 
     // TODO: Enable grid persistence
-    const auto available_persistent_buffer_size =
-        scheduler_utils::register_file_size;
+    // Buffers that don't fit in registers can be staged in shared memory,
+    // see Note [ Shared memory persistent buffers ]
+    const auto available_persistent_buffer_size = std::max(
+        scheduler_utils::register_file_size,
+        scheduler_utils::smemPersistentBufferSize());
 
     if (persistent_buffer_size > available_persistent_buffer_size) {
       scheduler_debug_utils::canScheduleRejectReason(
@@ -1793,10 +2233,9 @@ class PersistentKernelScheduler : public SchedulerEntry {
     }
 
     const int64_t device_max_threads_per_multiprocessor =
-        (int64_t)at::cuda::getCurrentDeviceProperties()
-            ->maxThreadsPerMultiProcessor;
+        getCurrentDeviceProfile().max_threads_per_sm;
 
-    const int64_t warp_size = at::cuda::warp_size();
+    const int64_t warp_size = getCurrentDeviceProfile().warp_size;
 
     // Maximum number of iteration dimensions we can have and still be
     // persistent.
@@ -1865,10 +2304,10 @@ class PersistentKernelScheduler : public SchedulerEntry {
     FUSER_PERF_SCOPE("PersistentKernelScheduler::canScheduleRuntimeOuter");
     FusionGuard fg(fusion);
 
-    const auto device_prop = at::cuda::getCurrentDeviceProperties();
+    const auto& device_prop = getCurrentDeviceProfile();
 
     const int64_t sm_register_file_size =
-        static_cast<int64_t>(device_prop->regsPerBlock * sizeof(int));
+        static_cast<int64_t>(device_prop.regs_per_block * sizeof(int));
 
     auto persistent_buffer_info_entry =
         HeuristicSummaryEntry<HeuristicCompileTime::PersistentBufferInfo>(
@@ -1890,8 +2329,7 @@ class PersistentKernelScheduler : public SchedulerEntry {
               persistent_buffer_size_info.persistent_buffer_size,
               persistent_buffer_size_info.projected_persistent_buffer_size);
 
-    const int64_t device_multiprocessor_count =
-        (int64_t)device_prop->multiProcessorCount;
+    const int64_t device_multiprocessor_count = scheduler_utils::numSMs();
 
     const auto available_persistent_buffer_size =
         sm_register_file_size * device_multiprocessor_count;
@@ -2005,7 +2443,7 @@ class PersistentKernelScheduler : public SchedulerEntry {
     }
 
     const int64_t device_max_threads_per_multiprocessor =
-        (int64_t)device_prop->maxThreadsPerMultiProcessor;
+        device_prop.max_threads_per_sm;
     const int64_t min_fraction_of_sms =
         scheduler_utils::safeDiv(device_multiprocessor_count, 8);
     if (properties.total_reduction_numel >=
@@ -2019,18 +2457,28 @@ class PersistentKernelScheduler : public SchedulerEntry {
     // The runtime kernel for grouped normal grid reductions is not
     // well tuned, and it turned out to be quite difficult to get
     // consistently better performances than non-persistent
-    // schedules. Disabled for now.
-    // TODO: Enable non-welford persistent reductions
-    if (is_cross_grid &&
-        std::any_of(
-            reduction_tvs.begin(),
-            reduction_tvs.end(),
-            [](TensorView* reduction_tv) {
-              return !reduction_tv->definition()->isA<WelfordOp>();
-            })) {
-      scheduler_debug_utils::canScheduleRejectReason(
-          ScheduleHeuristic::Persistent, "non-Welford not enabled yet");
-      return false;
+    // schedules. Disabled by default, see Note [ Grid persistent
+    // normal reductions ].
+    const auto num_welford_tvs = std::count_if(
+        reduction_tvs.begin(),
+        reduction_tvs.end(),
+        [](TensorView* reduction_tv) {
+          return reduction_tv->definition()->isA<WelfordOp>();
+        });
+    if (is_cross_grid && num_welford_tvs != (int64_t)reduction_tvs.size()) {
+      if (!isOptionEnabled(EnableOption::GridPersistentReductions)) {
+        scheduler_debug_utils::canScheduleRejectReason(
+            ScheduleHeuristic::Persistent, "non-Welford not enabled yet");
+        return false;
+      }
+      // Welford and normal reductions can't be grouped together, and
+      // each ungrouped grid reduction adds a grid synchronization
+      if (num_welford_tvs != 0) {
+        scheduler_debug_utils::canScheduleRejectReason(
+            ScheduleHeuristic::Persistent,
+            "mixed Welford and non-Welford grid reductions");
+        return false;
+      }
     }
 
     // Had a hard time tuning on Titan RTX and V100 when the iteration
@@ -2044,7 +2492,7 @@ class PersistentKernelScheduler : public SchedulerEntry {
              (vectorization_factor * cross_grid_params->launch_params.bdimx() *
               cross_grid_params->launch_params.gdimx()) !=
          0) &&
-        device_prop->major == 7) {
+        device_prop.major == 7) {
       scheduler_debug_utils::canScheduleRejectReason(
           ScheduleHeuristic::Persistent, "iteration not evenly divided");
       return false;
@@ -2058,8 +2506,13 @@ class PersistentKernelScheduler : public SchedulerEntry {
 const std::vector<ScheduleHeuristic>& all_heuristics() {
   static const std::vector<ScheduleHeuristic> hlist = {
       ScheduleHeuristic::NoOp,
+      ScheduleHeuristic::Matmul,
       ScheduleHeuristic::Reduction,
       ScheduleHeuristic::Transpose,
+      ScheduleHeuristic::IndexSelect,
+      ScheduleHeuristic::Scan,
+      ScheduleHeuristic::Attention,
+      ScheduleHeuristic::Stencil,
       ScheduleHeuristic::PointWise,
       ScheduleHeuristic::Persistent};
   return hlist;
@@ -2077,7 +2530,11 @@ bool checkCanSchedule(
   //  it has to pass all the compile time checks to create a data cache for this
   //  fusion.
   if (!data_cache) {
-    if (!isConnectedFusionGraph(fusion)) {
+    // Only the pointwise scheduler can schedule the components of a fusion
+    // separately, see Note [ Horizontal pointwise fusion ]
+    if (!isConnectedFusionGraph(fusion) &&
+        !(std::is_same<SchedulerType, PointWiseScheduler>::value &&
+          isOptionEnabled(EnableOption::HorizontalPointwise))) {
       return false;
     }
     if (IterDomainGraph(fusion, /*allow_self_mapping=*/true).hasSelfMapping()) {
@@ -2114,6 +2571,20 @@ bool SchedulerEntry::canSchedule(
     case ScheduleHeuristic::Transpose:
       return checkCanSchedule<TransposeScheduler>(
           fusion, runtime_info, data_cache);
+    case ScheduleHeuristic::Matmul:
+      return checkCanSchedule<MatmulScheduler>(
+          fusion, runtime_info, data_cache);
+    case ScheduleHeuristic::IndexSelect:
+      return checkCanSchedule<IndexSelectScheduler>(
+          fusion, runtime_info, data_cache);
+    case ScheduleHeuristic::Scan:
+      return checkCanSchedule<ScanScheduler>(fusion, runtime_info, data_cache);
+    case ScheduleHeuristic::Attention:
+      return checkCanSchedule<AttentionScheduler>(
+          fusion, runtime_info, data_cache);
+    case ScheduleHeuristic::Stencil:
+      return checkCanSchedule<StencilScheduler>(
+          fusion, runtime_info, data_cache);
     default:
       TORCH_INTERNAL_ASSERT(false, "unreachable");
       return false;
@@ -2148,6 +2619,26 @@ std::unique_ptr<SchedulerEntry> SchedulerEntry::makeEntry(
       scheduler_entry = std::make_unique<TransposeScheduler>(
           fusion, runtime_info, data_cache);
       break;
+    case ScheduleHeuristic::Matmul:
+      scheduler_entry = std::make_unique<MatmulScheduler>(
+          fusion, runtime_info, data_cache);
+      break;
+    case ScheduleHeuristic::IndexSelect:
+      scheduler_entry = std::make_unique<IndexSelectScheduler>(
+          fusion, runtime_info, data_cache);
+      break;
+    case ScheduleHeuristic::Scan:
+      scheduler_entry =
+          std::make_unique<ScanScheduler>(fusion, runtime_info, data_cache);
+      break;
+    case ScheduleHeuristic::Attention:
+      scheduler_entry = std::make_unique<AttentionScheduler>(
+          fusion, runtime_info, data_cache);
+      break;
+    case ScheduleHeuristic::Stencil:
+      scheduler_entry = std::make_unique<StencilScheduler>(
+          fusion, runtime_info, data_cache);
+      break;
     default:
       TORCH_INTERNAL_ASSERT(false, "unreachable");
   }
@@ -2184,6 +2675,16 @@ std::string toString(ScheduleHeuristic sh) {
       return "persistent";
     case ScheduleHeuristic::Transpose:
       return "transpose";
+    case ScheduleHeuristic::Matmul:
+      return "matmul";
+    case ScheduleHeuristic::IndexSelect:
+      return "index_select";
+    case ScheduleHeuristic::Scan:
+      return "scan";
+    case ScheduleHeuristic::Attention:
+      return "attention";
+    case ScheduleHeuristic::Stencil:
+      return "stencil";
     default:
       TORCH_INTERNAL_ASSERT(false, "undefined schedule");
   }
@@ -2243,6 +2744,26 @@ HeuristicSummary::HeuristicSummary(
       getTransposeHeuristics(fusion, runtime_info, this);
       TransposeScheduler::canScheduleRunTime(fusion, runtime_info, this);
       break;
+    case ScheduleHeuristic::Matmul:
+      getMatmulHeuristics(fusion, runtime_info, this);
+      MatmulScheduler::canScheduleRunTime(fusion, runtime_info, this);
+      break;
+    case ScheduleHeuristic::IndexSelect:
+      getIndexSelectHeuristics(fusion, runtime_info, this);
+      IndexSelectScheduler::canScheduleRunTime(fusion, runtime_info, this);
+      break;
+    case ScheduleHeuristic::Scan:
+      getScanHeuristics(fusion, runtime_info, this);
+      ScanScheduler::canScheduleRunTime(fusion, runtime_info, this);
+      break;
+    case ScheduleHeuristic::Attention:
+      getAttentionHeuristics(fusion, runtime_info, this);
+      AttentionScheduler::canScheduleRunTime(fusion, runtime_info, this);
+      break;
+    case ScheduleHeuristic::Stencil:
+      getStencilHeuristics(fusion, runtime_info, this);
+      StencilScheduler::canScheduleRunTime(fusion, runtime_info, this);
+      break;
     default:
       TORCH_INTERNAL_ASSERT(false, "unknown heuristic");
   }
@@ -2256,6 +2777,17 @@ void HeuristicSummary::validate() const {
       // TODO: need to cache the dynamically zero inputs?
       break;
     }
+    case ScheduleHeuristic::Matmul: {
+      // The matmul heuristic doesn't use the compile-time cache yet
+      break;
+    }
+    case ScheduleHeuristic::IndexSelect:
+    case ScheduleHeuristic::Scan:
+    case ScheduleHeuristic::Attention:
+    case ScheduleHeuristic::Stencil: {
+      // Nor do the index_select, scan, attention and stencil heuristics
+      break;
+    }
     case ScheduleHeuristic::Transpose:
     case ScheduleHeuristic::PointWise: {
       if (heuristic_ == ScheduleHeuristic::PointWise) {
@@ -11,6 +11,7 @@
 #include <scheduler/all_schedulers.h>
 #include <scheduler/compile_time_info.h>
 #include <scheduler/heuristic.h>
+#include <scheduler/matmul_heuristic.h>
 #include <scheduler/pointwise_heuristic.h>
 #include <scheduler/reduction_heuristic.h>
 #include <scheduler/utils.h>
@@ -79,6 +80,13 @@ class TORCH_CUDA_CU_API SchedulerRuntimeInfo : public NonCopyable {
     return index_mode_;
   }
 
+  //! Whether the input sizes are the canonical sizes of shape buckets, so
+  //! properties of the exact sizes can't be assumed, see
+  //! Note [ Shape bucketing ]
+  bool hasCanonicalSizes() const {
+    return canonical_sizes_;
+  }
+
   Fusion* fusion() {
     return complete_fusion_;
   }
@@ -130,6 +138,8 @@ class TORCH_CUDA_CU_API SchedulerRuntimeInfo : public NonCopyable {
   // Found index mode kernel needs to be run in
   KernelIndexMode index_mode_ = KernelIndexMode::INT64;
 
+  bool canonical_sizes_ = false;
+
   // TODO: Remove
   std::unordered_map<TensorView*, size_t> vectorword_map_;
 };
@@ -205,6 +215,43 @@ class TORCH_CUDA_CU_API SchedulerEntry {
     return *tparams;
   }
 
+  const IndexSelectParams& indexSelectParams() const {
+    auto isparams = std::dynamic_pointer_cast<IndexSelectParams>(params_);
+    TORCH_INTERNAL_ASSERT(
+        isparams != nullptr,
+        "Heuristic parameter is not an index_select parameter");
+    return *isparams;
+  }
+
+  const ScanParams& scanParams() const {
+    auto sparams = std::dynamic_pointer_cast<ScanParams>(params_);
+    TORCH_INTERNAL_ASSERT(
+        sparams != nullptr, "Heuristic parameter is not a scan parameter");
+    return *sparams;
+  }
+
+  const AttentionParams& attentionParams() const {
+    auto aparams = std::dynamic_pointer_cast<AttentionParams>(params_);
+    TORCH_INTERNAL_ASSERT(
+        aparams != nullptr,
+        "Heuristic parameter is not an attention parameter");
+    return *aparams;
+  }
+
+  const StencilParams& stencilParams() const {
+    auto sparams = std::dynamic_pointer_cast<StencilParams>(params_);
+    TORCH_INTERNAL_ASSERT(
+        sparams != nullptr, "Heuristic parameter is not a stencil parameter");
+    return *sparams;
+  }
+
+  const MatmulParams& matmulParams() const {
+    auto mparams = std::dynamic_pointer_cast<MatmulParams>(params_);
+    TORCH_INTERNAL_ASSERT(
+        mparams != nullptr, "Heuristic parameter is not a matmul parameter");
+    return *mparams;
+  }
+
   void updateLaunchConstraint(const LaunchParams& launch_params) {
     params_->lparams = launch_params;
   }
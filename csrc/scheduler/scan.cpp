@@ -0,0 +1,256 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <scheduler/scan.h>
+
+#include <compute_at_map.h>
+#include <inlining.h>
+#include <instrumentation.h>
+#include <ir_utils.h>
+#include <scheduler/pointwise.h>
+#include <scheduler/registry.h>
+#include <scheduler/utils.h>
+#include <transform_replay.h>
+#include <utils.h>
+
+#include <algorithm>
+
+namespace nvfuser {
+
+namespace {
+
+constexpr int64_t kThreadsPerBlock = 128;
+
+// Smallest power of two no less than n
+int64_t ceilPow2(int64_t n) {
+  auto pow2 = scheduler_utils::lastPow2(n);
+  return pow2 < n ? pow2 * 2 : pow2;
+}
+
+// Position of the dimension of the reference all scans scan, -1 if they
+// don't scan a single dimension of it
+int scannedDimOfReference(Fusion* fusion, TensorView* reference_tv) {
+  ComputeAtMap ca_map(fusion);
+  const auto ref_root =
+      TensorDomain::noReductions(reference_tv->getMaybeRFactorDomain());
+  int scanned_dim = -1;
+  for (auto sop : ir_utils::getScanOps(fusion)) {
+    auto scan_id =
+        sop->out()->as<TensorView>()->getRootDomain().at(sop->dim());
+    auto it = std::find_if(ref_root.begin(), ref_root.end(), [&](auto id) {
+      return ca_map.areMapped(id, scan_id, IdMappingMode::EXACT);
+    });
+    if (it == ref_root.end()) {
+      return -1;
+    }
+    const auto dim = (int)std::distance(ref_root.begin(), it);
+    if (scanned_dim >= 0 && dim != scanned_dim) {
+      return -1;
+    }
+    scanned_dim = dim;
+  }
+  return scanned_dim;
+}
+
+} // namespace
+
+std::string getScanCompileTimeRejectReason(Fusion* fusion) {
+  FusionGuard fg(fusion);
+
+  if (ir_utils::getScanOps(fusion).empty()) {
+    return "no scan op to schedule";
+  }
+
+  for (auto expr : fusion->exprs()) {
+    if (expr->isOneOf<SelectOp, IndexSelectOp, TorchGatherOp, ScatterOp>()) {
+      return "no support for gather-like ops";
+    }
+    if (expr->isOneOf<PadOp, SliceOp, CatOp>()) {
+      return "no support for resize ops";
+    }
+  }
+
+  if (!ir_utils::getViewOps(fusion).empty()) {
+    return "no support for view ops";
+  }
+
+  auto reference_tv = getReferenceTensorView(fusion);
+  if (reference_tv == nullptr) {
+    return "cannot find reference tensor";
+  }
+
+  if (scannedDimOfReference(fusion, reference_tv) < 0) {
+    return "scans are not along a single dimension of the reference";
+  }
+
+  return "";
+}
+
+std::shared_ptr<ScanParams> getScanHeuristics(
+    Fusion* fusion,
+    const at::ArrayRef<c10::IValue>& runtime_inputs,
+    HeuristicSummary* data_cache) {
+  SchedulerRuntimeInfo runtime_info(fusion, runtime_inputs, true);
+  return getScanHeuristics(fusion, runtime_info, data_cache);
+}
+
+std::shared_ptr<ScanParams> getScanHeuristics(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    HeuristicSummary* data_cache) {
+  FUSER_PERF_SCOPE("getScanHeuristics");
+
+  FusionGuard fg(fusion);
+
+  auto params = std::make_shared<ScanParams>(
+      "Scan heuristics", runtime_info.getIndexMode());
+
+  auto reference_tv = getReferenceTensorView(fusion);
+  TORCH_INTERNAL_ASSERT(reference_tv != nullptr);
+  const auto scanned_dim = scannedDimOfReference(fusion, reference_tv);
+  TORCH_INTERNAL_ASSERT(scanned_dim >= 0);
+
+  // The rows are all the elements of the reference along the other
+  // dimensions
+  auto ref_root =
+      TensorDomain::noReductions(reference_tv->getMaybeRFactorDomain());
+  auto& expr_eval = runtime_info.expressionEvaluator();
+  int64_t n_rows = 1;
+  int64_t row_size = 1;
+  for (auto i : c10::irange(ref_root.size())) {
+    auto extent = expr_eval.evaluate(ref_root[i]->extent());
+    TORCH_INTERNAL_ASSERT(
+        extent.has_value(),
+        "Error inferring size for scan scheduler: ",
+        ref_root[i]->extent()->toInlineString());
+    if ((int)i == scanned_dim) {
+      row_size = extent->as<int64_t>();
+    } else {
+      n_rows *= extent->as<int64_t>();
+    }
+  }
+
+  // A thread loads and stores vectors of its row if the rows are the
+  // innermost dimension of the reference
+  if (scanned_dim + 1 == (int)ref_root.size()) {
+    int64_t vectorize_factor =
+        (int64_t)SchedulerRuntimeInfo::max_alignment_size_in_byte;
+    for (auto tv : scheduler_utils::getInputsOutputsWithInnerDim(
+             reference_tv, true, true)) {
+      vectorize_factor = std::min(
+          vectorize_factor,
+          (int64_t)runtime_info.getInnerDimVectorizableWidth(tv));
+    }
+    params->vectorize_factor = std::max(vectorize_factor, (int64_t)1);
+  }
+
+  const int64_t bdimx =
+      std::min(ceilPow2(std::max(n_rows, (int64_t)1)), kThreadsPerBlock);
+  params->lparams.bind(bdimx, ParallelType::TIDx);
+
+  if (isDebugDumpEnabled(DebugDumpOption::SchedulerDebug)) {
+    std::cerr << "\n===== Scan Stats ========\n"
+              << "rows: " << n_rows << " row_size: " << row_size << "\n"
+              << "vectorize_factor: " << params->vectorize_factor << std::endl;
+    std::cerr << params->toString() << std::endl;
+  }
+
+  return params;
+}
+
+// TODO: remove or return launch parameters
+LaunchParams scheduleScan(
+    Fusion* fusion,
+    const at::ArrayRef<c10::IValue>& runtime_inputs) {
+  FUSER_PERF_SCOPE("scheduleFusion");
+  auto params = getScanHeuristics(fusion, runtime_inputs);
+  TORCH_INTERNAL_ASSERT(
+      params != nullptr, "Could not schedule scan operation.");
+  scheduleScan(fusion, *params);
+  return params->lparams;
+}
+
+void scheduleScan(Fusion* fusion, const ScanParams& params) {
+  FusionGuard fg(fusion);
+
+  // Make sure we don't have global memory set on intermediate tensors from
+  // fusion segmentation
+  scheduler_utils::clearMemorySpace(fusion);
+
+  scheduler_utils::cacheInputs(fusion, true);
+  scheduler_utils::cacheAndForkOutputs(fusion, true);
+
+  // Vectorized stores aren't inlined, so a copy of the outputs of the scans
+  // is computed in the serial loop of the vector instead of the scans
+  // themselves, see Note [ Scan scheduling ]
+  if (params.vectorize_factor > 1) {
+    for (auto sop : ir_utils::getScanOps(fusion)) {
+      sop->out()->as<TensorView>()->cacheAfter();
+    }
+  }
+
+  TensorView* reference_tv = getReferenceTensorView(fusion);
+  TORCH_INTERNAL_ASSERT(
+      reference_tv != nullptr,
+      "Could not find a fully broadcasted output to reference schedule on.");
+  const auto scanned_dim = scannedDimOfReference(fusion, reference_tv);
+  TORCH_INTERNAL_ASSERT(scanned_dim >= 0);
+
+  // Move the rows inside: [outer dims, row_size]
+  reference_tv->reorder({{scanned_dim, -1}});
+  while (reference_tv->nDims() > 2) {
+    reference_tv->merge(0);
+  }
+  const bool has_rows = reference_tv->nDims() == 2;
+
+  // [rows, row_size] -> [BIDx, TIDx, row_size / V, V]
+  if (params.vectorize_factor > 1) {
+    reference_tv->split(-1, params.vectorize_factor);
+  }
+  if (has_rows) {
+    reference_tv->split(0, NamedScalar::getParallelDim(ParallelType::TIDx));
+    reference_tv->axis(0)->parallelize(ParallelType::BIDx);
+    reference_tv->axis(1)->parallelize(ParallelType::TIDx);
+  }
+
+  TransformPropagator propagator(reference_tv);
+  MaxRootDomainInfoSpanningTree spanning_tree(reference_tv);
+  spanning_tree.traverse(&propagator);
+  scheduler_utils::parallelizeAllLike(reference_tv);
+
+  if (params.vectorize_factor > 1) {
+    // Vectorize the copies of the inputs and outputs along the rows
+    std::vector<TensorView*> vectorized_tvs;
+    bool should_vectorize_reference_tv = false;
+    for (auto tv : scheduler_utils::getInputsOutputsWithInnerDim(
+             reference_tv, true, true)) {
+      if (tv == reference_tv) {
+        should_vectorize_reference_tv = true;
+      }
+      if (!tv->isFusionInput()) {
+        vectorized_tvs.emplace_back(tv);
+        continue;
+      }
+      auto consumer_tvs = ir_utils::consumerTvsOf(tv);
+      vectorized_tvs.insert(
+          vectorized_tvs.end(), consumer_tvs.begin(), consumer_tvs.end());
+    }
+    auto vectorize_id = reference_tv->axis(-1);
+    vectorize_id->parallelize(ParallelType::Vectorize);
+    scheduler_utils::parallelizeAllLike(
+        reference_tv, vectorized_tvs, {ParallelType::Vectorize});
+    if (!should_vectorize_reference_tv) {
+      vectorize_id->parallelize(ParallelType::Serial);
+    }
+  }
+
+  // The outputs of the scans are registers carried along their serial
+  // loops, which requires them to be inlined, see Note [ Scan ops ]
+  inlineMost();
+}
+
+} // namespace nvfuser
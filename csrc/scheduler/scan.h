@@ -0,0 +1,67 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <ATen/core/ivalue.h>
+
+#include <fusion.h>
+#include <scheduler/scan_heuristic.h>
+
+namespace nvfuser {
+
+// Note [ Scan scheduling ]
+//
+// A fusion with scans and pointwise ops, e.g. the normalized cumulative sum
+//
+//   T1[i0, i1] = T0[i0, i1] * 2
+//   T2[i0, i1] = cumsum(T1, 1)
+//   T3[i0, i1] = T2 / T0
+//
+// is scheduled with every row of the scanned dimension on a thread, which
+// walks it serially, see Note [ Scan ops ]. The reference is reordered so
+// that the scanned dimension is the innermost one and split as
+//
+//   [i0, i1] -> [BIDx, TIDx, i1 / V, V]
+//
+// with the merged outer dimensions on blocks and threads. Everything is
+// inlined, so the pointwise producers and consumers of a scan are computed
+// in the same loops from registers. When the scanned dimension is also the
+// innermost one of the inputs and outputs, a thread loads and stores V
+// elements of its row with a vector access, and a copy of the outputs of
+// the scans is added so that they are still inlined in the serial loop of
+// the vector.
+//
+// All scans of the fusion must scan the same dimension of the reference,
+// and fusions with reductions, gather-like ops, views and resizes are left
+// to other schedulers, which in turn reject any scan, so the segmenter puts
+// scans in segments of their own.
+
+class SchedulerRuntimeInfo;
+class HeuristicSummary;
+
+TORCH_CUDA_CU_API std::shared_ptr<ScanParams> getScanHeuristics(
+    Fusion* fusion,
+    const at::ArrayRef<c10::IValue>& runtime_inputs,
+    HeuristicSummary* data_cache = nullptr);
+
+TORCH_CUDA_CU_API std::shared_ptr<ScanParams> getScanHeuristics(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    HeuristicSummary* data_cache = nullptr);
+
+TORCH_CUDA_CU_API void scheduleScan(Fusion* fusion, const ScanParams& params);
+
+TORCH_CUDA_CU_API LaunchParams scheduleScan(
+    Fusion* fusion,
+    const at::ArrayRef<c10::IValue>& runtime_inputs);
+
+//! Returns an empty string if the fusion has the structure the scan
+//! scheduler handles, otherwise the reason why it doesn't
+TORCH_CUDA_CU_API std::string getScanCompileTimeRejectReason(Fusion* fusion);
+
+} // namespace nvfuser
@@ -0,0 +1,62 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <scheduler/heuristic.h>
+
+#include <sstream>
+
+namespace nvfuser {
+
+// Parameters of the scan heuristic, see Note [ Scan scheduling ]. The block
+// shape is held by the launch parameters.
+// Warning: equal operator is intended for use in caching the kernel associated
+// with these parameters. It does not check if the launch parameters are
+// equivelent!
+class ScanParams : public HeuristicParams {
+ public:
+  // Elements of a scanned row loaded and stored by a vector access, 1 if
+  // not vectorized
+  int64_t vectorize_factor = 1;
+
+  using HeuristicParams::HeuristicParams;
+
+  // Warning: Does not check launch parameters!
+  bool sameAs(
+      const std::shared_ptr<HeuristicParams>& other_base) const override {
+    auto other_casted = std::dynamic_pointer_cast<ScanParams>(other_base);
+    if (other_casted == nullptr) {
+      return false;
+    }
+    return other_casted->cparams == cparams &&
+        other_casted->vectorize_factor == vectorize_factor;
+  }
+
+  std::string toString() const override {
+    std::stringstream ss;
+    ss << "\n===== Scan Parameters ========\n"
+       << (tag == "" ? "" : "Tag: ") << tag << "\n"
+       << " BlckX: " << lparams.bdimx() << "\n";
+    if (vectorize_factor > 1) {
+      ss << "Vectorize, Factor: " << vectorize_factor << "\n";
+    }
+    ss << "====================================\n";
+    return ss.str();
+  }
+
+  // Warning: Hash is not based on launch parameters!
+  size_t hash() const override {
+    return static_cast<size_t>(vectorize_factor);
+  }
+
+  std::shared_ptr<HeuristicParams> clone() const override {
+    return std::make_shared<ScanParams>(*this);
+  }
+};
+
+} // namespace nvfuser
@@ -0,0 +1,392 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <scheduler/stencil.h>
+
+#include <device_profile.h>
+#include <inlining.h>
+#include <instrumentation.h>
+#include <ir_utils.h>
+#include <scheduler/pointwise.h>
+#include <scheduler/registry.h>
+#include <scheduler/utils.h>
+#include <transform_replay.h>
+#include <utils.h>
+
+#include <algorithm>
+#include <array>
+
+namespace nvfuser {
+
+namespace {
+
+// Threads per block the tiles are sized for before growing them for halos
+constexpr int64_t kTargetThreadsPerBlock = 256;
+
+// Largest fraction of a block dimension only computing halos is
+// 1 / kMaxHaloFraction, see Note [ Stencil scheduling ]
+constexpr int64_t kMaxHaloFraction = 8;
+
+// Largest TIDx extent and number of threads a block grows to for halos
+constexpr int64_t kMaxBlockDimX = 128;
+constexpr int64_t kMaxGrownThreadsPerBlock = 512;
+
+// Most tiles a block walks serially
+constexpr int64_t kMaxTilesPerBlock = 8;
+
+// Waves of blocks to keep when blocks walk several tiles
+constexpr int64_t kMinWaves = 2;
+
+constexpr int64_t kMaxGridDimY = 65535;
+
+// Position of the serial loop over the tiles of a block in the reference,
+// [BIDx, BIDy, tiles_per_block, TIDy, TIDx]
+constexpr int64_t kTilePos = 3;
+
+// Halo widths of a tensor along the second innermost and innermost
+// dimensions
+using HaloWidths = std::array<int64_t, 2>;
+
+// Returns the halo widths of every tensor of the fusion, propagated from
+// the outputs to the inputs as HaloInfo::propagateRootAxisInfo does, which
+// the extents of the tiles in shared memory are extended by
+std::unordered_map<TensorView*, HaloWidths> getHaloWidths(Fusion* fusion) {
+  // Widths of the halos at the start and the end of each dimension
+  std::unordered_map<TensorView*, HaloWidths> start;
+  std::unordered_map<TensorView*, HaloWidths> stop;
+
+  auto exprs = fusion->exprs();
+  for (auto it = exprs.rbegin(); it != exprs.rend(); ++it) {
+    auto expr = *it;
+    auto out = dynamic_cast<TensorView*>(expr->output(0));
+    if (out == nullptr) {
+      continue;
+    }
+    const auto out_start = start.emplace(out, HaloWidths{0, 0}).first->second;
+    const auto out_stop = stop.emplace(out, HaloWidths{0, 0}).first->second;
+    auto sop = dynamic_cast<ShiftOp*>(expr);
+    for (auto in : ir_utils::filterByType<TensorView>(expr->inputs())) {
+      auto& in_start = start.emplace(in, HaloWidths{0, 0}).first->second;
+      auto& in_stop = stop.emplace(in, HaloWidths{0, 0}).first->second;
+      for (auto i : c10::irange(2)) {
+        const auto offset = sop == nullptr
+            ? 0
+            : sop->offset(sop->offsets().size() - 2 + i);
+        if (offset >= 0) {
+          in_start[i] = std::max(in_start[i], out_start[i] + offset);
+        }
+        if (offset <= 0) {
+          in_stop[i] = std::max(in_stop[i], out_stop[i] - offset);
+        }
+      }
+    }
+  }
+
+  std::unordered_map<TensorView*, HaloWidths> widths;
+  for (auto tv : ir_utils::allTvs(fusion)) {
+    auto start_it = start.find(tv);
+    if (start_it == start.end()) {
+      widths[tv] = {0, 0};
+      continue;
+    }
+    const auto& tv_stop = stop.at(tv);
+    widths[tv] = {
+        start_it->second[0] + tv_stop[0], start_it->second[1] + tv_stop[1]};
+  }
+  return widths;
+}
+
+// Widest halos of the fusion
+HaloWidths getMaxHaloWidths(
+    const std::unordered_map<TensorView*, HaloWidths>& widths) {
+  HaloWidths max_widths = {0, 0};
+  for (const auto& entry : widths) {
+    for (auto i : c10::irange(2)) {
+      max_widths[i] = std::max(max_widths[i], entry.second[i]);
+    }
+  }
+  return max_widths;
+}
+
+// A tensor with a halo needs a tile in shared memory if it's read by a
+// shift, as the elements of its halo are computed by other threads, or if
+// it's used by several consumers, which may not compute it for the same
+// halo
+bool needsSharedMemoryTile(TensorView* tv, const HaloWidths& widths) {
+  if (widths[0] == 0 && widths[1] == 0) {
+    return false;
+  }
+  return tv->uses().size() > 1 ||
+      std::any_of(tv->uses().begin(), tv->uses().end(), [](Expr* use) {
+           return use->isA<ShiftOp>();
+         });
+}
+
+// Block dimensions of the tiles, extended by the widest halos
+std::pair<int64_t, int64_t> getBlockDims(const HaloWidths& max_widths) {
+  int64_t bdimx = 32;
+  while (bdimx < kMaxBlockDimX && max_widths[1] * kMaxHaloFraction > bdimx) {
+    bdimx *= 2;
+  }
+  bdimx = std::max(bdimx, max_widths[1] + 1);
+  int64_t bdimy = std::max(kTargetThreadsPerBlock / bdimx, (int64_t)1);
+  while (bdimx * bdimy * 2 <= kMaxGrownThreadsPerBlock &&
+         max_widths[0] * kMaxHaloFraction > bdimy) {
+    bdimy *= 2;
+  }
+  bdimy = std::max(bdimy, max_widths[0] + 1);
+  return {bdimy, bdimx};
+}
+
+// Shared memory of the tiles of a block staged in shared memory, see Note [
+// Stencil scheduling ]. Before scheduling, the tiles of the inputs are
+// those of their caches.
+int64_t getSharedMemorySize(
+    Fusion* fusion,
+    const std::unordered_map<TensorView*, HaloWidths>& widths,
+    int64_t tile_y,
+    int64_t tile_x,
+    bool double_buffer) {
+  int64_t smem_size = 0;
+  for (auto tv : ir_utils::allTvs(fusion)) {
+    const auto& tv_widths = widths.at(tv);
+    if (tv->isFusionOutput() || !needsSharedMemoryTile(tv, tv_widths)) {
+      continue;
+    }
+    smem_size += (tile_y + tv_widths[0]) * (tile_x + tv_widths[1]) *
+        (int64_t)dataTypeSize(tv->getDataType().value()) *
+        (tv->isFusionInput() && double_buffer ? 2 : 1);
+  }
+  return smem_size;
+}
+
+} // namespace
+
+std::string getStencilCompileTimeRejectReason(Fusion* fusion) {
+  FusionGuard fg(fusion);
+
+  if (ir_utils::getShiftOps(fusion).empty()) {
+    return "no shift op to schedule";
+  }
+
+  for (auto expr : fusion->exprs()) {
+    if (!expr->isOneOf<UnaryOp, BinaryOp, TernaryOp, LoadStoreOp, ShiftOp>()) {
+      return "only pointwise and shift ops are supported";
+    }
+  }
+
+  auto reference_tv = getReferenceTensorView(fusion);
+  if (reference_tv == nullptr) {
+    return "cannot find reference tensor";
+  }
+  const auto n_dims =
+      TensorDomain::noReductions(reference_tv->getMaybeRFactorDomain())
+          .size();
+  if (n_dims < 2) {
+    return "the reference has less than two dimensions";
+  }
+
+  for (auto tv : ir_utils::allTvs(fusion)) {
+    if (tv->hasRFactor()) {
+      return "no support for view ops";
+    }
+    auto root = TensorDomain::noReductions(tv->getRootDomain());
+    if (root.size() != n_dims ||
+        std::any_of(root.begin(), root.end(), [](IterDomain* id) {
+          return id->isBroadcast();
+        })) {
+      return "all tensors must have the dimensions of the reference";
+    }
+  }
+
+  for (auto sop : ir_utils::getShiftOps(fusion)) {
+    for (auto i : c10::irange(n_dims - 2)) {
+      if (sop->offset(i) != 0) {
+        return "shifts must be along the two innermost dimensions";
+      }
+    }
+  }
+
+  const auto widths = getHaloWidths(fusion);
+  const auto max_widths = getMaxHaloWidths(widths);
+  const auto block_dims = getBlockDims(max_widths);
+  const auto& dev_prop = getCurrentDeviceProfile();
+  if (block_dims.first * block_dims.second > dev_prop.max_threads_per_block) {
+    return "the halos are too wide for a block";
+  }
+  if (getSharedMemorySize(
+          fusion,
+          widths,
+          block_dims.first - max_widths[0],
+          block_dims.second - max_widths[1],
+          false) > dev_prop.smem_per_block_optin) {
+    return "the tiles don't fit in shared memory";
+  }
+
+  return "";
+}
+
+std::shared_ptr<StencilParams> getStencilHeuristics(
+    Fusion* fusion,
+    const at::ArrayRef<c10::IValue>& runtime_inputs,
+    HeuristicSummary* data_cache) {
+  SchedulerRuntimeInfo runtime_info(fusion, runtime_inputs, true);
+  return getStencilHeuristics(fusion, runtime_info, data_cache);
+}
+
+std::shared_ptr<StencilParams> getStencilHeuristics(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    HeuristicSummary* data_cache) {
+  FUSER_PERF_SCOPE("getStencilHeuristics");
+
+  FusionGuard fg(fusion);
+
+  auto params = std::make_shared<StencilParams>(
+      "Stencil heuristics", runtime_info.getIndexMode());
+
+  const auto widths = getHaloWidths(fusion);
+  const auto max_widths = getMaxHaloWidths(widths);
+  const auto block_dims = getBlockDims(max_widths);
+  params->tile_y = block_dims.first - max_widths[0];
+  params->tile_x = block_dims.second - max_widths[1];
+
+  auto reference_tv = getReferenceTensorView(fusion);
+  TORCH_INTERNAL_ASSERT(reference_tv != nullptr);
+  auto ref_root =
+      TensorDomain::noReductions(reference_tv->getMaybeRFactorDomain());
+  auto& expr_eval = runtime_info.expressionEvaluator();
+  std::vector<int64_t> extents;
+  for (auto id : ref_root) {
+    auto extent = expr_eval.evaluate(id->extent());
+    TORCH_INTERNAL_ASSERT(
+        extent.has_value(),
+        "Error inferring size for stencil scheduler: ",
+        id->extent()->toInlineString());
+    extents.push_back(extent->as<int64_t>());
+  }
+
+  // Rows of tiles on BIDx and tiles of a row on BIDy and the serial loop
+  int64_t n_tile_rows = ceilDiv(extents.at(extents.size() - 2), params->tile_y);
+  for (auto i : c10::irange(extents.size() - 2)) {
+    n_tile_rows *= extents.at(i);
+  }
+  const int64_t n_tiles_x = ceilDiv(extents.back(), params->tile_x);
+
+  // Walk several tiles per block only if there are still a few waves of
+  // blocks to fill the device
+  const auto& dev_prop = getCurrentDeviceProfile();
+  const int64_t blocks_per_sm = std::max(
+      dev_prop.max_threads_per_sm / (block_dims.first * block_dims.second),
+      (int64_t)1);
+  const int64_t min_blocks =
+      kMinWaves * blocks_per_sm * scheduler_utils::numSMs();
+  int64_t tiles_per_block = 1;
+  while (tiles_per_block * 2 <= std::min(n_tiles_x, kMaxTilesPerBlock) &&
+         n_tile_rows * ceilDiv(n_tiles_x, tiles_per_block * 2) >=
+             min_blocks) {
+    tiles_per_block *= 2;
+  }
+  while (ceilDiv(n_tiles_x, tiles_per_block) > kMaxGridDimY) {
+    tiles_per_block *= 2;
+  }
+  params->tiles_per_block = tiles_per_block;
+
+  params->double_buffer = tiles_per_block > 1 &&
+      getSharedMemorySize(
+          fusion, widths, params->tile_y, params->tile_x, true) <=
+          dev_prop.smem_per_block_optin;
+
+  if (isDebugDumpEnabled(DebugDumpOption::SchedulerDebug)) {
+    std::cerr << "\n===== Stencil Stats ========\n"
+              << "halo widths: " << max_widths[0] << " x " << max_widths[1]
+              << "\n"
+              << "tile rows: " << n_tile_rows << " tiles per row: " << n_tiles_x
+              << std::endl;
+    std::cerr << params->toString() << std::endl;
+  }
+
+  return params;
+}
+
+// TODO: remove or return launch parameters
+LaunchParams scheduleStencil(
+    Fusion* fusion,
+    const at::ArrayRef<c10::IValue>& runtime_inputs) {
+  FUSER_PERF_SCOPE("scheduleFusion");
+  auto params = getStencilHeuristics(fusion, runtime_inputs);
+  TORCH_INTERNAL_ASSERT(
+      params != nullptr, "Could not schedule stencil operation.");
+  scheduleStencil(fusion, *params);
+  return params->lparams;
+}
+
+void scheduleStencil(Fusion* fusion, const StencilParams& params) {
+  FusionGuard fg(fusion);
+
+  // Make sure we don't have global memory set on intermediate tensors from
+  // fusion segmentation
+  scheduler_utils::clearMemorySpace(fusion);
+
+  auto cached_inputs = scheduler_utils::cacheInputs(fusion, true);
+  // Intermediate outputs are forked so that the tensor read by their
+  // consumers can be staged in shared memory
+  scheduler_utils::cacheAndForkOutputs(fusion, false);
+
+  const auto widths = getHaloWidths(fusion);
+  std::unordered_set<TensorView*> smem_tvs;
+  std::unordered_set<TensorView*> inlined_tvs;
+  for (auto tv : ir_utils::allTvs(fusion)) {
+    if (!tv->isFusionInput() && !tv->isFusionOutput() &&
+        needsSharedMemoryTile(tv, widths.at(tv))) {
+      tv->setMemoryType(MemoryType::Shared);
+      smem_tvs.insert(tv);
+    } else {
+      inlined_tvs.insert(tv);
+    }
+  }
+
+  TensorView* reference_tv = getReferenceTensorView(fusion);
+  TORCH_INTERNAL_ASSERT(
+      reference_tv != nullptr,
+      "Could not find a fully broadcasted output to reference schedule on.");
+
+  // [..., H, W] -> [..., H/tile_y, W/tile_x, tile_y, tile_x]
+  reference_tv->split(-1, params.tile_x);
+  reference_tv->split(-3, params.tile_y);
+  reference_tv->reorder({{-2, -3}});
+  // [rows of tiles, W/tile_x, tile_y, tile_x]
+  while (reference_tv->nDims() > 4) {
+    reference_tv->merge(0);
+  }
+  // [BIDx, BIDy, tiles_per_block, TIDy, TIDx]
+  reference_tv->split(1, params.tiles_per_block);
+  reference_tv->axis(0)->parallelize(ParallelType::BIDx);
+  reference_tv->axis(1)->parallelize(ParallelType::BIDy);
+  reference_tv->axis(3)->parallelize(ParallelType::TIDy);
+  reference_tv->axis(4)->parallelize(ParallelType::TIDx);
+
+  TransformPropagator propagator(reference_tv);
+  MaxRootDomainInfoSpanningTree spanning_tree(reference_tv);
+  spanning_tree.traverse(&propagator);
+  scheduler_utils::parallelizeAllLike(reference_tv);
+
+  // The tiles in shared memory are computed for a whole tile before their
+  // consumers, everything else is inlined
+  inlineSelectedAt(smem_tvs, reference_tv, kTilePos);
+  inlineMost(inlined_tvs);
+
+  if (params.double_buffer) {
+    for (auto tv : cached_inputs) {
+      if (smem_tvs.count(tv)) {
+        tv->doubleBuffer();
+      }
+    }
+  }
+}
+
+} // namespace nvfuser
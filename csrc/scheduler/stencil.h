@@ -0,0 +1,71 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <ATen/core/ivalue.h>
+
+#include <fusion.h>
+#include <scheduler/stencil_heuristic.h>
+
+namespace nvfuser {
+
+// Note [ Stencil scheduling ]
+//
+// A fusion of pointwise ops and shifts along the two innermost dimensions,
+// e.g. the 5-point blur
+//
+//   T1 = shift(T0, {0, 1, 0}), T2 = shift(T0, {0, -1, 0}), ...
+//   T5 = (T0 + T1 + T2 + T3 + T4) / 5
+//
+// reads, for every element of the outputs, a neighbourhood of the elements
+// of some of its tensors, the halo. The reference is tiled along the two
+// innermost dimensions as
+//
+//   [..., H, W] -> [BIDx, BIDy, tiles_per_block, TIDy{tile_y}, TIDx{tile_x}]
+//
+// with the outer dimensions merged into BIDx and each block walking
+// tiles_per_block consecutive tiles along W serially. The tensors read by
+// shifts, and any other tensor with a halo used more than once, are staged
+// in shared memory for a whole tile extended by their halo, see
+// lower_shift.cpp, and everything else is inlined. The block is therefore
+// as large as the tile extended by the widest halo, and the tile sizes are
+// picked from the halo widths so that no more than 1 / kMaxHaloFraction of
+// each block dimension computes halos only. When a block walks several
+// tiles, the shared memory tiles of the inputs are double buffered so that
+// the next tile is loaded while the current one is computed.
+//
+// Shifts of other dimensions, reductions, broadcasts and gather ops are
+// left to the segmenter, and the other schedulers reject any shift.
+
+class SchedulerRuntimeInfo;
+class HeuristicSummary;
+
+TORCH_CUDA_CU_API std::shared_ptr<StencilParams> getStencilHeuristics(
+    Fusion* fusion,
+    const at::ArrayRef<c10::IValue>& runtime_inputs,
+    HeuristicSummary* data_cache = nullptr);
+
+TORCH_CUDA_CU_API std::shared_ptr<StencilParams> getStencilHeuristics(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    HeuristicSummary* data_cache = nullptr);
+
+TORCH_CUDA_CU_API void scheduleStencil(
+    Fusion* fusion,
+    const StencilParams& params);
+
+TORCH_CUDA_CU_API LaunchParams scheduleStencil(
+    Fusion* fusion,
+    const at::ArrayRef<c10::IValue>& runtime_inputs);
+
+//! Returns an empty string if the fusion has the structure the stencil
+//! scheduler handles, otherwise the reason why it doesn't
+TORCH_CUDA_CU_API std::string getStencilCompileTimeRejectReason(
+    Fusion* fusion);
+
+} // namespace nvfuser
@@ -0,0 +1,78 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <scheduler/heuristic.h>
+
+#include <sstream>
+
+namespace nvfuser {
+
+// Parameters of the stencil heuristic, see Note [ Stencil scheduling ]. The
+// block shape is the tile shape extended by the halo, which is inferred
+// from the scheduled kernel.
+// Warning: equal operator is intended for use in caching the kernel associated
+// with these parameters. It does not check if the launch parameters are
+// equivelent!
+class StencilParams : public HeuristicParams {
+ public:
+  // Output elements of a tile along the second innermost dimension
+  int64_t tile_y = 1;
+
+  // Output elements of a tile along the innermost dimension
+  int64_t tile_x = 1;
+
+  // Tiles along the innermost dimension walked serially by a block
+  int64_t tiles_per_block = 1;
+
+  // Load the input tiles of the next serial iteration while computing the
+  // current one
+  bool double_buffer = false;
+
+  using HeuristicParams::HeuristicParams;
+
+  // Warning: Does not check launch parameters!
+  bool sameAs(
+      const std::shared_ptr<HeuristicParams>& other_base) const override {
+    auto other_casted = std::dynamic_pointer_cast<StencilParams>(other_base);
+    if (other_casted == nullptr) {
+      return false;
+    }
+    return other_casted->cparams == cparams &&
+        other_casted->tile_y == tile_y && other_casted->tile_x == tile_x &&
+        other_casted->tiles_per_block == tiles_per_block &&
+        other_casted->double_buffer == double_buffer;
+  }
+
+  std::string toString() const override {
+    std::stringstream ss;
+    ss << "\n===== Stencil Parameters ========\n"
+       << (tag == "" ? "" : "Tag: ") << tag << "\n"
+       << " Tile: " << tile_y << " x " << tile_x << "\n"
+       << " Tiles per block: " << tiles_per_block << "\n";
+    if (double_buffer) {
+      ss << "Double buffer tile loads\n";
+    }
+    ss << "====================================\n";
+    return ss.str();
+  }
+
+  // Warning: Hash is not based on launch parameters!
+  size_t hash() const override {
+    return (static_cast<size_t>(tile_y) << 16) ^
+        (static_cast<size_t>(tile_x) << 4) ^
+        (static_cast<size_t>(tiles_per_block) << 24) ^
+        static_cast<size_t>(double_buffer);
+  }
+
+  std::shared_ptr<HeuristicParams> clone() const override {
+    return std::make_shared<StencilParams>(*this);
+  }
+};
+
+} // namespace nvfuser
@@ -511,8 +511,7 @@ std::string getTransposeRuntimeRejectReason(
       TransposeParams::getDefaultTileSize();
 
   // don't schedule with transpose scheduler if less than a full wave
-  const int64_t device_multiprocessor_count =
-      (int64_t)at::cuda::getCurrentDeviceProperties()->multiProcessorCount;
+  const int64_t device_multiprocessor_count = scheduler_utils::numSMs();
   auto elements_per_wave = device_multiprocessor_count * default_tile_elements;
   if ((int64_t)elements_per_wave > n_elems) {
     return "Transpose scheduler does not perform well on small problem sizes.";
@@ -601,8 +600,7 @@ std::shared_ptr<TransposeParams> getTransposeHeuristics(
   auto& shape_in_ref1 = pair.first;
   auto& n_elems = pair.second;
 
-  const int64_t device_multiprocessor_count =
-      (int64_t)at::cuda::getCurrentDeviceProperties()->multiProcessorCount;
+  const int64_t device_multiprocessor_count = scheduler_utils::numSMs();
 
   auto innermost_info_entry = getInnerMostDimInfoInReference(
       data_cache, reference_tensors, reference1, domain_map);
@@ -710,6 +708,16 @@ std::shared_ptr<TransposeParams> getTransposeHeuristics(
   params->vectorize_factor2 = scheduler_utils::lastPow2(
       std::min(static_cast<size_t>(max_unroll_factor), vectorize_factor2));
 
+  // See Note [ Swizzled transpose tiles ]
+  params->smem_swizzle_size = 1;
+  if (params->tile_size2 % params->vectorize_factor2 == 0) {
+    const auto words_per_row = params->tile_size2 / params->vectorize_factor2;
+    while (words_per_row % (params->smem_swizzle_size * 2) == 0 &&
+           params->tile_size1 % (params->smem_swizzle_size * 2) == 0) {
+      params->smem_swizzle_size *= 2;
+    }
+  }
+
   params->lparams.bind(params->getThreadsPerBlock(), ParallelType::TIDx);
 
   if (isDebugDumpEnabled(DebugDumpOption::SchedulerDebug)) {
@@ -822,6 +830,7 @@ void scheduleTranspose(Fusion* fusion, TransposeParams params) {
    */
   std::unordered_set<TensorView*> group2_and_cached_inputs(
       grouped_inputs_outputs[1].begin(), grouped_inputs_outputs[1].end());
+  std::vector<TensorView*> group2_smem_cached_inputs;
   for (auto tv : grouped_inputs_outputs[1]) {
     if (tv->isFusionInput()) {
       auto existing_cache = ir_utils::consumerTvsOf(tv)[0];
@@ -829,9 +838,11 @@ void scheduleTranspose(Fusion* fusion, TransposeParams params) {
         auto new_cache = tv->cacheAfter();
         new_cache->setMemoryType(MemoryType::Shared);
         group2_and_cached_inputs.emplace(new_cache);
+        group2_smem_cached_inputs.push_back(new_cache);
       } else {
         existing_cache->setMemoryType(MemoryType::Shared);
         group2_and_cached_inputs.emplace(existing_cache);
+        group2_smem_cached_inputs.push_back(existing_cache);
       }
     }
   }
@@ -1137,6 +1148,57 @@ void scheduleTranspose(Fusion* fusion, TransposeParams params) {
     }
   }
 
+  // Note [ Swizzled transpose tiles ]
+  //
+  // The shared memory cache of an input of group 2 is written in the order of
+  // group 2, i.e. as a [tile1, tile2] tile with tile2 innermost, and read in
+  // the order of group 1, so that consecutive threads read the same column
+  // of the tile. With 32 x 32 tiles of 4-byte elements all of them hit the
+  // same bank. The tile is therefore XOR swizzled at the granularity of the
+  // vector words of its writer: with n the largest power of two dividing
+  // both tile2 / vectorize_factor2 and tile1, the position of a word within
+  // its group of n words of a row is XORed with the row index modulo n.
+  // Words stay contiguous, so the writes keep their vectorization, and reads
+  // of a column spread over n words, reducing the conflicts by a factor of n.
+  // Tiles with fewer rows than words per row are swizzled with a smaller n
+  // rather than not at all. The tile is recovered from the
+  // [Unroll, TIDx, Vectorize] domain of the writer and rebuilt into the same
+  // domain after swizzling. Shared memory caches of outputs are left
+  // unswizzled, as their producers are inlined into them, and so are tiles
+  // with broadcast domains, which can't be swizzled.
+  if (params.smem_swizzle_size > 1) {
+    const auto swizzle_size = (int64_t)params.smem_swizzle_size;
+    for (auto tv : group2_smem_cached_inputs) {
+      if (std::any_of(
+              tv->getRootDomain().begin(),
+              tv->getRootDomain().end(),
+              [](IterDomain* id) { return id->isBroadcast(); })) {
+        continue;
+      }
+      const auto vectorize_ptype = tv->axis(-1)->getParallelType();
+      const auto unroll_ptype = tv->axis(-3)->getParallelType();
+      // [..., Unroll, TIDx, Vectorize]
+      tv->merge(-3);
+      tv->merge(-2);
+      tv->split(-1, params.tile_size2);
+      tv->split(-1, params.vectorize_factor2);
+      tv->split(-2, swizzle_size);
+      tv->split(-4, swizzle_size);
+      // [..., tile1/n, n, tile2/vec/n, n, vec]
+      tv->swizzle(Swizzle2DType::XOR, -4, -2);
+      tv->merge(-5);
+      tv->merge(-4);
+      tv->merge(-3);
+      tv->merge(-2);
+      tv->split(-1, params.vectorize_factor2);
+      tv->split(-1, params.getThreadsPerBlock());
+      // [..., Unroll, TIDx, Vectorize]
+      tv->axis(-1)->parallelize(vectorize_ptype);
+      tv->axis(-2)->parallelize(ParallelType::TIDx);
+      tv->axis(-3)->parallelize(unroll_ptype);
+    }
+  }
+
   ////////////////////////////////
   // Step 5: Cleanup and inline //
   ////////////////////////////////
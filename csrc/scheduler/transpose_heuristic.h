@@ -50,6 +50,11 @@ class TransposeParams : public HeuristicParams {
   // Tile size for the inner most dim of tensors in the second group
   size_t tile_size2 = getDefaultTileSize();
 
+  // Size of the XOR swizzle of the shared memory tiles of the inputs of the
+  // second group, 1 if they are not swizzled, see
+  // Note [ Swizzled transpose tiles ]
+  size_t smem_swizzle_size = 1;
+
   using HeuristicParams::HeuristicParams;
 
   // Warning: Does not check launch parameters!
@@ -66,7 +71,8 @@ class TransposeParams : public HeuristicParams {
         other.dims_merged_with_2 == dims_merged_with_2 &&
         other.vectorize_factor1 == vectorize_factor1 &&
         other.vectorize_factor2 == vectorize_factor2 &&
-        other.tile_size1 == tile_size1 && other.tile_size2 == tile_size2;
+        other.tile_size1 == tile_size1 && other.tile_size2 == tile_size2 &&
+        other.smem_swizzle_size == smem_swizzle_size;
     return attr_equal;
   }
 
@@ -95,6 +101,9 @@ class TransposeParams : public HeuristicParams {
     if (unroll_factor2 > 1) {
       ss << "Unroll group 2, Factor: " << unroll_factor2 << "\n";
     }
+    if (smem_swizzle_size > 1) {
+      ss << "Swizzle shared memory tiles, Size: " << smem_swizzle_size << "\n";
+    }
     if (!split_before_tiling.empty() || !dims_merged_with_1.empty() ||
         !dims_merged_with_2.empty()) {
       ss << "Virtual inner-most dim:\n";
@@ -147,7 +156,8 @@ class TransposeParams : public HeuristicParams {
         vectorize_factor1,
         vectorize_factor2,
         tile_size1,
-        tile_size2);
+        tile_size2,
+        smem_swizzle_size);
   }
 
   std::shared_ptr<HeuristicParams> clone() const override {
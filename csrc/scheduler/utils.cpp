@@ -10,6 +10,7 @@
 #include <scheduler/vectorize_helper.h>
 
 #include <contiguity.h>
+#include <device_profile.h>
 #include <expr_evaluator.h>
 #include <instrumentation.h>
 #include <ir_utils.h>
@@ -18,12 +19,57 @@
 #include <scheduler/mma_utils.h>
 #include <transform_iter.h>
 #include <transform_replay.h>
+#include <utils.h>
 
 #include <algorithm>
 
 namespace nvfuser {
 namespace scheduler_utils {
 
+int64_t smemPersistentBufferSize() {
+  if (isOptionDisabled(DisableOption::SmemPersistentBuffers)) {
+    return 0;
+  }
+  const auto& device = getCurrentDeviceProfile();
+  // Leave room for the shared memory of block reductions and broadcasts,
+  // which is at most a Welford triplet of doubles per thread
+  const int64_t reduction_workspace_size =
+      device.max_threads_per_block * 3 * (int64_t)sizeof(double);
+  return std::max(
+      device.smem_per_block_optin - reduction_workspace_size, (int64_t)0);
+}
+
+namespace {
+
+thread_local c10::optional<int64_t> active_sm_budget = c10::nullopt;
+
+} // namespace
+
+int64_t numSMs() {
+  const auto num_sms = getCurrentDeviceProfile().sm_count;
+  if (!active_sm_budget.has_value()) {
+    return num_sms;
+  }
+  return std::min(num_sms, active_sm_budget.value());
+}
+
+c10::optional<int64_t> smBudget() {
+  return active_sm_budget;
+}
+
+SmBudgetGuard::SmBudgetGuard(c10::optional<int64_t> sm_budget)
+    : prev_sm_budget_(active_sm_budget) {
+  TORCH_CHECK(
+      !sm_budget.has_value() || sm_budget.value() > 0,
+      "SM budget must be positive, got ",
+      sm_budget.value_or(0));
+  active_sm_budget = sm_budget;
+}
+
+SmBudgetGuard::~SmBudgetGuard() {
+  active_sm_budget = prev_sm_budget_;
+}
+
 // Returns number of "valid" dimensions. e.g. if tv has
 // [I1, R2, I3, I4, R3{1}]
 // where R3{1} is in dont_merge, resulting domain should be:
@@ -501,6 +547,12 @@ PersistentBufferInfo persistentBuffers(Fusion* fusion) {
         PersistentBufferResolution::getResolutionPointsOf(fusion, buffer));
   }
 
+  // Inputs overwritten in place, e.g., the residual of a residual norm
+  std::unordered_set<Val*> aliased_inputs;
+  for (const auto& alias : fusion->ioAlias()) {
+    aliased_inputs.insert(alias.second);
+  }
+
   // Find projectable persistent buffers
   auto reduction_tvs = getReductionTvs(fusion);
   for (auto persistent_buffer : persistent_buffer_info.persistent_buffers) {
@@ -508,6 +560,18 @@ PersistentBufferInfo persistentBuffers(Fusion* fusion) {
     if (persistent_buffer->isFusionInput()) {
       continue;
     }
+    // A projected buffer is recomputed by reading its inputs again after the
+    // reduction, when inputs overwritten in place may already hold their new
+    // values, see Note [ In-place outputs ]
+    auto buffer_inputs = ir_utils::inputTvsOf(persistent_buffer);
+    if (std::any_of(
+            buffer_inputs.begin(),
+            buffer_inputs.end(),
+            [&aliased_inputs](TensorView* input) {
+              return aliased_inputs.count(input) > 0;
+            })) {
+      continue;
+    }
     auto dep_vals = DependencyCheck::getAllValsBetween(
         {reduction_tvs.begin(), reduction_tvs.end()}, {persistent_buffer});
 
@@ -986,22 +1050,69 @@ void clearMemorySpace(Fusion* fusion) {
   }
 }
 
-// Returns cached after tensors of the fusion inputs if unrolled. Otherwise
-// return empty vector.
-std::vector<TensorView*> cacheInputs(Fusion* fusion, bool unroll) {
-  if (!unroll) {
-    return {};
+// Note [ Device scalar inputs ]
+//
+// Scalars often arrive as 0-dim tensors on the device, e.g., loss scales or
+// step counts from captured graphs, which can't be passed by value like
+// scalars and CPU scalar tensors without a device to host sync. They are
+// passed by pointer like any other tensor and broadcast to the shape of
+// their consumers. Without a cache, the broadcast reads the global element
+// in the innermost loop, once per element computed by a thread, and the
+// reads can't be hoisted by nvcc as outputs may alias the input. A 0-dim
+// cache has no loops to be inlined into, so it is loaded once per thread at
+// the top of the kernel and kept in a register, which is cheaper than
+// sharing it through shared memory and a block sync. They are therefore
+// cached even when the other inputs aren't.
+//
+// Note [ Block sparse inputs ]
+//
+// where is generated as C++'s ?: operator, which only evaluates the operand
+// the condition picks. A where reading a fusion input directly from global
+// memory therefore doesn't load the elements it replaces, e.g., the zero
+// blocks of a block sparse input masked by block_sparse_mask. Caching the
+// input would load all of it ahead of the where, so the pointwise and
+// reduction schedulers leave inputs that are only picked by where uncached.
+// Such inputs are loaded an element at a time instead of vectorized, which
+// costs instructions but not bandwidth, and the bandwidth saved grows with
+// the fraction of the input the conditions don't pick.
+bool isOnlySelectedByWhere(TensorView* tv) {
+  if (tv->uses().empty()) {
+    return false;
   }
+  return std::all_of(tv->uses().begin(), tv->uses().end(), [tv](Expr* use) {
+    auto top = dynamic_cast<TernaryOp*>(use);
+    return top != nullptr &&
+        top->getTernaryOpType() == TernaryOpType::Where && top->in1() != tv &&
+        (top->in2() == tv) != (top->in3() == tv);
+  });
+}
 
+// Returns cached after tensors of the fusion inputs if unrolled. Otherwise
+// only 0-dim inputs on the device are cached, see Note [ Device scalar inputs ]
+// Inputs only picked by where are left uncached when skip_selected_inputs is
+// set, see Note [ Block sparse inputs ]
+std::vector<TensorView*> cacheInputs(
+    Fusion* fusion,
+    bool unroll,
+    bool skip_selected_inputs) {
   std::vector<TensorView*> cached_inputs;
   // If we're going to unroll, make a cache of the inputs
   auto in_tvs = ir_utils::filterByType<TensorView>(fusion->inputs());
   for (auto tv : in_tvs) {
+    const bool is_device_scalar = !tv->isCpuScalar() &&
+        TensorDomain::noReductions(tv->getMaybeRFactorDomain()).empty();
+    if (!unroll && !is_device_scalar) {
+      continue;
+    }
     if (tv->uses().empty() || ir_utils::isTorchGatherIndicesTv(tv) ||
         ir_utils::isTorchGatherLookupTv(tv) || ir_utils::isSelectInput(tv) ||
-        ir_utils::isIndexSelectLookupTv(tv)) {
+        ir_utils::isIndexSelectLookupTv(tv) || ir_utils::isScatterSelfTv(tv)) {
       // Right now, tensors that are input to the select op can't be cached as
-      // they must be in global memory.
+      // they must be in global memory. The self tensor of scatter is copied
+      // into its output by the executor, see Note [ Scatter outputs ].
+      continue;
+    }
+    if (skip_selected_inputs && isOnlySelectedByWhere(tv)) {
       continue;
     }
     auto cached_tv = tv->cacheAfter();
@@ -1360,7 +1471,8 @@ std::vector<TensorView*> getInputsOutputsWithInnerDim(
     // ignore it's lookup_tv.
     if (ir_utils::isTorchGatherLookupTv(input_tv) ||
         ir_utils::isTorchGatherIndicesTv(input_tv) ||
-        ir_utils::isIndexSelectLookupTv(input_tv)) {
+        ir_utils::isIndexSelectLookupTv(input_tv) ||
+        ir_utils::isScatterSelfTv(input_tv)) {
       continue;
     }
     if (hasInnerDim(input_tv, vectorizable_dims, vectorize_pass)) {
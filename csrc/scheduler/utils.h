@@ -51,6 +51,32 @@ inline int64_t safeDiv(const int64_t x, const int64_t y) {
   return std::max(x / y, (int64_t)1);
 }
 
+// Bytes of shared memory a block of the current device can use for
+// persistent buffers of inner persistent kernels, 0 if staging persistent
+// buffers in shared memory is disabled. See Note [ Shared memory persistent
+// buffers ] in normalization.cpp
+TORCH_CUDA_CU_API int64_t smemPersistentBufferSize();
+
+// Number of SMs heuristics size grids for, i.e. the SMs of the current
+// device, or the SM budget of the enclosing SmBudgetGuard if it is smaller.
+// See Note [ Execution policy ] in kernel_cache.cpp
+TORCH_CUDA_CU_API int64_t numSMs();
+
+// SM budget numSMs is limited to in the current thread, if any
+TORCH_CUDA_CU_API c10::optional<int64_t> smBudget();
+
+// Limits numSMs of the current thread to `sm_budget` while in scope.
+// nullopt removes the limit.
+class TORCH_CUDA_CU_API SmBudgetGuard : public NonCopyable {
+ public:
+  explicit SmBudgetGuard(c10::optional<int64_t> sm_budget);
+
+  ~SmBudgetGuard();
+
+ private:
+  c10::optional<int64_t> prev_sm_budget_;
+};
+
 // Split the given dimensions in `to_split`. Also update the dimensions in
 // `to_update` to the positions in the splitted tensor. Splitting one dimension
 // multiple times is supported, and if this is the case, then the order of
@@ -219,10 +245,17 @@ std::vector<TensorView*> getTVsWithNonReductionRFactor(Fusion* fusion);
 void clearMemorySpace(Fusion* fusion);
 
 // Returns cached after tensors of the fusion inputs if unrolled. Otherwise
-// return empty vector.
+// only 0-dim inputs on the device are cached, see Note [ Device scalar inputs ]
+// Inputs only picked by where are left uncached when skip_selected_inputs is
+// set, see Note [ Block sparse inputs ]
 TORCH_CUDA_CU_API std::vector<TensorView*> cacheInputs(
     Fusion* fusion,
-    bool unroll);
+    bool unroll,
+    bool skip_selected_inputs = false);
+
+// Whether every use of tv is the operand a where picks if its condition holds
+// or doesn't, i.e., neither the condition itself nor both operands
+TORCH_CUDA_CU_API bool isOnlySelectedByWhere(TensorView* tv);
 
 // Returns the pairs of <cache of each fusion output, corresponding output> for
 // all outputs.
@@ -562,17 +595,42 @@ void propagateViewTransforms(Fusion* fusion, const ComputeAtMap& ca_map);
 //! Check if tv is an output of a fastest-dim reduction
 bool isFastestDimReduction(TensorView* tv);
 
-// A wrapper for Fusion::rotateLoop that provide more consistent interace
+// A wrapper for Fusion::rotateLoop that provide more consistent interace.
+// An optional rotation is skipped at lowering if the selection can't be
+// rotated, see rotateLoops
 inline void rotateLoop(
     TensorView* loop_tv,
     int64_t axis,
-    std::unordered_set<Statement*> selection) {
+    std::unordered_set<Statement*> selection,
+    bool optional = false) {
   auto fusion = loop_tv->fusion();
-  if (!fusion->hasManaged("loop_rotation")) {
-    fusion->manage("loop_rotation", LoopRotationParam{});
+  const std::string name =
+      optional ? "optional_loop_rotation" : "loop_rotation";
+  if (!fusion->hasManaged(name)) {
+    fusion->manage(name, LoopRotationParam{});
+  }
+  fusion->getManaged<LoopRotationParam>(name).emplace_back(
+      loop_tv, axis, std::move(selection));
+}
+
+// Registers the split producing axis `axis` of tv as divisible. See
+// Note [ Assumed divisible splits ] in lower_divisible_split.h for when a
+// scheduler may do so.
+inline void assumeDivisibleSplit(TensorView* tv, int64_t axis) {
+  auto split = dynamic_cast<Split*>(tv->axis((int)axis)->definition());
+  TORCH_INTERNAL_ASSERT(
+      split != nullptr,
+      "Axis ",
+      axis,
+      " of ",
+      tv->toString(),
+      " is not produced by a split");
+  auto fusion = tv->fusion();
+  const std::string name = "assumed_divisible_splits";
+  if (!fusion->hasManaged(name)) {
+    fusion->manage(name, std::vector<IterDomain*>{});
   }
-  fusion->getManaged<LoopRotationParam>("loop_rotation")
-      .emplace_back(loop_tv, axis, std::move(selection));
+  fusion->getManaged<std::vector<IterDomain*>>(name).push_back(split->outer());
 }
 
 //! Certain tensors may need to be placed on shared or global memory
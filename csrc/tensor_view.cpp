@@ -312,11 +312,22 @@ TensorView::TensorView(const TensorView* src, IrCloner* ir_cloner)
       is_double_buffered_(src->is_double_buffered_),
       is_circular_buffered_(src->is_circular_buffered_),
       circular_buffer_stage_(src->circular_buffer_stage_),
+      cache_hint_(src->cache_hint_),
       cpu_scalar_(src->cpu_scalar_),
       has_swizzle_op_(src->has_swizzle_op_),
       compute_with_consumers_(ir_cloner->clone(src->compute_with_consumers_)),
       compute_with_pos_(src->compute_with_pos_) {}
 
+void TensorView::setDomain(TensorDomain* td) {
+  // Only the loop transformations are kept by the cached analyses of the
+  // tensor graph. See Note [ Cached tensor graph analyses ]
+  if (domain_ != nullptr &&
+      domain_->getMaybeRFactorDomain() != td->getMaybeRFactorDomain()) {
+    fusion()->invalidateTvGraph();
+  }
+  domain_ = td;
+}
+
 bool TensorView::hasReduction() const {
   return domain()->hasReduction();
 }
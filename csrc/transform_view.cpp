@@ -16,6 +16,9 @@
 #include <ops/arith.h>
 #include <transform_iter.h>
 
+#include <map>
+#include <mutex>
+
 namespace nvfuser {
 
 //! There's three domains associated with performing a view operation:
@@ -213,11 +216,15 @@ class MergeTransform final : public ViewTransform {
   }
 };
 
-//! The split tranformation creates two new iterDomains via an outer split.
+//! The split tranformation creates two new iterDomains via an outer split, or
+//! an inner split when splitting off the leading dimension of the new view,
+//! see Note [ Symbolic reshapes ].
 class SplitTransform final : public ViewTransform {
  public:
-  SplitTransform(const int64_t index, int64_t split_factor)
-      : ViewTransform(index), split_factor_(split_factor) {
+  SplitTransform(const int64_t index, int64_t split_factor, bool inner_split)
+      : ViewTransform(index),
+        split_factor_(split_factor),
+        inner_split_(inner_split) {
     TORCH_INTERNAL_ASSERT(
         split_factor > 0,
         "Split factors must be greater than 0, but found ",
@@ -227,7 +234,8 @@ class SplitTransform final : public ViewTransform {
 
   virtual std::string toString() const override {
     std::stringstream ss;
-    ss << "Split Index at: " << index_ << " by: " << split_factor_ << std::endl;
+    ss << (inner_split_ ? "Inner " : "") << "Split Index at: " << index_
+       << " by: " << split_factor_ << std::endl;
     return ss.str();
   }
 
@@ -256,36 +264,44 @@ class SplitTransform final : public ViewTransform {
     Val* remainder = ceilDiv(id->extent(), factor);
 
     // outer loop IterDomain
-    IterDomain* factor_id =
-        IterDomainBuilder(FusionGuard::getCurFusion()->zeroVal(), factor)
+    IterDomain* outer_id =
+        IterDomainBuilder(
+            FusionGuard::getCurFusion()->zeroVal(),
+            inner_split_ ? remainder : factor)
             .parallel_type(id->getParallelType())
             .iter_type(id->getIterType())
             .is_rfactor_domain(true)
             .build();
 
     // inner loop IterDomain
-    IterDomain* remainder_id =
+    IterDomain* inner_id =
         IterDomainBuilder(
-            FusionGuard::getCurFusion()->zeroVal(), remainder->as<Int>())
+            FusionGuard::getCurFusion()->zeroVal(),
+            inner_split_ ? factor : remainder)
             .is_rfactor_domain(true)
             .build();
 
-    IrBuilder::create<Split>(factor_id, remainder_id, id, factor, false);
+    IrBuilder::create<Split>(outer_id, inner_id, id, factor, inner_split_);
 
     current_transformed_domain.erase(
         current_transformed_domain.begin() + index_);
     current_transformed_domain.insert(
-        current_transformed_domain.begin() + index_, remainder_id);
+        current_transformed_domain.begin() + index_, inner_id);
     current_transformed_domain.insert(
-        current_transformed_domain.begin() + index_, factor_id);
+        current_transformed_domain.begin() + index_, outer_id);
   }
 
   int64_t split_factor() const {
     return split_factor_;
   }
 
+  bool innerSplit() const {
+    return inner_split_;
+  }
+
  private:
   const int64_t split_factor_ = 0;
+  const bool inner_split_ = false;
 };
 
 //! For any singleton dimensions in the new view, we create an implicit
@@ -376,6 +392,10 @@ class AnalyzeViewTransformation {
         constraint.split_merge_string.push_back(split_merge->index());
         constraint.split_merge_string.push_back(
             split_merge->as<SplitTransform>()->split_factor());
+        // Inner splits are marked by -1
+        if (split_merge->as<SplitTransform>()->innerSplit()) {
+          constraint.split_merge_string.push_back(-1);
+        }
         constraint.split_merge_string.push_back(-2);
       } else {
         TORCH_INTERNAL_ASSERT(
@@ -603,10 +623,16 @@ class AnalyzeViewTransformation {
 
       if (new_view_index < (int64_t)new_view_.size() &&
           current_size % new_view_.at(new_view_index) == 0) {
-        // Insert split to generate the next new_view domain.
+        // Insert split to generate the next new_view domain. The leading
+        // dimension is split off by the size of the remainder so its extent
+        // stays symbolic, see Note [ Symbolic reshapes ].
+        const bool inner_split = new_view_index == 0;
+        const int64_t remainder = current_size / new_view_.at(new_view_index);
         view_transforms_.push_back(std::make_shared<SplitTransform>(
-            transform_view_index, new_view_.at(new_view_index)));
-        current_size /= new_view_.at(new_view_index);
+            transform_view_index,
+            inner_split ? remainder : new_view_.at(new_view_index),
+            inner_split));
+        current_size = remainder;
         TORCH_INTERNAL_ASSERT(current_size > 1, "This should be unreachable.");
         // Update transform and new since a split doesn't increment from the
         // original domain we're working on.
@@ -758,10 +784,34 @@ AnalyzeViewConstraint analyzeViewConstraint(
     const std::vector<int64_t>& original_sizes,
     const std::vector<int64_t>& new_sizes) {
   FUSER_PERF_SCOPE("analyzeViewConstraint");
+  // Bound of the cached constraints, the cache is cleared beyond it
+  constexpr size_t kMaxCachedConstraints = 4096;
+  static std::mutex cache_mutex;
+  static std::map<
+      std::pair<std::vector<int64_t>, std::vector<int64_t>>,
+      AnalyzeViewConstraint>
+      cache;
+
+  auto key = std::make_pair(original_sizes, new_sizes);
+  {
+    std::lock_guard<std::mutex> guard(cache_mutex);
+    auto it = cache.find(key);
+    if (it != cache.end()) {
+      return it->second;
+    }
+  }
+
   auto sizes = inferViewShapes(original_sizes, new_sizes);
   AnalyzeViewTransformation analyzer(
       sizes.first /* original_view */, sizes.second /* new_view */);
-  return analyzer.constraint();
+  auto constraint = analyzer.constraint();
+
+  std::lock_guard<std::mutex> guard(cache_mutex);
+  if (cache.size() >= kMaxCachedConstraints) {
+    cache.clear();
+  }
+  cache.emplace(std::move(key), constraint);
+  return constraint;
 }
 
 //! Create new TensorDomain with a modified rfactor domain using the specified
@@ -37,6 +37,19 @@ class ViewTransform;
 //! in the new shape.
 //!
 
+// Note [ Symbolic reshapes ]
+//
+// The view transformations only bury the sizes of the original and new
+// shapes in split factors, so the same transformations apply to all shapes
+// with the same AnalyzeViewConstraint. Splits are outer splits by the size of
+// the new dimension, except for the leading dimension of the new view, which
+// is split off by the size of the remainder. The leading dimension usually is
+// the batch, so splits and merges of the leading dimensions don't depend on
+// the batch size, e.g. [B * S, H] -> [B, S, H] splits by S and
+// [B, S, H] -> [B * S, H] only merges. Fusions with such reshapes reuse their
+// kernels across batch sizes, and the python frontend reuses the definitions
+// of reshapes with the same constraint, see ReshapeOpRecord.
+
 struct AnalyzeViewResult {
   std::vector<bool> broadcast_axes;
   std::vector<bool> squeeze_axes;
@@ -110,7 +123,8 @@ AnalyzeViewResult analyzeView(
     const std::vector<int64_t>& original_sizes,
     const std::vector<int64_t>& new_sizes);
 
-// Find the constraints derived from the view transformations
+// Find the constraints derived from the view transformations. The constraints
+// are cached by the sizes as they are checked on every run of a fusion.
 TORCH_CUDA_CU_API AnalyzeViewConstraint analyzeViewConstraint(
     const std::vector<int64_t>& original_sizes,
     const std::vector<int64_t>& new_sizes);
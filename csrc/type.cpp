@@ -113,6 +113,10 @@ static std::string data_type2string(DataType t) {
               return "nvfuser_index_t";
             case DataType::Int32:
               return "int";
+            case DataType::Int8:
+              return "int8_t";
+            case DataType::UInt8:
+              return "uint8_t";
             case DataType::SMemAddress:
               return "unsigned";
             case DataType::ComplexFloat:
@@ -189,6 +193,7 @@ bool needFloatSuffix(UnaryOpType t) {
   switch (t) {
     case UnaryOpType::Abs:
     case UnaryOpType::Cast:
+    case UnaryOpType::FastDivMultiplier:
     case UnaryOpType::Frac:
     case UnaryOpType::Gelu:
     case UnaryOpType::Imag:
@@ -255,6 +260,8 @@ static const char* unary_op_type2string(UnaryOpType t) {
       return "erfinv";
     case UnaryOpType::Erfcinv:
       return "erfcinv";
+    case UnaryOpType::FastDivMultiplier:
+      return "fastDivMultiplier";
     case UnaryOpType::Floor:
       return "floor";
     case UnaryOpType::Frac:
@@ -517,6 +524,8 @@ static const char* ternary_op_type2string(TernaryOpType t) {
   switch (t) {
     case TernaryOpType::Clamp:
       return "clamp";
+    case TernaryOpType::FastDiv:
+      return "fastDiv";
     case TernaryOpType::Lerp:
       return "lerp";
     case TernaryOpType::Threshold:
@@ -683,6 +692,19 @@ static const char* load_store_type2string(LoadStoreOpType t) {
   }
 }
 
+static const char* cache_hint2string(CacheHint t) {
+  switch (t) {
+    case CacheHint::Default:
+      return "Default";
+    case CacheHint::EvictFirst:
+      return "EvictFirst";
+    case CacheHint::EvictLast:
+      return "EvictLast";
+    default:
+      TORCH_INTERNAL_ASSERT(false, "Unexpected cache hint");
+  }
+}
+
 const unsigned int _WORD_SHIFT = 16;
 constexpr unsigned int supported_switch_pair(PrimDataType t1, PrimDataType t2) {
   return ((unsigned int)t1 << _WORD_SHIFT) + (unsigned int)t2;
@@ -696,6 +718,8 @@ static const char* supported_casts2string(
     case supported_switch_pair(DataType::Index, DataType::Float):
     case supported_switch_pair(DataType::Int, DataType::Float):
     case supported_switch_pair(DataType::Int32, DataType::Float):
+    case supported_switch_pair(DataType::Int8, DataType::Float):
+    case supported_switch_pair(DataType::UInt8, DataType::Float):
     case supported_switch_pair(DataType::Double, DataType::Float):
     case supported_switch_pair(DataType::Bool, DataType::Float):
       return "(float)";
@@ -704,6 +728,8 @@ static const char* supported_casts2string(
       return "(float)std::real";
     case supported_switch_pair(DataType::Index, DataType::Int):
     case supported_switch_pair(DataType::Int32, DataType::Int):
+    case supported_switch_pair(DataType::Int8, DataType::Int):
+    case supported_switch_pair(DataType::UInt8, DataType::Int):
     case supported_switch_pair(DataType::Float, DataType::Int):
     case supported_switch_pair(DataType::Double, DataType::Int):
     case supported_switch_pair(DataType::Bool, DataType::Int):
@@ -713,6 +739,8 @@ static const char* supported_casts2string(
       return "(int64_t)std::real";
     case supported_switch_pair(DataType::Index, DataType::Int32):
     case supported_switch_pair(DataType::Int, DataType::Int32):
+    case supported_switch_pair(DataType::Int8, DataType::Int32):
+    case supported_switch_pair(DataType::UInt8, DataType::Int32):
     case supported_switch_pair(DataType::Float, DataType::Int32):
     case supported_switch_pair(DataType::Double, DataType::Int32):
     case supported_switch_pair(DataType::Bool, DataType::Int32):
@@ -720,8 +748,26 @@ static const char* supported_casts2string(
     case supported_switch_pair(DataType::ComplexFloat, DataType::Int32):
     case supported_switch_pair(DataType::ComplexDouble, DataType::Int32):
       return "(int32_t)std::real";
+    case supported_switch_pair(DataType::Index, DataType::Int8):
+    case supported_switch_pair(DataType::Int, DataType::Int8):
+    case supported_switch_pair(DataType::Int32, DataType::Int8):
+    case supported_switch_pair(DataType::UInt8, DataType::Int8):
+    case supported_switch_pair(DataType::Float, DataType::Int8):
+    case supported_switch_pair(DataType::Double, DataType::Int8):
+    case supported_switch_pair(DataType::Bool, DataType::Int8):
+      return "(int8_t)";
+    case supported_switch_pair(DataType::Index, DataType::UInt8):
+    case supported_switch_pair(DataType::Int, DataType::UInt8):
+    case supported_switch_pair(DataType::Int32, DataType::UInt8):
+    case supported_switch_pair(DataType::Int8, DataType::UInt8):
+    case supported_switch_pair(DataType::Float, DataType::UInt8):
+    case supported_switch_pair(DataType::Double, DataType::UInt8):
+    case supported_switch_pair(DataType::Bool, DataType::UInt8):
+      return "(uint8_t)";
     case supported_switch_pair(DataType::Int, DataType::Index):
     case supported_switch_pair(DataType::Int32, DataType::Index):
+    case supported_switch_pair(DataType::Int8, DataType::Index):
+    case supported_switch_pair(DataType::UInt8, DataType::Index):
     case supported_switch_pair(DataType::Float, DataType::Index):
     case supported_switch_pair(DataType::Double, DataType::Index):
       return "(nvfuser_index_t)";
@@ -731,6 +777,8 @@ static const char* supported_casts2string(
     case supported_switch_pair(DataType::Index, DataType::Double):
     case supported_switch_pair(DataType::Int, DataType::Double):
     case supported_switch_pair(DataType::Int32, DataType::Double):
+    case supported_switch_pair(DataType::Int8, DataType::Double):
+    case supported_switch_pair(DataType::UInt8, DataType::Double):
     case supported_switch_pair(DataType::Float, DataType::Double):
     case supported_switch_pair(DataType::Bool, DataType::Double):
       return "(double)";
@@ -741,6 +789,8 @@ static const char* supported_casts2string(
     case supported_switch_pair(DataType::Double, DataType::Bool):
     case supported_switch_pair(DataType::Int32, DataType::Bool):
     case supported_switch_pair(DataType::Int, DataType::Bool):
+    case supported_switch_pair(DataType::Int8, DataType::Bool):
+    case supported_switch_pair(DataType::UInt8, DataType::Bool):
       return "(bool)";
     case supported_switch_pair(DataType::ComplexFloat, DataType::Bool):
     case supported_switch_pair(DataType::ComplexDouble, DataType::Bool):
@@ -767,6 +817,8 @@ static const char* supported_casts2string(
     case supported_switch_pair(DataType::Double, DataType::Half):
       return "__double2half";
     case supported_switch_pair(DataType::Int32, DataType::Half):
+    case supported_switch_pair(DataType::Int8, DataType::Half):
+    case supported_switch_pair(DataType::UInt8, DataType::Half):
       return "__int322half";
     case supported_switch_pair(DataType::Int, DataType::Half):
       return "__int2half";
@@ -784,6 +836,10 @@ static const char* supported_casts2string(
       return "__half2int32";
     case supported_switch_pair(DataType::Half, DataType::Int):
       return "__half2int";
+    case supported_switch_pair(DataType::Half, DataType::Int8):
+      return "(int8_t)__half2int32";
+    case supported_switch_pair(DataType::Half, DataType::UInt8):
+      return "(uint8_t)__half2int32";
     case supported_switch_pair(DataType::Half, DataType::Bool):
       return "__half2bool";
     case supported_switch_pair(DataType::Half, DataType::ComplexFloat):
@@ -798,6 +854,8 @@ static const char* supported_casts2string(
     case supported_switch_pair(DataType::Half, DataType::BFloat16):
       return "__half2bfloat";
     case supported_switch_pair(DataType::Int32, DataType::BFloat16):
+    case supported_switch_pair(DataType::Int8, DataType::BFloat16):
+    case supported_switch_pair(DataType::UInt8, DataType::BFloat16):
       return "__int322bfloat";
     case supported_switch_pair(DataType::Int, DataType::BFloat16):
       return "__int2bfloat";
@@ -817,6 +875,10 @@ static const char* supported_casts2string(
       return "__bfloat2int32";
     case supported_switch_pair(DataType::BFloat16, DataType::Int):
       return "__bfloat2int";
+    case supported_switch_pair(DataType::BFloat16, DataType::Int8):
+      return "(int8_t)__bfloat2int32";
+    case supported_switch_pair(DataType::BFloat16, DataType::UInt8):
+      return "(uint8_t)__bfloat2int32";
     case supported_switch_pair(DataType::BFloat16, DataType::Bool):
       return "__bfloat2bool";
     case supported_switch_pair(DataType::BFloat16, DataType::ComplexFloat):
@@ -845,6 +907,10 @@ DataType aten_to_data_type(const at::ScalarType& scalar_type) {
       return DataType::Int;
     case at::ScalarType::Int:
       return DataType::Int32;
+    case at::ScalarType::Char:
+      return DataType::Int8;
+    case at::ScalarType::Byte:
+      return DataType::UInt8;
     case at::ScalarType::ComplexFloat:
       return DataType::ComplexFloat;
     case at::ScalarType::ComplexDouble:
@@ -877,6 +943,10 @@ at::ScalarType data_type_to_aten(const DataType& data_type) {
           "There's also this information in FusionExecutorCache and the Registry system.");
     case DataType::Int32:
       return at::ScalarType::Int;
+    case DataType::Int8:
+      return at::ScalarType::Char;
+    case DataType::UInt8:
+      return at::ScalarType::Byte;
     case DataType::ComplexFloat:
       return at::ScalarType::ComplexFloat;
     case DataType::ComplexDouble:
@@ -910,6 +980,9 @@ std::ostream& operator<<(std::ostream& out, const ScatterOpType sotype) {
   if (sotype == ScatterOpType::Set) {
     return out << "scatter";
   }
+  if (sotype == ScatterOpType::Add) {
+    return out << "scatter_add";
+  }
   TORCH_INTERNAL_ASSERT(false, "No scatterOp type found for scatterOp.");
 }
 
@@ -939,6 +1012,10 @@ std::ostream& operator<<(
   return out << load_store_type2string(load_store_type);
 }
 
+std::ostream& operator<<(std::ostream& out, const CacheHint cache_hint) {
+  return out << cache_hint2string(cache_hint);
+}
+
 std::ostream& operator<<(std::ostream& out, const IterType bt) {
   return out << iter_type2string(bt);
 }
@@ -1057,6 +1134,8 @@ std::string typePrefix(const DataType data_type) {
     case DataType::Index:
     case DataType::Int:
     case DataType::Int32:
+    case DataType::Int8:
+    case DataType::UInt8:
     case DataType::SMemAddress:
       return "i";
     case DataType::ComplexFloat:
@@ -1121,6 +1200,10 @@ size_t dataTypeSize(DataType type) {
               return sizeof(uint64_t);
             case DataType::Int32:
               return sizeof(uint32_t);
+            case DataType::Int8:
+              return sizeof(int8_t);
+            case DataType::UInt8:
+              return sizeof(uint8_t);
             case DataType::SMemAddress:
               return sizeof(unsigned);
             default:
@@ -78,6 +78,8 @@ enum class PrimDataType {
   Int32,
   Bool,
   BFloat16,
+  Int8,
+  UInt8,
   ComplexFloat,
   ComplexDouble,
   // Pointers
@@ -118,6 +120,8 @@ struct DataType {
   static constexpr PrimDataType Int32 = PrimDataType::Int32;
   static constexpr PrimDataType Bool = PrimDataType::Bool;
   static constexpr PrimDataType BFloat16 = PrimDataType::BFloat16;
+  static constexpr PrimDataType Int8 = PrimDataType::Int8;
+  static constexpr PrimDataType UInt8 = PrimDataType::UInt8;
   static constexpr PrimDataType ComplexFloat = PrimDataType::ComplexFloat;
   static constexpr PrimDataType ComplexDouble = PrimDataType::ComplexDouble;
   static constexpr PrimDataType SMemAddress = PrimDataType::SMemAddress;
@@ -164,6 +168,8 @@ TORCH_CUDA_CU_API inline bool isIntegralType(DataType dtype) {
             case DataType::Index:
             case DataType::Int:
             case DataType::Int32:
+            case DataType::Int8:
+            case DataType::UInt8:
               return true;
             case DataType::Null:
               TORCH_CHECK(
@@ -230,6 +236,8 @@ DEFINE_DATATYPE_TO_NATIVE_TYPE(DataType::Float, float);
 DEFINE_DATATYPE_TO_NATIVE_TYPE(DataType::Double, double);
 DEFINE_DATATYPE_TO_NATIVE_TYPE(DataType::Int, int64_t);
 DEFINE_DATATYPE_TO_NATIVE_TYPE(DataType::Int32, int);
+DEFINE_DATATYPE_TO_NATIVE_TYPE(DataType::Int8, int8_t);
+DEFINE_DATATYPE_TO_NATIVE_TYPE(DataType::UInt8, uint8_t);
 DEFINE_DATATYPE_TO_NATIVE_TYPE(DataType::Bool, bool);
 DEFINE_DATATYPE_TO_NATIVE_TYPE(DataType::ComplexFloat, std::complex<float>);
 DEFINE_DATATYPE_TO_NATIVE_TYPE(DataType::ComplexDouble, std::complex<double>);
@@ -260,6 +268,7 @@ enum class UnaryOpType {
   Erfc,
   Erfinv,
   Erfcinv,
+  FastDivMultiplier,
   Floor,
   Frac,
   Gelu,
@@ -344,7 +353,7 @@ enum class BinaryOpType {
   Xor
 };
 
-enum class ScatterOpType { Set };
+enum class ScatterOpType { Set, Add };
 
 enum class RNGOpType {
   Uniform, // Uniform in [0, 1)
@@ -363,7 +372,7 @@ bool isLogicalOp(const BinaryOpType bopt);
 // on input, for example bitwise_and is also used for boolean and in the jit
 bool alsoBooleanOperator(const BinaryOpType bopt);
 
-enum class TernaryOpType { Clamp, Lerp, Threshold, Where };
+enum class TernaryOpType { Clamp, FastDiv, Lerp, Threshold, Where };
 
 enum class ParallelType {
   BIDz,
@@ -447,6 +456,16 @@ enum class LoadStoreOpType {
   CpAsyncCg
 };
 
+// Note [ Cache hints ]
+//
+// Vectorized accesses of global tensors use the streaming (.cs) cache
+// operator by default. A scheduler can give a global tensor a cache hint to
+// set the eviction priority of its vectorized loads and stores instead, e.g.,
+// EvictLast for a broadcast operand that all blocks read again and
+// EvictFirst for the streaming operands, so that the streaming data doesn't
+// evict the reused data from L2. See CacheHint in runtime/array.cu.
+enum class CacheHint { Default, EvictFirst, EvictLast };
+
 // Used to label what part of the double buffered iterdomain
 //  a for loop is materializing.
 enum class DoubleBufferLoopStage { NotApplicable, Prolog, Main, Epilog };
@@ -600,6 +619,7 @@ TORCH_CUDA_CU_API std::ostream& operator<<(std::ostream&, const IdMappingMode);
 TORCH_CUDA_CU_API std::ostream& operator<<(
     std::ostream&,
     const LoadStoreOpType);
+TORCH_CUDA_CU_API std::ostream& operator<<(std::ostream&, const CacheHint);
 TORCH_CUDA_CU_API std::ostream& operator<<(
     std::ostream&,
     const DoubleBufferLoopStage);
@@ -137,7 +137,8 @@ auto parseDebugDumpOptions() {
       {"lower_verbose", DebugDumpOption::LowerVerbose},
       {"expr_simplify", DebugDumpOption::ExprSimplification},
       {"expr_sort", DebugDumpOption::ExprSort},
-      {"loop_rotation", DebugDumpOption::LoopRotation}};
+      {"loop_rotation", DebugDumpOption::LoopRotation},
+      {"kernel_resources", DebugDumpOption::KernelResources}};
 
   return parseEnvOptions("PYTORCH_NVFUSER_DUMP", available_options);
 }
@@ -150,17 +151,41 @@ const auto& getDebugDumpOptions() {
 auto parseDisableOptions() {
   const std::unordered_map<std::string, DisableOption> available_options = {
       {"arch_check", DisableOption::ArchCheck},
+      {"assumed_divisible_splits", DisableOption::AssumedDivisibleSplits},
+      {"attention_scheduler", DisableOption::AttentionScheduler},
       {"compile_to_sass", DisableOption::CompileToSass},
       {"fallback", DisableOption::Fallback},
+      {"fast_divmod", DisableOption::FastDivMod},
       {"fma", DisableOption::Fma},
+      {"fusion_stitching", DisableOption::FusionStitching},
+      {"grid_stride_pointwise", DisableOption::GridStridePointwise},
+      {"grouped_grid_reduction_outer_opt",
+       DisableOption::GroupedGridReductionOuterOpt},
       {"grouped_grid_welford_outer_opt",
        DisableOption::GroupedGridWelfordOuterOpt},
       {"index_hoist", DisableOption::IndexHoist},
+      {"index_select_scheduler", DisableOption::IndexSelectScheduler},
+      {"int32_chunks", DisableOption::Int32Chunks},
+      {"launch_bounds", DisableOption::LaunchBounds},
+      {"lowering_cache", DisableOption::LoweringCache},
       {"expr_simplify", DisableOption::ExprSimplify},
       {"nvtx", DisableOption::Nvtx},
       {"predicate_elimination", DisableOption::PredicateElimination},
+      {"preamble_pruning", DisableOption::PreamblePruning},
+      {"persistent_reprojection", DisableOption::PersistentReprojection},
+      {"scan_scheduler", DisableOption::ScanScheduler},
+      {"scheduler_loop_rotation", DisableOption::SchedulerLoopRotation},
+      {"serial_accumulators", DisableOption::SerialAccumulators},
+      {"shuffle_reduction", DisableOption::ShuffleReduction},
+      {"smem_carveout", DisableOption::SmemCarveout},
+      {"smem_packing", DisableOption::SmemPacking},
+      {"smem_persistent_buffers", DisableOption::SmemPersistentBuffers},
+      {"stencil_scheduler", DisableOption::StencilScheduler},
+      {"tile_peeling", DisableOption::TilePeeling},
       {"welford_vectorization", DisableOption::WelfordVectorization},
-      {"magic_zero", DisableOption::MagicZero}};
+      {"magic_zero", DisableOption::MagicZero},
+      {"magic_zero_elision", DisableOption::MagicZeroElision},
+      {"workspace_pool", DisableOption::WorkspacePool}};
 
   auto options = parseEnvOptions("PYTORCH_NVFUSER_DISABLE", available_options);
 
@@ -179,19 +204,41 @@ const auto& getDisableOptions() {
 
 auto parseEnableOptions() {
   const std::unordered_map<std::string, EnableOption> available_options = {
+      {"atomic_grid_reduction", EnableOption::AtomicGridReduction},
+      {"autotune", EnableOption::Autotune},
+      {"cat_slice_outputs", EnableOption::CatSliceOutputs},
+      {"circular_buffer", EnableOption::CircularBuffer},
       {"complex", EnableOption::Complex},
+      {"concurrent_segments", EnableOption::ConcurrentSegments},
+      {"cuda_graph", EnableOption::CudaGraph},
+      {"fast_compile", EnableOption::FastCompile},
       {"kernel_profile", EnableOption::KernelProfile},
+      {"kernel_telemetry", EnableOption::KernelTelemetry},
       {"linear_decomposition", EnableOption::LinearDecomposition},
       {"conv_decomposition", EnableOption::ConvDecomposition},
       {"graph_op_fusion", EnableOption::GraphOp},
+      {"grid_persistent_reductions",
+       EnableOption::GridPersistentReductions},
+      {"half_precision_ops", EnableOption::HalfPrecisionOps},
+      {"horizontal_pointwise", EnableOption::HorizontalPointwise},
       {"kernel_db", EnableOption::KernelDb},
+      {"kernel_db_sass", EnableOption::KernelDbSass},
+      {"l2_persistence", EnableOption::L2Persistence},
+      {"misaligned_vectorize", EnableOption::MisalignedVectorize},
+      {"parallel_compile", EnableOption::ParallelCompile},
+      {"programmatic_launch", EnableOption::ProgrammaticLaunch},
+      {"prune_small_fusions", EnableOption::PruneSmallFusions},
+      {"recompute_segment_inputs", EnableOption::RecomputeSegmentInputs},
+      {"reuse_partial_reductions", EnableOption::ReusePartialReductions},
+      {"segmenter_cost_model", EnableOption::SegmenterCostModel},
       {"warn_register_spill", EnableOption::WarnRegisterSpill}};
 
   return parseEnvOptions("PYTORCH_NVFUSER_ENABLE", available_options);
 }
 
-const auto& getEnableOptions() {
-  static const auto options = parseEnableOptions();
+//! Mutable so that EnableOptionGuard can override the environment
+auto& getEnableOptions() {
+  static auto options = parseEnableOptions();
   return options;
 }
 
@@ -376,6 +423,30 @@ const std::vector<std::string>& getEnableOptionArguments(EnableOption option) {
   return getEnableOptions().at(option);
 }
 
+EnableOptionGuard::EnableOptionGuard(
+    EnableOption option,
+    bool enabled,
+    std::vector<std::string> args)
+    : option_(option) {
+  auto& options = getEnableOptions();
+  auto it = options.find(option);
+  if (it != options.end()) {
+    prev_args_ = std::move(it->second);
+    options.erase(it);
+  }
+  if (enabled) {
+    options.emplace(option, std::move(args));
+  }
+}
+
+EnableOptionGuard::~EnableOptionGuard() {
+  auto& options = getEnableOptions();
+  options.erase(option_);
+  if (prev_args_.has_value()) {
+    options.emplace(option_, std::move(prev_args_.value()));
+  }
+}
+
 bool useFallback() {
   // Keep this env var for compatibility
   const char* disable_fb_env = getenv("PYTORCH_NVFUSER_DISABLE_FALLBACK");
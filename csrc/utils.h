@@ -79,6 +79,9 @@ enum class DebugDumpOption {
   ExprSimplification, //! Print all passes' transform in simplifyExpr
   ExprSort, //! Print merging decisions on expression sorting
   LoopRotation, //! Print loop rotation log
+  KernelResources, //! Print registers, shared and local memory and occupancy
+                   //! of kernels when launching them, and their cost
+                   //! estimate when compiling them
   EndOfOption //! Placeholder for counting the number of elements
 };
 
@@ -92,18 +95,52 @@ TORCH_CUDA_CU_API const std::vector<std::string>& getDebugDumpArguments(
 //!
 enum class DisableOption {
   ArchCheck, //! Disable hardware-specific checks to enable cross arch debug
+  AssumedDivisibleSplits, //! Disable assuming splits are divisible when the
+                          //! scheduled inputs are
+  AttentionScheduler, //! Disable the attention scheduler
   CompileToSass, //! Disable direct compilation to sass so the ptx can be
                  //! examined
   Fallback, //! Disable fallback
+  FastDivMod, //! Disable fast division by loop invariant divisors
   Fma, //! Disable FMA instructions
+  FusionStitching, //! Disable stitching fusions that python frontend batches
+                   //! run in a row
+  GridStridePointwise, //! Disable grid-stride loops of large pointwise kernels
+  GroupedGridReductionOuterOpt, //! Disable use of outer-optimized
+                                //! grouped grid reduction kernel
   GroupedGridWelfordOuterOpt, //! Disable use of outer-optimized
                               //! grouped grid welford kernel
   IndexHoist, //! Disable index hoisting
+  IndexSelectScheduler, //! Disable the index_select scheduler
+  Int32Chunks, //! Disable running 64-bit indexed fusions as chunks indexed
+               //! with 32 bits
+  LaunchBounds, //! Disable launch bounds, limit registers with maxrregcount
+  LoweringCache, //! Disable sharing the lowering of identical fusions
   ExprSimplify, //! Disable expression simplifier
   Nvtx, //! Disable NVTX instrumentation
   PredicateElimination, //! Disable predicate elimination
+  PreamblePruning, //! Always include the complete runtime library in the
+                   //! kernel preamble
+  PersistentReprojection, //! Disable projecting the persistent buffers of
+                          //! kernels estimated to spill registers
+  ScanScheduler, //! Disable the scan scheduler
+  SchedulerLoopRotation, //! Disable rotating the input loads of serial
+                         //! reduction loops
+  SerialAccumulators, //! Disable multiple accumulators in the serial loop of
+                      //! inner reductions
+  ShuffleReduction, //! Disable warp shuffles in block reductions
+  SmemCarveout, //! Disable setting the shared memory carveout of kernels
+  SmemPacking, //! Disable offset packing of shared memory buffers
+  SmemPersistentBuffers, //! Disable staging persistent buffers in shared
+                         //! memory
+  StencilScheduler, //! Disable the stencil scheduler
+  TilePeeling, //! Disable peeling full tiles off predicated loop nests
   WelfordVectorization, //! Disable vectorizaton of Welford ops
   MagicZero, //! Disable nvfuser_zero
+  MagicZeroElision, //! Keep nvfuser_zero in the unpredicated version of
+                    //! unswitched loops
+  WorkspacePool, //! Disable reuse of global work buffers and semaphores
+                 //! across launches
   EndOfOption //! Placeholder for counting the number of elements
 };
 
@@ -116,12 +153,33 @@ TORCH_CUDA_CU_API const std::vector<std::string>& getDisableOptionArguments(
 //! These can be set through the `PYTORCH_NVFUSER_ENABLE` environment variable
 //!
 enum class EnableOption {
+  AtomicGridReduction, //! Accumulate non-persistent grid sums with atomics
+  Autotune, //! Autotune hot kernels in the background
+  CatSliceOutputs, //! Write cat outputs as slices of one output buffer
+  CircularBuffer, //! Circular buffer input loads of serial reduction loops
   Complex, //! Enable complex support on python
+  ConcurrentSegments, //! Launch independent segments on multiple streams
+  CudaGraph, //! Replay cached launches of segmented fusions with CUDA graphs
+  FastCompile, //! Launch low-opt kernels until full-opt recompilation is done
   KernelProfile, //! Enable intra-kernel performance profiling
+  KernelTelemetry, //! Aggregate the GPU time of every kernel of the process
   LinearDecomposition, //! Enable linear-bias decomposition
   ConvDecomposition, //! Enable conv-bias decomposition
   GraphOp, //! Enable graphOps(index_select/gather/scatter)
+  GridPersistentReductions, //! Grid persistence of non-Welford normalizations
+  HalfPrecisionOps, //! Compute exact Half/BFloat16 pointwise ops natively
+  HorizontalPointwise, //! Schedule disconnected pointwise subgraphs together
   KernelDb, //! Enable Kernel Database
+  KernelDbSass, //! Store SASS JIT compiled from PTX in the Kernel Database
+  L2Persistence, //! Keep inputs re-read by several segments or blocks in L2
+  MisalignedVectorize, //! Vectorize pointwise tensors whatever their offset
+  ParallelCompile, //! Compile all segments of a segmented fusion concurrently
+  ProgrammaticLaunch, //! Overlap the prologue of kernels with the previous
+                      //! kernel on Hopper
+  PruneSmallFusions, //! Revert TorchScript fusion groups of too few ops
+  RecomputeSegmentInputs, //! Recompute cheap pointwise inputs of segments
+  ReusePartialReductions, //! Reduce sibling reductions from narrower ones
+  SegmenterCostModel, //! Order segment merges by estimated memory traffic
   WarnRegisterSpill, //! Enable warnings of register spill
   EndOfOption //! Placeholder for counting the number of elements
 };
@@ -130,6 +188,27 @@ TORCH_CUDA_CU_API bool isOptionEnabled(EnableOption option);
 TORCH_CUDA_CU_API const std::vector<std::string>& getEnableOptionArguments(
     EnableOption option);
 
+//! Enables `option` with `args`, or disables it, on top of
+//! PYTORCH_NVFUSER_ENABLE for the lifetime of the guard. Meant for tests, the
+//! options must not be read concurrently by another thread while a guard is
+//! created or destroyed
+class TORCH_CUDA_CU_API EnableOptionGuard {
+ public:
+  explicit EnableOptionGuard(
+      EnableOption option,
+      bool enabled = true,
+      std::vector<std::string> args = {});
+  ~EnableOptionGuard();
+
+  EnableOptionGuard(const EnableOptionGuard&) = delete;
+  EnableOptionGuard& operator=(const EnableOptionGuard&) = delete;
+
+ private:
+  EnableOption option_;
+  //! arguments of the option before the guard, nullopt if it was disabled
+  c10::optional<std::vector<std::string>> prev_args_;
+};
+
 // Check if fallback path should be used which will dispatch to eagermode if any
 // errors are encountered. Helpful for debugging.
 bool useFallback();
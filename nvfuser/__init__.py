@@ -29,6 +29,21 @@ class FusionDefinition(_C._FusionDefinition):
     def schedule(self):
         raise NotImplementedError("schedule() should be implemented by child class!")
 
+    def schedule_constraints(self):
+        """
+        Shape constraints of the inputs a user defined schedule applies to.
+        By default a schedule only applies to the shapes of the inputs it was
+        defined with. A child class whose schedule doesn't depend on the
+        concrete sizes can return a list with an entry for each input: None
+        for any input, or a list with an entry for each dimension of a tensor
+        input that is None for any size, an int for an exact size or a
+        DimConstraint, e.g. DimConstraint(divisor=8).
+
+        Returns:
+            Optional[List[Optional[List[Union[None, int, DimConstraint]]]]]
+        """
+        return None
+
     def execute(self, inputs, **kwargs):
         """
         Executes an nvFuser set of kernels for a given Fusion
@@ -38,11 +53,17 @@ class FusionDefinition(_C._FusionDefinition):
 
         Kwargs:
             override_user_schedule (bool): For a user defined schedule, override with auto-generated schedule (default: False)
+            profile (bool): Time every kernel launched by the execution and
+                also return a record of each launch, in launch order, with
+                the segment, kernel name, heuristic, grid and block, time,
+                bytes, bandwidth, registers, shared memory and occupancy
+                of the kernel (default: False)
 
         Returns:
-            List[Tensor]
+            List[Tensor], or Tuple[List[Tensor], List[Dict]] when profiling
         """
         override_user_schedule = kwargs.pop("override_user_schedule", False)
+        profile = kwargs.pop("profile", False)
         func_based_def = False
 
         # if definition is not defined by a context manager, try a child class
@@ -54,13 +75,16 @@ class FusionDefinition(_C._FusionDefinition):
 
         # If schedule is defined by child class, make a schedule for inputs
         if func_based_def and (super(type(self), self).schedule != self.schedule):
-            self._setup_schedule(inputs)
+            self._setup_schedule(inputs, self.schedule_constraints())
             self.schedule()
             self._finalize_schedule(inputs)
 
         result = None
         try:
-            result = self._execute(inputs, override_user_schedule)
+            if profile:
+                result = self._profile(inputs, override_user_schedule)
+            else:
+                result = self._execute(inputs, override_user_schedule)
         except Exception as err:
             print("\nError executing nvFuser FusionDefinition:")
             print(self)
@@ -68,6 +92,68 @@ class FusionDefinition(_C._FusionDefinition):
 
         return result
 
+    def precompile(self, input_signatures):
+        """
+        Compiles the nvFuser kernels of a Fusion ahead of time for a list of
+        expected input signatures, e.g. to warm up a process before it serves
+        requests. Kernels of all signatures are compiled in parallel.
+
+        Args:
+            input_signatures (List[List[Union[Tensor, Scalar]]]): A list of
+                input lists to fusion. Only sizes, strides and dtypes of
+                tensors are used, so tensors on the "meta" device can stand in
+                for real inputs.
+        """
+        # if definition is not defined by a context manager, try a child class
+        if self.id() is None:
+            self._setup_definition()
+            self.definition()
+            self._finalize_definition()
+
+        self._precompile(input_signatures)
+
+    def bind(self, inputs):
+        """
+        Binds the auto-generated schedules of a Fusion to the signature of
+        the given inputs, i.e. to their sizes, strides, alignment and devices.
+        The returned handle re-runs inputs of the same signature without the
+        cache lookups of execute, which matters for small kernels launched in
+        a loop. User defined schedules are not considered.
+
+        Args:
+            inputs (List[Union[Tensor, Scalar]]): A list of inputs to fusion.
+
+        Returns:
+            BoundExecution: Handle whose execute(inputs) runs the fusion for
+                inputs of the bound signature and whose matches(inputs) tells
+                whether inputs have that signature.
+        """
+        # if definition is not defined by a context manager, try a child class
+        if self.id() is None:
+            self._setup_definition()
+            self.definition()
+            self._finalize_definition()
+
+        return self._bind(inputs)
+
+    def set_fast_math(self, fast_math=True):
+        """
+        Compiles the auto-generated kernels of a Fusion with hardware
+        approximations of transcendental functions (--use_fast_math and
+        tanh.approx), trading IEEE precision for speed. Only affects kernels
+        compiled afterwards, so it should be called before the first execute.
+
+        Args:
+            fast_math (bool): Whether to use fast math (default: True)
+        """
+        # if definition is not defined by a context manager, try a child class
+        if self.id() is None:
+            self._setup_definition()
+            self.definition()
+            self._finalize_definition()
+
+        self._set_fast_math(fast_math)
+
     def from_pytorch(self, tensor):
         """
         Defines an nvfuser input tensor from a pytorch tensor
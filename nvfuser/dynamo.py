@@ -0,0 +1,340 @@
+# SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+# All rights reserved.
+# SPDX-License-Identifier: BSD-3-Clause
+"""
+A torch.compile backend that runs the aten graphs captured by dynamo with
+nvFuser.
+
+    import nvfuser.dynamo
+    compiled = torch.compile(func, backend=nvfuser.dynamo.backend)
+
+Each graph is partitioned into subgraphs of the aten ops nvFuser supports,
+and every other op keeps running eagerly. A subgraph is translated into a
+FusionDefinition once per input definition (dtypes, broadcast and
+contiguity of its inputs) and then run through a bound execution (see
+FusionDefinition.bind) of the exact input signature. Graphs are recompiled
+by dynamo whenever its guards fail, so a compiled subgraph only caches over
+the inputs its guards let through.
+"""
+import torch
+from torch.fx.node import map_aggregate
+from torch.fx.passes.infra.partitioner import CapabilityBasedPartitioner
+from torch.fx.passes.operator_support import OperatorSupport
+
+from . import FusionDefinition
+from .pytorch_utils import (
+    _torch_dtype_to_nvfuser_dtype_map,
+    torch_dtype_to_nvfuser_dtype,
+)
+
+aten = torch.ops.aten
+prims = torch.ops.prims
+
+
+def _meta(node):
+    return node.meta.get("val", None) if isinstance(node, torch.fx.Node) else None
+
+
+def _static_shape(node):
+    val = _meta(node)
+    if not isinstance(val, torch.Tensor) or not all(
+        isinstance(s, int) for s in val.shape
+    ):
+        return None
+    return list(val.shape)
+
+
+def _has_static_shapes(node):
+    return (
+        _static_shape(node) is not None and _static_shape(node.args[0]) is not None
+    )
+
+
+def _scalar(fd, x):
+    if isinstance(x, (bool, int, float)):
+        return fd.define_constant(x)
+    return x
+
+
+def _reshape(fd, node, x, *args):
+    return fd.ops.reshape(x, _static_shape(node.args[0]), _static_shape(node))
+
+
+def _expand(fd, node, x, *args):
+    in_rank = len(_static_shape(node.args[0]))
+    out_shape = _static_shape(node)
+    return fd.ops.broadcast_in_dim(
+        x, out_shape, list(range(len(out_shape) - in_rank, len(out_shape)))
+    )
+
+
+def _unsqueeze(fd, node, x, dim):
+    out_shape = _static_shape(node)
+    dim = dim % len(out_shape)
+    return fd.ops.broadcast_in_dim(
+        x, out_shape, [d for d in range(len(out_shape)) if d != dim]
+    )
+
+
+def _reduction(op):
+    def translate(fd, node, x, dims=None, keepdim=False, *, dtype=None):
+        # No dims or an empty list reduce over all dimensions
+        if not dims:
+            dims = list(range(len(_meta(node.args[0]).shape)))
+        return op(fd)(x, list(dims), keepdim)
+
+    return translate
+
+
+def _binary(name):
+    def translate(fd, node, x, y):
+        return getattr(fd.ops, name)(_scalar(fd, x), _scalar(fd, y))
+
+    return translate
+
+
+def _cast(fd, node, x, dtype=None, **kwargs):
+    return fd.ops.cast(x, torch_dtype_to_nvfuser_dtype(_meta(node).dtype))
+
+
+_UNARY_OPS = {
+    aten.abs.default: "abs",
+    aten.bitwise_not.default: "bitwise_not",
+    aten.ceil.default: "ceil",
+    aten.clone.default: "set",
+    aten.cos.default: "cos",
+    aten.erf.default: "erf",
+    aten.exp.default: "exp",
+    aten.expm1.default: "expm1",
+    aten.floor.default: "floor",
+    aten.isinf.default: "isinf",
+    aten.isnan.default: "isnan",
+    aten.log.default: "log",
+    aten.log1p.default: "log1p",
+    aten.neg.default: "neg",
+    aten.reciprocal.default: "reciprocal",
+    aten.relu.default: "relu",
+    aten.rsqrt.default: "rsqrt",
+    aten.sigmoid.default: "sigmoid",
+    aten.sign.default: "sign",
+    aten.sin.default: "sin",
+    aten.sqrt.default: "sqrt",
+    aten.tanh.default: "tanh",
+    aten.trunc.default: "trunc",
+}
+
+_BINARY_OPS = {
+    "add": "add",
+    "atan2": "atan2",
+    "bitwise_and": "bitwise_and",
+    "bitwise_or": "bitwise_or",
+    "bitwise_xor": "bitwise_xor",
+    "div": "div",
+    "eq": "eq",
+    "fmod": "fmod",
+    "ge": "ge",
+    "gt": "gt",
+    "le": "le",
+    "lt": "lt",
+    "mul": "mul",
+    "ne": "ne",
+    "pow": "pow",
+    "remainder": "remainder",
+    "sub": "sub",
+}
+
+# aten op -> (translation, extra check of the node)
+_TRANSLATIONS = {}
+for _op, _name in _UNARY_OPS.items():
+    _TRANSLATIONS[_op] = (
+        lambda fd, node, x, _name=_name: getattr(fd.ops, _name)(x),
+        None,
+    )
+for _aten_name, _name in _BINARY_OPS.items():
+    for _overload in ("Tensor", "Scalar"):
+        _op = getattr(getattr(aten, _aten_name), _overload, None)
+        if _op is None:
+            continue
+        _TRANSLATIONS[_op] = (
+            _binary(_name),
+            # Only the default alpha of add/sub and rounding mode of div
+            lambda node: not node.kwargs,
+        )
+_TRANSLATIONS.update(
+    {
+        aten.where.self: (
+            lambda fd, node, c, x, y: fd.ops.where(c, x, y),
+            None,
+        ),
+        aten.sum.default: (_reduction(lambda fd: fd.ops.sum), None),
+        aten.sum.dim_IntList: (_reduction(lambda fd: fd.ops.sum), None),
+        aten.amax.default: (_reduction(lambda fd: fd.ops.max), None),
+        prims.convert_element_type.default: (_cast, None),
+        aten._to_copy.default: (
+            _cast,
+            lambda node: set(node.kwargs) <= {"dtype"},
+        ),
+        aten.permute.default: (
+            lambda fd, node, x, dims: fd.ops.permute(x, list(dims)),
+            None,
+        ),
+        aten.view.default: (_reshape, _has_static_shapes),
+        aten._unsafe_view.default: (_reshape, _has_static_shapes),
+        aten.reshape.default: (_reshape, _has_static_shapes),
+        aten.expand.default: (_expand, _has_static_shapes),
+        aten.unsqueeze.default: (_unsqueeze, _has_static_shapes),
+    }
+)
+
+
+_CASTS = (prims.convert_element_type.default, aten._to_copy.default)
+
+
+class _NvFuserOperatorSupport(OperatorSupport):
+    """Aten ops of CUDA tensors nvFuser can translate"""
+
+    def is_node_supported(self, submodules, node):
+        if node.op != "call_function" or node.target not in _TRANSLATIONS:
+            return False
+        _, check = _TRANSLATIONS[node.target]
+        if check is not None and not check(node):
+            return False
+        vals = [_meta(node)] + [_meta(a) for a in node.all_input_nodes]
+        for val in vals:
+            if not isinstance(val, torch.Tensor):
+                return False
+            if (
+                not val.is_cuda
+                or val.dtype not in _torch_dtype_to_nvfuser_dtype_map
+            ):
+                return False
+        return True
+
+
+def _definition_key(inputs):
+    """What a FusionDefinition depends on: dtypes, broadcasts and contiguity"""
+    key = []
+    for inp in inputs:
+        if not isinstance(inp, torch.Tensor):
+            key.append(type(inp))
+            continue
+        sizes, strides = inp.size(), inp.stride()
+        contiguous = [
+            strides[i] == (strides[i + 1] * sizes[i + 1] if i + 1 < len(sizes) else 1)
+            for i in range(len(sizes))
+        ]
+        key.append((inp.dtype, tuple(s == 1 for s in sizes), tuple(contiguous)))
+    return tuple(key)
+
+
+def _translate(graph_module, inputs):
+    """Records the aten graph of a partition as a FusionDefinition"""
+    fd = FusionDefinition()
+    with fd:
+        env = {}
+        placeholders = iter(inputs)
+        for node in graph_module.graph.nodes:
+            if node.op == "placeholder":
+                inp = next(placeholders)
+                if isinstance(inp, torch.Tensor):
+                    env[node] = fd.define_tensor(
+                        sizes=inp.size(),
+                        strides=inp.stride(),
+                        dtype=torch_dtype_to_nvfuser_dtype(inp.dtype),
+                    )
+                else:
+                    env[node] = fd.define_scalar(
+                        torch_dtype_to_nvfuser_dtype(type(inp))
+                    )
+            elif node.op == "call_function":
+                translate, _ = _TRANSLATIONS[node.target]
+                args = [
+                    env[a] if isinstance(a, torch.fx.Node) else a for a in node.args
+                ]
+                out = translate(fd, node, *args, **node.kwargs)
+                # Keep the dtype aten computes, e.g., for reduced precision
+                # inputs that nvFuser computes in float
+                if node.target not in _CASTS:
+                    out = fd.ops.cast(
+                        out, torch_dtype_to_nvfuser_dtype(_meta(node).dtype)
+                    )
+                env[node] = out
+            elif node.op == "output":
+                outputs = []
+                map_aggregate(node.args[0], lambda n: outputs.append(n))
+                for out in outputs:
+                    fd.add_output(env[out])
+    return fd
+
+
+class _FusedModule(torch.nn.Module):
+    """Runs a supported partition of an FX graph with nvFuser"""
+
+    def __init__(self, graph_module):
+        super().__init__()
+        self.graph_module = graph_module
+        self.definitions = {}
+        self.bound_executions = []
+        output = next(n for n in graph_module.graph.nodes if n.op == "output")
+        self.returns_tuple = isinstance(output.args[0], (tuple, list))
+
+    def _bind(self, inputs):
+        key = _definition_key(inputs)
+        fd = self.definitions.get(key, None)
+        if fd is None:
+            fd = _translate(self.graph_module, inputs)
+            self.definitions[key] = fd
+        bound = fd.bind(inputs)
+        self.bound_executions.insert(0, bound)
+        return bound
+
+    def forward(self, *inputs):
+        bound = next(
+            (b for b in self.bound_executions if b.matches(inputs)), None
+        )
+        if bound is None:
+            bound = self._bind(inputs)
+        outputs = bound.execute(inputs)
+        return tuple(outputs) if self.returns_tuple else outputs[0]
+
+
+def compile_graph(graph_module, example_inputs):
+    """
+    Replaces the subgraphs of an aten FX graph nvFuser supports with modules
+    running them with nvFuser, keeping every other node eager.
+
+    Args:
+        graph_module (torch.fx.GraphModule): An aten graph, e.g., from
+            aot_autograd, with FakeTensor "val" metadata on its nodes
+        example_inputs (List[torch.Tensor]): Unused, partitions are
+            translated for their actual inputs when they first run
+
+    Returns:
+        torch.fx.GraphModule
+    """
+    partitioner = CapabilityBasedPartitioner(
+        graph_module, _NvFuserOperatorSupport(), allows_single_node_partition=False
+    )
+    partitions = partitioner.propose_partitions()
+    if not partitions:
+        return graph_module
+    fused_module = partitioner.fuse_partitions(partitions)
+    for node in fused_module.graph.nodes:
+        if node.op == "call_module" and node.target.startswith("fused_"):
+            submodule = getattr(fused_module, node.target)
+            setattr(fused_module, node.target, _FusedModule(submodule))
+    fused_module.recompile()
+    return fused_module
+
+
+def backend(graph_module, example_inputs):
+    """
+    torch.compile backend lowering the captured graph to aten with
+    aot_autograd and compiling its forward and backward graphs with
+    compile_graph.
+    """
+    from torch._dynamo.backends.common import aot_autograd
+
+    return aot_autograd(fw_compiler=compile_graph, bw_compiler=compile_graph)(
+        graph_module, example_inputs
+    )
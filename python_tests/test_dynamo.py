@@ -151,6 +151,50 @@ class TestNvFuserDynamo(TestCase):
         eager_result = func.__wrapped__(input1)
         self.assertEqual(eager_result, nvfuser_result)
 
+    def test_nvfuser_backend(self):
+        import nvfuser.dynamo
+
+        input1 = make_tensor((2, 4, 8), device="cuda", dtype=torch.float16)
+        input2 = make_tensor((2, 4, 8), device="cuda", dtype=torch.float16)
+
+        def func(a, b):
+            c = (a.sin() + b).relu()
+            # cumsum isn't translated and runs eagerly between the fusions
+            d = torch.cumsum(c, dim=-1)
+            return (d * 2.0).sum(dim=1)
+
+        compiled = torch.compile(func, backend=nvfuser.dynamo.backend)
+        for _ in range(2):
+            self.assertEqual(compiled(input1, input2), func(input1, input2))
+
+    def test_nvfuser_backend_caching(self):
+        from torch.fx.experimental.proxy_tensor import make_fx
+        from nvfuser.dynamo import compile_graph
+
+        input1 = make_tensor((4, 8), device="cuda", dtype=torch.float32)
+        input2 = make_tensor((4, 8), device="cuda", dtype=torch.float32)
+
+        def func(a, b):
+            return (a.exp() * b).amax(dim=0)
+
+        graph_module = compile_graph(
+            make_fx(func, tracing_mode="fake")(input1, input2), [input1, input2]
+        )
+        fused = [
+            m for n, m in graph_module.named_children() if n.startswith("fused_")
+        ]
+        self.assertEqual(len(fused), 1)
+
+        # The graph is translated once and rebound only for new signatures
+        for _ in range(3):
+            self.assertEqual(graph_module(input1, input2), func(input1, input2))
+        self.assertEqual(len(fused[0].definitions), 1)
+        self.assertEqual(len(fused[0].bound_executions), 1)
+
+        input3 = make_tensor((4, 8), device="cuda", dtype=torch.float32)
+        self.assertEqual(graph_module(input1, input3), func(input1, input3))
+        self.assertEqual(len(fused[0].bound_executions), 1)
+
 
 if __name__ == "__main__":
     run_tests()
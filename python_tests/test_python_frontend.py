@@ -26,6 +26,17 @@ try:
         DataType,
         version,
         compute_contiguity,
+        compile_stats,
+        reset_compile_stats,
+        runtime_metrics,
+        reset_runtime_metrics,
+        enable_kernel_telemetry,
+        kernel_telemetry,
+        kernel_telemetry_json,
+        reset_kernel_telemetry,
+        execute_fusions,
+        FusionOutputRef,
+        DimConstraint,
     )
     from nvfuser.pytorch_utils import torch_dtype_to_nvfuser_dtype
 except ImportError:
@@ -109,6 +120,227 @@ class TestNvFuserFrontend(TestCase):
         self.assertEqual(eager_out, nvf_out2[0])
         self.assertEqual(eager_out, nvf_out3[0])
 
+    def test_precompile(self):
+        with FusionDefinition() as fd:
+            t0 = fd.define_tensor(
+                symbolic_sizes=[-1, -1], contiguous=[True, True], dtype=DataType.Float
+            )
+            t1 = fd.ops.sum(t0, [-1], False, DataType.Float)
+            fd.add_output(t1)
+
+        shapes = [(128, 1024), (4, 65536)]
+        fd.precompile([[torch.empty(shape, device="meta")] for shape in shapes])
+
+        for shape in shapes:
+            inputs = [torch.randn(shape, device="cuda")]
+            nvf_out = fd.execute(inputs)
+            self.assertEqual(torch.sum(inputs[0], dim=-1), nvf_out[0])
+
+    def test_execute_fusions(self):
+        with FusionDefinition() as fd0:
+            t0 = fd0.define_tensor(
+                symbolic_sizes=[-1, -1], contiguous=[True, True], dtype=DataType.Float
+            )
+            c0 = fd0.define_constant(2.0)
+            t1 = fd0.ops.mul(t0, c0)
+            fd0.add_output(t1)
+
+        with FusionDefinition() as fd1:
+            t0 = fd1.define_tensor(
+                symbolic_sizes=[-1, -1], contiguous=[True, True], dtype=DataType.Float
+            )
+            t1 = fd1.define_tensor(
+                symbolic_sizes=[-1, -1], contiguous=[True, True], dtype=DataType.Float
+            )
+            t2 = fd1.ops.add(t0, t1)
+            fd1.add_output(t2)
+
+        inputs = [torch.randn(8, 16, device="cuda"), torch.randn(8, 16, device="cuda")]
+        outputs = execute_fusions(
+            [
+                (fd0, [inputs[0]]),
+                (fd1, [FusionOutputRef(0, 0), inputs[1]]),
+            ]
+        )
+        self.assertEqual(len(outputs), 2)
+        self.assertEqual(outputs[0][0], inputs[0] * 2.0)
+        self.assertEqual(outputs[1][0], inputs[0] * 2.0 + inputs[1])
+
+        # Outputs can only feed fusions that run after their producer
+        with self.assertRaisesRegex(RuntimeError, "doesn't run before it"):
+            execute_fusions([(fd1, [FusionOutputRef(0, 0), inputs[1]])])
+
+        # Repeated runs stitch the two fusions into one
+        for _ in range(4):
+            outputs = execute_fusions(
+                [
+                    (fd0, [inputs[0]]),
+                    (fd1, [FusionOutputRef(0, 0), inputs[1]]),
+                ],
+                return_intermediates=False,
+            )
+            self.assertIsNone(outputs[0][0])
+            self.assertEqual(outputs[1][0], inputs[0] * 2.0 + inputs[1])
+
+    def test_reshape_leading_dims(self):
+        def make_fusion_func(batch):
+            def fusion_func(fd: FusionDefinition):
+                t0 = fd.define_tensor(
+                    symbolic_sizes=[-1, -1],
+                    contiguous=[True, True],
+                    dtype=DataType.Float,
+                )
+                t1 = fd.ops.reshape(t0, [batch * 7, 16], [batch, 7, 16])
+                fd.add_output(t1)
+
+            return fusion_func
+
+        # Reshapes that only differ in the leading dimension share the fusion
+        for batch, new_fusion_expected in [(4, True), (8, False)]:
+            inputs = [torch.randn(batch * 7, 16, device="cuda")]
+            nvf_out, _ = self.exec_nvfuser(
+                make_fusion_func(batch), inputs, new_fusion_expected
+            )
+            self.assertEqual(nvf_out[0], inputs[0].reshape(batch, 7, 16))
+
+    def test_execute_profile(self):
+        inputs = [torch.randn(8, 16, device="cuda")]
+
+        def fusion_func(fd: FusionDefinition):
+            t0 = fd.from_pytorch(inputs[0])
+            t1 = fd.ops.sum(t0, axes=[1])
+            t2 = fd.ops.relu(t0)
+            fd.add_output(t1)
+            fd.add_output(t2)
+
+        with FusionDefinition() as fd:
+            fusion_func(fd)
+
+        outputs, kernel_profiles = fd.execute(inputs, profile=True)
+        self.assertEqual(outputs[0], torch.sum(inputs[0], dim=1))
+        self.assertEqual(outputs[1], torch.relu(inputs[0]))
+        self.assertGreater(len(kernel_profiles), 0)
+        for record in kernel_profiles:
+            self.assertGreater(record["time_ms"], 0)
+            self.assertGreater(record["bytes"], 0)
+            self.assertGreater(record["registers_per_thread"], 0)
+            # Neither kernel needs a stack nor spills
+            self.assertEqual(record["local_bytes_per_thread"], 0)
+            self.assertGreater(record["occupancy"], 0)
+            self.assertLessEqual(record["occupancy"], 1)
+
+        # Executions without profiling only return the outputs
+        outputs = fd.execute(inputs)
+        self.assertEqual(outputs[0], torch.sum(inputs[0], dim=1))
+
+    def test_foreign_array_inputs(self):
+        # Stand-ins for arrays of other frameworks that only expose one of the
+        # interchange protocols
+        class CudaArray:
+            def __init__(self, tensor):
+                self.__cuda_array_interface__ = tensor.__cuda_array_interface__
+
+        class DLPackArray:
+            def __init__(self, tensor):
+                self.tensor = tensor
+
+            def __dlpack__(self, stream=None):
+                return torch.utils.dlpack.to_dlpack(self.tensor)
+
+        with FusionDefinition() as fd:
+            t0 = fd.define_tensor(
+                symbolic_sizes=[-1, -1], contiguous=[True, True], dtype=DataType.Float
+            )
+            t1 = fd.define_tensor(
+                symbolic_sizes=[-1, -1], contiguous=[True, True], dtype=DataType.Float
+            )
+            c0 = fd.define_scalar(DataType.Double)
+            t2 = fd.ops.add(t0, t1)
+            t3 = fd.ops.mul(t2, c0)
+            fd.add_output(t3)
+
+        inputs = [torch.randn(8, 16, device="cuda"), torch.randn(8, 16, device="cuda")]
+        nvf_out = fd.execute([CudaArray(inputs[0]), DLPackArray(inputs[1]), 0.5])
+        self.assertEqual(nvf_out[0], (inputs[0] + inputs[1]) * 0.5)
+
+    def test_compile_stats(self):
+        reset_compile_stats()
+        with FusionDefinition() as fd:
+            t0 = fd.define_tensor(
+                symbolic_sizes=[-1, -1], contiguous=[True, True], dtype=DataType.Float
+            )
+            c0 = fd.define_constant(1.75)
+            t1 = fd.ops.mul(t0, c0)
+            fd.add_output(t1)
+
+        inputs = [torch.randn(8, 16, device="cuda")]
+        nvf_out = fd.execute(inputs)
+        self.assertEqual(inputs[0] * 1.75, nvf_out[0])
+
+        stats = compile_stats()
+        # Every compilation lowers the fusion, whether or not NVRTC runs
+        self.assertIn("GpuLower::finalize", stats)
+        for stage_stats in stats.values():
+            self.assertGreater(stage_stats["count"], 0)
+            self.assertEqual(
+                sum(count for _, count in stage_stats["histogram"]),
+                stage_stats["count"],
+            )
+
+    def test_runtime_metrics(self):
+        with FusionDefinition() as fd:
+            t0 = fd.define_tensor(
+                symbolic_sizes=[-1, -1], contiguous=[True, True], dtype=DataType.Float
+            )
+            c0 = fd.define_constant(2.25)
+            t1 = fd.ops.mul(t0, c0)
+            fd.add_output(t1)
+
+        inputs = [torch.randn(8, 16, device="cuda")]
+        fd.execute(inputs)
+
+        reset_runtime_metrics()
+        for _ in range(3):
+            nvf_out = fd.execute(inputs)
+        self.assertEqual(inputs[0] * 2.25, nvf_out[0])
+
+        metrics = runtime_metrics()
+        self.assertEqual(metrics["fusion_runs"], 3)
+        self.assertEqual(metrics["runtime_cache_hits"], 3)
+        self.assertEqual(metrics["runtime_cache_misses"], 0)
+        self.assertEqual(metrics["kernel_compilations"], 0)
+        self.assertEqual(metrics["segments_run"], 3)
+        self.assertGreaterEqual(metrics["bytes_allocated"], 3 * 8 * 16 * 4)
+        self.assertEqual(
+            sum(count for _, count in metrics["host_latency_histogram"]), 3
+        )
+
+    def test_kernel_telemetry(self):
+        with FusionDefinition() as fd:
+            t0 = fd.define_tensor(
+                symbolic_sizes=[-1, -1], contiguous=[True, True], dtype=DataType.Float
+            )
+            t1 = fd.ops.sum(t0, [1])
+            fd.add_output(t1)
+
+        inputs = [torch.randn(64, 128, device="cuda")]
+        reset_kernel_telemetry()
+        enable_kernel_telemetry(True)
+        try:
+            for _ in range(2):
+                nvf_out = fd.execute(inputs)
+        finally:
+            enable_kernel_telemetry(False)
+        self.assertEqual(inputs[0].sum(1), nvf_out[0])
+
+        report = kernel_telemetry(top_k=10)
+        self.assertEqual(len(report), 1)
+        self.assertEqual(report[0]["calls"], 2)
+        self.assertGreater(report[0]["gpu_time_ms"], 0)
+        self.assertNotEqual(report[0]["heuristic"], "")
+        self.assertIn(report[0]["kernel"], kernel_telemetry_json())
+        reset_kernel_telemetry()
+
     def test_basic_fp16(self):
         inputs = [
             torch.ones(2, 4, 8, device="cuda", dtype=torch.float16),
@@ -923,6 +1155,40 @@ class TestNvFuserFrontend(TestCase):
         nvf_out = fd.execute(inputs, override_user_schedule=True)
         self.assertEqual(nvf_user_out, nvf_out)
 
+    def test_symbolic_user_schedule(self):
+        inputs = [
+            torch.randn(4, 4, 4, device="cuda"),
+            torch.randn(4, 4, 4, device="cuda"),
+        ]
+
+        class SymbolicSched(FusionDefinition):
+            def definition(self):
+                self.t0 = self.from_pytorch(inputs[0])
+                self.t1 = self.from_pytorch(inputs[1])
+                self.t2 = self.ops.add(self.t0, self.t1)
+                self.add_output(self.t2)
+
+            def schedule(self):
+                self.sched.split(self.t2, 1, 2)
+                self.sched.merge(self.t2, -2)
+
+            def schedule_constraints(self):
+                dims = [None, DimConstraint(divisor=2), None]
+                return [dims, dims]
+
+        fd = SymbolicSched()
+        nvf_out = fd.execute(inputs)
+        self.assertEqual(nvf_out[0], inputs[0] + inputs[1])
+
+        # Other shapes satisfying the constraints run the same schedule
+        for shape in [(2, 6, 8), (8, 16, 3)]:
+            other_inputs = [
+                torch.randn(*shape, device="cuda"),
+                torch.randn(*shape, device="cuda"),
+            ]
+            nvf_out = fd.execute(other_inputs)
+            self.assertEqual(nvf_out[0], other_inputs[0] + other_inputs[1])
+
     def test_normal(self):
         input_size = [64, 128, 1024]
         dtype = torch.float32
@@ -107,7 +107,105 @@ __device__ void loadGenericVolatile(
   }
 }
 
-template <typename scalar_t, int vec_size, bool is_volatile>
+// Eviction priorities of vectorized global memory accesses, see Note [ Cache
+// hints ] in type.h. Default uses the streaming (.cs) accesses. On sm_70+,
+// EvictFirst and EvictLast set the L1 eviction priority, and on sm_80+ also
+// the L2 eviction priority with a cache policy covering the whole access.
+enum class CacheHint { Default, EvictFirst, EvictLast };
+
+#if __CUDA_ARCH__ >= 800
+#define __NVFUSER_CACHE_POLICY(priority) \
+  ".reg .b64 policy;\n"                  \
+  "createpolicy.fractional.L2::" priority ".b64 policy, 1.0;\n"
+#define __NVFUSER_CACHE_QUALIFIER(priority) ".L1::" priority ".L2::cache_hint"
+#define __NVFUSER_CACHE_OPERAND ", policy"
+#elif __CUDA_ARCH__ >= 700
+#define __NVFUSER_CACHE_POLICY(priority) ""
+#define __NVFUSER_CACHE_QUALIFIER(priority) ".L1::" priority
+#define __NVFUSER_CACHE_OPERAND ""
+#else
+#define __NVFUSER_CACHE_POLICY(priority) ""
+#define __NVFUSER_CACHE_QUALIFIER(priority) ".cs"
+#define __NVFUSER_CACHE_OPERAND ""
+#endif
+
+#define __NVFUSER_LD_V2(priority)                                   \
+  asm volatile("{" __NVFUSER_CACHE_POLICY(priority)                 \
+               "ld.global" __NVFUSER_CACHE_QUALIFIER(priority)      \
+               ".v2.s32 {%0,%1}, [%2]" __NVFUSER_CACHE_OPERAND ";}" \
+               : "=r"(data.x), "=r"(data.y)                         \
+               : "l"(from))
+
+#define __NVFUSER_LD_V4(priority)                                           \
+  asm volatile("{" __NVFUSER_CACHE_POLICY(priority)                         \
+               "ld.global" __NVFUSER_CACHE_QUALIFIER(priority)              \
+               ".v4.s32 {%0,%1,%2,%3}, [%4]" __NVFUSER_CACHE_OPERAND ";}"   \
+               : "=r"(data.x), "=r"(data.y), "=r"(data.z), "=r"(data.w) \
+               : "l"(from))
+
+#define __NVFUSER_ST_V2(priority)                                   \
+  asm volatile("{" __NVFUSER_CACHE_POLICY(priority)                 \
+               "st.global" __NVFUSER_CACHE_QUALIFIER(priority)      \
+               ".v2.s32 [%0], {%1,%2}" __NVFUSER_CACHE_OPERAND ";}" \
+               :                                                    \
+               : "l"(to), "r"(data.x), "r"(data.y))
+
+#define __NVFUSER_ST_V4(priority)                                         \
+  asm volatile("{" __NVFUSER_CACHE_POLICY(priority)                       \
+               "st.global" __NVFUSER_CACHE_QUALIFIER(priority)            \
+               ".v4.s32 [%0], {%1,%2,%3,%4}" __NVFUSER_CACHE_OPERAND ";}" \
+               :                                                          \
+               : "l"(to), "r"(data.x), "r"(data.y), "r"(data.z), "r"(data.w))
+
+template <CacheHint hint>
+__device__ void loadGlobalWithHint(uint2& data, const void* from) {
+  if constexpr (hint == CacheHint::EvictFirst) {
+    __NVFUSER_LD_V2("evict_first");
+  } else {
+    __NVFUSER_LD_V2("evict_last");
+  }
+}
+
+template <CacheHint hint>
+__device__ void loadGlobalWithHint(uint4& data, const void* from) {
+  if constexpr (hint == CacheHint::EvictFirst) {
+    __NVFUSER_LD_V4("evict_first");
+  } else {
+    __NVFUSER_LD_V4("evict_last");
+  }
+}
+
+template <CacheHint hint>
+__device__ void storeGlobalWithHint(void* to, const uint2& data) {
+  if constexpr (hint == CacheHint::EvictFirst) {
+    __NVFUSER_ST_V2("evict_first");
+  } else {
+    __NVFUSER_ST_V2("evict_last");
+  }
+}
+
+template <CacheHint hint>
+__device__ void storeGlobalWithHint(void* to, const uint4& data) {
+  if constexpr (hint == CacheHint::EvictFirst) {
+    __NVFUSER_ST_V4("evict_first");
+  } else {
+    __NVFUSER_ST_V4("evict_last");
+  }
+}
+
+#undef __NVFUSER_ST_V4
+#undef __NVFUSER_ST_V2
+#undef __NVFUSER_LD_V4
+#undef __NVFUSER_LD_V2
+#undef __NVFUSER_CACHE_OPERAND
+#undef __NVFUSER_CACHE_QUALIFIER
+#undef __NVFUSER_CACHE_POLICY
+
+template <
+    typename scalar_t,
+    int vec_size,
+    bool is_volatile,
+    CacheHint hint = CacheHint::Default>
 __device__ void loadLocalToGlobal(
     typename MaybeVolatile<scalar_t, is_volatile>::type* to,
     scalar_t* from) {
@@ -125,6 +223,8 @@ __device__ void loadLocalToGlobal(
                 (typename MaybeVolatile<uint2, is_volatile>::type*)to),
             "r"(data.x),
             "r"(data.y));
+      } else if (hint != CacheHint::Default) {
+        storeGlobalWithHint<hint>((void*)to, data);
       } else {
         asm volatile(
             "st.global.cs.v2.s32 [%0], {%1,%2};" ::"l"(
@@ -144,6 +244,8 @@ __device__ void loadLocalToGlobal(
             "r"(data.y),
             "r"(data.z),
             "r"(data.w));
+      } else if (hint != CacheHint::Default) {
+        storeGlobalWithHint<hint>((void*)to, data);
       } else {
         asm volatile(
             "st.global.cs.v4.s32 [%0], {%1,%2,%3,%4};" ::"l"(
@@ -158,7 +260,11 @@ __device__ void loadLocalToGlobal(
   }
 }
 
-template <typename scalar_t, int vec_size, bool is_volatile>
+template <
+    typename scalar_t,
+    int vec_size,
+    bool is_volatile,
+    CacheHint hint = CacheHint::Default>
 __device__ void loadGlobalToLocal(
     scalar_t* to,
     typename MaybeVolatile<scalar_t, is_volatile>::type* from) {
@@ -175,6 +281,9 @@ __device__ void loadGlobalToLocal(
                      : "=r"(data.x), "=r"(data.y)
                      : "l"((uint2*)from));
         break;
+      } else if (hint != CacheHint::Default) {
+        loadGlobalWithHint<hint>(
+            *reinterpret_cast<uint2*>(to), (const void*)from);
       } else {
         uint2& data = *reinterpret_cast<uint2*>(to);
         asm volatile("ld.global.cs.v2.s32 {%0,%1}, [%2];"
@@ -189,6 +298,9 @@ __device__ void loadGlobalToLocal(
         asm volatile("ld.volatile.global.v4.s32 {%0,%1,%2,%3}, [%4];"
                      : "=r"(data.x), "=r"(data.y), "=r"(data.z), "=r"(data.w)
                      : "l"((uint4*)from));
+      } else if (hint != CacheHint::Default) {
+        loadGlobalWithHint<hint>(
+            *reinterpret_cast<uint4*>(to), (const void*)from);
       } else {
         uint4& data = *reinterpret_cast<uint4*>(to);
         asm volatile("ld.global.cs.v4.s32 {%0,%1,%2,%3}, [%4];"
@@ -153,3 +153,122 @@ __device__ __inline__ __bfloat __real_then_2bfloat(
     const std::complex<double> c) {
   return __double2bfloat(std::real(c));
 }
+
+// Native bfloat16 arithmetic, see Note [ Native half precision ops ]. Before
+// sm_90, add, sub and mul are computed with fma.rn.bf16, e.g., a + b is
+// fma(a, 1, b), which rounds once and so is correctly rounded as well.
+// Immediates aren't allowed for bf16 operands, hence the mov.b16.
+__device__ __inline__ __bfloat operator+(const __bfloat a, const __bfloat b) {
+#if __CUDA_ARCH__ >= 900
+  __bfloat val;
+  asm("{  add.rn.bf16 %0, %1, %2;}\n"
+      : "=h"(__NVFUSER_BFLOAT_TO_US(val))
+      : "h"(__NVFUSER_BFLOAT_TO_CUS(a)), "h"(__NVFUSER_BFLOAT_TO_CUS(b)));
+  return val;
+#elif __CUDA_ARCH__ >= 800
+  __bfloat val;
+  asm("{ .reg .b16 one;\n"
+      "  mov.b16 one, 0x3F80;\n"
+      "  fma.rn.bf16 %0, %1, one, %2;}\n"
+      : "=h"(__NVFUSER_BFLOAT_TO_US(val))
+      : "h"(__NVFUSER_BFLOAT_TO_CUS(a)), "h"(__NVFUSER_BFLOAT_TO_CUS(b)));
+  return val;
+#else
+  return __float2bfloat(__bfloat2float(a) + __bfloat2float(b));
+#endif
+}
+
+__device__ __inline__ __bfloat operator-(const __bfloat a, const __bfloat b) {
+#if __CUDA_ARCH__ >= 900
+  __bfloat val;
+  asm("{  sub.rn.bf16 %0, %1, %2;}\n"
+      : "=h"(__NVFUSER_BFLOAT_TO_US(val))
+      : "h"(__NVFUSER_BFLOAT_TO_CUS(a)), "h"(__NVFUSER_BFLOAT_TO_CUS(b)));
+  return val;
+#elif __CUDA_ARCH__ >= 800
+  __bfloat val;
+  asm("{ .reg .b16 neg_one;\n"
+      "  mov.b16 neg_one, 0xBF80;\n"
+      "  fma.rn.bf16 %0, %2, neg_one, %1;}\n"
+      : "=h"(__NVFUSER_BFLOAT_TO_US(val))
+      : "h"(__NVFUSER_BFLOAT_TO_CUS(a)), "h"(__NVFUSER_BFLOAT_TO_CUS(b)));
+  return val;
+#else
+  return __float2bfloat(__bfloat2float(a) - __bfloat2float(b));
+#endif
+}
+
+__device__ __inline__ __bfloat operator*(const __bfloat a, const __bfloat b) {
+#if __CUDA_ARCH__ >= 900
+  __bfloat val;
+  asm("{  mul.rn.bf16 %0, %1, %2;}\n"
+      : "=h"(__NVFUSER_BFLOAT_TO_US(val))
+      : "h"(__NVFUSER_BFLOAT_TO_CUS(a)), "h"(__NVFUSER_BFLOAT_TO_CUS(b)));
+  return val;
+#elif __CUDA_ARCH__ >= 800
+  // -0 is the additive identity, so that a * b = -0 when the product is -0
+  __bfloat val;
+  asm("{ .reg .b16 neg_zero;\n"
+      "  mov.b16 neg_zero, 0x8000;\n"
+      "  fma.rn.bf16 %0, %1, %2, neg_zero;}\n"
+      : "=h"(__NVFUSER_BFLOAT_TO_US(val))
+      : "h"(__NVFUSER_BFLOAT_TO_CUS(a)), "h"(__NVFUSER_BFLOAT_TO_CUS(b)));
+  return val;
+#else
+  return __float2bfloat(__bfloat2float(a) * __bfloat2float(b));
+#endif
+}
+
+// NaN propagating like fmax and fmin of helpers.cu
+__device__ __inline__ __bfloat fmax(const __bfloat a, const __bfloat b) {
+#if __CUDA_ARCH__ >= 800
+  __bfloat val;
+  asm("{  max.NaN.bf16 %0, %1, %2;}\n"
+      : "=h"(__NVFUSER_BFLOAT_TO_US(val))
+      : "h"(__NVFUSER_BFLOAT_TO_CUS(a)), "h"(__NVFUSER_BFLOAT_TO_CUS(b)));
+  return val;
+#else
+  const float fa = __bfloat2float(a);
+  const float fb = __bfloat2float(b);
+  if (fa != fa) {
+    return a;
+  } else if (fb != fb) {
+    return b;
+  } else {
+    return fa > fb ? a : b;
+  }
+#endif
+}
+
+__device__ __inline__ __bfloat fmin(const __bfloat a, const __bfloat b) {
+#if __CUDA_ARCH__ >= 800
+  __bfloat val;
+  asm("{  min.NaN.bf16 %0, %1, %2;}\n"
+      : "=h"(__NVFUSER_BFLOAT_TO_US(val))
+      : "h"(__NVFUSER_BFLOAT_TO_CUS(a)), "h"(__NVFUSER_BFLOAT_TO_CUS(b)));
+  return val;
+#else
+  const float fa = __bfloat2float(a);
+  const float fb = __bfloat2float(b);
+  if (fa != fa) {
+    return a;
+  } else if (fb != fb) {
+    return b;
+  } else {
+    return fa > fb ? b : a;
+  }
+#endif
+}
+
+// Warp shuffles of the warp reductions of sums accumulating in bfloat16, see
+// Note [ Accumulation policies ]
+__device__ __inline__ __bfloat __shfl_xor_sync(
+    unsigned int mask,
+    const __bfloat var,
+    int lane_mask,
+    int width = 32) {
+  __bfloat val;
+  __NVFUSER_BFLOAT_TO_US(val) = (unsigned short)__shfl_xor_sync(
+      mask, (unsigned int)__NVFUSER_BFLOAT_TO_CUS(var), lane_mask, width);
+  return val;
+}
@@ -7,9 +7,9 @@
 // clang-format on
 // [Z,Y,X]_THREADS is the number of participating threads in the z, y, x
 // dimension of the block. If set to false the dimension doesn't
-// participate in the reduction. We could start with warp reductions, then
-// reduce the warps, this could save some shared memory, but could be slower in
-// some instances.
+// participate in the reduction. See warp::blockReduceShuffle for a version
+// that starts with warp reductions and only reduces the warps through shared
+// memory.
 //
 //  EXAMPLE USAGE:
 //  blockReduceSum<X_THREADS, Y_THREADS, Z_THREADS>
@@ -0,0 +1,144 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+namespace fused_reduction {
+namespace impl {
+
+// Grouped block reduction optimized for outer reductions with TIDx
+// and TIDy mapped to non-reduction and reduction domains,
+// respectively with unused TIDz.
+//
+// This is the same algorithm as blockWelfordOuter, just with a
+// single value per element instead of a Welford triplet, so see
+// block_welford_outer.cu for the details. In short, each warp first
+// does a scattered butterfly reduction of its NumVals values across
+// the 32 / blockDim.x threads sharing the same threadIdx.x, then the
+// warp-level partial results are exchanged through shared memory and
+// each of the first NumVals warps finishes one value of the group.
+//
+// The same assumptions as blockWelfordOuter hold. Only the threads of
+// the first NumVals warps with threadIdx.y % (32 / blockDim.x) == 0
+// return a valid result, which is the result of the group value
+// indexed by the warp index.
+template <
+    int NumVals,
+    typename DataType,
+    int BDIMX,
+    int BDIMY,
+    typename Func>
+__inline__ __device__ DataType blockReduceOuter(
+    DataType* inp,
+    DataType init_val,
+    DataType* smem,
+    Func reduction_op) {
+  constexpr int num_warps = BDIMX * BDIMY / 32;
+  static_assert(num_warps >= 1, "There must be at least a single warp");
+  static_assert(32 % BDIMX == 0, "blockDimx.x must be able to divide 32");
+
+  const int tid = threadIdx.x + threadIdx.y * BDIMX;
+  const int wid = tid / 32;
+
+  // Dimension of the Y axis within each warp
+  constexpr int wdimy = 32 / BDIMX;
+  static_assert(NumVals >= wdimy, "NumVals must be >= 32 / blockDim.x");
+  static_assert(
+      NumVals % wdimy == 0, "NumVals must be divisible by 32 / blockDim.x");
+
+  // Y index within each warp
+  const int warp_tidy = threadIdx.y % wdimy;
+
+  // Thread index in each warp
+  const int lane_id = threadIdx.x + warp_tidy * BDIMX;
+
+  int chunk_size = NumVals;
+
+  // Butterfly reduction, a.k.a. recursive halving as each iteration
+  // halves the number of values
+#pragma unroll
+  for (int lane_mask = 16; lane_mask >= BDIMX; lane_mask /= 2) {
+    chunk_size /= 2;
+#pragma unroll
+    for (int index_in_chunk = 0; index_in_chunk < chunk_size;
+         ++index_in_chunk) {
+      DataType pushed = init_val;
+      DataType self = init_val;
+      if (lane_id & lane_mask) {
+        // Push first half
+        pushed = inp[index_in_chunk];
+        self = inp[index_in_chunk + chunk_size];
+      } else {
+        // Push second half
+        pushed = inp[index_in_chunk + chunk_size];
+        self = inp[index_in_chunk];
+      }
+      auto peer = __shfl_xor_sync(0xffffffff, pushed, lane_mask);
+      reduction_op(self, peer);
+      inp[index_in_chunk] = self;
+    }
+  }
+
+  // Upload the chunk_size = NumVals / wdimy warp-reduced values with
+  // the same swizzled layout as blockWelfordOuter:
+  //
+  // [chunk_size, wid, warp_tidy, TIDx]
+#pragma unroll
+  for (int i = 0; i < chunk_size; ++i) {
+    int smem_offset = 0;
+    // TIDx
+    smem_offset += threadIdx.x;
+    // Warp_TIDy with swizzle
+    smem_offset += ((warp_tidy + wid) % wdimy) * BDIMX;
+    // WID
+    smem_offset += wid * 32;
+    // chunk_size
+    smem_offset += i * BDIMX * BDIMY;
+    smem[smem_offset] = inp[i];
+  }
+
+  __syncthreads();
+
+  static_assert(
+      num_warps >= NumVals,
+      "Number of warps must be at least as large as NumVals");
+
+  // Warp wid accumulates the partial results of the wid-th chunk
+  DataType result = init_val;
+  if (wid < NumVals) {
+#pragma unroll
+    for (int i = warp_tidy; i < num_warps; i += wdimy) {
+      int offset = 0;
+      offset += threadIdx.x;
+      // Offset to the partial results of the i-th warp
+      offset += i * 32;
+      // Offset to the chunk for this warp. Swizzled to avoid bank
+      // conflicts.
+      offset += ((wid / chunk_size + i) % wdimy) * BDIMX;
+      offset += (wid % chunk_size) * BDIMX * BDIMY;
+      reduction_op(result, smem[offset]);
+    }
+  }
+
+  __syncthreads();
+
+  // Nothing to do for warps whose wid is larger than NunVals
+  if (wid >= NumVals) {
+    return init_val;
+  }
+
+  // Standard binary-exchange reduction within wdimy intra-warp
+  // threads.
+#pragma unroll
+  for (int lane_mask = 16; lane_mask >= BDIMX; lane_mask /= 2) {
+    auto peer = __shfl_xor_sync(0xffffffff, result, lane_mask);
+    reduction_op(result, peer);
+  }
+
+  return result;
+}
+
+} // namespace impl
+} // namespace fused_reduction
@@ -126,8 +126,11 @@ class complex {
 template <>
 class complex<double>;
 
+// Like c10::complex, the specializations below are aligned to the size of the
+// whole number so that a single element is loaded and stored as one 8 or 16
+// byte access, and vectorized accesses of complex tensors stay aligned.
 template <>
-class complex<float> {
+class alignas(2 * sizeof(float)) complex<float> {
   float __re_;
   float __im_;
 
@@ -242,7 +245,7 @@ class complex<float> {
 };
 
 template <>
-class complex<double> {
+class alignas(2 * sizeof(double)) complex<double> {
   double __re_;
   double __im_;
 
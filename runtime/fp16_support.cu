@@ -99,3 +99,96 @@ __device__ __inline__ __half __real_then_2half(const std::complex<float> c) {
 __device__ __inline__ __half __real_then_2half(const std::complex<double> c) {
   return __double2half(std::real(c));
 }
+
+// Native half precision arithmetic, see Note [ Native half precision ops ].
+// The results are correctly rounded, so they match computing in float and
+// rounding back to half.
+__device__ __inline__ __half operator+(const __half a, const __half b) {
+#if __CUDA_ARCH__ >= 530
+  __half val;
+  asm("{  add.rn.f16 %0, %1, %2;}\n"
+      : "=h"(__NVFUSER_HALF_TO_US(val))
+      : "h"(__NVFUSER_HALF_TO_CUS(a)), "h"(__NVFUSER_HALF_TO_CUS(b)));
+  return val;
+#else
+  return __float2half(__half2float(a) + __half2float(b));
+#endif
+}
+
+__device__ __inline__ __half operator-(const __half a, const __half b) {
+#if __CUDA_ARCH__ >= 530
+  __half val;
+  asm("{  sub.rn.f16 %0, %1, %2;}\n"
+      : "=h"(__NVFUSER_HALF_TO_US(val))
+      : "h"(__NVFUSER_HALF_TO_CUS(a)), "h"(__NVFUSER_HALF_TO_CUS(b)));
+  return val;
+#else
+  return __float2half(__half2float(a) - __half2float(b));
+#endif
+}
+
+__device__ __inline__ __half operator*(const __half a, const __half b) {
+#if __CUDA_ARCH__ >= 530
+  __half val;
+  asm("{  mul.rn.f16 %0, %1, %2;}\n"
+      : "=h"(__NVFUSER_HALF_TO_US(val))
+      : "h"(__NVFUSER_HALF_TO_CUS(a)), "h"(__NVFUSER_HALF_TO_CUS(b)));
+  return val;
+#else
+  return __float2half(__half2float(a) * __half2float(b));
+#endif
+}
+
+// NaN propagating like fmax and fmin of helpers.cu
+__device__ __inline__ __half fmax(const __half a, const __half b) {
+#if __CUDA_ARCH__ >= 800
+  __half val;
+  asm("{  max.NaN.f16 %0, %1, %2;}\n"
+      : "=h"(__NVFUSER_HALF_TO_US(val))
+      : "h"(__NVFUSER_HALF_TO_CUS(a)), "h"(__NVFUSER_HALF_TO_CUS(b)));
+  return val;
+#else
+  const float fa = __half2float(a);
+  const float fb = __half2float(b);
+  if (fa != fa) {
+    return a;
+  } else if (fb != fb) {
+    return b;
+  } else {
+    return fa > fb ? a : b;
+  }
+#endif
+}
+
+__device__ __inline__ __half fmin(const __half a, const __half b) {
+#if __CUDA_ARCH__ >= 800
+  __half val;
+  asm("{  min.NaN.f16 %0, %1, %2;}\n"
+      : "=h"(__NVFUSER_HALF_TO_US(val))
+      : "h"(__NVFUSER_HALF_TO_CUS(a)), "h"(__NVFUSER_HALF_TO_CUS(b)));
+  return val;
+#else
+  const float fa = __half2float(a);
+  const float fb = __half2float(b);
+  if (fa != fa) {
+    return a;
+  } else if (fb != fb) {
+    return b;
+  } else {
+    return fa > fb ? b : a;
+  }
+#endif
+}
+
+// Warp shuffles of the warp reductions of sums accumulating in half, see
+// Note [ Accumulation policies ]
+__device__ __inline__ __half __shfl_xor_sync(
+    unsigned int mask,
+    const __half var,
+    int lane_mask,
+    int width = 32) {
+  __half val;
+  __NVFUSER_HALF_TO_US(val) = (unsigned short)__shfl_xor_sync(
+      mask, (unsigned int)__NVFUSER_HALF_TO_CUS(var), lane_mask, width);
+  return val;
+}
@@ -618,6 +618,41 @@ class ParallelReduce {
       int64_t& cycles,
       int64_t& count);
 
+  // Same as welfordGroupOuter but for a single plain reduction of
+  // NumVals grouped values. Defined in fused_reduction_impl_outer.cu.
+  template <
+      int NumVals,
+      typename DataType,
+      int BDIMX,
+      int BDIMY,
+      typename Func>
+  __device__ __inline__ void reduceGroupOuter(
+      DataType out[NumVals],
+      const DataType in[NumVals],
+      DataType init_val,
+      DataType* global_buf,
+      DataType* shared_buf,
+      int64_t* global_sync_buffer,
+      Func reduction_op);
+
+  // Profiled version
+  template <
+      int NumVals,
+      typename DataType,
+      int BDIMX,
+      int BDIMY,
+      typename Func>
+  __device__ __inline__ void reduceGroupOuter(
+      DataType out[NumVals],
+      const DataType in[NumVals],
+      DataType init_val,
+      DataType* global_buf,
+      DataType* shared_buf,
+      int64_t* global_sync_buffer,
+      int64_t& cycles,
+      int64_t& count,
+      Func reduction_op);
+
  private:
   __device__ static bool isLastBlockInGrid() {
     return index_utils::maskedIsLast<
@@ -7,12 +7,26 @@
 // clang-format on
 namespace grid_broadcast {
 
+// Note [ Double buffered grid broadcast ]
+//
+// A grid broadcast used to need two grid syncs: one to publish the
+// value and another to make sure every block has read it before the
+// buffer could be overwritten by the next broadcast. Instead, the work
+// buffer has two halves and each call uses the half selected by the
+// phase bit of the semaphore (see grid_sync::sync). The bit is read
+// before the block arrives at the sync, so it can't flip in between,
+// as flipping requires the arrival of all the blocks. A half is
+// written again only two phases later, which means every block has
+// arrived at the sync of the next phase and is therefore done reading
+// it. The calling block can thus go on right after the single sync.
+
 // Broadcasts per-thread values across threads and blocks.
 //
 // Function parameters:
 // - out: Per-thread output location
 // - inp_val: Per-thread input value
-// - work_buf: Temporary buffer for communication across threads/blocks
+// - work_buf: Temporary buffer for communication across threads/blocks. Must
+//   hold two copies of the broadcast values
 // - sync_flags: A vector of integers for synchronizations
 //
 // Template parameters:
@@ -60,8 +74,15 @@ __device__ void broadcast(
       (!X_THREAD || threadIdx.x == 0) && (!Y_THREAD || threadIdx.y == 0) &&
       (!Z_THREAD || threadIdx.z == 0);
 
+  // The work buffer holds two copies, alternating with the phase of the
+  // semaphore. See Note [ Double buffered grid broadcast ].
+  const bool phase =
+      grid_sync::globalAsVolatile(sync_flags[grid_seg_idx]) & FIRST_UINT64_BIT;
+  const auto buffer_offset = (phase ? 0 : grid_seg_size * block_stride) +
+      grid_seg_idx * block_stride + thread_offset;
+
   if (has_valid_data && read_write_pred) {
-    work_buf[grid_seg_idx * block_stride + thread_offset] = inp_val;
+    work_buf[buffer_offset] = inp_val;
     __threadfence();
   }
 
@@ -69,12 +90,7 @@ __device__ void broadcast(
       sync_flags[grid_seg_idx], grid_seg_size);
 
   if (read_write_pred) {
-    out = work_buf[grid_seg_idx * block_stride + thread_offset];
+    out = work_buf[buffer_offset];
   }
-
-  // Make sure everyone has read from the buffer before continuing the kernel
-  // and potentially overwriting
-  grid_sync::sync<X_BLOCK, Y_BLOCK, Z_BLOCK, true>(
-      sync_flags[grid_seg_idx], grid_seg_size);
 }
 } // namespace grid_broadcast
@@ -298,6 +298,129 @@ __device__ void gridReduce(
   }
 }
 
+namespace atomic {
+
+__device__ void add(volatile float& dst, float val) {
+  atomicAdd(const_cast<float*>(&dst), val);
+}
+
+__device__ void add(volatile double& dst, double val) {
+  atomicAdd(const_cast<double*>(&dst), val);
+}
+
+} // namespace atomic
+
+// Same as gridReduce but for sums of floating-point values. Instead of
+// storing the partial results of all blocks and reducing them in the last
+// block of each reduction segment, each block atomically adds its partial
+// result to a single slot per segment and thread in work_buf. The last block
+// then only reads the sum and resets the slot to zero. work_buf must be
+// zero-initialized and is sized by the non-reduced blocks and threads of the
+// grid times n_entrances. The reduction_op and init_val parameters are only
+// used for the block reduction and the update of out, and init_val must be
+// zero.
+template <
+    bool X_BLOCK,
+    bool Y_BLOCK,
+    bool Z_BLOCK,
+    bool X_THREAD,
+    bool Y_THREAD,
+    bool Z_THREAD,
+    bool PERSISTENT_REDUCTION,
+    typename T,
+    typename Func>
+__device__ void gridReduceAtomicAdd(
+    T& out,
+    const T& inp_val,
+    Func reduction_op,
+    volatile T* work_buf,
+    int64_t* sync_flags,
+    T* shared_buf,
+    bool read_pred,
+    bool write_pred,
+    T init_val,
+    const nvfuser_index_t entrance_ind,
+    const nvfuser_index_t n_entrances) {
+  T block_reduction_val = init_val;
+
+  // Do block reduction when required
+  if (X_THREAD || Y_THREAD || Z_THREAD) {
+    blockReduce<X_THREAD, Y_THREAD, Z_THREAD>(
+        block_reduction_val,
+        inp_val,
+        reduction_op,
+        threadIdx,
+        blockDim,
+        shared_buf,
+        read_pred,
+        true,
+        init_val);
+  } else if (read_pred) {
+    block_reduction_val = inp_val;
+  }
+
+  // Number of values to reduce in the reduction segment
+  const auto grid_reduction_segment_size =
+      index_utils::maskedSize<X_BLOCK, Y_BLOCK, Z_BLOCK>(gridDim);
+
+  // Index of the reduction we're performing out of the
+  // grid_reduction_segment_size
+  const auto idx_in_grid_segment =
+      index_utils::maskedOffset<!X_BLOCK, !Y_BLOCK, !Z_BLOCK>(
+          blockIdx, gridDim);
+
+  // Number of values each block contributes to the reduction segment
+  const auto block_reduction_segment_size =
+      index_utils::maskedSize<!X_THREAD, !Y_THREAD, !Z_THREAD>(blockDim);
+
+  // Number of reductions in the grid. Unlike gridReduce, the buffer is
+  // privatized for each entrance even when persistent, so the slots of
+  // different segments never overlap.
+  const nvfuser_index_t grid_segment_size =
+      index_utils::maskedSize<!X_BLOCK, !Y_BLOCK, !Z_BLOCK>(gridDim);
+
+  // Advance to the slots of this segment
+  work_buf += (entrance_ind * grid_segment_size + idx_in_grid_segment) *
+      block_reduction_segment_size;
+
+  const bool is_block_reduction_root = (!X_THREAD || threadIdx.x == 0) &&
+      (!Y_THREAD || threadIdx.y == 0) && (!Z_THREAD || threadIdx.z == 0);
+  const auto thread_offset =
+      index_utils::maskedOffset<!X_THREAD, !Y_THREAD, !Z_THREAD>(
+          threadIdx, blockDim);
+
+  if (is_block_reduction_root) {
+    atomic::add(work_buf[thread_offset], block_reduction_val);
+  }
+
+  if (PERSISTENT_REDUCTION) {
+    grid_sync::sync<X_BLOCK, Y_BLOCK, Z_BLOCK, PERSISTENT_REDUCTION>(
+        sync_flags[idx_in_grid_segment], grid_reduction_segment_size);
+  } else {
+    // Use a different sync flag for each call
+    grid_sync::sync<X_BLOCK, Y_BLOCK, Z_BLOCK, PERSISTENT_REDUCTION>(
+        sync_flags[entrance_ind * grid_segment_size + idx_in_grid_segment],
+        grid_reduction_segment_size);
+  }
+
+  bool last_block =
+      index_utils::maskedIsLast<X_BLOCK, Y_BLOCK, Z_BLOCK>(blockIdx, gridDim);
+
+  if (last_block && is_block_reduction_root) {
+    if (write_pred) {
+      reduction_op(out, work_buf[thread_offset]);
+    }
+    // Leave the slot zeroed for the next launch
+    work_buf[thread_offset] = init_val;
+  }
+
+  if (PERSISTENT_REDUCTION) {
+    // Make sure the slot is reset before it is accumulated into again
+    grid_sync::sync<X_BLOCK, Y_BLOCK, Z_BLOCK, PERSISTENT_REDUCTION>(
+        sync_flags[idx_in_grid_segment], grid_reduction_segment_size);
+  }
+}
+
 // This is just a wrapper of the above grid reduction routine to
 // measure the elapsed cycles. The measurement must be done just by
 // one thread, and in this case it should be done by one of the
@@ -29,14 +29,17 @@ __device__ void sync(
     int64_t& semaphore,
     const uint64_t& segment_size,
     const bool last_block) {
-  // Finish all global memory transactions before synchronizing
-  __threadfence();
-
   // Synchronize all threads in a block before synchronizing blocks
   block_sync::sync();
 
   // Only allow linear_tid == 0 to participate in the synchronization
   if (threadIdx.x == 0 && threadIdx.y == 0 && threadIdx.z == 0) {
+    // Finish all global memory transactions of the block before
+    // synchronizing. The block sync above orders the writes of the other
+    // threads before this fence, which is cumulative, so a single fence per
+    // block suffices instead of one per thread.
+    __threadfence();
+
     // Get increment value, only want a single block to have the large
     // increment, doesn't really matter which one, the goal is to flip/flop the
     // first bit of a uint64_t value, since our semaphores are actualy int64_t
@@ -53,11 +56,17 @@ __device__ void sync(
     uint64_t oldArrive =
         atomicAdd(reinterpret_cast<uint64_t*>(&semaphore), semaphore_increment);
 
+    // The block whose arrival flips the first bit is the last one to arrive,
+    // so it doesn't need to wait for anyone
+    const bool arrived_last =
+        ((oldArrive ^ (oldArrive + semaphore_increment)) & FIRST_UINT64_BIT) !=
+        0;
+
     // If for persistent kernels, lock all blocks until the semaphore has been
     // reached. Make sure we access semaphore as a volatile address so we get
     // the global memory updates.
     unsigned int ns = 8;
-    while ((PERSISTENT || last_block) &&
+    while ((PERSISTENT || last_block) && !arrived_last &&
            ((oldArrive ^ globalAsVolatile(semaphore)) & FIRST_UINT64_BIT) ==
                0) {
       // Put a sleep here so we have some breaks in probing the global
@@ -70,6 +79,9 @@ __device__ void sync(
       }
 #endif
     }
+
+    // Order the reads of the block after the sync
+    __threadfence();
   }
 
   // Sync block to make sure all other threads are waiting on the sync
@@ -100,14 +112,15 @@ __device__ void sync(
     int64_t& semaphore,
     const uint64_t& segment_size,
     const nvfuser_index_t n_entrances) {
-  // Finish all global memory transactions before synchronizing
-  __threadfence();
-
   // Synchronize all threads in a block before synchronizing blocks
   block_sync::sync();
 
   // Only allow linear_tid == 0 to participate in the synchronization
   if (threadIdx.x == 0 && threadIdx.y == 0 && threadIdx.z == 0) {
+    // Finish all global memory transactions of the block before
+    // synchronizing, see the other sync above
+    __threadfence();
+
     // Makes the assumption that blocks are in increasing order, this is not
     // guaranteed by CUDA but this is the current behavior, and unlikely to
     // change.
@@ -129,6 +142,7 @@ __device__ void sync(
         }
 #endif
       }
+      __threadfence();
     } else {
       auto old = atomicAdd(reinterpret_cast<uint64_t*>(&semaphore), 1);
     }
@@ -50,6 +50,32 @@ __device__ constexpr double ceilDiv(int64_t a, double b) {
   return std::ceil(a / b);
 }
 
+// Division of a nonnegative numerator by a positive divisor, both less than
+// 2^31, with a multiply-high, an add and a shift. The multiplier only depends
+// on the divisor and is computed once per kernel by fastDivMultiplier. With
+// shift = ceil(log2(divisor)), the multiplier is
+//   floor(2^32 * (2^shift - divisor) / divisor) + 1
+// which fits in 32 bits, and the quotient is
+//   (umulhi(numerator, multiplier) + numerator) >> shift
+// See "Division by Invariant Integers using Multiplication" by Granlund and
+// Montgomery, and Note [ Fast integer division ] in expr_simplifier.cpp.
+__device__ unsigned int fastDivShift(int divisor) {
+  return 32 - __clz(divisor - 1);
+}
+
+__device__ int fastDivMultiplier(int divisor) {
+  const unsigned long long one = 1;
+  const auto multiplier =
+      ((one << 32) * ((one << fastDivShift(divisor)) - divisor)) / divisor + 1;
+  return (int)(unsigned int)multiplier;
+}
+
+__device__ int fastDiv(int numerator, int divisor, int multiplier) {
+  const unsigned int high =
+      __umulhi((unsigned int)numerator, (unsigned int)multiplier);
+  return (int)((high + (unsigned int)numerator) >> fastDivShift(divisor));
+}
+
 // Monotonic and precise lerp is described here:
 // https://math.stackexchange.com/a/1798323
 __device__ double lerp(double start, double end, double weight) {
@@ -469,6 +495,45 @@ __device__ inline int64_t readCycleCounter() {
   return clock64();
 }
 
+#ifdef PYTORCH_NVFUSER_PROFILE_KERNEL
+// Return the nanoseconds of the global timer, which all SMs share
+__device__ inline int64_t readGlobalTimer() {
+  int64_t timer = 0;
+  asm volatile("mov.u64 %0, %%globaltimer;" : "=l"(timer));
+  return timer;
+}
+
+// Return the record of the calling block in the timeline of the profiled
+// expression `entry`, made of the begin and end global timer values and of
+// the SM the block runs on. See Note [ Kernel profile timeline ]
+__device__ inline int64_t* profileTimelineRecord(
+    int64_t* timeline,
+    int64_t entry) {
+  const int64_t num_blocks = (int64_t)gridDim.x * gridDim.y * gridDim.z;
+  const int64_t block = blockIdx.x +
+      (int64_t)gridDim.x * (blockIdx.y + (int64_t)gridDim.y * blockIdx.z);
+  return timeline + (entry * num_blocks + block) * 3;
+}
+
+__device__ inline void profileTimelineBegin(int64_t* timeline, int64_t entry) {
+  if (threadIdx.x == 0 && threadIdx.y == 0 && threadIdx.z == 0) {
+    __threadfence();
+    profileTimelineRecord(timeline, entry)[0] = readGlobalTimer();
+  }
+}
+
+__device__ inline void profileTimelineEnd(int64_t* timeline, int64_t entry) {
+  if (threadIdx.x == 0 && threadIdx.y == 0 && threadIdx.z == 0) {
+    __threadfence();
+    unsigned int sm = 0;
+    asm volatile("mov.u32 %0, %%smid;" : "=r"(sm));
+    auto record = profileTimelineRecord(timeline, entry);
+    record[1] = readGlobalTimer();
+    record[2] = sm;
+  }
+}
+#endif // PYTORCH_NVFUSER_PROFILE_KERNEL
+
 __device__ float print_impl(const char* name, float value) {
   printf(
       "%s = %f @ threadIdx=(%d,%d,%d), blockIdx=(%d,%d,%d)\n",
@@ -570,3 +635,19 @@ __device__ __bfloat print_impl(const char* name, __bfloat value) {
 #endif
 
 #define print(...) print_impl(#__VA_ARGS__, (__VA_ARGS__))
+
+#ifdef PYTORCH_NVFUSER_FAST_MATH
+// Hardware tanh of fast math kernels, see Note [ Fast math ] in
+// executor_utils.cpp
+__device__ float fast_tanhf(float x) {
+#if __CUDA_ARCH__ >= 750
+  float y;
+  asm("tanh.approx.f32 %0, %1;" : "=f"(y) : "f"(x));
+  return y;
+#else
+  return 1.0f - 2.0f / (__expf(2.0f * x) + 1.0f);
+#endif
+}
+
+#define tanhf(x) fast_tanhf(x)
+#endif
@@ -187,4 +187,84 @@ DEVICE_INLINE void cpAsyncPartialBarrier() {
 
 #endif // Arch 80
 
+#if (defined(__CUDA_ARCH__) && (__CUDA_ARCH__ >= 900))
+
+namespace Hopper {
+
+// Building blocks of bulk asynchronous copies (sm_90+). A bulk copy is
+//  issued by a single thread and signals its completion through an mbarrier
+//  in shared memory, which the consumer threads wait on:
+//
+//   if (tid == 0) {
+//     mbarrierArriveExpectTx(barrier, bytes);
+//     cpAsyncBulkG2S(smem_addr, gmem_ptr, bytes, barrier);
+//   }
+//   mbarrierWait(barrier, phase);
+//
+// The mbarrier must be initialized with mbarrierInit and made visible to the
+//  async proxy with fenceBarrierInit before the first copy is issued.
+
+// Initialize an mbarrier in shared memory that completes a phase once
+//  thread_count threads have arrived on it
+DEVICE_INLINE void mbarrierInit(unsigned barrier_addr, unsigned thread_count) {
+  asm volatile(
+      "mbarrier.init.shared::cta.b64 [%0], %1;\n" ::"r"(barrier_addr),
+      "r"(thread_count));
+}
+
+// Make initialized mbarriers visible to the other threads of the cluster and
+//  to the async proxy
+DEVICE_INLINE void fenceBarrierInit() {
+  asm volatile("fence.mbarrier_init.release.cluster;\n" ::);
+}
+
+// Arrive on an mbarrier and expect tx_bytes more bytes to be transferred by
+//  bulk copies before the current phase completes
+DEVICE_INLINE void mbarrierArriveExpectTx(
+    unsigned barrier_addr,
+    unsigned tx_bytes) {
+  asm volatile(
+      "mbarrier.arrive.expect_tx.shared::cta.b64 _, [%0], %1;\n" ::"r"(
+          barrier_addr),
+      "r"(tx_bytes));
+}
+
+// Arrive on an mbarrier without any expected transfer
+DEVICE_INLINE void mbarrierArrive(unsigned barrier_addr) {
+  asm volatile(
+      "mbarrier.arrive.shared::cta.b64 _, [%0];\n" ::"r"(barrier_addr));
+}
+
+// Block until the phase of the given parity of an mbarrier has completed
+DEVICE_INLINE void mbarrierWait(unsigned barrier_addr, unsigned phase_parity) {
+  asm volatile(
+      "{\n"
+      "  .reg .pred complete;\n"
+      "  waitLoop:\n"
+      "  mbarrier.try_wait.parity.shared::cta.b64 complete, [%0], %1;\n"
+      "  @!complete bra waitLoop;\n"
+      "}\n" ::"r"(barrier_addr),
+      "r"(phase_parity));
+}
+
+// Global to SMEM bulk copy of a contiguous range of bytes, completed through
+//  the given mbarrier. smem_addr, gmem_ptr and bytes must be 16B aligned.
+DEVICE_INLINE void cpAsyncBulkG2S(
+    unsigned smem_addr,
+    void const* gmem_ptr,
+    unsigned bytes,
+    unsigned barrier_addr) {
+  asm volatile(
+      "cp.async.bulk.shared::cluster.global.mbarrier::complete_tx::bytes"
+      " [%0], [%1], %2, [%3];\n" ::"r"(smem_addr),
+      "l"(gmem_ptr),
+      "r"(bytes),
+      "r"(barrier_addr)
+      : "memory");
+}
+
+} // namespace Hopper
+
+#endif // Arch 90
+
 #undef DEVICE_INLINE
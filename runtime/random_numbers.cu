@@ -95,63 +95,51 @@ __device__ float rng_uniform_rangef(
   return from + range * uniform01;
 }
 
-__device__ float normalf(unsigned int x, unsigned int y, int rng_component) {
-  float u = uniformf(x);
-  float v = uniformf(y) * 6.2831855f;
-
-  if (rng_component % 2 == 0) {
-    return sqrtf(-2.0f * logf(u)) * sinf(v);
-  } else {
-    return sqrtf(-2.0f * logf(u)) * cosf(v);
-  }
+// Box-Muller transforms all the components of a Philox result at once.
+// Components 2i and 2i+1 are the sine and cosine normals of the same radius
+// and angle, so the elements drawn from the same Philox result only
+// transform it once.
+__device__ float4 rng_normal_standard4f(const uint4& rng_result) {
+  float r0 = sqrtf(-2.0f * logf(uniformf(rng_result.x)));
+  float v0 = uniformf(rng_result.y) * 6.2831855f;
+  float r1 = sqrtf(-2.0f * logf(uniformf(rng_result.z)));
+  float v1 = uniformf(rng_result.w) * 6.2831855f;
+  return make_float4(
+      r0 * sinf(v0), r0 * cosf(v0), r1 * sinf(v1), r1 * cosf(v1));
 }
 
-__device__ double normal(
-    unsigned int x0,
-    unsigned int x1,
-    unsigned int y0,
-    unsigned int y1,
-    int rng_component) {
-  double u = uniform(x0, x1);
-  double v = uniform(y0, y1) * 6.2831853071795860;
-
-  if (rng_component % 2 == 0) {
-    return sqrt(-2.0 * log(u)) * sin(v);
-  } else {
-    return sqrt(-2.0 * log(u)) * cos(v);
-  }
+__device__ double2 rng_normal_standard2(const uint4& rng_result) {
+  double r = sqrt(-2.0 * log(uniform(rng_result.x, rng_result.y)));
+  double v = uniform(rng_result.z, rng_result.w) * 6.2831853071795860;
+  return make_double2(r * sin(v), r * cos(v));
 }
 
 __device__ double rng_normal_standard(
-    const uint4& rng_result,
+    const double2& rng_normal,
     int rng_component) {
-  return normal(
-      rng_result.x, rng_result.y, rng_result.z, rng_result.w, rng_component);
+  return rng_component == 0 ? rng_normal.x : rng_normal.y;
 }
 
 __device__ float rng_normal_standardf(
-    const uint4& rng_result,
+    const float4& rng_normal,
     int rng_component) {
-  return normalf(
-      (&rng_result.x)[rng_component / 2 * 2],
-      (&rng_result.y)[rng_component / 2 * 2],
-      rng_component);
+  return (&rng_normal.x)[rng_component];
 }
 
 __device__ double rng_normal_general(
-    const uint4& rng_result,
+    const double2& rng_normal,
     int rng_component,
     double mean,
     double std) {
-  auto normal01 = rng_normal_standard(rng_result, rng_component);
+  auto normal01 = rng_normal_standard(rng_normal, rng_component);
   return normal01 * std + mean;
 }
 
 __device__ float rng_normal_generalf(
-    const uint4& rng_result,
+    const float4& rng_normal,
     int rng_component,
     float mean,
     float std) {
-  auto normal01 = rng_normal_standardf(rng_result, rng_component);
+  auto normal01 = rng_normal_standardf(rng_normal, rng_component);
   return normal01 * std + mean;
 }
@@ -0,0 +1,214 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+
+// Atomic additions of scatter_add and index_add. Every thread adds its
+// element of src to the element of the output its index selects, and the
+// warp picks one of two strategies at runtime:
+//   - when all active lanes update different addresses, which is the common
+//     case of a low collision rate, every lane issues its own atomic;
+//   - otherwise the lanes are grouped by address with __match_any_sync, the
+//     values of a group are summed by a segmented reduction over warp
+//     shuffles and only the first lane of the group issues an atomic. Many
+//     duplicated indices, e.g. frequent tokens in the backward of an
+//     embedding, then only collide across warps.
+// Elements of 16 bits are grouped by the 32-bit word they are in, so that
+// consecutive lanes updating the two halves of a word issue a single packed
+// half2 or bfloat162 atomic.
+namespace scatter {
+
+namespace detail {
+
+#if defined(__CUDA_ARCH__) && __CUDA_ARCH__ >= 700
+#define NVFUSER_SCATTER_WARP_AGGREGATION
+#endif
+
+#ifdef NVFUSER_SCATTER_WARP_AGGREGATION
+__device__ inline unsigned int laneId() {
+  unsigned int lane;
+  asm("mov.u32 %0, %%laneid;" : "=r"(lane));
+  return lane;
+}
+
+// Mask of the lanes below the current one
+__device__ inline unsigned int lanesBelow() {
+  return (1u << laneId()) - 1;
+}
+
+// Groups the active lanes by key, returns the lanes with the same key as the
+// current one, or 0 when no two lanes have the same key
+__device__ inline unsigned int matchPeers(
+    unsigned int active,
+    unsigned long long key) {
+  const unsigned int peers = __match_any_sync(active, key);
+  return __all_sync(active, peers == (1u << laneId())) ? 0 : peers;
+}
+
+// Tree reduction of the values of each group of lanes in peers, the sum of a
+// group ends up in its lane of rank 0
+template <typename T>
+__device__ T segmentedReduce(unsigned int active, unsigned int peers, T val) {
+  const unsigned int rank = __popc(peers & lanesBelow());
+  for (unsigned int stride = 1; stride < 32; stride *= 2) {
+    // Lane of the peer stride ranks above, if any
+    const unsigned int src_lane = __fns(peers, 0, rank + stride + 1);
+    const bool has_src = src_lane < 32;
+    const T other = __shfl_sync(active, val, has_src ? src_lane : laneId());
+    if (has_src && rank % (2 * stride) == 0) {
+      val = val + other;
+    }
+  }
+  return val;
+}
+#endif
+
+__device__ inline void atomicAddValue(float* dst, float val) {
+  atomicAdd(dst, val);
+}
+
+__device__ inline void atomicAddValue(double* dst, double val) {
+  atomicAdd(dst, val);
+}
+
+__device__ inline void atomicAddValue(int* dst, int val) {
+  atomicAdd(dst, val);
+}
+
+__device__ inline void atomicAddValue(int64_t* dst, int64_t val) {
+  // Two's complement addition is the same for signed and unsigned values
+  atomicAdd(
+      reinterpret_cast<unsigned long long*>(dst), (unsigned long long)val);
+}
+
+__device__ inline float toFloat(__half val) {
+  return __half2float(val);
+}
+
+__device__ inline float toFloat(__bfloat val) {
+  return __bfloat2float(val);
+}
+
+template <typename T>
+__device__ T fromFloat(float val);
+
+template <>
+__device__ inline __half fromFloat<__half>(float val) {
+  return __float2half(val);
+}
+
+template <>
+__device__ inline __bfloat fromFloat<__bfloat>(float val) {
+  return __float2bfloat(val);
+}
+
+// Adds lo and hi to the low and high halves of an aligned 32-bit word with a
+// compare-and-swap loop
+template <typename T>
+__device__ void atomicAddPackedCas(unsigned int* word, float lo, float hi) {
+  unsigned int old = *word;
+  unsigned int assumed;
+  do {
+    assumed = old;
+    T lo_val, hi_val;
+    lo_val.__x = (unsigned short)(assumed & 0xffff);
+    hi_val.__x = (unsigned short)(assumed >> 16);
+    lo_val = fromFloat<T>(toFloat(lo_val) + lo);
+    hi_val = fromFloat<T>(toFloat(hi_val) + hi);
+    const unsigned int updated =
+        (unsigned int)lo_val.__x | ((unsigned int)hi_val.__x << 16);
+    old = atomicCAS(word, assumed, updated);
+  } while (assumed != old);
+}
+
+template <typename T>
+__device__ void atomicAddPacked(unsigned int* word, float lo, float hi);
+
+template <>
+__device__ inline void atomicAddPacked<__half>(
+    unsigned int* word,
+    float lo,
+    float hi) {
+#if defined(__CUDA_ARCH__) && __CUDA_ARCH__ >= 600
+  const unsigned int packed = (unsigned int)__float2half(lo).__x |
+      ((unsigned int)__float2half(hi).__x << 16);
+  asm volatile("red.global.add.noftz.f16x2 [%0], %1;"
+               :
+               : "l"(word), "r"(packed)
+               : "memory");
+#else
+  atomicAddPackedCas<__half>(word, lo, hi);
+#endif
+}
+
+template <>
+__device__ inline void atomicAddPacked<__bfloat>(
+    unsigned int* word,
+    float lo,
+    float hi) {
+#if defined(__CUDA_ARCH__) && __CUDA_ARCH__ >= 900
+  const unsigned int packed = (unsigned int)__float2bfloat(lo).__x |
+      ((unsigned int)__float2bfloat(hi).__x << 16);
+  asm volatile("red.global.add.noftz.bf16x2 [%0], %1;"
+               :
+               : "l"(word), "r"(packed)
+               : "memory");
+#else
+  atomicAddPackedCas<__bfloat>(word, lo, hi);
+#endif
+}
+
+// Elements of 16 bits, updated through the 32-bit word they are in
+template <typename T>
+__device__ void add16(T& dst, T val) {
+  const auto address = reinterpret_cast<size_t>(&dst);
+  auto word = reinterpret_cast<unsigned int*>(address & ~(size_t)3);
+  const bool is_hi = (address & 2) != 0;
+  float lo = is_hi ? 0.f : toFloat(val);
+  float hi = is_hi ? toFloat(val) : 0.f;
+#ifdef NVFUSER_SCATTER_WARP_AGGREGATION
+  const unsigned int active = __activemask();
+  const unsigned int peers = matchPeers(active, (unsigned long long)word);
+  if (peers != 0) {
+    lo = segmentedReduce(active, peers, lo);
+    hi = segmentedReduce(active, peers, hi);
+    if ((peers & lanesBelow()) != 0) {
+      return;
+    }
+  }
+#endif
+  atomicAddPacked<T>(word, lo, hi);
+}
+
+} // namespace detail
+
+template <typename T>
+__device__ void add(T& dst, T val) {
+#ifdef NVFUSER_SCATTER_WARP_AGGREGATION
+  const unsigned int active = __activemask();
+  const unsigned int peers =
+      detail::matchPeers(active, (unsigned long long)&dst);
+  if (peers != 0) {
+    val = detail::segmentedReduce(active, peers, val);
+    if ((peers & detail::lanesBelow()) != 0) {
+      return;
+    }
+  }
+#endif
+  detail::atomicAddValue(&dst, val);
+}
+
+__device__ inline void add(__half& dst, __half val) {
+  detail::add16(dst, val);
+}
+
+__device__ inline void add(__bfloat& dst, __bfloat val) {
+  detail::add16(dst, val);
+}
+
+#undef NVFUSER_SCATTER_WARP_AGGREGATION
+
+} // namespace scatter
@@ -393,6 +393,66 @@ DEVICE_INLINE void M16N16K16TN(
       reinterpret_cast<Array<__half, 4, 4>*>(&_B[4]));
 }
 
+// TF32 mma: the operands are read as floats and rounded to tf32 before
+//  being passed to the tensor core. The fragments of 32-bit operands hold
+//  half as many elements per register as the fp16 ones:
+//   A: 4 floats, the (g, t), (g + 8, t), (g, t + 4), (g + 8, t + 4) elements
+//   B: 2 floats, the (t, g), (t + 4, g) elements
+//  of the 16x8 and 8x8 tiles, where g = laneid / 4 and t = laneid % 4.
+namespace util {
+
+DEVICE_INLINE unsigned float2tf32(float f) {
+  unsigned tf32;
+  asm("cvt.rna.tf32.f32 %0, %1;\n" : "=r"(tf32) : "f"(f));
+  return tf32;
+}
+
+DEVICE_INLINE void m16n8k8TN(
+    Array<float, 4, 4>* C,
+    Array<float, 4, 4>* A,
+    Array<float, 2, 2>* B) {
+  float const* _A = reinterpret_cast<float const*>(A);
+  float const* _B = reinterpret_cast<float const*>(B);
+  unsigned* _C = reinterpret_cast<unsigned*>(C);
+  const unsigned* _D = reinterpret_cast<const unsigned*>(C);
+
+  asm("mma.sync.aligned.m16n8k8.row.col.f32.tf32.tf32.f32 {%0,%1,%2,%3}, {%4,%5,%6,%7}, {%8,%9}, {%10,%11,%12,%13};\n"
+      : "=r"(_C[0]), "=r"(_C[1]), "=r"(_C[2]), "=r"(_C[3])
+      : "r"(float2tf32(_A[0])),
+        "r"(float2tf32(_A[1])),
+        "r"(float2tf32(_A[2])),
+        "r"(float2tf32(_A[3])),
+        "r"(float2tf32(_B[0])),
+        "r"(float2tf32(_B[1])),
+        "r"(_D[0]),
+        "r"(_D[1]),
+        "r"(_D[2]),
+        "r"(_D[3]));
+}
+
+} // namespace util
+
+template <int acc_stride>
+DEVICE_INLINE void initM16N8K8TN(Array<float, 4, 4>* accumulator) {
+  initM16N8K16TN<acc_stride>(accumulator);
+}
+
+template <int acc_stride = 2>
+DEVICE_INLINE void M16N8K8TN(
+    Array<float, 4, 4>* C,
+    Array<float, 4, 4>* A,
+    Array<float, 2, 2>* B) {
+  float* _C = reinterpret_cast<float*>(C);
+  float C_data[4] = {_C[0], _C[1], _C[acc_stride], _C[acc_stride + 1]};
+
+  util::m16n8k8TN(reinterpret_cast<Array<float, 4, 4>*>(&C_data[0]), A, B);
+
+  _C[0] = C_data[0];
+  _C[1] = C_data[1];
+  _C[acc_stride] = C_data[2];
+  _C[acc_stride + 1] = C_data[3];
+}
+
 } // namespace Ampere
 
 #endif // Arch 80
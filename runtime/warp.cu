@@ -38,9 +38,11 @@ __device__ void warpReduceTIDX(
         reduce_val, __shfl_xor_sync(0xffffffff, reduce_val, i, WARP_SIZE));
   }
 
-  // Reduce across warp if needed
+  // Reduce across warp if needed. TIDx padded to a multiple of a warp may
+  // still turn out to be a single warp at launch, which needs no shared
+  // memory either.
   // Load value to shared mem
-  if (!SINGLE_WARP) {
+  if (!SINGLE_WARP && block_dim.x != WARP_SIZE) {
     unsigned int warp_idx = thread_idx.x / WARP_SIZE;
     unsigned int lane_idx = thread_idx.x % WARP_SIZE;
     unsigned int reduce_group_id = thread_idx.z * block_dim.y + thread_idx.y;
@@ -80,4 +82,150 @@ __device__ void warpReduceTIDX(
   }
 }
 
+// Reduces across the threads of the masked dimensions like blockReduce, but
+// with warp shuffles wherever possible. This requires the threads of each
+// reduction segment to be adjacent in the block, i.e., the reduced
+// dimensions are the innermost ones, and the block to be made of full warps:
+//
+// - When the segments are power-of-2 groups of no more than a warp, each
+//   segment is reduced with shuffles within its lanes, without shared memory
+//   or block synchronization, e.g., a softmax over short rows along TIDx
+//   with several rows per block along TIDy.
+// - When the segments are made of whole warps, each warp is reduced with
+//   shuffles, its first lane writes the partial result to shared memory, and
+//   the first warp of each segment reduces the partial results of its
+//   segment with shuffles again. That takes two block syncs and one shared
+//   memory value per warp instead of a sync and a shared memory value per
+//   thread for each level of the tree reduction of blockReduce.
+//
+// Otherwise this falls back to blockReduce. The choice only depends on
+// blockDim, so all threads of the block take the same path. As with
+// blockReduce, only the first thread of each segment writes the result, and
+// shared memory is free to reuse when this returns.
+template <
+    bool X_REDUCE,
+    bool Y_REDUCE,
+    bool Z_REDUCE,
+    typename T,
+    typename Func,
+    typename _dim3ti,
+    typename _dim3bd>
+__device__ void blockReduceShuffle(
+    T& out,
+    const T& inp_val,
+    Func reduction_op,
+    const _dim3ti& thread_idx,
+    const _dim3bd& block_dim,
+    T* shared_mem,
+    bool read_pred,
+    bool write_pred,
+    T init_val) {
+  constexpr unsigned int WARP_SIZE = 32;
+  // The threads of a segment are adjacent if no dimension that isn't
+  // reduced is inside a reduced one
+  constexpr bool ADJACENT_SEGMENTS =
+      (X_REDUCE || (!Y_REDUCE && !Z_REDUCE)) && (Y_REDUCE || !Z_REDUCE);
+
+  const unsigned int reduction_size =
+      index_utils::maskedSize<X_REDUCE, Y_REDUCE, Z_REDUCE>(block_dim);
+  const bool full_warps =
+      (block_dim.x * block_dim.y * block_dim.z) % WARP_SIZE == 0;
+  const bool is_sub_warp = reduction_size <= WARP_SIZE &&
+      (reduction_size & (reduction_size - 1)) == 0;
+  const bool is_multi_warp = reduction_size % WARP_SIZE == 0;
+
+  if (!ADJACENT_SEGMENTS || !full_warps || !(is_sub_warp || is_multi_warp)) {
+    blockReduce<X_REDUCE, Y_REDUCE, Z_REDUCE>(
+        out,
+        inp_val,
+        reduction_op,
+        thread_idx,
+        block_dim,
+        shared_mem,
+        read_pred,
+        write_pred,
+        init_val);
+    return;
+  }
+
+  const unsigned int reduction_tid =
+      index_utils::maskedOffset<X_REDUCE, Y_REDUCE, Z_REDUCE>(
+          thread_idx, block_dim);
+
+  T reduce_val = init_val;
+  if (read_pred) {
+    reduce_val = inp_val;
+  }
+
+  const unsigned int warp_reduction_size =
+      is_sub_warp ? reduction_size : WARP_SIZE;
+  for (unsigned int i = warp_reduction_size / 2; i >= 1; i /= 2) {
+    reduction_op(
+        reduce_val, __shfl_xor_sync(0xffffffff, reduce_val, i, WARP_SIZE));
+  }
+
+  if (is_sub_warp) {
+    if (reduction_tid == 0 && write_pred) {
+      reduction_op(out, reduce_val);
+    }
+    return;
+  }
+
+  const unsigned int reduction_idx =
+      index_utils::maskedOffset<!X_REDUCE, !Y_REDUCE, !Z_REDUCE>(
+          thread_idx, block_dim);
+  // At most 32 warps in a block
+  const unsigned int num_of_warps = reduction_size / WARP_SIZE;
+  const unsigned int smem_offset = reduction_idx * num_of_warps;
+
+  if (reduction_tid % WARP_SIZE == 0) {
+    shared_mem[smem_offset + reduction_tid / WARP_SIZE] = reduce_val;
+  }
+  block_sync::sync();
+
+  if (reduction_tid < WARP_SIZE) {
+    reduce_val = reduction_tid < num_of_warps
+        ? shared_mem[smem_offset + reduction_tid]
+        : init_val;
+    for (unsigned int i = WARP_SIZE / 2; i >= 1; i /= 2) {
+      reduction_op(
+          reduce_val, __shfl_xor_sync(0xffffffff, reduce_val, i, WARP_SIZE));
+    }
+    if (reduction_tid == 0 && write_pred) {
+      reduction_op(out, reduce_val);
+    }
+  }
+  block_sync::sync();
+}
+
+// Use the same pred for both reads and writes
+template <
+    bool X_REDUCE,
+    bool Y_REDUCE,
+    bool Z_REDUCE,
+    typename T,
+    typename Func,
+    typename _dim3ti,
+    typename _dim3bd>
+__device__ void blockReduceShuffle(
+    T& out,
+    const T& inp_val,
+    Func reduction_op,
+    const _dim3ti& thread_idx,
+    const _dim3bd& block_dim,
+    T* shared_mem,
+    bool read_write_pred,
+    T init_val) {
+  blockReduceShuffle<X_REDUCE, Y_REDUCE, Z_REDUCE>(
+      out,
+      inp_val,
+      reduction_op,
+      thread_idx,
+      block_dim,
+      shared_mem,
+      read_write_pred,
+      read_write_pred,
+      init_val);
+}
+
 } // namespace warp
@@ -949,4 +949,48 @@ TEST_F(ExprSimplifierTest, ReducePredicateRegisterUsage_CUDA) {
   }
 }
 
+TEST_F(ExprSimplifierTest, SameAsModuloReordering_CUDA) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(&fusion);
+
+  TORCH_CHECK(sameAsModuloReordering("i1 + i2"_, "i2 + i1"_));
+  TORCH_CHECK(
+      sameAsModuloReordering("( i1 + i2 ) + i3"_, "i3 + ( i2 + i1 )"_));
+  TORCH_CHECK(sameAsModuloReordering(
+      "( i1 * T0.size[0] + i2 ) / 4"_, "( i2 + T0.size[0] * i1 ) / 4"_));
+  TORCH_CHECK(sameAsModuloReordering(
+      "i1 < T0.size[0] && i2 < 8"_, "i2 < 8 && i1 < T0.size[0]"_));
+  TORCH_CHECK(!sameAsModuloReordering("i1 / i2"_, "i2 / i1"_));
+  TORCH_CHECK(!sameAsModuloReordering("i1 + i2"_, "i1 + i3"_));
+  TORCH_CHECK(
+      !sameAsModuloReordering("i1 * ( i2 + i3 )"_, "i1 * i2 + i1 * i3"_));
+  // Floating point arithmetic is not associative
+  TORCH_CHECK(
+      !sameAsModuloReordering("( d1 + d2 ) + d3"_, "d1 + ( d2 + d3 )"_));
+}
+
+TEST_F(ExprSimplifierTest, SharedSubexpression_CUDA) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(&fusion);
+
+  // Every level uses the previous one twice, so simplifying the tree
+  // unfolded from this DAG would visit 2^32 nodes
+  Val* x = "i1"_;
+  for (auto i : c10::irange(32)) {
+    (void)i;
+    x = add(cpp_div(x, "i2"_), cpp_div(x, "i3"_));
+  }
+
+  // The shared subexpressions are simplified once, and stay shared
+  auto simplified = simplifyExpr(x);
+  auto bop = dynamic_cast<BinaryOp*>(simplified->definition());
+  TORCH_CHECK(bop != nullptr && bop->getBinaryOpType() == BinaryOpType::Add);
+  auto lhs = dynamic_cast<BinaryOp*>(bop->lhs()->definition());
+  auto rhs = dynamic_cast<BinaryOp*>(bop->rhs()->definition());
+  TORCH_CHECK(lhs != nullptr && rhs != nullptr);
+  TORCH_CHECK(lhs->lhs() == rhs->lhs());
+}
+
 } // namespace nvfuser
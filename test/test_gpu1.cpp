@@ -7508,6 +7508,61 @@ TEST_F(NVFuserTest, FusionTestMaskSoftmax_CUDA) {
       lparams);
 }
 
+// Masks generated from iota comparisons, see
+// Note [ Generated attention masks ]
+TEST_F(NVFuserTest, FusionGeneratedMaskSoftmax_CUDA) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  const int64_t kWindow = 5;
+  TensorView* input = makeSymbolicTensor(4);
+  TensorView* lengths = makeSymbolicTensor(1, DataType::Int);
+  fusion->addInput(input);
+  fusion->addInput(lengths);
+
+  auto mask = bitwise_and(
+      causal_mask(input, IrBuilder::create<Int>(kWindow)),
+      length_mask(input, lengths));
+  auto output = masked_softmax(input, mask, -1);
+  fusion->addOutput(output);
+
+  // No mask tensor is read
+  TORCH_CHECK(fusion->inputs().size() == 2);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto options_int = options.dtype(at::kLong);
+  at::Tensor aten_input = at::randn({2, 3, 12, 16}, options);
+  // The last queries of the second batch have no key left
+  at::Tensor aten_lengths = at::tensor({16, 7}, options_int);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  auto cg_outputs =
+      executor_cache.runFusionWithInputs({aten_input, aten_lengths});
+
+  auto queries = at::arange(12, options_int).view({12, 1}) + (16 - 12);
+  auto keys = at::arange(16, options_int).view({1, 16});
+  auto aten_mask = at::logical_and(keys <= queries, keys > queries - kWindow)
+                       .view({1, 1, 12, 16})
+                       .logical_and(keys.view({1, 1, 1, 16}) <
+                                    aten_lengths.view({2, 1, 1, 1}));
+  auto aten_output =
+      at::_softmax(
+          aten_input.masked_fill(
+              aten_mask.logical_not(),
+              -std::numeric_limits<float>::infinity()),
+          -1,
+          false)
+          .masked_fill(aten_mask.logical_not(), 0);
+
+  testValidate(
+      executor_cache.fusion(),
+      cg_outputs,
+      {aten_input, aten_lengths},
+      {aten_output},
+      __LINE__,
+      __FILE__);
+}
+
 TEST_F(NVFuserTest, FusionMagicSchedulerLayerNormBackward_CUDA) {
   std::unique_ptr<Fusion> fusion_ptr = std::make_unique<Fusion>();
   Fusion& fusion = *fusion_ptr.get();
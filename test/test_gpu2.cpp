@@ -12,6 +12,7 @@
 #include <disjoint_set.h>
 #include <executor.h>
 #include <executor_params.h>
+#include <executor_utils.h>
 #include <expr_evaluator.h>
 #include <fusion.h>
 #include <fusion_segmenter.h>
@@ -48,10 +49,12 @@
 
 #include <ATen/cuda/CUDAContext.h>
 #include <ATen/cuda/Exceptions.h>
+#include <c10/cuda/CUDAGuard.h>
 #include <c10/cuda/CUDAStream.h>
 
 #include <algorithm>
 #include <iostream>
+#include <numeric>
 #include <sstream>
 #include <thread>
 
@@ -1098,6 +1101,80 @@ TEST_F(NVFuserTest, FusionInputsIdLookup_CUDA) {
   TORCH_CHECK(id_1_relook.eviction == false);
 }
 
+TEST_F(NVFuserTest, FusionInputsIdLookupSharded_CUDA) {
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+
+  // 4 shards holding 8 entries each, so no shard overflows below
+  nvfuser::InputsIdLookup inputs_id_lookup(32, 4);
+
+  std::vector<at::Tensor> tensors;
+  std::vector<size_t> ids;
+  for (auto i : c10::irange(8)) {
+    tensors.push_back(at::randn({i + 1, 8}, options));
+    auto ret = inputs_id_lookup.lookupId({tensors.back()});
+    TORCH_CHECK(ret.eviction == false);
+    ids.push_back(ret.id);
+  }
+  TORCH_CHECK(inputs_id_lookup.size() == 8);
+
+  // ids are unique across shards and stable on re-lookup
+  std::unordered_set<size_t> unique_ids(ids.begin(), ids.end());
+  TORCH_CHECK(unique_ids.size() == ids.size());
+  for (auto i : c10::irange(tensors.size())) {
+    auto ret = inputs_id_lookup.lookupId({tensors[i]});
+    TORCH_CHECK(ret.id == ids[i]);
+    TORCH_CHECK(ret.eviction == false);
+  }
+
+  // same sizes with a different stride must not alias an existing entry
+  auto t_transposed = at::randn({8, 1}, options).t();
+  auto ret = inputs_id_lookup.lookupId({t_transposed});
+  TORCH_CHECK(unique_ids.count(ret.id) == 0);
+}
+
+TEST_F(NVFuserTest, FusionExecutorCacheOutputReuse_CUDA) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = add(tv0, IrBuilder::create<Double>(1.0));
+  fusion->addOutput(tv1);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({128, 65}, options);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  executor_cache.setOutputRecycling(1);
+
+  // first run initializes the cache entry, the second one fills the ring
+  executor_cache.runFusionWithInputs({t0});
+  auto outputs = executor_cache.runFusionWithInputs({t0});
+  const void* recycled_ptr = outputs[0].data_ptr();
+
+  // outputs still referenced by the caller are not recycled
+  auto held_outputs = executor_cache.runFusionWithInputs({t0});
+  TORCH_CHECK(held_outputs[0].data_ptr() != recycled_ptr);
+
+  outputs.clear();
+  outputs = executor_cache.runFusionWithInputs({t0});
+  TORCH_CHECK(outputs[0].data_ptr() == recycled_ptr);
+  testValidate(
+      executor_cache.fusion(), outputs, {t0}, {t0 + 1}, __LINE__, __FILE__);
+
+  // preallocated outputs are written in place
+  auto preallocated = at::empty_like(t0);
+  outputs = executor_cache.runFusionWithInputs({t0}, {preallocated});
+  TORCH_CHECK(outputs[0].data_ptr() == preallocated.data_ptr());
+  testValidate(
+      executor_cache.fusion(), outputs, {t0}, {t0 + 1}, __LINE__, __FILE__);
+
+  // outputs not matching the cached allocation are rejected
+  auto mismatched = at::empty({65, 128}, options).t();
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-goto,hicpp-avoid-goto)
+  ASSERT_ANY_THROW(executor_cache.runFusionWithInputs({t0}, {mismatched}));
+}
+
 TEST_F(NVFuserTest, FusionGroupGuardSimpleTensor_CUDA) {
   std::vector<int64_t> sizes_vec({16, 8, 8});
   std::vector<int64_t> strides_vec({64, 8, 1});
@@ -9,6 +9,7 @@
 #include <gtest/gtest.h>
 
 #include <codegen.h>
+#include <device_profile.h>
 #include <disjoint_set.h>
 #include <executor.h>
 #include <executor_params.h>
@@ -17,6 +18,7 @@
 #include <fusion_segmenter.h>
 #include <grouped_reduction.h>
 #include <inlining.h>
+#include <instrumentation.h>
 #include <ir_all_nodes.h>
 #include <ir_builder.h>
 #include <ir_graphviz.h>
@@ -24,10 +26,14 @@
 #include <ir_utils.h>
 #include <iter_visitor.h>
 #include <kernel_cache.h>
+#include <kernel_db/utils.h>
 #include <kernel_ir.h>
 #include <kernel_ir_dispatch.h>
 #include <lower2device.h>
+#include <lower_divisible_split.h>
 #include <lower_magic_zero.h>
+#include <lower_predicate_elimination.h>
+#include <lower_validation.h>
 #include <mutator.h>
 #include <ops/all_ops.h>
 #include <root_domain_map.h>
@@ -46,10 +52,13 @@
 
 #include <ATen/cuda/CUDAContext.h>
 #include <ATen/cuda/Exceptions.h>
+#include <c10/cuda/CUDAGuard.h>
 #include <c10/cuda/CUDAStream.h>
 
 #include <algorithm>
+#include <chrono>
 #include <iostream>
+#include <numeric>
 #include <sstream>
 #include <thread>
 
@@ -3278,6 +3287,39 @@ TEST_F(NVFuserMultithreadedTest, MultipleFunctions_CUDA) {
   }
 }
 
+TEST_F(NVFuserMultithreadedTest, SharedFusionExecutorCache_CUDA) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = sum(exp(tv0), {1});
+  fusion->addOutput(tv1);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+
+  // threads share the cache and select runtimes for overlapping dynamic
+  // shapes concurrently
+  auto run_kernel = [&executor_cache](size_t thread_id) {
+    auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+    for (const auto i : c10::irange(16)) {
+      const int64_t inner_size = 8 * (int64_t)((i + thread_id) % 8 + 1);
+      auto t0 = at::randn({32, inner_size}, options);
+      auto outputs = executor_cache.runFusionWithInputs({t0});
+      ASSERT_TRUE(at::allclose(outputs[0], t0.exp().sum({1})));
+    }
+  };
+
+  constexpr size_t kNumThreads = 4;
+  std::vector<std::thread> threads;
+  for (size_t id = 0; id < kNumThreads; ++id) {
+    threads.emplace_back(run_kernel, id);
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+}
+
 // Repro of issue #1655
 TEST_F(NVFuserTest, FusionIncompleteConcreteID_CUDA) {
   Fusion fusion;
@@ -8041,6 +8083,1867 @@ TEST_F(NVFuserTest, FusionManagedData_CUDA) {
   ASSERT_EQ(kernel->getManaged<T2>("data2").magic_number, 0x123456789abcdef);
 }
 
+TEST_F(NVFuserTest, FusionReductionCircularBufferedInputs_CUDA) {
+  NVFUSER_TEST_CUDA_ARCH_GUARD(8, 0);
+
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeContigTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = sum(tv0, {1});
+  fusion.addOutput(tv1);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({16, 1 << 16}, options);
+
+  auto rparams = getReductionHeuristics(&fusion, {t0});
+  TORCH_CHECK(rparams, "Reduction schedule was not generated!");
+  TORCH_CHECK(rparams->vectorize_inner_reduction && !rparams->schedule_3D);
+  rparams->circular_buffer_stages = 3;
+  scheduleReduction(&fusion, *rparams);
+
+  auto tvs = ir_utils::allTvs(&fusion);
+  auto circular_buffered_it =
+      std::find_if(tvs.begin(), tvs.end(), [](TensorView* tv) {
+        return tv->isCircularBuffered();
+      });
+  TORCH_CHECK(circular_buffered_it != tvs.end());
+  TORCH_CHECK(
+      (*circular_buffered_it)->getMemoryType() == MemoryType::Shared &&
+      (*circular_buffered_it)->circularBufferDepth() == 3);
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {t0}, rparams->lparams);
+  TORCH_CHECK(fe.kernelString().find("cpAsyncCa") != std::string::npos);
+  auto cg_outputs = fe.runFusion({t0}, rparams->lparams);
+  testValidate(
+      &fusion,
+      cg_outputs,
+      {t0},
+      {t0.sum({1})},
+      __LINE__,
+      __FILE__,
+      "",
+      rparams->lparams);
+}
+
+// Divisions by the extents of merged domains use precomputed multipliers
+// with 32-bit indices
+TEST_F(NVFuserTest, FusionFastDivMod_CUDA) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(3);
+  fusion.addInput(tv0);
+  auto tv1 = add(tv0, IrBuilder::create<Double>(1));
+  fusion.addOutput(tv1);
+
+  // tv0 isn't contiguous, so its index needs the indices of the merged
+  // domains
+  tv1->merge(1)->merge(0)->split(0, 128);
+  tv1->axis(0)->parallelize(ParallelType::BIDx);
+  tv1->axis(1)->parallelize(ParallelType::TIDx);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({7, 13, 29}, options).transpose(0, 2);
+
+  FusionExecutor fe;
+  CompileParams compile_opts = {.index_type = PrimDataType::Int32};
+  fe.compileFusion(&fusion, {t0}, LaunchParams(), compile_opts);
+  const auto kernel_string = fe.kernelString();
+  TORCH_CHECK(
+      kernel_string.find("fastDivMultiplier(") != std::string::npos,
+      kernel_string);
+  TORCH_CHECK(kernel_string.find("fastDiv(") != std::string::npos);
+
+  auto outputs = fe.runFusion({t0}, LaunchParams(), compile_opts);
+  testValidate(&fusion, outputs, {t0}, {t0 + 1}, __LINE__, __FILE__);
+}
+
+// Full tiles of unrolled loops in the else clause of an unswitch are peeled
+// off into an unpredicated path
+TEST_F(NVFuserTest, FusionPeelFullTiles_CUDA) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(1);
+  fusion.addInput(tv0);
+  auto tv1 = set(tv0);
+  auto tv2 = add(tv1, IrBuilder::create<Double>(1));
+  fusion.addOutput(tv2);
+
+  // [BIDx, Unswitch, serial, Unroll]
+  tv2->split(0, 4);
+  tv2->split(0, 8);
+  tv2->split(0, 1);
+  tv2->axis(0)->parallelize(ParallelType::BIDx);
+  tv2->axis(1)->parallelize(ParallelType::Unswitch);
+  tv2->axis(3)->parallelize(ParallelType::Unroll);
+  tv1->computeAt(tv2, -1);
+
+  struct UnswitchCounter : kir::IrVisitor {
+    using kir::IrVisitor::handle;
+    int64_t num_unswitches = 0;
+
+    void handle(kir::IfThenElse* ite) final {
+      if (ite->predicate()->predicate_type() == PredicateType::Unswitch) {
+        ++num_unswitches;
+      }
+      kir::IrVisitor::handle(ite);
+    }
+  } counter;
+
+  GpuLower gpulw(&fusion);
+  counter.handle(gpulw.kernel()->topLevelExprs());
+  // The outer unswitch and the peeled tile in its else clause
+  TORCH_CHECK(
+      counter.num_unswitches == 2,
+      "Unexpected unswitches: ",
+      counter.num_unswitches);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({999}, options);
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {t0});
+  auto outputs = fe.runFusion({t0});
+  testValidate(&fusion, outputs, {t0}, {t0 + 1}, __LINE__, __FILE__);
+}
+
+// Loop transformations keep the analyses cached on the tensor graph while
+// new tensor expressions drop them
+TEST_F(NVFuserTest, FusionCachedTvGraphAnalysis_CUDA) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = sum(tv0, {1});
+  auto tv2 = add(tv1, IrBuilder::create<Double>(1));
+  fusion.addOutput(tv2);
+
+  fusion.cacheAnalysis("test", 1);
+  const auto version = fusion.tvGraphVersion();
+
+  tv1->split(1, 4);
+  tv1->reorder({{1, 2}, {2, 1}});
+  TORCH_CHECK(fusion.tvGraphVersion() == version);
+  TORCH_CHECK(fusion.getCachedAnalysis<int>("test") != nullptr);
+
+  auto tv3 = tv1->rFactor({-1});
+  TORCH_CHECK(fusion.tvGraphVersion() != version);
+  TORCH_CHECK(fusion.getCachedAnalysis<int>("test") == nullptr);
+
+  // The cached unmappable dims must follow the new tensor
+  inlineMost();
+  TORCH_CHECK(fusion.getCachedAnalysis<std::unordered_set<IterDomain*>>(
+                  "MaxPosCalculator::unmappable_dims") != nullptr);
+  TORCH_CHECK(tv3->getComputeAtPosition() == 1);
+
+  tv2->axis(0)->parallelize(ParallelType::BIDx);
+  scheduler_utils::parallelizeAllLike(tv2);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({5, 31}, options);
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {t0});
+  auto outputs = fe.runFusion({t0});
+  testValidate(&fusion, outputs, {t0}, {t0.sum({1}) + 1}, __LINE__, __FILE__);
+}
+
+// Persistent buffers that exceed the register file are staged in shared
+// memory instead of segmenting the normalization
+TEST_F(NVFuserTest, FusionSmemPersistentBuffers_CUDA) {
+  const int64_t rows = 128;
+  const int64_t cols = 34000;
+  if (scheduler_utils::smemPersistentBufferSize() <
+      cols * (int64_t)dataTypeSize(DataType::Float)) {
+    GTEST_SKIP() << "Not enough shared memory on this device";
+  }
+
+  std::unique_ptr<Fusion> fusion_ptr = std::make_unique<Fusion>();
+  auto fusion = fusion_ptr.get();
+  FusionGuard fg(fusion);
+
+  auto tv0 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = sum(tv0, {1});
+  auto tv2 = broadcast(tv1, {false, true});
+  auto tv3 = div(tv0, tv2);
+  fusion->addOutput(tv3);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({rows, cols}, options);
+  std::vector<c10::IValue> aten_inputs({t0});
+
+  FusionExecutorCache fec(std::move(fusion_ptr));
+  auto cg_outputs = fec.runFusionWithInputs(aten_inputs);
+
+  auto runtime = fec.getMostRecentKernelRuntime();
+  TORCH_CHECK(!runtime->isSegmented());
+  TORCH_CHECK(
+      runtime->schedulerHeuristics()->singleKernelHeuristics()->heuristic() ==
+      ScheduleHeuristic::Persistent);
+  auto params = dynamic_cast<ReductionParams*>(
+      runtime->getMostRecentExecutorLog().params.get());
+  TORCH_CHECK(params != nullptr && params->smem_persistent_buffers);
+
+  testValidate(
+      fec.fusion(),
+      cg_outputs,
+      aten_inputs,
+      {t0 / t0.sum({1}, true)},
+      __LINE__,
+      __FILE__);
+}
+
+// Vectorizing a domain merged across the padded stride of a sliced input is
+// only valid if vectors can't cross the padding
+TEST_F(NVFuserTest, FusionVectorizeStridedMergeValidation_CUDA) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  TensorView* tv0 =
+      TensorViewBuilder().ndims(2).contiguity({false, true}).build();
+  fusion.addInput(tv0);
+  auto tv1 = set(tv0);
+  fusion.addOutput(tv1);
+
+  tv1->merge(0);
+  tv1->split(0, 4);
+  tv1->axis(0)->parallelize(ParallelType::TIDx);
+  tv1->axis(1)->parallelize(ParallelType::Vectorize);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+
+  FusionExecutor fe;
+  at::Tensor t0 = at::randn({64, 20}, options).narrow(1, 0, 16);
+  fe.compileFusion(&fusion, {t0});
+  auto cg_outputs = fe.runFusion({t0});
+  testValidate(&fusion, cg_outputs, {t0}, {t0}, __LINE__, __FILE__);
+
+  // Vectors would straddle the rows of the slice
+  at::Tensor t1 = at::randn({64, 20}, options).narrow(1, 0, 18);
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-goto,hicpp-avoid-goto)
+  ASSERT_ANY_THROW(fe.runFusion({t1}));
+}
+
+// A 1D pointwise schedule looping over its blocks of elements with a grid
+// smaller than the number of blocks
+TEST_F(NVFuserTest, FusionPointwiseGridStrideLoop_CUDA) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeContigTensor(1);
+  fusion.addInput(tv0);
+  auto tv1 = add(tv0, IrBuilder::create<Double>(1));
+  auto tv2 = mul(tv1, IrBuilder::create<Double>(2));
+  fusion.addOutput(tv2);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({1000003}, options);
+
+  auto params = getPointwiseHeuristics(&fusion, {t0});
+  TORCH_CHECK(params != nullptr && params->break_point == 0);
+  params->grid_stride_loop = true;
+  params->lparams.bind(7, ParallelType::BIDx);
+  schedulePointwise(&fusion, *params);
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {t0}, params->lparams);
+  auto cg_outputs = fe.runFusion({t0}, params->lparams);
+  TORCH_CHECK(fe.lastLaunchParams().gdimx() == 7);
+  testValidate(&fusion, cg_outputs, {t0}, {(t0 + 1) * 2}, __LINE__, __FILE__);
+}
+
+TEST_F(NVFuserTest, FusionHorizontalPointwise_CUDA) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  // Two independent pointwise subgraphs of different shapes
+  auto tv0 = makeContigTensor(1);
+  fusion.addInput(tv0);
+  auto tv1 = add(tv0, IrBuilder::create<Double>(1));
+  fusion.addOutput(tv1);
+
+  auto tv2 = makeContigTensor(2);
+  fusion.addInput(tv2);
+  auto tv3 = mul(tv2, IrBuilder::create<Double>(2));
+  auto tv4 = sin(tv3);
+  fusion.addOutput(tv4);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({1001}, options);
+  at::Tensor t2 = at::randn({33, 77}, options);
+  std::vector<c10::IValue> aten_inputs = {t0, t2};
+
+  TORCH_CHECK(getHorizontalReferenceTensorViews(&fusion).size() == 2);
+
+  auto lparams = schedulePointwise(&fusion, aten_inputs);
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, aten_inputs, lparams);
+  auto cg_outputs = fe.runFusion(aten_inputs, lparams);
+
+  testValidate(
+      &fusion,
+      cg_outputs,
+      aten_inputs,
+      {t0 + 1, (t2 * 2).sin()},
+      __LINE__,
+      __FILE__);
+}
+
+TEST_F(NVFuserTest, FusionSegmentCostGuidedMerge_CUDA) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  // Normalization {first kernel}
+  auto tv1 = sum(tv0, {1});
+  auto tv2 = broadcast(tv1, {false, true});
+  auto tv3 = div(tv0, tv2);
+  // Outer reduction of the normalized tensor {second kernel}
+  auto tv4 = sum(tv3, {0});
+  auto tv5 = broadcast(tv4, {true, false});
+  auto tv6 = add(tv3, tv5);
+  fusion->addOutput(tv6);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({128, 1024}, options);
+
+  KernelArgumentHolder args(KernelIndexMode::INT32);
+  args.setDeviceIndex(0);
+  args.push(t0);
+
+  SegmentCandidateFinderOptions default_options;
+  default_options.cost_guided_merge = false;
+  auto default_segmented_fusion =
+      SegmentCandidateFinder::segment(fusion.get(), args, default_options);
+
+  SegmentCandidateFinderOptions cost_guided_options;
+  cost_guided_options.cost_guided_merge = true;
+  auto cost_guided_segmented_fusion =
+      SegmentCandidateFinder::segment(fusion.get(), args, cost_guided_options);
+
+  // There's a single producer-consumer pair to merge, so both merge orders
+  // end up with the same plan
+  TORCH_CHECK(
+      cost_guided_segmented_fusion->groups().size() ==
+      default_segmented_fusion->groups().size());
+}
+
+TEST_F(NVFuserTest, FusionSegmentRecomputePointwiseInputs_CUDA) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = makeSymbolicTensor(1);
+  fusion->addInput(tv1);
+  auto tv2 = broadcast(tv1, {true, false});
+  auto tv3 = add(tv0, tv2);
+  // Inner and outer reductions of tv3 {two kernels}
+  auto tv4 = sum(tv3, {1});
+  auto tv5 = sum(tv3, {0});
+  fusion->addOutput(tv4);
+  fusion->addOutput(tv5);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({128, 1024}, options);
+  at::Tensor t1 = at::randn({1024}, options);
+
+  KernelArgumentHolder args(KernelIndexMode::INT32);
+  args.setDeviceIndex(0);
+  args.push(t0);
+  args.push(t1);
+
+  // The segmenter works on a copy of the fusion, look tv3 up by name
+  auto uses_tv3 = [&tv3](const SegmentedFusion* segmented_fusion) {
+    return std::any_of(
+        segmented_fusion->groups().begin(),
+        segmented_fusion->groups().end(),
+        [&tv3](const SegmentedGroup* group) {
+          return std::any_of(
+              group->inputs().begin(), group->inputs().end(), [&](Val* inp) {
+                return inp->isA<TensorView>() && inp->name() == tv3->name();
+              });
+        });
+  };
+
+  SegmentCandidateFinderOptions materialize_options;
+  materialize_options.recompute_pointwise_inputs = false;
+  auto materialized =
+      SegmentCandidateFinder::segment(fusion.get(), args, materialize_options);
+  TORCH_CHECK(materialized->groups().size() == 2);
+  TORCH_CHECK(uses_tv3(materialized.get()));
+
+  // Reading the bias twice is cheaper than writing and reading back tv3
+  SegmentCandidateFinderOptions recompute_options;
+  recompute_options.recompute_pointwise_inputs = true;
+  auto recomputed =
+      SegmentCandidateFinder::segment(fusion.get(), args, recompute_options);
+  TORCH_CHECK(recomputed->groups().size() == 2);
+  TORCH_CHECK(!uses_tv3(recomputed.get()));
+}
+
+TEST_F(NVFuserTest, FusionInplaceResidualAdd_CUDA) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = makeSymbolicTensor(2);
+  fusion->addInput(tv1);
+  auto tv2 = add(tv0, tv1);
+  fusion->aliasOutputToInput(tv2, tv0);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({129, 1025}, options);
+  at::Tensor t1 = at::randn({129, 1025}, options);
+  auto t2 = t0 + t1;
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  auto outputs = executor_cache.runFusionWithInputs({t0, t1});
+
+  // Aliased outputs are written to their input and not returned
+  TORCH_CHECK(outputs.empty());
+  TORCH_CHECK(t0.allclose(t2));
+}
+
+TEST_F(NVFuserTest, FusionInplaceUnsafeAlias_CUDA) {
+  {
+    Fusion fusion;
+    FusionGuard fg(&fusion);
+
+    // Every element of the output depends on a whole row of the input
+    auto tv0 = makeSymbolicTensor(2);
+    fusion.addInput(tv0);
+    auto tv1 = sum(tv0, {1});
+    auto tv2 = broadcast(tv1, {false, true});
+    auto tv3 = sub(tv0, tv2);
+    fusion.aliasOutputToInput(tv3, tv0);
+
+    ASSERT_ANY_THROW(validateAliasedOutputs(&fusion));
+  }
+  {
+    Fusion fusion;
+    FusionGuard fg(&fusion);
+
+    auto tv0 = makeSymbolicTensor(2);
+    fusion.addInput(tv0);
+    auto tv1 = transpose(tv0);
+    auto tv2 = add(tv0, tv1);
+    fusion.aliasOutputToInput(tv2, tv0);
+
+    ASSERT_ANY_THROW(validateAliasedOutputs(&fusion));
+  }
+  {
+    Fusion fusion;
+    FusionGuard fg(&fusion);
+
+    // The input is only read at the position of the element overwritten
+    auto tv0 = makeSymbolicTensor(1);
+    fusion.addInput(tv0);
+    auto tv1 = makeSymbolicTensor(2);
+    fusion.addInput(tv1);
+    auto tv2 = sum(tv1, {0});
+    auto tv3 = mul(tv0, IrBuilder::create<Double>(0.9));
+    auto tv4 = add(tv3, tv2);
+    fusion.aliasOutputToInput(tv4, tv0);
+
+    validateAliasedOutputs(&fusion);
+  }
+}
+
+TEST_F(NVFuserTest, FusionSegmentReusePartialReductions_CUDA) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = sum(tv0, {1});
+  auto tv2 = sum(tv0, {0, 1});
+  fusion->addOutput(tv1);
+  fusion->addOutput(tv2);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({128, 1024}, options);
+
+  KernelArgumentHolder args(KernelIndexMode::INT32);
+  args.setDeviceIndex(0);
+  args.push(t0);
+
+  // The segmenter works on a copy of the fusion, look tv0 up by name
+  auto num_readers_of_tv0 = [&tv0](const SegmentedFusion* segmented_fusion) {
+    return std::count_if(
+        segmented_fusion->groups().begin(),
+        segmented_fusion->groups().end(),
+        [&tv0](const SegmentedGroup* group) {
+          return std::any_of(
+              group->inputs().begin(), group->inputs().end(), [&](Val* inp) {
+                return inp->isA<TensorView>() && inp->name() == tv0->name();
+              });
+        });
+  };
+
+  SegmentCandidateFinderOptions default_options;
+  default_options.reuse_partial_reductions = false;
+  auto default_segmented_fusion =
+      SegmentCandidateFinder::segment(fusion.get(), args, default_options);
+  TORCH_CHECK(num_readers_of_tv0(default_segmented_fusion.get()) == 2);
+
+  // The full sum reduces the partial sums of tv1 instead of tv0
+  SegmentCandidateFinderOptions reuse_options;
+  reuse_options.reuse_partial_reductions = true;
+  auto reuse_segmented_fusion =
+      SegmentCandidateFinder::segment(fusion.get(), args, reuse_options);
+  TORCH_CHECK(num_readers_of_tv0(reuse_segmented_fusion.get()) == 1);
+}
+
+TEST_F(NVFuserTest, FusionShuffleOnlyBlockReduction_CUDA) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = sum(tv0, {1});
+  fusion.addOutput(tv1);
+
+  // 16 threads per row, 8 rows per block
+  tv1->split(1, 16);
+  tv1->split(0, 8);
+  tv1->axis(0)->parallelize(ParallelType::BIDx);
+  tv1->axis(1)->parallelize(ParallelType::TIDy);
+  tv1->axis(3)->parallelize(ParallelType::TIDx);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({1001, 64}, options);
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {t0});
+  TORCH_CHECK(
+      fe.kernelString().find("warp::blockReduceShuffle") != std::string::npos,
+      "Expected a shuffle-only block reduction");
+  auto cg_outputs = fe.runFusion({t0});
+
+  auto ref = t0.sum({1});
+  testValidate(&fusion, cg_outputs, {t0}, {ref}, __LINE__, __FILE__);
+}
+
+// Block reductions over whole warps reduce each warp with shuffles and only
+// pass one value per warp through shared memory
+TEST_F(NVFuserTest, FusionMultiWarpShuffleBlockReduction_CUDA) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = sum(tv0, {1});
+  fusion.addOutput(tv1);
+
+  // 4 warps per row, 2 rows per block
+  tv1->split(1, 128);
+  tv1->split(0, 2);
+  tv1->axis(0)->parallelize(ParallelType::BIDx);
+  tv1->axis(1)->parallelize(ParallelType::TIDy);
+  tv1->axis(3)->parallelize(ParallelType::TIDx);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({1001, 512}, options);
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {t0});
+  TORCH_CHECK(
+      fe.kernelString().find("warp::blockReduceShuffle<true, false, false>") !=
+          std::string::npos,
+      "Expected a shuffle block reduction");
+  auto cg_outputs = fe.runFusion({t0});
+
+  auto ref = t0.sum({1});
+  testValidate(&fusion, cg_outputs, {t0}, {ref}, __LINE__, __FILE__);
+}
+
+// Serial welford over a vectorized reduction domain accumulates sums in the
+// loop and combines them with the running result once after it.
+// See Note [ Merging vectorized welford reductions ]
+TEST_F(NVFuserTest, FusionMergeVectorizedWelford_CUDA) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  std::vector<int64_t> shape({7, 32});
+
+  auto tv0 = makeContigConcreteTensor(shape);
+  fusion.addInput(tv0);
+
+  auto tv1 = set(tv0);
+  auto tvs = Welford(tv1, {1});
+  fusion.addOutput(tvs.avg);
+  fusion.addOutput(tvs.var_sum);
+  fusion.addOutput(tvs.n);
+
+  tv1->split(1, 4);
+
+  MaxRootDomainInfoSpanningTree tree(tv1);
+  TransformPropagator tp(tv1);
+  tree.traverse(&tp);
+
+  tv1->axis(-1)->parallelize(ParallelType::Vectorize);
+
+  tv1->computeAt(tvs.avg, 2);
+
+  GpuLower gpulw(&fusion);
+  auto all_exprs = KernelExprVisitor::getAllExprs(gpulw.kernel());
+  auto num_welford_ops =
+      std::count_if(all_exprs.begin(), all_exprs.end(), [](Expr* expr) {
+        return expr->isStrictlyA<WelfordOp>();
+      });
+  TORCH_CHECK(
+      num_welford_ops == 0, "The WelfordOp should be merged after the loop");
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto options_int = at::TensorOptions().dtype(at::kLong).device(at::kCUDA, 0);
+
+  at::Tensor t0 = at::randn(shape, options);
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {t0});
+  auto cg_outputs = fe.runFusion({t0});
+
+  auto ref_avg = t0.to(at::kDouble).mean({1});
+  auto ref_var = t0.to(at::kDouble).var({1}, false) * shape[1];
+  auto ref_N = at::ones({shape[0]}, options_int) * shape[1];
+
+  testValidate(
+      fe.kernel(),
+      cg_outputs,
+      {t0},
+      {ref_avg, ref_var, ref_N},
+      __LINE__,
+      __FILE__);
+}
+
+// Kernels compiled with CompileParams::fast_math use hardware approximations
+// of transcendental functions
+TEST_F(NVFuserTest, FusionFastMath_CUDA) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(1);
+  fusion.addInput(tv0);
+  auto tv1 = tanh(tv0);
+  auto tv2 = exp(tv0);
+  auto tv3 = sigmoid(tv0);
+  fusion.addOutput(tv1);
+  fusion.addOutput(tv2);
+  fusion.addOutput(tv3);
+
+  tv1->split(0, 128);
+  TransformPropagatorWithCheck propagator(tv1);
+  MaxRootDomainInfoSpanningTree(tv1).traverse(&propagator);
+  tv1->axis(0)->parallelize(ParallelType::BIDx);
+  tv1->axis(1)->parallelize(ParallelType::TIDx);
+  scheduler_utils::parallelizeAllLike(tv1);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({1000}, options);
+
+  FusionExecutor fe;
+  CompileParams compile_opts = {
+      .index_type = PrimDataType::Int, .fast_math = true};
+  fe.compileFusion(&fusion, {t0}, LaunchParams(), compile_opts);
+  auto cg_outputs = fe.runFusion({t0}, LaunchParams(), compile_opts);
+
+  // Approximations aren't bitwise exact, so only check closeness
+  TORCH_CHECK(cg_outputs[0].allclose(t0.tanh(), 1e-3, 1e-3));
+  TORCH_CHECK(cg_outputs[1].allclose(t0.exp(), 1e-3, 1e-3));
+  TORCH_CHECK(cg_outputs[2].allclose(t0.sigmoid(), 1e-3, 1e-3));
+}
+
+// The pointwise scheduler keeps broadcast inputs in cache over streaming
+// inputs and outputs. See Note [ Cache hints ]
+TEST_F(NVFuserTest, FusionPointwiseCacheHints_CUDA) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeContigTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = makeContigTensor(1);
+  fusion.addInput(tv1);
+  auto tv2 = broadcast(tv1, {true, false});
+  auto tv3 = add(tv0, tv2);
+  fusion.addOutput(tv3);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({1024, 1024}, options);
+  at::Tensor t1 = at::randn({1024}, options);
+
+  auto lparams = schedulePointwise(&fusion, {t0, t1});
+
+  TORCH_CHECK(tv0->cacheHint() == CacheHint::EvictFirst);
+  TORCH_CHECK(tv1->cacheHint() == CacheHint::EvictLast);
+  TORCH_CHECK(tv3->cacheHint() == CacheHint::EvictFirst);
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {t0, t1}, lparams);
+  TORCH_CHECK(
+      fe.kernelString().find("CacheHint::EvictLast") != std::string::npos,
+      "Expected a vectorized load with a cache hint");
+  auto cg_outputs = fe.runFusion({t0, t1}, lparams);
+
+  auto ref = t0 + t1.unsqueeze(0);
+  testValidate(&fusion, cg_outputs, {t0, t1}, {ref}, __LINE__, __FILE__);
+}
+
+TEST_F(NVFuserTest, FusionBoundExecution_CUDA) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = makeSymbolicTensor(2);
+  fusion->addInput(tv1);
+  auto tv2 = mul(tv0, tv1);
+  auto tv3 = add(tv2, IrBuilder::create<Double>(1.0));
+  fusion->addOutput(tv3);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({33, 257}, options);
+  at::Tensor t1 = at::randn({33, 257}, options);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  auto bound = executor_cache.bind({t0, t1});
+
+  for (auto i : c10::irange(3)) {
+    (void)i;
+    at::Tensor t2 = at::randn({33, 257}, options);
+    TORCH_CHECK(bound.matches({t0, t2}));
+    auto outputs = bound.run({t0, t2});
+    TORCH_CHECK(outputs.size() == 1);
+    TORCH_CHECK(outputs[0].allclose(t0 * t2 + 1.0));
+    TORCH_CHECK(
+        executor_cache.getMostRecentKernelRuntime() == bound.kernelRuntime());
+  }
+
+  // Inputs of another signature are rejected instead of running the bound
+  // kernel runtime
+  at::Tensor t3 = at::randn({65, 257}, options);
+  TORCH_CHECK(!bound.matches({t3, t3}));
+  EXPECT_THAT(
+      [&]() { bound.run({t3, t3}); },
+      ::testing::ThrowsMessage<c10::Error>(
+          ::testing::HasSubstr("don't match the signature")));
+}
+
+TEST_F(NVFuserTest, FusionStatementArena_CUDA) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = tv0;
+  // Enough nodes to span several blocks of the arena
+  for (auto i : c10::irange(1000)) {
+    (void)i;
+    tv1 = add(tv1, IrBuilder::create<Double>(1.0));
+  }
+  auto tv2 = sum(tv1, {1});
+  fusion->addOutput(tv2);
+  auto zero = fusion->zeroVal();
+
+  // The nodes and the shortcuts move with the container
+  Fusion moved(std::move(*fusion));
+  TORCH_CHECK(moved.zeroVal() == zero);
+  TORCH_CHECK(zero->container() == &moved);
+  for (auto val : moved.vals()) {
+    TORCH_CHECK(val->container() == &moved);
+  }
+
+  // A copy doesn't share the arena of the original
+  Fusion copy(moved);
+  TORCH_CHECK(copy.zeroVal() != zero);
+  moved.removeExpr(tv2->definition());
+  moved.clear();
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({8, 33}, options);
+
+  FusionExecutorCache executor_cache(
+      std::make_unique<Fusion>(std::move(copy)));
+  auto cg_outputs = executor_cache.runFusionWithInputs({t0});
+
+  auto ref = (t0 + 1000.0).sum({1});
+  testValidate(
+      executor_cache.fusion(), cg_outputs, {t0}, {ref}, __LINE__, __FILE__);
+}
+
+TEST_F(NVFuserTest, FusionSegmentCopy_CUDA) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  // Normalization {first kernel}
+  auto tv1 = sum(tv0, {1});
+  auto tv2 = broadcast(tv1, {false, true});
+  auto tv3 = div(tv0, tv2);
+  // Outer reduction of the normalized tensor {second kernel}
+  auto tv4 = sum(tv3, {0});
+  auto tv5 = broadcast(tv4, {true, false});
+  auto tv6 = add(tv3, tv5);
+  fusion->addOutput(tv6);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({128, 1024}, options);
+
+  KernelArgumentHolder args(KernelIndexMode::INT32);
+  args.setDeviceIndex(0);
+  args.push(t0);
+
+  auto segmented_fusion = SegmentCandidateFinder::segment(fusion.get(), args);
+  TORCH_CHECK(segmented_fusion->groups().size() > 1);
+
+  // The fusion of a segment only holds the exprs of the segment, and its
+  // inputs have no definition
+  for (auto group : segmented_fusion->groups()) {
+    auto fusion_segment = segmented_fusion->makeFusion(group);
+    TORCH_CHECK(
+        fusion_segment->unordered_exprs().size() <
+        segmented_fusion->completeFusion()->unordered_exprs().size());
+    for (auto inp : fusion_segment->inputs()) {
+      TORCH_CHECK(inp->definition() == nullptr);
+    }
+    for (auto expr : fusion_segment->exprs()) {
+      TORCH_CHECK(std::any_of(
+          group->exprs().begin(), group->exprs().end(), [&](Expr* e) {
+            return e->name() == expr->name();
+          }));
+    }
+  }
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  auto cg_outputs = executor_cache.runFusionWithInputs({t0});
+
+  auto t3 = t0 / t0.sum({1}).unsqueeze(1);
+  auto ref = t3 + t3.sum({0}).unsqueeze(0);
+  testValidate(
+      executor_cache.fusion(), cg_outputs, {t0}, {ref}, __LINE__, __FILE__);
+}
+
+TEST_F(NVFuserTest, FusionPrecomputedValuesTernaryOp_CUDA) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto s0 = IrBuilder::create<Int>();
+  auto s1 = IrBuilder::create<Int>();
+  fusion.addInput(s0);
+  fusion.addInput(s1);
+  // Extents computed by ternary, comparison and cast ops
+  auto size0 = where(gt(s0, s1), s0, s1);
+  auto size1 = castOp(DataType::Index, add(s0, s1));
+  auto tv0 =
+      full({size0, size1}, IrBuilder::create<Double>(1.0), DataType::Float);
+  fusion.addOutput(tv0);
+
+  PrecomputedValues precomputed_values(&fusion);
+  KernelArgumentHolder args(KernelIndexMode::INT64);
+  args.push((int64_t)3);
+  args.push((int64_t)5);
+  precomputed_values.bindInputs(args);
+  precomputed_values.evaluate();
+
+  auto value0 = precomputed_values.getMaybeValueFor(size0);
+  auto value1 = precomputed_values.getMaybeValueFor(size1);
+  TORCH_CHECK(value0.has_value() && value0->as<int64_t>() == 5);
+  TORCH_CHECK(value1.has_value() && value1->as<int64_t>() == 8);
+}
+
+TEST_F(NVFuserTest, FusionPrecomputedValuesBatch_CUDA) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(2);
+  auto s0 = IrBuilder::create<Int>();
+  fusion.addInput(tv0);
+  fusion.addInput(s0);
+  auto size = mul(tv0->axis(0)->extent(), s0);
+  auto tv1 = full({size}, IrBuilder::create<Double>(0.0), DataType::Float);
+  fusion.addOutput(tv0);
+  fusion.addOutput(tv1);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  std::vector<KernelArgumentHolder> args_batch;
+  for (auto i : c10::irange(1, 4)) {
+    at::Tensor t0 = at::randn({i, 2 * i}, options);
+    args_batch.push_back(KernelArgumentHolder::createKernelArgumentHolder(
+        {t0, c10::IValue((int64_t)(3 * i))}));
+  }
+
+  PrecomputedValues precomputed_values(&fusion);
+  auto results = precomputed_values.evaluateBatch(
+      args_batch, {tv0->axis(1)->extent(), size});
+  TORCH_CHECK(results.size() == 2);
+  for (auto i : c10::irange(1, 4)) {
+    TORCH_CHECK(results[0].at(i - 1)->as<int64_t>() == 2 * i);
+    TORCH_CHECK(results[1].at(i - 1)->as<int64_t>() == 3 * i * i);
+  }
+}
+
+TEST_F(NVFuserTest, FusionCachedExprOrder_CUDA) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+  auto s0 = IrBuilder::create<Int>();
+  auto tv1 = add(tv0, s0);
+  fusion.addOutput(tv1);
+
+  auto exprs = fusion.exprs();
+  TORCH_CHECK(exprs.size() == 1);
+
+  // Loop transformations keep the order
+  tv1->split(0, 4);
+  tv1->merge(1);
+  TORCH_CHECK(fusion.exprs() == exprs);
+  TORCH_CHECK(fusion.usedMathVals() == fusion.usedMathVals());
+
+  // Defining an already used scalar changes it
+  auto s1 = IrBuilder::create<Int>();
+  fusion.addInput(s1);
+  IrBuilder::create<BinaryOp>(
+      BinaryOpType::Mul, s0, s1, IrBuilder::create<Int>(2));
+  TORCH_CHECK(fusion.exprs().size() == 2);
+  TORCH_CHECK(fusion.exprs().front() == s0->definition());
+
+  // So do new tensor exprs and outputs
+  auto tv2 = neg(tv1);
+  TORCH_CHECK(fusion.exprs().size() == 2);
+  fusion.addOutput(tv2);
+  TORCH_CHECK(fusion.exprs().size() == 3);
+  TORCH_CHECK(fusion.exprs().back() == tv2->definition());
+  auto used_vals = fusion.usedMathVals();
+  TORCH_CHECK(
+      std::find(used_vals.begin(), used_vals.end(), tv2) != used_vals.end());
+
+  fusion.removeOutput(tv2);
+  TORCH_CHECK(fusion.exprs().size() == 2);
+}
+
+TEST_F(NVFuserTest, FusionRuntimeMetrics_CUDA) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = add(tv0, IrBuilder::create<Double>(1));
+  fusion->addOutput(tv1);
+  FusionExecutorCache executor_cache(std::move(fusion));
+
+  auto metrics = inst::RuntimeMetrics::instance();
+  metrics->reset();
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({128, 64}, options);
+  executor_cache.runFusionWithInputs({t0});
+
+  auto snapshot = metrics->snapshot();
+  TORCH_CHECK(snapshot.get(inst::RuntimeCounter::FusionRuns) == 1);
+  TORCH_CHECK(snapshot.get(inst::RuntimeCounter::RuntimeCacheMisses) == 1);
+  TORCH_CHECK(snapshot.get(inst::RuntimeCounter::KernelRuntimesCreated) == 1);
+  TORCH_CHECK(snapshot.get(inst::RuntimeCounter::KernelCompilations) == 1);
+  TORCH_CHECK(
+      snapshot.get(inst::RuntimeCounter::BytesAllocated) >=
+      (int64_t)t0.nbytes());
+
+  // Runs of exited threads are kept, and reset() only drops what was
+  // recorded before it
+  metrics->reset();
+  std::vector<at::Tensor> outputs;
+  std::thread thread(
+      [&]() { outputs = executor_cache.runFusionWithInputs({t0}); });
+  thread.join();
+  executor_cache.runFusionWithInputs({t0});
+  testValidate(
+      executor_cache.fusion(), outputs, {t0}, {t0 + 1}, __LINE__, __FILE__);
+
+  snapshot = metrics->snapshot();
+  TORCH_CHECK(snapshot.get(inst::RuntimeCounter::FusionRuns) == 2);
+  TORCH_CHECK(snapshot.get(inst::RuntimeCounter::RuntimeCacheHits) == 2);
+  TORCH_CHECK(snapshot.get(inst::RuntimeCounter::RuntimeCacheMisses) == 0);
+  TORCH_CHECK(snapshot.get(inst::RuntimeCounter::KernelCompilations) == 0);
+  TORCH_CHECK(snapshot.get(inst::RuntimeCounter::SegmentsRun) == 2);
+  TORCH_CHECK(
+      std::accumulate(
+          snapshot.latency_histogram.begin(),
+          snapshot.latency_histogram.end(),
+          int64_t(0)) == 2);
+  TORCH_CHECK(snapshot.total_latency_ns > 0);
+  TORCH_CHECK(executor_cache.numRuntimeCacheHits() == 2);
+  TORCH_CHECK(executor_cache.numRuntimeCacheMisses() == 1);
+}
+
+TEST_F(NVFuserTest, FusionKernelResourceUsage_CUDA) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+  auto tv0 = makeSymbolicTensor(1);
+  fusion.addInput(tv0);
+  auto tv1 = set(tv0);
+  fusion.addOutput(tv1);
+  tv1->split(0, 128);
+  tv1->axis(0)->parallelize(ParallelType::BIDx);
+  tv1->axis(1)->parallelize(ParallelType::TIDx);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({1024}, options);
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {t0});
+  auto outputs = fe.runFusion({t0});
+  testValidate(&fusion, outputs, {t0}, {t0}, __LINE__, __FILE__);
+
+  const auto usage = fe.kernelResourceUsage();
+  TORCH_CHECK(usage.registers_per_thread > 0);
+  TORCH_CHECK(usage.local_bytes_per_thread == 0);
+  TORCH_CHECK(usage.dynamic_smem_bytes == 0);
+  TORCH_CHECK(usage.max_threads_per_block >= 128);
+  TORCH_CHECK(usage.max_active_blocks_per_sm > 0);
+  TORCH_CHECK(usage.occupancy > 0 && usage.occupancy <= 1);
+}
+
+// See Note [ Kernel cost estimate ]
+TEST_F(NVFuserTest, FusionKernelCostEstimate_CUDA) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  auto tv0 = makeSymbolicTensor(1);
+  fusion->addInput(tv0);
+  auto tv1 = mul(tv0, IrBuilder::create<Double>(2.0));
+  auto tv2 = add(tv1, IrBuilder::create<Double>(1.0));
+  fusion->addOutput(tv2);
+  tv2->split(0, 128);
+  tv2->axis(0)->parallelize(ParallelType::BIDx);
+  tv2->axis(1)->parallelize(ParallelType::TIDx);
+  TransformPropagatorWithCheck propagator(tv2);
+  MaxRootDomainInfoSpanningTree(tv2).traverse(&propagator);
+  scheduler_utils::parallelizeAllLike(tv2);
+  inlineMost();
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({1024}, options);
+  FusionExecutor fe;
+  fe.compileFusion(fusion.get(), {t0});
+  auto outputs = fe.runFusion({t0});
+  testValidate(fusion.get(), outputs, {t0}, {t0 * 2 + 1}, __LINE__, __FILE__);
+
+  TORCH_CHECK(fe.estimatedCost().has_value());
+  const auto& cost = fe.estimatedCost().value();
+  TORCH_CHECK(cost.exact);
+  TORCH_CHECK(cost.threads_per_block == 128 && cost.blocks == 8);
+  TORCH_CHECK(cost.global_load_bytes == 4 && cost.global_store_bytes == 4);
+  TORCH_CHECK(cost.totalGlobalBytes() == 1024 * 8);
+  TORCH_CHECK(cost.arithmetic_ops == 2 && cost.arithmeticPerElement() == 2);
+  TORCH_CHECK(cost.smem_read_bytes == 0 && cost.block_syncs == 0);
+  TORCH_CHECK(cost.estimatedTimeUs(0) > 0);
+
+  // A rejected kernel is lowered and estimated, but not compiled
+  FusionExecutor rejected_fe;
+  rejected_fe.setCostFilter([](const KernelCostEstimate&) { return false; });
+  rejected_fe.compileFusion(fusion.get(), {t0});
+  TORCH_CHECK(!rejected_fe.compiled());
+  TORCH_CHECK(rejected_fe.estimatedCost().has_value());
+  TORCH_CHECK(
+      rejected_fe.estimatedCost()->totalGlobalBytes() ==
+      cost.totalGlobalBytes());
+
+  // A block reduction goes through shared memory
+  Fusion reduction_fusion;
+  FusionGuard reduction_fg(&reduction_fusion);
+  auto tv3 = makeSymbolicTensor(1);
+  reduction_fusion.addInput(tv3);
+  auto tv4 = sum(tv3, {0});
+  reduction_fusion.addOutput(tv4);
+  tv4->axis(0)->parallelize(ParallelType::TIDx);
+
+  at::Tensor t3 = at::randn({128}, options);
+  FusionExecutor reduction_fe;
+  reduction_fe.compileFusion(&reduction_fusion, {t3});
+  const auto& reduction_cost = reduction_fe.estimatedCost().value();
+  TORCH_CHECK(reduction_cost.threads_per_block == 128);
+  TORCH_CHECK(reduction_cost.smem_write_bytes >= 4);
+  TORCH_CHECK(reduction_cost.smem_read_bytes >= 4);
+  TORCH_CHECK(reduction_cost.block_syncs >= 2);
+  TORCH_CHECK(reduction_cost.grid_syncs == 0);
+}
+
+// argmax, argmin and topk as packed max reductions, see
+// Note [ Packed index reductions ]
+TEST_F(NVFuserTest, FusionIndexReductions_CUDA) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  auto& fusion = *fusion_ptr;
+  FusionGuard fg(fusion_ptr.get());
+
+  auto tv0 = makeContigTensor(2, DataType::Half);
+  fusion.addInput(tv0);
+  fusion.addOutput(argmax(tv0, 1));
+  fusion.addOutput(argmin(tv0, -1, true));
+  auto top = topk(tv0, 3, 1);
+  fusion.addOutput(top.values);
+  fusion.addOutput(top.indices);
+  auto bottom = topk(tv0, 2, 1, false);
+  fusion.addOutput(bottom.values);
+  fusion.addOutput(bottom.indices);
+
+  auto options = at::TensorOptions().dtype(at::kHalf).device(at::kCUDA, 0);
+  at::manual_seed(0);
+  // Few distinct values, so that rows have ties, which go to the first
+  // position like in eager mode
+  auto t0 = at::randint(-8, 8, {65, 1000}, options);
+  std::vector<c10::IValue> aten_inputs({t0});
+
+  FusionExecutorCache executor_cache(std::move(fusion_ptr));
+  auto cg_outputs = executor_cache.runFusionWithInputs(aten_inputs);
+
+  // The first position of every extremum
+  auto first_of = [&](const at::Tensor& extremum) {
+    auto positions = at::arange(t0.size(1), options.dtype(at::kLong));
+    return at::where(t0 == extremum, positions, t0.size(1)).amin(1);
+  };
+  TORCH_CHECK(cg_outputs[0].equal(first_of(t0.amax(1, true))));
+  TORCH_CHECK(cg_outputs[1].equal(first_of(t0.amin(1, true)).unsqueeze(1)));
+
+  auto ref_top = at::topk(t0, 3, 1);
+  auto ref_bottom = at::topk(t0, 2, 1, false);
+  TORCH_CHECK(cg_outputs[2].equal(std::get<0>(ref_top)));
+  TORCH_CHECK(cg_outputs[4].equal(std::get<0>(ref_bottom)));
+  // Indices of ties may differ from eager mode, but select the same values
+  TORCH_CHECK(t0.gather(1, cg_outputs[3]).equal(std::get<0>(ref_top)));
+  TORCH_CHECK(t0.gather(1, cg_outputs[5]).equal(std::get<0>(ref_bottom)));
+}
+
+// Scans fused with their pointwise producers and consumers
+TEST_F(NVFuserTest, FusionScanOps_CUDA) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  auto& fusion = *fusion_ptr;
+  FusionGuard fg(fusion_ptr.get());
+
+  auto tv0 = makeContigTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = mul(tv0, IrBuilder::create<Double>(2));
+  auto tv2 = cumsum(tv1, 1);
+  auto tv3 = cummax(tv1, -1);
+  auto tv4 = add(tv2, tv3);
+  fusion.addOutput(tv2);
+  fusion.addOutput(tv4);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::manual_seed(0);
+  auto t0 = at::randn({300, 1024}, options);
+  std::vector<c10::IValue> aten_inputs({t0});
+
+  FusionExecutorCache executor_cache(std::move(fusion_ptr));
+  auto cg_outputs = executor_cache.runFusionWithInputs(aten_inputs);
+
+  auto runtime = executor_cache.getMostRecentKernelRuntime();
+  TORCH_CHECK(!runtime->isSegmented(), "Unexpected segmentation");
+  const auto& scheduler_entry =
+      runtime->schedulerHeuristics()->heuristicsList().at(0);
+  TORCH_CHECK(
+      scheduler_entry->heuristic() == ScheduleHeuristic::Scan,
+      "Unexpected heuristic was chosen: ",
+      scheduler_entry->heuristic());
+  TORCH_CHECK(scheduler_entry->scanParams().vectorize_factor == 4);
+
+  auto t1 = t0 * 2;
+  auto t2 = at::cumsum(t1, 1);
+  auto t4 = t2 + std::get<0>(at::cummax(t1, 1));
+  testValidate(&fusion, cg_outputs, aten_inputs, {t2, t4}, __LINE__, __FILE__);
+
+  // Scanning the outer dimension of a half tensor, whose rows are summed in
+  // float and which is then left unvectorized
+  auto fusion_outer_ptr = std::make_unique<Fusion>();
+  auto& fusion_outer = *fusion_outer_ptr;
+  FusionGuard fg_outer(fusion_outer_ptr.get());
+
+  auto tv5 = makeContigTensor(3, DataType::Half);
+  fusion_outer.addInput(tv5);
+  auto tv6 = cumsum(tv5, 0);
+  auto tv7 = cumprod(castOp(DataType::Int, tv5), 0);
+  fusion_outer.addOutput(tv6);
+  fusion_outer.addOutput(tv7);
+
+  // Products of -1, 0 and 1 don't overflow
+  auto t5 = at::randint(-1, 2, {257, 5, 33}, options.dtype(at::kHalf));
+  std::vector<c10::IValue> aten_inputs_outer({t5});
+
+  FusionExecutorCache executor_cache_outer(std::move(fusion_outer_ptr));
+  auto cg_outputs_outer =
+      executor_cache_outer.runFusionWithInputs(aten_inputs_outer);
+  TORCH_CHECK(!executor_cache_outer.getMostRecentKernelRuntime()
+                   ->isSegmented());
+
+  testValidate(
+      &fusion_outer,
+      cg_outputs_outer,
+      aten_inputs_outer,
+      {at::cumsum(t5, 0), at::cumprod(t5.to(at::kLong), 0)},
+      __LINE__,
+      __FILE__);
+}
+
+TEST_F(NVFuserTest, FusionAttention_CUDA) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  auto& fusion = *fusion_ptr;
+  FusionGuard fg(fusion_ptr.get());
+
+  // The values are given transposed, [Dv, Sk]
+  auto tv0 = makeContigTensor(2, DataType::Half);
+  auto tv1 = makeContigTensor(2, DataType::Half);
+  auto tv2 = makeContigTensor(2, DataType::Half);
+  fusion.addInput(tv0);
+  fusion.addInput(tv1);
+  fusion.addInput(tv2);
+  auto tv3 = fusedMultiplySum(
+      broadcast(tv0, {false, true, false}),
+      broadcast(tv1, {true, false, false}),
+      {-1});
+  auto tv4 = softmax(mul(tv3, IrBuilder::create<Double>(0.125)), 1);
+  auto tv5 = fusedMultiplySum(
+      broadcast(castOp(DataType::Half, tv4), {false, true, false}),
+      broadcast(tv2, {true, false, false}),
+      {-1});
+  fusion.addOutput(castOp(DataType::Half, tv5));
+
+  auto options = at::TensorOptions().dtype(at::kHalf).device(at::kCUDA, 0);
+  at::manual_seed(0);
+  auto t0 = at::randn({300, 64}, options);
+  auto t1 = at::randn({1000, 64}, options);
+  auto t2 = at::randn({64, 1000}, options);
+  std::vector<c10::IValue> aten_inputs({t0, t1, t2});
+
+  FusionExecutorCache executor_cache(std::move(fusion_ptr));
+  auto cg_outputs = executor_cache.runFusionWithInputs(aten_inputs);
+
+  auto runtime = executor_cache.getMostRecentKernelRuntime();
+  TORCH_CHECK(!runtime->isSegmented(), "Unexpected segmentation");
+  const auto& scheduler_entry =
+      runtime->schedulerHeuristics()->heuristicsList().at(0);
+  TORCH_CHECK(
+      scheduler_entry->heuristic() == ScheduleHeuristic::Attention,
+      "Unexpected heuristic was chosen: ",
+      scheduler_entry->heuristic());
+  TORCH_CHECK(scheduler_entry->attentionParams().persistent_batch == 4);
+
+  auto t3 = at::matmul(t0.to(at::kFloat), t1.to(at::kFloat).t());
+  auto t4 = at::softmax(t3 * 0.125, 1).to(at::kHalf);
+  auto t5 = at::matmul(t4.to(at::kFloat), t2.to(at::kFloat).t());
+  testValidate(
+      &fusion,
+      cg_outputs,
+      aten_inputs,
+      {t5.to(at::kHalf)},
+      __LINE__,
+      __FILE__);
+
+  // Batched float attention written with multiplications and sums
+  auto fusion_batched_ptr = std::make_unique<Fusion>();
+  auto& fusion_batched = *fusion_batched_ptr;
+  FusionGuard fg_batched(fusion_batched_ptr.get());
+
+  auto tv6 = makeContigTensor(3);
+  auto tv7 = makeContigTensor(3);
+  auto tv8 = makeContigTensor(3);
+  fusion_batched.addInput(tv6);
+  fusion_batched.addInput(tv7);
+  fusion_batched.addInput(tv8);
+  auto tv9 = sum(
+      mul(broadcast(tv6, {false, false, true, false}),
+          broadcast(tv7, {false, true, false, false})),
+      {3});
+  auto tv10 = softmax(tv9, 2);
+  auto tv11 = sum(
+      mul(broadcast(tv10, {false, false, false, true}),
+          broadcast(tv8, {false, true, false, false})),
+      {2});
+  fusion_batched.addOutput(tv11);
+
+  auto options_float = options.dtype(at::kFloat);
+  auto t6 = at::randn({3, 65, 32}, options_float);
+  auto t7 = at::randn({3, 129, 32}, options_float);
+  auto t8 = at::randn({3, 129, 48}, options_float);
+  std::vector<c10::IValue> aten_inputs_batched({t6, t7, t8});
+
+  FusionExecutorCache executor_cache_batched(std::move(fusion_batched_ptr));
+  auto cg_outputs_batched =
+      executor_cache_batched.runFusionWithInputs(aten_inputs_batched);
+  TORCH_CHECK(!executor_cache_batched.getMostRecentKernelRuntime()
+                   ->isSegmented());
+
+  auto t10 = at::softmax(at::matmul(t6, t7.transpose(1, 2)), 2);
+  auto t11 = at::matmul(t10, t8);
+  testValidate(
+      &fusion_batched,
+      cg_outputs_batched,
+      aten_inputs_batched,
+      {t11},
+      __LINE__,
+      __FILE__);
+}
+
+// Cross-entropy without materializing the log-probabilities, see
+// Note [ Fused cross-entropy ]
+TEST_F(NVFuserTest, FusionCrossEntropy_CUDA) {
+  const int64_t kIgnoreIndex = -100;
+  auto fusion_ptr = std::make_unique<Fusion>();
+  auto& fusion = *fusion_ptr;
+  FusionGuard fg(fusion_ptr.get());
+
+  auto tv0 = makeContigTensor(2, DataType::Half);
+  auto tv1 = makeContigTensor(1, DataType::Int);
+  fusion.addInput(tv0);
+  fusion.addInput(tv1);
+  auto result = cross_entropy(tv0, tv1, kIgnoreIndex);
+  fusion.addOutput(result.loss);
+  fusion.addOutput(result.log_sum_exp);
+
+  auto options = at::TensorOptions().dtype(at::kHalf).device(at::kCUDA, 0);
+  at::manual_seed(0);
+  auto t0 = at::randn({300, 5003}, options);
+  auto t1 = at::randint(0, 5003, {300}, options.dtype(at::kLong));
+  t1.index_put_({at::indexing::Slice(0, 300, 7)}, kIgnoreIndex);
+  std::vector<c10::IValue> aten_inputs({t0, t1});
+
+  FusionExecutorCache executor_cache(std::move(fusion_ptr));
+  auto cg_outputs = executor_cache.runFusionWithInputs(aten_inputs);
+  TORCH_CHECK(!executor_cache.getMostRecentKernelRuntime()->isSegmented());
+
+  auto t0_float = t0.to(at::kFloat);
+  auto t2 = at::cross_entropy_loss(
+      t0_float, t1, {}, at::Reduction::None, kIgnoreIndex);
+  auto t3 = at::logsumexp(t0_float, {1});
+  testValidate(
+      &fusion, cg_outputs, aten_inputs, {t2, t3}, __LINE__, __FILE__);
+
+  auto fusion_bwd_ptr = std::make_unique<Fusion>();
+  auto& fusion_bwd = *fusion_bwd_ptr;
+  FusionGuard fg_bwd(fusion_bwd_ptr.get());
+
+  auto tv4 = makeContigTensor(1);
+  auto tv5 = makeContigTensor(2, DataType::Half);
+  auto tv6 = makeContigTensor(1, DataType::Int);
+  auto tv7 = makeContigTensor(1);
+  fusion_bwd.addInput(tv4);
+  fusion_bwd.addInput(tv5);
+  fusion_bwd.addInput(tv6);
+  fusion_bwd.addInput(tv7);
+  fusion_bwd.addOutput(
+      cross_entropy_backward(tv4, tv5, tv6, tv7, kIgnoreIndex));
+
+  auto t4 = at::randn({300}, options.dtype(at::kFloat));
+  std::vector<c10::IValue> aten_inputs_bwd({t4, t0, t1, t3});
+
+  FusionExecutorCache executor_cache_bwd(std::move(fusion_bwd_ptr));
+  auto cg_outputs_bwd =
+      executor_cache_bwd.runFusionWithInputs(aten_inputs_bwd);
+
+  auto ignored = t1.eq(kIgnoreIndex);
+  auto one_hot = at::zeros_like(t0_float).scatter_(
+      1, at::where(ignored, 0, t1).unsqueeze(1), 1);
+  auto row_grad = at::where(ignored, 0, t4).unsqueeze(1);
+  auto t8 = ((at::softmax(t0_float, 1) - one_hot) * row_grad).to(at::kHalf);
+  testValidate(
+      &fusion_bwd,
+      cg_outputs_bwd,
+      aten_inputs_bwd,
+      {t8},
+      __LINE__,
+      __FILE__);
+}
+
+TEST_F(NVFuserTest, FusionQuantizeDequantize_CUDA) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  auto& fusion = *fusion_ptr;
+  FusionGuard fg(fusion_ptr.get());
+
+  auto tv0 = makeContigTensor(2);
+  auto tv1 = makeContigTensor(1);
+  auto tv2 = makeContigTensor(1, DataType::Int32);
+  fusion.addInput(tv0);
+  fusion.addInput(tv1);
+  fusion.addInput(tv2);
+  auto tv3 = quantize_per_channel(tv0, tv1, tv2, 0, DataType::Int8);
+  auto tv4 = dequantize_per_channel(tv3, tv1, tv2, 0, DataType::Half);
+  fusion.addOutput(tv3);
+  fusion.addOutput(tv4);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::manual_seed(0);
+  auto t0 = at::randn({128, 1024}, options);
+  auto t1 = at::rand({128}, options) * 0.05 + 0.01;
+  auto t2 = at::randint(-8, 8, {128}, options.dtype(at::kInt));
+  std::vector<c10::IValue> aten_inputs({t0, t1, t2});
+
+  FusionExecutorCache executor_cache(std::move(fusion_ptr));
+  auto cg_outputs = executor_cache.runFusionWithInputs(aten_inputs);
+  TORCH_CHECK(!executor_cache.getMostRecentKernelRuntime()->isSegmented());
+
+  auto t3 = at::clamp(
+                at::round(t0 / t1.unsqueeze(1)) + t2.unsqueeze(1), -128, 127)
+                .to(at::kChar);
+  auto t4 = ((t3.to(at::kFloat) - t2.unsqueeze(1)) * t1.unsqueeze(1))
+                .to(at::kHalf);
+  testValidate(
+      &fusion, cg_outputs, aten_inputs, {t3, t4}, __LINE__, __FILE__);
+}
+
+// Dequantization of packed 4-bit weights with a scale and a zero point per
+// group of 128 weights of a row
+TEST_F(NVFuserTest, FusionDequantizeInt4_CUDA) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  auto& fusion = *fusion_ptr;
+  FusionGuard fg(fusion_ptr.get());
+
+  auto tv0 = makeContigTensor(3, DataType::UInt8);
+  auto tv1 = makeContigTensor(2, DataType::Half);
+  auto tv2 = makeContigTensor(2, DataType::Half);
+  fusion.addInput(tv0);
+  fusion.addInput(tv1);
+  fusion.addInput(tv2);
+  auto tv3 = flatten(unpack_int4(tv0, true), 2, 3);
+  auto tv4 = dequantize_per_group(tv3, tv1, tv2, DataType::Half);
+  fusion.addOutput(tv4);
+
+  auto options = at::TensorOptions().dtype(at::kHalf).device(at::kCUDA, 0);
+  at::manual_seed(0);
+  auto t0 = at::randint(0, 256, {256, 8, 64}, options.dtype(at::kByte));
+  auto t1 = at::rand({256, 8}, options) * 0.05 + 0.01;
+  auto t2 = at::randint(-2, 3, {256, 8}, options);
+  std::vector<c10::IValue> aten_inputs({t0, t1, t2});
+
+  FusionExecutorCache executor_cache(std::move(fusion_ptr));
+  auto cg_outputs = executor_cache.runFusionWithInputs(aten_inputs);
+  TORCH_CHECK(!executor_cache.getMostRecentKernelRuntime()->isSegmented());
+
+  auto t0_int = t0.to(at::kInt);
+  auto t3 = at::stack(
+                {t0_int.bitwise_and(0xf), t0_int.bitwise_right_shift(4)}, -1)
+                .flatten(2, 3);
+  t3 = t3.bitwise_xor(8) - 8;
+  auto t4 = ((t3.to(at::kFloat) - t2.to(at::kFloat).unsqueeze(-1)) *
+             t1.to(at::kFloat).unsqueeze(-1))
+                .to(at::kHalf);
+  testValidate(&fusion, cg_outputs, aten_inputs, {t4}, __LINE__, __FILE__);
+
+  // Packing the 4-bit integers back gives the packed weights
+  auto fusion_pack_ptr = std::make_unique<Fusion>();
+  auto& fusion_pack = *fusion_pack_ptr;
+  FusionGuard fg_pack(fusion_pack_ptr.get());
+
+  auto tv5 = makeContigTensor(4, DataType::Int8);
+  fusion_pack.addInput(tv5);
+  fusion_pack.addOutput(pack_int4(tv5));
+
+  auto t5 = t3.to(at::kChar).view({256, 8, 64, 2});
+  std::vector<c10::IValue> aten_inputs_pack({t5});
+  FusionExecutorCache executor_cache_pack(std::move(fusion_pack_ptr));
+  auto cg_outputs_pack =
+      executor_cache_pack.runFusionWithInputs(aten_inputs_pack);
+  TORCH_CHECK(cg_outputs_pack.at(0).equal(t0));
+}
+
+// Sum of the rows of each sequence of a packed jagged tensor, and the
+// broadcast of the sums back to the rows of their sequence
+TEST_F(NVFuserTest, FusionJaggedSum_CUDA) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  auto& fusion = *fusion_ptr;
+  FusionGuard fg(fusion_ptr.get());
+
+  auto tv0 = makeContigTensor(2);
+  auto tv1 = makeContigTensor(1, DataType::Int);
+  auto tv2 = makeContigTensor(2);
+  fusion.addInput(tv0);
+  fusion.addInput(tv1);
+  fusion.addInput(tv2);
+  auto tv3 = jagged_segment_ids(tv1, tv0->axis(0)->extent());
+  auto tv4 = jagged_sum(tv0, tv3, tv2);
+  fusion.addOutput(tv3);
+  fusion.addOutput(tv4);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::manual_seed(0);
+  const std::vector<int64_t> offsets = {0, 17, 17, 400, 1000};
+  auto t0 = at::randn({1000, 64}, options);
+  auto t1 = at::tensor(offsets, options.dtype(at::kLong));
+  auto t2 = at::zeros({4, 64}, options);
+  std::vector<c10::IValue> aten_inputs({t0, t1, t2});
+
+  FusionExecutorCache executor_cache(std::move(fusion_ptr));
+  auto cg_outputs = executor_cache.runFusionWithInputs(aten_inputs);
+
+  auto lengths = at::tensor({17, 0, 383, 600}, options.dtype(at::kLong));
+  auto t3 = at::repeat_interleave(lengths);
+  auto t4 = at::zeros({4, 64}, options).index_add(0, t3, t0);
+  testValidate(
+      &fusion, cg_outputs, aten_inputs, {t3, t4}, __LINE__, __FILE__);
+
+  auto fusion_bcast_ptr = std::make_unique<Fusion>();
+  auto& fusion_bcast = *fusion_bcast_ptr;
+  FusionGuard fg_bcast(fusion_bcast_ptr.get());
+
+  auto tv5 = makeContigTensor(2);
+  auto tv6 = makeContigTensor(1, DataType::Int);
+  auto tv7 = makeContigTensor(2);
+  fusion_bcast.addInput(tv5);
+  fusion_bcast.addInput(tv6);
+  fusion_bcast.addInput(tv7);
+  fusion_bcast.addOutput(add(tv7, index_select(tv5, 0, tv6)));
+
+  std::vector<c10::IValue> aten_inputs_bcast({t4, t3, t0});
+  FusionExecutorCache executor_cache_bcast(std::move(fusion_bcast_ptr));
+  auto cg_outputs_bcast =
+      executor_cache_bcast.runFusionWithInputs(aten_inputs_bcast);
+  testValidate(
+      &fusion_bcast,
+      cg_outputs_bcast,
+      aten_inputs_bcast,
+      {t0 + t4.index_select(0, t3)},
+      __LINE__,
+      __FILE__);
+}
+
+// conv-bn-relu with the batch norm applied to the input of the next
+// convolution, see Note [ Implicit GEMM convolution ]
+TEST_F(NVFuserTest, FusionConv2dNhwc_CUDA) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  auto& fusion = *fusion_ptr;
+  FusionGuard fg(fusion_ptr.get());
+
+  auto tv0 = makeContigTensor(4, DataType::Half);
+  auto tv1 = makeContigTensor(2, DataType::Half);
+  auto tv2 = makeContigTensor(1);
+  auto tv3 = makeContigTensor(1);
+  auto tv4 = makeContigTensor(1);
+  fusion.addInput(tv0);
+  fusion.addInput(tv1);
+  fusion.addInput(tv2);
+  fusion.addInput(tv3);
+  fusion.addInput(tv4);
+  const std::vector<bool> is_channel_dim({true, true, true, false});
+  auto tv5 = relu(
+      add(mul(castOp(DataType::Float, tv0), broadcast(tv2, is_channel_dim)),
+          broadcast(tv3, is_channel_dim)));
+  auto tv6 = conv2d_nhwc(tv5, tv1, {3, 3}, {1, 1});
+  auto tv7 = relu(add(tv6, broadcast(tv4, is_channel_dim)));
+  fusion.addOutput(castOp(DataType::Half, tv7));
+
+  auto options = at::TensorOptions().dtype(at::kHalf).device(at::kCUDA, 0);
+  at::manual_seed(0);
+  auto t0 = at::randn({2, 14, 14, 16}, options);
+  auto weight = at::randn({32, 16, 3, 3}, options.dtype(at::kFloat));
+  auto t1 = weight.permute({0, 2, 3, 1}).reshape({32, 144}).to(at::kHalf);
+  auto t2 = at::rand({16}, options.dtype(at::kFloat)) + 0.5;
+  auto t3 = at::randn({16}, options.dtype(at::kFloat));
+  auto t4 = at::randn({32}, options.dtype(at::kFloat));
+  std::vector<c10::IValue> aten_inputs({t0, t1, t2, t3, t4});
+
+  FusionExecutorCache executor_cache(std::move(fusion_ptr));
+  auto cg_outputs = executor_cache.runFusionWithInputs(aten_inputs);
+
+  auto t5 = at::relu(t0.to(at::kFloat) * t2 + t3).permute({0, 3, 1, 2});
+  auto filters = t1.to(at::kFloat).view({32, 3, 3, 16}).permute({0, 3, 1, 2});
+  auto t6 = at::conv2d(t5, filters, t4, 1, 1);
+  auto t7 = at::relu(t6).permute({0, 2, 3, 1}).to(at::kHalf);
+  testValidate(&fusion, cg_outputs, aten_inputs, {t7}, __LINE__, __FILE__);
+}
+
+// A fusion of 2^31 elements is run as chunks of rows indexed with 32 bits,
+// see Note [ 32-bit indexed chunks ]
+TEST_F(NVFuserTest, FusionInt32IndexedChunks_CUDA) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  auto& fusion = *fusion_ptr;
+  FusionGuard fg(fusion_ptr.get());
+
+  auto tv0 = makeContigTensor(2, DataType::Bool);
+  auto tv1 = makeContigTensor(1, DataType::Bool);
+  fusion.addInput(tv0);
+  fusion.addInput(tv1);
+  auto tv2 = ne(tv0, broadcast(tv1, {true, false}));
+  fusion.addOutput(tv2);
+
+  auto options = at::TensorOptions().dtype(at::kBool).device(at::kCUDA, 0);
+  at::manual_seed(0);
+  auto t0 = at::randint(0, 2, {4096, 1 << 19}, options);
+  auto t1 = at::randint(0, 2, {1 << 19}, options);
+  std::vector<c10::IValue> aten_inputs({t0, t1});
+  TORCH_CHECK(
+      KernelArgumentHolder::createKernelArgumentHolder(aten_inputs)
+          .getIndexMode() == KernelIndexMode::INT64);
+
+  FusionExecutorCache executor_cache(std::move(fusion_ptr));
+  auto cg_outputs = executor_cache.runFusionWithInputs(aten_inputs);
+  TORCH_CHECK(
+      executor_cache.getMostRecentKernelRuntime()
+          ->executors()
+          .front()
+          .kernel()
+          ->indexType() == PrimDataType::Int32);
+  TORCH_CHECK(cg_outputs.at(0).equal(t0.ne(t1.unsqueeze(0))));
+}
+
+// Kernels are specialized for the sizes of the first set of inputs only, see
+// Note [ Shape specialization ]
+TEST_F(NVFuserTest, FusionShapeSpecialization_CUDA) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  auto& fusion = *fusion_ptr;
+  FusionGuard fg(fusion_ptr.get());
+
+  auto tv0 = makeContigTensor(2);
+  auto tv1 = makeContigTensor(1);
+  fusion.addInput(tv0);
+  fusion.addInput(tv1);
+  auto tv2 = sum(add(tv0, broadcast(tv1, {true, false})), {1});
+  fusion.addOutput(tv2);
+
+  FusionExecutorCache executor_cache(std::move(fusion_ptr));
+  executor_cache.setShapeSpecialization(1);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::manual_seed(0);
+  auto run = [&](int64_t rows, int64_t cols) {
+    auto t0 = at::randn({rows, cols}, options);
+    auto t1 = at::randn({cols}, options);
+    std::vector<c10::IValue> aten_inputs({t0, t1});
+    auto cg_outputs = executor_cache.runFusionWithInputs(aten_inputs);
+    auto t2 = (t0 + t1.unsqueeze(0)).sum({1});
+    testValidate(
+        executor_cache.fusion(),
+        cg_outputs,
+        aten_inputs,
+        {t2},
+        __LINE__,
+        __FILE__);
+    return executor_cache.getMostRecentKernelRuntime();
+  };
+
+  auto specialized_runtime = run(129, 1000);
+  TORCH_CHECK(specialized_runtime->isShapeSpecialized());
+  auto specialized_tv0 = specialized_runtime->fusionSegments()
+                             ->completeFusion()
+                             ->inputs()
+                             .at(0)
+                             ->as<TensorView>();
+  for (auto id : specialized_tv0->getMaybeRFactorDomain()) {
+    TORCH_CHECK(id->extent()->isConstScalar(), id->toString());
+  }
+
+  auto generic_runtime = run(64, 1000);
+  TORCH_CHECK(generic_runtime != specialized_runtime);
+  TORCH_CHECK(!generic_runtime->isShapeSpecialized());
+
+  // New tensors of the specialized sizes are dispatched to its kernels
+  TORCH_CHECK(run(129, 1000) == specialized_runtime);
+}
+
+// Kernels are declared with the block size they are compiled for and the
+// target occupancy of their compile params, see Note [ Launch bounds ]
+TEST_F(NVFuserTest, FusionLaunchBounds_CUDA) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeContigTensor(1);
+  fusion.addInput(tv0);
+  auto tv1 = mul(tv0, IrBuilder::create<Double>(2.0));
+  fusion.addOutput(tv1);
+  tv1->split(0, 128);
+  tv1->axis(0)->parallelize(ParallelType::BIDx);
+  tv1->axis(1)->parallelize(ParallelType::TIDx);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::manual_seed(0);
+  auto t0 = at::randn({1000}, options);
+  std::vector<c10::IValue> aten_inputs({t0});
+
+  for (const int64_t min_blocks_per_sm : {1, 4}) {
+    CompileParams compile_params;
+    compile_params.min_blocks_per_sm = min_blocks_per_sm;
+    FusionExecutor fe;
+    fe.compileFusion(&fusion, aten_inputs, LaunchParams(), compile_params);
+    const auto launch_bounds = "__launch_bounds__(128, " +
+        std::to_string(min_blocks_per_sm) + ")";
+    TORCH_CHECK(
+        fe.kernelString().find(launch_bounds) != std::string::npos,
+        fe.kernelString());
+    auto cg_outputs =
+        fe.runFusion(aten_inputs, LaunchParams(), compile_params);
+    testValidate(
+        &fusion, cg_outputs, aten_inputs, {t0 * 2}, __LINE__, __FILE__);
+  }
+}
+
+// Kernels with and without shared memory set their carveout preference
+// before their launches, see Note [ Shared memory carveout ]
+TEST_F(NVFuserTest, FusionSmemCarveout_CUDA) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  auto& fusion = *fusion_ptr;
+  FusionGuard fg(fusion_ptr.get());
+
+  auto tv0 = makeContigTensor(2);
+  auto tv1 = makeContigTensor(1);
+  fusion.addInput(tv0);
+  fusion.addInput(tv1);
+  auto tv2 = mul(tv0, broadcast(tv1, {true, false}));
+  fusion.addOutput(tv2);
+  fusion.addOutput(sum(tv2, {1}));
+
+  FusionExecutorCache executor_cache(std::move(fusion_ptr));
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::manual_seed(0);
+  for (const int64_t cols : {1024, 4096}) {
+    auto t0 = at::randn({256, cols}, options);
+    auto t1 = at::randn({cols}, options);
+    std::vector<c10::IValue> aten_inputs({t0, t1});
+    auto cg_outputs = executor_cache.runFusionWithInputs(aten_inputs);
+    auto t2 = t0 * t1.unsqueeze(0);
+    testValidate(
+        executor_cache.fusion(),
+        cg_outputs,
+        aten_inputs,
+        {t2, t2.sum({1})},
+        __LINE__,
+        __FILE__);
+  }
+}
+
+// Unrolled elements of the serial loop of an inner reduction are accumulated
+// into separate registers, see Note [ Multiple serial accumulators ]
+TEST_F(NVFuserTest, FusionMultipleSerialAccumulators_CUDA) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeContigTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = sum(tv0, {1});
+  fusion.addOutput(tv1);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({1024, 1 << 15}, options);
+
+  auto rparams = getReductionHeuristics(&fusion, {t0});
+  TORCH_CHECK(rparams, "Reduction schedule was not generated!");
+  TORCH_CHECK(
+      rparams->unroll_factor_inner_reduction > 1 &&
+      !rparams->persistent_kernel);
+  rparams->multiple_serial_accumulators = true;
+  scheduleReduction(&fusion, *rparams);
+
+  // The serial loop, the combination of the accumulators and the block
+  // reduction
+  auto exprs = fusion.exprs();
+  TORCH_CHECK(
+      std::count_if(exprs.begin(), exprs.end(), [](Expr* expr) {
+        return expr->isA<ReductionOp>();
+      }) == 3);
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {t0}, rparams->lparams);
+  auto cg_outputs = fe.runFusion({t0}, rparams->lparams);
+  testValidate(
+      &fusion,
+      cg_outputs,
+      {t0},
+      {t0.sum({1})},
+      __LINE__,
+      __FILE__,
+      "",
+      rparams->lparams);
+}
+
+// A broadcast concretized by one consumer doesn't prevent the contiguous
+// indexing of another one computed in its own loops, see
+// Note [ Contiguity of concretized broadcasts ]
+TEST_F(NVFuserTest, FusionContigIndexingConcretizedBroadcast_CUDA) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeContigConcreteTensor({3, 4});
+  fusion.addInput(tv0);
+  auto tv1 = makeContigConcreteTensor({3, 5, 4});
+  fusion.addInput(tv1);
+
+  auto tv2 = broadcast(tv0, {false, true, false});
+  auto tv3 = add(tv2, tv1);
+  fusion.addOutput(tv3);
+  auto tv4 = mul(tv2, IrBuilder::create<Double>(2));
+  fusion.addOutput(tv4);
+
+  for (auto tv : {tv2, tv3, tv4}) {
+    tv->merge(1)->merge(0);
+  }
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({3, 4}, options);
+  auto t1 = at::randn({3, 5, 4}, options);
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {t0, t1});
+  auto cg_outputs = fe.runFusion({t0, t1});
+
+  auto t2 = t0.unsqueeze(1);
+  testValidate(
+      &fusion, cg_outputs, {t0, t1}, {t2 + t1, t2 * 2}, __LINE__, __FILE__);
+}
+
+// An input with a storage offset is vectorized with a scalar prologue and
+// epilogue, see Note [ Misaligned pointwise vectorization ]
+TEST_F(NVFuserTest, FusionPointwiseMisalignedVectorize_CUDA) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeContigTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = makeContigTensor(2);
+  fusion.addInput(tv1);
+  auto tv2 = mul(tv0, IrBuilder::create<Double>(2));
+  auto tv3 = add(tv2, tv1);
+  fusion.addOutput(tv3);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({33 * 457 + 1}, options).narrow(0, 1, 33 * 457);
+  t0 = t0.view({33, 457});
+  auto t1 = at::randn({33, 457}, options);
+  std::vector<c10::IValue> aten_inputs = {t0, t1};
+
+  auto params = getPointwiseHeuristics(&fusion, aten_inputs);
+  TORCH_CHECK(params->break_point == 0);
+  params->vectorize = true;
+  params->unroll_factor = 4;
+  params->grid_stride_loop = false;
+  params->misaligned_vectorize = true;
+  params->misaligned_vectorize_input = 0;
+  schedulePointwise(&fusion, *params);
+
+  auto cached_input = ir_utils::consumerTvsOf(tv0).at(0);
+  TORCH_CHECK(
+      cached_input->axis(-1)->getParallelType() ==
+          ParallelType::MisalignedVectorize,
+      "Misaligned input not vectorized: ",
+      cached_input->toString());
+  TORCH_CHECK(tv3->axis(-1)->getParallelType() == ParallelType::Serial);
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, aten_inputs, params->lparams);
+  auto cg_outputs = fe.runFusion(aten_inputs, params->lparams);
+
+  testValidate(
+      &fusion,
+      cg_outputs,
+      aten_inputs,
+      {t0 * 2 + t1},
+      __LINE__,
+      __FILE__,
+      "",
+      params->lparams);
+}
+
 // Test file size should be up to 10K LoC. Create a new file for more tests.
 
 } // namespace nvfuser
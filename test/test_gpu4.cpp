@@ -0,0 +1,2592 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <gmock/gmock-matchers.h>
+#include <gtest/gtest.h>
+
+#include <codegen.h>
+#include <device_profile.h>
+#include <disjoint_set.h>
+#include <executor.h>
+#include <executor_params.h>
+#include <executor_utils.h>
+#include <expr_evaluator.h>
+#include <fusion.h>
+#include <fusion_segmenter.h>
+#include <inlining.h>
+#include <instrumentation.h>
+#include <ir_all_nodes.h>
+#include <ir_builder.h>
+#include <ir_iostream.h>
+#include <ir_utils.h>
+#include <kernel_cache.h>
+#include <kernel_db/kernel_db.h>
+#include <kernel_db/utils.h>
+#include <kernel_ir.h>
+#include <kernel_ir_dispatch.h>
+#include <lower2device.h>
+#include <lower_divisible_split.h>
+#include <lower_magic_zero.h>
+#include <lower_validation.h>
+#include <ops/all_ops.h>
+#include <scheduler/all_schedulers.h>
+#include <scheduler/reduction_utils.h>
+#include <scheduler/utils.h>
+#include <test/test_gpu_validator.h>
+#include <test/test_utils.h>
+#include <transform_replay.h>
+
+#include <torch/csrc/jit/api/function_impl.h>
+#include <torch/csrc/jit/codegen/cuda/interface.h>
+#include <torch/csrc/jit/ir/irparser.h>
+#include <torch/csrc/jit/runtime/graph_executor.h>
+#include <torch/torch.h>
+
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/Exceptions.h>
+#include <c10/cuda/CUDAGuard.h>
+#include <c10/cuda/CUDAStream.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+#include <thread>
+
+namespace nvfuser {
+
+using namespace at::indexing;
+
+TEST_F(NVFuserTest, FusionExecutorCacheShapeBuckets_CUDA) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = sum(tv0, {1});
+  fusion->addOutput(tv1);
+
+  nvfuser::ShapeBuckets shape_buckets;
+  shape_buckets.dims = {{0, 1}};
+  shape_buckets.bounds = {256, 4096};
+
+  // all sizes fall into the same bucket with the same vectorizability
+  TORCH_CHECK(shape_buckets.canonicalSize(1001) == 4097);
+  TORCH_CHECK(shape_buckets.canonicalSize(3999) == 4097);
+  TORCH_CHECK(shape_buckets.canonicalSize(3000) == 4104);
+  TORCH_CHECK(shape_buckets.canonicalSize(8000) == 8192);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  executor_cache.setShapeBuckets(shape_buckets);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  FusionKernelRuntime* kernel_runtime = nullptr;
+  for (int64_t inner_size = 1001; inner_size < 4096; inner_size += 498) {
+    at::Tensor t0 = at::randn({128, inner_size}, options);
+    auto outputs = executor_cache.runFusionWithInputs({t0});
+    testValidate(
+        executor_cache.fusion(),
+        outputs,
+        {t0},
+        {t0.sum({1})},
+        __LINE__,
+        __FILE__);
+    // one runtime serves the whole bucket
+    if (kernel_runtime == nullptr) {
+      kernel_runtime = executor_cache.getMostRecentKernelRuntime();
+    }
+    TORCH_CHECK(kernel_runtime == executor_cache.getMostRecentKernelRuntime());
+  }
+  // the heuristics of the bucket are looked up for all later sizes, see
+  // Note [ Heuristic lookup ]
+  TORCH_CHECK(executor_cache.numCompilesAvoided() == 6);
+}
+
+TEST_F(NVFuserTest, FusionExecutorCacheCompileForInputs_CUDA) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = sum(tv0, {1});
+  fusion->addOutput(tv1);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto meta_options = at::TensorOptions().dtype(at::kFloat).device(at::kMeta);
+  std::vector<std::vector<int64_t>> shapes = {{128, 1024}, {4, 65536}};
+  std::vector<std::vector<c10::IValue>> input_signatures;
+  for (const auto& shape : shapes) {
+    input_signatures.push_back({at::empty(shape, meta_options)});
+  }
+  executor_cache.compileFusionForInputs(input_signatures);
+
+  for (const auto& shape : shapes) {
+    at::Tensor t0 = at::randn(shape, options);
+    TORCH_CHECK(executor_cache.isCompiled({t0}));
+    auto outputs = executor_cache.runFusionWithInputs({t0});
+    testValidate(
+        executor_cache.fusion(),
+        outputs,
+        {t0},
+        {t0.sum({1})},
+        __LINE__,
+        __FILE__);
+  }
+}
+
+TEST_F(NVFuserTest, FusionSharedKernelModule_CUDA) {
+  auto make_code = [](const std::string& name, const std::string& value) {
+    return "namespace CudaCodeGen {\n__global__ void " + name +
+        "(float* out) {\n  out[threadIdx.x] = " + value + ";\n}\n}\n";
+  };
+  auto compile = [](const std::string& code, const std::string& name) {
+    return std::get<0>(executor_utils::nvrtcCompile(
+        c10::nullopt, code, "CudaCodeGen::" + name, 1));
+  };
+
+  // kernels that only differ in their name share one module
+  auto function0 =
+      compile(make_code("shared_kernel0", "1.0f"), "shared_kernel0");
+  auto function1 =
+      compile(make_code("shared_kernel1", "1.0f"), "shared_kernel1");
+  TORCH_CHECK(function0.module == function1.module);
+  TORCH_CHECK(function0.function == function1.function);
+
+  auto function2 =
+      compile(make_code("shared_kernel2", "2.0f"), "shared_kernel2");
+  TORCH_CHECK(function0.module != function2.module);
+}
+
+TEST_F(NVFuserTest, FusionLoadedKernelBudget_CUDA) {
+  auto make_executor_cache = [](double value) {
+    auto fusion = std::make_unique<Fusion>();
+    FusionGuard fg(fusion.get());
+    auto tv0 = makeSymbolicTensor(2);
+    fusion->addInput(tv0);
+    auto tv1 = add(tv0, IrBuilder::create<Double>(value));
+    fusion->addOutput(tv1);
+    return std::make_unique<FusionExecutorCache>(std::move(fusion));
+  };
+
+  executor_utils::setMaxLoadedKernels(1);
+  std::vector<std::unique_ptr<FusionExecutorCache>> executor_caches;
+  executor_caches.push_back(make_executor_cache(1.0));
+  executor_caches.push_back(make_executor_cache(2.0));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({128, 64}, options);
+  // Each launch reloads the module the previous one unloaded
+  for (const auto i : c10::irange(4)) {
+    auto& executor_cache = executor_caches[i % 2];
+    auto outputs = executor_cache->runFusionWithInputs({t0});
+    testValidate(
+        executor_cache->fusion(),
+        outputs,
+        {t0},
+        {t0 + (double)(i % 2 + 1)},
+        __LINE__,
+        __FILE__);
+    TORCH_CHECK(executor_utils::numLoadedKernels() <= 1);
+  }
+  executor_utils::setMaxLoadedKernels(0);
+}
+
+TEST_F(NVFuserTest, FusionPrunedKernelPreamble_CUDA) {
+  const std::string full_preamble = executor_utils::kernelPreamble(
+      "Ampere::cpAsyncCommit();\nwelford::gridWelford();\n");
+  const std::string pruned_preamble = executor_utils::kernelPreamble("");
+  TORCH_CHECK(pruned_preamble.size() < full_preamble.size());
+  TORCH_CHECK(full_preamble.find("namespace Ampere") != std::string::npos);
+  TORCH_CHECK(pruned_preamble.find("namespace Ampere") == std::string::npos);
+
+  // A pruned preamble must still compile a kernel that doesn't use Welford
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = sum(tv0, {1});
+  fusion->addOutput(tv1);
+  FusionExecutorCache executor_cache(std::move(fusion));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({128, 64}, options);
+  auto outputs = executor_cache.runFusionWithInputs({t0});
+  testValidate(
+      executor_cache.fusion(),
+      outputs,
+      {t0},
+      {t0.sum({1})},
+      __LINE__,
+      __FILE__);
+}
+
+TEST_F(NVFuserTest, FusionCompileTimings_CUDA) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = sum(tv0, {1});
+  fusion->addOutput(tv1);
+  FusionExecutorCache executor_cache(std::move(fusion));
+  executor_cache.profile(true);
+
+  inst::CompileStats::instance()->reset();
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({128, 64}, options);
+  auto outputs = executor_cache.runFusionWithInputs({t0});
+  testValidate(
+      executor_cache.fusion(),
+      outputs,
+      {t0},
+      {t0.sum({1})},
+      __LINE__,
+      __FILE__);
+
+  const auto compile_timings = executor_cache.getMostRecentKernelRuntime()
+                                   ->getMostRecentExecutorLog()
+                                   .compile_timings;
+  auto has_stage = [&compile_timings](const std::string& name) {
+    return std::any_of(
+        compile_timings.stages_ms.begin(),
+        compile_timings.stages_ms.end(),
+        [&name](const auto& stage) { return stage.first == name; });
+  };
+  for (const auto& name :
+       {"Heuristics",
+        "Segmentation",
+        "Scheduling",
+        "GpuLower::LoopNestGenerator",
+        "GpuLower::finalize",
+        "CodeGen"}) {
+    TORCH_CHECK(has_stage(name), "Missing compile stage ", name);
+  }
+
+  const auto stats = inst::CompileStats::instance()->stats();
+  TORCH_CHECK(stats.count("CodeGen") == 1);
+  const auto& codegen_stats = stats.at("CodeGen");
+  TORCH_CHECK(
+      std::accumulate(
+          codegen_stats.histogram.begin(),
+          codegen_stats.histogram.end(),
+          int64_t(0)) == codegen_stats.count);
+}
+
+TEST_F(NVFuserTest, FusionLoweringCache_CUDA) {
+  auto make_fusion = [](CacheHint cache_hint = CacheHint::Default) {
+    auto fusion = std::make_unique<Fusion>();
+    FusionGuard fg(fusion.get());
+    auto tv0 = makeSymbolicTensor(2);
+    fusion->addInput(tv0);
+    tv0->setCacheHint(cache_hint);
+    auto tv1 = add(tv0, IrBuilder::create<Double>(1.0));
+    auto tv2 = sum(tv1, {1});
+    fusion->addOutput(tv2);
+    tv2->split(1, 32);
+    tv2->axis(0)->parallelize(ParallelType::BIDx);
+    tv2->axis(-1)->parallelize(ParallelType::TIDx);
+    scheduler_utils::parallelizeAllLike(tv2);
+    inlineMost();
+    return fusion;
+  };
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({16, 128}, options);
+  auto ref = (t0 + 1).sum({1});
+
+  auto fusion0 = make_fusion();
+  FusionExecutor fe0;
+  fe0.compileFusion(fusion0.get(), {t0});
+  auto fusion1 = make_fusion();
+  FusionExecutor fe1;
+  fe1.compileFusion(fusion1.get(), {t0});
+
+  // The identical fusion reuses the lowered kernel under its own name
+  TORCH_CHECK(fe0.kernel() == fe1.kernel());
+  TORCH_CHECK(fe0.kernelName() != fe1.kernelName());
+  TORCH_CHECK(
+      fe1.kernelString().find(" " + fe1.kernelName() + "(") !=
+      std::string::npos);
+  TORCH_CHECK(
+      fe1.kernelString().find(" " + fe0.kernelName() + "(") ==
+      std::string::npos);
+
+  // Cache hints are part of the key, as they change the generated accesses
+  auto fusion2 = make_fusion(CacheHint::EvictFirst);
+  FusionExecutor fe2;
+  fe2.compileFusion(fusion2.get(), {t0});
+  TORCH_CHECK(fe0.kernel() != fe2.kernel());
+
+  auto outputs0 = fe0.runFusion({t0});
+  auto outputs1 = fe1.runFusion({t0});
+  auto outputs2 = fe2.runFusion({t0});
+  testValidate(fusion0.get(), outputs0, {t0}, {ref}, __LINE__, __FILE__);
+  testValidate(fusion1.get(), outputs1, {t0}, {ref}, __LINE__, __FILE__);
+  testValidate(fusion2.get(), outputs2, {t0}, {ref}, __LINE__, __FILE__);
+}
+
+TEST_F(NVFuserTest, FusionSharedMemoryOffsetPacking_CUDA) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeConcreteTensor({128});
+  fusion.addInput(tv0);
+  auto tv1 = set(tv0);
+  auto tv2 = sin(tv1);
+  auto tv3 = castOp(DataType::Double, tv2);
+  auto tv4 = cos(tv3);
+  fusion.addOutput(tv4);
+
+  // tv1 is dead once tv3 is written, so both can start at the same offset
+  tv1->setMemoryType(MemoryType::Shared);
+  tv3->setMemoryType(MemoryType::Shared);
+  for (auto tv : {tv1, tv2, tv3, tv4}) {
+    tv->axis(0)->parallelize(ParallelType::TIDx);
+  }
+
+  GpuLower gpulw(&fusion);
+  const auto& packed_smem = gpulw.kernel()->summary().packed_smem;
+  TORCH_CHECK(packed_smem.offsets.size() == 2);
+  for (const auto& entry : packed_smem.offsets) {
+    TORCH_CHECK(entry.second == 0);
+  }
+  TORCH_CHECK(packed_smem.size == 128 * (int64_t)sizeof(double));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({128}, options);
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {t0});
+  TORCH_CHECK(
+      fe.kernelString().find("smem_packed_offset") != std::string::npos);
+  auto outputs = fe.runFusion({t0});
+  testValidate(
+      &fusion,
+      outputs,
+      {t0},
+      {t0.sin().to(at::kDouble).cos()},
+      __LINE__,
+      __FILE__);
+}
+
+TEST_F(NVFuserTest, FusionRegisterPressureEstimate_CUDA) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeConcreteTensor({64});
+  fusion.addInput(tv0);
+  auto tv1 = add(tv0, IrBuilder::create<Double>(1));
+  auto tv2 = add(tv1, IrBuilder::create<Double>(2));
+  auto tv3 = add(tv2, tv1);
+  auto tv4 = castOp(DataType::Double, tv3);
+  auto tv5 = sin(tv4);
+  fusion.addOutput(tv5);
+
+  // Nothing is inlined. tv1 and tv2 are live when tv3 is computed, and tv3
+  // is live when tv4, which takes two registers per element, is computed
+  GpuLower gpulw(&fusion);
+  TORCH_CHECK(
+      gpulw.kernel()->summary().register_pressure == 64 + 64 * 2,
+      "Unexpected register pressure estimate: ",
+      gpulw.kernel()->summary().register_pressure);
+}
+
+// Merging a small set into a large one keeps the order of the entries and
+// the sets
+TEST_F(NVFuserTest, FusionDisjointSetMergeOrder_CUDA) {
+  DisjointSets<int> set;
+
+  set.initializeSet(0);
+  for (auto i : c10::irange(1, 4)) {
+    set.mapEntries(1, i);
+  }
+  set.initializeSet(4);
+
+  // The set of 0 is smaller but its entries come first
+  set.mapEntries(0, 1);
+  TORCH_CHECK(set.disjointSets().size() == 2);
+  TORCH_CHECK(
+      set.disjointSets().at(0)->vector() == std::vector<int>({0, 1, 2, 3}));
+  TORCH_CHECK(set.disjointSets().at(1)->vector() == std::vector<int>({4}));
+  for (auto i : c10::irange(4)) {
+    TORCH_CHECK(set.strictAreMapped(i, 0));
+    TORCH_CHECK(!set.permissiveAreMapped(i, 4));
+  }
+
+  set.mapEntries(4, 2);
+  TORCH_CHECK(set.disjointSets().size() == 1);
+  TORCH_CHECK(
+      set.disjointSets().at(0)->vector() ==
+      std::vector<int>({4, 0, 1, 2, 3}));
+}
+
+// Merging the same domains in different orders is not mapped but
+// results in the same extent
+TEST_F(NVFuserTest, FusionParallelDimensionMap6_CUDA) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = add(tv0, IrBuilder::create<Double>(1));
+  fusion.addOutput(tv1);
+  auto tv2 = add(tv0, IrBuilder::create<Double>(2));
+  fusion.addOutput(tv2);
+
+  tv1->merge(0);
+  tv2->reorder({{0, 1}});
+  tv2->merge(0);
+
+  tv1->axis(0)->parallelize(ParallelType::TIDx);
+  tv2->axis(0)->parallelize(ParallelType::TIDx);
+
+  GpuLower gpulw(&fusion);
+  const auto& pdmap = gpulw.parallelDimensionMap();
+  TORCH_CHECK(pdmap.isExact(ParallelType::TIDx));
+  TORCH_CHECK(
+      pdmap.get(ParallelType::TIDx)->isA<NamedScalar>() &&
+      pdmap.get(ParallelType::TIDx)->as<NamedScalar>()->name() == "blockDim.x");
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor input1 = at::randn({7, 9}, options);
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {input1});
+  auto outputs = fe.runFusion({input1});
+
+  testValidate(
+      &fusion,
+      outputs,
+      {input1},
+      {input1 + 1, input1 + 2},
+      __LINE__,
+      __FILE__);
+}
+
+// Output shapes, segmentation and heuristics are inferred from meta inputs
+// without compiling, see Note [ Meta execution ]
+TEST_F(NVFuserTest, FusionExecutorCachePlanWithMetaInputs_CUDA) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = makeSymbolicTensor(1);
+  fusion->addInput(tv1);
+  auto tv2 = sum(tv0, {1});
+  auto tv3 = add(tv2, tv1);
+  auto tv4 = castOp(DataType::Half, broadcast(tv3, {false, true}));
+  auto tv5 = expand(
+      tv4,
+      {tv0->axis(0)->extent(),
+       mul(tv0->axis(1)->extent(), IrBuilder::create<Int>(2))});
+  fusion->addOutput(tv3);
+  fusion->addOutput(tv5);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+
+  auto meta_options = at::TensorOptions().dtype(at::kFloat).device(at::kMeta);
+  at::Tensor m0 = at::empty({128, 1024}, meta_options);
+  at::Tensor m1 = at::empty({128}, meta_options);
+  auto meta_execution = executor_cache.planFusionWithInputs({m0, m1});
+
+  TORCH_CHECK(meta_execution.outputs.size() == 2);
+  const auto& out0 = meta_execution.outputs.at(0);
+  const auto& out1 = meta_execution.outputs.at(1);
+  TORCH_CHECK(out0.is_meta() && out1.is_meta());
+  TORCH_CHECK(out0.sizes() == c10::IntArrayRef({128}));
+  TORCH_CHECK(out0.scalar_type() == at::kFloat);
+  TORCH_CHECK(out1.sizes() == c10::IntArrayRef({128, 2048}));
+  TORCH_CHECK(out1.strides() == c10::IntArrayRef({1, 0}));
+  TORCH_CHECK(out1.scalar_type() == at::kHalf);
+
+  auto kernel_runtime = meta_execution.kernel_runtime;
+  TORCH_CHECK(kernel_runtime != nullptr);
+  TORCH_CHECK(!kernel_runtime->isCompiled());
+
+  // The run reuses the planned runtime and matches the planned outputs
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({128, 1024}, options);
+  at::Tensor t1 = at::randn({128}, options);
+  auto outputs = executor_cache.runFusionWithInputs({t0, t1});
+  TORCH_CHECK(executor_cache.getMostRecentKernelRuntime() == kernel_runtime);
+  for (const auto i : c10::irange(outputs.size())) {
+    TORCH_CHECK(outputs[i].sizes() == meta_execution.outputs[i].sizes());
+    TORCH_CHECK(outputs[i].strides() == meta_execution.outputs[i].strides());
+    TORCH_CHECK(
+        outputs[i].scalar_type() == meta_execution.outputs[i].scalar_type());
+  }
+}
+
+// Segment outputs forwarding fusion inputs have no argument slot, see
+// Note [ Runtime argument slots ]
+TEST_F(NVFuserTest, FusionExecutorCacheCompileForwardedInputs_CUDA) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = makeSymbolicTensor(1);
+  fusion->addInput(tv1);
+  auto tv2 = makeSymbolicTensor(2);
+  fusion->addInput(tv2);
+
+  // Forwarded ahead of the intermediates of the segments
+  fusion->addOutput(tv0);
+  auto tv3 = add(tv0, IrBuilder::create<Double>(1));
+  auto tv4 = max(tv3, {0});
+  auto tv5 = add(tv4, tv1);
+  auto tv6 = add(tv5, tv2);
+  fusion->addOutput(tv6);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({8, 5}, options);
+  at::Tensor t1 = at::randn({5}, options);
+  at::Tensor t2 = at::randn({8, 5}, options);
+  std::vector<c10::IValue> aten_inputs = {t0, t1, t2};
+
+  // Compiled through compileFusionParallel
+  executor_cache.compileFusionForInputs({aten_inputs});
+  TORCH_CHECK(executor_cache.isCompiled(aten_inputs));
+
+  auto outputs = executor_cache.runFusionWithInputs(aten_inputs);
+  TORCH_CHECK(
+      executor_cache.getMostRecentKernelRuntime()->isSegmented(),
+      "segmentation didn't happen");
+
+  auto t6 = std::get<0>(at::max(t0 + 1, 0)) + t1 + t2;
+  testValidate(
+      executor_cache.fusion(),
+      outputs,
+      aten_inputs,
+      {t0, t6},
+      __LINE__,
+      __FILE__);
+}
+
+// With parallel_compile, the first run compiles all segments at once
+TEST_F(NVFuserTest, FusionExecutorCacheParallelCompile_CUDA) {
+  EnableOptionGuard opt_guard(EnableOption::ParallelCompile);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = makeSymbolicTensor(1);
+  fusion->addInput(tv1);
+  auto tv2 = makeSymbolicTensor(2);
+  fusion->addInput(tv2);
+
+  auto tv3 = add(tv0, IrBuilder::create<Double>(1));
+  auto tv4 = max(tv3, {0});
+  auto tv5 = add(tv4, tv1);
+  auto tv6 = sum(add(tv5, tv2), {1});
+  fusion->addOutput(tv6);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({8, 5}, options);
+  at::Tensor t1 = at::randn({5}, options);
+  at::Tensor t2 = at::randn({8, 5}, options);
+  std::vector<c10::IValue> aten_inputs = {t0, t1, t2};
+
+  auto outputs = executor_cache.runFusionWithInputs(aten_inputs);
+  auto kernel_runtime = executor_cache.getMostRecentKernelRuntime();
+  TORCH_CHECK(kernel_runtime->isSegmented(), "segmentation didn't happen");
+  TORCH_CHECK(kernel_runtime->isCompiled());
+  for (const auto& executor : kernel_runtime->executors()) {
+    TORCH_CHECK(executor.compiled());
+  }
+
+  // The second run re-uses the kernels compiled by the first
+  auto outputs2 = executor_cache.runFusionWithInputs(aten_inputs);
+  TORCH_CHECK(executor_cache.getMostRecentKernelRuntime() == kernel_runtime);
+
+  auto t6 = (std::get<0>(at::max(t0 + 1, 0)) + t1 + t2).sum({1});
+  testValidate(
+      executor_cache.fusion(), outputs, aten_inputs, {t6}, __LINE__, __FILE__);
+  testValidate(
+      executor_cache.fusion(),
+      outputs2,
+      aten_inputs,
+      {t6},
+      __LINE__,
+      __FILE__);
+}
+
+// Cached launches of a kernel with grid reductions and syncs reuse the work
+// buffers and semaphores of the workspace of their stream, see
+// Note [ Persistent workspace ]
+TEST_F(NVFuserTest, FusionGridPersistenceWorkspace_CUDA) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+
+  auto tv1 = sum(tv0, {0});
+  auto tv2 = broadcast(tv1, {true, false});
+  auto tv3 = add(tv0, tv2);
+  fusion.addOutput(tv3);
+
+  std::vector<TensorView*> tvs = {tv1, tv2, tv3};
+  for (auto tv : tvs) {
+    tv->split(0, 2);
+    tv->axis(0)->parallelize(ParallelType::BIDx);
+    tv->axis(1)->parallelize(ParallelType::TIDy);
+    tv->axis(2)->parallelize(ParallelType::TIDx);
+  }
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  const size_t cache_id = 0;
+  at::Tensor input = at::randn({64, 32}, options);
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {input});
+
+  // Back to back launches on the same stream
+  std::vector<at::Tensor> inputs;
+  std::vector<at::Tensor> outputs;
+  for (auto i : c10::irange(4)) {
+    (void)i; // Suppress unused variable warning
+    inputs.push_back(at::randn({64, 32}, options));
+    outputs.push_back(fe.runFusion(
+        {inputs.back()}, LaunchParams(), CompileParams(), cache_id)[0]);
+  }
+
+  // Interleaved launches on two streams, each with its own workspace
+  std::vector<c10::cuda::CUDAStream> streams = {
+      c10::cuda::getStreamFromPool(), c10::cuda::getStreamFromPool()};
+  for (auto i : c10::irange(8)) {
+    c10::cuda::CUDAStreamGuard stream_guard(streams.at(i % 2));
+    inputs.push_back(at::randn({64, 32}, options));
+    outputs.push_back(fe.runFusion(
+        {inputs.back()}, LaunchParams(), CompileParams(), cache_id)[0]);
+  }
+  for (const auto& stream : streams) {
+    stream.synchronize();
+  }
+
+  for (const auto i : c10::irange(inputs.size())) {
+    auto aten_output = inputs[i].sum({0}).unsqueeze(0).add(inputs[i]);
+    testValidate(
+        &fusion,
+        {outputs[i]},
+        {inputs[i]},
+        {aten_output},
+        __LINE__,
+        __FILE__);
+  }
+}
+
+// Cached launches after the first one patch the inputs, outputs and philox
+// state into the packed kernel arguments of the cache entry
+TEST_F(NVFuserTest, FusionPackedKernelArguments_CUDA) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+  auto s1 = IrBuilder::create<Double>();
+  fusion.addInput(s1);
+
+  auto tv2 = mul(tv0, s1);
+  fusion.addOutput(tv2);
+  auto tv3 = rand_like(tv0);
+  fusion.addOutput(tv3);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  const size_t cache_id = 0;
+  std::vector<c10::IValue> aten_inputs = {at::randn({64, 32}, options), 2.0};
+
+  auto lparams = schedulePointwise(&fusion, aten_inputs);
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, aten_inputs, lparams);
+
+  at::Tensor prev_rand;
+  for (auto i : c10::irange(4)) {
+    std::vector<c10::IValue> inputs = {
+        at::randn({64, 32}, options), (double)(i + 1)};
+    auto outputs = fe.runFusion(inputs, lparams, CompileParams(), cache_id);
+    auto aten_output = inputs[0].toTensor() * (double)(i + 1);
+    TORCH_CHECK(outputs[0].allclose(aten_output));
+    // The philox offset advances on every launch
+    TORCH_CHECK(outputs[1].min().item<float>() >= 0);
+    TORCH_CHECK(outputs[1].max().item<float>() < 1);
+    if (prev_rand.defined()) {
+      TORCH_CHECK(!outputs[1].equal(prev_rand));
+    }
+    prev_rand = outputs[1];
+  }
+}
+
+// Independent segments are launched on side streams, see
+// Note [ Concurrent segments ]
+TEST_F(NVFuserTest, FusionExecutorCacheConcurrentSegments_CUDA) {
+  EnableOptionGuard opt_guard(EnableOption::ConcurrentSegments, true, {"2"});
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+
+  // Two reductions independent of each other, and a normalization whose
+  // second segment depends on the first one
+  auto tv1 = sum(tv0, {0});
+  fusion->addOutput(tv1);
+  auto tv2 = sum(tv0, {1});
+  fusion->addOutput(tv2);
+  auto tv3 = max(tv0, {0});
+  auto tv4 = sum(add(tv0, broadcast(tv3, {true, false})), {1});
+  fusion->addOutput(tv4);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto validate = [&](const at::Tensor& t0,
+                      const std::vector<at::Tensor>& outputs) {
+    auto t3 = std::get<0>(at::max(t0, 0));
+    auto t4 = (t0 + t3.unsqueeze(0)).sum({1});
+    testValidate(
+        executor_cache.fusion(),
+        outputs,
+        {t0},
+        {t0.sum({0}), t0.sum({1}), t4},
+        __LINE__,
+        __FILE__);
+  };
+
+  for (auto i : c10::irange(3)) {
+    (void)i; // Suppress unused variable warning
+    at::Tensor t0 = at::randn({129, 65}, options);
+    validate(t0, executor_cache.runFusionWithInputs({t0}));
+  }
+  TORCH_CHECK(
+      executor_cache.getMostRecentKernelRuntime()->isSegmented(),
+      "segmentation didn't happen");
+
+  // The fusion is still ordered on the current stream when it isn't the
+  // default one
+  auto stream = c10::cuda::getStreamFromPool();
+  at::Tensor t0 = at::randn({129, 65}, options);
+  std::vector<at::Tensor> outputs;
+  {
+    c10::cuda::CUDAStreamGuard stream_guard(stream);
+    outputs = executor_cache.runFusionWithInputs({t0});
+  }
+  stream.synchronize();
+  validate(t0, outputs);
+}
+
+// A blur followed by the magnitude of its gradients is scheduled as a
+// single kernel with shared memory tiles, see Note [ Stencil scheduling ]
+TEST_F(NVFuserTest, FusionStencilScheduler_CUDA) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  auto& fusion = *fusion_ptr;
+  FusionGuard fg(fusion_ptr.get());
+
+  auto tv0 = makeContigTensor(3);
+  fusion.addInput(tv0);
+
+  const std::vector<std::vector<int>> offsets = {
+      {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}};
+  auto blur = tv0;
+  for (const auto& offset : offsets) {
+    blur = add(blur, shift(tv0, offset));
+  }
+  blur = div(blur, IrBuilder::create<Double>(5));
+  auto gx = sub(shift(blur, {0, 0, -1}), shift(blur, {0, 0, 1}));
+  auto gy = sub(shift(blur, {0, -1, 0}), shift(blur, {0, 1, 0}));
+  auto tv1 = add(mul(gx, gx), mul(gy, gy));
+  fusion.addOutput(tv1);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({3, 301, 257}, options);
+  std::vector<c10::IValue> aten_inputs = {t0};
+
+  FusionExecutorCache executor_cache(std::move(fusion_ptr));
+  auto cg_outputs = executor_cache.runFusionWithInputs(aten_inputs);
+
+  auto runtime = executor_cache.getMostRecentKernelRuntime();
+  TORCH_CHECK(!runtime->isSegmented(), "Unexpected segmentation");
+  const auto& scheduler_entry =
+      runtime->schedulerHeuristics()->heuristicsList().at(0);
+  TORCH_CHECK(
+      scheduler_entry->heuristic() == ScheduleHeuristic::Stencil,
+      "Unexpected heuristic was chosen: ",
+      scheduler_entry->heuristic());
+  const auto& params = scheduler_entry->stencilParams();
+  TORCH_CHECK(params.tile_x + 4 <= 32 && params.tile_y > 0);
+
+  // t[..., i - dy, j - dx], zero outside of t
+  auto shifted = [](at::Tensor t, int64_t dy, int64_t dx) {
+    auto padded = at::constant_pad_nd(t, {1, 1, 1, 1});
+    return padded.narrow(1, 1 - dy, t.size(1)).narrow(2, 1 - dx, t.size(2));
+  };
+  auto t_blur = t0;
+  for (const auto& offset : offsets) {
+    t_blur = t_blur + shifted(t0, offset[1], offset[2]);
+  }
+  t_blur = t_blur / 5;
+  auto t_gx = shifted(t_blur, 0, -1) - shifted(t_blur, 0, 1);
+  auto t_gy = shifted(t_blur, -1, 0) - shifted(t_blur, 1, 0);
+
+  testValidate(
+      &fusion,
+      cg_outputs,
+      aten_inputs,
+      {t_gx * t_gx + t_gy * t_gy},
+      __LINE__,
+      __FILE__);
+}
+
+// See Note [ Magic zero in unswitched loops ]
+TEST_F(NVFuserTest, FusionUnswitchMagicZeroElision_CUDA) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+
+  auto tv1 = add(tv0, IrBuilder::create<Double>(1));
+  auto tv2 = set(tv1);
+  fusion.addOutput(tv2);
+
+  // [BIDx, Unswitch, Unroll{4}, TIDx{128}]
+  tv2->merge(0);
+  tv2->split(0, 128);
+  tv2->split(0, 4);
+  tv2->split(0, 1);
+
+  TransformPropagatorWithCheck propagator(tv2);
+  MaxRootDomainInfoSpanningTree(tv2).traverse(&propagator);
+
+  tv2->axis(0)->parallelize(ParallelType::BIDx);
+  tv2->axis(1)->parallelize(ParallelType::Unswitch);
+  tv2->axis(2)->parallelize(ParallelType::Unroll);
+  tv2->axis(3)->parallelize(ParallelType::TIDx);
+  scheduler_utils::parallelizeAllLike(tv2);
+
+  inlineMost();
+
+  // Counts the tensor indices using magic zero and the magic zero updates
+  // in each version of the unswitched loop nest
+  class MagicZeroCounter : public kir::IrVisitor {
+   public:
+    using kir::IrVisitor::handle;
+
+    int64_t unpredicated_uses = 0;
+    int64_t unpredicated_updates = 0;
+    int64_t predicated_uses = 0;
+
+   private:
+    void handle(Expr* expr) final {
+      if (auto ite = dynamic_cast<kir::IfThenElse*>(expr)) {
+        if (ite->predicate()->predicate_type() != PredicateType::Unswitch) {
+          kir::IrVisitor::handle(ite);
+          return;
+        }
+        in_unpredicated_ = true;
+        for (auto then_expr : ite->thenBody().exprs()) {
+          handle(then_expr);
+        }
+        in_unpredicated_ = false;
+        for (auto else_expr : ite->elseBody().exprs()) {
+          handle(else_expr);
+        }
+      } else if (auto fl = dynamic_cast<kir::ForLoop*>(expr)) {
+        kir::IrVisitor::handle(fl);
+      } else if (expr->isA<kir::UpdateMagicZero>()) {
+        unpredicated_updates += in_unpredicated_;
+      } else {
+        std::vector<Val*> vals = expr->inputs();
+        vals.insert(vals.end(), expr->outputs().begin(), expr->outputs().end());
+        for (auto ti : ir_utils::filterByType<kir::TensorIndex>(vals)) {
+          if (usesMagicZero(ti->index())) {
+            (in_unpredicated_ ? unpredicated_uses : predicated_uses)++;
+          }
+        }
+      }
+    }
+
+    static bool usesMagicZero(Val* val) {
+      if (isMagicZero(val)) {
+        return true;
+      }
+      if (val->definition() == nullptr) {
+        return false;
+      }
+      const auto& inputs = val->definition()->inputs();
+      return std::any_of(inputs.begin(), inputs.end(), usesMagicZero);
+    }
+
+    bool in_unpredicated_ = false;
+  } counter;
+
+  GpuLower gpulw(&fusion);
+  counter.handle(gpulw.kernel()->topLevelExprs());
+
+  TORCH_CHECK(
+      counter.unpredicated_uses == 0 && counter.unpredicated_updates == 0,
+      "Unexpected magic zero in the unpredicated version of the unswitch");
+  TORCH_CHECK(
+      counter.predicated_uses > 0,
+      "Magic zero not found in the predicated version of the unswitch");
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({99, 101}, options);
+  std::vector<c10::IValue> aten_inputs = {t0};
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, aten_inputs);
+  auto cg_outputs = fe.runFusion(aten_inputs);
+
+  testValidate(&fusion, cg_outputs, aten_inputs, {t0 + 1}, __LINE__, __FILE__);
+}
+
+// See Note [ Eager fallback ]
+TEST_F(NVFuserTest, FusionEagerFallback_CUDA) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  auto tv1 = makeSymbolicTensor(1);
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+
+  auto tv2 = add(tv0, broadcast(tv1, {true, false}));
+  auto tv3 = sum(relu(tv2), {1});
+  fusion->addOutput(tv2);
+  fusion->addOutput(tv3);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  executor_cache.setEagerFallback(true);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({129, 257}, options);
+  at::Tensor t1 = at::randn({257}, options);
+  std::vector<c10::IValue> aten_inputs = {t0, t1};
+
+  auto t2 = t0 + t1.unsqueeze(0);
+  auto t3 = at::relu(t2).sum({1});
+
+  // The first run starts the compilation and doesn't wait for it
+  auto eager_outputs = executor_cache.runFusionWithInputs(aten_inputs);
+  TORCH_CHECK(
+      executor_cache.numEagerRuns() == 1,
+      "Expected the first run to fall back to ATen");
+  testValidate(
+      executor_cache.fusion(),
+      eager_outputs,
+      aten_inputs,
+      {t2, t3},
+      __LINE__,
+      __FILE__);
+
+  while (!executor_cache.isCompiled(aten_inputs)) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  auto cg_outputs = executor_cache.runFusionWithInputs(aten_inputs);
+  TORCH_CHECK(
+      executor_cache.numEagerRuns() == 1 &&
+          executor_cache.getMostRecentKernelRuntime() != nullptr,
+      "Expected the compiled kernels to run once they are ready");
+  testValidate(
+      executor_cache.fusion(),
+      cg_outputs,
+      aten_inputs,
+      {t2, t3},
+      __LINE__,
+      __FILE__);
+}
+
+// See Note [ Concurrent runs ] and Note [ Concurrent launches ]
+TEST_F(NVFuserTest, FusionConcurrentStreamsSameInputs_CUDA) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  // a reduction followed by a broadcast of its result is segmented, so the
+  // threads run several executors of the same runtime
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = sum(tv0, {1});
+  auto tv2 = add(tv0, broadcast(tv1, {false, true}));
+  auto tv3 = sum(tv2, {0});
+  fusion->addOutput(tv3);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({128, 1024}, options);
+  auto t3 = (t0 + t0.sum({1}).unsqueeze(1)).sum({0});
+
+  // compile once, so that all threads launch the cached executor entries of
+  // the same input id
+  executor_cache.runFusionWithInputs({t0});
+  auto kernel_runtime = executor_cache.getMostRecentKernelRuntime();
+  cudaDeviceSynchronize();
+
+  auto run_kernel = [&]() {
+    auto stream = c10::cuda::getStreamFromPool(false, 0);
+    c10::cuda::CUDAStreamGuard stream_guard(stream);
+    auto input = t0.clone();
+    for (const auto i : c10::irange(32)) {
+      (void)i; // Suppress unused variable warning
+      auto outputs = executor_cache.runFusionWithInputs({input});
+      ASSERT_TRUE(at::allclose(outputs[0], t3, 1e-3, 1e-3));
+    }
+  };
+
+  constexpr size_t kNumThreads = 4;
+  std::vector<std::thread> threads;
+  for (size_t id = 0; id < kNumThreads; ++id) {
+    threads.emplace_back(run_kernel);
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  TORCH_CHECK(
+      kernel_runtime->isSegmented() &&
+          executor_cache.getMostRecentKernelRuntime() == kernel_runtime,
+      "Expected all threads to run the segmented kernel runtime");
+}
+
+// See Note [ Execution policy ]
+TEST_F(NVFuserTest, FusionExecutionPolicy_CUDA) {
+  const auto device_sms =
+      (int64_t)at::cuda::getCurrentDeviceProperties()->multiProcessorCount;
+  {
+    scheduler_utils::SmBudgetGuard sm_budget_guard(4);
+    TORCH_CHECK(scheduler_utils::numSMs() == std::min<int64_t>(4, device_sms));
+  }
+  TORCH_CHECK(scheduler_utils::numSMs() == device_sms);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = sum(tv0, {0});
+  fusion->addOutput(tv1);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  ExecutionPolicy execution_policy;
+  execution_policy.high_priority_stream = true;
+  execution_policy.sm_budget = 4;
+  executor_cache.setExecutionPolicy(execution_policy);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({8192, 129}, options);
+  std::vector<c10::IValue> aten_inputs = {t0};
+
+  // outputs are used on the current stream after the run on the high
+  // priority stream
+  auto cg_outputs = executor_cache.runFusionWithInputs(aten_inputs);
+
+  testValidate(
+      executor_cache.fusion(),
+      cg_outputs,
+      aten_inputs,
+      {t0.sum({0})},
+      __LINE__,
+      __FILE__);
+}
+
+// The hash computed while the kernel is emitted must match the hash of the
+// emitted code, see Note [ Streaming kernel emission ]
+TEST_F(NVFuserTest, FusionCodegenStreamingHash_CUDA) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = mul(tv0, IrBuilder::create<Double>(0.1));
+  auto tv2 = add(tv1, IrBuilder::create<Double>(1e-7));
+  auto tv3 = sum(tv2, {1});
+  fusion.addOutput(tv3);
+
+  tv3->split(1, 128);
+  tv3->axis(-1)->parallelize(ParallelType::TIDx);
+  tv3->axis(0)->parallelize(ParallelType::BIDx);
+  TransformPropagatorWithCheck propagator(tv3);
+  MaxRootDomainInfoSpanningTree(tv3).traverse(&propagator);
+  scheduler_utils::parallelizeAllLike(tv3);
+  inlineMost();
+
+  GpuLower gpulw(&fusion);
+  uint64_t code_hash = 0;
+  const auto code = codegen::generateCudaKernel(
+      gpulw.kernel(), "CUDAGeneratedKernel", {}, &code_hash);
+  TORCH_CHECK(!code.empty());
+  TORCH_CHECK(code_hash == fnv1a_hash(code));
+  TORCH_CHECK(code == codegen::generateCudaKernel(gpulw.kernel()));
+}
+
+// Divisible pointwise problems assume their splits are divisible, while others
+// get a generic kernel, see Note [ Assumed divisible splits ]
+TEST_F(NVFuserTest, FusionPointwiseAssumedDivisibleSplit_CUDA) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeContigTensor(1);
+  fusion->addInput(tv0);
+  auto tv1 = add(tv0, IrBuilder::create<Double>(1));
+  fusion->addOutput(tv1);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({128 * 4 * 1000}, options);
+  at::Tensor t1 = at::randn({128 * 4 * 1000 + 4}, options);
+
+  {
+    Fusion fusion_copy(*fusion);
+    FusionGuard fg_copy(&fusion_copy);
+    auto params = getPointwiseHeuristics(&fusion_copy, {t0});
+    TORCH_CHECK(params->assume_divisible_split);
+    schedulePointwise(&fusion_copy, *params);
+    TORCH_CHECK(getAssumedDivisibleSplits(&fusion_copy).size() > 0);
+
+    FusionExecutor fe;
+    fe.compileFusion(&fusion_copy, {t0}, params->lparams);
+    auto cg_outputs = fe.runFusion({t0}, params->lparams);
+    testValidate(&fusion_copy, cg_outputs, {t0}, {t0 + 1}, __LINE__, __FILE__);
+
+    // The launch check rejects inputs violating the assumption
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-goto,hicpp-avoid-goto)
+    ASSERT_ANY_THROW(fe.runFusion({t1}, params->lparams));
+  }
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  for (const auto& t : {t0, t1}) {
+    auto cg_outputs = executor_cache.runFusionWithInputs({t});
+    testValidate(
+        executor_cache.fusion(), cg_outputs, {t}, {t + 1}, __LINE__, __FILE__);
+  }
+}
+
+// Canonical sizes of shape buckets don't tell whether the actual sizes are
+// divisible, so bucketed runs never assume divisible splits
+TEST_F(NVFuserTest, FusionPointwiseAssumedDivisibleSplitShapeBuckets_CUDA) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeContigTensor(1);
+  fusion->addInput(tv0);
+  auto tv1 = add(tv0, IrBuilder::create<Double>(1));
+  fusion->addOutput(tv1);
+
+  nvfuser::ShapeBuckets shape_buckets;
+  shape_buckets.dims = {{0, 0}};
+  // 528 isn't divisible by the elements of a block, but its canonical size is
+  TORCH_CHECK(shape_buckets.canonicalSize(528) == 1024);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  executor_cache.setShapeBuckets(shape_buckets);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  FusionKernelRuntime* kernel_runtime = nullptr;
+  for (int64_t size : {528, 1024, 784}) {
+    at::Tensor t0 = at::randn({size}, options);
+    auto cg_outputs = executor_cache.runFusionWithInputs({t0});
+    testValidate(
+        executor_cache.fusion(),
+        cg_outputs,
+        {t0},
+        {t0 + 1},
+        __LINE__,
+        __FILE__);
+    if (kernel_runtime == nullptr) {
+      kernel_runtime = executor_cache.getMostRecentKernelRuntime();
+    }
+    TORCH_CHECK(kernel_runtime == executor_cache.getMostRecentKernelRuntime());
+    TORCH_CHECK(!kernel_runtime->schedulerHeuristics()
+                     ->heuristicsList()
+                     .at(0)
+                     ->pointwiseParams()
+                     .assume_divisible_split);
+  }
+}
+
+// The residual of a residual norm is updated in place by the persistent
+// kernel of the norm, see Note [ Residual norms ]
+TEST_F(NVFuserTest, FusionResidualRMSNormInplace_CUDA) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  const float kEps = 1e-6;
+  auto tv0 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = makeContigTensor(2);
+  fusion->addInput(tv1);
+  auto result = residual_rms_norm(
+      tv0, tv1, 1, nullptr, IrBuilder::create<Double>(kEps), true);
+  fusion->addOutput(result.output);
+
+  // The norm reads the residual only at the positions it overwrites
+  validateAliasedOutputs(fusion.get());
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({129, 1024}, options);
+  at::Tensor t1 = at::randn({129, 1024}, options);
+  auto t2 = t0 + t1;
+  auto ref = t2 * at::rsqrt(t2.pow(2).mean(-1, true) + kEps);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  auto outputs = executor_cache.runFusionWithInputs({t0, t1});
+
+  TORCH_CHECK(
+      !executor_cache.getMostRecentKernelRuntime()->isSegmented(),
+      "The residual add and the norm should be a single kernel");
+  TORCH_CHECK(outputs.size() == 1);
+  TORCH_CHECK(t1.allclose(t2));
+  TORCH_CHECK(outputs.at(0).allclose(ref, 1e-4, 1e-5));
+}
+
+// Complex tensors are vectorized like any other type of the same size, with
+// two complex floats or a single complex double per 16 byte access
+TEST_F(NVFuserTest, FusionVectorizeComplex_CUDA) {
+  for (auto dtype : {DataType::ComplexFloat, DataType::ComplexDouble}) {
+    Fusion fusion;
+    FusionGuard fg(&fusion);
+
+    auto tv0 = makeContigTensor(1, dtype);
+    auto tv1 = makeContigTensor(1, dtype);
+    fusion.addInput(tv0);
+    fusion.addInput(tv1);
+    auto tv2 = mul(tv0, tv1);
+    auto tv3 = add(tv2, tv0);
+    fusion.addOutput(tv3);
+
+    auto options = at::TensorOptions()
+                       .dtype(data_type_to_aten(dtype))
+                       .device(at::kCUDA, 0);
+    at::Tensor t0 = at::randn({1024 * 1024}, options);
+    at::Tensor t1 = at::randn({1024 * 1024}, options);
+    std::vector<c10::IValue> aten_inputs = {t0, t1};
+
+    auto params = getPointwiseHeuristics(&fusion, aten_inputs);
+    TORCH_CHECK(params != nullptr);
+    if (dtype == DataType::ComplexFloat) {
+      TORCH_CHECK(
+          params->vectorize && params->unroll_factor == 2,
+          "Expected complex floats to be vectorized by 2");
+    }
+    schedulePointwise(&fusion, *params);
+
+    FusionExecutor fe;
+    fe.compileFusion(&fusion, aten_inputs, params->lparams);
+    auto cg_outputs = fe.runFusion(aten_inputs, params->lparams);
+    testValidate(
+        &fusion, cg_outputs, aten_inputs, {t0 * t1 + t0}, __LINE__, __FILE__);
+  }
+}
+
+TEST_F(NVFuserTest, FusionDeviceProfileOverrides_CUDA) {
+  const auto& device = getCurrentDeviceProfile();
+  const auto properties = at::cuda::getCurrentDeviceProperties();
+  TORCH_CHECK(device.sm_count == properties->multiProcessorCount);
+  TORCH_CHECK(device.l2_size == properties->l2CacheSize);
+  TORCH_CHECK(device.memory_bandwidth_gbs > 0);
+
+  DeviceProfile profile = device;
+  std::istringstream overrides(
+      "launch_latency_us = 3.5 # applies to every device\n"
+      "[Some other GPU]\n"
+      "sm_count = 1\n"
+      "[" +
+      device.name +
+      "]\n"
+      "  l2_size = 1048576\n"
+      "\n"
+      "[*]\n"
+      "memory_bandwidth_gbs=250\n");
+  applyDeviceProfileOverrides(profile, overrides);
+  TORCH_CHECK(profile.launch_latency_us == 3.5);
+  TORCH_CHECK(profile.sm_count == device.sm_count);
+  TORCH_CHECK(profile.l2_size == 1048576);
+  TORCH_CHECK(profile.memory_bandwidth_gbs == 250);
+
+  std::istringstream unknown_field("l3_size = 1\n");
+  ASSERT_ANY_THROW(applyDeviceProfileOverrides(profile, unknown_field));
+  std::istringstream invalid_value("sm_count = many\n");
+  ASSERT_ANY_THROW(applyDeviceProfileOverrides(profile, invalid_value));
+}
+
+// Group norm of both layouts is a single persistent kernel, the channels
+// last one through the 3D schedule
+TEST_F(NVFuserTest, FusionGroupNorm_CUDA) {
+  const int64_t N = 2, C = 64, G = 8, H = 24, W = 20;
+  const double kEps = 1e-5;
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+
+  for (bool channels_last : {false, true}) {
+    auto fusion_ptr = std::make_unique<Fusion>();
+    Fusion& fusion = *fusion_ptr.get();
+    FusionGuard fg(&fusion);
+
+    auto tv0 = makeContigTensor(5);
+    auto tv1 = makeContigTensor(2);
+    auto tv2 = makeContigTensor(2);
+    fusion.addInput(tv0);
+    fusion.addInput(tv1);
+    fusion.addInput(tv2);
+    auto result = group_norm(
+        tv0, tv1, tv2, IrBuilder::create<Double>(kEps), channels_last);
+    fusion.addOutput(result.output);
+    fusion.addOutput(result.mean);
+    fusion.addOutput(result.invstd);
+
+    at::Tensor t0 = channels_last ? at::randn({N, H, W, G, C / G}, options)
+                                  : at::randn({N, G, C / G, H, W}, options);
+    at::Tensor weight = at::randn({C}, options);
+    at::Tensor bias = at::randn({C}, options);
+    std::vector<c10::IValue> aten_inputs(
+        {t0, weight.view({G, C / G}), bias.view({G, C / G})});
+
+    FusionExecutorCache fec(std::move(fusion_ptr));
+    auto cg_outputs = fec.runFusionWithInputs(aten_inputs);
+
+    auto runtime = fec.getMostRecentKernelRuntime();
+    TORCH_CHECK(!runtime->isSegmented());
+    TORCH_CHECK(
+        runtime->schedulerHeuristics()->singleKernelHeuristics()->heuristic() ==
+        ScheduleHeuristic::Persistent);
+    auto params = dynamic_cast<ReductionParams*>(
+        runtime->getMostRecentExecutorLog().params.get());
+    TORCH_CHECK(
+        params != nullptr && params->persistent_kernel &&
+        params->schedule_3D == channels_last);
+
+    at::Tensor nchw = channels_last
+        ? t0.view({N, H, W, C}).permute({0, 3, 1, 2}).contiguous()
+        : t0.view({N, C, H, W});
+    auto aten_outputs =
+        at::native_group_norm(nchw, weight, bias, N, C, H * W, G, kEps);
+    at::Tensor aten_y = std::get<0>(aten_outputs);
+    aten_y = channels_last
+        ? aten_y.permute({0, 2, 3, 1}).reshape({N, H, W, G, C / G})
+        : aten_y.view({N, G, C / G, H, W});
+
+    testValidate(
+        fec.fusion(),
+        cg_outputs,
+        aten_inputs,
+        {aten_y, std::get<1>(aten_outputs), std::get<2>(aten_outputs)},
+        __LINE__,
+        __FILE__);
+  }
+}
+
+// Register buffers of loop nests run one after the other should share
+// registers even if their sizes differ, see Note [ Reusing larger register
+// buffers ]
+TEST_F(NVFuserTest, FusionReuseLargerRegisterBuffer_CUDA) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeConcreteTensor({8});
+  fusion.addInput(tv0);
+  auto tv1 = makeConcreteTensor({4});
+  fusion.addInput(tv1);
+
+  auto tv2 = add(tv0, IrBuilder::create<Double>(1));
+  auto tv3 = sum(tv2, {0});
+  auto tv4 = broadcast(tv3, {true});
+  auto tv5 = add(tv1, tv4);
+  auto tv6 = sum(tv5, {0});
+  fusion.addOutput(tv6);
+
+  GpuLower gpulw(&fusion);
+  bool found_alias = false;
+  for (auto expr : gpulw.kernel()->topLevelExprs()) {
+    auto alloc = dynamic_cast<kir::Allocate*>(expr);
+    if (alloc == nullptr || alloc->buffer() != tv5) {
+      continue;
+    }
+    TORCH_CHECK(
+        alloc->alias() != nullptr && alloc->alias()->buffer() == tv2,
+        "Expected T5 to reuse the registers of T2");
+    found_alias = true;
+  }
+  TORCH_CHECK(found_alias, "Allocation of T5 not found");
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({8}, options);
+  at::Tensor t1 = at::randn({4}, options);
+  std::vector<c10::IValue> aten_inputs = {t0, t1};
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, aten_inputs);
+  auto cg_outputs = fe.runFusion(aten_inputs);
+
+  auto ref = (t1 + (t0 + 1).sum()).sum();
+
+  testValidate(&fusion, cg_outputs, aten_inputs, {ref}, __LINE__, __FILE__);
+}
+
+// A timestep of an LSTM with its recurrent projection should run as a single
+// kernel, see Note [ Fused LSTM cells ]
+TEST_F(NVFuserTest, FusionLstmCellRecurrent_CUDA) {
+  constexpr int64_t kBatch = 4;
+  constexpr int64_t kHidden = 256;
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto hx = makeContigTensor(2);
+  auto cx = makeContigTensor(2);
+  fusion->addInput(hx);
+  fusion->addInput(cx);
+  std::vector<TensorView*> gates_x;
+  std::vector<TensorView*> weights;
+  for (auto& tvs : {&gates_x, &weights}) {
+    for (int i = 0; i < 4; i++) {
+      tvs->push_back(makeContigTensor(2));
+      fusion->addInput(tvs->back());
+    }
+  }
+
+  auto result = lstm_cell(
+      hx,
+      cx,
+      gates_x[0],
+      gates_x[1],
+      gates_x[2],
+      gates_x[3],
+      weights[0],
+      weights[1],
+      weights[2],
+      weights[3]);
+  fusion->addOutput(result.cell);
+  fusion->addOutput(result.hidden);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t_hx = at::randn({kBatch, kHidden}, options);
+  at::Tensor t_cx = at::randn({kBatch, kHidden}, options);
+  at::Tensor t_gates_x = at::randn({kBatch, 4 * kHidden}, options);
+  at::Tensor t_weight = at::randn({4 * kHidden, kHidden}, options) / 16;
+  auto gates_x_chunks = t_gates_x.chunk(4, 1);
+  auto weight_chunks = t_weight.chunk(4, 0);
+
+  std::vector<c10::IValue> aten_inputs = {t_hx, t_cx};
+  aten_inputs.insert(
+      aten_inputs.end(), gates_x_chunks.begin(), gates_x_chunks.end());
+  aten_inputs.insert(
+      aten_inputs.end(), weight_chunks.begin(), weight_chunks.end());
+
+  FusionExecutorCache fec(std::move(fusion));
+  auto cg_outputs = fec.runFusionWithInputs(aten_inputs);
+
+  auto runtime = fec.getMostRecentKernelRuntime();
+  TORCH_CHECK(!runtime->isSegmented());
+  TORCH_CHECK(
+      runtime->schedulerHeuristics()->singleKernelHeuristics()->heuristic() ==
+      ScheduleHeuristic::Reduction);
+
+  auto gates = (t_gates_x + at::matmul(t_hx, t_weight.t())).chunk(4, 1);
+  auto ref_cell =
+      gates[1].sigmoid() * t_cx + gates[0].sigmoid() * gates[2].tanh();
+  auto ref_hidden = gates[3].sigmoid() * ref_cell.tanh();
+
+  testValidate(
+      fec.fusion(),
+      cg_outputs,
+      aten_inputs,
+      {ref_cell, ref_hidden},
+      __LINE__,
+      __FILE__);
+}
+
+// Predicates of producer-consumer pairs can be checked on a scheduled fusion
+// before lowering it
+TEST_F(NVFuserTest, FusionQueryProducerConsumerPredicate_CUDA) {
+  for (int64_t extent : {16, 10}) {
+    Fusion fusion;
+    FusionGuard fg(&fusion);
+
+    auto tv0 = makeConcreteTensor({extent});
+    fusion.addInput(tv0);
+    auto tv1 = set(tv0);
+    auto tv2 = add(tv1, IrBuilder::create<Double>(1));
+    auto tv3 = set(tv2);
+    fusion.addOutput(tv3);
+
+    tv2->split(0, 4);
+
+    TORCH_CHECK(PredicateElimination::needsProducerConsumerPredicate(tv0, tv1));
+    TORCH_CHECK(PredicateElimination::needsProducerConsumerPredicate(tv2, tv3));
+    // Only the non-divisible split may read tv1 out of bounds
+    TORCH_CHECK(
+        PredicateElimination::needsProducerConsumerPredicate(tv1, tv2) ==
+        (extent % 4 != 0));
+  }
+}
+
+// See Note [ Accumulation policies ]
+TEST_F(NVFuserTest, FusionSumAccumulationPolicies_CUDA) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeContigTensor(2, DataType::Half);
+  fusion->addInput(tv0);
+  auto tv1 = makeContigTensor(2);
+  fusion->addInput(tv1);
+
+  auto tv2 = sum(tv0, {1}, AccumulationPolicy::Native);
+  auto tv3 = sum(tv0, {1}, AccumulationPolicy::Float);
+  auto tv4 = sum(tv1, {1}, AccumulationPolicy::Double);
+  fusion->addOutput(tv2);
+  fusion->addOutput(tv3);
+  fusion->addOutput(tv4);
+
+  TORCH_CHECK(tv2->getDataType() == DataType::Half);
+  TORCH_CHECK(
+      tv3->getDataType() == DataType::Half &&
+      tv3->definition()->input(0)->getDataType() == DataType::Float);
+  TORCH_CHECK(
+      tv4->getDataType() == DataType::Float &&
+      tv4->definition()->input(0)->getDataType() == DataType::Double);
+
+  // Small integers, so that the partial sums in half are exact
+  auto options = at::TensorOptions().dtype(at::kHalf).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randint(-4, 4, {64, 256}, options);
+  at::Tensor t1 = at::randn({64, 100000}, options.dtype(at::kFloat));
+  std::vector<c10::IValue> aten_inputs = {t0, t1};
+
+  FusionExecutorCache fec(std::move(fusion));
+  auto cg_outputs = fec.runFusionWithInputs(aten_inputs);
+
+  auto t0_sum = t0.to(at::kFloat).sum({1}).to(at::kHalf);
+  auto t1_sum = t1.to(at::kDouble).sum({1}).to(at::kFloat);
+
+  testValidate(
+      fec.fusion(),
+      cg_outputs,
+      aten_inputs,
+      {t0_sum, t0_sum, t1_sum},
+      __LINE__,
+      __FILE__);
+}
+
+// See Note [ Streamed execution ]
+TEST_F(NVFuserTest, FusionStreamedExecution_CUDA) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = makeContigTensor(1);
+  fusion->addInput(tv1);
+
+  auto tv2 = add(tv0, broadcast(tv1, {true, false}));
+  auto tv3 = sum(tv2, {1});
+  fusion->addOutput(tv2);
+  fusion->addOutput(tv3);
+
+  auto options = at::TensorOptions().dtype(at::kFloat);
+  // Rows on the host, the bias on the device
+  at::Tensor t0 = at::randn({1000, 129}, options).pin_memory();
+  at::Tensor t1 = at::randn({129}, options.device(at::kCUDA, 0));
+  std::vector<c10::IValue> aten_inputs = {t0, t1};
+
+  FusionExecutorCache fec(std::move(fusion));
+  auto cg_outputs = fec.runFusionStreamed(aten_inputs, 128);
+
+  TORCH_CHECK(cg_outputs.at(0).is_cpu() && cg_outputs.at(0).is_pinned());
+
+  auto t2 = t0 + t1.cpu();
+  auto t3 = t2.sum({1});
+  TORCH_CHECK(cg_outputs.at(0).allclose(t2));
+  TORCH_CHECK(cg_outputs.at(1).allclose(t3, 1e-4, 1e-4));
+}
+
+TEST_F(NVFuserTest, FusionBlockSparseMask_CUDA) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  // A [64, 128] matrix viewed as its [16, 32] blocks
+  auto tv0 = makeContigTensor(4);
+  fusion.addInput(tv0);
+  auto tv1 = makeContigTensor(2, DataType::Bool);
+  fusion.addInput(tv1);
+
+  auto tv2 = block_sparse_mask(tv0, tv1);
+  auto tv3 = mul(tv2, IrBuilder::create<Double>(2.));
+  fusion.addOutput(tv3);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({4, 16, 4, 32}, options);
+  at::Tensor t1 = at::rand({4, 4}, options) > 0.5;
+  std::vector<c10::IValue> aten_inputs = {t0, t1};
+
+  auto lparams = schedulePointwise(&fusion, aten_inputs);
+
+  // The masked input is read by the where itself rather than a cache of it
+  TORCH_CHECK(
+      tv0->uses().size() == 1 && tv0->uses().at(0)->isA<TernaryOp>(),
+      "Expected the masked input to be left uncached");
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, aten_inputs, lparams);
+  auto cg_outputs = fe.runFusion(aten_inputs, lparams);
+
+  auto aten_output =
+      at::where(t1.view({4, 1, 4, 1}), t0, at::zeros_like(t0)) * 2;
+
+  testValidate(
+      &fusion, cg_outputs, aten_inputs, {aten_output}, __LINE__, __FILE__);
+}
+
+TEST_F(NVFuserTest, FusionKernelTelemetry_CUDA) {
+  auto make_fusion = [](bool reduce) {
+    auto fusion = std::make_unique<Fusion>();
+    FusionGuard fg(fusion.get());
+    auto tv0 = makeSymbolicTensor(2);
+    fusion->addInput(tv0);
+    auto tv1 = add(tv0, IrBuilder::create<Double>(1));
+    fusion->addOutput(reduce ? sum(tv1, {1}) : tv1);
+    return fusion;
+  };
+  FusionExecutorCache pointwise_cache(make_fusion(false));
+  FusionExecutorCache reduction_cache(make_fusion(true));
+
+  auto telemetry = inst::KernelTelemetry::instance();
+  telemetry->reset();
+  telemetry->setEnabled(true);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({1024, 1024}, options);
+  for (auto i : c10::irange(3)) {
+    (void)i; // Suppress unused variable warning
+    pointwise_cache.runFusionWithInputs({t0});
+  }
+  reduction_cache.runFusionWithInputs({t0});
+  telemetry->setEnabled(false);
+  // Not recorded while disabled
+  pointwise_cache.runFusionWithInputs({t0});
+
+  auto report = telemetry->report();
+  TORCH_CHECK(report.size() == 2);
+  int64_t calls = 0;
+  for (const auto& entry : report) {
+    TORCH_CHECK(entry.gpu_time_ms > 0 && entry.host_overhead_ms > 0);
+    TORCH_CHECK(!entry.heuristic.empty() && !entry.params.empty());
+    calls += entry.calls;
+  }
+  TORCH_CHECK(calls == 4);
+  TORCH_CHECK(report.at(0).gpu_time_ms >= report.at(1).gpu_time_ms);
+
+  auto top = telemetry->report(1);
+  TORCH_CHECK(top.size() == 1);
+  TORCH_CHECK(top.at(0).kernel_name == report.at(0).kernel_name);
+  TORCH_CHECK(
+      telemetry->toJson().find(
+          "\"kernel\": \"" + report.at(1).kernel_name + "\"") !=
+      std::string::npos);
+
+  telemetry->reset();
+  TORCH_CHECK(telemetry->report().empty());
+}
+
+// See Note [ CUDA graph replay ]
+TEST_F(NVFuserTest, FusionCudaGraphReplay_CUDA) {
+  EnableOptionGuard opt_guard(EnableOption::CudaGraph);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = makeSymbolicTensor(1);
+  fusion->addInput(tv1);
+  auto s2 = IrBuilder::create<Double>();
+  fusion->addInput(s2);
+
+  auto tv3 = max(add(tv0, s2), {0});
+  auto tv4 = add(tv3, tv1);
+  fusion->addOutput(tv4);
+  auto tv5 = sum(add(tv0, broadcast(tv4, {true, false})), {1});
+  fusion->addOutput(tv5);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto make_inputs = [&](double scalar) {
+    return std::vector<c10::IValue>{
+        at::randn({64, 32}, options), at::randn({32}, options), scalar};
+  };
+  auto validate = [&](const std::vector<at::Tensor>& outputs,
+                      const std::vector<c10::IValue>& inputs) {
+    auto t0 = inputs[0].toTensor();
+    auto t1 = inputs[1].toTensor();
+    auto t4 = std::get<0>(at::max(t0 + inputs[2].toDouble(), 0)) + t1;
+    auto t5 = (t0 + t4.unsqueeze(0)).sum({1});
+    testValidate(
+        executor_cache.fusion(),
+        outputs,
+        inputs,
+        {t4, t5},
+        __LINE__,
+        __FILE__);
+  };
+
+  // The first run compiles, graphs are only captured for compiled runtimes
+  auto inputs = make_inputs(2.0);
+  validate(executor_cache.runFusionWithInputs(inputs), inputs);
+
+  // Captured and replayed
+  auto captured_outputs = executor_cache.runFusionWithInputs(inputs);
+  validate(captured_outputs, inputs);
+
+  // New tensors of the same input set are copied into the static inputs, and
+  // the outputs of the previous replay are not overwritten
+  auto new_inputs = make_inputs(2.0);
+  auto replayed_outputs = executor_cache.runFusionWithInputs(new_inputs);
+  validate(replayed_outputs, new_inputs);
+  validate(captured_outputs, inputs);
+  TORCH_CHECK(
+      replayed_outputs[0].data_ptr() != captured_outputs[0].data_ptr(),
+      "Replays should return copies of the static outputs");
+
+  // A scalar that doesn't match the captured one runs without the graph
+  auto other_scalar_inputs = make_inputs(3.0);
+  validate(
+      executor_cache.runFusionWithInputs(other_scalar_inputs),
+      other_scalar_inputs);
+
+  // Replays return the same static output buffers on request
+  executor_cache.setCudaGraphStaticOutputs(true);
+  auto static_outputs = executor_cache.runFusionWithInputs(inputs);
+  validate(static_outputs, inputs);
+  auto static_outputs2 = executor_cache.runFusionWithInputs(new_inputs);
+  validate(static_outputs2, new_inputs);
+  TORCH_CHECK(static_outputs[0].data_ptr() == static_outputs2[0].data_ptr());
+  TORCH_CHECK(static_outputs[1].data_ptr() == static_outputs2[1].data_ptr());
+  auto fallback_outputs =
+      executor_cache.runFusionWithInputs(other_scalar_inputs);
+  validate(fallback_outputs, other_scalar_inputs);
+  TORCH_CHECK(fallback_outputs[0].data_ptr() != static_outputs[0].data_ptr());
+}
+
+// See Note [ Fast compilation ]
+TEST_F(NVFuserTest, FusionFastCompile_CUDA) {
+  EnableOptionGuard opt_guard(EnableOption::FastCompile);
+
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = sin(add(tv0, IrBuilder::create<Double>(1)));
+  fusion.addOutput(tv1);
+
+  tv1->merge(0);
+  tv1->split(0, 128);
+  tv1->axis(0)->parallelize(ParallelType::BIDx);
+  tv1->axis(1)->parallelize(ParallelType::TIDx);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({64, 32}, options);
+  auto aten_output = at::sin(t0 + 1);
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {t0});
+  TORCH_CHECK(fe.isRecompiling());
+
+  // The fast kernel is launched until the optimized one is swapped in at a
+  // launch after the recompilation finished
+  const auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::minutes(2);
+  while (fe.isRecompiling()) {
+    TORCH_CHECK(
+        std::chrono::steady_clock::now() < deadline,
+        "The kernel wasn't recompiled in time");
+    auto outputs = fe.runFusion({t0});
+    testValidate(&fusion, outputs, {t0}, {aten_output}, __LINE__, __FILE__);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  auto outputs = fe.runFusion({t0});
+  testValidate(&fusion, outputs, {t0}, {aten_output}, __LINE__, __FILE__);
+}
+
+// Atomic grid reductions accumulate into slots of the persistent workspace
+// that the kernel resets itself, see Note [ Atomic grid reductions ]. Repeated
+// launches with changing sizes must keep starting from zeroed slots.
+TEST_F(NVFuserTest, FusionAtomicGridReductionWorkspace_CUDA) {
+  EnableOptionGuard opt_guard(EnableOption::AtomicGridReduction);
+
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+
+  // The max reduction is not atomic, so its work buffer and the semaphores
+  // of both reductions share the workspace with the accumulation slots
+  auto tv1 = sum(tv0, {0});
+  auto tv2 = max(tv0, {0});
+  fusion.addOutput(tv1);
+  fusion.addOutput(tv2);
+
+  for (auto tv : {tv1, tv2}) {
+    tv->split(0, 4);
+    tv->axis(0)->parallelize(ParallelType::BIDx);
+    tv->axis(1)->parallelize(ParallelType::TIDy);
+    tv->axis(2)->parallelize(ParallelType::TIDx);
+  }
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {at::randn({64, 32}, options)});
+  TORCH_CHECK(
+      fe.kernelString().find("gridReduceAtomicAdd") != std::string::npos,
+      "Expected an atomic grid reduction");
+  TORCH_CHECK(
+      fe.kernelString().find("gridReduce<") != std::string::npos,
+      "Expected the max reduction to use gridReduce");
+
+  // Interleave sizes, each with its own cache entry, so that the buffers are
+  // laid out differently in the workspace from one launch to the next
+  const std::vector<int64_t> sizes = {64, 128, 36, 256};
+  for (const auto round : c10::irange(3)) {
+    (void)round; // Suppress unused variable warning
+    for (const auto cache_id : c10::irange(sizes.size())) {
+      auto t0 = at::randn({sizes[cache_id], 32}, options);
+      auto outputs =
+          fe.runFusion({t0}, LaunchParams(), CompileParams(), cache_id);
+      testValidate(
+          &fusion,
+          outputs,
+          {t0},
+          {t0.sum({0}), std::get<0>(t0.max(0))},
+          __LINE__,
+          __FILE__);
+    }
+  }
+}
+
+// A sharded InputsIdLookup holds max_cache_size entries in total, no matter
+// how unevenly they are distributed over the shards
+TEST_F(NVFuserTest, FusionInputsIdLookupShardedCapacity_CUDA) {
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+
+  const size_t max_cache_size = 128;
+  const size_t num_shards = 8;
+  nvfuser::InputsIdLookup inputs_id_lookup(max_cache_size, num_shards);
+
+  std::vector<at::Tensor> tensors;
+  for (const auto i : c10::irange(max_cache_size)) {
+    tensors.push_back(at::empty({(int64_t)i + 1}, options));
+    auto ret = inputs_id_lookup.lookupId({tensors.back()});
+    TORCH_CHECK(ret.eviction == false, "Unexpected eviction at entry ", i);
+  }
+  TORCH_CHECK(inputs_id_lookup.size() == max_cache_size);
+
+  // Once full, new entries evict, and the table doesn't keep growing
+  size_t num_evictions = 0;
+  for (const auto i : c10::irange(max_cache_size)) {
+    tensors.push_back(at::empty({(int64_t)(max_cache_size + i) + 1}, options));
+    num_evictions += inputs_id_lookup.lookupId({tensors.back()}).eviction;
+  }
+  TORCH_CHECK(num_evictions + num_shards > max_cache_size);
+  TORCH_CHECK(inputs_id_lookup.size() < max_cache_size + num_shards);
+}
+
+// Half and BFloat16 ops computed natively match computing them in float and
+// rounding back bit for bit, see Note [ Native half precision ops ]
+TEST_F(NVFuserTest, FusionNativeHalfPrecisionOps_CUDA) {
+  std::vector<DataType> dtypes = {DataType::Half};
+#if defined(CUDA_VERSION) && CUDA_VERSION >= 11000
+  if (at::cuda::getDeviceProperties(0)->major >= 8) {
+    dtypes.push_back(DataType::BFloat16);
+  }
+#endif
+
+  const std::vector<BinaryOpType> op_types = {
+      BinaryOpType::Add,
+      BinaryOpType::Sub,
+      BinaryOpType::Mul,
+      BinaryOpType::Max,
+      BinaryOpType::Min};
+
+  for (const auto dtype : dtypes) {
+    Fusion fusion;
+    FusionGuard fg(&fusion);
+
+    auto tv0 = makeContigTensor(2, dtype);
+    auto tv1 = makeContigTensor(1, dtype);
+    fusion.addInput(tv0);
+    fusion.addInput(tv1);
+
+    // Both operands are half precision tensors in registers, one of them a
+    // broadcast
+    auto tv2 = set(tv0);
+    auto tv3 = broadcast(tv1, {true, false});
+    for (const auto op_type : op_types) {
+      auto out = castOp(
+          dtype,
+          binaryOp(
+              op_type,
+              castOp(DataType::Float, tv2),
+              castOp(DataType::Float, tv3)));
+      fusion.addOutput(out);
+    }
+
+    auto ref = fusion.outputs()[0]->as<TensorView>();
+    ref->merge(0);
+    ref->split(0, 128);
+    TransformPropagatorWithCheck propagator(ref);
+    MaxRootDomainInfoSpanningTree(ref).traverse(&propagator);
+    ref->axis(0)->parallelize(ParallelType::BIDx);
+    ref->axis(1)->parallelize(ParallelType::TIDx);
+    scheduler_utils::parallelizeAllLike(ref);
+    inlineMost();
+
+    auto options = at::TensorOptions()
+                       .dtype(data_type_to_aten(dtype))
+                       .device(at::kCUDA, 0);
+    at::Tensor t0 = at::randn({99, 101}, options);
+    at::Tensor t1 = at::randn({101}, options);
+    // NaNs in both operands, including the broadcast one
+    t0.view({-1}).slice(0, 0, t0.numel(), 7).fill_(NAN);
+    t1.slice(0, 0, t1.numel(), 13).fill_(NAN);
+    std::vector<c10::IValue> inputs = {t0, t1};
+
+    auto run = [&](bool enabled) {
+      EnableOptionGuard opt_guard(EnableOption::HalfPrecisionOps, enabled);
+      FusionExecutor fe;
+      fe.compileFusion(&fusion, inputs);
+      return std::make_pair(fe.kernelString(), fe.runFusion(inputs));
+    };
+    const auto native = run(true);
+    const auto promoted = run(false);
+    TORCH_CHECK(
+        native.first != promoted.first,
+        "Expected native ",
+        dtype,
+        " ops to be generated");
+
+    // NaN payloads are not specified, everything else must match bit for bit
+    for (const auto i : c10::irange(op_types.size())) {
+      const auto& native_output = native.second.at(i);
+      const auto& promoted_output = promoted.second.at(i);
+      auto is_nan = promoted_output.isnan();
+      TORCH_CHECK(
+          at::equal(native_output.isnan(), is_nan),
+          "NaNs differ for ",
+          op_types[i]);
+      TORCH_CHECK(
+          at::equal(
+              native_output.view(at::kShort).masked_fill(is_nan, 0),
+              promoted_output.view(at::kShort).masked_fill(is_nan, 0)),
+          "Results differ for ",
+          op_types[i]);
+    }
+  }
+}
+
+namespace {
+
+//! Counts the block syncs of a kernel, and how many of them are WAR syncs
+class BlockSyncCounter : private kir::IrVisitor {
+ public:
+  static std::pair<int, int> count(const kir::Kernel* kernel) {
+    BlockSyncCounter counter;
+    counter.kir::IrVisitor::handle(kernel->topLevelExprs());
+    return {counter.num_syncs_, counter.num_war_syncs_};
+  }
+
+ private:
+  using kir::IrVisitor::handle;
+
+  void handle(kir::BlockSync* sync) final {
+    ++num_syncs_;
+    if (sync->isWarHazardSync()) {
+      ++num_war_syncs_;
+    }
+  }
+
+  int num_syncs_ = 0;
+  int num_war_syncs_ = 0;
+};
+
+} // namespace
+
+// The WAR sync inserted where tv3 reuses the shared memory of tv1 and the
+// RAW sync of tv2 are only separated by the allocation of tv3, so only the
+// WAR sync is kept, see Note [ Redundant block syncs ]
+TEST_F(NVFuserTest, FusionRedundantSyncRemoval_CUDA) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeConcreteTensor({32, 32});
+  fusion.addInput(tv0);
+
+  // Each tensor is read by other threads than the ones writing it. The
+  // different data types keep the buffers from being aliased, so tv3 only
+  // shares memory with tv1 through shared memory packing.
+  auto tv1 = set(tv0);
+  auto tv2 = castOp(DataType::Double, tv1);
+  auto tv3 = castOp(DataType::Float, tv2);
+  auto tv4 = set(tv3);
+  fusion.addOutput(tv4);
+
+  for (auto tv : {tv1, tv3}) {
+    tv->axis(0)->parallelize(ParallelType::TIDy);
+    tv->axis(1)->parallelize(ParallelType::TIDx);
+  }
+  for (auto tv : {tv2, tv4}) {
+    tv->axis(0)->parallelize(ParallelType::TIDx);
+    tv->axis(1)->parallelize(ParallelType::TIDy);
+  }
+  for (auto tv : {tv1, tv2, tv3}) {
+    tv->setMemoryType(MemoryType::Shared);
+  }
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({32, 32}, options);
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {t0});
+
+  // The RAW syncs of tv1 and tv3, and the WAR sync that also protects the
+  // read of tv2
+  const auto num_syncs = BlockSyncCounter::count(fe.kernel());
+  TORCH_CHECK(
+      num_syncs.first == 3, "Expected 3 block syncs, got ", num_syncs.first);
+  TORCH_CHECK(num_syncs.second == 1);
+  TORCH_CHECK(fe.kernel()->summary().war_hazard_syncs_count == 1);
+
+  auto outputs = fe.runFusion({t0});
+  testValidate(&fusion, outputs, {t0}, {t0}, __LINE__, __FILE__);
+}
+
+// The RAW and WAR syncs of a loop body are separated by the read of shared
+// memory they protect, so both are kept
+TEST_F(NVFuserTest, FusionRedundantSyncRemovalSmemAccess_CUDA) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeConcreteTensor({8, 32, 32});
+  fusion.addInput(tv0);
+
+  auto tv1 = set(tv0);
+  auto tv2 = set(tv1);
+  fusion.addOutput(tv2);
+
+  tv1->setMemoryType(MemoryType::Shared);
+  tv1->computeAt(tv2, 1);
+  tv1->axis(1)->parallelize(ParallelType::TIDy);
+  tv1->axis(2)->parallelize(ParallelType::TIDx);
+  tv2->axis(1)->parallelize(ParallelType::TIDx);
+  tv2->axis(2)->parallelize(ParallelType::TIDy);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({8, 32, 32}, options);
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {t0});
+
+  const auto num_syncs = BlockSyncCounter::count(fe.kernel());
+  TORCH_CHECK(
+      num_syncs.first == 2, "Expected 2 block syncs, got ", num_syncs.first);
+  TORCH_CHECK(num_syncs.second == 1);
+  TORCH_CHECK(fe.kernel()->summary().war_hazard_syncs_count == 1);
+
+  auto outputs = fe.runFusion({t0});
+  testValidate(&fusion, outputs, {t0}, {t0}, __LINE__, __FILE__);
+}
+
+// Autotuning the first launch of every kernel, see
+// Note [ Background autotuning ]
+TEST_F(NVFuserTest, FusionBackgroundAutotune_CUDA) {
+  EnableOptionGuard opt_guard(EnableOption::Autotune, true, {"1", "0"});
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = add(sin(tv0), IrBuilder::create<Double>(1));
+  auto tv2 = sum(tv1, {1});
+  fusion->addOutput(tv1);
+  fusion->addOutput(tv2);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({1024, 4096}, options);
+  auto t1 = at::sin(t0) + 1;
+  auto t2 = t1.sum({1});
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  auto outputs = executor_cache.runFusionWithInputs({t0});
+  testValidate(
+      executor_cache.fusion(), outputs, {t0}, {t1, t2}, __LINE__, __FILE__);
+  auto runtime = executor_cache.getMostRecentKernelRuntime();
+
+  // Wait for the trials on the thread pool. Launches keep using the
+  // kernels of the heuristics until a winner is ready.
+  const auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::minutes(2);
+  while (runtime->isAutotuning()) {
+    TORCH_CHECK(
+        std::chrono::steady_clock::now() < deadline,
+        "Autotuning didn't finish in time");
+    outputs = executor_cache.runFusionWithInputs({t0});
+    testValidate(
+        executor_cache.fusion(), outputs, {t0}, {t1, t2}, __LINE__, __FILE__);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  // Launches after the swap, if any candidate won
+  for (const auto i : c10::irange(2)) {
+    (void)i; // Suppress unused variable warning
+    outputs = executor_cache.runFusionWithInputs({t0});
+    TORCH_CHECK(executor_cache.getMostRecentKernelRuntime() == runtime);
+    testValidate(
+        executor_cache.fusion(), outputs, {t0}, {t1, t2}, __LINE__, __FILE__);
+  }
+}
+
+// A fresh runtime compiles the winner of a previous autotuning recorded in
+// the KernelDb, see Note [ Background autotuning ]
+TEST_F(NVFuserTest, FusionRestoreTunedParams_CUDA) {
+  EnableOptionGuard opt_guard(EnableOption::KernelDb);
+
+  const auto db_dir = fs::temp_directory_path() /
+      ("nvfuser_kernel_db_test_" +
+       std::to_string(
+           std::chrono::steady_clock::now().time_since_epoch().count()));
+  // Closes the temporary db and removes it at the end of the test
+  struct KernelDbCleanup {
+    fs::path dir;
+    ~KernelDbCleanup() {
+      KernelDb::get(dir.string(), "db.csv", false, true, true);
+      fs::remove_all(dir);
+    }
+  } db_cleanup{db_dir};
+  TORCH_CHECK(
+      KernelDb::get(db_dir.string(), "db.csv", false, false, true).enabled(),
+      "Unable to open a KernelDb in ",
+      db_dir);
+
+  auto make_fusion = []() {
+    auto fusion = std::make_unique<Fusion>();
+    FusionGuard fg(fusion.get());
+    auto tv0 = makeContigTensor(2);
+    fusion->addInput(tv0);
+    auto tv1 = mul(sin(tv0), IrBuilder::create<Double>(2));
+    fusion->addOutput(tv1);
+    return fusion;
+  };
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({1024, 1024}, options);
+  auto t1 = at::sin(t0) * 2;
+
+  FusionExecutorCache executor_cache(make_fusion());
+  auto outputs = executor_cache.runFusionWithInputs({t0});
+  auto runtime = executor_cache.getMostRecentKernelRuntime();
+  TORCH_CHECK(!runtime->isSegmented(), "Expected a single kernel");
+
+  const auto& scheduler_entry =
+      runtime->schedulerHeuristics()->heuristicsList().at(0);
+  auto pparams = std::dynamic_pointer_cast<PointwiseParams>(
+      scheduler_entry->params()->clone());
+  TORCH_CHECK(pparams != nullptr, "Expected the pointwise scheduler");
+  const auto tuned_unroll =
+      pparams->unroll_factor == 1 ? 2 : pparams->unroll_factor / 2;
+  pparams->unroll_factor = tuned_unroll;
+  runtime->recordTunedParams(
+      0, pparams, KernelArgumentHolder::createKernelArgumentHolder({t0}));
+
+  FusionExecutorCache tuned_executor_cache(make_fusion());
+  tuned_executor_cache.profile(true);
+  outputs = tuned_executor_cache.runFusionWithInputs({t0});
+
+  auto tuned_params = std::dynamic_pointer_cast<PointwiseParams>(
+      tuned_executor_cache.getMostRecentExecutorInfo().params);
+  TORCH_CHECK(tuned_params != nullptr);
+  TORCH_CHECK(
+      tuned_params->unroll_factor == tuned_unroll,
+      "Expected the recorded unroll factor ",
+      tuned_unroll,
+      ", got ",
+      tuned_params->unroll_factor);
+  testValidate(
+      tuned_executor_cache.fusion(),
+      outputs,
+      {t0},
+      {t1},
+      __LINE__,
+      __FILE__);
+}
+
+// Intermediates of a segmented fusion read by more than one later group are
+// kept until their last reader, see Note [ Intermediate buffer liveness ]
+TEST_F(NVFuserTest, FusionSegmentedIntermediateLiveness_CUDA) {
+  auto make_fusion = []() {
+    auto fusion = std::make_unique<Fusion>();
+    FusionGuard fg(fusion.get());
+
+    auto tv0 = makeContigTensor(2);
+    fusion->addInput(tv0);
+
+    // The outer reduction tv1 is read by the group of the inner reduction
+    // tv3 and again by the group computing tv5. The rows are too long to be
+    // kept persistent, so tv3 and tv5 are computed by separate groups.
+    auto tv1 = sum(tv0, {0});
+    auto tv2 = add(tv0, broadcast(tv1, {true, false}));
+    auto tv3 = sum(tv2, {1});
+    auto tv4 = mul(tv0, broadcast(tv1, {true, false}));
+    auto tv5 = add(tv4, broadcast(tv3, {false, true}));
+    fusion->addOutput(tv5);
+    return fusion;
+  };
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+
+  for (const bool concurrent : {false, true}) {
+    EnableOptionGuard opt_guard(EnableOption::ConcurrentSegments, concurrent);
+    FusionExecutorCache executor_cache(make_fusion());
+
+    // Released intermediates are reused by later launches
+    for (auto i : c10::irange(3)) {
+      (void)i; // Suppress unused variable warning
+      at::Tensor t0 = at::randn({128, 65536}, options);
+      auto outputs = executor_cache.runFusionWithInputs({t0});
+
+      auto t1 = t0.sum({0});
+      auto t3 = (t0 + t1.unsqueeze(0)).sum({1});
+      auto t5 = t0 * t1.unsqueeze(0) + t3.unsqueeze(1);
+      testValidate(
+          executor_cache.fusion(),
+          outputs,
+          {t0},
+          {t5},
+          __LINE__,
+          __FILE__);
+    }
+
+    auto runtime = executor_cache.getMostRecentKernelRuntime();
+    TORCH_CHECK(runtime->isSegmented(), "segmentation didn't happen");
+    TORCH_CHECK(
+        runtime->fusionSegments()->groups().size() > 2,
+        "Expected tv1 to be read by a group after the next one, got ",
+        runtime->fusionSegments()->groups().size(),
+        " groups");
+  }
+}
+
+// A grid broadcast inside a serial loop reuses its work buffer in every
+// iteration, alternating between the two halves with the phase of the
+// semaphore. See Note [ Double buffered grid broadcast ]
+TEST_F(NVFuserTest, FusionGridBroadcastPhases_CUDA) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(3);
+  fusion.addInput(tv0);
+
+  auto tv1 = sum(tv0, {1});
+  auto tv2 = broadcast(tv1, {false, true, false});
+  auto tv3 = add(tv0, tv2);
+  fusion.addOutput(tv3);
+
+  // The fused allreduce is only used for reductions into registers, so
+  // keeping tv1 in shared memory leaves a separate grid broadcast
+  tv1->setMemoryType(MemoryType::Shared);
+
+  std::vector<TensorView*> tvs = {tv1, tv2, tv3};
+  for (auto tv : tvs) {
+    tv->split(1, 8);
+    tv->axis(1)->parallelize(ParallelType::BIDx);
+    tv->axis(2)->parallelize(ParallelType::TIDy);
+    tv->axis(3)->parallelize(ParallelType::TIDx);
+  }
+  tv1->computeAt(tv3, 1);
+
+  // Every iteration of the serial outermost loop takes a grid sync,
+  // flipping the phase bit
+  const int64_t num_iterations = 9;
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({num_iterations, 64, 32}, options);
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {t0});
+  TORCH_CHECK(
+      fe.kernel()->summary().has_grid_broadcasts,
+      "Expected a grid broadcast");
+
+  // Relaunches continue from the phase the previous launch left
+  const size_t cache_id = 0;
+  for (auto i : c10::irange(3)) {
+    (void)i; // Suppress unused variable warning
+    t0 = at::randn({num_iterations, 64, 32}, options);
+    auto outputs =
+        fe.runFusion({t0}, LaunchParams(), CompileParams(), cache_id);
+    auto aten_output = t0 + t0.sum({1}).unsqueeze(1);
+    testValidate(&fusion, outputs, {t0}, {aten_output}, __LINE__, __FILE__);
+  }
+}
+
+// See Note [ L2 persistence of re-read inputs ]
+TEST_F(NVFuserTest, FusionL2PersistenceOfRereadInputs_CUDA) {
+  EnableOptionGuard opt_guard(EnableOption::L2Persistence);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+
+  // The outer and the inner reduction are computed by separate groups, and
+  // both of them read tv0
+  auto tv1 = max(tv0, {0});
+  auto tv2 = sum(add(tv0, broadcast(tv1, {true, false})), {1});
+  fusion->addOutput(tv2);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto stream = c10::cuda::getStreamFromPool();
+  c10::cuda::CUDAStreamGuard stream_guard(stream);
+  for (auto i : c10::irange(3)) {
+    (void)i; // Suppress unused variable warning
+    at::Tensor t0 = at::randn({1024, 4096}, options);
+    auto outputs = executor_cache.runFusionWithInputs({t0});
+
+    // The window is removed again after the last launch
+    TORCH_CHECK(
+        !executor_utils::L2PersistenceWindow::isSetOn(stream),
+        "The access policy window was left on the stream");
+
+    auto t1 = std::get<0>(at::max(t0, 0));
+    auto t2 = (t0 + t1.unsqueeze(0)).sum({1});
+    testValidate(
+        executor_cache.fusion(), outputs, {t0}, {t2}, __LINE__, __FILE__);
+  }
+  TORCH_CHECK(
+      executor_cache.getMostRecentKernelRuntime()->isSegmented(),
+      "segmentation didn't happen");
+}
+
+// See Note [ Circular buffering of reduction inputs ]
+TEST_F(NVFuserTest, FusionCircularBufferedOuterReduction_CUDA) {
+  if (!deviceMajorMinorCheck(8)) {
+    GTEST_SKIP() << "skipping tests on pre-AMPERE GPUs";
+    return;
+  }
+  EnableOptionGuard opt_guard(EnableOption::CircularBuffer);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = sum(tv0, {0});
+  fusion->addOutput(tv1);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({16384, 1024}, options);
+  auto outputs = executor_cache.runFusionWithInputs({t0});
+
+  auto runtime = executor_cache.getMostRecentKernelRuntime();
+  TORCH_CHECK(!runtime->isSegmented(), "Expected a single kernel");
+  const auto& scheduler_entry =
+      runtime->schedulerHeuristics()->heuristicsList().at(0);
+  TORCH_CHECK(
+      scheduler_entry->heuristic() == ScheduleHeuristic::Reduction,
+      "Unexpected heuristic was chosen: ",
+      scheduler_entry->heuristic());
+  const auto& rparams = scheduler_entry->reductionParams();
+  TORCH_CHECK(!rparams.fastest_dim, "Expected an outer reduction");
+  TORCH_CHECK(
+      rparams.circular_buffer_stages > 0,
+      "Expected the input loads to be circular buffered");
+
+  testValidate(
+      executor_cache.fusion(),
+      outputs,
+      {t0},
+      {t0.sum({0})},
+      __LINE__,
+      __FILE__);
+}
+
+// Segments launched back to back as programmatic dependents of the previous
+// kernel, see Note [ Programmatic dependent launch ]
+TEST_F(NVFuserTest, FusionProgrammaticLaunch_CUDA) {
+  if (!deviceMajorMinorCheck(9)) {
+    GTEST_SKIP() << "skipping tests on pre-HOPPER GPUs";
+    return;
+  }
+  EnableOptionGuard opt_guard(EnableOption::ProgrammaticLaunch);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+
+  // The second segment reads the output of the first one and the input
+  auto tv1 = max(tv0, {0});
+  auto tv2 = sum(add(tv0, broadcast(tv1, {true, false})), {1});
+  fusion->addOutput(tv2);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  for (auto i : c10::irange(3)) {
+    (void)i; // Suppress unused variable warning
+    at::Tensor t0 = at::randn({1024, 4096}, options);
+    auto outputs = executor_cache.runFusionWithInputs({t0});
+
+    auto t1 = std::get<0>(at::max(t0, 0));
+    auto t2 = (t0 + t1.unsqueeze(0)).sum({1});
+    testValidate(
+        executor_cache.fusion(), outputs, {t0}, {t2}, __LINE__, __FILE__);
+  }
+
+  auto runtime = executor_cache.getMostRecentKernelRuntime();
+  TORCH_CHECK(runtime->isSegmented(), "segmentation didn't happen");
+  for (const auto& executor : runtime->executors()) {
+    TORCH_CHECK(
+        executor.kernelString().find("griddepcontrol.wait") !=
+            std::string::npos,
+        "Expected the kernel to wait on the previous kernel");
+  }
+}
+
+class NVFuserGraphFuserTest : public NVFuserTest {
+ protected:
+  bool was_enabled = false;
+
+  void SetUp() override {
+    NVFuserTest::SetUp();
+    was_enabled = torch::jit::fuser::cuda::setEnabled(true);
+  }
+
+  void TearDown() override {
+    torch::jit::fuser::cuda::setEnabled(was_enabled);
+  }
+};
+
+// Fusion groups of the TorchScript graph fuser with fewer ops than the
+// argument of EnableOption::PruneSmallFusions run their fallback graphs
+TEST_F(NVFuserGraphFuserTest, FusionPruneSmallFusions_CUDA) {
+  EnableOptionGuard opt_guard(EnableOption::PruneSmallFusions, true, {"3"});
+
+  // Returns the optimized graph and the output of running `ir` on x and y
+  auto run_graph = [](const std::string& ir,
+                      const at::Tensor& x,
+                      const at::Tensor& y) {
+    auto g = std::make_shared<torch::jit::Graph>();
+    torch::jit::parseIR(ir, g.get());
+    torch::jit::GraphFunction fn("nvfuser_test", g, nullptr);
+    at::Tensor output;
+    // Past the profiling runs
+    for (auto i : c10::irange(5)) {
+      (void)i; // Suppress unused variable warning
+      auto stack = createStack({x.clone(), y.clone()});
+      fn.run(stack);
+      output = stack.back().toTensor();
+    }
+    return std::make_pair(torch::jit::lastExecutedOptimizedGraph(), output);
+  };
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto x = at::randn({32, 32}, options);
+  auto y = at::randn({32, 32}, options);
+
+  const std::string two_ops_ir = R"IR(
+graph(%x.1 : Tensor,
+      %y.1 : Tensor):
+  %2 : int = prim::Constant[value=1]()
+  %3 : Tensor = aten::add(%x.1, %y.1, %2)
+  %4 : Tensor = aten::relu(%3)
+  return (%4)
+)IR";
+  auto two_ops = run_graph(two_ops_ir, x, y);
+  TORCH_CHECK(
+      two_ops.first->toString().find("prim::CudaFusionGroup") ==
+          std::string::npos,
+      "Expected the fusion group of two ops to be pruned:\n",
+      *two_ops.first);
+  TORCH_CHECK(two_ops.second.allclose(at::relu(x + y)));
+
+  const std::string three_ops_ir = R"IR(
+graph(%x.1 : Tensor,
+      %y.1 : Tensor):
+  %2 : int = prim::Constant[value=1]()
+  %3 : Tensor = aten::add(%x.1, %y.1, %2)
+  %4 : Tensor = aten::relu(%3)
+  %5 : Tensor = aten::sin(%4)
+  return (%5)
+)IR";
+  auto three_ops = run_graph(three_ops_ir, x, y);
+  TORCH_CHECK(
+      three_ops.first->toString().find("prim::CudaFusionGroup") !=
+          std::string::npos,
+      "Expected a fusion group of three ops:\n",
+      *three_ops.first);
+  TORCH_CHECK(three_ops.second.allclose(at::sin(at::relu(x + y))));
+}
+
+// Every block records its timeline of the profiled grid reductions, which
+// is exported to the trace after the launch. See
+// Note [ Kernel profile timeline ]
+TEST_F(NVFuserTest, FusionKernelProfileTimeline_CUDA) {
+  EnableOptionGuard opt_guard(EnableOption::KernelProfile, true, {"timeline"});
+
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = sum(tv0, {0});
+  fusion.addOutput(tv1);
+
+  tv1->split(0, 4);
+  tv1->axis(0)->parallelize(ParallelType::BIDx);
+  tv1->axis(1)->parallelize(ParallelType::TIDy);
+  tv1->axis(2)->parallelize(ParallelType::TIDx);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({64, 32}, options);
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {t0});
+  TORCH_CHECK(
+      fe.kernel()->profile().getTimelineBuffer() != nullptr,
+      "Expected a timeline buffer");
+  const auto kernel_string = fe.kernelString();
+  TORCH_CHECK(
+      kernel_string.find("profileTimelineBegin") != std::string::npos &&
+          kernel_string.find("profileTimelineEnd") != std::string::npos,
+      "Expected the grid reduction to record its timeline");
+
+  // The timelines are read back and exported after each launch
+  for (auto i : c10::irange(2)) {
+    (void)i; // Suppress unused variable warning
+    auto outputs = fe.runFusion({t0});
+    testValidate(&fusion, outputs, {t0}, {t0.sum({0})}, __LINE__, __FILE__);
+  }
+}
+
+// Test file size should be up to 10K LoC. Create a new file for more tests.
+
+} // namespace nvfuser
@@ -116,6 +116,119 @@ TEST_F(NVFuserTest, FusionScatter1DIndexZerosSelfTvSameShape_CUDA) {
   }
 }
 
+// Sum duplicated indices of scatter_add into a self tensor with fewer rows
+// than src, with both unique and colliding destinations
+TEST_F(NVFuserTest, FusionScatterAdd_CUDA) {
+  const int64_t n_rows = 512;
+  const int64_t n_cols = 64;
+  at::manual_seed(0);
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto options_i = at::TensorOptions().dtype(at::kLong).device(at::kCUDA, 0);
+  // The fewer rows self has, the more the indices collide
+  for (int64_t n_self_rows : {1024, 8, 1}) {
+    auto fusion_ptr = std::make_unique<Fusion>();
+    Fusion& fusion = *fusion_ptr.get();
+    FusionGuard fg(&fusion);
+
+    TensorView* tv_self = makeContigTensor(2);
+    TensorView* tv_idx = makeContigTensor(2, DataType::Int);
+    TensorView* tv_src = makeContigTensor(2);
+    fusion.addInput(tv_self);
+    fusion.addInput(tv_idx);
+    fusion.addInput(tv_src);
+    auto tv_out = scatter_add(tv_self, 0, tv_idx, tv_src);
+    fusion.addOutput(tv_out);
+
+    at::Tensor self = at::randn({n_self_rows, n_cols}, options);
+    at::Tensor idx = at::randint(0, n_self_rows, {n_rows, n_cols}, options_i);
+    at::Tensor src = at::randn({n_rows, n_cols}, options);
+    auto self_ref = self.clone();
+    auto out_ref = at::scatter_add(self, 0, idx, src);
+
+    std::vector<c10::IValue> aten_inputs = {self, idx, src};
+    FusionExecutorCache executor_cache(std::move(fusion_ptr));
+    auto cg_outputs = executor_cache.runFusionWithInputs(aten_inputs);
+    // Atomics sum in any order
+    TORCH_CHECK(cg_outputs[0].allclose(out_ref, 1e-4, 1e-4));
+    // Self is copied, not updated in place
+    TORCH_CHECK(self.equal(self_ref));
+  }
+}
+
+// The backward of an embedding of half rows, which packs the atomics of
+// consecutive elements of a row
+TEST_F(NVFuserTest, FusionIndexAddEmbeddingBackward_CUDA) {
+  const int64_t n_tokens = 1000;
+  const int64_t n_embeddings = 64;
+  const int64_t embedding_dim = 128;
+  at::manual_seed(0);
+  auto options = at::TensorOptions().dtype(at::kHalf).device(at::kCUDA, 0);
+  auto options_i = at::TensorOptions().dtype(at::kLong).device(at::kCUDA, 0);
+
+  auto fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(&fusion);
+
+  TensorView* tv_grad_weight = makeContigTensor(2, DataType::Half);
+  TensorView* tv_idx = makeContigTensor(1, DataType::Int);
+  TensorView* tv_grad = makeContigTensor(2, DataType::Half);
+  fusion.addInput(tv_grad_weight);
+  fusion.addInput(tv_idx);
+  fusion.addInput(tv_grad);
+  auto tv_out = index_add(tv_grad_weight, 0, tv_idx, tv_grad);
+  fusion.addOutput(tv_out);
+
+  at::Tensor grad_weight = at::zeros({n_embeddings, embedding_dim}, options);
+  at::Tensor idx = at::randint(0, n_embeddings, {n_tokens}, options_i);
+  at::Tensor grad = at::randn({n_tokens, embedding_dim}, options);
+  auto out_ref = at::index_add(
+      grad_weight.to(at::kFloat), 0, idx, grad.to(at::kFloat));
+
+  std::vector<c10::IValue> aten_inputs = {grad_weight, idx, grad};
+  FusionExecutorCache executor_cache(std::move(fusion_ptr));
+  auto cg_outputs = executor_cache.runFusionWithInputs(aten_inputs);
+  // Every row sums about 16 gradients rounded to half
+  TORCH_CHECK(cg_outputs[0].to(at::kFloat).allclose(out_ref, 1e-2, 1e-1));
+}
+
+// A scatter consumed in the fusion is cut into a segment of its own, whose
+// output gets self copied in, see Note [ Scatter outputs ]
+TEST_F(NVFuserTest, FusionIndexAddConsumed_CUDA) {
+  at::manual_seed(0);
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto options_i = at::TensorOptions().dtype(at::kLong).device(at::kCUDA, 0);
+
+  auto fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(&fusion);
+
+  TensorView* tv_self = makeContigTensor(2);
+  TensorView* tv_idx = makeContigTensor(1, DataType::Int);
+  TensorView* tv_src = makeContigTensor(2);
+  fusion.addInput(tv_self);
+  fusion.addInput(tv_idx);
+  fusion.addInput(tv_src);
+  auto tv_sum = index_add(tv_self, 0, tv_idx, tv_src);
+  auto tv_out = relu(tv_sum);
+  fusion.addOutput(tv_out);
+
+  // Fewer rows of src than of self, so most rows of self are not scattered
+  at::Tensor self = at::randn({64, 32}, options);
+  at::Tensor idx = at::randint(0, 64, {8}, options_i);
+  at::Tensor src = at::randn({8, 32}, options);
+  auto out_ref = at::relu(at::index_add(self, 0, idx, src));
+
+  std::vector<c10::IValue> aten_inputs = {self, idx, src};
+  FusionExecutorCache executor_cache(std::move(fusion_ptr));
+  auto cg_outputs = executor_cache.runFusionWithInputs(aten_inputs);
+
+  TORCH_CHECK(
+      executor_cache.getMostRecentKernelRuntime()->isSegmented(),
+      "Expected the scatter to be segmented from its consumer");
+  TORCH_CHECK(cg_outputs[0].sizes() == out_ref.sizes());
+  TORCH_CHECK(cg_outputs[0].allclose(out_ref, 1e-4, 1e-4));
+}
+
 // all torch.gather test follow the FusionTorchGather* pattern
 
 // Test the correctness of gather operator in different dimensions and selcted
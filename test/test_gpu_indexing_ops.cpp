@@ -678,4 +678,70 @@ TEST_F(NVFuserTest, FusionIndexSelectDim2InRank4_CUDA) {
       &fusion, cg_outputs, aten_inputs, {output_ref}, __LINE__, __FILE__);
 }
 
+// Embedding lookup with the index_select scheduler, see
+// Note [ Index select scheduling ]
+TEST_F(NVFuserTest, FusionIndexSelectScheduler_CUDA) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(&fusion);
+
+  int64_t vocab = 64;
+  int64_t n_tokens = 1000;
+  int64_t hidden = 1024;
+
+  TensorView* tv0 = makeContigTensor(2, DataType::Half);
+  TensorView* tv1 = makeContigTensor(2, DataType::Half);
+  TensorView* tv_idx = makeContigTensor(1, DataType::Int);
+  fusion.addInput(tv1);
+  fusion.addInput(tv0);
+  fusion.addInput(tv_idx);
+  TensorView* tv_sel = index_select(tv0, 0, tv_idx);
+  TensorView* tv2 =
+      add(castOp(DataType::Float, tv_sel), castOp(DataType::Float, tv1));
+  fusion.addOutput(castOp(DataType::Half, tv2));
+
+  auto options = at::TensorOptions().dtype(at::kHalf).device(at::kCUDA, 0);
+  at::Tensor input0 = at::randn({vocab, hidden}, options);
+  at::Tensor input1 = at::randn({n_tokens, hidden}, options);
+  // Many duplicated indices
+  auto options_i = at::TensorOptions().dtype(at::kLong).device(at::kCUDA, 0);
+  at::Tensor input_idx = at::randint(0, vocab, {n_tokens}, options_i);
+  std::vector<c10::IValue> aten_inputs = {input1, input0, input_idx};
+
+  FusionExecutorCache executor_cache(std::move(fusion_ptr));
+  auto cg_outputs = executor_cache.runFusionWithInputs(aten_inputs);
+
+  auto runtime = executor_cache.getMostRecentKernelRuntime();
+  TORCH_CHECK(!runtime->isSegmented(), "Unexpected segmentation");
+  const auto& scheduler_entry =
+      runtime->schedulerHeuristics()->heuristicsList().at(0);
+  TORCH_CHECK(
+      scheduler_entry->heuristic() == ScheduleHeuristic::IndexSelect,
+      "Unexpected heuristic was chosen: ",
+      scheduler_entry->heuristic());
+  TORCH_CHECK(scheduler_entry->indexSelectParams().vectorize_factor == 8);
+
+  auto ref = (at::index_select(input0, 0, input_idx).to(at::kFloat) +
+              input1.to(at::kFloat))
+                 .to(at::kHalf);
+  testValidate(&fusion, cg_outputs, aten_inputs, {ref}, __LINE__, __FILE__);
+
+  // Gathering along the inner dimension is left to the pointwise scheduler
+  Fusion fusion_inner;
+  FusionGuard fg_inner(&fusion_inner);
+  TensorView* tv0_inner = makeContigTensor(2);
+  TensorView* tv_idx_inner = makeContigTensor(1, DataType::Int);
+  fusion_inner.addInput(tv0_inner);
+  fusion_inner.addInput(tv_idx_inner);
+  fusion_inner.addOutput(index_select(tv0_inner, 1, tv_idx_inner));
+
+  auto options_f = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor input0_inner = at::randn({n_tokens, vocab}, options_f);
+  std::vector<c10::IValue> aten_inputs_inner = {input0_inner, input_idx};
+  SchedulerRuntimeInfo runtime_info_inner(
+      &fusion_inner, aten_inputs_inner, true);
+  TORCH_CHECK(!SchedulerEntry::canSchedule(
+      ScheduleHeuristic::IndexSelect, &fusion_inner, runtime_info_inner));
+}
+
 } // namespace nvfuser
@@ -26,8 +26,11 @@
 #include <lower2device.h>
 #include <mma_type.h>
 #include <multidevice/aggregate_dag.h>
+#include <multidevice/gradient_buckets.h>
 #include <multidevice/multicluster_fusion.h>
 #include <multidevice/multidevice_runtime.h>
+#include <multidevice/sharding.h>
+#include <multidevice/topology.h>
 #include <mutator.h>
 #include <ops/all_ops.h>
 #include <root_domain_map.h>
@@ -47,6 +50,7 @@
 
 #include <algorithm>
 #include <iostream>
+#include <numeric>
 
 #include <multidevice/ProcessGroupBuilder.hpp>
 #include <torch/csrc/distributed/c10d/TCPStore.hpp>
@@ -372,6 +376,680 @@ TEST_F(NVFuserTest, FusionMultiGPU_Reduce_CUDA) {
   pg->barrier();
 }
 
+TEST_F(NVFuserTest, FusionMultiGPU_AsyncCommunication_CUDA) {
+  /*
+  Test to be run on 2 ranks, with the communication in asynchronous mode.
+
+  rank 0:
+    input: tv
+    outputs: tv0 = tv + tv, sent to rank 1, and tv1 = tv * tv, which
+      doesn't depend on the communication
+
+  rank 1:
+    input: tv0
+    output: tv2 = tv0.sum(0)
+  */
+  MultiClusterFusion fusion;
+  FusionGuard fg(&fusion);
+
+  TensorView* tv = makeContigTensor(2);
+  fusion.addInput(tv);
+
+  fusion.newCluster({.process_rank = 0});
+  auto tv0 = add(tv, tv);
+  fusion.addClusterOutput(tv0);
+
+  fusion.newCluster({.process_rank = 1});
+  TensorView* tv2 = sum(tv0, {0});
+  fusion.addClusterOutput(tv2);
+
+  fusion.newCluster({.process_rank = 0});
+  auto tv1 = mul(tv, tv);
+  fusion.addClusterOutput(tv1);
+
+  fusion.addOutput(tv2);
+  fusion.addOutput(tv1);
+
+  int grank, gsize;
+  if (parseEnv(grank, gsize)) {
+    GTEST_SKIP() << "distributed config is not provided";
+  }
+
+  c10d::TCPStoreOptions store_opts;
+  store_opts.isServer = (grank == 0) ? true : false;
+  auto store = c10::make_intrusive<c10d::TCPStore>("localhost", store_opts);
+
+  ProcessGroupBuilder pgBuilder;
+  auto pg = pgBuilder.getProcessGroup("nccl", store, grank, gsize);
+
+  if (gsize < 2) {
+    GTEST_SKIP()
+        << "this test must be run with at least 2 ranks, however gsize="
+        << gsize;
+  }
+
+  auto number_of_gpus = at::cuda::getNumGPUs();
+  if (number_of_gpus < 2) {
+    GTEST_SKIP()
+        << "this test must be run with at least 2 GPUs, however there are "
+        << number_of_gpus << " GPUs available";
+  }
+  auto device = at::Device("cuda:" + std::to_string(grank));
+
+  MultiDeviceRuntime runtime(fusion.aggregateDag(), pg);
+  runtime.setAsyncCommunication(true);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(device);
+  // caveat: concrete values only used on rank 0
+  at::Tensor input_tv = at::randn({8, 8}, options);
+
+  auto cg_outputs = runtime.runWithInput({input_tv});
+
+  if (grank == 0) {
+    TORCH_INTERNAL_ASSERT(
+        allclose(input_tv * input_tv, cg_outputs[1]),
+        "Obtained output is not the one expected");
+    std::vector<at::Tensor> sent_tv = {input_tv};
+    pg->send(sent_tv, 1, 0);
+  } else if (grank == 1) {
+    std::vector<at::Tensor> received_tv = {input_tv};
+    auto work = pg->recv(received_tv, 0, 0);
+    while (!work->isCompleted())
+      ;
+    auto ref = (input_tv + input_tv).sum({0});
+    TORCH_INTERNAL_ASSERT(
+        allclose(ref, cg_outputs[0]),
+        "Obtained output is not the one expected");
+  }
+  pg->barrier();
+}
+
+TEST_F(NVFuserTest, FusionMultiGPU_AllReduce_CUDA) {
+  /*
+  Test to be run on any number of ranks, each rank being associated with a
+  unique device and two clusters.
+
+  rank r:
+    input: tv, filled with r + 1
+    output: tv0_r = tv * 2, contributed to an all-reduce into tv1
+
+  rank r:
+    input: tv1
+    output: tv2_r = tv1 + 1
+  */
+  int grank, gsize;
+  if (parseEnv(grank, gsize)) {
+    GTEST_SKIP() << "distributed config is not provided";
+  }
+
+  MultiClusterFusion fusion;
+  FusionGuard fg(&fusion);
+
+  TensorView* tv = makeContigTensor(1);
+  fusion.addInput(tv);
+
+  std::vector<TensorView*> partials;
+  for (auto rank : c10::irange(gsize)) {
+    fusion.newCluster({.process_rank = rank});
+    auto tv0 = mul(tv, IrBuilder::create<Double>(2.0));
+    fusion.addClusterOutput(tv0);
+    partials.push_back(tv0);
+  }
+
+  auto tv1 = fusion.addCollective(CollectiveType::AllReduce, partials);
+
+  for (auto rank : c10::irange(gsize)) {
+    fusion.newCluster({.process_rank = rank});
+    auto tv2 = add(tv1, IrBuilder::create<Double>(1.0));
+    fusion.addClusterOutput(tv2);
+    fusion.addOutput(tv2);
+  }
+
+  c10d::TCPStoreOptions store_opts;
+  store_opts.isServer = (grank == 0) ? true : false;
+  auto store = c10::make_intrusive<c10d::TCPStore>("localhost", store_opts);
+
+  ProcessGroupBuilder pgBuilder;
+  auto pg = pgBuilder.getProcessGroup("nccl", store, grank, gsize);
+
+  auto number_of_gpus = at::cuda::getNumGPUs();
+  if (number_of_gpus < gsize) {
+    GTEST_SKIP() << "this test must be run with at least " << gsize
+                 << " GPUs, however there are " << number_of_gpus
+                 << " GPUs available";
+  }
+  auto device = at::Device("cuda:" + std::to_string(grank));
+
+  MultiDeviceRuntime runtime(fusion.aggregateDag(), pg);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(device);
+  at::Tensor input_tv = at::full({16}, (double)(grank + 1), options);
+
+  auto cg_outputs = runtime.runWithInput({input_tv});
+
+  // sum over the ranks of 2 * (r + 1), plus one
+  auto ref = at::full({16}, (double)(gsize * (gsize + 1) + 1), options);
+  TORCH_INTERNAL_ASSERT(
+      allclose(ref, cg_outputs.at(grank)),
+      "Obtained output is not the one expected");
+  pg->barrier();
+}
+
+TEST_F(NVFuserTest, FusionMultiGPU_PeerOutputs_CUDA) {
+  /*
+  Test to be run on 2 ranks of the same node, with the kernel of rank 0
+  writing its output directly into the memory of rank 1.
+
+  rank 0:
+    input: tv
+    output: tv0 = tv + tv
+
+  rank 1:
+    input: tv0
+    output: tv1 = tv0.sum(0)
+  */
+  MultiClusterFusion fusion;
+  FusionGuard fg(&fusion);
+
+  TensorView* tv = makeContigTensor(2);
+  fusion.addInput(tv);
+
+  fusion.newCluster({.process_rank = 0});
+  auto tv0 = add(tv, tv);
+  fusion.addClusterOutput(tv0);
+
+  fusion.newCluster({.process_rank = 1});
+  TensorView* tv1 = sum(tv0, {0});
+  fusion.addClusterOutput(tv1);
+
+  fusion.addOutput(tv1);
+
+  int grank, gsize;
+  if (parseEnv(grank, gsize)) {
+    GTEST_SKIP() << "distributed config is not provided";
+  }
+
+  c10d::TCPStoreOptions store_opts;
+  store_opts.isServer = (grank == 0) ? true : false;
+  auto store = c10::make_intrusive<c10d::TCPStore>("localhost", store_opts);
+
+  ProcessGroupBuilder pgBuilder;
+  auto pg = pgBuilder.getProcessGroup("nccl", store, grank, gsize);
+
+  if (gsize < 2) {
+    GTEST_SKIP()
+        << "this test must be run with at least 2 ranks, however gsize="
+        << gsize;
+  }
+
+  auto number_of_gpus = at::cuda::getNumGPUs();
+  if (number_of_gpus < 2) {
+    GTEST_SKIP()
+        << "this test must be run with at least 2 GPUs, however there are "
+        << number_of_gpus << " GPUs available";
+  }
+  auto device = at::Device("cuda:" + std::to_string(grank));
+
+  MultiDeviceRuntime runtime(fusion.aggregateDag(), pg);
+  runtime.setPeerOutputs(true);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(device);
+
+  // Later runs write into the buffer set up by the first one
+  for (auto i : c10::irange(3)) {
+    (void)i;
+    // caveat: concrete values only used on rank 0
+    at::Tensor input_tv = at::randn({8, 8}, options);
+    auto cg_outputs = runtime.runWithInput({input_tv});
+
+    if (grank == 0) {
+      std::vector<at::Tensor> sent_tv = {input_tv};
+      pg->send(sent_tv, 1, 0);
+    } else if (grank == 1) {
+      std::vector<at::Tensor> received_tv = {input_tv};
+      auto work = pg->recv(received_tv, 0, 0);
+      while (!work->isCompleted())
+        ;
+      auto ref = (input_tv + input_tv).sum({0});
+      TORCH_INTERNAL_ASSERT(
+          allclose(ref, cg_outputs[0]),
+          "Obtained output is not the one expected");
+    }
+  }
+  pg->barrier();
+}
+
+TEST_F(NVFuserTest, FusionMultiGPU_MicroBatches_CUDA) {
+  /*
+  Test to be run on 2 ranks, pipelining 4 micro-batches of the rows of the
+  input through the two clusters.
+
+  rank 0:
+    input: tv
+    output: tv0 = tv + tv
+
+  rank 1:
+    input: tv0
+    output: tv1 = tv0 * tv0
+  */
+  MultiClusterFusion fusion;
+  FusionGuard fg(&fusion);
+
+  TensorView* tv = makeContigTensor(2);
+  fusion.addInput(tv);
+
+  fusion.newCluster({.process_rank = 0});
+  auto tv0 = add(tv, tv);
+  fusion.addClusterOutput(tv0);
+
+  fusion.newCluster({.process_rank = 1});
+  TensorView* tv1 = mul(tv0, tv0);
+  fusion.addClusterOutput(tv1);
+
+  fusion.addOutput(tv1);
+
+  int grank, gsize;
+  if (parseEnv(grank, gsize)) {
+    GTEST_SKIP() << "distributed config is not provided";
+  }
+
+  c10d::TCPStoreOptions store_opts;
+  store_opts.isServer = (grank == 0) ? true : false;
+  auto store = c10::make_intrusive<c10d::TCPStore>("localhost", store_opts);
+
+  ProcessGroupBuilder pgBuilder;
+  auto pg = pgBuilder.getProcessGroup("nccl", store, grank, gsize);
+
+  if (gsize < 2) {
+    GTEST_SKIP()
+        << "this test must be run with at least 2 ranks, however gsize="
+        << gsize;
+  }
+
+  auto number_of_gpus = at::cuda::getNumGPUs();
+  if (number_of_gpus < 2) {
+    GTEST_SKIP()
+        << "this test must be run with at least 2 GPUs, however there are "
+        << number_of_gpus << " GPUs available";
+  }
+  auto device = at::Device("cuda:" + std::to_string(grank));
+
+  MultiDeviceRuntime runtime(fusion.aggregateDag(), pg);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(device);
+  // caveat: concrete values only used on rank 0
+  at::Tensor input_tv = at::randn({16, 8}, options);
+
+  auto cg_outputs = runtime.runWithMicroBatches({input_tv}, 4);
+
+  if (grank == 0) {
+    std::vector<at::Tensor> sent_tv = {input_tv};
+    pg->send(sent_tv, 1, 0);
+  } else if (grank == 1) {
+    std::vector<at::Tensor> received_tv = {input_tv};
+    auto work = pg->recv(received_tv, 0, 0);
+    while (!work->isCompleted())
+      ;
+    auto ref = (input_tv + input_tv) * (input_tv + input_tv);
+    TORCH_INTERNAL_ASSERT(
+        allclose(ref, cg_outputs[0]),
+        "Obtained output is not the one expected");
+  }
+  pg->barrier();
+}
+
+TEST_F(NVFuserTest, FusionMultiGPU_DynamicShapes_CUDA) {
+  /*
+  Test to be run on 2 ranks, running the same fusion on inputs of
+  different shapes.
+
+  rank 0:
+    input: tv
+    output: tv0 = tv + tv
+
+  rank 1:
+    input: tv0
+    output: tv1 = tv0.sum(1)
+  */
+  MultiClusterFusion fusion;
+  FusionGuard fg(&fusion);
+
+  TensorView* tv = makeContigTensor(2);
+  fusion.addInput(tv);
+
+  fusion.newCluster({.process_rank = 0});
+  auto tv0 = add(tv, tv);
+  fusion.addClusterOutput(tv0);
+
+  fusion.newCluster({.process_rank = 1});
+  TensorView* tv1 = sum(tv0, {1});
+  fusion.addClusterOutput(tv1);
+
+  fusion.addOutput(tv1);
+
+  int grank, gsize;
+  if (parseEnv(grank, gsize)) {
+    GTEST_SKIP() << "distributed config is not provided";
+  }
+
+  c10d::TCPStoreOptions store_opts;
+  store_opts.isServer = (grank == 0) ? true : false;
+  auto store = c10::make_intrusive<c10d::TCPStore>("localhost", store_opts);
+
+  ProcessGroupBuilder pgBuilder;
+  auto pg = pgBuilder.getProcessGroup("nccl", store, grank, gsize);
+
+  if (gsize < 2) {
+    GTEST_SKIP()
+        << "this test must be run with at least 2 ranks, however gsize="
+        << gsize;
+  }
+
+  auto number_of_gpus = at::cuda::getNumGPUs();
+  if (number_of_gpus < 2) {
+    GTEST_SKIP()
+        << "this test must be run with at least 2 GPUs, however there are "
+        << number_of_gpus << " GPUs available";
+  }
+  auto device = at::Device("cuda:" + std::to_string(grank));
+
+  MultiDeviceRuntime runtime(fusion.aggregateDag(), pg);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(device);
+  // The reduction scheduler picks different heuristics for these shapes
+  for (auto shape : std::vector<std::vector<int64_t>>{
+           {8, 8}, {1024, 4}, {4, 65536}}) {
+    // caveat: concrete values only used on rank 0
+    at::Tensor input_tv = at::randn(shape, options);
+    auto cg_outputs = runtime.runWithInput({input_tv});
+
+    if (grank == 0) {
+      std::vector<at::Tensor> sent_tv = {input_tv};
+      pg->send(sent_tv, 1, 0);
+    } else if (grank == 1) {
+      std::vector<at::Tensor> received_tv = {input_tv};
+      auto work = pg->recv(received_tv, 0, 0);
+      while (!work->isCompleted())
+        ;
+      auto ref = (input_tv + input_tv).sum({1});
+      TORCH_INTERNAL_ASSERT(
+          allclose(ref, cg_outputs[0]),
+          "Obtained output is not the one expected");
+    }
+  }
+  pg->barrier();
+}
+
+TEST_F(NVFuserTest, FusionMultiGPU_Sharding_CUDA) {
+  /*
+  Test to be run on any number of ranks, each rank being associated with a
+  unique device. The clusters and communications are derived from the
+  sharding of the input.
+
+  input: tv, sharded along its axis 1
+  outputs: tv0 = tv * 2, sharded along its axis 1
+           tv2 = sum(tv0, {1}) + 1, which needs an all-reduce
+  */
+  int grank, gsize;
+  if (parseEnv(grank, gsize)) {
+    GTEST_SKIP() << "distributed config is not provided";
+  }
+
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  TensorView* tv = makeContigTensor(2);
+  fusion.addInput(tv);
+  auto tv0 = mul(tv, IrBuilder::create<Double>(2.0));
+  auto tv1 = sum(tv0, {1});
+  auto tv2 = add(tv1, IrBuilder::create<Double>(1.0));
+  fusion.addOutput(tv0);
+  fusion.addOutput(tv2);
+
+  std::vector<ProcessRankType> mesh(gsize);
+  std::iota(mesh.begin(), mesh.end(), 0);
+  ShardedFusion sharded_fusion(&fusion, {mesh, {{tv, 1}}});
+  TORCH_INTERNAL_ASSERT(
+      sharded_fusion.outputAxis(0) == 1 && sharded_fusion.outputAxis(1) == -1,
+      "Unexpected sharding of the outputs");
+
+  c10d::TCPStoreOptions store_opts;
+  store_opts.isServer = (grank == 0) ? true : false;
+  auto store = c10::make_intrusive<c10d::TCPStore>("localhost", store_opts);
+
+  ProcessGroupBuilder pgBuilder;
+  auto pg = pgBuilder.getProcessGroup("nccl", store, grank, gsize);
+
+  auto number_of_gpus = at::cuda::getNumGPUs();
+  if (number_of_gpus < gsize) {
+    GTEST_SKIP() << "this test must be run with at least " << gsize
+                 << " GPUs, however there are " << number_of_gpus
+                 << " GPUs available";
+  }
+  auto device = at::Device("cuda:" + std::to_string(grank));
+
+  MultiDeviceRuntime runtime(sharded_fusion.aggregateDag(), pg);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(device);
+  at::Tensor input_tv = at::arange(8 * 4 * gsize, options).view({8, -1});
+
+  auto cg_outputs = sharded_fusion.localOutputs(
+      runtime.runWithInput(sharded_fusion.shardInputs({input_tv}, grank)),
+      grank);
+
+  auto ref0 = at::tensor_split(input_tv * 2, gsize, 1).at(grank);
+  auto ref2 = (input_tv * 2).sum({1}) + 1;
+  TORCH_INTERNAL_ASSERT(
+      allclose(ref0, cg_outputs.at(0)) && allclose(ref2, cg_outputs.at(1)),
+      "Obtained output is not the one expected");
+  pg->barrier();
+}
+
+
+TEST_F(NVFuserTest, FusionMultiGPU_Placement_CUDA) {
+  /*
+  Clusters of ranks 0 and 2, and of ranks 1 and 3, exchange tensors, while
+  ranks 0 and 1, and ranks 2 and 3, share a node. The placement moves the
+  clusters exchanging tensors to the same node.
+
+  rank 0: tv0 = tv + 1    rank 2: tv1 = tv0 * 2
+  rank 1: tv2 = tv + 1    rank 3: tv3 = tv2 * 2
+  */
+  MultiClusterFusion fusion;
+  FusionGuard fg(&fusion);
+
+  TensorView* tv = makeContigTensor(1);
+  fusion.addInput(tv);
+
+  std::vector<TensorView*> outputs;
+  for (auto rank : {0, 1}) {
+    fusion.newCluster({.process_rank = rank});
+    auto tv0 = add(tv, IrBuilder::create<Double>(1.0));
+    fusion.addClusterOutput(tv0);
+
+    fusion.newCluster({.process_rank = rank + 2});
+    auto tv1 = mul(tv0, IrBuilder::create<Double>(2.0));
+    fusion.addClusterOutput(tv1);
+    fusion.addOutput(tv1);
+  }
+
+  std::vector<std::vector<LinkType>> links(
+      4, std::vector<LinkType>(4, LinkType::Network));
+  for (auto a : c10::irange(4)) {
+    for (auto b : c10::irange(4)) {
+      if (a == b) {
+        links[a][b] = LinkType::SameDevice;
+      } else if (a / 2 == b / 2) {
+        links[a][b] = LinkType::NVLink;
+      }
+    }
+  }
+  Topology topology(links);
+
+  auto placement = placeClusters(fusion, topology);
+  TORCH_INTERNAL_ASSERT(
+      topology.link(placement[0], placement[2]) == LinkType::NVLink &&
+          topology.link(placement[1], placement[3]) == LinkType::NVLink,
+      "Clusters exchanging tensors are not placed on the same node");
+
+  std::vector<ProcessRankType> ranks;
+  for (const auto& cluster : fusion.clusters()) {
+    ranks.push_back(cluster->params().process_rank);
+  }
+  fusion.remapRanks(placement);
+  for (auto i : c10::irange(ranks.size())) {
+    TORCH_INTERNAL_ASSERT(
+        fusion.clusters()[i]->params().process_rank == placement[ranks[i]]);
+  }
+  TORCH_INTERNAL_ASSERT(
+      selectTransport(LinkType::NVLink, true) == Transport::PeerMemory &&
+      selectTransport(LinkType::Network, true) == Transport::Backend);
+}
+
+
+TEST_F(NVFuserTest, FusionMultiGPU_ReuseRecvBuffers_CUDA) {
+  /*
+  Test to be run on 2 ranks, running the fusion several times so that rank
+  1 receives into the buffer of the previous run, then into a new one when
+  the shape changes.
+
+  rank 0:
+    input: tv
+    output: tv0 = tv + 1
+
+  rank 1:
+    input: tv0
+    output: tv1 = tv0 * 2
+  */
+  int grank, gsize;
+  if (parseEnv(grank, gsize)) {
+    GTEST_SKIP() << "distributed config is not provided";
+  }
+  if (gsize != 2) {
+    GTEST_SKIP() << "this test must be run with 2 ranks, however gsize="
+                 << gsize;
+  }
+
+  MultiClusterFusion fusion;
+  FusionGuard fg(&fusion);
+
+  TensorView* tv = makeContigTensor(1);
+  fusion.addInput(tv);
+
+  fusion.newCluster({.process_rank = 0});
+  auto tv0 = add(tv, IrBuilder::create<Double>(1.0));
+  fusion.addClusterOutput(tv0);
+
+  fusion.newCluster({.process_rank = 1});
+  auto tv1 = mul(tv0, IrBuilder::create<Double>(2.0));
+  fusion.addClusterOutput(tv1);
+  fusion.addOutput(tv1);
+
+  c10d::TCPStoreOptions store_opts;
+  store_opts.isServer = (grank == 0) ? true : false;
+  auto store = c10::make_intrusive<c10d::TCPStore>("localhost", store_opts);
+
+  ProcessGroupBuilder pgBuilder;
+  auto pg = pgBuilder.getProcessGroup("nccl", store, grank, gsize);
+
+  auto number_of_gpus = at::cuda::getNumGPUs();
+  if (number_of_gpus < 2) {
+    GTEST_SKIP()
+        << "this test must be run with at least 2 GPUs, however there are "
+        << number_of_gpus << " GPUs available";
+  }
+  auto device = at::Device("cuda:" + std::to_string(grank));
+
+  MultiDeviceRuntime runtime(fusion.aggregateDag(), pg);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(device);
+  std::vector<at::Tensor> inputs;
+  std::vector<at::Tensor> cg_outputs;
+  for (auto i : c10::irange(3)) {
+    // the last run changes the shape of the received value
+    inputs.push_back(at::arange(i < 2 ? 16 : 32, options) + i);
+    cg_outputs.push_back(runtime.runWithInput({inputs.back()}).at(0));
+  }
+
+  // outputs of the earlier runs are not overwritten by the later ones
+  if (grank == 1) {
+    for (auto i : c10::irange(inputs.size())) {
+      TORCH_INTERNAL_ASSERT(
+          allclose((inputs[i] + 1) * 2, cg_outputs[i]),
+          "Obtained output is not the one expected");
+    }
+  }
+  pg->barrier();
+}
+
+
+TEST_F(NVFuserTest, FusionMultiGPU_GradientBuckets_CUDA) {
+  /*
+  Test to be run on any number of ranks, two fusions producing gradients
+  into buckets that are all-reduced over the ranks.
+
+  rank r:
+    input: tv, filled with r + 1
+    fusion 0 outputs: tv * 2 (gradient), tv + 1
+    fusion 1 outputs: tv * 3 (gradient)
+  */
+  int grank, gsize;
+  if (parseEnv(grank, gsize)) {
+    GTEST_SKIP() << "distributed config is not provided";
+  }
+
+  std::vector<std::unique_ptr<FusionExecutorCache>> fecs;
+  for (auto factor : {2.0, 3.0}) {
+    auto fusion = std::make_unique<Fusion>();
+    FusionGuard fg(fusion.get());
+    TensorView* tv = makeContigTensor(1);
+    fusion->addInput(tv);
+    fusion->addOutput(mul(tv, IrBuilder::create<Double>(factor)));
+    if (factor == 2.0) {
+      fusion->addOutput(add(tv, IrBuilder::create<Double>(1.0)));
+    }
+    fecs.push_back(std::make_unique<FusionExecutorCache>(std::move(fusion)));
+  }
+
+  c10d::TCPStoreOptions store_opts;
+  store_opts.isServer = (grank == 0) ? true : false;
+  auto store = c10::make_intrusive<c10d::TCPStore>("localhost", store_opts);
+
+  ProcessGroupBuilder pgBuilder;
+  auto pg = pgBuilder.getProcessGroup("nccl", store, grank, gsize);
+
+  auto number_of_gpus = at::cuda::getNumGPUs();
+  if (number_of_gpus < gsize) {
+    GTEST_SKIP() << "this test must be run with at least " << gsize
+                 << " GPUs, however there are " << number_of_gpus
+                 << " GPUs available";
+  }
+  auto device = at::Device("cuda:" + std::to_string(grank));
+
+  // a bucket holds a single gradient, so the first one is all-reduced while
+  // the second fusion runs
+  constexpr int64_t size = 16;
+  GradientBuckets buckets(pg, size * sizeof(float), /*average=*/false);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(device);
+  at::Tensor input_tv = at::full({size}, (double)(grank + 1), options);
+  const double rank_sum = gsize * (gsize + 1) / 2;
+  for (auto step : c10::irange(2)) {
+    (void)step;
+    auto outputs0 = buckets.run(fecs[0].get(), {input_tv}, {0});
+    auto outputs1 = buckets.run(fecs[1].get(), {input_tv}, {0});
+    buckets.synchronize();
+
+    TORCH_INTERNAL_ASSERT(
+        allclose(outputs0.at(0), at::full({size}, 2 * rank_sum, options)) &&
+            allclose(outputs0.at(1), input_tv + 1) &&
+            allclose(outputs1.at(0), at::full({size}, 3 * rank_sum, options)),
+        "Obtained output is not the one expected");
+  }
+  TORCH_INTERNAL_ASSERT(buckets.numBuckets() == 2);
+  pg->barrier();
+}
+
 } // namespace nvfuser
 
 #endif
@@ -222,6 +222,159 @@ TEST_F(NVFuserTest, FusionGroupedGridWelfordOuterOpt_CUDA) {
   }
 }
 
+// Same as FusionGroupedGridWelfordOuterOpt but with a plain sum
+// reduction, which should also use the outer-optimized kernel
+TEST_F(NVFuserTest, FusionGroupedGridReductionOuterOpt_CUDA) {
+  struct OuterReductionParams {
+    int vec = 1;
+    int tidx = 1;
+    int tidy = 1;
+    int bidx = 1;
+    int pb = 8;
+    bool should_use_opt = false;
+    DataType dtype = DataType::Half;
+  };
+
+  auto run_test = [&](const OuterReductionParams& params) {
+    std::unique_ptr<Fusion> fusion_ptr = std::make_unique<Fusion>();
+    Fusion& fusion = *fusion_ptr.get();
+    FusionGuard fg(&fusion);
+
+    auto tv0 = makeContigTensor(2, params.dtype);
+    fusion.addInput(tv0);
+
+    auto tv1 = set(tv0);
+    auto tv2 =
+        params.dtype == DataType::Half ? castOp(DataType::Float, tv1) : tv1;
+    auto tv3 = sum(tv2, {0});
+    auto tv4 = broadcast(tv3, {true, false});
+    auto tv5 =
+        params.dtype == DataType::Half ? castOp(DataType::Float, tv1) : tv1;
+    auto tv6 = sub(tv5, tv4);
+    fusion.addOutput(tv6);
+
+    int64_t bidy = deviceSMCount() / params.bidx;
+
+    // Skip if the available SM count is too small for this problem size
+    if (deviceSMCount() <= params.bidx || bidy <= 1) {
+      return;
+    }
+
+    int64_t reduction_size = params.tidy * bidy * params.pb;
+    int64_t iteration_size = params.vec * params.tidx * params.bidx * 8;
+
+    auto ref = tv3;
+
+    ref->reorder({{0, 1}});
+
+    ref->split(1, params.tidy);
+    ref->split(1, params.pb);
+
+    ref->split(0, params.vec);
+    ref->split(0, params.tidx);
+    ref->split(0, params.bidx);
+
+    // Move the vectorized ID to the innermost position
+    ref->reorder({{3, -1}});
+
+    auto ref_rf = ref->rFactor({-3});
+
+    TransformPropagator propagator(ref_rf);
+    MaxRootDomainInfoSpanningTree(ref_rf).traverse(&propagator);
+
+    ref_rf->axis(1)->parallelize(ParallelType::BIDx);
+    ref_rf->axis(2)->parallelize(ParallelType::TIDx);
+    ref_rf->axis(3)->parallelize(ParallelType::BIDy);
+    ref_rf->axis(5)->parallelize(ParallelType::TIDy);
+
+    scheduler_utils::parallelizeAllLike(ref_rf, ir_utils::allTvs(&fusion));
+
+    tv1->axis(-1)->parallelize(ParallelType::Vectorize);
+    tv3->axis(-1)->parallelize(ParallelType::Group);
+
+    inlineMost();
+
+    auto at_dtype = params.dtype == DataType::Half ? at::kHalf : at::kFloat;
+    auto options = at::TensorOptions().dtype(at_dtype).device(at::kCUDA, 0);
+    at::manual_seed(0);
+
+    const std::vector<int64_t> input_shape{reduction_size, iteration_size};
+    auto t0 = at::randn(input_shape, options);
+    std::vector<c10::IValue> aten_inputs = {t0};
+
+    FusionExecutor fe;
+    fe.compileFusion(&fusion, aten_inputs);
+
+    TORCH_CHECK(
+        fe.kernel()->summary().has_outer_grouped_grid_reduction ==
+            params.should_use_opt,
+        (params.should_use_opt ? "Failed to use the optimized implementation"
+                               : "Should not use the optimized implementation"),
+        ": ",
+        params.vec,
+        ", ",
+        params.tidx,
+        ", ",
+        params.tidy,
+        ", ",
+        params.bidx);
+
+    auto cg_outputs = fe.runFusion(aten_inputs);
+
+    auto t1 = t0;
+    auto t2 = params.dtype == DataType::Half ? t1.to(at::kFloat) : t1;
+    auto t3 = t2.sum({0});
+    auto t4 = t3.unsqueeze(0);
+    auto t5 = params.dtype == DataType::Half ? t1.to(at::kFloat) : t1;
+    auto t6 = t5 - t4;
+
+    testValidate(
+        &fusion, cg_outputs, aten_inputs, {t6}, __LINE__, __FILE__, "");
+  };
+
+  std::vector<OuterReductionParams> test_params;
+
+  for (const auto& dtype : {DataType::Half, DataType::Float}) {
+    for (int bidx = 1; bidx < 8; bidx *= 2) {
+      if (dtype == DataType::Half) {
+        test_params.push_back(
+            {.vec = 8,
+             .tidx = 8,
+             .tidy = 32,
+             .bidx = bidx,
+             .should_use_opt = true,
+             .dtype = dtype});
+      }
+      test_params.push_back(
+          {.vec = 4,
+           .tidx = 16,
+           .tidy = 16,
+           .bidx = bidx,
+           .should_use_opt = true,
+           .dtype = dtype});
+      test_params.push_back(
+          {.vec = 4,
+           .tidx = 8,
+           .tidy = 32,
+           .bidx = bidx,
+           .should_use_opt = true,
+           .dtype = dtype});
+      // warp_size/tidx too large
+      test_params.push_back(
+          {.vec = 2,
+           .tidx = 8,
+           .tidy = 32,
+           .bidx = bidx,
+           .should_use_opt = false,
+           .dtype = dtype});
+    }
+  }
+
+  for (const auto& params : test_params) {
+    run_test(params);
+  }
+}
+
 namespace {
 
 // A quick opt-in switch to enable performance measurements.
@@ -1368,8 +1521,8 @@ bool shouldBePersistent(
     bool is_bwd,
     bool use_weights = false,
     DataType weights_dtype = DataType::Float) {
-  // Non-welford is disabled for now
-  if (is_bwd) {
+  // Non-welford grid reductions are disabled by default
+  if (is_bwd && !isOptionEnabled(EnableOption::GridPersistentReductions)) {
     return false;
   }
 
@@ -2018,14 +2171,17 @@ TEST_F(
       256, 28, 512, DataType::Float);
 }
 
+#endif
+
 namespace {
 
-// Backward batchnorm
+// Backward batchnorm, which has only non-Welford grid reductions
 void grid_persistent_batchnorm_bwd_scheduler(
     int64_t N,
     int64_t HW,
     int64_t C,
     DataType dtype) {
+  EnableOptionGuard opt_guard(EnableOption::GridPersistentReductions);
   const bool benchmark_mode = isBenchmarkMode();
   std::unique_ptr<Fusion> fusion_ptr = std::make_unique<Fusion>();
   Fusion& fusion = *fusion_ptr.get();
@@ -2206,5 +2362,52 @@ TEST_F(
     FusionGridPersistentBatchNormChannelsLastBwdFloat256x28x512Scheduler_CUDA) {
   grid_persistent_batchnorm_bwd_scheduler(256, 28, 512, DataType::Float);
 }
-#endif
+
+// An outer reduction with a transposed copy of its input is scheduled as a
+// single reduction kernel writing the copy through shared memory. See
+// Note [ Staging transposed outputs of reductions ]
+TEST_F(NVFuserTest, FusionOuterReductionWithTransposedOutput_CUDA) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  auto& fusion = *fusion_ptr;
+  FusionGuard fg(fusion_ptr.get());
+
+  auto tv0 = makeContigTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = sum(tv0, {0});
+  fusion.addOutput(tv1);
+  auto tv2 = mul(tv0, IrBuilder::create<Double>(2));
+  auto tv3 = transpose(tv2, 0, 1);
+  fusion.addOutput(tv3);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({4096, 1024}, options);
+  std::vector<c10::IValue> aten_inputs = {t0};
+
+  FusionExecutorCache executor_cache(std::move(fusion_ptr));
+  auto cg_outputs = executor_cache.runFusionWithInputs(aten_inputs);
+
+  auto runtime = executor_cache.getMostRecentKernelRuntime();
+  TORCH_CHECK(
+      !runtime->isSegmented(),
+      "Unexpected number of segments: ",
+      runtime->fusionSegments()->groups().size());
+  const auto& scheduler_entry =
+      runtime->schedulerHeuristics()->heuristicsList().at(0);
+  TORCH_CHECK(
+      scheduler_entry->heuristic() == ScheduleHeuristic::Reduction,
+      "Unexpected heuristic was chosen: ",
+      scheduler_entry->heuristic());
+  TORCH_CHECK(
+      scheduler_entry->reductionParams().stage_transposed_outputs,
+      "Expected the transposed output to be staged");
+
+  testValidate(
+      &fusion,
+      cg_outputs,
+      aten_inputs,
+      {t0.sum({0}), (t0 * 2).t()},
+      __LINE__,
+      __FILE__);
+}
+
 } // namespace nvfuser
@@ -14,12 +14,15 @@
 #include <ir_all_nodes.h>
 #include <kernel_cache.h>
 #include <ops/arith.h>
+#include <ops/composite.h>
 #include <scheduler/all_schedulers.h>
 #include <test/test_gpu_validator.h>
 #include <test/test_utils.h>
 #include <ATen/cuda/CUDAGraphsUtils.cuh>
 
 #include <cassert>
+#include <cmath>
+#include <limits>
 #include <type_traits>
 
 #include <curand.h>
@@ -473,4 +476,126 @@ TEST_F(NVFuserTest, FusionRandLikeReduction_CUDA) {
   testValidate(fec.fusion(), {out}, {t0}, {t3}, __LINE__, __FILE__);
 }
 
+// Dropout backward regenerates the forward mask from the seed and offset
+// instead of reading it back from memory
+TEST_F(NVFuserTest, FusionDropoutRecomputeMask_CUDA) {
+  auto dtype = at::kFloat;
+  const double keep_prob = 0.75;
+  const double scale = 1. / keep_prob;
+
+  auto fusion_fwd_ptr = std::make_unique<Fusion>();
+  {
+    FusionGuard fg(fusion_fwd_ptr.get());
+    auto x = makeSymbolicTensor(2, aten_to_data_type(dtype));
+    auto seed = IrBuilder::create<Int>();
+    auto offset = IrBuilder::create<Int>();
+    fusion_fwd_ptr->addInput(x);
+    fusion_fwd_ptr->addInput(seed);
+    fusion_fwd_ptr->addInput(offset);
+    auto result = dropout(
+        x,
+        IrBuilder::create<Double>(keep_prob),
+        IrBuilder::create<Double>(scale),
+        seed,
+        offset);
+    fusion_fwd_ptr->addOutput(result.output);
+    fusion_fwd_ptr->addOutput(result.mask);
+  }
+
+  auto fusion_bwd_ptr = std::make_unique<Fusion>();
+  {
+    FusionGuard fg(fusion_bwd_ptr.get());
+    auto dy = makeSymbolicTensor(2, aten_to_data_type(dtype));
+    auto seed = IrBuilder::create<Int>();
+    auto offset = IrBuilder::create<Int>();
+    fusion_bwd_ptr->addInput(dy);
+    fusion_bwd_ptr->addInput(seed);
+    fusion_bwd_ptr->addInput(offset);
+    auto dx = dropout_backward(
+        dy,
+        IrBuilder::create<Double>(keep_prob),
+        IrBuilder::create<Double>(scale),
+        seed,
+        offset);
+    fusion_bwd_ptr->addOutput(dx);
+  }
+
+  FusionExecutorCache fec_fwd(std::move(fusion_fwd_ptr));
+  FusionExecutorCache fec_bwd(std::move(fusion_bwd_ptr));
+
+  auto options = at::TensorOptions().dtype(dtype).device(at::kCUDA, 0);
+  at::Tensor x = at::randn({129, 1031}, options);
+  at::Tensor dy = at::randn({129, 1031}, options);
+
+  for (int64_t offset : {0, 4, 4096}) {
+    int64_t seed = 1234;
+    auto fwd_outputs = fec_fwd.runFusionWithInputs({x, seed, offset});
+    // Draws from the global generator in between must not matter
+    at::rand({7}, options);
+    auto bwd_outputs = fec_bwd.runFusionWithInputs({dy, seed, offset});
+
+    auto mask = fwd_outputs.at(1);
+    TORCH_CHECK(mask.to(at::kFloat).mean().item<double>() > 0.5);
+    TORCH_CHECK(at::allclose(fwd_outputs.at(0), x * mask * scale));
+    TORCH_CHECK(at::allclose(bwd_outputs.at(0), dy * mask * scale));
+
+    // Same seed and offset, same mask
+    auto rerun = fec_fwd.runFusionWithInputs({x, seed, offset});
+    TORCH_CHECK(at::equal(rerun.at(1), mask));
+  }
+
+  // A different offset gives a different mask
+  auto out0 = fec_fwd.runFusionWithInputs({x, 1234L, 0L});
+  auto out1 = fec_fwd.runFusionWithInputs({x, 1234L, 4096L});
+  TORCH_CHECK(!at::equal(out0.at(1), out1.at(1)));
+}
+
+// Stochastic rounding to BFloat16 only ever picks one of the two neighboring
+// BFloat16 values and is unbiased on average
+TEST_F(NVFuserTest, FusionStochasticRoundCast_CUDA) {
+#if defined(CUDA_VERSION) && CUDA_VERSION >= 11000
+  if (!deviceMajorMinorCheck(8)) {
+    GTEST_SKIP() << "skipping BFloat16 test on pre-AMPERE GPUs";
+  }
+  auto fusion_ptr = std::make_unique<Fusion>();
+  {
+    FusionGuard fg(fusion_ptr.get());
+    auto tv0 = makeSymbolicTensor(1);
+    auto seed = IrBuilder::create<Int>();
+    auto offset = IrBuilder::create<Int>();
+    fusion_ptr->addInput(tv0);
+    fusion_ptr->addInput(seed);
+    fusion_ptr->addInput(offset);
+    auto tv1 = stochastic_round_cast(tv0, DataType::BFloat16, seed, offset);
+    fusion_ptr->addOutput(tv1);
+  }
+
+  FusionExecutorCache fec(std::move(fusion_ptr));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  // 1 + 2^-9 lies a quarter of the way from 1 to the next BFloat16 value
+  const float value = 1.f + 1.f / 512.f;
+  at::Tensor t0 = at::full({1 << 20}, value, options);
+  t0[0] = std::numeric_limits<float>::infinity();
+  t0[1] = std::numeric_limits<float>::quiet_NaN();
+
+  auto outputs = fec.runFusionWithInputs({t0, 1234L, 0L});
+  auto out = outputs.at(0).to(at::kFloat);
+
+  TORCH_CHECK(std::isinf(out[0].item<float>()));
+  TORCH_CHECK(std::isnan(out[1].item<float>()));
+  auto finite = out.slice(0, 2);
+  const float lower = 1.f;
+  const float upper = 1.f + 1.f / 128.f;
+  TORCH_CHECK(
+      at::logical_or(finite == lower, finite == upper).all().item<bool>());
+  auto rounded_up = (finite == upper).to(at::kFloat).mean().item<double>();
+  TORCH_CHECK(std::abs(rounded_up - 0.25) < 0.01, rounded_up);
+
+  // Same seed and offset, same rounding
+  auto rerun = fec.runFusionWithInputs({t0, 1234L, 0L});
+  TORCH_CHECK(at::equal(rerun.at(0), outputs.at(0)));
+#endif
+}
+
 } // namespace nvfuser
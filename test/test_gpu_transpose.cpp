@@ -1029,4 +1029,98 @@ TEST_F(NVFuserTest, FusionTransposeBankConflict8_CUDA) {
   TORCH_CHECK(bank_conflict_info.empty());
 }
 
+TEST_F(NVFuserTest, FusionTransposeSwizzledSmemTiles_CUDA) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeContigTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = transpose(tv0, 0, 1);
+  fusion.addOutput(tv1);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor input = at::randn({1024, 1024}, options);
+
+  auto params = getTransposeHeuristics(&fusion, {input});
+  TORCH_CHECK(params != nullptr);
+  TORCH_CHECK(
+      params->smem_swizzle_size > 1,
+      "Expected the shared memory tiles to be swizzled:",
+      params->toString());
+  scheduleTranspose(&fusion, *params);
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {input}, params->lparams);
+  auto outputs = fe.runFusion({input}, params->lparams);
+
+  auto tv_ref = input.transpose(0, 1);
+
+  testValidate(&fusion, outputs, {input}, {tv_ref}, __LINE__, __FILE__);
+}
+
+// The swizzle of the shared memory tile of an input of group 2 divides the
+// bank conflicts of its transposed reads by the swizzle size, see
+// Note [ Swizzled transpose tiles ]
+TEST_F(NVFuserTest, FusionTransposeSwizzledSmemTilesBankConflict_CUDA) {
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({1024, 1024}, options);
+  at::Tensor t1 = at::randn({1024, 1024}, options);
+
+  // Returns the largest conflict of the reads of shared memory tensors and
+  // the swizzle size of the schedule
+  auto schedule_and_run = [&](bool swizzle) {
+    Fusion fusion;
+    FusionGuard fg(&fusion);
+    auto tv0 = makeContigTensor(2);
+    auto tv1 = makeContigTensor(2);
+    fusion.addInput(tv0);
+    fusion.addInput(tv1);
+    auto tv2 = add(tv0, transpose(tv1, 0, 1));
+    fusion.addOutput(tv2);
+
+    auto params = getTransposeHeuristics(&fusion, {t0, t1});
+    TORCH_CHECK(params != nullptr);
+    TORCH_CHECK(
+        params->smem_swizzle_size > 1,
+        "Expected the shared memory tiles to be swizzled:",
+        params->toString());
+    if (!swizzle) {
+      params->smem_swizzle_size = 1;
+    }
+    scheduleTranspose(&fusion, *params);
+
+    int max_read_ways = 1;
+    for (const auto& info : fusion.bankConflictInfo()) {
+      for (auto ways : info.second.first) {
+        max_read_ways = std::max(max_read_ways, ways);
+      }
+    }
+
+    FusionExecutor fe;
+    fe.compileFusion(&fusion, {t0, t1}, params->lparams);
+    auto outputs = fe.runFusion({t0, t1}, params->lparams);
+    testValidate(
+        &fusion,
+        outputs,
+        {t0, t1},
+        {t0 + t1.transpose(0, 1)},
+        __LINE__,
+        __FILE__);
+    return std::make_pair(max_read_ways, (int)params->smem_swizzle_size);
+  };
+
+  const auto unswizzled = schedule_and_run(false);
+  TORCH_CHECK(unswizzled.first > 1, "Expected conflicting transposed reads");
+  const auto swizzled = schedule_and_run(true);
+  TORCH_CHECK(
+      swizzled.first <= ceilDiv(unswizzled.first, swizzled.second),
+      "Swizzle of size ",
+      swizzled.second,
+      " reduced the conflicts from ",
+      unswizzled.first,
+      " to ",
+      swizzled.first,
+      " ways only");
+}
+
 } // namespace nvfuser
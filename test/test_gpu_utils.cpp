@@ -10,6 +10,7 @@
 
 #include <executor_utils.h>
 #include <fusion.h>
+#include <kernel_cache.h>
 #include <lower_utils.h>
 #include <ops/all_ops.h>
 #include <scheduler/utils.h>
@@ -1276,4 +1277,43 @@ TEST_F(NVFuserTest, FusionSASSDumpError_CUDA) {
   testValidate(fe.kernel(), cg_outputs, {t0}, {t0}, __LINE__, __FILE__);
 }
 
+// 0-dim inputs on the device are cached even without unrolling so they are
+// loaded once per thread, see Note [ Device scalar inputs ]
+TEST_F(NVFuserTest, FusionCacheDeviceScalarInputs_CUDA) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = makeSymbolicTensor(0);
+  fusion->addInput(tv1);
+  auto tv2 = makeSymbolicTensor(0);
+  tv2->setCpuScalar(true);
+  fusion->addInput(tv2);
+  auto tv3 = mul(tv0, tv1);
+  auto tv4 = add(tv3, tv2);
+  auto tv5 = sum(tv4, {1});
+  fusion->addOutput(tv5);
+
+  auto cached_inputs = scheduler_utils::cacheInputs(fusion.get(), false);
+  TORCH_CHECK(cached_inputs.size() == 1);
+  TORCH_CHECK(cached_inputs.at(0)->definition()->input(0) == tv1);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({129, 1025}, options);
+  at::Tensor t1 = at::randn({}, options);
+  at::Tensor t2 = at::randn({}, at::TensorOptions().dtype(at::kFloat));
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  auto cg_outputs = executor_cache.runFusionWithInputs({t0, t1, t2});
+
+  testValidate(
+      executor_cache.fusion(),
+      cg_outputs,
+      {t0, t1, t2},
+      {(t0 * t1 + t2).sum({1})},
+      __LINE__,
+      __FILE__);
+}
+
 } // namespace nvfuser
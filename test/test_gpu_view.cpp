@@ -1170,6 +1170,13 @@ TEST_F(NVFuserTest, FusionReshapeTransformCache_CUDA) {
       {{1, 3922 * 2, 1, 7}, {1, -1, 2}}, {{1, 3922, 1, 7}, {1, -1, 2}});
   assert_does_not_match(
       {{19, 3 * 4, 7, 99}, {19, -1, 3}}, {{19, 3 * 5, 7, 99}, {19, -1, 3}});
+
+  // Leading split matching, see Note [ Symbolic reshapes ]
+  assert_matches({{4 * 7, 16}, {4, 7, 16}}, {{8 * 7, 16}, {8, 7, 16}});
+  assert_matches({{4 * 7 * 16}, {-1, 7, 16}}, {{9 * 7 * 16}, {-1, 7, 16}});
+
+  // Leading split not matching
+  assert_does_not_match({{4 * 7, 16}, {4, 7, 16}}, {{4 * 8, 16}, {4, 8, 16}});
 }
 
 TEST_F(NVFuserTest, FusionReshapeIdGraph_CUDA) {
@@ -2438,4 +2445,28 @@ TEST_F(NVFuserTest, ReshapeOfReshape_CUDA) {
   TORCH_CHECK(ref.equal(cg_outputs.at(0)));
 }
 
+// Splitting off the leading dimension of a reshape doesn't depend on its
+// size, see Note [ Symbolic reshapes ]
+TEST_F(NVFuserTest, FusionReshapeSymbolicLeadingSplit_CUDA) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = reshape(tv0, {4 * 7, 16}, {4, 7, 16});
+  auto tv2 = sin(tv1);
+  fusion->addOutput(tv2);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  for (int64_t batch : {4, 8, 3}) {
+    auto t0 = at::randn({batch * 7, 16}, options);
+    auto cg_outputs = executor_cache.runFusionWithInputs({t0});
+    auto ref = at::sin(t0.reshape({batch, 7, 16}));
+    testValidate(
+        executor_cache.fusion(), cg_outputs, {t0}, {ref}, __LINE__, __FILE__);
+  }
+}
+
 } // namespace nvfuser
@@ -9,6 +9,7 @@
 
 #include <inlining.h>
 #include <ops/arith.h>
+#include <scheduler/reduction.h>
 #include <scheduler/utils.h>
 #include <test/test_gpu_validator.h>
 #include <test/test_utils.h>
@@ -657,4 +658,42 @@ __global__ void CUDAGeneratedKernel(Tensor<float, 2> T0, Tensor<float, 2> T3) {
     testValidate(&fusion, cg_outputs, {t0}, {t0}, __LINE__, __FILE__);
   }
 }
+
+// The reduction scheduler rotates the serial reduction loop of unrolled,
+// non-persistent reductions on its own, see
+// Note [ Rotated serial reduction loop ]
+TEST_F(LoopRotationTest, SchedulerRotatedReduction_CUDA) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeContigTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = sum(tv0, {1});
+  fusion.addOutput(tv1);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({128, 65536}, options);
+
+  auto rparams = getReductionHeuristics(&fusion, {t0});
+  TORCH_CHECK(rparams, "Reduction schedule was not generated!");
+  if (!rparams->rotate_serial_reduction_loop) {
+    GTEST_SKIP() << "heuristics did not select a rotated serial reduction";
+  }
+  scheduleReduction(&fusion, *rparams);
+  TORCH_CHECK(fusion.hasManaged("optional_loop_rotation"));
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {t0}, rparams->lparams);
+  auto cg_outputs = fe.runFusion({t0}, rparams->lparams);
+  auto ref = t0.sum({1});
+  testValidate(
+      &fusion,
+      cg_outputs,
+      {t0},
+      {ref},
+      __LINE__,
+      __FILE__,
+      "",
+      rparams->lparams);
+}
 } // namespace nvfuser
@@ -1425,6 +1425,51 @@ TEST_F(NVFuserTest, FusionResizeCatReduceScheduler1_CUDA) {
       __FILE__);
 }
 
+// Concatenated output written by the kernel as slices of a single buffer,
+// see Note [ Cat into output slices ]
+TEST_F(NVFuserTest, FusionResizeCatIntoOutputSlices_CUDA) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  auto& fusion = *fusion_ptr;
+  FusionGuard fg(fusion_ptr.get());
+
+  // Keys of a KV cache and of new tokens, concatenated along the sequence
+  auto tv0 = makeContigTensor(4);
+  fusion.addInput(tv0);
+  auto tv1 = makeContigTensor(4);
+  fusion.addInput(tv1);
+
+  std::vector<Val*> slices;
+  for (auto tv : {tv0, tv1}) {
+    auto slice = set(tv);
+    slice->setContiguity({false, false, true, true});
+    fusion.addOutput(slice);
+    slices.push_back(slice);
+  }
+  fusion.addConcatOutputSlices(slices, 2);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::manual_seed(0);
+
+  auto t0 = at::randn({2, 4, 16, 32}, options);
+  auto t1 = at::randn({2, 4, 3, 32}, options);
+  std::vector<c10::IValue> aten_inputs({t0, t1});
+
+  FusionExecutorCache executor_cache(std::move(fusion_ptr));
+  auto cg_outputs = executor_cache.runFusionWithInputs(aten_inputs);
+
+  auto ref = at::cat({t0, t1}, 2);
+
+  // The slices are returned as the buffer they are views of
+  TORCH_CHECK(cg_outputs.size() == 1, "Expected a single output");
+  TORCH_CHECK(cg_outputs[0].is_contiguous());
+  TORCH_CHECK(cg_outputs[0].equal(ref));
+
+  // Again through the cached launch
+  cg_outputs = executor_cache.runFusionWithInputs(aten_inputs);
+  TORCH_CHECK(cg_outputs.size() == 1, "Expected a single output");
+  TORCH_CHECK(cg_outputs[0].equal(ref));
+}
+
 TEST_F(NVFuserTest, FusionResizeCatSoftmaxScheduler1_CUDA) {
   auto fusion_ptr = std::make_unique<Fusion>();
   auto& fusion = *fusion_ptr;
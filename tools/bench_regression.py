@@ -0,0 +1,282 @@
+# SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+# All rights reserved.
+# SPDX-License-Identifier: BSD-3-Clause
+"""Tracks performance regressions of nvfuser_bench against stored baselines.
+
+`record` runs the benchmarks and stores the samples of every benchmark as the
+baseline of the GPU model. `compare` runs them again, or reads the results of
+an earlier run, and flags the benchmarks that are significantly slower than
+the baseline: Welch's t-test on the repetitions must reject equal means and
+the slowdown of the mean must exceed a threshold. The exit code is 1 if any
+benchmark regressed.
+
+Benchmarks are compared by their real time, which is the kernel time of the
+benchmarks with manual timing, and the host time of HostOverhead_* and
+CompileTime_*. The counters given with --counters, e.g. the compile stages
+CodeGen_ms of CompileTime_*, are compared as well.
+"""
+import argparse
+import json
+import math
+import os
+import re
+import subprocess
+import sys
+import tempfile
+
+BASELINE_FORMAT_VERSION = 1
+NVFUSER_ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+DEFAULT_BASELINE_DIR = os.path.join(NVFUSER_ROOT, "benchmark", "baselines")
+
+# Benchmarks of the defaults of --filter, covering kernel time, host overhead
+# and compile time in a few minutes
+CURATED_FILTER = (
+    "NvFuserScheduler_(LayerNorm|Softmax|Reduction|BatchNorm).*fp16.*"
+    "|HostOverhead_.*|CompileTime_.*WarmKernelCache"
+)
+
+
+def gpu_model():
+    output = subprocess.check_output(
+        ["nvidia-smi", "--query-gpu=name", "--format=csv,noheader", "-i", "0"],
+        text=True,
+    )
+    return output.strip()
+
+
+def baseline_path(baseline_dir, gpu):
+    slug = re.sub(r"[^A-Za-z0-9]+", "_", gpu).strip("_")
+    return os.path.join(baseline_dir, f"{slug}.json")
+
+
+def nvfuser_version():
+    with open(os.path.join(NVFUSER_ROOT, "version.txt")) as f:
+        version = f.read().strip()
+    try:
+        sha = subprocess.check_output(
+            ["git", "rev-parse", "--short", "HEAD"],
+            cwd=NVFUSER_ROOT,
+            text=True,
+            stderr=subprocess.DEVNULL,
+        ).strip()
+        version += f"+git{sha}"
+    except (OSError, subprocess.CalledProcessError):
+        pass
+    return version
+
+
+def run_benchmarks(bench, benchmark_filter, repetitions):
+    """Runs nvfuser_bench and returns its JSON report"""
+    with tempfile.NamedTemporaryFile(suffix=".json") as out:
+        subprocess.check_call(
+            [
+                bench,
+                f"--benchmark_filter={benchmark_filter}",
+                f"--benchmark_repetitions={repetitions}",
+                "--benchmark_out_format=json",
+                f"--benchmark_out={out.name}",
+            ]
+        )
+        with open(out.name) as f:
+            return json.load(f)
+
+
+def collect_samples(report, counters):
+    """Maps the benchmark names to the samples of their metrics"""
+    samples = {}
+    for run in report["benchmarks"]:
+        # Aggregates are recomputed from the repetitions
+        if run.get("run_type") == "aggregate" or run.get("error_occurred"):
+            continue
+        metrics = samples.setdefault(run["run_name"], {})
+        metrics.setdefault(f"real_time_{run['time_unit']}", []).append(
+            run["real_time"]
+        )
+        for counter in counters:
+            if counter in run:
+                metrics.setdefault(counter, []).append(run[counter])
+    return samples
+
+
+def mean_and_variance(samples):
+    mean = sum(samples) / len(samples)
+    if len(samples) < 2:
+        return mean, 0.0
+    variance = sum((x - mean) ** 2 for x in samples) / (len(samples) - 1)
+    return mean, variance
+
+
+def incomplete_beta(a, b, x):
+    """Regularized incomplete beta function, by its continued fraction"""
+    if x <= 0.0 or x >= 1.0:
+        return min(max(x, 0.0), 1.0)
+    if x > (a + 1.0) / (a + b + 2.0):
+        return 1.0 - incomplete_beta(b, a, 1.0 - x)
+    log_front = (
+        math.lgamma(a + b)
+        - math.lgamma(a)
+        - math.lgamma(b)
+        + a * math.log(x)
+        + b * math.log(1.0 - x)
+    )
+    tiny = 1e-300
+    c, d = 1.0, 1.0 - (a + b) * x / (a + 1.0)
+    d = 1.0 / (d if abs(d) > tiny else tiny)
+    fraction = d
+    for m in range(1, 200):
+        for numerator in (
+            m * (b - m) * x / ((a + 2 * m - 1) * (a + 2 * m)),
+            -(a + m) * (a + b + m) * x / ((a + 2 * m) * (a + 2 * m + 1)),
+        ):
+            d = 1.0 + numerator * d
+            d = 1.0 / (d if abs(d) > tiny else tiny)
+            c = 1.0 + numerator / c
+            c = c if abs(c) > tiny else tiny
+            fraction *= c * d
+        if abs(c * d - 1.0) < 1e-12:
+            break
+    return math.exp(log_front) * fraction / a
+
+
+def welch_p_value(baseline, current):
+    """One-sided p-value of the current mean not being larger"""
+    mean_b, var_b = mean_and_variance(baseline)
+    mean_c, var_c = mean_and_variance(current)
+    se2_b, se2_c = var_b / len(baseline), var_c / len(current)
+    if se2_b + se2_c == 0.0:
+        return 0.0 if mean_c > mean_b else 1.0
+    t = (mean_c - mean_b) / math.sqrt(se2_b + se2_c)
+    dof_denominator = (
+        se2_b**2 / (len(baseline) - 1) if len(baseline) > 1 else 0.0
+    ) + (se2_c**2 / (len(current) - 1) if len(current) > 1 else 0.0)
+    if dof_denominator == 0.0:
+        # Normal approximation
+        tail = 0.5 * math.erfc(abs(t) / math.sqrt(2.0))
+    else:
+        dof = (se2_b + se2_c) ** 2 / dof_denominator
+        tail = 0.5 * incomplete_beta(dof / 2.0, 0.5, dof / (dof + t * t))
+    return tail if t > 0 else 1.0 - tail
+
+
+def compare(baseline, current, alpha, threshold):
+    """Returns (name, metric, baseline mean, current mean, p-value) of the
+    regressions, and the names missing from the current results"""
+    regressions = []
+    missing = []
+    for name, metrics in sorted(baseline.items()):
+        if name not in current:
+            missing.append(name)
+            continue
+        for metric, baseline_samples in sorted(metrics.items()):
+            current_samples = current[name].get(metric)
+            if not current_samples:
+                continue
+            mean_b, _ = mean_and_variance(baseline_samples)
+            mean_c, _ = mean_and_variance(current_samples)
+            if mean_b <= 0.0 or mean_c <= mean_b * (1.0 + threshold):
+                continue
+            p_value = welch_p_value(baseline_samples, current_samples)
+            if p_value < alpha:
+                regressions.append((name, metric, mean_b, mean_c, p_value))
+    return regressions, missing
+
+
+def load_or_run(args):
+    if args.results is not None:
+        with open(args.results) as f:
+            return json.load(f)
+    return run_benchmarks(args.bench, args.filter, args.repetitions)
+
+
+def record(args):
+    gpu = args.gpu or gpu_model()
+    report = load_or_run(args)
+    baseline = {
+        "format_version": BASELINE_FORMAT_VERSION,
+        "gpu": gpu,
+        "nvfuser_version": nvfuser_version(),
+        "context": report.get("context", {}),
+        "benchmarks": collect_samples(report, args.counters),
+    }
+    path = args.baseline or baseline_path(args.baseline_dir, gpu)
+    os.makedirs(os.path.dirname(path), exist_ok=True)
+    with open(path, "w") as f:
+        json.dump(baseline, f, indent=1, sort_keys=True)
+    print(f"Recorded {len(baseline['benchmarks'])} benchmarks of {gpu} to {path}")
+    return 0
+
+
+def check(args):
+    gpu = args.gpu or gpu_model()
+    path = args.baseline or baseline_path(args.baseline_dir, gpu)
+    with open(path) as f:
+        baseline = json.load(f)
+    if baseline.get("format_version") != BASELINE_FORMAT_VERSION:
+        sys.exit(f"{path} has an unsupported format, record it again")
+    if baseline["gpu"] != gpu:
+        print(f"Warning: comparing {gpu} against a baseline of {baseline['gpu']}")
+
+    report = load_or_run(args)
+    current = collect_samples(report, args.counters)
+    regressions, missing = compare(
+        baseline["benchmarks"], current, args.alpha, args.threshold
+    )
+
+    print(
+        f"Compared {len(current)} benchmarks against {path} "
+        f"(nvfuser {baseline['nvfuser_version']})"
+    )
+    for name in missing:
+        print(f"  missing: {name}")
+    for name, metric, mean_b, mean_c, p_value in regressions:
+        print(
+            f"  REGRESSION {name} {metric}: {mean_b:.4g} -> {mean_c:.4g} "
+            f"(+{100.0 * (mean_c / mean_b - 1.0):.1f}%, p={p_value:.2g})"
+        )
+    if not regressions:
+        print("  no significant regressions")
+    return 1 if regressions else 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    subparsers = parser.add_subparsers(dest="command", required=True)
+    for command, func in (("record", record), ("compare", check)):
+        sub = subparsers.add_parser(command)
+        sub.set_defaults(func=func)
+        sub.add_argument("--bench", default="nvfuser_bench", help="benchmark binary")
+        sub.add_argument("--filter", default=CURATED_FILTER, help="benchmark regex")
+        sub.add_argument("--repetitions", type=int, default=10)
+        sub.add_argument(
+            "--results",
+            help="JSON report of nvfuser_bench --benchmark_out to use "
+            "instead of running the benchmarks",
+        )
+        sub.add_argument(
+            "--counters",
+            nargs="*",
+            default=["CodeGen_ms", "NVRTC_ms", "Segmentation_ms", "Scheduling_ms"],
+            help="user counters to track besides the real time",
+        )
+        sub.add_argument("--gpu", help="GPU model, queried with nvidia-smi by default")
+        sub.add_argument("--baseline", help="baseline file, per GPU model by default")
+        sub.add_argument("--baseline-dir", default=DEFAULT_BASELINE_DIR)
+        if command == "compare":
+            sub.add_argument(
+                "--alpha",
+                type=float,
+                default=0.01,
+                help="significance level of the t-test",
+            )
+            sub.add_argument(
+                "--threshold",
+                type=float,
+                default=0.05,
+                help="smallest relative slowdown reported",
+            )
+    args = parser.parse_args()
+    sys.exit(args.func(args))
+
+
+if __name__ == "__main__":
+    main()